@@ -0,0 +1,79 @@
+/**
+ * @file BenchCorpus.h
+ * @brief Entradas sintéticas y deterministas para los benchmarks
+ *
+ * Todo se genera a partir del tamaño pedido, sin aleatoriedad, para que
+ * dos ejecuciones (o dos versiones del compilador) midan exactamente el
+ * mismo trabajo.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace cpp20::compiler::bench {
+
+/**
+ * @brief Unidad con la mezcla habitual de declaraciones
+ *
+ * Cada repetición aporta un prototipo, una función con bucle y
+ * condicionales, una variable global inicializada y comentarios. Solo usa
+ * construcciones que el parser ya acepta, para que el benchmark mida el
+ * camino normal y no la recuperación de errores.
+ */
+inline std::string makeTranslationUnit(size_t repetitions) {
+    std::string source;
+    source.reserve(repetitions * 320);
+    for (size_t i = 0; i < repetitions; ++i) {
+        std::string n = std::to_string(i);
+        source += "// Bloque " + n + " del corpus sintético\n";
+        source += "int helper" + n + "(int value, double weight);\n";
+        source += "int accumulate" + n + "(int limit, int step) {\n"
+                  "    int total = 0;\n"
+                  "    for (int i = 0; i < limit; i += step) {\n"
+                  "        if (i % 3 == 0) { total += i * 2; } else { total -= 1; }\n"
+                  "    }\n"
+                  "    return total + 0x" + std::to_string(1000 + i) + ";\n"
+                  "}\n";
+        source += "/* constante */ int global" + n + " = " + n + " * 4 + (42 - 1);\n";
+    }
+    return source;
+}
+
+/**
+ * @brief Cadena de cabeceras con guardas donde cada una incluye a la siguiente
+ *
+ * header0.h incluye header1.h y así hasta la profundidad pedida; cada
+ * cabecera define macros con argumentos que usa la siguiente. Devuelve la
+ * unidad principal, que incluye la cadena dos veces (la segunda solo debe
+ * costar la comprobación de la guarda).
+ */
+inline std::string writeIncludeChain(const std::filesystem::path& dir, size_t depth) {
+    std::filesystem::create_directories(dir);
+    for (size_t level = 0; level < depth; ++level) {
+        std::string n = std::to_string(level);
+        std::ofstream out(dir / ("header" + n + ".h"), std::ios::binary);
+        out << "#ifndef HEADER" << n << "_H\n"
+            << "#define HEADER" << n << "_H\n";
+        if (level + 1 < depth) {
+            out << "#include \"header" << level + 1 << ".h\"\n";
+        }
+        out << "#define SCALE" << n << "(x) ((x) * " << level + 2 << ")\n"
+            << "#define NAME" << n << " value" << n << "\n"
+            << "#if defined(HEADER" << n << "_H) && " << level << " < 1000\n"
+            << "int NAME" << n << " = SCALE" << n << "(" << level << ");\n"
+            << "#endif\n"
+            << "#endif\n";
+    }
+    std::string main = "#include \"header0.h\"\n#include \"header0.h\"\n";
+    for (size_t level = 0; level < depth; ++level) {
+        std::string n = std::to_string(level);
+        main += "int use" + n + " = SCALE" + n + "(NAME" + n + ");\n";
+    }
+    return main;
+}
+
+} // namespace cpp20::compiler::bench
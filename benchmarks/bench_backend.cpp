@@ -0,0 +1,140 @@
+/**
+ * @file bench_backend.cpp
+ * @brief Rendimiento del asignador de registros, del escritor COFF y del MiniLinker
+ */
+
+#include <compiler/backend/codegen/RegisterAllocator.h>
+#include <compiler/backend/coff/COFFWriter.h>
+#include <compiler/backend/link/MiniLinker.h>
+#include <compiler/ir/IR.h>
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace cpp20::compiler;
+using namespace cpp20::compiler::backend;
+
+namespace {
+
+const ir::TypeInfo IntType(ir::IRType::Int, 4, 4, "i32");
+
+/**
+ * @brief int f(int p): crea `live` valores p + k y después los suma todos
+ *
+ * Todos los valores siguen vivos hasta la suma, así que con más de los
+ * registros disponibles el asignador tiene que elegir qué derramar.
+ */
+ir::IRFunction makePressureFunction(size_t live) {
+    ir::IRFunction function("pressure", IntType, {IntType});
+    ir::IRBuilder builder(function);
+    builder.setInsertPoint(builder.createBlock("entry"));
+
+    std::vector<ir::ValueId> values;
+    for (size_t k = 0; k < live; ++k) {
+        values.push_back(builder.createBinary(ir::IROpcode::Add, function.parameter(0),
+                                              builder.getInt(static_cast<int64_t>(k), IntType), IntType));
+    }
+    ir::ValueId total = values.front();
+    for (size_t k = 1; k < values.size(); ++k) {
+        total = builder.createBinary(ir::IROpcode::Add, total, values[k], IntType);
+    }
+    builder.createReturn(total);
+    return function;
+}
+
+/**
+ * @brief Función de `size` bytes que llama a `callee` (sin llamada si está vacío)
+ */
+coff::COFFFunction makeFunction(const std::string& name, const std::string& callee, size_t size) {
+    coff::COFFFunction function;
+    function.name = name;
+    function.code.assign(size, 0x90);               // nop
+    if (!callee.empty()) {
+        function.code[0] = 0xE8;                    // call rel32
+        function.code[1] = function.code[2] = function.code[3] = function.code[4] = 0;
+        function.relocations.push_back({1, callee, coff::IMAGE_REL_AMD64_REL32});
+    }
+    function.code.back() = 0xC3;                    // ret
+    return function;
+}
+
+// Funciones/s; argumentos: valores vivos y estrategia (0 = LinearScan, 1 = GraphColoring)
+void BM_RegisterAllocation(benchmark::State& state) {
+    ir::IRFunction function = makePressureFunction(static_cast<size_t>(state.range(0)));
+    auto strategy = state.range(1) ? AllocationStrategy::GraphColoring
+                                   : AllocationStrategy::LinearScan;
+    abi::ABIContract abiContract;
+
+    size_t spilled = 0;
+    for (auto _ : state) {
+        RegisterAllocator allocator(abiContract, strategy);
+        auto allocation = allocator.allocateRegisters(function);
+        spilled = allocation.spilledRegisters.size();
+        benchmark::DoNotOptimize(allocation.virtualToPhysical.size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.counters["spilled"] = static_cast<double>(spilled);
+}
+BENCHMARK(BM_RegisterAllocation)
+    ->Args({16, 0})->Args({64, 0})->Args({16, 1})->Args({64, 1})
+    ->Unit(benchmark::kMicrosecond);
+
+// Bytes de imagen/s al serializar un objeto con N funciones de 64 bytes
+void BM_COFFWrite(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+    coff::COFFObject object = coff::createBasicCOFFObject();
+    std::vector<coff::COFFFunction> functions;
+    for (size_t i = 0; i < count; ++i) {
+        std::string callee = i + 1 < count ? "f" + std::to_string(i + 1) : "";
+        functions.push_back(makeFunction("f" + std::to_string(i), callee, 64));
+    }
+    coff::appendFunctions(object, functions);
+
+    coff::COFFWriter writer;
+    std::vector<uint8_t> image;
+    for (auto _ : state) {
+        image.clear();
+        if (!writer.writeObject(object, image)) {
+            state.SkipWithError("writeObject falló");
+            break;
+        }
+        benchmark::DoNotOptimize(image.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * image.size()));
+}
+BENCHMARK(BM_COFFWrite)->Arg(256)->Arg(4096)->Unit(benchmark::kMillisecond);
+
+// Objetos/s: N objetos en memoria encadenados por llamadas, el primero define main
+void BM_MiniLinkerObjects(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+    std::vector<backend::link::ObjectImage> images;
+    coff::COFFWriter writer;
+    for (size_t i = 0; i < count; ++i) {
+        coff::COFFObject object = coff::createBasicCOFFObject();
+        std::string name = i == 0 ? "main" : "f" + std::to_string(i);
+        std::string callee = i + 1 < count ? "f" + std::to_string(i + 1) : "";
+        coff::appendFunctions(object, {makeFunction(name, callee, 256)});
+
+        backend::link::ObjectImage image;
+        image.name = "unit" + std::to_string(i) + ".obj";
+        writer.writeObject(object, image.bytes);
+        images.push_back(std::move(image));
+    }
+    auto output = std::filesystem::temp_directory_path() / "cpp20-bench-link.exe";
+
+    for (auto _ : state) {
+        backend::link::MiniLinker linker;
+        linker.addObjectImages(images);
+        auto result = linker.link(output);
+        if (!result.success) {
+            state.SkipWithError(result.errorMessage.c_str());
+            break;
+        }
+    }
+    std::filesystem::remove(output);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+BENCHMARK(BM_MiniLinkerObjects)->Arg(64)->Arg(512)->Unit(benchmark::kMillisecond);
+
+} // namespace
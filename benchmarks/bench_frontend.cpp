@@ -0,0 +1,84 @@
+/**
+ * @file bench_frontend.cpp
+ * @brief Rendimiento del lexer, del preprocesador y del parser
+ */
+
+#include "BenchCorpus.h"
+#include <compiler/frontend/Parser.h>
+#include <compiler/frontend/Preprocessor.h>
+#include <compiler/frontend/lexer/Lexer.h>
+#include <compiler/common/diagnostics/SourceManager.h>
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace cpp20::compiler;
+using frontend::lexer::Lexer;
+
+namespace {
+
+// Bytes/s sobre el corpus completo; el argumento es el número de repeticiones
+void BM_LexerThroughput(benchmark::State& state) {
+    std::string source = bench::makeTranslationUnit(static_cast<size_t>(state.range(0)));
+    auto sourceManager = std::make_shared<diagnostics::SourceManager>();
+    diagnostics::DiagnosticEngine diagEngine(sourceManager);
+
+    size_t tokens = 0;
+    for (auto _ : state) {
+        Lexer lexer(source, diagEngine);
+        auto result = lexer.tokenize();
+        tokens = result.size();
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * source.size()));
+    state.counters["tokens"] = static_cast<double>(tokens);
+}
+BENCHMARK(BM_LexerThroughput)->Arg(256)->Arg(4096)->Unit(benchmark::kMillisecond);
+
+// Tokens de salida/s con una cadena de #include de la profundidad indicada
+void BM_PreprocessorIncludeChain(benchmark::State& state) {
+    auto dir = std::filesystem::temp_directory_path() / "cpp20-bench-include-chain";
+    std::string source = bench::writeIncludeChain(dir, static_cast<size_t>(state.range(0)));
+
+    size_t tokens = 0;
+    for (auto _ : state) {
+        // Estado nuevo en cada iteración: se mide el primer paso por la cadena
+        auto sourceManager = std::make_shared<diagnostics::SourceManager>();
+        sourceManager->addIncludePath(dir, false);
+        diagnostics::DiagnosticEngine diagEngine(sourceManager);
+        frontend::Preprocessor preprocessor(diagEngine);
+        Lexer lexer(source, diagEngine);
+        auto result = preprocessor.process(lexer);
+        tokens = result.size();
+        benchmark::DoNotOptimize(result.data());
+    }
+    std::filesystem::remove_all(dir);
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * tokens));
+    state.counters["tokens"] = static_cast<double>(tokens);
+}
+BENCHMARK(BM_PreprocessorIncludeChain)->Arg(16)->Arg(64)->Unit(benchmark::kMillisecond);
+
+// Declaraciones de nivel superior/s sobre tokens ya generados
+void BM_ParserDeclarations(benchmark::State& state) {
+    std::string source = bench::makeTranslationUnit(static_cast<size_t>(state.range(0)));
+    auto sourceManager = std::make_shared<diagnostics::SourceManager>();
+    diagnostics::DiagnosticEngine diagEngine(sourceManager);
+    Lexer lexer(source, diagEngine);
+    std::vector<frontend::lexer::Token> tokens = lexer.tokenize();
+
+    size_t declarations = 0;
+    for (auto _ : state) {
+        frontend::Parser parser(tokens, diagEngine);
+        ast::TranslationUnit* unit = parser.parse();
+        declarations = unit ? unit->declarations().size() : 0;
+        benchmark::DoNotOptimize(unit);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * declarations));
+    state.counters["declarations"] = static_cast<double>(declarations);
+}
+BENCHMARK(BM_ParserDeclarations)->Arg(256)->Arg(2048)->Unit(benchmark::kMillisecond);
+
+} // namespace
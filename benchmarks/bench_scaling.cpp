@@ -0,0 +1,73 @@
+/**
+ * @file bench_scaling.cpp
+ * @brief Escalado del front-end con el tamaño del proyecto y el número de hilos
+ */
+
+#include <compiler/testing/ProjectGenerator.h>
+#include <compiler/frontend/Preprocessor.h>
+#include <compiler/frontend/lexer/Lexer.h>
+#include <compiler/common/diagnostics/SourceManager.h>
+#include <compiler/common/utils/ThreadPool.h>
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace cpp20::compiler;
+
+namespace {
+
+/**
+ * Tokens preprocesados/s de todas las unidades de un proyecto generado;
+ * argumentos: unidades y hilos. Si items_per_second deja de crecer con los
+ * hilos, o cae al crecer las unidades, ahí está el límite de escalado.
+ */
+void BM_ProjectPreprocess(benchmark::State& state) {
+    testing::ProjectShape shape;
+    shape.translationUnits = static_cast<size_t>(state.range(0));
+    shape.includeDepth = 16;
+    shape.templates = 32;
+    shape.instantiationsPerTemplate = 8;
+    size_t jobs = static_cast<size_t>(state.range(1));
+
+    auto root = std::filesystem::temp_directory_path() /
+                ("cpp20-bench-project-" + std::to_string(shape.translationUnits));
+    std::string error;
+    if (!testing::ProjectGenerator(shape).write(root, &error)) {
+        state.SkipWithError(error.c_str());
+        return;
+    }
+
+    std::vector<std::string> sources;
+    for (size_t unit = 0; unit < shape.translationUnits; ++unit) {
+        std::ifstream in(root / "src" / ("unit" + std::to_string(unit) + ".cpp"), std::ios::binary);
+        sources.emplace_back(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    std::atomic<size_t> tokens{0};
+    for (auto _ : state) {
+        tokens = 0;
+        common::utils::parallelFor(sources.size(), jobs, [&](size_t unit) {
+            auto sourceManager = std::make_shared<diagnostics::SourceManager>();
+            sourceManager->addIncludePath(root / "include", false);
+            diagnostics::DiagnosticEngine diagEngine(sourceManager);
+            frontend::Preprocessor preprocessor(diagEngine);
+            frontend::lexer::Lexer lexer(sources[unit], diagEngine);
+            tokens += preprocessor.process(lexer).size();
+        });
+    }
+    std::filesystem::remove_all(root);
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * tokens.load()));
+    state.counters["tokens"] = static_cast<double>(tokens.load());
+}
+BENCHMARK(BM_ProjectPreprocess)
+    ->ArgsProduct({{16, 128}, {1, 2, 4, 8}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
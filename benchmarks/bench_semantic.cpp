@@ -0,0 +1,122 @@
+/**
+ * @file bench_semantic.cpp
+ * @brief Rendimiento de la instanciación de templates y del VM constexpr
+ */
+
+#include <compiler/templates/TemplateSystem.h>
+#include <compiler/constexpr/ConstexprEvaluator.h>
+#include <compiler/ast/ASTContext.h>
+#include <compiler/ast/ExpressionAST.h>
+#include <compiler/ast/StatementAST.h>
+#include <compiler/ast/DeclarationAST.h>
+#include <compiler/common/diagnostics/SourceManager.h>
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace cpp20::compiler;
+
+namespace {
+
+// Instanciaciones/s: un template unario pedido con N argumentos distintos
+void BM_TemplateInstantiations(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+    size_t jobs = static_cast<size_t>(state.range(1));
+    auto sourceManager = std::make_shared<diagnostics::SourceManager>();
+    diagnostics::DiagnosticEngine diagEngine(sourceManager);
+    diagnostics::SourceLocation loc;
+
+    std::vector<std::string> arguments;
+    for (size_t i = 0; i < count; ++i) {
+        arguments.push_back("Type" + std::to_string(i));
+    }
+
+    size_t instantiated = 0;
+    for (auto _ : state) {
+        // Motor nuevo en cada iteración: la caché no debe ahorrar trabajo
+        state.PauseTiming();
+        ast::ASTContext context;
+        semantic::ConstraintSolver solver(diagEngine);
+        semantic::TemplateInstantiationEngine engine(diagEngine, solver);
+        std::vector<ast::TemplateParameter*> parameters = {
+            context.create<ast::TemplateParameter>(ast::TemplateParameterType::Type,
+                                                   context.copyString("T"), nullptr, loc),
+        };
+        auto* list = context.create<ast::TemplateParameterList>(context.makeList(parameters), loc);
+        engine.registerTemplate(std::make_unique<semantic::TemplateInfo>("box", list, nullptr));
+        state.ResumeTiming();
+
+        for (const auto& argument : arguments) {
+            engine.requestInstantiation("box", {argument}, loc);
+        }
+        instantiated = engine.performPendingInstantiations(jobs);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * instantiated));
+    state.counters["instantiations"] = static_cast<double>(instantiated);
+}
+BENCHMARK(BM_TemplateInstantiations)
+    ->Args({1000, 1})->Args({1000, 4})
+    ->Unit(benchmark::kMillisecond);
+
+// Pasos/s del VM: int sum(int n) { int s = 0; for (int i = 1; i <= n; i += 1) s += i % 7; return s; }
+void BM_ConstexprSteps(benchmark::State& state) {
+    using Op = ast::BinaryOp::OpKind;
+    using Assign = ast::Assignment::OpKind;
+
+    auto sourceManager = std::make_shared<diagnostics::SourceManager>();
+    diagnostics::DiagnosticEngine diagEngine(sourceManager);
+    diagnostics::SourceLocation loc;
+    ast::ASTContext context;
+
+    auto name = [&](std::string_view text) {
+        return context.create<ast::Identifier>(context.copyString(text), loc);
+    };
+    auto integer = [&](int64_t value) { return context.create<ast::IntegerLiteral>(value, loc); };
+    auto binary = [&](ast::ASTNode* left, Op op, ast::ASTNode* right) {
+        return context.create<ast::BinaryOp>(left, right, op, loc);
+    };
+    auto variable = [&](std::string_view varName, ast::ASTNode* init) {
+        return context.create<ast::VariableDecl>(context.copyString(varName), "int", init, loc);
+    };
+
+    std::vector<ast::ASTNode*> statements = {
+        variable("s", integer(0)),
+        context.create<ast::ForStmt>(
+            variable("i", integer(1)),
+            binary(name("i"), Op::LessEqual, name("n")),
+            context.create<ast::Assignment>(name("i"), integer(1), Assign::AddAssign, loc),
+            context.create<ast::ExprStmt>(
+                context.create<ast::Assignment>(name("s"), binary(name("i"), Op::Modulo, integer(7)),
+                                                Assign::AddAssign, loc), loc),
+            loc),
+        context.create<ast::ReturnStmt>(name("s"), loc),
+    };
+    std::vector<ast::ParameterDecl*> parameters = {
+        context.create<ast::ParameterDecl>(context.copyString("n"), "int", loc),
+    };
+    auto* sum = context.create<ast::FunctionDecl>(context.copyString("sum"), "int",
+                                                  context.makeList(parameters),
+                                                  context.create<ast::CompoundStmt>(context.makeList(statements), loc),
+                                                  loc);
+
+    int limit = static_cast<int>(state.range(0));
+    size_t steps = 0;
+    for (auto _ : state) {
+        // VM nuevo en cada iteración: la memoización respondería sin ejecutar
+        constexpr_eval::ConstexprVM vm(diagEngine);
+        vm.setLimits(100000000);
+        vm.registerFunction("sum", sum);
+        auto result = vm.call("sum", {constexpr_eval::ConstexprValue(limit)});
+        if (result.result != constexpr_eval::EvaluationResult::Success) {
+            state.SkipWithError(result.errorMessage.c_str());
+            break;
+        }
+        steps = result.stepsExecuted;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * steps));
+    state.counters["steps"] = static_cast<double>(steps);
+}
+BENCHMARK(BM_ConstexprSteps)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "ASTNode.h"
+#include <compiler/common/utils/MemoryPool.h>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace cpp20::compiler::ast {
+
+/**
+ * @brief Propietario de los nodos AST de una unidad de traducción
+ *
+ * Nodos, listas de hijos y cadenas se asignan en un MemoryPool: la
+ * construcción es un avance de puntero y la destrucción, el reset del
+ * pool. Sin pool externo el contexto crea uno propio; con pool externo el
+ * AST vive lo que viva ese pool.
+ */
+class ASTContext {
+public:
+    /**
+     * @brief Constructor
+     * @param pool Arena de la unidad (nullptr = arena propia)
+     */
+    explicit ASTContext(common::utils::MemoryPool* pool = nullptr)
+        : ownedPool_(pool ? nullptr : std::make_unique<common::utils::MemoryPool>(64 * 1024)),
+          pool_(pool ? pool : ownedPool_.get()) {
+        if (ownedPool_) ownedPool_->setSubsystem(common::utils::MemorySubsystem::AST);
+    }
+
+    ASTContext(const ASTContext&) = delete;
+    ASTContext& operator=(const ASTContext&) = delete;
+
+    /**
+     * @brief Construir un nodo en la arena
+     */
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_base_of_v<ASTNode, T>, "solo nodos AST");
+        static_assert(std::is_trivially_destructible_v<T>,
+                      "los nodos no registran destructores: usar NodeList y copyString");
+        ++nodeCount_;
+        return pool_->create<T>(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Copiar una lista de hijos a un arreglo contiguo de la arena
+     */
+    template<typename T>
+    NodeList<T> makeList(const std::vector<T*>& nodes) {
+        if (nodes.empty()) {
+            return NodeList<T>();
+        }
+        auto** data = static_cast<T**>(pool_->allocate(nodes.size() * sizeof(T*), alignof(T*)));
+        std::memcpy(data, nodes.data(), nodes.size() * sizeof(T*));
+        return NodeList<T>(data, static_cast<uint32_t>(nodes.size()));
+    }
+
+    /**
+     * @brief Copiar una cadena a la arena (los nodos guardan string_view)
+     */
+    std::string_view copyString(std::string_view text) {
+        if (text.empty()) {
+            return std::string_view();
+        }
+        auto* data = static_cast<char*>(pool_->allocate(text.size(), 1));
+        std::memcpy(data, text.data(), text.size());
+        return std::string_view(data, text.size());
+    }
+
+    /**
+     * @brief Copia única en la arena de un texto repetido (literales)
+     *
+     * Las tablas de constantes repiten los mismos literales: cada texto
+     * distinto se copia una vez y las demás apariciones comparten la vista.
+     */
+    std::string_view internString(std::string_view text) {
+        if (text.empty()) {
+            return std::string_view();
+        }
+        auto existing = interned_.find(text);
+        if (existing != interned_.end()) {
+            ++internHits_;
+            return *existing;
+        }
+        std::string_view copy = copyString(text);
+        interned_.insert(copy);
+        return copy;
+    }
+
+    /**
+     * @brief Veces que internString() devolvió una copia ya existente
+     */
+    size_t internHits() const { return internHits_; }
+
+    /**
+     * @brief Objeto trivialmente destructible en la arena (registros que no son nodos)
+     */
+    template<typename T, typename... Args>
+    const T* createRecord(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "la arena no ejecuta destructores");
+        return pool_->create<T>(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Nodos creados en este contexto
+     */
+    size_t nodeCount() const { return nodeCount_; }
+
+    common::utils::MemoryPool& pool() { return *pool_; }
+
+private:
+    std::unique_ptr<common::utils::MemoryPool> ownedPool_;
+    common::utils::MemoryPool* pool_;
+    size_t nodeCount_ = 0;
+    std::unordered_set<std::string_view> interned_;  // Vistas sobre la arena
+    size_t internHits_ = 0;
+};
+
+} // namespace cpp20::compiler::ast
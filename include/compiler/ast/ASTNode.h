@@ -1,8 +1,8 @@
 #pragma once
 
 #include <compiler/common/diagnostics/SourceLocation.h>
-#include <memory>
-#include <vector>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 // Forward declaration para tipos
@@ -15,7 +15,7 @@ namespace cpp20::compiler::ast {
 /**
  * @brief Tipos de nodos AST
  */
-enum class ASTNodeKind {
+enum class ASTNodeKind : uint8_t {
     // Expresiones
     Literal,
     IntegerLiteral,
@@ -39,6 +39,7 @@ enum class ASTNodeKind {
     // Declaraciones
     VariableDecl,
     FunctionDecl,
+    ParameterDecl,
     ClassDecl,
     EnumDecl,
     UsingDecl,
@@ -46,6 +47,7 @@ enum class ASTNodeKind {
 
     // Sentencias
     CompoundStmt,
+    ExprStmt,
     IfStmt,
     WhileStmt,
     ForStmt,
@@ -61,17 +63,58 @@ enum class ASTNodeKind {
     NamespaceDecl,
     TemplateDecl,
     ConceptDecl,
-    RequiresExpr
+    RequiresExpr,
+
+    // Templates y concepts
+    TemplateParameter,
+    TemplateParameterList,
+    TemplateArgument,
+    TemplateArgumentList,
+    TemplateInstantiation,
+    TemplateSpecialization,
+    RequiresClause,
+    ConstraintExpr
+};
+
+class ASTNode;
+
+/**
+ * @brief Secuencia de hijos: arreglo contiguo de punteros dentro de la arena
+ *
+ * No es propietaria; el arreglo y los nodos viven en el ASTContext que
+ * los creó. Ocupa lo mismo que un puntero y un contador, frente a los
+ * tres punteros y la reserva en el heap de un std::vector.
+ */
+template<typename T = ASTNode>
+class NodeList {
+public:
+    NodeList() = default;
+    NodeList(T* const* data, uint32_t size) : data_(data), size_(size) {}
+
+    T* const* begin() const { return data_; }
+    T* const* end() const { return data_ + size_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    T* operator[](size_t index) const { return data_[index]; }
+
+private:
+    T* const* data_ = nullptr;
+    uint32_t size_ = 0;
 };
 
 /**
  * @brief Clase base para todos los nodos del AST
+ *
+ * Los nodos no tienen vtable: el tipo concreto se obtiene de kind() y se
+ * recorre con ASTVisitor (ASTVisitor.h), que despacha con un switch. Todos
+ * se construyen en la arena de un ASTContext y son trivialmente
+ * destructibles, de modo que destruir el AST de una unidad es liberar sus
+ * bloques de memoria.
  */
 class ASTNode {
 public:
     ASTNode(ASTNodeKind kind, diagnostics::SourceLocation location)
         : kind_(kind), location_(location) {}
-    virtual ~ASTNode() = default;
 
     /**
      * @brief Obtiene el tipo de nodo AST
@@ -87,9 +130,10 @@ public:
     ASTNodeKind kind() const { return kind_; }
     const diagnostics::SourceLocation& location() const { return location_; }
 
-    // Utilidades
-    virtual void accept(class ASTVisitor* visitor) = 0;
-    virtual std::string toString() const = 0;
+    /**
+     * @brief Representación textual (despacha por kind() al nodo concreto)
+     */
+    std::string toString() const;
 
     // Información de tipos (se establece durante análisis semántico)
     const class cpp20::compiler::types::Type* type() const { return type_; }
@@ -106,37 +150,20 @@ private:
  */
 class TranslationUnit : public ASTNode {
 public:
-    TranslationUnit(diagnostics::SourceLocation location)
-        : ASTNode(ASTNodeKind::TranslationUnit, location) {}
-
-    void addDeclaration(std::unique_ptr<ASTNode> decl) {
-        declarations_.push_back(std::move(decl));
-    }
+    TranslationUnit(NodeList<> declarations, diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::TranslationUnit, location), declarations_(declarations) {}
 
-    const std::vector<std::unique_ptr<ASTNode>>& declarations() const {
-        return declarations_;
-    }
+    NodeList<> declarations() const { return declarations_; }
 
-    void accept(class ASTVisitor* visitor) override;
-    std::string toString() const override;
+    std::string toString() const;
 
 private:
-    std::vector<std::unique_ptr<ASTNode>> declarations_;
+    NodeList<> declarations_;
 };
 
 /**
- * @brief Visitor pattern para recorrer el AST
+ * @brief Nombre del tipo de nodo (para volcados y diagnósticos)
  */
-class ASTVisitor {
-public:
-    virtual ~ASTVisitor() = default;
-
-    // Visit methods para cada tipo de nodo
-    virtual void visit(TranslationUnit* node) = 0;
-
-    // Métodos helper
-    virtual void visitChildren(ASTNode* node);
-    virtual void visitNode(ASTNode* node);
-};
+const char* nodeKindName(ASTNodeKind kind);
 
 } // namespace cpp20::compiler::ast
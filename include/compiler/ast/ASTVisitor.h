@@ -0,0 +1,211 @@
+#pragma once
+
+#include "ASTNode.h"
+#include "ExpressionAST.h"
+#include "StatementAST.h"
+#include "DeclarationAST.h"
+#include "TemplateAST.h"
+
+namespace cpp20::compiler::ast {
+
+/**
+ * @brief Nodos con clase concreta: NODE(ASTNodeKind, Clase)
+ *
+ * Los tipos de ASTNodeKind que aún no tienen clase se visitan con
+ * visitNode().
+ */
+#define CPP20_AST_NODE_CLASSES(NODE) \
+    NODE(TranslationUnit, TranslationUnit) \
+    NODE(Literal, Literal) \
+    NODE(IntegerLiteral, IntegerLiteral) \
+    NODE(FloatingPointLiteral, FloatingPointLiteral) \
+    NODE(CharacterLiteral, CharacterLiteral) \
+    NODE(StringLiteral, StringLiteral) \
+    NODE(BooleanLiteral, BooleanLiteral) \
+    NODE(Identifier, Identifier) \
+    NODE(BinaryOp, BinaryOp) \
+    NODE(UnaryOp, UnaryOp) \
+    NODE(FunctionCall, FunctionCall) \
+    NODE(TernaryOp, TernaryOp) \
+    NODE(Assignment, Assignment) \
+    NODE(VariableDecl, VariableDecl) \
+    NODE(FunctionDecl, FunctionDecl) \
+    NODE(ParameterDecl, ParameterDecl) \
+    NODE(CompoundStmt, CompoundStmt) \
+    NODE(ExprStmt, ExprStmt) \
+    NODE(IfStmt, IfStmt) \
+    NODE(WhileStmt, WhileStmt) \
+    NODE(ForStmt, ForStmt) \
+    NODE(ReturnStmt, ReturnStmt) \
+    NODE(TemplateParameter, TemplateParameter) \
+    NODE(TemplateParameterList, TemplateParameterList) \
+    NODE(TemplateDecl, TemplateDeclaration) \
+    NODE(TemplateArgument, TemplateArgument) \
+    NODE(TemplateArgumentList, TemplateArgumentList) \
+    NODE(TemplateInstantiation, TemplateInstantiation) \
+    NODE(TemplateSpecialization, TemplateSpecialization) \
+    NODE(ConceptDecl, ConceptDefinition) \
+    NODE(RequiresClause, RequiresClause) \
+    NODE(RequiresExpr, RequiresExpression) \
+    NODE(ConstraintExpr, ConstraintExpression)
+
+/**
+ * @brief Invocar func(hijo) para cada hijo no nulo, en orden de fuente
+ */
+template<typename Func>
+void forEachChild(ASTNode* node, Func&& func) {
+    auto visit = [&func](ASTNode* child) {
+        if (child) {
+            func(child);
+        }
+    };
+
+    switch (node->kind()) {
+        case ASTNodeKind::TranslationUnit:
+            for (ASTNode* decl : static_cast<TranslationUnit*>(node)->declarations()) visit(decl);
+            break;
+        case ASTNodeKind::BinaryOp:
+            visit(static_cast<BinaryOp*>(node)->getLeft());
+            visit(static_cast<BinaryOp*>(node)->getRight());
+            break;
+        case ASTNodeKind::UnaryOp:
+            visit(static_cast<UnaryOp*>(node)->getOperand());
+            break;
+        case ASTNodeKind::FunctionCall:
+            visit(static_cast<FunctionCall*>(node)->getCallee());
+            for (ASTNode* argument : static_cast<FunctionCall*>(node)->getArguments()) visit(argument);
+            break;
+        case ASTNodeKind::TernaryOp:
+            visit(static_cast<TernaryOp*>(node)->getCondition());
+            visit(static_cast<TernaryOp*>(node)->getTrueExpr());
+            visit(static_cast<TernaryOp*>(node)->getFalseExpr());
+            break;
+        case ASTNodeKind::Assignment:
+            visit(static_cast<Assignment*>(node)->getLeft());
+            visit(static_cast<Assignment*>(node)->getRight());
+            break;
+        case ASTNodeKind::VariableDecl:
+            visit(static_cast<VariableDecl*>(node)->getInitializer());
+            break;
+        case ASTNodeKind::FunctionDecl:
+            for (ParameterDecl* parameter : static_cast<FunctionDecl*>(node)->getParameters()) visit(parameter);
+            visit(static_cast<FunctionDecl*>(node)->getBody());
+            break;
+        case ASTNodeKind::CompoundStmt:
+            for (ASTNode* statement : static_cast<CompoundStmt*>(node)->getStatements()) visit(statement);
+            break;
+        case ASTNodeKind::ExprStmt:
+            visit(static_cast<ExprStmt*>(node)->getExpression());
+            break;
+        case ASTNodeKind::IfStmt:
+            visit(static_cast<IfStmt*>(node)->getCondition());
+            visit(static_cast<IfStmt*>(node)->getThen());
+            visit(static_cast<IfStmt*>(node)->getElse());
+            break;
+        case ASTNodeKind::WhileStmt:
+            visit(static_cast<WhileStmt*>(node)->getCondition());
+            visit(static_cast<WhileStmt*>(node)->getBody());
+            break;
+        case ASTNodeKind::ForStmt:
+            visit(static_cast<ForStmt*>(node)->getInit());
+            visit(static_cast<ForStmt*>(node)->getCondition());
+            visit(static_cast<ForStmt*>(node)->getIncrement());
+            visit(static_cast<ForStmt*>(node)->getBody());
+            break;
+        case ASTNodeKind::ReturnStmt:
+            visit(static_cast<ReturnStmt*>(node)->getValue());
+            break;
+        case ASTNodeKind::TemplateParameter:
+            visit(static_cast<TemplateParameter*>(node)->getDefaultValue());
+            break;
+        case ASTNodeKind::TemplateParameterList:
+            for (TemplateParameter* parameter : static_cast<TemplateParameterList*>(node)->getParameters()) visit(parameter);
+            break;
+        case ASTNodeKind::TemplateDecl:
+            visit(static_cast<TemplateDeclaration*>(node)->getParameters());
+            visit(static_cast<TemplateDeclaration*>(node)->getDeclaration());
+            break;
+        case ASTNodeKind::TemplateArgument:
+            visit(static_cast<TemplateArgument*>(node)->getValue());
+            break;
+        case ASTNodeKind::TemplateArgumentList:
+            for (TemplateArgument* argument : static_cast<TemplateArgumentList*>(node)->getArguments()) visit(argument);
+            break;
+        case ASTNodeKind::TemplateInstantiation:
+            visit(static_cast<TemplateInstantiation*>(node)->getTemplateName());
+            visit(static_cast<TemplateInstantiation*>(node)->getArguments());
+            break;
+        case ASTNodeKind::TemplateSpecialization:
+            visit(static_cast<TemplateSpecialization*>(node)->getTemplateName());
+            visit(static_cast<TemplateSpecialization*>(node)->getArguments());
+            visit(static_cast<TemplateSpecialization*>(node)->getBody());
+            break;
+        case ASTNodeKind::ConceptDecl:
+            visit(static_cast<ConceptDefinition*>(node)->getParameters());
+            visit(static_cast<ConceptDefinition*>(node)->getConstraintExpression());
+            break;
+        case ASTNodeKind::RequiresClause:
+            visit(static_cast<RequiresClause*>(node)->getRequirements());
+            break;
+        case ASTNodeKind::RequiresExpr:
+            visit(static_cast<RequiresExpression*>(node)->getParameters());
+            visit(static_cast<RequiresExpression*>(node)->getRequirements());
+            break;
+        case ASTNodeKind::ConstraintExpr:
+            visit(static_cast<ConstraintExpression*>(node)->getLeft());
+            visit(static_cast<ConstraintExpression*>(node)->getRight());
+            break;
+        default:
+            break; // Hojas y nodos sin clase concreta
+    }
+}
+
+/**
+ * @brief Visitor sin vtable: despacha con switch (kind()) al método de Derived
+ *
+ * Derived redefine los visitX que le interesan; los demás caen en
+ * visitNode(), que por defecto recorre los hijos.
+ * @code
+ *   struct Counter : ASTVisitor<Counter> {
+ *       size_t literals = 0;
+ *       void visitIntegerLiteral(IntegerLiteral*) { ++literals; }
+ *   };
+ * @endcode
+ */
+template<typename Derived, typename RetTy = void>
+class ASTVisitor {
+public:
+    RetTy visit(ASTNode* node) {
+        switch (node->kind()) {
+#define CPP20_AST_VISIT_CASE(Kind, Class) \
+            case ASTNodeKind::Kind: \
+                return derived().visit##Class(static_cast<Class*>(node));
+            CPP20_AST_NODE_CLASSES(CPP20_AST_VISIT_CASE)
+#undef CPP20_AST_VISIT_CASE
+            default:
+                return derived().visitNode(node);
+        }
+    }
+
+#define CPP20_AST_VISIT_DEFAULT(Kind, Class) \
+    RetTy visit##Class(Class* node) { return derived().visitNode(node); }
+    CPP20_AST_NODE_CLASSES(CPP20_AST_VISIT_DEFAULT)
+#undef CPP20_AST_VISIT_DEFAULT
+
+    /**
+     * @brief Caso por defecto: recorrer los hijos
+     */
+    RetTy visitNode(ASTNode* node) {
+        visitChildren(node);
+        return RetTy();
+    }
+
+    void visitChildren(ASTNode* node) {
+        forEachChild(node, [this](ASTNode* child) { derived().visit(child); });
+    }
+
+protected:
+    Derived& derived() { return *static_cast<Derived*>(this); }
+};
+
+} // namespace cpp20::compiler::ast
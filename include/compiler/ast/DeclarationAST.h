@@ -0,0 +1,97 @@
+#pragma once
+
+#include "ASTNode.h"
+#include <string>
+#include <string_view>
+
+namespace cpp20::compiler::ast {
+
+class CompoundStmt;
+
+/**
+ * @brief Declaración de variable: tipo nombre [= inicializador];
+ *
+ * typeName conserva los especificadores tal como se escribieron
+ * ("const unsigned int") hasta que el análisis semántico los resuelva.
+ */
+class VariableDecl : public ASTNode {
+public:
+    VariableDecl(std::string_view name, std::string_view typeName, ASTNode* initializer,
+                 diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::VariableDecl, location),
+          name_(name), typeName_(typeName), initializer_(initializer) {}
+
+    std::string_view getName() const { return name_; }
+    std::string_view getTypeName() const { return typeName_; }
+    ASTNode* getInitializer() const { return initializer_; }
+
+    std::string toString() const;
+
+private:
+    std::string_view name_;
+    std::string_view typeName_;
+    ASTNode* initializer_;
+};
+
+/**
+ * @brief Parámetro de función (nombre vacío si se omite)
+ */
+class ParameterDecl : public ASTNode {
+public:
+    ParameterDecl(std::string_view name, std::string_view typeName, diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::ParameterDecl, location), name_(name), typeName_(typeName) {}
+
+    std::string_view getName() const { return name_; }
+    std::string_view getTypeName() const { return typeName_; }
+
+    std::string toString() const;
+
+private:
+    std::string_view name_;
+    std::string_view typeName_;
+};
+
+/**
+ * @brief Declaración o definición de función (body nullptr si solo se declara)
+ *
+ * Con cuerpos diferidos el parser guarda solo el rango de tokens del
+ * cuerpo; getBody() es nullptr hasta que Parser::parseDelayedBody lo parsea.
+ */
+class FunctionDecl : public ASTNode {
+public:
+    FunctionDecl(std::string_view name, std::string_view returnType, NodeList<ParameterDecl> parameters,
+                 CompoundStmt* body, diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::FunctionDecl, location),
+          name_(name), returnType_(returnType), parameters_(parameters), body_(body) {}
+
+    std::string_view getName() const { return name_; }
+    std::string_view getReturnType() const { return returnType_; }
+    NodeList<ParameterDecl> getParameters() const { return parameters_; }
+    CompoundStmt* getBody() const { return body_; }
+    void setBody(CompoundStmt* body) { body_ = body; delayedBegin_ = delayedEnd_ = 0; }
+
+    /**
+     * @brief Cuerpo pendiente: tokens [delayedBodyBegin, delayedBodyEnd) del parser
+     */
+    bool hasDelayedBody() const { return delayedEnd_ != 0; }
+    uint32_t delayedBodyBegin() const { return delayedBegin_; }
+    uint32_t delayedBodyEnd() const { return delayedEnd_; }
+    void setDelayedBody(uint32_t begin, uint32_t end) { delayedBegin_ = begin; delayedEnd_ = end; }
+
+    /**
+     * @brief Definición (cuerpo ya parseado o pendiente) frente a declaración
+     */
+    bool isDefinition() const { return body_ || hasDelayedBody(); }
+
+    std::string toString() const;
+
+private:
+    std::string_view name_;
+    std::string_view returnType_;
+    NodeList<ParameterDecl> parameters_;
+    CompoundStmt* body_;
+    uint32_t delayedBegin_ = 0;
+    uint32_t delayedEnd_ = 0;
+};
+
+} // namespace cpp20::compiler::ast
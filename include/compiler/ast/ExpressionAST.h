@@ -2,41 +2,84 @@
 
 #include "ASTNode.h"
 #include <string>
-#include <vector>
-#include <memory>
+#include <string_view>
 
 namespace cpp20::compiler::ast {
 
+/**
+ * @brief Literal sin valor interpretado (nullptr, literales de usuario)
+ */
+class Literal : public ASTNode {
+public:
+    Literal(std::string_view spelling, diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::Literal, location), spelling_(spelling) {}
+
+    std::string_view getSpelling() const { return spelling_; }
+    std::string toString() const { return std::string(spelling_); }
+
+private:
+    std::string_view spelling_;
+};
+
 /**
  * @brief Nodo para literales enteros
+ *
+ * También es el resultado de una expresión constante plegada por el
+ * parser (`1 << 20`): el árbol original no se construye y solo queda su
+ * rango en el fuente para los diagnósticos.
  */
 class IntegerLiteral : public ASTNode {
 public:
-    explicit IntegerLiteral(int64_t value, diagnostics::SourceLocation location)
-        : ASTNode(ASTNodeKind::IntegerLiteral, location), value_(value) {}
+    explicit IntegerLiteral(int64_t value, diagnostics::SourceLocation location,
+                            const diagnostics::SourceRange* foldedFrom = nullptr, bool isInt = true)
+        : ASTNode(ASTNodeKind::IntegerLiteral, location), value_(value), foldedFrom_(foldedFrom),
+          isInt_(isInt) {}
 
     int64_t getValue() const { return value_; }
-    void accept(ASTVisitor* visitor) override;
-    std::string toString() const override { return std::to_string(value_); }
+    std::string toString() const { return std::to_string(value_); }
+
+    /**
+     * @brief Rango de la expresión plegada (nullptr si es un literal escrito)
+     */
+    const diagnostics::SourceRange* getFoldedRange() const { return foldedFrom_; }
+
+    /**
+     * @brief El literal es de tipo int: sin sufijo y representable en int
+     *
+     * Los demás (`1u`, `3000000000`, `2L`) no se pliegan.
+     */
+    bool isInt() const { return isInt_; }
 
 private:
     int64_t value_;
+    const diagnostics::SourceRange* foldedFrom_;  // En la arena
+    bool isInt_;
 };
 
 /**
- * @brief Nodo para literales de punto flotante
+ * @brief Nodo para literales de punto flotante (o expresiones plegadas, como IntegerLiteral)
  */
 class FloatingPointLiteral : public ASTNode {
 public:
-    explicit FloatingPointLiteral(double value, diagnostics::SourceLocation location)
-        : ASTNode(ASTNodeKind::FloatingPointLiteral, location), value_(value) {}
+    explicit FloatingPointLiteral(double value, diagnostics::SourceLocation location,
+                                  const diagnostics::SourceRange* foldedFrom = nullptr, bool isDouble = true)
+        : ASTNode(ASTNodeKind::FloatingPointLiteral, location), value_(value), foldedFrom_(foldedFrom),
+          isDouble_(isDouble) {}
 
     double getValue() const { return value_; }
-    void accept(ASTVisitor* visitor) override;
-    std::string toString() const override { return std::to_string(value_); }
+    std::string toString() const { return std::to_string(value_); }
+
+    const diagnostics::SourceRange* getFoldedRange() const { return foldedFrom_; }
+
+    /**
+     * @brief El literal es de tipo double (sin sufijo f ni l)
+     */
+    bool isDouble() const { return isDouble_; }
 
 private:
     double value_;
+    const diagnostics::SourceRange* foldedFrom_;
+    bool isDouble_;
 };
 
 /**
@@ -48,27 +91,25 @@ public:
         : ASTNode(ASTNodeKind::CharacterLiteral, location), value_(value) {}
 
     char getValue() const { return value_; }
-    void accept(ASTVisitor* visitor) override;
-    std::string toString() const override { return std::string(1, value_); }
+    std::string toString() const { return std::string(1, value_); }
 
 private:
     char value_;
 };
 
 /**
- * @brief Nodo para literales de cadenas
+ * @brief Nodo para literales de cadenas (texto en la arena del ASTContext)
  */
 class StringLiteral : public ASTNode {
 public:
-    explicit StringLiteral(std::string value, diagnostics::SourceLocation location)
-        : ASTNode(ASTNodeKind::StringLiteral, location), value_(std::move(value)) {}
+    explicit StringLiteral(std::string_view value, diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::StringLiteral, location), value_(value) {}
 
-    const std::string& getValue() const { return value_; }
-    void accept(ASTVisitor* visitor) override;
-    std::string toString() const override { return "\"" + value_ + "\""; }
+    std::string_view getValue() const { return value_; }
+    std::string toString() const { return "\"" + std::string(value_) + "\""; }
 
 private:
-    std::string value_;
+    std::string_view value_;
 };
 
 /**
@@ -80,39 +121,56 @@ public:
         : ASTNode(ASTNodeKind::BooleanLiteral, location), value_(value) {}
 
     bool getValue() const { return value_; }
-    void accept(ASTVisitor* visitor) override;
-    std::string toString() const override { return value_ ? "true" : "false"; }
+    std::string toString() const { return value_ ? "true" : "false"; }
 
 private:
     bool value_;
 };
 
+/**
+ * @brief Nodo para referencias a nombres
+ */
+class Identifier : public ASTNode {
+public:
+    Identifier(std::string_view name, diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::Identifier, location), name_(name) {}
+
+    std::string_view getName() const { return name_; }
+    std::string toString() const { return std::string(name_); }
+
+private:
+    std::string_view name_;
+};
+
 /**
  * @brief Nodo para operaciones binarias
  */
 class BinaryOp : public ASTNode {
 public:
-    enum class OpKind {
+    enum class OpKind : uint8_t {
         Add, Subtract, Multiply, Divide, Modulo,
         Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual,
-        LogicalAnd, LogicalOr, BitwiseAnd, BitwiseOr, BitwiseXor
+        LogicalAnd, LogicalOr, BitwiseAnd, BitwiseOr, BitwiseXor,
+        LeftShift, RightShift
     };
 
-    BinaryOp(std::unique_ptr<ASTNode> left, std::unique_ptr<ASTNode> right,
-             OpKind op, diagnostics::SourceLocation location)
-        : ASTNode(ASTNodeKind::BinaryOp, location),
-          left_(std::move(left)), right_(std::move(right)), op_(op) {}
+    BinaryOp(ASTNode* left, ASTNode* right, OpKind op, diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::BinaryOp, location), left_(left), right_(right), op_(op) {}
 
-    const ASTNode* getLeft() const { return left_.get(); }
-    const ASTNode* getRight() const { return right_.get(); }
+    ASTNode* getLeft() const { return left_; }
+    ASTNode* getRight() const { return right_; }
     OpKind getOp() const { return op_; }
 
-    void accept(ASTVisitor* visitor) override;
-    std::string toString() const override;
+    std::string toString() const;
+
+    /**
+     * @brief Símbolo del operador ("+", "&&", ...)
+     */
+    static const char* opSpelling(OpKind op);
 
 private:
-    std::unique_ptr<ASTNode> left_;
-    std::unique_ptr<ASTNode> right_;
+    ASTNode* left_;
+    ASTNode* right_;
     OpKind op_;
 };
 
@@ -121,22 +179,25 @@ private:
  */
 class UnaryOp : public ASTNode {
 public:
-    enum class OpKind {
+    enum class OpKind : uint8_t {
         Plus, Minus, Not, BitwiseNot, AddressOf, Dereference
     };
 
-    UnaryOp(std::unique_ptr<ASTNode> operand, OpKind op, diagnostics::SourceLocation location)
-        : ASTNode(ASTNodeKind::UnaryOp, location),
-          operand_(std::move(operand)), op_(op) {}
+    UnaryOp(ASTNode* operand, OpKind op, diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::UnaryOp, location), operand_(operand), op_(op) {}
 
-    const ASTNode* getOperand() const { return operand_.get(); }
+    ASTNode* getOperand() const { return operand_; }
     OpKind getOp() const { return op_; }
 
-    void accept(ASTVisitor* visitor) override;
-    std::string toString() const override;
+    std::string toString() const;
+
+    /**
+     * @brief Símbolo del operador ("-", "!", ...)
+     */
+    static const char* opSpelling(OpKind op);
 
 private:
-    std::unique_ptr<ASTNode> operand_;
+    ASTNode* operand_;
     OpKind op_;
 };
 
@@ -145,21 +206,17 @@ private:
  */
 class FunctionCall : public ASTNode {
 public:
-    FunctionCall(std::unique_ptr<ASTNode> callee,
-                 std::vector<std::unique_ptr<ASTNode>> arguments,
-                 diagnostics::SourceLocation location)
-        : ASTNode(ASTNodeKind::FunctionCall, location),
-          callee_(std::move(callee)), arguments_(std::move(arguments)) {}
+    FunctionCall(ASTNode* callee, NodeList<> arguments, diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::FunctionCall, location), callee_(callee), arguments_(arguments) {}
 
-    const ASTNode* getCallee() const { return callee_.get(); }
-    const std::vector<std::unique_ptr<ASTNode>>& getArguments() const { return arguments_; }
+    ASTNode* getCallee() const { return callee_; }
+    NodeList<> getArguments() const { return arguments_; }
 
-    void accept(ASTVisitor* visitor) override;
-    std::string toString() const override;
+    std::string toString() const;
 
 private:
-    std::unique_ptr<ASTNode> callee_;
-    std::vector<std::unique_ptr<ASTNode>> arguments_;
+    ASTNode* callee_;
+    NodeList<> arguments_;
 };
 
 /**
@@ -167,26 +224,21 @@ private:
  */
 class TernaryOp : public ASTNode {
 public:
-    TernaryOp(std::unique_ptr<ASTNode> condition,
-              std::unique_ptr<ASTNode> trueExpr,
-              std::unique_ptr<ASTNode> falseExpr,
+    TernaryOp(ASTNode* condition, ASTNode* trueExpr, ASTNode* falseExpr,
               diagnostics::SourceLocation location)
         : ASTNode(ASTNodeKind::TernaryOp, location),
-          condition_(std::move(condition)),
-          trueExpr_(std::move(trueExpr)),
-          falseExpr_(std::move(falseExpr)) {}
+          condition_(condition), trueExpr_(trueExpr), falseExpr_(falseExpr) {}
 
-    const ASTNode* getCondition() const { return condition_.get(); }
-    const ASTNode* getTrueExpr() const { return trueExpr_.get(); }
-    const ASTNode* getFalseExpr() const { return falseExpr_.get(); }
+    ASTNode* getCondition() const { return condition_; }
+    ASTNode* getTrueExpr() const { return trueExpr_; }
+    ASTNode* getFalseExpr() const { return falseExpr_; }
 
-    void accept(ASTVisitor* visitor) override;
-    std::string toString() const override;
+    std::string toString() const;
 
 private:
-    std::unique_ptr<ASTNode> condition_;
-    std::unique_ptr<ASTNode> trueExpr_;
-    std::unique_ptr<ASTNode> falseExpr_;
+    ASTNode* condition_;
+    ASTNode* trueExpr_;
+    ASTNode* falseExpr_;
 };
 
 /**
@@ -194,26 +246,29 @@ private:
  */
 class Assignment : public ASTNode {
 public:
-    enum class OpKind {
+    enum class OpKind : uint8_t {
         Assign, AddAssign, SubtractAssign, MultiplyAssign, DivideAssign, ModuloAssign,
-        BitwiseAndAssign, BitwiseOrAssign, BitwiseXorAssign
+        BitwiseAndAssign, BitwiseOrAssign, BitwiseXorAssign,
+        LeftShiftAssign, RightShiftAssign
     };
 
-    Assignment(std::unique_ptr<ASTNode> left, std::unique_ptr<ASTNode> right,
-               OpKind op, diagnostics::SourceLocation location)
-        : ASTNode(ASTNodeKind::Assignment, location),
-          left_(std::move(left)), right_(std::move(right)), op_(op) {}
+    Assignment(ASTNode* left, ASTNode* right, OpKind op, diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::Assignment, location), left_(left), right_(right), op_(op) {}
 
-    const ASTNode* getLeft() const { return left_.get(); }
-    const ASTNode* getRight() const { return right_.get(); }
+    ASTNode* getLeft() const { return left_; }
+    ASTNode* getRight() const { return right_; }
     OpKind getOp() const { return op_; }
 
-    void accept(ASTVisitor* visitor) override;
-    std::string toString() const override;
+    std::string toString() const;
+
+    /**
+     * @brief Símbolo del operador ("=", "+=", ...)
+     */
+    static const char* opSpelling(OpKind op);
 
 private:
-    std::unique_ptr<ASTNode> left_;
-    std::unique_ptr<ASTNode> right_;
+    ASTNode* left_;
+    ASTNode* right_;
     OpKind op_;
 };
 
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "ASTNode.h"
+#include <string>
+
+namespace cpp20::compiler::ast {
+
+/**
+ * @brief Bloque { ... }
+ */
+class CompoundStmt : public ASTNode {
+public:
+    CompoundStmt(NodeList<> statements, diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::CompoundStmt, location), statements_(statements) {}
+
+    NodeList<> getStatements() const { return statements_; }
+
+    std::string toString() const;
+
+private:
+    NodeList<> statements_;
+};
+
+/**
+ * @brief Sentencia de expresión (expr;). expr es nullptr en la sentencia vacía
+ */
+class ExprStmt : public ASTNode {
+public:
+    ExprStmt(ASTNode* expression, diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::ExprStmt, location), expression_(expression) {}
+
+    ASTNode* getExpression() const { return expression_; }
+
+    std::string toString() const;
+
+private:
+    ASTNode* expression_;
+};
+
+/**
+ * @brief Sentencia if (else opcional)
+ */
+class IfStmt : public ASTNode {
+public:
+    IfStmt(ASTNode* condition, ASTNode* thenStmt, ASTNode* elseStmt,
+           diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::IfStmt, location),
+          condition_(condition), thenStmt_(thenStmt), elseStmt_(elseStmt) {}
+
+    ASTNode* getCondition() const { return condition_; }
+    ASTNode* getThen() const { return thenStmt_; }
+    ASTNode* getElse() const { return elseStmt_; }
+
+    std::string toString() const;
+
+private:
+    ASTNode* condition_;
+    ASTNode* thenStmt_;
+    ASTNode* elseStmt_;
+};
+
+/**
+ * @brief Sentencia while
+ */
+class WhileStmt : public ASTNode {
+public:
+    WhileStmt(ASTNode* condition, ASTNode* body, diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::WhileStmt, location), condition_(condition), body_(body) {}
+
+    ASTNode* getCondition() const { return condition_; }
+    ASTNode* getBody() const { return body_; }
+
+    std::string toString() const;
+
+private:
+    ASTNode* condition_;
+    ASTNode* body_;
+};
+
+/**
+ * @brief Sentencia for clásica (cada parte es opcional)
+ */
+class ForStmt : public ASTNode {
+public:
+    ForStmt(ASTNode* init, ASTNode* condition, ASTNode* increment, ASTNode* body,
+            diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::ForStmt, location),
+          init_(init), condition_(condition), increment_(increment), body_(body) {}
+
+    ASTNode* getInit() const { return init_; }
+    ASTNode* getCondition() const { return condition_; }
+    ASTNode* getIncrement() const { return increment_; }
+    ASTNode* getBody() const { return body_; }
+
+    std::string toString() const;
+
+private:
+    ASTNode* init_;
+    ASTNode* condition_;
+    ASTNode* increment_;
+    ASTNode* body_;
+};
+
+/**
+ * @brief Sentencia return (valor opcional)
+ */
+class ReturnStmt : public ASTNode {
+public:
+    ReturnStmt(ASTNode* value, diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::ReturnStmt, location), value_(value) {}
+
+    ASTNode* getValue() const { return value_; }
+
+    /**
+     * @brief [[clang::musttail]]: la llamada del valor se baja a salto (ir::IRFunction::setTailCall)
+     */
+    void setMustTail(bool mustTail = true) { mustTail_ = mustTail; }
+    bool isMustTail() const { return mustTail_; }
+
+    std::string toString() const;
+
+private:
+    ASTNode* value_;
+    bool mustTail_ = false;
+};
+
+} // namespace cpp20::compiler::ast
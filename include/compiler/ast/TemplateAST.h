@@ -6,9 +6,9 @@
 #pragma once
 
 #include <compiler/ast/ASTNode.h>
-#include <vector>
-#include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace cpp20::compiler::ast {
 
@@ -26,19 +26,21 @@ enum class TemplateParameterType {
  */
 class TemplateParameter : public ASTNode {
 public:
-    TemplateParameter(TemplateParameterType type, const std::string& name,
-                     std::unique_ptr<ASTNode> defaultValue = nullptr);
+    TemplateParameter(TemplateParameterType type, std::string_view name, ASTNode* defaultValue,
+                      diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::TemplateParameter, location),
+          parameterType_(type), name_(name), defaultValue_(defaultValue) {}
 
     TemplateParameterType getParameterType() const { return parameterType_; }
-    const std::string& getName() const { return name_; }
-    ASTNode* getDefaultValue() const { return defaultValue_.get(); }
+    std::string_view getName() const { return name_; }
+    ASTNode* getDefaultValue() const { return defaultValue_; }
 
-    void accept(ASTVisitor* visitor);
+    std::string toString() const;
 
 private:
     TemplateParameterType parameterType_;
-    std::string name_;
-    std::unique_ptr<ASTNode> defaultValue_;
+    std::string_view name_;
+    ASTNode* defaultValue_;
 };
 
 /**
@@ -46,15 +48,15 @@ private:
  */
 class TemplateParameterList : public ASTNode {
 public:
-    explicit TemplateParameterList(std::vector<std::unique_ptr<TemplateParameter>> parameters);
+    TemplateParameterList(NodeList<TemplateParameter> parameters, diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::TemplateParameterList, location), parameters_(parameters) {}
 
-    const std::vector<std::unique_ptr<TemplateParameter>>& getParameters() const { return parameters_; }
-    void addParameter(std::unique_ptr<TemplateParameter> param);
+    NodeList<TemplateParameter> getParameters() const { return parameters_; }
 
-    void accept(ASTVisitor* visitor);
+    std::string toString() const;
 
 private:
-    std::vector<std::unique_ptr<TemplateParameter>> parameters_;
+    NodeList<TemplateParameter> parameters_;
 };
 
 /**
@@ -62,17 +64,19 @@ private:
  */
 class TemplateDeclaration : public ASTNode {
 public:
-    TemplateDeclaration(std::unique_ptr<TemplateParameterList> parameters,
-                       std::unique_ptr<ASTNode> declaration);
+    TemplateDeclaration(TemplateParameterList* parameters, ASTNode* declaration,
+                        diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::TemplateDecl, location),
+          parameters_(parameters), declaration_(declaration) {}
 
-    const TemplateParameterList* getParameters() const { return parameters_.get(); }
-    ASTNode* getDeclaration() const { return declaration_.get(); }
+    TemplateParameterList* getParameters() const { return parameters_; }
+    ASTNode* getDeclaration() const { return declaration_; }
 
-    void accept(ASTVisitor* visitor);
+    std::string toString() const;
 
 private:
-    std::unique_ptr<TemplateParameterList> parameters_;
-    std::unique_ptr<ASTNode> declaration_;
+    TemplateParameterList* parameters_;
+    ASTNode* declaration_;
 };
 
 /**
@@ -86,16 +90,17 @@ public:
         Template    // template<template<typename> class>
     };
 
-    TemplateArgument(ArgumentType type, std::unique_ptr<ASTNode> value);
+    TemplateArgument(ArgumentType type, ASTNode* value, diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::TemplateArgument, location), argumentType_(type), value_(value) {}
 
     ArgumentType getArgumentType() const { return argumentType_; }
-    ASTNode* getValue() const { return value_.get(); }
+    ASTNode* getValue() const { return value_; }
 
-    void accept(ASTVisitor* visitor);
+    std::string toString() const;
 
 private:
     ArgumentType argumentType_;
-    std::unique_ptr<ASTNode> value_;
+    ASTNode* value_;
 };
 
 /**
@@ -103,15 +108,15 @@ private:
  */
 class TemplateArgumentList : public ASTNode {
 public:
-    explicit TemplateArgumentList(std::vector<std::unique_ptr<TemplateArgument>> arguments);
+    TemplateArgumentList(NodeList<TemplateArgument> arguments, diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::TemplateArgumentList, location), arguments_(arguments) {}
 
-    const std::vector<std::unique_ptr<TemplateArgument>>& getArguments() const { return arguments_; }
-    void addArgument(std::unique_ptr<TemplateArgument> arg);
+    NodeList<TemplateArgument> getArguments() const { return arguments_; }
 
-    void accept(ASTVisitor* visitor);
+    std::string toString() const;
 
 private:
-    std::vector<std::unique_ptr<TemplateArgument>> arguments_;
+    NodeList<TemplateArgument> arguments_;
 };
 
 /**
@@ -119,38 +124,41 @@ private:
  */
 class TemplateInstantiation : public ASTNode {
 public:
-    TemplateInstantiation(std::unique_ptr<ASTNode> templateName,
-                         std::unique_ptr<TemplateArgumentList> arguments);
+    TemplateInstantiation(ASTNode* templateName, TemplateArgumentList* arguments,
+                          diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::TemplateInstantiation, location),
+          templateName_(templateName), arguments_(arguments) {}
 
-    ASTNode* getTemplateName() const { return templateName_.get(); }
-    const TemplateArgumentList* getArguments() const { return arguments_.get(); }
+    ASTNode* getTemplateName() const { return templateName_; }
+    TemplateArgumentList* getArguments() const { return arguments_; }
 
-    void accept(ASTVisitor* visitor);
+    std::string toString() const;
 
 private:
-    std::unique_ptr<ASTNode> templateName_;
-    std::unique_ptr<TemplateArgumentList> arguments_;
+    ASTNode* templateName_;
+    TemplateArgumentList* arguments_;
 };
 
 /**
- * @brief Especailización template
+ * @brief Especialización template
  */
 class TemplateSpecialization : public ASTNode {
 public:
-    TemplateSpecialization(std::unique_ptr<ASTNode> templateName,
-                          std::unique_ptr<TemplateArgumentList> arguments,
-                          std::unique_ptr<ASTNode> body);
+    TemplateSpecialization(ASTNode* templateName, TemplateArgumentList* arguments, ASTNode* body,
+                           diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::TemplateSpecialization, location),
+          templateName_(templateName), arguments_(arguments), body_(body) {}
 
-    ASTNode* getTemplateName() const { return templateName_.get(); }
-    const TemplateArgumentList* getArguments() const { return arguments_.get(); }
-    ASTNode* getBody() const { return body_.get(); }
+    ASTNode* getTemplateName() const { return templateName_; }
+    TemplateArgumentList* getArguments() const { return arguments_; }
+    ASTNode* getBody() const { return body_; }
 
-    void accept(ASTVisitor* visitor);
+    std::string toString() const;
 
 private:
-    std::unique_ptr<ASTNode> templateName_;
-    std::unique_ptr<TemplateArgumentList> arguments_;
-    std::unique_ptr<ASTNode> body_;
+    ASTNode* templateName_;
+    TemplateArgumentList* arguments_;
+    ASTNode* body_;
 };
 
 /**
@@ -158,20 +166,21 @@ private:
  */
 class ConceptDefinition : public ASTNode {
 public:
-    ConceptDefinition(const std::string& name,
-                     std::unique_ptr<TemplateParameterList> parameters,
-                     std::unique_ptr<ASTNode> constraintExpression);
+    ConceptDefinition(std::string_view name, TemplateParameterList* parameters,
+                      ASTNode* constraintExpression, diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::ConceptDecl, location),
+          name_(name), parameters_(parameters), constraintExpression_(constraintExpression) {}
 
-    const std::string& getName() const { return name_; }
-    const TemplateParameterList* getParameters() const { return parameters_.get(); }
-    ASTNode* getConstraintExpression() const { return constraintExpression_.get(); }
+    std::string_view getName() const { return name_; }
+    TemplateParameterList* getParameters() const { return parameters_; }
+    ASTNode* getConstraintExpression() const { return constraintExpression_; }
 
-    void accept(ASTVisitor* visitor);
+    std::string toString() const;
 
 private:
-    std::string name_;
-    std::unique_ptr<TemplateParameterList> parameters_;
-    std::unique_ptr<ASTNode> constraintExpression_;
+    std::string_view name_;
+    TemplateParameterList* parameters_;
+    ASTNode* constraintExpression_;
 };
 
 /**
@@ -179,14 +188,15 @@ private:
  */
 class RequiresClause : public ASTNode {
 public:
-    explicit RequiresClause(std::unique_ptr<ASTNode> requirements);
+    RequiresClause(ASTNode* requirements, diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::RequiresClause, location), requirements_(requirements) {}
 
-    ASTNode* getRequirements() const { return requirements_.get(); }
+    ASTNode* getRequirements() const { return requirements_; }
 
-    void accept(ASTVisitor* visitor);
+    std::string toString() const;
 
 private:
-    std::unique_ptr<ASTNode> requirements_;
+    ASTNode* requirements_;
 };
 
 /**
@@ -194,17 +204,19 @@ private:
  */
 class RequiresExpression : public ASTNode {
 public:
-    RequiresExpression(std::unique_ptr<TemplateParameterList> parameters,
-                      std::unique_ptr<ASTNode> requirements);
+    RequiresExpression(TemplateParameterList* parameters, ASTNode* requirements,
+                       diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::RequiresExpr, location),
+          parameters_(parameters), requirements_(requirements) {}
 
-    const TemplateParameterList* getParameters() const { return parameters_.get(); }
-    ASTNode* getRequirements() const { return requirements_.get(); }
+    TemplateParameterList* getParameters() const { return parameters_; }
+    ASTNode* getRequirements() const { return requirements_; }
 
-    void accept(ASTVisitor* visitor);
+    std::string toString() const;
 
 private:
-    std::unique_ptr<TemplateParameterList> parameters_;
-    std::unique_ptr<ASTNode> requirements_;
+    TemplateParameterList* parameters_;
+    ASTNode* requirements_;
 };
 
 /**
@@ -221,20 +233,49 @@ public:
         LogicalNot      // !A
     };
 
-    ConstraintExpression(ConstraintType type,
-                        std::unique_ptr<ASTNode> left,
-                        std::unique_ptr<ASTNode> right = nullptr);
+    ConstraintExpression(ConstraintType type, ASTNode* left, ASTNode* right,
+                         diagnostics::SourceLocation location)
+        : ASTNode(ASTNodeKind::ConstraintExpr, location),
+          constraintType_(type), left_(left), right_(right) {}
 
     ConstraintType getConstraintType() const { return constraintType_; }
-    ASTNode* getLeft() const { return left_.get(); }
-    ASTNode* getRight() const { return right_.get(); }
+    ASTNode* getLeft() const { return left_; }
+    ASTNode* getRight() const { return right_; }
+
+    /**
+     * @brief node como ConstraintExpression, o nullptr si es de otro tipo
+     */
+    static const ConstraintExpression* dynCast(const ASTNode* node) {
+        return node && node->kind() == ASTNodeKind::ConstraintExpr
+            ? static_cast<const ConstraintExpression*>(node) : nullptr;
+    }
 
-    void accept(ASTVisitor* visitor);
+    std::string toString() const;
 
 private:
     ConstraintType constraintType_;
-    std::unique_ptr<ASTNode> left_;
-    std::unique_ptr<ASTNode> right_;
+    ASTNode* left_;
+    ASTNode* right_;
+};
+
+/**
+ * @brief Nombres que usa la definición de un template, según la búsqueda en dos fases
+ *
+ * Los no dependientes se ligan una vez, al definir el template. Los
+ * dependientes solo se pueden buscar al instanciar: son las llamadas no
+ * calificadas con algún argumento que depende de un parámetro (la ADL
+ * mira sus tipos). Los parámetros del template y los nombres declarados
+ * dentro de la definición no se buscan. Cada nombre aparece una vez, en
+ * orden de fuente; las vistas apuntan a la arena de la definición.
+ */
+struct TemplateNameUses {
+    std::vector<std::string_view> nonDependent;
+    std::vector<std::string_view> dependent;
 };
 
+/**
+ * @brief Clasificar los nombres de definition respecto a parameters
+ */
+TemplateNameUses collectTemplateNameUses(ASTNode* definition, const TemplateParameterList* parameters);
+
 } // namespace cpp20::compiler::ast
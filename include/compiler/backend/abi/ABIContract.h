@@ -50,6 +50,10 @@ public:
         (1 << 5)  | // RBP
         (1 << 4);   // RSP (implícitamente)
 
+    // Convención interna: R10/R11 y XMM4/XMM5 también son volátiles
+    static constexpr int MAX_FASTCALL_INTEGER_ARGS_IN_REGS = 6;
+    static constexpr int MAX_FASTCALL_FLOAT_ARGS_IN_REGS = 6;
+
     // Shadow space (espacio de sombra) - 32 bytes
     static constexpr size_t SHADOW_SPACE_SIZE = 32;
 
@@ -61,6 +65,49 @@ public:
     // ESTRUCTURAS DE DATOS DEL ABI
     // ========================================================================
 
+    /**
+     * @brief Convención de llamada
+     */
+    enum class CallingConvention {
+        Win64,              // Microsoft x64: obligatoria para todo lo visible desde fuera
+        InternalFastcall    // Opt-in para funciones internas cuya dirección no escapa
+    };
+
+    /**
+     * @brief Tipo de un parámetro o valor de retorno, lo que el ABI necesita saber
+     */
+    struct ValueType {
+        size_t size = 0;
+        size_t alignment = 1;
+        bool isFloat = false;           // float/double escalar
+        bool isSigned = false;
+        bool isVector = false;          // __m128/__m256
+        bool isAggregate = false;       // struct/union/class
+        bool isPOD = true;              // Agregados: POD de C++03 (retorno en RAX en Win64)
+        uint8_t floatFields = 0;        // Agregados con solo campos float o solo double: cuántos
+
+        static ValueType integer(size_t size, bool isSigned = false) {
+            ValueType type;
+            type.size = type.alignment = size;
+            type.isSigned = isSigned;
+            return type;
+        }
+        static ValueType floating(size_t size) {
+            ValueType type;
+            type.size = type.alignment = size;
+            type.isFloat = true;
+            return type;
+        }
+        static ValueType aggregate(size_t size, size_t alignment, uint8_t floatFields = 0) {
+            ValueType type;
+            type.size = size;
+            type.alignment = alignment;
+            type.isAggregate = true;
+            type.floatFields = floatFields;
+            return type;
+        }
+    };
+
     /**
      * @brief Información de un parámetro para paso de argumentos
      */
@@ -78,6 +125,9 @@ public:
         bool isSigned;      // Para enteros
         bool inRegister;    // Si se pasa en registro
         int registerIndex;  // Índice del registro (-1 si stack)
+        bool byReference = false;   // Se pasa un puntero a una copia del llamador
+        bool usesXmm = false;       // El registro es XMM (si no, de propósito general)
+        int registerCount = 1;      // Registros consecutivos que ocupa (2: mitades de 16 bytes)
 
         ParameterInfo(Kind k, size_t sz, size_t align, bool reg = false, int regIdx = -1, bool sign = false)
             : kind(k), size(sz), alignment(align), isSigned(sign),
@@ -100,9 +150,10 @@ public:
         size_t size;
         bool isIndirect;    // Retorno por referencia
         ParameterInfo::Kind underlyingKind;
+        int registerCount = 1;  // RAX:RDX o XMM0:XMM1 en InternalFastcall
 
         ReturnInfo(Kind k = Kind::Void, size_t sz = 0, bool indirect = false)
-            : kind(k), size(sz), isIndirect(indirect) {}
+            : kind(k), size(sz), isIndirect(indirect), underlyingKind(ParameterInfo::Kind::Integer) {}
     };
 
     /**
@@ -137,16 +188,61 @@ public:
 
     /**
      * @brief Determina cómo pasar un parámetro según el ABI
+     *
+     * Regla de Win64: lo que mide 1, 2, 4 u 8 bytes, agregados incluidos,
+     * va como un entero de ese tamaño; los float y double escalares en
+     * XMM; todo lo demás, __m128 incluido, por referencia a una copia.
+     * No asigna registro: eso depende de la posición (classifyParameters).
      */
     static ParameterInfo classifyParameter(
         size_t size, size_t alignment, bool isFloat, bool isSigned = false);
 
+    static ParameterInfo classifyParameter(const ValueType& type,
+                                           CallingConvention convention = CallingConvention::Win64);
+
+    /**
+     * @brief Clasifica los parámetros de una firma y les asigna registro
+     *
+     * Win64 es posicional: el parámetro i usa RCX/RDX/R8/R9 o XMMi si
+     * i < 4, y el puntero de retorno oculto ocupa la primera posición.
+     * InternalFastcall cuenta por separado 6 registros enteros (RCX, RDX,
+     * R8, R9, R10, R11) y 6 XMM, pasa los agregados de hasta 16 bytes en
+     * dos registros enteros, las parejas de float o double en XMM y los
+     * vectores por valor.
+     */
+    static std::vector<ParameterInfo> classifyParameters(
+        const std::vector<ValueType>& params,
+        CallingConvention convention = CallingConvention::Win64,
+        bool hiddenReturnPointer = false);
+
     /**
      * @brief Determina cómo retornar un valor según el ABI
      */
     static ReturnInfo classifyReturn(
         size_t size, size_t alignment, bool isFloat, bool isAggregate);
 
+    /**
+     * @brief Retorno según la convención
+     *
+     * Win64 devuelve en RAX los agregados POD de 1, 2, 4 u 8 bytes y el
+     * resto por referencia; InternalFastcall usa además RAX:RDX para
+     * agregados de hasta 16 bytes y XMM0(:XMM1) para parejas de float.
+     */
+    static ReturnInfo classifyReturn(const ValueType& type,
+                                     CallingConvention convention = CallingConvention::Win64);
+
+    /**
+     * @brief Convención de una función
+     *
+     * InternalFastcall solo si se pidió y nadie fuera de la unidad puede
+     * llamarla: enlace interno (static, espacio de nombres anónimo) y
+     * dirección que no escapa a un puntero a función.
+     */
+    static CallingConvention conventionFor(bool internalLinkage, bool addressEscapes, bool internalFastcall) {
+        return internalFastcall && internalLinkage && !addressEscapes ? CallingConvention::InternalFastcall
+                                                                      : CallingConvention::Win64;
+    }
+
     /**
      * @brief Calcula el tamaño de stack necesario para una función
      */
@@ -165,12 +261,14 @@ public:
     /**
      * @brief Obtiene el registro para un argumento entero
      */
-    static std::string getIntegerArgRegister(int index);
+    static std::string getIntegerArgRegister(int index,
+                                             CallingConvention convention = CallingConvention::Win64);
 
     /**
      * @brief Obtiene el registro para un argumento flotante
      */
-    static std::string getFloatArgRegister(int index);
+    static std::string getFloatArgRegister(int index,
+                                           CallingConvention convention = CallingConvention::Win64);
 
     /**
      * @brief Verifica si un registro debe preservarse
@@ -0,0 +1,132 @@
+/**
+ * @file CodeGenerator.h
+ * @brief Generación de código por función: asignación, selección y peephole
+ */
+
+#pragma once
+
+#include <compiler/ir/IR.h>
+#include <compiler/backend/abi/ABIContract.h>
+#include <compiler/backend/codegen/InstructionScheduler.h>
+#include <compiler/backend/codegen/InstructionSelector.h>
+#include <compiler/backend/codegen/RegisterAllocator.h>
+#include <compiler/backend/coff/COFFTypes.h>
+#include <string>
+#include <vector>
+
+namespace cpp20::compiler::backend {
+
+class CodegenDatabase;
+class MachineCodeCache;
+
+/**
+ * @brief Resultado del back-end para una función
+ *
+ * Todo lo que produce un worker es propio de la función; los offsets
+ * dentro de las secciones se fijan al coser los resultados en el objeto.
+ */
+struct FunctionCode {
+    std::string name;
+    std::vector<X86Instruction> instructions;   // Cuerpo tras peephole con prólogo y epílogos
+    std::vector<uint8_t> code;                  // Bytes de instructions (vacío si encodingError)
+    std::vector<coff::COFFFunctionRelocation> relocations;  // Llamadas, relativas a code
+    std::vector<coff::COFFJumpTable> jumpTables;            // Destinos relativos a code
+    std::string encodingError;                  // Instrucción que X86Encoder no sabe codificar
+    std::vector<uint8_t> prologueBytes;
+    std::vector<uint8_t> unwindInfo;            // UNWIND_INFO para .xdata (vacío si es hoja)
+    uint32_t unwindBegin = 0;                   // Bytes de la salida temprana previa al prólogo
+    uint8_t comdatSelection = 0;                // IMAGE_COMDAT_SELECT_* de su sección propia
+    uint32_t stackSize = 0;                     // SUB RSP del prólogo
+    RegisterAllocator::AllocationStats allocation;
+};
+
+/**
+ * @brief Funciones reutilizadas y regeneradas en una compilación incremental
+ */
+struct IncrementalStats {
+    size_t reused = 0;
+    size_t regenerated = 0;
+};
+
+/**
+ * @brief Back-end por función, paralelizable sobre los hilos de -j
+ *
+ * InstructionSelector, RegisterAllocator y PeepholeOptimizer guardan
+ * estado entre llamadas, así que cada función usa instancias propias y
+ * solo se comparten el contrato ABI y las extensiones de la CPU, que son
+ * de solo lectura.
+ */
+class CodeGenerator {
+public:
+    /**
+     * @param tune Microarquitectura de -mtune para el planificador
+     */
+    CodeGenerator(const abi::ABIContract& abiContract, const CPUFeatures& features = CPUFeatures(),
+                  AllocationStrategy strategy = AllocationStrategy::LinearScan,
+                  Microarchitecture tune = Microarchitecture::Generic);
+
+    /**
+     * @brief Genera el código y el unwind de una función
+     */
+    FunctionCode generateFunction(const ir::IRFunction& function) const;
+
+    /**
+     * @brief Caché compartida de código máquina (nullptr = ninguna)
+     *
+     * Con ella, generateModule y generateModuleIncremental buscan cada
+     * función por su dependencyHash antes de pasar por selección,
+     * asignación y peephole, y publican lo que generan. Debe seguir viva
+     * mientras se use el generador.
+     */
+    void setSharedCache(MachineCodeCache* cache) { sharedCache_ = cache; }
+
+    /**
+     * @brief Genera todas las funciones con definición del módulo
+     * @param jobs Hilos a usar (1 = en el hilo actual)
+     * @param stats Con caché compartida, funciones reutilizadas y generadas
+     * @return Un resultado por función, en el orden del módulo sea cual sea jobs
+     */
+    std::vector<FunctionCode> generateModule(const ir::IRModule& module, size_t jobs,
+                                             IncrementalStats* stats = nullptr) const;
+
+    /**
+     * @brief Como generateModule, pero reutiliza el código de database
+     *
+     * Solo se regeneran las funciones cuyo dependencyHash cambió; el
+     * resto se toma de la base (o, si no está, de la caché compartida).
+     * Al terminar, database contiene exactamente las funciones del
+     * módulo, lista para save(). Las reutilizadas llegan sin instructions
+     * ni allocation.
+     */
+    std::vector<FunctionCode> generateModuleIncremental(const ir::IRModule& module, size_t jobs,
+                                                        CodegenDatabase& database,
+                                                        IncrementalStats* stats = nullptr) const;
+
+    /**
+     * @brief Hash de todo lo que determina el código de una función
+     *
+     * Combina el IR de la función (texto y tipos de cada valor), la
+     * configuración del back-end y la declaración de cada global que
+     * referencia. El cuerpo de otra función no entra: cambiarlo no obliga
+     * a regenerar a quien la llama.
+     * @param dependencies Si no es nulo, recibe los globales referenciados, ordenados
+     */
+    uint64_t dependencyHash(const ir::IRFunction& function, const ir::IRModule& module,
+                            std::vector<std::string>* dependencies = nullptr) const;
+
+    /**
+     * @brief Vista COFF de un resultado, para coff::appendFunctions
+     */
+    static coff::COFFFunction toCOFFFunction(const FunctionCode& code);
+
+private:
+    const abi::ABIContract& abiContract_;
+    CPUFeatures features_;
+    AllocationStrategy strategy_;
+    Microarchitecture tune_;
+    MachineCodeCache* sharedCache_ = nullptr;
+
+    uint64_t configurationHash() const;
+};
+
+} // namespace cpp20::compiler::backend
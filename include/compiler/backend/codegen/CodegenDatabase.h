@@ -0,0 +1,122 @@
+/**
+ * @file CodegenDatabase.h
+ * @brief Base de datos persistente de código generado por función
+ */
+
+#pragma once
+
+#include <compiler/backend/codegen/CodeGenerator.h>
+#include <compiler/common/CacheBackend.h>
+#include <compiler/common/CacheFile.h>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cpp20::compiler::backend {
+
+/**
+ * @brief Código de una función junto a lo que lo determina
+ *
+ * dependencyHash resume el IR de la función, la configuración del
+ * back-end y las declaraciones de los globales que referencia; mientras no
+ * cambie, el código guardado sirve tal cual. Del FunctionCode solo se
+ * conserva lo que va al objeto: instructions y allocation quedan vacíos en
+ * los registros leídos de disco.
+ */
+struct CodegenRecord {
+    uint64_t dependencyHash = 0;
+    std::vector<std::string> dependencies;  // Globales referenciados, ordenados
+    FunctionCode code;
+};
+
+/**
+ * @brief Registros por función guardados junto al objeto (<objeto>.cgdb)
+ *
+ * load() proyecta el archivo anterior y find() lo consulta sin cargarlo
+ * entero; find() es seguro desde varios hilos. save() escribe solo lo
+ * guardado con store(): las funciones que desaparecen del módulo salen de
+ * la base en la siguiente compilación.
+ */
+class CodegenDatabase {
+public:
+    static constexpr uint32_t FileKind = 3;
+
+    /**
+     * @brief Ruta de la base que acompaña a un objeto
+     */
+    static std::filesystem::path fileFor(const std::filesystem::path& objectFile);
+
+    /**
+     * @return false si no existe o no es una base de este formato
+     */
+    bool load(const std::filesystem::path& path);
+
+    bool save(const std::filesystem::path& path) const;
+
+    /**
+     * @brief Registro de la función si se generó con las mismas dependencias
+     */
+    std::optional<CodegenRecord> find(const std::string& name, uint64_t dependencyHash) const;
+
+    void store(CodegenRecord record);
+
+    size_t size() const { return records_.size(); }
+
+private:
+    std::unique_ptr<CacheFileReader> persisted_;
+    std::unordered_map<std::string, CodegenRecord> records_;
+};
+
+/**
+ * @brief Código máquina por función compartido entre objetos y compilaciones
+ *
+ * Donde CodegenDatabase acompaña a un objeto, aquí cada entrada se
+ * direcciona solo por nombre y dependencyHash dentro del espacio del
+ * compilador: la misma función con el mismo IR se reutiliza desde otra
+ * unidad, desde otra máquina que comparta el backend o desde una
+ * partición de LTO. La consulta es síncrona, porque el código hace falta
+ * ya; la publicación va en segundo plano por SecondaryCache. Segura desde
+ * varios hilos.
+ */
+class MachineCodeCache {
+public:
+    static constexpr uint32_t FileKind = 6;
+
+    /**
+     * @param compilerId Versión exacta del compilador: el código de otro back-end no se mezcla
+     */
+    MachineCodeCache(std::shared_ptr<CacheBackend> backend, std::string_view compilerId);
+
+    /**
+     * @brief Registro publicado para esa función y ese dependencyHash
+     */
+    std::optional<CodegenRecord> find(const std::string& name, uint64_t dependencyHash) const;
+
+    /**
+     * @brief Publica un registro; los que no se codificaron (encodingError) no se guardan
+     */
+    void store(const CodegenRecord& record);
+
+    /**
+     * @brief Espera las publicaciones pendientes
+     */
+    void wait() { secondary_.wait(); }
+
+    size_t lookupCount() const { return lookups_.load(std::memory_order_relaxed); }
+    size_t hitCount() const { return hits_.load(std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<CacheBackend> backend_;
+    SecondaryCache secondary_;
+    mutable std::atomic<size_t> lookups_{0};
+    mutable std::atomic<size_t> hits_{0};
+
+    std::string address(const std::string& name, uint64_t dependencyHash) const;
+};
+
+} // namespace cpp20::compiler::backend
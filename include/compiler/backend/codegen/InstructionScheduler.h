@@ -0,0 +1,101 @@
+/**
+ * @file InstructionScheduler.h
+ * @brief Planificación de instrucciones tras la asignación de registros
+ */
+
+#pragma once
+
+#include <compiler/backend/codegen/InstructionSelector.h>
+#include <compiler/common/EnvironmentDetector.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace cpp20::compiler::backend {
+
+/**
+ * @brief Tipo de unidad de ejecución que ocupa una instrucción
+ */
+enum class ExecutionClass : uint8_t {
+    Alu,        // Enteros simples, MOV y LEA
+    Multiply,   // IMUL
+    Divide,     // IDIV (no segmentada)
+    Load,       // Puerto de carga: latencia aparte en loadLatency
+    Store,      // Puerto de escritura
+    FpAdd,      // ADDSS/SUBSD/COMIS* y sus variantes empaquetadas
+    FpMul,
+    FpDivide,
+    VectorInt,  // PADD/PAND/... y movimientos entre registros vectoriales
+    VectorMul,  // PMULLD
+    Shuffle,    // PSHUFD, broadcasts, desempaquetados
+    Transfer,   // MOVD/MOVQ entre registros generales y vectoriales
+    Count
+};
+
+/**
+ * @brief Coste de una clase de ejecución
+ */
+struct ExecutionCost {
+    uint8_t latency;    // Ciclos hasta que el resultado está disponible
+    uint8_t units;      // Instrucciones de la clase que empiezan por ciclo
+    uint8_t occupancy;  // Ciclos que cada unidad queda ocupada (1/throughput)
+};
+
+/**
+ * @brief Modelo de costes de una microarquitectura
+ *
+ * Valores redondeados de las tablas publicadas (Agner Fog, uops.info)
+ * para operandos de 64 bits y registros de 128 bits.
+ */
+struct MicroarchitectureModel {
+    const char* name;
+    uint8_t issueWidth;             // Instrucciones despachadas por ciclo
+    uint8_t loadLatency;            // Carga a uso desde L1
+    uint8_t storeForwardLatency;    // Escritura seguida de lectura de la misma memoria
+    std::array<ExecutionCost, static_cast<size_t>(ExecutionClass::Count)> costs;
+
+    const ExecutionCost& cost(ExecutionClass cls) const { return costs[static_cast<size_t>(cls)]; }
+
+    /**
+     * @brief Tabla de la microarquitectura de -mtune
+     */
+    static const MicroarchitectureModel& forTarget(Microarchitecture target);
+};
+
+/**
+ * @brief Planificador de lista por bloques, tras asignar registros
+ *
+ * Reordena cada tramo de instrucciones sin etiquetas ni control de flujo
+ * respetando las dependencias por registro (incluidos los flags y los
+ * alias de 32/16/8 bits y XMM/YMM) y por memoria (las escrituras no se
+ * cruzan con ningún acceso). Entre las listas, prioriza la ruta crítica
+ * hasta el final del tramo para adelantar las cargas y entrelazar cadenas
+ * independientes. La instrucción que fija los flags del salto final se
+ * deja la última para que siga fusionándose con él.
+ */
+class InstructionScheduler {
+public:
+    explicit InstructionScheduler(Microarchitecture target = Microarchitecture::Generic);
+
+    /**
+     * @brief Planifica el cuerpo de una función (sin prólogo)
+     */
+    std::vector<X86Instruction> schedule(std::vector<X86Instruction> instructions) const;
+
+    /**
+     * @brief Ciclos estimados de un tramo en orden, sin reordenar
+     *
+     * Sirve para comparar el orden original con el planificado.
+     */
+    uint32_t estimateCycles(const std::vector<X86Instruction>& instructions) const;
+
+private:
+    const MicroarchitectureModel& model_;
+
+    /**
+     * @brief Planifica instructions[begin, end) en su sitio
+     */
+    void scheduleRegion(std::vector<X86Instruction>& instructions, size_t begin, size_t end) const;
+};
+
+} // namespace cpp20::compiler::backend
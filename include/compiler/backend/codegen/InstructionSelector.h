@@ -7,6 +7,8 @@
 
 #include <compiler/ir/IR.h>
 #include <compiler/backend/abi/ABIContract.h>
+#include <compiler/backend/frame/FrameLayout.h>
+#include <compiler/common/EnvironmentDetector.h>
 #include <vector>
 #include <string>
 #include <memory>
@@ -27,12 +29,21 @@ enum class X86Opcode {
     // Operaciones lógicas
     AND, OR, XOR, NOT, SHL, SHR, SAR,
 
+    // Manipulación de bits; POPCNT, LZCNT (ABM), TZCNT (BMI1), PDEP y PEXT
+    // (BMI2) y CRC32 (SSE4.2) solo con la extensión del destino
+    BSF, BSR, BSWAP, ROL, ROR, POPCNT, LZCNT, TZCNT, PDEP, PEXT, CRC32,
+
     // Comparaciones y saltos
     CMP, TEST, JMP, JE, JNE, JL, JLE, JG, JGE,
     JB, JBE, JA, JAE, JS, JNS, JC, JNC,
 
-    // Llamadas y retorno
-    CALL, RET, LEAVE, ENTER,
+    // Movimientos condicionales, en el mismo orden que los saltos
+    CMOVE, CMOVNE, CMOVL, CMOVLE, CMOVG, CMOVGE,
+    CMOVB, CMOVBE, CMOVA, CMOVAE,
+
+    // Llamadas y retorno; TAILJMP es el JMP a otra función de una llamada en
+    // cola y JMPTABLE el salto indirecto de un Switch por su tabla de saltos
+    CALL, RET, LEAVE, ENTER, TAILJMP, JMPTABLE,
 
     // Operaciones de pila
     PUSH, POP,
@@ -40,12 +51,23 @@ enum class X86Opcode {
     // Operaciones de punto flotante (SSE/AVX)
     MOVSS, MOVSD, ADDSS, ADDSD, SUBSS, SUBSD,
     MULSS, MULSD, DIVSS, DIVSD, COMISS, COMISD,
+    MINSS, MINSD, MAXSS, MAXSD,
 
-    // Operaciones SIMD
+    // Operaciones SIMD (SSE2/SSE4.1)
     MOVAPS, MOVUPS, ADDPS, ADDPD,
+    MOVDQA, MOVDQU, MOVUPD, MOVD, MOVQ,
+    PADDD, PADDQ, PSUBD, PSUBQ, PMULLD, PAND, POR, PXOR,
+    SUBPS, SUBPD, MULPS, MULPD, DIVPS, DIVPD,
+    PSHUFD, SHUFPS, PUNPCKLQDQ, UNPCKLPD, PCMPEQB, PMOVMSKB,
 
-    // Instrucciones de control
-    NOP, HLT,
+    // Operaciones SIMD con codificación VEX (AVX/AVX2)
+    VMOVDQU, VMOVUPS, VMOVUPD, VMOVD, VMOVQ,
+    VPADDD, VPADDQ, VPSUBD, VPSUBQ, VPMULLD, VPAND, VPOR, VPXOR, VPCMPEQB,
+    VADDPS, VADDPD, VSUBPS, VSUBPD, VMULPS, VMULPD, VDIVPS, VDIVPD,
+    VPBROADCASTD, VPBROADCASTQ, VBROADCASTSS, VBROADCASTSD, VPMOVMSKB, VZEROUPPER,
+
+    // Instrucciones de control; CPUID y XGETBV leen y escriben EAX, EBX, ECX y EDX
+    NOP, HLT, CPUID, XGETBV,
 
     // Prefijos
     LOCK, REP, REPZ, REPNZ
@@ -77,6 +99,7 @@ enum class X86Register {
 
     // Registros SIMD
     YMM0, YMM1, YMM2, YMM3, YMM4, YMM5, YMM6, YMM7,
+    YMM8, YMM9, YMM10, YMM11, YMM12, YMM13, YMM14, YMM15,
     ZMM0, ZMM1, ZMM2, ZMM3, ZMM4, ZMM5, ZMM6, ZMM7,
 
     // Registros de segmento
@@ -96,7 +119,8 @@ enum class AddressingMode {
     MemoryIndirect,     // [reg]
     MemoryBaseDisp,     // [reg + displacement]
     MemoryBaseIndex,    // [reg + index*scale]
-    MemoryBaseIndexDisp // [reg + index*scale + displacement]
+    MemoryBaseIndexDisp,// [reg + index*scale + displacement]
+    RipRelative         // [rip + símbolo], con el símbolo en el comentario de la instrucción
 };
 
 /**
@@ -125,8 +149,22 @@ struct X86Instruction {
     X86Instruction(X86Opcode op = X86Opcode::NOP) : opcode(op) {}
 };
 
+/**
+ * @brief Tabla de saltos de un Switch
+ *
+ * JMPTABLE lleva name en el comentario y el índice ya rebasado y
+ * comprobado en su primer operando; cada entrada es la etiqueta del bloque
+ * al que salta ese índice.
+ */
+struct JumpTable {
+    std::string name;
+    std::vector<std::string> targets;
+};
+
 /**
  * @brief Información de mapeo registro virtual -> registro físico
+ *
+ * El registro virtual es el ir::ValueId del valor.
  */
 struct RegisterMapping {
     int virtualReg;
@@ -137,13 +175,24 @@ struct RegisterMapping {
 
 /**
  * @brief Selector de instrucciones para x86-64
+ *
+ * Las operaciones sobre tipos vector de la IR se emiten con SSE2/SSE4.1
+ * para 16 bytes y con AVX2 para 32; si la CPU tiene AVX también las de 16
+ * bytes usan la codificación VEX. Las funciones con vectores de 32 bytes
+ * ejecutan VZEROUPPER antes de llamar y de volver.
+ *
+ * Las instrucciones escalares se cubren por bloque con la tabla de
+ * patrones de InstructionPatterns.cpp: loads plegados en los operandos,
+ * direcciones base+índice*escala+desplazamiento, LEA y CMP+Jcc. Lo que
+ * ningún patrón cubre pasa por la selección por opcode.
  */
 class InstructionSelector {
 public:
     /**
      * @brief Constructor
+     * @param features Extensiones SIMD del destino (EnvironmentDetector::detectCPUFeatures)
      */
-    InstructionSelector(const abi::ABIContract& abiContract);
+    InstructionSelector(const abi::ABIContract& abiContract, const CPUFeatures& features = CPUFeatures());
 
     /**
      * @brief Destructor
@@ -161,83 +210,202 @@ public:
      * @brief Selecciona instrucciones para una instrucción IR
      */
     std::vector<X86Instruction> selectInstruction(
-        const ir::IRInstruction& instruction,
+        const ir::IRFunction& function,
+        ir::InstrId instruction,
         const std::unordered_map<int, RegisterMapping>& registerMap);
 
     /**
-     * @brief Genera prólogo de función
+     * @brief Genera prólogo de función (vacío si el marco es hoja)
      */
-    std::vector<X86Instruction> generateFunctionPrologue(
-        const ir::IRFunction& function,
-        size_t stackSize);
+    std::vector<X86Instruction> generateFunctionPrologue(const FrameLayout& frame);
 
     /**
-     * @brief Genera epílogo de función
+     * @brief Genera epílogo de función, terminado en RET
      */
-    std::vector<X86Instruction> generateFunctionEpilogue(
-        const ir::IRFunction& function);
+    std::vector<X86Instruction> generateFunctionEpilogue(const FrameLayout& frame);
 
     /**
      * @brief Convierte instrucciones a texto ensamblador
      */
     std::string instructionsToAssembly(const std::vector<X86Instruction>& instructions);
 
+    /**
+     * @brief Tablas de saltos de la última función seleccionada
+     */
+    const std::vector<JumpTable>& jumpTables() const { return jumpTables_; }
+
 private:
     const abi::ABIContract& abiContract_;
+    CPUFeatures features_;
+    std::vector<JumpTable> jumpTables_;
+
+    /**
+     * @brief Selecciona un bloque cubriendo su DAG con la tabla de patrones
+     *
+     * Los tiles se eligen de abajo arriba por coste (el del patrón más el
+     * de las hojas que no cubre). Solo se pliega un valor con un único uso
+     * que esté justo antes de su usuario, de modo que ningún registro
+     * reutilizado por el asignador quede entre medias.
+     */
+    void selectBlock(
+        const ir::IRFunction& function,
+        ir::BlockId block,
+        const std::unordered_map<int, RegisterMapping>& registerMap,
+        bool usesYmm,
+        std::vector<X86Instruction>& instructions);
 
     /**
      * @brief Selecciona instrucciones para operación binaria
      */
     std::vector<X86Instruction> selectBinaryOperation(
-        const ir::BinaryInstruction& instruction,
+        const ir::IRFunction& function,
+        ir::InstrId instruction,
         const std::unordered_map<int, RegisterMapping>& registerMap);
 
     /**
      * @brief Selecciona instrucciones para operación unaria
      */
     std::vector<X86Instruction> selectUnaryOperation(
-        const ir::UnaryInstruction& instruction,
+        const ir::IRFunction& function,
+        ir::InstrId instruction,
         const std::unordered_map<int, RegisterMapping>& registerMap);
 
     /**
      * @brief Selecciona instrucciones para load
      */
     std::vector<X86Instruction> selectLoad(
-        const ir::LoadInstruction& instruction,
+        const ir::IRFunction& function,
+        ir::InstrId instruction,
         const std::unordered_map<int, RegisterMapping>& registerMap);
 
     /**
      * @brief Selecciona instrucciones para store
      */
     std::vector<X86Instruction> selectStore(
-        const ir::StoreInstruction& instruction,
+        const ir::IRFunction& function,
+        ir::InstrId instruction,
         const std::unordered_map<int, RegisterMapping>& registerMap);
 
     /**
      * @brief Selecciona instrucciones para branch
      */
     std::vector<X86Instruction> selectBranch(
-        const ir::BranchInstruction& instruction);
+        const ir::IRFunction& function,
+        ir::InstrId instruction);
+
+    /**
+     * @brief Selecciona instrucciones para switch
+     *
+     * Con casos densos (los que deja SwitchLoweringPass) resta el mínimo,
+     * descarta lo que cae fuera con una comparación sin signo y salta por
+     * una tabla de jumpTables(); si no, como en -O0, compara caso a caso.
+     */
+    std::vector<X86Instruction> selectSwitch(
+        const ir::IRFunction& function,
+        ir::InstrId instruction,
+        const std::unordered_map<int, RegisterMapping>& registerMap);
+
+    /**
+     * @brief Selecciona instrucciones para select
+     *
+     * Sin saltos: fija los flags (repite la comparación de la condición
+     * si la hay, o TEST de la condición) y elige con CMOVcc. En coma
+     * flotante, x > y ? x : y y sus variantes exactas bajan a MAXSS y
+     * MINSS; el resto pasa por R10/R11 con MOVD/MOVQ.
+     */
+    std::vector<X86Instruction> selectSelect(
+        const ir::IRFunction& function,
+        ir::InstrId instruction,
+        const std::unordered_map<int, RegisterMapping>& registerMap);
+
+    /**
+     * @brief Expande MemCpy, MemSet y MemCmp de tamaño constante
+     *
+     * Bloques de 16 bytes con MOVDQU (32 con VMOVDQU si hay AVX2) a través
+     * de XMM14/XMM15; el resto se cubre con un último bloque solapado o,
+     * por debajo de 16 bytes, con uno o dos movimientos solapados de R11.
+     * MemCmp compara con PCMPEQB y acumula en R10 los bytes distintos
+     * según PMOVMSKB; deja 0 o 1.
+     */
+    std::vector<X86Instruction> selectMemoryIntrinsic(
+        const ir::IRFunction& function,
+        ir::InstrId instruction,
+        const std::unordered_map<int, RegisterMapping>& registerMap);
+
+    /**
+     * @brief Baja CPUFeatures a CPUID y XGETBV
+     *
+     * Guarda RAX, RBX, RCX y RDX con PUSH/POP, porque CPUID los escribe
+     * todos, y acumula en R10 los bits de CPUFeatures::mask(): SSE4.1
+     * (hoja 1), AVX solo si el sistema guarda los YMM (OSXSAVE y XCR0) y
+     * AVX2 (hoja 7) solo con AVX.
+     */
+    std::vector<X86Instruction> selectCPUFeatures(
+        const ir::IRFunction& function,
+        ir::InstrId instruction,
+        const std::unordered_map<int, RegisterMapping>& registerMap);
+
+    /**
+     * @brief Baja los intrínsecos de bits según las extensiones del destino
+     *
+     * El valor se extiende con ceros en R10 (a 32 bits si es más estrecho).
+     * Con la extensión, una instrucción: POPCNT, LZCNT, TZCNT, PDEP, PEXT,
+     * CRC32; sin ella, POPCNT pasa a la suma por bloques (SWAR), LZCNT y
+     * TZCNT a BSR/BSF con CMOV para el 0, y PDEP, PEXT y CRC32 a un bucle
+     * por bit. BSWAP y ROL/ROR no dependen de ninguna extensión; una
+     * cuenta de rotación variable pasa por CL guardando RCX.
+     */
+    std::vector<X86Instruction> selectBitIntrinsic(
+        const ir::IRFunction& function,
+        ir::InstrId instruction,
+        const std::unordered_map<int, RegisterMapping>& registerMap);
 
     /**
      * @brief Selecciona instrucciones para return
      */
     std::vector<X86Instruction> selectReturn(
-        const ir::ReturnInstruction& instruction,
+        const ir::IRFunction& function,
+        ir::InstrId instruction,
         const std::unordered_map<int, RegisterMapping>& registerMap);
 
     /**
      * @brief Selecciona instrucciones para call
      */
     std::vector<X86Instruction> selectCall(
-        const ir::CallInstruction& instruction,
+        const ir::IRFunction& function,
+        ir::InstrId instruction,
+        const std::unordered_map<int, RegisterMapping>& registerMap);
+
+    /**
+     * @brief Selecciona instrucciones para una operación sobre vectores
+     */
+    std::vector<X86Instruction> selectVectorOperation(
+        const ir::IRFunction& function,
+        ir::InstrId instruction,
+        const std::unordered_map<int, RegisterMapping>& registerMap);
+
+    /**
+     * @brief Selecciona instrucciones para replicar un escalar en todas las lanes
+     */
+    std::vector<X86Instruction> selectBroadcast(
+        const ir::IRFunction& function,
+        ir::InstrId instruction,
+        const std::unordered_map<int, RegisterMapping>& registerMap);
+
+    /**
+     * @brief Registro XMM (16 bytes) o YMM (32 bytes) de un valor
+     */
+    X86Register getVectorRegister(
+        int virtualReg,
+        size_t bytes,
         const std::unordered_map<int, RegisterMapping>& registerMap);
 
     /**
      * @brief Convierte operando IR a operando x86
      */
     X86Operand convertOperand(
-        const std::shared_ptr<ir::IROperand>& operand,
+        const ir::IRFunction& function,
+        ir::ValueId operand,
         const std::unordered_map<int, RegisterMapping>& registerMap);
 
     /**
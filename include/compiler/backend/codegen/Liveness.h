@@ -0,0 +1,104 @@
+/**
+ * @file Liveness.h
+ * @brief Análisis de vida por bloques con conjuntos de bits
+ */
+
+#pragma once
+
+#include <compiler/ir/IR.h>
+#include <compiler/ir/IRAnalysis.h>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace cpp20::compiler::backend {
+
+inline constexpr uint32_t NoLiveIndex = ~0u;
+
+/**
+ * @brief Conjunto denso de índices de LivenessAnalysis
+ */
+class LiveSet {
+public:
+    explicit LiveSet(size_t size = 0) : words_((size + 63) / 64, 0) {}
+
+    bool test(uint32_t index) const { return (words_[index >> 6] >> (index & 63)) & 1; }
+    void set(uint32_t index) { words_[index >> 6] |= uint64_t{1} << (index & 63); }
+    void reset(uint32_t index) { words_[index >> 6] &= ~(uint64_t{1} << (index & 63)); }
+
+    void unionWith(const LiveSet& other) {
+        for (size_t i = 0; i < words_.size(); ++i) words_[i] |= other.words_[i];
+    }
+
+    /**
+     * @brief this ∪= other \ excluded
+     */
+    void unionWithout(const LiveSet& other, const LiveSet& excluded) {
+        for (size_t i = 0; i < words_.size(); ++i) words_[i] |= other.words_[i] & ~excluded.words_[i];
+    }
+
+    template <typename F>
+    void forEach(F&& f) const {
+        for (size_t i = 0; i < words_.size(); ++i) {
+            for (uint64_t word = words_[i]; word != 0; word &= word - 1) {
+                f(static_cast<uint32_t>(i * 64 + std::countr_zero(word)));
+            }
+        }
+    }
+
+    bool operator==(const LiveSet& other) const = default;
+
+private:
+    std::vector<uint64_t> words_;
+};
+
+/**
+ * @brief Vida de los valores que necesitan registro, a nivel de bloque
+ *
+ * Numera densamente los parámetros y los resultados no void de los
+ * bloques alcanzables. Con semántica SSA de los phis: su resultado se
+ * define al entrar al bloque y cada operando se usa al final de su
+ * predecesor. Los parámetros se tratan como phis de la entrada.
+ *
+ * LiveIn(B)  = PhiDefs(B) ∪ Uses(B) ∪ (LiveOut(B) \ Defs(B))
+ * LiveOut(B) = PhiUses(B) ∪ ⋃ (LiveIn(S) \ PhiDefs(S))
+ *
+ * Se resuelve con una lista de trabajo: solo se revisitan los
+ * predecesores de los bloques cuyo LiveIn cambia.
+ */
+class LivenessAnalysis {
+public:
+    LivenessAnalysis(const ir::IRFunction& function, const ir::ControlFlowGraph& cfg);
+
+    size_t size() const { return values_.size(); }
+
+    /**
+     * @brief Índice denso del valor, o NoLiveIndex si no necesita registro
+     */
+    uint32_t index(ir::ValueId value) const {
+        return value < indexOf_.size() ? indexOf_[value] : NoLiveIndex;
+    }
+
+    ir::ValueId value(uint32_t index) const { return values_[index]; }
+
+    const LiveSet& liveIn(ir::BlockId block) const { return liveIn_[block]; }
+    const LiveSet& liveOut(ir::BlockId block) const { return liveOut_[block]; }
+    const LiveSet& phiDefs(ir::BlockId block) const { return phiDefs_[block]; }
+
+    /**
+     * @brief Saca un valor de los conjuntos de un bloque (partición de rangos)
+     */
+    void removeFromBlock(ir::BlockId block, uint32_t index) {
+        liveIn_[block].reset(index);
+        liveOut_[block].reset(index);
+    }
+
+private:
+    std::vector<ir::ValueId> values_;
+    std::vector<uint32_t> indexOf_;
+    std::vector<LiveSet> liveIn_;
+    std::vector<LiveSet> liveOut_;
+    std::vector<LiveSet> phiDefs_;
+};
+
+} // namespace cpp20::compiler::backend
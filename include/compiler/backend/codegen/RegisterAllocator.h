@@ -1,6 +1,6 @@
 /**
  * @file RegisterAllocator.h
- * @brief Asignador de registros con algoritmo greedy y manejo de spills
+ * @brief Asignadores de registros (lineal y por coloreado de grafos) con manejo de spills
  */
 
 #pragma once
@@ -48,6 +48,30 @@ struct PhysicalRegisterInfo {
     PhysicalRegisterInfo(X86Register r) : reg(r) {}
 };
 
+/**
+ * @brief Estrategia de asignación de registros
+ */
+enum class AllocationStrategy {
+    LinearScan,     // Intervalos lineales; el spill ocupa el intervalo entero (-O0/-O1)
+    GraphColoring   // Coalescing iterado de Chaitin-Briggs con partición de rangos (-O2/-O3)
+};
+
+/**
+ * @brief Store o reload de un valor a su slot de spill
+ *
+ * El código se inserta justo antes de `before`; ir::NoInstr indica el
+ * final del bloque. Un valor rematerializado no tiene slot (-1): en lugar
+ * de recargarlo se vuelve a calcular en el registro de recarga.
+ */
+struct SpillPlacement {
+    int virtualReg;
+    int spillSlot;
+    ir::BlockId block;
+    ir::InstrId before;
+    bool isReload;
+    bool rematerialize = false;
+};
+
 /**
  * @brief Estado del asignador de registros
  */
@@ -55,19 +79,46 @@ struct AllocationState {
     std::unordered_map<int, X86Register> virtualToPhysical;
     std::unordered_map<X86Register, int> physicalToVirtual;
     std::vector<int> spilledRegisters;
+    std::unordered_map<int, int> spillSlots;    // Slot de cada valor en memoria (spilled o partido)
+    std::vector<SpillPlacement> spillCode;
+    std::vector<int> rematerialized;           // Spilled sin slot: se recalculan en cada uso
     int nextSpillSlot = 0;
     size_t maxSpillSlots = 0;
+    size_t coalescedMoves = 0;
+    size_t splitRanges = 0;
 };
 
 /**
- * @brief Asignador de registros lineal (greedy) con manejo de spills
+ * @brief Asignador de registros con manejo de spills
+ *
+ * Con GraphColoring los valores en coma flotante y vectoriales reciben
+ * registros XMM. R10/R11 (y XMM14/XMM15 al colorear) quedan libres para
+ * recargar valores spilled.
  */
 class RegisterAllocator {
 public:
     /**
      * @brief Constructor
      */
-    RegisterAllocator(const abi::ABIContract& abiContract);
+    RegisterAllocator(const abi::ABIContract& abiContract,
+                      AllocationStrategy strategy = AllocationStrategy::LinearScan);
+
+    /**
+     * @brief Estrategia por defecto del nivel de optimización
+     */
+    static AllocationStrategy strategyForOptimizationLevel(int level) {
+        return level >= 2 ? AllocationStrategy::GraphColoring : AllocationStrategy::LinearScan;
+    }
+
+    /**
+     * @brief El valor se recalcula con una instrucción sin leer memoria
+     *
+     * Direcciones de Alloca (LEA sobre el marco), y GetElementPtr, sumas y
+     * conversiones enteras cuyos operandos son constantes, globales (LEA
+     * relativo a RIP) o Allocas: un MOV o un LEA cuestan menos que el
+     * store y los reloads de un spill.
+     */
+    static bool isRematerializable(const ir::IRFunction& function, ir::ValueId value);
 
     /**
      * @brief Destructor
@@ -93,11 +144,17 @@ public:
         size_t registersSpilled = 0;
         size_t spillSlotsUsed = 0;
         size_t maxLiveRegisters = 0;
+        size_t spillStores = 0;         // Stores a slots de spill de la función
+        size_t reloads = 0;             // Recargas desde slots de spill
+        size_t rematerialized = 0;      // Recálculos que sustituyen a una recarga
+        size_t splitRanges = 0;         // Rangos partidos alrededor de un bucle
+        size_t coalescedMoves = 0;      // Copias de phi eliminadas por coalescing
     };
     AllocationStats getStats() const { return stats_; }
 
 private:
     const abi::ABIContract& abiContract_;
+    AllocationStrategy strategy_;
     AllocationStats stats_;
 
     // Registros disponibles para asignación
@@ -111,49 +168,64 @@ private:
 
     /**
      * @brief Calcula intervalos de vida para todos los registros virtuales
+     *
+     * Parte de LiveIn/LiveOut por bloque (LivenessAnalysis) sobre el orden
+     * lineal en postorden inverso, así que cuesta O(instrucciones +
+     * bloques × valores / 64) en lugar de escanear pares de intervalos.
      */
     std::vector<LiveInterval> computeLiveIntervals(const ir::IRFunction& function);
 
     /**
-     * @brief Encuentra el registro físico más adecuado para asignar
+     * @brief Maneja el spill de un registro en el slot indicado
      */
-    X86Register findBestPhysicalRegister(
-        const LiveInterval& interval,
-        const std::vector<LiveInterval>& activeIntervals);
+    void spillRegister(int virtualReg, int spillSlot, AllocationState& state);
 
     /**
-     * @brief Maneja el spill de un registro
+     * @brief Restaura un registro desde memoria
      */
-    void spillRegister(int virtualReg, AllocationState& state);
+    void restoreRegister(int virtualReg, X86Register physicalReg, AllocationState& state);
 
     /**
-     * @brief Restaura un registro desde memoria
+     * @brief Actualiza estadísticas
      */
-    void restoreRegister(int virtualReg, X86Register physicalReg, AllocationState& state);
+    void updateStats(const AllocationState& state);
 
     /**
-     * @brief Verifica si un registro físico está disponible en un intervalo
+     * @brief Algoritmo principal de asignación lineal (Poletto y Sarkar)
+     *
+     * Los activos se ordenan por punto final: expirar y elegir el spill
+     * (el que termina más tarde) cuestan O(log n), O(n log n) en total.
+     * Un slot de spill se reutiliza en cuanto termina el intervalo que lo
+     * ocupaba.
      */
-    bool isRegisterAvailable(
-        X86Register reg,
-        const LiveInterval& interval,
-        const std::vector<LiveInterval>& activeIntervals) const;
+    AllocationState linearScanAllocation(const std::vector<LiveInterval>& intervals);
 
     /**
-     * @brief Obtiene el registro con el último uso más lejano
+     * @brief Coalescing iterado (Appel y George) sobre el grafo de interferencias
+     *
+     * Antes de colorear, los valores que solo atraviesan un bucle con más
+     * presión que registros se parten: se guardan en el preheader y se
+     * recargan en las salidas. El coste de spill pondera cada uso por la
+     * frecuencia del bloque según el perfil o, sin perfil, por la
+     * profundidad de bucle, de modo que se eligen valores usados fuera.
      */
-    X86Register getFurthestUseRegister(
-        const std::vector<LiveInterval>& activeIntervals) const;
+    AllocationState graphColoringAllocation(const ir::IRFunction& function);
 
     /**
-     * @brief Actualiza estadísticas
+     * @brief Coloca el store tras la definición y un reload antes de cada
+     * uso de los valores de spilledRegisters
+     *
+     * Las copias de phi entre valores que comparten slot no generan código.
      */
-    void updateStats(const AllocationState& state);
+    static void placeSpillCode(const ir::IRFunction& function, AllocationState& state);
 
     /**
-     * @brief Algoritmo principal de asignación lineal
+     * @brief Cambia store y reloads de los valores rematerializables por un
+     * recálculo antes de cada uso, libera sus slots y compacta el resto
+     *
+     * Se exceptúan los operandos de phi: la copia del phi lee el slot.
      */
-    AllocationState linearScanAllocation(const std::vector<LiveInterval>& intervals);
+    static void rematerializeSpills(const ir::IRFunction& function, AllocationState& state);
 
     /**
      * @brief Ordena intervalos por punto de inicio
@@ -183,10 +255,18 @@ public:
         bool isPrologue);
 
     /**
-     * @brief Calcula el tamaño de stack necesario para spills
+     * @brief Calcula el tamaño de stack necesario para spills (8 bytes por slot)
      */
     static size_t calculateSpillStackSize(const AllocationState& state);
 
+    /**
+     * @brief Un hueco por valor en memoria, del tamaño de su tipo
+     *
+     * El color es el slot: los valores que comparten slot comparten
+     * posición en FrameBuilder::layoutStackSlots.
+     */
+    static std::vector<StackSlot> spillStackSlots(const ir::IRFunction& function, const AllocationState& state);
+
     /**
      * @brief Valida que una asignación sea correcta
      */
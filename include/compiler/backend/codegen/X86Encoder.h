@@ -0,0 +1,66 @@
+/**
+ * @file X86Encoder.h
+ * @brief Codificación directa de X86Instruction a código máquina x86-64
+ */
+
+#pragma once
+
+#include <compiler/backend/codegen/InstructionSelector.h>
+#include <compiler/backend/coff/COFFTypes.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cpp20::compiler::backend {
+
+/**
+ * @brief Codificador x86-64 en memoria (REX/VEX, ModRM, SIB, disp, imm)
+ *
+ * Sigue las convenciones del selector: las etiquetas de bloque son NOP
+ * con el nombre y ':' en el comentario (y un inmediato si el bloque se
+ * alinea, que se rellena con NOPs largos), los saltos llevan en el
+ * comentario el nombre del bloque destino y CALL y TAILJMP el del símbolo
+ * llamado.
+ * Los saltos empiezan en su forma corta (rel8) y se relajan a rel32 solo
+ * los que no alcanzan, iterando hasta que ningún desplazamiento cambia.
+ * Las llamadas, y los saltos en cola, dejan una relocación REL32 contra el
+ * símbolo; JMPTABLE, una REL32 contra __ImageBase y una ADDR32NB contra su
+ * tabla.
+ */
+class X86Encoder {
+public:
+    /**
+     * @brief Codifica una secuencia de instrucciones
+     * @param code Bytes codificados (se añaden al final)
+     * @param relocations Relocaciones relativas al inicio de code
+     * @return false si alguna instrucción no tiene codificación (ver getLastError)
+     */
+    bool encode(const std::vector<X86Instruction>& instructions, std::vector<uint8_t>& code,
+                std::vector<coff::COFFFunctionRelocation>& relocations);
+
+    const std::string& getLastError() const { return lastError_; }
+
+    /**
+     * @brief Offset de cada etiqueta de bloque en code, acumulado en todas las llamadas a encode
+     */
+    const std::unordered_map<std::string, uint32_t>& labelOffsets() const { return labelOffsets_; }
+
+    /**
+     * @brief Número de registro de la codificación (bit 3 en REX.R/X/B)
+     */
+    static uint8_t registerNumber(X86Register reg);
+
+private:
+    std::string lastError_;
+    std::unordered_map<std::string, uint32_t> labelOffsets_;
+
+    /**
+     * @brief Codifica una instrucción que no es un salto
+     * @return false si no hay forma para esos operandos
+     */
+    bool encodeInstruction(const X86Instruction& inst, std::vector<uint8_t>& out,
+                           std::vector<coff::COFFFunctionRelocation>& relocations);
+};
+
+} // namespace cpp20::compiler::backend
@@ -1,7 +1,19 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <iostream>
+#include <memory>
+#include <vector>
+
+namespace cpp20::compiler::common::utils {
+class ThreadPool;
+}
+
+namespace cpp20::compiler::backend::link {
+struct ArchiveMember;
+}
 
 namespace cpp20::compiler::backend::coff {
 
@@ -10,14 +22,24 @@ struct IMAGE_SECTION_HEADER;
 struct IMAGE_SYMBOL;
 
 /**
- * @brief Lector y dumper de archivos COFF para validación
+ * @brief Lector y dumper de archivos COFF y bibliotecas (.lib) para validación
+ *
+ * Los símbolos se muestran con su nombre mangled y, si es de
+ * MSVCNameMangler, con su forma desmangled.
+ *
+ * Los archivos se proyectan en memoria en vez de leerse enteros. Los
+ * grupos de secciones, los tramos de la tabla de símbolos y los miembros
+ * de una biblioteca se formatean en setJobs() hilos y se escriben en orden
+ * a medida que terminan, con pocos trozos por delante del que se escribe.
+ * Con filtros solo se decodifica lo que coincide y se omite la cabecera
+ * del archivo.
  */
 class COFFDumper {
 public:
     COFFDumper();
 
     /**
-     * @brief Lee y muestra el contenido de un archivo COFF
+     * @brief Lee y muestra el contenido de un archivo COFF o de una biblioteca
      * @param filename Nombre del archivo COFF
      * @param output Stream de salida
      * @return true si la operación fue exitosa
@@ -33,15 +55,102 @@ public:
      */
     bool dumpObject(const uint8_t* data, size_t size, std::ostream& output);
 
+    /**
+     * @brief Muestra cada miembro de una biblioteca "!<arch>" en memoria
+     *
+     * Los objetos se muestran como con dumpObject() y los miembros de
+     * importación cortos, con su símbolo, DLL y hint.
+     */
+    bool dumpArchive(const uint8_t* data, size_t size, std::ostream& output);
+
+    /**
+     * @brief Muestra la tabla de símbolos de un archivo COFF ordenada por nombre desmangled
+     * @param filename Nombre del archivo COFF
+     * @param output Stream de salida
+     * @return true si la operación fue exitosa
+     */
+    bool dumpSortedSymbols(const std::string& filename, std::ostream& output);
+
+    /**
+     * @brief Muestra la tabla de símbolos de datos COFF en memoria ordenada por nombre desmangled
+     *
+     * El demangling se reparte entre setJobs() hilos (mangling::SymbolIndex).
+     */
+    bool dumpSortedSymbols(const uint8_t* data, size_t size, std::ostream& output);
+
+    /**
+     * @brief Hilos para formatear y desmanglear (0 = todos los núcleos, 1 = sin hilos)
+     */
+    void setJobs(size_t jobs) { jobs_ = jobs; }
+
+    /**
+     * @brief Mostrar solo las secciones con este nombre (repetible)
+     *
+     * Sin filtro de símbolos, la tabla de símbolos no se muestra.
+     */
+    void addSectionFilter(std::string name) { sectionFilters_.push_back(std::move(name)); }
+
+    /**
+     * @brief Mostrar solo los símbolos cuyo nombre mangled encaja con pattern ('*' = cualquier texto)
+     *
+     * Sin filtro de secciones, las secciones no se muestran.
+     */
+    void setSymbolFilter(std::string pattern) { symbolFilter_ = std::move(pattern); }
+
+    bool hasFilters() const { return !sectionFilters_.empty() || !symbolFilter_.empty(); }
+
+    /**
+     * @brief Comprueba name contra un patrón en el que '*' encaja con cualquier texto
+     *
+     * '?' no es comodín: es el primer carácter de los nombres MSVC.
+     */
+    static bool matchesPattern(std::string_view name, std::string_view pattern);
+
 private:
+    size_t jobs_ = 0;
+    std::vector<std::string> sectionFilters_;
+    std::string symbolFilter_;
+
+    bool dumpObject(const uint8_t* data, size_t size, std::ostream& output,
+                    common::utils::ThreadPool* pool);
+    bool dumpMember(const link::ArchiveMember& member, std::ostream& output);
+
     void dumpFileHeader(const IMAGE_FILE_HEADER& header, std::ostream& output);
     void dumpCharacteristics(uint16_t characteristics, std::ostream& output);
     void dumpSectionHeader(const IMAGE_SECTION_HEADER& header, std::ostream& output);
     void dumpSectionCharacteristics(uint32_t characteristics, std::ostream& output);
     void dumpSectionData(const IMAGE_SECTION_HEADER& header,
                         const uint8_t* data, size_t size, std::ostream& output);
-    void dumpSymbolTable(const uint8_t* data, uint32_t numSymbols, std::ostream& output);
-    void dumpSymbol(const IMAGE_SYMBOL& symbol, std::ostream& output);
+
+    /**
+     * @brief Muestra los registros [begin, end) de la tabla de símbolos
+     *
+     * begin debe ser un registro principal; los auxiliares van con el suyo.
+     */
+    void dumpSymbolRange(const uint8_t* data, uint32_t begin, uint32_t end, uint32_t numSymbols,
+                         std::string_view stringTable, std::ostream& output);
+    void dumpSymbol(const IMAGE_SYMBOL& symbol, std::string_view name, std::string& nameBuffer,
+                    std::ostream& output);
+
+    bool sectionSelected(const IMAGE_SECTION_HEADER& header) const;
+    bool symbolSelected(std::string_view name) const;
+
+    /**
+     * @brief Pool para count trozos de trabajo (nullptr si no compensa o jobs == 1)
+     */
+    std::unique_ptr<common::utils::ThreadPool> makePool(size_t count) const;
+
+    /**
+     * @brief Localiza la tabla de símbolos y la de strings que la sigue
+     * @return false si la tabla de símbolos no cabe en el archivo
+     */
+    static bool locateSymbolTable(const uint8_t* data, size_t size,
+                                  const uint8_t*& symbols, std::string_view& stringTable);
+
+    /**
+     * @brief Nombre de un símbolo: corto (8 bytes) o en la tabla de strings
+     */
+    static std::string_view symbolName(const IMAGE_SYMBOL& symbol, std::string_view stringTable);
 
     bool validateFileHeader(const IMAGE_FILE_HEADER& header);
     std::string getSectionName(const IMAGE_SECTION_HEADER& header);
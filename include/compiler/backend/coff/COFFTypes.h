@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 #include <string>
@@ -58,6 +59,7 @@ constexpr uint32_t IMAGE_SCN_ALIGN_1024BYTES         = 0x00B00000;
 constexpr uint32_t IMAGE_SCN_ALIGN_2048BYTES         = 0x00C00000;
 constexpr uint32_t IMAGE_SCN_ALIGN_4096BYTES         = 0x00D00000;
 constexpr uint32_t IMAGE_SCN_ALIGN_8192BYTES         = 0x00E00000;
+constexpr uint32_t IMAGE_SCN_ALIGN_MASK              = 0x00F00000;
 constexpr uint32_t IMAGE_SCN_LNK_NRELOC_OVFL         = 0x01000000;
 constexpr uint32_t IMAGE_SCN_MEM_DISCARDABLE         = 0x02000000;
 constexpr uint32_t IMAGE_SCN_MEM_NOT_CACHED          = 0x04000000;
@@ -84,6 +86,7 @@ constexpr uint8_t IMAGE_SYM_TYPE_BYTE                = 12;
 constexpr uint8_t IMAGE_SYM_TYPE_WORD                = 13;
 constexpr uint8_t IMAGE_SYM_TYPE_UINT                = 14;
 constexpr uint8_t IMAGE_SYM_TYPE_DWORD               = 15;
+constexpr uint16_t IMAGE_SYM_DTYPE_FUNCTION          = 0x20;
 
 // Symbol classes
 constexpr uint8_t IMAGE_SYM_CLASS_END_OF_FUNCTION    = 0xFF;
@@ -133,6 +136,30 @@ constexpr uint16_t IMAGE_REL_AMD64_SREL32            = 0x000E;
 constexpr uint16_t IMAGE_REL_AMD64_PAIR              = 0x000F;
 constexpr uint16_t IMAGE_REL_AMD64_SSPAN32           = 0x0010;
 
+// Relocations base de la imagen (.reloc): 4 bits de tipo y 12 de offset en la página
+constexpr uint16_t IMAGE_REL_BASED_ABSOLUTE          = 0;
+constexpr uint16_t IMAGE_REL_BASED_HIGHLOW           = 3;
+constexpr uint16_t IMAGE_REL_BASED_DIR64             = 10;
+
+// Entradas del directorio de datos del header opcional
+constexpr size_t IMAGE_DIRECTORY_ENTRY_IMPORT        = 1;
+constexpr size_t IMAGE_DIRECTORY_ENTRY_IAT           = 12;
+constexpr size_t IMAGE_DIRECTORY_ENTRY_DELAY_IMPORT  = 13;
+
+// COMDAT selection (registro auxiliar del símbolo de sección)
+constexpr uint8_t IMAGE_COMDAT_SELECT_NODUPLICATES   = 1;
+constexpr uint8_t IMAGE_COMDAT_SELECT_ANY            = 2;
+constexpr uint8_t IMAGE_COMDAT_SELECT_SAME_SIZE      = 3;
+constexpr uint8_t IMAGE_COMDAT_SELECT_EXACT_MATCH    = 4;
+constexpr uint8_t IMAGE_COMDAT_SELECT_ASSOCIATIVE    = 5;
+constexpr uint8_t IMAGE_COMDAT_SELECT_LARGEST        = 6;
+
+// Archivos de biblioteca (.lib)
+constexpr char IMAGE_ARCHIVE_START[]                 = "!<arch>\n";
+constexpr size_t IMAGE_ARCHIVE_START_SIZE            = 8;
+constexpr char IMAGE_ARCHIVE_END[]                   = "`\n";
+constexpr uint16_t IMPORT_OBJECT_HDR_SIG2            = 0xFFFF;
+
 // ========================================================================
 // Estructuras COFF según especificación
 // ========================================================================
@@ -183,6 +210,17 @@ struct IMAGE_SYMBOL {
     uint8_t NumberOfAuxSymbols;
 };
 
+// Auxiliary Symbol Record: Section Definition (18 bytes, como IMAGE_SYMBOL)
+struct IMAGE_AUX_SYMBOL_SECTION {
+    uint32_t Length;
+    uint16_t NumberOfRelocations;
+    uint16_t NumberOfLinenumbers;
+    uint32_t CheckSum;
+    uint16_t Number;            // Sección asociada (IMAGE_COMDAT_SELECT_ASSOCIATIVE)
+    uint8_t Selection;          // IMAGE_COMDAT_SELECT_*
+    uint8_t Unused[3];
+};
+
 // Relocation Entry
 struct IMAGE_RELOCATION {
     uint32_t VirtualAddress;
@@ -190,6 +228,36 @@ struct IMAGE_RELOCATION {
     uint16_t Type;
 };
 
+// Cabecera de cada miembro de una biblioteca; campos en ASCII rellenos con espacios
+struct IMAGE_ARCHIVE_MEMBER_HEADER {
+    char Name[16];              // "/" índice de símbolos, "//" nombres largos, "/n" o "nombre/"
+    char Date[12];
+    char UserID[6];
+    char GroupID[6];
+    char Mode[8];
+    char Size[10];              // Tamaño del miembro en decimal, sin esta cabecera
+    char EndHeader[2];          // IMAGE_ARCHIVE_END
+};
+
+// Miembro de importación corto (Sig1 = 0, Sig2 = 0xFFFF), seguido de
+// "símbolo\0dll\0"
+struct IMPORT_OBJECT_HEADER {
+    uint16_t Sig1;
+    uint16_t Sig2;
+    uint16_t Version;
+    uint16_t Machine;
+    uint32_t TimeDateStamp;
+    uint32_t SizeOfData;
+    uint16_t OrdinalOrHint;
+    uint16_t TypeInfo;          // Type:2, NameType:3, Reserved:11
+};
+
+// Bloque de relocations base: una página, seguida de sus entradas de 16 bits
+struct IMAGE_BASE_RELOCATION {
+    uint32_t VirtualAddress;    // RVA de la página
+    uint32_t SizeOfBlock;       // Con esta cabecera y el relleno hasta 4 bytes
+};
+
 // Import structures (simplified)
 struct IMAGE_IMPORT_DESCRIPTOR {
     union {
@@ -235,11 +303,76 @@ struct COFFSymbol {
     uint16_t type = 0;
     uint8_t storageClass = 0;
     uint8_t auxSymbols = 0;
+    std::vector<uint8_t> aux;   // auxSymbols registros de 18 bytes, tras la entrada
 
     COFFSymbol(std::string n, uint8_t storage = IMAGE_SYM_CLASS_EXTERNAL)
         : name(std::move(n)), storageClass(storage) {}
 };
 
+/**
+ * @brief Relocación del código de una función contra un símbolo por nombre
+ */
+struct COFFFunctionRelocation {
+    uint32_t offset;        // Relativo al inicio de la función
+    std::string symbol;
+    uint16_t type;          // IMAGE_REL_AMD64_*
+};
+
+/**
+ * @brief Símbolo que el linker define en la base de la imagen (RVA 0)
+ */
+inline constexpr const char* ImageBaseSymbol = "__ImageBase";
+
+/**
+ * @brief Tabla de saltos de una función, para .rdata
+ *
+ * El código la referencia con una relocación ADDR32NB contra name;
+ * appendFunctions la resuelve contra la tabla emitida. Cada entrada es la
+ * RVA de su destino, con otra ADDR32NB contra el código de la función.
+ */
+struct COFFJumpTable {
+    std::string name;
+    std::vector<uint32_t> targets;      // Offsets de los destinos, relativos a la función
+};
+
+/**
+ * @brief Código y unwind de una función, generados de forma independiente
+ *
+ * Los offsets son relativos a la propia función; appendFunctions los
+ * recoloca al coserla en .text, .xdata y .pdata. Con comdatSelection la
+ * función va en su propia sección COMDAT, que el linker puede descartar
+ * si no se referencia o si otro objeto ya trae la misma definición.
+ */
+struct COFFFunction {
+    std::string name;
+    std::vector<uint8_t> code;
+    std::vector<uint8_t> unwindInfo;    // UNWIND_INFO serializado (vacío = sin .pdata)
+    std::vector<COFFFunctionRelocation> relocations;
+    std::vector<COFFJumpTable> jumpTables = {};   // Inicializada: los literales {...} pueden omitirla
+    uint32_t unwindBegin = 0;           // Bytes iniciales sin marco, fuera de la RUNTIME_FUNCTION
+    uint8_t comdatSelection = 0;        // IMAGE_COMDAT_SELECT_* de su sección propia; 0 = .text común
+};
+
+/**
+ * @brief Dato de solo lectura: literal de cadena o tabla constante
+ *
+ * appendLiterals lo coloca en .rdata bajo un nombre derivado de su
+ * contenido, así que dos usos con los mismos bytes comparten copia.
+ */
+struct COFFLiteral {
+    std::vector<uint8_t> data;          // Con el terminador, si es una cadena
+    uint32_t alignment = 1;             // Potencia de dos, hasta 8192
+};
+
+/**
+ * @brief Variable global escribible con su valor inicial, para .data
+ */
+struct COFFVariable {
+    std::string name;
+    std::vector<uint8_t> data;          // Valor inicial; a cero si no tiene
+    uint32_t alignment = 8;             // Potencia de dos, hasta 8192
+};
+
 /**
  * @brief Representa un objeto COFF completo
  */
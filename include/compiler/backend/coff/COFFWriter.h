@@ -6,8 +6,29 @@
 
 namespace cpp20::compiler::backend::coff {
 
+/**
+ * @brief Posición de cada parte del archivo, calculada antes de escribir nada
+ */
+struct COFFLayout {
+    std::vector<size_t> rawDataOffsets;     // PointerToRawData de cada sección
+    std::vector<size_t> relocationOffsets;  // PointerToRelocations (0 si no tiene)
+    std::vector<uint32_t> symbolIndices;    // Índice en la tabla de cada símbolo (tras los auxiliares)
+    std::vector<uint32_t> nameOffsets;      // Offset en la tabla de cadenas de los nombres de más de 8 (0 si cabe)
+    uint32_t symbolTableEntries = 0;        // NumberOfSymbols: símbolos más registros auxiliares
+    size_t symbolTableOffset = 0;
+    size_t stringTableOffset = 0;
+    size_t stringTableSize = 0;             // Incluye el campo de tamaño de 4 bytes
+    size_t fileSize = 0;
+};
+
 /**
  * @brief Escritor de archivos objeto COFF
+ *
+ * Escribe en dos pasadas: primero calcula el layout completo (tamaños y
+ * offsets de cabeceras, secciones, relocaciones, símbolos y cadenas) y
+ * después copia cada parte directamente a su sitio en el archivo de
+ * salida, proyectado en memoria con su tamaño final. No se arma una
+ * copia del objeto en memoria, y las partes se escriben en paralelo.
  */
 class COFFWriter {
 public:
@@ -17,19 +38,30 @@ public:
      * @brief Escribe un objeto COFF a un archivo
      * @param object El objeto COFF a escribir
      * @param filename Nombre del archivo de salida
+     * @param jobs Hilos para copiar las secciones (1 = en el hilo actual)
      * @return true si la escritura fue exitosa
      */
-    bool writeObject(const COFFObject& object, const std::string& filename);
+    bool writeObject(const COFFObject& object, const std::string& filename, size_t jobs = 1);
+
+    /**
+     * @brief Serializa un objeto COFF en memoria, con el mismo layout que en disco
+     * @param object El objeto COFF a escribir
+     * @param image Recibe los bytes del objeto
+     * @param jobs Hilos para copiar las secciones (1 = en el hilo actual)
+     * @return true si el objeto cabe en los offsets COFF
+     */
+    bool writeObject(const COFFObject& object, std::vector<uint8_t>& image, size_t jobs = 1);
+
+    /**
+     * @brief Primera pasada: dónde va cada parte del objeto
+     */
+    static COFFLayout computeLayout(const COFFObject& object);
 
 private:
-    void writeHeader(const COFFObject& object, std::vector<uint8_t>& buffer);
+    void writeImage(const COFFObject& object, const COFFLayout& layout, uint8_t* image, size_t jobs);
     void writeSectionHeader(const COFFSection& section, IMAGE_SECTION_HEADER& header);
-    void writeSections(const COFFObject& object, std::vector<uint8_t>& buffer);
-    void writeSymbols(const COFFObject& object, std::vector<uint8_t>& buffer);
-    void writeSymbol(const COFFSymbol& symbol, IMAGE_SYMBOL& entry);
-    void writeStringTable(const COFFObject& object, std::vector<uint8_t>& buffer);
-    void updateHeaderOffsets(std::vector<uint8_t>& buffer, const COFFObject& object);
-    void appendBytes(std::vector<uint8_t>& buffer, const void* data, size_t size);
+    void writeSymbol(const COFFSymbol& symbol, uint32_t nameOffset, IMAGE_SYMBOL& entry);
+    void writeStringTable(const COFFObject& object, const COFFLayout& layout, uint8_t* out);
 };
 
 // ========================================================================
@@ -42,6 +74,70 @@ private:
  */
 COFFObject createBasicCOFFObject();
 
+/**
+ * @brief Cose en el objeto el código y el unwind de varias funciones
+ *
+ * Las funciones se colocan en el orden del vector, así que el resultado
+ * es el mismo sin importar qué hilo generó cada una. Cada función empieza
+ * alineada a 16 bytes en .text, y su UNWIND_INFO alineado a 4 en .xdata,
+ * donde las que no van en COMDAT con el mismo UNWIND_INFO comparten registro;
+ * en .pdata se añade su RUNTIME_FUNCTION con relocaciones ADDR32NB, que
+ * empieza en unwindBegin (el tramo anterior no tiene marco). Las
+ * relocaciones del código se pasan a .text contra el símbolo de su
+ * nombre, que queda externo sin definir si no es de este objeto, salvo
+ * las que nombran una de sus tablas de saltos: esas van contra la .rdata
+ * donde se emite la tabla, con entradas ADDR32NB alineadas a 4. Las
+ * secciones que falten se crean.
+ *
+ * Una función con comdatSelection va en su propia .text$mn COMDAT: su
+ * símbolo de sección lleva la definición auxiliar con esa selección y el
+ * de la función, justo detrás, es el símbolo COMDAT. Su .xdata, .pdata y
+ * .rdata de tablas son secciones COMDAT asociativas a ella, para que el
+ * linker las descarte junto con el código.
+ */
+void appendFunctions(COFFObject& object, const std::vector<COFFFunction>& functions);
+
+/**
+ * @brief Símbolo de un literal según su contenido: "??_C@_<tamaño>_<hash>@"
+ *
+ * El hash es de 128 bits (StreamingHasher), estable entre máquinas y
+ * unidades: objetos distintos nombran igual los mismos bytes.
+ */
+std::string literalSymbolName(const std::vector<uint8_t>& data);
+
+/**
+ * @brief Añade literales de solo lectura al objeto, uno por contenido
+ *
+ * Cada contenido distinto va una sola vez, en su propia .rdata COMDAT
+ * SELECT_ANY cuyo símbolo es literalSymbolName(data): los usos repetidos
+ * dentro de la unidad comparten sección, y el linker se queda con una
+ * copia de las de todos los objetos. El código los referencia con
+ * relocaciones contra ese nombre, así que se añaden antes que las
+ * funciones que los usan. Un mismo contenido con dos alineamientos se
+ * emite con el mayor.
+ * @return Nombre del símbolo de cada literal, en el orden de literals
+ */
+std::vector<std::string> appendLiterals(COFFObject& object, const std::vector<COFFLiteral>& literals);
+
+/**
+ * @brief Añade variables globales escribibles a .data, con símbolo externo
+ *
+ * Como los literales, se añaden antes que las funciones que las usan para
+ * que sus relocaciones no creen símbolos sin definir.
+ */
+void appendVariables(COFFObject& object, const std::vector<COFFVariable>& variables);
+
+/**
+ * @brief Registra funciones que el CRT llama al cargar la imagen
+ *
+ * Cada una es un puntero de 8 bytes en .CRT$XCC con una relocación ADDR64.
+ * El CRT recorre las .CRT$XC* en orden alfabético antes de main (o en
+ * DLL_PROCESS_ATTACH), así que corren antes que los constructores de los
+ * globales del usuario, que van en .CRT$XCU. Se añaden después de las
+ * funciones, para que la relocación use su símbolo ya definido.
+ */
+void appendInitializers(COFFObject& object, const std::vector<std::string>& functions);
+
 /**
  * @brief Escribe un objeto COFF a un archivo
  * @param object El objeto COFF a escribir
@@ -33,6 +33,16 @@ namespace abi {
     class ABIContract;
 }
 
+/**
+ * @brief Lo que el código de una función exige a su marco, ya asignados los registros
+ */
+struct FrameRequirements {
+    bool makesCalls = false;                // Shadow space y pila alineada a 16 en cada CALL
+    bool needsFramePointer = false;         // Reservas dinámicas de pila: RBP fijo
+    size_t localSize = 0;                   // Spills y variables locales
+    std::vector<uint8_t> usedCalleeSaved;   // No volátiles que escribe el cuerpo (número hardware)
+};
+
 /**
  * @brief Constructor de frames de pila para x86_64
  *
@@ -58,6 +68,28 @@ public:
         size_t localSize,
         size_t spillSize);
 
+    /**
+     * @brief Construye el marco mínimo de una función
+     *
+     * Una función que no llama, no usa pila ni toca no volátiles es hoja:
+     * sin prólogo ni UNWIND_INFO (Windows x64 asume entonces que [RSP] es
+     * la dirección de retorno). En el resto solo se guardan los no
+     * volátiles usados, el shadow space solo se reserva si hay llamadas y
+     * RBP solo se fija si se pide; los locales van relativos a RSP.
+     */
+    FrameLayout buildFunctionFrame(const FrameRequirements& requirements);
+
+    /**
+     * @brief Coloca los huecos en el área de locales
+     *
+     * Cada color ocupa una sola posición, del tamaño y la alineación de su
+     * mayor hueco. Las posiciones van de mayor a menor alineación, así que
+     * no queda relleno entre ellas; la alineación se limita a 16, la que
+     * garantiza RSP tras el prólogo.
+     * @return Bytes del área, múltiplo de 8
+     */
+    static size_t layoutStackSlots(std::vector<StackSlot>& slots);
+
     /**
      * @brief Clasifica parámetros según el ABI
      * @param paramSizes Vector de (size, alignment) para cada parámetro
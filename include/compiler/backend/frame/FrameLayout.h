@@ -1,13 +1,31 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <vector>
 
 namespace cpp20::compiler::backend {
 
+/**
+ * @brief Hueco del área de locales: una variable local o un slot de spill
+ *
+ * Los huecos del mismo color nunca están vivos a la vez y comparten
+ * posición (FrameBuilder::layoutStackSlots).
+ */
+struct StackSlot {
+    size_t size = 8;
+    size_t alignment = 8;
+    uint32_t color = 0;
+    size_t offset = 0;      // Dentro del área de locales; lo fija layoutStackSlots
+};
+
 /**
  * @brief Información del layout de un stack frame
  */
 struct FrameLayout {
+    /// Reservar más de una página de golpe podría saltarse la página de guarda
+    static constexpr size_t PageSize = 4096;
+
     // Tamaños de áreas
     size_t parameterAreaSize = 0;   // Área de parámetros en stack
     size_t localAreaSize = 0;       // Área de variables locales
@@ -18,8 +36,39 @@ struct FrameLayout {
     size_t savedRbpOffset = 0;      // Offset de RBP guardado
     size_t firstParameterOffset = 0;// Offset del primer parámetro
 
+    // Marco concreto de una función (FrameBuilder::buildFunctionFrame)
+    bool isLeaf = false;                    // Sin prólogo ni UNWIND_INFO
+    bool usesFramePointer = false;          // RBP fijo; si no, todo es relativo a RSP
+    std::vector<uint8_t> savedRegisters;    // No volátiles a guardar (número hardware), en orden de PUSH
+    size_t shadowSpaceSize = 0;             // 32 si la función llama a otras
+    size_t allocationSize = 0;              // SUB RSP tras los PUSH: shadow, locales y relleno
+
     size_t totalSize() const;
     bool isValid() const;
+
+    /**
+     * @brief Registro base de los locales (número hardware: RSP o RBP)
+     */
+    uint8_t frameRegister() const { return usesFramePointer ? 5 : 4; }
+
+    /**
+     * @brief La reserva necesita tocar la pila página a página (__chkstk)
+     *
+     * Por debajo de una página la reserva cae, como mucho, en la página de
+     * guarda, que el sistema amplía solo; las funciones pequeñas se ahorran
+     * la llamada.
+     */
+    bool needsStackProbe() const { return allocationSize >= PageSize; }
+
+    /**
+     * @brief Desplazamiento desde frameRegister() de un byte del área de locales
+     *
+     * RBP se fija justo después de reservar, así que el desplazamiento es
+     * el mismo con y sin puntero de marco.
+     */
+    int32_t localOffset(size_t offset) const {
+        return static_cast<int32_t>(shadowSpaceSize + offset);
+    }
 };
 
 } // namespace cpp20::compiler::backend
@@ -0,0 +1,138 @@
+/**
+ * @file LinkTimeOptimizer.h
+ * @brief Optimización en tiempo de enlace (-flto) sobre el IR embebido en los objetos
+ */
+
+#pragma once
+
+#include "compiler/backend/abi/ABIContract.h"
+#include "compiler/backend/coff/COFFTypes.h"
+#include "compiler/backend/link/MiniLinker.h"
+#include "compiler/common/EnvironmentDetector.h"
+#include "compiler/ir/IR.h"
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace cpp20::compiler::backend::link {
+
+/**
+ * @brief Sección COFF que lleva el IR de un objeto compilado con -flto
+ */
+inline constexpr const char* IRSectionName = ".cppir";
+
+/**
+ * @brief Añade al objeto una sección IRSectionName con el módulo serializado
+ *
+ * La sección es IMAGE_SCN_LNK_INFO | IMAGE_SCN_LNK_REMOVE: un linker que
+ * no hace LTO la descarta sin copiarla a la imagen.
+ */
+void embedIRModule(coff::COFFObject& object, const ir::IRModule& module);
+
+/**
+ * @brief Estadísticas de un enlace con LTO
+ */
+struct LTOStatistics {
+    size_t modules = 0;             // Objetos con IR
+    size_t functions = 0;           // Definiciones tras fusionar y optimizar
+    size_t removedFunctions = 0;    // Inline/plantillas que nadie usa tras el pipeline
+    size_t partitions = 0;          // Objetos generados
+    size_t cachedFunctions = 0;     // Código tomado de la caché compartida
+};
+
+/**
+ * @brief Fusiona los módulos de IR del enlace, los optimiza juntos y genera código
+ *
+ * Los módulos se fusionan por nombre: una definición sustituye a una
+ * declaración, de las LinkOnce (inline, plantillas) queda la primera y dos
+ * definiciones External del mismo nombre son un error. El pipeline de
+ * createForOptimizationLevel corre sobre el programa entero, así que el
+ * inliner cruza unidades y la desvirtualización ve todas las clases.
+ *
+ * La generación de código se reparte, como en ThinLTO, en particiones
+ * equilibradas por número de instrucciones; cada una se genera en un hilo
+ * y da un objeto COFF propio, y las llamadas entre particiones las
+ * resuelve el linker como entre objetos normales.
+ */
+class LinkTimeOptimizer {
+public:
+    explicit LinkTimeOptimizer(int optimizationLevel = 2);
+
+    /**
+     * @brief Perfil con el que anotar el programa antes de optimizarlo
+     *
+     * Debe seguir vivo hasta optimize().
+     */
+    void setProfile(const ir::ProfileData* profile) { profile_ = profile; }
+
+    /**
+     * @brief Caché de código máquina para las particiones (nullptr = ninguna)
+     *
+     * Una función cuyo IR optimizado no cambió desde el enlace anterior
+     * no vuelve a pasar por el back-end.
+     */
+    void setCodeCache(MachineCodeCache* cache) { codeCache_ = cache; }
+
+    /**
+     * @brief CPU destino (-march) y microarquitectura del planificador (-mtune)
+     *
+     * Las extensiones deciden el ancho del vectorizador y las instrucciones
+     * que elige el back-end; por defecto, x64 base y Generic.
+     */
+    void setTarget(const CPUFeatures& features, Microarchitecture tune) {
+        features_ = features;
+        tune_ = tune;
+    }
+
+    /**
+     * @brief Añade el contenido de una sección IRSectionName
+     * @param origin Objeto del que sale, para los mensajes
+     * @return false si no es IR válido o define algo ya definido (getLastError)
+     */
+    bool addModule(std::span<const uint8_t> bytes, const std::string& origin);
+
+    bool empty() const { return statistics_.modules == 0; }
+
+    /**
+     * @brief Optimiza el programa fusionado y quita las LinkOnce sin usos
+     */
+    void optimize();
+
+    /**
+     * @brief Genera un objeto por partición
+     * @param jobs Hilos a usar; también es el número máximo de particiones
+     * @return false si no se pudo escribir algún objeto
+     */
+    bool generateObjects(size_t jobs, std::vector<ObjectImage>& images);
+
+    const ir::IRModule& getModule() const { return module_; }
+    const LTOStatistics& getStatistics() const { return statistics_; }
+    const std::string& getLastError() const { return lastError_; }
+
+private:
+    int optimizationLevel_;
+    const ir::ProfileData* profile_ = nullptr;
+    MachineCodeCache* codeCache_ = nullptr;
+    CPUFeatures features_;
+    Microarchitecture tune_ = Microarchitecture::Generic;
+    abi::ABIContract abiContract_;
+    ir::IRModule module_;                                   // Globales y clases; funciones tras optimize()
+    std::vector<std::unique_ptr<ir::IRFunction>> functions_;
+    std::vector<std::string> functionOrigins_;
+    std::unordered_map<std::string, size_t> functionIndex_;  // Nombre -> posición en functions_
+    std::unordered_set<std::string> globalNames_;
+    std::unordered_set<std::string> classNames_;
+    LTOStatistics statistics_;
+    std::string lastError_;
+
+    /**
+     * @brief Quita las LinkOnce que no alcanza ninguna función External
+     */
+    void removeUnusedLinkOnce();
+};
+
+} // namespace cpp20::compiler::backend::link
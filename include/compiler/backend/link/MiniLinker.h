@@ -6,63 +6,29 @@
 #pragma once
 
 #include "compiler/backend/coff/COFFTypes.h"
+#include "compiler/backend/mangling/MSVCDemangler.h"
+#include "compiler/common/EnvironmentDetector.h"
+#include "compiler/common/utils/MappedFile.h"
+#include <array>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
 #include <memory>
+#include <optional>
 #include <filesystem>
 #include <cstdint>
+#include <shared_mutex>
+#include <span>
 #include <string>
+#include <string_view>
 
-// ========================================================================
-// Definiciones directas de tipos COFF para evitar problemas de namespace
-// ========================================================================
+namespace cpp20::compiler::ir {
+class ProfileData;
+}
 
 namespace cpp20::compiler::backend {
-
-// Forward declarations and type definitions
-namespace coff {
-
-// COFF Symbol structure
-struct COFFSymbol {
-    std::string name;
-    uint32_t value = 0;
-    int16_t sectionNumber = 0;
-    uint16_t type = 0;
-    uint8_t storageClass = 0;
-    uint8_t auxSymbols = 0;
-
-    COFFSymbol(std::string n, uint8_t storage = 2) // IMAGE_SYM_CLASS_EXTERNAL = 2
-        : name(std::move(n)), storageClass(storage) {}
-};
-
-// COFF File Header structure
-struct IMAGE_FILE_HEADER {
-    uint16_t Machine;
-    uint16_t NumberOfSections;
-    uint32_t TimeDateStamp;
-    uint32_t PointerToSymbolTable;
-    uint32_t NumberOfSymbols;
-    uint16_t SizeOfOptionalHeader;
-    uint16_t Characteristics;
-};
-
-// COFF Section Header structure
-struct IMAGE_SECTION_HEADER {
-    char Name[8];
-    uint32_t VirtualSize;
-    uint32_t VirtualAddress;
-    uint32_t SizeOfRawData;
-    uint32_t PointerToRawData;
-    uint32_t PointerToRelocations;
-    uint32_t PointerToLinenumbers;
-    uint16_t NumberOfRelocations;
-    uint16_t NumberOfLinenumbers;
-    uint32_t Characteristics;
-};
-
-} // namespace coff
-} // namespace cpp20::compiler::backend
+class MachineCodeCache;
+}
 
 namespace cpp20::compiler::backend::link {
 
@@ -87,17 +53,23 @@ using COFFSymbol = cpp20::compiler::backend::coff::COFFSymbol;
 
 /**
  * @brief Información de relocalización extendida
+ *
+ * Si el símbolo destino es local (por ejemplo el de una sección),
+ * targetSection es su sección en el objeto (base 1); al combinar pasa a
+ * ser la sección combinada, con addend el desplazamiento en ella. Con
+ * targetSection 0 el destino se busca por symbolName en la tabla global.
  */
 struct RelocationInfo {
     uint32_t virtualAddress;
     uint32_t symbolIndex;
     uint16_t type;
-    std::string symbolName;
+    std::string_view symbolName;    // En la tabla de cadenas del objeto proyectado
     uint32_t addend;
     uint32_t sectionOffset;
+    int16_t targetSection = 0;
 
     RelocationInfo(uint32_t vaddr = 0, uint32_t symIdx = 0, uint16_t t = 0,
-                   const std::string& symName = "", uint32_t add = 0, uint32_t sectOff = 0)
+                   std::string_view symName = {}, uint32_t add = 0, uint32_t sectOff = 0)
         : virtualAddress(vaddr), symbolIndex(symIdx), type(t), symbolName(symName),
           addend(add), sectionOffset(sectOff) {}
 };
@@ -105,9 +77,13 @@ struct RelocationInfo {
 
 /**
  * @brief Información de un símbolo en el proceso de linking
+ *
+ * El nombre es una vista sobre el objeto proyectado (o un literal de
+ * runtime): no se copia, y sigue siendo válido mientras el linker
+ * conserve el objeto.
  */
 struct SymbolInfo {
-    std::string name;
+    std::string_view name;
     uint32_t value;
     int16_t sectionNumber;  // Cambiado a int16_t para ser consistente con COFF
     uint16_t type;
@@ -115,19 +91,126 @@ struct SymbolInfo {
     bool isDefined;
     bool isExternal;
     bool isWeak;
-    std::string moduleName;  // Archivo objeto donde se define
+    uint32_t objectIndex = 0;  // Archivo objeto donde se define (orden de addObjectFile)
 
-    SymbolInfo(const std::string& n = "", uint32_t val = 0, int16_t sect = 0)
+    SymbolInfo(std::string_view n = {}, uint32_t val = 0, int16_t sect = 0)
         : name(n), value(val), sectionNumber(sect), type(0), storageClass(0),
           isDefined(false), isExternal(false), isWeak(false) {}
 };
 
+/**
+ * @brief Tabla global de símbolos, concurrente
+ *
+ * Cada nombre se interna una sola vez por enlace: la clave es la vista
+ * del nombre en el objeto con su hash, calculado sobre los bytes de la
+ * tabla de cadenas sin copiarlos. Está dividida en shards con su propio
+ * shared_mutex, como IdentifierTable, para que varios objetos inserten a
+ * la vez. Al insertar se fusiona con la entrada existente y se cuentan
+ * las definiciones, así que los conflictos salen del mismo recorrido.
+ */
+class GlobalSymbolTable {
+public:
+    /**
+     * @brief Inserta el símbolo o lo fusiona con el del mismo nombre (thread-safe)
+     *
+     * Una definición sustituye a una referencia; entre dos definiciones
+     * gana la de mayor order, igual que si los objetos se insertaran en
+     * serie, sea cual sea el hilo que llegue antes.
+     * @param order Posición del objeto en el enlace (0 para runtime)
+     */
+    void insert(const SymbolInfo& symbol, uint32_t order);
+
+    SymbolInfo* find(std::string_view name);
+    const SymbolInfo* find(std::string_view name) const;
+
+    /**
+     * @brief Nombres con más de una definición, contadas al insertar
+     */
+    std::vector<std::string_view> conflicts() const;
+
+    /**
+     * @brief Recorre todas las entradas (no concurrente con insert)
+     */
+    template <typename Function>
+    void forEach(Function&& function) {
+        for (auto& shard : shards_) {
+            for (auto& [key, entry] : shard.entries) function(entry.symbol);
+        }
+    }
+
+    template <typename Function>
+    void forEach(Function&& function) const {
+        for (const auto& shard : shards_) {
+            for (const auto& [key, entry] : shard.entries) function(entry.symbol);
+        }
+    }
+
+    /**
+     * @brief Quita las entradas que cumplen predicate (no concurrente con insert)
+     */
+    template <typename Predicate>
+    void eraseIf(Predicate&& predicate) {
+        for (auto& shard : shards_) {
+            std::erase_if(shard.entries, [&](const auto& item) { return predicate(item.second.symbol); });
+        }
+    }
+
+    size_t size() const;
+    void clear();
+
+private:
+    static constexpr size_t kShardCount = 16;
+
+    // Nombre internado: el hash se calcula una vez y lo reutilizan shard y mapa
+    struct Key {
+        std::string_view name;
+        size_t hash;
+        bool operator==(const Key& other) const { return name == other.name; }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const { return key.hash; }
+    };
+
+    struct Entry {
+        SymbolInfo symbol;
+        uint32_t order = 0;
+        uint32_t definitions = 0;
+    };
+
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<Key, Entry, KeyHash> entries;
+    };
+
+    std::array<Shard, kShardCount> shards_;
+
+    static Key makeKey(std::string_view name);
+    Shard& shardFor(const Key& key) { return shards_[key.hash % kShardCount]; }
+    const Shard& shardFor(const Key& key) const { return shards_[key.hash % kShardCount]; }
+};
+
+/**
+ * @brief Trozo de una sección combinada: los bytes de una sección de un objeto
+ */
+struct SectionContribution {
+    uint32_t offset;                    // Dentro de la sección combinada
+    std::span<const uint8_t> bytes;     // En la proyección del objeto, sin copiar
+    std::vector<RelocationInfo> relocations;  // Las suyas, ya relativas a la sección combinada
+    uint32_t reserved = 0;              // Enlace incremental: hueco total, con el relleno para crecer
+    uint32_t objectIndex = 0;           // Objeto del que sale
+};
+
 /**
  * @brief Información de una sección en el proceso de linking
+ *
+ * Las de un objeto ven sus bytes en la proyección del archivo
+ * (contents); las combinadas solo guardan qué trozo va en cada offset,
+ * y los bytes se copian una vez, directamente al archivo de salida.
  */
 struct SectionInfo {
     std::string name;
-    std::vector<uint8_t> data;
+    std::span<const uint8_t> contents;                  // Sección de un objeto
+    std::vector<SectionContribution> contributions;     // Sección combinada
     uint32_t virtualAddress;
     uint32_t rawSize;
     uint32_t virtualSize;
@@ -135,6 +218,20 @@ struct SectionInfo {
     std::vector<RelocationInfo> relocations;
     bool isBSS;  // Sección sin inicialización
 
+    // COMDAT (IMAGE_SCN_LNK_COMDAT)
+    uint8_t comdatSelection = 0;        // IMAGE_COMDAT_SELECT_*; 0 = no es COMDAT
+    std::string_view comdatSymbol;      // Nombre que identifica las copias entre objetos
+    uint16_t associatedSection = 0;     // Sección de la que depende si es asociativa (base 1)
+    bool discarded = false;             // Copia repetida o sin referencias: no se combina
+    int32_t foldedObject = -1;          // ICF: objeto de la sección idéntica que la sustituye
+    uint16_t foldedSection = 0;         // ICF: esa sección (base 0)
+
+    // Posición en la sección combinada (combineSections)
+    uint32_t outputSection = 0;
+    uint32_t outputOffset = 0;
+    uint32_t outputCapacity = 0;        // Hueco reservado (con relleno en modo incremental)
+    int32_t outputContribution = -1;    // Índice en contributions de la sección combinada
+
     SectionInfo(const std::string& n = "")
         : name(n), virtualAddress(0), rawSize(0), virtualSize(0),
           characteristics(0), isBSS(false) {}
@@ -145,6 +242,7 @@ struct SectionInfo {
  */
 struct ObjectFileInfo {
     std::filesystem::path path;
+    std::shared_ptr<const void> mapping;    // Proyección o imagen en memoria: mantiene válidas las vistas
     std::vector<SectionInfo> sections;
     std::vector<SymbolInfo> symbols;
     std::string machineType;
@@ -154,6 +252,47 @@ struct ObjectFileInfo {
         : path(p), isValid(false) {}
 };
 
+/**
+ * @brief Objeto COFF ya en memoria, para enlazar sin escribir un .obj
+ */
+struct ObjectImage {
+    std::filesystem::path name;     // Solo identifica el objeto; no tiene que existir
+    std::vector<uint8_t> bytes;
+};
+
+/**
+ * @brief Entrada del índice de símbolos de una biblioteca
+ */
+struct ArchiveSymbol {
+    std::string_view name;      // En el miembro índice, sobre la proyección
+    uint32_t memberOffset;      // Cabecera del miembro que lo define
+};
+
+/**
+ * @brief Miembro de una biblioteca (ni enlazador ni tabla de nombres largos)
+ */
+struct ArchiveMember {
+    std::string_view name;              // Sin "/" final; los largos, resueltos en "//"
+    uint32_t offset;                    // Cabecera del miembro
+    std::span<const uint8_t> contents;
+};
+
+/**
+ * @brief Biblioteca estática o de importación (.lib) proyectada
+ *
+ * De ella solo se lee el índice de símbolos; cada miembro se analiza
+ * cuando define algo que sigue sin definir (loadLibraryMembers).
+ */
+struct LibraryInfo {
+    std::filesystem::path path;
+    std::shared_ptr<const common::utils::MappedFile> mapping;
+    std::vector<ArchiveSymbol> symbolIndex;         // Ordenado por nombre
+    std::unordered_set<uint32_t> loadedMembers;     // Offsets de los miembros ya cargados
+
+    LibraryInfo(const std::filesystem::path& p)
+        : path(p) {}
+};
+
 /**
  * @brief Información de import de biblioteca
  */
@@ -161,11 +300,61 @@ struct ImportInfo {
     std::string dllName;
     std::vector<std::string> functionNames;
     std::vector<uint16_t> hintOrdinals;
+    bool delayLoaded = false;       // /DELAYLOAD: se enlaza en la primera llamada
 
     ImportInfo(const std::string& dll = "")
         : dllName(dll) {}
 };
 
+/**
+ * @brief Base de datos del enlace incremental (<salida>.ilk)
+ *
+ * Guarda dónde quedó cada sección de entrada y cuánto hueco tiene, el
+ * layout de las secciones combinadas y la dirección final de cada
+ * símbolo. Con ella el siguiente enlace puede conservar el layout y
+ * reescribir en el sitio solo los trozos que cambian.
+ */
+struct IncrementalDatabase {
+    struct Placement {
+        uint32_t outputSection;         // Índice en las secciones combinadas
+        uint32_t offset;                // Dentro de la sección combinada
+        uint32_t capacity;              // Bytes reservados, relleno incluido
+    };
+
+    struct Object {
+        std::string path;
+        uint64_t size = 0;
+        int64_t modified = 0;           // last_write_time del archivo
+        std::vector<Placement> placements;  // Una por sección enlazada, en orden
+    };
+
+    struct Section {
+        std::string name;
+        uint32_t characteristics = 0;
+        uint32_t virtualSize = 0;
+        uint32_t rawSize = 0;
+        bool isBSS = false;
+    };
+
+    std::string entryPoint;
+    uint64_t imageBase = 0;
+    uint64_t fileSize = 0;
+    std::vector<Object> objects;
+    std::vector<Section> sections;
+    std::unordered_map<std::string, uint32_t> symbols;  // Nombre -> RVA
+
+    /**
+     * @brief Ruta de la base de datos para un ejecutable
+     */
+    static std::filesystem::path pathFor(const std::filesystem::path& outputFile);
+
+    /**
+     * @return false si no existe o no tiene el formato esperado
+     */
+    bool read(const std::filesystem::path& path);
+    bool write(const std::filesystem::path& path) const;
+};
+
 /**
  * @brief Resultado del proceso de linking
  */
@@ -202,6 +391,23 @@ public:
      */
     bool addObjectFile(const std::filesystem::path& objectFile);
 
+    /**
+     * @brief Añade varios archivos objeto, analizándolos en paralelo (setJobs)
+     *
+     * Se añaden en el orden dado; los que no se pueden leer se omiten.
+     * @return false si alguno no se pudo añadir
+     */
+    bool addObjectFiles(const std::vector<std::filesystem::path>& objectFiles);
+
+    /**
+     * @brief Añade objetos generados en este proceso, sin pasar por disco
+     *
+     * Igual que addObjectFiles, pero el linker se queda con los bytes de
+     * cada imagen en lugar de proyectar un archivo. Estos objetos no
+     * tienen fecha de modificación: el enlace incremental no los parchea.
+     */
+    bool addObjectImages(std::vector<ObjectImage> images);
+
     /**
      * @brief Añade una biblioteca para importar
      */
@@ -232,6 +438,82 @@ public:
      */
     void setOptimize(bool optimize);
 
+    /**
+     * @brief Hilos para leer objetos, llenar la tabla de símbolos, copiar secciones y
+     *        aplicar relocations (1 = en el hilo actual)
+     */
+    void setJobs(size_t jobs);
+
+    /**
+     * @brief Enlace incremental (/INCREMENTAL)
+     *
+     * Cada sección de entrada recibe hueco para crecer y el layout se
+     * guarda junto a la salida. Si en el siguiente enlace los cambios
+     * caben en su hueco, solo se reescriben en el ejecutable existente
+     * los trozos de los objetos modificados y los que apuntan a símbolos
+     * que se han movido; si no, se hace un enlace completo.
+     */
+    void setIncremental(bool incremental);
+
+    /**
+     * @brief Nivel -O con el que se optimiza el IR de los objetos de -flto
+     *
+     * Los objetos con sección de IR (LinkTimeOptimizer) se detectan solos
+     * al enlazar; este nivel solo decide el pipeline que se les aplica.
+     */
+    void setLTOOptimizationLevel(int level);
+
+    /**
+     * @brief Perfil de -fprofile-use
+     *
+     * El IR de -flto se anota con él antes de optimizarlo y, si no hay un
+     * orden explícito (setFunctionOrder, loadOrderFile), las funciones
+     * ejecutadas van primero en .text, de más a menos llamadas.
+     */
+    void setProfile(std::shared_ptr<const ir::ProfileData> profile);
+
+    /**
+     * @brief Caché de código máquina para las particiones de -flto
+     *
+     * Con ella, la generación de código de LTO se reduce a consultas para
+     * las funciones cuyo IR optimizado no cambió (LinkTimeOptimizer::setCodeCache).
+     */
+    void setCodeCache(std::shared_ptr<MachineCodeCache> cache);
+
+    /**
+     * @brief CPU para la que se genera el código de -flto (LinkTimeOptimizer::setTarget)
+     */
+    void setTarget(const CPUFeatures& features, Microarchitecture tune);
+
+    /**
+     * @brief Orden de las funciones en .text (/ORDER)
+     *
+     * Las secciones que definen estos símbolos van primero y en este
+     * orden, para que el código caliente ocupe las menos páginas posibles;
+     * el resto sigue en el orden de los objetos.
+     */
+    void setFunctionOrder(std::vector<std::string> symbols);
+
+    /**
+     * @brief Lee el orden de un archivo: un símbolo por línea, opcionalmente
+     *        seguido de su número de ejecuciones (perfil)
+     *
+     * Si hay recuentos, las funciones se ordenan de más a menos ejecutadas;
+     * las líneas vacías y las que empiezan por '#' se ignoran.
+     * @return false si no se puede leer
+     */
+    bool loadOrderFile(const std::filesystem::path& orderFile);
+
+    /**
+     * @brief Carga diferida de una DLL (/DELAYLOAD)
+     *
+     * El loader no la carga al arrancar: su IAT apunta a un thunk que en
+     * la primera llamada a cada función llama a __delayLoadHelper2
+     * (delayimp.lib), que carga la DLL, escribe la dirección en la IAT y
+     * salta a ella. El nombre no distingue mayúsculas.
+     */
+    void addDelayLoad(const std::string& dllName);
+
     /**
      * @brief Realiza el proceso completo de linking
      */
@@ -242,6 +524,13 @@ public:
      */
     std::vector<std::string> getUndefinedSymbols() const;
 
+    /**
+     * @brief Símbolos sin resolver desmangled y ordenados, para informes y búsquedas
+     *
+     * El demangling se reparte entre setJobs() hilos.
+     */
+    mangling::SymbolIndex getUndefinedSymbolIndex() const;
+
     /**
      * @brief Obtiene estadísticas del proceso de linking
      */
@@ -257,7 +546,7 @@ private:
     std::vector<ObjectFileInfo> objectFiles_;
 
     // Símbolos globales
-    std::unordered_map<std::string, SymbolInfo> globalSymbols_;
+    GlobalSymbolTable globalSymbols_;
 
     // Secciones combinadas
     std::vector<SectionInfo> combinedSections_;
@@ -265,12 +554,32 @@ private:
     // Imports
     std::vector<ImportInfo> imports_;
 
+    // Bibliotecas con índice de símbolos y lo que resuelven sus miembros de importación
+    std::vector<LibraryInfo> libraries_;
+    std::unordered_set<std::string_view> importedSymbols_;
+    std::unordered_set<std::string> delayLoads_;       // En minúsculas
+
+    // Entrada del directorio de datos del header PE: símbolo de su inicio y tamaño
+    struct DataDirectory {
+        std::string symbol;
+        uint32_t size = 0;
+    };
+    std::array<DataDirectory, 16> dataDirectories_;
+
     // Configuración
     std::string entryPoint_;
     std::string subsystem_;
     std::string machineType_;
     uint64_t imageBase_;
     bool optimize_;
+    size_t jobs_ = 1;
+    bool incremental_ = false;
+    int ltoOptimizationLevel_ = 2;
+    std::shared_ptr<const ir::ProfileData> profile_;
+    std::shared_ptr<MachineCodeCache> codeCache_;
+    CPUFeatures targetFeatures_;
+    Microarchitecture tune_ = Microarchitecture::Generic;
+    std::vector<std::string> functionOrder_;
     uint32_t sectionAlignment_;
     uint32_t fileAlignment_;
 
@@ -278,19 +587,108 @@ private:
     size_t totalSymbols_;
     size_t resolvedSymbols_;
     size_t totalRelocations_;
+    size_t discardedSections_ = 0;
+    size_t loadedMembers_ = 0;
+    size_t patchedContributions_ = 0;
+    size_t foldedSections_ = 0;
+    size_t ltoModules_ = 0;
+    size_t ltoPartitions_ = 0;
+    size_t ltoCachedFunctions_ = 0;
+    size_t importedDlls_ = 0;
+    size_t delayLoadedDlls_ = 0;
+    size_t checksumOffset_ = 0;     // Offset del campo CheckSum dentro de createPEHeader()
 
     /**
      * @brief Parsea un archivo objeto COFF
      */
     bool parseObjectFile(ObjectFileInfo& objInfo);
 
+    /**
+     * @brief Añade en orden los objetos analizados; los vacíos no se pudieron leer
+     * @return false si falta alguno
+     */
+    bool appendParsedObjects(std::vector<std::optional<ObjectFileInfo>>& parsed);
+
+    /**
+     * @brief Optimiza juntos los módulos de IR de los objetos de -flto
+     *
+     * Si algún objeto trae la sección de IR, los módulos se fusionan, se
+     * optimizan como un programa entero y el código de cada partición se
+     * añade como un objeto más, antes de resolver símbolos.
+     * @return false si algún IR no es válido o hay definiciones repetidas
+     */
+    bool runLinkTimeOptimization(std::string& error);
+
     /**
      * @brief Parsea un archivo de biblioteca
+     *
+     * Si es un archivo "!<arch>" solo se lee su índice de símbolos; si no,
+     * se toma como nombre de una DLL a importar.
      */
     bool parseLibraryFile(const std::filesystem::path& libraryFile);
 
+    /**
+     * @brief Carga los miembros de biblioteca que definen símbolos pendientes
+     *
+     * Cada símbolo sin definir se busca en el índice de las bibliotecas,
+     * en orden; un miembro objeto se añade a objectFiles_ y uno de
+     * importación a imports_. Como lo cargado puede necesitar más
+     * símbolos, se repite hasta que ninguna vuelta cargue nada.
+     */
+    void loadLibraryMembers();
+
+    /**
+     * @brief Añade un objeto con las tablas de importación de imports_
+     *
+     * Las DLL normales van en .idata (descriptores, ILT, IAT y nombres) y
+     * las de /DELAYLOAD en .didat, con un thunk de carga por función y uno
+     * de mezcla por DLL en .text. Cada DLL tiene su IAT contigua; DLL y
+     * funciones siguen el orden de la primera relocación que las usa, así
+     * que las entradas que se usan al arrancar comparten páginas. Define
+     * __imp_f en la IAT y, si se llama a f directamente, f como un JMP a
+     * través de ella.
+     * @param delayLoaded Las DLL de /DELAYLOAD o las demás: las primeras
+     *        se añaden antes, porque __delayLoadHelper2 trae sus propias
+     *        importaciones de biblioteca
+     */
+    void synthesizeImports(bool delayLoaded);
+
+    /**
+     * @brief Se queda con una copia de cada COMDAT y descarta el resto
+     *
+     * Las asociativas siguen a la sección de la que dependen.
+     * @param duplicate Símbolo definido varias veces sin permitirlo
+     * @return false si un COMDAT NODUPLICATES (o de tamaño/contenido
+     *         obligado) aparece más de una vez con otro valor
+     */
+    bool foldComdatSections(std::string& duplicate);
+
+    /**
+     * @brief Descarta las secciones COMDAT inalcanzables (/OPT:REF)
+     *
+     * Raíces: las secciones que no son COMDAT y la del punto de entrada;
+     * se sigue cada relocación hasta su sección destino, y una sección
+     * viva mantiene vivas sus asociativas (.pdata/.xdata).
+     */
+    void removeUnreferencedSections();
+
+    /**
+     * @brief Pliega las funciones y los datos de solo lectura COMDAT idénticos (/OPT:ICF)
+     *
+     * Dos secciones de código o de .rdata son idénticas si tienen los mismos bytes,
+     * características, asociativas (.pdata/.xdata) y relocations contra
+     * los mismos destinos; al plegar una función sus llamadores pueden
+     * pasar a ser idénticos, así que se repite hasta que nada cambia. Las
+     * firmas se calculan en paralelo. Los símbolos de la copia descartada
+     * pasan a la que se queda.
+     */
+    void foldIdenticalSections();
+
     /**
      * @brief Construye la tabla de símbolos global
+     *
+     * Cada objeto inserta sus externos en paralelo; las definiciones
+     * repetidas quedan contadas para resolveSymbolConflicts.
      */
     void buildGlobalSymbolTable();
 
@@ -305,9 +703,51 @@ private:
     void combineSections();
 
     /**
-     * @brief Aplica relocations
+     * @brief Conserva el layout del enlace anterior (modo incremental)
+     *
+     * Cada sección enlazada vuelve a su sitio; falla si cambió el
+     * conjunto de objetos o secciones, o si algo ya no cabe en su hueco.
+     * @param changedObjects Objetos modificados desde ese enlace
+     */
+    bool reusePreviousLayout(const IncrementalDatabase& previous, const std::filesystem::path& outputFile,
+                             std::vector<bool>& changedObjects);
+
+    /**
+     * @brief Fijado el sitio de cada sección de entrada: relocations de cada trozo
+     *        y símbolos definidos relativos a su sección combinada
+     */
+    void attachContributions();
+
+    /**
+     * @brief Layout actual para el siguiente enlace incremental
+     */
+    IncrementalDatabase captureLayout(const std::filesystem::path& outputFile) const;
+
+    /**
+     * @brief Offset en el archivo de los datos de cada sección combinada
+     */
+    std::vector<size_t> rawSectionOffsets(size_t headersSize) const;
+
+    /**
+     * @brief Tamaño del archivo PE: cabeceras, secciones y lo que va detrás
+     */
+    size_t imageFileSize(size_t headersSize, size_t trailerSize) const;
+
+    /**
+     * @brief Escribe un trozo (relleno, bytes y relocations) en una ventana de su sección
+     * @param window Bytes de la sección combinada a partir de windowOffset
+     */
+    bool writeContribution(const SectionInfo& section, size_t index, std::span<uint8_t> window,
+                           uint32_t windowOffset) const;
+
+    /**
+     * @brief Copia cada sección de entrada a su sitio en la imagen y aplica sus relocations
+     *
+     * Las secciones de entrada no se solapan en la salida, así que cada
+     * una (copia, relleno previo y relocations) es una tarea independiente.
+     * @param rawOffsets Offset en image de los datos de cada sección combinada
      */
-    bool applyRelocations();
+    bool writeSections(uint8_t* image, const std::vector<size_t>& rawOffsets);
 
     /**
      * @brief Asigna direcciones virtuales
@@ -326,6 +766,10 @@ private:
 
     /**
      * @brief Crea el directorio de imports
+     *
+     * Las tablas ya están en .idata y .didat (synthesizeImports) y el
+     * header PE las señala en su directorio de datos: aquí no queda nada
+     * que añadir tras las secciones.
      */
     std::vector<uint8_t> createImportDirectory();
 
@@ -336,11 +780,20 @@ private:
 
     /**
      * @brief Crea la tabla de relocations base
+     *
+     * Un bloque por página con las direcciones absolutas (ADDR64, ADDR32)
+     * que el loader corrige si la imagen no se carga en imageBase_. Cada
+     * sección empieza en su propia página, así que sus bloques se generan
+     * en paralelo y se concatenan por RVA.
      */
     std::vector<uint8_t> createBaseRelocations();
 
     /**
      * @brief Escribe el archivo PE final
+     *
+     * El archivo se proyecta con su tamaño final; cada sección se copia
+     * directamente desde los objetos proyectados y las relocations se
+     * aplican ya sobre la salida (writeSections).
      */
     bool writePEFile(const std::filesystem::path& outputFile,
                     const std::vector<uint8_t>& peHeader,
@@ -349,6 +802,21 @@ private:
                     const std::vector<uint8_t>& exportDirectory,
                     const std::vector<uint8_t>& baseRelocations);
 
+    /**
+     * @brief Reescribe en el ejecutable existente solo lo que ha cambiado
+     *
+     * Cabeceras y tabla de secciones, los trozos de changedObjects y los
+     * que tienen relocations contra símbolos cuya dirección ya no es la
+     * de previous; las relocations base (del mismo tamaño) y el checksum
+     * se rehacen siempre.
+     */
+    bool patchPEFile(const std::filesystem::path& outputFile,
+                     const std::vector<uint8_t>& peHeader,
+                     const std::vector<uint8_t>& sectionTable,
+                     const std::vector<uint8_t>& baseRelocations,
+                     const IncrementalDatabase& previous,
+                     const std::vector<bool>& changedObjects);
+
     /**
      * @brief Verifica compatibilidad de archivos objeto
      */
@@ -371,13 +839,18 @@ private:
 
     /**
      * @brief Calcula checksum del PE
+     *
+     * Suma de palabras de 16 bits con acarreo circular más el tamaño del
+     * archivo; el campo CheckSum (en checksumOffset) cuenta como cero. La
+     * suma es asociativa: la imagen se reparte en trozos que se suman en
+     * paralelo (SSE2 si está disponible) y se pliegan al final.
      */
-    uint32_t calculatePEChecksum(const std::vector<uint8_t>& data) const;
+    uint32_t calculatePEChecksum(std::span<const uint8_t> image, size_t checksumOffset) const;
 
     /**
      * @brief Obtiene RVA de un símbolo
      */
-    uint32_t getSymbolRVA(const std::string& symbolName) const;
+    uint32_t getSymbolRVA(std::string_view symbolName) const;
 
     /**
      * @brief Verifica si un símbolo es definido externamente
@@ -402,6 +875,10 @@ private:
 
 /**
  * @brief Lector de archivos objeto COFF
+ *
+ * Proyecta cada objeto en memoria y lo analiza en el sitio: cabeceras,
+ * relocations y símbolos se leen por offset, y los datos de las
+ * secciones quedan como vistas sobre la proyección.
  */
 class COFFReader {
 public:
@@ -411,6 +888,13 @@ public:
     static bool readObjectFile(const std::filesystem::path& filePath,
                               ObjectFileInfo& objInfo);
 
+    /**
+     * @brief Analiza un objeto COFF ya proyectado (un archivo o un miembro de biblioteca)
+     * @param mapping Dueño de los bytes de data (proyección o imagen); objInfo lo conserva
+     */
+    static bool readObject(std::shared_ptr<const void> mapping,
+                           std::span<const uint8_t> data, ObjectFileInfo& objInfo);
+
     /**
      * @brief Valida formato COFF
      */
@@ -419,52 +903,82 @@ public:
     /**
      * @brief Extrae símbolos de un archivo COFF
      */
-    static std::vector<SymbolInfo> extractSymbols(const std::vector<uint8_t>& data,
+    static std::vector<SymbolInfo> extractSymbols(std::span<const uint8_t> data,
                                                  const COFFHeader& header);
 
     /**
      * @brief Extrae secciones de un archivo COFF
      */
-    static std::vector<SectionInfo> extractSections(const std::vector<uint8_t>& data,
+    static std::vector<SectionInfo> extractSections(std::span<const uint8_t> data,
                                                    const COFFHeader& header);
 
     /**
      * @brief Extrae relocations de una sección
      */
-    static std::vector<RelocationInfo> extractRelocations(const std::vector<uint8_t>& data,
+    static std::vector<RelocationInfo> extractRelocations(std::span<const uint8_t> data,
                                                          const SectionHeader& section,
                                                          uint32_t symbolCount);
 
 private:
     /**
-     * @brief Lee el header COFF
+     * @brief Nombre del símbolo index (corto o en la tabla de cadenas)
+     *
+     * Es una vista sobre data, así que vive lo que la proyección.
      */
-    static bool readCOFFHeader(std::ifstream& file, COFFHeader& header);
+    static std::string_view symbolName(std::span<const uint8_t> data, const COFFHeader& header,
+                                       uint32_t index);
 
     /**
-     * @brief Lee headers de sección
+     * @brief Comprueba la firma al inicio de los datos (máquina AMD64/i386, ANON o PE)
      */
-    static bool readSectionHeaders(std::ifstream& file, const COFFHeader& coffHeader,
-                                  std::vector<SectionHeader>& sectionHeaders);
+    static bool isCOFFObject(std::span<const uint8_t> data);
+};
 
+/**
+ * @brief Lector de bibliotecas COFF (.lib, formato "!<arch>")
+ *
+ * Trabaja sobre la proyección: el índice se lee del segundo miembro
+ * enlazador (ordenado, little-endian) o, si falta, del primero
+ * (big-endian), y los miembros se localizan por offset sin recorrer
+ * el archivo.
+ */
+class ArchiveReader {
+public:
     /**
-     * @brief Lee tabla de símbolos
+     * @brief Comprueba la firma "!<arch>\n"
      */
-    static bool readSymbolTable(std::ifstream& file, const COFFHeader& coffHeader,
-                               std::vector<COFFSymbol>& symbols,
-                               std::vector<std::string>& stringTable);
+    static bool isArchive(std::span<const uint8_t> data);
 
     /**
-     * @brief Lee datos de sección
+     * @brief Lee el índice de símbolos, ordenado por nombre
+     * @return false si no es una biblioteca o no tiene índice
      */
-    static bool readSectionData(std::ifstream& file, const SectionHeader& section,
-                               std::vector<uint8_t>& data);
+    static bool readSymbolIndex(std::span<const uint8_t> data, std::vector<ArchiveSymbol>& index);
 
     /**
-     * @brief Lee relocations de sección
+     * @brief Contenido del miembro cuya cabecera empieza en offset (vacío si no es válido)
+     */
+    static std::span<const uint8_t> memberAt(std::span<const uint8_t> data, uint32_t offset);
+
+    /**
+     * @brief Recorre todos los miembros en orden de archivo, sin copiarlos
+     * @return false si no es una biblioteca o alguna cabecera está truncada
+     */
+    static bool readMembers(std::span<const uint8_t> data, std::vector<ArchiveMember>& members);
+
+    /**
+     * @brief Lee un miembro de importación corto (IMPORT_OBJECT_HEADER)
+     * @return false si el miembro es un objeto COFF normal
+     */
+    static bool readImportObject(std::span<const uint8_t> member, std::string_view& symbol,
+                                 std::string_view& dllName, uint16_t& hint);
+
+private:
+    /**
+     * @brief Lee la cabecera de miembro en offset: nombre sin relleno y contenido
      */
-    static bool readSectionRelocations(std::ifstream& file, const SectionHeader& section,
-                                      std::vector<RelocationInfo>& relocations);
+    static bool readMemberHeader(std::span<const uint8_t> data, size_t offset,
+                                 std::string_view& name, std::span<const uint8_t>& contents);
 };
 
 /**
@@ -528,33 +1042,33 @@ public:
     /**
      * @brief Resuelve un símbolo en la tabla global
      */
-    static bool resolveSymbol(const std::string& symbolName,
-                             const std::unordered_map<std::string, SymbolInfo>& globalSymbols,
+    static bool resolveSymbol(std::string_view symbolName,
+                             const GlobalSymbolTable& globalSymbols,
                              uint32_t& resolvedAddress);
 
     /**
      * @brief Encuentra símbolos sin resolver
      */
     static std::vector<std::string> findUndefinedSymbols(
-        const std::unordered_map<std::string, SymbolInfo>& globalSymbols);
+        const GlobalSymbolTable& globalSymbols);
 
     /**
      * @brief Verifica conflictos de símbolos
      */
     static std::vector<std::string> findSymbolConflicts(
-        const std::unordered_map<std::string, SymbolInfo>& globalSymbols);
+        const GlobalSymbolTable& globalSymbols);
 
     /**
      * @brief Resuelve símbolos débiles
      */
     static void resolveWeakSymbols(
-        std::unordered_map<std::string, SymbolInfo>& globalSymbols);
+        GlobalSymbolTable& globalSymbols);
 
     /**
      * @brief Obtiene símbolos exportados
      */
     static std::vector<std::string> getExportedSymbols(
-        const std::unordered_map<std::string, SymbolInfo>& globalSymbols);
+        const GlobalSymbolTable& globalSymbols);
 
     /**
      * @brief Verifica si un símbolo es válido para linking
@@ -576,7 +1090,7 @@ public:
     /**
      * @brief Aplica una relocation a los datos de sección
      */
-    static bool applyRelocation(std::vector<uint8_t>& sectionData,
+    static bool applyRelocation(std::span<uint8_t> sectionData,
                                const RelocationInfo& relocation,
                                uint32_t symbolAddress,
                                uint32_t sectionRVA);
@@ -584,10 +1098,11 @@ public:
     /**
      * @brief Aplica todas las relocations de una sección
      */
-    static bool applySectionRelocations(std::vector<uint8_t>& sectionData,
+    static bool applySectionRelocations(std::span<uint8_t> sectionData,
                                        const std::vector<RelocationInfo>& relocations,
-                                       const std::unordered_map<std::string, SymbolInfo>& globalSymbols,
-                                       const std::vector<SectionInfo>& sections);
+                                       const GlobalSymbolTable& globalSymbols,
+                                       const std::vector<SectionInfo>& sections,
+                                       uint32_t sectionRVA);
 
     /**
      * @brief Verifica que una relocation sea válida
@@ -615,21 +1130,21 @@ private:
     /**
      * @brief Aplica relocation IMAGE_REL_AMD64_ADDR32
      */
-    static bool applyAddr32Relocation(std::vector<uint8_t>& data,
+    static bool applyAddr32Relocation(std::span<uint8_t> data,
                                      size_t offset,
                                      uint32_t value);
 
     /**
      * @brief Aplica relocation IMAGE_REL_AMD64_ADDR64
      */
-    static bool applyAddr64Relocation(std::vector<uint8_t>& data,
+    static bool applyAddr64Relocation(std::span<uint8_t> data,
                                      size_t offset,
                                      uint64_t value);
 
     /**
      * @brief Aplica relocation IMAGE_REL_AMD64_REL32
      */
-    static bool applyRel32Relocation(std::vector<uint8_t>& data,
+    static bool applyRel32Relocation(std::span<uint8_t> data,
                                     size_t offset,
                                     uint32_t value,
                                     uint32_t currentRVA);
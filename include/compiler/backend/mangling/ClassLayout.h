@@ -9,6 +9,8 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace cpp20::compiler::backend::mangling {
 
@@ -39,9 +41,12 @@ struct VirtualFunctionInfo {
     int vtableIndex;            // Índice en vtable
     bool isPureVirtual;         // Es pura virtual
     bool isOverride;            // Es override
+    bool isInline;              // Definida en la clase o declarada inline
+    bool isDefined;             // Definida en esta unidad de traducción
 
-    VirtualFunctionInfo(const std::string& n, const std::string& sig, int idx)
-        : name(n), signature(sig), vtableIndex(idx), isPureVirtual(false), isOverride(false) {}
+    VirtualFunctionInfo(const std::string& n, const std::string& sig, int idx, bool pure = false)
+        : name(n), signature(sig), vtableIndex(idx), isPureVirtual(pure), isOverride(false),
+          isInline(false), isDefined(false) {}
 };
 
 /**
@@ -57,8 +62,49 @@ struct InheritanceInfo {
         : baseClass(base), offset(off), isVirtual(virt), isPrimary(primary) {}
 };
 
+/**
+ * @brief Hueco de relleno entre dos miembros o al final del objeto
+ */
+struct PaddingHole {
+    std::string afterMember;    // Miembro que precede al hueco
+    size_t offset;              // Primer byte de relleno
+    size_t bytes;               // Bytes de relleno
+};
+
+/**
+ * @brief Relleno de una clase y el orden de miembros que lo reduce (-Wpadded)
+ */
+struct PaddingReport {
+    std::string className;
+    size_t size = 0;                            // sizeof actual
+    size_t paddingBytes = 0;                    // Suma de los huecos
+    std::vector<PaddingHole> holes;
+    std::vector<std::string> suggestedOrder;    // Vacío si no hay orden mejor
+    size_t suggestedSize = 0;                   // sizeof con suggestedOrder
+    size_t cacheLines = 0;                      // Líneas de 64 bytes que ocupa una instancia
+    size_t suggestedCacheLines = 0;
+
+    /**
+     * @brief Bytes que se ahorran por instancia con el orden sugerido
+     */
+    size_t bytesSaved() const { return size - suggestedSize; }
+
+    /**
+     * @brief Aviso legible, una línea por hueco y otra con la sugerencia
+     */
+    std::string format() const;
+};
+
+class ClassLayoutCache;
+
 /**
  * @brief Layout completo de una clase compatible con MSVC
+ *
+ * El vptr (si hay funciones virtuales) va al principio, seguido de las
+ * bases no virtuales y de los miembros en orden de declaración, cada uno
+ * alineado a su tipo. Un layout creado por un ClassLayoutCache resuelve
+ * el tamaño de los miembros y bases de tipo clase con los layouts de esa
+ * caché; sin caché se suponen de 8 bytes.
  */
 class ClassLayout {
 public:
@@ -142,12 +188,30 @@ public:
      */
     std::string getClassName() const { return className_; }
 
+    /**
+     * @brief Nombre con su ámbito (ns::Clase), la clave en ClassLayoutCache
+     */
+    std::string getQualifiedName() const;
+
     /**
      * @brief Verifica compatibilidad con MSVC
      */
     bool isMSVCCompatible() const;
 
+    /**
+     * @brief Huecos de relleno y orden de miembros que los reduce
+     *
+     * El orden sugerido agrupa los miembros por alineación decreciente
+     * (a igual alineación, los más grandes primero), lo que elimina los
+     * huecos interiores cuando los tamaños son múltiplos de la alineación.
+     * Sin sugerencia si hay bit fields o si el orden no ahorra nada.
+     * Requiere computeLayout().
+     */
+    PaddingReport analyzePadding() const;
+
 private:
+    friend class ClassLayoutCache;
+
     std::string className_;                 // Nombre de la clase
     std::string scope_;                     // Ámbito
     std::vector<MemberInfo> dataMembers_;   // Miembros de datos
@@ -157,19 +221,23 @@ private:
     size_t totalSize_;                      // Tamaño total calculado
     size_t alignment_;                      // Alineación calculada
     size_t vtableOffset_;                   // Offset del puntero vtable
+    size_t dataStart_;                      // Primer byte tras vptr y bases
     bool layoutComputed_;                   // Si el layout ya fue calculado
+    ClassLayoutCache* cache_;               // Layouts de los tipos clase, si los hay
 
     MSVCNameMangler nameMangler_;           // Mangler para nombres
 
     /**
-     * @brief Calcula offsets para miembros de datos
+     * @brief Calcula offsets para miembros de datos a partir de offset
+     * @return Primer byte tras el último miembro
      */
-    void computeDataMemberOffsets();
+    size_t computeDataMemberOffsets(size_t offset);
 
     /**
-     * @brief Calcula layout para herencia
+     * @brief Calcula layout para herencia a partir de offset
+     * @return Primer byte tras la última base
      */
-    void computeInheritanceLayout();
+    size_t computeInheritanceLayout(size_t offset);
 
     /**
      * @brief Calcula posiciones de funciones virtuales
@@ -177,9 +245,9 @@ private:
     void computeVirtualFunctionLayout();
 
     /**
-     * @brief Calcula el tamaño total y alineación
+     * @brief Calcula el tamaño total (end alineado) y la alineación
      */
-    void computeSizeAndAlignment();
+    void computeSizeAndAlignment(size_t end);
 
     /**
      * @brief Obtiene el tamaño de un tipo
@@ -191,6 +259,11 @@ private:
      */
     size_t getTypeAlignment(const std::string& typeName) const;
 
+    /**
+     * @brief Layout de la caché para un tipo clase, o nullptr
+     */
+    const ClassLayout* classLayoutOf(const std::string& typeName) const;
+
     /**
      * @brief Alinea un offset al siguiente límite
      */
@@ -202,6 +275,63 @@ private:
     bool validateMSVCRules() const;
 };
 
+/**
+ * @brief Layouts calculados una vez por clase
+ *
+ * La clave es el nombre cualificado (ns::Clase), que en el backend
+ * identifica el tipo canónico: VTableGenerator, el mangling y codegen
+ * piden el layout aquí en vez de recalcularlo. Una clase debe estar
+ * completa (todos sus miembros declarados) antes de pedir su layout o el
+ * de una clase que la contenga, como en C++. No es thread-safe: una caché
+ * por unidad de traducción, igual que types::TypeContext.
+ *
+ * Con setPaddingAnalysis() activo (la opción -Wpadded) cada layout que se
+ * calcula con relleno por encima del umbral deja un PaddingReport.
+ */
+class ClassLayoutCache {
+public:
+    /**
+     * @brief Layout de className para rellenar; el mismo si ya se declaró
+     */
+    ClassLayout& declareClass(const std::string& className, const std::string& scope = "");
+
+    /**
+     * @brief Layout calculado de la clase, o nullptr si no se declaró
+     *
+     * Solo la primera petición calcula el layout; también devuelve nullptr
+     * si la clase se contiene a sí misma (dependencia circular).
+     */
+    const ClassLayout* getLayout(const std::string& qualifiedName);
+
+    /**
+     * @brief Activa el análisis de relleno
+     * @param minimumPercent Solo se informa de clases con al menos este % de relleno
+     */
+    void setPaddingAnalysis(bool enabled, size_t minimumPercent = 0);
+
+    /**
+     * @brief Informes de relleno de los layouts calculados, en orden de cálculo
+     */
+    const std::vector<PaddingReport>& paddingReports() const { return paddingReports_; }
+
+    /**
+     * @brief Layouts calculados y peticiones servidas sin calcular
+     */
+    size_t computedLayouts() const { return computed_; }
+    size_t cacheHits() const { return hits_; }
+
+    size_t size() const { return layouts_.size(); }
+
+private:
+    std::unordered_map<std::string, std::unique_ptr<ClassLayout>> layouts_;
+    std::unordered_set<std::string> computing_;     // Para cortar ciclos
+    std::vector<PaddingReport> paddingReports_;
+    bool paddingAnalysis_ = false;
+    size_t minimumPaddingPercent_ = 0;
+    size_t computed_ = 0;
+    size_t hits_ = 0;
+};
+
 /**
  * @brief Generador de layouts de clase
  */
@@ -0,0 +1,120 @@
+/**
+ * @file MSVCDemangler.h
+ * @brief Demangler de los nombres de MSVCNameMangler e índice de símbolos
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cpp20::compiler::backend::mangling {
+
+/**
+ * @brief Inverso de MSVCNameMangler
+ *
+ * Reconoce la gramática que produce el mangler (funciones, variables,
+ * clases, vtables y type_info), no la de MSVC completa. El resultado se
+ * añade a un buffer del llamador y las back-references de parámetros se
+ * guardan como posiciones en ese buffer: al reutilizar el buffer entre
+ * símbolos no se reserva memoria por nombre. Sin estado: seguro entre hilos.
+ *
+ * La gramática del mangler es ambigua cuando el calificador de un método
+ * coincide con un código de tipo (D es char y const volatile); se prefiere
+ * la lectura sin calificador.
+ */
+class MSVCDemangler {
+public:
+    /**
+     * @brief Añade a out la forma legible de mangled
+     * @return false si mangled no es un nombre del mangler; out queda intacto
+     */
+    static bool demangle(std::string_view mangled, std::string& out);
+
+    /**
+     * @brief Forma legible de mangled, o mangled tal cual si no lo es
+     */
+    static std::string demangle(std::string_view mangled);
+};
+
+/**
+ * @brief Tabla de símbolos ordenada por nombre desmangled
+ *
+ * Pensada para objetos y bibliotecas con cientos de miles de símbolos: el
+ * demangling se reparte por bloques entre hilos, cada bloque se ordena en
+ * su hilo y los bloques se mezclan. Los nombres desmangled viven en un
+ * único buffer contiguo.
+ */
+class SymbolIndex {
+public:
+    /**
+     * @brief Un símbolo del índice; las vistas viven lo que el índice
+     */
+    struct Symbol {
+        std::string_view mangled;
+        std::string_view demangled;     // Igual a mangled si no se pudo desmanglear
+        uint32_t ordinal;               // Posición en la tabla original
+    };
+
+    SymbolIndex() = default;
+    SymbolIndex(SymbolIndex&&) = default;
+    SymbolIndex& operator=(SymbolIndex&&) = default;
+    SymbolIndex(const SymbolIndex&) = delete;
+    SymbolIndex& operator=(const SymbolIndex&) = delete;
+
+    /**
+     * @brief Desmanglea y ordena names
+     * @param jobs Hilos a usar (0 = ThreadPool::defaultThreadCount())
+     */
+    static SymbolIndex build(std::vector<std::string> names, size_t jobs = 0);
+
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+
+    /**
+     * @brief i-ésimo símbolo en orden de nombre desmangled
+     */
+    Symbol operator[](size_t i) const { return symbolAt(entries_[i]); }
+
+    /**
+     * @brief Nombre desmangled del símbolo en la posición ordinal de la tabla original
+     */
+    std::string_view demangledByOrdinal(uint32_t ordinal) const;
+
+    /**
+     * @brief Rango [first, last) de símbolos cuyo nombre desmangled empieza por prefix
+     */
+    std::pair<size_t, size_t> findPrefix(std::string_view prefix) const;
+
+    /**
+     * @brief Posición del símbolo con ese nombre mangled, o size() si no está
+     */
+    size_t findMangled(std::string_view mangled) const;
+
+private:
+    struct Entry {
+        uint32_t ordinal;
+        uint32_t offset;        // En text_
+        uint32_t length;
+    };
+
+    std::vector<std::string> names_;
+    std::string text_;
+    std::vector<Entry> entries_;            // Ordenadas por nombre desmangled
+    std::vector<uint32_t> byOrdinal_;       // Ordinal -> posición en entries_
+    std::vector<uint32_t> byMangled_;       // Posiciones en entries_ ordenadas por nombre mangled
+
+    std::string_view demangledOf(const Entry& entry) const {
+        return std::string_view(text_).substr(entry.offset, entry.length);
+    }
+
+    Symbol symbolAt(const Entry& entry) const {
+        return {names_[entry.ordinal], demangledOf(entry), entry.ordinal};
+    }
+};
+
+} // namespace cpp20::compiler::backend::mangling
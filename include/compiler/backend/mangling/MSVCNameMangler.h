@@ -5,7 +5,10 @@
 
 #pragma once
 
+#include <array>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <memory>
 
@@ -90,6 +93,13 @@ struct ClassInfo {
  *
  * Implementa el algoritmo completo de name decoration de Microsoft Visual C++.
  * Soporta funciones, variables, clases y templates.
+ *
+ * Los fragmentos de tipo y de ámbito se guardan por su nombre la primera
+ * vez que se manglean, y los nombres se construyen en un buffer que se
+ * reutiliza entre llamadas. En una lista de parámetros, un tipo de más de
+ * un carácter que se repite se sustituye por su back-reference (0-9),
+ * como en MSVC. Por la caché, un mangler no es seguro entre hilos: cada
+ * hilo usa el suyo.
  */
 class MSVCNameMangler {
 public:
@@ -187,7 +197,41 @@ public:
      */
     std::string mangleName(const std::string& name) const;
 
+    /**
+     * @brief Vacía la caché de fragmentos
+     */
+    void clearCache();
+
 private:
+    /**
+     * @brief Tipos de parámetro ya vistos en la lista actual (máximo 10, como MSVC)
+     */
+    struct ParameterBackReferences {
+        std::array<const std::string*, 10> types{};
+        size_t count = 0;
+    };
+
+    std::unordered_map<std::string, std::string> typeCache_;
+    std::unordered_map<std::string, std::string> scopeCache_;
+    std::string buffer_;
+
+    /**
+     * @brief Fragmento de un tipo, calculado una vez por nombre
+     */
+    const std::string& cachedType(const std::string& typeName);
+
+    const std::string& cachedScope(const std::string& scope);
+
+    void appendParameterList(std::string& out, const std::vector<std::string>& paramTypes);
+    void appendBaseName(std::string& out, std::string_view name) const;
+    void appendScope(std::string& out, std::string_view scope) const;
+    void appendLength(std::string& out, size_t length) const;
+
+    /**
+     * @brief Codifica un número con el esquema de MSVC (dimensiones de arrays)
+     */
+    void appendNumber(std::string& out, size_t value) const;
+
     /**
      * @brief Códigos base para tipos básicos MSVC
      */
@@ -259,9 +303,9 @@ private:
 class MangledNameUtils {
 public:
     /**
-     * @brief Desmanglea un nombre (simplificado)
+     * @brief Desmanglea un nombre con MSVCDemangler
      * @param mangled Nombre mangled
-     * @return Nombre desmangled aproximado
+     * @return Nombre desmangled, o mangled si no es un nombre del mangler
      */
     static std::string demangle(const std::string& mangled);
 
@@ -6,9 +6,11 @@
 #pragma once
 
 #include <compiler/backend/mangling/ClassLayout.h>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <memory>
+#include <unordered_set>
 
 namespace cpp20::compiler::backend::mangling {
 
@@ -43,8 +45,33 @@ struct RTTIInfo {
           hasVirtualDestructor(false), typeInfoOffset(0) {}
 };
 
+/**
+ * @brief Dónde se emite una vtable o un type_info en esta unidad de traducción
+ */
+enum class VTableLinkage : uint8_t {
+    None,       // Lo emite otra unidad (o no hace falta)
+    Strong,     // Definición única: esta unidad define la función clave
+    Comdat      // Sección COMDAT: el enlazador conserva una copia
+};
+
+/**
+ * @brief Uso que necesita el type_info de una clase
+ */
+enum class RTTIUse : uint8_t {
+    TypeId,
+    DynamicCast,
+    Exception   // throw o catch del tipo; necesita type_info incluso con -fno-rtti
+};
+
 /**
  * @brief Generador de VTables compatible con MSVC
+ *
+ * Para no repetir la vtable de una clase en cada unidad que ve su
+ * definición se sigue la regla de la función clave: la primera función
+ * virtual no pura ni inline. Solo la unidad que la define emite la vtable;
+ * sin función clave, todas la emiten como COMDAT. El RTTI de una clase
+ * polimórfica viaja con su vtable (la vtable lo referencia); el de las
+ * demás clases solo se emite si la unidad registra un uso con requireRTTI().
  */
 class VTableGenerator {
 public:
@@ -86,6 +113,34 @@ public:
      */
     std::vector<uint8_t> generateRTTIData(const RTTIInfo& rttiInfo);
 
+    /**
+     * @brief Función clave de la clase (nullptr si no tiene)
+     */
+    static const VirtualFunctionInfo* keyFunction(const ClassLayout& layout);
+
+    /**
+     * @brief Si esta unidad emite la vtable de la clase y con qué enlace
+     */
+    static VTableLinkage vtableLinkage(const ClassLayout& layout);
+
+    /**
+     * @brief Activar o desactivar RTTI (-fno-rtti, /GR-)
+     */
+    void setRTTIEnabled(bool enabled) { rttiEnabled_ = enabled; }
+    bool isRTTIEnabled() const { return rttiEnabled_; }
+
+    /**
+     * @brief Registrar un uso del type_info de la clase en esta unidad
+     * @param qualifiedName Nombre con ámbito (ClassLayout::getQualifiedName())
+     * @return false si el uso no es posible: typeid o dynamic_cast sin RTTI
+     */
+    bool requireRTTI(const std::string& qualifiedName, RTTIUse use);
+
+    /**
+     * @brief Si esta unidad emite el type_info de la clase y con qué enlace
+     */
+    VTableLinkage rttiLinkage(const ClassLayout& layout) const;
+
     /**
      * @brief Calcula el tamaño de la vtable
      */
@@ -98,6 +153,8 @@ public:
 
 private:
     MSVCNameMangler nameMangler_;   // Para generar nombres mangled
+    bool rttiEnabled_ = true;
+    std::unordered_set<std::string> rttiUses_; // Clases con type_info pedido en esta unidad
 
     /**
      * @brief Genera entradas para funciones virtuales propias
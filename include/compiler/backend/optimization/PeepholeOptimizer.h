@@ -7,29 +7,48 @@
 
 #include <compiler/backend/codegen/InstructionSelector.h>
 #include <vector>
+#include <span>
 #include <unordered_map>
 #include <functional>
 
 namespace cpp20::compiler::backend {
 
+/**
+ * @brief Ventana de instrucciones consecutivas, sin copiar
+ */
+using PeepholeWindow = std::span<const X86Instruction>;
+
 /**
  * @brief Patrón de optimización de mirilla
+ *
+ * Cada instrucción del reemplazo toma los operandos de la instrucción de
+ * la ventana en la misma posición; rewrite puede ajustarlos después.
  */
 struct PeepholePattern {
     std::vector<X86Opcode> pattern;        // Secuencia de opcodes a buscar
     std::vector<X86Opcode> replacement;    // Secuencia de reemplazo
     std::string description;               // Descripción de la optimización
-    std::function<bool(const std::vector<X86Instruction>&)> condition; // Condición adicional
+    std::function<bool(PeepholeWindow)> condition; // Condición adicional
+    std::function<void(PeepholeWindow, std::span<X86Instruction>)> rewrite; // Ajuste del reemplazo
 
     PeepholePattern(const std::vector<X86Opcode>& p,
                    const std::vector<X86Opcode>& r,
                    const std::string& desc = "",
-                   std::function<bool(const std::vector<X86Instruction>&)> cond = nullptr)
-        : pattern(p), replacement(r), description(desc), condition(cond) {}
+                   std::function<bool(PeepholeWindow)> cond = nullptr,
+                   std::function<void(PeepholeWindow, std::span<X86Instruction>)> rw = nullptr)
+        : pattern(p), replacement(r), description(desc), condition(cond), rewrite(rw) {}
 };
 
 /**
  * @brief Optimizador de mirilla para instrucciones x86-64
+ *
+ * Los patrones se indexan por su primer opcode. optimize recorre la
+ * secuencia una vez compactándola en su propio vector: lo ya procesado
+ * queda al principio y solo se prueban las ventanas que terminan en la
+ * última instrucción aceptada. Un reemplazo vuelve a la entrada para
+ * revisarse junto a lo anterior, así que se llega al punto fijo sin
+ * pasadas completas. Las etiquetas de bloque (NOP con comentario)
+ * cortan las ventanas.
  */
 class PeepholeOptimizer {
 public:
@@ -46,7 +65,7 @@ public:
     /**
      * @brief Optimiza una secuencia de instrucciones
      */
-    std::vector<X86Instruction> optimize(const std::vector<X86Instruction>& instructions);
+    std::vector<X86Instruction> optimize(std::vector<X86Instruction> instructions);
 
     /**
      * @brief Añade un patrón de optimización personalizado
@@ -77,32 +96,30 @@ public:
 
 private:
     std::vector<PeepholePattern> patterns_;
+    std::unordered_map<X86Opcode, std::vector<size_t>> patternsByOpcode_; // Índices en patterns_
+    size_t maxPatternLength_ = 0;
     OptimizationStats stats_;
 
     /**
-     * @brief Inicializa patrones de optimización estándar
+     * @brief Registra un patrón en el índice por primer opcode
      */
-    void initializeStandardPatterns();
+    void indexPattern(size_t index);
 
     /**
-     * @brief Aplica optimizaciones en una ventana deslizante
+     * @brief Inicializa patrones de optimización estándar
      */
-    std::vector<X86Instruction> applyPeepholeOptimizations(
-        const std::vector<X86Instruction>& instructions,
-        size_t windowSize = 3);
+    void initializeStandardPatterns();
 
     /**
-     * @brief Verifica si una secuencia coincide con un patrón
+     * @brief Busca un patrón para las ventanas que terminan al final de done
+     * @return Índice en patterns_ y longitud de la ventana, o {patterns_.size(), 0}
      */
-    bool matchesPattern(const std::vector<X86Instruction>& window,
-                       const PeepholePattern& pattern) const;
+    std::pair<size_t, size_t> findMatch(std::span<const X86Instruction> done) const;
 
     /**
-     * @brief Aplica un patrón de reemplazo
+     * @brief Verifica si una secuencia coincide con un patrón
      */
-    std::vector<X86Instruction> applyPattern(
-        const std::vector<X86Instruction>& window,
-        const PeepholePattern& pattern) const;
+    bool matchesPattern(PeepholeWindow window, const PeepholePattern& pattern) const;
 
     /**
      * @brief Optimizaciones específicas
@@ -125,24 +142,11 @@ private:
     bool operandsEqual(const X86Operand& a, const X86Operand& b) const;
 
     /**
-     * @brief Verifica si una instrucción es un NOP efectivo
+     * @brief Verifica si una instrucción es un NOP que se puede borrar
+     *
+     * Las etiquetas de bloque son NOP con comentario y se conservan.
      */
     bool isEffectiveNop(const X86Instruction& inst) const;
-
-    /**
-     * @brief Elimina instrucciones NOP
-     */
-    std::vector<X86Instruction> removeNops(const std::vector<X86Instruction>& instructions);
-
-    /**
-     * @brief Fusiona instrucciones consecutivas cuando sea posible
-     */
-    std::vector<X86Instruction> fuseInstructions(const std::vector<X86Instruction>& instructions);
-
-    /**
-     * @brief Optimiza uso de registros
-     */
-    std::vector<X86Instruction> optimizeRegisterUsage(const std::vector<X86Instruction>& instructions);
 };
 
 /**
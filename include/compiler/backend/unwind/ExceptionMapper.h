@@ -70,8 +70,19 @@ public:
      */
     uint32_t generateExceptionHandler();
 
+    /**
+     * @brief RVA de inicio de la función: los offsets de la tabla son relativos a él
+     */
+    void setFunctionStart(uint32_t rva) { functionStart_ = rva; }
+
     /**
      * @brief Genera datos de exception data para la función
+     *
+     * Tabla compacta (FuncInfo): los tipos capturados o lanzados van una
+     * sola vez como RVA de 32 bits; regiones y throws se ordenan por
+     * dirección y se codifican en LEB128 como deltas y longitudes
+     * relativos al inicio de la función. Los catch pueden estar en la
+     * parte fría, detrás del código normal, sin ocupar más.
      * @return Vector de bytes con la información de excepciones
      */
     std::vector<uint8_t> generateExceptionData();
@@ -120,6 +131,7 @@ private:
     std::vector<TryCatchRegion> tryCatchRegions_;
     std::vector<ThrowSite> throwSites_;
     std::unique_ptr<WindowsExceptionHandler> windowsHandler_;
+    uint32_t functionStart_ = 0;
 };
 
 } // namespace cpp20::compiler::backend::unwind
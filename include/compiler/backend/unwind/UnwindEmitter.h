@@ -17,6 +17,11 @@ namespace cpp20::compiler::backend::unwind {
  *
  * Esta clase genera las secciones .pdata y .xdata necesarias para
  * el stack unwinding en Windows x64.
+ *
+ * Los UNWIND_INFO idénticos byte a byte (mismo prólogo, mismo marco) se
+ * emiten una sola vez en .xdata y todas sus RUNTIME_FUNCTION apuntan al
+ * mismo registro. La .pdata sale ordenada por dirección de inicio, como
+ * exige la búsqueda binaria de RtlLookupFunctionEntry.
  */
 class UnwindEmitter {
 public:
@@ -47,6 +52,19 @@ public:
         uint8_t frameReg = 0,
         bool hasExceptionHandler = false);
 
+    /**
+     * @brief Añade un fragmento separado de una función (p. ej. su parte fría)
+     *
+     * El fragmento no tiene prólogo propio: su UNWIND_INFO lleva
+     * UNW_FLAG_CHAININFO y la RUNTIME_FUNCTION de la función principal,
+     * así que el unwinder aplica los códigos de ella.
+     * @param fragmentRVA RVA de inicio del fragmento
+     * @param fragmentSize Tamaño del fragmento en bytes
+     * @param primaryRVA RVA de inicio de la función principal, ya añadida
+     * @return false si no hay ninguna función añadida que empiece en primaryRVA
+     */
+    bool addChainedUnwind(uint32_t fragmentRVA, uint32_t fragmentSize, uint32_t primaryRVA);
+
     /**
      * @brief Genera la sección .pdata (Runtime Functions)
      * @return Datos de la sección .pdata
@@ -75,10 +93,15 @@ public:
     uint32_t getPdataSize() const;
 
     /**
-     * @brief Obtiene el tamaño total de .xdata
+     * @brief Obtiene el tamaño total de .xdata, ya sin registros repetidos
      */
     uint32_t getXdataSize() const;
 
+    /**
+     * @brief Número de UNWIND_INFO distintos que se emiten en .xdata
+     */
+    size_t getUniqueUnwindInfoCount() const;
+
     /**
      * @brief Valida toda la información de unwind generada
      * @return true si todo es válido
@@ -96,6 +119,9 @@ private:
         std::vector<uint8_t> prologueBytes;
         uint32_t stackSize;
         bool hasExceptionHandler;
+        size_t chainedTo = NotChained;   // Índice de la función principal de un fragmento
+
+        static constexpr size_t NotChained = static_cast<size_t>(-1);
 
         FunctionUnwindInfo(uint32_t beginRVA, uint32_t endRVA,
                           const UnwindInfo& info,
@@ -112,13 +138,20 @@ private:
 
     /**
      * @brief Genera datos binarios para UNWIND_INFO
+     * @param primaryRVA RVA del UNWIND_INFO de la función principal (solo fragmentos)
+     */
+    std::vector<uint8_t> generateUnwindInfoData(const FunctionUnwindInfo& info, uint32_t primaryRVA) const;
+
+    /**
+     * @brief Serializa .xdata compartiendo los registros repetidos
+     * @param offsets Offset en .xdata del UNWIND_INFO de cada función
      */
-    std::vector<uint8_t> generateUnwindInfoData(const FunctionUnwindInfo& info);
+    std::vector<uint8_t> buildXdata(std::vector<uint32_t>& offsets) const;
 
     /**
-     * @brief Calcula RVA para UNWIND_INFO de una función
+     * @brief RVA de un offset de .xdata (0 si no hay RVA base)
      */
-    uint32_t calculateUnwindInfoRVA(size_t functionIndex) const;
+    uint32_t xdataRVA(uint32_t offset) const { return xdataBaseRVA_ == 0 ? 0 : xdataBaseRVA_ + offset; }
 
     /**
      * @brief Valida información de unwind para una función
@@ -128,7 +161,6 @@ private:
     // Miembros privados
     std::vector<std::unique_ptr<FunctionUnwindInfo>> functions_;
     uint32_t xdataBaseRVA_;
-    uint32_t currentXdataOffset_;
 };
 
 } // namespace cpp20::compiler::backend::unwind
@@ -0,0 +1,144 @@
+/**
+ * @file CacheBackend.h
+ * @brief Almacén secundario compartido para las cachés de plantillas y constexpr
+ */
+
+#pragma once
+
+#include <compiler/common/utils/ThreadPool.h>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+namespace cpp20::compiler {
+
+/**
+ * @brief Almacén clave/valor direccionado por contenido
+ *
+ * Las direcciones las calcula SecondaryCache y ya incluyen versión del
+ * compilador, opciones y huella de la clave, así que un valor escrito en
+ * una dirección nunca cambia. Las implementaciones deben poder usarse
+ * desde varios hilos a la vez. Un servicio remoto (HTTP u otro) encaja
+ * implementando estas dos operaciones.
+ */
+class CacheBackend {
+public:
+    virtual ~CacheBackend() = default;
+
+    /**
+     * @brief Lee el valor de una dirección
+     * @return nullopt si no existe o no se pudo leer
+     */
+    virtual std::optional<std::string> fetch(const std::string& address) = 0;
+
+    /**
+     * @brief Publica un valor; si la dirección ya existe no hace nada
+     */
+    virtual bool put(const std::string& address, std::string_view data) = 0;
+};
+
+/**
+ * @brief Backend sobre un directorio, local o compartido por NFS/SMB
+ *
+ * Cada dirección es un archivo root/<2 primeros caracteres>/<dirección>.
+ * Las escrituras van a un temporal que se renombra, así que varias
+ * máquinas pueden publicar la misma entrada sin que un lector vea un
+ * archivo a medias.
+ */
+class DirectoryCacheBackend : public CacheBackend {
+public:
+    explicit DirectoryCacheBackend(std::filesystem::path root);
+
+    std::optional<std::string> fetch(const std::string& address) override;
+    bool put(const std::string& address, std::string_view data) override;
+
+    const std::filesystem::path& root() const { return root_; }
+
+private:
+    std::filesystem::path root_;
+
+    std::filesystem::path pathFor(const std::string& address) const;
+};
+
+/**
+ * @brief Canal asíncrono entre una caché en memoria y un CacheBackend
+ *
+ * prefetch() y writeBehind() solo encolan trabajo en un pool propio: la
+ * compilación nunca espera al backend. Una dirección se pide como mucho
+ * una vez por instancia, tanto si se encontró como si no, y lo que se
+ * escribe no se vuelve a pedir.
+ */
+class SecondaryCache {
+public:
+    /**
+     * @param backend Almacén compartido
+     * @param namespaceKey Versión del compilador y opciones (namespaceKeyFor())
+     * @param threadCount Hilos para E/S con el backend
+     */
+    SecondaryCache(std::shared_ptr<CacheBackend> backend, uint64_t namespaceKey,
+                   size_t threadCount = 2);
+
+    /**
+     * @brief Espera las lecturas y escrituras pendientes
+     */
+    ~SecondaryCache();
+
+    SecondaryCache(const SecondaryCache&) = delete;
+    SecondaryCache& operator=(const SecondaryCache&) = delete;
+
+    /**
+     * @brief Clave de espacio: entradas de otra versión u otras opciones no se mezclan
+     */
+    static uint64_t namespaceKeyFor(std::string_view compilerVersion, uint64_t optionsHash);
+
+    /**
+     * @brief Dirección de una entrada de un tipo de caché con una huella persistente
+     */
+    std::string address(uint32_t kind, uint64_t fingerprint) const;
+
+    /**
+     * @brief Pide una dirección en segundo plano
+     *
+     * Si existe, deliver recibe el valor desde un hilo del pool.
+     */
+    void prefetch(const std::string& address, std::function<void(std::string_view)> deliver);
+
+    /**
+     * @brief Publica un valor en segundo plano
+     */
+    void writeBehind(const std::string& address, std::string data);
+
+    /**
+     * @brief Bloquea hasta que no quedan operaciones pendientes
+     */
+    void wait();
+
+    size_t fetchCount() const { return fetches_.load(std::memory_order_relaxed); }
+    size_t hitCount() const { return hits_.load(std::memory_order_relaxed); }
+    size_t writeCount() const { return writes_.load(std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<CacheBackend> backend_;
+    uint64_t namespaceKey_;
+
+    std::mutex mutex_;
+    std::unordered_set<std::string> requested_;   // Direcciones pedidas o escritas
+
+    std::atomic<size_t> fetches_{0};
+    std::atomic<size_t> hits_{0};
+    std::atomic<size_t> writes_{0};
+
+    // Último miembro: se destruye primero y espera a los trabajos en curso
+    common::utils::ThreadPool pool_;
+
+    bool markRequested(const std::string& address);
+};
+
+} // namespace cpp20::compiler
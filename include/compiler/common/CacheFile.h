@@ -0,0 +1,187 @@
+/**
+ * @file CacheFile.h
+ * @brief Formato binario proyectable en memoria para cachés persistentes
+ */
+
+#pragma once
+
+#include <compiler/common/utils/MappedFile.h>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace cpp20::compiler {
+
+/**
+ * @brief Disposición del archivo (little-endian, tamaños fijos)
+ *
+ *   cabecera  magic "CPPCACHE", u32 versión, u32 tipo de caché,
+ *             u64 número de registros, CounterCount x u64 contadores
+ *   índice    por registro: u64 huella, u64 offset, u32 bytes de clave,
+ *             u32 bytes de valor; ordenado por huella
+ *   datos     clave y valor de cada registro, contiguos
+ *
+ * El índice va al principio para que una búsqueda binaria toque solo sus
+ * páginas y las del registro encontrado. Al abrir se valida la cabecera y
+ * el tamaño del índice; los límites de cada registro se comprueban al
+ * leerlo, de modo que abrir no recorre el archivo.
+ */
+namespace cache_file {
+constexpr uint32_t FormatVersion = 1;
+constexpr size_t CounterCount = 4;
+constexpr size_t HeaderSize = 8 + 4 + 4 + 8 + CounterCount * 8;
+constexpr size_t IndexEntrySize = 8 + 8 + 4 + 4;
+} // namespace cache_file
+
+/**
+ * @brief Construye un archivo de caché en memoria y lo escribe de forma atómica
+ */
+class CacheFileWriter {
+public:
+    void add(uint64_t fingerprint, std::string key, std::string value);
+
+    void setCounter(size_t index, uint64_t value) { counters_[index] = value; }
+
+    size_t size() const { return records_.size(); }
+
+    /**
+     * @brief Escribe en un temporal y lo renombra sobre el destino
+     *
+     * Un lector que tenga proyectado el archivo anterior sigue viendo su
+     * contenido hasta cerrarlo.
+     */
+    bool write(const std::filesystem::path& path, uint32_t kind) const;
+
+private:
+    struct Record {
+        uint64_t fingerprint;
+        std::string key;
+        std::string value;
+    };
+
+    std::vector<Record> records_;
+    std::array<uint64_t, cache_file::CounterCount> counters_{};
+};
+
+/**
+ * @brief Vista de solo lectura sobre un archivo de caché proyectado
+ */
+class CacheFileReader {
+public:
+    struct Record {
+        uint64_t fingerprint;
+        std::string_view key;
+        std::string_view value;
+    };
+
+    /**
+     * @brief Proyecta y valida la cabecera
+     * @return nullptr si el archivo no existe, no es de este tipo o de esta versión
+     */
+    static std::unique_ptr<CacheFileReader> open(const std::filesystem::path& path, uint32_t kind);
+
+    size_t size() const { return count_; }
+
+    uint64_t counter(size_t index) const;
+
+    uint64_t fingerprintAt(size_t index) const;
+
+    /**
+     * @brief Registro i del índice, o nullopt si sus límites salen del archivo
+     */
+    std::optional<Record> record(size_t index) const;
+
+    /**
+     * @brief Rango [first, last) de posiciones del índice con esa huella
+     */
+    std::pair<size_t, size_t> equalRange(uint64_t fingerprint) const;
+
+private:
+    CacheFileReader(std::unique_ptr<common::utils::MappedFile> mapping, size_t count)
+        : mapping_(std::move(mapping)), count_(count) {}
+
+    std::unique_ptr<common::utils::MappedFile> mapping_;
+    size_t count_;
+};
+
+/**
+ * @brief Codifica los campos de una clave o un valor
+ */
+class CacheRecordWriter {
+public:
+    void u8(uint8_t value) { buffer_.push_back(static_cast<char>(value)); }
+    void u32(uint32_t value) { raw(value, 4); }
+    void u64(uint64_t value) { raw(value, 8); }
+
+    void str(std::string_view value) {
+        u32(static_cast<uint32_t>(value.size()));
+        buffer_.append(value);
+    }
+
+    size_t size() const { return buffer_.size(); }
+    std::string take() { return std::move(buffer_); }
+
+private:
+    std::string buffer_;
+
+    void raw(uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            buffer_.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+        }
+    }
+};
+
+/**
+ * @brief Decodifica los campos escritos por CacheRecordWriter
+ *
+ * Las cadenas son vistas sobre el archivo proyectado. Una lectura fuera de
+ * límites deja ok() en false y devuelve ceros.
+ */
+class CacheRecordReader {
+public:
+    explicit CacheRecordReader(std::string_view data) : data_(data) {}
+
+    bool ok() const { return ok_; }
+    bool atEnd() const { return position_ == data_.size(); }
+
+    uint8_t u8() { return static_cast<uint8_t>(raw(1)); }
+    uint32_t u32() { return static_cast<uint32_t>(raw(4)); }
+    uint64_t u64() { return raw(8); }
+
+    std::string_view str() {
+        uint32_t size = u32();
+        if (!ok_ || data_.size() - position_ < size) {
+            ok_ = false;
+            return std::string_view();
+        }
+        std::string_view value = data_.substr(position_, size);
+        position_ += size;
+        return value;
+    }
+
+private:
+    std::string_view data_;
+    size_t position_ = 0;
+    bool ok_ = true;
+
+    uint64_t raw(int bytes) {
+        if (!ok_ || data_.size() - position_ < static_cast<size_t>(bytes)) {
+            ok_ = false;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(static_cast<uint8_t>(data_[position_ + i])) << (8 * i);
+        }
+        position_ += bytes;
+        return value;
+    }
+};
+
+} // namespace cpp20::compiler
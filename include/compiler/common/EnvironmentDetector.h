@@ -11,6 +11,8 @@
 #include <filesystem>
 #include <memory>
 #include <optional>
+#include <cstdint>
+#include <utility>
 
 namespace cpp20::compiler {
 
@@ -69,6 +71,11 @@ struct MSVCVersion {
         return revision < other.revision;
     }
 
+    bool operator==(const MSVCVersion& other) const {
+        return major == other.major && minor == other.minor && build == other.build &&
+               revision == other.revision;
+    }
+
     std::string toString() const {
         return fullVersion.empty() ?
             std::to_string(major) + "." + std::to_string(minor) + "." +
@@ -76,6 +83,148 @@ struct MSVCVersion {
     }
 };
 
+/**
+ * @brief Extensiones SIMD disponibles para el código generado
+ */
+struct CPUFeatures {
+    bool sse2 = true;       // Garantizada en x64
+    bool sse41 = false;     // PMULLD
+    bool sse42 = false;     // CRC32 y PCMPxSTRx
+    bool popcnt = false;
+    bool avx = false;       // Codificación VEX y registros YMM
+    bool avx2 = false;      // Enteros de 256 bits y broadcasts desde registro
+    bool bmi1 = false;      // ANDN, BLSR, TZCNT
+    bool bmi2 = false;      // SHLX/SHRX/SARX, PDEP/PEXT
+    bool lzcnt = false;
+    bool avx512f = false;   // Solo se detecta: el back-end no genera EVEX
+
+    // Bits de mask(): los que calcula IROpcode::CPUFeatures en tiempo de ejecución
+    static constexpr uint32_t SSE41 = 1;
+    static constexpr uint32_t AVX = 2;
+    static constexpr uint32_t AVX2 = 4;
+
+    /**
+     * @brief Ancho de los registros vectoriales que conviene usar
+     */
+    unsigned vectorBytes() const { return avx2 ? 32 : 16; }
+
+    uint32_t mask() const { return (sse41 ? SSE41 : 0) | (avx ? AVX : 0) | (avx2 ? AVX2 : 0); }
+
+    /**
+     * @brief Unión de dos conjuntos de extensiones
+     */
+    CPUFeatures operator|(const CPUFeatures& other) const {
+        CPUFeatures features;
+        features.sse41 = sse41 || other.sse41;
+        features.sse42 = sse42 || other.sse42;
+        features.popcnt = popcnt || other.popcnt;
+        features.avx = avx || other.avx;
+        features.avx2 = avx2 || other.avx2;
+        features.bmi1 = bmi1 || other.bmi1;
+        features.bmi2 = bmi2 || other.bmi2;
+        features.lzcnt = lzcnt || other.lzcnt;
+        features.avx512f = avx512f || other.avx512f;
+        return features;
+    }
+};
+
+/**
+ * @brief Bits de CPUID y XCR0 de cada extensión
+ *
+ * Los usan detectCPUFeatures y el código que el back-end genera para
+ * IROpcode::CPUFeatures, que repite la misma detección en la máquina
+ * que ejecuta el programa.
+ */
+namespace cpuid {
+inline constexpr uint32_t Leaf1EdxSSE2 = 1u << 26;
+inline constexpr uint32_t Leaf1EcxSSE41 = 1u << 19;
+inline constexpr uint32_t Leaf1EcxSSE42 = 1u << 20;
+inline constexpr uint32_t Leaf1EcxPOPCNT = 1u << 23;
+inline constexpr uint32_t Leaf1EcxOSXSAVE = 1u << 27;   // XGETBV disponible
+inline constexpr uint32_t Leaf1EcxAVX = 1u << 28;
+inline constexpr uint32_t Leaf7EbxBMI1 = 1u << 3;
+inline constexpr uint32_t Leaf7EbxAVX2 = 1u << 5;
+inline constexpr uint32_t Leaf7EbxBMI2 = 1u << 8;
+inline constexpr uint32_t Leaf7EbxAVX512F = 1u << 16;
+inline constexpr uint32_t Ext1EcxLZCNT = 1u << 5;       // Hoja 0x80000001 (ABM en AMD)
+inline constexpr uint32_t XcrYmmState = 0x6;            // El SO guarda XMM e YMM
+inline constexpr uint32_t XcrZmmState = 0xE6;           // Además opmask y ZMM
+} // namespace cpuid
+
+/**
+ * @brief Nombre de target_clones (los de GCC) a extensiones
+ *
+ * Cada nivel incluye los anteriores; "default" es el mínimo de x64.
+ * AVX-512 no se acepta: el back-end no genera EVEX.
+ */
+inline std::optional<CPUFeatures> parseTargetFeatures(const std::string& name) {
+    CPUFeatures features;
+    if (name == "default") return features;
+    features.sse41 = true;
+    if (name == "sse4.1") return features;
+    features.avx = true;
+    if (name == "avx") return features;
+    features.avx2 = true;
+    if (name == "avx2") return features;
+    return std::nullopt;
+}
+
+/**
+ * @brief Nombre de -march (los niveles x86-64 de GCC/Clang) a extensiones
+ *
+ * "native" no se resuelve aquí: es EnvironmentDetector::detectHostCPU().
+ */
+inline std::optional<CPUFeatures> parseArchitecture(const std::string& name) {
+    CPUFeatures features;
+    if (name == "x86-64") return features;
+    features.sse41 = features.sse42 = features.popcnt = true;
+    if (name == "x86-64-v2") return features;
+    features.avx = features.avx2 = features.bmi1 = features.bmi2 = features.lzcnt = true;
+    if (name == "x86-64-v3") return features;
+    features.avx512f = true;
+    if (name == "x86-64-v4") return features;
+    return std::nullopt;
+}
+
+/**
+ * @brief Microarquitectura para la que se ajusta el código (-mtune)
+ *
+ * No cambia qué instrucciones se usan, solo el orden que elige el
+ * planificador del back-end.
+ */
+enum class Microarchitecture {
+    Generic,
+    Skylake,
+    Zen3,
+    Zen4
+};
+
+/**
+ * @brief Nombre de -mtune (los de GCC/Clang) a microarquitectura
+ */
+inline std::optional<Microarchitecture> parseMicroarchitecture(const std::string& name) {
+    if (name == "generic") return Microarchitecture::Generic;
+    if (name == "skylake") return Microarchitecture::Skylake;
+    if (name == "znver3") return Microarchitecture::Zen3;
+    if (name == "znver4") return Microarchitecture::Zen4;
+    return std::nullopt;
+}
+
+/**
+ * @brief CPU que ejecuta el compilador (-march=native / -mtune=native)
+ */
+struct HostCPU {
+    std::string vendor;                 // "GenuineIntel", "AuthenticAMD"... (vacío sin CPUID)
+    uint32_t signature = 0;             // EAX de CPUID(1): familia, modelo y stepping
+    unsigned family = 0;
+    unsigned model = 0;
+    Microarchitecture microarchitecture = Microarchitecture::Generic;
+    CPUFeatures features;
+    uint32_t l1DataKB = 0;              // Tamaños de caché por núcleo (L3: compartida)
+    uint32_t l2KB = 0;
+    uint32_t l3KB = 0;
+};
+
 /**
  * @brief Información del entorno de compilación detectado
  */
@@ -88,6 +237,7 @@ struct DetectedEnvironment {
     std::vector<std::filesystem::path> libraryPaths;
     std::vector<std::string> preprocessorDefinitions;
     std::string targetArchitecture;
+    HostCPU hostCPU;
     bool isValid;
 
     DetectedEnvironment()
@@ -114,6 +264,32 @@ public:
      */
     DetectedEnvironment detectEnvironment(const std::string& targetArch = "x64");
 
+    /**
+     * @brief Extensiones SIMD de la CPU que ejecuta el compilador
+     *
+     * Es el objetivo por defecto del código generado (equivale a compilar
+     * para la máquina local); AVX solo cuenta si el SO guarda el estado YMM.
+     */
+    static CPUFeatures detectCPUFeatures();
+
+    /**
+     * @brief Extensiones, microarquitectura y cachés de la CPU local
+     */
+    static HostCPU detectHostCPU();
+
+    /**
+     * @brief Fabricante y firma de CPUID(1): basta para saber si un HostCPU guardado sigue valiendo
+     */
+    static std::pair<std::string, uint32_t> hostSignature();
+
+    /**
+     * @brief Modelo del planificador más cercano a una familia/modelo de CPUID
+     *
+     * Los núcleos grandes de Intel posteriores a Skylake comparten sus
+     * puertos; Zen 5 se aproxima con Zen 4. El resto es Generic.
+     */
+    static Microarchitecture microarchitectureFor(const std::string& vendor, unsigned family, unsigned model);
+
     /**
      * @brief Busca instalación de Visual Studio
      */
@@ -170,6 +346,15 @@ public:
      */
     std::string getCompilerVersionString(const std::filesystem::path& compilerPath);
 
+    /**
+     * @brief Directorios cuyo mtime cambia al instalar o quitar lo detectado
+     *
+     * Las raíces donde se buscan Visual Studio y los Windows Kits, más el
+     * directorio de toolsets de la instalación elegida: sirven de huella
+     * para revalidar una detección guardada sin repetirla.
+     */
+    static std::vector<std::filesystem::path> fingerprintDirectories(const DetectedEnvironment& env);
+
     /**
      * @brief Lista todas las versiones disponibles de MSVC
      */
@@ -190,6 +375,11 @@ public:
      */
     std::string getPreferredArchitecture() const { return preferredArch_; }
 
+    /**
+     * @brief Obtiene arquitectura canónica
+     */
+    std::string getCanonicalArchitecture(const std::string& arch);
+
 private:
     std::string preferredArch_;
 
@@ -252,11 +442,6 @@ private:
      */
     bool isPathAccessible(const std::filesystem::path& path);
 
-    /**
-     * @brief Obtiene arquitectura canónica
-     */
-    std::string getCanonicalArchitecture(const std::string& arch);
-
     /**
      * @brief Determina la mejor versión de MSVC disponible
      */
@@ -371,8 +556,41 @@ public:
      */
     void updateConfig(DetectedEnvironment& existing, const DetectedEnvironment& detected);
 
+    /**
+     * @brief Entorno guardado en la caché por usuario, o detectado y guardado
+     *
+     * La detección recorre las instalaciones de Visual Studio y del SDK; la
+     * caché la evita en cada invocación. Se revalida con el mtime de
+     * EnvironmentDetector::fingerprintDirectories(): instalar o quitar un
+     * Visual Studio, un toolset o un SDK cambia alguno de ellos. Con la
+     * caché válida el coste es un stat por directorio. El HostCPU guardado
+     * se reutiliza si la firma de CPUID coincide; si no, se redetecta solo él.
+     */
+    DetectedEnvironment loadOrDetect(const std::string& targetArch = "x64");
+
+    /**
+     * @brief Lee la caché
+     * @return false si falta, está corrupta, es de otra arquitectura o alguna huella cambió
+     */
+    bool loadCache(const std::filesystem::path& cacheFile, const std::string& targetArch,
+                   DetectedEnvironment& env);
+
+    /**
+     * @brief Escribe la caché con las huellas actuales (escritura atómica vía archivo temporal)
+     */
+    bool saveCache(const std::filesystem::path& cacheFile, const DetectedEnvironment& env);
+
+    void setCacheFile(const std::filesystem::path& cacheFile) { cacheFile_ = cacheFile; }
+    const std::filesystem::path& cacheFile() const { return cacheFile_; }
+
+    /**
+     * @brief Caché por usuario: %LOCALAPPDATA%, $XDG_CACHE_HOME o ~/.cache
+     */
+    static std::filesystem::path defaultCacheFile();
+
 private:
     std::filesystem::path configFile_;
+    std::filesystem::path cacheFile_;
 
     /**
      * @brief Parsea archivo de configuración JSON
@@ -0,0 +1,132 @@
+/**
+ * @file TelemetrySink.h
+ * @brief Métricas por unidad acumuladas entre compilaciones
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace cpp20::compiler {
+
+/**
+ * @brief Métricas de una unidad de traducción (o de un enlace)
+ *
+ * Los nombres van con puntos por familia: "phase.Parsing.us",
+ * "cache.template.hit_rate", "bmi.load.us", "link.total_symbols".
+ */
+struct TelemetryRecord {
+    std::string unit;
+    std::string compilerVersion;
+    std::map<std::string, double> metrics;   // Ordenado: líneas estables entre ejecuciones
+};
+
+/**
+ * @brief Archivo de métricas compartido por todo el build (-ftelemetry=)
+ *
+ * Cada registro es una línea JSON que se añade al final bajo un FileLock
+ * sobre <archivo>.lock, de modo que los procesos de un build paralelo
+ * pueden escribir en el mismo archivo. Las líneas mal formadas (un proceso
+ * que murió a medias) se saltan al leer.
+ */
+class TelemetrySink {
+public:
+    explicit TelemetrySink(std::filesystem::path path) : path_(std::move(path)) {}
+
+    bool append(const TelemetryRecord& record) const;
+    bool append(const std::vector<TelemetryRecord>& records) const;
+
+    const std::filesystem::path& path() const { return path_; }
+
+    /**
+     * @param malformed Si no es nulo, recibe el número de líneas descartadas
+     */
+    static std::vector<TelemetryRecord> read(const std::filesystem::path& path,
+                                             size_t* malformed = nullptr);
+
+    static std::string formatRecord(const TelemetryRecord& record);
+    static std::optional<TelemetryRecord> parseRecord(std::string_view line);
+
+private:
+    std::filesystem::path path_;
+};
+
+/**
+ * @brief Distribución de una métrica sobre todas las unidades
+ */
+struct MetricDistribution {
+    std::string name;
+    size_t count = 0;
+    double min = 0;
+    double max = 0;
+    double mean = 0;
+    double p50 = 0;
+    double p90 = 0;
+    double p99 = 0;
+    double total = 0;
+};
+
+/**
+ * @brief Variación de una métrica frente a una distribución de referencia
+ */
+struct MetricRegression {
+    std::string name;
+    double baseline = 0;        // p50 de referencia
+    double current = 0;         // p50 actual
+    double baselineP90 = 0;
+    double currentP90 = 0;
+    double change = 0;          // Mayor incremento relativo de p50 y p90
+};
+
+/**
+ * @brief Agrega registros de muchos builds en distribuciones por métrica
+ *
+ * Los percentiles son del valor más cercano sobre la muestra ordenada.
+ * filterVersion(), llamado antes de add(), deja solo los registros de una
+ * versión del compilador: así se comparan dos versiones del mismo archivo.
+ */
+class TelemetryAggregator {
+public:
+    void add(const TelemetryRecord& record);
+    void add(const std::vector<TelemetryRecord>& records);
+
+    void filterVersion(std::string versionFilter) { versionFilter_ = std::move(versionFilter); }
+
+    size_t recordCount() const { return records_; }
+
+    /**
+     * @brief Distribuciones ordenadas por nombre de métrica
+     */
+    std::vector<MetricDistribution> distributions() const;
+
+    std::string generateReport() const;
+    std::string generateJSON() const;
+
+    /**
+     * @brief Métricas cuyo p50 o p90 crecen más de tolerance (0.05 = 5%)
+     *
+     * Solo se comparan las métricas presentes en ambos lados con al menos
+     * minSamples muestras. Todas las métricas se tratan como "menos es
+     * mejor" salvo las terminadas en hit_rate, donde se invierte el signo.
+     */
+    static std::vector<MetricRegression> findRegressions(
+        const std::vector<MetricDistribution>& baseline,
+        const std::vector<MetricDistribution>& current,
+        double tolerance, size_t minSamples = 1);
+
+    static std::string formatRegressions(const std::vector<MetricRegression>& regressions);
+
+private:
+    std::map<std::string, std::vector<double>> samples_;
+    std::string versionFilter_;
+    size_t records_ = 0;
+};
+
+} // namespace cpp20::compiler
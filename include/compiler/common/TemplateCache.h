@@ -6,7 +6,14 @@
 #pragma once
 
 #include <compiler/types/Type.h>
+#include <compiler/common/CacheBackend.h>
+#include <compiler/common/CacheFile.h>
+#include <compiler/common/utils/HashUtils.h>
 #include <compiler/ast/ASTNode.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <unordered_map>
 #include <unordered_set>
 #include <memory>
@@ -17,15 +24,26 @@
 
 namespace cpp20::compiler {
 
+class CompilationTelemetry;
+
 /**
  * @brief Clave de caché para instanciaciones de plantillas
  */
 struct TemplateInstantiationKey {
     std::string templateName;           // Nombre de la plantilla
-    std::vector<Type> argumentTypes;    // Tipos de los argumentos
+    std::vector<const types::Type*> argumentTypes; // Tipos canónicos de los argumentos (TypeContext)
     std::string sourceLocation;         // Ubicación en el código fuente
     std::string compilationContext;     // Contexto de compilación (flags, etc.)
 
+    /**
+     * @brief Huella de 64 bits de la clave
+     *
+     * Mezcla dependiente del orden: pair<int, long> y pair<long, int> dan
+     * huellas distintas. Los tipos entran por su identidad canónica, sin
+     * toString().
+     */
+    uint64_t fingerprint() const;
+
     bool operator==(const TemplateInstantiationKey& other) const {
         return templateName == other.templateName &&
                argumentTypes == other.argumentTypes &&
@@ -54,16 +72,7 @@ struct TemplateInstantiationValue {
  */
 struct TemplateInstantiationKeyHash {
     size_t operator()(const TemplateInstantiationKey& key) const {
-        size_t hash = std::hash<std::string>()(key.templateName);
-
-        for (const auto& type : key.argumentTypes) {
-            hash ^= std::hash<std::string>()(type.toString());
-        }
-
-        hash ^= std::hash<std::string>()(key.sourceLocation);
-        hash ^= std::hash<std::string>()(key.compilationContext);
-
-        return hash;
+        return static_cast<size_t>(key.fingerprint());
     }
 };
 
@@ -91,6 +100,22 @@ struct TemplateCacheStats {
 
 /**
  * @brief Caché para instanciaciones de plantillas
+ *
+ * Las entradas se reparten en ShardCount particiones según el hash de la
+ * clave; cada una tiene su mutex y su LRU, así que hilos que consultan
+ * claves distintas casi nunca compiten. Los contadores son atómicos y el
+ * límite de memoria es global: al superarlo se expulsa desde la LRU de la
+ * partición que inserta.
+ *
+ * deserializeFromFile() no reconstruye las entradas: proyecta el archivo
+ * (ver CacheFile.h) y cada fallo en memoria busca la clave en su índice,
+ * cargando solo los registros que se piden. Como los punteros de tipo no
+ * sobreviven a la invocación, en disco la clave se identifica por el
+ * texto de sus tipos.
+ *
+ * Con un SecondaryCache conectado, los fallos lo consultan en segundo
+ * plano (la búsqueda que falla no espera; una posterior acierta) y cada
+ * store() publica la entrada en él.
  */
 class TemplateInstantiationCache {
 public:
@@ -132,9 +157,9 @@ public:
     void clear();
 
     /**
-     * @brief Obtiene estadísticas del caché
+     * @brief Obtiene una instantánea de las estadísticas del caché
      */
-    const TemplateCacheStats& getStats() const { return stats_; }
+    TemplateCacheStats getStats() const;
 
     /**
      * @brief Establece límite de memoria
@@ -148,14 +173,25 @@ public:
 
     /**
      * @brief Serializa el caché a disco
+     *
+     * Incluye las entradas del archivo proyectado que no se llegaron a
+     * cargar ni se invalidaron.
      */
     bool serializeToFile(const std::filesystem::path& filePath) const;
 
     /**
-     * @brief Deserializa el caché desde disco
+     * @brief Proyecta un archivo de caché; sus entradas se cargan bajo demanda
      */
     bool deserializeFromFile(const std::filesystem::path& filePath);
 
+    /**
+     * @brief Conecta un almacén secundario compartido (nullptr lo desconecta)
+     *
+     * Debe fijarse antes de usar el caché desde varios hilos. El destructor
+     * espera a las entregas pendientes del almacén conectado.
+     */
+    void setSecondary(SecondaryCache* secondary) { secondary_ = secondary; }
+
     /**
      * @brief Habilita/deshabilita el caché
      */
@@ -167,25 +203,76 @@ public:
     bool isEnabled() const { return enabled_; }
 
 private:
-    bool enabled_;
-    size_t maxMemory_;
-    mutable std::mutex mutex_;
+    static constexpr size_t ShardCount = 16;
+    static constexpr uint32_t FileKind = 1;
 
-    std::unordered_map<TemplateInstantiationKey,
-                       std::unique_ptr<TemplateInstantiationValue>,
-                       TemplateInstantiationKeyHash> cache_;
+    /**
+     * @brief Nodo del caché enlazado en la lista LRU intrusiva de su partición
+     *
+     * La tabla se indexa por la huella de la clave; la clave completa vive
+     * en el nodo y solo se compara cuando dos huellas coinciden. Los nodos
+     * de unordered_multimap no se mueven al rehacer la tabla, así que los
+     * enlaces siguen siendo válidos mientras la entrada exista. Los enlaces
+     * son mutable porque lookup() es const y mueve la entrada al frente
+     * bajo el mutex de la partición.
+     */
+    struct CacheEntry {
+        TemplateInstantiationKey key;
+        uint64_t fingerprint = 0;
+        std::unique_ptr<TemplateInstantiationValue> value;
+        mutable const CacheEntry* lruPrev = nullptr;
+        mutable const CacheEntry* lruNext = nullptr;
+    };
 
-    // Para LRU eviction
-    std::unordered_map<TemplateInstantiationKey,
-                       std::chrono::system_clock::time_point,
-                       TemplateInstantiationKeyHash> accessTimes_;
+    // La huella ya está mezclada: basta con la identidad como hash
+    struct FingerprintHash {
+        size_t operator()(uint64_t fingerprint) const { return static_cast<size_t>(fingerprint); }
+    };
 
-    mutable TemplateCacheStats stats_;
+    using EntryMap = std::unordered_multimap<uint64_t, CacheEntry, FingerprintHash>;
 
     /**
-     * @brief Actualiza estadísticas
+     * @brief Partición con su propio mutex, tabla y LRU
+     *
+     * Cabeza = usada más recientemente, cola = próxima a expulsar.
      */
-    void updateStats();
+    struct Shard {
+        mutable std::mutex mutex;
+        EntryMap entries;
+        mutable const CacheEntry* lruHead = nullptr;
+        mutable const CacheEntry* lruTail = nullptr;
+        std::unordered_set<uint64_t> hiddenPersisted; // Huellas en disco invalidadas
+    };
+
+    std::atomic<bool> enabled_;
+    std::atomic<size_t> maxMemory_;
+    std::array<Shard, ShardCount> shards_;
+
+    // Archivo proyectado por deserializeFromFile(); solo cambia con todas
+    // las particiones bloqueadas
+    std::unique_ptr<CacheFileReader> persisted_;
+
+    SecondaryCache* secondary_ = nullptr;
+
+    // Contadores compartidos por todas las particiones
+    mutable std::atomic<size_t> totalInstantiations_{0};
+    mutable std::atomic<size_t> cacheHits_{0};
+    mutable std::atomic<size_t> cacheMisses_{0};
+    std::atomic<size_t> memoryUsed_{0};
+
+    Shard& shardFor(uint64_t fingerprint);
+    const Shard& shardFor(uint64_t fingerprint) const;
+
+    /**
+     * @brief Busca la entrada de una clave entre las de su misma huella
+     *
+     * Requiere el mutex de la partición tomado.
+     */
+    static EntryMap::iterator findLocked(Shard& shard, const TemplateInstantiationKey& key,
+                                         uint64_t fingerprint);
+    static EntryMap::const_iterator findLocked(const Shard& shard,
+                                               const TemplateInstantiationKey& key,
+                                               uint64_t fingerprint);
 
     /**
      * @brief Calcula tamaño de memoria de una entrada
@@ -193,9 +280,70 @@ private:
     size_t calculateEntrySize(const TemplateInstantiationValue& value) const;
 
     /**
-     * @brief Encuentra la entrada más antigua para eviction
+     * @brief Inserta o reemplaza una entrada y la deja al frente de la LRU
+     *
+     * Requiere el mutex de la partición tomado.
+     */
+    CacheEntry& insertLocked(Shard& shard, const TemplateInstantiationKey& key, uint64_t fingerprint,
+                             std::unique_ptr<TemplateInstantiationValue> value);
+
+    /**
+     * @brief Lee del archivo proyectado el valor de una clave
+     *
+     * Requiere el mutex de la partición tomado.
+     * @return nullptr si no hay archivo, la clave no está o fue invalidada
+     */
+    std::unique_ptr<TemplateInstantiationValue> loadPersistedLocked(
+        const Shard& shard, const TemplateInstantiationKey& key) const;
+
+    std::array<std::unique_lock<std::mutex>, ShardCount> lockAllShards() const;
+
+    /**
+     * @brief Elimina una entrada ajustando memoria y lista en O(1)
+     *
+     * Requiere el mutex de la partición tomado.
+     */
+    void eraseLocked(Shard& shard, EntryMap::iterator it);
+
+    /**
+     * @brief Expulsa desde la cola de la LRU hasta volver al límite
+     *
+     * Requiere el mutex de la partición tomado.
+     */
+    void evictLocked(Shard& shard);
+
+    /**
+     * @brief Vacía tabla y lista de la partición
+     *
+     * Requiere el mutex de la partición tomado.
+     */
+    void clearLocked(Shard& shard);
+
+    /**
+     * @brief Pide la clave al almacén secundario; la respuesta llega por storeFetched()
      */
-    TemplateInstantiationKey findLRUEntry() const;
+    void requestSecondary(const TemplateInstantiationKey& key) const;
+
+    /**
+     * @brief Publica una entrada en el almacén secundario
+     */
+    void publishSecondary(const TemplateInstantiationKey& key,
+                          const TemplateInstantiationValue& value) const;
+
+    /**
+     * @brief Inserta una entrada recibida del almacén secundario si sigue faltando
+     */
+    void storeFetched(const TemplateInstantiationKey& key,
+                      std::unique_ptr<TemplateInstantiationValue> value);
+
+    /**
+     * @brief Vacía todas las particiones, suelta el archivo proyectado y
+     * pone a cero los contadores
+     */
+    void clearAllShards();
+
+    static void lruUnlink(const Shard& shard, const CacheEntry& entry);
+    static void lruPushFront(const Shard& shard, const CacheEntry& entry);
 
     /**
      * @brief Verifica si se necesita limpieza
@@ -209,9 +357,17 @@ private:
 struct ConstexprEvaluationKey {
     std::string expression;             // Expresión a evaluar
     std::string context;                // Contexto (función, template, etc.)
-    std::unordered_map<std::string, Type> parameters; // Parámetros y sus tipos
+    std::unordered_map<std::string, const types::Type*> parameters; // Parámetros y sus tipos canónicos
     std::string compilationFlags;       // Flags de compilación que afectan la evaluación
 
+    /**
+     * @brief Huella de 64 bits de la clave
+     *
+     * Los parámetros se combinan de forma conmutativa porque el mapa no
+     * tiene orden; el resto de campos, en orden.
+     */
+    uint64_t fingerprint() const;
+
     bool operator==(const ConstexprEvaluationKey& other) const {
         return expression == other.expression &&
                context == other.context &&
@@ -241,16 +397,7 @@ struct ConstexprEvaluationValue {
  */
 struct ConstexprEvaluationKeyHash {
     size_t operator()(const ConstexprEvaluationKey& key) const {
-        size_t hash = std::hash<std::string>()(key.expression);
-        hash ^= std::hash<std::string>()(key.context);
-        hash ^= std::hash<std::string>()(key.compilationFlags);
-
-        for (const auto& [name, type] : key.parameters) {
-            hash ^= std::hash<std::string>()(name);
-            hash ^= std::hash<std::string>()(type.toString());
-        }
-
-        return hash;
+        return static_cast<size_t>(key.fingerprint());
     }
 };
 
@@ -277,6 +424,10 @@ struct ConstexprCacheStats {
 
 /**
  * @brief Caché para evaluaciones constexpr
+ *
+ * Particionado y persistido igual que TemplateInstantiationCache: un
+ * mutex por partición, contadores atómicos compartidos y archivo
+ * proyectado cuyos registros se cargan bajo demanda.
  */
 class ConstexprEvaluationCache {
 public:
@@ -321,9 +472,9 @@ public:
     void clear();
 
     /**
-     * @brief Obtiene estadísticas del caché
+     * @brief Obtiene una instantánea de las estadísticas del caché
      */
-    const ConstexprCacheStats& getStats() const { return stats_; }
+    ConstexprCacheStats getStats() const;
 
     /**
      * @brief Establece límite de entradas
@@ -332,14 +483,25 @@ public:
 
     /**
      * @brief Serializa el caché a disco
+     *
+     * Incluye las entradas del archivo proyectado que no se llegaron a
+     * cargar ni se invalidaron.
      */
     bool serializeToFile(const std::filesystem::path& filePath) const;
 
     /**
-     * @brief Deserializa el caché desde disco
+     * @brief Proyecta un archivo de caché; sus entradas se cargan bajo demanda
      */
     bool deserializeFromFile(const std::filesystem::path& filePath);
 
+    /**
+     * @brief Conecta un almacén secundario compartido (nullptr lo desconecta)
+     *
+     * Debe fijarse antes de usar el caché desde varios hilos. El destructor
+     * espera a las entregas pendientes del almacén conectado.
+     */
+    void setSecondary(SecondaryCache* secondary) { secondary_ = secondary; }
+
     /**
      * @brief Habilita/deshabilita el caché
      */
@@ -351,25 +513,95 @@ public:
     bool isEnabled() const { return enabled_; }
 
 private:
-    bool enabled_;
-    size_t maxEntries_;
-    mutable std::mutex mutex_;
+    static constexpr size_t ShardCount = 16;
+    static constexpr uint32_t FileKind = 2;
+
+    /**
+     * @brief Entrada indexada por huella; la clave completa solo se compara
+     * cuando dos huellas coinciden
+     */
+    struct CacheEntry {
+        ConstexprEvaluationKey key;
+        std::unique_ptr<ConstexprEvaluationValue> value;
+    };
+
+    struct FingerprintHash {
+        size_t operator()(uint64_t fingerprint) const { return static_cast<size_t>(fingerprint); }
+    };
+
+    using EntryMap = std::unordered_multimap<uint64_t, CacheEntry, FingerprintHash>;
 
-    std::unordered_map<ConstexprEvaluationKey,
-                       std::unique_ptr<ConstexprEvaluationValue>,
-                       ConstexprEvaluationKeyHash> cache_;
+    struct Shard {
+        mutable std::mutex mutex;
+        EntryMap entries;
+        std::unordered_set<uint64_t> hiddenPersisted; // Huellas en disco invalidadas
+    };
 
-    mutable ConstexprCacheStats stats_;
+    std::atomic<bool> enabled_;
+    std::atomic<size_t> maxEntries_;
+    std::array<Shard, ShardCount> shards_;
+
+    // Archivo proyectado por deserializeFromFile(), como en TemplateInstantiationCache
+    std::unique_ptr<CacheFileReader> persisted_;
+
+    SecondaryCache* secondary_ = nullptr;
+
+    mutable std::atomic<size_t> totalEvaluations_{0};
+    mutable std::atomic<size_t> cacheHits_{0};
+    mutable std::atomic<size_t> cacheMisses_{0};
+    std::atomic<size_t> failedEvaluations_{0};
+    std::atomic<size_t> entryCount_{0};
+
+    Shard& shardFor(uint64_t fingerprint);
+    const Shard& shardFor(uint64_t fingerprint) const;
 
     /**
-     * @brief Actualiza estadísticas
+     * @brief Busca la entrada de una clave entre las de su misma huella
+     *
+     * Requiere el mutex de la partición tomado.
      */
-    void updateStats();
+    static EntryMap::iterator findLocked(Shard& shard, const ConstexprEvaluationKey& key,
+                                         uint64_t fingerprint);
+    static EntryMap::const_iterator findLocked(const Shard& shard,
+                                               const ConstexprEvaluationKey& key,
+                                               uint64_t fingerprint);
 
     /**
-     * @brief Realiza limpieza por LRU si es necesario
+     * @brief Elimina entradas de la partición hasta volver al límite
+     *
+     * Requiere el mutex de la partición tomado.
      */
-    void performLRUCleanup();
+    void evictLocked(Shard& shard);
+
+    /**
+     * @brief Inserta o reemplaza una entrada
+     *
+     * Requiere el mutex de la partición tomado.
+     */
+    CacheEntry& insertLocked(Shard& shard, const ConstexprEvaluationKey& key, uint64_t fingerprint,
+                             std::unique_ptr<ConstexprEvaluationValue> value);
+
+    /**
+     * @brief Lee del archivo proyectado el valor de una clave
+     *
+     * Requiere el mutex de la partición tomado.
+     */
+    std::unique_ptr<ConstexprEvaluationValue> loadPersistedLocked(
+        const Shard& shard, const ConstexprEvaluationKey& key) const;
+
+    std::array<std::unique_lock<std::mutex>, ShardCount> lockAllShards() const;
+
+    void requestSecondary(const ConstexprEvaluationKey& key) const;
+    void publishSecondary(const ConstexprEvaluationKey& key,
+                          const ConstexprEvaluationValue& value) const;
+    void storeFetched(const ConstexprEvaluationKey& key,
+                      std::unique_ptr<ConstexprEvaluationValue> value);
+
+    /**
+     * @brief Vacía todas las particiones, suelta el archivo proyectado y
+     * pone a cero los contadores
+     */
+    void clearAllShards();
 };
 
 /**
@@ -420,14 +652,39 @@ public:
      */
     std::string getUnifiedStats() const;
 
+    /**
+     * @brief Vuelca aciertos, fallos y tasas de ambos cachés como métricas "cache.*"
+     */
+    void recordTelemetry(CompilationTelemetry& telemetry) const;
+
     /**
      * @brief Habilita/deshabilita todos los cachés
      */
     void setEnabled(bool enabled);
 
+    /**
+     * @brief Conecta ambos cachés a un almacén compartido (nullptr lo desconecta)
+     *
+     * Las direcciones incluyen la versión del compilador y el hash de las
+     * opciones (p. ej. CompilationOptionsHash::combined()), de modo que
+     * builds incompatibles no comparten entradas.
+     */
+    void setSecondaryBackend(std::shared_ptr<CacheBackend> backend,
+                             std::string_view compilerVersion,
+                             uint64_t optionsHash);
+
+    /**
+     * @brief Almacén secundario conectado, o nullptr
+     */
+    SecondaryCache* getSecondary() { return secondary_.get(); }
+
 private:
     TemplateInstantiationCache templateCache_;
     ConstexprEvaluationCache constexprCache_;
+
+    // Después de los cachés: al destruirse espera las entregas que aún
+    // escriben en ellos
+    std::unique_ptr<SecondaryCache> secondary_;
 };
 
 } // namespace cpp20::compiler
@@ -5,13 +5,20 @@
 
 #pragma once
 
+#include <compiler/common/TelemetrySink.h>
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <filesystem>
 #include <memory>
 #include <iostream>
 #include <mutex>
+#include <string_view>
+#include <thread>
 
 namespace cpp20::compiler {
 
@@ -23,6 +30,7 @@ enum class CompilationPhase {
     Lexing,
     Parsing,
     Preprocessing,
+    HeaderInclusion,
     SemanticAnalysis,
 
     // Fases de templates y constexpr
@@ -32,6 +40,7 @@ enum class CompilationPhase {
 
     // Fases del back-end
     IRGeneration,
+    CodeGeneration,
     InstructionSelection,
     RegisterAllocation,
     CodeOptimization,
@@ -56,6 +65,7 @@ enum class CompilationPhase {
     DiagnosticEmission,
     FileIO,
     MemoryManagement,
+    TranslationUnit,
     TotalCompilation,
 
     // Placeholder para extensiones futuras
@@ -89,10 +99,11 @@ struct PhaseStats {
     std::chrono::microseconds maxTime;   // Tiempo máximo
     std::chrono::microseconds avgTime;   // Tiempo promedio
     size_t totalMemory;                  // Memoria total usada
+    size_t peakMemory;                   // Mayor pico de una ejecución
     size_t totalOperations;              // Operaciones totales
 
     PhaseStats() : callCount(0), totalTime(0), minTime(std::chrono::microseconds::max()),
-                  maxTime(0), avgTime(0), totalMemory(0), totalOperations(0) {}
+                  maxTime(0), avgTime(0), totalMemory(0), peakMemory(0), totalOperations(0) {}
 
     void update(const PhaseTiming& timing) {
         callCount++;
@@ -100,6 +111,7 @@ struct PhaseStats {
         minTime = std::min(minTime, timing.duration);
         maxTime = std::max(maxTime, timing.duration);
         totalMemory += timing.memoryUsed;
+        peakMemory = std::max(peakMemory, timing.peakMemory);
         totalOperations += timing.operationsCount;
 
         if (callCount > 0) {
@@ -108,8 +120,47 @@ struct PhaseStats {
     }
 };
 
+/**
+ * @brief Intervalo completo de un hilo en la traza
+ *
+ * Se guarda al cerrar el ámbito, con su inicio: los ámbitos anidados quedan
+ * contenidos en el de fuera y el visor de trazas reconstruye la pila.
+ */
+struct TraceEvent {
+    uint64_t begin = 0;         // Ticks de TimingProfiler::now()
+    uint64_t end = 0;
+    CompilationPhase phase = CompilationPhase::CustomPhase;
+    std::string detail;         // Atributo: plantilla instanciada, archivo...
+};
+
+/**
+ * @brief Coste acumulado de una entidad: plantilla, función constexpr, header...
+ *
+ * totalTime incluye los ámbitos anidados; selfTime los descuenta, de modo
+ * que un header que incluye otros solo se lleva lo que cuesta él mismo.
+ */
+struct EntityStats {
+    CompilationPhase phase = CompilationPhase::CustomPhase;
+    std::string name;
+    size_t count = 0;
+    std::chrono::microseconds totalTime{0};
+    std::chrono::microseconds selfTime{0};
+    size_t memory = 0;                   // Suma de lo registrado con recordMemoryUsage
+};
+
+class TimingProfiler;
+
 /**
  * @brief Temporizador automático (RAII)
+ *
+ * Mide un ámbito: se pueden anidar y usar desde varios hilos a la vez. Si
+ * el profiler tiene la traza activa, el ámbito se añade también al buffer
+ * del hilo con details como atributo; si acumula entidades, details es el
+ * nombre de la entidad.
+ *
+ * Con MemoryTracker activo toma instantáneas al abrir y cerrar: la memoria
+ * de la fase es lo que crece el uso contabilizado y su pico el máximo
+ * alcanzado entre medias.
  */
 class AutoTimer {
 public:
@@ -119,6 +170,12 @@ public:
     AutoTimer(TimingProfiler& profiler, CompilationPhase phase,
               const std::string& details = "");
 
+    /**
+     * @brief Como el anterior; con profiler nulo no mide nada
+     */
+    AutoTimer(TimingProfiler* profiler, CompilationPhase phase,
+              const std::string& details = "");
+
     /**
      * @brief Destructor - detiene el temporizador y registra el tiempo
      */
@@ -139,17 +196,38 @@ public:
      */
     void recordMemoryUsage(size_t bytes);
 
+    AutoTimer(const AutoTimer&) = delete;
+    AutoTimer& operator=(const AutoTimer&) = delete;
+
 private:
-    TimingProfiler& profiler_;
+    TimingProfiler* profiler_;
     CompilationPhase phase_;
     std::chrono::steady_clock::time_point startTime_;
+    uint64_t startTicks_ = 0;
+    uint64_t childTicks_ = 0;       // Ticks de los ámbitos anidados, para el tiempo propio
+    AutoTimer* parent_ = nullptr;   // Ámbito que estaba abierto en este hilo
     std::string details_;
     size_t operations_;
     size_t memoryUsed_;
+    bool trackingMemory_ = false;
+    size_t startMemory_ = 0;        // MemoryTracker::totalCurrent() al abrir
+    size_t outerPeakWindow_ = 0;    // Devuelto por beginPeakWindow()
 };
 
 /**
  * @brief Sistema de profiling de tiempos
+ *
+ * startPhase/endPhase llevan una medición abierta por fase y sirven para
+ * fases únicas del proceso. Para fases anidadas o concurrentes se usa
+ * AutoTimer, que además alimenta la traza.
+ *
+ * La traza (enableTrace) guarda eventos en un buffer circular por hilo:
+ * cada hilo escribe solo en el suyo, sin locks, y el mutex solo se toma la
+ * primera vez que un hilo registra un evento. Las marcas de tiempo son del
+ * TSC en x86-64 (steady_clock en otras arquitecturas) y se convierten a
+ * microsegundos al exportar, calibrando contra steady_clock. La exportación
+ * sigue el formato trace_event de Chrome, como -ftime-trace de clang, y se
+ * abre en chrome://tracing o Perfetto.
  */
 class TimingProfiler {
 public:
@@ -175,10 +253,11 @@ public:
 
     /**
      * @brief Registra tiempo de una fase completada
+     * @param peakMemory Pico de memoria en la fase (0 = el de memoryUsed)
      */
     void recordPhaseTiming(CompilationPhase phase, std::chrono::microseconds duration,
                           size_t memoryUsed = 0, size_t operations = 0,
-                          const std::string& details = "");
+                          const std::string& details = "", size_t peakMemory = 0);
 
     /**
      * @brief Obtiene información de timing de una fase
@@ -195,6 +274,11 @@ public:
      */
     std::vector<CompilationPhase> getMeasuredPhases() const;
 
+    /**
+     * @brief Obtiene nombre de una fase
+     */
+    std::string getPhaseName(CompilationPhase phase) const;
+
     /**
      * @brief Genera reporte de tiempos
      */
@@ -235,10 +319,154 @@ public:
      */
     CompilationPhase getMostMemoryIntensivePhase() const;
 
+    // ========================================================================
+    // Traza por hilo
+    // ========================================================================
+
+    /**
+     * @brief Activa la traza y descarta la anterior
+     * @param eventsPerThread Capacidad del buffer de cada hilo (se redondea a
+     *        potencia de dos); al llenarse se sobrescriben los más antiguos
+     *
+     * Libera los buffers anteriores: no debe llamarse, ni tampoco reset(),
+     * mientras otro hilo tenga ámbitos abiertos.
+     */
+    void enableTrace(size_t eventsPerThread = DefaultTraceCapacity);
+
+    void disableTrace() { tracing_.store(false, std::memory_order_relaxed); }
+
+    bool isTracing() const { return tracing_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Añade un evento al buffer del hilo actual
+     */
+    void recordTraceEvent(CompilationPhase phase, uint64_t begin, uint64_t end,
+                          std::string detail = {});
+
+    /**
+     * @brief Eventos del hilo index en orden de inicio (para tests y volcados)
+     */
+    std::vector<TraceEvent> getTraceEvents(size_t threadIndex) const;
+
+    size_t getTraceThreadCount() const;
+
+    /**
+     * @brief Eventos sobrescritos por buffers llenos
+     */
+    uint64_t getDroppedTraceEvents() const;
+
+    /**
+     * @brief Traza en formato trace_event de Chrome (JSON)
+     *
+     * Debe llamarse cuando los hilos medidos ya no registran eventos.
+     */
+    std::string generateChromeTrace() const;
+
+    bool writeChromeTrace(const std::filesystem::path& path) const;
+
+    // ========================================================================
+    // Coste por entidad
+    // ========================================================================
+
+    /**
+     * @brief Acumula tiempo y memoria por entidad (el details de cada AutoTimer)
+     */
+    void setEntityTracking(bool enabled) { trackingEntities_.store(enabled, std::memory_order_relaxed); }
+
+    bool isTrackingEntities() const { return trackingEntities_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Suma un uso de la entidad en la tabla del hilo actual, sin locks
+     * @param totalTicks Ticks de now() del ámbito completo
+     * @param selfTicks Los mismos sin los ámbitos anidados
+     */
+    void recordEntity(CompilationPhase phase, std::string_view name, uint64_t totalTicks,
+                      uint64_t selfTicks, size_t memory = 0);
+
+    /**
+     * @brief Entidades de una fase ordenadas por tiempo total, de todos los hilos
+     *
+     * Como la traza, debe consultarse cuando los hilos medidos ya terminaron.
+     */
+    std::vector<EntityStats> getTopEntities(CompilationPhase phase, size_t limit) const;
+
+    /**
+     * @brief Las limit entidades más caras de cada fase (-ftime-report=entities)
+     */
+    std::string generateEntityReport(size_t limit = DefaultEntityReportSize) const;
+
+    /**
+     * @brief Memoria y pico de cada fase medida (-fmemory-report)
+     */
+    std::string generatePhaseMemoryReport() const;
+
+    /**
+     * @brief Marca de tiempo de la traza (TSC o nanosegundos)
+     */
+    static uint64_t now();
+
+    /**
+     * @brief Ticks de now() por microsegundo, medidos desde la creación o enableTrace()
+     */
+    double ticksPerMicrosecond() const;
+
+    /**
+     * @brief Profiler que instrumenta código sin acceso al driver
+     *
+     * Por ejemplo la instanciación de plantillas. nullptr = sin medir.
+     */
+    static TimingProfiler* active() { return active_.load(std::memory_order_acquire); }
+    static void setActive(TimingProfiler* profiler) { active_.store(profiler, std::memory_order_release); }
+
+    static constexpr size_t DefaultTraceCapacity = 1 << 14;
+    static constexpr size_t DefaultEntityReportSize = 10;
+
 private:
+    struct EntityTotals {
+        size_t count = 0;
+        uint64_t totalTicks = 0;
+        uint64_t selfTicks = 0;
+        size_t memory = 0;
+    };
+
+    // Búsqueda por string_view sin construir la clave
+    struct NameHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const { return std::hash<std::string_view>()(name); }
+    };
+
+    using EntityTable = std::unordered_map<std::string, EntityTotals, NameHash, std::equal_to<>>;
+
+    /**
+     * @brief Estado de un hilo: un solo escritor
+     *
+     * events es el buffer circular de la traza (vacío sin enableTrace()) y
+     * entities la tabla de coste por entidad y fase.
+     */
+    struct ThreadTrace {
+        std::vector<TraceEvent> events;
+        std::atomic<uint64_t> written{0};
+        uint32_t index = 0;
+        std::unordered_map<CompilationPhase, EntityTable> entities;
+    };
+
     bool enabled_;
     mutable std::mutex mutex_;
 
+    // Traza: generation_ es único entre profilers y cambia con enableTrace()
+    // y reset(), lo que invalida el buffer cacheado por cada hilo
+    std::atomic<bool> tracing_{false};
+    std::atomic<bool> trackingEntities_{false};
+    std::atomic<uint64_t> generation_{0};
+    size_t traceCapacity_ = DefaultTraceCapacity;
+    uint64_t traceStartTicks_ = 0;
+    std::chrono::steady_clock::time_point traceStartTime_;
+    std::unordered_map<std::thread::id, std::unique_ptr<ThreadTrace>> threadTraces_;
+
+    static std::atomic<TimingProfiler*> active_;
+
+    ThreadTrace& currentThreadTrace();
+
     // Timing actual por fase
     std::unordered_map<CompilationPhase, std::chrono::steady_clock::time_point> activeTimers_;
     std::unordered_map<CompilationPhase, std::string> activeDetails_;
@@ -259,10 +487,13 @@ private:
      */
     void initializePhaseNames();
 
-    /**
-     * @brief Obtiene nombre de una fase
-     */
-    std::string getPhaseName(CompilationPhase phase) const;
+    // Variantes que esperan mutex_ ya tomado
+    void recordPhaseTimingLocked(CompilationPhase phase, std::chrono::microseconds duration,
+                                 size_t memoryUsed, size_t operations, const std::string& details,
+                                 size_t peakMemory = 0);
+    std::chrono::microseconds totalCompilationTimeLocked() const;
+    CompilationPhase slowestPhaseLocked() const;
+    CompilationPhase mostMemoryIntensivePhaseLocked() const;
 
     /**
      * @brief Formatea duración como string
@@ -332,6 +563,11 @@ public:
      */
     static size_t getMemoryDelta();
 
+    /**
+     * @brief Pico del proceso y contadores de MemoryTracker por subsistema
+     */
+    static std::string generateSubsystemReport();
+
 private:
     static size_t lastCheckpoint_;
 };
@@ -374,6 +610,16 @@ public:
      */
     std::string exportToJSON() const;
 
+    /**
+     * @brief Añade el tiempo total de cada fase medida como "phase.<fase>.us"
+     */
+    void recordPhaseTimes();
+
+    /**
+     * @brief Registro para TelemetrySink: cada métrica con la suma de sus valores
+     */
+    TelemetryRecord toRecord(const std::string& unit, const std::string& compilerVersion) const;
+
 private:
     TimingProfiler& profiler_;
     std::vector<std::pair<std::string, std::string>> events_;
@@ -5,6 +5,7 @@
 #include <vector>
 #include <memory>
 #include <format>
+#include <functional>
 
 namespace cpp20::compiler::diagnostics {
 
@@ -83,11 +84,26 @@ enum class DiagnosticCode {
     NOTE_TYPE_CONVERSION = 7002
 };
 
+/**
+ * @brief Referencia a un tipo por su id, sin nombre ya formateado
+ */
+struct TypeRef {
+    uint32_t id = 0;
+};
+
+/**
+ * @brief Referencia a una declaración por su id, sin nombre ya formateado
+ */
+struct DeclRef {
+    uint32_t id = 0;
+};
+
 /**
  * @brief Argumento de formato para diagnósticos
  *
  * Los diagnósticos pueden incluir argumentos que se formatean
- * en el mensaje final.
+ * en el mensaje final. Tipos y declaraciones se guardan como id: su
+ * nombre solo se construye si el diagnóstico llega a mostrarse.
  */
 class DiagnosticArgument {
 public:
@@ -102,10 +118,15 @@ public:
     };
 
     DiagnosticArgument(std::string value) : type_(Type::String), stringValue_(std::move(value)) {}
+    DiagnosticArgument(const char* value) : type_(Type::String), stringValue_(value) {}
     DiagnosticArgument(int64_t value) : type_(Type::Integer), intValue_(value) {}
+    DiagnosticArgument(int value) : type_(Type::Integer), intValue_(value) {}
     DiagnosticArgument(uint64_t value) : type_(Type::Unsigned), uintValue_(value) {}
+    DiagnosticArgument(uint32_t value) : type_(Type::Unsigned), uintValue_(value) {}
     DiagnosticArgument(SourceLocation loc) : type_(Type::Location), locationValue_(loc) {}
     DiagnosticArgument(SourceRange range) : type_(Type::Range), rangeValue_(range) {}
+    DiagnosticArgument(TypeRef type) : type_(Type::Type), uintValue_(type.id) {}
+    DiagnosticArgument(DeclRef decl) : type_(Type::Symbol), uintValue_(decl.id) {}
 
     Type type() const { return type_; }
 
@@ -114,6 +135,8 @@ public:
     uint64_t asUnsigned() const { return uintValue_; }
     const SourceLocation& asLocation() const { return locationValue_; }
     const SourceRange& asRange() const { return rangeValue_; }
+    uint32_t asTypeId() const { return static_cast<uint32_t>(uintValue_); }
+    uint32_t asDeclId() const { return static_cast<uint32_t>(uintValue_); }
 
 private:
     Type type_;
@@ -124,6 +147,14 @@ private:
     SourceRange rangeValue_;
 };
 
+/**
+ * @brief Nombre de un tipo o una declaración a partir de su id
+ *
+ * Lo aporta la fase que conoce los ids (el analizador semántico) y se usa
+ * solo al mostrar el diagnóstico. Recibe Type::Type o Type::Symbol.
+ */
+using DiagnosticNameResolver = std::function<std::string(DiagnosticArgument::Type kind, uint32_t id)>;
+
 /**
  * @brief Representa un diagnóstico completo del compilador
  *
@@ -165,7 +196,14 @@ public:
         return level_ == DiagnosticLevel::Note;
     }
 
-    std::string formatMessage() const;
+    /**
+     * @brief Mensaje final: sustituye %0, %1... por los argumentos
+     *
+     * message() es la plantilla tal como se emitió; el formateo se hace
+     * aquí, al mostrar el diagnóstico. "%%" es un % literal. Sin resolver,
+     * tipos y declaraciones se muestran como "type#id" y "decl#id".
+     */
+    std::string formatMessage(const DiagnosticNameResolver& resolver = {}) const;
     DiagnosticCategory category() const;
 
     // Factory methods para diagnósticos comunes
@@ -2,13 +2,22 @@
 
 #include "Diagnostic.h"
 #include "SourceManager.h"
+#include <atomic>
+#include <bitset>
+#include <condition_variable>
+#include <deque>
 #include <memory>
 #include <vector>
 #include <functional>
 #include <mutex>
+#include <ostream>
+#include <string_view>
+#include <thread>
 
 namespace cpp20::compiler::diagnostics {
 
+class DiagnosticTrap;
+
 /**
  * @brief Motor principal del sistema de diagnósticos
  *
@@ -18,6 +27,11 @@ namespace cpp20::compiler::diagnostics {
  * - Mantener estadísticas de diagnósticos
  * - Gestionar el flujo de diagnóstico (errores fatales detienen compilación)
  * - Proporcionar interfaces para diagnostic consumers
+ *
+ * Los contadores son atómicos: shouldContinue() se puede consultar desde
+ * cualquier hilo sin bloquear. Con Options::parallel, emit solo añade el
+ * diagnóstico al buffer del hilo que lo emite; flush() los junta en un
+ * orden determinista y un hilo de fondo se los pasa a los consumers.
  */
 class DiagnosticEngine {
 public:
@@ -56,6 +70,8 @@ public:
         int maxErrors = 100;                // Máximo número de errores antes de detener
         bool fatalErrors = false;           // Tratar errores como fatales
         std::string outputFile;             // Archivo de salida (vacío = stderr)
+        bool parallel = false;              // Buffers por hilo y render en segundo plano (flush)
+        bool suppressSystemHeaderWarnings = true;  // Advertencias y notas en headers de sistema
     };
 
     // Constructor y destructor
@@ -65,36 +81,118 @@ public:
     // Configuración
     void setOptions(const Options& options) { options_ = options; }
     const Options& options() const { return options_; }
+    const std::shared_ptr<SourceManager>& sourceManager() const { return sourceManager_; }
 
     // Gestión de consumers
     void addConsumer(std::unique_ptr<Consumer> consumer);
     void clearConsumers();
 
+    // Filtrado
+    void disableWarning(DiagnosticCode code) { disabledCodes_.set(codeIndex(code)); }   // -Wno-*
+    void enableWarning(DiagnosticCode code) { disabledCodes_.reset(codeIndex(code)); }
+
+    /**
+     * @brief Marca un archivo como header de sistema (incluido con <...> desde una ruta de sistema)
+     *
+     * Se llama al abrir el archivo, antes de las fases paralelas.
+     */
+    void markSystemHeader(uint32_t fileId);
+
+    /**
+     * @brief Si un diagnóstico así llegaría a emitirse
+     *
+     * Solo mira las opciones, los códigos desactivados y si la ubicación
+     * está en un header de sistema: no toca el SourceManager ni reserva
+     * memoria, así que se puede consultar antes de construir nada.
+     */
+    bool isEnabled(DiagnosticLevel level, DiagnosticCode code, SourceLocation location) const {
+        if (level == DiagnosticLevel::Error || level == DiagnosticLevel::Fatal) return true;
+        if (level == DiagnosticLevel::Warning ? !options_.showWarnings : !options_.showNotes) return false;
+        if (disabledCodes_.test(codeIndex(code))) return false;
+        uint32_t fileId = location.fileId();
+        return !options_.suppressSystemHeaderWarnings || fileId >= systemFiles_.size() || !systemFiles_[fileId];
+    }
+
+    /**
+     * @brief Nombres de tipos y declaraciones para formatear los argumentos
+     */
+    void setNameResolver(DiagnosticNameResolver resolver) { nameResolver_ = std::move(resolver); }
+    const DiagnosticNameResolver& nameResolver() const { return nameResolver_; }
+
     // Emisión de diagnósticos
     void emit(const Diagnostic& diagnostic);
     void emit(DiagnosticLevel level, DiagnosticCode code,
               SourceLocation location, std::string message);
 
+    /**
+     * @brief Entrega lo acumulado en los buffers de los hilos (Options::parallel)
+     *
+     * Junta los buffers de todos los hilos y los ordena por ubicación
+     * (archivo, línea, columna, y después nivel, código y mensaje), así
+     * que la salida no depende del reparto del trabajo entre hilos. Cada
+     * nota va pegada al diagnóstico que la precedió en su hilo. Se llama al
+     * terminar cada fase paralela, cuando sus hilos ya no emiten; el
+     * destructor hace el último.
+     */
+    void flush();
+
+    /**
+     * @brief Espera a que los consumers hayan recibido todo lo entregado con flush
+     */
+    void waitRendered();
+
     // Métodos convenientes para tipos comunes de diagnóstico
     void reportError(DiagnosticCode code, SourceLocation loc, std::string msg);
     void reportWarning(DiagnosticCode code, SourceLocation loc, std::string msg);
     void reportNote(DiagnosticCode code, SourceLocation loc, std::string msg);
     void reportFatal(DiagnosticCode code, SourceLocation loc, std::string msg);
 
-    // Estadísticas
-    size_t errorCount() const { return errorCount_; }
-    size_t warningCount() const { return warningCount_; }
-    size_t noteCount() const { return noteCount_; }
-    size_t totalCount() const { return errorCount_ + warningCount_ + noteCount_; }
+    /**
+     * @brief Emite un diagnóstico con plantilla y argumentos tipados
+     *
+     * Si el diagnóstico está desactivado vuelve sin construir el Diagnostic
+     * ni sus argumentos. El mensaje se formatea al mostrarse (ver
+     * Diagnostic::formatMessage); los tipos y declaraciones se pasan como
+     * TypeRef y DeclRef para no construir su nombre por adelantado.
+     *
+     * @code
+     * engine.report(DiagnosticLevel::Warning, DiagnosticCode::WARN_IMPLICIT_CONVERSION, loc,
+     *               "conversión implícita de %0 a %1", TypeRef{from}, TypeRef{to});
+     * @endcode
+     */
+    template <typename... Args>
+    void report(DiagnosticLevel level, DiagnosticCode code, SourceLocation loc,
+                const char* format, Args&&... args) {
+        if ((activeTrap_ && trapDiagnostic(level, code, loc)) || !isEnabled(level, code, loc)) {
+            return;
+        }
+        Diagnostic diagnostic(level, code, loc, format);
+        (diagnostic.addArgument(DiagnosticArgument(std::forward<Args>(args))), ...);
+        emit(diagnostic);
+    }
 
-    bool hasErrors() const { return errorCount_ > 0; }
-    bool hasFatalErrors() const { return fatalCount_ > 0; }
+    /**
+     * @brief Advertencia con plantilla; los literales sin argumentos también pasan por aquí
+     */
+    template <typename... Args>
+    void reportWarning(DiagnosticCode code, SourceLocation loc, const char* format, Args&&... args) {
+        report(DiagnosticLevel::Warning, code, loc, format, std::forward<Args>(args)...);
+    }
+
+    // Estadísticas (incluyen lo que aún está en los buffers de los hilos)
+    size_t errorCount() const { return errorCount_.load(std::memory_order_relaxed); }
+    size_t warningCount() const { return warningCount_.load(std::memory_order_relaxed); }
+    size_t noteCount() const { return noteCount_.load(std::memory_order_relaxed); }
+    size_t totalCount() const { return errorCount() + warningCount() + noteCount(); }
+
+    bool hasErrors() const { return errorCount() > 0; }
+    bool hasFatalErrors() const { return fatalCount_.load(std::memory_order_relaxed) > 0; }
 
     // Control de flujo
     void setErrorLimit(size_t limit) { options_.maxErrors = static_cast<int>(limit); }
-    bool shouldContinue() const { return errorCount_ < static_cast<size_t>(options_.maxErrors); }
+    bool shouldContinue() const { return errorCount() < static_cast<size_t>(options_.maxErrors); }
 
-    // Historial de diagnósticos
+    // Historial de diagnósticos (con Options::parallel, lo entregado con flush)
     const std::vector<Diagnostic>& diagnostics() const { return diagnostics_; }
     void clearDiagnostics();
 
@@ -108,24 +206,101 @@ public:
     }
 
 private:
+    friend class DiagnosticTrap;
+    struct ThreadBuffer;
+
+    // Trampa más interna del hilo (en cualquier motor); ver DiagnosticTrap
+    static inline thread_local DiagnosticTrap* activeTrap_ = nullptr;
+
+    /**
+     * @brief Anotar el diagnóstico en la trampa de este motor, si la hay
+     * @return true si se capturó y no hay que construirlo
+     */
+    bool trapDiagnostic(DiagnosticLevel level, DiagnosticCode code, SourceLocation location) const;
+
     // Miembros privados
     std::shared_ptr<SourceManager> sourceManager_;
     Options options_;
     std::vector<std::unique_ptr<Consumer>> consumers_;
     std::vector<Diagnostic> diagnostics_;
-    std::mutex mutex_;  // Para thread-safety
+    std::mutex mutex_;  // consumers_ y diagnostics_
+
+    // Filtrado (los códigos van de 1000 a 7999)
+    static constexpr size_t MaxDiagnosticCode = 8000;
+    static size_t codeIndex(DiagnosticCode code) {
+        return static_cast<size_t>(code) % MaxDiagnosticCode;
+    }
+    std::bitset<MaxDiagnosticCode> disabledCodes_;
+    std::vector<bool> systemFiles_;     // Indexado por fileId
+    DiagnosticNameResolver nameResolver_;
 
     // Contadores
-    size_t errorCount_ = 0;
-    size_t warningCount_ = 0;
-    size_t noteCount_ = 0;
-    size_t fatalCount_ = 0;
+    std::atomic<size_t> errorCount_{0};
+    std::atomic<size_t> warningCount_{0};
+    std::atomic<size_t> noteCount_{0};
+    std::atomic<size_t> fatalCount_{0};
+
+    // Buffers por hilo (Options::parallel)
+    uint64_t id_;                                       // Clave del motor en la caché de cada hilo
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+    std::mutex buffersMutex_;
+
+    // Hilo de render: recibe lotes ya ordenados de flush
+    std::thread renderThread_;
+    std::mutex renderMutex_;
+    std::condition_variable renderReady_;
+    std::condition_variable renderIdle_;
+    std::deque<std::vector<Diagnostic>> renderQueue_;
+    bool rendering_ = false;
+    bool stopRendering_ = false;
 
     // Métodos internos
-    void processDiagnostic(const Diagnostic& diagnostic);
     void emitToConsumers(const Diagnostic& diagnostic);
-    void updateStatistics(const Diagnostic& diagnostic);
+    bool updateStatistics(const Diagnostic& diagnostic);
     bool shouldEmit(const Diagnostic& diagnostic) const;
+    ThreadBuffer& threadBuffer();
+    void renderLoop();
+};
+
+/**
+ * @brief Captura los diagnósticos de un intento descartable (sustitución SFINAE)
+ *
+ * Mientras viva, lo que el hilo que la creó emita en ese motor no se
+ * construye, ni cuenta, ni llega a los consumers: solo se anota el nivel
+ * y el primer error. Se pueden anidar; captura la más interna del motor.
+ * Los mensajes que el llamador ya formateó como std::string sí se
+ * construyen: en el camino caliente conviene report() con plantilla.
+ */
+class DiagnosticTrap {
+public:
+    explicit DiagnosticTrap(DiagnosticEngine& engine)
+        : engine_(engine), previous_(DiagnosticEngine::activeTrap_) {
+        DiagnosticEngine::activeTrap_ = this;
+    }
+
+    ~DiagnosticTrap() { DiagnosticEngine::activeTrap_ = previous_; }
+
+    DiagnosticTrap(const DiagnosticTrap&) = delete;
+    DiagnosticTrap& operator=(const DiagnosticTrap&) = delete;
+
+    bool hasErrors() const { return errors_ > 0; }
+    size_t trappedCount() const { return trapped_; }
+
+    /**
+     * @brief Código y ubicación del primer error capturado (válidos si hasErrors())
+     */
+    DiagnosticCode firstErrorCode() const { return firstErrorCode_; }
+    const SourceLocation& firstErrorLocation() const { return firstErrorLocation_; }
+
+private:
+    friend class DiagnosticEngine;
+
+    DiagnosticEngine& engine_;
+    DiagnosticTrap* previous_;
+    size_t trapped_ = 0;
+    size_t errors_ = 0;
+    DiagnosticCode firstErrorCode_{};
+    SourceLocation firstErrorLocation_;
 };
 
 /**
@@ -138,12 +313,54 @@ public:
     bool handleDiagnostic(const Diagnostic& diagnostic) override;
     void finish() override;
 
+    void setNameResolver(DiagnosticNameResolver resolver) { nameResolver_ = std::move(resolver); }
+
 private:
     std::ostream& stream_;
     bool useColors_;
+    DiagnosticNameResolver nameResolver_;
     std::string formatWithColor(const std::string& text, const std::string& color) const;
 };
 
+/**
+ * @brief Consumer que escribe un log SARIF 2.1.0 a medida que llegan los diagnósticos
+ *
+ * Cada diagnóstico se escribe en el stream en cuanto se recibe, escapando
+ * el texto carácter a carácter sobre el stream: no se construye el
+ * documento en memoria ni una cadena por diagnóstico, así que el coste es
+ * lineal y la memoria constante aunque haya cientos de miles. Las notas
+ * van como resultados de nivel "note". finish() (o el destructor) cierra
+ * el documento.
+ */
+class SarifConsumer : public DiagnosticEngine::Consumer {
+public:
+    /**
+     * @param sourceManager Para el URI del archivo y el fragmento de línea (puede ser nulo)
+     * @param includeSnippets Añadir la línea de código a cada región
+     */
+    SarifConsumer(std::ostream& stream, std::shared_ptr<SourceManager> sourceManager,
+                  bool includeSnippets = true);
+    ~SarifConsumer() override;
+
+    bool handleDiagnostic(const Diagnostic& diagnostic) override;
+    void finish() override;
+
+    void setNameResolver(DiagnosticNameResolver resolver) { nameResolver_ = std::move(resolver); }
+    size_t resultCount() const { return resultCount_; }
+
+private:
+    std::ostream& stream_;
+    std::shared_ptr<SourceManager> sourceManager_;
+    bool includeSnippets_;
+    DiagnosticNameResolver nameResolver_;
+    size_t resultCount_ = 0;
+    bool open_ = false;
+    bool closed_ = false;
+
+    void open();
+    void writeString(std::string_view text);
+};
+
 /**
  * @brief Consumer que acumula diagnósticos en memoria
  */
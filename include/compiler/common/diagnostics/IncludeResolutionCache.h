@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cpp20::compiler::diagnostics {
+
+/**
+ * @brief Caché persistente de resolución de #include entre invocaciones
+ *
+ * Cada entrada se indexa por (hash de la lista de rutas de búsqueda,
+ * nombre del include, <> o "") y guarda la ruta resuelta (o que no se
+ * encontró) junto con el mtime de cada directorio sondeado hasta dar con
+ * ella. Crear o borrar un archivo cambia el mtime de su directorio, así que
+ * la entrada es válida mientras esos mtimes coincidan. Cada directorio se
+ * consulta una sola vez por proceso, de modo que una resolución con caché
+ * caliente no cuesta ningún stat adicional.
+ *
+ * Thread-safe: los workers de -j resuelven includes en paralelo.
+ */
+class IncludeResolutionCache {
+public:
+    /// Resultado de lookup(): nullopt = sin entrada válida; path vacío = no existe
+    using Resolution = std::optional<std::filesystem::path>;
+
+    /**
+     * @brief Constructor
+     * @param cacheFile Archivo de persistencia (vacío = solo en memoria)
+     */
+    explicit IncludeResolutionCache(std::filesystem::path cacheFile = {});
+
+    /**
+     * @brief Cargar las entradas persistidas (un archivo ausente o corrupto deja la caché vacía)
+     */
+    bool load();
+
+    /**
+     * @brief Persistir la caché si cambió (escritura atómica vía archivo temporal)
+     */
+    bool save() const;
+
+    /**
+     * @brief Buscar una resolución previa todavía válida
+     */
+    Resolution lookup(uint64_t searchPathHash, const std::string& includeName, bool isAngled);
+
+    /**
+     * @brief Registrar una resolución
+     * @param resolvedPath Ruta encontrada (vacía si el include no existe)
+     * @param probedDirectories Directorios consultados, en orden, hasta el resultado
+     */
+    void store(uint64_t searchPathHash, const std::string& includeName, bool isAngled,
+               const std::filesystem::path& resolvedPath,
+               const std::vector<std::filesystem::path>& probedDirectories);
+
+    /**
+     * @brief Rutas encontradas con ese conjunto de rutas de búsqueda, sin validarlas
+     *
+     * Sirve como lista de archivos a precargar: lo que ya no exista falla al leerse.
+     */
+    std::vector<std::filesystem::path> resolvedPaths(uint64_t searchPathHash) const;
+
+    size_t size() const;
+    size_t hitCount() const { return hits_; }
+    size_t missCount() const { return misses_; }
+    const std::filesystem::path& cacheFile() const { return cacheFile_; }
+
+private:
+    /// mtime de un directorio inexistente
+    static constexpr int64_t kMissingDirectory = INT64_MIN;
+
+    struct ProbedDirectory {
+        std::string path;
+        int64_t mtime;
+    };
+
+    struct Entry {
+        std::string resolvedPath;                 // "" = no encontrado
+        std::vector<ProbedDirectory> directories;
+    };
+
+    std::filesystem::path cacheFile_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::unordered_map<std::string, int64_t> directoryTimes_; // stat por proceso
+    mutable std::mutex mutex_;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    bool dirty_ = false;
+
+    static std::string makeKey(uint64_t searchPathHash, const std::string& includeName, bool isAngled);
+    int64_t directoryTime(const std::string& directory);
+};
+
+} // namespace cpp20::compiler::diagnostics
@@ -76,6 +76,48 @@ private:
     uint32_t fileId_ = 0;   // ID del archivo en el SourceManager
 };
 
+/**
+ * @brief Ubicación de 32 bits en el espacio de direcciones del SourceManager
+ *
+ * Cada archivo cargado ocupa un tramo [base, base + tamaño] del espacio y
+ * la ubicación es base + offset: 4 bytes frente a los 16 de
+ * SourceLocation, que es lo que conviene guardar en tokens y nodos. La
+ * línea y la columna se calculan solo al pedirlas, con
+ * SourceManager::getSourceLocation. Con el bit alto activo la ubicación
+ * cae en una expansión de macro (SourceManager::createExpansionLocation).
+ * 0 es la ubicación inválida.
+ */
+class CompactSourceLocation {
+public:
+    static constexpr uint32_t MacroBit = 1u << 31;
+
+    constexpr CompactSourceLocation() noexcept = default;
+
+    static constexpr CompactSourceLocation fromRaw(uint32_t raw) noexcept {
+        CompactSourceLocation location;
+        location.raw_ = raw;
+        return location;
+    }
+
+    constexpr uint32_t raw() const noexcept { return raw_; }
+
+    constexpr bool isValid() const noexcept { return raw_ != 0; }
+    constexpr bool isFileLocation() const noexcept { return isValid() && (raw_ & MacroBit) == 0; }
+    constexpr bool isMacroLocation() const noexcept { return (raw_ & MacroBit) != 0; }
+
+    // Desplazamiento dentro del mismo archivo o expansión
+    constexpr CompactSourceLocation operator+(uint32_t offset) const noexcept {
+        return fromRaw(raw_ + offset);
+    }
+
+    constexpr auto operator<=>(const CompactSourceLocation&) const noexcept = default;
+
+private:
+    uint32_t raw_ = 0;
+};
+
+static_assert(sizeof(CompactSourceLocation) == 4, "CompactSourceLocation debe ocupar 4 bytes");
+
 /**
  * @brief Representa un rango de código fuente
  *
@@ -1,7 +1,15 @@
 #pragma once
 
 #include "SourceLocation.h"
+#include "IncludeResolutionCache.h"
+#include <compiler/common/utils/FileUtils.h>
+#include <compiler/common/utils/MappedFile.h>
+#include <compiler/common/utils/ThreadPool.h>
+#include <atomic>
+#include <condition_variable>
 #include <string>
+#include <string_view>
+#include <mutex>
 #include <vector>
 #include <memory>
 #include <unordered_map>
@@ -28,19 +36,30 @@ enum class Encoding {
 
 /**
  * @brief Información sobre un archivo fuente con soporte completo para C++20
+ *
+ * El contenido puede estar en memoria propia (rawContent / normalizedContent)
+ * o, para archivos grandes, ser una vista de solo lectura de una proyección
+ * en memoria. text() devuelve siempre el contenido normalizado sin copiarlo.
+ * Los offsets de línea se calculan la primera vez que se necesitan.
+ *
+ * Un alias es la entrada de otra ruta al mismo archivo (enlace simbólico,
+ * "..", otra copia idéntica): tiene ID, ruta y ubicaciones propias pero
+ * comparte el texto y los offsets de línea del archivo canónico.
  */
 struct SourceFile {
     uint32_t id;                           // ID único del archivo
+    uint32_t canonicalId;                  // Archivo dueño del contenido (== id si no es alias)
     std::filesystem::path path;           // Ruta completa del archivo
-    std::string rawContent;               // Contenido raw sin procesar
-    std::string normalizedContent;        // Contenido normalizado (UTF-8, \n)
-    std::vector<uint32_t> lineOffsets;    // Offsets de inicio de cada línea
+    std::string rawContent;               // Contenido raw (vacío si está proyectado)
+    std::string normalizedContent;        // Contenido normalizado si difiere del raw
+    std::shared_ptr<const common::utils::MappedFile> mapping; // Proyección (opcional)
     std::string displayName;              // Nombre para mostrar (puede ser relativo)
     Encoding encoding = Encoding::UNKNOWN; // Codificación detectada
     bool isPreprocessed = false;          // Si el contenido ya está preprocesado
     bool isHeaderUnit = false;           // Si es una unidad de encabezado
     std::filesystem::file_time_type lastModified; // Última modificación
     size_t fileSize = 0;                 // Tamaño del archivo en bytes
+    uint32_t baseOffset = 0;             // Inicio en el espacio de CompactSourceLocation (0 = fuera)
 
     // Mapeos para preprocesador y módulos
     std::unordered_map<uint32_t, SourceLocation> offsetToOriginalLocation; // Para #line
@@ -48,22 +67,45 @@ struct SourceFile {
 
     SourceFile(uint32_t id, std::filesystem::path path, std::string rawContent,
                Encoding encoding = Encoding::UTF8);
+    SourceFile(uint32_t id, std::filesystem::path path,
+               std::shared_ptr<const common::utils::MappedFile> mapping,
+               Encoding encoding = Encoding::UTF8);
+    SourceFile(uint32_t id, std::filesystem::path path, const SourceFile& canonical);   // Alias
+
+    // Acceso al contenido sin copia
+    std::string_view rawText() const;
+    std::string_view text() const { return text_; }
+    bool isMapped() const { return mapping != nullptr; }
+    bool isAlias() const { return canonicalId != id; }
+
+    // Offsets de línea (cálculo diferido, thread-safe)
+    const std::vector<uint32_t>& lineOffsets() const;
 
     // Utilidades
-    uint32_t lineCount() const { return static_cast<uint32_t>(lineOffsets.size()); }
+    uint32_t lineCount() const { return static_cast<uint32_t>(lineOffsets().size()); }
     SourceLocation locationForOffset(uint32_t offset) const;
     uint32_t offsetForLocation(const SourceLocation& location) const;
+    uint32_t lineForOffset(uint32_t offset) const;       // Búsqueda binaria; 0 si está fuera
+    std::string_view lineText(uint32_t lineNumber) const;  // Sin copia ni salto de línea final
     std::string getLine(uint32_t lineNumber) const;
     std::string getText(SourceRange range) const;
-    std::string getNormalizedContent() const { return normalizedContent; }
+    std::string getNormalizedContent() const { return std::string(text_); }
 
     // Función estática auxiliar para calcular offsets de línea
-    static std::vector<uint32_t> computeLineOffsets(const std::string& content);
+    static std::vector<uint32_t> computeLineOffsets(std::string_view content);
 
     // Soporte para mapeos de preprocesador
     void addMacroExpansion(uint32_t offset, const std::string& expansion);
     std::optional<std::string> getMacroExpansion(uint32_t offset) const;
     SourceLocation mapToOriginalLocation(uint32_t offset) const;
+
+private:
+    const SourceFile* canonical_ = nullptr;       // Solo en los alias
+    std::string_view text_;                       // Vista del contenido normalizado
+    mutable std::vector<uint32_t> lineOffsets_;   // Offsets de inicio de cada línea
+    mutable std::once_flag lineOffsetsOnce_;
+
+    void normalize(std::string_view raw);
 };
 
 /**
@@ -75,6 +117,10 @@ struct IncludeCacheEntry {
     std::filesystem::file_time_type lastModified;
     uint32_t fileId = 0;
     bool isValid = true;
+
+    // Optimización de inclusión múltiple (detectada en la primera inclusión)
+    std::string includeGuard;   // Macro del idiom #ifndef/#define/#endif ("" = ninguna)
+    bool pragmaOnce = false;    // El archivo contiene #pragma once
 };
 
 /**
@@ -92,9 +138,28 @@ public:
         const std::string& includeName,
         bool isSystemInclude) const;
 
+    /**
+     * @brief Usar una caché de resolución (persistente entre invocaciones)
+     */
+    void setResolutionCache(std::shared_ptr<IncludeResolutionCache> cache) { cache_ = std::move(cache); }
+
+    /**
+     * @brief Hash de la lista ordenada de rutas (parte de la clave de la caché)
+     */
+    uint64_t pathsHash() const { return pathsHash_; }
+
+    /**
+     * @brief Archivos que la caché de resolución encontró con estas mismas rutas
+     */
+    std::vector<std::filesystem::path> previousResolutions() const;
+
 private:
     std::vector<std::filesystem::path> systemPaths_;
     std::vector<std::filesystem::path> userPaths_;
+    std::shared_ptr<IncludeResolutionCache> cache_;
+    uint64_t pathsHash_ = 0;
+
+    void updatePathsHash();
 };
 
 /**
@@ -136,11 +201,39 @@ public:
                               const std::string& displayName);
 
     /**
-     * @brief Precarga archivos de encabezado comunes
+     * @brief Precarga archivos de encabezado comunes en segundo plano
      * @param paths Lista de rutas de encabezados
      */
     void preloadHeaders(const std::vector<std::filesystem::path>& paths);
 
+    /**
+     * @brief Lee en segundo plano archivos que se van a cargar pronto
+     *
+     * Un hilo de E/S lee (o proyecta y pide con madvise) cada archivo que
+     * aún no esté cargado; loadFile toma después el contenido ya leído y
+     * solo espera si la lectura de ese archivo sigue en curso. Con la lista
+     * de includes del escáner de dependencias o de un build anterior, el
+     * preprocesador no se bloquea en lecturas de disco frío, lo que en
+     * sistemas de archivos de red oculta casi toda la latencia.
+     * @param headerUnits Se cargarán como header units
+     */
+    void prefetchFiles(const std::vector<std::filesystem::path>& paths, bool headerUnits = false);
+
+    /**
+     * @brief Precarga los archivos que resolvió un build anterior con las rutas actuales
+     *
+     * Requiere una caché de resolución (setIncludeResolutionCache).
+     * @return Número de archivos pedidos
+     */
+    size_t prefetchPreviousIncludes();
+
+    /**
+     * @brief Bloquea hasta que terminan las lecturas en segundo plano
+     */
+    void waitForPrefetch();
+
+    size_t prefetchHitCount() const { return prefetchHits_.load(std::memory_order_relaxed); }
+
     // === GESTIÓN DE INCLUDES ===
 
     /**
@@ -160,6 +253,11 @@ public:
      */
     void setIncludeSearchPath(const IncludeSearchPath& searchPath);
 
+    /**
+     * @brief Hash de las rutas de búsqueda configuradas (IncludeSearchPath::pathsHash)
+     */
+    uint64_t includePathsHash() const;
+
     /**
      * @brief Añade una ruta de búsqueda de includes
      * @param path Ruta a añadir
@@ -167,6 +265,24 @@ public:
      */
     void addIncludePath(const std::filesystem::path& path, bool isSystemPath = false);
 
+    /**
+     * @brief Resolver los includes a través de una caché persistente
+     */
+    void setIncludeResolutionCache(std::shared_ptr<IncludeResolutionCache> cache);
+
+    /**
+     * @brief Obtiene la entrada de caché de un include ya resuelto
+     * @return Copia de la entrada (los preprocesadores de -j la consultan en paralelo)
+     */
+    std::optional<IncludeCacheEntry> getIncludeCacheEntry(const std::string& includeName) const;
+
+    /**
+     * @brief Registra la guarda de inclusión o #pragma once de un archivo
+     *
+     * Se aplica a todas las entradas de caché que resuelven a fileId.
+     */
+    void recordMultipleIncludeInfo(uint32_t fileId, const std::string& includeGuard, bool pragmaOnce);
+
     // === ACCESO A ARCHIVOS ===
 
     /**
@@ -223,6 +339,14 @@ public:
      */
     std::string getLine(const SourceLocation& location) const;
 
+    /**
+     * @brief Como getLine, pero sin copiar la línea
+     *
+     * La vista apunta al contenido del archivo y vale mientras viva el
+     * SourceManager. Es lo que usan los consumers que pintan fragmentos.
+     */
+    std::string_view getLineText(const SourceLocation& location) const;
+
     /**
      * @brief Obtiene múltiples líneas alrededor de una ubicación
      * @param location Ubicación central
@@ -251,6 +375,55 @@ public:
     void registerLineMapping(const SourceLocation& currentLocation,
                            const SourceLocation& originalLocation);
 
+    // === UBICACIONES COMPACTAS ===
+
+    /**
+     * @brief Ubicación compacta de un offset de un archivo
+     * @return Ubicación inválida si el archivo no existe o no cupo en el espacio
+     */
+    CompactSourceLocation getCompactLocation(uint32_t fileId, uint32_t offset) const;
+
+    /**
+     * @brief Ubicación compacta equivalente (a partir de fileId, línea y columna)
+     */
+    CompactSourceLocation getCompactLocation(const SourceLocation& location) const;
+
+    /**
+     * @brief Línea, columna y archivo de una ubicación compacta
+     *
+     * Búsqueda binaria del archivo por su base y después de la línea en
+     * sus offsets. Las ubicaciones de macro se resuelven a su punto de
+     * expansión, que es donde el usuario ve el diagnóstico.
+     */
+    SourceLocation getSourceLocation(CompactSourceLocation location) const;
+
+    /**
+     * @brief Archivo de una ubicación compacta de archivo (0 si no es de ninguno)
+     */
+    uint32_t getFileId(CompactSourceLocation location) const;
+
+    /**
+     * @brief Reserva ubicaciones para los tokens de una expansión de macro
+     *
+     * Las ubicaciones [resultado, resultado + length) corresponden al texto
+     * que empieza en spelling (el cuerpo de la macro o un argumento) y se
+     * expandieron en expansion (la invocación). Un registro de 16 bytes por
+     * expansión, en lugar de una ubicación completa por token.
+     */
+    CompactSourceLocation createExpansionLocation(CompactSourceLocation spelling,
+                                                  CompactSourceLocation expansion,
+                                                  uint32_t length);
+
+    /**
+     * @brief Dónde está escrito el texto (sigue las expansiones anidadas)
+     */
+    CompactSourceLocation getSpellingLocation(CompactSourceLocation location) const;
+
+    /**
+     * @brief Dónde se invocó la macro más externa
+     */
+    CompactSourceLocation getExpansionLocation(CompactSourceLocation location) const;
+
     // === GESTIÓN DE HEADER UNITS ===
 
     /**
@@ -267,6 +440,14 @@ public:
      */
     bool isHeaderUnit(uint32_t fileId) const;
 
+    /**
+     * @brief Archivo canónico de un alias; el propio fileId si no lo es
+     *
+     * Dos IDs con el mismo canónico son el mismo archivo: #pragma once y
+     * las guardas de inclusión se comparan por este ID.
+     */
+    uint32_t getCanonicalFileId(uint32_t fileId) const;
+
     // === ESTADÍSTICAS Y GESTIÓN ===
 
     // Estadísticas
@@ -278,7 +459,52 @@ public:
     // Gestión de memoria
     void clearCache();
     void clearIncludeCache();
-    void preloadFiles(const std::vector<std::filesystem::path>& paths);
+    void preloadFiles(const std::vector<std::filesystem::path>& paths);     // Como prefetchFiles
+
+    /**
+     * @brief Olvida la versión cargada de un archivo
+     *
+     * La siguiente loadFile lo vuelve a leer con un ID nuevo. El SourceFile
+     * antiguo se conserva para que los IDs ya repartidos sigan siendo válidos.
+     * @return true si el archivo estaba cargado
+     */
+    bool invalidateFile(const std::filesystem::path& path);
+
+    /**
+     * @brief Invalida los archivos cargados cuya fecha o tamaño cambió en disco
+     * @return Número de archivos invalidados
+     */
+    size_t invalidateChangedFiles();
+
+    /**
+     * @brief Rutas de los archivos cargados actualmente (sin los virtuales)
+     */
+    std::vector<std::filesystem::path> loadedFilePaths() const;
+
+    /**
+     * @brief Activa la carga por proyección en memoria
+     *
+     * Los archivos de al menos kMemoryMapThreshold bytes se proyectan en
+     * lugar de leerse; por debajo del umbral read() es más barato.
+     */
+    void setUseMemoryMapping(bool enable) { useMemoryMapping_ = enable; }
+    bool useMemoryMapping() const { return useMemoryMapping_; }
+
+    /**
+     * @brief Deduplica además por contenido (copias del mismo header en varios SDK)
+     *
+     * Por defecto un archivo se reconoce por su identidad en el sistema de
+     * archivos (dispositivo e inodo, o volumen e índice en Windows). Con
+     * esta opción, un archivo distinto con el mismo contenido también se
+     * carga como alias: se lee para hashearlo, pero no se indexa ni se
+     * detecta su guarda de nuevo.
+     */
+    void setDeduplicateByContent(bool enable) { deduplicateByContent_ = enable; }
+    bool deduplicateByContent() const { return deduplicateByContent_; }
+
+    size_t aliasCount() const { return aliasCount_; }     // Cargas resueltas como alias
+
+    static constexpr size_t kMemoryMapThreshold = 16 * 1024;
 
     // Utilidades
     std::string getDisplayName(uint32_t fileId) const;
@@ -293,22 +519,89 @@ private:
     std::unordered_map<std::string, IncludeCacheEntry> includeCache_;
     IncludeSearchPath includeSearchPath_;
     uint32_t nextFileId_ = 1;  // 0 es inválido
+    bool useMemoryMapping_ = true;
+    bool deduplicateByContent_ = false;
+    size_t aliasCount_ = 0;
+
+    // Archivo canónico por identidad en disco; el stat descarta una versión anterior
+    struct FileIdentity {
+        uint64_t device;
+        uint64_t fileId;
+        bool operator==(const FileIdentity&) const = default;
+    };
+    struct FileIdentityHash {
+        size_t operator()(const FileIdentity& identity) const;
+    };
+    struct CanonicalFile {
+        uint32_t id;
+        common::utils::FileStamp stamp;
+    };
+    std::unordered_map<FileIdentity, CanonicalFile, FileIdentityHash> canonicalByIdentity_;
+    std::unordered_map<std::string, uint32_t> canonicalByContent_;     // hash128 → ID
+
+    // Espacio de CompactSourceLocation: archivos por debajo de MacroBit,
+    // expansiones por encima. Bases crecientes: se buscan por bisección.
+    struct ExpansionRecord {
+        uint32_t base;
+        uint32_t length;
+        CompactSourceLocation spelling;
+        CompactSourceLocation expansion;
+    };
+    uint32_t nextFileBase_ = 1;    // 0 es la ubicación inválida
+    std::vector<ExpansionRecord> expansions_;
+
+    // Protege files_, pathToId_ e includeCache_: las unidades de -j resuelven
+    // includes en paralelo. Recursivo porque findAndLoadInclude llama a loadFile.
+    mutable std::recursive_mutex mutex_;
 
     // Estadísticas de caché
     size_t cacheHits_ = 0;
     size_t cacheMisses_ = 0;
 
+    /**
+     * @brief Contenido leído por el hilo de E/S a la espera de loadFile
+     */
+    struct PrefetchedContent {
+        bool ready = false;
+        bool loaded = false;
+        bool headerUnit = false;
+        std::string content;
+        std::shared_ptr<const common::utils::MappedFile> mapping;
+        Encoding encoding = Encoding::UNKNOWN;
+        std::filesystem::file_time_type lastModified;
+    };
+
+    // El hilo de E/S nunca toma mutex_: loadFile puede esperarle con mutex_ tomado
+    std::mutex prefetchMutex_;
+    std::condition_variable prefetchReady_;
+    std::unordered_map<std::filesystem::path, PrefetchedContent> prefetched_;
+    std::atomic<size_t> prefetchHits_{0};
+    std::atomic<bool> prefetchCancelled_{false};
+
     // Métodos internos
     uint32_t assignFileId();
+    void addFile(std::unique_ptr<SourceFile> file);
+    uint32_t addAlias(const std::filesystem::path& path, const SourceFile& canonical,
+                      const std::string& displayName, bool isHeaderUnit);
+    const SourceFile* fileForCompactOffset(uint32_t raw) const;
+    const ExpansionRecord* findExpansion(CompactSourceLocation location) const;
     std::vector<uint32_t> computeLineOffsets(const std::string& content) const;
     bool loadFileContent(const std::filesystem::path& path, std::string& content,
+                        std::shared_ptr<const common::utils::MappedFile>& mapping,
                         Encoding& encoding, std::filesystem::file_time_type& lastModified) const;
     std::string readFileToString(const std::filesystem::path& path) const;
     std::string decodeContent(const std::string& rawContent, Encoding encoding) const;
-    std::string computeContentHash(const std::string& content) const;
+    std::string computeContentHash(std::string_view content) const;
+    void prefetchOne(const std::filesystem::path& path);
+    bool takePrefetched(const std::filesystem::path& path, std::string& content,
+                        std::shared_ptr<const common::utils::MappedFile>& mapping, Encoding& encoding,
+                        std::filesystem::file_time_type& lastModified, bool& headerUnit);
     bool isCacheValid(const std::filesystem::path& path, const IncludeCacheEntry& entry) const;
     void updateIncludeCache(const std::string& includeName, const std::filesystem::path& resolvedPath,
                            uint32_t fileId);
+
+    // Último miembro: se crea con el primer prefetch y se destruye antes que lo que usan sus trabajos
+    std::unique_ptr<common::utils::ThreadPool> prefetchPool_;
 };
 
 } // namespace cpp20::compiler::diagnostics
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+
+namespace cpp20::compiler::common::utils {
+
+/**
+ * @brief Bloqueo exclusivo entre procesos sobre un archivo de bloqueo
+ *
+ * Usa flock en POSIX y LockFileEx en Windows. El bloqueo es consultivo:
+ * solo excluye a quien también lo pide. Se libera al destruir el objeto o
+ * cuando termina el proceso, así que un compilador que muere no deja la
+ * entrada bloqueada. El archivo de bloqueo no se borra nunca: otro proceso
+ * puede estar esperando sobre ese mismo inodo.
+ */
+class FileLock {
+public:
+    /**
+     * @brief Crea el archivo si hace falta y espera hasta obtener el bloqueo
+     * @return El bloqueo, o nullptr si el archivo no se puede abrir
+     */
+    static std::unique_ptr<FileLock> acquire(const std::filesystem::path& path);
+
+    /**
+     * @brief Como acquire, pero devuelve nullptr en lugar de esperar
+     */
+    static std::unique_ptr<FileLock> tryAcquire(const std::filesystem::path& path);
+
+    ~FileLock();
+
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+
+private:
+    explicit FileLock(void* handle) : handle_(handle) {}
+
+    static std::unique_ptr<FileLock> lock(const std::filesystem::path& path, bool wait);
+
+    void* handle_; // HANDLE en Windows, descriptor en POSIX
+};
+
+} // namespace cpp20::compiler::common::utils
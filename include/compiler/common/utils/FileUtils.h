@@ -1,6 +1,10 @@
 #pragma once
 
+#include <compiler/common/utils/MappedFile.h>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace cpp20::compiler::common::utils {
@@ -19,8 +23,53 @@ std::string getFileName(const std::string& path);
 std::string getFileNameWithoutExtension(const std::string& path);
 std::string getDirectory(const std::string& path);
 
+/**
+ * @brief Contenido de un archivo leído con readFileBuffer
+ *
+ * Proyectado en memoria si el archivo lo permite (sin copiar nada a un
+ * std::string); si no, por ejemplo un archivo vacío, leído a memoria. Se
+ * mueve sin copiar el contenido.
+ */
+class FileBuffer {
+public:
+    FileBuffer() = default;
+    explicit FileBuffer(std::unique_ptr<MappedFile> mapping) : mapping_(std::move(mapping)) {}
+    explicit FileBuffer(std::string content) : content_(std::move(content)) {}
+
+    std::string_view view() const { return mapping_ ? mapping_->view() : std::string_view(content_); }
+    const char* data() const { return view().data(); }
+    size_t size() const { return view().size(); }
+    bool empty() const { return size() == 0; }
+    bool isMapped() const { return mapping_ != nullptr; }
+
+private:
+    std::unique_ptr<MappedFile> mapping_;
+    std::string content_;
+};
+
+/**
+ * @brief Identidad y versión de un archivo según su stat, sin leerlo
+ *
+ * Si coincide con el registrado al derivar algo del archivo (un hash, un
+ * header unit), el contenido se da por igual, como hace el índice de git.
+ * fileId distingue un archivo reemplazado por otro del mismo tamaño y
+ * fecha: inodo en POSIX, índice de archivo en Windows.
+ */
+struct FileStamp {
+    uint64_t size = 0;
+    int64_t modifiedNs = 0;     // Nanosegundos desde la época Unix
+    uint64_t device = 0;
+    uint64_t fileId = 0;
+
+    bool operator==(const FileStamp&) const = default;
+    bool empty() const { return size == 0 && modifiedNs == 0 && fileId == 0; }
+};
+
+bool statFile(const std::string& path, FileStamp& stamp);      // false si no existe o no se puede consultar
+
 // File I/O
 std::string readFile(const std::string& path);
+FileBuffer readFileBuffer(const std::string& path);     // Lanza std::runtime_error como readFile
 void writeFile(const std::string& path, const std::string& content);
 
 // Directory listing
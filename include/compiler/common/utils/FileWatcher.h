@@ -0,0 +1,52 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace cpp20::compiler::common::utils {
+
+/**
+ * @brief Notificación de cambios en directorios vigilados
+ *
+ * En Linux usa inotify con un hilo propio que llama al callback con la
+ * ruta del archivo creado, modificado, movido o borrado. Si el kernel
+ * descarta eventos (cola desbordada) se llama con una ruta vacía: cualquier
+ * archivo pudo cambiar. En otras plataformas isSupported() es false y
+ * quien lo use debe comprobar fechas de modificación por su cuenta.
+ */
+class FileWatcher {
+public:
+    using Callback = std::function<void(const std::filesystem::path&)>;
+
+    explicit FileWatcher(Callback onChange);
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    bool isSupported() const { return inotifyFd_ >= 0; }
+
+    /**
+     * @brief Vigila los archivos de un directorio (no recursivo)
+     * @return true si el directorio no estaba ya vigilado y se añadió
+     */
+    bool watchDirectory(const std::filesystem::path& directory);
+
+private:
+    Callback onChange_;
+    int inotifyFd_ = -1;
+    int wakeFds_[2] = {-1, -1};   // Pipe para despertar al hilo al destruir
+    std::thread thread_;
+    std::mutex mutex_;
+    std::unordered_map<int, std::filesystem::path> directories_;  // descriptor -> directorio
+    std::unordered_set<std::string> watched_;
+
+    void run();
+};
+
+} // namespace cpp20::compiler::common::utils
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <array>
 #include <string>
+#include <string_view>
 #include <cstdint>
 #include <cstddef>
+#include <type_traits>
 
 namespace cpp20::compiler::common::utils {
 
@@ -17,8 +20,119 @@ size_t hashPointer(const void* ptr);
 // Hash combining
 size_t hashCombine(size_t seed, size_t value);
 
-// FNV-1a hashing (fast and good distribution)
-uint32_t fnv1a32(const std::string& str);
-uint64_t fnv1a64(const std::string& str);
+// Mezcla fuerte de 64 bits (finalizador de splitmix64): cada bit de entrada
+// afecta a todos los de salida, útil para ids y punteros con bits bajos fijos
+uint64_t mix64(uint64_t value);
+
+// Combinación dependiente del orden con mezcla completa: hashMix(a, b) != hashMix(b, a)
+uint64_t hashMix(uint64_t seed, uint64_t value);
+
+// FNV-1a hashing (fast and good distribution); seed encadena varios fragmentos
+uint32_t fnv1a32(std::string_view str);
+uint64_t fnv1a64(std::string_view str, uint64_t seed = 14695981039346656037ull);
+
+/**
+ * @brief Hash de 128 bits
+ */
+struct Hash128 {
+    uint64_t low = 0;
+    uint64_t high = 0;
+
+    bool operator==(const Hash128&) const = default;
+
+    std::string toHex() const;      // 32 dígitos, high primero
+};
+
+/**
+ * @brief Hash incremental rápido, no criptográfico, para contenido
+ *
+ * De la familia de wyhash/xxh3: franjas de 32 bytes en dos carriles
+ * independientes, cada uno con una multiplicación de 64x64→128 bits por
+ * cada 16 bytes. Son unos pocos ciclos por franja frente al byte a byte
+ * de FNV, y a diferencia de una versión SIMD no depende del conjunto de
+ * instrucciones. update() acepta los datos en trozos de cualquier tamaño:
+ * el resultado es el mismo que el de hash64/hash128 del total. Estable
+ * entre ejecuciones y máquinas little-endian; no sirve contra un
+ * adversario (para eso, Blake3Hasher).
+ */
+class StreamingHasher {
+public:
+    explicit StreamingHasher(uint64_t seed = 0);
+
+    void update(const void* data, size_t size);
+    void update(std::string_view data) { update(data.data(), data.size()); }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void updateValue(const T& value) {
+        update(&value, sizeof(T));
+    }
+
+    uint64_t digest64() const { return digest128().low; }
+    Hash128 digest128() const;
+
+    static constexpr size_t StripeSize = 32;
+
+private:
+    uint64_t lanes_[2];
+    uint64_t length_ = 0;
+    unsigned char buffer_[StripeSize];
+    size_t buffered_ = 0;
+
+    void consumeStripe(const unsigned char* stripe);
+};
+
+// Hash rápido de un bloque (equivale a un StreamingHasher con un solo update)
+uint64_t hash64(std::string_view data, uint64_t seed = 0);
+Hash128 hash128(std::string_view data, uint64_t seed = 0);
+
+/**
+ * @brief BLAKE3 (hash criptográfico de 256 bits), modo hash sin clave
+ *
+ * Para claves que se comparten entre máquinas (caché remota), donde una
+ * colisión, accidental o provocada, entregaría un artefacto ajeno. Más
+ * lento que StreamingHasher pero sigue siendo rápido: bloques de 64
+ * bytes, fragmentos de 1 KiB y un árbol de valores de encadenamiento en
+ * una pila, como en la implementación de referencia. Incremental.
+ */
+class Blake3Hasher {
+public:
+    static constexpr size_t OutputSize = 32;
+
+    Blake3Hasher();
+
+    void update(const void* data, size_t size);
+    void update(std::string_view data) { update(data.data(), data.size()); }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void updateValue(const T& value) {
+        update(&value, sizeof(T));
+    }
+
+    std::array<uint8_t, OutputSize> digest() const;
+    std::string hexDigest() const;
+
+private:
+    struct ChunkState {
+        uint32_t chainingValue[8];
+        uint64_t chunkCounter = 0;
+        uint8_t block[64] = {};
+        uint8_t blockLength = 0;
+        uint8_t blocksCompressed = 0;
+
+        size_t length() const { return size_t{blocksCompressed} * 64 + blockLength; }
+    };
+
+    ChunkState chunk_;
+    uint32_t stack_[54][8];     // Un valor por nivel del árbol: basta para 2^64 bytes
+    size_t stackSize_ = 0;
+
+    void startChunk(uint64_t counter);
+    void updateChunk(const uint8_t* data, size_t size);
+    void pushChunk(const uint32_t chainingValue[8], uint64_t totalChunks);
+};
+
+std::array<uint8_t, Blake3Hasher::OutputSize> blake3(std::string_view data);
 
 } // namespace cpp20::compiler::common::utils
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+namespace cpp20::compiler::common::utils {
+
+/**
+ * @brief Vista de solo lectura de un archivo proyectado en memoria
+ *
+ * Usa mmap en POSIX y CreateFileMapping/MapViewOfFile en Windows. El
+ * contenido no se copia: las páginas se cargan bajo demanda y se
+ * comparten con la caché del sistema operativo.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Proyecta un archivo completo
+     * @return La vista, o nullptr si el archivo no existe, está vacío o
+     *         el sistema no permite proyectarlo
+     */
+    static std::unique_ptr<MappedFile> open(const std::filesystem::path& path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    std::string_view view() const { return std::string_view(data_, size_); }
+
+    /**
+     * @brief Pide al sistema que lea ya todas las páginas, sin esperar
+     *
+     * madvise(MADV_WILLNEED) en POSIX y PrefetchVirtualMemory en Windows:
+     * la lectura anticipada avanza mientras el llamador hace otra cosa.
+     */
+    void prefetch() const;
+
+private:
+    MappedFile(const char* data, size_t size, void* mappingHandle)
+        : data_(data), size_(size), mappingHandle_(mappingHandle) {}
+
+    const char* data_;
+    size_t size_;
+    [[maybe_unused]] void* mappingHandle_; // HANDLE de la proyección en Windows, sin uso en POSIX
+};
+
+/**
+ * @brief Archivo de salida de tamaño conocido, proyectado en memoria para escribir
+ *
+ * El archivo se crea (o trunca) con su tamaño final y el espacio se
+ * reserva antes de proyectarlo, de modo que un disco lleno falla en
+ * create() y no al escribir en la vista. Distintos hilos pueden escribir
+ * a la vez en rangos disjuntos de data().
+ */
+class MappedOutputFile {
+public:
+    /**
+     * @brief Crea el archivo con size bytes y lo proyecta para escritura
+     * @return La vista, o nullptr si no se puede crear, reservar o proyectar
+     */
+    static std::unique_ptr<MappedOutputFile> create(const std::filesystem::path& path, size_t size);
+
+    ~MappedOutputFile();
+
+    MappedOutputFile(const MappedOutputFile&) = delete;
+    MappedOutputFile& operator=(const MappedOutputFile&) = delete;
+
+    char* data() { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    MappedOutputFile(char* data, size_t size, void* mappingHandle)
+        : data_(data), size_(size), mappingHandle_(mappingHandle) {}
+
+    char* data_;
+    size_t size_;
+    [[maybe_unused]] void* mappingHandle_; // HANDLE de la proyección en Windows, sin uso en POSIX
+};
+
+} // namespace cpp20::compiler::common::utils
@@ -1,18 +1,69 @@
 #pragma once
 
-#include <vector>
+#include <compiler/common/utils/MemoryTracker.h>
+#include <array>
 #include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace cpp20::compiler::common::utils {
 
 /**
- * @brief Pool de memoria para allocations eficientes
+ * @brief Origen de los bloques de un MemoryPool
  *
- * TODO: Implementar pooling real en Capa 4+
- * Por ahora es un wrapper simple sobre malloc/free
+ * Por defecto cada bloque es un malloc suelto. Con reserveBytes > 0 el
+ * pool reserva de una vez una región virtual contigua y reparte los
+ * bloques desde ella; las páginas físicas solo se ocupan al tocarlas. Con
+ * largePages la región se respalda con páginas grandes (MAP_HUGETLB, o THP
+ * con madvise si no hay páginas reservadas; MEM_LARGE_PAGES en Windows),
+ * lo que reduce los fallos de TLB en arenas de varios GB. Con numaNode >= 0
+ * las páginas se piden a ese nodo NUMA. Si el sistema rechaza algo se cae
+ * al siguiente escalón: páginas normales, y después malloc.
+ */
+struct ArenaBacking {
+    size_t reserveBytes = 0;    // Región virtual a reservar (0 = malloc por bloque)
+    bool largePages = false;    // Respaldar la región con páginas grandes
+    int numaNode = -1;          // Nodo NUMA preferido (-1 = política del sistema)
+
+    /**
+     * @brief Nodo NUMA de la CPU en la que corre el hilo actual (0 si no se sabe)
+     */
+    static int currentNumaNode();
+};
+
+/**
+ * @brief Arena de memoria con asignación bump-pointer
+ *
+ * Las asignaciones se sirven avanzando un cursor dentro de bloques de
+ * tamaño fijo. Los bloques liberados con deallocate() de tamaño pequeño
+ * vuelven a listas libres por clase de tamaño; el resto solo se recupera
+ * con reset() o al destruir el pool. reset() rebobina el cursor al primer
+ * bloque sin devolver memoria al sistema, de modo que reutilizar el pool
+ * para la siguiente unidad de traducción no vuelve a llamar a malloc.
+ *
+ * Con MemoryTracker activo, los bloques y las asignaciones grandes se
+ * atribuyen al subsistema del pool: el del hilo al construirlo, o el que
+ * se fije con setSubsystem().
+ *
+ * checkpoint()/rollback() permiten asignar de forma especulativa (un
+ * intento de sustitución SFINAE) y descartarlo moviendo el cursor atrás.
+ *
+ * Con un ArenaBacking los bloques salen de una región reservada (páginas
+ * grandes, nodo NUMA del worker); los que no caben en ella, de malloc.
+ *
+ * No es thread-safe: se espera un pool por hilo / unidad de traducción.
  */
 class MemoryPool {
 public:
+    /// Tamaño máximo servido desde las listas libres
+    static constexpr size_t kMaxSmallSize = 256;
+    /// Granularidad de las clases de tamaño
+    static constexpr size_t kSizeClassGranularity = 16;
+    static constexpr size_t kSizeClassCount = kMaxSmallSize / kSizeClassGranularity;
+
     /**
      * @brief Constructor
      * @param blockSize Tamaño de cada bloque
@@ -20,30 +71,100 @@ public:
      */
     MemoryPool(size_t blockSize = 4096, size_t initialBlocks = 1);
 
+    /**
+     * @brief Constructor con los bloques respaldados por una región reservada
+     */
+    MemoryPool(size_t blockSize, size_t initialBlocks, const ArenaBacking& backing);
+
     /**
      * @brief Destructor
      */
     ~MemoryPool();
 
+    MemoryPool(const MemoryPool&) = delete;
+    MemoryPool& operator=(const MemoryPool&) = delete;
+
     /**
      * @brief Alloca memoria
      * @param size Tamaño a allocar
+     * @param alignment Alineación requerida (potencia de 2)
      * @return Puntero a la memoria allocada
      */
-    void* allocate(size_t size);
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
 
     /**
      * @brief Libera memoria
      * @param ptr Puntero a liberar
-     * @param size Tamaño original (para future pooling)
+     * @param size Tamaño original (selecciona la lista libre)
      */
     void deallocate(void* ptr, size_t size);
 
     /**
-     * @brief Resetea el pool (libera bloques extra)
+     * @brief Construye un objeto dentro del pool
+     *
+     * Si T no es trivialmente destructible su destructor se ejecuta en
+     * reset() o al destruir el pool, en orden inverso de creación.
+     */
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        void* memory = allocate(sizeof(T), alignof(T));
+        T* object = new (memory) T(std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            destructors_.push_back({object, [](void* p) { static_cast<T*>(p)->~T(); }});
+        }
+        return object;
+    }
+
+    /**
+     * @brief Resetea el pool en O(1): rebobina el cursor y vacía las listas libres
+     *
+     * Los bloques se conservan para reutilizarse; solo se liberan las
+     * asignaciones grandes que no caben en un bloque.
      */
     void reset();
 
+    /**
+     * @brief Resetea y devuelve al sistema todos los bloques salvo el primero
+     */
+    void release();
+
+    /**
+     * @brief Posición del pool al abrir una asignación especulativa
+     */
+    struct Checkpoint {
+        size_t blockIndex;
+        size_t used;
+        size_t usedInFullBlocks;
+        size_t destructors;
+        size_t largeBlocks;
+    };
+
+    /**
+     * @brief Abrir una asignación especulativa (se pueden anidar)
+     *
+     * Mientras haya alguna abierta las listas libres no se usan ni se
+     * rellenan: todo lo asignado queda detrás del cursor y deallocate() no
+     * hace nada, así que rollback() no deja huecos reciclables dentro de
+     * memoria descartada. Cada checkpoint se cierra con rollback() o
+     * commit(), en orden inverso de apertura.
+     */
+    Checkpoint checkpoint();
+
+    /**
+     * @brief Descartar lo asignado desde el checkpoint y cerrarlo
+     *
+     * Rebobina el cursor en O(1); solo los destructores y las asignaciones
+     * grandes posteriores al checkpoint cuestan lo que su número.
+     */
+    void rollback(const Checkpoint& checkpoint);
+
+    /**
+     * @brief Conservar lo asignado desde el checkpoint y cerrarlo
+     */
+    void commit(const Checkpoint& checkpoint);
+
+    bool isSpeculating() const { return speculationDepth_ > 0; }
+
     /**
      * @brief Obtiene total de memoria allocada
      */
@@ -54,14 +175,110 @@ public:
      */
     size_t totalUsed() const;
 
+    /**
+     * @brief Atribuye la memoria del pool a otro subsistema, incluida la ya reservada
+     */
+    void setSubsystem(MemorySubsystem subsystem);
+
+    MemorySubsystem subsystem() const { return subsystem_; }
+
+    /**
+     * @brief Bytes de la región reservada (0 si los bloques vienen de malloc)
+     */
+    size_t reservedBytes() const { return regionSize_; }
+
+    /**
+     * @brief Si la región quedó respaldada por páginas grandes
+     */
+    bool usesLargePages() const { return regionLargePages_; }
+
 private:
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    struct LargeBlock {
+        void* memory;
+        size_t size;
+        size_t alignment;
+    };
+
+    struct Destructor {
+        void* object;
+        void (*destroy)(void*);
+    };
+
     size_t blockSize_;
     size_t initialBlocks_;
     std::vector<void*> blocks_;
-    char* currentBlock_;
-    size_t used_;
+    std::vector<LargeBlock> largeBlocks_;
+    std::vector<Destructor> destructors_;
+    std::array<FreeNode*, kSizeClassCount> freeLists_{};
+    size_t currentBlockIndex_ = 0;
+    char* currentBlock_ = nullptr;
+    size_t used_ = 0;             // Bytes usados en el bloque actual
+    size_t usedInFullBlocks_ = 0; // Bytes usados en bloques anteriores
+    size_t largeBytes_ = 0;
+    MemorySubsystem subsystem_;
+    size_t trackedBytes_ = 0;     // Bytes registrados en MemoryTracker
+    size_t speculationDepth_ = 0; // Checkpoints abiertos
+    char* region_ = nullptr;      // Región reservada (ArenaBacking)
+    size_t regionSize_ = 0;
+    size_t regionUsed_ = 0;       // Bytes de la región ya repartidos en bloques
+    bool regionLargePages_ = false;
+    int regionNode_ = -1;
 
+    void initializeBlocks();
     void allocateNewBlock();
+    void freeBlock(void* block);
+    void trackAllocation(size_t bytes);
+    void trackRelease(size_t bytes);
+    void advanceBlock();
+    void runDestructors();
+    void freeLargeBlocks();
+    static size_t sizeClassIndex(size_t size);
+};
+
+/**
+ * @brief Adaptador de allocator STL sobre MemoryPool
+ *
+ * Permite usar contenedores estándar cuya memoria vive en un pool:
+ * @code
+ *   std::vector<int, ArenaAllocator<int>> values{ArenaAllocator<int>(pool)};
+ * @endcode
+ */
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(MemoryPool& pool) noexcept : pool_(&pool) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : pool_(other.pool()) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(pool_->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, size_t count) noexcept {
+        pool_->deallocate(ptr, count * sizeof(T));
+    }
+
+    MemoryPool* pool() const noexcept { return pool_; }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return pool_ == other.pool();
+    }
+
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept {
+        return pool_ != other.pool();
+    }
+
+private:
+    MemoryPool* pool_;
 };
 
 } // namespace cpp20::compiler::common::utils
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace cpp20::compiler::common::utils {
+
+/**
+ * @brief Subsistema al que se atribuye una asignación
+ */
+enum class MemorySubsystem : uint8_t {
+    Other,
+    Sources,    // Contenido de archivos fuente
+    Tokens,     // Lexer, identificadores y preprocesado
+    AST,
+    Types,
+    IR,
+    Backend,    // Generación de código y objetos
+    Caches,     // Cachés de instanciación y de includes
+    BMI,        // Interfaces de módulo
+    Count
+};
+
+/**
+ * @brief Contadores de un subsistema
+ */
+struct MemoryCounters {
+    size_t current = 0;         // Bytes vivos
+    size_t peak = 0;            // Máximo de bytes vivos
+    size_t allocations = 0;     // Asignaciones registradas
+};
+
+/**
+ * @brief Contabilidad de memoria por subsistema (opcional)
+ *
+ * Desactivado no cuesta más que una carga atómica por asignación. Lo
+ * alimentan los MemoryPool (por bloque, no por objeto) y, si el ejecutable
+ * se compila con CPP20_COMPILER_TRACK_ALLOCATIONS, el operator new global.
+ * Cada hilo tiene un subsistema actual que fija MemoryScope; las
+ * asignaciones sin ámbito van a Other.
+ *
+ * Además del pico de cada subsistema se lleva una marca de agua del total
+ * para medir el pico de un intervalo: beginPeakWindow() la rebaja al uso
+ * actual y endPeakWindow() devuelve el máximo alcanzado desde entonces.
+ * Las ventanas se pueden anidar.
+ */
+class MemoryTracker {
+public:
+    static constexpr size_t SubsystemCount = static_cast<size_t>(MemorySubsystem::Count);
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    static void recordAllocation(MemorySubsystem subsystem, size_t bytes);
+
+    /**
+     * @brief Registra la liberación de bytes registrados antes con el mismo subsistema
+     */
+    static void recordRelease(MemorySubsystem subsystem, size_t bytes);
+
+    /**
+     * @brief Subsistema al que se atribuyen las asignaciones de este hilo
+     */
+    static MemorySubsystem current();
+    static void setCurrent(MemorySubsystem subsystem);
+
+    static MemoryCounters counters(MemorySubsystem subsystem);
+    static size_t totalCurrent();
+    static size_t totalPeak();
+
+    /**
+     * @brief Rebaja los picos al uso actual
+     */
+    static void resetPeaks();
+
+    /**
+     * @brief Abre una ventana de pico
+     * @return Marca de agua anterior, que hay que pasar a endPeakWindow()
+     */
+    static size_t beginPeakWindow();
+
+    /**
+     * @brief Cierra la ventana y devuelve el máximo total alcanzado en ella
+     */
+    static size_t endPeakWindow(size_t previous);
+
+    static std::string_view subsystemName(MemorySubsystem subsystem);
+};
+
+/**
+ * @brief Atribuye a un subsistema las asignaciones de este hilo (RAII)
+ */
+class MemoryScope {
+public:
+    explicit MemoryScope(MemorySubsystem subsystem)
+        : previous_(MemoryTracker::current()) {
+        MemoryTracker::setCurrent(subsystem);
+    }
+
+    ~MemoryScope() { MemoryTracker::setCurrent(previous_); }
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemorySubsystem previous_;
+};
+
+} // namespace cpp20::compiler::common::utils
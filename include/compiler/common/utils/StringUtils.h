@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstddef>
+#include <iterator>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <sstream>
 
@@ -8,26 +11,104 @@ namespace cpp20::compiler::common::utils {
 
 /**
  * @brief Utilidades para manipulación de strings
+ *
+ * Las funciones reciben std::string_view: aceptan std::string, literales
+ * y vistas sin copiar la entrada. Las variantes *View devuelven una vista
+ * de la entrada, que debe seguir viva mientras se use el resultado.
  */
 
 // Case conversion
-std::string toLower(const std::string& str);
-std::string toUpper(const std::string& str);
+std::string toLower(std::string_view str);
+std::string toUpper(std::string_view str);
+void toLowerInPlace(std::string& str);
+void toUpperInPlace(std::string& str);
 
 // Trimming
-std::string trim(const std::string& str);
-std::string trimLeft(const std::string& str);
-std::string trimRight(const std::string& str);
+std::string trim(std::string_view str);
+std::string trimLeft(std::string_view str);
+std::string trimRight(std::string_view str);
+std::string_view trimView(std::string_view str);
+std::string_view trimLeftView(std::string_view str);
+std::string_view trimRightView(std::string_view str);
 
 // Prefix/suffix checking
-bool startsWith(const std::string& str, const std::string& prefix);
-bool endsWith(const std::string& str, const std::string& suffix);
+bool startsWith(std::string_view str, std::string_view prefix);
+bool endsWith(std::string_view str, std::string_view suffix);
+
+/**
+ * @brief Campos de un texto separados por un carácter, calculados al iterar
+ *
+ * Cada campo es una vista de la entrada; no se reserva memoria. Conserva
+ * todos los campos, también los vacíos del final: "a,,b," da "a", "",
+ * "b" y "". Un texto vacío da un solo campo vacío.
+ */
+class SplitRange {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = std::string_view;
+
+        iterator() = default;
+
+        std::string_view operator*() const { return text_.substr(start_, end_ - start_); }
+
+        iterator& operator++() {
+            if (end_ == text_.size()) {
+                start_ = std::string_view::npos;    // Era el último campo
+            } else {
+                start_ = end_ + 1;
+                end_ = fieldEnd(start_);
+            }
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        bool operator==(const iterator& other) const { return start_ == other.start_; }
+
+    private:
+        friend class SplitRange;
+
+        iterator(std::string_view text, char delimiter)
+            : text_(text), delimiter_(delimiter), start_(0), end_(fieldEnd(0)) {}
+
+        size_t fieldEnd(size_t from) const {
+            size_t end = text_.find(delimiter_, from);
+            return end == std::string_view::npos ? text_.size() : end;
+        }
+
+        std::string_view text_;
+        char delimiter_ = 0;
+        size_t start_ = std::string_view::npos;   // npos: fin del rango
+        size_t end_ = 0;
+    };
+
+    SplitRange(std::string_view text, char delimiter) : text_(text), delimiter_(delimiter) {}
+
+    iterator begin() const { return iterator(text_, delimiter_); }
+    iterator end() const { return iterator(); }
+
+private:
+    std::string_view text_;
+    char delimiter_;
+};
+
+inline SplitRange splitView(std::string_view str, char delimiter) {
+    return SplitRange(str, delimiter);
+}
 
 // Splitting and joining
-std::vector<std::string> split(const std::string& str, char delimiter);
-std::string join(const std::vector<std::string>& parts, const std::string& separator);
+std::vector<std::string> split(std::string_view str, char delimiter);
+std::string join(const std::vector<std::string>& parts, std::string_view separator);
 
 // String replacement
-std::string replace(const std::string& str, const std::string& from, const std::string& to);
+std::string replace(std::string_view str, std::string_view from, std::string_view to);
 
 } // namespace cpp20::compiler::common::utils
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace cpp20::compiler::common::utils {
+
+/**
+ * @brief Pool de hilos de tamaño fijo para trabajo paralelo del compilador
+ *
+ * Los trabajos se encolan con submit() y se ejecutan en orden FIFO por
+ * los hilos del pool. wait() bloquea hasta que la cola queda vacía y no
+ * hay trabajos en curso.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Constructor
+     * @param threadCount Número de hilos (0 = hardware_concurrency)
+     */
+    explicit ThreadPool(size_t threadCount = 0);
+
+    /**
+     * @brief Destructor (espera a que terminen los trabajos pendientes)
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Encola un trabajo
+     * @return Future con el resultado (o la excepción) del trabajo
+     */
+    template<typename Func>
+    std::future<std::invoke_result_t<Func>> submit(Func&& task) {
+        using Result = std::invoke_result_t<Func>;
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(task));
+        std::future<Result> future = packaged->get_future();
+        enqueue([packaged]() { (*packaged)(); });
+        return future;
+    }
+
+    /**
+     * @brief Espera a que todos los trabajos encolados terminen
+     */
+    void wait();
+
+    /**
+     * @brief Número de hilos del pool
+     */
+    size_t threadCount() const { return workers_.size(); }
+
+    /**
+     * @brief Número de hilos por defecto (nunca 0)
+     */
+    static size_t defaultThreadCount();
+
+private:
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable taskAvailable_;
+    std::condition_variable idle_;
+    size_t activeTasks_ = 0;
+    bool stopping_ = false;
+
+    void enqueue(std::function<void()> task);
+    void workerLoop();
+};
+
+/**
+ * @brief Cola FIFO de capacidad fija entre las etapas de un pipeline
+ *
+ * push() bloquea mientras la cola está llena, de modo que una etapa rápida
+ * no adelanta a la siguiente más de `capacity` elementos; pop() bloquea
+ * mientras está vacía. close() despierta a ambos lados: pop() entrega lo
+ * que quede y después nullopt, y push() descarta y devuelve false.
+ */
+template<typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity == 0 ? 1 : capacity) {}
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /**
+     * @return false si la cola se cerró (el elemento no se encola)
+     */
+    bool push(T value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this]() { return closed_ || items_.size() < capacity_; });
+        if (closed_) {
+            return false;
+        }
+        items_.push_back(std::move(value));
+        lock.unlock();
+        notEmpty_.notify_one();
+        return true;
+    }
+
+    /**
+     * @return El elemento más antiguo, o nullopt si la cola está cerrada y vacía
+     */
+    std::optional<T> pop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [this]() { return closed_ || !items_.empty(); });
+        if (items_.empty()) {
+            return std::nullopt;
+        }
+        std::optional<T> value(std::move(items_.front()));
+        items_.pop_front();
+        lock.unlock();
+        notFull_.notify_one();
+        return value;
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        notEmpty_.notify_all();
+        notFull_.notify_all();
+    }
+
+private:
+    std::deque<T> items_;
+    size_t capacity_;
+    std::mutex mutex_;
+    std::condition_variable notFull_;
+    std::condition_variable notEmpty_;
+    bool closed_ = false;
+};
+
+/**
+ * @brief Ejecuta body(i) para i en [0, count) usando hasta `jobs` hilos
+ *
+ * Con jobs <= 1 o count <= 1 se ejecuta en el hilo actual. Los índices se
+ * reparten dinámicamente; si algún cuerpo lanza, se relanza la primera
+ * excepción una vez terminados todos los hilos.
+ */
+void parallelFor(size_t count, size_t jobs, const std::function<void(size_t)>& body);
+
+} // namespace cpp20::compiler::common::utils
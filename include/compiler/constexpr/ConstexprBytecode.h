@@ -0,0 +1,164 @@
+/**
+ * @file ConstexprBytecode.h
+ * @brief Bytecode de registros para la evaluación constexpr
+ */
+
+#pragma once
+
+#include <compiler/constexpr/ConstexprEvaluator.h>
+#include <compiler/ast/ExpressionAST.h>
+#include <compiler/ast/StatementAST.h>
+#include <compiler/ast/DeclarationAST.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace cpp20::compiler::constexpr_eval {
+
+/**
+ * @brief Códigos de operación
+ *
+ * Los operandos a, b y c son registros del marco actual salvo donde se
+ * indica. Los saltos son índices absolutos dentro de la función.
+ */
+enum class OpCode : uint8_t {
+    LoadConst,      // r[a] = constants[b]
+    Move,           // r[a] = r[b]
+    Binary,         // r[a] = r[b] <kind> r[c]          (kind = BinaryOp::OpKind)
+    Unary,          // r[a] = <kind> r[b]               (kind = UnaryOp::OpKind)
+    ToBool,         // r[a] = bool(r[b])
+    Jump,           // pc = a
+    JumpIfFalse,    // if (!r[a]) pc = b
+    JumpIfTrue,     // if (r[a]) pc = b
+    Call,           // r[a] = functions[b](r[c] .. r[c + count - 1])
+    Return,         // devuelve r[a]
+    ReturnVoid      // devuelve sin valor
+};
+
+/**
+ * @brief Instrucción de 16 bytes
+ */
+struct Instruction {
+    OpCode op;
+    uint8_t kind = 0;       // Operador de Binary/Unary
+    uint16_t count = 0;     // Argumentos de Call
+    uint32_t a = 0;
+    uint32_t b = 0;
+    uint32_t c = 0;
+};
+
+static_assert(sizeof(Instruction) == 16, "Instruction debe ocupar 16 bytes");
+
+/**
+ * @brief Función compilada
+ *
+ * Los parámetros (o las variables libres de una expresión suelta) ocupan
+ * los registros 0..parameterCount-1; las variables locales y los
+ * temporales, los siguientes. Cada llamada reserva registerCount
+ * registros contiguos.
+ */
+struct BytecodeFunction {
+    std::string name;
+    std::vector<Instruction> code;
+    std::vector<ConstexprValue> constants;
+    uint32_t parameterCount = 0;
+    uint32_t registerCount = 0;
+    bool returnsValue = true;
+
+    // Sin instrucciones que modifiquen AbstractMemory: sus llamadas se
+    // pueden memoizar si tampoco las tienen las funciones a las que llama
+    bool pure = true;
+
+    // Variables libres en el orden de sus registros (expresiones sueltas)
+    std::vector<std::string> freeVariables;
+};
+
+/**
+ * @brief Traduce cuerpos de funciones y expresiones constexpr a bytecode
+ *
+ * Los nombres se resuelven una sola vez, al compilar: cada variable pasa
+ * a ser un registro y cada llamada, un índice en la tabla de funciones
+ * del VM. Lo que el evaluador no soporta se rechaza aquí con un mensaje,
+ * antes de ejecutar nada.
+ */
+class BytecodeCompiler {
+public:
+    /**
+     * @brief Índice en la tabla del VM de la función con ese nombre
+     */
+    using FunctionResolver = std::function<std::optional<uint32_t>(std::string_view)>;
+
+    explicit BytecodeCompiler(FunctionResolver resolver);
+
+    /**
+     * @brief Compila una función con cuerpo
+     * @return nullptr si no es evaluable; error describe el motivo
+     */
+    std::unique_ptr<BytecodeFunction> compileFunction(const ast::FunctionDecl* function,
+                                                      std::string& error);
+
+    /**
+     * @brief Compila una expresión o sentencia suelta
+     *
+     * freeVariables se asignan a los primeros registros en ese orden. Una
+     * expresión devuelve su valor; una sentencia, el de su return.
+     */
+    std::unique_ptr<BytecodeFunction> compileStandalone(const ast::ASTNode* node,
+                                                        const std::vector<std::string>& freeVariables,
+                                                        std::string& error);
+
+private:
+    struct LocalVariable {
+        uint32_t reg;
+        bool isConst;
+    };
+
+    FunctionResolver resolver_;
+    BytecodeFunction* function_ = nullptr;
+    std::vector<std::unordered_map<std::string_view, LocalVariable>> scopes_;
+    uint32_t top_ = 0;              // Primer registro libre
+    std::string error_;
+
+    void reset(BytecodeFunction* function);
+    bool fail(std::string message);
+    bool failed() const { return !error_.empty(); }
+
+    uint32_t allocate();
+    uint32_t addConstant(ConstexprValue value);
+    size_t emit(Instruction instruction);
+    void patchJump(size_t at, size_t target);
+
+    const LocalVariable* lookup(std::string_view name) const;
+    void declare(std::string_view name, uint32_t reg, bool isConst);
+
+    void compileStatement(const ast::ASTNode* node);
+    void compileCompound(const ast::CompoundStmt* node);
+    void compileVariable(const ast::VariableDecl* node);
+    void compileIf(const ast::IfStmt* node);
+    void compileWhile(const ast::WhileStmt* node);
+    void compileFor(const ast::ForStmt* node);
+    void compileReturn(const ast::ReturnStmt* node);
+
+    /**
+     * @brief Registro con el valor de una expresión, sin copiar si ya está en uno
+     */
+    uint32_t compileOperand(const ast::ASTNode* node);
+
+    /**
+     * @brief Evalúa una expresión y deja el resultado en dst
+     */
+    void compileInto(const ast::ASTNode* node, uint32_t dst);
+    void compileBinary(const ast::BinaryOp* node, uint32_t dst);
+    void compileAssignment(const ast::Assignment* node, uint32_t dst);
+    void compileTernary(const ast::TernaryOp* node, uint32_t dst);
+    void compileCall(const ast::FunctionCall* node, uint32_t dst);
+
+    static bool isExpression(ast::ASTNodeKind kind);
+};
+
+} // namespace cpp20::compiler::constexpr_eval
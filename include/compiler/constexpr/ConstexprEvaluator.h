@@ -7,15 +7,28 @@
 
 #include <compiler/ast/ASTNode.h>
 #include <compiler/common/diagnostics/DiagnosticEngine.h>
+#include <compiler/common/utils/MemoryPool.h>
+#include <cstdint>
 #include <memory>
 #include <unordered_map>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <variant>
 #include <optional>
 
+namespace cpp20::compiler::ast {
+class FunctionDecl;
+}
+
 namespace cpp20::compiler::constexpr_eval {
 
+struct BytecodeFunction;
+class ConstexprJIT;
+class NativeFunction;
+
 /**
  * @brief Estado de evaluación constexpr
  */
@@ -30,10 +43,16 @@ enum class EvaluationResult {
 
 /**
  * @brief Valor constexpr
+ *
+ * Ocupa 16 bytes y es trivialmente copiable: los escalares van en línea y
+ * lo que no cabe se referencia. Las cadenas apuntan a una copia interna
+ * inmutable (internString) que vive lo que el proceso; punteros,
+ * referencias y los arrays y structs a los que apuntan son handles de
+ * objetos de AbstractMemory. Copiar un valor nunca reserva memoria.
  */
 class ConstexprValue {
 public:
-    enum class ValueType {
+    enum class ValueType : uint8_t {
         Integer,        // int, long, etc.
         FloatingPoint,  // float, double
         Boolean,        // bool
@@ -45,14 +64,23 @@ public:
         Uninitialized   // No inicializado
     };
 
-    ConstexprValue() : type_(ValueType::Uninitialized) {}
+    ConstexprValue() : type_(ValueType::Uninitialized), handleValue_(0) {}
     ConstexprValue(int val) : type_(ValueType::Integer), intValue_(val) {}
     ConstexprValue(long val) : type_(ValueType::Integer), intValue_(static_cast<int>(val)) {}
     ConstexprValue(bool val) : type_(ValueType::Boolean), boolValue_(val) {}
     ConstexprValue(char val) : type_(ValueType::Character), charValue_(val) {}
     ConstexprValue(double val) : type_(ValueType::FloatingPoint), doubleValue_(val) {}
     ConstexprValue(float val) : type_(ValueType::FloatingPoint), doubleValue_(static_cast<double>(val)) {}
-    ConstexprValue(const std::string& val) : type_(ValueType::String), stringValue_(val) {}
+    ConstexprValue(std::string_view val) : type_(ValueType::String), stringValue_(internString(val)) {}
+    ConstexprValue(const std::string& val) : ConstexprValue(std::string_view(val)) {}
+    ConstexprValue(const char* val) : ConstexprValue(std::string_view(val)) {}
+
+    /**
+     * @brief Puntero o referencia a un objeto de AbstractMemory
+     */
+    static ConstexprValue pointer(size_t handle) { return ConstexprValue(ValueType::Pointer, handle); }
+    static ConstexprValue reference(size_t handle) { return ConstexprValue(ValueType::Reference, handle); }
+    static ConstexprValue null() { return ConstexprValue(ValueType::Nullptr, 0); }
 
     ValueType getType() const { return type_; }
 
@@ -66,23 +94,46 @@ public:
     bool isReference() const { return type_ == ValueType::Reference; }
     bool isUninitialized() const { return type_ == ValueType::Uninitialized; }
 
-    int asInteger() const { return intValue_; }
-    bool asBoolean() const { return boolValue_; }
-    char asCharacter() const { return charValue_; }
-    double asFloatingPoint() const { return doubleValue_; }
-    const std::string& asString() const { return stringValue_; }
+    int asInteger() const { return isInteger() ? intValue_ : 0; }
+    bool asBoolean() const { return isBoolean() && boolValue_; }
+    char asCharacter() const { return isCharacter() ? charValue_ : '\0'; }
+    double asFloatingPoint() const { return isFloatingPoint() ? doubleValue_ : 0.0; }
+    const std::string& asString() const;
+    size_t asHandle() const { return isPointer() || isReference() ? handleValue_ : 0; }
+
+    /**
+     * @brief Igualdad exacta de tipo y contenido (clave de memoización)
+     *
+     * Los double se comparan por bits y las cadenas por su copia interna,
+     * de modo que dos valores idénticos siempre dan el mismo resultado.
+     */
+    bool identical(const ConstexprValue& other) const;
+    uint64_t hash() const;
 
     std::string toString() const;
 
+    /**
+     * @brief Copia estable de una cadena; la misma cadena da el mismo puntero
+     */
+    static const std::string* internString(std::string_view text);
+
 private:
     ValueType type_;
-    int intValue_ = 0;
-    bool boolValue_ = false;
-    char charValue_ = 0;
-    double doubleValue_ = 0.0;
-    std::string stringValue_;
+    union {
+        int intValue_;
+        bool boolValue_;
+        char charValue_;
+        double doubleValue_;
+        const std::string* stringValue_;
+        size_t handleValue_;
+    };
+
+    ConstexprValue(ValueType type, size_t handle) : type_(type), handleValue_(handle) {}
 };
 
+static_assert(sizeof(ConstexprValue) <= 16, "ConstexprValue debe caber en 16 bytes");
+static_assert(std::is_trivially_copyable_v<ConstexprValue>, "ConstexprValue se copia sin reservar memoria");
+
 /**
  * @brief Resultado de evaluación constexpr
  */
@@ -95,73 +146,174 @@ struct EvaluationContext {
 
     EvaluationContext() : result(EvaluationResult::Success) {}
     EvaluationContext(EvaluationResult res) : result(res) {}
-    EvaluationContext(EvaluationResult res, const std::string& msg)
-        : result(res), errorMessage(msg) {}
+    EvaluationContext(EvaluationResult res, std::string msg)
+        : result(res), errorMessage(std::move(msg)) {}
 };
 
 /**
- * @brief Variable en scope constexpr
+ * @brief Posición de una variable: scopes hacia arriba y hueco dentro del scope
  */
-struct ConstexprVariable {
-    std::string name;
-    ConstexprValue value;
-    bool isConst = true;
-    bool isInitialized = false;
-
-    ConstexprVariable() = default;
-    ConstexprVariable(const std::string& n, const ConstexprValue& v, bool isConst_ = true)
-        : name(n), value(v), isConst(isConst_), isInitialized(true) {}
+struct VariableSlot {
+    uint32_t depth = 0;     // 0 = scope actual
+    uint32_t index = 0;
 };
 
 /**
- * @brief Scope de evaluación constexpr
+ * @brief Scope de evaluación constexpr sobre almacenamiento plano
+ *
+ * Los valores de todos los scopes abiertos viven contiguos en un único
+ * vector; cada scope es un intervalo [base, tope). pushScope y popScope
+ * solo mueven el tope, sin liberar ni reservar memoria una vez que el
+ * vector alcanzó su tamaño máximo. Los nombres se resuelven una vez con
+ * resolve() y los accesos posteriores usan el VariableSlot obtenido; el
+ * VM, que ya resuelve nombres al compilar, trabaja solo con huecos.
  */
 class EvaluationScope {
 public:
     EvaluationScope() = default;
 
-    void declareVariable(const std::string& name, const ConstexprValue& value, bool isConst = true);
-    bool hasVariable(const std::string& name) const;
-    const ConstexprVariable* getVariable(const std::string& name) const;
+    /**
+     * @brief Abre un scope con slotCount huecos reservados
+     *
+     * Los huecos conservan lo que dejara un scope anterior: quien los
+     * reserva debe escribirlos antes de leerlos.
+     * @return Base del scope dentro del almacenamiento
+     */
+    size_t pushScope(size_t slotCount = 0);
+    void popScope();
+
+    /**
+     * @brief Declara una variable al final del scope actual
+     * @return Hueco asignado dentro del scope
+     */
+    uint32_t declareVariable(const std::string& name, const ConstexprValue& value, bool isConst = true);
+
+    /**
+     * @brief Resuelve un nombre al hueco visible más interno
+     */
+    std::optional<VariableSlot> resolve(std::string_view name) const;
+
+    ConstexprValue& at(VariableSlot slot) { return values_[baseOf(slot.depth) + slot.index]; }
+    const ConstexprValue& at(VariableSlot slot) const { return values_[baseOf(slot.depth) + slot.index]; }
+
+    /**
+     * @brief Primer hueco de un scope; válido hasta el siguiente pushScope
+     */
+    ConstexprValue* frame(uint32_t depth = 0) { return values_.data() + baseOf(depth); }
+
+    // Acceso por nombre: resuelve en cada llamada
+    bool hasVariable(const std::string& name) const { return resolve(name).has_value(); }
+    const ConstexprValue* getVariable(const std::string& name) const;
     bool updateVariable(const std::string& name, const ConstexprValue& value);
 
-    void pushScope();
-    void popScope();
+    size_t depth() const { return scopes_.size(); }
+    size_t size() const { return top_; }
+
+    /**
+     * @brief Cierra todos los scopes conservando la capacidad reservada
+     */
+    void clear();
 
 private:
-    std::vector<std::unordered_map<std::string, ConstexprVariable>> scopes_;
+    struct Binding {
+        std::string name;
+        size_t slot;        // Posición absoluta en values_
+        bool isConst;
+    };
+
+    struct ScopeRecord {
+        size_t base;
+        size_t bindingsBegin;
+    };
+
+    std::vector<ConstexprValue> values_;
+    std::vector<Binding> bindings_;
+    std::vector<ScopeRecord> scopes_;
+    size_t top_ = 0;
+
+    size_t baseOf(uint32_t depth) const { return scopes_[scopes_.size() - 1 - depth].base; }
+    void reserveTo(size_t size);
+    const Binding* findBinding(std::string_view name) const;
 };
 
 /**
  * @brief Memoria abstracta para evaluación constexpr
+ *
+ * Los bytes de cada objeto salen de un MemoryPool con listas libres por
+ * clase de tamaño, y los descriptores, de un vector de huecos que se
+ * reciclan. Un handle combina el hueco con una generación: tras
+ * deallocate() el handle antiguo deja de resolver, lo que detecta usos
+ * después de liberar y dobles liberaciones. clear() libera todo de una
+ * vez al final de una evaluación.
  */
 class AbstractMemory {
 public:
     struct MemoryObject {
-        std::string type;
+        std::string_view type;
         size_t size = 0;
-        std::vector<char> data;
+        char* data = nullptr;
         bool isInitialized = false;
-
-        MemoryObject(const std::string& t, size_t s) : type(t), size(s), data(s, 0) {}
     };
 
-    size_t allocate(const std::string& type, size_t size);
+    AbstractMemory();
+
+    /**
+     * @return Handle del objeto; 0 es nullptr
+     */
+    size_t allocate(std::string_view type, size_t size);
     bool deallocate(size_t address);
     MemoryObject* getObject(size_t address);
     const MemoryObject* getObject(size_t address) const;
 
     size_t getTotalAllocated() const { return totalAllocated_; }
+    size_t getLiveObjectCount() const { return liveObjects_; }
+
+    /**
+     * @brief Handles de los objetos aún vivos, en una sola pasada
+     */
+    std::vector<size_t> liveObjects() const;
+
+    /**
+     * @brief Libera todos los objetos de golpe, conservando la memoria reservada
+     */
     void clear();
 
 private:
-    std::unordered_map<size_t, std::unique_ptr<MemoryObject>> objects_;
-    size_t nextAddress_ = 1; // 0 es nullptr
+    struct Slot {
+        MemoryObject object;
+        uint32_t generation = 1;
+        uint32_t nextFree = 0;      // Siguiente hueco libre + 1 (0 = fin)
+        bool live = false;
+    };
+
+    common::utils::MemoryPool pool_;
+    std::vector<Slot> slots_;
+    uint32_t firstFree_ = 0;        // Primer hueco libre + 1 (0 = ninguno)
+    size_t liveObjects_ = 0;
     size_t totalAllocated_ = 0;
+
+    static size_t makeHandle(uint32_t slot, uint32_t generation) {
+        return (static_cast<size_t>(generation) << 32) | (static_cast<size_t>(slot) + 1);
+    }
+    const Slot* resolve(size_t address) const;
 };
 
 /**
  * @brief Máquina Virtual para evaluación constexpr
+ *
+ * Las funciones y expresiones se compilan a bytecode de registros
+ * (ConstexprBytecode.h) y se interpretan sin volver a recorrer el AST.
+ * Cada función registrada se compila una sola vez, la primera vez que se
+ * llama; las llamadas posteriores solo ejecutan su código.
+ *
+ * Las llamadas a funciones puras (sin efectos sobre AbstractMemory, ni
+ * propios ni de sus llamadas) se memoizan por función y valores de los
+ * argumentos durante toda la vida del VM: fib(n) recursivo evalúa cada
+ * fib(k) una sola vez.
+ *
+ * Una función que llega a jitThreshold llamadas sin memoizar se compila a
+ * código nativo (ConstexprJIT.h) si es apta; si el código nativo abandona,
+ * la llamada se repite en el intérprete.
  */
 class ConstexprVM {
 public:
@@ -181,8 +333,23 @@ public:
     EvaluationContext evaluate(const ast::ASTNode* expression,
                               const std::unordered_map<std::string, ConstexprValue>& parameters = {});
 
+    /**
+     * @brief Registrar función invocable desde el código evaluado
+     *
+     * Volver a registrar un nombre sustituye la declaración y descarta su
+     * código compilado.
+     */
+    void registerFunction(const std::string& name, const ast::FunctionDecl* function);
+
+    /**
+     * @brief Evaluar una llamada a una función registrada
+     */
+    EvaluationContext call(const std::string& name, const std::vector<ConstexprValue>& arguments);
+
     /**
      * @brief Verificar si expresión es constexpr válida
+     *
+     * Una FunctionDecl se comprueba compilando su cuerpo.
      */
     bool isValidConstexpr(const ast::ASTNode* expression,
                          std::string& errorMessage);
@@ -194,6 +361,13 @@ public:
                   size_t maxRecursion = 100,
                   size_t maxMemory = 1024 * 1024); // 1MB
 
+    static constexpr size_t DefaultJitThreshold = 1000;
+
+    /**
+     * @brief Llamadas tras las que una función pasa al nivel nativo (0 = nunca)
+     */
+    void setJitThreshold(size_t calls) { jitThreshold_ = calls; }
+
     /**
      * @brief Obtener estadísticas de evaluación
      */
@@ -203,6 +377,12 @@ public:
         size_t maxRecursionDepth = 0;
         size_t memoryPeak = 0;
         size_t errors = 0;
+        size_t functionsCompiled = 0;
+        size_t memoHits = 0;
+        size_t memoEntries = 0;
+        size_t nativeCompilations = 0;
+        size_t nativeCalls = 0;
+        size_t nativeBailouts = 0;     // Llamadas nativas repetidas en el intérprete
     };
     VMStats getStats() const { return stats_; }
 
@@ -212,92 +392,130 @@ public:
     void clear();
 
 private:
-    diagnostics::DiagnosticEngine& diagEngine_;
-    EvaluationScope scope_;
-    AbstractMemory memory_;
-    VMStats stats_;
+    struct FunctionEntry {
+        const ast::FunctionDecl* decl = nullptr;
+        std::unique_ptr<BytecodeFunction> code;     // nullptr hasta la primera llamada
+        std::unique_ptr<NativeFunction> native;     // nullptr hasta jitThreshold_ llamadas
+        size_t calls = 0;
+        bool nativeRejected = false;                // ConstexprJIT ya la descartó
+    };
 
-    // Límites
-    size_t maxSteps_ = 1000000;
-    size_t maxRecursion_ = 100;
-    size_t maxMemory_ = 1024 * 1024;
-    size_t currentRecursion_ = 0;
+    struct Frame {
+        const BytecodeFunction* function;
+        size_t pc;
+        uint32_t result;    // Registro del llamador que recibe el valor
+        uint32_t index;     // Entrada en functions_ (NoFunction si es una expresión)
+        size_t memoBase;    // Argumentos de la llamada en memoArguments_
+        bool memoize;       // Sin efectos sobre AbstractMemory hasta ahora
+        uint64_t startTicks = 0;    // TimingProfiler::now() al entrar, si se mide
+        uint64_t childTicks = 0;    // Ticks de las llamadas anidadas
+    };
 
-    /**
-     * @brief Evaluar expresión específica
-     */
-    EvaluationContext evaluateExpression(const ast::ASTNode* node);
+    static constexpr uint32_t NoFunction = ~0u;
+    static constexpr size_t MaxMemoEntries = 1 << 20;
 
     /**
-     * @brief Evaluar literal
+     * @brief Llamada ya evaluada: función y valores de los argumentos
      */
-    EvaluationContext evaluateLiteral(const ast::ASTNode* node);
+    struct MemoKey {
+        uint32_t function;
+        std::vector<ConstexprValue> arguments;
+    };
 
     /**
-     * @brief Evaluar operador binario
+     * @brief Vista sin copia para buscar una llamada antes de ejecutarla
      */
-    EvaluationContext evaluateBinaryOp(const ast::ASTNode* node);
+    struct MemoKeyView {
+        uint32_t function;
+        const ConstexprValue* arguments;
+        size_t count;
+    };
 
-    /**
-     * @brief Evaluar operador unario
-     */
-    EvaluationContext evaluateUnaryOp(const ast::ASTNode* node);
+    struct MemoHash {
+        using is_transparent = void;
+        size_t operator()(const MemoKey& key) const;
+        size_t operator()(const MemoKeyView& key) const;
+    };
 
-    /**
-     * @brief Evaluar llamada a función
-     */
-    EvaluationContext evaluateFunctionCall(const ast::ASTNode* node);
+    struct MemoEqual {
+        using is_transparent = void;
+        bool operator()(const MemoKeyView& a, const MemoKeyView& b) const;
+        bool operator()(const MemoKey& a, const MemoKey& b) const { return (*this)(view(a), view(b)); }
+        bool operator()(const MemoKey& a, const MemoKeyView& b) const { return (*this)(view(a), b); }
+        bool operator()(const MemoKeyView& a, const MemoKey& b) const { return (*this)(a, view(b)); }
 
-    /**
-     * @brief Evaluar variable
-     */
-    EvaluationContext evaluateVariable(const ast::ASTNode* node);
+        static MemoKeyView view(const MemoKey& key) {
+            return MemoKeyView{key.function, key.arguments.data(), key.arguments.size()};
+        }
+    };
 
-    /**
-     * @brief Evaluar asignación
-     */
-    EvaluationContext evaluateAssignment(const ast::ASTNode* node);
+    diagnostics::DiagnosticEngine& diagEngine_;
+    AbstractMemory memory_;
+    VMStats stats_;
+
+    std::vector<FunctionEntry> functions_;
+    std::unordered_map<std::string, uint32_t> functionIndex_;
+
+    // Registros de los marcos activos: un scope por llamada
+    EvaluationScope scope_;
+    std::vector<Frame> frames_;
+
+    // Resultados de llamadas a funciones puras, válidos para toda la unidad
+    std::unordered_map<MemoKey, ConstexprValue, MemoHash, MemoEqual> memo_;
+    std::vector<ConstexprValue> memoArguments_;
+
+    // Límites
+    size_t maxSteps_ = 1000000;
+    size_t maxRecursion_ = 100;
+    size_t maxMemory_ = 1024 * 1024;
+
+    // Nivel nativo, creado con la primera función que lo alcanza
+    size_t jitThreshold_ = DefaultJitThreshold;
+    std::unique_ptr<ConstexprJIT> jit_;
 
     /**
-     * @brief Evaluar declaración
+     * @brief Código de una función registrada, compilándolo si hace falta
+     * @return nullptr si no es evaluable; error describe el motivo
      */
-    EvaluationContext evaluateDeclaration(const ast::ASTNode* node);
+    const BytecodeFunction* compiledFunction(uint32_t index, std::string& error);
 
     /**
-     * @brief Evaluar if constexpr
+     * @brief Llamada en código nativo, contándola y compilando al llegar al umbral
+     * @return false si la función no tiene nivel nativo o el código abandona
      */
-    EvaluationContext evaluateIfConstexpr(const ast::ASTNode* node);
+    bool callNative(uint32_t index, const ConstexprValue* arguments, size_t count, ConstexprValue& result);
 
     /**
-     * @brief Evaluar operador ternario
+     * @brief Índice de una función por nombre (resolución de llamadas al compilar)
      */
-    EvaluationContext evaluateTernaryOp(const ast::ASTNode* node);
+    std::optional<uint32_t> resolveFunction(std::string_view name) const;
 
     /**
-     * @brief Verificar límites
+     * @brief Ejecutar código compilado con los argumentos dados
      */
-    bool checkLimits();
+    EvaluationContext execute(const BytecodeFunction* function,
+                              const std::vector<ConstexprValue>& arguments,
+                              uint32_t index = NoFunction);
 
     /**
-     * @brief Incrementar contador de pasos
+     * @brief Resultado memoizado de una llamada, si lo hay
      */
-    void incrementSteps();
+    const ConstexprValue* findMemo(uint32_t index, const ConstexprValue* arguments, size_t count);
 
     /**
      * @brief Crear error de evaluación
      */
     EvaluationContext createError(const std::string& message,
                                  const std::vector<std::string>& notes = {});
+};
 
-    /**
-     * @brief Obtener valor de variable
-     */
-    std::optional<ConstexprValue> getVariableValue(const std::string& name);
-
-    /**
-     * @brief Establecer valor de variable
-     */
-    bool setVariableValue(const std::string& name, const ConstexprValue& value);
+/**
+ * @brief Inicializador de variable constexpr o static_assert de ámbito de namespace
+ */
+struct ConstexprInitializer {
+    std::string name;                         // Variable declarada; vacío en un static_assert
+    const ast::ASTNode* expression = nullptr;
+    bool isStaticAssert = false;
 };
 
 /**
@@ -328,6 +546,22 @@ public:
     EvaluationContext evaluateExpression(const ast::ASTNode* expression,
                                        const std::unordered_map<std::string, ConstexprValue>& context = {});
 
+    /**
+     * @brief Evaluar los inicializadores de una unidad, en paralelo donde se pueda
+     *
+     * Un inicializador que nombra una variable declarada antes en la lista
+     * depende de ella y se evalúa en una oleada posterior, con su valor como
+     * parámetro; los de una misma oleada se reparten entre hasta `jobs`
+     * hilos, cada uno con su propio ConstexprVM (y su AbstractMemory). El
+     * primer hilo usa el VM del evaluador. Un static_assert cuyo valor no es
+     * true se devuelve como Error.
+     *
+     * @param jobs Hilos como máximo (0 = ThreadPool::defaultThreadCount())
+     * @return Un resultado por inicializador, en el orden de la lista
+     */
+    std::vector<EvaluationContext> evaluateInitializers(const std::vector<ConstexprInitializer>& initializers,
+                                                        size_t jobs = 0);
+
     /**
      * @brief Verificar si función es constexpr válida
      */
@@ -362,6 +596,7 @@ public:
         size_t totalSteps = 0;
         size_t errors = 0;
         size_t timeSpentMs = 0;
+        size_t initializerWaves = 0;    // Oleadas de evaluateInitializers
     };
     EvaluatorStats getStats() const;
 
@@ -376,6 +611,11 @@ private:
     std::unordered_map<std::string, const ast::ASTNode*> constexprFunctions_;
     EvaluatorStats stats_;
 
+    // Límites vigentes, para los VM de los hilos de evaluateInitializers
+    size_t maxSteps_ = 1000000;
+    size_t maxRecursion_ = 100;
+    size_t maxMemory_ = 1024 * 1024;
+
     /**
      * @brief Verificar que función cumple reglas constexpr
      */
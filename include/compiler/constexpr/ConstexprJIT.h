@@ -0,0 +1,103 @@
+/**
+ * @file ConstexprJIT.h
+ * @brief Nivel nativo del VM constexpr: funciones calientes compiladas con el back-end x86-64
+ */
+
+#pragma once
+
+#include <compiler/constexpr/ConstexprEvaluator.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace cpp20::compiler::ir {
+class IRFunction;
+}
+
+namespace cpp20::compiler::backend::abi {
+class ABIContract;
+}
+
+namespace cpp20::compiler::constexpr_eval {
+
+struct BytecodeFunction;
+
+/**
+ * @brief Código nativo de una función constexpr en memoria ejecutable
+ *
+ * El cuerpo recibe un único puntero a un marco con los argumentos como
+ * enteros de 64 bits y devuelve en RAX (resultado << 2) | estado, con
+ * estado 1 si el resultado es un int, 2 si es un bool y 0 si abandona: ante un desbordamiento, un desplazamiento fuera de rango o
+ * cualquier otro caso que el intérprete diagnostica, el código nativo no
+ * decide nada y la llamada se repite en el intérprete, que da el error
+ * exacto. Delante del cuerpo va un stub que guarda los registros no
+ * volátiles y lleva el puntero del marco al registro que le asignó el
+ * asignador.
+ */
+class NativeFunction {
+public:
+    ~NativeFunction();
+
+    NativeFunction(const NativeFunction&) = delete;
+    NativeFunction& operator=(const NativeFunction&) = delete;
+
+    /**
+     * @brief Ejecutar con los argumentos dados
+     * @return false si el código abandona o algún argumento no es un int
+     */
+    bool call(const ConstexprValue* arguments, size_t count, ConstexprValue& result) const;
+
+    size_t parameterCount() const { return parameterCount_; }
+    size_t codeSize() const { return codeSize_; }
+
+private:
+    friend class ConstexprJIT;
+    NativeFunction() = default;
+
+    void* memory_ = nullptr;
+    size_t mappedSize_ = 0;
+    size_t codeSize_ = 0;
+    size_t parameterCount_ = 0;
+};
+
+/**
+ * @brief Compilador del nivel nativo
+ *
+ * Baja el bytecode a ir::IRFunction y lo pasa por CodeGenerator
+ * (InstructionSelector, RegisterAllocator, peephole, X86Encoder). Solo son
+ * aptas las funciones escalares sin llamadas ni bucles: int y bool con
+ * + - * & | ^, desplazamientos por constante, comparaciones y saltos hacia
+ * delante. Cada camino del bytecode se baja por separado, con sus propios
+ * valores, de modo que la IR no necesita phis; los casos que el intérprete
+ * comprueba (rango de int, desplazamientos) saltan al bloque de abandono.
+ * Las llamadas y los bucles siguen en el intérprete, donde la memoización
+ * y el límite de pasos ya los cubren.
+ */
+class ConstexprJIT {
+public:
+    ConstexprJIT();
+    ~ConstexprJIT();
+
+    /**
+     * @brief Si el anfitrión puede ejecutar el código del back-end (x86-64)
+     */
+    static bool isSupported();
+
+    /**
+     * @brief Compilar una función
+     * @return nullptr si no es apta; reason describe el motivo
+     */
+    std::unique_ptr<NativeFunction> compile(const BytecodeFunction& function, std::string& reason) const;
+
+    /**
+     * @brief Bajada a IR, sin generar código
+     * @return nullptr si no es apta; reason describe el motivo
+     */
+    static std::unique_ptr<ir::IRFunction> lowerToIR(const BytecodeFunction& function, std::string& reason);
+
+private:
+    std::unique_ptr<backend::abi::ABIContract> abiContract_;
+};
+
+} // namespace cpp20::compiler::constexpr_eval
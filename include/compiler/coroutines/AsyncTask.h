@@ -0,0 +1,240 @@
+/**
+ * @file AsyncTask.h
+ * @brief Tarea perezosa que encadena corrutinas por transferencia simétrica
+ */
+
+#pragma once
+
+#include <compiler/coroutines/CoroutineFrame.h>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <semaphore>
+#include <utility>
+
+namespace cpp20::compiler::coroutines {
+
+template <typename T>
+class AsyncTask;
+
+namespace detail {
+
+/**
+ * @brief Parte común de las promesas de AsyncTask
+ *
+ * Tanto el co_await que arranca la tarea como el final_suspend que vuelve
+ * a quien la esperaba devuelven el coroutine_handle siguiente desde
+ * await_suspend: el salto al otro marco es una llamada en cola, no un
+ * resume() anidado, así que una cadena de co_await de cualquier
+ * profundidad ocupa pila constante y cada salto cuesta un JMP.
+ */
+class AsyncPromiseBase {
+public:
+    static void* operator new(size_t size) { return CoroutineFrameAllocator::allocate(size); }
+    static void operator delete(void* frame, size_t size) noexcept {
+        CoroutineFrameAllocator::deallocate(frame, size);
+    }
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> finished) noexcept {
+            return finished.promise().continuation();
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() noexcept { exception_ = std::current_exception(); }
+
+    /**
+     * @brief Corrutina a reanudar al terminar; noop_coroutine si nadie espera
+     */
+    std::coroutine_handle<> continuation() const { return continuation_; }
+    void setContinuation(std::coroutine_handle<> continuation) { continuation_ = continuation; }
+
+protected:
+    void rethrowIfFailed() const {
+        if (exception_) std::rethrow_exception(exception_);
+    }
+
+private:
+    std::coroutine_handle<> continuation_ = std::noop_coroutine();
+    std::exception_ptr exception_;
+};
+
+template <typename T>
+class AsyncPromise : public AsyncPromiseBase {
+public:
+    AsyncTask<T> get_return_object();
+
+    template <typename U>
+    void return_value(U&& value) {
+        value_.emplace(std::forward<U>(value));
+    }
+
+    T result() {
+        rethrowIfFailed();
+        return std::move(*value_);
+    }
+
+private:
+    std::optional<T> value_;
+};
+
+template <>
+class AsyncPromise<void> : public AsyncPromiseBase {
+public:
+    AsyncTask<void> get_return_object();
+
+    void return_void() noexcept {}
+    void result() const { rethrowIfFailed(); }
+};
+
+/**
+ * @brief Corrutina de syncWait: despierta al hilo que espera al terminar
+ */
+struct SyncWaitTask {
+    struct promise_type {
+        std::binary_semaphore* finished = nullptr;
+
+        SyncWaitTask get_return_object() {
+            return {std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        auto final_suspend() noexcept {
+            struct Signal {
+                bool await_ready() noexcept { return false; }
+                void await_suspend(std::coroutine_handle<promise_type> done) noexcept {
+                    done.promise().finished->release();
+                }
+                void await_resume() noexcept {}
+            };
+            return Signal{};
+        }
+
+        void return_void() noexcept {}
+        // La tarea esperada guarda sus excepciones: aquí no llega ninguna
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+} // namespace detail
+
+/**
+ * @brief Tarea perezosa: empieza al esperarla con co_await
+ *
+ * El resultado o la excepción del cuerpo se entregan en el co_await. Si
+ * la tarea se suspende en otro sitio (un CoroutineScheduler, por ejemplo),
+ * quien la reanude continúa la cadena hasta el primer llamador, que a su
+ * vez se reanuda en ese hilo.
+ */
+template <typename T = void>
+class AsyncTask {
+public:
+    using promise_type = detail::AsyncPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    explicit AsyncTask(Handle handle) : handle_(handle) {}
+    AsyncTask(AsyncTask&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    AsyncTask& operator=(AsyncTask&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    AsyncTask(const AsyncTask&) = delete;
+    AsyncTask& operator=(const AsyncTask&) = delete;
+
+    ~AsyncTask() {
+        if (handle_) handle_.destroy();
+    }
+
+    bool isDone() const { return !handle_ || handle_.done(); }
+
+    auto operator co_await() noexcept {
+        struct Awaiter {
+            Handle task;
+
+            bool await_ready() noexcept { return task.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                task.promise().setContinuation(awaiting);
+                return task;
+            }
+
+            T await_resume() { return task.promise().result(); }
+        };
+        return Awaiter{handle_};
+    }
+
+    /**
+     * @brief Espera a que termine sin tomar el resultado ni la excepción
+     */
+    auto completion() noexcept {
+        struct Awaiter {
+            Handle task;
+
+            bool await_ready() noexcept { return task.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                task.promise().setContinuation(awaiting);
+                return task;
+            }
+
+            void await_resume() noexcept {}
+        };
+        return Awaiter{handle_};
+    }
+
+private:
+    Handle handle_;
+
+    template <typename U>
+    friend U syncWait(AsyncTask<U> task);
+};
+
+template <typename T>
+AsyncTask<T> detail::AsyncPromise<T>::get_return_object() {
+    return AsyncTask<T>(std::coroutine_handle<AsyncPromise<T>>::from_promise(*this));
+}
+
+inline AsyncTask<void> detail::AsyncPromise<void>::get_return_object() {
+    return AsyncTask<void>(std::coroutine_handle<AsyncPromise<void>>::from_promise(*this));
+}
+
+namespace detail {
+
+template <typename T>
+SyncWaitTask waitFor(AsyncTask<T>& task) {
+    co_await task.completion();
+}
+
+} // namespace detail
+
+/**
+ * @brief Ejecuta la tarea desde código que no es corrutina y bloquea hasta su fin
+ *
+ * La tarea arranca en el hilo que llama; si se suspende en un
+ * planificador, el hilo espera a que otro la termine.
+ */
+template <typename T>
+T syncWait(AsyncTask<T> task) {
+    std::binary_semaphore finished(0);
+    detail::SyncWaitTask waiter = detail::waitFor(task);
+    waiter.handle.promise().finished = &finished;
+    waiter.handle.resume();
+    finished.acquire();
+    waiter.handle.destroy();
+    return task.handle_.promise().result();
+}
+
+} // namespace cpp20::compiler::coroutines
@@ -0,0 +1,170 @@
+/**
+ * @file CoroutineFrame.h
+ * @brief Disposición del marco de una corrutina, elisión de su reserva y pool de marcos
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cpp20::compiler::coroutines {
+
+/**
+ * @brief Variable local candidata a guardarse en el marco
+ *
+ * Las posiciones son las de las instrucciones del cuerpo en orden de
+ * programa, las mismas con las que se registran los puntos de suspensión.
+ */
+struct FrameVariable {
+    std::string name;
+    uint32_t size = 0;
+    uint32_t alignment = 1;
+    uint32_t definition = 0;    // Posición de la definición
+    uint32_t lastUse = 0;       // Posición del último uso
+};
+
+/**
+ * @brief Campo del marco ya colocado
+ */
+struct FrameSlot {
+    std::string name;
+    uint32_t offset = 0;
+    uint32_t size = 0;
+};
+
+/**
+ * @brief Disposición compacta del marco de una corrutina
+ *
+ * Solo van al marco las variables vivas en algún punto de suspensión
+ * (definidas antes y usadas después); el resto vive en la pila de resume
+ * como en una función normal. Tras la cabecera va la promesa, en un
+ * offset fijo para coroutine_handle::from_promise, y después las
+ * variables de mayor a menor alineación y, a igual alineación, de mayor a
+ * menor tamaño, de modo que el relleno entre campos es mínimo.
+ */
+class CoroutineFrameLayout {
+public:
+    /**
+     * @brief Punteros a resume y destroy e índice del punto de suspensión
+     */
+    static constexpr uint32_t HeaderSize = 24;
+
+    void setPromise(uint32_t size, uint32_t alignment);
+    void addSuspendPoint(uint32_t position);
+    void addVariable(FrameVariable variable);
+
+    /**
+     * @brief Coloca la promesa y las variables que cruzan una suspensión
+     */
+    void compute();
+
+    const std::vector<FrameSlot>& getSlots() const { return slots_; }
+
+    /**
+     * @brief Campo de la variable, o nullptr si no va en el marco
+     */
+    const FrameSlot* findSlot(const std::string& name) const;
+
+    uint32_t getPromiseOffset() const { return promiseOffset_; }
+    uint32_t getFrameSize() const { return frameSize_; }            // Múltiplo de getFrameAlignment
+    uint32_t getFrameAlignment() const { return frameAlignment_; }
+    size_t getLocalCount() const { return localCount_; }            // Variables fuera del marco
+
+private:
+    uint32_t promiseSize_ = 0;
+    uint32_t promiseAlignment_ = 1;
+    std::vector<uint32_t> suspendPoints_;
+    std::vector<FrameVariable> variables_;
+
+    std::vector<FrameSlot> slots_;
+    uint32_t promiseOffset_ = 0;
+    uint32_t frameSize_ = 0;
+    uint32_t frameAlignment_ = 8;
+    size_t localCount_ = 0;
+
+    bool isLiveAcrossSuspend(const FrameVariable& variable) const;
+};
+
+/**
+ * @brief Cómo usa el llamador la corrutina que crea
+ */
+struct CoroutineUse {
+    bool calleeKnown = false;         // Llamada directa: se conoce el tamaño del marco
+    bool handleEscapes = false;       // El handle se guarda, se devuelve o se pasa a otra función
+    bool destroyedInCaller = false;   // Todos los caminos del llamador destruyen el marco
+};
+
+/**
+ * @brief Dónde reservar el marco de una corrutina
+ */
+enum class FrameAllocation {
+    Heap,           // operator new de la promesa o global
+    CallerStack     // Alloca en el marco del llamador, sin reserva
+};
+
+/**
+ * @brief Tamaño máximo de un marco que se coloca en la pila del llamador
+ */
+inline constexpr uint32_t DefaultMaxElidedFrame = 4096;
+
+/**
+ * @brief Decide si se elide la reserva del marco (HALO)
+ *
+ * Como CoroElide de LLVM: si el llamador conoce la corrutina, el handle
+ * no escapa y el marco se destruye antes de que el llamador retorne
+ * (un generator consumido en un bucle, un Task esperado en el acto), su
+ * vida está anidada en la del llamador y el marco puede ir en su pila.
+ * Los marcos grandes siguen en el heap para no agotar la pila.
+ */
+FrameAllocation chooseFrameAllocation(const CoroutineUse& use, uint32_t frameSize,
+                                      uint32_t maxStackFrame = DefaultMaxElidedFrame);
+
+/**
+ * @brief Estadísticas del pool de marcos, sumadas de todos los hilos
+ */
+struct FramePoolStatistics {
+    uint64_t allocations = 0;     // Marcos pedidos
+    uint64_t poolHits = 0;        // Servidos desde una lista libre
+    uint64_t heapFallbacks = 0;   // Marcos mayores que la clase más grande
+    uint64_t deallocations = 0;
+};
+
+/**
+ * @brief operator new/delete de los marcos de corrutina que no se eliden
+ *
+ * Clases de tamaño de 16 en 16 bytes hasta MaxPooledSize, cada una con una
+ * lista libre por hilo: reservar un marco del mismo tamaño que uno ya
+ * liberado es sacar un puntero de la lista, sin locks ni atómicos. El
+ * tamaño del marco se conoce tras el lowering, así que la clase se puede
+ * resolver en compilación con sizeClassOf. Un marco liberado en otro hilo
+ * (tras robarse la corrutina) va a la lista de ese hilo; cada lista tiene
+ * un tope y lo que lo supera vuelve al heap, igual que los marcos grandes.
+ */
+class CoroutineFrameAllocator {
+public:
+    static constexpr size_t Granularity = 16;
+    static constexpr size_t MaxPooledSize = 1024;
+    static constexpr size_t SizeClassCount = MaxPooledSize / Granularity;
+    static constexpr size_t MaxCachedPerClass = 256;
+
+    /**
+     * @brief Clase de tamaño de un marco, o SizeClassCount si va al heap
+     */
+    static constexpr size_t sizeClassOf(size_t size) {
+        return size == 0 ? 0 : size > MaxPooledSize ? SizeClassCount : (size - 1) / Granularity;
+    }
+
+    static void* allocate(size_t size);
+
+    /**
+     * @param size El mismo tamaño pedido a allocate (operator delete con tamaño)
+     */
+    static void deallocate(void* frame, size_t size) noexcept;
+
+    static FramePoolStatistics statistics();
+};
+
+} // namespace cpp20::compiler::coroutines
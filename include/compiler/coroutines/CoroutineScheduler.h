@@ -0,0 +1,363 @@
+/**
+ * @file CoroutineScheduler.h
+ * @brief Planificador multihilo de corrutinas con robo de trabajo y rueda de temporizadores
+ */
+
+#pragma once
+
+#include <compiler/coroutines/CoroutineFrame.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cpp20::compiler::coroutines {
+
+// ============================================================================
+// ChaseLevDeque
+// ============================================================================
+
+/**
+ * @brief Cola de trabajo de Chase-Lev sin locks
+ *
+ * Un único dueño mete y saca por el fondo (LIFO, la corrutina recién
+ * encolada sigue caliente en caché); cualquier otro hilo roba por la
+ * cima (FIFO). El array crece al llenarse y los anteriores se liberan al
+ * destruir la cola, porque un ladrón puede estar leyendo de ellos.
+ * Órdenes de memoria de Lê et al., "Correct and Efficient Work-Stealing
+ * for Weak Memory Models" (PPoPP 2013).
+ */
+template <typename T>
+class ChaseLevDeque {
+    static_assert(std::is_trivially_copyable_v<T>, "ChaseLevDeque guarda valores trivialmente copiables");
+
+public:
+    explicit ChaseLevDeque(size_t capacity = 256) {
+        size_t rounded = 1;
+        while (rounded < capacity) rounded <<= 1;
+        buffers_.push_back(std::make_unique<Buffer>(rounded));
+        buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+    }
+
+    ChaseLevDeque(const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+    /**
+     * @brief Mete por el fondo (solo el dueño)
+     */
+    void push(T value) {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        int64_t top = top_.load(std::memory_order_acquire);
+        Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+        if (bottom - top > static_cast<int64_t>(buffer->mask)) {
+            buffers_.push_back(buffer->grow(top, bottom));
+            buffer = buffers_.back().get();
+            buffer_.store(buffer, std::memory_order_release);
+        }
+        buffer->store(bottom, value);
+        bottom_.store(bottom + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Saca por el fondo (solo el dueño)
+     */
+    std::optional<T> pop() {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = top_.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        T value = buffer->load(bottom);
+        if (top == bottom) {
+            // Último elemento: se disputa con los ladrones
+            bool won = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed);
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            if (!won) return std::nullopt;
+        }
+        return value;
+    }
+
+    /**
+     * @brief Roba por la cima (cualquier hilo)
+     */
+    std::optional<T> steal() {
+        int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = bottom_.load(std::memory_order_acquire);
+        if (top >= bottom) return std::nullopt;
+
+        T value = buffer_.load(std::memory_order_acquire)->load(top);
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    /**
+     * @brief Elementos en la cola; aproximado si otros hilos la tocan
+     */
+    size_t sizeApprox() const {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        int64_t top = top_.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+    }
+
+    bool emptyApprox() const { return sizeApprox() == 0; }
+
+private:
+    struct Buffer {
+        size_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+
+        explicit Buffer(size_t capacity) : mask(capacity - 1), slots(new std::atomic<T>[capacity]) {}
+
+        T load(int64_t index) const { return slots[index & mask].load(std::memory_order_relaxed); }
+        void store(int64_t index, T value) { slots[index & mask].store(value, std::memory_order_relaxed); }
+
+        std::unique_ptr<Buffer> grow(int64_t top, int64_t bottom) const {
+            auto bigger = std::make_unique<Buffer>((mask + 1) * 2);
+            for (int64_t i = top; i < bottom; ++i) {
+                bigger->store(i, load(i));
+            }
+            return bigger;
+        }
+    };
+
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+    std::atomic<Buffer*> buffer_{nullptr};
+    std::vector<std::unique_ptr<Buffer>> buffers_;   // Del dueño; el último es el actual
+};
+
+// ============================================================================
+// TimerWheel
+// ============================================================================
+
+/**
+ * @brief Rueda de temporizadores de un nivel
+ *
+ * Cada hueco cubre un tick; un vencimiento a más de una vuelta espera en
+ * su hueco hasta que el tick actual lo alcanza. Añadir es O(1) y avanzar
+ * cuesta un hueco por tick transcurrido. No es segura entre hilos: el
+ * planificador la protege con su mutex.
+ */
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit TimerWheel(std::chrono::microseconds tick = std::chrono::microseconds(50), size_t slots = 256,
+                        Clock::time_point start = Clock::now());
+
+    /**
+     * @brief Programa item para deadline; si ya pasó, vence en el próximo advance
+     */
+    void add(Clock::time_point deadline, void* item);
+
+    /**
+     * @brief Añade a expired los elementos vencidos hasta now
+     */
+    void advance(Clock::time_point now, std::vector<void*>& expired);
+
+    /**
+     * @brief Vencimiento más próximo, redondeado al tick
+     */
+    std::optional<Clock::time_point> nextDeadline() const;
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    struct Entry {
+        uint64_t tick;
+        void* item;
+    };
+
+    std::chrono::microseconds tick_;
+    Clock::time_point start_;
+    uint64_t current_ = 0;                  // Primer tick sin procesar
+    std::vector<std::vector<Entry>> slots_;
+    size_t size_ = 0;
+
+    uint64_t tickOf(Clock::time_point time) const;
+    void expireSlot(size_t slot, uint64_t upTo, std::vector<void*>& expired);
+};
+
+// ============================================================================
+// CoroutineScheduler
+// ============================================================================
+
+/**
+ * @brief Corrutina lanzada con CoroutineScheduler::spawn
+ *
+ * Empieza suspendida hasta que el planificador la reanuda y libera su
+ * marco al terminar; una excepción sin capturar termina el programa,
+ * como en un std::thread. Los marcos salen de CoroutineFrameAllocator.
+ */
+class ScheduledTask {
+public:
+    struct promise_type {
+        static void* operator new(size_t size) { return CoroutineFrameAllocator::allocate(size); }
+        static void operator delete(void* frame, size_t size) noexcept {
+            CoroutineFrameAllocator::deallocate(frame, size);
+        }
+
+        ScheduledTask get_return_object() {
+            return ScheduledTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+
+    ScheduledTask(ScheduledTask&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    ScheduledTask& operator=(ScheduledTask&&) = delete;
+    ~ScheduledTask() {
+        if (handle_) handle_.destroy();
+    }
+
+    /**
+     * @brief Cede el marco: desde aquí lo libera la propia corrutina al terminar
+     */
+    std::coroutine_handle<> release() { return std::exchange(handle_, nullptr); }
+
+private:
+    explicit ScheduledTask(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+/**
+ * @brief Estadísticas del planificador
+ */
+struct SchedulerStatistics {
+    uint64_t resumed = 0;       // Reanudaciones
+    uint64_t stolen = 0;        // De ellas, robadas de la cola de otro hilo
+    uint64_t timersFired = 0;   // Temporizadores vencidos
+};
+
+/**
+ * @brief Planificador de corrutinas con una cola de Chase-Lev por hilo
+ *
+ * Lo que encola un hilo del planificador va a su propia cola y lo que
+ * llega de fuera a una cola compartida. Un hilo sin trabajo roba de los
+ * demás empezando por uno al azar y, si no encuentra nada, duerme en una
+ * variable de condición hasta que llega trabajo o vence el próximo
+ * temporizador: las esperas no usan sleep_for y la latencia de
+ * despertar es la de la variable de condición más un tick de la rueda.
+ */
+class CoroutineScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @param workerCount Hilos (0 = hardware_concurrency)
+     * @param timerTick Resolución de la rueda de temporizadores
+     */
+    explicit CoroutineScheduler(size_t workerCount = 0,
+                                std::chrono::microseconds timerTick = std::chrono::microseconds(50));
+
+    /**
+     * @brief Espera a que no quede trabajo ni temporizadores y para los hilos
+     */
+    ~CoroutineScheduler();
+
+    CoroutineScheduler(const CoroutineScheduler&) = delete;
+    CoroutineScheduler& operator=(const CoroutineScheduler&) = delete;
+
+    /**
+     * @brief Encola una corrutina suspendida para reanudarla en algún hilo
+     */
+    void schedule(std::coroutine_handle<> handle);
+
+    /**
+     * @brief Reanuda la corrutina cuando llegue deadline
+     */
+    void scheduleAt(Clock::time_point deadline, std::coroutine_handle<> handle);
+
+    /**
+     * @brief Lanza una corrutina; el planificador se queda con su marco
+     */
+    void spawn(ScheduledTask task) { schedule(task.release()); }
+
+    /**
+     * @brief Bloquea hasta que no quede nada encolado, ejecutándose ni programado
+     */
+    void waitIdle();
+
+    size_t workerCount() const { return workers_.size(); }
+    SchedulerStatistics getStatistics() const;
+
+    /**
+     * @brief co_await scheduler.yield(): cede el hilo y vuelve a la cola
+     *
+     * Desde fuera del planificador sirve para pasar la corrutina a sus hilos.
+     */
+    auto yield() {
+        struct Awaiter {
+            CoroutineScheduler& scheduler;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { scheduler.schedule(handle); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{*this};
+    }
+
+    /**
+     * @brief co_await scheduler.sleepFor(d): suspende sin ocupar un hilo
+     */
+    auto sleepFor(std::chrono::microseconds duration) {
+        struct Awaiter {
+            CoroutineScheduler& scheduler;
+            Clock::time_point deadline;
+            bool await_ready() const noexcept { return deadline <= Clock::now(); }
+            void await_suspend(std::coroutine_handle<> handle) { scheduler.scheduleAt(deadline, handle); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{*this, Clock::now() + duration};
+    }
+
+private:
+    struct Worker {
+        ChaseLevDeque<void*> queue;
+        std::thread thread;
+        uint64_t randomState;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::mutex mutex_;                          // Protege injected_, timers_ y stopping_
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::deque<void*> injected_;                // Trabajo encolado desde fuera
+    TimerWheel timers_;
+    bool stopping_ = false;
+    std::atomic<size_t> pending_{0};            // Encoladas, en ejecución o con temporizador
+    std::atomic<size_t> sleeping_{0};
+    std::atomic<uint64_t> resumed_{0};
+    std::atomic<uint64_t> stolen_{0};
+    std::atomic<uint64_t> timersFired_{0};
+
+    void workerLoop(size_t index);
+    void* findWork(size_t index);
+    bool anyQueuedWork() const;
+    void wakeOne();
+    void finishOne();
+};
+
+} // namespace cpp20::compiler::coroutines
@@ -9,7 +9,9 @@
 #include <compiler/ast/ASTNode.h>
 #include <compiler/types/Type.h>
 #include <compiler/symbols/Symbol.h>
+#include <cstdint>
 #include <vector>
+#include <string>
 #include <unordered_map>
 #include <memory>
 #include <filesystem>
@@ -193,6 +195,7 @@ struct DebugSymbol {
     uint32_t address;
     uint32_t size;
     std::string typeName;
+    uint32_t typeIndex = 0;     // DebugType::typeIndex de la unidad; 0 = sin tipo
     std::vector<uint8_t> data;
 
     DebugSymbol(CodeViewRecordType t, const std::string& n = "",
@@ -207,6 +210,7 @@ struct DebugType {
     CodeViewRecordType type;
     uint32_t typeIndex;
     std::vector<uint8_t> data;
+    std::vector<uint32_t> referenceOffsets;    // Offsets en data de índices de tipo (uint32) a otros registros
 
     DebugType(CodeViewRecordType t, uint32_t idx = 0)
         : type(t), typeIndex(idx) {}
@@ -219,12 +223,62 @@ struct DebugObjectFile {
     std::filesystem::path path;
     std::vector<DebugSymbol> symbols;
     std::vector<DebugType> types;
+    std::vector<uint64_t> typeHashes;          // .debug$H: hash global de cada tipo, en orden de typeIndex
     std::vector<SourceLineInfo> lineInfo;
     std::unordered_map<std::string, uint32_t> fileNameToIndex;
 
     DebugObjectFile(const std::filesystem::path& p) : path(p) {}
 };
 
+/**
+ * @brief Tabla de registros de tipo CodeView sin repeticiones
+ *
+ * La clave de cada registro son sus bytes serializados, con las
+ * referencias a otros tipos ya traducidas a índices de la tabla: el
+ * mismo std::string o std::vector<int> recibe un único índice aunque lo
+ * aporten varias funciones o varios objetos.
+ */
+class CodeViewTypeTable {
+public:
+    static constexpr uint32_t kFirstTypeIndex = 0x1000;    // Los anteriores son tipos simples
+
+    /**
+     * @brief Añade los registros de una unidad
+     *
+     * Se recorren por typeIndex creciente, de modo que las referencias a
+     * tipos anteriores ya están traducidas cuando se calcula la clave.
+     * @return Índice en la tabla de cada typeIndex de la unidad
+     */
+    std::unordered_map<uint32_t, uint32_t> merge(const std::vector<DebugType>& types);
+
+    /**
+     * @brief Registros en orden de índice (sin la firma de .debug$T)
+     */
+    std::vector<uint8_t> serialize() const;
+
+    /**
+     * @brief Hash global (GHASH) de cada registro, en orden de índice
+     *
+     * Cubre los bytes del registro con las referencias sustituidas por el
+     * hash del tipo referenciado, así que no depende de los índices
+     * locales: el mismo tipo da el mismo hash en cualquier objeto.
+     */
+    std::vector<uint64_t> globalHashes() const;
+
+    /**
+     * @brief Hash global de los tipos de un objeto, en orden de typeIndex
+     */
+    static std::vector<uint64_t> hashTypes(const std::vector<DebugType>& types);
+
+    size_t size() const { return records_.size(); }
+    void clear();
+
+private:
+    std::unordered_map<std::string, uint32_t> indices_;    // Registro serializado -> índice
+    std::vector<const std::string*> records_;              // Claves de indices_, por índice
+    std::vector<std::vector<uint32_t>> references_;        // referenceOffsets de cada registro
+};
+
 /**
  * @brief Emisor de información de debug CodeView
  */
@@ -242,30 +296,83 @@ public:
 
     /**
      * @brief Añade información de debug de un archivo fuente
+     *
+     * Las líneas se codifican al momento como un bloque; no se guardan.
      */
     void addSourceFile(const std::filesystem::path& sourceFile,
                       const std::vector<SourceLineInfo>& lineInfo);
 
+    /**
+     * @brief Empieza la tabla de líneas de una función
+     *
+     * El encoder la va llenando con addLine mientras emite código; al
+     * cerrarla con endFunctionLines se codifica y solo queda en memoria la
+     * forma compacta.
+     */
+    void beginFunctionLines(uint32_t address);
+
+    /**
+     * @brief Registra que el código desde address corresponde a line
+     */
+    void addLine(const std::string& fileName, uint32_t address, uint32_t line);
+
+    /**
+     * @brief Cierra la función en curso (codeSize bytes desde su dirección)
+     */
+    void endFunctionLines(uint32_t codeSize);
+
     /**
      * @brief Añade símbolo de debug
+     *
+     * Con setLineTablesOnly solo se guardan los procedimientos, sin tipo.
      */
     void addDebugSymbol(const DebugSymbol& symbol);
 
     /**
      * @brief Añade tipo de debug
+     * @return Su typeIndex en la unidad (se asigna uno si venía a 0); 0 y
+     *         nada guardado con setLineTablesOnly
+     */
+    uint32_t addDebugType(const DebugType& type);
+
+    /**
+     * @brief Solo tablas de líneas (-gline-tables-only)
+     *
+     * Basta para simbolizar pilas: S_GPROC32/S_LPROC32 y las líneas, sin
+     * variables ni datos; .debug$T y .debug$H quedan vacías.
      */
-    void addDebugType(const DebugType& type);
+    void setLineTablesOnly(bool only) { lineTablesOnly_ = only; }
+
+    /**
+     * @brief Hilos para serializar las funciones de .debug$S
+     */
+    void setJobs(size_t jobs) { jobs_ = jobs == 0 ? 1 : jobs; }
 
     /**
      * @brief Genera sección .debug$S (símbolos)
+     *
+     * Una subsección DEBUG_S_SYMBOLS por función (el procedimiento, sus
+     * símbolos y S_END) o por dato global; se serializan en paralelo y se
+     * concatenan en orden, así que el resultado no depende de los hilos.
      */
     std::vector<uint8_t> generateDebugSSymbols();
 
     /**
      * @brief Genera sección .debug$T (tipos)
+     *
+     * Cada registro distinto aparece una vez; los símbolos usan los
+     * índices ya traducidos.
      */
     std::vector<uint8_t> generateDebugTTypes();
 
+    /**
+     * @brief Genera sección .debug$H (hash global de cada registro de .debug$T)
+     *
+     * Calculados al compilar, permiten al enlazador fusionar los tipos de
+     * todos los objetos sin volver a recorrer los bytes de cada registro.
+     */
+    std::vector<uint8_t> generateDebugHHashes();
+
     /**
      * @brief Genera sección .debug$F (nombres de archivos)
      */
@@ -273,6 +380,8 @@ public:
 
     /**
      * @brief Genera información de línea completa
+     *
+     * Concatena las subsecciones DEBUG_S_LINES ya codificadas.
      */
     std::vector<uint8_t> generateLineNumbers();
 
@@ -300,10 +409,32 @@ private:
     std::string targetArch_;
     std::vector<DebugSymbol> debugSymbols_;
     std::vector<DebugType> debugTypes_;
-    std::vector<SourceLineInfo> sourceLines_;
+    std::vector<SourceLineInfo> pendingLines_;           // Solo la función en curso
+    std::vector<uint8_t> lineSubsections_;               // DEBUG_S_LINES ya codificadas
+    size_t lineCount_ = 0;
+    uint32_t functionAddress_ = 0;
     std::unordered_map<std::string, uint32_t> fileNameMap_;
+    std::vector<uint32_t> fileChecksums_;                // Por índice de archivo - 1
     uint32_t nextTypeIndex_;
     uint32_t nextFileIndex_;
+    size_t jobs_ = 1;
+    bool lineTablesOnly_ = false;
+    size_t skippedRecords_ = 0;                          // Tipos y símbolos descartados por lineTablesOnly_
+
+    // Tipos sin repetir y traducción de los índices de la unidad
+    CodeViewTypeTable typeTable_;
+    std::unordered_map<uint32_t, uint32_t> typeIndexMap_;
+    bool typesMerged_ = false;
+
+    /**
+     * @brief Deduplica debugTypes_ en typeTable_ (una vez por cambio)
+     */
+    void mergeTypes();
+
+    /**
+     * @brief Índice en typeTable_ de un typeIndex de la unidad
+     */
+    uint32_t remapTypeIndex(uint32_t typeIndex) const;
 
     /**
      * @brief Crea header de subsección CodeView
@@ -312,8 +443,10 @@ private:
 
     /**
      * @brief Serializa un símbolo CodeView
+     *
+     * Solo lee: se llama desde varios hilos a la vez.
      */
-    std::vector<uint8_t> serializeSymbol(const DebugSymbol& symbol);
+    std::vector<uint8_t> serializeSymbol(const DebugSymbol& symbol) const;
 
     /**
      * @brief Serializa un tipo CodeView
@@ -321,12 +454,9 @@ private:
     std::vector<uint8_t> serializeType(const DebugType& type);
 
     /**
-     * @brief Serializa información de línea
-     */
-    std::vector<uint8_t> serializeLineInfo(const SourceLineInfo& lineInfo);
-
-    /**
-     * @brief Obtiene índice de archivo
+     * @brief Obtiene índice de archivo, registrándolo la primera vez
+     *
+     * El checksum del archivo se calcula solo en ese primer uso.
      */
     uint32_t getFileIndex(const std::string& fileName);
 
@@ -337,8 +467,13 @@ private:
 
     /**
      * @brief Comprime información de línea
+     *
+     * Una subsección DEBUG_S_LINES sin columnas: un bloque por cada racha
+     * de líneas del mismo archivo, direcciones relativas a la primera y
+     * sin entradas que repitan la línea anterior.
+     * @param codeSize Bytes de código cubiertos (0: hasta la última dirección)
      */
-    std::vector<uint8_t> compressLineInfo(const std::vector<SourceLineInfo>& lines);
+    std::vector<uint8_t> compressLineInfo(const std::vector<SourceLineInfo>& lines, uint32_t codeSize = 0);
 };
 
 /**
@@ -363,6 +498,10 @@ public:
 
     /**
      * @brief Genera archivo PDB
+     *
+     * Los streams se construyen a la vez y sus páginas MSF se reparten
+     * antes de escribir; después cada uno se copia en paralelo a su sitio
+     * del archivo proyectado y se libera en cuanto está escrito.
      */
     bool generatePDB(const std::filesystem::path& pdbPath);
 
@@ -376,9 +515,15 @@ public:
      */
     void setTimestamp(uint32_t timestamp);
 
+    /**
+     * @brief Hilos para construir y escribir los streams
+     */
+    void setJobs(size_t jobs) { jobs_ = jobs == 0 ? 1 : jobs; }
+
 private:
     std::string moduleName_;
     uint32_t timestamp_;
+    size_t jobs_ = 1;
     std::vector<DebugObjectFile> debugObjects_;
 
     /**
@@ -392,7 +537,20 @@ private:
     std::vector<uint8_t> createGlobalSymbolStream();
 
     /**
-     * @brief Crea stream de tipos
+     * @brief Crea la tabla hash de los símbolos globales (GSI)
+     *
+     * Los hashes de los nombres se calculan en paralelo y cada hilo
+     * ordena un rango de cubetas.
+     */
+    std::vector<uint8_t> createGlobalHashStream(const std::vector<uint8_t>& symbols);
+
+    /**
+     * @brief Crea stream de tipos (TPI, con su cabecera)
+     *
+     * Cada tipo distinto entre todos los objetos aparece una vez. La
+     * identidad es el hash global (typeHashes, o calculado si el objeto no
+     * traía .debug$H); las inserciones se reparten en tablas por rango de
+     * hash que se llenan en paralelo.
      */
     std::vector<uint8_t> createTypeStream();
 
@@ -454,6 +612,12 @@ public:
      * @brief Formatea registro CodeView como string
      */
     static std::string formatRecord(const std::vector<uint8_t>& record);
+
+    /**
+     * @brief Lee los hashes de una sección .debug$H
+     * @return false si la cabecera no es válida o usa otro algoritmo
+     */
+    static bool parseGlobalHashes(const std::vector<uint8_t>& section, std::vector<uint64_t>& hashes);
 };
 
 /**
@@ -478,6 +642,8 @@ public:
 
     /**
      * @brief Establece nivel de debug
+     *
+     * 1 (-g1, -gline-tables-only): solo funciones y líneas; 2 o más: completo.
      */
     void setDebugLevel(int level);
 
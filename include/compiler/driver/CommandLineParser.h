@@ -1,12 +1,57 @@
 #pragma once
 
 #include <compiler/driver/CompilerDriver.h>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
-#include <filesystem>
 
 namespace cpp20::compiler {
 
+/**
+ * @brief Caché de resultados de CommandLineParser, para el modo servidor
+ *
+ * La clave es la lista de argumentos; cada entrada guarda el hash del
+ * contenido de los archivos de respuesta que se expandieron, y solo se
+ * reutiliza si todos siguen igual. Solo se guardan parseos correctos.
+ * Thread-safe.
+ */
+class ParsedOptionsCache {
+public:
+    static constexpr size_t kMaxEntries = 256;
+
+    /**
+     * @brief Instancia del proceso (la usan el servidor y los drivers que atiende)
+     */
+    static ParsedOptionsCache& shared();
+
+    struct ResponseFileStamp {
+        std::filesystem::path path;
+        uint64_t contentHash = 0;
+    };
+
+    std::optional<CompilerOptions> lookup(uint64_t key) const;
+    void store(uint64_t key, const CompilerOptions& options, std::vector<ResponseFileStamp> responseFiles);
+    void clear();
+
+    size_t hitCount() const;
+    size_t size() const;
+
+private:
+    struct Entry {
+        CompilerOptions options;
+        std::vector<ResponseFileStamp> responseFiles;
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, Entry> entries_;
+    mutable size_t hits_ = 0;
+};
+
 /**
  * @brief Parser avanzado de línea de comandos para el compilador C++20
  *
@@ -18,11 +63,18 @@ namespace cpp20::compiler {
  * - Opciones de preprocesador (-D, -U)
  * - Opciones de warning (-W, -w)
  * - Archivos de respuesta (@file.rsp)
+ *
+ * Cada argumento se resuelve con búsquedas en tablas hash construidas una
+ * vez (flags, opciones con valor y prefijos pegados como -I o -D), sobre
+ * string_view y sin copiarlo. Los archivos de respuesta se proyectan en
+ * memoria y se trocean en vistas sobre la proyección; solo se copian los
+ * valores que se guardan en CompilerOptions. Las rutas -I y las
+ * definiciones -D repetidas se guardan una vez.
  */
 class CommandLineParser {
 public:
     CommandLineParser();
-    ~CommandLineParser() = default;
+    ~CommandLineParser();
 
     /**
      * @brief Parsea los argumentos de línea de comandos
@@ -41,6 +93,23 @@ public:
      */
     bool parseResponseFile(const std::filesystem::path& responseFile, CompilerOptions& options);
 
+    /**
+     * @brief Reutilizar parseos anteriores de los mismos argumentos
+     *
+     * Con caché, parse() asigna el resultado guardado a options, que debe
+     * llegar recién construido.
+     */
+    void setCache(ParsedOptionsCache* cache) { cache_ = cache; }
+
+    /**
+     * @brief Trocea el contenido de un archivo de respuesta
+     *
+     * Argumentos separados por espacios o saltos de línea; "#" al inicio de
+     * un argumento comenta hasta el fin de la línea y las comillas dobles
+     * agrupan un argumento con espacios. Las vistas apuntan a content.
+     */
+    static std::vector<std::string_view> tokenizeResponseFile(std::string_view content);
+
     /**
      * @brief Muestra la ayuda completa del compilador
      */
@@ -58,67 +127,40 @@ public:
     void showOptionHelp(const std::string& option) const;
 
 private:
-    /**
-     * @brief Parsea un argumento individual
-     * @param arg Argumento a parsear
-     * @param options Opciones donde almacenar
-     * @return true si se procesó correctamente
-     */
-    bool parseArgument(const std::string& arg, CompilerOptions& options);
+    struct ParseState;
 
     /**
-     * @brief Parsea un flag (argumento que no toma valor)
-     * @param flag Flag a parsear
-     * @param options Opciones donde almacenar
-     * @return true si se reconoció el flag
+     * @brief Parsea una lista de argumentos (sin argv[0]) sin validar el resultado
      */
-    bool parseFlag(const std::string& flag, CompilerOptions& options);
+    bool parseArguments(const std::vector<std::string_view>& args, ParseState& state);
 
     /**
-     * @brief Parsea una opción con valor separado
-     * @param option Opción a parsear
-     * @param value Valor de la opción
-     * @param options Opciones donde almacenar
-     * @return true si se procesó correctamente
+     * @brief Expande un archivo de respuesta dentro del parseo en curso
      */
-    bool parseOption(const std::string& option, const std::string& value, CompilerOptions& options);
+    bool expandResponseFile(const std::filesystem::path& path, ParseState& state);
 
     /**
-     * @brief Parsea una opción con valor integrado (= o pegado)
-     * @param arg Argumento completo (ej: -std=c++20)
-     * @param options Opciones donde almacenar
-     * @return true si se procesó correctamente
+     * @brief Parsea un argumento que empieza por '-'
+     * @param next Siguiente argumento, para las opciones con valor separado (-o archivo)
+     * @param consumedNext Se pone a true si el valor era next
+     * @return true si se reconoció el argumento
      */
-    bool parseCompoundOption(const std::string& arg, CompilerOptions& options);
+    bool parseArgument(std::string_view arg, const std::string_view* next, bool& consumedNext,
+                       ParseState& state);
 
     /**
      * @brief Verifica si un string es un archivo fuente válido
      * @param filename Nombre del archivo
      * @return true si es un archivo fuente válido
      */
-    bool isSourceFile(const std::string& filename) const;
+    bool isSourceFile(std::string_view filename) const;
 
     /**
      * @brief Verifica si un string es un archivo de respuesta
      * @param filename Nombre del archivo
      * @return true si es un archivo de respuesta
      */
-    bool isResponseFile(const std::string& filename) const;
-
-    /**
-     * @brief Lee y parsea las líneas de un archivo de respuesta
-     * @param path Ruta al archivo
-     * @return Vector de argumentos parseados
-     */
-    std::vector<std::string> readResponseFile(const std::filesystem::path& path) const;
-
-    /**
-     * @brief Parsea opciones de warning
-     * @param warningSpec Especificación del warning (ej: "no-unused-variable")
-     * @param enable Si se debe habilitar o deshabilitar
-     * @param options Opciones donde almacenar
-     */
-    void parseWarningOption(const std::string& warningSpec, bool enable, CompilerOptions& options);
+    bool isResponseFile(std::string_view filename) const;
 
     /**
      * @brief Valida la consistencia de las opciones
@@ -128,7 +170,8 @@ private:
     bool validateOptions(const CompilerOptions& options) const;
 
     // Estado interno
-    std::vector<std::filesystem::path> processedResponseFiles_; // Para evitar recursión
+    std::vector<std::filesystem::path> activeResponseFiles_; // Para evitar recursión
+    ParsedOptionsCache* cache_ = nullptr;
 };
 
 } // namespace cpp20::compiler
\ No newline at end of file
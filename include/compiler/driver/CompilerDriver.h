@@ -2,6 +2,7 @@
 
 #include <compiler/common/diagnostics/DiagnosticEngine.h>
 #include <compiler/common/diagnostics/SourceManager.h>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -9,12 +10,23 @@
 
 namespace cpp20::compiler {
 
+class TimingProfiler;
+struct TelemetryRecord;
+class ObjectCache;
+
+namespace frontend {
+class ConditionCache;
+class HeaderUnitTable;
+}
+
 /**
  * @brief Opciones de configuración del compilador
  */
 struct CompilerOptions {
     // Fases de compilación
     bool preprocessOnly = false;        // -E: solo preprocesamiento
+    bool preprocessedTokens = false;    // -fpreprocessed-tokens: -E como flujo binario de tokens
+    bool dependencyScan = false;        // -M: solo reglas de dependencias
     bool compileOnly = false;           // -c: compilar a objeto, no linkear
     bool assembleOnly = false;          // -S: generar ensamblador
     bool linkOnly = false;              // Solo linking
@@ -27,7 +39,15 @@ struct CompilerOptions {
     // Optimización
     int optimizationLevel = 0;          // -O0, -O1, -O2, -O3
     bool debugInfo = false;             // -g: incluir información de debug
+    bool lineTablesOnly = false;        // -gline-tables-only: solo funciones y líneas, sin tipos ni locales
     bool lto = false;                   // -flto: link-time optimization
+    bool profileGenerate = false;       // -fprofile-generate: contadores por bloque en el IR
+    std::filesystem::path profileUse;   // -fprofile-use=: perfil que guía la optimización
+    bool incrementalLink = false;       // -fincremental-link: reescribir solo lo que cambia del ejecutable
+    std::filesystem::path orderFile;    // -forder-file=: orden de funciones en .text
+    std::vector<std::string> delayLoadDlls;     // -fdelay-load=: DLL cargadas en su primera llamada
+    std::string arch = "x86-64";        // -march=: extensiones que puede usar el código (native: las locales)
+    std::string tune;                   // -mtune=: microarquitectura para el planificador (vacío: según -march)
 
     // Lenguaje
     std::string standard = "c++20";     // -std=c++20
@@ -45,6 +65,11 @@ struct CompilerOptions {
     std::vector<std::string> includePaths;     // -I: directorios de include
     std::vector<std::string> defines;          // -D: definiciones de macro
     std::vector<std::string> undefines;        // -U: undefinir macros
+    std::filesystem::path includeCacheFile;    // -finclude-cache=: resolución de includes persistente
+    std::filesystem::path snapshotDirectory;   // -fpp-snapshot-dir=: instantáneas del prólogo de #include
+    std::filesystem::path autoHeaderUnitsFile; // -fauto-header-units=: uso de headers y los promovidos a header unit
+    std::filesystem::path objectCacheDirectory;    // -fobject-cache=: objetos de unidades ya compiladas
+    std::filesystem::path codegenCacheDirectory;   // -fcodegen-cache=: código máquina por función (LTO)
 
     // Linking
     std::vector<std::string> libraryPaths;     // -L: directorios de librerías
@@ -62,8 +87,19 @@ struct CompilerOptions {
 
     // Avanzado
     size_t maxErrors = 100;             // Máximo número de errores
+    size_t jobs = 1;                    // -j N: unidades de traducción en paralelo
     bool timing = false;                // -ftime-report: reportar tiempos
+    bool timingEntities = false;        // -ftime-report=entities: además, las entidades más caras
+    bool timeTrace = false;             // -ftime-trace: traza por hilo en formato de Chrome
+    std::filesystem::path timeTraceFile;    // -ftime-trace=: destino de la traza (por defecto <objeto>.json)
+    bool memoryReport = false;          // -fmemory-report: memoria por subsistema y pico por fase
+    std::filesystem::path telemetryFile;    // -ftelemetry=: métricas por unidad para todo el build
+    bool delayFunctionBodies = false;   // -fdelayed-function-bodies: parsear cuerpos solo si se usan
+    size_t arenaReserveMB = 0;          // -farena-reserve=<MB>: región reservada por arena de unidad, en el nodo NUMA del worker
+    bool arenaLargePages = false;       // -farena-large-pages: respaldar esa región con páginas grandes
     std::string saveTemps;              // -save-temps: guardar archivos temporales
+    std::filesystem::path serverSocket;     // -fserver=: atender compilaciones con cachés residentes
+    std::filesystem::path useServerSocket;  // -fuse-server=: reenviar la invocación a un servidor
 
     // Ayuda y versión
     bool showHelp = false;              // -h, --help: mostrar ayuda
@@ -84,6 +120,21 @@ struct CompilationResult {
     double compilationTime = 0.0;  // en segundos
 };
 
+/**
+ * @brief Resultado de compilar una unidad de traducción
+ *
+ * Cada worker acumula sus diagnósticos en un shard propio; el driver
+ * los vuelca al DiagnosticEngine principal en el orden de entrada.
+ */
+struct TranslationUnitResult {
+    std::filesystem::path inputFile;
+    std::filesystem::path objectFile;
+    std::vector<uint8_t> objectImage;   // Enlace en el proceso: el objeto, sin escribir objectFile
+    std::vector<diagnostics::Diagnostic> diagnostics;
+    std::unique_ptr<TimingProfiler> profile;    // Fases de esta unidad, solo con -ftelemetry
+    bool success = false;
+};
+
 /**
  * @brief Driver principal del compilador
  *
@@ -118,10 +169,27 @@ public:
         const CompilerOptions& options
     );
 
+    /**
+     * @brief SourceManager del driver (el servidor invalida en él los archivos que cambian)
+     */
+    const std::shared_ptr<diagnostics::SourceManager>& sourceManager() const { return sourceManager_; }
+
 private:
     // Componentes principales
     std::shared_ptr<diagnostics::SourceManager> sourceManager_;
     std::shared_ptr<diagnostics::DiagnosticEngine> diagnosticEngine_;
+    std::shared_ptr<diagnostics::IncludeResolutionCache> includeCache_;
+    std::unique_ptr<ObjectCache> objectCache_;      // Solo con -fobject-cache
+    std::shared_ptr<frontend::ConditionCache> conditionCache_;  // #if ya evaluados, común a las unidades
+    std::shared_ptr<frontend::HeaderUnitTable> headerUnits_;    // Solo con -fauto-header-units
+
+    // Profiler de la invocación en curso (solo con -ftime-report o -ftime-trace)
+    std::unique_ptr<TimingProfiler> profiler_;
+
+    // Objetos generados por la última compilación (en orden de entrada);
+    // si se compiló para enlazar en el proceso, sus bytes en objectImages_
+    std::vector<std::filesystem::path> objectFiles_;
+    std::vector<std::vector<uint8_t>> objectImages_;
 
     // Métodos internos
     CompilerOptions parseCommandLine(int argc, char* argv[]);
@@ -134,13 +202,61 @@ private:
     // Fases de compilación
     bool runPreprocessing(const std::vector<std::filesystem::path>& inputs,
                          const CompilerOptions& options);
+    bool runDependencyScan(const std::vector<std::filesystem::path>& inputs,
+                          const CompilerOptions& options);
     bool runCompilation(const std::vector<std::filesystem::path>& inputs,
-                       const CompilerOptions& options);
+                       const CompilerOptions& options,
+                       bool inMemory = false);
     bool runAssembly(const std::vector<std::filesystem::path>& inputs,
                     const CompilerOptions& options);
     bool runLinking(const std::vector<std::filesystem::path>& inputs,
                    const CompilerOptions& options);
 
+    /**
+     * @brief Compila una unidad de traducción completa en su propio shard
+     *
+     * Seguro para llamarse desde varios hilos: solo lee del SourceManager
+     * (los archivos ya están cargados) y usa un DiagnosticEngine local.
+     * Con inMemory el objeto queda en objectImage en lugar de escribirse.
+     */
+    TranslationUnitResult compileTranslationUnit(const std::filesystem::path& input,
+                                                 uint32_t fileId,
+                                                 const CompilerOptions& options,
+                                                 const std::vector<std::filesystem::path>& inputs,
+                                                 bool inMemory = false) const;
+
+    /**
+     * @brief Front-end y backend de compileTranslationUnit por separado
+     *
+     * ParsedUnit guarda el AST con su arena y su shard hasta que
+     * emitTranslationUnit genera el objeto.
+     */
+    struct ParsedUnit;
+    std::unique_ptr<ParsedUnit> parseTranslationUnit(const std::filesystem::path& input,
+                                                     uint32_t fileId,
+                                                     const CompilerOptions& options,
+                                                     const std::vector<std::filesystem::path>& inputs) const;
+    TranslationUnitResult emitTranslationUnit(ParsedUnit& unit, const CompilerOptions& options,
+                                              bool inMemory) const;
+
+    /**
+     * @brief Compila varias unidades sin -j con las fases solapadas
+     *
+     * Lectura, front-end, emisión y escritura del objeto van cada una en
+     * su hilo, unidas por colas acotadas: mientras la unidad N se emite, la
+     * N+1 se parsea, la N+2 se lee y el objeto de la N-1 se escribe.
+     * @return false si falta una entrada (las anteriores ya se compilaron)
+     */
+    bool compilePipelined(const std::vector<std::filesystem::path>& inputs,
+                          const CompilerOptions& options,
+                          bool inMemory,
+                          std::vector<uint32_t>& fileIds,
+                          std::vector<TranslationUnitResult>& results);
+    void mergeDiagnostics(const std::vector<TranslationUnitResult>& results);
+    std::filesystem::path objectFileFor(const std::filesystem::path& input,
+                                        const CompilerOptions& options,
+                                        const std::vector<std::filesystem::path>& inputs) const;
+
     // Utilidades
     std::vector<std::filesystem::path> collectInputFiles(int argc, char* argv[]);
     std::filesystem::path determineOutputFile(
@@ -149,6 +265,9 @@ private:
     );
     void cleanupTempFiles(const CompilerOptions& options);
     void reportTiming(double totalTime, const CompilerOptions& options) const;
+    void reportMemory() const;
+    void appendTelemetry(const std::vector<TelemetryRecord>& records, const CompilerOptions& options) const;
+    static std::string compilerVersion();
 
 };
 
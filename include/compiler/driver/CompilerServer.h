@@ -0,0 +1,150 @@
+#pragma once
+
+#include <compiler/common/utils/FileWatcher.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace cpp20::compiler {
+
+class CompilerDriver;
+
+/**
+ * @brief Invocación que un cliente reenvía al servidor
+ */
+struct ServerRequest {
+    std::filesystem::path workingDirectory;
+    std::vector<std::string> arguments;     // argv sin argv[0]
+};
+
+/**
+ * @brief Resultado de una invocación ejecutada en el servidor
+ */
+struct ServerResponse {
+    int exitCode = EXIT_FAILURE;
+    std::string standardOutput;
+    std::string standardError;
+};
+
+/**
+ * @brief Servidor residente que mantiene calientes las cachés del driver
+ *
+ * Cada invocación de cpp20-compiler con -fuse-server=<socket> se envía por
+ * un socket de dominio UNIX (AF_UNIX, también disponible en Windows 10) a
+ * un proceso lanzado con -fserver=<socket>. El servidor conserva sesiones:
+ * cada una es un CompilerDriver con su SourceManager, su caché de includes
+ * y su caché de resolución ya cargados. Las sesiones se agrupan por una
+ * clave de configuración (directorio de trabajo, rutas -I, estándar y
+ * caché de includes) para que dos proyectos no compartan resoluciones.
+ *
+ * Un FileWatcher apunta en un registro los archivos que cambian; antes de
+ * reutilizar una sesión se invalidan los que cambiaron desde su último
+ * uso. Sin inotify se comprueban las fechas de todos los archivos cargados.
+ *
+ * Las peticiones se atienden en paralelo, una por sesión. La salida de
+ * std::cout y std::cerr se redirige por hilo a la respuesta. El directorio
+ * de trabajo es global al proceso: peticiones con directorios distintos
+ * se ejecutan por turnos.
+ */
+class CompilerServer {
+public:
+    /**
+     * @param endpoint Ruta del socket
+     * @param jobs Conexiones atendidas a la vez (0 = hardware_concurrency)
+     */
+    explicit CompilerServer(std::filesystem::path endpoint, size_t jobs = 0);
+    ~CompilerServer();
+
+    CompilerServer(const CompilerServer&) = delete;
+    CompilerServer& operator=(const CompilerServer&) = delete;
+
+    /**
+     * @brief Atiende conexiones hasta stop()
+     * @return false si el socket no se pudo abrir o ya hay un servidor en él
+     */
+    bool serve();
+
+    /**
+     * @brief Pide a serve() que termine (seguro desde otro hilo)
+     */
+    void stop();
+
+    /**
+     * @brief Ejecuta una petición en este proceso con una sesión caliente
+     */
+    ServerResponse handle(const ServerRequest& request);
+
+    size_t sessionCount() const;
+
+    /**
+     * @brief Envía una petición a un servidor
+     * @return nullopt si no hay servidor o la conexión falló
+     */
+    static std::optional<ServerResponse> send(const std::filesystem::path& endpoint,
+                                              const ServerRequest& request);
+
+    /**
+     * @brief true en el hilo que ejecuta handle(): el driver no debe reenviar
+     */
+    static bool handlingRequest();
+
+    static constexpr size_t kMaxSessions = 16;
+    static constexpr size_t kMaxPendingChanges = 65536;
+
+private:
+    struct Session {
+        uint64_t key = 0;
+        std::unique_ptr<CompilerDriver> driver;
+        uint64_t appliedChanges = 0;    // Posición en el registro de cambios ya aplicada
+        bool busy = false;
+        std::chrono::steady_clock::time_point lastUsed;
+    };
+
+    std::filesystem::path endpoint_;
+    size_t jobs_;
+    std::atomic<bool> stopping_{false};
+
+    // std::cout y std::cerr enrutados por hilo hacia la respuesta en curso
+    std::unique_ptr<std::streambuf> routedOutput_;
+    std::unique_ptr<std::streambuf> routedError_;
+    std::streambuf* originalOutput_ = nullptr;
+    std::streambuf* originalError_ = nullptr;
+
+    mutable std::mutex sessionsMutex_;
+    std::vector<std::unique_ptr<Session>> sessions_;
+
+    // Registro de cambios: changes_[i] es el cambio número changesBase_ + i.
+    // Una ruta vacía, o una sesión que se quedó por detrás de changesBase_,
+    // significa "pudo cambiar cualquier archivo"
+    std::deque<std::filesystem::path> changes_;
+    uint64_t changesBase_ = 0;
+    std::unique_ptr<common::utils::FileWatcher> watcher_;
+
+    // Turnos por directorio de trabajo
+    std::mutex directoryMutex_;
+    std::condition_variable directoryReleased_;
+    std::filesystem::path currentDirectory_;
+    size_t activeInDirectory_ = 0;
+
+    uint64_t sessionKey(const ServerRequest& request) const;
+    Session* acquireSession(uint64_t key);
+    void releaseSession(Session* session);
+    void applyChanges(Session& session);
+    void watchLoadedFiles(Session& session);
+    void recordChange(const std::filesystem::path& path);
+
+    bool enterDirectory(const std::filesystem::path& directory);
+    void leaveDirectory();
+};
+
+} // namespace cpp20::compiler
@@ -0,0 +1,93 @@
+/**
+ * @file ObjectCache.h
+ * @brief Caché de objetos por unidad de traducción completa (modo directo)
+ */
+
+#pragma once
+
+#include <compiler/common/CacheBackend.h>
+#include <compiler/common/diagnostics/Diagnostic.h>
+#include <compiler/common/diagnostics/SourceManager.h>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace cpp20::compiler {
+
+/**
+ * @brief Objeto y diagnósticos de una compilación anterior
+ */
+struct CachedObject {
+    std::vector<uint8_t> image;
+    std::vector<diagnostics::Diagnostic> diagnostics;   // Con los fileId de esta sesión
+};
+
+/**
+ * @brief Caché de objetos al estilo del modo directo de ccache
+ *
+ * No hace falta preprocesar para consultarla. El manifiesto de una unidad
+ * (dirección: fuente, opciones efectivas y compilador) lista los archivos
+ * que incluyó la primera compilación; la entrada se direcciona además con
+ * el contenido actual de esos archivos y guarda el objeto, los
+ * diagnósticos a reproducir y la huella de cada dependencia real, que se
+ * comprueba antes de dar el acierto.
+ *
+ * Las direcciones y las huellas son BLAKE3, porque el directorio puede
+ * compartirse entre máquinas, y se publican con el CacheBackend, que ya
+ * escribe de forma atómica. Los manifiestos no se reescriben: si las
+ * dependencias de una unidad cambian, su entrada se sigue direccionando
+ * con la lista del manifiesto y la comprobación descarta lo que no cuadre.
+ * Puede usarse desde varios hilos a la vez.
+ */
+class ObjectCache {
+public:
+    /**
+     * @param namespaceKey Versión del compilador y opciones (SecondaryCache::namespaceKeyFor)
+     */
+    ObjectCache(std::shared_ptr<CacheBackend> backend,
+                std::shared_ptr<diagnostics::SourceManager> sources,
+                uint64_t namespaceKey);
+
+    /**
+     * @brief Busca el objeto de una unidad ya cargada
+     *
+     * Carga en el SourceManager las dependencias del manifiesto para
+     * comprobarlas; son las mismas que cargaría compilarla.
+     */
+    std::optional<CachedObject> lookup(uint32_t fileId);
+
+    /**
+     * @brief Publica el resultado de compilar una unidad
+     * @param dependencies Archivos incluidos (Preprocessor::includeGraph), en cualquier orden
+     */
+    bool store(uint32_t fileId, const std::vector<uint32_t>& dependencies,
+               const std::vector<uint8_t>& image,
+               const std::vector<diagnostics::Diagnostic>& diagnostics);
+
+    size_t hitCount() const { return hits_.load(std::memory_order_relaxed); }
+    size_t missCount() const { return misses_.load(std::memory_order_relaxed); }
+    size_t storeCount() const { return stores_.load(std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<CacheBackend> backend_;
+    std::shared_ptr<diagnostics::SourceManager> sources_;
+    uint64_t namespaceKey_;
+
+    std::atomic<size_t> hits_{0};
+    std::atomic<size_t> misses_{0};
+    std::atomic<size_t> stores_{0};
+
+    std::string manifestAddress(const diagnostics::SourceFile& source) const;
+
+    /**
+     * @brief Dirección de la entrada con la lista del manifiesto; vacía si falta un archivo
+     */
+    std::string entryAddress(const std::string& manifest,
+                             const std::vector<std::filesystem::path>& paths) const;
+};
+
+} // namespace cpp20::compiler
@@ -0,0 +1,78 @@
+/**
+ * @file DependencyScanner.h
+ * @brief Escaneo de dependencias (#include e import) sin preprocesar el cuerpo
+ */
+
+#pragma once
+
+#include <compiler/frontend/Preprocessor.h>
+#include <compiler/common/diagnostics/SourceManager.h>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cpp20::compiler::frontend {
+
+/**
+ * @brief Opciones del escaneo de dependencias
+ */
+struct DependencyScanOptions {
+    PreprocessorConfig preprocessor;       // Configuración de cada preprocesador
+    std::vector<std::string> defines;      // -D
+    std::vector<std::string> undefines;    // -U
+    size_t jobs = 1;                       // Unidades escaneadas en paralelo
+};
+
+/**
+ * @brief Dependencias de una unidad de traducción
+ */
+struct DependencyScanResult {
+    uint32_t fileId = 0;
+    std::filesystem::path inputFile;
+    std::vector<std::filesystem::path> includes; // Sin duplicados, en orden de primera inclusión
+    std::vector<IncludeRecord> includeGraph;     // Todas las aristas, incluidas las evitadas
+    ModuleDependencies modules;
+    std::vector<diagnostics::Diagnostic> diagnostics;
+    bool success = false;
+};
+
+/**
+ * @brief Escáner de dependencias estilo -M
+ *
+ * Cada archivo se reduce con PreprocessorUtils::minimizeToDirectives antes
+ * de tokenizarlo: solo se tokenizan las directivas y las declaraciones
+ * module/import, y las condiciones de #if se evalúan con las macros vistas
+ * hasta ese punto. Las unidades se escanean en paralelo sobre el mismo
+ * SourceManager, que comparte entre hilos la caché de includes y las
+ * guardas ya detectadas.
+ */
+class DependencyScanner {
+public:
+    DependencyScanner(std::shared_ptr<diagnostics::SourceManager> sourceManager,
+                      DependencyScanOptions options = DependencyScanOptions());
+
+    /**
+     * @brief Escanear una unidad ya cargada en el SourceManager
+     *
+     * Seguro para llamarse desde varios hilos: cada llamada usa su propio
+     * preprocesador y un DiagnosticEngine local.
+     */
+    DependencyScanResult scan(uint32_t fileId) const;
+
+    /**
+     * @brief Escanear varias unidades con options.jobs hilos (resultados en orden de entrada)
+     */
+    std::vector<DependencyScanResult> scanAll(const std::vector<uint32_t>& fileIds) const;
+
+    /**
+     * @brief Regla de make "target: fuente includes..." seguida de las líneas de módulos
+     */
+    static std::string formatMakeRule(const DependencyScanResult& result, const std::string& target);
+
+private:
+    std::shared_ptr<diagnostics::SourceManager> sourceManager_;
+    DependencyScanOptions options_;
+};
+
+} // namespace cpp20::compiler::frontend
@@ -0,0 +1,121 @@
+/**
+ * @file HeaderUnitTable.h
+ * @brief Headers promovidos a header unit según su uso en el build
+ */
+
+#pragma once
+
+#include <compiler/frontend/Preprocessor.h>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace cpp20::compiler {
+struct EntityStats;
+}
+
+namespace cpp20::compiler::frontend {
+
+/**
+ * @brief Headers cuyo #include se traduce en la importación de un header unit
+ *
+ * El driver le pasa tras cada build las entidades de HeaderInclusion del
+ * TimingProfiler: cuántas veces se entró en cada header y su tiempo propio.
+ * Un header se promueve al superar la política si además es elegible: no
+ * depende de macros de quien lo incluye (ver isEligible()). A partir de ahí
+ * el preprocesador lo preprocesa una vez aislado, guarda aquí sus tokens y
+ * macros, y cada #include posterior los copia en lugar de abrirlo.
+ *
+ * Las promociones y los contadores persisten en un archivo de caché para
+ * que se acumulen entre invocaciones del mismo build; los tokens solo viven
+ * en el proceso. Un header que cambia deja de importarse hasta que se
+ * vuelve a evaluar. Puede usarse desde varios hilos.
+ */
+class HeaderUnitTable {
+public:
+    static constexpr uint32_t FileKind = 7;
+
+    /**
+     * @brief Umbrales de promoción: ambos deben alcanzarse
+     */
+    struct Policy {
+        size_t minIncludes = 3;                             // Entradas en el header en todo el build
+        std::chrono::microseconds minSelfTime{5000};        // Tiempo propio acumulado
+    };
+
+    /**
+     * @brief Lo que aporta un header unit al importarlo
+     */
+    struct Unit {
+        std::vector<lexer::Token> tokens;       // Salida del header preprocesado aislado
+        std::vector<MacroDefinition> macros;    // Macros que define (incluida la guarda)
+    };
+
+    explicit HeaderUnitTable(std::filesystem::path file = {});
+    HeaderUnitTable(std::filesystem::path file, Policy policy);
+
+    /**
+     * @brief El header se puede importar sin cambiar el resultado
+     *
+     * Exige #pragma once o guarda, y que el resto de directivas sean
+     * #define o #pragma: sin #include, #undef ni condicionales aparte de
+     * la guarda, su contenido no depende de las macros del que lo incluye.
+     */
+    static bool isEligible(std::string_view text);
+
+    /**
+     * @brief Sumar las inclusiones medidas y promover los headers que pasen la política
+     * @param headers Entidades de CompilationPhase::HeaderInclusion (nombre = ruta)
+     * @return Headers promovidos en esta llamada
+     */
+    size_t update(const std::vector<EntityStats>& headers, diagnostics::SourceManager& sources);
+
+    /**
+     * @brief El header está promovido y su contenido es el que se evaluó
+     */
+    bool isPromoted(const std::string& path, std::string_view text) const;
+
+    /**
+     * @brief Header unit ya preprocesado en este proceso (nullptr si aún no)
+     */
+    std::shared_ptr<const Unit> unit(const std::string& path) const;
+
+    /**
+     * @brief Guardar el header unit de un header; si otro hilo se adelantó se conserva el suyo
+     */
+    std::shared_ptr<const Unit> storeUnit(const std::string& path, std::shared_ptr<const Unit> unit);
+
+    /**
+     * @brief Retirar la promoción (el header unit no se pudo construir)
+     */
+    void demote(const std::string& path);
+
+    size_t promotedCount() const;
+
+    bool load();
+    bool save() const;
+
+    const std::filesystem::path& file() const { return file_; }
+
+private:
+    struct Entry {
+        size_t includes = 0;
+        std::chrono::microseconds selfTime{0};
+        uint64_t contentHash = 0;           // fnv1a64 del texto evaluado
+        bool promoted = false;
+        std::shared_ptr<const Unit> unit;
+    };
+
+    std::filesystem::path file_;
+    Policy policy_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+};
+
+} // namespace cpp20::compiler::frontend
@@ -6,8 +6,17 @@
 #pragma once
 
 #include <compiler/frontend/lexer/Token.h>
-#include <compiler/ast/ASTNode.h>
+#include <compiler/frontend/TokenCursor.h>
+#include <compiler/ast/ASTContext.h>
+#include <compiler/ast/ExpressionAST.h>
+#include <compiler/ast/StatementAST.h>
+#include <compiler/ast/DeclarationAST.h>
 #include <compiler/common/diagnostics/DiagnosticEngine.h>
+#include <compiler/common/utils/MemoryPool.h>
+#include <array>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 #include <memory>
 
@@ -21,6 +30,8 @@ struct ParserConfig {
     bool enableSemanticAnalysis = true;   // Análisis semántico durante parsing
     bool enableErrorRecovery = true;      // Recuperación de errores
     size_t maxLookahead = 3;              // Máximo lookahead para decisiones
+    bool delayFunctionBodies = false;     // Guardar el rango de tokens del cuerpo y parsearlo bajo demanda
+    bool foldConstants = true;            // Plegar subexpresiones aritméticas de literales al construirlas
 };
 
 /**
@@ -36,10 +47,13 @@ class Parser {
 public:
     /**
      * @brief Constructor
+     * @param tokens Tokens de entrada; no se copian y deben vivir más que el parser
+     * @param pool Arena donde se construyen los nodos (nullptr = arena propia del parser)
      */
     Parser(const std::vector<lexer::Token>& tokens,
            diagnostics::DiagnosticEngine& diagEngine,
-           const ParserConfig& config = ParserConfig());
+           const ParserConfig& config = ParserConfig(),
+           common::utils::MemoryPool* pool = nullptr);
 
     /**
      * @brief Destructor
@@ -48,8 +62,37 @@ public:
 
     /**
      * @brief Parsear tokens en AST
+     *
+     * El árbol pertenece a la arena: es válido mientras viva el pool pasado
+     * al constructor o, sin pool, mientras viva el parser.
      */
-    std::unique_ptr<ast::TranslationUnit> parse();
+    ast::TranslationUnit* parse();
+
+    /**
+     * @brief Parsear el cuerpo diferido de una función de este parser
+     *
+     * Lo llaman el análisis semántico, la generación de código o la
+     * evaluación constexpr cuando necesitan el cuerpo. Los errores se
+     * reportan en ese momento. Devuelve el cuerpo ya existente si no
+     * estaba diferido.
+     */
+    ast::CompoundStmt* parseDelayedBody(ast::FunctionDecl* function);
+
+    /**
+     * @brief Parsear todos los cuerpos aún diferidos
+     *
+     * Con jobs > 1 los cuerpos se reparten en tramos contiguos entre
+     * hilos; cada tramo usa un parser auxiliar con arena propia (que vive
+     * lo mismo que este parser) y sus errores se emiten al final en orden
+     * de fuente, igual que en serie.
+     * @return Número de cuerpos parseados
+     */
+    size_t parseDelayedBodies(size_t jobs = 1);
+
+    /**
+     * @brief Funciones cuyo cuerpo se difirió, en orden de fuente
+     */
+    const std::vector<ast::FunctionDecl*>& delayedFunctions() const { return delayedFunctions_; }
 
     /**
      * @brief Verificar si el parsing fue exitoso
@@ -64,19 +107,66 @@ public:
         size_t nodesCreated = 0;
         size_t errorsReported = 0;
         size_t tentativeParses = 0;
+        size_t memoHits = 0;              // Reglas reutilizadas del memo packrat
+        size_t constantsFolded = 0;       // Operadores plegados en un literal
+        size_t literalsInterned = 0;      // Literales de texto que reutilizaron una copia
         size_t errorRecoveries = 0;
+        size_t delayedBodies = 0;         // Cuerpos guardados como rango de tokens
+        size_t delayedBodiesParsed = 0;   // Cuerpos diferidos parseados después
     };
     ParserStats getStats() const { return stats_; }
 
 private:
-    std::vector<lexer::Token> tokens_;    // Tokens de entrada
+    TokenCursor cursor_;                  // Posición sobre los tokens de entrada
     diagnostics::DiagnosticEngine& diagEngine_; // Motor de diagnósticos
     ParserConfig config_;                 // Configuración
     ParserStats stats_;                   // Estadísticas
+    ast::ASTContext context_;             // Arena de nodos, listas y nombres
 
-    size_t currentTokenIndex_ = 0;        // Índice del token actual
     bool success_ = true;                 // Si el parsing fue exitoso
 
+    /**
+     * @brief Error emitido durante un parsing tentativo, pendiente de confirmar
+     */
+    struct DeferredError {
+        std::string message;
+        diagnostics::SourceLocation location;
+    };
+    size_t tentativeDepth_ = 0;           // Parsings tentativos anidados en curso
+    std::vector<DeferredError> deferredErrors_;
+
+    /**
+     * @brief Reglas cuyo resultado se memoriza por posición (packrat)
+     */
+    enum class ParseRule : uint8_t {
+        FunctionDeclaration,
+        TypeSpecifiers,
+        Declarator,
+        Count
+    };
+
+    /**
+     * @brief Resultado de una regla en una posición, reutilizable tras volver atrás
+     */
+    struct MemoEntry {
+        ast::ASTNode* node = nullptr;         // Reglas que producen nodo (nullptr = fallo)
+        std::string_view text;                // Reglas que producen texto de la arena
+        size_t consumed = 0;                  // Tokens que consumió la regla
+        std::vector<DeferredError> errors;    // Errores retenidos mientras se parseaba
+    };
+    size_t speculationDepth_ = 0;         // tentativeParse abiertos (los auxiliares retienen sin especular)
+    // Por dirección del primer token: única también dentro de los cursores acotados
+    std::array<std::unordered_map<const lexer::Token*, MemoEntry>,
+               static_cast<size_t>(ParseRule::Count)> memo_;
+    std::vector<ast::FunctionDecl*> delayedFunctions_;
+    std::vector<std::unique_ptr<Parser>> bodyParsers_; // Parsers auxiliares de parseDelayedBodies(jobs)
+
+    /**
+     * @brief Parser auxiliar para cuerpos diferidos: comparte tokens, no arena
+     */
+    Parser(const TokenCursor& cursor, diagnostics::DiagnosticEngine& diagEngine,
+           const ParserConfig& config);
+
     /**
      * @brief Obtener token actual
      */
@@ -122,182 +212,259 @@ private:
     /**
      * @brief Parsear unidad de traducción
      */
-    std::unique_ptr<ast::TranslationUnit> parseTranslationUnit();
+    ast::TranslationUnit* parseTranslationUnit();
 
     /**
      * @brief Parsear declaración externa
      */
-    std::unique_ptr<ast::ASTNode> parseExternalDeclaration();
+    ast::ASTNode* parseExternalDeclaration();
 
     // === PARSING DE DECLARACIONES ===
 
     /**
      * @brief Parsear declaración
      */
-    std::unique_ptr<ast::ASTNode> parseDeclaration();
+    ast::ASTNode* parseDeclaration();
 
     /**
      * @brief Parsear declaración de función
      */
-    std::unique_ptr<ast::ASTNode> parseFunctionDeclaration();
+    ast::ASTNode* parseFunctionDeclaration();
 
     /**
      * @brief Parsear declaración de variable
      */
-    std::unique_ptr<ast::ASTNode> parseVariableDeclaration();
+    ast::ASTNode* parseVariableDeclaration();
 
     /**
      * @brief Parsear especificadores de tipo
+     * @return Especificadores unidos por espacios, en la arena (vacío si no hay)
      */
-    std::vector<std::string> parseTypeSpecifiers();
+    std::string_view parseTypeSpecifiers();
+    std::string_view parseTypeSpecifierSequence();  // Sin memo
 
     /**
      * @brief Parsear declarador
+     * @return Nombre declarado (vacío si no hay identificador)
      */
-    std::unique_ptr<ast::ASTNode> parseDeclarator();
+    std::string_view parseDeclarator();
 
     /**
      * @brief Parsear lista de parámetros
      */
-    std::vector<std::unique_ptr<ast::ASTNode>> parseParameterList();
+    ast::NodeList<ast::ParameterDecl> parseParameterList();
 
     // === PARSING DE EXPRESIONES ===
 
     /**
      * @brief Parsear expresión
      */
-    std::unique_ptr<ast::ASTNode> parseExpression();
+    ast::ASTNode* parseExpression();
 
     /**
      * @brief Parsear expresión de asignación
      */
-    std::unique_ptr<ast::ASTNode> parseAssignmentExpression();
+    ast::ASTNode* parseAssignmentExpression();
 
     /**
-     * @brief Parsear expresión condicional
+     * @brief Precedence climbing sobre TokenUtils::getOperatorPrecedence
+     *
+     * Consume operadores binarios, ?: y asignaciones cuya precedencia
+     * (1 = la más fuerte) no supere maxPrecedence. Un literal cuesta una
+     * llamada aquí y otra en parseUnaryExpression, en lugar de recorrer
+     * un nivel por cada precedencia.
      */
-    std::unique_ptr<ast::ASTNode> parseConditionalExpression();
+    ast::ASTNode* parseBinaryExpression(int maxPrecedence);
 
     /**
-     * @brief Parsear expresión lógica OR
+     * @brief Parsear expresión unaria (y las llamadas que siguen a la primaria)
      */
-    std::unique_ptr<ast::ASTNode> parseLogicalOrExpression();
+    ast::ASTNode* parseUnaryExpression();
 
     /**
-     * @brief Parsear expresión lógica AND
+     * @brief Parsear expresión primaria
      */
-    std::unique_ptr<ast::ASTNode> parseLogicalAndExpression();
+    ast::ASTNode* parsePrimaryExpression();
 
-    /**
-     * @brief Parsear expresión OR bit a bit
-     */
-    std::unique_ptr<ast::ASTNode> parseBitwiseOrExpression();
+    // === PARSING DE SENTENCIAS ===
 
     /**
-     * @brief Parsear expresión XOR bit a bit
+     * @brief Parsear sentencia
      */
-    std::unique_ptr<ast::ASTNode> parseBitwiseXorExpression();
+    ast::ASTNode* parseStatement();
 
     /**
-     * @brief Parsear expresión AND bit a bit
+     * @brief Parsear bloque de sentencias
      */
-    std::unique_ptr<ast::ASTNode> parseBitwiseAndExpression();
+    ast::CompoundStmt* parseCompoundStatement();
 
     /**
-     * @brief Parsear expresión de igualdad
+     * @brief Saltar un cuerpo { ... } equilibrado sin construir nodos
+     * @return false si falta la llave de cierre
      */
-    std::unique_ptr<ast::ASTNode> parseEqualityExpression();
+    bool skipFunctionBody(uint32_t& begin, uint32_t& end);
 
     /**
-     * @brief Parsear expresión relacional
+     * @brief Parsear sentencia if
      */
-    std::unique_ptr<ast::ASTNode> parseRelationalExpression();
+    ast::ASTNode* parseIfStatement();
 
     /**
-     * @brief Parsear expresión de desplazamiento
+     * @brief Parsear sentencia while
      */
-    std::unique_ptr<ast::ASTNode> parseShiftExpression();
+    ast::ASTNode* parseWhileStatement();
 
     /**
-     * @brief Parsear expresión aditiva
+     * @brief Parsear sentencia for
      */
-    std::unique_ptr<ast::ASTNode> parseAdditiveExpression();
+    ast::ASTNode* parseForStatement();
 
     /**
-     * @brief Parsear expresión multiplicativa
+     * @brief Parsear sentencia return
      */
-    std::unique_ptr<ast::ASTNode> parseMultiplicativeExpression();
+    ast::ASTNode* parseReturnStatement();
 
     /**
-     * @brief Parsear expresión unaria
+     * @brief Parsear [[atributos]] sentencia
+     *
+     * Los atributos desconocidos se ignoran; [[clang::musttail]] solo se
+     * admite delante de un return de una llamada.
      */
-    std::unique_ptr<ast::ASTNode> parseUnaryExpression();
+    ast::ASTNode* parseAttributedStatement();
 
     /**
-     * @brief Parsear expresión primaria
+     * @brief Parsear sentencia expression
      */
-    std::unique_ptr<ast::ASTNode> parsePrimaryExpression();
+    ast::ASTNode* parseExpressionStatement();
 
-    // === PARSING DE SENTENCIAS ===
+    // === UTILIDADES DE PARSING ===
 
     /**
-     * @brief Parsear sentencia
+     * @brief Parsing tentativo (para ambigüedades)
+     *
+     * Ejecuta parserFunc desde la posición actual. Si devuelve nullptr el
+     * cursor vuelve a la marca y sus errores se descartan; si no, los
+     * errores retenidos se emiten. Los nodos de un intento fallido quedan
+     * en la arena sin referencias, pero el resultado de la regla y el de
+     * las reglas memorizadas que usó se guardan: otro intento en la misma
+     * posición, o la alternativa que vuelve a leer el mismo prefijo, los
+     * reutiliza en vez de reparsear y de volver a ocupar la arena.
      */
-    std::unique_ptr<ast::ASTNode> parseStatement();
-
-    /**
-     * @brief Parsear bloque de sentencias
+    template<typename Func>
+    ast::ASTNode* tentativeParse(ParseRule rule, Func parserFunc) {
+        ++stats_.tentativeParses;
+        TokenCursor::Mark mark = cursor_.mark();
+        size_t firstError = deferredErrors_.size();
+
+        ++tentativeDepth_;
+        ++speculationDepth_;
+        ast::ASTNode* result = memoized(rule, parserFunc);
+        --speculationDepth_;
+        --tentativeDepth_;
+
+        if (!result) {
+            cursor_.rewind(mark);
+            deferredErrors_.resize(firstError);
+            return nullptr;
+        }
+        if (tentativeDepth_ == 0) {
+            flushDeferredErrors();
+        }
+        return result;
+    }
+
+    /**
+     * @brief Ejecutar una regla o reutilizar su resultado en esta posición
+     *
+     * Solo se guardan resultados calculados dentro de un tentativeParse;
+     * se consultan siempre. Las reglas no dependen de más estado que la
+     * posición, así que el resultado vale mientras dure el parse().
      */
-    std::unique_ptr<ast::ASTNode> parseCompoundStatement();
+    template<typename Func>
+    auto memoized(ParseRule rule, Func parserFunc) -> decltype(parserFunc()) {
+        using Result = decltype(parserFunc());
+        auto& memo = memo_[static_cast<size_t>(rule)];
+        const lexer::Token* start = &cursor_.current();
+        auto cached = memo.find(start);
+        if (cached != memo.end() && cursor_.position() + cached->second.consumed <= cursor_.size()) {
+            ++stats_.memoHits;
+            replayMemoEntry(cached->second);
+            if constexpr (std::is_same_v<Result, std::string_view>) {
+                return cached->second.text;
+            } else {
+                return static_cast<Result>(cached->second.node);
+            }
+        }
 
-    /**
-     * @brief Parsear sentencia if
-     */
-    std::unique_ptr<ast::ASTNode> parseIfStatement();
+        size_t begin = cursor_.position();
+        size_t firstError = deferredErrors_.size();
+        Result result = parserFunc();
+        if (speculationDepth_ > 0) {
+            MemoEntry entry;
+            if constexpr (std::is_same_v<Result, std::string_view>) {
+                entry.text = result;
+            } else {
+                entry.node = result;
+            }
+            entry.consumed = cursor_.position() - begin;
+            entry.errors.assign(deferredErrors_.begin() + static_cast<std::ptrdiff_t>(firstError),
+                                deferredErrors_.end());
+            memo.emplace(start, std::move(entry));
+        }
+        return result;
+    }
 
     /**
-     * @brief Parsear sentencia while
+     * @brief Avanzar lo que consumió una entrada del memo y volver a reportar sus errores
      */
-    std::unique_ptr<ast::ASTNode> parseWhileStatement();
+    void replayMemoEntry(const MemoEntry& entry);
 
     /**
-     * @brief Parsear sentencia for
+     * @brief Olvidar el memo al empezar una declaración o sentencia fuera de intentos
+     *
+     * Nada anterior a la posición actual se vuelve a leer.
      */
-    std::unique_ptr<ast::ASTNode> parseForStatement();
+    void pruneMemo();
 
     /**
-     * @brief Parsear sentencia return
+     * @brief Emitir los errores retenidos por parsings tentativos confirmados
      */
-    std::unique_ptr<ast::ASTNode> parseReturnStatement();
+    void flushDeferredErrors();
 
     /**
-     * @brief Parsear sentencia expression
+     * @brief Verificar precedencia de operadores
      */
-    std::unique_ptr<ast::ASTNode> parseExpressionStatement();
-
-    // === UTILIDADES DE PARSING ===
+    int getOperatorPrecedence(lexer::TokenType type) const;
 
     /**
-     * @brief Parsing tentativo (para ambigüedades)
+     * @brief Verificar asociatividad de operadores
      */
-    template<typename Func>
-    std::unique_ptr<ast::ASTNode> tentativeParse(Func parserFunc);
+    bool isRightAssociative(lexer::TokenType type) const;
 
     /**
-     * @brief Verificar precedencia de operadores
+     * @brief Crear nodo AST en la arena del parser
      */
-    int getOperatorPrecedence(lexer::TokenType type) const;
+    template<typename T, typename... Args>
+    T* createASTNode(Args&&... args) {
+        ++stats_.nodesCreated;
+        return context_.create<T>(std::forward<Args>(args)...);
+    }
 
     /**
-     * @brief Verificar asociatividad de operadores
+     * @brief Literal con el valor de `left op right` si ambos son constantes aritméticas
+     *
+     * Devuelve nullptr (y se construye el BinaryOp) cuando el resultado no
+     * está definido o depende del tipo: división por cero, desbordamiento,
+     * desplazamientos fuera de rango, comparaciones y operadores lógicos.
      */
-    bool isRightAssociative(lexer::TokenType type) const;
+    ast::ASTNode* foldBinary(ast::ASTNode* left, ast::ASTNode* right, ast::BinaryOp::OpKind op);
+    ast::ASTNode* foldUnary(ast::ASTNode* operand, ast::UnaryOp::OpKind op,
+                            diagnostics::SourceLocation location);
 
     /**
-     * @brief Crear nodo AST básico
+     * @brief Texto de un literal, compartido con las apariciones anteriores
      */
-    template<typename T, typename... Args>
-    std::unique_ptr<T> createASTNode(Args&&... args);
+    std::string_view internLiteral(std::string_view text);
 
     /**
      * @brief Crear ubicación actual
@@ -0,0 +1,116 @@
+/**
+ * @file PreprocessedOutput.h
+ * @brief Salida de -E: texto con marcas de línea mínimas o flujo binario de tokens
+ */
+
+#pragma once
+
+#include <compiler/frontend/lexer/Token.h>
+#include <compiler/common/CacheFile.h>
+#include <compiler/common/diagnostics/SourceManager.h>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace cpp20::compiler::frontend {
+
+namespace lexer {
+class IdentifierTable;
+}
+
+/**
+ * @brief Texto preprocesado para compilarlo en otra máquina
+ *
+ * Cada lexema se añade tal cual a un buffer que se vuelca al flujo en
+ * bloques de BufferSize bytes. Los tokens conservan la línea de su fuente:
+ * un salto de hasta MaxBlankLines líneas se escribe con líneas vacías y
+ * uno mayor, o un cambio de archivo, con una sola marca `# <línea>
+ * "<archivo>"` al estilo de GCC. Dentro de una línea se escribe un espacio
+ * donde el fuente lo tenía y donde pegar dos tokens formaría otro.
+ */
+class PreprocessedTextWriter {
+public:
+    static constexpr uint32_t MaxBlankLines = 8;
+    static constexpr size_t BufferSize = 64 * 1024;
+
+    /**
+     * @param lineMarkers Sin marcas (-P de GCC) los saltos largos se reducen a un salto de línea
+     */
+    PreprocessedTextWriter(std::ostream& out, std::shared_ptr<diagnostics::SourceManager> sources,
+                           bool lineMarkers = true);
+
+    /**
+     * @brief Vuelca lo pendiente si no se llamó a finish()
+     */
+    ~PreprocessedTextWriter();
+
+    void write(const lexer::Token& token);
+
+    /**
+     * @brief Terminar la última línea y volcar el buffer
+     * @return false si el flujo falló en algún momento
+     */
+    bool finish();
+
+    size_t markerCount() const { return markers_; }
+
+private:
+    std::ostream& out_;
+    std::shared_ptr<diagnostics::SourceManager> sources_;
+    bool lineMarkers_;
+    std::string buffer_;
+
+    uint32_t fileId_ = 0;               // Archivo de la línea en curso (0 = ninguno aún)
+    uint32_t line_ = 0;                 // Línea del fuente en la que está la salida
+    bool lineHasTokens_ = false;
+    char lastChar_ = 0;                 // Último carácter del token anterior de la línea
+    bool lastWasNumber_ = false;
+    size_t markers_ = 0;
+    bool finished_ = false;
+
+    void moveTo(uint32_t fileId, uint32_t line);
+    void flushIfFull();
+};
+
+/**
+ * @brief Flujo binario de tokens preprocesados
+ *
+ * Un trabajador remoto lo carga con readTokens() sin volver a tokenizar ni
+ * preprocesar. Tras la magic "CPPTOKS1" van registros: un archivo (su ruta
+ * recibe el siguiente id local, empezando en 1) la primera vez que aparece
+ * en una ubicación, y un token por registro con tipo, flags, ubicación
+ * con id local, lexema y valor. Se escribe en bloques como el de texto.
+ */
+class PreprocessedTokenWriter {
+public:
+    PreprocessedTokenWriter(std::ostream& out, std::shared_ptr<diagnostics::SourceManager> sources);
+    ~PreprocessedTokenWriter();
+
+    void write(const lexer::Token& token);
+    bool finish();
+
+    /**
+     * @brief Tokens de un flujo completo; nullopt si está truncado o es de otra versión
+     *
+     * Los archivos se registran en el SourceManager como virtuales sin
+     * contenido: los diagnósticos conservan ruta, línea y columna.
+     * @param identifiers Tabla donde internar los identificadores (nullptr = global)
+     */
+    static std::optional<std::vector<lexer::Token>> readTokens(std::string_view data,
+                                                               diagnostics::SourceManager& sources,
+                                                               lexer::IdentifierTable* identifiers = nullptr);
+
+private:
+    std::ostream& out_;
+    std::shared_ptr<diagnostics::SourceManager> sources_;
+    CacheRecordWriter record_;                          // Bloque aún sin volcar
+    std::unordered_map<uint32_t, uint32_t> localIds_;   // fileId -> id local
+    bool finished_ = false;
+};
+
+} // namespace cpp20::compiler::frontend
@@ -7,13 +7,31 @@
 
 #include <compiler/frontend/lexer/Token.h>
 #include <compiler/common/diagnostics/DiagnosticEngine.h>
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
+#include <mutex>
+
+namespace cpp20::compiler {
+class AutoTimer;
+}
 
 namespace cpp20::compiler::frontend {
 
+namespace lexer {
+class Lexer;
+class IdentifierTable;
+class IdentifierInfo;
+}
+
+struct PreprocessorSnapshot;
+class HeaderUnitTable;
+
 /**
  * @brief Definición de macro
  */
@@ -24,21 +42,108 @@ struct MacroDefinition {
     bool isFunctionLike;                 // Si es una macro de función
     bool isVariadic;                     // Si tiene parámetros variádicos
 
+    // Lista de reemplazo precalculada por resolveParameters()
+    std::vector<int> parameterIndices;   // Por token de body: índice del parámetro o -1
+    bool hasOperators = false;           // El cuerpo usa # o ## (sustitución lenta)
+    uint64_t fingerprint = 0;            // Huella de parámetros y cuerpo (nunca 0)
+
     MacroDefinition(const std::string& n, const std::vector<lexer::Token>& b,
                    bool funcLike = false, bool variadic = false)
         : name(n), body(b), isFunctionLike(funcLike), isVariadic(variadic) {}
+
+    /**
+     * @brief Resolver en tiempo de #define qué tokens del cuerpo son parámetros y calcular la huella
+     */
+    void resolveParameters();
 };
 
 /**
  * @brief Estado de inclusión de archivos
+ *
+ * Cada archivo incluido en curso tiene su propio lexer en la pila: el
+ * preprocesador extrae del de la cima y, al agotarlo, vuelve al que lo
+ * incluyó sin recursión.
  */
 struct IncludeState {
     std::string filename;                // Nombre del archivo
     bool isSystemInclude;               // Si es una inclusión de sistema
     size_t includeDepth;                // Profundidad de inclusión
+    uint32_t fileId = 0;                // Archivo en el SourceManager
+    size_t conditionalDepth = 0;        // #if abiertos al entrar en el archivo
+    std::unique_ptr<std::string> minimizedText; // Solo directivas (escaneo de dependencias)
+    std::unique_ptr<lexer::Lexer> lexer;        // Fuente de tokens del archivo
+    std::unique_ptr<AutoTimer> timer;           // Coste del header mientras está abierto
+
+    // Fuera de línea: Lexer y AutoTimer solo están declarados aquí
+    IncludeState(const std::string& fname, bool system = false, size_t depth = 0);
+    IncludeState(IncludeState&&) noexcept;
+    IncludeState& operator=(IncludeState&&) noexcept;
+    ~IncludeState();
+};
+
+/**
+ * @brief Arista del grafo de inclusión
+ */
+struct IncludeRecord {
+    uint32_t includerFileId = 0;        // Archivo con el #include (0 = entrada sin archivo)
+    uint32_t fileId = 0;                // Archivo incluido
+    std::string name;                   // Nombre tal como aparece en la directiva
+    bool isSystem = false;              // Inclusión con <...>
+    bool skipped = false;               // Evitado por guarda o #pragma once
+};
+
+/**
+ * @brief Declaraciones de módulos C++20 de una unidad de traducción
+ */
+struct ModuleDependencies {
+    std::string moduleName;             // "export module X;" (vacío si no es interfaz)
+    std::vector<std::string> imports;   // Módulos, particiones (":p") y header units ("<x>", "\"x\"")
+};
+
+/**
+ * @brief Resultado de una condición de #if / #elif y lo que leyó para obtenerlo
+ */
+struct CompiledCondition {
+    struct MacroRead {
+        std::string name;
+        uint64_t fingerprint = 0;       // MacroDefinition::fingerprint; 0 si no estaba definida
+    };
+
+    struct IncludeQuery {
+        std::string name;
+        bool isSystem = false;
+        bool found = false;
+    };
+
+    uint64_t expressionHash = 0;        // Tokens de la directiva: descarta las de un archivo que cambió
+    std::vector<MacroRead> macros;      // defined() y cada identificador que miró la expansión
+    std::vector<IncludeQuery> includes; // __has_include
+    bool value = false;
+};
+
+/**
+ * @brief Resultados de #if / #elif por archivo y offset, compartidos entre unidades
+ *
+ * Un resultado vale mientras todas las macros que leyó tengan la misma
+ * huella y cada __has_include responda igual. Las macros se guardan por
+ * nombre, así que sirve entre unidades con tablas de identificadores
+ * distintas. Una directiva conserva varias variantes (un #ifdef _DEBUG
+ * visto desde unidades con -D distintos); la más antigua se descarta al
+ * superar MaxVariants. Puede usarse desde varios hilos.
+ */
+class ConditionCache {
+public:
+    static constexpr size_t MaxVariants = 4;
+
+    std::vector<std::shared_ptr<const CompiledCondition>> variants(uint32_t fileId, uint32_t offset) const;
+    void store(uint32_t fileId, uint32_t offset, std::shared_ptr<const CompiledCondition> condition);
+
+    size_t size() const;    // Variantes guardadas en total
+    void clear();
 
-    IncludeState(const std::string& fname, bool system = false, size_t depth = 0)
-        : filename(fname), isSystemInclude(system), includeDepth(depth) {}
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, std::vector<std::shared_ptr<const CompiledCondition>>> entries_;
 };
 
 /**
@@ -50,6 +155,10 @@ struct PreprocessorConfig {
     size_t maxIncludeDepth = 100;       // Profundidad máxima de inclusión
     std::vector<std::string> includePaths; // Rutas de inclusión
     std::vector<std::string> systemIncludePaths; // Rutas de inclusión de sistema
+    lexer::IdentifierTable* identifiers = nullptr; // Tabla de identificadores (nullptr = global)
+    bool dependencyScan = false;        // Solo directivas: no se generan tokens de salida
+    std::shared_ptr<ConditionCache> conditionCache; // Compartida entre unidades (nullptr = propia)
+    std::shared_ptr<HeaderUnitTable> headerUnits;   // #include de headers promovidos como import (nullptr = ninguno)
 };
 
 /**
@@ -76,11 +185,41 @@ public:
      */
     ~Preprocessor();
 
+    Preprocessor(const Preprocessor&) = delete;
+    Preprocessor& operator=(const Preprocessor&) = delete;
+
     /**
      * @brief Procesar tokens de entrada
      */
     std::vector<lexer::Token> process(const std::vector<lexer::Token>& inputTokens);
 
+    /**
+     * @brief Procesar tokens extraídos bajo demanda del lexer
+     *
+     * No materializa la entrada: cada token se pide con getNextToken()
+     * cuando el preprocesador lo necesita. Equivale a begin() y
+     * nextToken() hasta el final; el vector devuelto es la única copia
+     * de la salida.
+     */
+    std::vector<lexer::Token> process(lexer::Lexer& lexer);
+
+    /**
+     * @brief Empezar una unidad sin preprocesar nada todavía
+     *
+     * El lexer debe vivir hasta que nextToken() devuelva nullopt. Una
+     * unidad a medias se descarta al llamar otra vez a begin() o process().
+     */
+    void begin(lexer::Lexer& lexer);
+
+    /**
+     * @brief Siguiente token preprocesado de la unidad; nullopt al terminar
+     *
+     * Solo avanza la entrada lo necesario para producirlo: una directiva,
+     * una expansión de macro o la entrada o salida de un #include. Entre
+     * llamadas el preprocesador guarda únicamente la expansión pendiente.
+     */
+    std::optional<lexer::Token> nextToken();
+
     /**
      * @brief Definir una macro predefinida
      */
@@ -100,17 +239,66 @@ public:
      * @brief Verificar si una macro está definida
      */
     bool isMacroDefined(const std::string& name) const;
+    bool isMacroDefined(const lexer::IdentifierInfo* name) const;
 
     /**
      * @brief Obtener definición de macro
      */
     const MacroDefinition* getMacro(const std::string& name) const;
 
+    /**
+     * @brief Obtener definición de macro por identificador internado
+     *
+     * Descarta sin buscar los identificadores que ningún preprocesador define.
+     */
+    const MacroDefinition* getMacro(const lexer::IdentifierInfo* name) const;
+
+    /**
+     * @brief Aplicar las opciones -D (NOMBRE o NOMBRE=VALOR) y -U de la línea de comandos
+     */
+    void applyCommandLineMacros(const std::vector<std::string>& defines,
+                                const std::vector<std::string>& undefines);
+
     /**
      * @brief Añadir ruta de inclusión
      */
     void addIncludePath(const std::string& path, bool system = false);
 
+    /**
+     * @brief Capturar una instantánea al llegar el archivo principal a prologueLength
+     *
+     * La captura se hace durante el siguiente process(), antes del primer
+     * token del archivo principal situado tras el prólogo. Se omite si para
+     * entonces hay errores o algún #if sin cerrar.
+     */
+    void requestSnapshot(uint32_t mainFileId, size_t prologueLength);
+
+    /**
+     * @brief Instantánea capturada en el último process() (nullptr si no hubo)
+     */
+    std::unique_ptr<PreprocessorSnapshot> takeSnapshot();
+
+    /**
+     * @brief Restaurar una instantánea como prólogo del archivo principal mainFileId
+     *
+     * Vuelve a resolver cada inclusión y compara el hash del contenido de
+     * cada header con el guardado. Si todo coincide, el siguiente process()
+     * parte de las macros y tokens restaurados y salta el texto del prólogo.
+     * Los diagnósticos emitidos al capturar el prólogo no se repiten.
+     * @return false, sin modificar el estado, si la instantánea no es válida
+     */
+    bool restoreSnapshot(const PreprocessorSnapshot& snapshot, uint32_t mainFileId);
+
+    /**
+     * @brief Inclusiones resueltas durante el último process(), en orden de aparición
+     */
+    const std::vector<IncludeRecord>& includeGraph() const { return includeGraph_; }
+
+    /**
+     * @brief Declaraciones module/import encontradas durante el último process()
+     */
+    const ModuleDependencies& moduleDependencies() const { return moduleDependencies_; }
+
     /**
      * @brief Obtener estadísticas del preprocesamiento
      */
@@ -119,6 +307,11 @@ public:
         size_t macrosUndefined = 0;
         size_t conditionalsProcessed = 0;
         size_t includesProcessed = 0;
+        size_t includesSkipped = 0;       // Evitados por guarda o #pragma once
+        size_t headerUnitImports = 0;     // #include traducidos a la importación de un header unit
+        size_t macrosExpanded = 0;
+        size_t expansionCacheHits = 0;    // Expansiones servidas por la memo
+        size_t conditionCacheHits = 0;    // #if / #elif resueltos por la ConditionCache
         size_t tokensProcessed = 0;
         size_t tokensGenerated = 0;
     };
@@ -130,21 +323,155 @@ private:
     PreprocessorStats stats_;                   // Estadísticas
 
     // Estado del preprocesamiento
-    std::unordered_map<std::string, MacroDefinition> macros_; // Macros definidas
+    lexer::IdentifierTable* identifiers_;        // Tabla de identificadores internados
+    std::unordered_map<const lexer::IdentifierInfo*, MacroDefinition> macros_; // Macros definidas
     std::vector<IncludeState> includeStack_;     // Pila de inclusiones
-    std::vector<bool> conditionalStack_;         // Pila de condicionales
+    std::unordered_set<uint32_t> enteredFiles_;  // Archivos ya incluidos en la unidad (IDs canónicos)
+    std::vector<IncludeRecord> includeGraph_;    // Inclusiones de la unidad
+    ModuleDependencies moduleDependencies_;      // module / import de la unidad
+    std::vector<IncludeRecord> unresolvedIncludes_; // #include no encontrados (fileId 0)
+    std::vector<std::string> commandLineDefines_;   // -D aplicados (también valen en los header units)
+    std::vector<std::string> commandLineUndefines_; // -U aplicados
+
+    // Instantáneas del prólogo
+    bool snapshotPending_ = false;               // Captura pedida con requestSnapshot()
+    uint32_t snapshotFileId_ = 0;                // Archivo principal de la captura
+    size_t snapshotOffset_ = 0;                  // Fin del prólogo en el archivo principal
+    std::unique_ptr<PreprocessorSnapshot> capturedSnapshot_;
+    bool restored_ = false;                      // El próximo process() parte de una instantánea
+    size_t resumeOffset_ = 0;                    // Texto del archivo principal ya cubierto
+
+    /**
+     * @brief Un nivel de #if / #ifdef abierto
+     */
+    struct ConditionalFrame {
+        bool active = false;                    // La rama actual se procesa
+        bool parentActive = false;              // La sección que contiene el #if se procesa
+        bool branchTaken = false;               // Alguna rama ya fue verdadera
+        bool seenElse = false;                  // Ya apareció #else
+    };
+    std::vector<ConditionalFrame> conditionalStack_; // Pila de condicionales
     std::unordered_map<std::string, std::string> predefinedMacros_; // Macros predefinidas
 
     // Control de flujo
     size_t currentTokenIndex_ = 0;              // Índice del token actual
     std::vector<lexer::Token> inputTokens_;     // Tokens de entrada
-    std::vector<lexer::Token> outputTokens_;    // Tokens de salida
+    lexer::Lexer* mainSource_ = nullptr;        // Lexer del archivo principal en modo streaming
+    lexer::Lexer* tokenSource_ = nullptr;       // Lexer de la cima de la pila (o el principal)
+    std::vector<lexer::Token> outputTokens_;    // Salida aún no entregada por nextToken()
+    size_t outputIndex_ = 0;                    // Primer token de outputTokens_ sin entregar
+
+    /**
+     * @brief Detección del idiom de guarda en un archivo incluido
+     *
+     * Un archivo está protegido si, salvo espacios, comentarios y #pragma,
+     * todo su contenido está dentro de un #ifndef X ... #endif sin #else.
+     */
+    struct MultipleIncludeState {
+        enum class Phase {
+            Start,        // Aún no hay contenido significativo
+            InGuard,      // Dentro del #ifndef inicial
+            AfterGuard,   // Tras su #endif: cualquier contenido invalida la guarda
+            Invalid
+        };
+
+        uint32_t fileId = 0;
+        Phase phase = Phase::Start;
+        const lexer::IdentifierInfo* guardMacro = nullptr;
+        size_t guardDepth = 0;                   // conditionalStack_ antes del #ifndef
+        bool pragmaOnce = false;
+    };
+    std::vector<MultipleIncludeState> guardStates_; // Uno por archivo incluido en curso
+
+    // Expansión de macros
+    std::vector<const lexer::IdentifierInfo*> activeExpansions_; // Macros en expansión (no se reexpanden)
+    std::unordered_map<const lexer::IdentifierInfo*, std::vector<lexer::Token>> expansionMemo_;
+    std::unordered_set<const lexer::IdentifierInfo*> memoDependencies_; // Nombres leídos por la memo
+    size_t memoizingDepth_ = 0;                  // Expansiones de objeto en curso
+
+    // Evaluación de #if / #elif
+    std::shared_ptr<ConditionCache> conditionCache_;    // La de la configuración o una propia
+    CompiledCondition* conditionReads_ = nullptr;       // Evaluación en curso que registra lo que lee
+    std::unordered_map<std::string, bool> hasIncludeResults_; // __has_include ya resueltos en la unidad
+
+    /**
+     * @brief Reiniciar el estado por unidad al comenzar process()
+     *
+     * Tras restoreSnapshot() conserva la salida restaurada y avanza la
+     * entrada hasta el final del prólogo.
+     */
+    void beginUnit();
+
+    /**
+     * @brief Guardar el estado actual como instantánea del prólogo
+     */
+    void captureSnapshot();
+
+    /**
+     * @brief Vaciar nextToken() en un vector
+     */
+    std::vector<lexer::Token> drainTokens();
+
+    /**
+     * @brief Procesar la siguiente directiva o token de la entrada
+     *
+     * Cierra antes los archivos incluidos que se hayan agotado.
+     * @return false al acabar el archivo principal
+     */
+    bool processNext();
 
     /**
      * @brief Procesar token actual
      */
     void processToken();
 
+    /**
+     * @brief Verificar si un include ya resuelto puede omitirse sin abrirlo
+     */
+    bool shouldSkipInclude(const std::string& includeName, uint32_t fileId) const;
+
+    /**
+     * @brief Apilar un archivo incluido: la entrada sigue por su primer token
+     */
+    void enterIncludedFile(uint32_t fileId, const std::string& includeName, bool isSystem);
+
+    /**
+     * @brief Traducir el #include de un header promovido en su importación
+     *
+     * Copia en la salida los tokens del header unit y define sus macros;
+     * lo construye la primera vez que alguna unidad lo importa.
+     * @return false si el header no está promovido: se incluye como texto
+     */
+    bool importHeaderUnit(uint32_t fileId, const std::string& includeName, bool isSystem);
+
+    /**
+     * @brief Preprocesar un header aislado, solo con las macros predefinidas y las de la línea de comandos
+     * @param macros Las que el header define o redefine
+     * @return false si hubo errores o el header incluye otros
+     */
+    bool preprocessIsolated(uint32_t fileId, std::vector<lexer::Token>& tokens,
+                            std::vector<MacroDefinition>& macros);
+
+    /**
+     * @brief Desapilar el archivo incluido agotado y registrar su guarda
+     */
+    void leaveIncludedFile();
+
+    /**
+     * @brief Contenido fuera de la guarda del archivo actual
+     */
+    void noteNonGuardContent();
+
+    /**
+     * @brief Registrar una macro (reemplaza la definición previa)
+     */
+    void storeMacro(lexer::IdentifierInfo* name, const MacroDefinition& macro);
+
+    /**
+     * @brief Entrada internada del nombre de un token
+     */
+    lexer::IdentifierInfo* identifierOf(const lexer::Token& token) const;
+
     /**
      * @brief Procesar directiva de preprocesador
      */
@@ -178,7 +505,17 @@ private:
     /**
      * @brief Procesar #else / #elif
      */
-    void processElseOrElif();
+    void processElseOrElif(bool isElif);
+
+    /**
+     * @brief Abrir un nivel condicional con la condición de su primera rama
+     */
+    void pushConditional(bool condition);
+
+    /**
+     * @brief Procesar "module ...;", "export module ...;" e "import ...;" al inicio de línea
+     */
+    void processModuleDeclaration();
 
     /**
      * @brief Procesar #endif
@@ -201,15 +538,82 @@ private:
     void processDiagnostic(bool isError);
 
     /**
-     * @brief Expandir macro
+     * @brief Expandir una invocación de macro (sustitución y reescaneo)
+     *
+     * Las macros de objeto se memorizan: su expansión no depende de
+     * argumentos y solo cambia si se redefine alguna macro leída al
+     * expandirla, lo que vacía la memo.
+     */
+    void expandMacro(const lexer::IdentifierInfo* name, const MacroDefinition& macro,
+                     const std::vector<std::vector<lexer::Token>>& arguments,
+                     const diagnostics::SourceLocation& location,
+                     std::vector<lexer::Token>& output);
+
+    /**
+     * @brief Expandir las macros de una secuencia de tokens
+     */
+    void rescan(const std::vector<lexer::Token>& tokens, std::vector<lexer::Token>& output);
+
+    /**
+     * @brief Sustituir argumentos en la lista de reemplazo (# y ## incluidos)
+     */
+    std::vector<lexer::Token> substituteArguments(const MacroDefinition& macro,
+                                                  const std::vector<std::vector<lexer::Token>>& arguments);
+
+    /**
+     * @brief Leer los argumentos de una invocación desde la entrada (tras el nombre)
+     * @return false si falta el ')' de cierre
+     */
+    bool collectArgumentsFromInput(std::vector<std::vector<lexer::Token>>& arguments);
+
+    /**
+     * @brief Ajustar argumentos al número de parámetros (variádicos, invocación vacía)
+     * @return false si el número de argumentos no es válido
      */
-    std::vector<lexer::Token> expandMacro(const MacroDefinition& macro,
-                                         const std::vector<std::vector<lexer::Token>>& arguments = {});
+    bool normalizeArguments(const MacroDefinition& macro,
+                            std::vector<std::vector<lexer::Token>>& arguments,
+                            const diagnostics::SourceLocation& location);
 
     /**
-     * @brief Evaluar expresión condicional
+     * @brief Invalidar la memo si name fue leído por alguna expansión memorizada
      */
-    bool evaluateConditionalExpression(const std::vector<lexer::Token>& expression);
+    void invalidateExpansionMemo(const lexer::IdentifierInfo* name);
+
+    /**
+     * @brief Tokenizar un texto suelto (valores de -D, resultado de ##)
+     */
+    std::vector<lexer::Token> lexText(const std::string& text, const diagnostics::SourceLocation& location);
+
+    /**
+     * @brief Evaluar la expresión de #if / #elif
+     *
+     * Resuelve defined y __has_include, expande macros y sustituye por 0
+     * los identificadores restantes antes de evaluar en intmax_t.
+     */
+    bool evaluateConditionalExpression(const std::vector<lexer::Token>& expression,
+                                       const diagnostics::SourceLocation& location);
+
+    /**
+     * @brief Resolver y evaluar la expresión (evaluateConditionalExpression sin caché)
+     * @return nullopt si la expresión no es válida (el error ya se informó)
+     */
+    std::optional<bool> computeConditionalExpression(const std::vector<lexer::Token>& expression,
+                                                     const diagnostics::SourceLocation& location);
+
+    /**
+     * @brief Comprobar que lo que leyó una condición ya evaluada sigue igual
+     */
+    bool isConditionCurrent(const CompiledCondition& condition, uint32_t fileId);
+
+    /**
+     * @brief Anotar en la evaluación en curso la definición actual de name
+     */
+    void recordConditionRead(const lexer::IdentifierInfo* name);
+
+    /**
+     * @brief __has_include desde fileId, resuelto una vez por unidad
+     */
+    bool hasInclude(const std::string& includeName, bool isSystem, uint32_t fileId);
 
     /**
      * @brief Obtener tokens hasta fin de línea
@@ -287,6 +691,17 @@ public:
      */
     static std::string tokensToString(const std::vector<lexer::Token>& tokens);
 
+    /**
+     * @brief Reducir un archivo a sus directivas y declaraciones de módulo
+     *
+     * Las líneas que no empiezan por '#', "module", "export" o "import" se
+     * reemplazan por su salto de línea, de modo que los números de línea de
+     * las directivas no cambian y el lexer pasa sobre el cuerpo sin formar
+     * tokens. Los comentarios de bloque y los raw strings que abarcan
+     * varias líneas se siguen para no confundir su contenido con directivas.
+     */
+    static std::string minimizeToDirectives(std::string_view source);
+
     /**
      * @brief Parsear parámetros de macro de función
      */
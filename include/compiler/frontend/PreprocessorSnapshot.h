@@ -0,0 +1,83 @@
+/**
+ * @file PreprocessorSnapshot.h
+ * @brief Estado del preprocesador tras el prólogo de #include de una unidad (PCH ligero)
+ */
+
+#pragma once
+
+#include <compiler/frontend/Preprocessor.h>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cpp20::compiler::frontend {
+
+/**
+ * @brief Instantánea del preprocesador al terminar el prólogo de una unidad
+ *
+ * El prólogo es la secuencia inicial de líneas #include del archivo
+ * principal (ver prologueOf()). La instantánea guarda las macros, las
+ * inclusiones realizadas y los tokens ya producidos, de modo que otra
+ * unidad con el mismo prólogo y las mismas opciones puede continuar
+ * desde ahí sin volver a preprocesar los headers.
+ *
+ * Los archivos se guardan con ids locales (0 = sin archivo, 1 = archivo
+ * principal, 2.. = headers en orden de primera inclusión) porque los ids
+ * del SourceManager cambian entre invocaciones. Al restaurar, cada
+ * inclusión se vuelve a resolver y el contenido de cada header se compara
+ * por hash: cualquier diferencia descarta la instantánea.
+ */
+struct PreprocessorSnapshot {
+    /**
+     * @brief Header entrado durante el prólogo
+     */
+    struct File {
+        uint64_t contentHash = 0;           // fnv1a64 del texto normalizado
+        std::string includeGuard;           // Guarda detectada (vacía si no hay)
+        bool pragmaOnce = false;
+    };
+
+    uint64_t key = 0;                       // computeKey() del prólogo y las opciones
+    uint32_t prologueLength = 0;            // Bytes del archivo principal cubiertos
+    std::vector<File> files;                // File de id local i + 2
+    std::vector<IncludeRecord> includes;    // Aristas con ids locales
+    std::vector<MacroDefinition> macros;    // Macros definidas al final del prólogo
+    std::vector<lexer::Token> tokens;       // Tokens de salida con ids locales
+
+    /**
+     * @brief Prefijo del fuente formado por líneas #include, en blanco o comentarios //
+     *
+     * Termina en un salto de línea; vacío si el archivo no empieza por un #include.
+     */
+    static std::string_view prologueOf(std::string_view source);
+
+    /**
+     * @brief Clave de la instantánea: texto del prólogo más opciones que afectan al resultado
+     */
+    static uint64_t computeKey(std::string_view prologue, const PreprocessorConfig& config,
+                               const std::vector<std::string>& defines,
+                               const std::vector<std::string>& undefines);
+
+    /**
+     * @brief Nombre del archivo de una clave dentro del directorio de instantáneas
+     */
+    static std::filesystem::path fileFor(const std::filesystem::path& directory, uint64_t key);
+
+    /**
+     * @brief Escribir en formato binario (archivo temporal y renombrado atómico)
+     */
+    bool save(const std::filesystem::path& file) const;
+
+    /**
+     * @brief Leer una instantánea; nullopt si no existe, es de otra versión o está corrupta
+     * @param identifiers Tabla donde internar los identificadores (nullptr = global); debe
+     *        ser la del preprocesador que la restaure
+     */
+    static std::optional<PreprocessorSnapshot> load(const std::filesystem::path& file,
+                                                    lexer::IdentifierTable* identifiers = nullptr);
+};
+
+} // namespace cpp20::compiler::frontend
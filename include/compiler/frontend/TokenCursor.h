@@ -0,0 +1,87 @@
+#pragma once
+
+#include <compiler/frontend/lexer/Token.h>
+#include <cstddef>
+#include <vector>
+
+namespace cpp20::compiler::frontend {
+
+/**
+ * @brief Cursor de solo lectura sobre una secuencia de tokens ya producida
+ *
+ * No copia ni posee los tokens: guarda un puntero y una posición, así que
+ * peek/advance devuelven referencias al buffer original y mark/rewind
+ * cuestan lo mismo que copiar un entero. Más allá del final devuelve un
+ * END_OF_FILE compartido.
+ */
+class TokenCursor {
+public:
+    /**
+     * @brief Posición guardada para volver atrás en un parsing tentativo
+     */
+    struct Mark {
+        size_t position;
+    };
+
+    /**
+     * @param tokens Secuencia que debe vivir más que el cursor
+     */
+    explicit TokenCursor(const std::vector<lexer::Token>& tokens)
+        : tokens_(tokens.data()), size_(tokens.size()) {}
+
+    TokenCursor(const lexer::Token* tokens, size_t size)
+        : tokens_(tokens), size_(size) {}
+
+    const lexer::Token& current() const { return peek(0); }
+
+    /**
+     * @brief Token a offset posiciones del actual (0 = el actual)
+     */
+    const lexer::Token& peek(size_t offset) const {
+        size_t index = position_ + offset;
+        return index < size_ ? tokens_[index] : endOfFile();
+    }
+
+    /**
+     * @brief Avanzar y devolver el token que se deja atrás
+     */
+    const lexer::Token& advance() {
+        const lexer::Token& token = current();
+        if (position_ < size_) {
+            ++position_;
+        }
+        return token;
+    }
+
+    bool atEnd() const {
+        return position_ >= size_ || tokens_[position_].getType() == lexer::TokenType::END_OF_FILE;
+    }
+
+    size_t position() const { return position_; }
+    size_t size() const { return size_; }
+
+    /**
+     * @brief Cursor nuevo limitado a los tokens [begin, end) de este
+     */
+    TokenCursor slice(size_t begin, size_t end) const {
+        end = end < size_ ? end : size_;
+        begin = begin < end ? begin : end;
+        return TokenCursor(tokens_ + begin, end - begin);
+    }
+
+    Mark mark() const { return Mark{position_}; }
+    void rewind(Mark mark) { position_ = mark.position; }
+    void reset() { position_ = 0; }
+
+private:
+    static const lexer::Token& endOfFile() {
+        static const lexer::Token eof(lexer::TokenType::END_OF_FILE, "", diagnostics::SourceLocation());
+        return eof;
+    }
+
+    const lexer::Token* tokens_;
+    size_t size_;
+    size_t position_ = 0;
+};
+
+} // namespace cpp20::compiler::frontend
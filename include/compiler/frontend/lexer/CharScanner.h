@@ -0,0 +1,53 @@
+/**
+ * @file CharScanner.h
+ * @brief Búsquedas vectorizadas sobre el buffer del lexer
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace cpp20::compiler::frontend::lexer {
+
+/**
+ * @brief Rutinas de escaneo que clasifican 16-32 bytes por iteración
+ *
+ * La implementación se elige una sola vez en tiempo de ejecución: AVX2 si
+ * la CPU lo soporta, SSE2 en cualquier x86-64 y un bucle escalar en el
+ * resto de arquitecturas. Todas las funciones reciben el rango [begin, end)
+ * y devuelven un puntero dentro de él (end si no encuentran nada).
+ */
+class CharScanner {
+public:
+    /**
+     * @brief Primer carácter que no pertenece a [A-Za-z0-9_]
+     */
+    static const char* skipIdentifierChars(const char* begin, const char* end);
+
+    /**
+     * @brief Primer carácter que no es espacio en blanco (' ', \t, \n, \v, \f, \r)
+     */
+    static const char* skipWhitespace(const char* begin, const char* end);
+
+    /**
+     * @brief Siguiente '\n'
+     */
+    static const char* findNewline(const char* begin, const char* end);
+
+    /**
+     * @brief Inicio del siguiente "*\/" (end si el comentario no se cierra)
+     */
+    static const char* findBlockCommentEnd(const char* begin, const char* end);
+
+    /**
+     * @brief Número de '\n' en el rango
+     */
+    static size_t countNewlines(const char* begin, const char* end);
+
+    /**
+     * @brief Nombre de la implementación activa ("avx2", "sse2" o "scalar")
+     */
+    static const char* implementationName();
+};
+
+} // namespace cpp20::compiler::frontend::lexer
@@ -0,0 +1,129 @@
+/**
+ * @file IdentifierTable.h
+ * @brief Tabla global de identificadores internados
+ */
+
+#pragma once
+
+#include <compiler/frontend/lexer/Token.h>
+#include <compiler/common/utils/MemoryPool.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+namespace cpp20::compiler::frontend::lexer {
+
+/**
+ * @brief Entrada única por identificador
+ *
+ * Dos identificadores con el mismo texto comparten IdentifierInfo, de modo
+ * que la igualdad de nombres es una comparación de punteros. El puntero y
+ * el texto que apunta name() viven tanto como la tabla.
+ */
+class IdentifierInfo {
+public:
+    IdentifierInfo(const IdentifierInfo&) = delete;
+    IdentifierInfo& operator=(const IdentifierInfo&) = delete;
+
+    /**
+     * @brief Texto del identificador
+     */
+    std::string_view name() const { return name_; }
+
+    /**
+     * @brief Tipo de palabra clave (IDENTIFIER si no lo es)
+     */
+    TokenType keywordKind() const { return keywordKind_; }
+
+    /**
+     * @brief Verificar si es palabra clave
+     */
+    bool isKeyword() const { return keywordKind_ != TokenType::IDENTIFIER; }
+
+    /**
+     * @brief Verificar si algún preprocesador lo tiene definido como macro
+     *
+     * La tabla es compartida entre unidades de traducción, así que el bit es
+     * un contador de definiciones activas: si es false la búsqueda de macro
+     * se descarta sin consultar la tabla de macros; si es true, cada
+     * preprocesador consulta la suya.
+     */
+    bool mayHaveMacroDefinition() const {
+        return macroDefinitions_.load(std::memory_order_relaxed) != 0;
+    }
+
+    void addMacroDefinition() { macroDefinitions_.fetch_add(1, std::memory_order_relaxed); }
+    void removeMacroDefinition() { macroDefinitions_.fetch_sub(1, std::memory_order_relaxed); }
+
+private:
+    friend class IdentifierTable;
+
+    IdentifierInfo(std::string_view name, TokenType keywordKind)
+        : name_(name), keywordKind_(keywordKind) {}
+
+    std::string_view name_;               // Texto en la arena de la tabla
+    TokenType keywordKind_;               // Calculado una vez al internar
+    std::atomic<uint32_t> macroDefinitions_{0}; // Preprocesadores que lo definen
+};
+
+static_assert(std::is_trivially_destructible_v<IdentifierInfo>,
+              "IdentifierInfo vive en arenas sin destructores registrados");
+
+/**
+ * @brief Tabla de identificadores internados, thread-safe
+ *
+ * Las entradas y sus textos se asignan en arenas y nunca se liberan, por lo
+ * que los IdentifierInfo* son estables. La tabla está dividida en shards
+ * con su propio lock para que los hilos de -j N no se serialicen.
+ */
+class IdentifierTable {
+public:
+    IdentifierTable();
+    ~IdentifierTable();
+
+    IdentifierTable(const IdentifierTable&) = delete;
+    IdentifierTable& operator=(const IdentifierTable&) = delete;
+
+    /**
+     * @brief Tabla compartida por lexer, preprocesador y tablas de símbolos
+     */
+    static IdentifierTable& global();
+
+    /**
+     * @brief Obtener (o crear) la entrada de un identificador
+     */
+    IdentifierInfo* get(std::string_view name);
+
+    /**
+     * @brief Buscar sin crear (nullptr si nunca se internó)
+     */
+    IdentifierInfo* find(std::string_view name) const;
+
+    /**
+     * @brief Número de identificadores internados
+     */
+    size_t size() const;
+
+private:
+    static constexpr size_t kShardCount = 16;
+
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string_view, IdentifierInfo*> entries;
+        common::utils::MemoryPool pool{16 * 1024};
+
+        Shard() { pool.setSubsystem(common::utils::MemorySubsystem::Tokens); }
+    };
+
+    std::array<Shard, kShardCount> shards_;
+
+    Shard& shardFor(size_t hash) { return shards_[hash % kShardCount]; }
+    const Shard& shardFor(size_t hash) const { return shards_[hash % kShardCount]; }
+};
+
+} // namespace cpp20::compiler::frontend::lexer
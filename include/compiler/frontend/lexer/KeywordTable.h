@@ -0,0 +1,202 @@
+/**
+ * @file KeywordTable.h
+ * @brief Reconocimiento de palabras clave con hash perfecto constexpr
+ */
+
+#pragma once
+
+#include <compiler/frontend/lexer/Token.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace cpp20::compiler::frontend::lexer {
+
+/**
+ * @brief Palabra clave y su tipo de token
+ */
+struct KeywordInfo {
+    std::string_view spelling;
+    TokenType type;
+    bool isCpp20;              // Palabra clave de C++20 (LexerUtils::isCpp20Keyword)
+};
+
+namespace keyword_detail {
+
+inline constexpr auto kKeywords = std::to_array<KeywordInfo>({
+    // Tipos fundamentales
+    {"void", TokenType::VOID, false}, {"int", TokenType::INT, false},
+    {"char", TokenType::CHAR, false}, {"short", TokenType::SHORT, false},
+    {"long", TokenType::LONG, false}, {"float", TokenType::FLOAT, false},
+    {"double", TokenType::DOUBLE, false}, {"bool", TokenType::BOOL, false},
+
+    // Calificadores
+    {"const", TokenType::CONST, false}, {"volatile", TokenType::VOLATILE, false},
+    {"consteval", TokenType::CONSTEVAL, true}, {"constexpr", TokenType::CONSTEXPR, true},
+    {"constinit", TokenType::CONSTINIT, true}, {"mutable", TokenType::MUTABLE, false},
+
+    // Especificadores de almacenamiento
+    {"static", TokenType::STATIC, false}, {"extern", TokenType::EXTERN, false},
+    {"inline", TokenType::INLINE, false}, {"thread_local", TokenType::THREAD_LOCAL, false},
+
+    // Control de acceso
+    {"public", TokenType::PUBLIC, false}, {"private", TokenType::PRIVATE, false},
+    {"protected", TokenType::PROTECTED, false},
+
+    // Estructuras de control
+    {"if", TokenType::IF, false}, {"else", TokenType::ELSE, false},
+    {"while", TokenType::WHILE, false}, {"for", TokenType::FOR, false},
+    {"do", TokenType::DO, false}, {"switch", TokenType::SWITCH, false},
+    {"case", TokenType::CASE, false}, {"default", TokenType::DEFAULT, false},
+    {"break", TokenType::BREAK, false}, {"continue", TokenType::CONTINUE, false},
+    {"return", TokenType::RETURN, false}, {"goto", TokenType::GOTO, false},
+
+    // Estructuras de datos
+    {"struct", TokenType::STRUCT, false}, {"class", TokenType::CLASS, false},
+    {"union", TokenType::UNION, false}, {"enum", TokenType::ENUM, false},
+
+    // Funciones y métodos
+    {"virtual", TokenType::VIRTUAL, false}, {"override", TokenType::OVERRIDE, false},
+    {"final", TokenType::FINAL, false}, {"noexcept", TokenType::NOEXCEPT, false},
+
+    // Excepciones
+    {"try", TokenType::TRY, false}, {"catch", TokenType::CATCH, false},
+    {"throw", TokenType::THROW, false},
+
+    // Templates y conceptos
+    {"template", TokenType::TEMPLATE, false}, {"typename", TokenType::TYPENAME, false},
+    {"concept", TokenType::CONCEPT, true}, {"requires", TokenType::REQUIRES, true},
+
+    // Espacios de nombres
+    {"namespace", TokenType::NAMESPACE, false}, {"using", TokenType::USING, false},
+
+    // Operadores y conversión
+    {"operator", TokenType::OPERATOR, false}, {"explicit", TokenType::EXPLICIT, false},
+
+    // Misceláneo
+    {"sizeof", TokenType::SIZEOF, false}, {"alignof", TokenType::ALIGNOF, false},
+    {"alignas", TokenType::ALIGNAS, false}, {"typeid", TokenType::TYPEID, false},
+    {"decltype", TokenType::DECLTYPE, false}, {"auto", TokenType::AUTO, false},
+
+    // C++20 específico
+    {"co_await", TokenType::CO_AWAIT, true}, {"co_return", TokenType::CO_RETURN, true},
+    {"co_yield", TokenType::CO_YIELD, true}, {"module", TokenType::MODULE, true},
+    {"import", TokenType::IMPORT, true}, {"export", TokenType::EXPORT, true},
+
+    // Literales
+    {"true", TokenType::TRUE_LITERAL, false}, {"false", TokenType::FALSE_LITERAL, false},
+    {"nullptr", TokenType::NULLPTR_LITERAL, false}
+});
+
+inline constexpr size_t kSlotCount = 512;
+inline constexpr uint32_t kSlotMask = kSlotCount - 1;
+static_assert(kKeywords.size() < 255, "los slots guardan índice + 1 en un byte");
+
+/**
+ * @brief FNV-1a con semilla y mezcla final de los bits altos
+ */
+constexpr uint32_t hash(std::string_view word, uint32_t seed) {
+    uint32_t h = 2166136261u ^ seed;
+    for (char c : word) {
+        h = (h ^ static_cast<uint8_t>(c)) * 16777619u;
+    }
+    return h ^ (h >> 15);
+}
+
+constexpr bool isPerfect(uint32_t seed) {
+    std::array<bool, kSlotCount> used{};
+    for (const KeywordInfo& keyword : kKeywords) {
+        uint32_t slot = hash(keyword.spelling, seed) & kSlotMask;
+        if (used[slot]) {
+            return false;
+        }
+        used[slot] = true;
+    }
+    return true;
+}
+
+constexpr uint32_t findSeed() {
+    for (uint32_t seed = 0; seed < 100000; ++seed) {
+        if (isPerfect(seed)) {
+            return seed;
+        }
+    }
+    return UINT32_MAX;
+}
+
+constexpr std::array<uint8_t, kSlotCount> buildSlots(uint32_t seed) {
+    std::array<uint8_t, kSlotCount> slots{};
+    for (size_t i = 0; i < kKeywords.size(); ++i) {
+        slots[hash(kKeywords[i].spelling, seed) & kSlotMask] = static_cast<uint8_t>(i + 1);
+    }
+    return slots;
+}
+
+constexpr size_t lengthBound(bool longest) {
+    size_t length = kKeywords[0].spelling.size();
+    for (const KeywordInfo& keyword : kKeywords) {
+        size_t size = keyword.spelling.size();
+        length = (longest ? size > length : size < length) ? size : length;
+    }
+    return length;
+}
+
+inline constexpr size_t kMinLength = lengthBound(false);
+inline constexpr size_t kMaxLength = lengthBound(true);
+inline constexpr uint32_t kSeed = findSeed();
+static_assert(kSeed != UINT32_MAX, "no se encontró semilla sin colisiones");
+inline constexpr std::array<uint8_t, kSlotCount> kSlots = buildSlots(kSeed);
+
+} // namespace keyword_detail
+
+/**
+ * @brief Tabla de palabras clave indexada por un hash perfecto
+ *
+ * La semilla del hash se busca en tiempo de compilación hasta que ninguna
+ * palabra clave colisiona, así que una búsqueda cuesta un hash del
+ * identificador, un acceso a la tabla y una comparación. Los identificadores
+ * fuera del rango de longitudes de las palabras clave se descartan sin hashear.
+ */
+class KeywordTable {
+public:
+    /**
+     * @brief Buscar una palabra clave (nullptr si no lo es)
+     */
+    static constexpr const KeywordInfo* lookup(std::string_view word) {
+        size_t index = indexOf(word);
+        return index < keyword_detail::kKeywords.size() ? &keyword_detail::kKeywords[index] : nullptr;
+    }
+
+    /**
+     * @brief Tipo de token de una palabra (IDENTIFIER si no es palabra clave)
+     */
+    static constexpr TokenType typeOf(std::string_view word) {
+        size_t index = indexOf(word);
+        return index < keyword_detail::kKeywords.size() ? keyword_detail::kKeywords[index].type
+                                                        : TokenType::IDENTIFIER;
+    }
+
+    /**
+     * @brief Todas las palabras clave reconocidas
+     */
+    static constexpr const auto& keywords() { return keyword_detail::kKeywords; }
+
+private:
+    /**
+     * @brief Índice de la palabra clave (kKeywords.size() si no lo es)
+     */
+    static constexpr size_t indexOf(std::string_view word) {
+        using namespace keyword_detail;
+        if (word.size() < kMinLength || word.size() > kMaxLength) {
+            return kKeywords.size();
+        }
+        uint8_t slot = kSlots[hash(word, kSeed) & kSlotMask];
+        if (slot == 0 || kKeywords[slot - 1].spelling != word) {
+            return kKeywords.size();
+        }
+        return slot - 1;
+    }
+};
+
+} // namespace cpp20::compiler::frontend::lexer
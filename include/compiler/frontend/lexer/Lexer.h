@@ -7,12 +7,23 @@
 
 #include <compiler/frontend/lexer/Token.h>
 #include <compiler/common/diagnostics/DiagnosticEngine.h>
+#include <compiler/common/utils/MemoryPool.h>
+#include <deque>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 
+namespace cpp20::compiler::common::utils {
+class ThreadPool;
+}
+
 namespace cpp20::compiler::frontend::lexer {
 
+class TokenBuffer;
+class IdentifierTable;
+class IdentifierInfo;
+
 /**
  * @brief Configuración del lexer
  */
@@ -24,6 +35,9 @@ struct LexerConfig {
     bool enableCoroutines = true;         // Soporte para corrutinas C++20
     bool enableConcepts = true;           // Soporte para conceptos C++20
     bool preserveComments = false;        // Preservar comentarios en tokens
+    bool enableTrigraphs = true;          // Reemplazo de trígrafos (eliminado en C++17)
+    uint32_t fileId = 0;                  // Archivo del SourceManager (ubicaciones)
+    IdentifierTable* identifiers = nullptr; // Tabla de identificadores (nullptr = global)
 };
 
 /**
@@ -41,21 +55,25 @@ struct LexerState {
 /**
  * @brief Lexer para C++20 que implementa las fases de traducción
  *
- * El lexer sigue las fases de traducción especificadas en [lex.phases]:
- * 1. Codificación física de caracteres
- * 2. Eliminación de caracteres de control
- * 3. Concatenación de líneas
- * 4. Reemplazo de trígrafos
- * 5. Eliminación de espacios en blanco y comentarios
- * 6. Tokenización
+ * Las fases 1-5 de [lex.phases] (eliminación de caracteres de control,
+ * concatenación de líneas, trígrafos y comentarios) no reescriben el
+ * buffer: están fusionadas en el cursor de caracteres, que las aplica al
+ * leer. La fase 6 produce tokens bajo demanda con getNextToken(), de modo
+ * que el consumo de memoria depende del lookahead y no del tamaño del
+ * archivo. tokenize() sigue disponible para materializar todos los tokens.
+ *
+ * El lexer no copia el código fuente: el buffer debe sobrevivir al lexer.
  */
 class Lexer {
 public:
     /**
      * @brief Constructor
+     * @param source Código fuente (vista; debe vivir más que el lexer)
+     * @param pool Arena para los buffers temporales (nullptr = el lexer crea la suya)
      */
-    Lexer(const std::string& source, diagnostics::DiagnosticEngine& diagEngine,
-          const LexerConfig& config = LexerConfig());
+    Lexer(std::string_view source, diagnostics::DiagnosticEngine& diagEngine,
+          const LexerConfig& config = LexerConfig(),
+          common::utils::MemoryPool* pool = nullptr);
 
     /**
      * @brief Destructor
@@ -63,17 +81,57 @@ public:
     ~Lexer();
 
     /**
-     * @brief Ejecutar todas las fases de traducción y obtener tokens
+     * @brief Consumir el flujo completo y obtener todos los tokens
      */
     std::vector<Token> tokenize();
 
+    /**
+     * @brief Consumir el flujo completo en formato compacto
+     *
+     * Los tokens se añaden a buffer sin copiar su texto salvo los que
+     * cruzan continuaciones de línea o trígrafos. El fuente se registra en
+     * el buffer con config.fileId.
+     */
+    void tokenize(TokenBuffer& buffer);
+
+    /**
+     * @brief Tamaño mínimo de cada trozo de tokenize(buffer, pool)
+     */
+    static constexpr size_t kMinParallelChunk = 1 << 20;
+
+    /**
+     * @brief Como tokenize(buffer), repartiendo el fuente en trozos entre los hilos de pool
+     *
+     * Para los fuentes generados de decenas de MB (tablas de datos). Los
+     * cortes de findSplitPoints() caen en saltos de línea donde el lexer
+     * secuencial está entre tokens, así que cada trozo se lexea con su
+     * propio lexer sobre el mismo fuente (offsets y líneas absolutos) y los
+     * tokens se concatenan en orden: el resultado es el mismo que el
+     * secuencial. Sin dos trozos de kMinParallelChunk no se divide. No debe
+     * llamarse desde una tarea del mismo pool.
+     */
+    void tokenize(TokenBuffer& buffer, common::utils::ThreadPool& pool);
+
+    /**
+     * @brief Puntos de corte para lexear el fuente por trozos
+     *
+     * Pre-escaneo lineal que solo sigue comentarios, literales y
+     * pp-numbers con el mismo cursor lógico que el lexer. Devuelve como
+     * mucho chunkCount - 1 offsets crecientes de '\n' que acaban una línea
+     * fuera de ellos, separados al menos size / chunkCount bytes.
+     */
+    static std::vector<size_t> findSplitPoints(std::string_view source, size_t chunkCount,
+                                               const LexerConfig& config = LexerConfig());
+
     /**
      * @brief Obtener siguiente token sin consumir
+     *
+     * La referencia es válida hasta el siguiente getNextToken().
      */
-    Token peekNextToken();
+    const Token& peekNextToken();
 
     /**
-     * @brief Obtener y consumir siguiente token
+     * @brief Obtener y consumir siguiente token (END_OF_FILE al terminar)
      */
     Token getNextToken();
 
@@ -100,54 +158,89 @@ public:
     LexerStats getStats() const { return stats_; }
 
 private:
-    std::string source_;                  // Código fuente original
+    std::string_view source_;             // Código fuente original
     diagnostics::DiagnosticEngine& diagEngine_; // Motor de diagnósticos
     LexerConfig config_;                  // Configuración del lexer
     LexerState state_;                    // Estado actual del lexer
     LexerStats stats_;                    // Estadísticas del análisis
 
-    std::vector<Token> tokens_;           // Tokens generados
-    size_t currentTokenIndex_ = 0;        // Índice del token actual
+    std::vector<Token> tokens_;           // Tokens materializados por tokenize()
+    std::deque<Token> lookahead_;         // Tokens leídos y aún no consumidos
+    bool eofConsumed_ = false;            // Si ya se entregó END_OF_FILE
+
+    diagnostics::SourceLocation tokenStart_; // Inicio del token en curso
+    size_t tokenStartOffset_ = 0;         // Offset físico del inicio del token
+    uint16_t tokenFlags_ = TOKEN_FLAG_NONE; // TokenFlags del token en curso
+    bool atStartOfLine_ = true;           // Aún no hay tokens en la línea actual
+    IdentifierTable* identifiers_;        // Tabla donde se internan los identificadores
+    IdentifierInfo* tokenIdentifier_ = nullptr; // Entrada del identificador en curso
+    bool tokenNeedsRebuild_ = false;      // El token cruza una continuación o trígrafo
+
+    using ScratchBuffer = std::vector<char, common::utils::ArenaAllocator<char>>;
+
+    std::unique_ptr<common::utils::MemoryPool> ownedPool_; // Arena propia si no se pasa una
+    common::utils::MemoryPool* pool_;     // Arena de buffers temporales
+
+    /**
+     * @brief Leer el siguiente token del buffer
+     */
+    Token lexNextToken();
+
+    /**
+     * @brief Añadir a buffer los tokens hasta el final del fuente
+     * @param endOfFile Añadir también el END_OF_FILE (no en los trozos intermedios)
+     */
+    void lexInto(TokenBuffer& buffer, bool endOfFile);
 
-    // === FASES DE TRADUCCIÓN ===
+    /**
+     * @brief Reconocer el siguiente token sin materializar su texto
+     *
+     * Deja en tokenStartOffset_..state_.position su extensión física.
+     */
+    TokenType lexTokenType();
 
     /**
-     * @brief Fase 1: Codificación física de caracteres
-     * (Asumimos que ya está en UTF-8)
+     * @brief Construir el Token del último lexTokenType()
      */
-    void phase1_PhysicalSource();
+    Token makeToken(TokenType type);
 
     /**
-     * @brief Fase 2: Eliminación de caracteres de control
+     * @brief Verificar si [from, to) contiene un fin de línea (no una continuación)
      */
-    void phase2_RemoveControlChars();
+    bool containsLineBreak(size_t from, size_t to) const;
 
     /**
-     * @brief Fase 3: Concatenación de líneas
+     * @brief Saltar espacios en blanco y comentarios (fase 5 fusionada)
      */
-    void phase3_LineConcatenation();
+    void skipWhitespaceAndComments();
 
     /**
-     * @brief Fase 4: Reemplazo de trígrafos
+     * @brief Posición del siguiente carácter lógico desde pos
+     *
+     * Salta continuaciones de línea y caracteres de control.
      */
-    void phase4_TrigraphReplacement();
+    size_t logicalPosition(size_t pos) const;
 
     /**
-     * @brief Fase 5: Eliminación de espacios en blanco y comentarios
+     * @brief Decodificar el carácter en pos (trígrafos)
+     * @return Número de bytes físicos que ocupa
      */
-    void phase5_RemoveWhitespaceAndComments();
+    size_t decodeAt(size_t pos, char& c) const;
 
     /**
-     * @brief Fase 6: Tokenización
+     * @brief Texto del token desde start hasta la posición actual
+     *
+     * Si el token cruza continuaciones o trígrafos se reconstruye en la arena.
      */
-    void phase6_Tokenization();
+    std::string spelling(size_t start);
 
     // === FUNCIONES DE TOKENIZACIÓN ===
 
     /**
-     * @brief Obtener siguiente caracter sin consumir
+     * @brief Obtener un caracter lógico sin consumir
+     * @param lookahead Caracteres lógicos a saltar (0 = el actual)
      */
-    char peekChar() const;
+    char peekChar(size_t lookahead = 0) const;
 
     /**
      * @brief Obtener y consumir siguiente caracter
@@ -174,35 +267,40 @@ private:
      */
     void advancePosition(char c);
 
+    /**
+     * @brief Avanzar hasta newPosition de una vez (saltos devueltos por CharScanner)
+     */
+    void advanceTo(size_t newPosition);
+
     /**
      * @brief Tokenizar identificadores y palabras clave
      */
-    Token tokenizeIdentifier();
+    TokenType tokenizeIdentifier();
+
+    /**
+     * @brief Longitud del prefijo de codificación (L, u, U, u8) si le sigue ' o " (0 si no)
+     */
+    size_t encodingPrefixLength() const;
 
     /**
      * @brief Tokenizar literales numéricos
      */
-    Token tokenizeNumber();
+    TokenType tokenizeNumber();
 
     /**
      * @brief Tokenizar literales de caracter
      */
-    Token tokenizeCharacterLiteral();
+    TokenType tokenizeCharacterLiteral();
 
     /**
      * @brief Tokenizar literales de string
      */
-    Token tokenizeStringLiteral();
+    TokenType tokenizeStringLiteral();
 
     /**
      * @brief Tokenizar operadores y puntuación
      */
-    Token tokenizeOperatorOrPunctuation();
-
-    /**
-     * @brief Manejar secuencias de escape
-     */
-    std::string handleEscapeSequence();
+    TokenType tokenizeOperatorOrPunctuation();
 
     /**
      * @brief Verificar si es dígito
@@ -229,12 +327,6 @@ private:
      */
     void reportError(const std::string& message, const diagnostics::SourceLocation& location);
 
-    /**
-     * @brief Crear token
-     */
-    Token createToken(TokenType type, const std::string& lexeme = "",
-                     const std::string& value = "");
-
     // === MANEJO DE LITERALES ===
 
     /**
@@ -307,7 +399,7 @@ public:
     /**
      * @brief Verificar si es palabra clave C++20
      */
-    static bool isCpp20Keyword(const std::string& word);
+    static bool isCpp20Keyword(std::string_view word);
 
     /**
      * @brief Normalizar nueva línea
@@ -5,16 +5,20 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <memory>
 #include <compiler/common/diagnostics/SourceLocation.h>
 
 namespace cpp20::compiler::frontend::lexer {
 
+class IdentifierInfo;
+
 /**
  * @brief Tipos de tokens para C++20
  */
-enum class TokenType {
+enum class TokenType : uint16_t {
     // === TOKENS ESPECIALES ===
     END_OF_FILE,           // Fin de archivo
     INVALID,              // Token inválido
@@ -129,6 +133,16 @@ enum class TokenType {
     CONCEPT_KEYWORD, REQUIRES_KEYWORD
 };
 
+/**
+ * @brief Flags de contexto de un token
+ */
+enum TokenFlags : uint16_t {
+    TOKEN_FLAG_NONE = 0,
+    TOKEN_FLAG_START_OF_LINE = 1 << 0,      // Primer token de su línea lógica
+    TOKEN_FLAG_LEADING_SPACE = 1 << 1,      // Precedido de espacio o comentario
+    TOKEN_FLAG_SPELLING_IN_TABLE = 1 << 2   // Texto en tabla (no coincide con el fuente)
+};
+
 /**
  * @brief Representa un token léxico en el código fuente
  *
@@ -158,6 +172,9 @@ public:
      * Necesario debido al destructor virtual personalizado
      */
     Token(const Token&) = default;
+    Token(Token&&) noexcept = default;
+    Token& operator=(const Token&) = default;
+    Token& operator=(Token&&) noexcept = default;
 
     /**
      * @brief Obtener tipo del token
@@ -209,11 +226,30 @@ public:
      */
     bool isValid() const { return type_ != TokenType::INVALID; }
 
+    /**
+     * @brief Flags de contexto (TokenFlags)
+     */
+    uint16_t flags() const { return flags_; }
+    void setFlags(uint16_t flags) { flags_ = flags; }
+
+    /**
+     * @brief Verificar si es el primer token de su línea
+     */
+    bool isAtStartOfLine() const { return (flags_ & TOKEN_FLAG_START_OF_LINE) != 0; }
+
+    /**
+     * @brief Entrada internada del identificador (nullptr si no es identificador)
+     */
+    IdentifierInfo* getIdentifierInfo() const { return identifierInfo_; }
+    void setIdentifierInfo(IdentifierInfo* info) { identifierInfo_ = info; }
+
 private:
     TokenType type_;                    // Tipo del token
+    uint16_t flags_ = TOKEN_FLAG_NONE;  // TokenFlags
     std::string lexeme_;               // Texto original del token
     diagnostics::SourceLocation location_; // Ubicación en el código fuente
     std::string value_;                // Valor semántico (para literales)
+    IdentifierInfo* identifierInfo_ = nullptr; // Identificador internado
 };
 
 /**
@@ -229,7 +265,12 @@ public:
     /**
      * @brief Verificar si un identificador es una palabra clave
      */
-    static TokenType getKeywordType(const std::string& identifier);
+    static TokenType getKeywordType(std::string_view identifier);
+
+    /**
+     * @brief Valor de un literal de carácter o string (sin comillas, escapes resueltos)
+     */
+    static std::string unescapeLiteral(std::string_view lexeme);
 
     /**
      * @brief Obtener precedencia de operador
@@ -0,0 +1,129 @@
+/**
+ * @file TokenBuffer.h
+ * @brief Representación compacta de tokens (16 bytes, trivialmente copiable)
+ */
+
+#pragma once
+
+#include <compiler/frontend/lexer/Token.h>
+#include <compiler/common/diagnostics/SourceLocation.h>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace cpp20::compiler::frontend::lexer {
+
+/**
+ * @brief Token compacto: tipo, flags, ubicación por offset y spelling
+ *
+ * El texto no se copia: spelling es la longitud del token en el fuente
+ * (a partir de offset) o, con TOKEN_FLAG_SPELLING_IN_TABLE, un índice en
+ * la tabla de spellings del TokenBuffer (tokens que cruzan continuaciones
+ * de línea o trigraphs). Línea y columna se calculan solo al pedirlas.
+ */
+struct CompactToken {
+    TokenType type;          // Tipo del token
+    uint16_t flags;          // TokenFlags
+    uint32_t fileId;         // Archivo del SourceManager
+    uint32_t offset;         // Offset del inicio del token en el archivo
+    uint32_t spelling;       // Longitud en el fuente o índice en la tabla
+};
+
+static_assert(sizeof(CompactToken) == 16, "CompactToken debe ocupar 16 bytes");
+static_assert(std::is_trivially_copyable_v<CompactToken>, "CompactToken debe ser POD");
+
+class TokenBuffer;
+
+/**
+ * @brief Vista de un token del buffer con la interfaz de lexer::Token
+ */
+class TokenView {
+public:
+    TokenView(const TokenBuffer& buffer, const CompactToken& token)
+        : buffer_(&buffer), token_(&token) {}
+
+    TokenType getType() const { return token_->type; }
+    std::string_view getLexeme() const;
+    std::string getValue() const;
+    diagnostics::SourceLocation getLocation() const;
+    uint16_t flags() const { return token_->flags; }
+    bool isAtStartOfLine() const { return (token_->flags & TOKEN_FLAG_START_OF_LINE) != 0; }
+    bool isValid() const { return token_->type != TokenType::INVALID; }
+
+    /**
+     * @brief Materializar como lexer::Token (para etapas aún no migradas)
+     */
+    Token toToken() const;
+
+private:
+    const TokenBuffer* buffer_;
+    const CompactToken* token_;
+};
+
+/**
+ * @brief Secuencia inmutable de tokens compactos de una unidad de traducción
+ *
+ * Registra las vistas de los archivos fuente de los que provienen los
+ * tokens; esos buffers deben sobrevivir al TokenBuffer. No es thread-safe.
+ */
+class TokenBuffer {
+public:
+    /**
+     * @brief Registrar el texto de un archivo (debe vivir más que el buffer)
+     */
+    void addSource(uint32_t fileId, std::string_view text);
+
+    /**
+     * @brief Añadir un token cuyo texto es el fuente en [offset, offset + length)
+     */
+    void pushSpan(TokenType type, uint32_t fileId, uint32_t offset, uint32_t length,
+                  uint16_t flags = TOKEN_FLAG_NONE);
+
+    /**
+     * @brief Añadir un token cuyo texto no coincide con el fuente
+     */
+    void pushSpelled(TokenType type, uint32_t fileId, uint32_t offset, std::string spelling,
+                     uint16_t flags = TOKEN_FLAG_NONE);
+
+    /**
+     * @brief Mover al final los tokens de other (sus spellings y fuentes incluidos)
+     */
+    void append(TokenBuffer&& other);
+
+    size_t size() const { return tokens_.size(); }
+    bool empty() const { return tokens_.empty(); }
+    void reserve(size_t count) { tokens_.reserve(count); }
+    void clear();
+
+    const CompactToken& operator[](size_t index) const { return tokens_[index]; }
+    TokenView view(size_t index) const { return TokenView(*this, tokens_[index]); }
+
+    std::vector<CompactToken>::const_iterator begin() const { return tokens_.begin(); }
+    std::vector<CompactToken>::const_iterator end() const { return tokens_.end(); }
+
+    /**
+     * @brief Texto del token sin copia
+     */
+    std::string_view spelling(const CompactToken& token) const;
+
+    /**
+     * @brief Ubicación completa (línea/columna calculadas bajo demanda)
+     */
+    diagnostics::SourceLocation location(const CompactToken& token) const;
+
+private:
+    struct SourceText {
+        std::string_view text;
+        mutable std::vector<uint32_t> lineOffsets; // Calculado con la primera ubicación
+    };
+
+    std::vector<CompactToken> tokens_;
+    std::unordered_map<uint32_t, SourceText> sources_;
+    std::deque<std::string> spellings_;  // deque: las vistas a sus elementos son estables
+};
+
+} // namespace cpp20::compiler::frontend::lexer
@@ -6,8 +6,11 @@
 #pragma once
 
 #include <compiler/ir/IR.h>
-#include <vector>
 #include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace cpp20::compiler::ir {
 
@@ -52,63 +55,14 @@ struct InvokeInfo {
 };
 
 /**
- * @brief Instrucción invoke (llamada que puede lanzar excepciones)
- */
-class InvokeInstruction : public IRInstruction {
-public:
-    InvokeInstruction(std::shared_ptr<IROperand> function,
-                     const std::vector<std::shared_ptr<IROperand>>& args,
-                     const TypeInfo& resultType,
-                     std::shared_ptr<InvokeInfo> invokeInfo)
-        : IRInstruction(IROpcode::Call, resultType), invokeInfo_(invokeInfo) {
-        addOperand(function);
-        for (auto& arg : args) {
-            addOperand(arg);
-        }
-    }
-
-    std::shared_ptr<InvokeInfo> getInvokeInfo() const { return invokeInfo_; }
-
-    std::string toString() const override;
-
-private:
-    std::shared_ptr<InvokeInfo> invokeInfo_;
-};
-
-/**
- * @brief Instrucción landing pad
- */
-class LandingPadInstruction : public IRInstruction {
-public:
-    LandingPadInstruction(const std::vector<std::string>& catchTypes,
-                         const std::vector<std::string>& cleanupActions,
-                         const TypeInfo& resultType)
-        : IRInstruction(IROpcode::Phi, resultType),
-          catchTypes_(catchTypes), cleanupActions_(cleanupActions) {}
-
-    const std::vector<std::string>& getCatchTypes() const { return catchTypes_; }
-    const std::vector<std::string>& getCleanupActions() const { return cleanupActions_; }
-
-    std::string toString() const override;
-
-private:
-    std::vector<std::string> catchTypes_;
-    std::vector<std::string> cleanupActions_;
-};
-
-/**
- * @brief Instrucción resume (relanzar excepción)
+ * @brief Cláusulas de una instrucción landing pad
+ *
+ * La instrucción LandingPad de la IR no tiene operandos; sus cláusulas
+ * se guardan aparte, indexadas por InstrId.
  */
-class ResumeInstruction : public IRInstruction {
-public:
-    ResumeInstruction(std::shared_ptr<IROperand> exceptionValue)
-        : IRInstruction(IROpcode::Ret) {
-        if (exceptionValue) {
-            addOperand(exceptionValue);
-        }
-    }
-
-    std::string toString() const override;
+struct LandingPadInfo {
+    std::vector<std::string> catchTypes;
+    std::vector<std::string> cleanupActions;
 };
 
 /**
@@ -150,6 +104,16 @@ public:
      */
     std::shared_ptr<InvokeInfo> createInvokeInfo(uint32_t normalBlock, uint32_t unwindBlock);
 
+    /**
+     * @brief Registra las cláusulas de un landing pad
+     */
+    void setLandingPadInfo(InstrId landingPad, LandingPadInfo info);
+
+    /**
+     * @brief Cláusulas de un landing pad, o nullptr si no es uno registrado
+     */
+    const LandingPadInfo* getLandingPadInfo(InstrId landingPad) const;
+
     /**
      * @brief Verifica si una función tiene exception handling
      */
@@ -167,6 +131,7 @@ public:
 
 private:
     std::vector<std::shared_ptr<ExceptionRegion>> exceptionRegions_;
+    std::unordered_map<InstrId, LandingPadInfo> landingPads_;
     uint32_t nextRegionId_ = 1;
 };
 
@@ -181,37 +146,36 @@ public:
     ExceptionIRBuilder(IRBuilder& irBuilder, ExceptionHandler& exceptionHandler);
 
     /**
-     * @brief Crea una instrucción invoke
+     * @brief Crea una instrucción invoke en el punto de inserción
+     * @return Valor resultado, o NoValue si resultType es Void
      */
-    std::unique_ptr<InvokeInstruction> createInvoke(
-        std::shared_ptr<IROperand> function,
-        const std::vector<std::shared_ptr<IROperand>>& args,
-        const TypeInfo& resultType,
-        uint32_t normalBlock,
-        uint32_t unwindBlock);
+    ValueId createInvoke(ValueId function,
+                         std::span<const ValueId> args,
+                         const TypeInfo& resultType,
+                         BlockId normalBlock,
+                         BlockId unwindBlock);
 
     /**
-     * @brief Crea una instrucción landing pad
+     * @brief Crea una instrucción landing pad en el punto de inserción
      */
-    std::unique_ptr<LandingPadInstruction> createLandingPad(
-        const std::vector<std::string>& catchTypes,
-        const std::vector<std::string>& cleanupActions,
-        const TypeInfo& resultType);
+    ValueId createLandingPad(const std::vector<std::string>& catchTypes,
+                             const std::vector<std::string>& cleanupActions,
+                             const TypeInfo& resultType);
 
     /**
-     * @brief Crea una instrucción resume
+     * @brief Crea una instrucción resume en el punto de inserción
      */
-    std::unique_ptr<ResumeInstruction> createResume(std::shared_ptr<IROperand> exceptionValue);
+    InstrId createResume(ValueId exceptionValue = NoValue);
 
     /**
-     * @brief Crea bloques para exception handling
+     * @brief Crea un bloque landing pad catch-all
      */
-    std::unique_ptr<BasicBlock> createLandingPadBlock(uint32_t blockId);
+    BlockId createLandingPadBlock(uint32_t blockId);
 
     /**
      * @brief Crea bloque de cleanup
      */
-    std::unique_ptr<BasicBlock> createCleanupBlock(uint32_t blockId);
+    BlockId createCleanupBlock(uint32_t blockId);
 
 private:
     IRBuilder& irBuilder_;
@@ -1,15 +1,25 @@
 /**
  * @file IR.h
  * @brief Representación Intermedia (IR) del compilador C++20
+ *
+ * Cada IRFunction guarda su código en forma SSA densa: instrucciones,
+ * operandos y valores viven en vectores contiguos de la propia función y
+ * se referencian con identificadores de 32 bits. Cada valor mantiene la
+ * lista de sus usos, así que replaceAllUsesWith no recorre la función.
  */
 
 #pragma once
 
-#include <string>
-#include <vector>
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
 #include <unordered_map>
-#include <variant>
+#include <utility>
+#include <vector>
 
 namespace cpp20::compiler::ir {
 
@@ -29,7 +39,8 @@ enum class IRType {
     Pointer,    // Puntero genérico
     Array,      // Array
     Struct,     // Struct/class
-    Function    // Tipo función
+    Function,   // Tipo función
+    Vector      // Vector SIMD de escalares (ver TypeInfo::vectorOf)
 };
 
 /**
@@ -40,139 +51,54 @@ struct TypeInfo {
     size_t size = 0;        // Tamaño en bytes
     size_t alignment = 1;   // Alineación en bytes
     std::string typeName;   // Nombre del tipo (para structs, etc.)
+    IRType elementType = IRType::Void;  // Solo vectores: tipo de cada lane
+    uint32_t lanes = 0;
 
     TypeInfo(IRType t = IRType::Void, size_t sz = 0, size_t align = 1,
              const std::string& name = "")
         : type(t), size(sz), alignment(align), typeName(name) {}
-};
-
-/**
- * @brief Operandos de las instrucciones IR
- */
-class IROperand {
-public:
-    enum class Kind {
-        Register,       // Registro virtual
-        Immediate,      // Valor inmediato
-        Label,          // Etiqueta
-        Global,         // Variable global
-        Parameter       // Parámetro de función
-    };
-
-    IROperand(Kind k = Kind::Register) : kind_(k) {}
-
-    Kind getKind() const { return kind_; }
-
-    // Métodos para diferentes tipos de operandos
-    virtual std::string toString() const = 0;
-    virtual ~IROperand() = default;
-
-protected:
-    Kind kind_;
-};
-
-/**
- * @brief Registro virtual
- */
-class Register : public IROperand {
-public:
-    Register(int id, const TypeInfo& type)
-        : IROperand(Kind::Register), id_(id), type_(type) {}
-
-    int getId() const { return id_; }
-    const TypeInfo& getType() const { return type_; }
-
-    std::string toString() const override {
-        return "%r" + std::to_string(id_);
-    }
-
-private:
-    int id_;
-    TypeInfo type_;
-};
-
-/**
- * @brief Valor inmediato
- */
-class Immediate : public IROperand {
-public:
-    using ValueType = std::variant<int64_t, double, bool, std::string>;
-
-    Immediate(ValueType value, const TypeInfo& type)
-        : IROperand(Kind::Immediate), value_(value), type_(type) {}
-
-    const ValueType& getValue() const { return value_; }
-    const TypeInfo& getType() const { return type_; }
-
-    std::string toString() const override;
-
-private:
-    ValueType value_;
-    TypeInfo type_;
-};
-
-/**
- * @brief Etiqueta
- */
-class Label : public IROperand {
-public:
-    Label(const std::string& name)
-        : IROperand(Kind::Label), name_(name) {}
-
-    const std::string& getName() const { return name_; }
-
-    std::string toString() const override {
-        return name_;
-    }
-
-private:
-    std::string name_;
-};
-
-/**
- * @brief Variable global
- */
-class GlobalVar : public IROperand {
-public:
-    GlobalVar(const std::string& name, const TypeInfo& type)
-        : IROperand(Kind::Global), name_(name), type_(type) {}
-
-    const std::string& getName() const { return name_; }
-    const TypeInfo& getType() const { return type_; }
-
-    std::string toString() const override {
-        return "@" + name_;
-    }
 
-private:
-    std::string name_;
-    TypeInfo type_;
-};
-
-/**
- * @brief Parámetro de función
- */
-class Parameter : public IROperand {
-public:
-    Parameter(int index, const TypeInfo& type)
-        : IROperand(Kind::Parameter), index_(index), type_(type) {}
+    bool operator==(const TypeInfo& other) const = default;
 
-    int getIndex() const { return index_; }
-    const TypeInfo& getType() const { return type_; }
+    bool isFloatingPoint() const { return type == IRType::Float || type == IRType::Double; }
+    bool isVector() const { return type == IRType::Vector; }
 
-    std::string toString() const override {
-        return "%arg" + std::to_string(index_);
+    /**
+     * @brief Tipo vector de lanes elementos escalares, alineado a su tamaño
+     */
+    static TypeInfo vectorOf(const TypeInfo& element, uint32_t lanes) {
+        TypeInfo vector(IRType::Vector, element.size * lanes, element.size * lanes,
+                        "<" + std::to_string(lanes) + " x " + element.typeName + ">");
+        vector.elementType = element.type;
+        vector.lanes = lanes;
+        return vector;
     }
-
-private:
-    int index_;
-    TypeInfo type_;
 };
 
 /**
  * @brief Operaciones de la IR (formato de tres direcciones)
+ *
+ * Disposición de los operandos:
+ *   binarias / comparaciones   [lhs, rhs]
+ *   Neg, Not, conversiones     [valor]
+ *   Load                       [dirección]
+ *   Store                      [valor, dirección]
+ *   Alloca                     []
+ *   GetElementPtr              [base, índices...]
+ *   Br                         [destino]
+ *   BrCond                     [condición, si, no]
+ *   Call                       [función, argumentos...]
+ *   Invoke                     [función, argumentos..., normal, unwind]
+ *   Ret                        [] o [valor]
+ *   Phi                        [valor0, bloque0, valor1, bloque1, ...]
+ *   Select                     [condición, si, no]
+ *   Broadcast                  [escalar] (resultado vector con el escalar en cada lane)
+ *   LandingPad                 []
+ *   Resume                     [] o [excepción]
+ *   Switch                     [valor, defecto, caso0, bloque0, caso1, bloque1, ...]
+ *                              (casos: constantes enteras distintas)
  */
-enum class IROpcode {
+enum class IROpcode : uint8_t {
     // Operaciones aritméticas
     Add, Sub, Mul, Div, Mod, Neg,
 
@@ -192,183 +118,162 @@ enum class IROpcode {
     Trunc, ZExt, SExt, FPTrunc, FPExt, FPToSI, SIToFP,
 
     // Operaciones especiales
-    Phi, Select
-};
+    Phi, Select, Broadcast,
 
-/**
- * @brief Instrucción IR
- */
-class IRInstruction {
-public:
-    IRInstruction(IROpcode opcode, const TypeInfo& resultType = TypeInfo())
-        : opcode_(opcode), resultType_(resultType) {}
+    // Excepciones
+    Invoke, LandingPad, Resume,
 
-    virtual ~IRInstruction() = default;
+    // Salto multidestino; SwitchLoweringPass lo baja antes del back-end
+    Switch,
 
-    IROpcode getOpcode() const { return opcode_; }
-    const TypeInfo& getResultType() const { return resultType_; }
+    // Intrínsecos de memoria: (destino, origen o byte, tamaño en bytes).
+    // MemCmp solo distingue iguales (0) de distintos (otro valor)
+    MemCpy, MemSet, MemCmp,
 
-    // Operandos
-    void addOperand(std::shared_ptr<IROperand> operand) {
-        operands_.push_back(operand);
-    }
+    // CPUFeatures::mask() de la CPU que ejecuta el programa (CPUID y XGETBV)
+    CPUFeatures,
 
-    const std::vector<std::shared_ptr<IROperand>>& getOperands() const {
-        return operands_;
-    }
+    // Intrínsecos de bits, sin signo y al ancho del tipo. Unarios: [valor];
+    // CountLeadingZeros y CountTrailingZeros de 0 dan el ancho. Rotaciones:
+    // [valor, cuenta] (cuenta módulo el ancho). BitDeposit / BitExtract:
+    // [valor, máscara] (PDEP / PEXT). Crc32: [crc, dato], CRC-32C sobre el
+    // ancho del dato, resultado de 32 bits
+    PopCount, CountLeadingZeros, CountTrailingZeros, ByteSwap,
+    RotateLeft, RotateRight, BitDeposit, BitExtract, Crc32
+};
 
-    // Resultado (registro destino)
-    void setResult(std::shared_ptr<Register> result) {
-        result_ = result;
-    }
+/**
+ * @brief Nombre textual de un opcode
+ */
+const char* opcodeName(IROpcode opcode);
 
-    std::shared_ptr<Register> getResult() const { return result_; }
+/**
+ * @brief Instrucciones que terminan un bloque básico
+ */
+bool isTerminator(IROpcode opcode);
 
-    virtual std::string toString() const = 0;
+/**
+ * @brief Instrucciones sin efectos laterales cuyo resultado depende solo de sus operandos
+ */
+bool isPure(IROpcode opcode);
 
-protected:
-    IROpcode opcode_;
-    TypeInfo resultType_;
-    std::vector<std::shared_ptr<IROperand>> operands_;
-    std::shared_ptr<Register> result_;
-};
+/**
+ * @brief Instrucciones que no se pueden borrar aunque su resultado no se use
+ */
+bool hasSideEffects(IROpcode opcode);
 
 /**
- * @brief Instrucción binaria (Add, Sub, Mul, etc.)
+ * @brief Instrucciones que pueden escribir en memoria
  */
-class BinaryInstruction : public IRInstruction {
-public:
-    BinaryInstruction(IROpcode opcode, std::shared_ptr<IROperand> left,
-                     std::shared_ptr<IROperand> right, const TypeInfo& resultType)
-        : IRInstruction(opcode, resultType) {
-        addOperand(left);
-        addOperand(right);
-    }
+bool writesMemory(IROpcode opcode);
 
-    std::string toString() const override;
-};
+// Identificadores densos dentro de una IRFunction
+using ValueId = uint32_t;
+using InstrId = uint32_t;
+using BlockId = uint32_t;
+using TypeId = uint32_t;
+
+inline constexpr ValueId NoValue = ~0u;
+inline constexpr InstrId NoInstr = ~0u;
+inline constexpr BlockId NoBlock = ~0u;
 
 /**
- * @brief Instrucción unaria (Neg, Not, etc.)
+ * @brief Frecuencia de un bloque sin dato de perfil (creado tras anotarlo)
  */
-class UnaryInstruction : public IRInstruction {
-public:
-    UnaryInstruction(IROpcode opcode, std::shared_ptr<IROperand> operand,
-                    const TypeInfo& resultType)
-        : IRInstruction(opcode, resultType) {
-        addOperand(operand);
-    }
+inline constexpr uint64_t UnknownFrequency = ~0ull;
 
-    std::string toString() const override;
+/**
+ * @brief Clase de entidad a la que se refiere un ValueId
+ */
+enum class ValueKind : uint8_t {
+    Instruction,    // Resultado de una instrucción
+    Constant,       // Constante (deduplicada por función)
+    Parameter,      // Parámetro de la función
+    Global,         // Variable o función global, por nombre
+    Block,          // Etiqueta de un bloque básico
+    Undef           // Valor indefinido (lectura sin escritura previa)
 };
 
 /**
- * @brief Instrucción de carga (Load)
+ * @brief Constante escalar
+ *
+ * Los enteros y booleanos usan intValue; los flotantes, floatValue.
  */
-class LoadInstruction : public IRInstruction {
-public:
-    LoadInstruction(std::shared_ptr<IROperand> address, const TypeInfo& resultType)
-        : IRInstruction(IROpcode::Load, resultType) {
-        addOperand(address);
-    }
-
-    std::string toString() const override;
+struct IRConstant {
+    int64_t intValue = 0;
+    double floatValue = 0.0;
 };
 
 /**
- * @brief Instrucción de almacenamiento (Store)
+ * @brief Entrada de la tabla de valores
  */
-class StoreInstruction : public IRInstruction {
-public:
-    StoreInstruction(std::shared_ptr<IROperand> value, std::shared_ptr<IROperand> address)
-        : IRInstruction(IROpcode::Store) {
-        addOperand(value);
-        addOperand(address);
-    }
-
-    std::string toString() const override;
+struct Value {
+    ValueKind kind;
+    TypeId type;
+    uint32_t index;         // Instrucción, constante, parámetro, global o bloque
+    uint32_t firstUse;      // Primer OperandSlot que usa el valor
 };
 
 /**
- * @brief Instrucción de salto condicional
+ * @brief Operando: un uso de un valor, enlazado en su lista de usos
  */
-class BranchInstruction : public IRInstruction {
-public:
-    BranchInstruction(std::shared_ptr<IROperand> condition,
-                     std::shared_ptr<Label> trueLabel,
-                     std::shared_ptr<Label> falseLabel)
-        : IRInstruction(IROpcode::BrCond) {
-        addOperand(condition);
-        addOperand(trueLabel);
-        addOperand(falseLabel);
-    }
-
-    BranchInstruction(std::shared_ptr<Label> target)
-        : IRInstruction(IROpcode::Br) {
-        addOperand(target);
-    }
-
-    std::string toString() const override;
+struct OperandSlot {
+    ValueId value;
+    InstrId user;
+    uint32_t prevUse;
+    uint32_t nextUse;
 };
 
 /**
- * @brief Instrucción de retorno
+ * @brief Instrucción
+ *
+ * Sus operandos son operandCount OperandSlot contiguos a partir de
+ * firstOperand. Las instrucciones de un bloque forman una lista
+ * doblemente enlazada (prev/next) sobre el vector de la función, de
+ * modo que insertar y borrar no mueve ninguna otra.
  */
-class ReturnInstruction : public IRInstruction {
-public:
-    ReturnInstruction(std::shared_ptr<IROperand> value = nullptr)
-        : IRInstruction(IROpcode::Ret) {
-        if (value) {
-            addOperand(value);
-        }
-    }
-
-    std::string toString() const override;
+struct Instruction {
+    IROpcode opcode;
+    bool erased = false;
+    bool tail = false;      // Call que debe bajarse a un salto (ver IRFunction::setTailCall)
+    TypeId type;            // Tipo del resultado (o el reservado por Alloca)
+    ValueId result;         // NoValue si no produce valor
+    BlockId block;
+    uint32_t firstOperand;
+    uint32_t operandCount;
+    uint32_t operandCapacity;
+    InstrId prev;
+    InstrId next;
 };
 
 /**
- * @brief Instrucción de llamada a función
+ * @brief Bloque básico
  */
-class CallInstruction : public IRInstruction {
-public:
-    CallInstruction(std::shared_ptr<IROperand> function,
-                   const std::vector<std::shared_ptr<IROperand>>& args,
-                   const TypeInfo& resultType)
-        : IRInstruction(IROpcode::Call, resultType) {
-        addOperand(function);
-        for (auto& arg : args) {
-            addOperand(arg);
-        }
-    }
-
-    std::string toString() const override;
+struct BasicBlock {
+    std::string name;
+    ValueId label;
+    InstrId first = NoInstr;
+    InstrId last = NoInstr;
+    uint64_t frequency = UnknownFrequency;  // Ejecuciones según el perfil (-fprofile-use)
+    uint32_t alignment = 0;                 // Bytes a los que alinear su inicio; 0 sin alinear
 };
 
 /**
- * @brief Bloque básico de instrucciones
+ * @brief Indicación de inlining de la declaración
  */
-class BasicBlock {
-public:
-    BasicBlock(const std::string& name)
-        : name_(name), label_(std::make_shared<Label>(name)) {}
-
-    void addInstruction(std::unique_ptr<IRInstruction> instruction) {
-        instructions_.push_back(std::move(instruction));
-    }
-
-    const std::string& getName() const { return name_; }
-    const std::vector<std::unique_ptr<IRInstruction>>& getInstructions() const {
-        return instructions_;
-    }
-
-    std::shared_ptr<Label> getLabel() const { return label_; }
-
-    std::string toString() const;
+enum class InlineHint : uint8_t {
+    None,       // Decide el modelo de coste
+    Inline,     // Declarada inline: umbral más alto
+    Always,     // __forceinline / always_inline
+    Never       // __declspec(noinline) / noinline
+};
 
-private:
-    std::string name_;
-    std::shared_ptr<Label> label_;
-    std::vector<std::unique_ptr<IRInstruction>> instructions_;
+/**
+ * @brief Enlace de la definición
+ */
+enum class Linkage : uint8_t {
+    External,   // Una sola definición en todo el programa
+    LinkOnce    // inline o instancia de plantilla: puede repetirse entre unidades
 };
 
 /**
@@ -377,32 +282,358 @@ private:
 class IRFunction {
 public:
     IRFunction(const std::string& name, const TypeInfo& returnType,
-               const std::vector<TypeInfo>& paramTypes)
-        : name_(name), returnType_(returnType), paramTypes_(paramTypes) {}
+               const std::vector<TypeInfo>& paramTypes);
 
-    void addBasicBlock(std::unique_ptr<BasicBlock> block) {
-        blocks_.push_back(std::move(block));
-    }
+    // ========================================================================
+    // Firma
+    // ========================================================================
 
-    void addParameter(const std::string& name, const TypeInfo& type) {
-        paramNames_.push_back(name);
-        paramTypes_.push_back(type);
-    }
+    void addParameter(const std::string& name, const TypeInfo& type);
 
     const std::string& getName() const { return name_; }
     const TypeInfo& getReturnType() const { return returnType_; }
     const std::vector<TypeInfo>& getParamTypes() const { return paramTypes_; }
     const std::vector<std::string>& getParamNames() const { return paramNames_; }
-    const std::vector<std::unique_ptr<BasicBlock>>& getBasicBlocks() const { return blocks_; }
 
+    void setInlineHint(InlineHint hint) { inlineHint_ = hint; }
+    InlineHint getInlineHint() const { return inlineHint_; }
+
+    void setLinkage(Linkage linkage) { linkage_ = linkage; }
+    Linkage getLinkage() const { return linkage_; }
+
+    /**
+     * @brief Renombra la función; pensado para copias que aún nadie referencia
+     */
+    void setName(const std::string& name) { name_ = name; }
+
+    /**
+     * @brief target_clones: una copia por extensión, elegida al cargar la imagen
+     *
+     * Nombres de parseTargetFeatures; MultiversioningPass los consume.
+     */
+    void setTargetClones(std::vector<std::string> targets) { targetClones_ = std::move(targets); }
+    const std::vector<std::string>& getTargetClones() const { return targetClones_; }
+
+    /**
+     * @brief Extensiones para las que se compila esta función (vacío = las del módulo)
+     *
+     * El back-end y el vectorizador las suman a las de la compilación.
+     */
+    void setTarget(const std::string& target) { target_ = target; }
+    const std::string& getTarget() const { return target_; }
+
+    /**
+     * @brief Valor del parámetro index
+     */
+    ValueId parameter(size_t index) const { return parameters_[index]; }
+
+    // ========================================================================
+    // Tipos y valores
+    // ========================================================================
+
+    /**
+     * @brief Identificador del tipo, compartido por todos los valores iguales
+     */
+    TypeId internType(const TypeInfo& type);
+    const TypeInfo& type(TypeId id) const { return types_[id]; }
+    const TypeInfo& typeOf(ValueId value) const { return types_[values_[value].type]; }
+
+    ValueId constantInt(int64_t value, const TypeInfo& type);
+    ValueId constantFloat(double value, const TypeInfo& type);
+    ValueId constantBool(bool value);
+
+    /**
+     * @brief Valor indefinido del tipo, uno por tipo
+     */
+    ValueId undef(const TypeInfo& type);
+
+    /**
+     * @brief Referencia a un símbolo global (variable o función)
+     */
+    ValueId global(std::string_view name, const TypeInfo& type);
+
+    const Value& value(ValueId id) const { return values_[id]; }
+    size_t valueCount() const { return values_.size(); }
+
+    /**
+     * @brief Constante del valor, o nullptr si no es una constante
+     */
+    const IRConstant* constant(ValueId id) const;
+    const std::string& globalName(ValueId id) const { return globals_[values_[id].index]; }
+
+    /**
+     * @brief Instrucción que define el valor, o NoInstr
+     */
+    InstrId definingInstruction(ValueId id) const;
+
+    // ========================================================================
+    // Bloques
+    // ========================================================================
+
+    /**
+     * @brief Crea un bloque al final de la función; el primero es la entrada
+     */
+    BlockId createBlock(const std::string& name);
+
+    const BasicBlock& block(BlockId id) const { return blocks_[id]; }
+    size_t blockCount() const { return blocks_.size(); }
+
+    ValueId blockLabel(BlockId id) const { return blocks_[id].label; }
+
+    /**
+     * @brief Bloque nombrado por una etiqueta
+     */
+    BlockId labelBlock(ValueId label) const { return values_[label].index; }
+
+    /**
+     * @brief Terminador del bloque, o NoInstr si aún no lo tiene
+     */
+    InstrId terminator(BlockId id) const;
+
+    /**
+     * @brief Sucesores según el terminador del bloque
+     */
+    void successors(BlockId id, std::vector<BlockId>& out) const;
+
+    /**
+     * @brief Ejecuciones del bloque según el perfil, o UnknownFrequency
+     */
+    uint64_t blockFrequency(BlockId id) const { return blocks_[id].frequency; }
+    void setBlockFrequency(BlockId id, uint64_t frequency);
+
+    /**
+     * @brief Alinea el inicio del bloque (potencia de dos) con NOPs de relleno
+     */
+    void setBlockAlignment(BlockId id, uint32_t alignment) { blocks_[id].alignment = alignment; }
+
+    /**
+     * @brief Si la función está anotada con un perfil (ProfileAnnotatePass)
+     */
+    bool hasProfile() const { return hasProfile_; }
+
+    /**
+     * @brief Ejecuciones del bloque por llamada a la función, o -1 si no se conocen
+     */
+    double relativeFrequency(BlockId id) const;
+
+    /**
+     * @brief Orden de emisión de los bloques; por defecto el de creación
+     *
+     * La entrada va siempre primera. Los bloques creados después de fijar
+     * el orden se añaden al final.
+     */
+    std::vector<BlockId> blockLayout() const;
+    void setBlockLayout(std::vector<BlockId> layout);
+
+    // ========================================================================
+    // Instrucciones
+    // ========================================================================
+
+    /**
+     * @brief Añade una instrucción al final del bloque
+     * @param producesValue Si crea un valor resultado de tipo resultType
+     */
+    InstrId append(BlockId block, IROpcode opcode, const TypeInfo& type,
+                   std::span<const ValueId> operands, bool producesValue);
+
+    /**
+     * @brief Añade una instrucción al principio del bloque (phis)
+     */
+    InstrId prepend(BlockId block, IROpcode opcode, const TypeInfo& type,
+                    std::span<const ValueId> operands, bool producesValue);
+
+    /**
+     * @brief Inserta una instrucción justo antes de position
+     */
+    InstrId insertBefore(InstrId position, IROpcode opcode, const TypeInfo& type,
+                         std::span<const ValueId> operands, bool producesValue);
+
+    /**
+     * @brief Saca la instrucción de su bloque y libera sus operandos
+     *
+     * El identificador sigue siendo válido (erased = true) y conserva su
+     * next, así que se puede borrar la instrucción actual mientras se
+     * itera un bloque. Su resultado no debe tener usos.
+     */
+    void erase(InstrId id);
+
+    /**
+     * @brief Borra todas las instrucciones del bloque
+     *
+     * Los usos de sus resultados fuera del bloque pasan a undef: solo debe
+     * usarse con bloques que han quedado inalcanzables.
+     */
+    void clearBlock(BlockId block);
+
+    /**
+     * @brief Mueve una instrucción delante de position (quizá en otro bloque)
+     */
+    void moveBefore(InstrId id, InstrId position);
+
+    /**
+     * @brief Mueve una instrucción al final de un bloque
+     */
+    void moveToEnd(InstrId id, BlockId block);
+
+    /**
+     * @brief Parte el bloque de id: lo que sigue a id pasa a un bloque nuevo
+     *
+     * Los phis de los sucesores pasan a recibir la entrada desde el bloque
+     * nuevo, que es el que ahora contiene el terminador.
+     */
+    BlockId splitBlockAfter(InstrId id, const std::string& name);
+
+    const Instruction& instruction(InstrId id) const { return instructions_[id]; }
+    size_t instructionCapacity() const { return instructions_.size(); }
+
+    /**
+     * @brief Marca un Call en posición de cola (musttail)
+     *
+     * El Call debe ir seguido del Ret de su resultado (o de un Ret vacío).
+     * El back-end lo baja a epílogo y JMP, sin CALL/RET ni marco nuevo, así
+     * que una cadena de llamadas así ocupa pila constante: es la
+     * transferencia simétrica de las corrutinas (await_suspend que devuelve
+     * un coroutine_handle, resume del siguiente marco en la salida). Si un
+     * pase separa el Call del Ret, queda como llamada normal.
+     */
+    void setTailCall(InstrId id, bool tail = true) { instructions_[id].tail = tail; }
+
+    /**
+     * @brief Número de instrucciones no borradas
+     */
+    size_t instructionCount() const { return instructions_.size() - erasedCount_; }
+
+    ValueId operand(InstrId id, size_t index) const {
+        return operands_[instructions_[id].firstOperand + index].value;
+    }
+
+    size_t operandCount(InstrId id) const { return instructions_[id].operandCount; }
+
+    void setOperand(InstrId id, size_t index, ValueId value);
+
+    /**
+     * @brief Añade un operando (entradas de Phi)
+     */
+    void addOperand(InstrId id, ValueId value);
+
+    /**
+     * @brief Quita el operando index desplazando los siguientes
+     */
+    void removeOperand(InstrId id, size_t index);
+
+    /**
+     * @brief Quita de los phis de block las entradas que llegan desde predecessor
+     */
+    void removeIncoming(BlockId block, BlockId predecessor);
+
+    // ========================================================================
+    // Usos
+    // ========================================================================
+
+    /**
+     * @brief Sustituye todos los usos de from por to
+     */
+    void replaceAllUsesWith(ValueId from, ValueId to);
+
+    bool hasUses(ValueId id) const { return values_[id].firstUse != NoUse; }
+    size_t useCount(ValueId id) const;
+
+    /**
+     * @brief Recorre los usos del valor: f(instrucción, índice del operando)
+     */
+    template <typename F>
+    void forEachUse(ValueId id, F&& f) const {
+        for (uint32_t slot = values_[id].firstUse; slot != NoUse;) {
+            const OperandSlot& use = operands_[slot];
+            uint32_t next = use.nextUse;
+            f(use.user, slot - instructions_[use.user].firstOperand);
+            slot = next;
+        }
+    }
+
+    // ========================================================================
+    // Iteración
+    // ========================================================================
+
+    /**
+     * @brief Rango de las instrucciones de un bloque, en orden
+     */
+    class InstructionRange {
+    public:
+        class iterator {
+        public:
+            iterator(const IRFunction* function, InstrId id) : function_(function), id_(id) {}
+            InstrId operator*() const { return id_; }
+            iterator& operator++() {
+                id_ = function_->instructions_[id_].next;
+                return *this;
+            }
+            bool operator!=(const iterator& other) const { return id_ != other.id_; }
+            bool operator==(const iterator& other) const { return id_ == other.id_; }
+
+        private:
+            const IRFunction* function_;
+            InstrId id_;
+        };
+
+        InstructionRange(const IRFunction* function, InstrId first)
+            : function_(function), first_(first) {}
+        iterator begin() const { return {function_, first_}; }
+        iterator end() const { return {function_, NoInstr}; }
+
+    private:
+        const IRFunction* function_;
+        InstrId first_;
+    };
+
+    InstructionRange instructions(BlockId id) const { return {this, blocks_[id].first}; }
+
+    /**
+     * @brief Nombre textual de un valor (%N, %argN, @global, etiqueta, constante)
+     */
+    std::string valueName(ValueId id) const;
+
+    std::string instructionToString(InstrId id) const;
     std::string toString() const;
 
 private:
+    static constexpr uint32_t NoUse = ~0u;
+
     std::string name_;
     TypeInfo returnType_;
     std::vector<TypeInfo> paramTypes_;
     std::vector<std::string> paramNames_;
-    std::vector<std::unique_ptr<BasicBlock>> blocks_;
+    InlineHint inlineHint_ = InlineHint::None;
+    Linkage linkage_ = Linkage::External;
+    bool hasProfile_ = false;
+    std::vector<std::string> targetClones_;
+    std::string target_;
+
+    std::vector<TypeInfo> types_;
+    std::vector<Value> values_;
+    std::vector<Instruction> instructions_;
+    std::vector<OperandSlot> operands_;
+    std::vector<BasicBlock> blocks_;
+    std::vector<IRConstant> constants_;
+    std::vector<std::string> globals_;
+    std::vector<ValueId> parameters_;
+    std::vector<BlockId> layout_;           // Vacío: orden de creación
+
+    std::map<std::pair<TypeId, uint64_t>, ValueId> constantIds_;
+    std::unordered_map<std::string, ValueId> globalIds_;
+    std::unordered_map<TypeId, ValueId> undefIds_;
+    size_t erasedCount_ = 0;
+
+    ValueId addValue(ValueKind kind, TypeId type, uint32_t index);
+    ValueId addConstant(IRConstant constant, uint64_t bits, const TypeInfo& type);
+
+    InstrId create(BlockId block, IROpcode opcode, const TypeInfo& type,
+                   std::span<const ValueId> operands, bool producesValue);
+    void link(InstrId id, BlockId block, InstrId before);
+    void unlink(InstrId id);
+
+    void addUse(uint32_t slot, ValueId value);
+    void removeUse(uint32_t slot);
 };
 
 /**
@@ -411,19 +642,38 @@ private:
 class IRGlobalVariable {
 public:
     IRGlobalVariable(const std::string& name, const TypeInfo& type,
-                    std::shared_ptr<IROperand> initializer = nullptr)
+                    std::optional<IRConstant> initializer = std::nullopt)
         : name_(name), type_(type), initializer_(initializer) {}
 
     const std::string& getName() const { return name_; }
     const TypeInfo& getType() const { return type_; }
-    std::shared_ptr<IROperand> getInitializer() const { return initializer_; }
+    const std::optional<IRConstant>& getInitializer() const { return initializer_; }
 
     std::string toString() const;
 
 private:
     std::string name_;
     TypeInfo type_;
-    std::shared_ptr<IROperand> initializer_;
+    std::optional<IRConstant> initializer_;
+};
+
+/**
+ * @brief Clase polimórfica del programa, para la desvirtualización
+ *
+ * virtualMethods tiene una entrada por slot de la vtable, incluidos los
+ * heredados, con la implementación que usa esta clase.
+ */
+struct IRClassInfo {
+    struct VirtualMethod {
+        std::string implementation;     // Función del slot; vacía si es virtual pura
+        bool isFinal = false;
+    };
+
+    std::string name;
+    std::string vtableSymbol;           // Global de la vtable que guardan los constructores
+    std::vector<std::string> bases;
+    std::vector<VirtualMethod> virtualMethods;
+    bool isFinal = false;
 };
 
 /**
@@ -441,9 +691,29 @@ public:
         globals_.push_back(std::move(global));
     }
 
+    void addClass(IRClassInfo info) {
+        classes_.push_back(std::move(info));
+    }
+
+    /**
+     * @brief Función sin parámetros que se ejecuta al cargar la imagen, antes de main
+     */
+    void addInitializer(const std::string& function) {
+        initializers_.push_back(function);
+    }
+
+    /**
+     * @brief Saca todas las funciones del módulo, que queda sin ninguna
+     */
+    std::vector<std::unique_ptr<IRFunction>> takeFunctions() {
+        return std::exchange(functions_, {});
+    }
+
     const std::string& getName() const { return name_; }
     const std::vector<std::unique_ptr<IRFunction>>& getFunctions() const { return functions_; }
     const std::vector<std::unique_ptr<IRGlobalVariable>>& getGlobals() const { return globals_; }
+    const std::vector<IRClassInfo>& getClasses() const { return classes_; }
+    const std::vector<std::string>& getInitializers() const { return initializers_; }
 
     std::string toString() const;
 
@@ -451,64 +721,92 @@ private:
     std::string name_;
     std::vector<std::unique_ptr<IRFunction>> functions_;
     std::vector<std::unique_ptr<IRGlobalVariable>> globals_;
+    std::vector<IRClassInfo> classes_;
+    std::vector<std::string> initializers_;
 };
 
 /**
  * @brief Constructor de IR
+ *
+ * Añade instrucciones al final del bloque de inserción de una función.
+ * Los métodos que producen un valor devuelven su ValueId.
  */
 class IRBuilder {
 public:
-    IRBuilder();
-
-    // Creación de operandos
-    std::shared_ptr<Register> createRegister(const TypeInfo& type);
-    std::shared_ptr<Immediate> createImmediate(int64_t value, const TypeInfo& type);
-    std::shared_ptr<Immediate> createImmediate(double value, const TypeInfo& type);
-    std::shared_ptr<Immediate> createImmediate(bool value, const TypeInfo& type);
-    std::shared_ptr<Label> createLabel(const std::string& name);
-    std::shared_ptr<GlobalVar> createGlobal(const std::string& name, const TypeInfo& type);
-    std::shared_ptr<Parameter> createParameter(int index, const TypeInfo& type);
-
-    // Creación de instrucciones
-    std::unique_ptr<BinaryInstruction> createBinary(IROpcode opcode,
-                                                   std::shared_ptr<IROperand> left,
-                                                   std::shared_ptr<IROperand> right,
-                                                   const TypeInfo& resultType);
-
-    std::unique_ptr<UnaryInstruction> createUnary(IROpcode opcode,
-                                                 std::shared_ptr<IROperand> operand,
-                                                 const TypeInfo& resultType);
-
-    std::unique_ptr<LoadInstruction> createLoad(std::shared_ptr<IROperand> address,
-                                               const TypeInfo& resultType);
-
-    std::unique_ptr<StoreInstruction> createStore(std::shared_ptr<IROperand> value,
-                                                 std::shared_ptr<IROperand> address);
-
-    std::unique_ptr<BranchInstruction> createBranch(std::shared_ptr<Label> target);
-
-    std::unique_ptr<BranchInstruction> createConditionalBranch(std::shared_ptr<IROperand> condition,
-                                                              std::shared_ptr<Label> trueLabel,
-                                                              std::shared_ptr<Label> falseLabel);
-
-    std::unique_ptr<ReturnInstruction> createReturn(std::shared_ptr<IROperand> value = nullptr);
-
-    std::unique_ptr<CallInstruction> createCall(std::shared_ptr<IROperand> function,
-                                               const std::vector<std::shared_ptr<IROperand>>& args,
-                                               const TypeInfo& resultType);
-
-    // Gestión de bloques
-    std::unique_ptr<BasicBlock> createBasicBlock(const std::string& name);
-    std::unique_ptr<IRFunction> createFunction(const std::string& name,
-                                              const TypeInfo& returnType,
-                                              const std::vector<TypeInfo>& paramTypes);
-    std::unique_ptr<IRGlobalVariable> createGlobalVariable(const std::string& name,
-                                                          const TypeInfo& type,
-                                                          std::shared_ptr<IROperand> initializer = nullptr);
-    std::unique_ptr<IRModule> createModule(const std::string& name);
+    explicit IRBuilder(IRFunction& function);
+
+    IRFunction& getFunction() { return function_; }
+
+    void setInsertPoint(BlockId block) { block_ = block; }
+    BlockId getInsertBlock() const { return block_; }
+
+    /**
+     * @brief Crea un bloque; con nombre vacío se numera automáticamente
+     */
+    BlockId createBlock(const std::string& name = "");
+
+    // Operandos
+    ValueId getInt(int64_t value, const TypeInfo& type);
+    ValueId getFloat(double value, const TypeInfo& type);
+    ValueId getBool(bool value);
+    ValueId getGlobal(const std::string& name, const TypeInfo& type);
+
+    // Instrucciones
+    ValueId createBinary(IROpcode opcode, ValueId left, ValueId right, const TypeInfo& resultType);
+    ValueId createUnary(IROpcode opcode, ValueId operand, const TypeInfo& resultType);
+    ValueId createCast(IROpcode opcode, ValueId operand, const TypeInfo& resultType);
+    ValueId createAlloca(const TypeInfo& allocatedType);
+    ValueId createLoad(ValueId address, const TypeInfo& resultType);
+    InstrId createStore(ValueId value, ValueId address);
+    InstrId createBranch(BlockId target);
+    InstrId createConditionalBranch(ValueId condition, BlockId trueBlock, BlockId falseBlock);
+
+    /**
+     * @brief Salto según el valor entero: cada caso va a su bloque y el resto a defaultBlock
+     */
+    InstrId createSwitch(ValueId value, BlockId defaultBlock,
+                         std::span<const std::pair<int64_t, BlockId>> cases);
+    InstrId createReturn(ValueId value = NoValue);
+    ValueId createSelect(ValueId condition, ValueId trueValue, ValueId falseValue,
+                         const TypeInfo& resultType);
+
+    /**
+     * @brief Intrínsecos de memoria; size es un entero en bytes
+     *
+     * Con tamaño constante y pequeño el back-end los expande en línea;
+     * MemoryIntrinsicsPass convierte el resto en llamadas a la CRT.
+     */
+    InstrId createMemCpy(ValueId destination, ValueId source, ValueId size);
+    InstrId createMemSet(ValueId destination, ValueId byte, ValueId size);
+    ValueId createMemCmp(ValueId left, ValueId right, ValueId size, const TypeInfo& resultType);
+    ValueId createCPUFeatures(const TypeInfo& resultType);
+
+    /**
+     * @brief Llamada; devuelve NoValue si resultType es Void
+     */
+    ValueId createCall(ValueId function, std::span<const ValueId> args, const TypeInfo& resultType);
+
+    /**
+     * @brief Call en posición de cola seguido del Ret de su resultado
+     * @return El Call, marcado con IRFunction::setTailCall
+     */
+    InstrId createTailCall(ValueId function, std::span<const ValueId> args, const TypeInfo& resultType);
+
+    /**
+     * @brief Phi vacío; las entradas se añaden con addIncoming
+     */
+    ValueId createPhi(const TypeInfo& type);
+    void addIncoming(ValueId phi, ValueId value, BlockId from);
+
+    /**
+     * @brief Añade una instrucción arbitraria en el punto de inserción
+     */
+    InstrId createInstruction(IROpcode opcode, const TypeInfo& type,
+                              std::span<const ValueId> operands, bool producesValue);
 
 private:
-    int nextRegisterId_ = 0;
+    IRFunction& function_;
+    BlockId block_ = NoBlock;
     int nextLabelId_ = 0;
 };
 
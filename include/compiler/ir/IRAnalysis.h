@@ -0,0 +1,138 @@
+/**
+ * @file IRAnalysis.h
+ * @brief Análisis de flujo de control sobre IRFunction
+ */
+
+#pragma once
+
+#include <compiler/ir/IR.h>
+#include <vector>
+
+namespace cpp20::compiler::ir {
+
+/**
+ * @brief Grafo de flujo de control de una función
+ *
+ * Instantánea de los terminadores en el momento de construirlo: si un
+ * pase cambia los saltos, debe volver a construirlo.
+ */
+class ControlFlowGraph {
+public:
+    explicit ControlFlowGraph(const IRFunction& function);
+
+    size_t blockCount() const { return successors_.size(); }
+
+    const std::vector<BlockId>& successors(BlockId block) const { return successors_[block]; }
+    const std::vector<BlockId>& predecessors(BlockId block) const { return predecessors_[block]; }
+
+    /**
+     * @brief Bloques alcanzables desde la entrada, en postorden inverso
+     */
+    const std::vector<BlockId>& reversePostOrder() const { return reversePostOrder_; }
+
+    bool isReachable(BlockId block) const { return postOrderIndex_[block] != NoBlock; }
+
+    /**
+     * @brief Posición del bloque en el postorden (NoBlock si es inalcanzable)
+     */
+    uint32_t postOrderIndex(BlockId block) const { return postOrderIndex_[block]; }
+
+private:
+    std::vector<std::vector<BlockId>> successors_;
+    std::vector<std::vector<BlockId>> predecessors_;
+    std::vector<BlockId> reversePostOrder_;
+    std::vector<uint32_t> postOrderIndex_;
+};
+
+/**
+ * @brief Árbol de dominadores (algoritmo de Cooper, Harvey y Kennedy)
+ */
+class DominatorTree {
+public:
+    explicit DominatorTree(const ControlFlowGraph& cfg);
+
+    /**
+     * @brief Dominador inmediato (NoBlock para la entrada y los inalcanzables)
+     */
+    BlockId idom(BlockId block) const { return idom_[block]; }
+
+    const std::vector<BlockId>& children(BlockId block) const { return children_[block]; }
+
+    /**
+     * @brief Si a domina a b (todo bloque alcanzable se domina a sí mismo)
+     */
+    bool dominates(BlockId a, BlockId b) const;
+
+    /**
+     * @brief Bloques alcanzables en preorden del árbol
+     */
+    const std::vector<BlockId>& preorder() const { return preorder_; }
+
+    /**
+     * @brief Frontera de dominancia de cada bloque
+     */
+    std::vector<std::vector<BlockId>> dominanceFrontiers(const ControlFlowGraph& cfg) const;
+
+private:
+    BlockId entry_ = NoBlock;
+    std::vector<BlockId> idom_;
+    std::vector<std::vector<BlockId>> children_;
+    std::vector<BlockId> preorder_;
+    std::vector<uint32_t> enter_;   // Intervalos del recorrido para dominates()
+    std::vector<uint32_t> exit_;
+};
+
+inline constexpr uint32_t NoLoop = ~0u;
+
+/**
+ * @brief Bucle natural: una cabecera que domina las colas de sus aristas de retorno
+ */
+struct Loop {
+    BlockId header;
+    std::vector<BlockId> blocks;        // En postorden inverso; el primero es la cabecera
+    std::vector<BlockId> latches;       // Origen de las aristas de retorno
+    uint32_t parent = NoLoop;
+    uint32_t depth = 1;
+};
+
+/**
+ * @brief Bucles naturales de una función y su anidamiento
+ *
+ * Los bucles con la misma cabecera se fusionan. Los ciclos irreducibles
+ * (sin cabecera dominante) no se consideran bucles.
+ */
+class LoopInfo {
+public:
+    LoopInfo(const ControlFlowGraph& cfg, const DominatorTree& domTree);
+
+    /**
+     * @brief Bucles de dentro hacia fuera: cada uno precede a los que lo contienen
+     */
+    const std::vector<Loop>& loops() const { return loops_; }
+
+    /**
+     * @brief Bucle más interno que contiene el bloque, o NoLoop
+     */
+    uint32_t loopFor(BlockId block) const { return loopFor_[block]; }
+
+    /**
+     * @brief Profundidad de anidamiento del bloque (0 fuera de bucles)
+     */
+    uint32_t depth(BlockId block) const {
+        return loopFor_[block] == NoLoop ? 0 : loops_[loopFor_[block]].depth;
+    }
+
+    bool contains(uint32_t loop, BlockId block) const;
+
+    /**
+     * @brief Único predecesor de la cabecera fuera del bucle cuyo único
+     * sucesor es la cabecera, o NoBlock
+     */
+    BlockId preheader(const ControlFlowGraph& cfg, uint32_t loop) const;
+
+private:
+    std::vector<Loop> loops_;
+    std::vector<uint32_t> loopFor_;
+};
+
+} // namespace cpp20::compiler::ir
@@ -0,0 +1,614 @@
+/**
+ * @file IRPasses.h
+ * @brief Pases de optimización sobre la IR y gestor de pases
+ */
+
+#pragma once
+
+#include <compiler/ir/IR.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cpp20::compiler {
+struct CPUFeatures;
+}
+
+namespace cpp20::compiler::ir {
+
+/**
+ * @brief Pase que transforma una función
+ */
+class FunctionPass {
+public:
+    virtual ~FunctionPass() = default;
+
+    virtual const char* getName() const = 0;
+
+    /**
+     * @brief Ejecuta el pase
+     * @return true si modificó la función
+     */
+    virtual bool run(IRFunction& function) = 0;
+};
+
+/**
+ * @brief Pase que necesita ver el módulo entero (interprocedural)
+ */
+class ModulePass {
+public:
+    virtual ~ModulePass() = default;
+
+    virtual const char* getName() const = 0;
+
+    /**
+     * @brief Ejecuta el pase
+     * @return true si modificó alguna función
+     */
+    virtual bool run(IRModule& module) = 0;
+};
+
+/**
+ * @brief Parámetros del modelo de coste del inliner
+ *
+ * El coste de una llamada es el número de instrucciones del callee menos
+ * una bonificación por cada argumento constante, que SCCP plegará
+ * después de integrarla.
+ */
+struct InlineCostModel {
+    size_t threshold = 40;              // Coste máximo sin indicación
+    size_t hintThreshold = 120;         // Coste máximo de una función inline
+    size_t alwaysInlineSize = 8;        // Hojas de este tamaño se integran siempre
+    size_t loopBonus = 40;              // Umbral extra para llamadas dentro de bucles
+    size_t constantArgumentBonus = 4;
+    size_t maxCallerSize = 4000;        // No hacer crecer el llamador por encima
+    size_t hotCallBonus = 200;          // Con perfil: sustituye a loopBonus en llamadas calientes
+    double hotCallFraction = 0.01;      // Caliente: al menos esta fracción del bloque más ejecutado
+
+    /**
+     * @brief -O1 solo integra hojas triviales y funciones always_inline
+     */
+    static InlineCostModel forOptimizationLevel(int level);
+};
+
+/**
+ * @brief Integración de llamadas (inlining)
+ *
+ * Recorre el grafo de llamadas de abajo arriba, de modo que un callee ya
+ * tiene integradas sus propias llamadas cuando se evalúa su coste. No
+ * integra llamadas recursivas directas ni callees con invoke o landing
+ * pads. Los allocas del callee se mueven al bloque de entrada del
+ * llamador para que mem2reg los promocione.
+ *
+ * Con perfil (ProfileAnnotatePass) las llamadas que no se ejecutaron no
+ * se integran salvo las hojas triviales y always_inline, y las calientes
+ * reciben hotCallBonus en lugar de la bonificación estática de bucle. Los
+ * bloques integrados heredan las frecuencias del callee escaladas a las
+ * de la llamada.
+ */
+class InlinerPass : public ModulePass {
+public:
+    explicit InlinerPass(InlineCostModel model = InlineCostModel());
+
+    const char* getName() const override { return "inline"; }
+    bool run(IRModule& module) override;
+
+    /**
+     * @brief Integra una llamada concreta
+     * @return false si la llamada no se puede integrar
+     */
+    static bool inlineCall(IRFunction& caller, InstrId call, const IRFunction& callee);
+
+    size_t getInlinedCount() const { return inlinedCount_; }
+
+private:
+    InlineCostModel model_;
+    size_t inlinedCount_ = 0;
+    uint64_t hotCallCount_ = UnknownFrequency;  // Recuento a partir del que una llamada es caliente
+
+    bool shouldInline(const IRFunction& caller, InstrId call, const IRFunction& callee,
+                      bool inLoop) const;
+};
+
+/**
+ * @brief Desvirtualización con la jerarquía de clases del módulo
+ *
+ * Una llamada virtual tiene la forma
+ *   %vptr = Load %obj; %slot = GetElementPtr %vptr, k; %fn = Load %slot; Call %fn, ...
+ * donde el tipo de %obj es un puntero a la clase estática ("C*") y k es
+ * una constante. Pasa a ser una llamada directa a la implementación del
+ * slot si se conoce el tipo dinámico (el vptr es el global de una vtable,
+ * directamente o guardado en %obj antes en el mismo bloque), si la clase
+ * estática es final o si el método es final.
+ *
+ * Con wholeProgram (CompilerOptions::lto) el módulo contiene todas las
+ * clases: si la clase estática y sus derivadas comparten una única
+ * implementación del slot, la llamada se protege con una comparación del
+ * puntero cargado contra ella y en la rama que coincide se llama
+ * directamente, donde el inliner ya puede integrarla. La llamada
+ * indirecta queda como respaldo por si se carga código con otras
+ * derivadas.
+ */
+class DevirtualizePass : public ModulePass {
+public:
+    explicit DevirtualizePass(bool wholeProgram = false) : wholeProgram_(wholeProgram) {}
+
+    const char* getName() const override { return "devirtualize"; }
+    bool run(IRModule& module) override;
+
+    /**
+     * @brief Llamadas convertidas en directas y llamadas protegidas
+     */
+    size_t getDevirtualizedCount() const { return devirtualizedCount_; }
+    size_t getGuardedCount() const { return guardedCount_; }
+
+private:
+    bool wholeProgram_;
+    size_t devirtualizedCount_ = 0;
+    size_t guardedCount_ = 0;
+};
+
+/**
+ * @brief Multiversión de funciones con target_clones
+ *
+ * Cada función F con target_clones se compila una vez por extensión
+ * (F.avx2, F.avx, ..., F.default, cada una con su setTarget) y F pasa a
+ * ser un salto de cola a través del puntero global F.ptr. F.resolver lee
+ * CPUFeatures y guarda en F.ptr la mejor copia que admite la CPU; se
+ * registra como inicializador del módulo, así que corre una sola vez al
+ * cargar la imagen y las llamadas no vuelven a consultar la CPU. Las
+ * llamadas a F del módulo cargan F.ptr directamente, salvo las de una
+ * copia a sí misma, que ya saben qué versión es. Los nombres que
+ * parseTargetFeatures no acepta se ignoran.
+ */
+class MultiversioningPass : public ModulePass {
+public:
+    const char* getName() const override { return "multiversion"; }
+    bool run(IRModule& module) override;
+
+    /**
+     * @brief Copias creadas (incluida la default), llamadas a través del
+     * puntero y nombres de extensión ignorados
+     */
+    size_t getCloneCount() const { return cloneCount_; }
+    size_t getDispatchedCallCount() const { return dispatchedCallCount_; }
+    size_t getIgnoredTargetCount() const { return ignoredTargetCount_; }
+
+private:
+    size_t cloneCount_ = 0;
+    size_t dispatchedCallCount_ = 0;
+    size_t ignoredTargetCount_ = 0;
+};
+
+/**
+ * @brief Promoción de allocas a registros SSA (mem2reg)
+ *
+ * Un alloca del bloque de entrada cuyos únicos usos son loads y stores
+ * directos se sustituye por phis en su frontera de dominancia iterada y
+ * por los valores almacenados.
+ */
+class Mem2RegPass : public FunctionPass {
+public:
+    const char* getName() const override { return "mem2reg"; }
+    bool run(IRFunction& function) override;
+};
+
+/**
+ * @brief Propagación condicional dispersa de constantes (SCCP)
+ *
+ * Solo considera alcanzables las aristas que pueden ejecutarse con las
+ * constantes conocidas. Sustituye los valores constantes, convierte en
+ * incondicionales los saltos con condición conocida y vacía los bloques
+ * inalcanzables. No pliega operaciones con comportamiento indefinido
+ * (división por cero, desplazamientos fuera de rango).
+ */
+class SCCPPass : public FunctionPass {
+public:
+    const char* getName() const override { return "sccp"; }
+    bool run(IRFunction& function) override;
+};
+
+/**
+ * @brief Numeración global de valores (GVN/CSE)
+ *
+ * Recorre el árbol de dominadores con una tabla con ámbitos: una
+ * instrucción pura igual a otra que la domina se sustituye por ella. Los
+ * operadores conmutativos se normalizan y los phis con una sola entrada
+ * distinta se eliminan.
+ */
+class GVNPass : public FunctionPass {
+public:
+    const char* getName() const override { return "gvn"; }
+    bool run(IRFunction& function) override;
+};
+
+/**
+ * @brief Eliminación de código muerto
+ *
+ * Marca como vivas las instrucciones con efectos laterales y, desde
+ * ellas, sus operandos; borra el resto, incluidos los ciclos de phis que
+ * solo se usan entre sí.
+ */
+class DeadCodeEliminationPass : public FunctionPass {
+public:
+    const char* getName() const override { return "dce"; }
+    bool run(IRFunction& function) override;
+};
+
+/**
+ * @brief Extracción de código invariante de bucles (LICM)
+ *
+ * Crea un preheader para cada bucle que no lo tenga y mueve a él las
+ * instrucciones puras cuyos operandos se definen fuera del bucle, de
+ * dentro hacia fuera. Los loads solo se extraen si el bucle no escribe en
+ * memoria y la dirección es siempre válida (alloca o global) o el load
+ * está en la cabecera. Las divisiones enteras solo si el divisor es una
+ * constante distinta de 0 y de -1.
+ */
+class LICMPass : public FunctionPass {
+public:
+    const char* getName() const override { return "licm"; }
+    bool run(IRFunction& function) override;
+};
+
+/**
+ * @brief Reducción de fuerza sobre variables de inducción
+ *
+ * Para una variable de inducción básica i = phi [i0, pre], [i + s, latch]
+ * con paso constante, sustituye cada Mul(i, c) del bucle con c constante
+ * por una nueva variable de inducción j = phi [i0 * c, pre], [j + s * c, latch].
+ * Los productos del preheader quedan para SCCP.
+ */
+class LoopStrengthReductionPass : public FunctionPass {
+public:
+    const char* getName() const override { return "loop-reduce"; }
+    bool run(IRFunction& function) override;
+};
+
+/**
+ * @brief Desenrollado completo de bucles con número de iteraciones constante
+ *
+ * Reconoce bucles de dos bloques (cabecera con la comparación y cuerpo que
+ * vuelve a ella) cuya variable de inducción empieza en una constante,
+ * avanza un paso constante y se compara con una constante. Si el número
+ * de iteraciones y el tamaño resultante están dentro de los límites, copia
+ * el cuerpo tantas veces como iteraciones al final del preheader.
+ */
+class LoopUnrollPass : public FunctionPass {
+public:
+    explicit LoopUnrollPass(size_t maxTripCount = 8, size_t maxUnrolledSize = 128)
+        : maxTripCount_(maxTripCount), maxUnrolledSize_(maxUnrolledSize) {}
+
+    const char* getName() const override { return "loop-unroll"; }
+    bool run(IRFunction& function) override;
+
+private:
+    size_t maxTripCount_;
+    size_t maxUnrolledSize_;
+};
+
+/**
+ * @brief Capacidades SIMD del destino que usa el vectorizador
+ */
+struct VectorTarget {
+    unsigned registerBytes = 16;        // 16 con SSE2, 32 con AVX2
+    bool integerMultiply = false;       // Mul de enteros de 32 bits (PMULLD, SSE4.1)
+
+    static VectorTarget fromCPUFeatures(const CPUFeatures& features);
+};
+
+/**
+ * @brief Vectorización de bucles contados sobre arrays
+ *
+ * Reconoce bucles de dos bloques for (i = c; i < n; ++i) con c constante
+ * no negativa cuyo cuerpo solo accede a base[i] con bases invariantes y
+ * combina los valores cargados con operaciones elementales. Genera un
+ * bucle vectorial que avanza registerBytes / tamaño del elemento
+ * iteraciones por vuelta y deja el bucle original como resto. Si hay
+ * stores y accesos con bases distintas, una comprobación en tiempo de
+ * ejecución envía los arrays solapados al bucle escalar. Los invariantes
+ * se replican con Broadcast en el preheader.
+ */
+class LoopVectorizePass : public FunctionPass {
+public:
+    explicit LoopVectorizePass(VectorTarget target = VectorTarget()) : target_(target) {}
+
+    const char* getName() const override { return "loop-vectorize"; }
+    bool run(IRFunction& function) override;
+
+    size_t getVectorizedCount() const { return vectorizedCount_; }
+
+private:
+    VectorTarget target_;
+    size_t vectorizedCount_ = 0;
+};
+
+/**
+ * @brief Orden de los bloques guiado por el perfil o por heurísticas
+ *
+ * Encadena cada bloque con su sucesor más ejecutado, de modo que el
+ * camino caliente cae de un bloque al siguiente sin saltos tomados, y
+ * deja al final los bloques que no se ejecutan. Los bloques creados
+ * tras anotar el perfil toman la frecuencia de sus predecesores. Sin
+ * perfil, las frecuencias se estiman: seguir en el bucle es probable y
+ * los caminos que solo llevan a LandingPad o Resume no se ejecutan.
+ *
+ * También alinea a loopAlignment bytes la cabecera de cada bucle más
+ * interno. Las funciones empiezan alineadas a 16 bytes en .text, así que
+ * un valor mayor solo se respeta relativo al inicio de la función.
+ */
+class BlockPlacementPass : public FunctionPass {
+public:
+    explicit BlockPlacementPass(uint32_t loopAlignment = 16) : loopAlignment_(loopAlignment) {}
+
+    const char* getName() const override { return "block-placement"; }
+    bool run(IRFunction& function) override;
+
+private:
+    uint32_t loopAlignment_;
+};
+
+/**
+ * @brief Lleva al final de la función los caminos de excepción
+ *
+ * Los bloques con LandingPad y los que solo se alcanzan desde ellos
+ * (catch, cleanup, Resume) pasan al final del orden de bloques, así el
+ * código de un try ocupa las mismas líneas de caché que sin él. Se
+ * conserva el orden relativo de cada grupo, también el que haya dejado
+ * block-placement.
+ */
+class ColdExceptionPathsPass : public FunctionPass {
+public:
+    const char* getName() const override { return "eh-cold-layout"; }
+    bool run(IRFunction& function) override;
+
+    size_t getColdBlockCount() const { return coldBlockCount_; }
+
+private:
+    size_t coldBlockCount_ = 0;
+};
+
+/**
+ * @brief Umbrales de IfConversionPass
+ */
+struct IfConversionOptions {
+    int maxSpeculatedCost = 6;          // Coste de los dos lados más un Select por phi
+    size_t maxSelects = 4;              // Phis de la unión
+    uint64_t predictableRatio = 16;     // Con perfil: se deja la rama si el lado raro es menos de 1/16
+};
+
+/**
+ * @brief Conversión de rombos y triángulos pequeños en Select
+ *
+ * Un BrCond cuyos lados son bloques de un solo predecesor que saltan a la
+ * misma unión (o uno salta a la unión y el otro es la unión) se
+ * sustituye por un Br: las instrucciones de los lados pasan al bloque de
+ * la condición y cada phi de la unión se elige con un Select, que el
+ * back-end baja a CMOVcc o a MINSS/MAXSS. Solo se especulan
+ * instrucciones puras que no pueden fallar, con el coste de
+ * speculationCost; con perfil, las ramas muy sesgadas se dejan al
+ * predictor. Si la condición es una comparación, cada Select lleva su
+ * propia copia justo delante.
+ */
+class IfConversionPass : public FunctionPass {
+public:
+    explicit IfConversionPass(IfConversionOptions options = IfConversionOptions()) : options_(options) {}
+
+    const char* getName() const override { return "if-convert"; }
+    bool run(IRFunction& function) override;
+
+    /**
+     * @brief Ciclos aproximados de ejecutar la instrucción sin condición, o -1 si no se puede
+     */
+    static int speculationCost(const IRFunction& function, InstrId id);
+
+    size_t getConvertedCount() const { return convertedCount_; }
+    size_t getSelectCount() const { return selectCount_; }
+
+private:
+    IfConversionOptions options_;
+    size_t convertedCount_ = 0;
+    size_t selectCount_ = 0;
+};
+
+/**
+ * @brief Marcado de las llamadas en posición de cola
+ *
+ * Un Call seguido del Ret de su resultado (o de un Ret vacío) se marca
+ * con IRFunction::setTailCall y el back-end lo baja a epílogo y JMP, así
+ * que la recursión de cola y el estilo de continuaciones ocupan pila
+ * constante. Un Call seguido de un Br a un bloque que solo devuelve (su
+ * phi o nada) recibe una copia del Ret. No se marca nada si algún Alloca
+ * se usa para algo más que cargar y guardar: el llamado podría recibir
+ * una dirección del marco, que se libera antes del salto. Los Invoke no
+ * están nunca en cola.
+ */
+class TailCallPass : public FunctionPass {
+public:
+    const char* getName() const override { return "tail-calls"; }
+    bool run(IRFunction& function) override;
+
+    size_t getTailCallCount() const { return tailCallCount_; }
+    size_t getDuplicatedReturnCount() const { return duplicatedReturnCount_; }
+
+private:
+    size_t tailCallCount_ = 0;
+    size_t duplicatedReturnCount_ = 0;
+};
+
+/**
+ * @brief Intrínsecos de memoria que el back-end expande en línea
+ *
+ * Las llamadas a memcpy y memset con tamaño constante (y byte constante
+ * en memset) de hasta getInlineLimit() bytes pasan a MemCpy y MemSet; las
+ * de memcmp, si su resultado solo se compara con 0 por igualdad, a
+ * MemCmp. Una copia de struct o array (Load cuyo único uso es un Store
+ * en el mismo bloque, sin escrituras entre ambos) pasa a MemCpy. El
+ * límite son ocho registros vectoriales: 128 bytes con SSE2 y 256 con
+ * AVX2. Los intrínsecos que el back-end no puede expandir (tamaño
+ * variable o mayor que el límite) se convierten en llamadas a la CRT.
+ */
+class MemoryIntrinsicsPass : public FunctionPass {
+public:
+    explicit MemoryIntrinsicsPass(VectorTarget target = VectorTarget()) : inlineLimit_(8 * target.registerBytes) {}
+
+    const char* getName() const override { return "mem-intrinsics"; }
+    bool run(IRFunction& function) override;
+
+    uint64_t getInlineLimit() const { return inlineLimit_; }
+    size_t getIntrinsicCount() const { return intrinsicCount_; }
+    size_t getLibraryCallCount() const { return libraryCallCount_; }
+
+private:
+    uint64_t inlineLimit_;
+    size_t intrinsicCount_ = 0;     // Llamadas y copias convertidas en intrínsecos
+    size_t libraryCallCount_ = 0;   // Intrínsecos convertidos en llamadas
+};
+
+/**
+ * @brief Builtins y patrones de manipulación de bits a intrínsecos de la IR
+ *
+ * Las llamadas a __builtin_popcount/clz/ctz/bswap/rotate*, a sus
+ * equivalentes de MSVC (__popcnt, __lzcnt, _byteswap_*, _rotl, _rotr,
+ * _BitScanForward, _BitScanReverse) y a _mm_popcnt_*, _lzcnt_*, _tzcnt_*,
+ * _pdep_*, _pext_* y _mm_crc32_* pasan a PopCount, CountLeadingZeros,
+ * CountTrailingZeros, ByteSwap, RotateLeft/Right, BitDeposit, BitExtract
+ * y Crc32. También reconoce la rotación escrita con desplazamientos y
+ * máscara, y el Select que protege ctz/clz contra 0. El back-end elige la
+ * instrucción según las extensiones del destino.
+ */
+class BitIntrinsicsPass : public FunctionPass {
+public:
+    const char* getName() const override { return "bit-intrinsics"; }
+    bool run(IRFunction& function) override;
+
+    size_t getIntrinsicCount() const { return intrinsicCount_; }
+    size_t getIdiomCount() const { return idiomCount_; }
+
+private:
+    size_t intrinsicCount_ = 0;     // Llamadas convertidas en intrínsecos
+    size_t idiomCount_ = 0;         // Patrones reescritos
+};
+
+/**
+ * @brief Umbrales de SwitchLoweringPass
+ */
+struct SwitchLoweringOptions {
+    size_t minJumpTableCases = 4;       // Casos mínimos de una tabla de saltos
+    uint32_t minJumpTableDensity = 40;  // Porcentaje de casos sobre las entradas de la tabla
+    uint64_t maxJumpTableEntries = 4096;
+    size_t minBitTestCases = 3;         // Casos mínimos de un grupo de prueba de bits
+    size_t maxBitTestDestinations = 3;  // Una máscara, un AND y un salto por destino
+};
+
+/**
+ * @brief Bajada de Switch a tablas de saltos, pruebas de bits y árbol binario
+ *
+ * Los casos ordenados se agrupan de izquierda a derecha: el tramo más
+ * largo con densidad suficiente forma una tabla de saltos; si no, el más
+ * largo que cabe en una palabra con pocos destinos forma una prueba de
+ * bits (1 << (x - min) contra una máscara por destino); si no, los casos
+ * consecutivos con el mismo destino forman un rango. Sobre los grupos se
+ * construye un árbol binario equilibrado de comparaciones, y cada hoja
+ * solo comprueba los límites que el camino hasta ella no ha fijado ya.
+ *
+ * Las tablas quedan como un Switch con casos densos, que el back-end
+ * emite como salto indirecto por una tabla de RVAs en .rdata; después de
+ * este pase no queda ningún otro Switch.
+ */
+class SwitchLoweringPass : public FunctionPass {
+public:
+    explicit SwitchLoweringPass(SwitchLoweringOptions options = SwitchLoweringOptions()) : options_(options) {}
+
+    const char* getName() const override { return "switch-lowering"; }
+    bool run(IRFunction& function) override;
+
+    size_t getJumpTableCount() const { return jumpTableCount_; }
+    size_t getBitTestCount() const { return bitTestCount_; }
+    size_t getComparisonCount() const { return comparisonCount_; }
+
+private:
+    SwitchLoweringOptions options_;
+    size_t jumpTableCount_ = 0;
+    size_t bitTestCount_ = 0;
+    size_t comparisonCount_ = 0;    // Saltos condicionales del árbol y de los rangos
+};
+
+class ProfileData;
+
+/**
+ * @brief Optimización guiada por perfil en el pipeline (ver Profile.h)
+ */
+struct ProfileOptions {
+    bool instrument = false;                // -fprofile-generate: contadores por bloque
+    const ProfileData* profile = nullptr;   // -fprofile-use: frecuencias de los bloques
+};
+
+/**
+ * @brief Ejecuta una secuencia de pases sobre funciones o módulos
+ */
+class PassManager {
+public:
+    /**
+     * @brief Estadísticas acumuladas de un pase
+     */
+    struct PassStats {
+        std::string name;
+        size_t runs = 0;
+        size_t changes = 0;                 // Ejecuciones que modificaron la función
+        size_t instructionsRemoved = 0;
+    };
+
+    PassManager() = default;
+    PassManager(PassManager&&) = default;
+    PassManager& operator=(PassManager&&) = default;
+
+    void addPass(std::unique_ptr<FunctionPass> pass);
+    void addModulePass(std::unique_ptr<ModulePass> pass);
+
+    /**
+     * @brief Ejecuta solo los pases de función
+     * @return true si algún pase modificó la función
+     */
+    bool run(IRFunction& function);
+
+    /**
+     * @brief Ejecuta los pases de módulo y después los de función en cada función
+     */
+    bool run(IRModule& module);
+
+    size_t getPassCount() const { return modulePasses_.size() + passes_.size(); }
+
+    /**
+     * @brief Estadísticas en orden de ejecución (pases de módulo primero)
+     */
+    std::vector<PassStats> getStats() const;
+
+    /**
+     * @brief Pipeline para CompilerOptions::optimizationLevel
+     *
+     * -O0 no ejecuta nada; -O1 inline (solo hojas triviales), mem2reg,
+     * SCCP y DCE; -O2 y -O3 usan el modelo de coste completo y añaden GVN
+     * y los pases de bucles (LICM, desenrollado, vectorización y reducción
+     * de fuerza), seguidos de otra SCCP. -O3 desenrolla bucles más largos.
+     * Desde -O2 la desvirtualización va antes del inliner; wholeProgram
+     * (-flto) le permite las llamadas protegidas.
+     *
+     * La instrumentación y la anotación del perfil van antes que todo,
+     * también en -O0, sobre el CFG recién generado. Tras DCE van
+     * if-convert y tail-calls (desde -O2) y switch-lowering (desde -O1; en
+     * -O0 el back-end baja los Switch por su cuenta). -O2 y -O3 terminan con
+     * block-placement, con el perfil o con frecuencias estimadas; no al
+     * instrumentar.
+     */
+    static PassManager createForOptimizationLevel(int level, VectorTarget target = VectorTarget(),
+                                                  bool wholeProgram = false, ProfileOptions pgo = {});
+
+private:
+    std::vector<std::unique_ptr<ModulePass>> modulePasses_;
+    std::vector<PassStats> moduleStats_;
+    std::vector<std::unique_ptr<FunctionPass>> passes_;
+    std::vector<PassStats> stats_;
+};
+
+} // namespace cpp20::compiler::ir
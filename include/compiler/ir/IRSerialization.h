@@ -0,0 +1,37 @@
+/**
+ * @file IRSerialization.h
+ * @brief Formato binario de un IRModule, para embeberlo en los objetos de -flto
+ */
+
+#pragma once
+
+#include <compiler/ir/IR.h>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace cpp20::compiler::ir {
+
+/**
+ * @brief Añade a out la forma binaria del módulo
+ *
+ * Los enteros van en LEB128 y cada cadena (nombres de funciones, globales,
+ * tipos y bloques) se escribe una vez en una tabla al principio. Un
+ * operando es su clase de valor seguida de lo justo para recrearlo: el
+ * número del resultado de una instrucción en el orden de los bloques, el
+ * índice de un parámetro o bloque, o el tipo y el valor de una constante.
+ * Las instrucciones borradas no se escriben.
+ */
+void serializeModule(const IRModule& module, std::vector<uint8_t>& out);
+
+/**
+ * @brief Reconstruye un módulo escrito por serializeModule
+ *
+ * Los ValueId del resultado no tienen por qué coincidir con los del
+ * original, pero volver a serializarlo da los mismos bytes.
+ * @return nullptr si bytes no es un módulo válido de esta versión
+ */
+std::unique_ptr<IRModule> deserializeModule(std::span<const uint8_t> bytes);
+
+} // namespace cpp20::compiler::ir
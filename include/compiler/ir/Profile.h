@@ -0,0 +1,139 @@
+/**
+ * @file Profile.h
+ * @brief Optimización guiada por perfil: contadores, formato del perfil y anotación
+ */
+
+#pragma once
+
+#include <compiler/ir/IRPasses.h>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace cpp20::compiler::ir {
+
+/**
+ * @brief Prefijo del array de contadores de cada función instrumentada
+ *
+ * El global __cpp_prof_cnts.<función> tiene un contador de 64 bits por
+ * bloque, en el orden de creación de los bloques.
+ */
+inline constexpr const char* ProfileCounterPrefix = "__cpp_prof_cnts.";
+
+/**
+ * @brief Función del runtime que vuelca los contadores al salir de main
+ *
+ * Recorre los globales ProfileCounterPrefix del programa y escribe el
+ * perfil en default.cppprof, en el formato de ProfileData::serialize.
+ */
+inline constexpr const char* ProfileWriteFunction = "__cpp_profile_write";
+
+/**
+ * @brief Huella del CFG de la función: un perfil de otra versión no se aplica
+ */
+uint64_t profileHash(const IRFunction& function);
+
+/**
+ * @brief Recuentos de una función
+ */
+struct FunctionProfile {
+    uint64_t hash = 0;              // profileHash de la función instrumentada
+    std::vector<uint64_t> counts;   // Ejecuciones de cada bloque
+};
+
+/**
+ * @brief Perfil de ejecución (.cppprof)
+ *
+ * Formato: "CPPPROF1", número de funciones (u32) y, por función, nombre
+ * (u32 de longitud y bytes), hash (u64), número de contadores (u32) y los
+ * contadores (u64). Todo en little-endian, tal como lo escribe el runtime.
+ */
+class ProfileData {
+public:
+    /**
+     * @brief Añade los recuentos de una función
+     *
+     * Si ya estaba con el mismo hash se suman (varias ejecuciones); si el
+     * hash cambió, el nuevo sustituye al anterior.
+     */
+    void addFunction(const std::string& name, FunctionProfile profile);
+
+    /**
+     * @brief Recuentos de la función, o nullptr si no se ejecutó
+     */
+    const FunctionProfile* find(const std::string& name) const;
+
+    size_t size() const { return functions_.size(); }
+    bool empty() const { return functions_.empty(); }
+
+    void serialize(std::vector<uint8_t>& out) const;
+
+    /**
+     * @brief Añade un perfil serializado a los recuentos actuales
+     * @return false si no es un perfil válido (getLastError)
+     */
+    bool merge(std::span<const uint8_t> bytes);
+
+    bool readFile(const std::filesystem::path& path);
+    bool writeFile(const std::filesystem::path& path) const;
+
+    /**
+     * @brief Funciones ejecutadas, de más a menos llamadas (orden de .text)
+     */
+    std::vector<std::string> hotFunctionOrder() const;
+
+    const std::string& getLastError() const { return lastError_; }
+
+private:
+    std::map<std::string, FunctionProfile> functions_;  // Ordenado: salida determinista
+    std::string lastError_;
+};
+
+/**
+ * @brief -fprofile-generate: un contador por bloque en cada función definida
+ *
+ * Se ejecuta al generar el IR, antes de optimizar, para que el CFG
+ * instrumentado sea el mismo que anota ProfileAnnotatePass. Al principio
+ * de cada bloque (tras los phis) se incrementa su contador; antes de cada
+ * Ret de main se llama a ProfileWriteFunction. Los recuentos de las aristas
+ * se deducen de los de los bloques en los casos que usan los consumidores.
+ */
+class ProfileInstrumentationPass : public ModulePass {
+public:
+    const char* getName() const override { return "pgo-instrument"; }
+    bool run(IRModule& module) override;
+
+    size_t getInstrumentedCount() const { return instrumentedCount_; }
+
+private:
+    size_t instrumentedCount_ = 0;
+};
+
+/**
+ * @brief -fprofile-use: fija las frecuencias de los bloques desde el perfil
+ *
+ * Una función definida que no está en el perfil no se ejecutó y todos
+ * sus bloques quedan a 0. Las que cambiaron de CFG desde la
+ * instrumentación (profileHash) quedan sin anotar y se optimizan con las
+ * heurísticas estáticas.
+ */
+class ProfileAnnotatePass : public ModulePass {
+public:
+    explicit ProfileAnnotatePass(const ProfileData& profile) : profile_(profile) {}
+
+    const char* getName() const override { return "pgo-annotate"; }
+    bool run(IRModule& module) override;
+
+    size_t getAnnotatedCount() const { return annotatedCount_; }
+    size_t getMismatchedCount() const { return mismatchedCount_; }
+
+private:
+    const ProfileData& profile_;
+    size_t annotatedCount_ = 0;
+    size_t mismatchedCount_ = 0;
+};
+
+} // namespace cpp20::compiler::ir
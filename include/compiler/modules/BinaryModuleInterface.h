@@ -8,12 +8,17 @@
 #include <compiler/ast/ASTNode.h>
 #include <compiler/types/Type.h>
 #include <compiler/symbols/Symbol.h>
+#include <compiler/common/utils/MappedFile.h>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
+#include <atomic>
 #include <filesystem>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
 
 namespace cpp20::compiler::modules {
 
@@ -23,7 +28,8 @@ namespace cpp20::compiler::modules {
 enum class BMIFormatVersion {
     Version1_0 = 1,  // C++20 inicial
     Version1_1 = 2,  // Con mejoras de rendimiento
-    Version2_0 = 3   // C++23+
+    Version2_0 = 3,  // C++23+
+    Version1_2 = 4   // Por bloques: cadenas sin repetir, entidades de ancho fijo y AST
 };
 
 /**
@@ -139,6 +145,17 @@ struct BMIMetadata {
 
 /**
  * @brief BMI (Binary Module Interface) completo
+ *
+ * En disco (Version1_2) es una cabecera, una tabla de cadenas sin
+ * repetir, una tabla de entidades de ancho fijo ordenada por huella del
+ * nombre y el AST; las cadenas se referencian por offset. Al importar se
+ * proyecta el archivo y solo se leen la cabecera, los imports y los
+ * requerimientos: cada entidad se decodifica la primera vez que se busca
+ * por nombre, y el AST cuando se pide.
+ *
+ * Un BMI importado puede compartirse entre hilos: las búsquedas de
+ * entidades ya decodificadas solo toman el cerrojo en modo compartido, y
+ * la primera decodificación de cada una lo toma en exclusiva.
  */
 class BinaryModuleInterface {
 public:
@@ -195,13 +212,18 @@ public:
 
     /**
      * @brief Obtiene entidades exportadas
+     *
+     * Con un BMI importado carga antes todas las que falten.
      */
     const std::vector<std::unique_ptr<ExportedEntity>>& getExportedEntities() const {
+        loadAllEntities();
         return exportedEntities_;
     }
 
     /**
      * @brief Busca una entidad exportada por nombre
+     *
+     * Con un BMI importado decodifica solo esa entidad, la primera vez.
      */
     const ExportedEntity* findEntity(const std::string& name) const;
 
@@ -223,9 +245,9 @@ public:
     }
 
     /**
-     * @brief Obtiene el AST del módulo
+     * @brief Obtiene el AST del módulo (de un BMI importado, al pedirlo)
      */
-    const ast::ASTNode* getModuleAST() const { return moduleAST_.get(); }
+    const ast::ASTNode* getModuleAST() const;
 
     /**
      * @brief Calcula hash del BMI para comparación
@@ -238,14 +260,73 @@ public:
     bool isCompatibleWith(const BinaryModuleInterface& other) const;
 
 private:
+    /**
+     * @brief Bloques de un BMI proyectado (offsets desde el inicio del archivo)
+     */
+    struct MappedBlocks {
+        uint64_t strings = 0;
+        uint64_t stringsSize = 0;
+        uint64_t entities = 0;
+        uint64_t entityCount = 0;
+        uint64_t references = 0;
+        uint64_t referenceCount = 0;
+        uint64_t ast = 0;
+        uint64_t astSize = 0;
+    };
+
     BMIMetadata metadata_;
-    std::vector<std::unique_ptr<ExportedEntity>> exportedEntities_;
+    // Con mapping_ crecen a medida que se buscan entidades
+    mutable std::vector<std::unique_ptr<ExportedEntity>> exportedEntities_;
     std::vector<ModuleImport> moduleImports_;
     std::vector<ModuleRequirement> moduleRequirements_;
-    std::unique_ptr<ast::ASTNode> moduleAST_;
+    mutable std::unique_ptr<ast::ASTNode> moduleAST_;
 
     // Índices para búsqueda rápida
-    std::unordered_map<std::string, size_t> entityIndex_;
+    mutable std::unordered_map<std::string, size_t> entityIndex_;
+
+    // BMI importado: archivo proyectado del que se cargan entidades y AST
+    std::unique_ptr<common::utils::MappedFile> mapping_;
+    MappedBlocks blocks_;
+    mutable std::atomic<bool> allEntitiesLoaded_{true};
+    mutable std::atomic<bool> astLoaded_{true};
+    mutable std::shared_mutex lazyMutex_;
+
+    /**
+     * @brief Carga del archivo las entidades que aún no se han buscado
+     */
+    void loadAllEntities() const;
+
+    /**
+     * @brief Valida la cabecera y los bloques, y lee metadatos, imports y requerimientos
+     */
+    bool mapBlocks(std::unique_ptr<common::utils::MappedFile> mapping);
+
+    /**
+     * @brief Cadena del bloque de cadenas (vacía si la referencia sale del bloque)
+     */
+    std::string_view mappedString(uint64_t reference) const;
+
+    /**
+     * @brief Nombre de la entidad i de la tabla proyectada
+     */
+    std::string_view mappedEntityName(size_t index) const;
+
+    /**
+     * @brief Decodifica la entidad i de la tabla proyectada
+     * @return nullptr si sus referencias salen de los bloques
+     */
+    std::unique_ptr<ExportedEntity> decodeMappedEntity(size_t index) const;
+
+    /**
+     * @brief Deserializa imports y requerimientos (formato anterior)
+     */
+    void deserializeModuleInfo(std::istream& stream);
+
+    /**
+     * @brief Formato anterior (flujo secuencial sin índice)
+     */
+    static std::unique_ptr<BinaryModuleInterface> deserializeLegacyFile(
+        const std::filesystem::path& filePath);
 
     /**
      * @brief Actualiza metadatos
@@ -283,9 +364,9 @@ private:
     void serializeAST(std::ostream& stream) const;
 
     /**
-     * @brief Deserializa AST del módulo
+     * @brief Deserializa AST del módulo (moduleAST_ es mutable: se carga al pedirlo)
      */
-    void deserializeAST(std::istream& stream);
+    void deserializeAST(std::istream& stream) const;
 
     /**
      * @brief Calcula tamaño total del BMI
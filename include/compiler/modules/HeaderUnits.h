@@ -7,6 +7,8 @@
 
 #include <compiler/modules/BinaryModuleInterface.h>
 #include <compiler/ast/ASTNode.h>
+#include <compiler/common/utils/FileLock.h>
+#include <compiler/common/utils/FileUtils.h>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -24,6 +26,7 @@ struct HeaderUnit {
     std::string headerName;                     // Nombre lógico del header
     std::string contentHash;                    // Hash del contenido
     std::chrono::system_clock::time_point lastModified; // Última modificación
+    common::utils::FileStamp stamp;             // Stat del header cuando se comprobó contentHash
     std::unique_ptr<BinaryModuleInterface> bmi; // BMI compilado
     std::vector<std::string> dependencies;      // Headers que importa
     bool isCompiled;                            // Si está compilado
@@ -181,6 +184,14 @@ public:
      */
     void invalidate(const std::filesystem::path& headerPath);
 
+    /**
+     * @brief Hash del contenido de un header; "" si no se puede leer
+     *
+     * Se reutiliza el del sidecar header_hashes.dat mientras el stat del
+     * archivo no cambie, así que un header intacto no se vuelve a leer.
+     */
+    std::string contentHash(const std::filesystem::path& headerPath);
+
     /**
      * @brief Limpia el caché completo
      */
@@ -203,6 +214,10 @@ public:
 
     /**
      * @brief Serializa el caché a disco
+     *
+     * El índice lo comparten todos los procesos del build: bajo el bloqueo
+     * del directorio se mezclan las entradas que otros hayan publicado y
+     * el resultado se publica con un rename atómico.
      */
     bool serializeToDisk() const;
 
@@ -211,6 +226,19 @@ public:
      */
     bool deserializeFromDisk();
 
+    /**
+     * @brief Incorpora las entradas publicadas por otros procesos que falten en memoria
+     */
+    bool mergeFromDisk();
+
+    /**
+     * @brief Bloquea la compilación de un header frente a otros procesos
+     *
+     * Quien obtiene el bloqueo compila; los demás esperan y, al entrar,
+     * deben llamar a mergeFromDisk y volver a buscar antes de compilar.
+     */
+    std::unique_ptr<common::utils::FileLock> lockEntry(const std::filesystem::path& headerPath) const;
+
     /**
      * @brief Verifica integridad del caché
      */
@@ -230,6 +258,44 @@ private:
     size_t totalHits_;
     size_t totalMisses_;
     size_t totalInvalidations_;
+    mutable size_t contentHashesComputed_ = 0;  // Headers leídos para hashearlos
+
+    /**
+     * @brief Hash de contenido junto al stat con el que se calculó
+     */
+    struct HashedContent {
+        common::utils::FileStamp stamp;
+        std::string hash;
+    };
+
+    // Sidecar persistente: ruta → hash, válido mientras el stat coincida
+    mutable std::unordered_map<std::string, HashedContent> contentHashes_;
+    mutable bool contentHashesChanged_ = false;
+
+    static constexpr uint32_t ContentHashFileKind = 5;
+
+    /**
+     * @brief Hash del header con ese stat, del sidecar o leyéndolo; requiere mutex_
+     */
+    std::string hashContent(const std::filesystem::path& headerPath,
+                            const common::utils::FileStamp& stamp) const;
+
+    /**
+     * @brief Carga y publica el sidecar de hashes; requieren mutex_ o estar en construcción
+     */
+    void readContentHashes() const;
+    bool writeContentHashes() const;
+
+    /**
+     * @brief Escribe el índice; requiere mutex_
+     */
+    bool writeIndex() const;
+
+    /**
+     * @brief Lee el índice de disco sin tocar cache_
+     */
+    bool readIndex(std::unordered_map<std::string, std::shared_ptr<HeaderUnit>>& entries,
+                   size_t statistics[3]) const;
 
     /**
      * @brief Genera clave de caché para un header
@@ -243,6 +309,10 @@ private:
 
     /**
      * @brief Verifica si un header unit en caché es válido
+     *
+     * Primero el stat: si coincide con el registrado, la entrada vale sin
+     * leer el header. Si no (un touch, un checkout, otra máquina), decide
+     * el hash del contenido y, si coincide, se registra el stat nuevo.
      */
     bool isCacheEntryValid(const std::shared_ptr<HeaderUnit>& headerUnit) const;
 
@@ -420,10 +490,11 @@ private:
     std::unique_ptr<HeaderUnitCompiler> compiler_;
     size_t maxParallelJobs_;
 
-    // Estadísticas
+    // Estadísticas (las actualizan los hilos de compileInParallel)
     size_t totalCompiled_;
     size_t totalFromCache_;
     size_t totalFailed_;
+    mutable std::mutex statisticsMutex_;
 
     /**
      * @brief Compila un header unit individual
@@ -444,6 +515,12 @@ private:
 
     /**
      * @brief Compila headers en paralelo
+     *
+     * Cada header se encola en cuanto terminan todas sus dependencias
+     * dentro del conjunto, con hasta maxParallelJobs_ hilos. Si falla una
+     * dependencia, sus dependientes no se compilan. Un ciclo entre los
+     * headers pedidos es un error (detectCycles() antes de empezar).
+     * @return Los header units compilados, en el orden de headerPaths
      */
     std::vector<std::shared_ptr<HeaderUnit>> compileInParallel(
         const std::vector<std::filesystem::path>& headerPaths,
@@ -5,12 +5,23 @@
 
 #pragma once
 
+#include <chrono>
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
 #include <memory>
 #include <filesystem>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <compiler/common/utils/FileLock.h>
+#include <compiler/common/utils/HashUtils.h>
+#include <compiler/modules/P1689Scanner.h>
+
+namespace cpp20::compiler {
+class CompilationTelemetry;
+}
 
 namespace cpp20::compiler::modules {
 
@@ -90,6 +101,7 @@ struct ModuleDependency {
     std::string moduleName;
     bool isInterface = true;  // true para import, false para header unit
     std::string sourceLocation;
+    uint64_t interfaceHash = 0;  // Hash de interfaz del importado al compilar (0 = desconocido)
 
     ModuleDependency(const std::string& name, bool iface, const std::string& loc = "")
         : moduleName(name), isInterface(iface), sourceLocation(loc) {}
@@ -138,7 +150,7 @@ public:
     static std::unique_ptr<BinaryModuleInterface> deserialize(const std::vector<uint8_t>& data);
 
     /**
-     * @brief Verificar si BMI es válido
+     * @brief Verificar si BMI es válido (con nombre y al menos una exportación)
      */
     bool isValid() const;
 
@@ -177,12 +189,21 @@ public:
      */
     const CompilationOptionsHash& getCompilationOptionsHash() const;
 
+    /**
+     * @brief Hash de la superficie exportada
+     *
+     * Solo cubre tipo, nombres y flags de las entidades exportadas, sin
+     * ubicaciones ni orden: cambios en código no exportado o en cuerpos
+     * no inline dejan el hash igual y los importadores no se recompilan.
+     */
+    uint64_t calculateInterfaceHash() const;
+
 private:
     std::string moduleName_;
     std::vector<ExportedEntity> exportedEntities_;
     std::vector<ModuleDependency> dependencies_;
     CompilationOptionsHash optionsHash_;
-    uint32_t version_ = 1;
+    uint32_t version_ = 2;
     uint64_t timestamp_ = 0;
 };
 
@@ -226,9 +247,9 @@ public:
     const std::vector<std::string>& getPartitions() const;
 
     /**
-     * @brief Establecer BMI
+     * @brief Establecer BMI (puede ser el mismo objeto que usan otros trabajos)
      */
-    void setBMI(std::unique_ptr<BinaryModuleInterface> bmi);
+    void setBMI(std::shared_ptr<const BinaryModuleInterface> bmi);
 
     /**
      * @brief Obtener BMI
@@ -236,7 +257,7 @@ public:
     const BinaryModuleInterface* getBMI() const;
 
     /**
-     * @brief Verificar si está listo
+     * @brief Verificar si está listo (tiene un BMI con nombre, aunque no exporte nada)
      */
     bool isReady() const;
 
@@ -244,7 +265,7 @@ private:
     std::string moduleName_;
     std::filesystem::path sourcePath_;
     std::vector<std::string> partitions_;
-    std::unique_ptr<BinaryModuleInterface> bmi_;
+    std::shared_ptr<const BinaryModuleInterface> bmi_;
 };
 
 // ============================================================================
@@ -316,6 +337,11 @@ public:
      */
     std::vector<ModuleDependency> scanFile(const std::filesystem::path& filePath);
 
+    /**
+     * @brief Regla P1689 del archivo (escaneada una sola vez con P1689Scanner)
+     */
+    const P1689Rule& scanRule(const std::filesystem::path& filePath);
+
     /**
      * @brief Verificar si archivo contiene módulo
      */
@@ -338,7 +364,56 @@ public:
 
 private:
     // Cache de archivos escaneados
-    std::unordered_map<std::string, std::vector<ModuleDependency>> scanCache_;
+    std::unordered_map<std::string, P1689Rule> scanCache_;
+};
+
+// ============================================================================
+// BMI Registry
+// ============================================================================
+
+/**
+ * @brief BMI cargados, compartidos por todos los trabajos del proceso
+ *
+ * La clave es el hash del contenido del BMI: quien importa el mismo
+ * módulo recibe el mismo objeto inmutable, deserializado una sola vez.
+ * El registro solo guarda referencias débiles; el BMI se libera cuando
+ * lo suelta el último importador.
+ */
+class BMIRegistry {
+public:
+    /**
+     * @brief Registro del proceso
+     */
+    static BMIRegistry& global();
+
+    /**
+     * @brief BMI con ese hash; si nadie lo tiene cargado, lo crea load
+     *
+     * Si otro hilo ya lo está cargando, se espera a su resultado en vez de
+     * repetir la carga. Lo que devuelve load no se registra si es nullptr.
+     * @param loaded Si no es nulo, true cuando la llamada ejecutó load
+     */
+    std::shared_ptr<const BinaryModuleInterface> acquire(
+        const common::utils::Hash128& hash,
+        const std::function<std::unique_ptr<BinaryModuleInterface>()>& load, bool* loaded = nullptr);
+
+    /**
+     * @brief BMI vivos en el registro
+     */
+    size_t liveCount() const;
+
+private:
+    struct Entry {
+        std::weak_ptr<const BinaryModuleInterface> bmi;
+        bool loading = false;
+    };
+    struct KeyHash {
+        size_t operator()(const common::utils::Hash128& hash) const { return static_cast<size_t>(hash.low); }
+    };
+
+    mutable std::mutex mutex_;
+    std::condition_variable loadFinished_;
+    std::unordered_map<common::utils::Hash128, Entry, KeyHash> entries_;
 };
 
 // ============================================================================
@@ -367,14 +442,27 @@ public:
 
     /**
      * @brief Recuperar BMI desde cache
+     *
+     * El archivo se proyecta y se identifica por el hash de su contenido;
+     * si BMIRegistry ya tiene ese BMI se devuelve el mismo objeto sin
+     * deserializarlo otra vez.
      */
-    std::unique_ptr<BinaryModuleInterface> retrieve(const std::string& moduleName);
+    std::shared_ptr<const BinaryModuleInterface> retrieve(const std::string& moduleName);
 
     /**
      * @brief Verificar si BMI está en cache y es válido
      */
     bool isValid(const std::string& moduleName, const CompilationOptionsHash& currentHash);
 
+    /**
+     * @brief Verificar además que ningún import haya cambiado de interfaz
+     *
+     * importHashes da el hash de interfaz actual de cada módulo importado;
+     * un import sin hash registrado o ausente del mapa invalida la entrada.
+     */
+    bool isValid(const std::string& moduleName, const CompilationOptionsHash& currentHash,
+                 const std::unordered_map<std::string, uint64_t>& importHashes);
+
     /**
      * @brief Invalidar entrada de cache
      */
@@ -385,6 +473,24 @@ public:
      */
     void clear();
 
+    /**
+     * @brief Bloquear la entrada de un módulo frente a otros procesos
+     *
+     * Quien obtiene el bloqueo compila y publica el BMI; el resto espera
+     * aquí y, al entrar, debe volver a consultar la caché antes de compilar.
+     */
+    std::unique_ptr<common::utils::FileLock> lockEntry(const std::string& moduleName);
+
+    /**
+     * @brief Borrar los BMI usados hace más tiempo hasta quedar en maxBytes
+     *
+     * El orden LRU sale de la fecha de modificación, que retrieve actualiza
+     * en cada acierto. Las entradas bloqueadas por otro proceso se respetan
+     * y, si otro proceso ya está recolectando, no se hace nada.
+     * @return Número de BMI borrados
+     */
+    size_t collectGarbage(uint64_t maxBytes);
+
     /**
      * @brief Obtener estadísticas de cache
      */
@@ -393,9 +499,17 @@ public:
         size_t hits = 0;
         size_t misses = 0;
         size_t invalidations = 0;
+        size_t bytesLoaded = 0;                 // Tamaño de los BMI recuperados
+        size_t sharedHits = 0;                  // Aciertos servidos por BMIRegistry sin deserializar
+        std::chrono::microseconds loadTime{0};  // Lectura y deserialización de los aciertos
     };
     CacheStats getStats() const;
 
+    /**
+     * @brief Vuelca aciertos y tiempo de carga de BMI como métricas "bmi.*"
+     */
+    void recordTelemetry(CompilationTelemetry& telemetry) const;
+
 private:
     std::filesystem::path cacheDir_;
     CacheStats stats_;
@@ -453,6 +567,23 @@ private:
 // Module System (Clase principal)
 // ============================================================================
 
+/**
+ * @brief Grafo de dependencias entre interfaces de módulo
+ *
+ * Los nodos están en orden topológico: dependencies[i] solo contiene
+ * índices menores que i. criticalPath[i] es el coste del camino más largo
+ * desde i hasta el final del build; lanzar antes los nodos con mayor valor
+ * acorta el tiempo total cuando hay más trabajo listo que hilos.
+ */
+struct ModuleBuildGraph {
+    std::vector<std::string> modules;
+    std::vector<std::vector<size_t>> dependencies;  // Módulos que importa cada nodo
+    std::vector<std::vector<size_t>> dependents;    // Módulos que lo importan
+    std::vector<double> cost;                       // Duración estimada (ms)
+    std::vector<double> criticalPath;               // cost + máximo de los dependientes
+    bool acyclic = true;
+};
+
 /**
  * @brief Sistema completo de módulos C++20
  */
@@ -488,6 +619,53 @@ public:
      */
     std::vector<std::string> getModuleDependencies(const std::string& moduleName);
 
+    /**
+     * @brief Construir el grafo de módulos necesario para compilar targetModule
+     *
+     * Une los imports escaneados del fuente (las particiones ":P" se
+     * resuelven contra el módulo primario), las particiones registradas y
+     * las dependencias del BMI. El coste de cada nodo sale de la última
+     * duración medida; sin historial se usa la media de los conocidos.
+     */
+    ModuleBuildGraph buildModuleGraph(const std::string& targetModule);
+
+    /**
+     * @brief Compilar todos los nodos del grafo en paralelo
+     *
+     * Cada nodo arranca cuando terminan sus dependencias; entre los listos
+     * se elige el de mayor camino crítico. Si un módulo falla, sus
+     * dependientes no se compilan.
+     */
+    bool compileModuleGraph(const ModuleBuildGraph& graph);
+
+    /**
+     * @brief Número máximo de módulos compilándose a la vez
+     */
+    void setParallelJobs(size_t jobs) { parallelJobs_ = jobs == 0 ? 1 : jobs; }
+
+    /**
+     * @brief Fijar la duración histórica de un módulo (p. ej. de un build anterior)
+     */
+    void setModuleCost(const std::string& moduleName, double milliseconds);
+
+    /**
+     * @brief Duración histórica de un módulo en ms (0 si no hay medida)
+     */
+    double getModuleCost(const std::string& moduleName) const;
+
+    /**
+     * @brief Tamaño máximo del directorio de caché tras cada build (0 = sin límite)
+     */
+    void setCacheSizeLimit(uint64_t bytes) { cacheSizeLimit_ = bytes; }
+
+    /**
+     * @brief Marcar el fuente de un módulo como modificado
+     *
+     * Solo ese módulo se recompila en el siguiente compileModule; sus
+     * importadores lo hacen únicamente si cambia su hash de interfaz.
+     */
+    void invalidateModule(const std::string& moduleName);
+
     /**
      * @brief Verificar si módulo existe
      */
@@ -520,11 +698,18 @@ private:
 
     SystemStats stats_;
 
+    size_t parallelJobs_;
+    uint64_t cacheSizeLimit_ = 0;
+    std::unordered_map<std::string, double> moduleCosts_;
+    mutable std::mutex buildMutex_;  // cache_, stats_ y moduleCosts_ durante compileModuleGraph
+
     bool processModuleDeclaration(const std::filesystem::path& filePath,
                                 const std::string& moduleName);
     bool processImportDeclaration(const std::filesystem::path& filePath,
                                 const std::string& importName);
     std::vector<std::string> computeCompilationOrder(const std::string& targetModule);
+    std::vector<std::string> collectInterfaceDependencies(const std::string& moduleName);
+    bool buildInterface(const std::string& moduleName, const std::vector<std::string>& dependencies);
 };
 
 } // namespace cpp20::compiler::modules
@@ -0,0 +1,78 @@
+/**
+ * @file P1689Scanner.h
+ * @brief Escáner de dependencias de módulos con salida P1689
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cpp20::compiler::modules {
+
+/**
+ * @brief Módulo o header unit requerido por una unidad
+ */
+struct P1689Requirement {
+    std::string logicalName;    // "core", "app:part" o el nombre del header
+    bool isHeaderUnit = false;
+    bool isAngled = false;      // import <x> frente a import "x"
+    bool isExported = false;    // export import
+    uint32_t line = 0;
+};
+
+/**
+ * @brief Regla P1689 de una unidad de traducción
+ *
+ * provides queda vacío en unidades que no son de módulo y en unidades de
+ * implementación "module a;", que en su lugar requieren a.
+ */
+struct P1689Rule {
+    std::filesystem::path sourcePath;
+    std::string primaryOutput;         // Se omite del JSON si está vacío
+    std::string provides;
+    bool isInterface = false;          // export module
+    std::string implements;            // "module a;" (sin partición)
+    std::vector<P1689Requirement> requirements;
+    bool success = false;
+};
+
+/**
+ * @brief Escáner de declaraciones module/import (P1689R5)
+ *
+ * Recorre el archivo proyectado en memoria sin copiarlo. Solo se examina
+ * el principio de cada línea; el resto se salta buscando con SSE2 el
+ * siguiente salto de línea, comentario o literal, de modo que el coste
+ * está dominado por la lectura. Comentarios de bloque y raw strings que
+ * abarcan varias líneas se saltan enteros para no confundir su contenido
+ * con una declaración. No se preprocesa: los imports dentro de #if se
+ * informan siempre.
+ */
+class P1689Scanner {
+public:
+    /**
+     * @brief Escanear un archivo
+     */
+    static P1689Rule scanFile(const std::filesystem::path& path);
+
+    /**
+     * @brief Escanear un buffer en memoria
+     */
+    static P1689Rule scanBuffer(std::string_view source, const std::filesystem::path& path = {});
+
+    /**
+     * @brief Escanear varios archivos con jobs hilos (resultados en orden de entrada)
+     */
+    static std::vector<P1689Rule> scanFiles(const std::vector<std::filesystem::path>& paths,
+                                            size_t jobs);
+
+    /**
+     * @brief Documento JSON P1689 ("version": 1, "revision": 0) con una regla por unidad
+     */
+    static std::string formatJson(const std::vector<P1689Rule>& rules);
+};
+
+} // namespace cpp20::compiler::modules
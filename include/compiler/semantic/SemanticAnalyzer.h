@@ -9,9 +9,15 @@
 #include <compiler/common/diagnostics/DiagnosticEngine.h>
 #include <compiler/common/diagnostics/SourceManager.h>
 #include <compiler/symbols/Symbol.h>
+#include <compiler/symbols/OverloadCache.h>
+#include <compiler/symbols/ScopeChain.h>
+#include <compiler/frontend/lexer/IdentifierTable.h>
 #include <compiler/types/Type.h>
-#include <compiler/semantic/TemplateSystem.h>
+#include <compiler/types/TypeContext.h>
+#include <compiler/templates/TemplateSystem.h>
 #include <memory>
+#include <span>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <stack>
@@ -56,24 +62,22 @@ struct ConversionInfo {
     bool isValid() const { return !conversionSteps.empty(); }
 };
 
-/**
- * @brief Entrada de tabla de símbolos
- */
-struct SymbolTableEntry {
-    std::unique_ptr<symbols::Symbol> symbol;
-    uint32_t scopeLevel;
-    bool isVisible = true;
-
-    SymbolTableEntry(std::unique_ptr<symbols::Symbol> sym, uint32_t level)
-        : symbol(std::move(sym)), scopeLevel(level) {}
-};
-
 /**
  * @brief Tabla de símbolos con scopes
+ *
+ * Los scopes son una symbols::ScopeChain: la búsqueda ordinaria se queda
+ * con la declaración más interna. Los símbolos viven en la SymbolArena de
+ * la tabla hasta clear(), así que los punteros devueltos por lookup() no
+ * caducan al salir del scope.
  */
 class SymbolTable {
 public:
-    SymbolTable();
+    /**
+     * @brief Constructor
+     * @param identifiers Tabla donde se internan los nombres (por defecto la global)
+     */
+    explicit SymbolTable(frontend::lexer::IdentifierTable& identifiers =
+                             frontend::lexer::IdentifierTable::global());
     ~SymbolTable() = default;
 
     /**
@@ -82,14 +86,22 @@ public:
     void enterScope();
 
     /**
-     * @brief Salir del scope actual
+     * @brief Salir del scope actual (el scope global no se abandona)
      */
     void exitScope();
 
     /**
      * @brief Añadir símbolo al scope actual
+     * @return nullptr si el nombre ya existe en el scope (no se crea nada)
      */
-    bool addSymbol(std::unique_ptr<symbols::Symbol> symbol);
+    const symbols::Symbol* addSymbol(symbols::SymbolKind kind, std::string_view name, const types::Type* type);
+
+    const symbols::VariableSymbol* addVariable(std::string_view name, const types::Type* type,
+                                               bool isConst = false, bool isStatic = false);
+
+    const symbols::FunctionSymbol* addFunction(std::string_view name, const types::Type* returnType,
+                                               std::span<const types::Type* const> paramTypes,
+                                               bool isStatic = false);
 
     /**
      * @brief Buscar símbolo por nombre
@@ -97,14 +109,21 @@ public:
     LookupResult lookup(const std::string& name, LookupMode mode = LookupMode::Ordinary) const;
 
     /**
-     * @brief Buscar símbolo en scope específico
+     * @brief Buscar símbolo por identificador internado (sin hashear el texto)
+     */
+    LookupResult lookup(const frontend::lexer::IdentifierInfo* name,
+                        LookupMode mode = LookupMode::Ordinary) const;
+
+    /**
+     * @brief Buscar símbolo en un scope activo concreto
+     * @param scopeLevel Identificador devuelto por currentScopeLevel()
      */
     LookupResult lookupInScope(const std::string& name, uint32_t scopeLevel) const;
 
     /**
      * @brief Obtener nivel de scope actual
      */
-    uint32_t currentScopeLevel() const { return currentScope_; }
+    uint32_t currentScopeLevel() const { return scopes_.currentScope(); }
 
     /**
      * @brief Limpiar tabla de símbolos
@@ -116,16 +135,18 @@ public:
      */
     struct Stats {
         size_t totalSymbols = 0;
+        size_t symbolMemory = 0;        // Bytes de la arena de símbolos
         size_t scopes = 0;
         size_t maxDepth = 0;
     };
     Stats getStats() const;
 
 private:
-    std::unordered_map<std::string, std::vector<SymbolTableEntry>> symbolMap_;
-    std::stack<uint32_t> scopeStack_;
-    uint32_t currentScope_ = 0;
-    uint32_t nextScopeId_ = 1;
+    using Name = const frontend::lexer::IdentifierInfo*;
+
+    frontend::lexer::IdentifierTable* identifiers_;
+    symbols::ScopeChain scopes_;
+    symbols::SymbolArena arena_;
 };
 
 /**
@@ -135,7 +156,8 @@ class ExpressionAnalyzer {
 public:
     ExpressionAnalyzer(diagnostics::DiagnosticEngine& diagEngine,
                       SymbolTable& symbolTable,
-                      TemplateSystem& templateSystem);
+                      TemplateSystem& templateSystem,
+                      types::TypeContext& typeContext);
 
     /**
      * @brief Analizar expresión
@@ -149,17 +171,31 @@ public:
 
     /**
      * @brief Encontrar conversiones implícitas
+     *
+     * Ambos tipos se llevan a su forma canónica, así que la identidad y
+     * cualquier consulta posterior comparan punteros.
      */
     ConversionInfo findImplicitConversion(const types::Type* source, const types::Type* target);
 
+    /**
+     * @brief Tipos canónicos con los que compara el analizador
+     */
+    types::TypeContext& typeContext() const { return typeContext_; }
+
 private:
     diagnostics::DiagnosticEngine& diagEngine_;
     SymbolTable& symbolTable_;
     TemplateSystem& templateSystem_;
+    types::TypeContext& typeContext_;
 };
 
 /**
  * @brief Resolvedor de sobrecargas
+ *
+ * Antes de ordenar conversiones descarta los candidatos con
+ * symbols::mayBeViable(), y memoriza el resultado en una
+ * symbols::OverloadCache durante toda la unidad: llamadas repetidas como
+ * operator<<(ostream&, int) se resuelven una sola vez.
  */
 class OverloadResolver {
 public:
@@ -193,10 +229,29 @@ public:
         const std::vector<const symbols::FunctionSymbol*>& candidates,
         const std::vector<const types::Type*>& argumentTypes);
 
+    /**
+     * @brief Olvidar las resoluciones memorizadas (los símbolos dejan de existir)
+     */
+    void clearCache() { cache_.clear(); }
+
+    /**
+     * @brief Estadísticas de poda y memorización
+     */
+    struct Stats {
+        size_t cacheHits = 0;
+        size_t cacheMisses = 0;
+        size_t prunedCandidates = 0;
+        size_t rankedCandidates = 0;
+    };
+    Stats getStats() const;
+
 private:
     diagnostics::DiagnosticEngine& diagEngine_;
     SymbolTable& symbolTable_;
     ExpressionAnalyzer& exprAnalyzer_;
+    symbols::OverloadCache cache_;
+    size_t prunedCandidates_ = 0;
+    size_t rankedCandidates_ = 0;
 };
 
 /**
@@ -218,6 +273,15 @@ public:
     SemanticAnalyzer(diagnostics::DiagnosticEngine& diagEngine,
                     diagnostics::SourceManager& sourceManager);
 
+    /**
+     * @brief Constructor con sistema de templates compartido
+     * @param templateSystem Motor común a toda la compilación; debe vivir más
+     *        que el analizador y no se usa desde dos analizadores a la vez
+     */
+    SemanticAnalyzer(diagnostics::DiagnosticEngine& diagEngine,
+                    diagnostics::SourceManager& sourceManager,
+                    TemplateSystem& templateSystem);
+
     /**
      * @brief Destructor
      */
@@ -300,15 +364,22 @@ public:
      */
     void clear();
 
+    /**
+     * @brief Tipos canónicos de la unidad
+     */
+    types::TypeContext& typeContext() { return typeContext_; }
+
 private:
     diagnostics::DiagnosticEngine& diagEngine_;
     diagnostics::SourceManager& sourceManager_;
 
     // Componentes principales
+    std::unique_ptr<TemplateSystem> ownedTemplateSystem_; // Solo sin motor compartido
+    TemplateSystem& templateSystem_;
+    types::TypeContext typeContext_;
     SymbolTable symbolTable_;
     ExpressionAnalyzer expressionAnalyzer_;
     OverloadResolver overloadResolver_;
-    TemplateSystem templateSystem_;
 
     // Estado
     std::stack<bool> templateContextStack_;
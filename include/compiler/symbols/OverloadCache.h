@@ -0,0 +1,82 @@
+#pragma once
+
+#include <compiler/symbols/Symbol.h>
+#include <compiler/types/TypeContext.h>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace cpp20::compiler::symbols {
+
+/**
+ * @brief Filtro barato: false si el argumento no puede convertirse al parámetro
+ *
+ * Quita las referencias y solo rechaza pares de categorías de tipo que
+ * ninguna conversión estándar ni definida por el usuario puede unir.
+ */
+bool mayConvert(const types::Type* argument, const types::Type* parameter);
+
+/**
+ * @brief Poda previa a ordenar conversiones: aridad y primer argumento
+ */
+bool mayBeViable(const FunctionSymbol& candidate, std::span<const types::Type* const> argumentTypes);
+
+/**
+ * @brief Resoluciones de sobrecarga memorizadas durante una unidad
+ *
+ * La clave es (conjunto de sobrecargas, tupla de tipos canónicos de los
+ * argumentos): los punteros de los candidatos, un separador nulo y los
+ * tipos del TypeContext, así que añadir una sobrecarga da otra clave.
+ * También se memorizan los fallos. Una llamada con algún argumento que el
+ * contexto no sabe unificar no se memoriza. Las entradas apuntan a los
+ * símbolos: hay que llamar a clear() antes de liberarlos.
+ */
+class OverloadCache {
+public:
+    struct Key {
+        std::vector<const void*> entries;
+        bool memoizable = true;
+    };
+
+    explicit OverloadCache(types::TypeContext& typeContext) : typeContext_(&typeContext) {}
+
+    /**
+     * @brief Clave de una llamada (canonicaliza los tipos de los argumentos)
+     */
+    Key makeKey(std::span<const FunctionSymbol* const> candidates,
+                std::span<const types::Type* const> argumentTypes) const;
+
+    /**
+     * @brief Resolución memorizada; nullopt si no hay o la clave no es memorizable
+     * @return Puede contener nullptr: la llamada ya falló antes
+     */
+    std::optional<const FunctionSymbol*> find(const Key& key);
+
+    void store(Key&& key, const FunctionSymbol* result);
+
+    /**
+     * @brief Olvidar las resoluciones (los símbolos dejan de existir)
+     */
+    void clear() { entries_.clear(); }
+
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t entries = 0;
+    };
+    Stats getStats() const;
+
+private:
+    struct KeyHash {
+        size_t operator()(const std::vector<const void*>& key) const;
+    };
+
+    types::TypeContext* typeContext_;
+    std::unordered_map<std::vector<const void*>, const FunctionSymbol*, KeyHash> entries_;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+};
+
+} // namespace cpp20::compiler::symbols
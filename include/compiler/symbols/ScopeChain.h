@@ -0,0 +1,127 @@
+#pragma once
+
+#include <compiler/symbols/Symbol.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace cpp20::compiler::symbols {
+
+/**
+ * @brief Cadena de scopes activos con una tabla hash abierta por scope
+ *
+ * Cada scope indexa sus símbolos por el IdentifierInfo internado y apunta
+ * a su padre; find() recorre la cadena hacia fuera y se queda con la
+ * primera coincidencia, de modo que el scope más interno oculta al resto.
+ * Salir de un scope vacía solo las entradas que se añadieron en él y lo
+ * recicla para el siguiente enter(). La cadena no posee los símbolos.
+ */
+class ScopeChain {
+public:
+    using Name = Symbol::Name;
+
+    /**
+     * @brief Crea la cadena con el scope global (id 1) ya abierto
+     */
+    ScopeChain();
+
+    ScopeChain(const ScopeChain&) = delete;
+    ScopeChain& operator=(const ScopeChain&) = delete;
+
+    /**
+     * @brief Abrir un scope anidado en el actual
+     * @return Identificador del nuevo scope, único hasta clear()
+     */
+    uint32_t enter();
+
+    /**
+     * @brief Cerrar el scope actual
+     * @return false en el scope global, que no se abandona
+     */
+    bool exit();
+
+    /**
+     * @brief Añadir un símbolo al scope actual
+     * @return false si el nombre ya existe en el scope actual
+     */
+    bool insert(Name name, const Symbol* symbol);
+
+    /**
+     * @brief Símbolo visible más interno con ese nombre
+     */
+    const Symbol* find(Name name) const;
+
+    /**
+     * @brief Todos los símbolos de la cadena con ese nombre, del más interno al global
+     */
+    std::vector<const Symbol*> findAll(Name name) const;
+
+    /**
+     * @brief Buscar solo en el scope actual
+     */
+    const Symbol* findInCurrent(Name name) const { return current_->find(name); }
+
+    /**
+     * @brief Buscar solo en el scope global
+     */
+    const Symbol* findInGlobal(Name name) const { return scopes_.front()->find(name); }
+
+    /**
+     * @brief Buscar en un scope activo concreto (nullptr si ya se cerró)
+     */
+    const Symbol* findInScope(Name name, uint32_t scopeId) const;
+
+    uint32_t currentScope() const { return current_->id; }
+
+    /**
+     * @brief Profundidad actual (1 = global) y máxima alcanzada
+     */
+    size_t depth() const { return scopes_.size(); }
+    size_t maxDepth() const { return maxDepth_; }
+
+    /**
+     * @brief Scopes abiertos desde la construcción o el último clear()
+     */
+    size_t scopesCreated() const { return nextScopeId_ - 1; }
+
+    /**
+     * @brief Cerrar todos los scopes y volver a abrir el global
+     */
+    void clear();
+
+private:
+    /**
+     * @brief Tabla hash de un scope: potencia de dos con sondeo lineal
+     *
+     * used guarda los índices ocupados para vaciar el scope recorriendo
+     * solo sus símbolos y no toda la tabla.
+     */
+    struct Scope {
+        struct Slot {
+            Name name = nullptr;
+            const Symbol* symbol = nullptr;
+        };
+
+        uint32_t id = 0;
+        Scope* parent = nullptr;
+        std::vector<Slot> slots;
+        std::vector<uint32_t> used;
+
+        const Symbol* find(Name name) const;
+        bool insert(Name name, const Symbol* symbol);
+        void reset();
+
+    private:
+        static size_t hash(Name name);
+        void grow();
+    };
+
+    Scope* current_ = nullptr;
+    std::vector<std::unique_ptr<Scope>> scopes_;     // Cadena activa, [0] = global
+    std::vector<std::unique_ptr<Scope>> freeScopes_; // Scopes ya vaciados para reutilizar
+    uint32_t nextScopeId_ = 1;
+    size_t maxDepth_ = 0;
+};
+
+} // namespace cpp20::compiler::symbols
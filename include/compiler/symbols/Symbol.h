@@ -1,16 +1,27 @@
 #pragma once
 
 #include <compiler/types/Type.h>
+#include <compiler/common/utils/MemoryPool.h>
+#include <cstdint>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <memory>
+
+namespace cpp20::compiler::frontend::lexer {
+class IdentifierInfo;
+}
 
 namespace cpp20::compiler::symbols {
 
+class SymbolArena;
+class VariableSymbol;
+class FunctionSymbol;
+
 /**
  * @brief Tipos de símbolos
  */
-enum class SymbolKind {
+enum class SymbolKind : uint8_t {
     Variable,
     Function,
     Type,
@@ -18,23 +29,55 @@ enum class SymbolKind {
 };
 
 /**
- * @brief Clase base para todos los símbolos
+ * @brief Símbolo compacto: clase, nombre internado, tipo e id dentro de su arena
+ *
+ * No tiene métodos virtuales ni posee memoria: lo que depende de la clase
+ * (los parámetros de una función) vive en tablas de la SymbolArena que lo
+ * creó. VariableSymbol y FunctionSymbol son vistas sin datos propios, así
+ * que asVariable() y asFunction() sustituyen a dynamic_cast.
  */
 class Symbol {
 public:
-    Symbol(SymbolKind kind, std::string name, const types::Type* type);
-    virtual ~Symbol();
+    using Name = const frontend::lexer::IdentifierInfo*;
+
+    /**
+     * @brief Símbolo suelto, fuera de cualquier arena (sin datos por clase)
+     */
+    Symbol(SymbolKind kind, Name name, const types::Type* type);
 
     SymbolKind kind() const { return kind_; }
-    const std::string& name() const { return name_; }
+    Name identifier() const { return name_; }
+    std::string_view name() const;
     const types::Type* type() const { return type_; }
 
-    virtual std::string toString() const;
+    /**
+     * @brief Posición en la arena (0 en un símbolo suelto)
+     */
+    uint32_t id() const { return id_; }
 
-private:
-    SymbolKind kind_;
-    std::string name_;
+    const VariableSymbol* asVariable() const;
+    const FunctionSymbol* asFunction() const;
+
+    /**
+     * @brief Descripción legible; se construye en cada llamada, nada se guarda en el símbolo
+     */
+    std::string toString() const;
+
+protected:
+    enum Flags : uint8_t {
+        Const = 1 << 0,
+        Static = 1 << 1,
+    };
+
+    const SymbolArena* arena_ = nullptr;
+    Name name_;
     const types::Type* type_;
+    uint32_t id_ = 0;
+    uint32_t payload_ = 0;              // Índice en la tabla de su clase
+    SymbolKind kind_;
+    uint8_t flags_ = 0;
+
+    friend class SymbolArena;
 };
 
 /**
@@ -42,17 +85,12 @@ private:
  */
 class VariableSymbol : public Symbol {
 public:
-    VariableSymbol(std::string name, const types::Type* type,
-                  bool isConst = false, bool isStatic = false);
-
-    bool isConst() const { return isConst_; }
-    bool isStatic() const { return isStatic_; }
-
-    std::string toString() const override;
+    bool isConst() const { return flags_ & Const; }
+    bool isStatic() const { return flags_ & Static; }
 
 private:
-    bool isConst_;
-    bool isStatic_;
+    using Symbol::Symbol;
+    friend class SymbolArena;
 };
 
 /**
@@ -60,18 +98,67 @@ private:
  */
 class FunctionSymbol : public Symbol {
 public:
-    FunctionSymbol(std::string name, const types::Type* returnType,
-                  std::vector<const types::Type*> paramTypes,
-                  bool isStatic = false);
+    /**
+     * @brief Tipos de los parámetros, guardados en la arena
+     */
+    std::span<const types::Type* const> paramTypes() const;
+    bool isStatic() const { return flags_ & Static; }
 
-    const std::vector<const types::Type*>& paramTypes() const { return paramTypes_; }
-    bool isStatic() const { return isStatic_; }
+private:
+    using Symbol::Symbol;
+    friend class SymbolArena;
+};
 
-    std::string toString() const override;
+/**
+ * @brief Almacén de los símbolos de una unidad de traducción
+ *
+ * Los símbolos y las listas de parámetros se construyen en un MemoryPool:
+ * sin una asignación por símbolo ni destructores, y con direcciones
+ * estables hasta clear(). Las unidades que incluyen <windows.h> crean
+ * cientos de miles de símbolos.
+ */
+class SymbolArena {
+public:
+    SymbolArena();
+
+    SymbolArena(const SymbolArena&) = delete;
+    SymbolArena& operator=(const SymbolArena&) = delete;
+
+    const Symbol* create(SymbolKind kind, Symbol::Name name, const types::Type* type);
+
+    const VariableSymbol* createVariable(Symbol::Name name, const types::Type* type,
+                                         bool isConst = false, bool isStatic = false);
+
+    const FunctionSymbol* createFunction(Symbol::Name name, const types::Type* returnType,
+                                         std::span<const types::Type* const> paramTypes,
+                                         bool isStatic = false);
+
+    /**
+     * @brief Símbolo por id (1..size())
+     */
+    const Symbol* symbol(uint32_t id) const { return symbols_[id - 1]; }
+
+    size_t size() const { return symbols_.size(); }
+
+    /**
+     * @brief Bytes reservados por el pool
+     */
+    size_t memoryUsage() const { return pool_.totalAllocated(); }
+
+    /**
+     * @brief Olvidar todos los símbolos; los punteros dados dejan de ser válidos
+     */
+    void clear();
 
 private:
-    std::vector<const types::Type*> paramTypes_;
-    bool isStatic_;
+    common::utils::MemoryPool pool_;
+    std::vector<const Symbol*> symbols_;                             // Por id - 1
+    std::vector<std::span<const types::Type* const>> parameters_;    // Por payload de cada función
+
+    template<typename T>
+    T* place(SymbolKind kind, Symbol::Name name, const types::Type* type);
+
+    friend class FunctionSymbol;
 };
 
 } // namespace cpp20::compiler::symbols
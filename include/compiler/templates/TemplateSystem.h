@@ -8,13 +8,38 @@
 #include <compiler/ast/ASTNode.h>
 #include <compiler/ast/TemplateAST.h>
 #include <compiler/common/diagnostics/DiagnosticEngine.h>
+#include <compiler/common/utils/MemoryPool.h>
+#include <compiler/types/Type.h>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <string>
 
+namespace cpp20::compiler::symbols {
+class Symbol;
+}
+
 namespace cpp20::compiler::semantic {
 
+/**
+ * @brief Búsqueda de un nombre para los templates
+ *
+ * arguments son los argumentos de la especialización para las búsquedas
+ * dependientes y están vacíos al ligar en la definición. Se llama desde
+ * varios hilos durante performPendingInstantiations(jobs > 1).
+ */
+using TemplateNameLookup = std::function<const symbols::Symbol*(const std::string& name,
+                                                                const std::vector<std::string>& arguments)>;
+
+/**
+ * @brief Resultado de las búsquedas de nombres (nullptr = no encontrado)
+ */
+using NameBindings = std::unordered_map<std::string, const symbols::Symbol*>;
+
 /**
  * @brief Estado de evaluación de constraint
  */
@@ -38,17 +63,22 @@ struct ConstraintEvaluationResult {
 
 /**
  * @brief Información de template
+ *
+ * Los nodos pertenecen al ASTContext de la unidad que declaró el template.
  */
 struct TemplateInfo {
     std::string name;
-    std::unique_ptr<ast::TemplateParameterList> parameters;
-    std::unique_ptr<ast::ASTNode> definition;
-    std::unordered_map<std::string, std::unique_ptr<ast::ASTNode>> specializations;
+    ast::TemplateParameterList* parameters;
+    ast::ASTNode* definition;
+    std::unordered_map<std::string, ast::ASTNode*> specializations;
     bool isConcept = false;
 
-    TemplateInfo(const std::string& n, std::unique_ptr<ast::TemplateParameterList> params,
-                std::unique_ptr<ast::ASTNode> def)
-        : name(n), parameters(std::move(params)), definition(std::move(def)) {}
+    // Búsqueda en dos fases, rellenada al registrar
+    NameBindings boundNames;                  // No dependientes, ligados en la definición
+    std::vector<std::string> dependentNames;  // Se buscan una vez por especialización
+
+    TemplateInfo(const std::string& n, ast::TemplateParameterList* params, ast::ASTNode* def)
+        : name(n), parameters(params), definition(def) {}
 };
 
 /**
@@ -57,19 +87,38 @@ struct TemplateInfo {
 struct TemplateInstance {
     std::string templateName;
     std::vector<std::string> arguments;
-    std::unique_ptr<ast::ASTNode> instantiatedCode;
+    ast::ASTNode* instantiatedCode = nullptr;
     bool isValid = true;
     std::string errorMessage;
+    NameBindings dependentBindings;           // Nombres dependientes con estos argumentos
 
     TemplateInstance(const std::string& name, const std::vector<std::string>& args)
         : templateName(name), arguments(args) {}
 };
 
+/**
+ * @brief Resultado de deducir los argumentos de un template de función
+ */
+struct DeductionResult {
+    bool success = false;
+    std::vector<std::string> arguments;       // Uno por parámetro del template, en orden
+    std::string errorMessage;
+};
+
 /**
  * @brief Constraint Solver para concepts C++20
+ *
+ * Memoriza tres cosas: la satisfacción de (concept, tipo), con el tipo
+ * identificado por su puntero canónico o por su nombre internado; la
+ * evaluación de cada constraint con sus bindings; y la subsumption entre
+ * pares de constraints, calculada sobre su forma normal (DNF/CNF de
+ * átomos), que también queda en caché. Las cachés están protegidas por
+ * un mutex porque la instanciación diferida evalúa desde varios hilos.
  */
 class ConstraintSolver {
 public:
+    using Bindings = std::unordered_map<std::string, std::string>;
+
     /**
      * @brief Constructor
      */
@@ -79,45 +128,177 @@ public:
      * @brief Evaluar constraint expression
      */
     ConstraintEvaluationResult evaluateConstraint(const ast::ConstraintExpression* constraint,
-                                                const std::unordered_map<std::string, std::string>& bindings);
+                                                const Bindings& bindings);
 
     /**
      * @brief Verificar si un tipo satisface un concept
      */
     ConstraintEvaluationResult checkConceptSatisfaction(const std::string& conceptName,
                                                        const std::string& typeName,
-                                                       const std::unordered_map<std::string, std::string>& bindings);
+                                                       const Bindings& bindings);
+
+    /**
+     * @brief Verificar si un tipo canónico satisface un concept
+     *
+     * Con un tipo de TypeContext la clave de caché es el puntero; un tipo
+     * no canónico se identifica por su nombre.
+     */
+    ConstraintEvaluationResult checkConceptSatisfaction(const std::string& conceptName,
+                                                       const types::Type* type,
+                                                       const Bindings& bindings);
 
     /**
      * @brief Verificar subsumption entre constraints
+     *
+     * derived subsume a base si cada cláusula disyuntiva de derived comparte
+     * un átomo con cada cláusula conjuntiva de base. Si la forma normal
+     * crece demasiado se responde false, que es la respuesta conservadora.
      */
     bool checkSubsumption(const ast::ConstraintExpression* derived,
                          const ast::ConstraintExpression* base);
 
+    /**
+     * @brief Olvidar resultados y formas normales memorizados
+     */
+    void clearCache();
+
+    /**
+     * @brief Estadísticas de las cachés
+     */
+    struct CacheStats {
+        size_t satisfactionHits = 0;
+        size_t satisfactionMisses = 0;
+        size_t evaluationHits = 0;
+        size_t evaluationMisses = 0;
+        size_t subsumptionHits = 0;
+        size_t subsumptionMisses = 0;
+    };
+    CacheStats getCacheStats() const;
+
 private:
+    using Clauses = std::vector<std::vector<uint32_t>>;
+
+    /**
+     * @brief Forma normal de un constraint: cláusulas de ids de átomo ordenados
+     */
+    struct NormalForm {
+        Clauses disjunctive;   // OR de ANDs
+        Clauses conjunctive;   // AND de ORs
+        bool overflow = false; // Demasiadas cláusulas para decidir
+    };
+
+    struct SatisfactionKey {
+        std::string conceptName;
+        const void* typeId;
+
+        bool operator==(const SatisfactionKey& other) const {
+            return typeId == other.typeId && conceptName == other.conceptName;
+        }
+    };
+
+    struct EvaluationKey {
+        const ast::ConstraintExpression* constraint;
+        std::vector<std::pair<std::string, std::string>> bindings; // Ordenados por nombre
+
+        bool operator==(const EvaluationKey& other) const {
+            return constraint == other.constraint && bindings == other.bindings;
+        }
+    };
+
+    struct SubsumptionKey {
+        const ast::ConstraintExpression* derived;
+        const ast::ConstraintExpression* base;
+
+        bool operator==(const SubsumptionKey& other) const {
+            return derived == other.derived && base == other.base;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const SatisfactionKey& key) const;
+        size_t operator()(const EvaluationKey& key) const;
+        size_t operator()(const SubsumptionKey& key) const;
+    };
+
     diagnostics::DiagnosticEngine& diagEngine_;
 
+    mutable std::mutex cacheMutex_;
+    std::unordered_map<SatisfactionKey, ConstraintEvaluationResult, KeyHash> satisfactionCache_;
+    std::unordered_map<EvaluationKey, ConstraintEvaluationResult, KeyHash> evaluationCache_;
+    std::unordered_map<SubsumptionKey, bool, KeyHash> subsumptionCache_;
+    std::unordered_map<const ast::ASTNode*, NormalForm> normalForms_;
+    std::unordered_map<std::string, uint32_t> atomIds_;
+    std::unordered_set<std::string> typeNames_;
+    CacheStats cacheStats_;
+
+    /**
+     * @brief Satisfacción consultando y rellenando la caché
+     */
+    ConstraintEvaluationResult cachedConceptSatisfaction(const std::string& conceptName,
+                                                        const void* typeId,
+                                                        const std::string& typeName);
+
+    /**
+     * @brief Satisfacción sin caché
+     */
+    ConstraintEvaluationResult evaluateConceptSatisfaction(const std::string& conceptName,
+                                                          const std::string& typeName);
+
+    /**
+     * @brief Evaluación recursiva sin caché
+     */
+    ConstraintEvaluationResult evaluateConstraintUncached(const ast::ConstraintExpression* constraint,
+                                                        const Bindings& bindings);
+
+    /**
+     * @brief Forma normal memorizada (requiere cacheMutex_)
+     */
+    const NormalForm& normalize(const ast::ASTNode* constraint);
+
+    /**
+     * @brief Id estable de un átomo por su texto (requiere cacheMutex_)
+     */
+    uint32_t atomId(const std::string& atom);
+
+    /**
+     * @brief Producto de dos conjuntos de cláusulas (false si excede el límite)
+     */
+    static bool combineClauses(const Clauses& left, const Clauses& right, Clauses& result);
+
     /**
      * @brief Evaluar constraint atómico
      */
     ConstraintEvaluationResult evaluateAtomicConstraint(const ast::ASTNode* atomic,
-                                                       const std::unordered_map<std::string, std::string>& bindings);
+                                                       const Bindings& bindings);
 
     /**
      * @brief Evaluar conjunction (&&)
      */
     ConstraintEvaluationResult evaluateConjunction(const ast::ConstraintExpression* constraint,
-                                                  const std::unordered_map<std::string, std::string>& bindings);
+                                                  const Bindings& bindings);
 
     /**
      * @brief Evaluar disjunction (||)
      */
     ConstraintEvaluationResult evaluateDisjunction(const ast::ConstraintExpression* constraint,
-                                                 const std::unordered_map<std::string, std::string>& bindings);
+                                                 const Bindings& bindings);
+
+    /**
+     * @brief Evaluar negación (!)
+     */
+    ConstraintEvaluationResult evaluateNegation(const ast::ConstraintExpression* constraint,
+                                              const Bindings& bindings);
 };
 
 /**
  * @brief Template Instantiation Engine
+ *
+ * Además de la instanciación inmediata admite una lista de trabajo
+ * diferida: requestInstantiation() solo anota el punto de instanciación
+ * y performPendingInstantiations() instancia en paralelo las
+ * especializaciones pendientes, que son independientes entre sí. La
+ * caché de instancias es el punto de deduplicado: una especialización ya
+ * instanciada o ya pendiente no se vuelve a encolar.
  */
 class TemplateInstantiationEngine {
 public:
@@ -128,16 +309,74 @@ public:
                               ConstraintSolver& constraintSolver);
 
     /**
-     * @brief Registrar template
+     * @brief Búsqueda de nombres para ligar definiciones e instancias
+     *
+     * Debe fijarse antes de registrar: los nombres no dependientes de un
+     * template se ligan en registerTemplate(). Sin ella los nombres se
+     * clasifican pero no se buscan.
+     */
+    void setNameLookup(TemplateNameLookup lookup) { nameLookup_ = std::move(lookup); }
+
+    /**
+     * @brief Registrar template y ligar sus nombres no dependientes
      */
     void registerTemplate(std::unique_ptr<TemplateInfo> templateInfo);
 
     /**
      * @brief Instanciar template
+     *
+     * Solo busca los nombres dependientes, y una sola vez por lista de
+     * argumentos: una instancia en caché devuelve sus dependentBindings.
      */
     std::unique_ptr<TemplateInstance> instantiateTemplate(const std::string& templateName,
                                                         const std::vector<std::string>& arguments);
 
+    /**
+     * @brief Deducir los argumentos de un template de función a partir de una llamada
+     *
+     * explicitArguments son los de `f<int>(...)` y ocupan los primeros
+     * parámetros. Cada parámetro de función se compara con el tipo de su
+     * argumento ya sin referencia ni const de nivel superior. Los
+     * parámetros de la forma T, const T& o T&& se deducen por asignación
+     * directa, sin recorrer el patrón; el resto (vector<T>, T*) se
+     * empareja token a token.
+     *
+     * El resultado, éxito o fallo, se memoriza por (template, argumentos
+     * explícitos, tipos de los argumentos): una llamada repetida no vuelve
+     * a deducir. La caché es de la unidad en curso; clearCache() la vacía.
+     */
+    DeductionResult deduceTemplateArguments(const std::string& templateName,
+                                            const std::vector<std::string>& explicitArguments,
+                                            const std::vector<std::string>& argumentTypes);
+
+    /**
+     * @brief Anotar un punto de instanciación para instanciarlo más tarde
+     * @return false si la especialización ya está instanciada o pendiente
+     */
+    bool requestInstantiation(const std::string& templateName,
+                              const std::vector<std::string>& arguments,
+                              const diagnostics::SourceLocation& pointOfInstantiation);
+
+    /**
+     * @brief Instanciar todo lo pendiente con hasta jobs hilos
+     *
+     * Los errores se reportan en el punto de instanciación y en el orden
+     * en que se anotaron, sea cual sea el hilo que instanció.
+     * @return Número de especializaciones instanciadas
+     */
+    size_t performPendingInstantiations(size_t jobs);
+
+    /**
+     * @brief Número de especializaciones anotadas y aún sin instanciar
+     */
+    size_t pendingInstantiations() const { return worklist_.size(); }
+
+    /**
+     * @brief Instancia ya completada (nullptr si no se ha instanciado)
+     */
+    const TemplateInstance* findInstance(const std::string& templateName,
+                                         const std::vector<std::string>& arguments) const;
+
     /**
      * @brief Verificar si template puede ser instanciado
      */
@@ -164,27 +403,68 @@ public:
         size_t cacheHits = 0;
         size_t cacheMisses = 0;
         size_t errors = 0;
+        size_t deferredRequests = 0;
+        size_t deferredDuplicates = 0;
+        size_t namesBoundAtDefinition = 0;   // Búsquedas hechas al registrar
+        size_t dependentLookups = 0;         // Búsquedas hechas al instanciar
+        size_t deductionCacheHits = 0;
+        size_t deductionsRun = 0;
+        size_t deductionFastPaths = 0;       // Deducciones sin emparejar patrones
     };
     InstantiationStats getStats() const { return stats_; }
 
 private:
+    /**
+     * @brief Punto de instanciación anotado en la lista de trabajo
+     */
+    struct PendingInstantiation {
+        std::string cacheKey;
+        std::string templateName;
+        std::vector<std::string> arguments;
+        diagnostics::SourceLocation pointOfInstantiation;
+    };
+
     diagnostics::DiagnosticEngine& diagEngine_;
     ConstraintSolver& constraintSolver_;
     InstantiationStats stats_;
+    TemplateNameLookup nameLookup_;
 
     std::unordered_map<std::string, std::unique_ptr<TemplateInfo>> templates_;
     std::unordered_map<std::string, std::unique_ptr<TemplateInstance>> instanceCache_;
+    std::vector<PendingInstantiation> worklist_;
+    std::unordered_set<std::string> pendingKeys_;
+    std::unordered_map<std::string, DeductionResult> deductionCache_;   // Ver deductionCacheKey
 
     /**
      * @brief Generar clave de cache
      */
-    std::string generateCacheKey(const std::string& templateName,
-                                const std::vector<std::string>& arguments);
+    static std::string generateCacheKey(const std::string& templateName,
+                                        const std::vector<std::string>& arguments);
+
+    /**
+     * @brief Deducción sin caché
+     */
+    DeductionResult runDeduction(const TemplateInfo& templateInfo,
+                                 const std::vector<std::string>& explicitArguments,
+                                 const std::vector<std::string>& argumentTypes);
+
+    /**
+     * @brief Instanciar sin tocar caché ni estadísticas (seguro en paralelo)
+     *
+     * Solo lee templates_, que no cambia mientras hay instanciaciones en curso.
+     */
+    std::unique_ptr<TemplateInstance> buildInstance(const std::string& templateName,
+                                                    const std::vector<std::string>& arguments);
+
+    /**
+     * @brief Guardar en la caché una copia sin AST de la instancia
+     */
+    void cacheInstance(const std::string& cacheKey, const TemplateInstance& instance);
 
     /**
      * @brief Sustituir parámetros en AST
      */
-    std::unique_ptr<ast::ASTNode> substituteParameters(
+    ast::ASTNode* substituteParameters(
         const ast::ASTNode* templateAST,
         const std::unordered_map<std::string, std::string>& parameterMap);
 
@@ -232,18 +512,65 @@ public:
     std::string getSFINAEErrorMessage(const std::string& templateName,
                                     const std::vector<std::string>& arguments) const;
 
+    /**
+     * @brief Probar la sustitución de un candidato sin pagar su fallo
+     *
+     * substitute() corre dentro de un checkpoint de arena y de una
+     * DiagnosticTrap. Si devuelve false o emite algún error, la arena
+     * vuelve al checkpoint y los diagnósticos se descartan sin haberse
+     * construido; el fallo queda registrado con el código del primer
+     * error. Si tiene éxito, lo asignado se conserva y los avisos
+     * capturados se pierden, como en un compilador que no los repite al
+     * elegir el candidato.
+     * @return true si la sustitución es válida
+     */
+    template<typename Func>
+    bool trySubstitution(const std::string& templateName, const std::vector<std::string>& arguments,
+                         common::utils::MemoryPool& arena, Func&& substitute) {
+        ++stats_.trials;
+        common::utils::MemoryPool::Checkpoint checkpoint = arena.checkpoint();
+        bool substituted;
+        diagnostics::DiagnosticCode firstError{};
+        {
+            diagnostics::DiagnosticTrap trap(diagEngine_);
+            substituted = substitute() && !trap.hasErrors();
+            firstError = trap.firstErrorCode();
+        }
+        if (substituted) {
+            arena.commit(checkpoint);
+            return true;
+        }
+        arena.rollback(checkpoint);
+        ++stats_.failedTrials;
+        registerSFINAEFailure(templateName, arguments,
+                              "sustitución fallida (" + std::to_string(static_cast<int>(firstError)) + ")");
+        return false;
+    }
+
     /**
      * @brief Limpiar registros SFINAE
      */
     void clear();
 
+    struct TrialStats {
+        size_t trials = 0;
+        size_t failedTrials = 0;
+    };
+    TrialStats getStats() const { return stats_; }
+
 private:
     diagnostics::DiagnosticEngine& diagEngine_;
     std::unordered_map<std::string, std::string> sfinaeErrors_;
+    TrialStats stats_;
 };
 
 /**
  * @brief Sistema de Templates C++20
+ *
+ * Único motor de templates del compilador: el análisis semántico lo usa
+ * a través de SemanticAnalyzer y puede compartir una instancia entre
+ * unidades para que la caché de instancias y las estadísticas cubran
+ * toda la compilación.
  */
 class TemplateSystem {
 public:
@@ -262,6 +589,13 @@ public:
      */
     void registerTemplate(std::unique_ptr<TemplateInfo> templateInfo);
 
+    /**
+     * @brief Búsqueda de nombres de la búsqueda en dos fases (ver TemplateInstantiationEngine)
+     */
+    void setNameLookup(TemplateNameLookup lookup) {
+        instantiationEngine_->setNameLookup(std::move(lookup));
+    }
+
     /**
      * @brief Registrar concept
      */
@@ -273,14 +607,41 @@ public:
     std::unique_ptr<TemplateInstance> instantiateTemplate(const std::string& templateName,
                                                         const std::vector<std::string>& arguments);
 
+    /**
+     * @brief Anotar un punto de instanciación diferida
+     */
+    bool requestInstantiation(const std::string& templateName,
+                              const std::vector<std::string>& arguments,
+                              const diagnostics::SourceLocation& pointOfInstantiation) {
+        return instantiationEngine_->requestInstantiation(templateName, arguments, pointOfInstantiation);
+    }
+
+    /**
+     * @brief Instanciar en paralelo las especializaciones diferidas
+     */
+    size_t performPendingInstantiations(size_t jobs);
+
     /**
      * @brief Verificar concept satisfaction
      */
     ConstraintEvaluationResult checkConceptSatisfaction(const std::string& conceptName,
                                                        const std::string& typeName);
 
+    /**
+     * @brief Deducir argumentos de un template de función (con caché por unidad)
+     */
+    DeductionResult deduceTemplateArguments(const std::string& templateName,
+                                            const std::vector<std::string>& explicitArguments,
+                                            const std::vector<std::string>& argumentTypes) {
+        return instantiationEngine_->deduceTemplateArguments(templateName, explicitArguments, argumentTypes);
+    }
+
     /**
      * @brief Resolver sobrecarga con templates
+     *
+     * argumentTypes son los tipos de los argumentos de la llamada; los
+     * argumentos del template se deducen de ellos. Un template sin
+     * definición de función se instancia con argumentTypes tal cual.
      */
     std::vector<std::unique_ptr<TemplateInstance>> resolveOverload(
         const std::string& functionName,
@@ -300,9 +661,24 @@ public:
         size_t instancesCreated = 0;
         size_t sfinaeFailures = 0;
         size_t constraintChecks = 0;
+        size_t cacheHits = 0;
+        size_t cacheMisses = 0;
+
+        /**
+         * @brief Tasa de aciertos de la caché de instancias (0..1)
+         */
+        double hitRate() const {
+            size_t lookups = cacheHits + cacheMisses;
+            return lookups ? static_cast<double>(cacheHits) / static_cast<double>(lookups) : 0.0;
+        }
     };
     TemplateStats getStats() const;
 
+    /**
+     * @brief Pruebas de sustitución de candidatos (resolución de sobrecarga)
+     */
+    SFINAEHandler& sfinaeHandler() { return *sfinaeHandler_; }
+
 private:
     diagnostics::DiagnosticEngine& diagEngine_;
     std::unique_ptr<ConstraintSolver> constraintSolver_;
@@ -7,6 +7,9 @@
 
 #include <compiler/driver/CompilerDriver.h>
 #include <compiler/backend/codegen/LinkerIntegration.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <filesystem>
@@ -26,9 +29,10 @@ struct TestResult {
     std::vector<std::string> compilerOutput;
     std::vector<std::string> programOutput;
     int exitCode;
+    bool cached;                          // No se ejecutó: sin cambios desde su última pasada
 
     TestResult(const std::string& name)
-        : testName(name), passed(false), executionTime(0), exitCode(0) {}
+        : testName(name), passed(false), executionTime(0), exitCode(0), cached(false) {}
 };
 
 /**
@@ -88,12 +92,15 @@ public:
     ~AcceptanceTestRunner();
 
     /**
-     * @brief Ejecuta todas las pruebas
+     * @brief Ejecuta todas las pruebas del shard configurado
+     *
+     * Las pruebas se reparten entre setJobs() hilos; los resultados salen
+     * en el orden de registro, igual que en una ejecución en serie.
      */
     std::vector<TestResult> runAllTests();
 
     /**
-     * @brief Ejecuta pruebas de una categoría específica
+     * @brief Ejecuta pruebas de una categoría específica (sin mirar el shard)
      */
     std::vector<TestResult> runTestsByCategory(TestCategory category);
 
@@ -115,7 +122,7 @@ public:
     /**
      * @brief Configura el compilador a usar
      */
-    void setCompilerDriver(std::unique_ptr<driver::CompilerDriver> driver);
+    void setCompilerDriver(std::unique_ptr<CompilerDriver> driver);
 
     /**
      * @brief Configura la integración con linker
@@ -132,22 +139,75 @@ public:
      */
     void setRunPrograms(bool run);
 
+    /**
+     * @brief Hilos para ejecutar pruebas (0 = núcleos disponibles)
+     */
+    void setJobs(size_t jobs) { jobs_ = jobs; }
+
+    /**
+     * @brief Limita runAllTests() al shard index de count
+     *
+     * Cada categoría va entera a un shard. El reparto es determinista
+     * (categoría con más pruebas al shard menos cargado), así que todos los
+     * nodos de CI calculan el mismo sin coordinarse.
+     */
+    void setShard(size_t index, size_t count);
+
+    /**
+     * @brief Shard al que pertenece una categoría con el count actual
+     */
+    size_t shardOf(TestCategory category) const;
+
+    /**
+     * @brief Omite pruebas sin cambios desde su última pasada
+     *
+     * La huella de una prueba cubre el contenido de sus fuentes, sus
+     * argumentos y resultados esperados, y el contenido del binario del
+     * compilador: si nada cambió, la prueba se da por pasada sin compilarla
+     * (TestResult::cached). Solo se recuerdan las pruebas que pasan; una que
+     * falla se vuelve a ejecutar siempre.
+     *
+     * @return false si el binario del compilador no se puede leer (la caché
+     *         queda desactivada)
+     */
+    bool setResultCache(const std::filesystem::path& cacheFile,
+                        const std::filesystem::path& compilerBinary);
+
     /**
      * @brief Obtiene estadísticas de las pruebas
      */
     std::unordered_map<TestCategory, size_t> getTestCounts() const;
 
+    static constexpr uint32_t ResultCacheKind = 4;
+
 private:
     std::filesystem::path testDirectory_;
     std::filesystem::path tempDirectory_;
-    std::unique_ptr<driver::CompilerDriver> compilerDriver_;
+    std::unique_ptr<CompilerDriver> compilerDriver_;
     std::unique_ptr<backend::LinkerIntegration> linker_;
     std::chrono::milliseconds globalTimeout_;
     bool runPrograms_;
 
+    size_t jobs_ = 0;
+    size_t shardIndex_ = 0;
+    size_t shardCount_ = 1;
+    std::filesystem::path resultCacheFile_;
+    uint64_t compilerHash_ = 0;
+    std::atomic<uint64_t> tempCounter_{0};
+
     std::vector<std::unique_ptr<AcceptanceTest>> tests_;
     std::unordered_map<std::string, size_t> testIndex_;
 
+    /**
+     * @brief Ejecuta las pruebas en paralelo pasando por la caché de resultados
+     */
+    std::vector<TestResult> runTests(const std::vector<const AcceptanceTest*>& tests);
+
+    /**
+     * @brief Huella de las entradas de una prueba y del compilador
+     */
+    uint64_t testFingerprint(const AcceptanceTest& test) const;
+
     /**
      * @brief Inicializa las pruebas de aceptación
      */
@@ -231,7 +291,7 @@ private:
     void cleanupTempFiles(const std::vector<std::filesystem::path>& files);
 
     /**
-     * @brief Genera nombre de archivo temporal
+     * @brief Genera nombre de archivo temporal (único aunque se llame desde varios hilos)
      */
     std::filesystem::path generateTempFileName(const std::string& prefix,
                                              const std::string& extension);
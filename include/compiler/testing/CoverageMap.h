@@ -0,0 +1,98 @@
+/**
+ * @file CoverageMap.h
+ * @brief Cobertura de aristas de SanitizerCoverage para el fuzzing guiado
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace cpp20::compiler::testing {
+
+/**
+ * @brief Contadores de aristas de una ejecución, propios de un hilo
+ *
+ * Solo cuentan mientras hay un CoverageScope activo en el hilo, así que
+ * cada trabajador del fuzzer ve únicamente las aristas de su entrada.
+ */
+class CoverageTrace {
+public:
+    CoverageTrace();
+
+    void reset();
+
+    const std::vector<uint8_t>& counters() const { return counters_; }
+
+    /**
+     * @brief Firma de la ejecución: arista * 8 + intervalo, en orden creciente
+     *
+     * Dos entradas con la misma firma son equivalentes para el fuzzer; es
+     * lo que CorpusManager usa para deduplicar y minimizar.
+     */
+    std::vector<uint32_t> features() const;
+
+private:
+    friend class CoverageScope;
+    std::vector<uint8_t> counters_;
+};
+
+/**
+ * @brief Activa un CoverageTrace en el hilo actual durante su vida
+ */
+class CoverageScope {
+public:
+    explicit CoverageScope(CoverageTrace& trace);
+    ~CoverageScope();
+
+    CoverageScope(const CoverageScope&) = delete;
+    CoverageScope& operator=(const CoverageScope&) = delete;
+
+private:
+    uint8_t* previousCounters_;
+    size_t previousSize_;
+};
+
+/**
+ * @brief Aristas vistas por todos los trabajadores
+ *
+ * El código compilado con -fsanitize-coverage=trace-pc-guard (opción
+ * CPP20_COMPILER_FUZZ_COVERAGE, solo Clang) numera sus aristas al
+ * arrancar; sin instrumentar edgeCount() es 0 y merge() nunca encuentra
+ * nada nuevo. Como en AFL, el número de pasos por una arista se agrupa en
+ * 8 intervalos (1, 2, 3, 4-7, 8-15, 16-31, 32-127, 128+): un intervalo no
+ * visto antes también cuenta como cobertura nueva.
+ */
+class CoverageMap {
+public:
+    CoverageMap();
+
+    /**
+     * @brief Aristas instrumentadas en el proceso
+     */
+    static size_t edgeCount();
+
+    static bool isInstrumented() { return edgeCount() > 0; }
+
+    /**
+     * @brief Añade una ejecución; devuelve los pares (arista, intervalo) nuevos
+     *
+     * Seguro entre hilos.
+     */
+    size_t merge(const CoverageTrace& trace);
+
+    /**
+     * @brief Aristas alcanzadas al menos una vez
+     */
+    size_t coveredEdges() const { return coveredEdges_.load(std::memory_order_relaxed); }
+
+private:
+    size_t size_;
+    std::unique_ptr<std::atomic<uint8_t>[]> seen_;     // Intervalos vistos por arista
+    std::atomic<size_t> coveredEdges_{0};
+};
+
+} // namespace cpp20::compiler::testing
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <compiler/testing/CoverageMap.h>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -12,6 +13,7 @@
 #include <random>
 #include <filesystem>
 #include <chrono>
+#include <mutex>
 
 namespace cpp20::compiler::testing {
 
@@ -50,10 +52,11 @@ struct FuzzResult {
     bool isCrash;                        // Si fue un crash
     bool isHang;                         // Si fue un hang
     size_t inputSize;                    // Tamaño del input
+    size_t newCoverage;                  // Pares (arista, intervalo) nuevos que alcanzó
 
     FuzzResult(const std::string& inp = "", FuzzTarget tgt = FuzzTarget::Lexer)
         : input(inp), target(tgt), executionTime(0), isCrash(false),
-          isHang(false), inputSize(inp.size()) {}
+          isHang(false), inputSize(inp.size()), newCoverage(0) {}
 };
 
 /**
@@ -65,12 +68,16 @@ struct FuzzStatistics {
     size_t hangsFound;                   // Número de hangs encontrados
     size_t uniqueCrashes;                // Crashes únicos
     size_t coverageIncrease;             // Aumento de cobertura
+    size_t edgesCovered;                 // Aristas alcanzadas (con SanitizerCoverage)
+    size_t corpusSize;                   // Entradas del corpus compartido al terminar
+    double execsPerSecond;               // Ejecuciones por segundo de reloj, todos los trabajadores
     std::chrono::milliseconds totalTime; // Tiempo total
     std::unordered_map<std::string, size_t> errorCounts; // Conteo por tipo de error
 
     FuzzStatistics()
         : totalInputs(0), crashesFound(0), hangsFound(0), uniqueCrashes(0),
-          coverageIncrease(0), totalTime(0) {}
+          coverageIncrease(0), edgesCovered(0), corpusSize(0), execsPerSecond(0),
+          totalTime(0) {}
 };
 
 /**
@@ -154,6 +161,26 @@ private:
      */
     std::string generateRandomLiteral();
 
+    /**
+     * @brief Genera directivas de preprocesador
+     */
+    std::string generatePreprocessorInput(size_t complexity);
+
+    /**
+     * @brief Genera templates y su uso para el análisis semántico
+     */
+    std::string generateSemanticInput(size_t complexity);
+
+    /**
+     * @brief Genera clases con herencia y funciones virtuales
+     */
+    std::string generateCodeGenInput(size_t complexity);
+
+    /**
+     * @brief Genera un programa que recorre todas las fases
+     */
+    std::string generateFullPipelineInput(size_t complexity);
+
     /**
      * @brief Aplica mutaciones al input
      */
@@ -182,6 +209,14 @@ private:
 
 /**
  * @brief Ejecutor de fuzzing
+ *
+ * Los targets se ejecutan dentro del proceso: cada entrada recibe un
+ * SourceManager, un DiagnosticEngine sin consumidores y una tabla de
+ * identificadores nuevos, así que nada de una ejecución llega a la
+ * siguiente. Semantic, CodeGen y FullPipeline recorren el front-end
+ * completo (preprocesador y parser): el back-end aún no tiene una entrada
+ * desde el AST. Un fallo de memoria termina el proceso, igual que en
+ * libFuzzer; las excepciones se registran como crash.
  */
 class FuzzExecutor {
 public:
@@ -225,8 +260,15 @@ public:
 
     /**
      * @brief Minimiza input que causa crash
+     *
+     * Delta debugging (ddmin) sobre bytes: en cada ronda se prueban los
+     * trozos y sus complementos, hasta `jobs` a la vez, y se queda el
+     * candidato de menor índice que reproduce el mismo tipo de error, así
+     * que el resultado no depende del número de hilos. El ejecutor no
+     * guarda estado entre ejecuciones, por eso puede compartirse.
      */
-    std::string minimizeInput(const std::string& crashingInput, FuzzTarget target);
+    std::string minimizeInput(const std::string& crashingInput, FuzzTarget target,
+                              size_t jobs = 1);
 
 private:
     /**
@@ -260,22 +302,14 @@ private:
     FuzzResult fuzzFullPipeline(const std::string& input);
 
     /**
-     * @brief Ejecuta comando con captura de salida
-     */
-    std::tuple<std::string, int, std::chrono::milliseconds> executeCommand(
-        const std::string& command, std::chrono::milliseconds timeout);
-
-    /**
-     * @brief Verifica que la salida es razonable
+     * @brief Lexer, preprocesador y parser en proceso, según se pidan
      */
-    bool validateOutput(const std::string& output, int exitCode);
-
-    /**
-     * @brief Detecta patrones de error comunes
-     */
-    std::string detectErrorPattern(const std::string& output, int exitCode);
+    FuzzResult runFrontend(const std::string& input, FuzzTarget target,
+                           bool preprocess, bool parse);
 };
 
+class CorpusManager;
+
 /**
  * @brief Motor principal de fuzzing
  */
@@ -335,7 +369,32 @@ public:
      */
     void setSeed(size_t seed);
 
+    /**
+     * @brief Trabajadores en paralelo (1 por defecto)
+     *
+     * Cada uno tiene su generador (semilla + índice) y su ejecutor, y
+     * comparten el corpus y el mapa de cobertura: una entrada que alcanza
+     * aristas nuevas en un trabajador se puede mutar en todos.
+     */
+    void setWorkers(size_t workers) { workers_ = workers > 0 ? workers : 1; }
+
+    /**
+     * @brief Corpus compartido: semillas cargadas y entradas con cobertura nueva
+     */
+    const CorpusManager& getCorpus() const { return *corpus_; }
+
+    /**
+     * @brief Deduplica y minimiza el corpus; devuelve las entradas eliminadas
+     *
+     * Las entradas sin firma de cobertura (semillas cargadas) se ejecutan
+     * una vez en los trabajadores para obtenerla. No debe llamarse durante
+     * runFuzzing().
+     */
+    size_t minimizeCorpus();
+
 private:
+    struct Worker;
+
     FuzzTarget target_;
     FuzzStrategy strategy_;
     size_t maxInputSize_;
@@ -343,11 +402,15 @@ private:
     double mutationRate_;
     bool verbose_;
     size_t seed_;
+    size_t workers_ = 1;
 
     FuzzStatistics statistics_;
     std::vector<FuzzResult> crashes_;
     std::unique_ptr<FuzzInputGenerator> inputGenerator_;
     std::unique_ptr<FuzzExecutor> executor_;
+    std::unique_ptr<CorpusManager> corpus_;
+    std::unique_ptr<CoverageMap> coverage_;
+    std::mutex resultMutex_;              // Estadísticas y crashes entre trabajadores
 
     /**
      * @brief Inicializa generadores
@@ -355,9 +418,14 @@ private:
     void initializeGenerators();
 
     /**
-     * @brief Ejecuta una iteración de fuzzing
+     * @brief Ejecuta una iteración de fuzzing en un trabajador
      */
-    FuzzResult runIteration(size_t iteration);
+    FuzzResult runIteration(Worker& worker);
+
+    /**
+     * @brief Genera la siguiente entrada según la estrategia
+     */
+    std::string nextInput(Worker& worker);
 
     /**
      * @brief Procesa resultado de fuzzing
@@ -398,11 +466,14 @@ private:
 
 /**
  * @brief Gestor de corpus de fuzzing
+ *
+ * Seguro entre hilos salvo getAllEntries(), que no debe usarse mientras
+ * haya trabajadores añadiendo entradas.
  */
 class CorpusManager {
 public:
     /**
-     * @brief Constructor
+     * @brief Constructor; con un directorio vacío el corpus solo vive en memoria
      */
     CorpusManager(const std::filesystem::path& corpusDir);
 
@@ -423,23 +494,62 @@ public:
 
     /**
      * @brief Añade entrada al corpus
+     *
+     * features es la firma de cobertura (CoverageTrace::features()); vacía
+     * si no se conoce.
      */
-    void addEntry(const std::string& entry, const std::string& metadata = "");
+    void addEntry(const std::string& entry, const std::string& metadata = "",
+                  std::vector<uint32_t> features = {});
+
+    /**
+     * @brief Asigna la firma de cobertura de la entrada index
+     */
+    void setFeatures(size_t index, std::vector<uint32_t> features);
 
     /**
      * @brief Obtiene entrada aleatoria
      */
     std::string getRandomEntry();
 
+    /**
+     * @brief Entrada index (vacía si no existe)
+     */
+    std::string getEntry(size_t index) const;
+
+    /**
+     * @brief Número de entradas
+     */
+    size_t size() const;
+
     /**
      * @brief Obtiene todas las entradas
      */
     const std::vector<std::string>& getAllEntries() const { return entries_; }
 
     /**
-     * @brief Elimina entradas duplicadas
+     * @brief Firmas de cobertura, paralelas a getAllEntries()
+     */
+    const std::vector<std::vector<uint32_t>>& getAllFeatures() const { return features_; }
+
+    /**
+     * @brief Elimina entradas duplicadas; devuelve cuántas se quitaron
+     *
+     * Primero por contenido y después por firma de cobertura: de las
+     * entradas con la misma firma se queda la más corta. Ambas pasadas son
+     * lineales (tablas hash) y conservan el orden del corpus.
      */
-    void deduplicate();
+    size_t deduplicate();
+
+    /**
+     * @brief Elimina entradas redundantes; devuelve cuántas se quitaron
+     *
+     * Set cover voraz sobre las firmas: se elige la entrada que cubre más
+     * pares (arista, intervalo) aún sin cubrir, con la más corta en caso
+     * de empate, hasta cubrir todos. Las ganancias solo bajan, así que se
+     * recalculan de forma perezosa al sacar cada entrada del heap. Las
+     * entradas sin firma se conservan siempre.
+     */
+    size_t minimizeCorpus();
 
     /**
      * @brief Obtiene estadísticas del corpus
@@ -450,21 +560,28 @@ private:
     std::filesystem::path corpusDir_;
     std::vector<std::string> entries_;
     std::vector<std::string> metadata_;
+    std::vector<std::vector<uint32_t>> features_;
+    mutable std::mutex mutex_;
 
     /**
      * @brief Calcula hash de entrada
      */
     std::string calculateEntryHash(const std::string& entry) const;
 
+    /**
+     * @brief Tamaño total en bytes de las entradas
+     */
+    size_t calculateCacheSize() const;
+
     /**
      * @brief Verifica integridad del corpus
      */
     bool validateCorpus() const;
 
     /**
-     * @brief Minimiza corpus eliminando entradas redundantes
+     * @brief Conserva solo las entradas marcadas en keep
      */
-    void minimizeCorpus();
+    void retain(const std::vector<bool>& keep);
 };
 
 /**
@@ -489,6 +606,9 @@ public:
 
     /**
      * @brief Calcula distancia de edición entre dos strings
+     *
+     * Descarta el prefijo y el sufijo comunes y guarda una sola fila:
+     * memoria O(min(n, m)).
      */
     static size_t editDistance(const std::string& s1, const std::string& s2);
 
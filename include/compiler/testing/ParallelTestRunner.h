@@ -0,0 +1,121 @@
+/**
+ * @file ParallelTestRunner.h
+ * @brief Ejecución de tests en procesos aislados, en paralelo y con el más lento primero
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cpp20::compiler::testing {
+
+/**
+ * @brief Ejecutor de tests como procesos independientes
+ *
+ * Cada test es una línea de comandos (para Google Test, el ejecutable con
+ * --gtest_filter=Suite.Test): un crash o un cuelgue solo afecta a ese
+ * test, y al vencer su timeout se mata su grupo de procesos. Los tests se
+ * reparten entre jobs procesos simultáneos en orden de duración registrada
+ * decreciente, de modo que el más lento no empieza al final y alarga el
+ * tiempo total; los que no tienen historial van primero. El historial
+ * persiste en un archivo de caché entre ejecuciones.
+ */
+class ParallelTestRunner {
+public:
+    static constexpr uint32_t FileKind = 8;
+
+    struct Test {
+        std::string name;                       // Clave del historial (Suite.Test)
+        std::vector<std::string> command;       // Programa y argumentos
+        std::chrono::milliseconds timeout{std::chrono::seconds(60)};
+    };
+
+    enum class Outcome : uint8_t {
+        Passed,
+        Failed,         // Código de salida distinto de 0, señal o fallo al lanzarlo
+        TimedOut
+    };
+
+    struct Result {
+        std::string name;
+        Outcome outcome = Outcome::Failed;
+        int exitCode = -1;                      // -señal si murió por una señal
+        std::chrono::milliseconds duration{0};
+        uint64_t peakMemoryBytes = 0;           // Pico de memoria residente del proceso
+        std::string output;                     // stdout y stderr (el final, si es largo)
+    };
+
+    /**
+     * @param jobs Procesos simultáneos (0 = ThreadPool::defaultThreadCount())
+     */
+    explicit ParallelTestRunner(size_t jobs = 0);
+
+    void addTest(Test test);
+
+    /**
+     * @brief Añadir cada test de un ejecutable de Google Test como un proceso
+     *
+     * Los tests se listan con --gtest_list_tests; los DISABLED_ se omiten.
+     * @return Tests añadidos (0 si el ejecutable no los pudo listar)
+     */
+    size_t addGoogleTests(const std::filesystem::path& executable,
+                          std::chrono::milliseconds timeout = std::chrono::seconds(60));
+
+    /**
+     * @brief Timeout de los tests cuyo nombre empieza por prefix (el prefijo más largo gana)
+     *
+     * Es el presupuesto de tiempo de esos tests: uno que lo supera falla como TimedOut.
+     */
+    void setTimeout(std::string prefix, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Orden de ejecución: sin historial primero, luego por duración registrada decreciente
+     */
+    std::vector<const Test*> schedule() const;
+
+    /**
+     * @brief Ejecutar todos los tests y registrar sus duraciones en el historial
+     * @return Resultados en el orden en que se añadieron los tests
+     */
+    std::vector<Result> run();
+
+    /**
+     * @brief Ejecutar un único test en su propio proceso
+     */
+    static Result runIsolated(const Test& test);
+
+    bool loadHistory(const std::filesystem::path& file);
+    bool saveHistory(const std::filesystem::path& file) const;
+
+    /**
+     * @brief Duración registrada de un test (nullptr si no hay)
+     */
+    const std::chrono::milliseconds* recordedDuration(const std::string& name) const;
+
+    /**
+     * @brief Informe JSON: tiempo y pico de memoria por test, el más lento primero
+     */
+    static std::string formatJSON(const std::vector<Result>& results, std::chrono::milliseconds wallTime);
+
+    static std::string_view outcomeName(Outcome outcome);
+
+    size_t size() const { return tests_.size(); }
+    size_t jobs() const { return jobs_; }
+
+private:
+    size_t jobs_;
+    std::vector<Test> tests_;
+    std::vector<std::pair<std::string, std::chrono::milliseconds>> timeouts_; // Por prefijo
+    std::unordered_map<std::string, std::chrono::milliseconds> history_;
+
+    std::chrono::milliseconds timeoutFor(const Test& test) const;
+};
+
+} // namespace cpp20::compiler::testing
@@ -0,0 +1,86 @@
+/**
+ * @file ProjectGenerator.h
+ * @brief Proyectos sintéticos de tamaño y forma controlados para medir escalado
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace cpp20::compiler::testing {
+
+/**
+ * @brief Parámetros de forma del proyecto generado
+ */
+struct ProjectShape {
+    size_t translationUnits = 16;           // N: unidades .cpp
+    size_t includeDepth = 4;                // D: cabeceras encadenadas que incluye cada unidad
+    size_t templates = 8;                   // M: templates de función
+    size_t instantiationsPerTemplate = 4;   // K: argumentos distintos de cada template
+    size_t constexprFunctions = 4;          // Funciones constexpr con bucle
+    size_t constexprIterations = 1000;      // Iteraciones de cada evaluación constexpr
+    size_t moduleWidth = 0;                 // Módulos por nivel (0 = sin módulos)
+    size_t moduleDepth = 0;                 // Niveles del grafo de módulos
+    size_t fillerComplexity = 0;            // Declaraciones de FuzzInputGenerator por unidad
+    size_t seed = 1;
+};
+
+/**
+ * @brief Archivo generado, con la ruta relativa a la raíz del proyecto
+ */
+struct GeneratedFile {
+    enum class Kind { Header, ModuleInterface, Source };
+
+    std::filesystem::path path;
+    std::string content;
+    Kind kind;
+};
+
+/**
+ * @brief Genera proyectos paramétricos deterministas
+ *
+ * La misma forma produce siempre los mismos archivos. Cada unidad incluye
+ * la cadena include/chain0.h .. chain<D-1>.h (con guardas) y las cabeceras
+ * de templates y constexpr. Las K instanciaciones de cada template se
+ * reparten entre las unidades en turno rotatorio, de modo que el total es
+ * M * K sea cual sea N. El módulo m<nivel>_<i> importa todos los del nivel
+ * siguiente, y las unidades importan los del nivel 0.
+ *
+ * Con fillerComplexity > 0 cada unidad añade declaraciones de
+ * FuzzInputGenerator::generateGrammarBasedInput con semilla propia: sirven
+ * de ruido para el lexer y el parser, no tienen por qué ser semánticamente
+ * válidas.
+ */
+class ProjectGenerator {
+public:
+    explicit ProjectGenerator(ProjectShape shape) : shape_(shape) {}
+
+    /**
+     * @brief Archivos del proyecto; los módulos van de las hojas a la raíz
+     */
+    std::vector<GeneratedFile> generate() const;
+
+    /**
+     * @brief Escribe el proyecto bajo root junto con sources.txt
+     *
+     * sources.txt lista las interfaces de módulo y las unidades en orden de
+     * compilación, una por línea.
+     */
+    bool write(const std::filesystem::path& root, std::string* error = nullptr) const;
+
+    const ProjectShape& shape() const { return shape_; }
+
+private:
+    ProjectShape shape_;
+
+    std::string makeChainHeader(size_t level) const;
+    std::string makeTemplatesHeader() const;
+    std::string makeConstexprHeader() const;
+    std::string makeModule(size_t level, size_t index) const;
+    std::string makeUnit(size_t unit) const;
+};
+
+} // namespace cpp20::compiler::testing
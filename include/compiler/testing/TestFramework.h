@@ -9,6 +9,9 @@
 #include <compiler/backend/codegen/LinkerIntegration.h>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <map>
+#include <optional>
 #include <unordered_map>
 #include <memory>
 #include <filesystem>
@@ -209,7 +212,7 @@ public:
     /**
      * @brief Configura compilador para tests
      */
-    void setCompilerDriver(std::unique_ptr<driver::CompilerDriver> driver);
+    void setCompilerDriver(std::unique_ptr<CompilerDriver> driver);
 
     /**
      * @brief Configura linker para tests
@@ -220,7 +223,7 @@ private:
     std::vector<std::unique_ptr<TestSuite>> suites_;
     std::unordered_map<std::string, size_t> suiteIndex_;
     std::filesystem::path outputDirectory_;
-    std::unique_ptr<driver::CompilerDriver> compilerDriver_;
+    std::unique_ptr<CompilerDriver> compilerDriver_;
     std::unique_ptr<backend::LinkerIntegration> linker_;
 
     /**
@@ -229,8 +232,44 @@ private:
     void updateSuiteIndex();
 };
 
+/**
+ * @brief Métricas de rendimiento de un golden test
+ *
+ * Los nombres siguen la telemetría: "compile.ms", "memory.peak_bytes",
+ * "code.text_bytes" y "code.function_bytes.<símbolo>". En disco van en
+ * <test>.perf junto al .golden, una línea "nombre valor" por métrica.
+ */
+struct PerformanceMetrics {
+    std::map<std::string, double> values;   // Ordenado: archivos estables entre ejecuciones
+
+    std::string format() const;
+
+    /**
+     * @return nullopt si alguna línea no es "nombre valor"
+     */
+    static std::optional<PerformanceMetrics> parse(std::string_view text);
+};
+
+/**
+ * @brief Margen relativo admitido por familia de métricas (0.10 = 10%)
+ *
+ * El código generado es determinista y por defecto no admite crecer; el
+ * tiempo lleva además un margen absoluto para que un test de pocos
+ * milisegundos no falle por el ruido del reloj.
+ */
+struct PerformanceTolerance {
+    double compileTime = 0.25;          // compile.*
+    double compileTimeSlackMs = 5.0;
+    double memory = 0.10;               // memory.*
+    double codeSize = 0.0;              // code.*
+};
+
 /**
  * @brief Ejecutor de golden tests
+ *
+ * Un test con <test>.perf además tiene presupuesto de rendimiento: falla
+ * si una métrica supera la guardada en más del margen de su familia.
+ * Mejorar no falla; recordPerformance() vuelve a fijar el presupuesto.
  */
 class GoldenTestRunner {
 public:
@@ -261,9 +300,48 @@ public:
     bool compareWithReference(const std::string& output,
                              const std::filesystem::path& referenceFile);
 
+    /**
+     * @brief Compila el test con nuestro compilador y mide sus métricas
+     *
+     * El tiempo es el mínimo de setTimingRepetitions() compilaciones y la
+     * memoria, el pico de MemoryTracker durante la primera. Las métricas
+     * code.* salen del objeto COFF que deja la compilación (objectFileFor):
+     * el tamaño de las secciones .text* y, por función, la distancia hasta
+     * el siguiente símbolo de su sección.
+     */
+    PerformanceMetrics measurePerformance(const std::filesystem::path& testFile);
+
+    /**
+     * @brief Escribe <test>.perf con las métricas actuales de cada test
+     */
+    bool recordPerformance(const std::vector<std::filesystem::path>& testFiles);
+
+    /**
+     * @brief Métricas de budget que actual supera en más del margen
+     *
+     * Una métrica que ya no se produce (una función eliminada) no cuenta
+     * como regresión. Devuelve una línea legible por cada una.
+     */
+    static std::vector<std::string> checkPerformance(const PerformanceMetrics& budget,
+                                                     const PerformanceMetrics& actual,
+                                                     const PerformanceTolerance& tolerance);
+
+    void setPerformanceTolerance(const PerformanceTolerance& tolerance) { tolerance_ = tolerance; }
+
+    void setTimingRepetitions(size_t repetitions) { timingRepetitions_ = repetitions > 0 ? repetitions : 1; }
+
+    /**
+     * @brief Objeto que deja nuestra compilación del test
+     */
+    std::filesystem::path objectFileFor(const std::filesystem::path& testFile) const;
+
 private:
     std::filesystem::path testDataDir_;
     std::filesystem::path referenceCompilerPath_;
+    PerformanceTolerance tolerance_;
+    size_t timingRepetitions_ = 3;
+
+    std::filesystem::path performanceFileFor(const std::filesystem::path& testFile) const;
 
     /**
      * @brief Compila con compilador de referencia
@@ -6,6 +6,8 @@
 
 namespace cpp20::compiler::types {
 
+class TypeContext;
+
 /**
  * @brief Categorías de valor de C++
  */
@@ -63,12 +65,115 @@ public:
     virtual bool equals(const Type* other) const = 0;
     bool compatible(const Type* other) const;
 
+    /**
+     * @brief Verificar si el tipo es la instancia única de un TypeContext
+     *
+     * Dos tipos canónicos son iguales si y solo si son el mismo puntero.
+     */
+    bool isCanonical() const { return canonical_; }
+
     // Modificadores
     virtual std::unique_ptr<Type> withCV(CVQualifier cv) const = 0;
 
 private:
+    friend class TypeContext;
+
     Kind kind_;
     CVQualifier cv_;
+    bool canonical_ = false;
+};
+
+/**
+ * @brief Igualdad de tipos: comparación de punteros si ambos son canónicos
+ */
+inline bool isSameType(const Type* a, const Type* b) {
+    if (a == b) return true;
+    if (!a || !b || (a->isCanonical() && b->isCanonical())) return false;
+    return a->equals(b);
+}
+
+/**
+ * @brief Tipo fundamental (void, bool, char, int, float...)
+ */
+class BasicType : public Type {
+public:
+    enum class BasicKind {
+        Void,
+        Bool,
+        Char,
+        Short,
+        Int,
+        Long,
+        LongLong,
+        Float,
+        Double,
+        LongDouble
+    };
+
+    static constexpr size_t BasicKindCount = static_cast<size_t>(BasicKind::LongDouble) + 1;
+
+    BasicType(BasicKind basicKind, CVQualifier cv = CVQualifier::None)
+        : Type(Kind::Basic, cv), basicKind_(basicKind) {}
+
+    BasicKind basicKind() const { return basicKind_; }
+
+    std::string toString() const override;
+    size_t size() const override;
+    size_t alignment() const override;
+    bool isComplete() const override;
+    bool equals(const Type* other) const override;
+    std::unique_ptr<Type> withCV(CVQualifier cv) const override;
+
+private:
+    BasicKind basicKind_;
+};
+
+/**
+ * @brief Tipo puntero T* (no posee el tipo apuntado)
+ */
+class PointerType : public Type {
+public:
+    PointerType(const Type* pointee, CVQualifier cv = CVQualifier::None)
+        : Type(Kind::Pointer, cv), pointee_(pointee) {}
+
+    const Type* pointee() const { return pointee_; }
+
+    std::string toString() const override;
+    size_t size() const override { return 8; }
+    size_t alignment() const override { return 8; }
+    bool isComplete() const override { return true; }
+    bool equals(const Type* other) const override;
+    std::unique_ptr<Type> withCV(CVQualifier cv) const override;
+
+private:
+    const Type* pointee_;
+};
+
+/**
+ * @brief Tipo referencia T& o T&& (no posee el tipo referido)
+ */
+class ReferenceType : public Type {
+public:
+    ReferenceType(const Type* referee, bool isRValue = false)
+        : Type(Kind::Reference), referee_(referee), isRValue_(isRValue) {}
+
+    const Type* referee() const { return referee_; }
+    bool isRValue() const { return isRValue_; }
+
+    std::string toString() const override;
+    size_t size() const override { return referee_ ? referee_->size() : 0; }
+    size_t alignment() const override { return referee_ ? referee_->alignment() : 0; }
+    bool isComplete() const override { return referee_ && referee_->isComplete(); }
+    bool equals(const Type* other) const override;
+
+    /**
+     * @brief Las referencias no admiten calificadores: devuelve una copia
+     */
+    std::unique_ptr<Type> withCV(CVQualifier cv) const override;
+
+private:
+    const Type* referee_;
+    bool isRValue_;
 };
 
 /**
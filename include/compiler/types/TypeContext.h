@@ -0,0 +1,96 @@
+#pragma once
+
+#include <compiler/types/Type.h>
+#include <compiler/common/utils/MemoryTracker.h>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace cpp20::compiler::types {
+
+/**
+ * @brief Propietario de los tipos canónicos de una unidad de traducción
+ *
+ * Cada combinación de tipo base, calificadores CV y derivación (puntero,
+ * referencia) se crea una sola vez, así que la igualdad es una
+ * comparación de punteros y el puntero sirve directamente como hash. Los
+ * tipos viven tanto como el contexto. No es thread-safe: se usa un
+ * contexto por unidad.
+ */
+class TypeContext {
+public:
+    TypeContext();
+
+    TypeContext(const TypeContext&) = delete;
+    TypeContext& operator=(const TypeContext&) = delete;
+
+    /**
+     * @brief Tipo fundamental con calificadores
+     */
+    const BasicType* getBasicType(BasicType::BasicKind kind, CVQualifier cv = CVQualifier::None) const {
+        return basicTypes_[static_cast<size_t>(kind) * 4 + static_cast<size_t>(cv)];
+    }
+
+    /**
+     * @brief Puntero a pointee (se canonicaliza si no lo es)
+     */
+    const PointerType* getPointerType(const Type* pointee, CVQualifier cv = CVQualifier::None);
+
+    /**
+     * @brief Referencia a referee (T& o T&&)
+     */
+    const ReferenceType* getReferenceType(const Type* referee, bool isRValue = false);
+
+    /**
+     * @brief Mismo tipo con otros calificadores CV (las referencias no cambian)
+     */
+    const Type* getQualifiedType(const Type* type, CVQualifier cv);
+
+    /**
+     * @brief Instancia canónica de un tipo creado fuera del contexto
+     *
+     * Los tipos canónicos se devuelven tal cual; los de un tipo que el
+     * contexto todavía no sabe unificar también.
+     */
+    const Type* getCanonicalType(const Type* type);
+
+    /**
+     * @brief Número de tipos distintos creados
+     */
+    size_t typeCount() const { return storage_.size(); }
+
+private:
+    struct Key {
+        Type::Kind kind;
+        CVQualifier cv;
+        bool isRValue;
+        const Type* element;
+
+        bool operator==(const Key& other) const {
+            return kind == other.kind && cv == other.cv && isRValue == other.isRValue &&
+                   element == other.element;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    template<typename T, typename... Args>
+    const T* create(Args&&... args) {
+        common::utils::MemoryScope scope(common::utils::MemorySubsystem::Types);
+        auto type = std::make_unique<T>(std::forward<Args>(args)...);
+        type->canonical_ = true;
+        const T* result = type.get();
+        storage_.push_back(std::move(type));
+        return result;
+    }
+
+    std::array<const BasicType*, BasicType::BasicKindCount * 4> basicTypes_{};
+    std::unordered_map<Key, const Type*, KeyHash> derivedTypes_;
+    std::vector<std::unique_ptr<Type>> storage_;
+};
+
+} // namespace cpp20::compiler::types
@@ -4,6 +4,7 @@
  */
 
 #include <compiler/ast/ASTNode.h>
+#include <compiler/ast/ASTVisitor.h>
 
 namespace cpp20::compiler::ast {
 
@@ -11,48 +12,79 @@ namespace cpp20::compiler::ast {
 // ASTNode implementation
 // ========================================================================
 
-// Constructor y destructor ya están definidos inline en el header
-
-// ========================================================================
-// TranslationUnit implementation
-// ========================================================================
-
-// Constructor ya está definido inline en el header
-
-void TranslationUnit::accept(ASTVisitor* visitor) {
-    if (visitor) {
-        visitor->visit(this);
+std::string ASTNode::toString() const {
+    switch (kind_) {
+#define CPP20_AST_TO_STRING_CASE(Kind, Class) \
+        case ASTNodeKind::Kind: \
+            return static_cast<const Class*>(this)->toString();
+        CPP20_AST_NODE_CLASSES(CPP20_AST_TO_STRING_CASE)
+#undef CPP20_AST_TO_STRING_CASE
+        default:
+            return nodeKindName(kind_);
     }
 }
 
-std::string TranslationUnit::toString() const {
-    return "TranslationUnit(" + std::to_string(declarations_.size()) + " declarations)";
-}
-
-// ========================================================================
-// ASTVisitor implementation
-// ========================================================================
-
-void ASTVisitor::visitChildren(ASTNode* node) {
-    // Base implementation - override in derived classes
-    (void)node;
-}
-
-void ASTVisitor::visitNode(ASTNode* node) {
-    if (node) {
-        node->accept(this);
+const char* nodeKindName(ASTNodeKind kind) {
+    switch (kind) {
+        case ASTNodeKind::Literal: return "Literal";
+        case ASTNodeKind::IntegerLiteral: return "IntegerLiteral";
+        case ASTNodeKind::FloatingPointLiteral: return "FloatingPointLiteral";
+        case ASTNodeKind::CharacterLiteral: return "CharacterLiteral";
+        case ASTNodeKind::StringLiteral: return "StringLiteral";
+        case ASTNodeKind::BooleanLiteral: return "BooleanLiteral";
+        case ASTNodeKind::Identifier: return "Identifier";
+        case ASTNodeKind::BinaryOp: return "BinaryOp";
+        case ASTNodeKind::UnaryOp: return "UnaryOp";
+        case ASTNodeKind::FunctionCall: return "FunctionCall";
+        case ASTNodeKind::MemberAccess: return "MemberAccess";
+        case ASTNodeKind::ArrayAccess: return "ArrayAccess";
+        case ASTNodeKind::Cast: return "Cast";
+        case ASTNodeKind::TernaryOp: return "TernaryOp";
+        case ASTNodeKind::Lambda: return "Lambda";
+        case ASTNodeKind::New: return "New";
+        case ASTNodeKind::Delete: return "Delete";
+        case ASTNodeKind::Assignment: return "Assignment";
+        case ASTNodeKind::VariableDecl: return "VariableDecl";
+        case ASTNodeKind::FunctionDecl: return "FunctionDecl";
+        case ASTNodeKind::ParameterDecl: return "ParameterDecl";
+        case ASTNodeKind::ClassDecl: return "ClassDecl";
+        case ASTNodeKind::EnumDecl: return "EnumDecl";
+        case ASTNodeKind::UsingDecl: return "UsingDecl";
+        case ASTNodeKind::TypeAliasDecl: return "TypeAliasDecl";
+        case ASTNodeKind::CompoundStmt: return "CompoundStmt";
+        case ASTNodeKind::ExprStmt: return "ExprStmt";
+        case ASTNodeKind::IfStmt: return "IfStmt";
+        case ASTNodeKind::WhileStmt: return "WhileStmt";
+        case ASTNodeKind::ForStmt: return "ForStmt";
+        case ASTNodeKind::ReturnStmt: return "ReturnStmt";
+        case ASTNodeKind::BreakStmt: return "BreakStmt";
+        case ASTNodeKind::ContinueStmt: return "ContinueStmt";
+        case ASTNodeKind::SwitchStmt: return "SwitchStmt";
+        case ASTNodeKind::CaseStmt: return "CaseStmt";
+        case ASTNodeKind::DefaultStmt: return "DefaultStmt";
+        case ASTNodeKind::TranslationUnit: return "TranslationUnit";
+        case ASTNodeKind::NamespaceDecl: return "NamespaceDecl";
+        case ASTNodeKind::TemplateDecl: return "TemplateDecl";
+        case ASTNodeKind::ConceptDecl: return "ConceptDecl";
+        case ASTNodeKind::RequiresExpr: return "RequiresExpr";
+        case ASTNodeKind::TemplateParameter: return "TemplateParameter";
+        case ASTNodeKind::TemplateParameterList: return "TemplateParameterList";
+        case ASTNodeKind::TemplateArgument: return "TemplateArgument";
+        case ASTNodeKind::TemplateArgumentList: return "TemplateArgumentList";
+        case ASTNodeKind::TemplateInstantiation: return "TemplateInstantiation";
+        case ASTNodeKind::TemplateSpecialization: return "TemplateSpecialization";
+        case ASTNodeKind::RequiresClause: return "RequiresClause";
+        case ASTNodeKind::ConstraintExpr: return "ConstraintExpr";
     }
+    return "Unknown";
 }
 
 // ========================================================================
-// ASTVisitor visit methods (placeholders)
+// TranslationUnit implementation
 // ========================================================================
 
-void ASTVisitor::visit(TranslationUnit* node) {
-    // Visit children
-    for (const auto& decl : node->declarations()) {
-        visitNode(decl.get());
-    }
+std::string TranslationUnit::toString() const {
+    return "TranslationUnit(" + std::to_string(declarations_.size()) + " declarations)";
 }
 
 } // namespace cpp20::compiler::ast
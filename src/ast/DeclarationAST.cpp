@@ -0,0 +1,31 @@
+#include <compiler/ast/DeclarationAST.h>
+#include <compiler/ast/StatementAST.h>
+
+namespace cpp20::compiler::ast {
+
+std::string VariableDecl::toString() const {
+    std::string result = std::string(typeName_) + " " + std::string(name_);
+    if (initializer_) {
+        result += " = " + initializer_->toString();
+    }
+    return result + ";";
+}
+
+std::string ParameterDecl::toString() const {
+    return name_.empty() ? std::string(typeName_) : std::string(typeName_) + " " + std::string(name_);
+}
+
+std::string FunctionDecl::toString() const {
+    std::string result = std::string(returnType_) + " " + std::string(name_) + "(";
+    for (size_t i = 0; i < parameters_.size(); ++i) {
+        if (i > 0) result += ", ";
+        result += parameters_[i]->toString();
+    }
+    result += ")";
+    if (body_) {
+        return result + " " + body_->toString();
+    }
+    return hasDelayedBody() ? result + " { ... }" : result + ";";
+}
+
+} // namespace cpp20::compiler::ast
@@ -1,116 +1,112 @@
 #include <compiler/ast/ExpressionAST.h>
-#include <sstream>
 
 namespace cpp20::compiler::ast {
 
-// ============================================================================
-// IntegerLiteral Implementation
-// ============================================================================
+namespace {
 
-void IntegerLiteral::accept(ASTVisitor* visitor) {
-    // Implementación básica - en un compilador real esto visitaría el nodo
-    if (visitor) {
-        // visitor->visitIntegerLiteral(this);
-    }
+std::string childString(const ASTNode* node) {
+    return node ? node->toString() : "<null>";
 }
 
-// ============================================================================
-// FloatingPointLiteral Implementation
-// ============================================================================
-
-void FloatingPointLiteral::accept(ASTVisitor* visitor) {
-    // Implementación básica - en un compilador real esto visitaría el nodo
-    if (visitor) {
-        // visitor->visitFloatingPointLiteral(this);
-    }
-}
+} // namespace
 
 // ============================================================================
-// CharacterLiteral Implementation
+// BinaryOp Implementation
 // ============================================================================
 
-void CharacterLiteral::accept(ASTVisitor* visitor) {
-    // Implementación básica - en un compilador real esto visitaría el nodo
-    if (visitor) {
-        // visitor->visitCharacterLiteral(this);
+const char* BinaryOp::opSpelling(OpKind op) {
+    switch (op) {
+        case OpKind::Add: return "+";
+        case OpKind::Subtract: return "-";
+        case OpKind::Multiply: return "*";
+        case OpKind::Divide: return "/";
+        case OpKind::Modulo: return "%";
+        case OpKind::Equal: return "==";
+        case OpKind::NotEqual: return "!=";
+        case OpKind::Less: return "<";
+        case OpKind::LessEqual: return "<=";
+        case OpKind::Greater: return ">";
+        case OpKind::GreaterEqual: return ">=";
+        case OpKind::LogicalAnd: return "&&";
+        case OpKind::LogicalOr: return "||";
+        case OpKind::BitwiseAnd: return "&";
+        case OpKind::BitwiseOr: return "|";
+        case OpKind::BitwiseXor: return "^";
+        case OpKind::LeftShift: return "<<";
+        case OpKind::RightShift: return ">>";
     }
+    return "?";
 }
 
-// ============================================================================
-// StringLiteral Implementation
-// ============================================================================
-
-void StringLiteral::accept(ASTVisitor* visitor) {
-    // Implementación básica - en un compilador real esto visitaría el nodo
-    if (visitor) {
-        // visitor->visitStringLiteral(this);
-    }
+std::string BinaryOp::toString() const {
+    return "(" + childString(left_) + " " + opSpelling(op_) + " " + childString(right_) + ")";
 }
 
 // ============================================================================
-// BooleanLiteral Implementation
-// ============================================================================
-
-void BooleanLiteral::accept(ASTVisitor* visitor) {
-    // Implementación básica - en un compilador real esto visitaría el nodo
-    if (visitor) {
-        // visitor->visitBooleanLiteral(this);
-    }
-}
-
-// ============================================================================
-// BinaryOp Implementation
+// UnaryOp Implementation
 // ============================================================================
 
-void BinaryOp::accept(ASTVisitor* visitor) {
-    // Implementación básica - en un compilador real esto visitaría el nodo
-    if (visitor) {
-        // visitor->visitBinaryOp(this);
+const char* UnaryOp::opSpelling(OpKind op) {
+    switch (op) {
+        case OpKind::Plus: return "+";
+        case OpKind::Minus: return "-";
+        case OpKind::Not: return "!";
+        case OpKind::BitwiseNot: return "~";
+        case OpKind::AddressOf: return "&";
+        case OpKind::Dereference: return "*";
     }
+    return "?";
 }
 
-// ============================================================================
-// UnaryOp Implementation
-// ============================================================================
-
-void UnaryOp::accept(ASTVisitor* visitor) {
-    // Implementación básica - en un compilador real esto visitaría el nodo
-    if (visitor) {
-        // visitor->visitUnaryOp(this);
-    }
+std::string UnaryOp::toString() const {
+    return std::string("(") + opSpelling(op_) + childString(operand_) + ")";
 }
 
 // ============================================================================
 // FunctionCall Implementation
 // ============================================================================
 
-void FunctionCall::accept(ASTVisitor* visitor) {
-    // Implementación básica - en un compilador real esto visitaría el nodo
-    if (visitor) {
-        // visitor->visitFunctionCall(this);
+std::string FunctionCall::toString() const {
+    std::string result = childString(callee_) + "(";
+    for (size_t i = 0; i < arguments_.size(); ++i) {
+        if (i > 0) result += ", ";
+        result += childString(arguments_[i]);
     }
+    return result + ")";
 }
 
 // ============================================================================
 // TernaryOp Implementation
 // ============================================================================
 
-void TernaryOp::accept(ASTVisitor* visitor) {
-    // Implementación básica - en un compilador real esto visitaría el nodo
-    if (visitor) {
-        // visitor->visitTernaryOp(this);
-    }
+std::string TernaryOp::toString() const {
+    return "(" + childString(condition_) + " ? " + childString(trueExpr_) + " : " +
+           childString(falseExpr_) + ")";
 }
 
 // ============================================================================
 // Assignment Implementation
 // ============================================================================
 
-void Assignment::accept(ASTVisitor* visitor) {
-    // Implementación básica - en un compilador real esto visitaría el nodo
-    if (visitor) {
-        // visitor->visitAssignment(this);
+const char* Assignment::opSpelling(OpKind op) {
+    switch (op) {
+        case OpKind::Assign: return "=";
+        case OpKind::AddAssign: return "+=";
+        case OpKind::SubtractAssign: return "-=";
+        case OpKind::MultiplyAssign: return "*=";
+        case OpKind::DivideAssign: return "/=";
+        case OpKind::ModuloAssign: return "%=";
+        case OpKind::BitwiseAndAssign: return "&=";
+        case OpKind::BitwiseOrAssign: return "|=";
+        case OpKind::BitwiseXorAssign: return "^=";
+        case OpKind::LeftShiftAssign: return "<<=";
+        case OpKind::RightShiftAssign: return ">>=";
     }
+    return "?";
+}
+
+std::string Assignment::toString() const {
+    return "(" + childString(left_) + " " + opSpelling(op_) + " " + childString(right_) + ")";
 }
 
 } // namespace cpp20::compiler::ast
@@ -0,0 +1,48 @@
+#include <compiler/ast/StatementAST.h>
+
+namespace cpp20::compiler::ast {
+
+namespace {
+
+std::string childString(const ASTNode* node) {
+    return node ? node->toString() : "<null>";
+}
+
+} // namespace
+
+std::string CompoundStmt::toString() const {
+    std::string result = "{";
+    for (const ASTNode* statement : statements_) {
+        result += " " + childString(statement);
+    }
+    return result + " }";
+}
+
+std::string ExprStmt::toString() const {
+    return expression_ ? expression_->toString() + ";" : ";";
+}
+
+std::string IfStmt::toString() const {
+    std::string result = "if (" + childString(condition_) + ") " + childString(thenStmt_);
+    if (elseStmt_) {
+        result += " else " + elseStmt_->toString();
+    }
+    return result;
+}
+
+std::string WhileStmt::toString() const {
+    return "while (" + childString(condition_) + ") " + childString(body_);
+}
+
+std::string ForStmt::toString() const {
+    auto part = [](const ASTNode* node) { return node ? node->toString() : std::string(); };
+    return "for (" + part(init_) + "; " + part(condition_) + "; " + part(increment_) + ") " +
+           childString(body_);
+}
+
+std::string ReturnStmt::toString() const {
+    std::string text = value_ ? "return " + value_->toString() + ";" : "return;";
+    return mustTail_ ? "[[clang::musttail]] " + text : text;
+}
+
+} // namespace cpp20::compiler::ast
@@ -4,162 +4,237 @@
  */
 
 #include <compiler/ast/TemplateAST.h>
+#include <compiler/ast/ASTVisitor.h>
+#include <cctype>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace cpp20::compiler::ast {
 
-// ============================================================================
-// TemplateParameter - Implementación
-// ============================================================================
-
-TemplateParameter::TemplateParameter(TemplateParameterType type, const std::string& name,
-                                   std::unique_ptr<ASTNode> defaultValue)
-    : ASTNode(ASTNodeKind::TemplateParameter), parameterType_(type), name_(name),
-      defaultValue_(std::move(defaultValue)) {
-}
+namespace {
 
-void TemplateParameter::accept(ASTVisitor& visitor) {
-    visitor.visit(*this);
+std::string childString(const ASTNode* node) {
+    return node ? node->toString() : "<null>";
 }
 
-// ============================================================================
-// TemplateParameterList - Implementación
-// ============================================================================
-
-TemplateParameterList::TemplateParameterList(std::vector<std::unique_ptr<TemplateParameter>> parameters)
-    : ASTNode(ASTNodeKind::TemplateParameterList), parameters_(std::move(parameters)) {
+template<typename T>
+std::string joinList(NodeList<T> list) {
+    std::string result;
+    for (size_t i = 0; i < list.size(); ++i) {
+        if (i > 0) result += ", ";
+        result += list[i]->toString();
+    }
+    return result;
 }
 
-void TemplateParameterList::addParameter(std::unique_ptr<TemplateParameter> param) {
-    parameters_.push_back(std::move(param));
-}
+} // namespace
 
-void TemplateParameterList::accept(ASTVisitor& visitor) {
-    visitor.visit(*this);
-}
-
-// ============================================================================
-// TemplateDeclaration - Implementación
-// ============================================================================
-
-TemplateDeclaration::TemplateDeclaration(std::unique_ptr<TemplateParameterList> parameters,
-                                       std::unique_ptr<ASTNode> declaration)
-    : ASTNode(ASTNodeKind::TemplateDeclaration), parameters_(std::move(parameters)),
-      declaration_(std::move(declaration)) {
-}
-
-void TemplateDeclaration::accept(ASTVisitor& visitor) {
-    visitor.visit(*this);
-}
-
-// ============================================================================
-// TemplateArgument - Implementación
 // ============================================================================
-
-TemplateArgument::TemplateArgument(ArgumentType type, std::unique_ptr<ASTNode> value)
-    : ASTNode(ASTNodeKind::TemplateArgument), argumentType_(type), value_(std::move(value)) {
-}
-
-void TemplateArgument::accept(ASTVisitor& visitor) {
-    visitor.visit(*this);
-}
-
-// ============================================================================
-// TemplateArgumentList - Implementación
+// TemplateParameter - Implementación
 // ============================================================================
 
-TemplateArgumentList::TemplateArgumentList(std::vector<std::unique_ptr<TemplateArgument>> arguments)
-    : ASTNode(ASTNodeKind::TemplateArgumentList), arguments_(std::move(arguments)) {
-}
-
-void TemplateArgumentList::addArgument(std::unique_ptr<TemplateArgument> arg) {
-    arguments_.push_back(std::move(arg));
-}
-
-void TemplateArgumentList::accept(ASTVisitor& visitor) {
-    visitor.visit(*this);
+std::string TemplateParameter::toString() const {
+    std::string result;
+    switch (parameterType_) {
+        case TemplateParameterType::Type: result = "typename"; break;
+        case TemplateParameterType::NonType: result = "auto"; break;
+        case TemplateParameterType::Template: result = "template<typename> class"; break;
+    }
+    if (!name_.empty()) {
+        result += " ";
+        result += name_;
+    }
+    if (defaultValue_) {
+        result += " = " + defaultValue_->toString();
+    }
+    return result;
 }
 
 // ============================================================================
-// TemplateInstantiation - Implementación
+// TemplateParameterList / TemplateDeclaration - Implementación
 // ============================================================================
 
-TemplateInstantiation::TemplateInstantiation(std::unique_ptr<ASTNode> templateName,
-                                           std::unique_ptr<TemplateArgumentList> arguments)
-    : ASTNode(ASTNodeKind::TemplateInstantiation), templateName_(std::move(templateName)),
-      arguments_(std::move(arguments)) {
+std::string TemplateParameterList::toString() const {
+    return "template<" + joinList(parameters_) + ">";
 }
 
-void TemplateInstantiation::accept(ASTVisitor& visitor) {
-    visitor.visit(*this);
+std::string TemplateDeclaration::toString() const {
+    return childString(parameters_) + " " + childString(declaration_);
 }
 
 // ============================================================================
-// TemplateSpecialization - Implementación
+// TemplateArgument / TemplateArgumentList - Implementación
 // ============================================================================
 
-TemplateSpecialization::TemplateSpecialization(std::unique_ptr<ASTNode> templateName,
-                                             std::unique_ptr<TemplateArgumentList> arguments,
-                                             std::unique_ptr<ASTNode> body)
-    : ASTNode(ASTNodeKind::TemplateSpecialization), templateName_(std::move(templateName)),
-      arguments_(std::move(arguments)), body_(std::move(body)) {
+std::string TemplateArgument::toString() const {
+    return childString(value_);
 }
 
-void TemplateSpecialization::accept(ASTVisitor& visitor) {
-    visitor.visit(*this);
+std::string TemplateArgumentList::toString() const {
+    return "<" + joinList(arguments_) + ">";
 }
 
 // ============================================================================
-// ConceptDefinition - Implementación
+// TemplateInstantiation / TemplateSpecialization - Implementación
 // ============================================================================
 
-ConceptDefinition::ConceptDefinition(const std::string& name,
-                                   std::unique_ptr<TemplateParameterList> parameters,
-                                   std::unique_ptr<ASTNode> constraintExpression)
-    : ASTNode(ASTNodeKind::ConceptDefinition), name_(name),
-      parameters_(std::move(parameters)), constraintExpression_(std::move(constraintExpression)) {
+std::string TemplateInstantiation::toString() const {
+    return childString(templateName_) + childString(arguments_);
 }
 
-void ConceptDefinition::accept(ASTVisitor& visitor) {
-    visitor.visit(*this);
+std::string TemplateSpecialization::toString() const {
+    return "template<> " + childString(templateName_) + childString(arguments_) + " " +
+           childString(body_);
 }
 
 // ============================================================================
-// RequiresClause - Implementación
+// Concepts y constraints - Implementación
 // ============================================================================
 
-RequiresClause::RequiresClause(std::unique_ptr<ASTNode> requirements)
-    : ASTNode(ASTNodeKind::RequiresClause), requirements_(std::move(requirements)) {
+std::string ConceptDefinition::toString() const {
+    return childString(parameters_) + " concept " + std::string(name_) + " = " +
+           childString(constraintExpression_);
 }
 
-void RequiresClause::accept(ASTVisitor& visitor) {
-    visitor.visit(*this);
+std::string RequiresClause::toString() const {
+    return "requires " + childString(requirements_);
 }
 
-// ============================================================================
-// RequiresExpression - Implementación
-// ============================================================================
-
-RequiresExpression::RequiresExpression(std::unique_ptr<TemplateParameterList> parameters,
-                                     std::unique_ptr<ASTNode> requirements)
-    : ASTNode(ASTNodeKind::RequiresExpression), parameters_(std::move(parameters)),
-      requirements_(std::move(requirements)) {
+std::string RequiresExpression::toString() const {
+    return "requires " + childString(parameters_) + " { " + childString(requirements_) + " }";
 }
 
-void RequiresExpression::accept(ASTVisitor& visitor) {
-    visitor.visit(*this);
+std::string ConstraintExpression::toString() const {
+    switch (constraintType_) {
+        case ConstraintType::Atomic:
+            return childString(left_);
+        case ConstraintType::Conjunction:
+        case ConstraintType::LogicalAnd:
+            return "(" + childString(left_) + " && " + childString(right_) + ")";
+        case ConstraintType::Disjunction:
+        case ConstraintType::LogicalOr:
+            return "(" + childString(left_) + " || " + childString(right_) + ")";
+        case ConstraintType::LogicalNot:
+            return "(!" + childString(left_) + ")";
+    }
+    return "?";
 }
 
 // ============================================================================
-// ConstraintExpression - Implementación
+// Búsqueda en dos fases
 // ============================================================================
 
-ConstraintExpression::ConstraintExpression(ConstraintType type,
-                                         std::unique_ptr<ASTNode> left,
-                                         std::unique_ptr<ASTNode> right)
-    : ASTNode(ASTNodeKind::ConstraintExpression), constraintType_(type),
-      left_(std::move(left)), right_(std::move(right)) {
-}
+namespace {
 
-void ConstraintExpression::accept(ASTVisitor& visitor) {
-    visitor.visit(*this);
-}
+/**
+ * @brief Recorrido que decide qué subexpresiones dependen de los parámetros
+ */
+class NameUseCollector {
+public:
+    explicit NameUseCollector(const TemplateParameterList* parameters) {
+        if (parameters) {
+            for (TemplateParameter* parameter : parameters->getParameters()) {
+                parameters_.insert(parameter->getName());
+            }
+        }
+    }
+
+    /**
+     * @return Si node depende de algún parámetro del template
+     */
+    bool visit(ASTNode* node) {
+        switch (node->kind()) {
+            case ASTNodeKind::Identifier:
+                return useName(static_cast<Identifier*>(node)->getName(), false);
+            case ASTNodeKind::FunctionCall: {
+                auto* call = static_cast<FunctionCall*>(node);
+                bool dependentArguments = false;
+                for (ASTNode* argument : call->getArguments()) {
+                    dependentArguments |= argument && visit(argument);
+                }
+                ASTNode* callee = call->getCallee();
+                if (callee && callee->kind() == ASTNodeKind::Identifier) {
+                    return useName(static_cast<Identifier*>(callee)->getName(), dependentArguments) ||
+                           dependentArguments;
+                }
+                return (callee && visit(callee)) || dependentArguments;
+            }
+            case ASTNodeKind::VariableDecl: {
+                auto* variable = static_cast<VariableDecl*>(node);
+                bool dependent = mentionsParameter(variable->getTypeName());
+                if (ASTNode* initializer = variable->getInitializer()) {
+                    dependent |= visit(initializer);
+                }
+                locals_[variable->getName()] = dependent;
+                return false;
+            }
+            case ASTNodeKind::ParameterDecl: {
+                auto* parameter = static_cast<ParameterDecl*>(node);
+                locals_[parameter->getName()] = mentionsParameter(parameter->getTypeName());
+                return false;
+            }
+            case ASTNodeKind::FunctionDecl:
+                locals_[static_cast<FunctionDecl*>(node)->getName()] = false;
+                break;
+            default:
+                break;
+        }
+
+        bool dependent = false;
+        forEachChild(node, [&](ASTNode* child) { dependent |= visit(child); });
+        return dependent;
+    }
+
+    TemplateNameUses take() { return std::move(uses_); }
+
+private:
+    std::unordered_set<std::string_view> parameters_;
+    std::unordered_map<std::string_view, bool> locals_;   // Declarados en la definición -> dependiente
+    std::unordered_set<std::string_view> seen_[2];      // No dependientes, dependientes
+    TemplateNameUses uses_;
+
+    bool useName(std::string_view name, bool dependentCall) {
+        if (parameters_.count(name)) {
+            return true;
+        }
+        if (auto local = locals_.find(name); local != locals_.end()) {
+            return local->second;
+        }
+        // f(1) y f(t) en la misma definición: se liga ya y además se busca al instanciar
+        if (seen_[dependentCall].insert(name).second) {
+            (dependentCall ? uses_.dependent : uses_.nonDependent).push_back(name);
+        }
+        return false;
+    }
+
+    // "const std::vector<T>&" menciona T
+    bool mentionsParameter(std::string_view typeName) const {
+        size_t start = 0;
+        while (start < typeName.size()) {
+            while (start < typeName.size() && !isWordChar(typeName[start])) ++start;
+            size_t end = start;
+            while (end < typeName.size() && isWordChar(typeName[end])) ++end;
+            if (end > start && parameters_.count(typeName.substr(start, end - start))) {
+                return true;
+            }
+            start = end;
+        }
+        return false;
+    }
+
+    static bool isWordChar(char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    }
+};
+
+} // namespace
+
+TemplateNameUses collectTemplateNameUses(ASTNode* definition, const TemplateParameterList* parameters) {
+    NameUseCollector collector(parameters);
+    if (definition) {
+        collector.visit(definition);
+    }
+    return collector.take();
+}
+
+} // namespace cpp20::compiler::ast
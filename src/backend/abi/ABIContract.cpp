@@ -9,6 +9,21 @@
 
 namespace cpp20::compiler::backend::abi {
 
+namespace {
+
+bool isRegisterSized(size_t size) {
+    return size == 1 || size == 2 || size == 4 || size == 8;
+}
+
+/**
+ * @brief Agregado de dos float o dos double: cabe en XMM en la convención interna
+ */
+bool isFloatPair(const ABIContract::ValueType& type) {
+    return type.floatFields == 2 && (type.size == 8 || type.size == 16);
+}
+
+} // namespace
+
 // ============================================================================
 // IMPLEMENTACIÓN DE FUNCIONES ESTÁTICAS
 // ============================================================================
@@ -40,57 +55,149 @@ bool ABIContract::validateFrameLayout(const FrameLayout& layout) {
 ABIContract::ParameterInfo ABIContract::classifyParameter(
     size_t size, size_t alignment, bool isFloat, bool isSigned) {
 
-    ParameterInfo info(ParameterInfo::Kind::Integer, size, alignment, false, -1, isSigned);
+    ValueType type;
+    type.size = size;
+    type.alignment = alignment;
+    type.isSigned = isSigned;
+    type.isVector = size == 16 && alignment == 16;     // __m128
+    type.isFloat = isFloat && !type.isVector;
+    type.isAggregate = !type.isVector && !type.isFloat && !isRegisterSized(size);
+    return classifyParameter(type);
+}
 
-    // Parámetros flotantes
-    if (isFloat) {
-        info.kind = ParameterInfo::Kind::Float;
+ABIContract::ParameterInfo ABIContract::classifyParameter(const ValueType& type, CallingConvention convention) {
+    bool fastcall = convention == CallingConvention::InternalFastcall;
+    ParameterInfo info(ParameterInfo::Kind::Integer, type.size, type.alignment, false, -1, type.isSigned);
+
+    // Parámetros vectoriales: Win64 los pasa por referencia
+    if (type.isVector) {
+        info.kind = ParameterInfo::Kind::Vector;
+        info.usesXmm = fastcall;
+        info.byReference = !fastcall;
         return info;
     }
 
-    // Parámetros agregados (structs, etc.)
-    if (size > 8 || alignment > 8) {
-        info.kind = ParameterInfo::Kind::Aggregate;
+    // Parámetros flotantes
+    if (type.isFloat) {
+        info.kind = ParameterInfo::Kind::Float;
+        info.usesXmm = true;
         return info;
     }
 
-    // Parámetros vectoriales
-    if (size == 16 && alignment == 16) { // __m128
-        info.kind = ParameterInfo::Kind::Vector;
+    // Parámetros enteros normales
+    if (!type.isAggregate) {
         return info;
     }
 
-    // Parámetros enteros normales
-    info.kind = ParameterInfo::Kind::Integer;
+    // Agregados: en Win64 los de 1, 2, 4 u 8 bytes van como enteros,
+    // aunque sus campos sean float
+    info.kind = ParameterInfo::Kind::Aggregate;
+    if (fastcall && isFloatPair(type)) {
+        info.usesXmm = true;
+        info.registerCount = type.size == 16 ? 2 : 1;
+    } else if (fastcall && type.size <= 16 && type.alignment <= GENERAL_ALIGNMENT) {
+        info.registerCount = type.size > 8 ? 2 : 1;
+    } else {
+        info.byReference = !isRegisterSized(type.size);
+    }
     return info;
 }
 
+std::vector<ABIContract::ParameterInfo> ABIContract::classifyParameters(
+    const std::vector<ValueType>& params, CallingConvention convention, bool hiddenReturnPointer) {
+
+    std::vector<ParameterInfo> result;
+    result.reserve(params.size());
+
+    if (convention == CallingConvention::Win64) {
+        // Cada posición tiene su registro entero y su XMM; se usa uno de los dos
+        int position = hiddenReturnPointer ? 1 : 0;
+        for (const ValueType& type : params) {
+            ParameterInfo info = classifyParameter(type, convention);
+            if (position < MAX_INTEGER_ARGS_IN_REGS) {
+                info.inRegister = true;
+                info.registerIndex = position;
+            }
+            ++position;
+            result.push_back(info);
+        }
+        return result;
+    }
+
+    // Convención interna: enteros y XMM se reparten por separado
+    int nextInteger = hiddenReturnPointer ? 1 : 0;
+    int nextFloat = 0;
+    for (const ValueType& type : params) {
+        ParameterInfo info = classifyParameter(type, convention);
+        int& next = info.usesXmm ? nextFloat : nextInteger;
+        int limit = info.usesXmm ? MAX_FASTCALL_FLOAT_ARGS_IN_REGS : MAX_FASTCALL_INTEGER_ARGS_IN_REGS;
+        if (next + info.registerCount <= limit) {
+            info.inRegister = true;
+            info.registerIndex = next;
+            next += info.registerCount;
+        }
+        result.push_back(info);
+    }
+    return result;
+}
+
 ABIContract::ReturnInfo ABIContract::classifyReturn(
     size_t size, size_t alignment, bool isFloat, bool isAggregate) {
 
-    ReturnInfo info;
+    ValueType type;
+    type.size = size;
+    type.alignment = alignment;
+    type.isFloat = isFloat && !isAggregate;
+    type.isAggregate = isAggregate;
+    return classifyReturn(type);
+}
+
+ABIContract::ReturnInfo ABIContract::classifyReturn(const ValueType& type, CallingConvention convention) {
+    ReturnInfo info(ReturnInfo::Kind::Void, type.size);
 
     // Void
-    if (size == 0) {
-        info.kind = ReturnInfo::Kind::Void;
+    if (type.size == 0) {
         return info;
     }
 
-    // Retorno por referencia para agregados grandes
-    if (isAggregate && (size > 8 || alignment > 8)) {
-        info.kind = ReturnInfo::Kind::Aggregate;
-        info.isIndirect = true;
+    // __m128/__m256 en XMM0/YMM0
+    if (type.isVector) {
+        info.kind = ReturnInfo::Kind::Vector;
+        info.underlyingKind = ParameterInfo::Kind::Vector;
         return info;
     }
 
     // Retorno flotante
-    if (isFloat) {
+    if (type.isFloat) {
         info.kind = ReturnInfo::Kind::Float;
+        info.underlyingKind = ParameterInfo::Kind::Float;
         return info;
     }
 
     // Retorno entero
     info.kind = ReturnInfo::Kind::Integer;
+    if (!type.isAggregate) {
+        return info;
+    }
+
+    info.underlyingKind = ParameterInfo::Kind::Aggregate;
+    if (convention == CallingConvention::InternalFastcall) {
+        if (isFloatPair(type)) {
+            info.kind = ReturnInfo::Kind::Float;
+            info.registerCount = type.size == 16 ? 2 : 1;
+            return info;
+        }
+        if (type.size <= 16 && type.alignment <= GENERAL_ALIGNMENT) {
+            info.registerCount = type.size > 8 ? 2 : 1;
+            return info;
+        }
+    } else if (isRegisterSized(type.size) && type.isPOD) {
+        return info;
+    }
+
+    // Retorno por referencia: el llamador pasa el destino como primer argumento
+    info.kind = ReturnInfo::Kind::Aggregate;
+    info.isIndirect = true;
     return info;
 }
 
@@ -129,17 +236,21 @@ size_t ABIContract::calculateStackSize(
     return alignOffset(stackSize, STACK_ALIGNMENT);
 }
 
-std::string ABIContract::getIntegerArgRegister(int index) {
-    static const char* registers[] = {"rcx", "rdx", "r8", "r9"};
-    if (index >= 0 && index < 4) {
+std::string ABIContract::getIntegerArgRegister(int index, CallingConvention convention) {
+    static const char* registers[] = {"rcx", "rdx", "r8", "r9", "r10", "r11"};
+    int limit = convention == CallingConvention::InternalFastcall ? MAX_FASTCALL_INTEGER_ARGS_IN_REGS
+                                                                  : MAX_INTEGER_ARGS_IN_REGS;
+    if (index >= 0 && index < limit) {
         return registers[index];
     }
     return "";
 }
 
-std::string ABIContract::getFloatArgRegister(int index) {
-    static const char* registers[] = {"xmm0", "xmm1", "xmm2", "xmm3"};
-    if (index >= 0 && index < 4) {
+std::string ABIContract::getFloatArgRegister(int index, CallingConvention convention) {
+    static const char* registers[] = {"xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5"};
+    int limit = convention == CallingConvention::InternalFastcall ? MAX_FASTCALL_FLOAT_ARGS_IN_REGS
+                                                                  : MAX_FLOAT_ARGS_IN_REGS;
+    if (index >= 0 && index < limit) {
         return registers[index];
     }
     return "";
@@ -0,0 +1,419 @@
+/**
+ * @file CodeGenerator.cpp
+ * @brief Implementación del back-end por función
+ */
+
+#include <compiler/backend/codegen/CodeGenerator.h>
+#include <compiler/backend/codegen/CodegenDatabase.h>
+#include <compiler/backend/codegen/X86Encoder.h>
+#include <compiler/backend/frame/FrameBuilder.h>
+#include <compiler/backend/optimization/PeepholeOptimizer.h>
+#include <compiler/backend/unwind/UnwindEmitter.h>
+#include <compiler/common/TimingProfiler.h>
+#include <compiler/common/utils/HashUtils.h>
+#include <compiler/common/utils/MemoryTracker.h>
+#include <compiler/common/utils/ThreadPool.h>
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+
+namespace cpp20::compiler::backend {
+
+namespace {
+
+constexpr uint8_t kRsp = 4;
+
+/**
+ * @brief Llama a visit con cada registro de propósito general del operando
+ */
+template <typename Visit>
+void forEachRegister(const X86Operand& operand, Visit visit) {
+    switch (operand.mode) {
+        case AddressingMode::Register:
+        case AddressingMode::MemoryIndirect:
+        case AddressingMode::MemoryBaseDisp:
+            if (operand.reg < X86Register::XMM0) visit(X86Encoder::registerNumber(operand.reg));
+            break;
+        case AddressingMode::MemoryBaseIndex:
+        case AddressingMode::MemoryBaseIndexDisp:
+            visit(X86Encoder::registerNumber(operand.baseReg));
+            visit(X86Encoder::registerNumber(operand.indexReg));
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Si la instrucción necesita el marco: llama, usa la pila o toca un no volátil
+ */
+bool needsFrame(const X86Instruction& inst) {
+    if (inst.opcode == X86Opcode::CALL || inst.opcode == X86Opcode::PUSH || inst.opcode == X86Opcode::POP) {
+        return true;
+    }
+    bool needs = false;
+    for (const X86Operand& operand : inst.operands) {
+        forEachRegister(operand, [&](uint8_t reg) {
+            needs = needs || reg == kRsp || abi::ABIContract::isCalleeSavedRegister(reg);
+        });
+    }
+    return needs;
+}
+
+/**
+ * @brief Lo que el cuerpo ya seleccionado exige al marco
+ */
+FrameRequirements frameRequirements(const std::vector<X86Instruction>& body, size_t localSize) {
+    FrameRequirements requirements;
+    requirements.localSize = localSize;
+
+    uint16_t used = 0;
+    for (const X86Instruction& inst : body) {
+        requirements.makesCalls = requirements.makesCalls || inst.opcode == X86Opcode::CALL;
+        for (const X86Operand& operand : inst.operands) {
+            forEachRegister(operand, [&](uint8_t reg) { used |= static_cast<uint16_t>(1u << reg); });
+        }
+    }
+    for (uint8_t reg = 0; reg < 16; ++reg) {
+        if (reg != kRsp && (used >> reg & 1) && abi::ABIContract::isCalleeSavedRegister(reg)) {
+            requirements.usedCalleeSaved.push_back(reg);
+        }
+    }
+    return requirements;
+}
+
+/**
+ * @brief Instrucciones iniciales que pueden ir antes del prólogo (shrink-wrapping)
+ *
+ * El tramo no necesita marco, contiene algún RET (o salto en cola) y solo
+ * se sale de él cayendo al prólogo: ningún salto cruza el corte en ningún
+ * sentido.
+ * Windows x64 trata el código fuera de .pdata como hoja, así que la
+ * salida temprana no paga ni prólogo ni epílogo.
+ */
+size_t framelessPrefix(const std::vector<X86Instruction>& body) {
+    std::unordered_map<std::string, size_t> labels;
+    for (size_t i = 0; i < body.size(); ++i) {
+        if (body[i].opcode != X86Opcode::NOP || body[i].comment.empty()) continue;
+        std::string name = body[i].comment;
+        if (name.back() == ':') name.pop_back();
+        labels.emplace(std::move(name), i);
+    }
+
+    // Destino de cada salto; sin etiqueta no se arriesga el corte
+    constexpr size_t kNone = SIZE_MAX;
+    std::vector<size_t> targets(body.size(), kNone);
+    for (size_t i = 0; i < body.size(); ++i) {
+        const X86Instruction& inst = body[i];
+        // Los destinos de una tabla de saltos no se siguen: sin corte
+        if (inst.opcode == X86Opcode::JMPTABLE) return 0;
+        bool jump = inst.opcode >= X86Opcode::JMP && inst.opcode <= X86Opcode::JNC;
+        if (!jump) continue;
+        auto label = labels.find(inst.comment);
+        if (label == labels.end()) return 0;
+        targets[i] = label->second;
+    }
+
+    size_t limit = std::find_if(body.begin(), body.end(), needsFrame) - body.begin();
+    if (limit == body.size()) return 0;
+
+    // lowestTarget[p]: menor destino de los saltos en [p, n)
+    std::vector<size_t> lowestTarget(body.size() + 1, kNone);
+    for (size_t i = body.size(); i-- > 0;) {
+        lowestTarget[i] = std::min(lowestTarget[i + 1], targets[i]);
+    }
+
+    size_t best = 0;
+    size_t highestTarget = 0;   // Uno más que el mayor destino de los saltos en [0, p)
+    bool returns = false;
+    for (size_t p = 1; p <= limit; ++p) {
+        const X86Instruction& inst = body[p - 1];
+        returns = returns || inst.opcode == X86Opcode::RET || inst.opcode == X86Opcode::TAILJMP;
+        if (targets[p - 1] != kNone) highestTarget = std::max(highestTarget, targets[p - 1] + 1);
+        if (returns && highestTarget <= p && lowestTarget[p] >= p) best = p;
+    }
+    return best;
+}
+
+uint64_t typeHash(uint64_t seed, const ir::TypeInfo& type) {
+    using common::utils::hashMix;
+    seed = hashMix(seed, static_cast<uint64_t>(type.type));
+    seed = hashMix(seed, type.size);
+    seed = hashMix(seed, type.alignment);
+    seed = hashMix(seed, static_cast<uint64_t>(type.elementType));
+    seed = hashMix(seed, type.lanes);
+    return common::utils::fnv1a64(type.typeName, seed);
+}
+
+using DeclarationHashes = std::unordered_map<std::string, uint64_t>;
+
+/**
+ * @brief Declaración de cada global del módulo tal como la ve quien lo referencia
+ */
+DeclarationHashes declarationHashes(const ir::IRModule& module) {
+    DeclarationHashes declarations;
+    for (const auto& global : module.getGlobals()) {
+        declarations[global->getName()] =
+            common::utils::fnv1a64(global->toString(), common::utils::fnv1a64(global->getName()));
+    }
+    for (const auto& function : module.getFunctions()) {
+        uint64_t seed = typeHash(common::utils::fnv1a64(function->getName()), function->getReturnType());
+        for (const auto& param : function->getParamTypes()) {
+            seed = typeHash(seed, param);
+        }
+        declarations[function->getName()] =
+            common::utils::hashMix(seed, static_cast<uint64_t>(function->getLinkage()));
+    }
+    return declarations;
+}
+
+uint64_t functionHash(const ir::IRFunction& function, uint64_t configuration,
+                      const DeclarationHashes& declarations, std::vector<std::string>* dependencies) {
+    using common::utils::hashMix;
+
+    uint64_t hash = hashMix(common::utils::fnv1a64(function.toString()), configuration);
+    hash = hashMix(hash, static_cast<uint64_t>(function.getLinkage()));
+    for (ir::ValueId id = 0; id < function.valueCount(); ++id) {
+        hash = typeHash(hash, function.typeOf(id));
+    }
+
+    std::vector<std::string> globals;
+    for (ir::ValueId id = 0; id < function.valueCount(); ++id) {
+        if (function.value(id).kind == ir::ValueKind::Global) {
+            globals.push_back(function.globalName(id));
+        }
+    }
+    std::sort(globals.begin(), globals.end());
+    globals.erase(std::unique(globals.begin(), globals.end()), globals.end());
+
+    // Un global externo al módulo solo aporta su nombre
+    for (const auto& name : globals) {
+        auto it = declarations.find(name);
+        hash = hashMix(hash, it != declarations.end() ? it->second : common::utils::fnv1a64(name));
+    }
+
+    if (dependencies) {
+        *dependencies = std::move(globals);
+    }
+    return hash;
+}
+
+} // namespace
+
+// ============================================================================
+// CodeGenerator - Implementación
+// ============================================================================
+
+CodeGenerator::CodeGenerator(const abi::ABIContract& abiContract, const CPUFeatures& features,
+                             AllocationStrategy strategy, Microarchitecture tune)
+    : abiContract_(abiContract), features_(features), strategy_(strategy), tune_(tune) {
+}
+
+FunctionCode CodeGenerator::generateFunction(const ir::IRFunction& function) const {
+    TimingProfiler* profiler = TimingProfiler::active();
+    AutoTimer timer(profiler, CompilationPhase::CodeGeneration,
+                    profiler ? function.getName() : std::string());
+    // Se ejecuta en los workers de parallelFor: el ámbito es por hilo
+    common::utils::MemoryScope memoryScope(common::utils::MemorySubsystem::Backend);
+
+    FunctionCode result;
+    result.name = function.getName();
+
+    // Cada función en su sección: el linker descarta las que nadie usa y
+    // se queda con una sola copia de las inline y plantillas
+    result.comdatSelection = function.getLinkage() == ir::Linkage::LinkOnce
+                                 ? coff::IMAGE_COMDAT_SELECT_ANY
+                                 : coff::IMAGE_COMDAT_SELECT_NODUPLICATES;
+
+    RegisterAllocator allocator(abiContract_, strategy_);
+    // Las copias de target_clones usan además sus propias extensiones
+    CPUFeatures features = features_;
+    if (std::optional<CPUFeatures> target = parseTargetFeatures(function.getTarget())) features = features | *target;
+    InstructionSelector selector(abiContract_, features);
+    PeepholeOptimizer peephole;
+
+    AllocationState state = allocator.allocateRegisters(function);
+    result.allocation = allocator.getStats();
+    auto registerMap = RegisterAllocationUtils::createRegisterMapping(state);
+
+    // Los registros ya están fijados: el planificador solo reordena
+    auto body = InstructionScheduler(tune_).schedule(selector.selectInstructions(function, registerMap));
+    body = peephole.optimize(std::move(body));
+
+    // El marco sale de lo que el cuerpo usa de verdad; los valores que
+    // nunca están vivos a la vez comparten hueco
+    std::vector<StackSlot> slots = RegisterAllocationUtils::spillStackSlots(function, state);
+    size_t spillSize = FrameBuilder::layoutStackSlots(slots);
+    FrameLayout frame = FrameBuilder().buildFunctionFrame(frameRequirements(body, spillSize));
+    result.stackSize = static_cast<uint32_t>(frame.allocationSize);
+
+    size_t split = frame.isLeaf ? body.size() : framelessPrefix(body);
+    auto prologue = selector.generateFunctionPrologue(frame);
+    auto epilogue = selector.generateFunctionEpilogue(frame);
+    std::vector<X86Instruction> framed = prologue;
+    for (size_t i = split; i < body.size(); ++i) {
+        if (body[i].opcode == X86Opcode::RET) {
+            framed.insert(framed.end(), epilogue.begin(), epilogue.end());
+        } else if (body[i].opcode == X86Opcode::TAILJMP) {
+            // Epílogo sin RET: el salto deja la pila como la recibió la función
+            framed.insert(framed.end(), epilogue.begin(), epilogue.end() - 1);
+            framed.push_back(std::move(body[i]));
+        } else {
+            framed.push_back(std::move(body[i]));
+        }
+    }
+    body.resize(split);
+
+    // El tramo sin marco y el resto no comparten saltos: se codifican por separado
+    X86Encoder encoder;
+    std::vector<coff::COFFFunctionRelocation> prologueRelocations;
+    encoder.encode(prologue, result.prologueBytes, prologueRelocations);
+    bool encoded = encoder.encode(body, result.code, result.relocations);
+    result.unwindBegin = static_cast<uint32_t>(result.code.size());
+    if (!encoded || !encoder.encode(framed, result.code, result.relocations)) {
+        result.code.clear();
+        result.relocations.clear();
+        result.unwindBegin = 0;
+        result.encodingError = encoder.getLastError();
+    }
+
+    // Las tablas de saltos, con los offsets finales de sus bloques
+    if (!result.code.empty()) {
+        for (const JumpTable& table : selector.jumpTables()) {
+            coff::COFFJumpTable& entry = result.jumpTables.emplace_back();
+            entry.name = table.name;
+            for (const std::string& target : table.targets) {
+                entry.targets.push_back(encoder.labelOffsets().at(target));
+            }
+        }
+    }
+    result.instructions = std::move(body);
+    result.instructions.insert(result.instructions.end(), framed.begin(), framed.end());
+
+    // UNWIND_INFO propio: RVA 0, appendFunctions lo recoloca al coser
+    if (!frame.isLeaf && !result.code.empty()) {
+        unwind::UnwindEmitter emitter;
+        emitter.addFunctionUnwind(0, static_cast<uint32_t>(result.code.size() - result.unwindBegin),
+                                  result.prologueBytes, result.stackSize,
+                                  frame.usesFramePointer ? frame.frameRegister() : 0);
+        result.unwindInfo = emitter.generateXdataSection();
+    }
+
+    return result;
+}
+
+std::vector<FunctionCode> CodeGenerator::generateModule(const ir::IRModule& module, size_t jobs,
+                                                        IncrementalStats* stats) const {
+    std::vector<const ir::IRFunction*> functions;
+    for (const auto& function : module.getFunctions()) {
+        if (function->blockCount() > 0) functions.push_back(function.get());
+    }
+
+    // Cada índice escribe solo su hueco: el orden no depende de los hilos
+    std::vector<FunctionCode> results(functions.size());
+    if (!sharedCache_) {
+        common::utils::parallelFor(functions.size(), jobs, [&](size_t index) {
+            results[index] = generateFunction(*functions[index]);
+        });
+        if (stats) stats->regenerated += functions.size();
+        return results;
+    }
+
+    uint64_t configuration = configurationHash();
+    DeclarationHashes declarations = declarationHashes(module);
+    std::vector<uint8_t> reused(functions.size(), 0);
+    common::utils::parallelFor(functions.size(), jobs, [&](size_t index) {
+        const ir::IRFunction& function = *functions[index];
+        CodegenRecord record;
+        record.dependencyHash = functionHash(function, configuration, declarations, &record.dependencies);
+        if (auto cached = sharedCache_->find(function.getName(), record.dependencyHash)) {
+            results[index] = std::move(cached->code);
+            reused[index] = 1;
+            return;
+        }
+        record.code = generateFunction(function);
+        sharedCache_->store(record);
+        results[index] = std::move(record.code);
+    });
+    if (stats) {
+        for (uint8_t hit : reused) {
+            ++(hit ? stats->reused : stats->regenerated);
+        }
+    }
+    return results;
+}
+
+std::vector<FunctionCode> CodeGenerator::generateModuleIncremental(const ir::IRModule& module,
+                                                                  size_t jobs,
+                                                                  CodegenDatabase& database,
+                                                                  IncrementalStats* stats) const {
+    std::vector<const ir::IRFunction*> functions;
+    for (const auto& function : module.getFunctions()) {
+        if (function->blockCount() > 0) functions.push_back(function.get());
+    }
+
+    uint64_t configuration = configurationHash();
+    DeclarationHashes declarations = declarationHashes(module);
+
+    // Hash, consulta a la base y, si hace falta, generación: todo por función
+    std::vector<CodegenRecord> records(functions.size());
+    std::vector<uint8_t> reused(functions.size(), 0);
+    common::utils::parallelFor(functions.size(), jobs, [&](size_t index) {
+        const ir::IRFunction& function = *functions[index];
+        std::vector<std::string> dependencies;
+        uint64_t hash = functionHash(function, configuration, declarations, &dependencies);
+
+        auto cached = database.find(function.getName(), hash);
+        if (!cached && sharedCache_) {
+            cached = sharedCache_->find(function.getName(), hash);
+        }
+        if (cached) {
+            records[index] = std::move(*cached);
+            reused[index] = 1;
+            return;
+        }
+        records[index].dependencyHash = hash;
+        records[index].dependencies = std::move(dependencies);
+        records[index].code = generateFunction(function);
+        if (sharedCache_) {
+            sharedCache_->store(records[index]);
+        }
+    });
+
+    std::vector<FunctionCode> results;
+    results.reserve(records.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+        if (stats) {
+            ++(reused[i] ? stats->reused : stats->regenerated);
+        }
+        results.push_back(records[i].code);
+        database.store(std::move(records[i]));
+    }
+    return results;
+}
+
+uint64_t CodeGenerator::dependencyHash(const ir::IRFunction& function, const ir::IRModule& module,
+                                       std::vector<std::string>* dependencies) const {
+    return functionHash(function, configurationHash(), declarationHashes(module), dependencies);
+}
+
+uint64_t CodeGenerator::configurationHash() const {
+    using common::utils::hashMix;
+    uint64_t hash = hashMix(0, features_.mask());
+    hash = hashMix(hash, static_cast<uint64_t>(strategy_));
+    return hashMix(hash, static_cast<uint64_t>(tune_));
+}
+
+coff::COFFFunction CodeGenerator::toCOFFFunction(const FunctionCode& code) {
+    coff::COFFFunction function;
+    function.name = code.name;
+    function.code = code.code;
+    function.unwindInfo = code.unwindInfo;
+    function.relocations = code.relocations;
+    function.jumpTables = code.jumpTables;
+    function.unwindBegin = code.unwindBegin;
+    function.comdatSelection = code.comdatSelection;
+    return function;
+}
+
+} // namespace cpp20::compiler::backend
@@ -0,0 +1,181 @@
+/**
+ * @file CodegenDatabase.cpp
+ * @brief Persistencia del código generado por función
+ */
+
+#include <compiler/backend/codegen/CodegenDatabase.h>
+#include <compiler/common/utils/HashUtils.h>
+
+namespace cpp20::compiler::backend {
+
+namespace {
+
+void writeBytes(CacheRecordWriter& writer, const std::vector<uint8_t>& bytes) {
+    writer.str(std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size()));
+}
+
+std::vector<uint8_t> readBytes(CacheRecordReader& reader) {
+    std::string_view data = reader.str();
+    return std::vector<uint8_t>(data.begin(), data.end());
+}
+
+std::string encodeRecord(const CodegenRecord& record) {
+    CacheRecordWriter writer;
+    writer.u64(record.dependencyHash);
+    writer.u32(static_cast<uint32_t>(record.dependencies.size()));
+    for (const auto& dependency : record.dependencies) {
+        writer.str(dependency);
+    }
+
+    const FunctionCode& code = record.code;
+    writeBytes(writer, code.code);
+    writer.u32(static_cast<uint32_t>(code.relocations.size()));
+    for (const auto& relocation : code.relocations) {
+        writer.u32(relocation.offset);
+        writer.str(relocation.symbol);
+        writer.u32(relocation.type);
+    }
+    writer.str(code.encodingError);
+    writeBytes(writer, code.prologueBytes);
+    writeBytes(writer, code.unwindInfo);
+    writer.u32(code.unwindBegin);
+    writer.u8(code.comdatSelection);
+    writer.u32(code.stackSize);
+    writer.u32(static_cast<uint32_t>(code.jumpTables.size()));
+    for (const auto& table : code.jumpTables) {
+        writer.str(table.name);
+        writer.u32(static_cast<uint32_t>(table.targets.size()));
+        for (uint32_t target : table.targets) {
+            writer.u32(target);
+        }
+    }
+    return writer.take();
+}
+
+std::optional<CodegenRecord> decodeRecord(std::string_view name, std::string_view data) {
+    CacheRecordReader reader(data);
+    CodegenRecord record;
+    record.dependencyHash = reader.u64();
+    uint32_t dependencyCount = reader.u32();
+    for (uint32_t i = 0; i < dependencyCount && reader.ok(); ++i) {
+        record.dependencies.emplace_back(reader.str());
+    }
+
+    FunctionCode& code = record.code;
+    code.name = std::string(name);
+    code.code = readBytes(reader);
+    uint32_t relocationCount = reader.u32();
+    for (uint32_t i = 0; i < relocationCount && reader.ok(); ++i) {
+        coff::COFFFunctionRelocation relocation;
+        relocation.offset = reader.u32();
+        relocation.symbol = std::string(reader.str());
+        relocation.type = static_cast<uint16_t>(reader.u32());
+        code.relocations.push_back(std::move(relocation));
+    }
+    code.encodingError = std::string(reader.str());
+    code.prologueBytes = readBytes(reader);
+    code.unwindInfo = readBytes(reader);
+    code.unwindBegin = reader.u32();
+    code.comdatSelection = reader.u8();
+    code.stackSize = reader.u32();
+    uint32_t tableCount = reader.u32();
+    for (uint32_t i = 0; i < tableCount && reader.ok(); ++i) {
+        coff::COFFJumpTable& table = code.jumpTables.emplace_back();
+        table.name = std::string(reader.str());
+        uint32_t entryCount = reader.u32();
+        for (uint32_t e = 0; e < entryCount && reader.ok(); ++e) {
+            table.targets.push_back(reader.u32());
+        }
+    }
+
+    if (!reader.ok() || !reader.atEnd()) {
+        return std::nullopt;
+    }
+    return record;
+}
+
+} // namespace
+
+std::filesystem::path CodegenDatabase::fileFor(const std::filesystem::path& objectFile) {
+    std::filesystem::path path = objectFile;
+    path += ".cgdb";
+    return path;
+}
+
+bool CodegenDatabase::load(const std::filesystem::path& path) {
+    persisted_ = CacheFileReader::open(path, FileKind);
+    records_.clear();
+    return persisted_ != nullptr;
+}
+
+bool CodegenDatabase::save(const std::filesystem::path& path) const {
+    try {
+        CacheFileWriter writer;
+        for (const auto& [name, record] : records_) {
+            writer.add(common::utils::fnv1a64(name), name, encodeRecord(record));
+        }
+        return writer.write(path, FileKind);
+
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+std::optional<CodegenRecord> CodegenDatabase::find(const std::string& name,
+                                                   uint64_t dependencyHash) const {
+    if (!persisted_) return std::nullopt;
+
+    auto [first, last] = persisted_->equalRange(common::utils::fnv1a64(name));
+    for (size_t i = first; i < last; ++i) {
+        auto record = persisted_->record(i);
+        if (!record || record->key != name) continue;
+
+        // El hash va primero: un registro obsoleto se descarta sin decodificarlo
+        CacheRecordReader header(record->value);
+        if (header.u64() != dependencyHash || !header.ok()) {
+            return std::nullopt;
+        }
+        return decodeRecord(name, record->value);
+    }
+    return std::nullopt;
+}
+
+void CodegenDatabase::store(CodegenRecord record) {
+    std::string name = record.code.name;
+    records_[std::move(name)] = std::move(record);
+}
+
+MachineCodeCache::MachineCodeCache(std::shared_ptr<CacheBackend> backend, std::string_view compilerId)
+    : backend_(backend), secondary_(std::move(backend), SecondaryCache::namespaceKeyFor(compilerId, FileKind)) {
+}
+
+std::string MachineCodeCache::address(const std::string& name, uint64_t dependencyHash) const {
+    return secondary_.address(FileKind, common::utils::fnv1a64(name, dependencyHash));
+}
+
+std::optional<CodegenRecord> MachineCodeCache::find(const std::string& name, uint64_t dependencyHash) const {
+    lookups_.fetch_add(1, std::memory_order_relaxed);
+    auto data = backend_->fetch(address(name, dependencyHash));
+    if (!data) return std::nullopt;
+
+    // El nombre va delante: una colisión de dirección no entrega código ajeno
+    CacheRecordReader reader(*data);
+    std::string_view stored = reader.str();
+    std::string_view encoded = reader.str();
+    if (!reader.ok() || !reader.atEnd() || stored != name) return std::nullopt;
+    auto record = decodeRecord(name, encoded);
+    if (!record || record->dependencyHash != dependencyHash) return std::nullopt;
+
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return record;
+}
+
+void MachineCodeCache::store(const CodegenRecord& record) {
+    if (!record.code.encodingError.empty()) return;
+    CacheRecordWriter writer;
+    writer.str(record.code.name);
+    writer.str(encodeRecord(record));
+    secondary_.writeBehind(address(record.code.name, record.dependencyHash), writer.take());
+}
+
+} // namespace cpp20::compiler::backend
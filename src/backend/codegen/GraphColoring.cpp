@@ -0,0 +1,744 @@
+/**
+ * @file GraphColoring.cpp
+ * @brief Asignación de registros por coloreado de grafos con coalescing iterado
+ */
+
+#include <compiler/backend/codegen/RegisterAllocator.h>
+#include <compiler/backend/codegen/Liveness.h>
+#include <compiler/backend/codegen/X86Encoder.h>
+#include <compiler/ir/IRAnalysis.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+
+namespace cpp20::compiler::backend {
+
+namespace {
+
+constexpr uint32_t NoNode = NoLiveIndex;
+
+/**
+ * @brief Coalescing iterado de George y Appel sobre los valores SSA
+ *
+ * Las copias a considerar son las implícitas de los phis. Los cuatro
+ * primeros parámetros llegan precoloreados en su registro de Windows x64
+ * (RCX/RDX/R8/R9 o XMM0-XMM3 según la posición), y un valor vivo a
+ * través de una llamada solo puede recibir registros no volátiles: los
+ * volátiles cuentan como vecinos que nunca se simplifican. Un parámetro
+ * que cruza una llamada no puede seguir en su registro de entrada y se
+ * colorea como los demás; la copia, como el paso de argumentos, queda
+ * para la selección.
+ */
+class GraphColoring {
+public:
+    GraphColoring(const ir::IRFunction& function, const std::vector<X86Register>& general,
+                  const std::vector<X86Register>& xmm)
+        : function_(function), registers_{general, xmm},
+          cfg_(function), domTree_(cfg_), loops_(cfg_, domTree_), liveness_(function, cfg_) {
+        for (uint8_t registerClass = 0; registerClass < 2; ++registerClass) {
+            for (size_t color = 0; color < registers_[registerClass].size(); ++color) {
+                if (!isCalleeSaved(registers_[registerClass][color])) volatile_[registerClass] |= 1u << color;
+            }
+        }
+    }
+
+    AllocationState run();
+
+private:
+    enum class NodeState : uint8_t {
+        Initial, Precolored, Simplify, Freeze, Spill, Coalesced, Colored, Stack, Spilled
+    };
+    enum class MoveState : uint8_t { Worklist, Active, Coalesced, Constrained, Frozen };
+
+    struct Move {
+        uint32_t dst;
+        uint32_t src;
+    };
+
+    const ir::IRFunction& function_;
+    std::array<std::vector<X86Register>, 2> registers_;     // General y XMM
+    ir::ControlFlowGraph cfg_;
+    ir::DominatorTree domTree_;
+    ir::LoopInfo loops_;
+    LivenessAnalysis liveness_;         // Los nodos son sus índices densos
+
+    std::vector<uint8_t> class_;
+    std::vector<double> cost_;
+    std::array<uint32_t, 2> volatile_{};        // Colores que una llamada destruye, por clase
+    std::vector<uint32_t> excluded_;            // Colores prohibidos: los vivos a través de una llamada
+
+    std::vector<uint32_t> split_;
+    std::vector<SpillPlacement> splitCode_;     // spillSlot se fija al final
+
+    std::vector<uint64_t> adjSet_;              // Aristas (min << 32 | max) ordenadas
+    std::vector<std::vector<uint32_t>> adjList_;
+    std::vector<uint32_t> degree_;
+
+    std::vector<Move> moves_;
+    std::vector<MoveState> moveState_;
+    std::vector<std::vector<uint32_t>> moveList_;
+    std::vector<uint32_t> worklistMoves_;
+    size_t coalescedMoves_ = 0;
+
+    std::vector<NodeState> state_;
+    std::vector<uint32_t> alias_;
+    std::vector<uint32_t> color_;
+    std::vector<uint32_t> simplifyWorklist_;
+    std::vector<uint32_t> freezeWorklist_;
+    std::vector<uint32_t> spillWorklist_;
+    std::vector<uint32_t> selectStack_;
+
+    uint32_t node(ir::ValueId value) const { return liveness_.index(value); }
+    size_t nodeCount() const { return liveness_.size(); }
+    size_t registerCount(uint32_t node) const { return registers_[class_[node]].size(); }
+    bool precolored(uint32_t node) const { return state_[node] == NodeState::Precolored; }
+
+    static bool isCalleeSaved(X86Register reg) {
+        // XMM6-XMM15 son no volátiles en Windows x64
+        if (reg >= X86Register::XMM0) return reg >= X86Register::XMM6;
+        return abi::ABIContract::isCalleeSavedRegister(X86Encoder::registerNumber(reg));
+    }
+
+    void createNodes();
+    size_t maxPressure(ir::BlockId block, uint8_t registerClass) const;
+    void splitAroundLoops();
+    void build();
+    void precolorParameters();
+
+    bool interferes(uint32_t u, uint32_t v) const;
+    void addEdge(uint32_t u, uint32_t v);
+    std::vector<uint32_t> adjacent(uint32_t node) const;
+    bool moveRelated(uint32_t node) const;
+    void enableMoves(uint32_t node);
+    void push(std::vector<uint32_t>& worklist, uint32_t node, NodeState state);
+    uint32_t pop(std::vector<uint32_t>& worklist, NodeState state);
+    uint32_t alias(uint32_t node) const;
+
+    void makeWorklist();
+    void simplify(uint32_t node);
+    void decrementDegree(uint32_t node);
+    void coalesce(uint32_t move);
+    void addWorkList(uint32_t node);
+    bool conservative(uint32_t u, uint32_t v) const;
+    bool george(uint32_t u, uint32_t v) const;
+    void combine(uint32_t u, uint32_t v);
+    void freezeMoves(uint32_t node);
+    uint32_t chooseSpill();
+    void assignColors();
+};
+
+void GraphColoring::createNodes() {
+    for (uint32_t n = 0; n < nodeCount(); ++n) {
+        const ir::TypeInfo& type = function_.typeOf(liveness_.value(n));
+        class_.push_back(type.isFloatingPoint() || type.isVector() ? 1 : 0);
+    }
+
+    // Coste de spill: cada definición y uso pesa las ejecuciones del bloque
+    // por llamada según el perfil o, sin él, 10^profundidad del bucle
+    auto blockWeight = [&](ir::BlockId block) {
+        double relative = function_.relativeFrequency(block);
+        return relative >= 0.0 ? relative : std::pow(10.0, std::min<uint32_t>(loops_.depth(block), 6));
+    };
+    cost_.assign(nodeCount(), 0.0);
+    for (size_t i = 0; i < function_.getParamTypes().size(); ++i) {
+        if (node(function_.parameter(i)) != NoNode) cost_[node(function_.parameter(i))] += 1.0;
+    }
+    for (ir::BlockId block : cfg_.reversePostOrder()) {
+        double weight = blockWeight(block);
+        for (ir::InstrId id : function_.instructions(block)) {
+            const ir::Instruction& inst = function_.instruction(id);
+            if (node(inst.result) != NoNode) cost_[node(inst.result)] += weight;
+            for (size_t i = 0; i < inst.operandCount; ++i) {
+                ir::ValueId operand = function_.operand(id, i);
+                if (inst.opcode == ir::IROpcode::Phi && i % 2 == 0) {
+                    ir::BlockId pred = function_.labelBlock(function_.operand(id, i + 1));
+                    if (node(operand) != NoNode) {
+                        cost_[node(operand)] += blockWeight(pred);
+                    }
+                } else if (node(operand) != NoNode) {
+                    cost_[node(operand)] += weight;
+                }
+            }
+        }
+    }
+
+    // Sin store y con un MOV o LEA por recarga: se eligen antes que los que pasan por memoria
+    for (uint32_t n = 0; n < nodeCount(); ++n) {
+        if (RegisterAllocator::isRematerializable(function_, liveness_.value(n))) cost_[n] *= 0.25;
+    }
+}
+
+size_t GraphColoring::maxPressure(ir::BlockId block, uint8_t registerClass) const {
+    LiveSet live = liveness_.liveOut(block);
+    size_t count = 0;
+    live.forEach([&](uint32_t n) { count += class_[n] == registerClass; });
+
+    size_t pressure = count;
+    for (ir::InstrId id = function_.block(block).last; id != ir::NoInstr; id = function_.instruction(id).prev) {
+        const ir::Instruction& inst = function_.instruction(id);
+        if (inst.opcode == ir::IROpcode::Phi) break;
+        uint32_t def = node(inst.result);
+        if (def != NoNode && live.test(def)) {
+            live.reset(def);
+            count -= class_[def] == registerClass;
+        }
+        for (size_t i = 0; i < inst.operandCount; ++i) {
+            uint32_t used = node(function_.operand(id, i));
+            if (used != NoNode && !live.test(used)) {
+                live.set(used);
+                count += class_[used] == registerClass;
+            }
+        }
+        pressure = std::max(pressure, count);
+    }
+
+    size_t top = 0;
+    liveness_.liveIn(block).forEach([&](uint32_t n) { top += class_[n] == registerClass; });
+    return std::max(pressure, top);
+}
+
+void GraphColoring::splitAroundLoops() {
+    const auto& loops = loops_.loops();
+
+    // De fuera hacia dentro: un valor partido en un bucle ya no vive en los internos
+    for (size_t index = loops.size(); index-- > 0;) {
+        const ir::Loop& loop = loops[index];
+        auto loopId = static_cast<uint32_t>(index);
+        ir::BlockId preheader = loops_.preheader(cfg_, loopId);
+        if (preheader == ir::NoBlock) continue;
+
+        // Salidas dedicadas: el reload no debe verse desde caminos sin el store
+        std::vector<ir::BlockId> exits;
+        bool dedicated = true;
+        for (ir::BlockId block : loop.blocks) {
+            for (ir::BlockId succ : cfg_.successors(block)) {
+                if (loops_.contains(loopId, succ) || std::find(exits.begin(), exits.end(), succ) != exits.end()) {
+                    continue;
+                }
+                exits.push_back(succ);
+                for (ir::BlockId pred : cfg_.predecessors(succ)) {
+                    if (!loops_.contains(loopId, pred)) dedicated = false;
+                }
+            }
+        }
+        if (!dedicated) continue;
+
+        LiveSet touched(nodeCount());
+        for (ir::BlockId block : loop.blocks) {
+            for (ir::InstrId id : function_.instructions(block)) {
+                const ir::Instruction& inst = function_.instruction(id);
+                if (node(inst.result) != NoNode) touched.set(node(inst.result));
+                for (size_t i = 0; i < inst.operandCount; ++i) {
+                    if (node(function_.operand(id, i)) != NoNode) touched.set(node(function_.operand(id, i)));
+                }
+            }
+        }
+
+        for (uint8_t registerClass = 0; registerClass < 2; ++registerClass) {
+            size_t pressure = 0;
+            for (ir::BlockId block : loop.blocks) pressure = std::max(pressure, maxPressure(block, registerClass));
+            size_t available = registers_[registerClass].size();
+            if (pressure <= available) continue;
+
+            // Valores que solo atraviesan el bucle; primero los que viven en menos salidas
+            std::vector<std::pair<size_t, uint32_t>> candidates;
+            liveness_.liveIn(loop.header).forEach([&](uint32_t n) {
+                if (class_[n] != registerClass || touched.test(n)) return;
+                size_t liveExits = 0;
+                for (ir::BlockId exit : exits) liveExits += liveness_.liveIn(exit).test(n);
+                candidates.emplace_back(liveExits, n);
+            });
+            std::sort(candidates.begin(), candidates.end());
+            candidates.resize(std::min(candidates.size(), pressure - available));
+
+            for (auto [liveExits, n] : candidates) {
+                for (ir::BlockId block : loop.blocks) liveness_.removeFromBlock(block, n);
+
+                int virtualReg = static_cast<int>(liveness_.value(n));
+                splitCode_.push_back({virtualReg, -1, preheader, function_.terminator(preheader), false});
+                for (ir::BlockId exit : exits) {
+                    if (!liveness_.liveIn(exit).test(n)) continue;
+                    ir::InstrId position = function_.block(exit).first;
+                    while (position != ir::NoInstr &&
+                           function_.instruction(position).opcode == ir::IROpcode::Phi) {
+                        position = function_.instruction(position).next;
+                    }
+                    splitCode_.push_back({virtualReg, -1, exit, position, true});
+                }
+                split_.push_back(n);
+            }
+        }
+    }
+}
+
+bool GraphColoring::interferes(uint32_t u, uint32_t v) const {
+    uint64_t key = uint64_t{std::min(u, v)} << 32 | std::max(u, v);
+    return std::binary_search(adjSet_.begin(), adjSet_.end(), key);
+}
+
+void GraphColoring::addEdge(uint32_t u, uint32_t v) {
+    if (u == v || class_[u] != class_[v]) return;
+    uint64_t key = uint64_t{std::min(u, v)} << 32 | std::max(u, v);
+    auto it = std::lower_bound(adjSet_.begin(), adjSet_.end(), key);
+    if (it != adjSet_.end() && *it == key) return;
+    adjSet_.insert(it, key);
+    adjList_[u].push_back(v);
+    adjList_[v].push_back(u);
+    ++degree_[u];
+    ++degree_[v];
+}
+
+void GraphColoring::build() {
+    size_t count = nodeCount();
+    adjList_.assign(count, {});
+    degree_.assign(count, 0);
+    moveList_.assign(count, {});
+    excluded_.assign(count, 0);
+
+    // Primero se recogen las aristas y se ordenan: insertar una a una
+    // en el vector ordenado sería cuadrático
+    std::vector<uint64_t> edges;
+    auto collect = [&](uint32_t u, uint32_t v) {
+        if (u != v && class_[u] == class_[v]) edges.push_back(uint64_t{std::min(u, v)} << 32 | std::max(u, v));
+    };
+
+    for (ir::BlockId block : cfg_.reversePostOrder()) {
+        LiveSet live = liveness_.liveOut(block);
+        std::vector<uint32_t> top;
+
+        for (ir::InstrId id = function_.block(block).last; id != ir::NoInstr; id = function_.instruction(id).prev) {
+            const ir::Instruction& inst = function_.instruction(id);
+            if (inst.opcode == ir::IROpcode::Phi) {
+                if (node(inst.result) != NoNode) top.push_back(node(inst.result));
+                continue;
+            }
+            uint32_t def = node(inst.result);
+            if (def != NoNode) {
+                live.forEach([&](uint32_t other) { collect(def, other); });
+                live.reset(def);
+            }
+            // Lo que sigue vivo tras la llamada la cruza
+            if (inst.opcode == ir::IROpcode::Call) {
+                live.forEach([&](uint32_t other) { excluded_[other] |= volatile_[class_[other]]; });
+            }
+            for (size_t i = 0; i < inst.operandCount; ++i) {
+                if (node(function_.operand(id, i)) != NoNode) live.set(node(function_.operand(id, i)));
+            }
+        }
+
+        // Phis (y parámetros en la entrada) se definen a la vez al entrar al bloque
+        if (block == 0) {
+            for (size_t i = 0; i < function_.getParamTypes().size(); ++i) {
+                if (node(function_.parameter(i)) != NoNode) top.push_back(node(function_.parameter(i)));
+            }
+        }
+        for (uint32_t def : top) live.set(def);
+        for (uint32_t def : top) {
+            live.forEach([&](uint32_t other) { collect(def, other); });
+        }
+    }
+
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    for (uint64_t edge : edges) {
+        auto u = static_cast<uint32_t>(edge >> 32);
+        auto v = static_cast<uint32_t>(edge);
+        adjList_[u].push_back(v);
+        adjList_[v].push_back(u);
+        ++degree_[u];
+        ++degree_[v];
+    }
+    adjSet_ = std::move(edges);
+    for (uint32_t n = 0; n < count; ++n) degree_[n] += static_cast<uint32_t>(std::popcount(excluded_[n]));
+
+    // Copias implícitas de los phis
+    for (ir::BlockId block : cfg_.reversePostOrder()) {
+        for (ir::InstrId id : function_.instructions(block)) {
+            const ir::Instruction& inst = function_.instruction(id);
+            if (inst.opcode != ir::IROpcode::Phi) break;
+            uint32_t dst = node(inst.result);
+            if (dst == NoNode) continue;
+            for (size_t i = 0; i < inst.operandCount; i += 2) {
+                uint32_t src = node(function_.operand(id, i));
+                if (src == NoNode || src == dst || class_[src] != class_[dst]) continue;
+                auto move = static_cast<uint32_t>(moves_.size());
+                moves_.push_back({dst, src});
+                moveState_.push_back(MoveState::Worklist);
+                moveList_[dst].push_back(move);
+                moveList_[src].push_back(move);
+                worklistMoves_.push_back(move);
+            }
+        }
+    }
+}
+
+void GraphColoring::precolorParameters() {
+    static constexpr X86Register kArguments[2][4] = {
+        {X86Register::RCX, X86Register::RDX, X86Register::R8, X86Register::R9},
+        {X86Register::XMM0, X86Register::XMM1, X86Register::XMM2, X86Register::XMM3},
+    };
+    size_t count = std::min<size_t>(function_.getParamTypes().size(), abi::ABIContract::MAX_INTEGER_ARGS_IN_REGS);
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t n = node(function_.parameter(i));
+        if (n == NoNode) continue;
+        // Los vectores y los agregados grandes llegan por referencia
+        const ir::TypeInfo& type = function_.typeOf(function_.parameter(i));
+        if (type.isVector() || type.size > 8) continue;
+
+        const auto& registers = registers_[class_[n]];
+        auto color = static_cast<uint32_t>(std::find(registers.begin(), registers.end(), kArguments[class_[n]][i]) -
+                                           registers.begin());
+        if (color == registers.size() || (excluded_[n] >> color & 1)) continue;
+        state_[n] = NodeState::Precolored;
+        color_[n] = color;
+    }
+}
+
+std::vector<uint32_t> GraphColoring::adjacent(uint32_t n) const {
+    std::vector<uint32_t> result;
+    for (uint32_t other : adjList_[n]) {
+        if (state_[other] != NodeState::Stack && state_[other] != NodeState::Coalesced) result.push_back(other);
+    }
+    return result;
+}
+
+bool GraphColoring::moveRelated(uint32_t n) const {
+    for (uint32_t move : moveList_[n]) {
+        if (moveState_[move] == MoveState::Active || moveState_[move] == MoveState::Worklist) return true;
+    }
+    return false;
+}
+
+void GraphColoring::enableMoves(uint32_t n) {
+    for (uint32_t move : moveList_[n]) {
+        if (moveState_[move] == MoveState::Active) {
+            moveState_[move] = MoveState::Worklist;
+            worklistMoves_.push_back(move);
+        }
+    }
+}
+
+void GraphColoring::push(std::vector<uint32_t>& worklist, uint32_t n, NodeState state) {
+    state_[n] = state;
+    worklist.push_back(n);
+}
+
+uint32_t GraphColoring::pop(std::vector<uint32_t>& worklist, NodeState state) {
+    // Las listas son perezosas: una entrada vale si el nodo sigue en ese estado
+    while (!worklist.empty()) {
+        uint32_t n = worklist.back();
+        worklist.pop_back();
+        if (state_[n] == state) return n;
+    }
+    return NoNode;
+}
+
+uint32_t GraphColoring::alias(uint32_t n) const {
+    while (state_[n] == NodeState::Coalesced) n = alias_[n];
+    return n;
+}
+
+void GraphColoring::makeWorklist() {
+    for (uint32_t n = 0; n < nodeCount(); ++n) {
+        if (precolored(n)) continue;
+        if (degree_[n] >= registerCount(n)) {
+            push(spillWorklist_, n, NodeState::Spill);
+        } else if (moveRelated(n)) {
+            push(freezeWorklist_, n, NodeState::Freeze);
+        } else {
+            push(simplifyWorklist_, n, NodeState::Simplify);
+        }
+    }
+}
+
+void GraphColoring::simplify(uint32_t n) {
+    state_[n] = NodeState::Stack;
+    selectStack_.push_back(n);
+    for (uint32_t other : adjacent(n)) decrementDegree(other);
+}
+
+void GraphColoring::decrementDegree(uint32_t n) {
+    // Grado infinito: un precoloreado nunca pasa a las listas
+    if (precolored(n)) return;
+    uint32_t degree = degree_[n]--;
+    if (degree != registerCount(n)) return;
+
+    enableMoves(n);
+    for (uint32_t other : adjacent(n)) enableMoves(other);
+    if (state_[n] != NodeState::Spill) return;
+    if (moveRelated(n)) {
+        push(freezeWorklist_, n, NodeState::Freeze);
+    } else {
+        push(simplifyWorklist_, n, NodeState::Simplify);
+    }
+}
+
+void GraphColoring::addWorkList(uint32_t n) {
+    if (state_[n] == NodeState::Freeze && !moveRelated(n) && degree_[n] < registerCount(n)) {
+        push(simplifyWorklist_, n, NodeState::Simplify);
+    }
+}
+
+bool GraphColoring::conservative(uint32_t u, uint32_t v) const {
+    // Briggs: el nodo combinado tiene menos de K vecinos de grado significativo
+    std::vector<uint32_t> neighbors = adjacent(u);
+    for (uint32_t other : adjacent(v)) neighbors.push_back(other);
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+
+    // Los registros que prohíbe una llamada son vecinos de grado infinito
+    size_t significant = static_cast<size_t>(std::popcount(excluded_[u] | excluded_[v]));
+    for (uint32_t other : neighbors) significant += precolored(other) || degree_[other] >= registerCount(other);
+    return significant < registerCount(u);
+}
+
+bool GraphColoring::george(uint32_t u, uint32_t v) const {
+    // George, con u precoloreado: cada vecino de v es trivial o ya vecino de u
+    if (excluded_[v] >> color_[u] & 1) return false;
+    for (uint32_t other : adjacent(v)) {
+        if (!precolored(other) && degree_[other] >= registerCount(other) && !interferes(other, u)) return false;
+    }
+    return true;
+}
+
+void GraphColoring::coalesce(uint32_t move) {
+    uint32_t u = alias(moves_[move].dst);
+    uint32_t v = alias(moves_[move].src);
+    if (precolored(v)) std::swap(u, v);
+
+    if (u == v) {
+        moveState_[move] = MoveState::Coalesced;
+        ++coalescedMoves_;
+        addWorkList(u);
+    } else if (precolored(v) || interferes(u, v)) {
+        moveState_[move] = MoveState::Constrained;
+        addWorkList(u);
+        addWorkList(v);
+    } else if (precolored(u) ? george(u, v) : conservative(u, v)) {
+        moveState_[move] = MoveState::Coalesced;
+        ++coalescedMoves_;
+        combine(u, v);
+        addWorkList(u);
+    } else {
+        moveState_[move] = MoveState::Active;
+    }
+}
+
+void GraphColoring::combine(uint32_t u, uint32_t v) {
+    state_[v] = NodeState::Coalesced;
+    alias_[v] = u;
+    moveList_[u].insert(moveList_[u].end(), moveList_[v].begin(), moveList_[v].end());
+    cost_[u] += cost_[v];
+    degree_[u] += static_cast<uint32_t>(std::popcount(excluded_[v] & ~excluded_[u]));
+    excluded_[u] |= excluded_[v];
+    enableMoves(v);
+
+    for (uint32_t other : adjacent(v)) {
+        addEdge(other, u);
+        decrementDegree(other);
+    }
+    if (degree_[u] >= registerCount(u) && state_[u] == NodeState::Freeze) {
+        push(spillWorklist_, u, NodeState::Spill);
+    }
+}
+
+void GraphColoring::freezeMoves(uint32_t u) {
+    for (uint32_t move : moveList_[u]) {
+        if (moveState_[move] != MoveState::Active && moveState_[move] != MoveState::Worklist) continue;
+        uint32_t x = alias(moves_[move].dst);
+        uint32_t y = alias(moves_[move].src);
+        uint32_t v = y == alias(u) ? x : y;
+        moveState_[move] = MoveState::Frozen;
+        if (state_[v] == NodeState::Freeze && !moveRelated(v) && degree_[v] < registerCount(v)) {
+            push(simplifyWorklist_, v, NodeState::Simplify);
+        }
+    }
+}
+
+uint32_t GraphColoring::chooseSpill() {
+    // Menor coste por vecino: los valores usados fuera de bucles van primero
+    uint32_t best = NoNode;
+    double bestRatio = 0.0;
+    std::vector<uint32_t> valid;
+    std::vector<bool> seen(nodeCount(), false);
+    for (uint32_t n : spillWorklist_) {
+        if (state_[n] != NodeState::Spill || seen[n]) continue;
+        seen[n] = true;
+        valid.push_back(n);
+        double ratio = cost_[n] / std::max<uint32_t>(degree_[n], 1);
+        if (best == NoNode || ratio < bestRatio) {
+            best = n;
+            bestRatio = ratio;
+        }
+    }
+    spillWorklist_ = std::move(valid);
+    return best;
+}
+
+void GraphColoring::assignColors() {
+    while (!selectStack_.empty()) {
+        uint32_t n = selectStack_.back();
+        selectStack_.pop_back();
+
+        std::vector<bool> available(registerCount(n), true);
+        for (size_t color = 0; color < available.size(); ++color) {
+            if (excluded_[n] >> color & 1) available[color] = false;
+        }
+        for (uint32_t other : adjList_[n]) {
+            uint32_t root = alias(other);
+            if (state_[root] == NodeState::Colored || precolored(root)) available[color_[root]] = false;
+        }
+
+        auto chosen = std::find(available.begin(), available.end(), true);
+        if (chosen == available.end()) {
+            state_[n] = NodeState::Spilled;
+        } else {
+            state_[n] = NodeState::Colored;
+            color_[n] = static_cast<uint32_t>(chosen - available.begin());
+        }
+    }
+}
+
+AllocationState GraphColoring::run() {
+    createNodes();
+    splitAroundLoops();
+    build();
+
+    state_.assign(nodeCount(), NodeState::Initial);
+    alias_.assign(nodeCount(), NoNode);
+    color_.assign(nodeCount(), NoNode);
+    precolorParameters();
+    makeWorklist();
+
+    while (true) {
+        uint32_t n;
+        if ((n = pop(simplifyWorklist_, NodeState::Simplify)) != NoNode) {
+            simplify(n);
+        } else if (!worklistMoves_.empty()) {
+            uint32_t move = worklistMoves_.back();
+            worklistMoves_.pop_back();
+            if (moveState_[move] == MoveState::Worklist) coalesce(move);
+        } else if ((n = pop(freezeWorklist_, NodeState::Freeze)) != NoNode) {
+            push(simplifyWorklist_, n, NodeState::Simplify);
+            freezeMoves(n);
+        } else if ((n = chooseSpill()) != NoNode) {
+            push(simplifyWorklist_, n, NodeState::Simplify);
+            freezeMoves(n);
+        } else {
+            break;
+        }
+    }
+    assignColors();
+
+    AllocationState state;
+    state.coalescedMoves = coalescedMoves_;
+
+    // Slots: los grupos coalescidos comparten slot, y dos grupos en memoria
+    // (spilled o partidos) pueden compartirlo si no están vivos a la vez.
+    // El grafo de registros no sirve: no une valores de distinta clase
+    std::vector<bool> inMemory(nodeCount(), false);
+    for (uint32_t n = 0; n < nodeCount(); ++n) inMemory[n] = state_[n] == NodeState::Spilled;
+    for (uint32_t n : split_) inMemory[alias(n)] = true;
+
+    std::vector<std::vector<uint32_t>> neighbors(nodeCount());
+    auto conflict = [&](uint32_t u, uint32_t v) {
+        u = alias(u);
+        v = alias(v);
+        if (u == v || !inMemory[u] || !inMemory[v]) return;
+        neighbors[u].push_back(v);
+        neighbors[v].push_back(u);
+    };
+    for (ir::BlockId block : cfg_.reversePostOrder()) {
+        LiveSet live = liveness_.liveOut(block);
+        std::vector<uint32_t> top;
+        for (ir::InstrId id = function_.block(block).last; id != ir::NoInstr; id = function_.instruction(id).prev) {
+            const ir::Instruction& inst = function_.instruction(id);
+            if (inst.opcode == ir::IROpcode::Phi) {
+                if (node(inst.result) != NoNode) top.push_back(node(inst.result));
+                continue;
+            }
+            uint32_t def = node(inst.result);
+            if (def != NoNode) {
+                if (inMemory[alias(def)]) live.forEach([&](uint32_t other) { conflict(def, other); });
+                live.reset(def);
+            }
+            for (size_t i = 0; i < inst.operandCount; ++i) {
+                if (node(function_.operand(id, i)) != NoNode) live.set(node(function_.operand(id, i)));
+            }
+        }
+        if (block == 0) {
+            for (size_t i = 0; i < function_.getParamTypes().size(); ++i) {
+                if (node(function_.parameter(i)) != NoNode) top.push_back(node(function_.parameter(i)));
+            }
+        }
+        for (uint32_t def : top) live.set(def);
+        for (uint32_t def : top) {
+            if (inMemory[alias(def)]) live.forEach([&](uint32_t other) { conflict(def, other); });
+        }
+    }
+
+    std::vector<int> slotOf(nodeCount(), -1);
+    int slots = 0;
+    for (uint32_t n = 0; n < nodeCount(); ++n) {
+        if (alias(n) != n || !inMemory[n]) continue;
+        std::vector<bool> used(static_cast<size_t>(slots) + 1, false);
+        for (uint32_t other : neighbors[n]) {
+            if (slotOf[other] >= 0) used[slotOf[other]] = true;
+        }
+        slotOf[n] = static_cast<int>(std::find(used.begin(), used.end(), false) - used.begin());
+        slots = std::max(slots, slotOf[n] + 1);
+    }
+
+    for (uint32_t n = 0; n < nodeCount(); ++n) {
+        uint32_t root = alias(n);
+        int virtualReg = static_cast<int>(liveness_.value(n));
+        if (state_[root] == NodeState::Spilled) {
+            // Se opera sobre el registro de recarga, reservado fuera del coloreado
+            state.virtualToPhysical[virtualReg] = class_[n] == 0 ? X86Register::R11 : X86Register::XMM15;
+            state.spilledRegisters.push_back(virtualReg);
+            state.spillSlots[virtualReg] = slotOf[root];
+        } else {
+            state.virtualToPhysical[virtualReg] = registers_[class_[n]][color_[root]];
+        }
+    }
+
+    // Los rangos partidos que acabaron spilled ya tienen su slot completo
+    for (uint32_t n : split_) {
+        if (state_[alias(n)] == NodeState::Spilled) continue;
+        int virtualReg = static_cast<int>(liveness_.value(n));
+        state.spillSlots[virtualReg] = slotOf[alias(n)];
+        ++state.splitRanges;
+        for (SpillPlacement placement : splitCode_) {
+            if (placement.virtualReg != virtualReg) continue;
+            placement.spillSlot = state.spillSlots[virtualReg];
+            state.spillCode.push_back(placement);
+        }
+    }
+
+    state.nextSpillSlot = slots;
+    state.maxSpillSlots = static_cast<size_t>(slots);
+    return state;
+}
+
+} // namespace
+
+// ============================================================================
+// RegisterAllocator - Coloreado de grafos
+// ============================================================================
+
+AllocationState RegisterAllocator::graphColoringAllocation(const ir::IRFunction& function) {
+    // R10/R11 y XMM14/XMM15 se reservan para recargar valores spilled
+    std::vector<X86Register> general;
+    for (X86Register reg : availableRegisters_) {
+        if (reg != X86Register::R10 && reg != X86Register::R11) general.push_back(reg);
+    }
+    std::vector<X86Register> xmm;
+    for (int i = 0; i < 14; ++i) {
+        xmm.push_back(static_cast<X86Register>(static_cast<int>(X86Register::XMM0) + i));
+    }
+
+    return GraphColoring(function, general, xmm).run();
+}
+
+} // namespace cpp20::compiler::backend
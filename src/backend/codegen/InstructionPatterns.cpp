@@ -0,0 +1,886 @@
+/**
+ * @file InstructionPatterns.cpp
+ * @brief Tabla de patrones x86-64 y cobertura de bloques por tiles
+ */
+
+#include <compiler/backend/codegen/InstructionSelector.h>
+#include <array>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace cpp20::compiler::backend {
+
+namespace {
+
+/**
+ * @brief Forma que debe tener un operando IR para que el patrón aplique
+ */
+enum class Shape : uint8_t {
+    None,       // Sin operando
+    Any,        // Registro o constante: se copia al destino
+    Reg,        // Valor en registro
+    Imm,        // Constante entera de 32 bits
+    Mem,        // Load de un solo uso plegado como operando memoria
+    Scaled,     // Shl por 1..3 o Mul por 2/4/8, plegado como índice escalado
+    Factor,     // Constante 3, 5 o 9: Mul como LEA [a + a*(k-1)]
+    Cmp,        // Comparación de un solo uso fusionada con el salto
+    Addr        // Dirección: se pliega lo que se pueda en base+índice*escala+desp
+};
+
+/**
+ * @brief Forma de emitir un patrón
+ */
+enum class Tile : uint8_t {
+    Load,           // MOV r, [dir]
+    Store,          // MOV [dir], v
+    Binary,         // MOV r, a ; OP r, b
+    BinarySwapped,  // Igual, con el operando memoria a la izquierda (conmutativas)
+    Lea,            // LEA r, [base + índice*escala + desp]
+    ImulImm,        // IMUL r, a, imm
+    Unary,          // MOV r, a ; OP r
+    CmpBranch,      // CMP a, b ; Jcc
+    TestBranch      // TEST c, c ; JNE
+};
+
+struct Pattern {
+    ir::IROpcode root;
+    std::array<Shape, 2> operands;  // Forma de los operandos 0 y 1 de la raíz
+    Tile tile;
+    X86Opcode opcode;
+    uint8_t cost;                   // Instrucciones sin contar la copia al destino; IMUL cuenta 3
+};
+
+using ir::IROpcode;
+using S = Shape;
+
+/**
+ * @brief Patrones agrupados por opcode raíz; a igual coste gana el primero
+ *
+ * ADD va antes que LEA porque es más corto cuando el destino ya es el
+ * operando izquierdo; si hay que copiarlo, LEA ahorra la copia.
+ */
+inline constexpr auto kPatterns = std::to_array<Pattern>({
+    {IROpcode::Load, {S::Addr, S::None}, Tile::Load, X86Opcode::MOV, 1},
+
+    {IROpcode::Store, {S::Imm, S::Addr}, Tile::Store, X86Opcode::MOV, 1},
+    {IROpcode::Store, {S::Reg, S::Addr}, Tile::Store, X86Opcode::MOV, 1},
+
+    {IROpcode::Add, {S::Any, S::Imm}, Tile::Binary, X86Opcode::ADD, 1},
+    {IROpcode::Add, {S::Any, S::Mem}, Tile::Binary, X86Opcode::ADD, 1},
+    {IROpcode::Add, {S::Mem, S::Reg}, Tile::BinarySwapped, X86Opcode::ADD, 1},
+    {IROpcode::Add, {S::Any, S::Reg}, Tile::Binary, X86Opcode::ADD, 1},
+    {IROpcode::Add, {S::Reg, S::Scaled}, Tile::Lea, X86Opcode::LEA, 1},
+    {IROpcode::Add, {S::Scaled, S::Reg}, Tile::Lea, X86Opcode::LEA, 1},
+    {IROpcode::Add, {S::Reg, S::Imm}, Tile::Lea, X86Opcode::LEA, 1},
+    {IROpcode::Add, {S::Reg, S::Reg}, Tile::Lea, X86Opcode::LEA, 1},
+
+    {IROpcode::Sub, {S::Any, S::Imm}, Tile::Binary, X86Opcode::SUB, 1},
+    {IROpcode::Sub, {S::Any, S::Mem}, Tile::Binary, X86Opcode::SUB, 1},
+    {IROpcode::Sub, {S::Any, S::Reg}, Tile::Binary, X86Opcode::SUB, 1},
+    {IROpcode::Sub, {S::Reg, S::Imm}, Tile::Lea, X86Opcode::LEA, 1},
+
+    {IROpcode::Mul, {S::Reg, S::Factor}, Tile::Lea, X86Opcode::LEA, 1},
+    {IROpcode::Mul, {S::Reg, S::Imm}, Tile::ImulImm, X86Opcode::IMUL, 3},
+    {IROpcode::Mul, {S::Mem, S::Imm}, Tile::ImulImm, X86Opcode::IMUL, 3},
+    {IROpcode::Mul, {S::Any, S::Mem}, Tile::Binary, X86Opcode::IMUL, 3},
+    {IROpcode::Mul, {S::Mem, S::Reg}, Tile::BinarySwapped, X86Opcode::IMUL, 3},
+    {IROpcode::Mul, {S::Any, S::Reg}, Tile::Binary, X86Opcode::IMUL, 3},
+
+    {IROpcode::And, {S::Any, S::Imm}, Tile::Binary, X86Opcode::AND, 1},
+    {IROpcode::And, {S::Any, S::Mem}, Tile::Binary, X86Opcode::AND, 1},
+    {IROpcode::And, {S::Mem, S::Reg}, Tile::BinarySwapped, X86Opcode::AND, 1},
+    {IROpcode::And, {S::Any, S::Reg}, Tile::Binary, X86Opcode::AND, 1},
+
+    {IROpcode::Or, {S::Any, S::Imm}, Tile::Binary, X86Opcode::OR, 1},
+    {IROpcode::Or, {S::Any, S::Mem}, Tile::Binary, X86Opcode::OR, 1},
+    {IROpcode::Or, {S::Mem, S::Reg}, Tile::BinarySwapped, X86Opcode::OR, 1},
+    {IROpcode::Or, {S::Any, S::Reg}, Tile::Binary, X86Opcode::OR, 1},
+
+    {IROpcode::Xor, {S::Any, S::Imm}, Tile::Binary, X86Opcode::XOR, 1},
+    {IROpcode::Xor, {S::Any, S::Mem}, Tile::Binary, X86Opcode::XOR, 1},
+    {IROpcode::Xor, {S::Mem, S::Reg}, Tile::BinarySwapped, X86Opcode::XOR, 1},
+    {IROpcode::Xor, {S::Any, S::Reg}, Tile::Binary, X86Opcode::XOR, 1},
+
+    // Los enteros de la IR son con signo: Shr es aritmético
+    {IROpcode::Shl, {S::Any, S::Imm}, Tile::Binary, X86Opcode::SHL, 1},
+    {IROpcode::Shr, {S::Any, S::Imm}, Tile::Binary, X86Opcode::SAR, 1},
+
+    {IROpcode::Neg, {S::Any, S::None}, Tile::Unary, X86Opcode::NEG, 1},
+    {IROpcode::Not, {S::Any, S::None}, Tile::Unary, X86Opcode::NOT, 1},
+
+    {IROpcode::GetElementPtr, {S::Reg, S::Any}, Tile::Lea, X86Opcode::LEA, 1},
+
+    {IROpcode::BrCond, {S::Cmp, S::None}, Tile::CmpBranch, X86Opcode::CMP, 2},
+    {IROpcode::BrCond, {S::Reg, S::None}, Tile::TestBranch, X86Opcode::TEST, 2},
+});
+
+constexpr size_t kOpcodeCount = static_cast<size_t>(IROpcode::Crc32) + 1;
+
+struct PatternRange {
+    uint16_t first = 0;
+    uint16_t count = 0;
+};
+
+/**
+ * @brief Índice por opcode raíz, generado en compilación a partir de kPatterns
+ */
+inline constexpr auto kPatternIndex = [] {
+    std::array<PatternRange, kOpcodeCount> index{};
+    for (size_t i = 0; i < kPatterns.size(); ++i) {
+        PatternRange& range = index[static_cast<size_t>(kPatterns[i].root)];
+        if (range.count == 0) range.first = static_cast<uint16_t>(i);
+        ++range.count;
+    }
+    return index;
+}();
+
+static_assert([] {
+    for (size_t i = 0; i < kPatterns.size(); ++i) {
+        const PatternRange& range = kPatternIndex[static_cast<size_t>(kPatterns[i].root)];
+        if (i < range.first || i >= static_cast<size_t>(range.first + range.count)) return false;
+    }
+    return true;
+}(), "kPatterns debe estar agrupada por opcode raíz");
+
+bool isScalarInteger(const ir::TypeInfo& type) {
+    switch (type.type) {
+        case ir::IRType::Bool:
+        case ir::IRType::Char:
+        case ir::IRType::Short:
+        case ir::IRType::Int:
+        case ir::IRType::Long:
+        case ir::IRType::LongLong:
+        case ir::IRType::Pointer:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool fitsInt32(int64_t value) {
+    return value >= std::numeric_limits<int32_t>::min() && value <= std::numeric_limits<int32_t>::max();
+}
+
+bool isComparison(IROpcode opcode) {
+    return opcode >= IROpcode::CmpEQ && opcode <= IROpcode::CmpGE;
+}
+
+bool isCommutative(X86Opcode opcode) {
+    return opcode == X86Opcode::ADD || opcode == X86Opcode::IMUL || opcode == X86Opcode::AND ||
+           opcode == X86Opcode::OR || opcode == X86Opcode::XOR;
+}
+
+/**
+ * @brief a op b == b op' a
+ */
+IROpcode swappedComparison(IROpcode opcode) {
+    switch (opcode) {
+        case IROpcode::CmpLT: return IROpcode::CmpGT;
+        case IROpcode::CmpLE: return IROpcode::CmpGE;
+        case IROpcode::CmpGT: return IROpcode::CmpLT;
+        case IROpcode::CmpGE: return IROpcode::CmpLE;
+        default: return opcode;
+    }
+}
+
+IROpcode negatedComparison(IROpcode opcode) {
+    switch (opcode) {
+        case IROpcode::CmpEQ: return IROpcode::CmpNE;
+        case IROpcode::CmpNE: return IROpcode::CmpEQ;
+        case IROpcode::CmpLT: return IROpcode::CmpGE;
+        case IROpcode::CmpLE: return IROpcode::CmpGT;
+        case IROpcode::CmpGT: return IROpcode::CmpLE;
+        default: return IROpcode::CmpLT;
+    }
+}
+
+X86Opcode conditionalJump(IROpcode comparison, bool isUnsigned) {
+    switch (comparison) {
+        case IROpcode::CmpEQ: return X86Opcode::JE;
+        case IROpcode::CmpNE: return X86Opcode::JNE;
+        case IROpcode::CmpLT: return isUnsigned ? X86Opcode::JB : X86Opcode::JL;
+        case IROpcode::CmpLE: return isUnsigned ? X86Opcode::JBE : X86Opcode::JLE;
+        case IROpcode::CmpGT: return isUnsigned ? X86Opcode::JA : X86Opcode::JG;
+        default: return isUnsigned ? X86Opcode::JAE : X86Opcode::JGE;
+    }
+}
+
+/**
+ * @brief base + índice*escala + desplazamiento sobre valores IR
+ */
+struct Address {
+    ir::ValueId base = ir::NoValue;
+    ir::ValueId index = ir::NoValue;
+    uint8_t scale = 1;
+    int64_t displacement = 0;
+};
+
+struct OperandMatch {
+    Shape shape = Shape::None;
+    ir::ValueId value = ir::NoValue;
+    Address address;                // Mem y Addr
+    uint8_t scale = 1;              // Scaled y Factor
+};
+
+/**
+ * @brief Un patrón aplicado a una raíz concreta
+ */
+struct TileMatch {
+    const Pattern* pattern = nullptr;
+    std::array<OperandMatch, 2> operands;
+    Address address;                            // Lea
+    std::array<OperandMatch, 2> compared;       // CmpBranch: operandos del CMP
+    IROpcode condition = IROpcode::CmpNE;
+    bool isUnsigned = false;
+    std::vector<ir::InstrId> covered;           // Instrucciones plegadas en el tile
+    std::vector<ir::ValueId> leaves;            // Valores que el tile lee de registro
+    ir::InstrId cursor = ir::NoInstr;           // Siguiente instrucción plegable
+    bool swapped = false;                       // Binary: se conmutan los operandos
+    bool viaScratch = false;                    // Binary: el derecho pasa por R10
+    uint32_t cost = 0;
+};
+
+using RegisterOf = std::function<X86Register(ir::ValueId)>;
+
+constexpr uint32_t kUnselectable = 1000;
+
+/**
+ * @brief Cobertura de un bloque básico por tiles de kPatterns
+ *
+ * Primero se calcula, en orden, el mejor tile de cada instrucción como
+ * raíz (programación dinámica: coste del patrón más el de sus hojas);
+ * después, de abajo arriba, cada raíz no cubierta fija su tile y marca
+ * lo que pliega.
+ *
+ * Solo se pliega la instrucción inmediatamente anterior a lo ya cubierto
+ * (el cursor), y los operandos se recorren del último al primero: las
+ * instrucciones plegadas quedan contiguas justo antes de la raíz, así que
+ * ningún valor intermedio ha podido reutilizar sus registros ni hay
+ * stores entre un load y su uso.
+ */
+class BlockTiler {
+public:
+    BlockTiler(const ir::IRFunction& function, ir::BlockId block, RegisterOf registerOf);
+
+    /**
+     * @brief Tile elegido para la raíz, o nullptr si se selecciona por opcode
+     */
+    const TileMatch* tile(ir::InstrId id) const;
+
+    bool isCovered(ir::InstrId id) const { return covered_.count(id) != 0; }
+
+    void emit(ir::InstrId root, const TileMatch& match, std::vector<X86Instruction>& out) const;
+
+private:
+    struct Snapshot {
+        size_t covered;
+        size_t leaves;
+        ir::InstrId cursor;
+    };
+
+    const ir::IRFunction& function_;
+    ir::BlockId block_;
+    RegisterOf registerOf_;
+    std::unordered_map<ir::InstrId, TileMatch> best_;
+    std::unordered_set<ir::InstrId> covered_;
+
+    static Snapshot save(const TileMatch& match) { return {match.covered.size(), match.leaves.size(), match.cursor}; }
+    static void restore(TileMatch& match, const Snapshot& snapshot);
+
+    const ir::IRConstant* integerConstant(ir::ValueId value) const;
+    ir::InstrId fold(ir::ValueId value, TileMatch& match) const;
+    ir::InstrId peek(ir::ValueId value, const TileMatch& match) const;
+    size_t elementSize(ir::ValueId address) const;
+
+    bool addTerm(ir::ValueId value, uint8_t scale, Address& address, TileMatch& match) const;
+    bool decompose(ir::ValueId value, ir::InstrId root, Address& address, TileMatch& match) const;
+    bool decomposeScaled(ir::ValueId value, uint8_t scale, Address& address, TileMatch& match) const;
+    bool normalize(Address& address) const;
+    bool matchAddress(ir::ValueId value, Address& address, TileMatch& match) const;
+    bool matchOperand(Shape shape, ir::ValueId value, OperandMatch& out, TileMatch& match) const;
+    bool matchCompare(ir::InstrId compare, TileMatch& match) const;
+    bool match(ir::InstrId root, const Pattern& pattern, TileMatch& match) const;
+    bool finish(ir::InstrId root, TileMatch& match) const;
+    uint32_t leafCost(ir::ValueId value) const;
+
+    X86Operand registerOperand(X86Register reg) const;
+    X86Operand valueOperand(ir::ValueId value) const;
+    X86Operand memoryOperand(const Address& address) const;
+    X86Operand sourceOperand(const OperandMatch& operand) const;
+    void emitJumps(X86Opcode jump, X86Opcode inverse, ir::InstrId branch, std::vector<X86Instruction>& out) const;
+};
+
+BlockTiler::BlockTiler(const ir::IRFunction& function, ir::BlockId block, RegisterOf registerOf)
+    : function_(function), block_(block), registerOf_(std::move(registerOf)) {
+
+    std::vector<ir::InstrId> order;
+    for (ir::InstrId id : function_.instructions(block_)) {
+        order.push_back(id);
+        const ir::Instruction& inst = function_.instruction(id);
+        const PatternRange& range = kPatternIndex[static_cast<size_t>(inst.opcode)];
+        if (range.count == 0) continue;
+
+        // Solo escalares enteros: coma flotante y vectores van por opcode
+        bool eligible = inst.opcode == IROpcode::BrCond;
+        if (inst.result != ir::NoValue) eligible = isScalarInteger(function_.typeOf(inst.result));
+        if (inst.opcode == IROpcode::Store) eligible = isScalarInteger(function_.typeOf(function_.operand(id, 0)));
+        // Los símbolos se direccionan relativos a RIP: también por opcode
+        for (size_t i = 0; i < inst.operandCount && eligible; ++i) {
+            eligible = function_.value(function_.operand(id, i)).kind != ir::ValueKind::Global;
+        }
+        if (!eligible) continue;
+
+        TileMatch best;
+        for (uint16_t i = range.first; i < range.first + range.count; ++i) {
+            TileMatch candidate;
+            if (!match(id, kPatterns[i], candidate)) continue;
+            if (best.pattern == nullptr || candidate.cost < best.cost) best = std::move(candidate);
+        }
+        if (best.pattern != nullptr) best_.emplace(id, std::move(best));
+    }
+
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        if (isCovered(*it)) continue;
+        auto found = best_.find(*it);
+        if (found == best_.end()) continue;
+        covered_.insert(found->second.covered.begin(), found->second.covered.end());
+    }
+}
+
+const TileMatch* BlockTiler::tile(ir::InstrId id) const {
+    if (isCovered(id)) return nullptr;
+    auto it = best_.find(id);
+    return it == best_.end() ? nullptr : &it->second;
+}
+
+void BlockTiler::restore(TileMatch& match, const Snapshot& snapshot) {
+    match.covered.resize(snapshot.covered);
+    match.leaves.resize(snapshot.leaves);
+    match.cursor = snapshot.cursor;
+}
+
+const ir::IRConstant* BlockTiler::integerConstant(ir::ValueId value) const {
+    if (function_.value(value).kind != ir::ValueKind::Constant) return nullptr;
+    if (!isScalarInteger(function_.typeOf(value))) return nullptr;
+    return function_.constant(value);
+}
+
+ir::InstrId BlockTiler::peek(ir::ValueId value, const TileMatch& match) const {
+    ir::InstrId def = function_.definingInstruction(value);
+    if (def == ir::NoInstr || def != match.cursor) return ir::NoInstr;
+    if (function_.useCount(value) != 1 || !isScalarInteger(function_.typeOf(value))) return ir::NoInstr;
+    return def;
+}
+
+ir::InstrId BlockTiler::fold(ir::ValueId value, TileMatch& match) const {
+    ir::InstrId def = peek(value, match);
+    if (def == ir::NoInstr) return def;
+    match.covered.push_back(def);
+    match.cursor = function_.instruction(def).prev;
+    return def;
+}
+
+size_t BlockTiler::elementSize(ir::ValueId address) const {
+    // GetElementPtr [base, i] avanza i elementos del tipo al que se accede
+    size_t size = 0;
+    function_.forEachUse(address, [&](ir::InstrId user, uint32_t index) {
+        if (size != 0) return;
+        const ir::Instruction& inst = function_.instruction(user);
+        const ir::TypeInfo* type = nullptr;
+        if (inst.opcode == IROpcode::Load && index == 0) type = &function_.typeOf(inst.result);
+        if (inst.opcode == IROpcode::Store && index == 1) type = &function_.typeOf(function_.operand(user, 0));
+        if (type != nullptr) size = type->lanes != 0 ? type->size / type->lanes : type->size;
+    });
+    return size == 0 ? 1 : size;
+}
+
+bool BlockTiler::addTerm(ir::ValueId value, uint8_t scale, Address& address, TileMatch& match) const {
+    if (function_.value(value).kind == ir::ValueKind::Constant) return false;
+    if (scale == 1 && address.base == ir::NoValue) {
+        address.base = value;
+    } else if (address.index == ir::NoValue) {
+        address.index = value;
+        address.scale = scale;
+    } else if (address.base == ir::NoValue && address.scale == 1) {
+        address.base = address.index;
+        address.index = value;
+        address.scale = scale;
+    } else {
+        return false;
+    }
+    match.leaves.push_back(value);
+    return true;
+}
+
+bool BlockTiler::decomposeScaled(ir::ValueId value, uint8_t scale, Address& address, TileMatch& match) const {
+    if (const ir::IRConstant* constant = integerConstant(value)) {
+        address.displacement += constant->intValue * scale;
+        return true;
+    }
+
+    ir::InstrId def = peek(value, match);
+    if (def != ir::NoInstr) {
+        const ir::Instruction& inst = function_.instruction(def);
+        ir::ValueId lhs = inst.operandCount == 2 ? function_.operand(def, 0) : ir::NoValue;
+        const ir::IRConstant* rhs = inst.operandCount == 2 ? integerConstant(function_.operand(def, 1)) : nullptr;
+
+        // (j + c) * s = j * s + c * s
+        if (rhs != nullptr && (inst.opcode == IROpcode::Add || inst.opcode == IROpcode::Sub)) {
+            fold(value, match);
+            address.displacement += (inst.opcode == IROpcode::Add ? rhs->intValue : -rhs->intValue) * scale;
+            return decomposeScaled(lhs, scale, address, match);
+        }
+        int64_t factor = 0;
+        if (rhs != nullptr && inst.opcode == IROpcode::Shl && rhs->intValue >= 1 && rhs->intValue <= 3) {
+            factor = int64_t{1} << rhs->intValue;
+        } else if (rhs != nullptr && inst.opcode == IROpcode::Mul &&
+                   (rhs->intValue == 2 || rhs->intValue == 4 || rhs->intValue == 8)) {
+            factor = rhs->intValue;
+        }
+        if (factor != 0 && scale * factor <= 8 && function_.value(lhs).kind != ir::ValueKind::Constant) {
+            fold(value, match);
+            return addTerm(lhs, static_cast<uint8_t>(scale * factor), address, match);
+        }
+    }
+    return addTerm(value, scale, address, match);
+}
+
+bool BlockTiler::decompose(ir::ValueId value, ir::InstrId root, Address& address, TileMatch& match) const {
+    if (const ir::IRConstant* constant = integerConstant(value)) {
+        address.displacement += constant->intValue;
+        return true;
+    }
+
+    // La raíz de un LEA se descompone sin plegarse
+    ir::InstrId def = function_.definingInstruction(value);
+    if (def == ir::NoInstr || (def != root && peek(value, match) == ir::NoInstr)) {
+        return addTerm(value, 1, address, match);
+    }
+
+    const ir::Instruction& inst = function_.instruction(def);
+    if (def != root && (inst.opcode == IROpcode::Shl || inst.opcode == IROpcode::Mul)) {
+        return decomposeScaled(value, 1, address, match);
+    }
+    if (inst.operandCount != 2 ||
+        (inst.opcode != IROpcode::Add && inst.opcode != IROpcode::Sub && inst.opcode != IROpcode::GetElementPtr)) {
+        return addTerm(value, 1, address, match);
+    }
+    ir::ValueId lhs = function_.operand(def, 0);
+    ir::ValueId rhs = function_.operand(def, 1);
+
+    switch (inst.opcode) {
+        case IROpcode::Sub: {
+            const ir::IRConstant* constant = integerConstant(rhs);
+            if (constant == nullptr) return addTerm(value, 1, address, match);
+            if (def != root) fold(value, match);
+            address.displacement -= constant->intValue;
+            return decompose(lhs, root, address, match);
+        }
+
+        case IROpcode::Add:
+            // Último operando primero: el cursor sigue el orden de emisión
+            if (def != root) fold(value, match);
+            return decompose(rhs, root, address, match) && decompose(lhs, root, address, match);
+
+        default: {
+            size_t size = elementSize(value);
+            if (size != 1 && size != 2 && size != 4 && size != 8) return addTerm(value, 1, address, match);
+            if (def != root) fold(value, match);
+            return decomposeScaled(rhs, static_cast<uint8_t>(size), address, match) &&
+                   decompose(lhs, root, address, match);
+        }
+    }
+}
+
+bool BlockTiler::normalize(Address& address) const {
+    if (!fitsInt32(address.displacement)) return false;
+    if (address.base == ir::NoValue && address.index != ir::NoValue) {
+        // [índice*escala + desp] sin base no está entre los AddressingMode
+        if (address.scale != 1) return false;
+        std::swap(address.base, address.index);
+    }
+    return true;
+}
+
+bool BlockTiler::matchAddress(ir::ValueId value, Address& address, TileMatch& match) const {
+    Snapshot snapshot = save(match);
+    Address decomposed;
+    if (decompose(value, ir::NoInstr, decomposed, match) && normalize(decomposed)) {
+        address = decomposed;
+        return true;
+    }
+
+    // Sin plegar nada: la dirección ya está en un registro
+    restore(match, snapshot);
+    if (function_.value(value).kind == ir::ValueKind::Constant) return false;
+    address = Address{};
+    address.base = value;
+    match.leaves.push_back(value);
+    return true;
+}
+
+bool BlockTiler::matchOperand(Shape shape, ir::ValueId value, OperandMatch& out, TileMatch& match) const {
+    out.shape = shape;
+    out.value = value;
+    const ir::IRConstant* constant = integerConstant(value);
+    bool isConstant = function_.value(value).kind == ir::ValueKind::Constant;
+
+    switch (shape) {
+        case Shape::None:
+            return true;
+
+        case Shape::Any:
+            if (isConstant) return constant != nullptr;
+            match.leaves.push_back(value);
+            return true;
+
+        case Shape::Reg:
+            if (isConstant) return false;
+            match.leaves.push_back(value);
+            return true;
+
+        case Shape::Imm:
+            return constant != nullptr && fitsInt32(constant->intValue);
+
+        case Shape::Factor:
+            if (constant == nullptr || (constant->intValue != 3 && constant->intValue != 5 && constant->intValue != 9)) {
+                return false;
+            }
+            out.scale = static_cast<uint8_t>(constant->intValue - 1);
+            return true;
+
+        case Shape::Mem: {
+            ir::InstrId def = peek(value, match);
+            if (def == ir::NoInstr || function_.instruction(def).opcode != IROpcode::Load) return false;
+            fold(value, match);
+            return matchAddress(function_.operand(def, 0), out.address, match);
+        }
+
+        case Shape::Scaled: {
+            ir::InstrId def = peek(value, match);
+            if (def == ir::NoInstr || function_.instruction(def).operandCount != 2) return false;
+            const ir::Instruction& inst = function_.instruction(def);
+            const ir::IRConstant* amount = integerConstant(function_.operand(def, 1));
+            if (amount == nullptr) return false;
+            int64_t scale = 0;
+            if (inst.opcode == IROpcode::Shl && amount->intValue >= 1 && amount->intValue <= 3) {
+                scale = int64_t{1} << amount->intValue;
+            } else if (inst.opcode == IROpcode::Mul &&
+                       (amount->intValue == 2 || amount->intValue == 4 || amount->intValue == 8)) {
+                scale = amount->intValue;
+            }
+            if (scale == 0 || function_.value(function_.operand(def, 0)).kind == ir::ValueKind::Constant) return false;
+            fold(value, match);
+            out.value = function_.operand(def, 0);
+            out.scale = static_cast<uint8_t>(scale);
+            match.leaves.push_back(out.value);
+            return true;
+        }
+
+        case Shape::Cmp: {
+            ir::InstrId def = peek(value, match);
+            if (def == ir::NoInstr || !isComparison(function_.instruction(def).opcode)) return false;
+            fold(value, match);
+            return matchCompare(def, match);
+        }
+
+        case Shape::Addr:
+            return matchAddress(value, out.address, match);
+    }
+    return false;
+}
+
+bool BlockTiler::matchCompare(ir::InstrId compare, TileMatch& match) const {
+    ir::ValueId lhs = function_.operand(compare, 0);
+    ir::ValueId rhs = function_.operand(compare, 1);
+    if (!isScalarInteger(function_.typeOf(lhs))) return false;
+
+    match.condition = function_.instruction(compare).opcode;
+    match.isUnsigned = function_.typeOf(lhs).type == ir::IRType::Pointer;
+    if (function_.value(lhs).kind == ir::ValueKind::Constant && function_.value(rhs).kind != ir::ValueKind::Constant) {
+        std::swap(lhs, rhs);
+        match.condition = swappedComparison(match.condition);
+    }
+
+    static constexpr std::array<std::pair<Shape, Shape>, 5> kForms = {{
+        {Shape::Reg, Shape::Imm}, {Shape::Mem, Shape::Imm}, {Shape::Reg, Shape::Mem},
+        {Shape::Mem, Shape::Reg}, {Shape::Reg, Shape::Reg},
+    }};
+    for (auto [left, right] : kForms) {
+        Snapshot snapshot = save(match);
+        if (matchOperand(right, rhs, match.compared[1], match) &&
+            matchOperand(left, lhs, match.compared[0], match)) {
+            return true;
+        }
+        restore(match, snapshot);
+    }
+    return false;
+}
+
+bool BlockTiler::match(ir::InstrId root, const Pattern& pattern, TileMatch& match) const {
+    const ir::Instruction& inst = function_.instruction(root);
+    match.pattern = &pattern;
+    match.cursor = inst.prev;
+
+    // Del último operando al primero, como se emitieron
+    for (size_t i = pattern.operands.size(); i-- > 0;) {
+        if (pattern.operands[i] == Shape::None) continue;
+        if (i >= inst.operandCount) return false;
+        if (!matchOperand(pattern.operands[i], function_.operand(root, i), match.operands[i], match)) {
+            return false;
+        }
+    }
+
+    if (pattern.tile == Tile::Lea) {
+        // Las formas solo filtran: la dirección sale de descomponer la raíz
+        match.covered.clear();
+        match.leaves.clear();
+        match.cursor = inst.prev;
+        Address& address = match.address;
+        if (inst.opcode == IROpcode::Mul) {
+            ir::ValueId lhs = function_.operand(root, 0);
+            address.base = lhs;
+            address.index = lhs;
+            address.scale = match.operands[1].scale;
+            match.leaves.push_back(lhs);
+        } else if (!decompose(inst.result, root, address, match) || !normalize(address) ||
+                   address.base == ir::NoValue || address.base == inst.result || address.index == inst.result) {
+            return false;
+        }
+    }
+
+    return finish(root, match);
+}
+
+bool BlockTiler::finish(ir::InstrId root, TileMatch& match) const {
+    const Pattern& pattern = *match.pattern;
+    const ir::Instruction& inst = function_.instruction(root);
+    match.cost = pattern.cost;
+
+    if (pattern.tile == Tile::Binary || pattern.tile == Tile::BinarySwapped) {
+        bool swappedTile = pattern.tile == Tile::BinarySwapped;
+        const OperandMatch& lhs = match.operands[swappedTile ? 1 : 0];
+        const OperandMatch& rhs = match.operands[swappedTile ? 0 : 1];
+        X86Register result = registerOf_(inst.result);
+        bool lhsConstant = function_.value(lhs.value).kind == ir::ValueKind::Constant;
+        bool needsMove = lhsConstant || registerOf_(lhs.value) != result;
+
+        if (needsMove && rhs.shape == Shape::Mem) {
+            // La copia al destino machacaría la dirección
+            const Address& address = rhs.address;
+            if ((address.base != ir::NoValue && registerOf_(address.base) == result) ||
+                (address.index != ir::NoValue && registerOf_(address.index) == result)) {
+                return false;
+            }
+        }
+        if (needsMove && rhs.shape == Shape::Reg && registerOf_(rhs.value) == result) {
+            const ir::IRConstant* constant = integerConstant(lhs.value);
+            if (isCommutative(pattern.opcode) && (!lhsConstant || (constant && fitsInt32(constant->intValue)))) {
+                match.swapped = true;
+                needsMove = false;
+            } else {
+                match.viaScratch = true;
+                ++match.cost;
+            }
+        }
+        if (needsMove) ++match.cost;
+    } else if (pattern.tile == Tile::Unary) {
+        const OperandMatch& operand = match.operands[0];
+        if (function_.value(operand.value).kind == ir::ValueKind::Constant ||
+            registerOf_(operand.value) != registerOf_(inst.result)) {
+            ++match.cost;
+        }
+    }
+
+    for (ir::ValueId leaf : match.leaves) match.cost += leafCost(leaf);
+    return true;
+}
+
+uint32_t BlockTiler::leafCost(ir::ValueId value) const {
+    // Solo cuentan las hojas que se calculan para este tile
+    ir::InstrId def = function_.definingInstruction(value);
+    if (def == ir::NoInstr || function_.instruction(def).block != block_ || function_.useCount(value) != 1) return 0;
+    auto it = best_.find(def);
+    if (it != best_.end()) return it->second.cost;
+    // Una comparación suelta no se materializa por opcode: solo fusionada con su salto
+    return isComparison(function_.instruction(def).opcode) ? kUnselectable : 2;
+}
+
+X86Operand BlockTiler::registerOperand(X86Register reg) const {
+    X86Operand op(AddressingMode::Register);
+    op.reg = reg;
+    return op;
+}
+
+X86Operand BlockTiler::valueOperand(ir::ValueId value) const {
+    if (const ir::IRConstant* constant = integerConstant(value)) {
+        X86Operand op(AddressingMode::Immediate);
+        op.immediate = constant->intValue;
+        return op;
+    }
+    return registerOperand(registerOf_(value));
+}
+
+X86Operand BlockTiler::memoryOperand(const Address& address) const {
+    auto displacement = static_cast<int32_t>(address.displacement);
+    if (address.base == ir::NoValue) {
+        X86Operand op(AddressingMode::MemoryDirect);
+        op.immediate = displacement;
+        return op;
+    }
+    if (address.index == ir::NoValue) {
+        X86Operand op(displacement == 0 ? AddressingMode::MemoryIndirect : AddressingMode::MemoryBaseDisp);
+        op.reg = registerOf_(address.base);
+        op.displacement = displacement;
+        return op;
+    }
+    X86Operand op(displacement == 0 ? AddressingMode::MemoryBaseIndex : AddressingMode::MemoryBaseIndexDisp);
+    op.baseReg = registerOf_(address.base);
+    op.indexReg = registerOf_(address.index);
+    op.scale = address.scale;
+    op.displacement = displacement;
+    return op;
+}
+
+X86Operand BlockTiler::sourceOperand(const OperandMatch& operand) const {
+    return operand.shape == Shape::Mem ? memoryOperand(operand.address) : valueOperand(operand.value);
+}
+
+void BlockTiler::emitJumps(X86Opcode jump, X86Opcode inverse, ir::InstrId branch,
+                           std::vector<X86Instruction>& out) const {
+    ir::BlockId taken = function_.labelBlock(function_.operand(branch, 1));
+    ir::BlockId other = function_.labelBlock(function_.operand(branch, 2));
+    ir::BlockId next = block_ + 1;
+
+    auto emitJump = [&](X86Opcode opcode, ir::BlockId target) {
+        X86Instruction inst(opcode);
+        inst.comment = function_.block(target).name;
+        out.push_back(inst);
+    };
+
+    // El bloque siguiente en el orden de emisión no necesita salto
+    if (taken == next) {
+        emitJump(inverse, other);
+        return;
+    }
+    emitJump(jump, taken);
+    if (other != next) emitJump(X86Opcode::JMP, other);
+}
+
+void BlockTiler::emit(ir::InstrId root, const TileMatch& match, std::vector<X86Instruction>& out) const {
+    const Pattern& pattern = *match.pattern;
+    const ir::Instruction& inst = function_.instruction(root);
+    auto push = [&](X86Opcode opcode, std::initializer_list<X86Operand> operands) {
+        X86Instruction x86(opcode);
+        x86.operands = operands;
+        out.push_back(x86);
+    };
+
+    switch (pattern.tile) {
+        case Tile::Load:
+            push(X86Opcode::MOV, {registerOperand(registerOf_(inst.result)), memoryOperand(match.operands[0].address)});
+            break;
+
+        case Tile::Store:
+            push(X86Opcode::MOV, {memoryOperand(match.operands[1].address), valueOperand(match.operands[0].value)});
+            break;
+
+        case Tile::Binary:
+        case Tile::BinarySwapped: {
+            bool swappedTile = pattern.tile == Tile::BinarySwapped;
+            const OperandMatch* lhs = &match.operands[swappedTile ? 1 : 0];
+            const OperandMatch* rhs = &match.operands[swappedTile ? 0 : 1];
+            if (match.swapped) std::swap(lhs, rhs);
+            X86Operand result = registerOperand(registerOf_(inst.result));
+            X86Operand source = sourceOperand(*rhs);
+
+            if (match.viaScratch) {
+                push(X86Opcode::MOV, {registerOperand(X86Register::R10), source});
+                source = registerOperand(X86Register::R10);
+            }
+            X86Operand first = valueOperand(lhs->value);
+            if (first.mode != AddressingMode::Register || first.reg != result.reg) {
+                push(X86Opcode::MOV, {result, first});
+            }
+            push(pattern.opcode, {result, source});
+            break;
+        }
+
+        case Tile::Lea:
+            push(X86Opcode::LEA, {registerOperand(registerOf_(inst.result)), memoryOperand(match.address)});
+            break;
+
+        case Tile::ImulImm:
+            push(X86Opcode::IMUL, {registerOperand(registerOf_(inst.result)), sourceOperand(match.operands[0]),
+                                   valueOperand(match.operands[1].value)});
+            break;
+
+        case Tile::Unary: {
+            X86Operand result = registerOperand(registerOf_(inst.result));
+            X86Operand operand = valueOperand(match.operands[0].value);
+            if (operand.mode != AddressingMode::Register || operand.reg != result.reg) {
+                push(X86Opcode::MOV, {result, operand});
+            }
+            // El Not de un bool es lógico: solo cambia el bit 0
+            if (inst.opcode == IROpcode::Not && function_.typeOf(inst.result).type == ir::IRType::Bool) {
+                X86Operand one(AddressingMode::Immediate);
+                one.immediate = 1;
+                push(X86Opcode::XOR, {result, one});
+            } else {
+                push(pattern.opcode, {result});
+            }
+            break;
+        }
+
+        case Tile::CmpBranch:
+            push(X86Opcode::CMP, {sourceOperand(match.compared[0]), sourceOperand(match.compared[1])});
+            emitJumps(conditionalJump(match.condition, match.isUnsigned),
+                      conditionalJump(negatedComparison(match.condition), match.isUnsigned), root, out);
+            break;
+
+        case Tile::TestBranch: {
+            X86Operand condition = registerOperand(registerOf_(match.operands[0].value));
+            push(X86Opcode::TEST, {condition, condition});
+            emitJumps(X86Opcode::JNE, X86Opcode::JE, root, out);
+            break;
+        }
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// InstructionSelector - Cobertura por patrones
+// ============================================================================
+
+void InstructionSelector::selectBlock(
+    const ir::IRFunction& function,
+    ir::BlockId block,
+    const std::unordered_map<int, RegisterMapping>& registerMap,
+    bool usesYmm,
+    std::vector<X86Instruction>& instructions) {
+
+    BlockTiler tiler(function, block, [&](ir::ValueId value) {
+        return getPhysicalRegister(static_cast<int>(value), registerMap);
+    });
+
+    for (ir::InstrId inst : function.instructions(block)) {
+        if (tiler.isCovered(inst)) continue;
+        if (const TileMatch* match = tiler.tile(inst)) {
+            tiler.emit(inst, *match, instructions);
+            continue;
+        }
+
+        ir::IROpcode opcode = function.instruction(inst).opcode;
+        if (usesYmm && (opcode == ir::IROpcode::Ret || opcode == ir::IROpcode::Call)) {
+            instructions.emplace_back(X86Opcode::VZEROUPPER);
+        }
+        auto selected = selectInstruction(function, inst, registerMap);
+        instructions.insert(instructions.end(), selected.begin(), selected.end());
+    }
+}
+
+} // namespace cpp20::compiler::backend
@@ -0,0 +1,485 @@
+/**
+ * @file InstructionScheduler.cpp
+ * @brief Planificador de lista con tablas de latencia por microarquitectura
+ */
+
+#include <compiler/backend/codegen/InstructionScheduler.h>
+#include <algorithm>
+#include <queue>
+
+namespace cpp20::compiler::backend {
+
+namespace {
+
+using C = ExecutionClass;
+
+//                                       Alu       Multiply  Divide     Load      Store     FpAdd     FpMul     FpDivide   VectorInt VectorMul  Shuffle   Transfer
+const MicroarchitectureModel kGeneric = {"generic", 4, 5, 5, {{{1, 3, 1}, {3, 1, 1}, {40, 1, 20}, {0, 2, 1}, {1, 1, 1}, {4, 2, 1}, {4, 2, 1}, {14, 1, 4}, {1, 3, 1}, {10, 1, 1}, {1, 1, 1}, {3, 1, 1}}}};
+const MicroarchitectureModel kSkylake = {"skylake", 4, 5, 4, {{{1, 4, 1}, {3, 1, 1}, {42, 1, 24}, {0, 2, 1}, {1, 1, 1}, {4, 2, 1}, {4, 2, 1}, {14, 1, 4}, {1, 3, 1}, {10, 2, 1}, {1, 1, 1}, {2, 1, 1}}}};
+const MicroarchitectureModel kZen3 = {"znver3", 6, 4, 6, {{{1, 4, 1}, {3, 1, 1}, {18, 1, 7}, {0, 3, 1}, {1, 2, 1}, {3, 2, 1}, {3, 2, 1}, {13, 1, 4}, {1, 4, 1}, {3, 2, 1}, {1, 2, 1}, {3, 1, 1}}}};
+const MicroarchitectureModel kZen4 = {"znver4", 6, 4, 6, {{{1, 4, 1}, {3, 1, 1}, {18, 1, 7}, {0, 3, 1}, {1, 2, 1}, {3, 2, 1}, {3, 2, 1}, {13, 1, 5}, {1, 4, 1}, {3, 2, 1}, {1, 2, 1}, {3, 1, 1}}}};
+
+// Bits de InstructionInfo::defs/uses: 0-15 generales, 16-31 vectoriales
+constexpr uint64_t kFlagsBit = uint64_t{1} << 32;
+
+/**
+ * @brief Registro canónico (RAX, EAX, AX y AL comparten bit; XMMn e YMMn también)
+ */
+uint64_t registerBit(X86Register reg) {
+    auto index = static_cast<int>(reg);
+    if (index < static_cast<int>(X86Register::XMM0)) return uint64_t{1} << (index % 16);
+    if (index <= static_cast<int>(X86Register::XMM15)) return uint64_t{1} << (16 + index - static_cast<int>(X86Register::XMM0));
+    if (index <= static_cast<int>(X86Register::YMM15)) return uint64_t{1} << (16 + index - static_cast<int>(X86Register::YMM0));
+    if (index <= static_cast<int>(X86Register::ZMM7)) return uint64_t{1} << (16 + index - static_cast<int>(X86Register::ZMM0));
+    if (reg == X86Register::RFLAGS) return kFlagsBit;
+    return 0;
+}
+
+bool isMemory(const X86Operand& operand) {
+    return operand.mode != AddressingMode::Register && operand.mode != AddressingMode::Immediate;
+}
+
+uint64_t addressRegisters(const X86Operand& operand) {
+    switch (operand.mode) {
+        case AddressingMode::MemoryIndirect:
+        case AddressingMode::MemoryBaseDisp:
+            return registerBit(operand.reg);
+        case AddressingMode::MemoryBaseIndex:
+        case AddressingMode::MemoryBaseIndexDisp:
+            return registerBit(operand.baseReg) | registerBit(operand.indexReg);
+        default:
+            return 0;
+    }
+}
+
+bool isConditionalJump(X86Opcode opcode) {
+    switch (opcode) {
+        case X86Opcode::JE: case X86Opcode::JNE: case X86Opcode::JL: case X86Opcode::JLE:
+        case X86Opcode::JG: case X86Opcode::JGE: case X86Opcode::JB: case X86Opcode::JBE:
+        case X86Opcode::JA: case X86Opcode::JAE: case X86Opcode::JS: case X86Opcode::JNS:
+        case X86Opcode::JC: case X86Opcode::JNC:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Instrucciones que cortan los tramos y no se mueven
+ */
+bool isBarrier(const X86Instruction& inst) {
+    switch (inst.opcode) {
+        case X86Opcode::JMP: case X86Opcode::CALL: case X86Opcode::RET: case X86Opcode::TAILJMP:
+        case X86Opcode::JMPTABLE:
+        case X86Opcode::LEAVE: case X86Opcode::ENTER: case X86Opcode::PUSH: case X86Opcode::POP:
+        case X86Opcode::VZEROUPPER: case X86Opcode::NOP: case X86Opcode::HLT:
+        case X86Opcode::CPUID: case X86Opcode::XGETBV:
+        case X86Opcode::LOCK: case X86Opcode::REP: case X86Opcode::REPZ: case X86Opcode::REPNZ:
+            return true;
+        default:
+            return isConditionalJump(inst.opcode);
+    }
+}
+
+bool writesFlags(X86Opcode opcode) {
+    switch (opcode) {
+        case X86Opcode::ADD: case X86Opcode::SUB: case X86Opcode::IMUL: case X86Opcode::IDIV:
+        case X86Opcode::INC: case X86Opcode::DEC: case X86Opcode::NEG:
+        case X86Opcode::AND: case X86Opcode::OR: case X86Opcode::XOR:
+        case X86Opcode::SHL: case X86Opcode::SHR: case X86Opcode::SAR:
+        case X86Opcode::ROL: case X86Opcode::ROR: case X86Opcode::BSF: case X86Opcode::BSR:
+        case X86Opcode::POPCNT: case X86Opcode::LZCNT: case X86Opcode::TZCNT:
+        case X86Opcode::CMP: case X86Opcode::TEST: case X86Opcode::COMISS: case X86Opcode::COMISD:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief El primer operando solo se lee (comparaciones)
+ */
+bool readsOnlyDestination(X86Opcode opcode) {
+    return opcode == X86Opcode::CMP || opcode == X86Opcode::TEST ||
+           opcode == X86Opcode::COMISS || opcode == X86Opcode::COMISD;
+}
+
+/**
+ * @brief El destino se sobrescribe entero sin leerse
+ */
+bool overwritesDestination(const X86Instruction& inst) {
+    switch (inst.opcode) {
+        case X86Opcode::MOV: case X86Opcode::MOVZX: case X86Opcode::MOVSX: case X86Opcode::LEA:
+        case X86Opcode::MOVD: case X86Opcode::MOVQ: case X86Opcode::MOVAPS: case X86Opcode::MOVUPS:
+        case X86Opcode::MOVDQA: case X86Opcode::MOVDQU: case X86Opcode::MOVUPD:
+        case X86Opcode::VMOVDQU: case X86Opcode::VMOVUPS: case X86Opcode::VMOVUPD:
+        case X86Opcode::VMOVD: case X86Opcode::VMOVQ: case X86Opcode::PSHUFD:
+        case X86Opcode::VPBROADCASTD: case X86Opcode::VPBROADCASTQ:
+        case X86Opcode::VBROADCASTSS: case X86Opcode::VBROADCASTSD:
+        case X86Opcode::PMOVMSKB: case X86Opcode::VPMOVMSKB:
+        case X86Opcode::POPCNT: case X86Opcode::LZCNT: case X86Opcode::TZCNT:
+        case X86Opcode::PDEP: case X86Opcode::PEXT:
+            return true;
+        case X86Opcode::MOVSS: case X86Opcode::MOVSD:
+            // Desde memoria pone a cero el resto; entre registros mezcla
+            return inst.operands.size() >= 2 && isMemory(inst.operands[1]);
+        case X86Opcode::IMUL:
+            return inst.operands.size() >= 3;
+        default:
+            // Las formas VEX de tres operandos no leen el destino
+            return inst.operands.size() >= 3 && inst.opcode >= X86Opcode::VPADDD &&
+                   inst.opcode <= X86Opcode::VDIVPD;
+    }
+}
+
+ExecutionClass classOf(X86Opcode opcode) {
+    switch (opcode) {
+        case X86Opcode::IMUL:
+        // Mismo puerto y latencia (3) que IMUL en Intel
+        case X86Opcode::POPCNT: case X86Opcode::LZCNT: case X86Opcode::TZCNT:
+        case X86Opcode::BSF: case X86Opcode::BSR:
+        case X86Opcode::PDEP: case X86Opcode::PEXT: case X86Opcode::CRC32:
+            return C::Multiply;
+        case X86Opcode::IDIV:
+            return C::Divide;
+        case X86Opcode::ADDSS: case X86Opcode::ADDSD: case X86Opcode::SUBSS: case X86Opcode::SUBSD:
+        case X86Opcode::COMISS: case X86Opcode::COMISD:
+        case X86Opcode::MINSS: case X86Opcode::MINSD: case X86Opcode::MAXSS: case X86Opcode::MAXSD:
+        case X86Opcode::ADDPS: case X86Opcode::ADDPD: case X86Opcode::SUBPS: case X86Opcode::SUBPD:
+        case X86Opcode::VADDPS: case X86Opcode::VADDPD: case X86Opcode::VSUBPS: case X86Opcode::VSUBPD:
+            return C::FpAdd;
+        case X86Opcode::MULSS: case X86Opcode::MULSD: case X86Opcode::MULPS: case X86Opcode::MULPD:
+        case X86Opcode::VMULPS: case X86Opcode::VMULPD:
+            return C::FpMul;
+        case X86Opcode::DIVSS: case X86Opcode::DIVSD: case X86Opcode::DIVPS: case X86Opcode::DIVPD:
+        case X86Opcode::VDIVPS: case X86Opcode::VDIVPD:
+            return C::FpDivide;
+        case X86Opcode::MOVSS: case X86Opcode::MOVSD: case X86Opcode::MOVAPS: case X86Opcode::MOVUPS:
+        case X86Opcode::MOVDQA: case X86Opcode::MOVDQU: case X86Opcode::MOVUPD:
+        case X86Opcode::VMOVDQU: case X86Opcode::VMOVUPS: case X86Opcode::VMOVUPD:
+        case X86Opcode::PADDD: case X86Opcode::PADDQ: case X86Opcode::PSUBD: case X86Opcode::PSUBQ:
+        case X86Opcode::PAND: case X86Opcode::POR: case X86Opcode::PXOR: case X86Opcode::PCMPEQB:
+        case X86Opcode::VPADDD: case X86Opcode::VPADDQ: case X86Opcode::VPSUBD: case X86Opcode::VPSUBQ:
+        case X86Opcode::VPAND: case X86Opcode::VPOR: case X86Opcode::VPXOR: case X86Opcode::VPCMPEQB:
+            return C::VectorInt;
+        case X86Opcode::PMULLD: case X86Opcode::VPMULLD:
+            return C::VectorMul;
+        case X86Opcode::PSHUFD: case X86Opcode::SHUFPS: case X86Opcode::PUNPCKLQDQ: case X86Opcode::UNPCKLPD:
+        case X86Opcode::VPBROADCASTD: case X86Opcode::VPBROADCASTQ:
+        case X86Opcode::VBROADCASTSS: case X86Opcode::VBROADCASTSD:
+            return C::Shuffle;
+        case X86Opcode::MOVD: case X86Opcode::MOVQ: case X86Opcode::VMOVD: case X86Opcode::VMOVQ:
+        case X86Opcode::PMOVMSKB: case X86Opcode::VPMOVMSKB:
+            return C::Transfer;
+        default:
+            return C::Alu;
+    }
+}
+
+bool isMove(X86Opcode opcode) {
+    switch (opcode) {
+        case X86Opcode::MOV: case X86Opcode::MOVZX: case X86Opcode::MOVSX:
+        case X86Opcode::MOVSS: case X86Opcode::MOVSD: case X86Opcode::MOVAPS: case X86Opcode::MOVUPS:
+        case X86Opcode::MOVDQA: case X86Opcode::MOVDQU: case X86Opcode::MOVUPD:
+        case X86Opcode::VMOVDQU: case X86Opcode::VMOVUPS: case X86Opcode::VMOVUPD:
+        case X86Opcode::MOVD: case X86Opcode::MOVQ: case X86Opcode::VMOVD: case X86Opcode::VMOVQ:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Lo que el planificador necesita saber de una instrucción
+ */
+struct InstructionInfo {
+    uint64_t defs = 0;
+    uint64_t uses = 0;
+    bool loads = false;
+    bool stores = false;
+    bool usesUnit = true;           // false para MOV de carga o escritura pura
+    ExecutionClass cls = C::Alu;
+    uint32_t latency = 1;
+};
+
+InstructionInfo analyze(const X86Instruction& inst, const MicroarchitectureModel& model) {
+    InstructionInfo info;
+    info.cls = classOf(inst.opcode);
+
+    for (size_t i = 0; i < inst.operands.size(); ++i) {
+        const X86Operand& operand = inst.operands[i];
+        if (operand.mode == AddressingMode::Register) {
+            uint64_t bit = registerBit(operand.reg);
+            if (i > 0 || readsOnlyDestination(inst.opcode)) {
+                info.uses |= bit;
+            } else {
+                info.defs |= bit;
+                if (!overwritesDestination(inst)) info.uses |= bit;
+            }
+        } else if (isMemory(operand)) {
+            info.uses |= addressRegisters(operand);
+            if (inst.opcode == X86Opcode::LEA) continue;
+            if (i == 0 && !readsOnlyDestination(inst.opcode)) {
+                info.stores = true;
+                if (!overwritesDestination(inst)) info.loads = true;
+            } else {
+                info.loads = true;
+            }
+        }
+    }
+
+    if (inst.opcode == X86Opcode::IDIV) {
+        uint64_t pair = registerBit(X86Register::RAX) | registerBit(X86Register::RDX);
+        info.defs |= pair;
+        info.uses |= pair;
+    }
+    if (writesFlags(inst.opcode)) info.defs |= kFlagsBit;
+    if (inst.opcode >= X86Opcode::CMOVE && inst.opcode <= X86Opcode::CMOVAE) info.uses |= kFlagsBit;
+
+    // Un MOV con memoria solo ocupa el puerto de carga o de escritura
+    info.usesUnit = !(isMove(inst.opcode) && (info.loads || info.stores));
+    info.latency = (info.loads ? model.loadLatency : 0) + (info.usesUnit ? model.cost(info.cls).latency : 0);
+    if (info.latency == 0) info.latency = 1;
+    return info;
+}
+
+/**
+ * @brief Unidades ocupadas: ciclo en que queda libre cada una, por clase
+ */
+class ResourceTable {
+public:
+    explicit ResourceTable(const MicroarchitectureModel& model) : model_(model) {
+        for (size_t cls = 0; cls < freeAt_.size(); ++cls) {
+            freeAt_[cls].assign(model.costs[cls].units, 0);
+        }
+    }
+
+    bool available(const InstructionInfo& info, uint32_t cycle) const {
+        return (!info.usesUnit || hasFree(info.cls, cycle)) &&
+               (!info.loads || hasFree(C::Load, cycle)) &&
+               (!info.stores || hasFree(C::Store, cycle));
+    }
+
+    void reserve(const InstructionInfo& info, uint32_t cycle) {
+        if (info.usesUnit) take(info.cls, cycle);
+        if (info.loads) take(C::Load, cycle);
+        if (info.stores) take(C::Store, cycle);
+    }
+
+private:
+    const MicroarchitectureModel& model_;
+    std::array<std::vector<uint32_t>, static_cast<size_t>(C::Count)> freeAt_;
+
+    bool hasFree(ExecutionClass cls, uint32_t cycle) const {
+        const auto& units = freeAt_[static_cast<size_t>(cls)];
+        return std::any_of(units.begin(), units.end(), [&](uint32_t free) { return free <= cycle; });
+    }
+
+    void take(ExecutionClass cls, uint32_t cycle) {
+        for (uint32_t& free : freeAt_[static_cast<size_t>(cls)]) {
+            if (free <= cycle) {
+                free = cycle + model_.cost(cls).occupancy;
+                return;
+            }
+        }
+    }
+};
+
+struct Edge {
+    uint32_t to;
+    uint32_t latency;
+};
+
+} // namespace
+
+const MicroarchitectureModel& MicroarchitectureModel::forTarget(Microarchitecture target) {
+    switch (target) {
+        case Microarchitecture::Skylake: return kSkylake;
+        case Microarchitecture::Zen3: return kZen3;
+        case Microarchitecture::Zen4: return kZen4;
+        default: return kGeneric;
+    }
+}
+
+// ============================================================================
+// InstructionScheduler - Implementación
+// ============================================================================
+
+InstructionScheduler::InstructionScheduler(Microarchitecture target)
+    : model_(MicroarchitectureModel::forTarget(target)) {
+}
+
+std::vector<X86Instruction> InstructionScheduler::schedule(std::vector<X86Instruction> instructions) const {
+    size_t begin = 0;
+    for (size_t i = 0; i <= instructions.size(); ++i) {
+        if (i < instructions.size() && !isBarrier(instructions[i])) continue;
+        if (i - begin > 1) scheduleRegion(instructions, begin, i);
+        begin = i + 1;
+    }
+    return instructions;
+}
+
+void InstructionScheduler::scheduleRegion(std::vector<X86Instruction>& instructions, size_t begin, size_t end) const {
+    size_t count = end - begin;
+    std::vector<InstructionInfo> info(count);
+    for (size_t i = 0; i < count; ++i) info[i] = analyze(instructions[begin + i], model_);
+
+    // Grafo de dependencias con el último escritor y los lectores
+    // posteriores de cada registro, y lo mismo para la memoria
+    std::vector<std::vector<Edge>> successors(count);
+    std::vector<uint32_t> predecessors(count, 0);
+    auto addEdge = [&](uint32_t from, uint32_t to, uint32_t latency) {
+        successors[from].push_back({to, latency});
+        predecessors[to]++;
+    };
+
+    constexpr size_t kBits = 33;
+    std::array<int64_t, kBits> lastDef;
+    lastDef.fill(-1);
+    std::array<std::vector<uint32_t>, kBits> readers;
+    int64_t lastStore = -1;
+    std::vector<uint32_t> loadsSinceStore;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const InstructionInfo& current = info[i];
+        for (size_t bit = 0; bit < kBits; ++bit) {
+            uint64_t mask = uint64_t{1} << bit;
+            if (current.uses & mask) {
+                if (lastDef[bit] >= 0) addEdge(static_cast<uint32_t>(lastDef[bit]), i, info[lastDef[bit]].latency);
+            }
+            if (current.defs & mask) {
+                // Con renombrado, WAW y WAR solo imponen orden
+                if (lastDef[bit] >= 0) addEdge(static_cast<uint32_t>(lastDef[bit]), i, 0);
+                for (uint32_t reader : readers[bit]) {
+                    if (reader != i) addEdge(reader, i, 0);
+                }
+                readers[bit].clear();
+            }
+        }
+        for (size_t bit = 0; bit < kBits; ++bit) {
+            uint64_t mask = uint64_t{1} << bit;
+            if (current.defs & mask) lastDef[bit] = i;
+            if ((current.uses & mask) && !(current.defs & mask)) readers[bit].push_back(i);
+        }
+
+        if (current.loads && lastStore >= 0) addEdge(static_cast<uint32_t>(lastStore), i, model_.storeForwardLatency);
+        if (current.stores) {
+            if (lastStore >= 0 && !current.loads) addEdge(static_cast<uint32_t>(lastStore), i, 0);
+            for (uint32_t load : loadsSinceStore) {
+                if (load != i) addEdge(load, i, 0);
+            }
+            loadsSinceStore.clear();
+            lastStore = i;
+        } else if (current.loads) {
+            loadsSinceStore.push_back(i);
+        }
+    }
+
+    // Quien fija los flags del salto va el último: se fusiona con el Jcc
+    if (end < instructions.size() && isConditionalJump(instructions[end].opcode) && lastDef[32] >= 0) {
+        auto flags = static_cast<uint32_t>(lastDef[32]);
+        for (uint32_t i = 0; i < count; ++i) {
+            if (i != flags) addEdge(i, flags, 0);
+        }
+    }
+
+    // Prioridad: ruta crítica hasta el final del tramo
+    std::vector<uint32_t> height(count, 0);
+    for (size_t i = count; i-- > 0;) {
+        height[i] = info[i].latency;
+        for (const Edge& edge : successors[i]) {
+            height[i] = std::max(height[i], edge.latency + height[edge.to]);
+        }
+    }
+
+    auto lower = [&](uint32_t a, uint32_t b) {
+        return height[a] != height[b] ? height[a] < height[b] : a > b;
+    };
+    std::priority_queue<uint32_t, std::vector<uint32_t>, decltype(lower)> ready(lower);
+    std::vector<uint32_t> earliest(count, 0);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (predecessors[i] == 0) ready.push(i);
+    }
+
+    std::vector<uint32_t> order;
+    order.reserve(count);
+    std::vector<uint32_t> deferred;
+    ResourceTable resources(model_);
+    uint32_t cycle = 0;
+
+    while (order.size() < count) {
+        uint32_t issued = 0;
+        uint32_t nextCycle = UINT32_MAX;
+        deferred.clear();
+
+        while (!ready.empty() && issued < model_.issueWidth) {
+            uint32_t candidate = ready.top();
+            ready.pop();
+            if (earliest[candidate] > cycle || !resources.available(info[candidate], cycle)) {
+                nextCycle = std::min(nextCycle, std::max(earliest[candidate], cycle + 1));
+                deferred.push_back(candidate);
+                continue;
+            }
+            resources.reserve(info[candidate], cycle);
+            order.push_back(candidate);
+            issued++;
+            for (const Edge& edge : successors[candidate]) {
+                earliest[edge.to] = std::max(earliest[edge.to], cycle + edge.latency);
+                if (--predecessors[edge.to] == 0) {
+                    // Las dependencias de latencia 0 pueden salir en este mismo ciclo
+                    ready.push(edge.to);
+                }
+            }
+        }
+
+        for (uint32_t candidate : deferred) ready.push(candidate);
+        cycle = issued == model_.issueWidth || nextCycle == UINT32_MAX ? cycle + 1 : nextCycle;
+    }
+
+    std::vector<X86Instruction> scheduled;
+    scheduled.reserve(count);
+    for (uint32_t index : order) scheduled.push_back(std::move(instructions[begin + index]));
+    std::move(scheduled.begin(), scheduled.end(), instructions.begin() + static_cast<std::ptrdiff_t>(begin));
+}
+
+uint32_t InstructionScheduler::estimateCycles(const std::vector<X86Instruction>& instructions) const {
+    // Emisión en orden: cada instrucción espera a sus operandos, a una
+    // unidad libre y a un hueco de despacho en el ciclo
+    std::array<uint32_t, 33> readyAt{};
+    uint32_t storeReadyAt = 0;
+    uint32_t cycle = 0;
+    uint32_t issued = 0;
+    uint32_t finish = 0;
+    ResourceTable resources(model_);
+
+    for (const X86Instruction& inst : instructions) {
+        if (inst.opcode == X86Opcode::NOP) continue;
+        InstructionInfo current = analyze(inst, model_);
+
+        uint32_t start = cycle;
+        for (size_t bit = 0; bit < readyAt.size(); ++bit) {
+            if (current.uses & (uint64_t{1} << bit)) start = std::max(start, readyAt[bit]);
+        }
+        if (current.loads) start = std::max(start, storeReadyAt);
+        while (!resources.available(current, start)) start++;
+
+        if (start != cycle) {
+            cycle = start;
+            issued = 0;
+        }
+        resources.reserve(current, cycle);
+        if (++issued == model_.issueWidth) {
+            cycle++;
+            issued = 0;
+        }
+
+        for (size_t bit = 0; bit < readyAt.size(); ++bit) {
+            if (current.defs & (uint64_t{1} << bit)) readyAt[bit] = start + current.latency;
+        }
+        if (current.stores) storeReadyAt = start + model_.storeForwardLatency;
+        finish = std::max(finish, start + current.latency);
+    }
+    return finish;
+}
+
+} // namespace cpp20::compiler::backend
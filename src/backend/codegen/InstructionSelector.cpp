@@ -4,17 +4,134 @@
  */
 
 #include <compiler/backend/codegen/InstructionSelector.h>
+#include <compiler/backend/codegen/X86Encoder.h>
+#include <compiler/ir/IRPasses.h>
 #include <sstream>
 #include <algorithm>
+#include <bit>
+#include <iterator>
 
 namespace cpp20::compiler::backend {
 
+namespace {
+
+/**
+ * @brief Registro de 64 bits con ese número hardware (el de FrameLayout)
+ */
+X86Register hardwareRegister(uint8_t number) {
+    static constexpr X86Register kRegisters[16] = {
+        X86Register::RAX, X86Register::RCX, X86Register::RDX, X86Register::RBX,
+        X86Register::RSP, X86Register::RBP, X86Register::RSI, X86Register::RDI,
+        X86Register::R8, X86Register::R9, X86Register::R10, X86Register::R11,
+        X86Register::R12, X86Register::R13, X86Register::R14, X86Register::R15};
+    return kRegisters[number & 15];
+}
+
+bool isFloatVector(const ir::TypeInfo& type) {
+    return type.elementType == ir::IRType::Float || type.elementType == ir::IRType::Double;
+}
+
+/**
+ * @brief Si el Call se baja a salto: marcado, seguido del Ret de su resultado y con los argumentos en pila que caben
+ */
+bool isLoweredTailCall(const ir::IRFunction& function, ir::InstrId id) {
+    const ir::Instruction& call = function.instruction(id);
+    if (call.opcode != ir::IROpcode::Call || !call.tail || call.next == ir::NoInstr) return false;
+    // Los argumentos en pila van al área de entrada que nos reservó nuestro
+    // llamador (el marco propio ya se ha liberado): no pueden ser más que los nuestros
+    size_t registers = static_cast<size_t>(abi::ABIContract::MAX_INTEGER_ARGS_IN_REGS);
+    if (function.operandCount(id) - 1 > std::max(registers, function.getParamTypes().size())) {
+        return false;
+    }
+    ir::InstrId next = call.next;
+    if (function.instruction(next).opcode != ir::IROpcode::Ret) return false;
+    return function.operandCount(next) == 0 || function.operand(next, 0) == call.result;
+}
+
+size_t laneSize(const ir::TypeInfo& type) {
+    return type.lanes == 0 ? 0 : type.size / type.lanes;
+}
+
+/**
+ * @brief Opcode de una operación elemental sobre vectores, o NOP si no hay
+ */
+X86Opcode vectorArithmetic(ir::IROpcode opcode, const ir::TypeInfo& type, bool vex) {
+    bool wide = laneSize(type) == 8;
+    auto pick = [&](X86Opcode sse32, X86Opcode sse64, X86Opcode vex32, X86Opcode vex64) {
+        return vex ? (wide ? vex64 : vex32) : (wide ? sse64 : sse32);
+    };
+
+    if (isFloatVector(type)) {
+        switch (opcode) {
+            case ir::IROpcode::Add: return pick(X86Opcode::ADDPS, X86Opcode::ADDPD, X86Opcode::VADDPS, X86Opcode::VADDPD);
+            case ir::IROpcode::Sub: return pick(X86Opcode::SUBPS, X86Opcode::SUBPD, X86Opcode::VSUBPS, X86Opcode::VSUBPD);
+            case ir::IROpcode::Mul: return pick(X86Opcode::MULPS, X86Opcode::MULPD, X86Opcode::VMULPS, X86Opcode::VMULPD);
+            case ir::IROpcode::Div: return pick(X86Opcode::DIVPS, X86Opcode::DIVPD, X86Opcode::VDIVPS, X86Opcode::VDIVPD);
+            default: return X86Opcode::NOP;
+        }
+    }
+
+    switch (opcode) {
+        case ir::IROpcode::Add: return pick(X86Opcode::PADDD, X86Opcode::PADDQ, X86Opcode::VPADDD, X86Opcode::VPADDQ);
+        case ir::IROpcode::Sub: return pick(X86Opcode::PSUBD, X86Opcode::PSUBQ, X86Opcode::VPSUBD, X86Opcode::VPSUBQ);
+        case ir::IROpcode::Mul:
+            // Sin PMULLQ (AVX-512) el vectorizador no genera Mul de 64 bits
+            return wide ? X86Opcode::NOP : (vex ? X86Opcode::VPMULLD : X86Opcode::PMULLD);
+        case ir::IROpcode::And: return vex ? X86Opcode::VPAND : X86Opcode::PAND;
+        case ir::IROpcode::Or: return vex ? X86Opcode::VPOR : X86Opcode::POR;
+        case ir::IROpcode::Xor: return vex ? X86Opcode::VPXOR : X86Opcode::PXOR;
+        default: return X86Opcode::NOP;
+    }
+}
+
+/**
+ * @brief Movimiento sin alinear entre memoria y registro vectorial
+ */
+X86Opcode vectorMove(const ir::TypeInfo& type, bool vex) {
+    if (!isFloatVector(type)) return vex ? X86Opcode::VMOVDQU : X86Opcode::MOVDQU;
+    if (laneSize(type) == 8) return vex ? X86Opcode::VMOVUPD : X86Opcode::MOVUPD;
+    return vex ? X86Opcode::VMOVUPS : X86Opcode::MOVUPS;
+}
+
+bool isCommutative(ir::IROpcode opcode) {
+    return opcode == ir::IROpcode::Add || opcode == ir::IROpcode::Mul || opcode == ir::IROpcode::And ||
+           opcode == ir::IROpcode::Or || opcode == ir::IROpcode::Xor;
+}
+
+/**
+ * @brief Nombre de 32 bits de un registro general de 64 bits (MOVD)
+ */
+X86Register toRegister32(X86Register reg) {
+    int index = static_cast<int>(reg);
+    if (index > static_cast<int>(X86Register::R15)) return reg;
+    return static_cast<X86Register>(index + static_cast<int>(X86Register::EAX));
+}
+
+/**
+ * @brief Nombre de 8, 4, 2 o 1 bytes de un registro general de 64 bits
+ */
+X86Register sizedRegister(X86Register reg, int32_t bytes) {
+    int groups = bytes == 8 ? 0 : bytes == 4 ? 1 : bytes == 2 ? 2 : 3;
+    return static_cast<X86Register>(static_cast<int>(reg) + 16 * groups);
+}
+
+/**
+ * @brief Si una instrucción produce o consume un vector
+ */
+bool isVectorInstruction(const ir::IRFunction& function, ir::InstrId id) {
+    const ir::Instruction& inst = function.instruction(id);
+    if (inst.opcode == ir::IROpcode::Store) return function.typeOf(function.operand(id, 0)).isVector();
+    return inst.result != ir::NoValue && function.typeOf(inst.result).isVector();
+}
+
+} // namespace
+
 // ============================================================================
 // InstructionSelector - Implementación
 // ============================================================================
 
-InstructionSelector::InstructionSelector(const abi::ABIContract& abiContract)
-    : abiContract_(abiContract) {
+InstructionSelector::InstructionSelector(const abi::ABIContract& abiContract, const CPUFeatures& features)
+    : abiContract_(abiContract), features_(features) {
 }
 
 InstructionSelector::~InstructionSelector() = default;
@@ -24,20 +141,40 @@ std::vector<X86Instruction> InstructionSelector::selectInstructions(
     const std::unordered_map<int, RegisterMapping>& registerMap) {
 
     std::vector<X86Instruction> instructions;
+    jumpTables_.clear();
+
+    // Con registros YMM sucios, las transiciones a código SSE del llamado o
+    // del llamador penalizan: se limpia la mitad alta antes de salir
+    bool usesYmm = false;
+    for (ir::BlockId block = 0; block < function.blockCount() && !usesYmm; ++block) {
+        for (ir::InstrId inst : function.instructions(block)) {
+            const ir::Instruction& data = function.instruction(inst);
+            if (data.opcode >= ir::IROpcode::MemCpy && data.opcode <= ir::IROpcode::MemCmp) {
+                // Intrínsecos de memoria: bloques de 32 bytes con AVX2
+                const ir::IRConstant* size = function.constant(function.operand(inst, 2));
+                if (features_.avx2 && size && size->intValue >= 32) usesYmm = true;
+                continue;
+            }
+            if (!isVectorInstruction(function, inst)) continue;
+            ir::ValueId typed = data.opcode == ir::IROpcode::Store ? function.operand(inst, 0) : data.result;
+            if (function.typeOf(typed).size == 32) usesYmm = true;
+        }
+    }
 
-    // Procesar cada bloque básico
-    for (const auto& block : function.getBasicBlocks()) {
+    // Procesar cada bloque básico, en el orden de block-placement si lo hay
+    for (ir::BlockId block : function.blockLayout()) {
         // Etiqueta del bloque
         X86Instruction labelInst;
         labelInst.opcode = X86Opcode::NOP; // Placeholder para etiqueta
-        labelInst.comment = block->getName() + ":";
+        labelInst.comment = function.block(block).name + ":";
+        // Un inmediato en la etiqueta pide alinear el bloque (cabeceras de bucle)
+        if (uint32_t alignment = function.block(block).alignment; alignment > 1) {
+            labelInst.operands.push_back(createImmediateOperand(alignment));
+        }
         instructions.push_back(labelInst);
 
         // Procesar instrucciones del bloque
-        for (const auto& inst : block->getInstructions()) {
-            auto selected = selectInstruction(*inst, registerMap);
-            instructions.insert(instructions.end(), selected.begin(), selected.end());
-        }
+        selectBlock(function, block, registerMap, usesYmm, instructions);
     }
 
     // Optimizar secuencia final
@@ -47,10 +184,15 @@ std::vector<X86Instruction> InstructionSelector::selectInstructions(
 }
 
 std::vector<X86Instruction> InstructionSelector::selectInstruction(
-    const ir::IRInstruction& instruction,
+    const ir::IRFunction& function,
+    ir::InstrId instruction,
     const std::unordered_map<int, RegisterMapping>& registerMap) {
 
-    switch (instruction.getOpcode()) {
+    if (isVectorInstruction(function, instruction)) {
+        return selectVectorOperation(function, instruction, registerMap);
+    }
+
+    switch (function.instruction(instruction).opcode) {
         case ir::IROpcode::Add:
         case ir::IROpcode::Sub:
         case ir::IROpcode::Mul:
@@ -65,34 +207,52 @@ std::vector<X86Instruction> InstructionSelector::selectInstruction(
         case ir::IROpcode::CmpLE:
         case ir::IROpcode::CmpGT:
         case ir::IROpcode::CmpGE:
-            return selectBinaryOperation(
-                static_cast<const ir::BinaryInstruction&>(instruction), registerMap);
+            return selectBinaryOperation(function, instruction, registerMap);
 
         case ir::IROpcode::Neg:
         case ir::IROpcode::Not:
-            return selectUnaryOperation(
-                static_cast<const ir::UnaryInstruction&>(instruction), registerMap);
+            return selectUnaryOperation(function, instruction, registerMap);
 
         case ir::IROpcode::Load:
-            return selectLoad(
-                static_cast<const ir::LoadInstruction&>(instruction), registerMap);
+            return selectLoad(function, instruction, registerMap);
 
         case ir::IROpcode::Store:
-            return selectStore(
-                static_cast<const ir::StoreInstruction&>(instruction), registerMap);
+            return selectStore(function, instruction, registerMap);
 
         case ir::IROpcode::Br:
         case ir::IROpcode::BrCond:
-            return selectBranch(
-                static_cast<const ir::BranchInstruction&>(instruction));
+            return selectBranch(function, instruction);
+
+        case ir::IROpcode::Switch:
+            return selectSwitch(function, instruction, registerMap);
+
+        case ir::IROpcode::Select:
+            return selectSelect(function, instruction, registerMap);
+
+        case ir::IROpcode::MemCpy:
+        case ir::IROpcode::MemSet:
+        case ir::IROpcode::MemCmp:
+            return selectMemoryIntrinsic(function, instruction, registerMap);
+
+        case ir::IROpcode::CPUFeatures:
+            return selectCPUFeatures(function, instruction, registerMap);
+
+        case ir::IROpcode::PopCount:
+        case ir::IROpcode::CountLeadingZeros:
+        case ir::IROpcode::CountTrailingZeros:
+        case ir::IROpcode::ByteSwap:
+        case ir::IROpcode::RotateLeft:
+        case ir::IROpcode::RotateRight:
+        case ir::IROpcode::BitDeposit:
+        case ir::IROpcode::BitExtract:
+        case ir::IROpcode::Crc32:
+            return selectBitIntrinsic(function, instruction, registerMap);
 
         case ir::IROpcode::Ret:
-            return selectReturn(
-                static_cast<const ir::ReturnInstruction&>(instruction), registerMap);
+            return selectReturn(function, instruction, registerMap);
 
         case ir::IROpcode::Call:
-            return selectCall(
-                static_cast<const ir::CallInstruction&>(instruction), registerMap);
+            return selectCall(function, instruction, registerMap);
 
         default:
             // Instrucción no soportada
@@ -100,56 +260,73 @@ std::vector<X86Instruction> InstructionSelector::selectInstruction(
     }
 }
 
-std::vector<X86Instruction> InstructionSelector::generateFunctionPrologue(
-    const ir::IRFunction& function,
-    size_t stackSize) {
-
+std::vector<X86Instruction> InstructionSelector::generateFunctionPrologue(const FrameLayout& frame) {
     std::vector<X86Instruction> prologue;
+    if (frame.isLeaf) return prologue;
 
-    // Push callee-saved registers
-    for (int i = 0; i < 16; ++i) {
-        if (abiContract_.isCalleeSavedRegister(i)) {
-            X86Instruction pushInst(X86Opcode::PUSH);
-            pushInst.operands.push_back(createRegisterOperand(static_cast<X86Register>(i)));
-            prologue.push_back(pushInst);
-        }
+    // Guardar solo los no volátiles que usa el cuerpo
+    for (uint8_t reg : frame.savedRegisters) {
+        X86Instruction pushInst(X86Opcode::PUSH);
+        pushInst.operands.push_back(createRegisterOperand(hardwareRegister(reg)));
+        prologue.push_back(pushInst);
     }
 
-    // Set up frame pointer
-    X86Instruction movInst(X86Opcode::MOV);
-    movInst.operands.push_back(createRegisterOperand(X86Register::RBP));
-    movInst.operands.push_back(createRegisterOperand(X86Register::RSP));
-    prologue.push_back(movInst);
-
-    // Allocate stack space
-    if (stackSize > 0) {
+    // Reservar shadow space y locales. Una página o más se reserva como MSVC:
+    // __chkstk toca cada página del tamaño de EAX y el SUB usa RAX
+    if (frame.needsStackProbe()) {
+        X86Instruction sizeInst(X86Opcode::MOV);
+        sizeInst.operands.push_back(createRegisterOperand(X86Register::EAX));
+        sizeInst.operands.push_back(createImmediateOperand(static_cast<int64_t>(frame.allocationSize)));
+        prologue.push_back(sizeInst);
+        X86Instruction probeInst(X86Opcode::CALL);
+        probeInst.comment = "__chkstk";
+        prologue.push_back(probeInst);
+        X86Instruction subInst(X86Opcode::SUB);
+        subInst.operands.push_back(createRegisterOperand(X86Register::RSP));
+        subInst.operands.push_back(createRegisterOperand(X86Register::RAX));
+        prologue.push_back(subInst);
+    } else if (frame.allocationSize > 0) {
         X86Instruction subInst(X86Opcode::SUB);
         subInst.operands.push_back(createRegisterOperand(X86Register::RSP));
-        subInst.operands.push_back(createImmediateOperand(stackSize));
+        subInst.operands.push_back(createImmediateOperand(static_cast<int64_t>(frame.allocationSize)));
         prologue.push_back(subInst);
     }
 
+    // RBP se fija después de reservar (UWOP_SET_FPREG con desplazamiento 0)
+    if (frame.usesFramePointer) {
+        X86Instruction movInst(X86Opcode::MOV);
+        movInst.operands.push_back(createRegisterOperand(X86Register::RBP));
+        movInst.operands.push_back(createRegisterOperand(X86Register::RSP));
+        prologue.push_back(movInst);
+    }
+
     return prologue;
 }
 
-std::vector<X86Instruction> InstructionSelector::generateFunctionEpilogue(
-    const ir::IRFunction& function) {
-
+std::vector<X86Instruction> InstructionSelector::generateFunctionEpilogue(const FrameLayout& frame) {
     std::vector<X86Instruction> epilogue;
 
-    // Deallocate stack space (simplificado)
-    X86Instruction movInst(X86Opcode::MOV);
-    movInst.operands.push_back(createRegisterOperand(X86Register::RSP));
-    movInst.operands.push_back(createRegisterOperand(X86Register::RBP));
-    epilogue.push_back(movInst);
+    // Las dos formas de liberar el marco que admite el unwinder de Windows x64
+    if (frame.usesFramePointer) {
+        X86Operand address(AddressingMode::MemoryBaseDisp);
+        address.reg = X86Register::RBP;
+        address.displacement = static_cast<int32_t>(frame.allocationSize);
+        X86Instruction leaInst(X86Opcode::LEA);
+        leaInst.operands.push_back(createRegisterOperand(X86Register::RSP));
+        leaInst.operands.push_back(address);
+        epilogue.push_back(leaInst);
+    } else if (frame.allocationSize > 0) {
+        X86Instruction addInst(X86Opcode::ADD);
+        addInst.operands.push_back(createRegisterOperand(X86Register::RSP));
+        addInst.operands.push_back(createImmediateOperand(static_cast<int64_t>(frame.allocationSize)));
+        epilogue.push_back(addInst);
+    }
 
-    // Pop callee-saved registers (en orden inverso)
-    for (int i = 15; i >= 0; --i) {
-        if (abiContract_.isCalleeSavedRegister(i)) {
-            X86Instruction popInst(X86Opcode::POP);
-            popInst.operands.push_back(createRegisterOperand(static_cast<X86Register>(i)));
-            epilogue.push_back(popInst);
-        }
+    // Restaurar en orden inverso al prólogo
+    for (auto it = frame.savedRegisters.rbegin(); it != frame.savedRegisters.rend(); ++it) {
+        X86Instruction popInst(X86Opcode::POP);
+        popInst.operands.push_back(createRegisterOperand(hardwareRegister(*it)));
+        epilogue.push_back(popInst);
     }
 
     // Return
@@ -196,6 +373,18 @@ std::string InstructionSelector::instructionsToAssembly(const std::vector<X86Ins
                     }
                     ss << "]";
                     break;
+                case AddressingMode::RipRelative:
+                    ss << "[rip+" << inst.comment << "]";
+                    break;
+                case AddressingMode::MemoryBaseIndex:
+                case AddressingMode::MemoryBaseIndexDisp:
+                    ss << "[" << registerToString(operand.baseReg) << "+" << registerToString(operand.indexReg);
+                    if (operand.scale != 1) ss << "*" << static_cast<int>(operand.scale);
+                    if (operand.displacement != 0) {
+                        ss << (operand.displacement > 0 ? "+" : "") << operand.displacement;
+                    }
+                    ss << "]";
+                    break;
                 default:
                     ss << "<unknown>";
                     break;
@@ -217,17 +406,19 @@ std::string InstructionSelector::instructionsToAssembly(const std::vector<X86Ins
 // ============================================================================
 
 std::vector<X86Instruction> InstructionSelector::selectBinaryOperation(
-    const ir::BinaryInstruction& instruction,
+    const ir::IRFunction& function,
+    ir::InstrId instruction,
     const std::unordered_map<int, RegisterMapping>& registerMap) {
 
     std::vector<X86Instruction> instructions;
+    const ir::Instruction& inst = function.instruction(instruction);
 
-    auto resultReg = getPhysicalRegister(instruction.getResult()->getId(), registerMap);
-    auto leftOp = convertOperand(instruction.getOperands()[0], registerMap);
-    auto rightOp = convertOperand(instruction.getOperands()[1], registerMap);
+    auto resultReg = getPhysicalRegister(inst.result, registerMap);
+    auto leftOp = convertOperand(function, function.operand(instruction, 0), registerMap);
+    auto rightOp = convertOperand(function, function.operand(instruction, 1), registerMap);
 
     X86Opcode opcode;
-    switch (instruction.getOpcode()) {
+    switch (inst.opcode) {
         case ir::IROpcode::Add: opcode = X86Opcode::ADD; break;
         case ir::IROpcode::Sub: opcode = X86Opcode::SUB; break;
         case ir::IROpcode::And: opcode = X86Opcode::AND; break;
@@ -250,20 +441,22 @@ std::vector<X86Instruction> InstructionSelector::selectBinaryOperation(
 }
 
 std::vector<X86Instruction> InstructionSelector::selectUnaryOperation(
-    const ir::UnaryInstruction& instruction,
+    const ir::IRFunction& function,
+    ir::InstrId instruction,
     const std::unordered_map<int, RegisterMapping>& registerMap) {
 
     std::vector<X86Instruction> instructions;
+    const ir::Instruction& inst = function.instruction(instruction);
 
-    auto resultReg = getPhysicalRegister(instruction.getResult()->getId(), registerMap);
-    auto operand = convertOperand(instruction.getOperands()[0], registerMap);
+    auto resultReg = getPhysicalRegister(inst.result, registerMap);
+    auto operand = convertOperand(function, function.operand(instruction, 0), registerMap);
 
     // Movemos el operando al registro resultado
     auto moveInsts = generateMove(createRegisterOperand(resultReg), operand);
     instructions.insert(instructions.end(), moveInsts.begin(), moveInsts.end());
 
     // Aplicamos la operación unaria
-    X86Opcode opcode = (instruction.getOpcode() == ir::IROpcode::Neg) ?
+    X86Opcode opcode = (inst.opcode == ir::IROpcode::Neg) ?
                        X86Opcode::NEG : X86Opcode::NOT;
 
     X86Instruction opInst(opcode);
@@ -274,15 +467,25 @@ std::vector<X86Instruction> InstructionSelector::selectUnaryOperation(
 }
 
 std::vector<X86Instruction> InstructionSelector::selectLoad(
-    const ir::LoadInstruction& instruction,
+    const ir::IRFunction& function,
+    ir::InstrId instruction,
     const std::unordered_map<int, RegisterMapping>& registerMap) {
 
     std::vector<X86Instruction> instructions;
+    const ir::Instruction& inst = function.instruction(instruction);
 
-    auto resultReg = getPhysicalRegister(instruction.getResult()->getId(), registerMap);
-    auto addressOp = convertOperand(instruction.getOperands()[0], registerMap);
+    auto resultReg = getPhysicalRegister(inst.result, registerMap);
+    ir::ValueId address = function.operand(instruction, 0);
+    auto addressOp = convertOperand(function, address, registerMap);
 
     X86Instruction loadInst(X86Opcode::MOV);
+    if (function.value(address).kind == ir::ValueKind::Global) {
+        // Variable global: [RIP + símbolo]
+        addressOp = X86Operand(AddressingMode::RipRelative);
+        loadInst.comment = function.globalName(address);
+        int32_t size = static_cast<int32_t>(function.typeOf(inst.result).size);
+        if (size == 1 || size == 2 || size == 4) resultReg = sizedRegister(resultReg, size);
+    }
     loadInst.operands.push_back(createRegisterOperand(resultReg));
     loadInst.operands.push_back(addressOp);
     instructions.push_back(loadInst);
@@ -291,15 +494,34 @@ std::vector<X86Instruction> InstructionSelector::selectLoad(
 }
 
 std::vector<X86Instruction> InstructionSelector::selectStore(
-    const ir::StoreInstruction& instruction,
+    const ir::IRFunction& function,
+    ir::InstrId instruction,
     const std::unordered_map<int, RegisterMapping>& registerMap) {
 
     std::vector<X86Instruction> instructions;
 
-    auto valueOp = convertOperand(instruction.getOperands()[0], registerMap);
-    auto addressOp = convertOperand(instruction.getOperands()[1], registerMap);
+    ir::ValueId value = function.operand(instruction, 0);
+    ir::ValueId address = function.operand(instruction, 1);
+    auto valueOp = convertOperand(function, value, registerMap);
+    auto addressOp = convertOperand(function, address, registerMap);
 
     X86Instruction storeInst(X86Opcode::MOV);
+    if (function.value(value).kind == ir::ValueKind::Global) {
+        // La dirección de un símbolo se calcula en R11
+        X86Instruction lea(X86Opcode::LEA);
+        lea.operands = {createRegisterOperand(X86Register::R11), X86Operand(AddressingMode::RipRelative)};
+        lea.comment = function.globalName(value);
+        instructions.push_back(lea);
+        valueOp = createRegisterOperand(X86Register::R11);
+    }
+    if (function.value(address).kind == ir::ValueKind::Global) {
+        addressOp = X86Operand(AddressingMode::RipRelative);
+        storeInst.comment = function.globalName(address);
+        int32_t size = static_cast<int32_t>(function.typeOf(value).size);
+        if (valueOp.mode == AddressingMode::Register && (size == 1 || size == 2 || size == 4)) {
+            valueOp.reg = sizedRegister(valueOp.reg, size);
+        }
+    }
     storeInst.operands.push_back(addressOp);
     storeInst.operands.push_back(valueOp);
     instructions.push_back(storeInst);
@@ -308,35 +530,685 @@ std::vector<X86Instruction> InstructionSelector::selectStore(
 }
 
 std::vector<X86Instruction> InstructionSelector::selectBranch(
-    const ir::BranchInstruction& instruction) {
+    const ir::IRFunction& function,
+    ir::InstrId instruction) {
 
     std::vector<X86Instruction> instructions;
 
-    if (instruction.getOpcode() == ir::IROpcode::BrCond) {
+    // El destino va en el comentario: es la etiqueta que usa X86Encoder
+    auto jumpTo = [&](X86Opcode opcode, size_t operand) {
+        X86Instruction jmpInst(opcode);
+        jmpInst.comment = function.block(function.labelBlock(function.operand(instruction, operand))).name;
+        instructions.push_back(jmpInst);
+    };
+
+    if (function.instruction(instruction).opcode == ir::IROpcode::BrCond) {
         // Branch condicional - asumimos que el primer operando es la condición
         // En un compilador real, esto sería más complejo
-        X86Instruction jmpInst(X86Opcode::JNE);
-        // Agregar etiqueta de destino (simplificado)
-        instructions.push_back(jmpInst);
+        jumpTo(X86Opcode::JNE, 1);
+        jumpTo(X86Opcode::JMP, 2);
     } else {
         // Branch incondicional
-        X86Instruction jmpInst(X86Opcode::JMP);
-        // Agregar etiqueta de destino (simplificado)
-        instructions.push_back(jmpInst);
+        jumpTo(X86Opcode::JMP, 0);
+    }
+
+    return instructions;
+}
+
+std::vector<X86Instruction> InstructionSelector::selectSwitch(
+    const ir::IRFunction& function,
+    ir::InstrId instruction,
+    const std::unordered_map<int, RegisterMapping>& registerMap) {
+
+    std::vector<X86Instruction> instructions;
+    auto blockName = [&](ir::ValueId label) { return function.block(function.labelBlock(label)).name; };
+    auto emit = [&](X86Opcode opcode, std::vector<X86Operand> operands, std::string comment = {}) {
+        X86Instruction inst(opcode);
+        inst.operands = std::move(operands);
+        inst.comment = std::move(comment);
+        instructions.push_back(std::move(inst));
+    };
+    // Operaciones de R10 con un inmediato de 64 bits pasan por R11
+    auto withImmediate = [&](X86Opcode opcode, int64_t value) {
+        if (value >= INT32_MIN && value <= INT32_MAX) {
+            emit(opcode, {createRegisterOperand(X86Register::R10), createImmediateOperand(value)});
+            return;
+        }
+        emit(X86Opcode::MOV, {createRegisterOperand(X86Register::R11), createImmediateOperand(value)});
+        emit(opcode, {createRegisterOperand(X86Register::R10), createRegisterOperand(X86Register::R11)});
+    };
+
+    std::vector<std::pair<int64_t, std::string>> cases;
+    for (size_t i = 2; i + 1 < function.operandCount(instruction); i += 2) {
+        cases.emplace_back(function.constant(function.operand(instruction, i))->intValue,
+                           blockName(function.operand(instruction, i + 1)));
+    }
+    std::sort(cases.begin(), cases.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    std::string defaultTarget = blockName(function.operand(instruction, 1));
+
+    // El valor en R10, libre fuera de las recargas del asignador
+    emit(X86Opcode::MOV, {createRegisterOperand(X86Register::R10),
+                          convertOperand(function, function.operand(instruction, 0), registerMap)});
+
+    ir::SwitchLoweringOptions density;
+    uint64_t entries = cases.empty() ? 0
+                                     : static_cast<uint64_t>(cases.back().first) -
+                                           static_cast<uint64_t>(cases.front().first) + 1;
+    bool dense = cases.size() >= density.minJumpTableCases && entries != 0 &&
+                 entries <= density.maxJumpTableEntries &&
+                 cases.size() * 100 >= entries * density.minJumpTableDensity;
+    if (!dense) {
+        for (const auto& [value, target] : cases) {
+            withImmediate(X86Opcode::CMP, value);
+            emit(X86Opcode::JE, {}, target);
+        }
+        emit(X86Opcode::JMP, {}, defaultTarget);
+        return instructions;
+    }
+
+    // Índice = valor - mínimo; los negativos quedan por encima del rango sin signo
+    if (cases.front().first != 0) withImmediate(X86Opcode::SUB, cases.front().first);
+    emit(X86Opcode::CMP, {createRegisterOperand(X86Register::R10),
+                          createImmediateOperand(static_cast<int64_t>(entries - 1))});
+    emit(X86Opcode::JA, {}, defaultTarget);
+
+    JumpTable table;
+    table.name = "$jt" + std::to_string(jumpTables_.size());
+    table.targets.assign(entries, defaultTarget);
+    for (const auto& [value, target] : cases) {
+        table.targets[static_cast<uint64_t>(value) - static_cast<uint64_t>(cases.front().first)] = target;
+    }
+    emit(X86Opcode::JMPTABLE, {createRegisterOperand(X86Register::R10), createRegisterOperand(X86Register::R11)},
+         table.name);
+    jumpTables_.push_back(std::move(table));
+    return instructions;
+}
+
+std::vector<X86Instruction> InstructionSelector::selectSelect(
+    const ir::IRFunction& function,
+    ir::InstrId instruction,
+    const std::unordered_map<int, RegisterMapping>& registerMap) {
+
+    std::vector<X86Instruction> instructions;
+    const ir::Instruction& inst = function.instruction(instruction);
+    auto emit = [&](X86Opcode opcode, std::vector<X86Operand> operands) {
+        X86Instruction emitted(opcode);
+        emitted.operands = std::move(operands);
+        instructions.push_back(std::move(emitted));
+    };
+    auto reg = [&](X86Register r) { return createRegisterOperand(r); };
+    auto isRegister = [](const X86Operand& operand) { return operand.mode == AddressingMode::Register; };
+    auto isConstant = [&](ir::ValueId value) { return function.value(value).kind == ir::ValueKind::Constant; };
+
+    // Bits de una constante de coma flotante de su tamaño
+    auto floatBits = [&](ir::ValueId value) -> int64_t {
+        const ir::IRConstant* constant = function.constant(value);
+        if (function.typeOf(value).size == 4) {
+            return std::bit_cast<uint32_t>(static_cast<float>(constant->floatValue));
+        }
+        return std::bit_cast<int64_t>(constant->floatValue);
+    };
+    // Un escalar de coma flotante puede vivir en un XMM o, según lo asigne el allocator, en un GPR
+    auto isXmm = [](X86Register r) { return r >= X86Register::XMM0 && r <= X86Register::XMM15; };
+    auto transfer = [&](const ir::TypeInfo& type) { return type.size == 4 ? X86Opcode::MOVD : X86Opcode::MOVQ; };
+    auto intoXmm = [&](ir::ValueId value, X86Register scratch) {
+        if (!isConstant(value)) {
+            X86Operand operand = convertOperand(function, value, registerMap);
+            if (isXmm(operand.reg)) return operand;
+            emit(transfer(function.typeOf(value)), {reg(scratch), operand});
+            return reg(scratch);
+        }
+        emit(X86Opcode::MOV, {reg(X86Register::R10), createImmediateOperand(floatBits(value))});
+        emit(transfer(function.typeOf(value)), {reg(scratch), reg(X86Register::R10)});
+        return reg(scratch);
+    };
+    auto intoGeneral = [&](ir::ValueId value, X86Register target) {
+        if (isConstant(value)) {
+            emit(X86Opcode::MOV, {reg(target), createImmediateOperand(floatBits(value))});
+        } else {
+            X86Operand operand = convertOperand(function, value, registerMap);
+            emit(isXmm(operand.reg) ? transfer(function.typeOf(value)) : X86Opcode::MOV, {reg(target), operand});
+        }
+    };
+
+    ir::ValueId condition = function.operand(instruction, 0);
+    ir::ValueId whenTrue = function.operand(instruction, 1);
+    ir::ValueId whenFalse = function.operand(instruction, 2);
+    const ir::TypeInfo& type = function.typeOf(inst.result);
+    X86Register result = getPhysicalRegister(inst.result, registerMap);
+
+    ir::InstrId compare = ir::NoInstr;
+    if (function.value(condition).kind == ir::ValueKind::Instruction) {
+        ir::InstrId id = function.definingInstruction(condition);
+        ir::IROpcode opcode = function.instruction(id).opcode;
+        if (opcode >= ir::IROpcode::CmpEQ && opcode <= ir::IROpcode::CmpGE) compare = id;
+    }
+
+    // Comparación normalizada: los operandos de coma flotante se giran para
+    // que solo queden > y >= (un NaN deja CF = 1 y los dos dan falso)
+    ir::IROpcode predicate = ir::IROpcode::CmpNE;
+    ir::ValueId left = condition, right = ir::NoValue;
+    bool floatCompare = false;
+    if (compare != ir::NoInstr) {
+        predicate = function.instruction(compare).opcode;
+        left = function.operand(compare, 0);
+        right = function.operand(compare, 1);
+        floatCompare = function.typeOf(left).isFloatingPoint();
+        auto mirror = [&]() {
+            std::swap(left, right);
+            switch (predicate) {
+                case ir::IROpcode::CmpLT: predicate = ir::IROpcode::CmpGT; break;
+                case ir::IROpcode::CmpLE: predicate = ir::IROpcode::CmpGE; break;
+                case ir::IROpcode::CmpGT: predicate = ir::IROpcode::CmpLT; break;
+                case ir::IROpcode::CmpGE: predicate = ir::IROpcode::CmpLE; break;
+                default: break;
+            }
+        };
+        if (floatCompare ? predicate == ir::IROpcode::CmpLT || predicate == ir::IROpcode::CmpLE
+                         : isConstant(left) && !isConstant(right)) {
+            mirror();
+        }
+    }
+
+    // x > y ? x : y es MAXSS x, y y x > y ? y : x es MINSS y, x, también con NaN
+    if (type.isFloatingPoint() && floatCompare && predicate == ir::IROpcode::CmpGT &&
+        !isConstant(whenTrue) && !isConstant(whenFalse) &&
+        ((whenTrue == left && whenFalse == right) || (whenTrue == right && whenFalse == left))) {
+        bool maximum = whenTrue == left;
+        bool single = type.size == 4;
+        X86Opcode opcode = maximum ? (single ? X86Opcode::MAXSS : X86Opcode::MAXSD)
+                                   : (single ? X86Opcode::MINSS : X86Opcode::MINSD);
+        X86Operand destination = intoXmm(whenTrue, X86Register::XMM14);
+        X86Operand source = intoXmm(whenFalse, X86Register::XMM15);
+        X86Register work = !isXmm(result) || (source.reg == result && destination.reg != result) ? X86Register::XMM14
+                                                                                                 : result;
+        if (destination.reg != work) emit(X86Opcode::MOVAPS, {reg(work), destination});
+        emit(opcode, {reg(work), source});
+        if (work != result) emit(isXmm(result) ? X86Opcode::MOVAPS : transfer(type), {reg(result), reg(work)});
+        return instructions;
+    }
+
+    // Flags
+    X86Opcode cmov = X86Opcode::CMOVNE;
+    if (compare == ir::NoInstr) {
+        X86Operand tested = convertOperand(function, condition, registerMap);
+        if (!isRegister(tested)) {
+            emit(X86Opcode::MOV, {reg(X86Register::R10), tested});
+            tested = reg(X86Register::R10);
+        }
+        emit(X86Opcode::TEST, {tested, tested});
+    } else if (floatCompare) {
+        X86Operand a = intoXmm(left, X86Register::XMM14);
+        X86Operand b = intoXmm(right, a.reg == X86Register::XMM14 ? X86Register::XMM15 : X86Register::XMM14);
+        emit(function.typeOf(left).size == 4 ? X86Opcode::COMISS : X86Opcode::COMISD, {a, b});
+        cmov = predicate == ir::IROpcode::CmpGT ? X86Opcode::CMOVA : X86Opcode::CMOVAE;
+    } else {
+        X86Operand a = convertOperand(function, left, registerMap);
+        X86Operand b = convertOperand(function, right, registerMap);
+        if (!isRegister(a)) {
+            emit(X86Opcode::MOV, {reg(X86Register::R10), a});
+            a = reg(X86Register::R10);
+        }
+        if (b.mode == AddressingMode::Immediate && (b.immediate < INT32_MIN || b.immediate > INT32_MAX)) {
+            X86Register scratch = a.reg == X86Register::R10 ? X86Register::R11 : X86Register::R10;
+            emit(X86Opcode::MOV, {reg(scratch), b});
+            b = reg(scratch);
+        }
+        emit(X86Opcode::CMP, {a, b});
+        bool unsignedCompare = function.typeOf(left).type == ir::IRType::Pointer;
+        switch (predicate) {
+            case ir::IROpcode::CmpEQ: cmov = X86Opcode::CMOVE; break;
+            case ir::IROpcode::CmpNE: cmov = X86Opcode::CMOVNE; break;
+            case ir::IROpcode::CmpLT: cmov = unsignedCompare ? X86Opcode::CMOVB : X86Opcode::CMOVL; break;
+            case ir::IROpcode::CmpLE: cmov = unsignedCompare ? X86Opcode::CMOVBE : X86Opcode::CMOVLE; break;
+            case ir::IROpcode::CmpGT: cmov = unsignedCompare ? X86Opcode::CMOVA : X86Opcode::CMOVG; break;
+            default: cmov = unsignedCompare ? X86Opcode::CMOVAE : X86Opcode::CMOVGE; break;
+        }
+    }
+
+    // Coma flotante: la elección se hace en R10/R11 y vuelve al registro resultado
+    if (type.isFloatingPoint()) {
+        intoGeneral(whenFalse, X86Register::R10);
+        intoGeneral(whenTrue, X86Register::R11);
+        emit(cmov, {reg(X86Register::R10), reg(X86Register::R11)});
+        emit(isXmm(result) ? transfer(type) : X86Opcode::MOV, {reg(result), reg(X86Register::R10)});
+        return instructions;
+    }
+
+    // result = falso; CMOVcc result, verdadero. MOV no toca los flags. Si el
+    // verdadero ya está en result, se invierte la condición.
+    X86Operand chosen = convertOperand(function, whenTrue, registerMap);
+    X86Operand fallback = convertOperand(function, whenFalse, registerMap);
+    if (isRegister(chosen) && chosen.reg == result) {
+        static constexpr std::pair<X86Opcode, X86Opcode> kInverse[] = {
+            {X86Opcode::CMOVE, X86Opcode::CMOVNE}, {X86Opcode::CMOVL, X86Opcode::CMOVGE},
+            {X86Opcode::CMOVLE, X86Opcode::CMOVG}, {X86Opcode::CMOVB, X86Opcode::CMOVAE},
+            {X86Opcode::CMOVBE, X86Opcode::CMOVA},
+        };
+        for (const auto& [a, b] : kInverse) {
+            if (cmov == a || cmov == b) {
+                cmov = cmov == a ? b : a;
+                break;
+            }
+        }
+        std::swap(chosen, fallback);
+    }
+    if (!isRegister(fallback) || fallback.reg != result) emit(X86Opcode::MOV, {reg(result), fallback});
+    if (!isRegister(chosen)) {
+        emit(X86Opcode::MOV, {reg(X86Register::R10), chosen});
+        chosen = reg(X86Register::R10);
+    }
+    emit(cmov, {reg(result), chosen});
+    return instructions;
+}
+
+std::vector<X86Instruction> InstructionSelector::selectMemoryIntrinsic(
+    const ir::IRFunction& function,
+    ir::InstrId instruction,
+    const std::unordered_map<int, RegisterMapping>& registerMap) {
+
+    std::vector<X86Instruction> instructions;
+    const ir::Instruction& inst = function.instruction(instruction);
+    const ir::IRConstant* sizeConstant = function.constant(function.operand(instruction, 2));
+    if (!sizeConstant || sizeConstant->intValue < 0 || sizeConstant->intValue > INT32_MAX) return instructions;
+    auto size = static_cast<int32_t>(sizeConstant->intValue);
+
+    auto emit = [&](X86Opcode opcode, std::initializer_list<X86Operand> operands) {
+        X86Instruction i(opcode);
+        i.operands = operands;
+        instructions.push_back(i);
+    };
+    auto reg = [&](X86Register r) { return createRegisterOperand(r); };
+    X86Register left = getPhysicalRegister(static_cast<int>(function.operand(instruction, 0)), registerMap);
+    X86Register right = getPhysicalRegister(static_cast<int>(function.operand(instruction, 1)), registerMap);
+
+    // Trozos (desplazamiento, bytes): bloques enteros, y el resto con un
+    // bloque solapado sobre el final; nada se lee ni escribe fuera de [0, size)
+    int32_t chunk = features_.avx2 && size >= 32 ? 32 : 16;
+    std::vector<std::pair<int32_t, int32_t>> pieces;
+    int32_t offset = 0;
+    for (; size - offset >= chunk; offset += chunk) pieces.emplace_back(offset, chunk);
+    if (offset < size && size >= 16) {
+        int32_t last = size - offset > 16 ? chunk : 16;
+        pieces.emplace_back(size - last, last);
+    } else if (offset < size) {
+        int32_t bytes = size >= 8 ? 8 : size >= 4 ? 4 : size >= 2 ? 2 : 1;
+        pieces.emplace_back(0, bytes);
+        if (size > bytes) pieces.emplace_back(size - bytes, bytes);
+    }
+
+    bool vex = features_.avx;
+    X86Opcode move = vex ? X86Opcode::VMOVDQU : X86Opcode::MOVDQU;
+    auto vector = [](int number, int32_t bytes) {
+        return static_cast<X86Register>(static_cast<int>(bytes == 32 ? X86Register::YMM0 : X86Register::XMM0) + number);
+    };
+
+    switch (inst.opcode) {
+        case ir::IROpcode::MemCpy:
+            // Se alternan XMM14 y XMM15 para que las copias no se encadenen
+            for (size_t i = 0; i < pieces.size(); ++i) {
+                auto [at, bytes] = pieces[i];
+                X86Register scratch = bytes >= 16 ? vector(14 + static_cast<int>(i % 2), bytes)
+                                                  : sizedRegister(X86Register::R11, bytes);
+                X86Opcode opcode = bytes >= 16 ? move : X86Opcode::MOV;
+                emit(opcode, {reg(scratch), createMemoryOperand(right, at)});
+                emit(opcode, {createMemoryOperand(left, at), reg(scratch)});
+            }
+            break;
+
+        case ir::IROpcode::MemSet: {
+            const ir::IRConstant* byte = function.constant(function.operand(instruction, 1));
+            if (!byte) return {};
+            uint64_t pattern = 0x0101010101010101ull * static_cast<uint8_t>(byte->intValue);
+            emit(X86Opcode::MOV, {reg(X86Register::R11), createImmediateOperand(static_cast<int64_t>(pattern))});
+            bool vectors = size >= 16;
+            if (vectors && pattern == 0) {
+                // VEX.128 también pone a cero la mitad alta de YMM15
+                if (vex) emit(X86Opcode::VPXOR, {reg(X86Register::XMM15), reg(X86Register::XMM15), reg(X86Register::XMM15)});
+                else emit(X86Opcode::PXOR, {reg(X86Register::XMM15), reg(X86Register::XMM15)});
+            } else if (vectors) {
+                emit(vex ? X86Opcode::VMOVQ : X86Opcode::MOVQ, {reg(X86Register::XMM15), reg(X86Register::R11)});
+                if (chunk == 32) emit(X86Opcode::VPBROADCASTQ, {reg(X86Register::YMM15), reg(X86Register::XMM15)});
+                else emit(X86Opcode::PUNPCKLQDQ, {reg(X86Register::XMM15), reg(X86Register::XMM15)});
+            }
+            for (auto [at, bytes] : pieces) {
+                if (bytes >= 16) emit(move, {createMemoryOperand(left, at), reg(vector(15, bytes))});
+                else emit(X86Opcode::MOV, {createMemoryOperand(left, at), reg(sizedRegister(X86Register::R11, bytes))});
+            }
+            break;
+        }
+
+        case ir::IROpcode::MemCmp: {
+            // R10 acumula lo que difiere; al final vale 0 o 1
+            emit(X86Opcode::XOR, {reg(X86Register::R10D), reg(X86Register::R10D)});
+            for (auto [at, bytes] : pieces) {
+                if (bytes < 16) {
+                    emit(X86Opcode::MOV, {reg(sizedRegister(X86Register::R11, bytes)), createMemoryOperand(left, at)});
+                    emit(X86Opcode::XOR, {reg(sizedRegister(X86Register::R11, bytes)), createMemoryOperand(right, at)});
+                    emit(X86Opcode::OR, {reg(sizedRegister(X86Register::R10, bytes)),
+                                         reg(sizedRegister(X86Register::R11, bytes))});
+                    continue;
+                }
+                X86Register a = vector(14, bytes), b = vector(15, bytes);
+                emit(move, {reg(a), createMemoryOperand(left, at)});
+                emit(move, {reg(b), createMemoryOperand(right, at)});
+                if (vex) emit(X86Opcode::VPCMPEQB, {reg(a), reg(a), reg(b)});
+                else emit(X86Opcode::PCMPEQB, {reg(a), reg(b)});
+                emit(vex ? X86Opcode::VPMOVMSKB : X86Opcode::PMOVMSKB, {reg(X86Register::R11D), reg(a)});
+                // Un bit por byte igual: se invierten los 16 o 32 bits de la máscara
+                if (bytes == 32) emit(X86Opcode::NOT, {reg(X86Register::R11D)});
+                else emit(X86Opcode::XOR, {reg(X86Register::R11D), createImmediateOperand(0xFFFF)});
+                emit(X86Opcode::OR, {reg(X86Register::R10D), reg(X86Register::R11D)});
+            }
+            emit(X86Opcode::MOV, {reg(X86Register::R11D), createImmediateOperand(1)});
+            emit(X86Opcode::TEST, {reg(X86Register::R10), reg(X86Register::R10)});
+            emit(X86Opcode::CMOVNE, {reg(X86Register::R10), reg(X86Register::R11)});
+            emit(X86Opcode::MOV, {reg(getPhysicalRegister(inst.result, registerMap)), reg(X86Register::R10)});
+            break;
+        }
+
+        default:
+            break;
+    }
+    return instructions;
+}
+
+std::vector<X86Instruction> InstructionSelector::selectCPUFeatures(
+    const ir::IRFunction& function,
+    ir::InstrId instruction,
+    const std::unordered_map<int, RegisterMapping>& registerMap) {
+
+    std::vector<X86Instruction> instructions;
+    auto emit = [&](X86Opcode opcode, std::initializer_list<X86Operand> operands) {
+        X86Instruction i(opcode);
+        i.operands = operands;
+        instructions.push_back(i);
+    };
+    auto reg = [&](X86Register r) { return createRegisterOperand(r); };
+    auto imm = [&](int64_t value) { return createImmediateOperand(value); };
+    std::string done = ".Lcpufeatures" + std::to_string(instruction);
+    auto skip = [&](X86Opcode jump) {
+        X86Instruction i(jump);
+        i.comment = done;
+        instructions.push_back(i);
+    };
+    const X86Register saved[] = {X86Register::RAX, X86Register::RCX, X86Register::RDX, X86Register::RBX};
+    for (X86Register r : saved) emit(X86Opcode::PUSH, {reg(r)});
+
+    // Hoja 0: si existe la 7 se recuerda en el bit 8 de R10 hasta comprobar AVX
+    emit(X86Opcode::XOR, {reg(X86Register::EAX), reg(X86Register::EAX)});
+    emit(X86Opcode::XOR, {reg(X86Register::ECX), reg(X86Register::ECX)});
+    emit(X86Opcode::CPUID, {});
+    emit(X86Opcode::XOR, {reg(X86Register::R10D), reg(X86Register::R10D)});
+    emit(X86Opcode::MOV, {reg(X86Register::R11D), imm(0x100)});
+    emit(X86Opcode::CMP, {reg(X86Register::EAX), imm(7)});
+    emit(X86Opcode::CMOVAE, {reg(X86Register::R10D), reg(X86Register::R11D)});
+
+    // Hoja 1: SSE4.1, y AVX si además el sistema operativo guarda los YMM
+    emit(X86Opcode::MOV, {reg(X86Register::EAX), imm(1)});
+    emit(X86Opcode::CPUID, {});
+    emit(X86Opcode::MOV, {reg(X86Register::R11D), reg(X86Register::ECX)});
+    emit(X86Opcode::SHR, {reg(X86Register::R11D), imm(std::countr_zero(cpuid::Leaf1EcxSSE41))});
+    emit(X86Opcode::AND, {reg(X86Register::R11D), imm(CPUFeatures::SSE41)});
+    emit(X86Opcode::OR, {reg(X86Register::R10D), reg(X86Register::R11D)});
+    constexpr int64_t avxBits = cpuid::Leaf1EcxOSXSAVE | cpuid::Leaf1EcxAVX;
+    emit(X86Opcode::MOV, {reg(X86Register::R11D), reg(X86Register::ECX)});
+    emit(X86Opcode::AND, {reg(X86Register::R11D), imm(avxBits)});
+    emit(X86Opcode::CMP, {reg(X86Register::R11D), imm(avxBits)});
+    skip(X86Opcode::JNE);
+    emit(X86Opcode::XOR, {reg(X86Register::ECX), reg(X86Register::ECX)});
+    emit(X86Opcode::XGETBV, {});
+    emit(X86Opcode::AND, {reg(X86Register::EAX), imm(cpuid::XcrYmmState)});
+    emit(X86Opcode::CMP, {reg(X86Register::EAX), imm(cpuid::XcrYmmState)});
+    skip(X86Opcode::JNE);
+    emit(X86Opcode::OR, {reg(X86Register::R10D), imm(CPUFeatures::AVX)});
+
+    // Hoja 7: AVX2
+    emit(X86Opcode::TEST, {reg(X86Register::R10D), imm(0x100)});
+    skip(X86Opcode::JE);
+    emit(X86Opcode::MOV, {reg(X86Register::EAX), imm(7)});
+    emit(X86Opcode::XOR, {reg(X86Register::ECX), reg(X86Register::ECX)});
+    emit(X86Opcode::CPUID, {});
+    emit(X86Opcode::TEST, {reg(X86Register::EBX), imm(cpuid::Leaf7EbxAVX2)});
+    skip(X86Opcode::JE);
+    emit(X86Opcode::OR, {reg(X86Register::R10D), imm(CPUFeatures::AVX2)});
+
+    X86Instruction label(X86Opcode::NOP);
+    label.comment = done + ":";
+    instructions.push_back(label);
+    emit(X86Opcode::AND, {reg(X86Register::R10D), imm(CPUFeatures::SSE41 | CPUFeatures::AVX | CPUFeatures::AVX2)});
+    for (auto it = std::rbegin(saved); it != std::rend(saved); ++it) emit(X86Opcode::POP, {reg(*it)});
+    X86Register result = getPhysicalRegister(function.instruction(instruction).result, registerMap);
+    emit(X86Opcode::MOV, {reg(sizedRegister(result, 4)), reg(X86Register::R10D)});
+    return instructions;
+}
+
+std::vector<X86Instruction> InstructionSelector::selectBitIntrinsic(
+    const ir::IRFunction& function,
+    ir::InstrId instruction,
+    const std::unordered_map<int, RegisterMapping>& registerMap) {
+
+    std::vector<X86Instruction> instructions;
+    auto emit = [&](X86Opcode opcode, std::initializer_list<X86Operand> operands) {
+        X86Instruction i(opcode);
+        i.operands = operands;
+        instructions.push_back(i);
+    };
+    auto reg = [&](X86Register r) { return createRegisterOperand(r); };
+    auto imm = [&](int64_t value) { return createImmediateOperand(value); };
+    auto label = [&](const std::string& name) {
+        X86Instruction i(X86Opcode::NOP);
+        i.comment = name + ":";
+        instructions.push_back(i);
+    };
+    auto jump = [&](X86Opcode opcode, const std::string& name) {
+        X86Instruction i(opcode);
+        i.comment = name;
+        instructions.push_back(i);
+    };
+
+    const ir::Instruction& inst = function.instruction(instruction);
+    ir::ValueId value = function.operand(instruction, inst.opcode == ir::IROpcode::Crc32 ? 1 : 0);
+    int32_t bytes = static_cast<int32_t>(function.typeOf(value).size);
+    if (bytes != 1 && bytes != 2 && bytes != 4 && bytes != 8) return {};
+    int32_t wide = std::max(bytes, 4);                  // Ancho de trabajo en R10/R11
+    int64_t bits = bytes * 8;
+    int64_t wideBits = wide * 8;
+    X86Register r10 = sizedRegister(X86Register::R10, wide);
+    X86Register r11 = sizedRegister(X86Register::R11, wide);
+
+    // Operando extendido con ceros al ancho de trabajo
+    auto load = [&](X86Register target, ir::ValueId operand, int32_t size) {
+        X86Operand source = convertOperand(function, operand, registerMap);
+        int32_t to = std::max(size, 4);
+        if (source.mode == AddressingMode::Immediate) {
+            uint64_t constant = static_cast<uint64_t>(source.immediate);
+            if (size < 8) constant &= (uint64_t{1} << (size * 8)) - 1;
+            emit(X86Opcode::MOV, {reg(sizedRegister(target, to)), imm(static_cast<int64_t>(constant))});
+        } else if (size >= 4) {
+            emit(X86Opcode::MOV, {reg(sizedRegister(target, to)), reg(sizedRegister(source.reg, size))});
+        } else {
+            emit(X86Opcode::MOVZX, {reg(sizedRegister(target, 4)), reg(sizedRegister(source.reg, size))});
+        }
+    };
+    std::string prefix = ".Lbits" + std::to_string(instruction);
+
+    switch (inst.opcode) {
+        case ir::IROpcode::PopCount:
+            load(X86Register::R10, value, bytes);
+            if (features_.popcnt) {
+                emit(X86Opcode::POPCNT, {reg(r10), reg(r10)});
+                break;
+            }
+            {
+                // Suma por bloques de 2, 4 y 8 bits; el producto junta los bytes en el alto.
+                // Las máscaras de 64 bits no caben en un inmediato: van en RAX
+                X86Register rax = sizedRegister(X86Register::RAX, wide);
+                auto masked = [&](int64_t pattern) {
+                    emit(X86Opcode::MOV, {reg(rax), imm(wide == 8 ? pattern : static_cast<int32_t>(pattern))});
+                };
+                emit(X86Opcode::PUSH, {reg(X86Register::RAX)});
+                emit(X86Opcode::MOV, {reg(r11), reg(r10)});
+                emit(X86Opcode::SHR, {reg(r11), imm(1)});
+                masked(0x5555555555555555ll);
+                emit(X86Opcode::AND, {reg(r11), reg(rax)});
+                emit(X86Opcode::SUB, {reg(r10), reg(r11)});
+                emit(X86Opcode::MOV, {reg(r11), reg(r10)});
+                emit(X86Opcode::SHR, {reg(r11), imm(2)});
+                masked(0x3333333333333333ll);
+                emit(X86Opcode::AND, {reg(r11), reg(rax)});
+                emit(X86Opcode::AND, {reg(r10), reg(rax)});
+                emit(X86Opcode::ADD, {reg(r10), reg(r11)});
+                emit(X86Opcode::MOV, {reg(r11), reg(r10)});
+                emit(X86Opcode::SHR, {reg(r11), imm(4)});
+                emit(X86Opcode::ADD, {reg(r10), reg(r11)});
+                masked(0x0F0F0F0F0F0F0F0Fll);
+                emit(X86Opcode::AND, {reg(r10), reg(rax)});
+                masked(0x0101010101010101ll);
+                emit(X86Opcode::IMUL, {reg(r10), reg(rax)});
+                emit(X86Opcode::SHR, {reg(r10), imm(wideBits - 8)});
+                emit(X86Opcode::POP, {reg(X86Register::RAX)});
+            }
+            break;
+
+        case ir::IROpcode::CountLeadingZeros:
+            load(X86Register::R10, value, bytes);
+            if (features_.lzcnt) {
+                emit(X86Opcode::LZCNT, {reg(r10), reg(r10)});
+            } else {
+                // BSR da el índice del bit alto; con 0 deja ZF y el CMOV no elige: 2w-1 ^ (w-1) = w
+                emit(X86Opcode::BSR, {reg(r11), reg(r10)});
+                emit(X86Opcode::MOV, {reg(r10), imm(2 * wideBits - 1)});
+                emit(X86Opcode::CMOVNE, {reg(r10), reg(r11)});
+                emit(X86Opcode::XOR, {reg(r10), imm(wideBits - 1)});
+            }
+            // Los ceros añadidos al extender no cuentan
+            if (bits < wideBits) emit(X86Opcode::SUB, {reg(r10), imm(wideBits - bits)});
+            break;
+
+        case ir::IROpcode::CountTrailingZeros:
+            load(X86Register::R10, value, bytes);
+            // Un bit por encima del ancho: con 0 la cuenta es el ancho del tipo
+            if (bits < wideBits) emit(X86Opcode::OR, {reg(r10), imm(int64_t{1} << bits)});
+            if (features_.bmi1) {
+                emit(X86Opcode::TZCNT, {reg(r10), reg(r10)});
+            } else {
+                emit(X86Opcode::BSF, {reg(r11), reg(r10)});
+                emit(X86Opcode::MOV, {reg(r10), imm(wideBits)});
+                emit(X86Opcode::CMOVNE, {reg(r10), reg(r11)});
+            }
+            break;
+
+        case ir::IROpcode::ByteSwap:
+            load(X86Register::R10, value, bytes);
+            if (bytes == 2) emit(X86Opcode::ROL, {reg(X86Register::R10W), imm(8)});
+            else if (bytes >= 4) emit(X86Opcode::BSWAP, {reg(r10)});
+            break;
+
+        case ir::IROpcode::RotateLeft:
+        case ir::IROpcode::RotateRight: {
+            load(X86Register::R10, value, bytes);
+            X86Opcode opcode = inst.opcode == ir::IROpcode::RotateLeft ? X86Opcode::ROL : X86Opcode::ROR;
+            X86Register narrow = sizedRegister(X86Register::R10, bytes);
+            X86Operand count = convertOperand(function, function.operand(instruction, 1), registerMap);
+            if (count.mode == AddressingMode::Immediate) {
+                emit(opcode, {reg(narrow), imm(count.immediate & (bits - 1))});
+                break;
+            }
+            emit(X86Opcode::PUSH, {reg(X86Register::RCX)});
+            emit(X86Opcode::MOV, {reg(X86Register::ECX), reg(sizedRegister(count.reg, 4))});
+            emit(opcode, {reg(narrow), reg(X86Register::CL)});
+            emit(X86Opcode::POP, {reg(X86Register::RCX)});
+            break;
+        }
+
+        case ir::IROpcode::BitDeposit:
+        case ir::IROpcode::BitExtract: {
+            load(X86Register::R10, value, bytes);
+            load(X86Register::R11, function.operand(instruction, 1), bytes);
+            bool deposit = inst.opcode == ir::IROpcode::BitDeposit;
+            if (features_.bmi2) {
+                emit(deposit ? X86Opcode::PDEP : X86Opcode::PEXT, {reg(r10), reg(r10), reg(r11)});
+                break;
+            }
+            // Un bit de la máscara por vuelta: RDX es su bit más bajo y RCX el bit compacto
+            const X86Register saved[] = {X86Register::RAX, X86Register::RCX, X86Register::RDX};
+            for (X86Register r : saved) emit(X86Opcode::PUSH, {reg(r)});
+            emit(X86Opcode::XOR, {reg(X86Register::EAX), reg(X86Register::EAX)});
+            emit(X86Opcode::MOV, {reg(X86Register::ECX), imm(1)});
+            label(prefix + ".loop");
+            emit(X86Opcode::TEST, {reg(X86Register::R11), reg(X86Register::R11)});
+            jump(X86Opcode::JE, prefix + ".done");
+            emit(X86Opcode::MOV, {reg(X86Register::RDX), reg(X86Register::R11)});
+            emit(X86Opcode::NEG, {reg(X86Register::RDX)});
+            emit(X86Opcode::AND, {reg(X86Register::RDX), reg(X86Register::R11)});
+            emit(X86Opcode::TEST, {reg(X86Register::R10), reg(deposit ? X86Register::RCX : X86Register::RDX)});
+            jump(X86Opcode::JE, prefix + ".skip");
+            emit(X86Opcode::OR, {reg(X86Register::RAX), reg(deposit ? X86Register::RDX : X86Register::RCX)});
+            label(prefix + ".skip");
+            emit(X86Opcode::XOR, {reg(X86Register::R11), reg(X86Register::RDX)});
+            emit(X86Opcode::ADD, {reg(X86Register::RCX), reg(X86Register::RCX)});
+            jump(X86Opcode::JMP, prefix + ".loop");
+            label(prefix + ".done");
+            emit(X86Opcode::MOV, {reg(X86Register::R10), reg(X86Register::RAX)});
+            for (auto it = std::rbegin(saved); it != std::rend(saved); ++it) emit(X86Opcode::POP, {reg(*it)});
+            break;
+        }
+
+        case ir::IROpcode::Crc32: {
+            // CRC-32C: el acumulado en R10D y el dato en R11
+            load(X86Register::R10, function.operand(instruction, 0), 4);
+            load(X86Register::R11, value, bytes);
+            if (features_.sse42) {
+                X86Register data = bytes <= 2 ? sizedRegister(X86Register::R11, bytes) : r11;
+                emit(X86Opcode::CRC32, {reg(bytes == 8 ? X86Register::R10 : X86Register::R10D), reg(data)});
+                break;
+            }
+            // Un bit por vuelta, del menos significativo, con el polinomio reflejado 0x82F63B78
+            const X86Register saved[] = {X86Register::RAX, X86Register::RCX};
+            for (X86Register r : saved) emit(X86Opcode::PUSH, {reg(r)});
+            emit(X86Opcode::MOV, {reg(X86Register::ECX), imm(bits)});
+            label(prefix + ".loop");
+            emit(X86Opcode::MOV, {reg(X86Register::EAX), reg(X86Register::R10D)});
+            emit(X86Opcode::XOR, {reg(X86Register::EAX), reg(X86Register::R11D)});
+            emit(X86Opcode::SHR, {reg(X86Register::R10D), imm(1)});
+            emit(X86Opcode::SHR, {reg(X86Register::R11), imm(1)});
+            emit(X86Opcode::AND, {reg(X86Register::EAX), imm(1)});
+            emit(X86Opcode::NEG, {reg(X86Register::EAX)});
+            emit(X86Opcode::AND, {reg(X86Register::EAX), imm(static_cast<int32_t>(0x82F63B78u))});
+            emit(X86Opcode::XOR, {reg(X86Register::R10D), reg(X86Register::EAX)});
+            emit(X86Opcode::DEC, {reg(X86Register::ECX)});
+            jump(X86Opcode::JNE, prefix + ".loop");
+            for (auto it = std::rbegin(saved); it != std::rend(saved); ++it) emit(X86Opcode::POP, {reg(*it)});
+            break;
+        }
+
+        default:
+            return {};
     }
 
+    X86Register result = getPhysicalRegister(inst.result, registerMap);
+    int32_t resultBytes = std::max<int32_t>(static_cast<int32_t>(function.typeOf(inst.result).size), 4);
+    emit(X86Opcode::MOV, {reg(sizedRegister(result, resultBytes)), reg(sizedRegister(X86Register::R10, resultBytes))});
     return instructions;
 }
 
 std::vector<X86Instruction> InstructionSelector::selectReturn(
-    const ir::ReturnInstruction& instruction,
+    const ir::IRFunction& function,
+    ir::InstrId instruction,
     const std::unordered_map<int, RegisterMapping>& registerMap) {
 
     std::vector<X86Instruction> instructions;
 
-    if (!instruction.getOperands().empty()) {
+    // Tras una llamada en cola el llamado ya devuelve a nuestro llamador
+    ir::InstrId previous = function.instruction(instruction).prev;
+    if (previous != ir::NoInstr && isLoweredTailCall(function, previous)) {
+        return instructions;
+    }
+
+    if (function.operandCount(instruction) > 0) {
         // Retorno con valor - mover al registro RAX
-        auto valueOp = convertOperand(instruction.getOperands()[0], registerMap);
+        auto valueOp = convertOperand(function, function.operand(instruction, 0), registerMap);
         auto moveInsts = generateMove(createRegisterOperand(X86Register::RAX), valueOp);
         instructions.insert(instructions.end(), moveInsts.begin(), moveInsts.end());
     }
@@ -348,22 +1220,52 @@ std::vector<X86Instruction> InstructionSelector::selectReturn(
 }
 
 std::vector<X86Instruction> InstructionSelector::selectCall(
-    const ir::CallInstruction& instruction,
+    const ir::IRFunction& function,
+    ir::InstrId instruction,
     const std::unordered_map<int, RegisterMapping>& registerMap) {
 
     std::vector<X86Instruction> instructions;
+    const ir::Instruction& inst = function.instruction(instruction);
 
     // Configurar argumentos según ABI (simplificado)
     // En un compilador real, esto seguiría las reglas completas del ABI
 
+    // En cola: el epílogo va delante del salto (CodeGenerator) y el
+    // resultado llega en RAX directamente a nuestro llamador
+    ir::ValueId callee = function.operand(instruction, 0);
+    if (isLoweredTailCall(function, instruction)) {
+        X86Instruction jumpInst(X86Opcode::TAILJMP);
+        if (function.value(callee).kind == ir::ValueKind::Global) {
+            jumpInst.comment = function.globalName(callee);
+        } else {
+            // El epílogo restaura los no volátiles: el destino tiene que sobrevivirle
+            X86Register target = getPhysicalRegister(callee, registerMap);
+            if (static_cast<int>(target) < 16 && abi::ABIContract::isCalleeSavedRegister(X86Encoder::registerNumber(target))) {
+                X86Instruction move(X86Opcode::MOV);
+                move.operands = {createRegisterOperand(X86Register::RAX), createRegisterOperand(target)};
+                instructions.push_back(move);
+                target = X86Register::RAX;
+            }
+            jumpInst.operands.push_back(createRegisterOperand(target));
+        }
+        instructions.push_back(jumpInst);
+        return instructions;
+    }
+
     // Llamar a la función
+    // El operando 0 es la función a llamar; su nombre es el símbolo de la relocación
     X86Instruction callInst(X86Opcode::CALL);
-    // El operando 0 es la función a llamar (simplificado)
+    if (function.value(callee).kind == ir::ValueKind::Global) {
+        callInst.comment = function.globalName(callee);
+    } else {
+        // Llamada indirecta: CALL r/m64
+        callInst.operands.push_back(createRegisterOperand(getPhysicalRegister(callee, registerMap)));
+    }
     instructions.push_back(callInst);
 
     // Si hay resultado, mover de RAX
-    if (instruction.getResult()) {
-        auto resultReg = getPhysicalRegister(instruction.getResult()->getId(), registerMap);
+    if (inst.result != ir::NoValue) {
+        auto resultReg = getPhysicalRegister(inst.result, registerMap);
         X86Instruction movInst(X86Opcode::MOV);
         movInst.operands.push_back(createRegisterOperand(resultReg));
         movInst.operands.push_back(createRegisterOperand(X86Register::RAX));
@@ -373,21 +1275,187 @@ std::vector<X86Instruction> InstructionSelector::selectCall(
     return instructions;
 }
 
+std::vector<X86Instruction> InstructionSelector::selectVectorOperation(
+    const ir::IRFunction& function,
+    ir::InstrId instruction,
+    const std::unordered_map<int, RegisterMapping>& registerMap) {
+
+    std::vector<X86Instruction> instructions;
+    const ir::Instruction& inst = function.instruction(instruction);
+    ir::ValueId typed = inst.opcode == ir::IROpcode::Store ? function.operand(instruction, 0) : inst.result;
+    const ir::TypeInfo& type = function.typeOf(typed);
+    bool vex = type.size == 32 || features_.avx;
+
+    auto vectorOperand = [&](ir::ValueId value) {
+        return createRegisterOperand(getVectorRegister(static_cast<int>(value), type.size, registerMap));
+    };
+    auto memoryOperand = [&](ir::ValueId address) {
+        X86Operand op(AddressingMode::MemoryIndirect);
+        op.reg = getPhysicalRegister(static_cast<int>(address), registerMap);
+        return op;
+    };
+
+    switch (inst.opcode) {
+        case ir::IROpcode::Load: {
+            X86Instruction load(vectorMove(type, vex));
+            load.operands = {vectorOperand(inst.result), memoryOperand(function.operand(instruction, 0))};
+            instructions.push_back(load);
+            return instructions;
+        }
+
+        case ir::IROpcode::Store: {
+            X86Instruction store(vectorMove(type, vex));
+            store.operands = {memoryOperand(function.operand(instruction, 1)),
+                              vectorOperand(function.operand(instruction, 0))};
+            instructions.push_back(store);
+            return instructions;
+        }
+
+        case ir::IROpcode::Broadcast:
+            return selectBroadcast(function, instruction, registerMap);
+
+        default:
+            break;
+    }
+
+    X86Opcode opcode = vectorArithmetic(inst.opcode, type, vex);
+    if (opcode == X86Opcode::NOP || inst.operandCount != 2) return {};
+
+    X86Operand result = vectorOperand(inst.result);
+    X86Operand lhs = vectorOperand(function.operand(instruction, 0));
+    X86Operand rhs = vectorOperand(function.operand(instruction, 1));
+
+    // VEX: tres operandos, no destruye las fuentes
+    if (vex) {
+        X86Instruction op(opcode);
+        op.operands = {result, lhs, rhs};
+        instructions.push_back(op);
+        return instructions;
+    }
+
+    // SSE: dst = dst op src; si el destino es el operando derecho hay que
+    // conmutar o pasar por un temporal (XMM5 es volátil en Win64)
+    if (result.reg == rhs.reg && result.reg != lhs.reg) {
+        if (isCommutative(inst.opcode)) {
+            std::swap(lhs, rhs);
+        } else {
+            X86Instruction save(X86Opcode::MOVAPS);
+            save.operands = {createRegisterOperand(X86Register::XMM5), rhs};
+            instructions.push_back(save);
+            rhs = createRegisterOperand(X86Register::XMM5);
+        }
+    }
+    if (result.reg != lhs.reg) {
+        X86Instruction copy(isFloatVector(type) ? X86Opcode::MOVAPS : X86Opcode::MOVDQA);
+        copy.operands = {result, lhs};
+        instructions.push_back(copy);
+    }
+    X86Instruction op(opcode);
+    op.operands = {result, rhs};
+    instructions.push_back(op);
+    return instructions;
+}
+
+std::vector<X86Instruction> InstructionSelector::selectBroadcast(
+    const ir::IRFunction& function,
+    ir::InstrId instruction,
+    const std::unordered_map<int, RegisterMapping>& registerMap) {
+
+    std::vector<X86Instruction> instructions;
+    const ir::Instruction& inst = function.instruction(instruction);
+    const ir::TypeInfo& type = function.typeOf(inst.result);
+    ir::ValueId scalar = function.operand(instruction, 0);
+    bool floating = isFloatVector(type);
+    bool quad = laneSize(type) == 8;
+
+    X86Register result = getVectorRegister(static_cast<int>(inst.result), type.size, registerMap);
+    X86Register low = getVectorRegister(static_cast<int>(inst.result), 16, registerMap);
+    auto emit = [&](X86Opcode opcode, std::initializer_list<X86Operand> operands) {
+        X86Instruction i(opcode);
+        i.operands = operands;
+        instructions.push_back(i);
+    };
+
+    // Escalar en la lane 0 de low. Las constantes pasan por R11, volátil y
+    // sin uso en el paso de argumentos de Win64
+    X86Opcode moveToVector = features_.avx ? (quad ? X86Opcode::VMOVQ : X86Opcode::VMOVD)
+                                           : (quad ? X86Opcode::MOVQ : X86Opcode::MOVD);
+    X86Register source = low;
+    if (const ir::IRConstant* constant = function.constant(scalar)) {
+        int64_t bits = constant->intValue;
+        if (floating) {
+            bits = quad ? std::bit_cast<int64_t>(constant->floatValue)
+                        : std::bit_cast<int32_t>(static_cast<float>(constant->floatValue));
+        }
+        emit(X86Opcode::MOV, {createRegisterOperand(X86Register::R11), createImmediateOperand(bits)});
+        X86Register gp = quad ? X86Register::R11 : toRegister32(X86Register::R11);
+        emit(moveToVector, {createRegisterOperand(low), createRegisterOperand(gp)});
+    } else if (floating) {
+        source = getVectorRegister(static_cast<int>(scalar), 16, registerMap);
+    } else {
+        X86Register gp = getPhysicalRegister(static_cast<int>(scalar), registerMap);
+        if (!quad) gp = toRegister32(gp);
+        emit(moveToVector, {createRegisterOperand(low), createRegisterOperand(gp)});
+    }
+
+    if (features_.avx2) {
+        X86Opcode opcode = floating ? (quad ? X86Opcode::VBROADCASTSD : X86Opcode::VBROADCASTSS)
+                                    : (quad ? X86Opcode::VPBROADCASTQ : X86Opcode::VPBROADCASTD);
+        // VBROADCASTSD solo existe con destino YMM
+        if (!(opcode == X86Opcode::VBROADCASTSD && type.size != 32)) {
+            emit(opcode, {createRegisterOperand(result), createRegisterOperand(source)});
+            return instructions;
+        }
+    }
+
+    if (source != low) {
+        emit(X86Opcode::MOVAPS, {createRegisterOperand(low), createRegisterOperand(source)});
+    }
+    if (floating) {
+        if (quad) {
+            emit(X86Opcode::UNPCKLPD, {createRegisterOperand(low), createRegisterOperand(low)});
+        } else {
+            emit(X86Opcode::SHUFPS, {createRegisterOperand(low), createRegisterOperand(low), createImmediateOperand(0)});
+        }
+    } else if (quad) {
+        emit(X86Opcode::PUNPCKLQDQ, {createRegisterOperand(low), createRegisterOperand(low)});
+    } else {
+        emit(X86Opcode::PSHUFD, {createRegisterOperand(low), createRegisterOperand(low), createImmediateOperand(0)});
+    }
+    return instructions;
+}
+
+X86Register InstructionSelector::getVectorRegister(
+    int virtualReg,
+    size_t bytes,
+    const std::unordered_map<int, RegisterMapping>& registerMap) {
+
+    int index = static_cast<int>(getPhysicalRegister(virtualReg, registerMap));
+    int xmm0 = static_cast<int>(X86Register::XMM0);
+    int ymm0 = static_cast<int>(X86Register::YMM0);
+
+    // El asignador lineal solo reparte registros generales: se usa el mismo número
+    int number = index % 16;
+    if (index >= xmm0 && index < xmm0 + 16) number = index - xmm0;
+    if (index >= ymm0 && index < ymm0 + 16) number = index - ymm0;
+
+    return static_cast<X86Register>((bytes == 32 ? ymm0 : xmm0) + number);
+}
+
 X86Operand InstructionSelector::convertOperand(
-    const std::shared_ptr<ir::IROperand>& operand,
+    const ir::IRFunction& function,
+    ir::ValueId operand,
     const std::unordered_map<int, RegisterMapping>& registerMap) {
 
-    switch (operand->getKind()) {
-        case ir::IROperand::Kind::Register: {
-            auto regOp = std::static_pointer_cast<ir::Register>(operand);
-            X86Register physReg = getPhysicalRegister(regOp->getId(), registerMap);
+    switch (function.value(operand).kind) {
+        case ir::ValueKind::Instruction:
+        case ir::ValueKind::Parameter: {
+            X86Register physReg = getPhysicalRegister(static_cast<int>(operand), registerMap);
             return createRegisterOperand(physReg);
         }
-        case ir::IROperand::Kind::Immediate: {
-            auto immOp = std::static_pointer_cast<ir::Immediate>(operand);
-            return createImmediateOperand(std::get<int64_t>(immOp->getValue()));
-        }
-        case ir::IROperand::Kind::Label: {
+        case ir::ValueKind::Constant:
+            return createImmediateOperand(function.constant(operand)->intValue);
+        case ir::ValueKind::Block: {
             // Manejo simplificado de etiquetas
             X86Operand op(AddressingMode::Immediate);
             return op;
@@ -440,11 +1508,16 @@ std::string InstructionSelector::registerToString(X86Register reg) const {
         "al", "bl", "cl", "dl", "sil", "dil", "bpl", "spl",
         "r8b", "r9b", "r10b", "r11b", "r12b", "r13b", "r14b", "r15b",
         "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6", "xmm7",
-        "xmm8", "xmm9", "xmm10", "xmm11", "xmm12", "xmm13", "xmm14", "xmm15"
+        "xmm8", "xmm9", "xmm10", "xmm11", "xmm12", "xmm13", "xmm14", "xmm15",
+        "ymm0", "ymm1", "ymm2", "ymm3", "ymm4", "ymm5", "ymm6", "ymm7",
+        "ymm8", "ymm9", "ymm10", "ymm11", "ymm12", "ymm13", "ymm14", "ymm15",
+        "zmm0", "zmm1", "zmm2", "zmm3", "zmm4", "zmm5", "zmm6", "zmm7",
+        "cs", "ds", "ss", "es", "fs", "gs",
+        "rflags"
     };
 
     int index = static_cast<int>(reg);
-    if (index >= 0 && index < 72) {
+    if (index >= 0 && index < static_cast<int>(std::size(registerNames))) {
         return registerNames[index];
     }
 
@@ -456,19 +1529,32 @@ std::string InstructionSelector::opcodeToString(X86Opcode opcode) const {
         "mov", "movzx", "movsx", "lea",
         "add", "sub", "imul", "idiv", "inc", "dec", "neg",
         "and", "or", "xor", "not", "shl", "shr", "sar",
+        "bsf", "bsr", "bswap", "rol", "ror", "popcnt", "lzcnt", "tzcnt", "pdep", "pext", "crc32",
         "cmp", "test", "jmp", "je", "jne", "jl", "jle", "jg", "jge",
         "jb", "jbe", "ja", "jae", "js", "jns", "jc", "jnc",
-        "call", "ret", "leave", "enter",
+        "cmove", "cmovne", "cmovl", "cmovle", "cmovg", "cmovge",
+        "cmovb", "cmovbe", "cmova", "cmovae",
+        "call", "ret", "leave", "enter", "jmp", "jmp",
         "push", "pop",
         "movss", "movsd", "addss", "addsd", "subss", "subsd",
         "mulss", "mulsd", "divss", "divsd", "comiss", "comisd",
+        "minss", "minsd", "maxss", "maxsd",
         "movaps", "movups", "addps", "addpd",
-        "nop", "hlt",
+        "movdqa", "movdqu", "movupd", "movd", "movq",
+        "paddd", "paddq", "psubd", "psubq", "pmulld", "pand", "por", "pxor",
+        "subps", "subpd", "mulps", "mulpd", "divps", "divpd",
+        "pshufd", "shufps", "punpcklqdq", "unpcklpd", "pcmpeqb", "pmovmskb",
+        "vmovdqu", "vmovups", "vmovupd", "vmovd", "vmovq",
+        "vpaddd", "vpaddq", "vpsubd", "vpsubq", "vpmulld", "vpand", "vpor", "vpxor", "vpcmpeqb",
+        "vaddps", "vaddpd", "vsubps", "vsubpd", "vmulps", "vmulpd", "vdivps", "vdivpd",
+        "vpbroadcastd", "vpbroadcastq", "vbroadcastss", "vbroadcastsd", "vpmovmskb", "vzeroupper",
+        "nop", "hlt", "cpuid", "xgetbv",
         "lock", "rep", "repz", "repnz"
     };
+    static_assert(std::size(opcodeNames) == static_cast<size_t>(X86Opcode::REPNZ) + 1);
 
     int index = static_cast<int>(opcode);
-    if (index >= 0 && index < 60) {
+    if (index >= 0 && index < static_cast<int>(std::size(opcodeNames))) {
         return opcodeNames[index];
     }
 
@@ -494,11 +1580,17 @@ void InstructionSelector::optimizeInstructionSequence(std::vector<X86Instruction
     // Implementación simplificada - en un compilador real esto sería mucho más sofisticado
     std::vector<X86Instruction> optimized;
 
-    for (const auto& inst : instructions) {
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        const auto& inst = instructions[i];
         // Evitar NOPs innecesarios
         if (inst.opcode == X86Opcode::NOP && inst.comment.empty()) {
             continue;
         }
+        // Un JMP a la etiqueta siguiente sobra: el bloque cae en ella
+        if (inst.opcode == X86Opcode::JMP && i + 1 < instructions.size() &&
+            instructions[i + 1].opcode == X86Opcode::NOP && instructions[i + 1].comment == inst.comment + ":") {
+            continue;
+        }
         optimized.push_back(inst);
     }
 
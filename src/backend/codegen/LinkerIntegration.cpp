@@ -4,6 +4,7 @@
  */
 
 #include <compiler/backend/codegen/LinkerIntegration.h>
+#include <compiler/common/EnvironmentDetector.h>
 #include <iostream>
 #include <sstream>
 #include <algorithm>
@@ -19,6 +20,21 @@
 
 namespace cpp20::compiler::backend {
 
+namespace {
+
+std::vector<std::string> defaultSystemLibraries() {
+    return {
+        "kernel32.lib",
+        "user32.lib",
+        "advapi32.lib",
+        "msvcrt.lib",
+        "vcruntime.lib",
+        "ucrt.lib"
+    };
+}
+
+} // namespace
+
 // ============================================================================
 // LinkerIntegration - Implementación
 // ============================================================================
@@ -34,6 +50,19 @@ LinkerIntegration::LinkerIntegration(const LinkerConfig& config)
 LinkerIntegration::~LinkerIntegration() = default;
 
 bool LinkerIntegration::detectVisualStudioInstallation() {
+    // Detección guardada en la caché por usuario: revalidarla cuesta unos
+    // stat en lugar de recorrer las instalaciones en cada invocación
+    CompilerConfigManager configManager;
+    DetectedEnvironment environment = configManager.loadOrDetect(config_.machine);
+    if (environment.isValid) {
+        config_.linkerPath = getLinkerPathForArchitecture(config_.machine);
+        config_.defaultLibraries = defaultSystemLibraries();
+        for (const auto& path : environment.libraryPaths) {
+            config_.defaultLibraryPaths.push_back(path.string());
+        }
+        return true;
+    }
+
     auto vsPath = findVisualStudioInstallation();
     if (!vsPath.empty()) {
         setupDefaultPaths(vsPath);
@@ -91,14 +120,7 @@ void LinkerIntegration::setupDefaultPaths(const std::filesystem::path& vsPath) {
     config_.linkerPath = getLinkerPathForArchitecture(config_.machine);
 
     // Configurar librerías por defecto
-    config_.defaultLibraries = {
-        "kernel32.lib",
-        "user32.lib",
-        "advapi32.lib",
-        "msvcrt.lib",
-        "vcruntime.lib",
-        "ucrt.lib"
-    };
+    config_.defaultLibraries = defaultSystemLibraries();
 
     // Configurar rutas de librerías
     std::filesystem::path vcPath = vsPath / "VC/Tools/MSVC";
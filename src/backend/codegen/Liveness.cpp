@@ -0,0 +1,94 @@
+/**
+ * @file Liveness.cpp
+ * @brief Implementación del análisis de vida por bloques
+ */
+
+#include <compiler/backend/codegen/Liveness.h>
+
+namespace cpp20::compiler::backend {
+
+LivenessAnalysis::LivenessAnalysis(const ir::IRFunction& function, const ir::ControlFlowGraph& cfg) {
+    indexOf_.assign(function.valueCount(), NoLiveIndex);
+
+    auto add = [&](ir::ValueId value) {
+        if (function.typeOf(value).type == ir::IRType::Void) return;
+        indexOf_[value] = static_cast<uint32_t>(values_.size());
+        values_.push_back(value);
+    };
+
+    for (size_t i = 0; i < function.getParamTypes().size(); ++i) add(function.parameter(i));
+    for (ir::BlockId block : cfg.reversePostOrder()) {
+        for (ir::InstrId id : function.instructions(block)) {
+            if (function.instruction(id).result != ir::NoValue) add(function.instruction(id).result);
+        }
+    }
+
+    size_t blocks = function.blockCount();
+    LiveSet empty(values_.size());
+    liveIn_.assign(blocks, empty);
+    liveOut_.assign(blocks, empty);
+    phiDefs_.assign(blocks, empty);
+    std::vector<LiveSet> uses(blocks, empty), defs(blocks, empty), phiUses(blocks, empty);
+
+    for (size_t i = 0; i < function.getParamTypes().size(); ++i) {
+        uint32_t param = index(function.parameter(i));
+        if (param == NoLiveIndex) continue;
+        phiDefs_[0].set(param);
+        defs[0].set(param);
+    }
+
+    for (ir::BlockId block : cfg.reversePostOrder()) {
+        for (ir::InstrId id : function.instructions(block)) {
+            const ir::Instruction& inst = function.instruction(id);
+            uint32_t def = index(inst.result);
+            if (inst.opcode == ir::IROpcode::Phi) {
+                if (def != NoLiveIndex) {
+                    phiDefs_[block].set(def);
+                    defs[block].set(def);
+                }
+                for (size_t i = 0; i + 1 < inst.operandCount; i += 2) {
+                    uint32_t used = index(function.operand(id, i));
+                    if (used != NoLiveIndex) phiUses[function.labelBlock(function.operand(id, i + 1))].set(used);
+                }
+                continue;
+            }
+            for (size_t i = 0; i < inst.operandCount; ++i) {
+                uint32_t used = index(function.operand(id, i));
+                if (used != NoLiveIndex && !defs[block].test(used)) uses[block].set(used);
+            }
+            if (def != NoLiveIndex) defs[block].set(def);
+        }
+    }
+
+    // Se empieza en postorden para que casi todos los sucesores estén
+    // resueltos; después solo vuelven los predecesores de un LiveIn cambiado
+    const auto& rpo = cfg.reversePostOrder();
+    std::vector<ir::BlockId> worklist(rpo.begin(), rpo.end());
+    std::vector<bool> queued(blocks, false);
+    for (ir::BlockId block : worklist) queued[block] = true;
+
+    while (!worklist.empty()) {
+        ir::BlockId block = worklist.back();
+        worklist.pop_back();
+        queued[block] = false;
+
+        LiveSet out = phiUses[block];
+        for (ir::BlockId succ : cfg.successors(block)) out.unionWithout(liveIn_[succ], phiDefs_[succ]);
+
+        LiveSet in = phiDefs_[block];
+        in.unionWith(uses[block]);
+        in.unionWithout(out, defs[block]);
+        liveOut_[block] = std::move(out);
+
+        if (in == liveIn_[block]) continue;
+        liveIn_[block] = std::move(in);
+        for (ir::BlockId pred : cfg.predecessors(block)) {
+            if (!queued[pred] && cfg.isReachable(pred)) {
+                queued[pred] = true;
+                worklist.push_back(pred);
+            }
+        }
+    }
+}
+
+} // namespace cpp20::compiler::backend
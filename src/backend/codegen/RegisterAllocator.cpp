@@ -4,7 +4,10 @@
  */
 
 #include <compiler/backend/codegen/RegisterAllocator.h>
+#include <compiler/backend/codegen/Liveness.h>
+#include <compiler/ir/IRAnalysis.h>
 #include <algorithm>
+#include <limits>
 #include <iostream>
 
 namespace cpp20::compiler::backend {
@@ -13,19 +16,24 @@ namespace cpp20::compiler::backend {
 // RegisterAllocator - Implementación
 // ============================================================================
 
-RegisterAllocator::RegisterAllocator(const abi::ABIContract& abiContract)
-    : abiContract_(abiContract) {
+RegisterAllocator::RegisterAllocator(const abi::ABIContract& abiContract, AllocationStrategy strategy)
+    : abiContract_(abiContract), strategy_(strategy) {
     initializeAvailableRegisters();
 }
 
 RegisterAllocator::~RegisterAllocator() = default;
 
 AllocationState RegisterAllocator::allocateRegisters(const ir::IRFunction& function) {
-    // Calcular intervalos de vida
-    auto intervals = computeLiveIntervals(function);
-
-    // Aplicar algoritmo de asignación lineal
-    auto state = linearScanAllocation(intervals);
+    AllocationState state;
+    if (strategy_ == AllocationStrategy::GraphColoring) {
+        state = graphColoringAllocation(function);
+    } else {
+        // Calcular intervalos de vida y aplicar algoritmo de asignación lineal
+        auto intervals = computeLiveIntervals(function);
+        state = linearScanAllocation(intervals);
+    }
+    placeSpillCode(function, state);
+    rematerializeSpills(function, state);
 
     // Actualizar estadísticas
     updateStats(state);
@@ -54,45 +62,53 @@ void RegisterAllocator::initializeAvailableRegisters() {
 
     // Inicializar información de registros
     for (auto reg : availableRegisters_) {
-        registerInfo_[reg] = PhysicalRegisterInfo(reg);
+        registerInfo_.insert_or_assign(reg, PhysicalRegisterInfo(reg));
     }
 }
 
 std::vector<LiveInterval> RegisterAllocator::computeLiveIntervals(const ir::IRFunction& function) {
-    std::vector<LiveInterval> intervals;
-    std::unordered_map<int, int> firstDef, lastUse;
-
-    int instructionIndex = 0;
-
-    // Recorrer todas las instrucciones para calcular intervalos
-    for (const auto& block : function.getBasicBlocks()) {
-        for (const auto& inst : block->getInstructions()) {
-            // Procesar operandos de entrada
-            for (const auto& operand : inst->getOperands()) {
-                if (auto regOp = std::dynamic_pointer_cast<ir::Register>(operand)) {
-                    int regId = regOp->getId();
-                    lastUse[regId] = instructionIndex;
-                    if (firstDef.find(regId) == firstDef.end()) {
-                        firstDef[regId] = instructionIndex;
-                    }
-                }
-            }
+    ir::ControlFlowGraph cfg(function);
+    LivenessAnalysis liveness(function, cfg);
+    std::vector<int> start(liveness.size(), std::numeric_limits<int>::max());
+    std::vector<int> end(liveness.size(), -1);
+
+    auto extend = [&](uint32_t index, int point) {
+        start[index] = std::min(start[index], point);
+        end[index] = std::max(end[index], point);
+    };
 
-            // Procesar resultado
-            if (auto result = inst->getResult()) {
-                int regId = result->getId();
-                firstDef[regId] = instructionIndex;
-                lastUse[regId] = instructionIndex;
+    // Orden lineal en postorden inverso: un valor vivo a través de un
+    // back-edge cubre el bucle entero gracias a LiveIn/LiveOut
+    int point = 0;
+    for (ir::BlockId block : cfg.reversePostOrder()) {
+        int blockStart = point;
+        liveness.liveIn(block).forEach([&](uint32_t index) { extend(index, blockStart); });
+
+        for (ir::InstrId id : function.instructions(block)) {
+            const ir::Instruction& inst = function.instruction(id);
+            if (inst.opcode == ir::IROpcode::Phi) {
+                // Definido al entrar; los operandos viven en LiveOut del predecesor
+                if (liveness.index(inst.result) != NoLiveIndex) extend(liveness.index(inst.result), blockStart);
+                ++point;
+                continue;
             }
-
-            instructionIndex++;
+            for (size_t i = 0; i < inst.operandCount; ++i) {
+                uint32_t used = liveness.index(function.operand(id, i));
+                if (used != NoLiveIndex) extend(used, point);
+            }
+            if (liveness.index(inst.result) != NoLiveIndex) extend(liveness.index(inst.result), point);
+            ++point;
         }
+
+        int blockEnd = std::max(point - 1, blockStart);
+        liveness.liveOut(block).forEach([&](uint32_t index) { extend(index, blockEnd); });
     }
 
-    // Crear intervalos
-    for (const auto& [regId, defPoint] : firstDef) {
-        int usePoint = lastUse[regId];
-        intervals.emplace_back(regId, defPoint, usePoint);
+    std::vector<LiveInterval> intervals;
+    intervals.reserve(liveness.size());
+    for (uint32_t index = 0; index < liveness.size(); ++index) {
+        if (end[index] < 0) continue;
+        intervals.emplace_back(static_cast<int>(liveness.value(index)), start[index], end[index]);
     }
 
     // Ordenar por punto de inicio
@@ -101,25 +117,10 @@ std::vector<LiveInterval> RegisterAllocator::computeLiveIntervals(const ir::IRFu
     return intervals;
 }
 
-X86Register RegisterAllocator::findBestPhysicalRegister(
-    const LiveInterval& interval,
-    const std::vector<LiveInterval>& activeIntervals) {
-
-    // Buscar registro disponible que no tenga conflictos
-    for (auto reg : availableRegisters_) {
-        if (isRegisterAvailable(reg, interval, activeIntervals)) {
-            return reg;
-        }
-    }
-
-    // Si no hay disponible, elegir el que libere primero
-    return getFurthestUseRegister(activeIntervals);
-}
-
-void RegisterAllocator::spillRegister(int virtualReg, AllocationState& state) {
-    // Asignar un slot de spill
-    int spillSlot = state.nextSpillSlot++;
+void RegisterAllocator::spillRegister(int virtualReg, int spillSlot, AllocationState& state) {
+    state.nextSpillSlot = std::max(state.nextSpillSlot, spillSlot + 1);
     state.spilledRegisters.push_back(virtualReg);
+    state.spillSlots[virtualReg] = spillSlot;
 
     // Actualizar estadísticas
     if (static_cast<size_t>(spillSlot + 1) > state.maxSpillSlots) {
@@ -133,49 +134,7 @@ void RegisterAllocator::restoreRegister(int virtualReg, X86Register physicalReg,
     if (it != state.spilledRegisters.end()) {
         state.spilledRegisters.erase(it);
     }
-}
-
-bool RegisterAllocator::isRegisterAvailable(
-    X86Register reg,
-    const LiveInterval& interval,
-    const std::vector<LiveInterval>& activeIntervals) const {
-
-    auto it = registerInfo_.find(reg);
-    if (it == registerInfo_.end()) {
-        return false;
-    }
-
-    // Verificar que no haya conflictos con intervalos activos
-    for (const auto& active : activeIntervals) {
-        if (interval.overlaps(active)) {
-            auto activeIt = state.virtualToPhysical.find(active.virtualReg);
-            if (activeIt != state.virtualToPhysical.end() && activeIt->second == reg) {
-                return false;
-            }
-        }
-    }
-
-    return true;
-}
-
-X86Register RegisterAllocator::getFurthestUseRegister(
-    const std::vector<LiveInterval>& activeIntervals) const {
-
-    X86Register bestReg = X86Register::RAX;
-    int furthestUse = -1;
-
-    for (auto reg : availableRegisters_) {
-        auto it = registerInfo_.find(reg);
-        if (it != registerInfo_.end()) {
-            int lastUse = it->second.lastUse;
-            if (lastUse > furthestUse) {
-                furthestUse = lastUse;
-                bestReg = reg;
-            }
-        }
-    }
-
-    return bestReg;
+    state.spillSlots.erase(virtualReg);
 }
 
 void RegisterAllocator::updateStats(const AllocationState& state) {
@@ -183,54 +142,208 @@ void RegisterAllocator::updateStats(const AllocationState& state) {
     stats_.registersAssigned = state.virtualToPhysical.size();
     stats_.registersSpilled = state.spilledRegisters.size();
     stats_.spillSlotsUsed = state.maxSpillSlots;
+    stats_.spillStores = 0;
+    stats_.reloads = 0;
+    stats_.rematerialized = 0;
+    for (const auto& placement : state.spillCode) {
+        ++(placement.rematerialize ? stats_.rematerialized
+           : placement.isReload    ? stats_.reloads
+                                   : stats_.spillStores);
+    }
+    stats_.splitRanges = state.splitRanges;
+    stats_.coalescedMoves = state.coalescedMoves;
 }
 
 AllocationState RegisterAllocator::linearScanAllocation(const std::vector<LiveInterval>& intervals) {
     AllocationState state;
-    std::vector<LiveInterval> activeIntervals;
 
-    for (const auto& interval : intervals) {
+    // R10/R11 se reservan para recargar valores spilled, como en el coloreado
+    std::vector<X86Register> freeRegisters;
+    for (auto it = availableRegisters_.rbegin(); it != availableRegisters_.rend(); ++it) {
+        if (*it != X86Register::R10 && *it != X86Register::R11) freeRegisters.push_back(*it);
+    }
+
+    // Activos ordenados por punto final: el primero es el siguiente en
+    // expirar y el último el candidato a spill, ambos en O(log n)
+    std::set<std::pair<int, size_t>> active;
+    size_t maxActive = 0;
+
+    // Fin del último intervalo de cada slot: se reutiliza el que ya quedó libre.
+    // Un intervalo expulsado va entero a memoria, desde su inicio
+    std::vector<int> slotEnd;
+    auto spillInterval = [&](const LiveInterval& spilled) {
+        auto free = std::find_if(slotEnd.begin(), slotEnd.end(), [&](int end) { return end < spilled.startPoint; });
+        int slot = static_cast<int>(free - slotEnd.begin());
+        if (free == slotEnd.end()) slotEnd.push_back(spilled.endPoint);
+        else *free = spilled.endPoint;
+        spillRegister(spilled.virtualReg, slot, state);
+        state.virtualToPhysical[spilled.virtualReg] = X86Register::R11;
+    };
+
+    for (size_t index = 0; index < intervals.size(); ++index) {
+        const LiveInterval& interval = intervals[index];
+
         // Expulsar intervalos que han terminado
-        activeIntervals.erase(
-            std::remove_if(activeIntervals.begin(), activeIntervals.end(),
-                [&interval](const LiveInterval& active) {
-                    return active.endPoint < interval.startPoint;
-                }),
-            activeIntervals.end()
-        );
-
-        // Intentar asignar registro
-        X86Register assignedReg = findBestPhysicalRegister(interval, activeIntervals);
-
-        // Verificar si necesitamos spill
-        auto regIt = registerInfo_.find(assignedReg);
-        if (regIt != registerInfo_.end() && regIt->second.assignedVirtualReg != -1) {
-            // Spill del registro actual
-            int spilledReg = regIt->second.assignedVirtualReg;
-            spillRegister(spilledReg, state);
-
-            // Remover de active
-            activeIntervals.erase(
-                std::remove_if(activeIntervals.begin(), activeIntervals.end(),
-                    [spilledReg](const LiveInterval& active) {
-                        return active.virtualReg == spilledReg;
-                    }),
-                activeIntervals.end()
-            );
+        while (!active.empty() && active.begin()->first < interval.startPoint) {
+            const LiveInterval& expired = intervals[active.begin()->second];
+            X86Register reg = state.virtualToPhysical.at(expired.virtualReg);
+            registerInfo_.at(reg).assignedVirtualReg = -1;
+            freeRegisters.push_back(reg);
+            active.erase(active.begin());
+        }
+
+        X86Register assignedReg;
+        if (!freeRegisters.empty()) {
+            assignedReg = freeRegisters.back();
+            freeRegisters.pop_back();
+        } else {
+            // Se hace spill del intervalo que termina más tarde
+            auto furthest = std::prev(active.end());
+            if (furthest->first <= interval.endPoint) {
+                spillInterval(interval);
+                continue;
+            }
+            const LiveInterval& spilled = intervals[furthest->second];
+            assignedReg = state.virtualToPhysical.at(spilled.virtualReg);
+            spillInterval(spilled);
+            active.erase(furthest);
         }
 
         // Asignar el registro
         state.virtualToPhysical[interval.virtualReg] = assignedReg;
-        registerInfo_[assignedReg].assignedVirtualReg = interval.virtualReg;
-        registerInfo_[assignedReg].lastUse = interval.endPoint;
+        registerInfo_.at(assignedReg).assignedVirtualReg = interval.virtualReg;
+        registerInfo_.at(assignedReg).lastUse = interval.endPoint;
 
-        // Añadir a intervalos activos
-        activeIntervals.push_back(interval);
+        active.emplace(interval.endPoint, index);
+        maxActive = std::max(maxActive, active.size());
     }
 
+    stats_.maxLiveRegisters = maxActive;
     return state;
 }
 
+void RegisterAllocator::placeSpillCode(const ir::IRFunction& function, AllocationState& state) {
+    auto slotOf = [&](ir::ValueId value) {
+        auto it = state.spillSlots.find(static_cast<int>(value));
+        return it == state.spillSlots.end() ? -1 : it->second;
+    };
+
+    for (int virtualReg : state.spilledRegisters) {
+        auto value = static_cast<ir::ValueId>(virtualReg);
+        int slot = slotOf(value);
+
+        // Store tras la definición (los parámetros, al entrar)
+        ir::InstrId def = function.definingInstruction(value);
+        if (function.value(value).kind == ir::ValueKind::Parameter) {
+            state.spillCode.push_back({virtualReg, slot, 0, function.block(0).first, false});
+        } else if (def != ir::NoInstr) {
+            const ir::Instruction& inst = function.instruction(def);
+            bool inPlace = inst.opcode == ir::IROpcode::Phi;
+            for (size_t i = 0; inPlace && i < function.operandCount(def); i += 2) {
+                inPlace = slotOf(function.operand(def, i)) == slot;
+            }
+            if (!inPlace) {
+                ir::InstrId position = inst.next;
+                while (position != ir::NoInstr && function.instruction(position).opcode == ir::IROpcode::Phi) {
+                    position = function.instruction(position).next;
+                }
+                state.spillCode.push_back({virtualReg, slot, inst.block, position, false});
+            }
+        }
+
+        // Reload antes de cada uso; el operando de un phi, al final del predecesor
+        std::vector<ir::InstrId> reloaded;
+        function.forEachUse(value, [&](ir::InstrId user, uint32_t index) {
+            const ir::Instruction& inst = function.instruction(user);
+            if (inst.opcode == ir::IROpcode::Phi) {
+                if (slotOf(inst.result) == slot) return;
+                ir::BlockId pred = function.labelBlock(function.operand(user, index + 1));
+                state.spillCode.push_back({virtualReg, slot, pred, function.terminator(pred), true});
+                return;
+            }
+            if (std::find(reloaded.begin(), reloaded.end(), user) != reloaded.end()) return;
+            reloaded.push_back(user);
+            state.spillCode.push_back({virtualReg, slot, inst.block, user, true});
+        });
+    }
+}
+
+bool RegisterAllocator::isRematerializable(const ir::IRFunction& function, ir::ValueId value) {
+    if (function.value(value).kind != ir::ValueKind::Instruction) return false;
+    const ir::Instruction& inst = function.instruction(function.definingInstruction(value));
+    const ir::TypeInfo& type = function.typeOf(value);
+    if (type.isFloatingPoint() || type.isVector() || type.size > 8) return false;
+
+    switch (inst.opcode) {
+        case ir::IROpcode::Alloca:
+            return true;
+        case ir::IROpcode::GetElementPtr:
+        case ir::IROpcode::Add:
+        case ir::IROpcode::Sub:
+        case ir::IROpcode::Trunc:
+        case ir::IROpcode::ZExt:
+        case ir::IROpcode::SExt:
+            break;
+        default:
+            return false;
+    }
+    // Un nivel: la base de un LEA puede ser el marco, pero no otro registro
+    for (size_t i = 0; i < inst.operandCount; ++i) {
+        ir::ValueId operand = function.operand(function.definingInstruction(value), i);
+        ir::ValueKind kind = function.value(operand).kind;
+        if (kind == ir::ValueKind::Constant || kind == ir::ValueKind::Global) continue;
+        if (kind != ir::ValueKind::Instruction ||
+            function.instruction(function.definingInstruction(operand)).opcode != ir::IROpcode::Alloca) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void RegisterAllocator::rematerializeSpills(const ir::IRFunction& function, AllocationState& state) {
+    std::unordered_set<int> cheap;
+    for (const auto& [virtualReg, slot] : state.spillSlots) {
+        auto value = static_cast<ir::ValueId>(virtualReg);
+        if (!isRematerializable(function, value)) continue;
+        bool phiUse = false;
+        function.forEachUse(value, [&](ir::InstrId user, uint32_t) {
+            phiUse = phiUse || function.instruction(user).opcode == ir::IROpcode::Phi;
+        });
+        if (!phiUse) cheap.insert(virtualReg);
+    }
+    if (cheap.empty()) return;
+
+    std::vector<SpillPlacement> code;
+    for (SpillPlacement placement : state.spillCode) {
+        if (cheap.count(placement.virtualReg)) {
+            if (!placement.isReload) continue;
+            placement.spillSlot = -1;
+            placement.rematerialize = true;
+        }
+        code.push_back(placement);
+    }
+    state.spillCode = std::move(code);
+    for (int virtualReg : cheap) {
+        state.spillSlots.erase(virtualReg);
+        state.rematerialized.push_back(virtualReg);
+    }
+    std::sort(state.rematerialized.begin(), state.rematerialized.end());
+
+    // Los slots que quedan se renumeran sin huecos, conservando cuáles se comparten
+    std::unordered_map<int, int> renumbered;
+    std::vector<int> used;
+    for (const auto& [virtualReg, slot] : state.spillSlots) used.push_back(slot);
+    std::sort(used.begin(), used.end());
+    used.erase(std::unique(used.begin(), used.end()), used.end());
+    for (size_t i = 0; i < used.size(); ++i) renumbered[used[i]] = static_cast<int>(i);
+    for (auto& [virtualReg, slot] : state.spillSlots) slot = renumbered.at(slot);
+    for (SpillPlacement& placement : state.spillCode) {
+        if (!placement.rematerialize) placement.spillSlot = renumbered.at(placement.spillSlot);
+    }
+    state.nextSpillSlot = static_cast<int>(used.size());
+    state.maxSpillSlots = used.size();
+}
+
 // ============================================================================
 // RegisterAllocationUtils - Implementación
 // ============================================================================
@@ -268,8 +381,21 @@ std::vector<X86Instruction> RegisterAllocationUtils::generateSpillCode(
 }
 
 size_t RegisterAllocationUtils::calculateSpillStackSize(const AllocationState& state) {
-    // Cada registro spilled necesita 8 bytes en x64
-    return state.spilledRegisters.size() * 8;
+    // Los valores que comparten slot no ocupan más
+    return static_cast<size_t>(state.nextSpillSlot) * 8;
+}
+
+std::vector<StackSlot> RegisterAllocationUtils::spillStackSlots(const ir::IRFunction& function,
+                                                                const AllocationState& state) {
+    std::vector<StackSlot> slots;
+    slots.reserve(state.spillSlots.size());
+    for (const auto& [virtualReg, slot] : state.spillSlots) {
+        // Un slot de 8 bytes guarda cualquier escalar entero o de coma flotante
+        const ir::TypeInfo& type = function.typeOf(static_cast<ir::ValueId>(virtualReg));
+        slots.push_back({std::max<size_t>(type.size, 8), std::max<size_t>(type.alignment, 8),
+                         static_cast<uint32_t>(slot), 0});
+    }
+    return slots;
 }
 
 bool RegisterAllocationUtils::validateAllocation(
@@ -336,12 +462,15 @@ std::unordered_map<int, RegisterMapping> RegisterAllocationUtils::createRegister
         regMap.virtualReg = virt;
         regMap.physicalReg = phys;
 
-        // Verificar si está spilled
+        // Verificar si está spilled (los rangos partidos conservan su registro)
         auto it = std::find(state.spilledRegisters.begin(),
                            state.spilledRegisters.end(), virt);
         if (it != state.spilledRegisters.end()) {
             regMap.isSpilled = true;
-            regMap.spillSlot = std::distance(state.spilledRegisters.begin(), it);
+            auto slot = state.spillSlots.find(virt);
+            regMap.spillSlot = slot != state.spillSlots.end()
+                ? slot->second
+                : static_cast<int>(std::distance(state.spilledRegisters.begin(), it));
         }
 
         mapping[virt] = regMap;
@@ -0,0 +1,982 @@
+/**
+ * @file X86Encoder.cpp
+ * @brief Implementación del codificador x86-64
+ */
+
+#include <compiler/backend/codegen/X86Encoder.h>
+#include <unordered_map>
+
+namespace cpp20::compiler::backend {
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+bool isRegister(const X86Operand& operand) { return operand.mode == AddressingMode::Register; }
+bool isImmediate(const X86Operand& operand) { return operand.mode == AddressingMode::Immediate; }
+bool isMemory(const X86Operand& operand) { return !isRegister(operand) && !isImmediate(operand); }
+
+bool fitsInt8(int64_t value) { return value >= INT8_MIN && value <= INT8_MAX; }
+bool fitsInt32(int64_t value) { return value >= INT32_MIN && value <= INT32_MAX; }
+
+bool inRange(X86Register reg, X86Register first, X86Register last) {
+    return static_cast<int>(reg) >= static_cast<int>(first) && static_cast<int>(reg) <= static_cast<int>(last);
+}
+
+/**
+ * @brief Tamaño en bytes de un registro general (0 si no lo es)
+ */
+unsigned gprSize(X86Register reg) {
+    if (inRange(reg, X86Register::RAX, X86Register::R15)) return 8;
+    if (inRange(reg, X86Register::EAX, X86Register::R15D)) return 4;
+    if (inRange(reg, X86Register::AX, X86Register::R15W)) return 2;
+    if (inRange(reg, X86Register::AL, X86Register::R15B)) return 1;
+    return 0;
+}
+
+bool isVectorRegister(X86Register reg) { return inRange(reg, X86Register::XMM0, X86Register::YMM15); }
+bool isYmm(X86Register reg) { return inRange(reg, X86Register::YMM0, X86Register::YMM15); }
+
+void appendValue(Bytes& out, uint64_t value, unsigned bytes) {
+    for (unsigned i = 0; i < bytes; ++i) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+/**
+ * @brief Prefijos, opcode y operando r/m de una instrucción
+ *
+ * Reúne los bits de REX/VEX mientras se codifica ModRM para poder emitir
+ * los prefijos delante al final.
+ */
+struct Encoding {
+    uint8_t legacyPrefix = 0;   // 0x66, 0xF2 o 0xF3
+    uint8_t mandatoryPrefix = 0;    // F2/F3 obligatorio tras el 0x66 (POPCNT, CRC32...)
+    bool rexW = false;
+    bool forceRex = false;      // SPL/BPL/SIL/DIL
+    uint8_t rex = 0;            // Bits R, X, B
+    Bytes opcode;
+    Bytes modrm;                // ModRM, SIB y desplazamiento
+    Bytes immediate;
+
+    // VEX: map 1 = 0F, 2 = 0F38; pp 0..3 = -, 66, F3, F2
+    bool vex = false;
+    uint8_t vexMap = 1;
+    uint8_t vexPP = 0;
+    bool vexL = false;
+    uint8_t vexV = 0;           // Registro de VEX.vvvv (sin invertir)
+
+    // [RIP + símbolo]: el desplazamiento son los 4 últimos bytes de modrm
+    bool ripRelative = false;
+    const std::string* symbol = nullptr;
+    std::vector<coff::COFFFunctionRelocation>* relocations = nullptr;
+
+    void emit(Bytes& out) const {
+        if (vex) {
+            bool r = rex & 4, x = rex & 2, b = rex & 1;
+            if (vexMap == 1 && !rexW && !x && !b) {
+                out.push_back(0xC5);
+                out.push_back(static_cast<uint8_t>((r ? 0 : 0x80) | (~vexV & 15) << 3 | (vexL ? 4 : 0) | vexPP));
+            } else {
+                out.push_back(0xC4);
+                out.push_back(static_cast<uint8_t>((r ? 0 : 0x80) | (x ? 0 : 0x40) | (b ? 0 : 0x20) | vexMap));
+                out.push_back(static_cast<uint8_t>((rexW ? 0x80 : 0) | (~vexV & 15) << 3 | (vexL ? 4 : 0) | vexPP));
+            }
+        } else {
+            if (legacyPrefix) out.push_back(legacyPrefix);
+            if (mandatoryPrefix) out.push_back(mandatoryPrefix);
+            if (rexW || rex || forceRex) out.push_back(static_cast<uint8_t>(0x40 | (rexW ? 8 : 0) | rex));
+        }
+        out.insert(out.end(), opcode.begin(), opcode.end());
+        out.insert(out.end(), modrm.begin(), modrm.end());
+        if (ripRelative) {
+            // REL32_N: el desplazamiento se mide desde el final de la instrucción,
+            // N bytes de inmediato después
+            relocations->push_back({static_cast<uint32_t>(out.size() - 4), *symbol,
+                                    static_cast<uint16_t>(coff::IMAGE_REL_AMD64_REL32 + immediate.size())});
+        }
+        out.insert(out.end(), immediate.begin(), immediate.end());
+    }
+};
+
+void noteByteRegister(Encoding& encoding, X86Register reg) {
+    if (reg == X86Register::SPL || reg == X86Register::BPL || reg == X86Register::SIL || reg == X86Register::DIL) {
+        encoding.forceRex = true;
+    }
+}
+
+/**
+ * @brief ModRM (y SIB/desplazamiento) para reg y el operando r/m
+ * @return false si el direccionamiento no es codificable
+ */
+bool encodeModRM(Encoding& encoding, uint8_t reg, const X86Operand& rm) {
+    if (reg & 8) encoding.rex |= 4;
+    uint8_t regBits = static_cast<uint8_t>((reg & 7) << 3);
+
+    if (isRegister(rm)) {
+        uint8_t number = X86Encoder::registerNumber(rm.reg);
+        if (number & 8) encoding.rex |= 1;
+        noteByteRegister(encoding, rm.reg);
+        encoding.modrm.push_back(static_cast<uint8_t>(0xC0 | regBits | (number & 7)));
+        return true;
+    }
+
+    int64_t displacement = rm.displacement;
+    switch (rm.mode) {
+        case AddressingMode::RipRelative:
+            if (!encoding.symbol || encoding.symbol->empty()) return false;
+            encoding.modrm.push_back(static_cast<uint8_t>(regBits | 5));
+            appendValue(encoding.modrm, 0, 4);
+            encoding.ripRelative = true;
+            return true;
+
+        case AddressingMode::MemoryDirect:
+            // [disp32] absoluto: SIB sin base ni índice (mod 00, r/m 101 sería RIP)
+            if (!fitsInt32(rm.immediate)) return false;
+            encoding.modrm.push_back(static_cast<uint8_t>(regBits | 4));
+            encoding.modrm.push_back(0x25);
+            appendValue(encoding.modrm, static_cast<uint64_t>(rm.immediate), 4);
+            return true;
+
+        case AddressingMode::MemoryIndirect:
+        case AddressingMode::MemoryBaseDisp:
+        case AddressingMode::MemoryBaseIndex:
+        case AddressingMode::MemoryBaseIndexDisp: {
+            bool indexed = rm.mode == AddressingMode::MemoryBaseIndex ||
+                           rm.mode == AddressingMode::MemoryBaseIndexDisp;
+            X86Register baseReg = indexed ? rm.baseReg : rm.reg;
+            if (gprSize(baseReg) != 8) return false;
+            uint8_t base = X86Encoder::registerNumber(baseReg);
+            if (base & 8) encoding.rex |= 1;
+            if (rm.mode == AddressingMode::MemoryIndirect) displacement = 0;
+
+            // RBP/R13 como base no tienen forma sin desplazamiento
+            uint8_t mod = 0x80;
+            if (displacement == 0 && (base & 7) != 5) mod = 0x00;
+            else if (fitsInt8(displacement)) mod = 0x40;
+
+            if (indexed || (base & 7) == 4) {
+                uint8_t sib;
+                if (indexed) {
+                    if (gprSize(rm.indexReg) != 8 || rm.indexReg == X86Register::RSP) return false;
+                    uint8_t index = X86Encoder::registerNumber(rm.indexReg);
+                    if (index & 8) encoding.rex |= 2;
+                    uint8_t scale;
+                    switch (rm.scale) {
+                        case 1: scale = 0; break;
+                        case 2: scale = 1; break;
+                        case 4: scale = 2; break;
+                        case 8: scale = 3; break;
+                        default: return false;
+                    }
+                    sib = static_cast<uint8_t>(scale << 6 | (index & 7) << 3 | (base & 7));
+                } else {
+                    sib = static_cast<uint8_t>(0x20 | (base & 7));   // Sin índice
+                }
+                encoding.modrm.push_back(static_cast<uint8_t>(mod | regBits | 4));
+                encoding.modrm.push_back(sib);
+            } else {
+                encoding.modrm.push_back(static_cast<uint8_t>(mod | regBits | (base & 7)));
+            }
+            if (mod == 0x40) appendValue(encoding.modrm, static_cast<uint64_t>(displacement), 1);
+            if (mod == 0x80) appendValue(encoding.modrm, static_cast<uint64_t>(displacement), 4);
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Ajusta REX.W/0x66 al tamaño de operando de un registro general
+ */
+void setOperandSize(Encoding& encoding, unsigned size) {
+    if (size == 8) encoding.rexW = true;
+    if (size == 2) encoding.legacyPrefix = 0x66;
+}
+
+/**
+ * @brief Tamaño de operando de una instrucción entera (64 si no hay registros)
+ */
+unsigned operandSize(const X86Instruction& inst) {
+    for (const X86Operand& operand : inst.operands) {
+        if (isRegister(operand) && gprSize(operand.reg)) return gprSize(operand.reg);
+    }
+    return 8;
+}
+
+/**
+ * @brief Extensión /digit del grupo 1 (ADD, OR, AND, SUB, XOR, CMP)
+ */
+int aluExtension(X86Opcode opcode) {
+    switch (opcode) {
+        case X86Opcode::ADD: return 0;
+        case X86Opcode::OR: return 1;
+        case X86Opcode::AND: return 4;
+        case X86Opcode::SUB: return 5;
+        case X86Opcode::XOR: return 6;
+        case X86Opcode::CMP: return 7;
+        default: return -1;
+    }
+}
+
+int conditionCode(X86Opcode opcode) {
+    switch (opcode) {
+        case X86Opcode::JB: case X86Opcode::JC: return 0x2;
+        case X86Opcode::JAE: case X86Opcode::JNC: return 0x3;
+        case X86Opcode::JE: return 0x4;
+        case X86Opcode::JNE: return 0x5;
+        case X86Opcode::JBE: return 0x6;
+        case X86Opcode::JA: return 0x7;
+        case X86Opcode::JS: return 0x8;
+        case X86Opcode::JNS: return 0x9;
+        case X86Opcode::JL: return 0xC;
+        case X86Opcode::JGE: return 0xD;
+        case X86Opcode::JLE: return 0xE;
+        case X86Opcode::JG: return 0xF;
+        default: return -1;
+    }
+}
+
+/**
+ * @brief Forma SSE/AVX: prefijo obligatorio, mapa y opcodes de carga y escritura
+ *
+ * store = 0 si la instrucción no tiene forma con destino en memoria.
+ * Para VEX, ternary indica que el primer fuente va en vvvv.
+ */
+struct VectorForm {
+    uint8_t prefix;     // 0, 0x66, 0xF3, 0xF2
+    uint8_t map;        // 1 = 0F, 2 = 0F38
+    uint8_t load;
+    uint8_t store;
+    bool vex;
+    bool ternary;
+    bool rexW;
+};
+
+const std::unordered_map<X86Opcode, VectorForm>& vectorForms() {
+    static const std::unordered_map<X86Opcode, VectorForm> forms = {
+        {X86Opcode::MOVSS, {0xF3, 1, 0x10, 0x11, false, false, false}},
+        {X86Opcode::MOVSD, {0xF2, 1, 0x10, 0x11, false, false, false}},
+        {X86Opcode::ADDSS, {0xF3, 1, 0x58, 0, false, false, false}},
+        {X86Opcode::ADDSD, {0xF2, 1, 0x58, 0, false, false, false}},
+        {X86Opcode::SUBSS, {0xF3, 1, 0x5C, 0, false, false, false}},
+        {X86Opcode::SUBSD, {0xF2, 1, 0x5C, 0, false, false, false}},
+        {X86Opcode::MULSS, {0xF3, 1, 0x59, 0, false, false, false}},
+        {X86Opcode::MULSD, {0xF2, 1, 0x59, 0, false, false, false}},
+        {X86Opcode::DIVSS, {0xF3, 1, 0x5E, 0, false, false, false}},
+        {X86Opcode::DIVSD, {0xF2, 1, 0x5E, 0, false, false, false}},
+        {X86Opcode::COMISS, {0x00, 1, 0x2F, 0, false, false, false}},
+        {X86Opcode::COMISD, {0x66, 1, 0x2F, 0, false, false, false}},
+        {X86Opcode::MINSS, {0xF3, 1, 0x5D, 0, false, false, false}},
+        {X86Opcode::MINSD, {0xF2, 1, 0x5D, 0, false, false, false}},
+        {X86Opcode::MAXSS, {0xF3, 1, 0x5F, 0, false, false, false}},
+        {X86Opcode::MAXSD, {0xF2, 1, 0x5F, 0, false, false, false}},
+        {X86Opcode::MOVAPS, {0x00, 1, 0x28, 0x29, false, false, false}},
+        {X86Opcode::MOVUPS, {0x00, 1, 0x10, 0x11, false, false, false}},
+        {X86Opcode::MOVUPD, {0x66, 1, 0x10, 0x11, false, false, false}},
+        {X86Opcode::MOVDQA, {0x66, 1, 0x6F, 0x7F, false, false, false}},
+        {X86Opcode::MOVDQU, {0xF3, 1, 0x6F, 0x7F, false, false, false}},
+        {X86Opcode::ADDPS, {0x00, 1, 0x58, 0, false, false, false}},
+        {X86Opcode::ADDPD, {0x66, 1, 0x58, 0, false, false, false}},
+        {X86Opcode::SUBPS, {0x00, 1, 0x5C, 0, false, false, false}},
+        {X86Opcode::SUBPD, {0x66, 1, 0x5C, 0, false, false, false}},
+        {X86Opcode::MULPS, {0x00, 1, 0x59, 0, false, false, false}},
+        {X86Opcode::MULPD, {0x66, 1, 0x59, 0, false, false, false}},
+        {X86Opcode::DIVPS, {0x00, 1, 0x5E, 0, false, false, false}},
+        {X86Opcode::DIVPD, {0x66, 1, 0x5E, 0, false, false, false}},
+        {X86Opcode::PADDD, {0x66, 1, 0xFE, 0, false, false, false}},
+        {X86Opcode::PADDQ, {0x66, 1, 0xD4, 0, false, false, false}},
+        {X86Opcode::PSUBD, {0x66, 1, 0xFA, 0, false, false, false}},
+        {X86Opcode::PSUBQ, {0x66, 1, 0xFB, 0, false, false, false}},
+        {X86Opcode::PMULLD, {0x66, 2, 0x40, 0, false, false, false}},
+        {X86Opcode::PAND, {0x66, 1, 0xDB, 0, false, false, false}},
+        {X86Opcode::POR, {0x66, 1, 0xEB, 0, false, false, false}},
+        {X86Opcode::PXOR, {0x66, 1, 0xEF, 0, false, false, false}},
+        {X86Opcode::PSHUFD, {0x66, 1, 0x70, 0, false, false, false}},
+        {X86Opcode::SHUFPS, {0x00, 1, 0xC6, 0, false, false, false}},
+        {X86Opcode::PUNPCKLQDQ, {0x66, 1, 0x6C, 0, false, false, false}},
+        {X86Opcode::UNPCKLPD, {0x66, 1, 0x14, 0, false, false, false}},
+        {X86Opcode::PCMPEQB, {0x66, 1, 0x74, 0, false, false, false}},
+
+        {X86Opcode::VMOVDQU, {0xF3, 1, 0x6F, 0x7F, true, false, false}},
+        {X86Opcode::VMOVUPS, {0x00, 1, 0x10, 0x11, true, false, false}},
+        {X86Opcode::VMOVUPD, {0x66, 1, 0x10, 0x11, true, false, false}},
+        {X86Opcode::VPADDD, {0x66, 1, 0xFE, 0, true, true, false}},
+        {X86Opcode::VPADDQ, {0x66, 1, 0xD4, 0, true, true, false}},
+        {X86Opcode::VPSUBD, {0x66, 1, 0xFA, 0, true, true, false}},
+        {X86Opcode::VPSUBQ, {0x66, 1, 0xFB, 0, true, true, false}},
+        {X86Opcode::VPMULLD, {0x66, 2, 0x40, 0, true, true, false}},
+        {X86Opcode::VPAND, {0x66, 1, 0xDB, 0, true, true, false}},
+        {X86Opcode::VPOR, {0x66, 1, 0xEB, 0, true, true, false}},
+        {X86Opcode::VPXOR, {0x66, 1, 0xEF, 0, true, true, false}},
+        {X86Opcode::VPCMPEQB, {0x66, 1, 0x74, 0, true, true, false}},
+        {X86Opcode::VADDPS, {0x00, 1, 0x58, 0, true, true, false}},
+        {X86Opcode::VADDPD, {0x66, 1, 0x58, 0, true, true, false}},
+        {X86Opcode::VSUBPS, {0x00, 1, 0x5C, 0, true, true, false}},
+        {X86Opcode::VSUBPD, {0x66, 1, 0x5C, 0, true, true, false}},
+        {X86Opcode::VMULPS, {0x00, 1, 0x59, 0, true, true, false}},
+        {X86Opcode::VMULPD, {0x66, 1, 0x59, 0, true, true, false}},
+        {X86Opcode::VDIVPS, {0x00, 1, 0x5E, 0, true, true, false}},
+        {X86Opcode::VDIVPD, {0x66, 1, 0x5E, 0, true, true, false}},
+        {X86Opcode::VPBROADCASTD, {0x66, 2, 0x58, 0, true, false, false}},
+        {X86Opcode::VPBROADCASTQ, {0x66, 2, 0x59, 0, true, false, false}},
+        {X86Opcode::VBROADCASTSS, {0x66, 2, 0x18, 0, true, false, false}},
+        {X86Opcode::VBROADCASTSD, {0x66, 2, 0x19, 0, true, false, false}},
+    };
+    return forms;
+}
+
+uint8_t vexPP(uint8_t prefix) {
+    switch (prefix) {
+        case 0x66: return 1;
+        case 0xF3: return 2;
+        case 0xF2: return 3;
+        default: return 0;
+    }
+}
+
+bool encodeVector(const X86Instruction& inst, const VectorForm& form, Encoding& encoding) {
+    const auto& ops = inst.operands;
+    if (ops.size() < 2) return false;
+
+    // Forma de escritura: destino en memoria
+    bool store = isMemory(ops[0]);
+    if (store && form.store == 0) return false;
+    const X86Operand& regOperand = store ? ops[1] : ops[0];
+    if (!isRegister(regOperand) || !isVectorRegister(regOperand.reg)) return false;
+
+    const X86Operand* rm = store ? &ops[0] : &ops[1];
+    if (form.vex && form.ternary) {
+        // dst, src1 (vvvv), src2 (r/m); con dos operandos, src1 = dst
+        if (ops.size() >= 3 && !isImmediate(ops[2])) {
+            if (!isRegister(ops[1])) return false;
+            encoding.vexV = X86Encoder::registerNumber(ops[1].reg);
+            rm = &ops[2];
+        } else {
+            encoding.vexV = X86Encoder::registerNumber(ops[0].reg);
+        }
+    }
+
+    encoding.vex = form.vex;
+    encoding.vexMap = form.map;
+    encoding.vexPP = vexPP(form.prefix);
+    encoding.vexL = isYmm(regOperand.reg);
+    encoding.rexW = form.rexW;
+    if (!form.vex) {
+        encoding.legacyPrefix = form.prefix;
+        encoding.opcode.push_back(0x0F);
+        if (form.map == 2) encoding.opcode.push_back(0x38);
+    }
+    encoding.opcode.push_back(store ? form.store : form.load);
+    if (!encodeModRM(encoding, X86Encoder::registerNumber(regOperand.reg), *rm)) return false;
+
+    // PSHUFD/SHUFPS llevan imm8
+    if (isImmediate(ops.back())) appendValue(encoding.immediate, static_cast<uint64_t>(ops.back().immediate), 1);
+    return true;
+}
+
+/**
+ * @brief MOVD/MOVQ (y sus formas VEX) entre registros generales y vectoriales
+ */
+bool encodeTransfer(const X86Instruction& inst, Encoding& encoding) {
+    const auto& ops = inst.operands;
+    if (ops.size() != 2) return false;
+    bool quad = inst.opcode == X86Opcode::MOVQ || inst.opcode == X86Opcode::VMOVQ;
+    encoding.vex = inst.opcode == X86Opcode::VMOVD || inst.opcode == X86Opcode::VMOVQ;
+
+    bool toVector = isRegister(ops[0]) && isVectorRegister(ops[0].reg);
+    const X86Operand& vector = toVector ? ops[0] : ops[1];
+    const X86Operand& other = toVector ? ops[1] : ops[0];
+    if (!isRegister(vector) || !isVectorRegister(vector.reg)) return false;
+
+    // MOVQ xmm, xmm/m64 (F3 0F 7E) y MOVQ m64, xmm (66 0F D6)
+    if (quad && !(isRegister(other) && gprSize(other.reg))) {
+        uint8_t prefix = toVector ? 0xF3 : 0x66;
+        uint8_t opcode = toVector ? 0x7E : 0xD6;
+        encoding.vexPP = vexPP(prefix);
+        if (!encoding.vex) {
+            encoding.legacyPrefix = prefix;
+            encoding.opcode.push_back(0x0F);
+        }
+        encoding.opcode.push_back(opcode);
+        return encodeModRM(encoding, X86Encoder::registerNumber(vector.reg), other);
+    }
+
+    encoding.rexW = quad;
+    encoding.vexPP = 1;
+    if (!encoding.vex) {
+        encoding.legacyPrefix = 0x66;
+        encoding.opcode.push_back(0x0F);
+    }
+    encoding.opcode.push_back(toVector ? 0x6E : 0x7E);
+    return encodeModRM(encoding, X86Encoder::registerNumber(vector.reg), other);
+}
+
+/**
+ * @brief Elemento de la secuencia: bytes fijos, etiqueta o salto relajable
+ */
+struct Item {
+    enum Kind : uint8_t { Fixed, Label, Jump } kind;
+    uint32_t begin = 0;         // Fixed: rango en el buffer de bytes
+    uint32_t end = 0;
+    X86Opcode opcode = X86Opcode::NOP;
+    uint32_t target = 0;        // Jump: índice del Item etiqueta
+    bool near = false;          // Jump: rel32
+    uint32_t relocations = 0;   // Fixed: primera relocación propia
+    uint32_t relocationEnd = 0;
+    uint32_t alignment = 0;     // Label: relleno hasta este múltiplo
+};
+
+/**
+ * @brief Relleno que lleva offset a un múltiplo de alignment
+ */
+uint32_t paddingFor(uint32_t offset, uint32_t alignment) {
+    return alignment > 1 ? (alignment - offset % alignment) % alignment : 0;
+}
+
+/**
+ * @brief NOPs de varios bytes recomendados por Intel, de los más largos primero
+ */
+void appendNops(Bytes& out, uint32_t count) {
+    static const std::vector<uint8_t> nops[] = {
+        {0x90},
+        {0x66, 0x90},
+        {0x0F, 0x1F, 0x00},
+        {0x0F, 0x1F, 0x40, 0x00},
+        {0x0F, 0x1F, 0x44, 0x00, 0x00},
+        {0x66, 0x0F, 0x1F, 0x44, 0x00, 0x00},
+        {0x0F, 0x1F, 0x80, 0x00, 0x00, 0x00, 0x00},
+        {0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00},
+        {0x66, 0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00},
+    };
+    while (count > 0) {
+        const std::vector<uint8_t>& nop = nops[std::min<uint32_t>(count, std::size(nops)) - 1];
+        out.insert(out.end(), nop.begin(), nop.end());
+        count -= static_cast<uint32_t>(nop.size());
+    }
+}
+
+uint32_t jumpSize(const Item& item) {
+    if (!item.near) return 2;
+    return item.opcode == X86Opcode::JMP ? 5 : 6;
+}
+
+} // namespace
+
+// ============================================================================
+// X86Encoder - Implementación
+// ============================================================================
+
+uint8_t X86Encoder::registerNumber(X86Register reg) {
+    // Orden de X86Register en cada banco: RAX, RBX, RCX, RDX, RSI, RDI, RBP, RSP, R8..R15
+    static constexpr uint8_t kHardware[16] = {0, 3, 1, 2, 6, 7, 5, 4, 8, 9, 10, 11, 12, 13, 14, 15};
+    auto index = static_cast<int>(reg);
+    if (index < static_cast<int>(X86Register::XMM0)) return kHardware[index % 16];
+    if (isVectorRegister(reg)) return static_cast<uint8_t>((index - static_cast<int>(X86Register::XMM0)) % 16);
+    return 0;
+}
+
+bool X86Encoder::encodeInstruction(const X86Instruction& inst, Bytes& out,
+                                   std::vector<coff::COFFFunctionRelocation>& relocations) {
+    const auto& ops = inst.operands;
+    Encoding encoding;
+    encoding.symbol = &inst.comment;
+    encoding.relocations = &relocations;
+
+    auto fail = [&]() {
+        lastError_ = "instrucción sin codificación x86-64 (opcode " +
+                     std::to_string(static_cast<int>(inst.opcode)) + ")";
+        return false;
+    };
+    auto single = [&](uint8_t byte) {
+        out.push_back(byte);
+        return true;
+    };
+
+    auto vectorForm = vectorForms().find(inst.opcode);
+    if (vectorForm != vectorForms().end()) {
+        if (!encodeVector(inst, vectorForm->second, encoding)) return fail();
+        encoding.emit(out);
+        return true;
+    }
+
+    switch (inst.opcode) {
+        case X86Opcode::NOP: return single(0x90);
+        case X86Opcode::RET: return single(0xC3);
+        case X86Opcode::LEAVE: return single(0xC9);
+        case X86Opcode::HLT: return single(0xF4);
+        case X86Opcode::CPUID:
+            out.insert(out.end(), {0x0F, 0xA2});
+            return true;
+        case X86Opcode::XGETBV:
+            out.insert(out.end(), {0x0F, 0x01, 0xD0});
+            return true;
+        case X86Opcode::VZEROUPPER:
+            out.insert(out.end(), {0xC5, 0xF8, 0x77});
+            return true;
+
+        case X86Opcode::PUSH:
+        case X86Opcode::POP: {
+            if (ops.size() != 1 || !isRegister(ops[0]) || gprSize(ops[0].reg) != 8) return fail();
+            uint8_t number = registerNumber(ops[0].reg);
+            if (number & 8) out.push_back(0x41);
+            out.push_back(static_cast<uint8_t>((inst.opcode == X86Opcode::PUSH ? 0x50 : 0x58) + (number & 7)));
+            return true;
+        }
+
+        case X86Opcode::CALL: {
+            if (!ops.empty()) {
+                // CALL r/m64 (FF /2)
+                encoding.opcode.push_back(0xFF);
+                if (!encodeModRM(encoding, 2, ops[0])) return fail();
+                encoding.emit(out);
+                return true;
+            }
+            if (inst.comment.empty()) return fail();
+            out.push_back(0xE8);
+            relocations.push_back({static_cast<uint32_t>(out.size()), inst.comment, coff::IMAGE_REL_AMD64_REL32});
+            appendValue(out, 0, 4);
+            return true;
+        }
+
+        case X86Opcode::TAILJMP: {
+            if (!ops.empty()) {
+                // REX.W JMP r/m64 (FF /4): la forma indirecta que el unwinder acepta en un epílogo
+                encoding.rexW = true;
+                encoding.opcode.push_back(0xFF);
+                if (!encodeModRM(encoding, 4, ops[0])) return fail();
+                encoding.emit(out);
+                return true;
+            }
+            if (inst.comment.empty()) return fail();
+            out.push_back(0xE9);
+            relocations.push_back({static_cast<uint32_t>(out.size()), inst.comment, coff::IMAGE_REL_AMD64_REL32});
+            appendValue(out, 0, 4);
+            return true;
+        }
+
+        case X86Opcode::JMPTABLE: {
+            // LEA base, [RIP + __ImageBase]; MOV index32, [base + index*4 + tabla];
+            // ADD index, base; JMP index. Las entradas son RVAs de 32 bits.
+            if (ops.size() != 2 || !isRegister(ops[0]) || !isRegister(ops[1]) || inst.comment.empty() ||
+                gprSize(ops[0].reg) != 8 || gprSize(ops[1].reg) != 8 || ops[0].reg == X86Register::RSP) {
+                return fail();
+            }
+            uint8_t index = registerNumber(ops[0].reg);
+            uint8_t base = registerNumber(ops[1].reg);
+
+            out.push_back(static_cast<uint8_t>(0x48 | (base & 8 ? 4 : 0)));
+            out.push_back(0x8D);
+            out.push_back(static_cast<uint8_t>(0x05 | (base & 7) << 3));
+            relocations.push_back({static_cast<uint32_t>(out.size()), coff::ImageBaseSymbol, coff::IMAGE_REL_AMD64_REL32});
+            appendValue(out, 0, 4);
+
+            uint8_t rex = (index & 8 ? 4 : 0) | (index & 8 ? 2 : 0) | (base & 8 ? 1 : 0);
+            if (rex) out.push_back(static_cast<uint8_t>(0x40 | rex));
+            out.push_back(0x8B);
+            out.push_back(static_cast<uint8_t>(0x84 | (index & 7) << 3));
+            out.push_back(static_cast<uint8_t>(0x80 | (index & 7) << 3 | (base & 7)));
+            relocations.push_back({static_cast<uint32_t>(out.size()), inst.comment, coff::IMAGE_REL_AMD64_ADDR32NB});
+            appendValue(out, 0, 4);
+
+            // ADD index, base (01 /r) y JMP index (FF /4)
+            out.push_back(static_cast<uint8_t>(0x48 | (base & 8 ? 4 : 0) | (index & 8 ? 1 : 0)));
+            out.push_back(0x01);
+            out.push_back(static_cast<uint8_t>(0xC0 | (base & 7) << 3 | (index & 7)));
+            if (index & 8) out.push_back(0x41);
+            out.push_back(0xFF);
+            out.push_back(static_cast<uint8_t>(0xE0 | (index & 7)));
+            return true;
+        }
+
+        case X86Opcode::MOVD: case X86Opcode::MOVQ: case X86Opcode::VMOVD: case X86Opcode::VMOVQ:
+            if (!encodeTransfer(inst, encoding)) return fail();
+            encoding.emit(out);
+            return true;
+
+        case X86Opcode::PMOVMSKB: case X86Opcode::VPMOVMSKB:
+            // PMOVMSKB r32, xmm/ymm (66 0F D7): el bit alto de cada byte
+            if (ops.size() != 2 || !isRegister(ops[0]) || !isRegister(ops[1]) || !isVectorRegister(ops[1].reg)) {
+                return fail();
+            }
+            encoding.vex = inst.opcode == X86Opcode::VPMOVMSKB;
+            encoding.vexPP = vexPP(0x66);
+            encoding.vexL = isYmm(ops[1].reg);
+            if (!encoding.vex) {
+                encoding.legacyPrefix = 0x66;
+                encoding.opcode.push_back(0x0F);
+            }
+            encoding.opcode.push_back(0xD7);
+            if (!encodeModRM(encoding, registerNumber(ops[0].reg), ops[1])) return fail();
+            encoding.emit(out);
+            return true;
+
+        default:
+            break;
+    }
+
+    if (ops.empty()) return fail();
+    unsigned size = operandSize(inst);
+    bool byteOp = size == 1;
+
+    // Grupo 1: ADD/OR/AND/SUB/XOR/CMP
+    int extension = aluExtension(inst.opcode);
+    if (extension >= 0) {
+        if (ops.size() != 2) return fail();
+        setOperandSize(encoding, size);
+        auto base = static_cast<uint8_t>(extension * 8);
+        if (isImmediate(ops[1])) {
+            int64_t value = ops[1].immediate;
+            if (byteOp) {
+                encoding.opcode.push_back(0x80);
+                appendValue(encoding.immediate, static_cast<uint64_t>(value), 1);
+            } else if (fitsInt8(value)) {
+                encoding.opcode.push_back(0x83);
+                appendValue(encoding.immediate, static_cast<uint64_t>(value), 1);
+            } else {
+                if (!fitsInt32(value)) return fail();
+                encoding.opcode.push_back(0x81);
+                appendValue(encoding.immediate, static_cast<uint64_t>(value), size == 2 ? 2 : 4);
+            }
+            if (!encodeModRM(encoding, static_cast<uint8_t>(extension), ops[0])) return fail();
+        } else if (isRegister(ops[1])) {
+            noteByteRegister(encoding, ops[1].reg);
+            encoding.opcode.push_back(static_cast<uint8_t>(base + (byteOp ? 0 : 1)));
+            if (!encodeModRM(encoding, registerNumber(ops[1].reg), ops[0])) return fail();
+        } else {
+            if (!isRegister(ops[0])) return fail();
+            noteByteRegister(encoding, ops[0].reg);
+            encoding.opcode.push_back(static_cast<uint8_t>(base + (byteOp ? 2 : 3)));
+            if (!encodeModRM(encoding, registerNumber(ops[0].reg), ops[1])) return fail();
+        }
+        encoding.emit(out);
+        return true;
+    }
+
+    switch (inst.opcode) {
+        case X86Opcode::MOV: {
+            if (ops.size() != 2) return fail();
+            setOperandSize(encoding, size);
+            if (isImmediate(ops[1])) {
+                int64_t value = ops[1].immediate;
+                if (isRegister(ops[0]) && !byteOp && size != 2 && !(size == 8 && fitsInt32(value))) {
+                    // B8+r: imm32 (que se extiende con ceros) o imm64
+                    uint8_t number = registerNumber(ops[0].reg);
+                    bool wide = size == 8 && (value < 0 || value > UINT32_MAX);
+                    encoding.rexW = wide;
+                    if (number & 8) encoding.rex |= 1;
+                    encoding.opcode.push_back(static_cast<uint8_t>(0xB8 + (number & 7)));
+                    appendValue(encoding.immediate, static_cast<uint64_t>(value), wide ? 8 : 4);
+                } else {
+                    if (!byteOp && !fitsInt32(value)) return fail();
+                    encoding.opcode.push_back(byteOp ? 0xC6 : 0xC7);
+                    if (!encodeModRM(encoding, 0, ops[0])) return fail();
+                    appendValue(encoding.immediate, static_cast<uint64_t>(value), byteOp ? 1 : size == 2 ? 2 : 4);
+                }
+            } else if (isRegister(ops[1])) {
+                noteByteRegister(encoding, ops[1].reg);
+                encoding.opcode.push_back(byteOp ? 0x88 : 0x89);
+                if (!encodeModRM(encoding, registerNumber(ops[1].reg), ops[0])) return fail();
+            } else {
+                if (!isRegister(ops[0])) return fail();
+                noteByteRegister(encoding, ops[0].reg);
+                encoding.opcode.push_back(byteOp ? 0x8A : 0x8B);
+                if (!encodeModRM(encoding, registerNumber(ops[0].reg), ops[1])) return fail();
+            }
+            break;
+        }
+
+        case X86Opcode::LEA:
+            if (ops.size() != 2 || !isRegister(ops[0]) || !isMemory(ops[1])) return fail();
+            setOperandSize(encoding, size);
+            encoding.opcode.push_back(0x8D);
+            if (!encodeModRM(encoding, registerNumber(ops[0].reg), ops[1])) return fail();
+            break;
+
+        case X86Opcode::MOVZX:
+        case X86Opcode::MOVSX: {
+            if (ops.size() != 2 || !isRegister(ops[0])) return fail();
+            setOperandSize(encoding, gprSize(ops[0].reg));
+            unsigned from = isRegister(ops[1]) ? gprSize(ops[1].reg) : 1;
+            if (isRegister(ops[1])) noteByteRegister(encoding, ops[1].reg);
+            if (from == 4 && inst.opcode == X86Opcode::MOVSX) {
+                encoding.opcode.push_back(0x63);   // MOVSXD
+            } else if (from == 1 || from == 2) {
+                encoding.opcode.push_back(0x0F);
+                uint8_t opcode = inst.opcode == X86Opcode::MOVZX ? 0xB6 : 0xBE;
+                encoding.opcode.push_back(static_cast<uint8_t>(opcode + (from == 2 ? 1 : 0)));
+            } else {
+                return fail();
+            }
+            if (!encodeModRM(encoding, registerNumber(ops[0].reg), ops[1])) return fail();
+            break;
+        }
+
+        case X86Opcode::TEST:
+            if (ops.size() != 2) return fail();
+            setOperandSize(encoding, size);
+            if (isImmediate(ops[1])) {
+                if (!fitsInt32(ops[1].immediate)) return fail();
+                encoding.opcode.push_back(byteOp ? 0xF6 : 0xF7);
+                if (!encodeModRM(encoding, 0, ops[0])) return fail();
+                appendValue(encoding.immediate, static_cast<uint64_t>(ops[1].immediate), byteOp ? 1 : size == 2 ? 2 : 4);
+            } else {
+                if (!isRegister(ops[1])) return fail();
+                encoding.opcode.push_back(byteOp ? 0x84 : 0x85);
+                if (!encodeModRM(encoding, registerNumber(ops[1].reg), ops[0])) return fail();
+            }
+            break;
+
+        case X86Opcode::CMOVE: case X86Opcode::CMOVNE: case X86Opcode::CMOVL: case X86Opcode::CMOVLE:
+        case X86Opcode::CMOVG: case X86Opcode::CMOVGE: case X86Opcode::CMOVB: case X86Opcode::CMOVBE:
+        case X86Opcode::CMOVA: case X86Opcode::CMOVAE: {
+            // 0F 40+cc /r, con los códigos del Jcc del mismo orden
+            if (ops.size() != 2 || !isRegister(ops[0]) || isImmediate(ops[1]) || byteOp) return fail();
+            setOperandSize(encoding, size);
+            auto jump = static_cast<X86Opcode>(static_cast<int>(X86Opcode::JE) +
+                                               (static_cast<int>(inst.opcode) - static_cast<int>(X86Opcode::CMOVE)));
+            encoding.opcode.insert(encoding.opcode.end(), {0x0F, static_cast<uint8_t>(0x40 + conditionCode(jump))});
+            if (!encodeModRM(encoding, registerNumber(ops[0].reg), ops[1])) return fail();
+            break;
+        }
+
+        case X86Opcode::IMUL: {
+            if (ops.size() < 2 || !isRegister(ops[0]) || byteOp) return fail();
+            setOperandSize(encoding, size);
+            // IMUL r, imm equivale a IMUL r, r, imm
+            const X86Operand& source = isImmediate(ops[1]) ? ops[0] : ops[1];
+            const X86Operand* immediate = isImmediate(ops.back()) ? &ops.back() : nullptr;
+            if (immediate) {
+                if (!fitsInt32(immediate->immediate)) return fail();
+                bool shortForm = fitsInt8(immediate->immediate);
+                encoding.opcode.push_back(shortForm ? 0x6B : 0x69);
+                appendValue(encoding.immediate, static_cast<uint64_t>(immediate->immediate),
+                            shortForm ? 1 : size == 2 ? 2 : 4);
+            } else {
+                encoding.opcode.insert(encoding.opcode.end(), {0x0F, 0xAF});
+            }
+            if (!encodeModRM(encoding, registerNumber(ops[0].reg), source)) return fail();
+            break;
+        }
+
+        case X86Opcode::IDIV:
+        case X86Opcode::NEG:
+        case X86Opcode::NOT:
+        case X86Opcode::INC:
+        case X86Opcode::DEC: {
+            setOperandSize(encoding, size);
+            bool group5 = inst.opcode == X86Opcode::INC || inst.opcode == X86Opcode::DEC;
+            uint8_t digit = inst.opcode == X86Opcode::IDIV ? 7 : inst.opcode == X86Opcode::NEG ? 3 :
+                            inst.opcode == X86Opcode::NOT ? 2 : inst.opcode == X86Opcode::INC ? 0 : 1;
+            encoding.opcode.push_back(group5 ? (byteOp ? 0xFE : 0xFF) : (byteOp ? 0xF6 : 0xF7));
+            if (!encodeModRM(encoding, digit, ops[0])) return fail();
+            break;
+        }
+
+        case X86Opcode::BSF:
+        case X86Opcode::BSR:
+        case X86Opcode::POPCNT:
+        case X86Opcode::LZCNT:
+        case X86Opcode::TZCNT: {
+            // [F3] 0F B8/BC/BD /r: sin F3, BC y BD son BSF y BSR
+            if (ops.size() != 2 || !isRegister(ops[0]) || isImmediate(ops[1]) || byteOp) return fail();
+            setOperandSize(encoding, size);
+            if (inst.opcode != X86Opcode::BSF && inst.opcode != X86Opcode::BSR) encoding.mandatoryPrefix = 0xF3;
+            uint8_t opcode = inst.opcode == X86Opcode::POPCNT ? 0xB8
+                           : inst.opcode == X86Opcode::BSF || inst.opcode == X86Opcode::TZCNT ? 0xBC : 0xBD;
+            encoding.opcode.insert(encoding.opcode.end(), {0x0F, opcode});
+            if (!encodeModRM(encoding, registerNumber(ops[0].reg), ops[1])) return fail();
+            break;
+        }
+
+        case X86Opcode::BSWAP: {
+            // 0F C8+r, solo de 32 y 64 bits
+            if (ops.size() != 1 || !isRegister(ops[0]) || size < 4) return fail();
+            setOperandSize(encoding, size);
+            uint8_t number = registerNumber(ops[0].reg);
+            if (number & 8) encoding.rex |= 1;
+            encoding.opcode.insert(encoding.opcode.end(), {0x0F, static_cast<uint8_t>(0xC8 + (number & 7))});
+            break;
+        }
+
+        case X86Opcode::CRC32: {
+            // F2 [REX.W] 0F 38 F0 /r con fuente de 8 bits, F1 con 16 (0x66), 32 o 64
+            if (ops.size() != 2 || !isRegister(ops[0]) || size < 4 || isImmediate(ops[1])) return fail();
+            unsigned from = isRegister(ops[1]) ? gprSize(ops[1].reg) : size;
+            if ((size == 8) != (from == 8)) return fail();
+            encoding.mandatoryPrefix = 0xF2;
+            encoding.rexW = size == 8;
+            if (from == 2) encoding.legacyPrefix = 0x66;
+            if (isRegister(ops[1])) noteByteRegister(encoding, ops[1].reg);
+            encoding.opcode.insert(encoding.opcode.end(), {0x0F, 0x38, static_cast<uint8_t>(from == 1 ? 0xF0 : 0xF1)});
+            if (!encodeModRM(encoding, registerNumber(ops[0].reg), ops[1])) return fail();
+            break;
+        }
+
+        case X86Opcode::PDEP:
+        case X86Opcode::PEXT: {
+            // VEX.LZ.F2/F3.0F38.W0/W1 F5 /r: destino, fuente (vvvv), máscara (r/m)
+            if (ops.size() != 3 || !isRegister(ops[0]) || !isRegister(ops[1]) || isImmediate(ops[2]) || size < 4) {
+                return fail();
+            }
+            encoding.vex = true;
+            encoding.vexMap = 2;
+            encoding.vexPP = vexPP(inst.opcode == X86Opcode::PDEP ? 0xF2 : 0xF3);
+            encoding.vexV = registerNumber(ops[1].reg);
+            encoding.rexW = size == 8;
+            encoding.opcode.push_back(0xF5);
+            if (!encodeModRM(encoding, registerNumber(ops[0].reg), ops[2])) return fail();
+            break;
+        }
+
+        case X86Opcode::SHL:
+        case X86Opcode::SHR:
+        case X86Opcode::SAR:
+        case X86Opcode::ROL:
+        case X86Opcode::ROR: {
+            if (ops.size() != 2) return fail();
+            setOperandSize(encoding, size);
+            uint8_t digit = inst.opcode == X86Opcode::SHL ? 4 : inst.opcode == X86Opcode::SHR ? 5 :
+                            inst.opcode == X86Opcode::SAR ? 7 : inst.opcode == X86Opcode::ROL ? 0 : 1;
+            if (isImmediate(ops[1])) {
+                uint8_t count = static_cast<uint8_t>(ops[1].immediate & 63);
+                if (count == 1) {
+                    encoding.opcode.push_back(byteOp ? 0xD0 : 0xD1);
+                } else {
+                    encoding.opcode.push_back(byteOp ? 0xC0 : 0xC1);
+                    encoding.immediate.push_back(count);
+                }
+            } else {
+                // Cuenta en CL
+                if (!isRegister(ops[1]) || registerNumber(ops[1].reg) != 1) return fail();
+                encoding.opcode.push_back(byteOp ? 0xD2 : 0xD3);
+            }
+            if (!encodeModRM(encoding, digit, ops[0])) return fail();
+            break;
+        }
+
+        default:
+            return fail();
+    }
+
+    encoding.emit(out);
+    return true;
+}
+
+bool X86Encoder::encode(const std::vector<X86Instruction>& instructions, std::vector<uint8_t>& code,
+                        std::vector<coff::COFFFunctionRelocation>& relocations) {
+    lastError_.clear();
+
+    // Los bytes que no dependen de la colocación se codifican una vez
+    Bytes fixed;
+    std::vector<coff::COFFFunctionRelocation> fixedRelocations;
+    std::vector<Item> items;
+    std::unordered_map<std::string, uint32_t> labels;
+    std::vector<std::pair<uint32_t, const std::string*>> pendingJumps;
+
+    for (const X86Instruction& inst : instructions) {
+        Item item{Item::Fixed};
+        if (inst.opcode == X86Opcode::NOP && !inst.comment.empty()) {
+            std::string name = inst.comment;
+            if (name.back() == ':') name.pop_back();
+            item.kind = Item::Label;
+            if (inst.operands.size() == 1 && inst.operands[0].mode == AddressingMode::Immediate) {
+                item.alignment = static_cast<uint32_t>(inst.operands[0].immediate);
+            }
+            if (!labels.emplace(name, static_cast<uint32_t>(items.size())).second) {
+                lastError_ = "etiqueta duplicada: " + name;
+                return false;
+            }
+        } else if (inst.opcode == X86Opcode::JMP || conditionCode(inst.opcode) >= 0) {
+            if (inst.comment.empty()) {
+                lastError_ = "salto sin bloque destino";
+                return false;
+            }
+            item.kind = Item::Jump;
+            item.opcode = inst.opcode;
+            pendingJumps.emplace_back(static_cast<uint32_t>(items.size()), &inst.comment);
+        } else {
+            item.begin = static_cast<uint32_t>(fixed.size());
+            item.relocations = static_cast<uint32_t>(fixedRelocations.size());
+            // Las relocaciones quedan relativas al inicio de la instrucción
+            Bytes bytes;
+            if (!encodeInstruction(inst, bytes, fixedRelocations)) return false;
+            fixed.insert(fixed.end(), bytes.begin(), bytes.end());
+            item.end = static_cast<uint32_t>(fixed.size());
+            item.relocationEnd = static_cast<uint32_t>(fixedRelocations.size());
+        }
+        items.push_back(item);
+    }
+
+    for (const auto& [index, name] : pendingJumps) {
+        auto label = labels.find(*name);
+        if (label == labels.end()) {
+            lastError_ = "salto a un bloque sin etiqueta: " + *name;
+            return false;
+        }
+        items[index].target = label->second;
+    }
+
+    // Relajación: los saltos solo crecen, así que el bucle termina. El
+    // relleno de las etiquetas alineadas se cuenta desde el inicio del código.
+    auto base = static_cast<uint32_t>(code.size());
+    std::vector<uint32_t> offsets(items.size() + 1, 0);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 0; i < items.size(); ++i) {
+            const Item& item = items[i];
+            uint32_t size = item.kind == Item::Fixed ? item.end - item.begin :
+                            item.kind == Item::Jump ? jumpSize(item) :
+                            paddingFor(base + offsets[i], item.alignment);
+            offsets[i + 1] = offsets[i] + size;
+        }
+        for (size_t i = 0; i < items.size(); ++i) {
+            Item& item = items[i];
+            if (item.kind != Item::Jump || item.near) continue;
+            int64_t displacement = static_cast<int64_t>(offsets[item.target + 1]) - offsets[i + 1];
+            if (!fitsInt8(displacement)) {
+                item.near = true;
+                changed = true;
+            }
+        }
+    }
+
+    // La etiqueta marca el final de su relleno
+    code.reserve(code.size() + offsets.back());
+    for (const auto& [name, index] : labels) {
+        labelOffsets_[name] = base + offsets[index + 1];
+    }
+    for (size_t i = 0; i < items.size(); ++i) {
+        const Item& item = items[i];
+        if (item.kind == Item::Fixed) {
+            auto start = static_cast<uint32_t>(code.size());
+            code.insert(code.end(), fixed.begin() + item.begin, fixed.begin() + item.end);
+            for (uint32_t r = item.relocations; r < item.relocationEnd; ++r) {
+                coff::COFFFunctionRelocation relocation = fixedRelocations[r];
+                relocation.offset += start;
+                relocations.push_back(std::move(relocation));
+            }
+        } else if (item.kind == Item::Label) {
+            appendNops(code, offsets[i + 1] - offsets[i]);
+        } else if (item.kind == Item::Jump) {
+            int64_t displacement = static_cast<int64_t>(offsets[item.target + 1]) - offsets[i + 1];
+            int cc = conditionCode(item.opcode);
+            if (!item.near) {
+                code.push_back(item.opcode == X86Opcode::JMP ? 0xEB : static_cast<uint8_t>(0x70 + cc));
+                appendValue(code, static_cast<uint64_t>(displacement), 1);
+            } else {
+                if (item.opcode == X86Opcode::JMP) {
+                    code.push_back(0xE9);
+                } else {
+                    code.push_back(0x0F);
+                    code.push_back(static_cast<uint8_t>(0x80 + cc));
+                }
+                appendValue(code, static_cast<uint64_t>(displacement), 4);
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace cpp20::compiler::backend
@@ -1,18 +1,106 @@
 /**
  * @file COFFDumper.cpp
- * @brief Lector y dumper de archivos COFF para validación
+ * @brief Lector y dumper de archivos COFF y bibliotecas para validación
  */
 
 #include <compiler/backend/coff/COFFDumper.h>
 #include <compiler/backend/coff/COFFTypes.h>
-#include <compiler/common/utils/FileUtils.h>
+#include <compiler/backend/link/MiniLinker.h>
+#include <compiler/backend/mangling/MSVCDemangler.h>
+#include <compiler/common/utils/MappedFile.h>
+#include <compiler/common/utils/ThreadPool.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <future>
 #include <iostream>
 #include <iomanip>
+#include <span>
 #include <sstream>
 #include <fstream>
+#include <vector>
 
 namespace cpp20::compiler::backend::coff {
 
+namespace {
+
+// Secciones y registros de símbolo por trozo de trabajo
+constexpr size_t kSectionsPerChunk = 256;
+constexpr uint32_t kSymbolsPerChunk = 4096;
+// Trozos ya formateados que pueden esperar al que se está escribiendo, por hilo
+constexpr size_t kChunksAheadPerThread = 4;
+constexpr uint16_t kMachineI386 = 0x014C;
+
+/**
+ * @brief Formatea count trozos y los escribe en orden según terminan
+ *
+ * Sin pool cada trozo se escribe directamente en output. Con pool cada uno
+ * se formatea en su propio buffer y se escribe en cuanto él y los
+ * anteriores han terminado; solo unos pocos van por delante del que se
+ * escribe, así que la memoria no crece con el tamaño del archivo.
+ */
+template<typename Format>
+bool streamInOrder(common::utils::ThreadPool* pool, size_t count, const Format& format, std::ostream& output) {
+    bool success = true;
+    if (!pool) {
+        for (size_t i = 0; i < count; ++i) {
+            success = format(i, output) && success;
+        }
+        return success;
+    }
+
+    std::deque<std::future<std::pair<bool, std::string>>> pending;
+    size_t next = 0;
+    auto submitNext = [&]() {
+        size_t index = next++;
+        pending.push_back(pool->submit([&format, index]() {
+            std::ostringstream chunk;
+            bool chunkSuccess = format(index, chunk);
+            return std::make_pair(chunkSuccess, std::move(chunk).str());
+        }));
+    };
+
+    size_t window = pool->threadCount() * kChunksAheadPerThread;
+    while (next < count && pending.size() < window) {
+        submitNext();
+    }
+    while (!pending.empty()) {
+        auto future = std::move(pending.front());
+        pending.pop_front();
+        std::pair<bool, std::string> chunk;
+        try {
+            chunk = future.get();
+        } catch (...) {
+            // Los trozos en curso usan format: esperarlos antes de salir
+            for (auto& running : pending) running.wait();
+            throw;
+        }
+        if (next < count) {
+            submitNext();
+        }
+        output.write(chunk.second.data(), static_cast<std::streamsize>(chunk.second.size()));
+        success = chunk.first && success;
+    }
+    return success;
+}
+
+// Miembro de biblioteca que es un objeto (AMD64 o i386), no un binario LTO u otro formato
+bool isObjectMember(std::span<const uint8_t> contents) {
+    if (contents.size() < sizeof(IMAGE_FILE_HEADER)) {
+        return false;
+    }
+    uint16_t machine = static_cast<uint16_t>(contents[0] | (contents[1] << 8));
+    return machine == IMAGE_FILE_MACHINE_AMD64 || machine == kMachineI386;
+}
+
+std::string_view sectionName(const IMAGE_SECTION_HEADER& header) {
+    return std::string_view(header.Name, strnlen(header.Name, 8));
+}
+
+} // namespace
+
 // ========================================================================
 // COFFDumper implementation
 // ========================================================================
@@ -20,80 +108,303 @@ namespace cpp20::compiler::backend::coff {
 COFFDumper::COFFDumper() = default;
 
 bool COFFDumper::dumpFile(const std::string& filename, std::ostream& output) {
-    try {
-        std::string content = cpp20::compiler::common::utils::readFile(filename);
-        if (content.empty()) {
-            output << "Error: Empty or invalid file" << std::endl;
-            return false;
-        }
-
-        const uint8_t* data = reinterpret_cast<const uint8_t*>(content.data());
-        size_t size = content.size();
-
-        return dumpObject(data, size, output);
-
-    } catch (const std::exception& e) {
-        output << "Error reading file: " << e.what() << std::endl;
+    // Proyectado: solo se cargan las páginas de lo que se llega a decodificar
+    auto file = common::utils::MappedFile::open(filename);
+    if (!file) {
+        output << "Error: Empty or invalid file\n";
         return false;
     }
+
+    const auto* data = reinterpret_cast<const uint8_t*>(file->data());
+    bool success = link::ArchiveReader::isArchive({data, file->size()})
+                       ? dumpArchive(data, file->size(), output)
+                       : dumpObject(data, file->size(), output);
+    output.flush();
+    return success;
 }
 
 bool COFFDumper::dumpObject(const uint8_t* data, size_t size, std::ostream& output) {
+    size_t chunks = 0;
+    if (size >= sizeof(IMAGE_FILE_HEADER)) {
+        const auto* header = reinterpret_cast<const IMAGE_FILE_HEADER*>(data);
+        chunks = header->NumberOfSections / kSectionsPerChunk + header->NumberOfSymbols / kSymbolsPerChunk;
+    }
+    auto pool = makePool(chunks);
+    return dumpObject(data, size, output, pool.get());
+}
+
+bool COFFDumper::dumpObject(const uint8_t* data, size_t size, std::ostream& output,
+                            common::utils::ThreadPool* pool) {
     if (size < sizeof(IMAGE_FILE_HEADER)) {
-        output << "Error: File too small for COFF header" << std::endl;
+        output << "Error: File too small for COFF header\n";
         return false;
     }
 
-    // Read file header
+    // Con filtros solo lo que se pidió: secciones, símbolos o ambos
     const IMAGE_FILE_HEADER* header = reinterpret_cast<const IMAGE_FILE_HEADER*>(data);
-    dumpFileHeader(*header, output);
-
-    // Validate header
-    if (!validateFileHeader(*header)) {
-        output << "Warning: Invalid COFF file header" << std::endl;
+    bool showSections = symbolFilter_.empty() || !sectionFilters_.empty();
+    bool showSymbols = sectionFilters_.empty() || !symbolFilter_.empty();
+    if (!hasFilters()) {
+        dumpFileHeader(*header, output);
+        if (!validateFileHeader(*header)) {
+            output << "Warning: Invalid COFF file header\n";
+        }
     }
 
-    size_t offset = sizeof(IMAGE_FILE_HEADER);
+    // Cabeceras de sección que caben en el archivo, en grupos de kSectionsPerChunk
+    const auto* sections = reinterpret_cast<const IMAGE_SECTION_HEADER*>(data + sizeof(IMAGE_FILE_HEADER));
+    size_t sectionCount = std::min<size_t>(header->NumberOfSections,
+                                           (size - sizeof(IMAGE_FILE_HEADER)) / sizeof(IMAGE_SECTION_HEADER));
+    size_t groups = (sectionCount + kSectionsPerChunk - 1) / kSectionsPerChunk;
+    auto forEachSelected = [&](size_t group, auto&& dump) {
+        size_t end = std::min(sectionCount, (group + 1) * kSectionsPerChunk);
+        for (size_t i = group * kSectionsPerChunk; i < end; ++i) {
+            if (sectionSelected(sections[i])) dump(sections[i]);
+        }
+        return true;
+    };
+
+    if (showSections) {
+        streamInOrder(pool, groups, [&](size_t group, std::ostream& out) {
+            return forEachSelected(group, [&](const IMAGE_SECTION_HEADER& section) {
+                dumpSectionHeader(section, out);
+            });
+        }, output);
+    }
+    if (sectionCount < header->NumberOfSections) {
+        output << "Error: Truncated section header\n";
+        return false;
+    }
+    if (showSections) {
+        streamInOrder(pool, groups, [&](size_t group, std::ostream& out) {
+            return forEachSelected(group, [&](const IMAGE_SECTION_HEADER& section) {
+                dumpSectionData(section, data, size, out);
+            });
+        }, output);
+    }
 
-    // Read section headers
-    for (uint16_t i = 0; i < header->NumberOfSections; ++i) {
-        if (offset + sizeof(IMAGE_SECTION_HEADER) > size) {
-            output << "Error: Truncated section header" << std::endl;
+    // Read symbol table if present
+    if (showSymbols && header->PointerToSymbolTable > 0 && header->NumberOfSymbols > 0) {
+        const uint8_t* symbols;
+        std::string_view stringTable;
+        if (!locateSymbolTable(data, size, symbols, stringTable)) {
+            output << "Error: Symbol table extends beyond file\n";
             return false;
         }
 
-        const IMAGE_SECTION_HEADER* sectionHeader =
-            reinterpret_cast<const IMAGE_SECTION_HEADER*>(data + offset);
+        // Tramos que empiezan en un registro principal, para no separar los auxiliares
+        uint32_t count = header->NumberOfSymbols;
+        std::vector<uint32_t> starts{0};
+        if (pool) {
+            for (uint32_t i = 0; i < count;
+                 i += 1 + symbols[i * sizeof(IMAGE_SYMBOL) + offsetof(IMAGE_SYMBOL, NumberOfAuxSymbols)]) {
+                if (i - starts.back() >= kSymbolsPerChunk) {
+                    starts.push_back(i);
+                }
+            }
+        }
 
-        dumpSectionHeader(*sectionHeader, output);
-        offset += sizeof(IMAGE_SECTION_HEADER);
+        // Con filtros, sin título: un miembro sin coincidencias no escribe nada
+        if (!hasFilters()) {
+            output << "\nSymbol Table:\n";
+        }
+        streamInOrder(pool, starts.size(), [&](size_t range, std::ostream& out) {
+            uint32_t end = range + 1 < starts.size() ? starts[range + 1] : count;
+            dumpSymbolRange(symbols, starts[range], end, count, stringTable, out);
+            return true;
+        }, output);
     }
 
-    // Read sections data
-    for (uint16_t i = 0; i < header->NumberOfSections; ++i) {
-        const IMAGE_SECTION_HEADER* sectionHeader =
-            reinterpret_cast<const IMAGE_SECTION_HEADER*>(
-                data + sizeof(IMAGE_FILE_HEADER) + i * sizeof(IMAGE_SECTION_HEADER));
+    return true;
+}
 
-        dumpSectionData(*sectionHeader, data, size, output);
+bool COFFDumper::dumpArchive(const uint8_t* data, size_t size, std::ostream& output) {
+    std::vector<link::ArchiveMember> members;
+    if (!link::ArchiveReader::readMembers({data, size}, members)) {
+        output << "Error: Invalid or truncated archive\n";
+        return false;
     }
 
-    // Read symbol table if present
-    if (header->PointerToSymbolTable > 0 && header->NumberOfSymbols > 0) {
-        if (header->PointerToSymbolTable + header->NumberOfSymbols * sizeof(IMAGE_SYMBOL) > size) {
-            output << "Error: Symbol table extends beyond file" << std::endl;
+    if (!hasFilters()) {
+        output << "Archive: " << members.size() << " members\n";
+    }
+
+    // Un miembro por trozo; dentro de cada uno no se reparte más
+    auto pool = makePool(members.size());
+    return streamInOrder(pool.get(), members.size(), [&](size_t i, std::ostream& out) {
+        return dumpMember(members[i], out);
+    }, output);
+}
+
+bool COFFDumper::dumpMember(const link::ArchiveMember& member, std::ostream& output) {
+    auto memberHeader = [&]() {
+        output << "\nMember: " << member.name << " (offset 0x" << std::hex << member.offset << std::dec << ")\n";
+    };
+
+    // Con filtros la cabecera del miembro solo aparece si algo coincide
+    std::ostringstream filtered;
+    std::ostream& out = hasFilters() ? static_cast<std::ostream&>(filtered) : output;
+    if (!hasFilters()) {
+        memberHeader();
+    }
+
+    bool success = true;
+    std::string_view symbol;
+    std::string_view dllName;
+    uint16_t hint = 0;
+    if (link::ArchiveReader::readImportObject(member.contents, symbol, dllName, hint)) {
+        if (!hasFilters() || (!symbolFilter_.empty() && symbolSelected(symbol))) {
+            out << "  Import:        " << symbol << " from " << dllName << " (hint " << hint << ")\n";
+        }
+    } else if (isObjectMember(member.contents)) {
+        success = dumpObject(member.contents.data(), member.contents.size(), out, nullptr);
+    } else if (!hasFilters()) {
+        out << "  Not a COFF object (" << member.contents.size() << " bytes)\n";
+    }
+
+    if (hasFilters() && filtered.tellp() > 0) {
+        memberHeader();
+        output << std::move(filtered).str();
+    }
+    return success;
+}
+
+bool COFFDumper::dumpSortedSymbols(const std::string& filename, std::ostream& output) {
+    auto file = common::utils::MappedFile::open(filename);
+    if (!file) {
+        output << "Error: Empty or invalid file\n";
+        return false;
+    }
+
+    bool success = dumpSortedSymbols(reinterpret_cast<const uint8_t*>(file->data()), file->size(), output);
+    output.flush();
+    return success;
+}
+
+bool COFFDumper::dumpSortedSymbols(const uint8_t* data, size_t size, std::ostream& output) {
+    if (size < sizeof(IMAGE_FILE_HEADER)) {
+        output << "Error: File too small for COFF header\n";
+        return false;
+    }
+
+    const uint8_t* symbols;
+    std::string_view stringTable;
+    if (!locateSymbolTable(data, size, symbols, stringTable)) {
+        output << "Error: Symbol table extends beyond file\n";
+        return false;
+    }
+
+    // Solo los registros principales (los auxiliares no tienen nombre) que pasan el filtro
+    const auto* header = reinterpret_cast<const IMAGE_FILE_HEADER*>(data);
+    std::vector<std::string> names;
+    std::vector<IMAGE_SYMBOL> records;
+    for (uint32_t i = 0; i < header->NumberOfSymbols; ++i) {
+        IMAGE_SYMBOL symbol;
+        std::memcpy(&symbol, symbols + i * sizeof(IMAGE_SYMBOL), sizeof(symbol));
+        std::string_view name = symbolName(symbol, stringTable);
+        if (symbolSelected(name)) {
+            names.emplace_back(name);
+            records.push_back(symbol);
+        }
+        i += symbol.NumberOfAuxSymbols;
+    }
+
+    auto index = mangling::SymbolIndex::build(std::move(names), jobs_);
+
+    output << "Symbols (" << index.size() << ", sorted by name):\n";
+    for (size_t i = 0; i < index.size(); ++i) {
+        auto symbol = index[i];
+        const IMAGE_SYMBOL& record = records[symbol.ordinal];
+        output << "  " << std::setw(4) << record.SectionNumber << "  0x" << std::hex << std::setw(8)
+               << std::setfill('0') << record.Value << std::dec << std::setfill(' ') << "  "
+               << symbol.demangled;
+        if (symbol.demangled != symbol.mangled) {
+            output << "  (" << symbol.mangled << ")";
+        }
+        output << '\n';
+    }
+    return true;
+}
+
+bool COFFDumper::matchesPattern(std::string_view name, std::string_view pattern) {
+    // Al fallar se vuelve al último '*' y se le hace absorber un carácter más
+    size_t n = 0;
+    size_t p = 0;
+    size_t star = std::string_view::npos;
+    size_t resume = 0;
+    while (n < name.size()) {
+        if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            resume = n;
+        } else if (p < pattern.size() && pattern[p] == name[n]) {
+            ++p;
+            ++n;
+        } else if (star != std::string_view::npos) {
+            p = star + 1;
+            n = ++resume;
+        } else {
             return false;
         }
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+bool COFFDumper::sectionSelected(const IMAGE_SECTION_HEADER& header) const {
+    return sectionFilters_.empty() ||
+           std::find(sectionFilters_.begin(), sectionFilters_.end(), sectionName(header)) != sectionFilters_.end();
+}
 
-        dumpSymbolTable(data + header->PointerToSymbolTable,
-                       header->NumberOfSymbols, output);
+bool COFFDumper::symbolSelected(std::string_view name) const {
+    return symbolFilter_.empty() || matchesPattern(name, symbolFilter_);
+}
+
+std::unique_ptr<common::utils::ThreadPool> COFFDumper::makePool(size_t count) const {
+    if (jobs_ == 1 || count < 2) {
+        return nullptr;
+    }
+    return std::make_unique<common::utils::ThreadPool>(jobs_);
+}
+
+bool COFFDumper::locateSymbolTable(const uint8_t* data, size_t size,
+                                   const uint8_t*& symbols, std::string_view& stringTable) {
+    const auto* header = reinterpret_cast<const IMAGE_FILE_HEADER*>(data);
+    size_t tableEnd = static_cast<size_t>(header->PointerToSymbolTable) +
+                      static_cast<size_t>(header->NumberOfSymbols) * sizeof(IMAGE_SYMBOL);
+    if (tableEnd > size) {
+        return false;
     }
 
+    symbols = data + header->PointerToSymbolTable;
+
+    // La tabla de strings empieza con su tamaño (incluidos esos 4 bytes)
+    stringTable = {};
+    if (tableEnd + sizeof(uint32_t) <= size) {
+        uint32_t stringTableSize;
+        std::memcpy(&stringTableSize, data + tableEnd, sizeof(stringTableSize));
+        size_t available = std::min<size_t>(stringTableSize, size - tableEnd);
+        stringTable = std::string_view(reinterpret_cast<const char*>(data + tableEnd), available);
+    }
     return true;
 }
 
+std::string_view COFFDumper::symbolName(const IMAGE_SYMBOL& symbol, std::string_view stringTable) {
+    if (symbol.N.Name.Zeroes != 0) {
+        return std::string_view(symbol.N.ShortName, strnlen(symbol.N.ShortName, 8));
+    }
+
+    uint32_t offset = symbol.N.Name.Offset;
+    if (offset < sizeof(uint32_t) || offset >= stringTable.size()) {
+        return {};
+    }
+    std::string_view name = stringTable.substr(offset);
+    return name.substr(0, name.find('\0'));
+}
+
 void COFFDumper::dumpFileHeader(const IMAGE_FILE_HEADER& header, std::ostream& output) {
-    output << "COFF File Header:" << std::endl;
+    output << "COFF File Header:\n";
     output << "  Machine:              0x" << std::hex << header.Machine << std::dec;
 
     switch (header.Machine) {
@@ -104,14 +415,14 @@ void COFFDumper::dumpFileHeader(const IMAGE_FILE_HEADER& header, std::ostream& o
             output << " (Unknown)";
             break;
     }
-    output << std::endl;
+    output << '\n';
 
-    output << "  Number of Sections:   " << header.NumberOfSections << std::endl;
-    output << "  TimeDateStamp:        " << header.TimeDateStamp << std::endl;
-    output << "  PointerToSymbolTable: 0x" << std::hex << header.PointerToSymbolTable << std::dec << std::endl;
-    output << "  NumberOfSymbols:      " << header.NumberOfSymbols << std::endl;
-    output << "  SizeOfOptionalHeader: " << header.SizeOfOptionalHeader << std::endl;
-    output << "  Characteristics:      0x" << std::hex << header.Characteristics << std::dec << std::endl;
+    output << "  Number of Sections:   " << header.NumberOfSections << '\n';
+    output << "  TimeDateStamp:        " << header.TimeDateStamp << '\n';
+    output << "  PointerToSymbolTable: 0x" << std::hex << header.PointerToSymbolTable << std::dec << '\n';
+    output << "  NumberOfSymbols:      " << header.NumberOfSymbols << '\n';
+    output << "  SizeOfOptionalHeader: " << header.SizeOfOptionalHeader << '\n';
+    output << "  Characteristics:      0x" << std::hex << header.Characteristics << std::dec << '\n';
 
     // Decode characteristics
     dumpCharacteristics(header.Characteristics, output);
@@ -124,19 +435,19 @@ void COFFDumper::dumpCharacteristics(uint16_t characteristics, std::ostream& out
     if (characteristics & IMAGE_FILE_LINE_NUMS_STRIPPED) output << "LINE_NUMS_STRIPPED ";
     if (characteristics & IMAGE_FILE_LOCAL_SYMS_STRIPPED) output << "LOCAL_SYMS_STRIPPED ";
     if (characteristics & IMAGE_FILE_LARGE_ADDRESS_AWARE) output << "LARGE_ADDRESS_AWARE ";
-    output << std::endl;
+    output << '\n';
 }
 
 void COFFDumper::dumpSectionHeader(const IMAGE_SECTION_HEADER& header, std::ostream& output) {
-    output << std::endl << "Section Header:" << std::endl;
-    output << "  Name:                 " << std::string(header.Name, strnlen(header.Name, 8)) << std::endl;
-    output << "  Virtual Size:         0x" << std::hex << header.Misc.VirtualSize << std::dec << std::endl;
-    output << "  Virtual Address:      0x" << std::hex << header.VirtualAddress << std::dec << std::endl;
-    output << "  Size of Raw Data:     " << header.SizeOfRawData << std::endl;
-    output << "  Pointer to Raw Data:  0x" << std::hex << header.PointerToRawData << std::dec << std::endl;
-    output << "  Pointer to Relocs:    0x" << std::hex << header.PointerToRelocations << std::dec << std::endl;
-    output << "  Number of Relocs:     " << header.NumberOfRelocations << std::endl;
-    output << "  Characteristics:      0x" << std::hex << header.Characteristics << std::dec << std::endl;
+    output << "\nSection Header:\n";
+    output << "  Name:                 " << std::string(header.Name, strnlen(header.Name, 8)) << '\n';
+    output << "  Virtual Size:         0x" << std::hex << header.Misc.VirtualSize << std::dec << '\n';
+    output << "  Virtual Address:      0x" << std::hex << header.VirtualAddress << std::dec << '\n';
+    output << "  Size of Raw Data:     " << header.SizeOfRawData << '\n';
+    output << "  Pointer to Raw Data:  0x" << std::hex << header.PointerToRawData << std::dec << '\n';
+    output << "  Pointer to Relocs:    0x" << std::hex << header.PointerToRelocations << std::dec << '\n';
+    output << "  Number of Relocs:     " << header.NumberOfRelocations << '\n';
+    output << "  Characteristics:      0x" << std::hex << header.Characteristics << std::dec << '\n';
 
     // Decode section characteristics
     dumpSectionCharacteristics(header.Characteristics, output);
@@ -150,7 +461,7 @@ void COFFDumper::dumpSectionCharacteristics(uint32_t characteristics, std::ostre
     if (characteristics & IMAGE_SCN_MEM_READ) output << "READ ";
     if (characteristics & IMAGE_SCN_MEM_WRITE) output << "WRITE ";
     if (characteristics & IMAGE_SCN_MEM_EXECUTE) output << "EXECUTE ";
-    output << std::endl;
+    output << '\n';
 }
 
 void COFFDumper::dumpSectionData(const IMAGE_SECTION_HEADER& header,
@@ -159,12 +470,12 @@ void COFFDumper::dumpSectionData(const IMAGE_SECTION_HEADER& header,
         return;
     }
 
-    if (header.PointerToRawData + header.SizeOfRawData > size) {
-        output << "Error: Section data extends beyond file" << std::endl;
+    if (static_cast<size_t>(header.PointerToRawData) + header.SizeOfRawData > size) {
+        output << "Error: Section data extends beyond file\n";
         return;
     }
 
-    output << std::endl << "Section Data (" << std::string(header.Name, strnlen(header.Name, 8)) << "):" << std::endl;
+    output << "\nSection Data (" << std::string(header.Name, strnlen(header.Name, 8)) << "):\n";
 
     // Dump first 16 bytes as hex
     const uint8_t* sectionData = data + header.PointerToRawData;
@@ -179,27 +490,51 @@ void COFFDumper::dumpSectionData(const IMAGE_SECTION_HEADER& header,
     if (header.SizeOfRawData > 16) {
         output << "... (" << header.SizeOfRawData << " bytes total)";
     }
-    output << std::dec << std::endl;
+    output << std::dec << std::setfill(' ') << '\n';
 }
 
-void COFFDumper::dumpSymbolTable(const uint8_t* data, uint32_t numSymbols, std::ostream& output) {
-    output << std::endl << "Symbol Table:" << std::endl;
 
-    for (uint32_t i = 0; i < numSymbols; ++i) {
+void COFFDumper::dumpSymbolRange(const uint8_t* data, uint32_t begin, uint32_t end, uint32_t numSymbols,
+                                 std::string_view stringTable, std::ostream& output) {
+    std::string nameBuffer;     // Se reutiliza en cada símbolo del tramo
+
+    for (uint32_t i = begin; i < end; ++i) {
         const IMAGE_SYMBOL* symbol = reinterpret_cast<const IMAGE_SYMBOL*>(
             data + i * sizeof(IMAGE_SYMBOL));
 
-        dumpSymbol(*symbol, output);
+        std::string_view name = symbolName(*symbol, stringTable);
+        if (symbolSelected(name)) {
+            dumpSymbol(*symbol, name, nameBuffer, output);
+
+            // Definición de sección de un COMDAT: selección y sección asociada
+            if (symbol->StorageClass == IMAGE_SYM_CLASS_STATIC && symbol->NumberOfAuxSymbols > 0 &&
+                i + 1 < numSymbols) {
+                IMAGE_AUX_SYMBOL_SECTION aux;
+                std::memcpy(&aux, data + (i + 1) * sizeof(IMAGE_SYMBOL), sizeof(aux));
+                if (aux.Selection != 0) {
+                    output << "    COMDAT:        selection " << static_cast<int>(aux.Selection)
+                           << ", associated " << aux.Number << '\n';
+                }
+            }
+        }
+        i += symbol->NumberOfAuxSymbols;
     }
 }
 
-void COFFDumper::dumpSymbol(const IMAGE_SYMBOL& symbol, std::ostream& output) {
-    output << "  Symbol:" << std::endl;
-    output << "    Value:         0x" << std::hex << symbol.Value << std::dec << std::endl;
-    output << "    Section:       " << symbol.SectionNumber << std::endl;
-    output << "    Type:          " << symbol.Type << std::endl;
-    output << "    Storage Class: " << static_cast<int>(symbol.StorageClass) << std::endl;
-    output << "    Aux Symbols:   " << static_cast<int>(symbol.NumberOfAuxSymbols) << std::endl;
+void COFFDumper::dumpSymbol(const IMAGE_SYMBOL& symbol, std::string_view name, std::string& nameBuffer,
+                            std::ostream& output) {
+    output << "  Symbol:\n";
+    output << "    Name:          " << name << '\n';
+
+    nameBuffer.clear();
+    if (mangling::MSVCDemangler::demangle(name, nameBuffer)) {
+        output << "    Demangled:     " << nameBuffer << '\n';
+    }
+    output << "    Value:         0x" << std::hex << symbol.Value << std::dec << '\n';
+    output << "    Section:       " << symbol.SectionNumber << '\n';
+    output << "    Type:          " << symbol.Type << '\n';
+    output << "    Storage Class: " << static_cast<int>(symbol.StorageClass) << '\n';
+    output << "    Aux Symbols:   " << static_cast<int>(symbol.NumberOfAuxSymbols) << '\n';
 }
 
 bool COFFDumper::validateFileHeader(const IMAGE_FILE_HEADER& header) {
@@ -227,12 +562,9 @@ std::string COFFDumper::getSectionName(const IMAGE_SECTION_HEADER& header) {
 }
 
 size_t COFFDumper::getFileSize(const std::string& filename) {
-    try {
-        std::string content = cpp20::compiler::common::utils::readFile(filename);
-        return content.size();
-    } catch (...) {
-        return 0;
-    }
+    std::error_code error;
+    auto size = std::filesystem::file_size(filename, error);
+    return error ? 0 : static_cast<size_t>(size);
 }
 
 // ========================================================================
@@ -5,11 +5,19 @@
 
 #include <compiler/backend/coff/COFFWriter.h>
 #include <compiler/backend/coff/COFFTypes.h>
-#include <compiler/common/utils/FileUtils.h>
+#include <compiler/common/utils/HashUtils.h>
+#include <compiler/common/utils/MappedFile.h>
+#include <compiler/common/utils/ThreadPool.h>
 #include <algorithm>
+#include <cstdint>
 #include <ctime>
 #include <cstring>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
 
 namespace cpp20::compiler::backend::coff {
 
@@ -19,19 +27,62 @@ namespace cpp20::compiler::backend::coff {
 
 COFFWriter::COFFWriter() = default;
 
-bool COFFWriter::writeObject(const COFFObject& object, const std::string& filename) {
+COFFLayout COFFWriter::computeLayout(const COFFObject& object) {
+    COFFLayout layout;
+    size_t offset = sizeof(IMAGE_FILE_HEADER) + object.sections.size() * sizeof(IMAGE_SECTION_HEADER);
+
+    for (const auto& section : object.sections) {
+        layout.rawDataOffsets.push_back(offset);
+        offset += section.size();
+        layout.relocationOffsets.push_back(section.relocations.empty() ? 0 : offset);
+        offset += section.relocations.size() * sizeof(IMAGE_RELOCATION);
+    }
+
+    // Los registros auxiliares ocupan entradas: las relocaciones apuntan
+    // a índices de la tabla, no del vector
+    layout.symbolTableOffset = offset;
+    for (const auto& symbol : object.symbols) {
+        layout.symbolIndices.push_back(layout.symbolTableEntries);
+        layout.symbolTableEntries += 1 + symbol.auxSymbols;
+    }
+    offset += layout.symbolTableEntries * sizeof(IMAGE_SYMBOL);
+
+    // Tabla de cadenas: las del objeto y después los nombres largos de símbolos
+    layout.stringTableOffset = offset;
+    layout.stringTableSize = sizeof(uint32_t);
+    for (const auto& str : object.stringTable) {
+        layout.stringTableSize += str.length() + 1; // +1 for null terminator
+    }
+    for (const auto& symbol : object.symbols) {
+        layout.nameOffsets.push_back(symbol.name.length() > 8 ? static_cast<uint32_t>(layout.stringTableSize) : 0);
+        if (symbol.name.length() > 8) {
+            layout.stringTableSize += symbol.name.length() + 1;
+        }
+    }
+    layout.fileSize = offset + layout.stringTableSize;
+    return layout;
+}
+
+bool COFFWriter::writeObject(const COFFObject& object, const std::string& filename, size_t jobs) {
     try {
-        std::vector<uint8_t> buffer;
-        writeHeader(object, buffer);
-        writeSections(object, buffer);
-        writeSymbols(object, buffer);
-        writeStringTable(object, buffer);
+        COFFLayout layout = computeLayout(object);
+        if (layout.fileSize > UINT32_MAX) {
+            throw std::runtime_error("el objeto supera los 4 GiB que admiten los offsets COFF");
+        }
 
-        // Update header with final positions
-        updateHeaderOffsets(buffer, object);
+        if (auto output = common::utils::MappedOutputFile::create(filename, layout.fileSize)) {
+            writeImage(object, layout, reinterpret_cast<uint8_t*>(output->data()), jobs);
+            return true;
+        }
 
-        // Write to file
-        cpp20::compiler::common::utils::writeFile(filename, std::string(buffer.begin(), buffer.end()));
+        // Sin proyección (sistema de archivos que no la admite): un buffer del tamaño final
+        std::vector<uint8_t> buffer(layout.fileSize);
+        writeImage(object, layout, buffer.data(), jobs);
+        std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        if (!out) {
+            throw std::runtime_error("no se pudo escribir el archivo");
+        }
         return true;
 
     } catch (const std::exception& e) {
@@ -42,16 +93,86 @@ bool COFFWriter::writeObject(const COFFObject& object, const std::string& filena
     }
 }
 
-void COFFWriter::writeHeader(const COFFObject& object, std::vector<uint8_t>& buffer) {
-    // File header
-    appendBytes(buffer, &object.header, sizeof(IMAGE_FILE_HEADER));
+bool COFFWriter::writeObject(const COFFObject& object, std::vector<uint8_t>& image, size_t jobs) {
+    COFFLayout layout = computeLayout(object);
+    if (layout.fileSize > UINT32_MAX) {
+        std::cerr << "Error writing COFF object to memory: el objeto supera los 4 GiB que admiten los offsets COFF"
+                  << std::endl;
+        return false;
+    }
+    image.assign(layout.fileSize, 0);
+    writeImage(object, layout, image.data(), jobs);
+    return true;
+}
 
-    // Section headers
-    for (const auto& section : object.sections) {
+void COFFWriter::writeImage(const COFFObject& object, const COFFLayout& layout, uint8_t* image,
+                            size_t jobs) {
+    // Cabeceras con los offsets ya calculados
+    IMAGE_FILE_HEADER fileHeader = object.header;
+    if (!object.symbols.empty()) {
+        fileHeader.PointerToSymbolTable = static_cast<uint32_t>(layout.symbolTableOffset);
+    }
+    fileHeader.NumberOfSymbols = layout.symbolTableEntries;
+    std::memcpy(image, &fileHeader, sizeof(IMAGE_FILE_HEADER));
+
+    for (size_t i = 0; i < object.sections.size(); ++i) {
         IMAGE_SECTION_HEADER sectionHeader = {};
-        writeSectionHeader(section, sectionHeader);
-        appendBytes(buffer, &sectionHeader, sizeof(IMAGE_SECTION_HEADER));
+        writeSectionHeader(object.sections[i], sectionHeader);
+        sectionHeader.PointerToRawData = static_cast<uint32_t>(layout.rawDataOffsets[i]);
+        sectionHeader.PointerToRelocations = static_cast<uint32_t>(layout.relocationOffsets[i]);
+        std::memcpy(image + sizeof(IMAGE_FILE_HEADER) + i * sizeof(IMAGE_SECTION_HEADER),
+                    &sectionHeader, sizeof(IMAGE_SECTION_HEADER));
+    }
+
+    // Cada tarea escribe un rango disjunto; las secciones grandes (CodeView)
+    // se parten para que un solo .debug$S no serialice la escritura
+    constexpr size_t kChunkSize = 4 << 20;
+    constexpr size_t kSymbolsPerTask = kChunkSize / sizeof(IMAGE_SYMBOL);
+    std::vector<std::function<void()>> tasks;
+
+    for (size_t i = 0; i < object.sections.size(); ++i) {
+        const COFFSection& section = object.sections[i];
+        for (size_t begin = 0; begin < section.size(); begin += kChunkSize) {
+            size_t length = std::min(kChunkSize, section.size() - begin);
+            tasks.push_back([&section, begin, length, destination = image + layout.rawDataOffsets[i] + begin] {
+                std::memcpy(destination, section.data.data() + begin, length);
+            });
+        }
+        if (!section.relocations.empty()) {
+            tasks.push_back([&section, &layout, destination = image + layout.relocationOffsets[i]] {
+                for (size_t r = 0; r < section.relocations.size(); ++r) {
+                    IMAGE_RELOCATION relocation = section.relocations[r];
+                    relocation.SymbolTableIndex = layout.symbolIndices[relocation.SymbolTableIndex];
+                    std::memcpy(destination + r * sizeof(IMAGE_RELOCATION), &relocation,
+                                sizeof(IMAGE_RELOCATION));
+                }
+            });
+        }
     }
+
+    for (size_t begin = 0; begin < object.symbols.size(); begin += kSymbolsPerTask) {
+        size_t end = std::min(object.symbols.size(), begin + kSymbolsPerTask);
+        tasks.push_back([&, begin, end] {
+            for (size_t i = begin; i < end; ++i) {
+                IMAGE_SYMBOL symbolEntry = {};
+                writeSymbol(object.symbols[i], layout.nameOffsets[i], symbolEntry);
+                uint8_t* entry = image + layout.symbolTableOffset +
+                                 layout.symbolIndices[i] * sizeof(IMAGE_SYMBOL);
+                std::memcpy(entry, &symbolEntry, sizeof(IMAGE_SYMBOL));
+
+                size_t auxSize = object.symbols[i].auxSymbols * sizeof(IMAGE_SYMBOL);
+                const auto& aux = object.symbols[i].aux;
+                std::memset(entry + sizeof(IMAGE_SYMBOL), 0, auxSize);
+                if (!aux.empty()) {
+                    std::memcpy(entry + sizeof(IMAGE_SYMBOL), aux.data(), std::min(aux.size(), auxSize));
+                }
+            }
+        });
+    }
+
+    tasks.push_back([&] { writeStringTable(object, layout, image + layout.stringTableOffset); });
+
+    common::utils::parallelFor(tasks.size(), jobs, [&](size_t index) { tasks[index](); });
 }
 
 void COFFWriter::writeSectionHeader(const COFFSection& section, IMAGE_SECTION_HEADER& header) {
@@ -66,44 +187,23 @@ void COFFWriter::writeSectionHeader(const COFFSection& section, IMAGE_SECTION_HE
     header.Misc.VirtualSize = static_cast<uint32_t>(section.size());
     header.VirtualAddress = section.virtualAddress;
     header.SizeOfRawData = static_cast<uint32_t>(section.size());
-    header.PointerToRawData = 0;        // Will be updated later
-    header.PointerToRelocations = 0;    // Will be updated later
+    header.PointerToRawData = 0;        // Lo fija writeImage según el layout
+    header.PointerToRelocations = 0;
     header.PointerToLinenumbers = 0;
     header.NumberOfRelocations = static_cast<uint16_t>(section.relocations.size());
     header.NumberOfLinenumbers = 0;
     header.Characteristics = section.characteristics;
 }
 
-void COFFWriter::writeSections(const COFFObject& object, std::vector<uint8_t>& buffer) {
-    for (const auto& section : object.sections) {
-        // Section data
-        buffer.insert(buffer.end(), section.data.begin(), section.data.end());
-
-        // Relocations for this section
-        for (const auto& reloc : section.relocations) {
-            appendBytes(buffer, &reloc, sizeof(IMAGE_RELOCATION));
-        }
-    }
-}
-
-void COFFWriter::writeSymbols(const COFFObject& object, std::vector<uint8_t>& buffer) {
-    for (const auto& symbol : object.symbols) {
-        IMAGE_SYMBOL symbolEntry = {};
-        writeSymbol(symbol, symbolEntry);
-        appendBytes(buffer, &symbolEntry, sizeof(IMAGE_SYMBOL));
-    }
-}
-
-void COFFWriter::writeSymbol(const COFFSymbol& symbol, IMAGE_SYMBOL& entry) {
+void COFFWriter::writeSymbol(const COFFSymbol& symbol, uint32_t nameOffset, IMAGE_SYMBOL& entry) {
     // Symbol name
     if (symbol.name.length() <= 8) {
-        // Short name
+        // Short name (sin terminador si ocupa los 8 bytes)
         std::memcpy(entry.N.ShortName, symbol.name.c_str(), symbol.name.length());
-        entry.N.Name.Zeroes = 0;
     } else {
-        // Long name - will be in string table
+        // Long name - en la tabla de cadenas
         entry.N.Name.Zeroes = 0;
-        entry.N.Name.Offset = 0; // Will be updated with string table offset
+        entry.N.Name.Offset = nameOffset;
     }
 
     // Symbol properties
@@ -114,68 +214,345 @@ void COFFWriter::writeSymbol(const COFFSymbol& symbol, IMAGE_SYMBOL& entry) {
     entry.NumberOfAuxSymbols = symbol.auxSymbols;
 }
 
-void COFFWriter::writeStringTable(const COFFObject& object, std::vector<uint8_t>& buffer) {
-    if (object.stringTable.empty()) {
-        // Empty string table (just size)
-        uint32_t size = sizeof(uint32_t);
-        appendBytes(buffer, &size, sizeof(uint32_t));
-        return;
-    }
+void COFFWriter::writeStringTable(const COFFObject& object, const COFFLayout& layout, uint8_t* out) {
+    // Size of string table (incluye estos 4 bytes aunque esté vacía)
+    auto totalSize = static_cast<uint32_t>(layout.stringTableSize);
+    std::memcpy(out, &totalSize, sizeof(uint32_t));
+    out += sizeof(uint32_t);
 
-    // Calculate total size
-    uint32_t totalSize = sizeof(uint32_t); // Size of string table
+    // Write strings
     for (const auto& str : object.stringTable) {
-        totalSize += static_cast<uint32_t>(str.length() + 1); // +1 for null terminator
+        std::memcpy(out, str.data(), str.length());
+        out[str.length()] = 0; // Null terminator
+        out += str.length() + 1;
+    }
+    for (size_t i = 0; i < object.symbols.size(); ++i) {
+        if (layout.nameOffsets[i] == 0) continue;
+        const std::string& name = object.symbols[i].name;
+        std::memcpy(out, name.data(), name.length());
+        out[name.length()] = 0;
+        out += name.length() + 1;
     }
+}
 
-    // Write size
-    appendBytes(buffer, &totalSize, sizeof(uint32_t));
+// ========================================================================
+// Helper functions
+// ========================================================================
 
-    // Write strings
-    for (const auto& str : object.stringTable) {
-        buffer.insert(buffer.end(), str.begin(), str.end());
-        buffer.push_back(0); // Null terminator
+namespace {
+
+size_t findOrAddSection(COFFObject& object, const std::string& name, uint32_t characteristics) {
+    for (size_t i = 0; i < object.sections.size(); ++i) {
+        const COFFSection& section = object.sections[i];
+        if (section.name == name && !(section.characteristics & IMAGE_SCN_LNK_COMDAT)) return i;
     }
+    object.addSection(COFFSection(name, characteristics));
+    return object.sections.size() - 1;
 }
 
-void COFFWriter::updateHeaderOffsets(std::vector<uint8_t>& buffer, const COFFObject& object) {
-    size_t offset = sizeof(IMAGE_FILE_HEADER) + object.sections.size() * sizeof(IMAGE_SECTION_HEADER);
+/**
+ * @brief Crea una sección COMDAT y su símbolo de sección con la definición auxiliar
+ *
+ * Length y NumberOfRelocations se rellenan al final (fillSectionDefinitions).
+ */
+size_t addComdatSection(COFFObject& object, const std::string& name, uint32_t characteristics,
+                        uint8_t selection, size_t associated = 0) {
+    object.addSection(COFFSection(name, characteristics | IMAGE_SCN_LNK_COMDAT));
+    size_t section = object.sections.size() - 1;
+
+    IMAGE_AUX_SYMBOL_SECTION definition = {};
+    definition.Selection = selection;
+    if (selection == IMAGE_COMDAT_SELECT_ASSOCIATIVE) {
+        definition.Number = static_cast<uint16_t>(associated + 1);
+    }
 
-    // Update section data pointers
-    for (size_t i = 0; i < object.sections.size(); ++i) {
-        const auto& section = object.sections[i];
-        size_t sectionHeaderOffset = sizeof(IMAGE_FILE_HEADER) + i * sizeof(IMAGE_SECTION_HEADER);
+    COFFSymbol symbol(name, IMAGE_SYM_CLASS_STATIC);
+    symbol.sectionNumber = static_cast<int16_t>(section + 1);
+    symbol.auxSymbols = 1;
+    symbol.aux.resize(sizeof(IMAGE_SYMBOL));
+    std::memcpy(symbol.aux.data(), &definition, sizeof(definition));
+    object.addSymbol(std::move(symbol));
+    return section;
+}
 
-        // Update PointerToRawData
-        size_t dataOffset = offset;
-        std::memcpy(&buffer[sectionHeaderOffset + offsetof(IMAGE_SECTION_HEADER, PointerToRawData)],
-                   &dataOffset, sizeof(uint32_t));
+void fillSectionDefinitions(COFFObject& object) {
+    for (COFFSymbol& symbol : object.symbols) {
+        if (symbol.storageClass != IMAGE_SYM_CLASS_STATIC || symbol.sectionNumber <= 0 ||
+            symbol.aux.size() < sizeof(IMAGE_AUX_SYMBOL_SECTION)) {
+            continue;
+        }
+        const COFFSection& section = object.sections[symbol.sectionNumber - 1];
+        if (!(section.characteristics & IMAGE_SCN_LNK_COMDAT)) continue;
+
+        IMAGE_AUX_SYMBOL_SECTION definition;
+        std::memcpy(&definition, symbol.aux.data(), sizeof(definition));
+        definition.Length = static_cast<uint32_t>(section.size());
+        definition.NumberOfRelocations = static_cast<uint16_t>(section.relocations.size());
+        std::memcpy(symbol.aux.data(), &definition, sizeof(definition));
+    }
+}
 
-        // Update PointerToRelocations
-        if (!section.relocations.empty()) {
-            size_t relocOffset = offset + section.size();
-            std::memcpy(&buffer[sectionHeaderOffset + offsetof(IMAGE_SECTION_HEADER, PointerToRelocations)],
-                       &relocOffset, sizeof(uint32_t));
+/**
+ * @brief Índice del símbolo de sección (estático, valor 0), creándolo si falta
+ */
+uint32_t sectionSymbol(COFFObject& object, size_t section) {
+    int16_t number = static_cast<int16_t>(section + 1);
+    for (size_t i = 0; i < object.symbols.size(); ++i) {
+        const COFFSymbol& symbol = object.symbols[i];
+        if (symbol.storageClass == IMAGE_SYM_CLASS_STATIC && symbol.sectionNumber == number &&
+            symbol.value == 0 && symbol.name == object.sections[section].name) {
+            return static_cast<uint32_t>(i);
         }
+    }
+    COFFSymbol symbol(object.sections[section].name, IMAGE_SYM_CLASS_STATIC);
+    symbol.sectionNumber = number;
+    object.addSymbol(std::move(symbol));
+    return static_cast<uint32_t>(object.symbols.size() - 1);
+}
 
-        offset += section.size() + section.relocations.size() * sizeof(IMAGE_RELOCATION);
+/**
+ * @brief Índice del símbolo externo con ese nombre; si no existe, queda sin definir
+ */
+uint32_t externalSymbol(COFFObject& object, const std::string& name) {
+    for (size_t i = 0; i < object.symbols.size(); ++i) {
+        const COFFSymbol& symbol = object.symbols[i];
+        if (symbol.storageClass == IMAGE_SYM_CLASS_EXTERNAL && symbol.name == name) {
+            return static_cast<uint32_t>(i);
+        }
     }
+    COFFSymbol symbol(name, IMAGE_SYM_CLASS_EXTERNAL);
+    symbol.type = IMAGE_SYM_DTYPE_FUNCTION;
+    object.addSymbol(std::move(symbol));
+    return static_cast<uint32_t>(object.symbols.size() - 1);
+}
 
-    // Update symbol table pointer
-    if (!object.symbols.empty()) {
-        std::memcpy(&buffer[offsetof(IMAGE_FILE_HEADER, PointerToSymbolTable)],
-                   &offset, sizeof(uint32_t));
+/**
+ * @brief Bits IMAGE_SCN_ALIGN_* de un alineamiento en bytes (potencia de dos)
+ */
+uint32_t alignmentCharacteristics(uint32_t alignment) {
+    uint32_t log2 = 0;
+    while (log2 < 13 && (1u << log2) < alignment) ++log2;
+    return (log2 + 1) << 20;
+}
+
+void alignSection(COFFSection& section, size_t alignment, uint8_t fill) {
+    while (section.data.size() % alignment != 0) {
+        section.data.push_back(fill);
     }
 }
 
-void COFFWriter::appendBytes(std::vector<uint8_t>& buffer, const void* data, size_t size) {
-    const uint8_t* bytes = static_cast<const uint8_t*>(data);
-    buffer.insert(buffer.end(), bytes, bytes + size);
+void appendUInt32(std::vector<uint8_t>& data, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        data.push_back(static_cast<uint8_t>(value >> shift));
+    }
 }
 
-// ========================================================================
-// Helper functions
-// ========================================================================
+} // namespace
+
+void appendFunctions(COFFObject& object, const std::vector<COFFFunction>& functions) {
+    if (functions.empty()) return;
+
+    constexpr uint32_t kTextCharacteristics = IMAGE_SCN_CNT_CODE | IMAGE_SCN_MEM_EXECUTE |
+                                              IMAGE_SCN_MEM_READ | IMAGE_SCN_ALIGN_16BYTES;
+    constexpr uint32_t kUnwindCharacteristics = IMAGE_SCN_CNT_INITIALIZED_DATA | IMAGE_SCN_MEM_READ |
+                                                IMAGE_SCN_ALIGN_4BYTES;
+
+    // Las secciones comunes solo hacen falta si alguna función no va en COMDAT
+    bool shared = std::any_of(functions.begin(), functions.end(),
+                              [](const COFFFunction& function) { return function.comdatSelection == 0; });
+    size_t text = 0, xdata = 0, pdata = 0;
+    uint32_t textSymbol = 0, xdataSymbol = 0;
+    if (shared) {
+        text = findOrAddSection(object, ".text", kTextCharacteristics);
+        xdata = findOrAddSection(object, ".xdata", kUnwindCharacteristics);
+        pdata = findOrAddSection(object, ".pdata", kUnwindCharacteristics);
+        textSymbol = sectionSymbol(object, text);
+        xdataSymbol = sectionSymbol(object, xdata);
+    }
+    std::vector<size_t> sections;
+    std::vector<uint32_t> starts;
+
+    // Tablas de saltos por función: nombre -> (símbolo de su sección, offset)
+    constexpr uint32_t kTableCharacteristics = IMAGE_SCN_CNT_INITIALIZED_DATA | IMAGE_SCN_MEM_READ |
+                                               IMAGE_SCN_ALIGN_4BYTES;
+    std::vector<std::unordered_map<std::string, std::pair<uint32_t, uint32_t>>> tables(functions.size());
+
+    // UNWIND_INFO ya emitidos en la .xdata común: los prólogos idénticos comparten registro
+    std::unordered_map<std::string, uint32_t> sharedUnwind;
+
+    for (const COFFFunction& function : functions) {
+        bool comdat = function.comdatSelection != 0;
+        size_t code = comdat ? addComdatSection(object, ".text$mn", kTextCharacteristics,
+                                                function.comdatSelection)
+                             : text;
+        auto codeSymbol = comdat ? static_cast<uint32_t>(object.symbols.size() - 1) : textSymbol;
+
+        // Relleno con INT3 entre funciones
+        alignSection(object.sections[code], 16, 0xCC);
+        auto begin = static_cast<uint32_t>(object.sections[code].data.size());
+        sections.push_back(code);
+        starts.push_back(begin);
+        object.sections[code].data.insert(object.sections[code].data.end(),
+                                          function.code.begin(), function.code.end());
+        auto end = static_cast<uint32_t>(object.sections[code].data.size());
+
+        // En una COMDAT es el símbolo que sigue al de sección: el que da nombre al COMDAT
+        COFFSymbol symbol(function.name, IMAGE_SYM_CLASS_EXTERNAL);
+        symbol.value = begin;
+        symbol.sectionNumber = static_cast<int16_t>(code + 1);
+        symbol.type = IMAGE_SYM_DTYPE_FUNCTION;
+        object.addSymbol(std::move(symbol));
+
+        // Cada entrada, RVA de su bloque: ADDR32NB contra el código con el offset como addend
+        if (!function.jumpTables.empty()) {
+            size_t rdata = comdat ? addComdatSection(object, ".rdata", kTableCharacteristics,
+                                                     IMAGE_COMDAT_SELECT_ASSOCIATIVE, code)
+                                  : findOrAddSection(object, ".rdata", kTableCharacteristics);
+            uint32_t rdataSymbol = comdat ? static_cast<uint32_t>(object.symbols.size() - 1)
+                                          : sectionSymbol(object, rdata);
+            for (const COFFJumpTable& table : function.jumpTables) {
+                COFFSection& section = object.sections[rdata];
+                alignSection(section, 4, 0);
+                auto offset = static_cast<uint32_t>(section.data.size());
+                for (uint32_t target : table.targets) {
+                    section.relocations.push_back(
+                        {static_cast<uint32_t>(section.data.size()), codeSymbol, IMAGE_REL_AMD64_ADDR32NB});
+                    appendUInt32(section.data, begin + target);
+                }
+                tables[sections.size() - 1].emplace(table.name, std::make_pair(rdataSymbol, offset));
+            }
+        }
+
+        if (function.unwindInfo.empty() || begin + function.unwindBegin >= end) continue;
+
+        size_t unwindSection = comdat ? addComdatSection(object, ".xdata", kUnwindCharacteristics,
+                                                         IMAGE_COMDAT_SELECT_ASSOCIATIVE, code)
+                                      : xdata;
+        auto unwindSymbol = comdat ? static_cast<uint32_t>(object.symbols.size() - 1) : xdataSymbol;
+        size_t runtimeSection = comdat ? addComdatSection(object, ".pdata", kUnwindCharacteristics,
+                                                          IMAGE_COMDAT_SELECT_ASSOCIATIVE, code)
+                                       : pdata;
+
+        uint32_t unwind = 0;
+        auto shared = comdat ? sharedUnwind.end()
+                             : sharedUnwind.find(std::string(function.unwindInfo.begin(), function.unwindInfo.end()));
+        if (shared != sharedUnwind.end()) {
+            unwind = shared->second;
+        } else {
+            alignSection(object.sections[unwindSection], 4, 0);
+            unwind = static_cast<uint32_t>(object.sections[unwindSection].data.size());
+            object.sections[unwindSection].data.insert(object.sections[unwindSection].data.end(),
+                                                       function.unwindInfo.begin(), function.unwindInfo.end());
+            if (!comdat) {
+                sharedUnwind.emplace(std::string(function.unwindInfo.begin(), function.unwindInfo.end()), unwind);
+            }
+        }
+
+        // RUNTIME_FUNCTION: inicio, fin y UNWIND_INFO, relativos a la imagen
+        COFFSection& runtime = object.sections[runtimeSection];
+        auto entry = static_cast<uint32_t>(runtime.data.size());
+        appendUInt32(runtime.data, begin + function.unwindBegin);
+        appendUInt32(runtime.data, end);
+        appendUInt32(runtime.data, unwind);
+        runtime.relocations.push_back({entry, codeSymbol, IMAGE_REL_AMD64_ADDR32NB});
+        runtime.relocations.push_back({entry + 4, codeSymbol, IMAGE_REL_AMD64_ADDR32NB});
+        runtime.relocations.push_back({entry + 8, unwindSymbol, IMAGE_REL_AMD64_ADDR32NB});
+    }
+
+    // Con todas las funciones ya definidas, las llamadas entre ellas no
+    // crean símbolos externos sin definir
+    for (size_t i = 0; i < functions.size(); ++i) {
+        for (const COFFFunctionRelocation& relocation : functions[i].relocations) {
+            auto table = tables[i].find(relocation.symbol);
+            if (table != tables[i].end()) {
+                // Contra la sección de la tabla: su offset va como addend en el código
+                uint32_t at = starts[i] + relocation.offset;
+                std::memcpy(&object.sections[sections[i]].data[at], &table->second.second, sizeof(uint32_t));
+                object.sections[sections[i]].relocations.push_back({at, table->second.first, relocation.type});
+                continue;
+            }
+            object.sections[sections[i]].relocations.push_back(
+                {starts[i] + relocation.offset, externalSymbol(object, relocation.symbol), relocation.type});
+        }
+    }
+
+    fillSectionDefinitions(object);
+}
+
+std::string literalSymbolName(const std::vector<uint8_t>& data) {
+    common::utils::StreamingHasher hasher;
+    hasher.update(data.data(), data.size());
+    return "??_C@_" + std::to_string(data.size()) + "_" + hasher.digest128().toHex() + "@";
+}
+
+std::vector<std::string> appendLiterals(COFFObject& object, const std::vector<COFFLiteral>& literals) {
+    constexpr uint32_t kLiteralCharacteristics = IMAGE_SCN_CNT_INITIALIZED_DATA | IMAGE_SCN_MEM_READ;
+
+    // Sección de cada literal ya presente, incluidos los de llamadas anteriores
+    std::unordered_map<std::string, size_t> pooled;
+    for (const COFFSymbol& symbol : object.symbols) {
+        if (symbol.storageClass == IMAGE_SYM_CLASS_EXTERNAL && symbol.sectionNumber > 0 &&
+            symbol.name.starts_with("??_C@_")) {
+            pooled.emplace(symbol.name, static_cast<size_t>(symbol.sectionNumber - 1));
+        }
+    }
+
+    std::vector<std::string> names;
+    names.reserve(literals.size());
+    for (const COFFLiteral& literal : literals) {
+        std::string name = literalSymbolName(literal.data);
+        uint32_t alignment = alignmentCharacteristics(literal.alignment);
+        auto [it, inserted] = pooled.try_emplace(name, 0);
+        if (inserted) {
+            it->second = addComdatSection(object, ".rdata", kLiteralCharacteristics | alignment,
+                                          IMAGE_COMDAT_SELECT_ANY);
+            object.sections[it->second].data = literal.data;
+            COFFSymbol symbol(name, IMAGE_SYM_CLASS_EXTERNAL);
+            symbol.sectionNumber = static_cast<int16_t>(it->second + 1);
+            object.addSymbol(std::move(symbol));
+        } else {
+            COFFSection& section = object.sections[it->second];
+            if ((section.characteristics & IMAGE_SCN_ALIGN_MASK) < alignment) {
+                section.characteristics = (section.characteristics & ~IMAGE_SCN_ALIGN_MASK) | alignment;
+            }
+        }
+        names.push_back(std::move(name));
+    }
+
+    fillSectionDefinitions(object);
+    return names;
+}
+
+void appendVariables(COFFObject& object, const std::vector<COFFVariable>& variables) {
+    if (variables.empty()) return;
+    size_t data = findOrAddSection(object, ".data", IMAGE_SCN_CNT_INITIALIZED_DATA | IMAGE_SCN_MEM_READ |
+                                                        IMAGE_SCN_MEM_WRITE);
+    COFFSection& section = object.sections[data];
+    for (const COFFVariable& variable : variables) {
+        uint32_t alignment = alignmentCharacteristics(variable.alignment);
+        if ((section.characteristics & IMAGE_SCN_ALIGN_MASK) < alignment) {
+            section.characteristics = (section.characteristics & ~IMAGE_SCN_ALIGN_MASK) | alignment;
+        }
+        alignSection(section, variable.alignment, 0);
+        COFFSymbol symbol(variable.name, IMAGE_SYM_CLASS_EXTERNAL);
+        symbol.value = static_cast<uint32_t>(section.data.size());
+        symbol.sectionNumber = static_cast<int16_t>(data + 1);
+        object.addSymbol(std::move(symbol));
+        section.data.insert(section.data.end(), variable.data.begin(), variable.data.end());
+    }
+}
+
+void appendInitializers(COFFObject& object, const std::vector<std::string>& functions) {
+    if (functions.empty()) return;
+    size_t table = findOrAddSection(object, ".CRT$XCC", IMAGE_SCN_CNT_INITIALIZED_DATA | IMAGE_SCN_MEM_READ |
+                                                            IMAGE_SCN_ALIGN_8BYTES);
+    for (const std::string& function : functions) {
+        uint32_t symbol = externalSymbol(object, function);
+        COFFSection& section = object.sections[table];
+        section.relocations.push_back({static_cast<uint32_t>(section.data.size()), symbol, IMAGE_REL_AMD64_ADDR64});
+        section.data.insert(section.data.end(), 8, 0);
+    }
+}
 
 COFFObject createBasicCOFFObject() {
     COFFObject object;
@@ -61,26 +61,92 @@ FrameLayout FrameBuilder::buildFrameLayout(
     return layout;
 }
 
-std::vector<ParameterInfo> FrameBuilder::classifyParameters(
-    const std::vector<std::pair<size_t, size_t>>& paramSizes) {
+FrameLayout FrameBuilder::buildFunctionFrame(const FrameRequirements& requirements) {
+    constexpr uint8_t kRbp = 5;
 
-    std::vector<ParameterInfo> params;
+    FrameLayout layout;
+    layout.usesFramePointer = requirements.needsFramePointer;
+    layout.localAreaSize = abi::ABIContract::alignOffset(requirements.localSize, 8);
+
+    // Orden fijo de PUSH para que prólogo, epílogo y unwind coincidan
+    for (uint8_t reg = 0; reg < 16; ++reg) {
+        bool used = std::find(requirements.usedCalleeSaved.begin(), requirements.usedCalleeSaved.end(),
+                              reg) != requirements.usedCalleeSaved.end();
+        if (reg == kRbp) used = used || layout.usesFramePointer;
+        if (used && reg != 4 && abi::ABIContract::isCalleeSavedRegister(reg)) {
+            layout.savedRegisters.push_back(reg);
+        }
+    }
 
-    for (size_t i = 0; i < paramSizes.size(); ++i) {
-        const auto& [size, alignment] = paramSizes[i];
+    if (requirements.makesCalls) layout.shadowSpaceSize = abi::ABIContract::SHADOW_SPACE_SIZE;
+    layout.allocationSize = layout.shadowSpaceSize + layout.localAreaSize;
 
-        // Crear parámetro (simplificado - todos como enteros por ahora)
-        ParameterInfo paramInfo(ParameterInfo::Kind::Integer, size, alignment, false, -1, false);
+    // Al entrar RSP es 8 mod 16 (dirección de retorno); solo hace falta
+    // realinear si se va a llamar o hay locales que reservar
+    if (layout.allocationSize > 0) {
+        size_t pushed = 8 + 8 * layout.savedRegisters.size();
+        layout.allocationSize = abi::ABIContract::alignOffset(pushed + layout.allocationSize,
+                                                              abi::ABIContract::STACK_ALIGNMENT) - pushed;
+    }
 
-        // Asignar registro si está disponible
-        if (i < 4) {
-            paramInfo.inRegister = true;
-            paramInfo.registerIndex = static_cast<int>(i);
-        }
+    layout.isLeaf = layout.savedRegisters.empty() && layout.allocationSize == 0;
+    layout.returnAddressOffset = layout.allocationSize + 8 * layout.savedRegisters.size();
+    return layout;
+}
 
-        params.push_back(paramInfo);
+size_t FrameBuilder::layoutStackSlots(std::vector<StackSlot>& slots) {
+    struct Position {
+        size_t size = 0;
+        size_t alignment = 1;
+        size_t offset = 0;
+    };
+    std::vector<Position> positions;
+    for (const StackSlot& slot : slots) {
+        if (slot.color >= positions.size()) positions.resize(slot.color + 1);
+        Position& position = positions[slot.color];
+        position.alignment = std::max(position.alignment, std::min<size_t>(slot.alignment, 16));
+        position.size = std::max(position.size, slot.size);
     }
 
+    std::vector<uint32_t> order;
+    for (uint32_t color = 0; color < positions.size(); ++color) {
+        if (positions[color].size > 0) order.push_back(color);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        if (positions[a].alignment != positions[b].alignment) return positions[a].alignment > positions[b].alignment;
+        return positions[a].size > positions[b].size;
+    });
+
+    size_t size = 0;
+    for (uint32_t color : order) {
+        size = abi::ABIContract::alignOffset(size, positions[color].alignment);
+        positions[color].offset = size;
+        size += positions[color].size;
+    }
+    for (StackSlot& slot : slots) slot.offset = positions[slot.color].offset;
+    return abi::ABIContract::alignOffset(size, 8);
+}
+
+std::vector<ParameterInfo> FrameBuilder::classifyParameters(
+    const std::vector<std::pair<size_t, size_t>>& paramSizes) {
+
+    // Sin más información que el tamaño: lo que no cabe en un entero es un agregado
+    std::vector<abi::ABIContract::ValueType> types;
+    types.reserve(paramSizes.size());
+    for (const auto& [size, alignment] : paramSizes) {
+        types.push_back(size == 1 || size == 2 || size == 4 || size == 8
+                            ? abi::ABIContract::ValueType::integer(size)
+                            : abi::ABIContract::ValueType::aggregate(size, alignment));
+    }
+
+    std::vector<ParameterInfo> params;
+    for (const auto& info : abi::ABIContract::classifyParameters(types)) {
+        // Por referencia, en el registro o la pila va el puntero a la copia
+        size_t size = info.byReference ? abi::ABIContract::GENERAL_ALIGNMENT : info.size;
+        size_t alignment = info.byReference ? abi::ABIContract::GENERAL_ALIGNMENT : info.alignment;
+        params.emplace_back(static_cast<ParameterInfo::Kind>(info.kind), size, alignment, info.inRegister,
+                            info.registerIndex, info.isSigned);
+    }
     return params;
 }
 
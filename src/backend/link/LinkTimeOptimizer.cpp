@@ -0,0 +1,230 @@
+/**
+ * @file LinkTimeOptimizer.cpp
+ * @brief Fusión, optimización y generación de código del IR de -flto
+ */
+
+#include <compiler/backend/link/LinkTimeOptimizer.h>
+#include <compiler/backend/codegen/CodeGenerator.h>
+#include <compiler/backend/coff/COFFWriter.h>
+#include <compiler/common/utils/ThreadPool.h>
+#include <compiler/ir/IRPasses.h>
+#include <compiler/ir/IRSerialization.h>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <numeric>
+
+namespace cpp20::compiler::backend::link {
+
+void embedIRModule(coff::COFFObject& object, const ir::IRModule& module) {
+    coff::COFFSection section(IRSectionName, coff::IMAGE_SCN_LNK_INFO | coff::IMAGE_SCN_LNK_REMOVE |
+                                                 coff::IMAGE_SCN_ALIGN_1BYTES);
+    ir::serializeModule(module, section.data);
+    object.addSection(std::move(section));
+}
+
+LinkTimeOptimizer::LinkTimeOptimizer(int optimizationLevel)
+    : optimizationLevel_(optimizationLevel), module_("lto") {
+}
+
+bool LinkTimeOptimizer::addModule(std::span<const uint8_t> bytes, const std::string& origin) {
+    auto module = ir::deserializeModule(bytes);
+    if (!module) {
+        lastError_ = "IR no válido en " + origin;
+        return false;
+    }
+
+    for (auto& function : module->takeFunctions()) {
+        auto [it, inserted] = functionIndex_.try_emplace(function->getName(), functions_.size());
+        if (inserted) {
+            functions_.push_back(std::move(function));
+            functionOrigins_.push_back(origin);
+            continue;
+        }
+
+        // Una definición sustituye a una declaración; de las LinkOnce basta una
+        auto& existing = functions_[it->second];
+        if (function->blockCount() == 0) continue;
+        if (existing->blockCount() == 0) {
+            existing = std::move(function);
+            functionOrigins_[it->second] = origin;
+            continue;
+        }
+        if (existing->getLinkage() == ir::Linkage::LinkOnce && function->getLinkage() == ir::Linkage::LinkOnce) {
+            continue;
+        }
+        lastError_ = "Función '" + function->getName() + "' definida en " + functionOrigins_[it->second] +
+                     " y en " + origin;
+        return false;
+    }
+
+    for (const auto& global : module->getGlobals()) {
+        if (globalNames_.insert(global->getName()).second) {
+            module_.addGlobalVariable(std::make_unique<ir::IRGlobalVariable>(
+                global->getName(), global->getType(), global->getInitializer()));
+        }
+    }
+    for (const auto& info : module->getClasses()) {
+        if (classNames_.insert(info.name).second) module_.addClass(info);
+    }
+    for (const std::string& initializer : module->getInitializers()) {
+        const auto& existing = module_.getInitializers();
+        if (std::find(existing.begin(), existing.end(), initializer) == existing.end()) {
+            module_.addInitializer(initializer);
+        }
+    }
+
+    ++statistics_.modules;
+    return true;
+}
+
+void LinkTimeOptimizer::optimize() {
+    for (auto& function : functions_) {
+        module_.addFunction(std::move(function));
+    }
+    functions_.clear();
+    functionIndex_.clear();
+    functionOrigins_.clear();
+
+    // Con el programa entero a la vista: desvirtualización protegida e inlining entre unidades
+    ir::ProfileOptions pgo;
+    pgo.profile = profile_;
+    auto pipeline = ir::PassManager::createForOptimizationLevel(optimizationLevel_,
+                                                                ir::VectorTarget::fromCPUFeatures(features_), true, pgo);
+    pipeline.run(module_);
+    removeUnusedLinkOnce();
+
+    statistics_.functions = 0;
+    for (const auto& function : module_.getFunctions()) {
+        if (function->blockCount() > 0) ++statistics_.functions;
+    }
+}
+
+void LinkTimeOptimizer::removeUnusedLinkOnce() {
+    auto functions = module_.takeFunctions();
+    std::unordered_map<std::string_view, size_t> byName;
+    for (size_t i = 0; i < functions.size(); ++i) {
+        byName.emplace(functions[i]->getName(), i);
+    }
+
+    // Raíces: todo lo que no es LinkOnce y lo que el CRT llama al cargar;
+    // los objetos sin IR tienen su propia copia
+    std::vector<bool> live(functions.size(), false);
+    std::vector<size_t> pending;
+    for (size_t i = 0; i < functions.size(); ++i) {
+        if (functions[i]->getLinkage() != ir::Linkage::LinkOnce) {
+            live[i] = true;
+            pending.push_back(i);
+        }
+    }
+    for (const std::string& initializer : module_.getInitializers()) {
+        auto it = byName.find(initializer);
+        if (it != byName.end() && !live[it->second]) {
+            live[it->second] = true;
+            pending.push_back(it->second);
+        }
+    }
+    while (!pending.empty()) {
+        const ir::IRFunction& function = *functions[pending.back()];
+        pending.pop_back();
+        for (ir::ValueId id = 0; id < function.valueCount(); ++id) {
+            if (function.value(id).kind != ir::ValueKind::Global || !function.hasUses(id)) continue;
+            auto it = byName.find(function.globalName(id));
+            if (it != byName.end() && !live[it->second]) {
+                live[it->second] = true;
+                pending.push_back(it->second);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < functions.size(); ++i) {
+        if (live[i]) {
+            module_.addFunction(std::move(functions[i]));
+        } else {
+            ++statistics_.removedFunctions;
+        }
+    }
+}
+
+bool LinkTimeOptimizer::generateObjects(size_t jobs, std::vector<ObjectImage>& images) {
+    std::vector<const ir::IRFunction*> functions;
+    for (const auto& function : module_.getFunctions()) {
+        if (function->blockCount() > 0) functions.push_back(function.get());
+    }
+    if (functions.empty()) return true;
+
+    // Reparto voraz de mayor a menor: cada función a la partición con menos instrucciones
+    size_t partitionCount = std::min(std::max<size_t>(1, jobs), functions.size());
+    std::vector<size_t> order(functions.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return functions[a]->instructionCount() > functions[b]->instructionCount();
+    });
+    std::vector<std::vector<size_t>> partitions(partitionCount);
+
+    // Las variables globales y los inicializadores van con la partición 0
+    std::vector<coff::COFFVariable> variables;
+    for (const auto& global : module_.getGlobals()) {
+        coff::COFFVariable variable;
+        variable.name = global->getName();
+        variable.data.assign(global->getType().size, 0);
+        if (const auto& initializer = global->getInitializer()) {
+            const ir::TypeInfo& type = global->getType();
+            uint64_t bits = type.type == ir::IRType::Double ? std::bit_cast<uint64_t>(initializer->floatValue)
+                          : type.type == ir::IRType::Float
+                              ? std::bit_cast<uint32_t>(static_cast<float>(initializer->floatValue))
+                              : static_cast<uint64_t>(initializer->intValue);
+            for (size_t i = 0; i < variable.data.size() && i < sizeof(bits); ++i) {
+                variable.data[i] = static_cast<uint8_t>(bits >> (8 * i));
+            }
+        }
+        variable.alignment = std::max<uint32_t>(1, static_cast<uint32_t>(global->getType().alignment));
+        variables.push_back(std::move(variable));
+    }
+    std::vector<size_t> loads(partitionCount, 0);
+    for (size_t index : order) {
+        size_t lightest = std::min_element(loads.begin(), loads.end()) - loads.begin();
+        partitions[lightest].push_back(index);
+        loads[lightest] += functions[index]->instructionCount();
+    }
+
+    // Código de todas las funciones, en el orden del módulo; con caché, las
+    // que no cambiaron desde el enlace anterior no pasan por el back-end
+    CodeGenerator generator(abiContract_, features_, AllocationStrategy::LinearScan, tune_);
+    generator.setSharedCache(codeCache_);
+    IncrementalStats reuse;
+    std::vector<FunctionCode> generated = generator.generateModule(module_, jobs, &reuse);
+    statistics_.cachedFunctions = reuse.reused;
+
+    // Dentro de cada partición, el orden del módulo: la salida no depende de los hilos
+    size_t first = images.size();
+    images.resize(first + partitionCount);
+    std::atomic<bool> written{true};
+    common::utils::parallelFor(partitionCount, jobs, [&](size_t partition) {
+        auto& members = partitions[partition];
+        std::sort(members.begin(), members.end());
+        std::vector<coff::COFFFunction> code;
+        for (size_t index : members) {
+            code.push_back(CodeGenerator::toCOFFFunction(generated[index]));
+        }
+
+        coff::COFFObject object = coff::createBasicCOFFObject();
+        if (partition == 0) coff::appendVariables(object, variables);
+        coff::appendFunctions(object, code);
+        if (partition == 0) coff::appendInitializers(object, module_.getInitializers());
+        ObjectImage& image = images[first + partition];
+        image.name = "lto." + std::to_string(partition) + ".obj";
+        if (!coff::COFFWriter().writeObject(object, image.bytes)) {
+            written = false;
+        }
+    });
+
+    statistics_.partitions = partitionCount;
+    if (!written) {
+        lastError_ = "No se pudo escribir un objeto de LTO";
+        return false;
+    }
+    return true;
+}
+
+} // namespace cpp20::compiler::backend::link
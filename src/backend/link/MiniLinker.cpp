@@ -4,15 +4,253 @@
  */
 
 #include <compiler/backend/link/MiniLinker.h>
+#include <compiler/backend/link/LinkTimeOptimizer.h>
+#include <compiler/ir/Profile.h>
 #include <compiler/backend/coff/COFFTypes.h>
+#include <compiler/backend/coff/COFFWriter.h>
+#include <compiler/common/utils/ThreadPool.h>
+#include <atomic>
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <cstring>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#define CPP20_LINKER_HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
 namespace cpp20::compiler::backend::link {
 
+namespace {
+
+constexpr uint32_t kAlignMask = 0x00F00000;
+constexpr uint32_t kPageSize = 0x1000;
+constexpr size_t kChecksumChunk = size_t{1} << 20;     // Par: ninguna palabra queda partida
+constexpr char kDatabaseMagic[8] = {'C', 'P', 'P', 'I', 'L', 'K', '0', '1'};
+
+// Nombre para mensajes: forma desmangled con el mangled entre paréntesis
+std::string describeSymbol(std::string_view name) {
+    std::string result;
+    if (!mangling::MSVCDemangler::demangle(name, result)) {
+        return std::string(name);
+    }
+    result += " (";
+    result += name;
+    result += ')';
+    return result;
+}
+
+// Suma de las palabras de 16 bits (little-endian) de data; si el tamaño
+// es impar, el último byte cuenta como palabra con el byte alto a cero
+uint64_t sumWords(const uint8_t* data, size_t size) {
+    uint64_t sum = 0;
+    size_t i = 0;
+#ifdef CPP20_LINKER_HAS_SSE2
+    // PSADBW contra cero suma bytes en dos carriles de 64 bits: por
+    // separado los bytes bajos y los altos de cada palabra
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lowMask = _mm_set1_epi16(0x00FF);
+    __m128i low = zero;
+    __m128i high = zero;
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        low = _mm_add_epi64(low, _mm_sad_epu8(_mm_and_si128(v, lowMask), zero));
+        high = _mm_add_epi64(high, _mm_sad_epu8(_mm_srli_epi16(v, 8), zero));
+    }
+    alignas(16) uint64_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), low);
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes + 2), high);
+    sum = lanes[0] + lanes[1] + ((lanes[2] + lanes[3]) << 8);
+#endif
+    for (; i + 1 < size; i += 2) {
+        sum += static_cast<uint64_t>(data[i]) | static_cast<uint64_t>(data[i + 1]) << 8;
+    }
+    if (i < size) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+// Se enlaza salvo que esté descartada o sea solo información para el linker
+bool isLinkedSection(const SectionInfo& section) {
+    return !section.discarded &&
+           !(section.characteristics & (coff::IMAGE_SCN_LNK_REMOVE | coff::IMAGE_SCN_LNK_INFO));
+}
+
+// Las agrupadas (".text$mn") van a la sección de antes del '$'
+std::string sectionGroupName(const SectionInfo& section) {
+    return section.name.substr(0, section.name.find('$'));
+}
+
+// IMAGE_SCN_ALIGN_* de la sección de entrada
+uint32_t sectionAlignment(const SectionInfo& section) {
+    uint32_t alignShift = (section.characteristics & kAlignMask) >> 20;
+    return alignShift > 0 ? 1u << (alignShift - 1) : 1;
+}
+
+// Hueco de una sección de entrada en modo incremental: un 25% más, al menos 64 bytes
+uint32_t incrementalCapacity(uint32_t size) {
+    return size + std::max(size / 4, 64u);
+}
+
+// Trozo con bytes que copiar; en modo incremental también los vacíos, para limpiar su hueco
+bool contributesBytes(const SectionInfo& section, bool incremental) {
+    return !section.isBSS && (incremental || !section.contents.empty() || !section.relocations.empty());
+}
+
+// Nombre de DLL sin extensión, como en __IMPORT_DESCRIPTOR_<dll>
+std::string dllStem(std::string_view dllName) {
+    return std::string(dllName.substr(0, dllName.rfind('.')));
+}
+
+/**
+ * @brief Objeto COFF que el linker genera para las tablas de importación
+ *
+ * Las referencias dentro del objeto van contra el símbolo de la sección
+ * destino, con el desplazamiento en los propios bytes.
+ */
+struct ImportObjectBuilder {
+    coff::COFFObject object;
+    std::vector<uint32_t> sectionSymbols;
+
+    size_t addSection(const std::string& name, uint32_t characteristics) {
+        object.addSection(coff::COFFSection(name, characteristics));
+        coff::COFFSymbol symbol(name, coff::IMAGE_SYM_CLASS_STATIC);
+        symbol.sectionNumber = static_cast<int16_t>(object.sections.size());
+        object.addSymbol(std::move(symbol));
+        sectionSymbols.push_back(static_cast<uint32_t>(object.symbols.size() - 1));
+        return object.sections.size() - 1;
+    }
+
+    // Externo por nombre; lo crea sin definir si aún no existe
+    uint32_t external(const std::string& name) {
+        for (size_t i = 0; i < object.symbols.size(); ++i) {
+            if (object.symbols[i].storageClass == coff::IMAGE_SYM_CLASS_EXTERNAL && object.symbols[i].name == name) {
+                return static_cast<uint32_t>(i);
+            }
+        }
+        object.addSymbol(coff::COFFSymbol(name));
+        return static_cast<uint32_t>(object.symbols.size() - 1);
+    }
+
+    void define(const std::string& name, size_t section, uint32_t offset) {
+        coff::COFFSymbol& symbol = object.symbols[external(name)];
+        symbol.sectionNumber = static_cast<int16_t>(section + 1);
+        symbol.value = offset;
+    }
+
+    void put(size_t section, uint32_t offset, uint64_t value, size_t width) {
+        std::memcpy(object.sections[section].data.data() + offset, &value, width);
+    }
+
+    // Referencia en section+at a target+offset
+    void reference(size_t section, uint32_t at, uint16_t type, size_t target, uint32_t offset) {
+        put(section, at, offset, type == coff::IMAGE_REL_AMD64_ADDR64 ? 8 : 4);
+        object.sections[section].relocations.push_back({at, sectionSymbols[target], type});
+    }
+
+    void referenceSymbol(size_t section, uint32_t at, uint16_t type, const std::string& name) {
+        object.sections[section].relocations.push_back({at, external(name), type});
+    }
+
+    // Añade código y devuelve dónde empieza
+    uint32_t emit(size_t section, std::initializer_list<uint8_t> code) {
+        auto& data = object.sections[section].data;
+        uint32_t offset = static_cast<uint32_t>(data.size());
+        data.insert(data.end(), code);
+        return offset;
+    }
+};
+
+} // namespace
+
+// ============================================================================
+// GlobalSymbolTable - Implementación
+// ============================================================================
+
+GlobalSymbolTable::Key GlobalSymbolTable::makeKey(std::string_view name) {
+    return {name, std::hash<std::string_view>{}(name)};
+}
+
+void GlobalSymbolTable::insert(const SymbolInfo& symbol, uint32_t order) {
+    Key key = makeKey(symbol.name);
+    Shard& shard = shardFor(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+    auto [it, inserted] = shard.entries.try_emplace(key);
+    Entry& entry = it->second;
+    if (inserted) {
+        entry.symbol = symbol;
+        entry.order = order;
+        entry.definitions = symbol.isDefined ? 1 : 0;
+        return;
+    }
+
+    if (!symbol.isDefined) {
+        // Entre referencias se queda la primera, como en serie
+        if (!entry.symbol.isDefined && order < entry.order) {
+            entry.symbol = symbol;
+            entry.order = order;
+        }
+        return;
+    }
+
+    // Dos definiciones: conflicto; se usa la del último objeto
+    bool replace = !entry.symbol.isDefined || order > entry.order;
+    if (entry.symbol.isDefined) ++entry.definitions; else entry.definitions = 1;
+    if (replace) {
+        entry.symbol = symbol;
+        entry.order = order;
+    }
+}
+
+SymbolInfo* GlobalSymbolTable::find(std::string_view name) {
+    Key key = makeKey(name);
+    Shard& shard = shardFor(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    return it != shard.entries.end() ? &it->second.symbol : nullptr;
+}
+
+const SymbolInfo* GlobalSymbolTable::find(std::string_view name) const {
+    Key key = makeKey(name);
+    const Shard& shard = shardFor(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    return it != shard.entries.end() ? &it->second.symbol : nullptr;
+}
+
+std::vector<std::string_view> GlobalSymbolTable::conflicts() const {
+    std::vector<std::string_view> names;
+    for (const Shard& shard : shards_) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        for (const auto& [key, entry] : shard.entries) {
+            if (entry.definitions > 1) names.push_back(key.name);
+        }
+    }
+    return names;
+}
+
+size_t GlobalSymbolTable::size() const {
+    size_t total = 0;
+    for (const Shard& shard : shards_) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        total += shard.entries.size();
+    }
+    return total;
+}
+
+void GlobalSymbolTable::clear() {
+    for (Shard& shard : shards_) {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.entries.clear();
+    }
+}
+
 // ============================================================================
 // MiniLinker - Implementación
 // ============================================================================
@@ -36,10 +274,53 @@ bool MiniLinker::addObjectFile(const std::filesystem::path& objectFile) {
         return false;
     }
 
+    for (auto& symbol : objInfo.symbols) {
+        symbol.objectIndex = static_cast<uint32_t>(objectFiles_.size());
+    }
     objectFiles_.push_back(std::move(objInfo));
     return true;
 }
 
+bool MiniLinker::addObjectFiles(const std::vector<std::filesystem::path>& objectFiles) {
+    // Cada objeto se proyecta y analiza por separado; el orden final es el dado
+    std::vector<std::optional<ObjectFileInfo>> parsed(objectFiles.size());
+    common::utils::parallelFor(objectFiles.size(), jobs_, [&](size_t index) {
+        ObjectFileInfo objInfo(objectFiles[index]);
+        if (parseObjectFile(objInfo) && checkObjectCompatibility(objInfo)) {
+            parsed[index] = std::move(objInfo);
+        }
+    });
+
+    return appendParsedObjects(parsed);
+}
+
+bool MiniLinker::addObjectImages(std::vector<ObjectImage> images) {
+    std::vector<std::optional<ObjectFileInfo>> parsed(images.size());
+    common::utils::parallelFor(images.size(), jobs_, [&](size_t index) {
+        auto bytes = std::make_shared<const std::vector<uint8_t>>(std::move(images[index].bytes));
+        ObjectFileInfo objInfo(images[index].name);
+        if (COFFReader::readObject(bytes, *bytes, objInfo) && checkObjectCompatibility(objInfo)) {
+            parsed[index] = std::move(objInfo);
+        }
+    });
+    return appendParsedObjects(parsed);
+}
+
+bool MiniLinker::appendParsedObjects(std::vector<std::optional<ObjectFileInfo>>& parsed) {
+    bool allAdded = true;
+    for (auto& objInfo : parsed) {
+        if (!objInfo) {
+            allAdded = false;
+            continue;
+        }
+        for (auto& symbol : objInfo->symbols) {
+            symbol.objectIndex = static_cast<uint32_t>(objectFiles_.size());
+        }
+        objectFiles_.push_back(std::move(*objInfo));
+    }
+    return allAdded;
+}
+
 bool MiniLinker::addLibrary(const std::filesystem::path& libraryFile) {
     return parseLibraryFile(libraryFile);
 }
@@ -64,30 +345,123 @@ void MiniLinker::setOptimize(bool optimize) {
     optimize_ = optimize;
 }
 
+void MiniLinker::setJobs(size_t jobs) {
+    jobs_ = std::max<size_t>(1, jobs);
+}
+
+void MiniLinker::setIncremental(bool incremental) {
+    incremental_ = incremental;
+}
+
+void MiniLinker::setLTOOptimizationLevel(int level) {
+    ltoOptimizationLevel_ = level;
+}
+
+void MiniLinker::setProfile(std::shared_ptr<const ir::ProfileData> profile) {
+    profile_ = std::move(profile);
+}
+
+void MiniLinker::setCodeCache(std::shared_ptr<MachineCodeCache> cache) {
+    codeCache_ = std::move(cache);
+}
+
+void MiniLinker::setTarget(const CPUFeatures& features, Microarchitecture tune) {
+    targetFeatures_ = features;
+    tune_ = tune;
+}
+
+void MiniLinker::setFunctionOrder(std::vector<std::string> symbols) {
+    functionOrder_ = std::move(symbols);
+}
+
+void MiniLinker::addDelayLoad(const std::string& dllName) {
+    std::string lower(dllName);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+    delayLoads_.insert(std::move(lower));
+}
+
+bool MiniLinker::loadOrderFile(const std::filesystem::path& orderFile) {
+    std::ifstream file(orderFile);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    struct Entry {
+        std::string symbol;
+        uint64_t count;
+    };
+    std::vector<Entry> entries;
+    bool hasCounts = false;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        Entry entry{{}, 0};
+        if (!(fields >> entry.symbol) || entry.symbol[0] == '#') continue;
+        hasCounts = (fields >> entry.count) || hasCounts;
+        entries.push_back(std::move(entry));
+    }
+
+    // Perfil: lo más ejecutado primero; a igual recuento, el orden del archivo
+    if (hasCounts) {
+        std::stable_sort(entries.begin(), entries.end(),
+                         [](const Entry& a, const Entry& b) { return a.count > b.count; });
+    }
+    functionOrder_.clear();
+    for (auto& entry : entries) {
+        functionOrder_.push_back(std::move(entry.symbol));
+    }
+    return true;
+}
+
 LinkResult MiniLinker::link(const std::filesystem::path& outputFile) {
     LinkResult result;
     result.outputFile = outputFile;
 
     try {
-        // Paso 1: Construir tabla de símbolos global
+        // Paso 0: Código de los objetos de -flto y miembros de biblioteca que definen lo que falta
+        if (!runLinkTimeOptimization(result.errorMessage)) {
+            return result;
+        }
+        loadLibraryMembers();
+
+        // Tablas de importación; __delayLoadHelper2 puede traer más importaciones
+        synthesizeImports(true);
+        if (delayLoadedDlls_ > 0) {
+            loadLibraryMembers();
+        }
+        synthesizeImports(false);
+
+        // Paso 1: Una copia de cada COMDAT (inline, plantillas)
+        std::string duplicate;
+        if (!foldComdatSections(duplicate)) {
+            result.errorMessage = "Símbolo '" + describeSymbol(duplicate) + "' definido en varios objetos";
+            return result;
+        }
+
+        // Paso 2: Construir tabla de símbolos global
         buildGlobalSymbolTable();
 
-        // Paso 2: Resolver símbolos
+        // Paso 3: Resolver símbolos
         if (!resolveSymbols()) {
             result.errorMessage = "Error resolviendo símbolos";
             return result;
         }
 
-        // Paso 3: Combinar secciones
-        combineSections();
-
-        // Paso 4: Aplicar relocations
-        if (!applyRelocations()) {
-            result.errorMessage = "Error aplicando relocations";
-            return result;
+        // Paso 4: Quitar las funciones que nadie referencia
+        if (optimize_) {
+            removeUnreferencedSections();
+            foldIdenticalSections();
         }
 
-        // Paso 5: Asignar direcciones virtuales
+        // Paso 5: Combinar secciones (o conservar el layout del enlace
+        // incremental anterior) y asignar direcciones virtuales
+        IncrementalDatabase previous;
+        std::vector<bool> changedObjects;
+        bool patching = incremental_ && previous.read(IncrementalDatabase::pathFor(outputFile)) &&
+                        reusePreviousLayout(previous, outputFile, changedObjects);
+        if (!patching) {
+            combineSections();
+        }
         assignVirtualAddresses();
 
         // Paso 6: Obtener RVA del entry point
@@ -104,13 +478,30 @@ LinkResult MiniLinker::link(const std::filesystem::path& outputFile) {
         auto exportDirectory = createExportDirectory();
         auto baseRelocations = createBaseRelocations();
 
-        // Paso 8: Escribir archivo PE
-        if (!writePEFile(outputFile, peHeader, sectionTable, importDirectory,
-                        exportDirectory, baseRelocations)) {
-            result.errorMessage = "Error escribiendo archivo PE";
+        // Si cambia el número de relocations base cambia el tamaño del
+        // archivo: se reescribe entero, aunque con el mismo layout
+        size_t headersSize = PEWriter::createDOSStub().size() + peHeader.size() + sectionTable.size();
+        size_t trailerSize = importDirectory.size() + exportDirectory.size() + baseRelocations.size();
+        patching = patching && imageFileSize(headersSize, trailerSize) == previous.fileSize;
+
+        // Paso 8: Escribir archivo PE (o solo lo que cambió) y aplicar relocations sobre él
+        patchedContributions_ = 0;
+        bool written = patching
+            ? patchPEFile(outputFile, peHeader, sectionTable, baseRelocations, previous, changedObjects)
+            : writePEFile(outputFile, peHeader, sectionTable, importDirectory, exportDirectory, baseRelocations);
+        if (!written) {
+            result.errorMessage = "Error escribiendo archivo PE o aplicando relocations";
             return result;
         }
 
+        // Un .ilk de otro layout no debe servir para parchear esta salida
+        std::error_code removeError;
+        if (!incremental_) {
+            std::filesystem::remove(IncrementalDatabase::pathFor(outputFile), removeError);
+        } else if (!captureLayout(outputFile).write(IncrementalDatabase::pathFor(outputFile))) {
+            result.warnings.push_back("No se pudo guardar la base de datos del enlace incremental");
+        }
+
         // Paso 9: Actualizar estadísticas
         updateStatistics();
 
@@ -119,11 +510,11 @@ LinkResult MiniLinker::link(const std::filesystem::path& outputFile) {
         result.imageSize = calculateImageSize();
 
         // Llenar mapa de direcciones de símbolos
-        for (const auto& [name, symbol] : globalSymbols_) {
+        globalSymbols_.forEach([&](const SymbolInfo& symbol) {
             if (symbol.isDefined) {
-                result.symbolAddresses[name] = symbol.value;
+                result.symbolAddresses[std::string(symbol.name)] = symbol.value;
             }
-        }
+        });
 
     } catch (const std::exception& e) {
         result.errorMessage = std::string("Excepción durante linking: ") + e.what();
@@ -136,6 +527,10 @@ std::vector<std::string> MiniLinker::getUndefinedSymbols() const {
     return SymbolResolver::findUndefinedSymbols(globalSymbols_);
 }
 
+mangling::SymbolIndex MiniLinker::getUndefinedSymbolIndex() const {
+    return mangling::SymbolIndex::build(getUndefinedSymbols(), jobs_);
+}
+
 std::unordered_map<std::string, size_t> MiniLinker::getLinkStatistics() const {
     return {
         {"total_symbols", totalSymbols_},
@@ -143,7 +538,16 @@ std::unordered_map<std::string, size_t> MiniLinker::getLinkStatistics() const {
         {"undefined_symbols", totalSymbols_ - resolvedSymbols_},
         {"total_relocations", totalRelocations_},
         {"object_files", objectFiles_.size()},
-        {"combined_sections", combinedSections_.size()}
+        {"combined_sections", combinedSections_.size()},
+        {"discarded_sections", discardedSections_},
+        {"loaded_members", loadedMembers_},
+        {"patched_contributions", patchedContributions_},
+        {"folded_sections", foldedSections_},
+        {"lto_modules", ltoModules_},
+        {"lto_partitions", ltoPartitions_},
+        {"lto_cached_functions", ltoCachedFunctions_},
+        {"imported_dlls", importedDlls_},
+        {"delay_loaded_dlls", delayLoadedDlls_}
     };
 }
 
@@ -152,143 +556,967 @@ void MiniLinker::clear() {
     globalSymbols_.clear();
     combinedSections_.clear();
     imports_.clear();
+    libraries_.clear();
+    importedSymbols_.clear();
 
     totalSymbols_ = 0;
     resolvedSymbols_ = 0;
     totalRelocations_ = 0;
+    discardedSections_ = 0;
+    loadedMembers_ = 0;
+    patchedContributions_ = 0;
+    foldedSections_ = 0;
+    ltoModules_ = 0;
+    ltoPartitions_ = 0;
+    ltoCachedFunctions_ = 0;
+    importedDlls_ = 0;
+    delayLoadedDlls_ = 0;
+    dataDirectories_ = {};
 }
 
 bool MiniLinker::parseObjectFile(ObjectFileInfo& objInfo) {
     return COFFReader::readObjectFile(objInfo.path, objInfo);
 }
 
+bool MiniLinker::runLinkTimeOptimization(std::string& error) {
+    LinkTimeOptimizer optimizer(ltoOptimizationLevel_);
+    optimizer.setProfile(profile_.get());
+    optimizer.setCodeCache(codeCache_.get());
+    optimizer.setTarget(targetFeatures_, tune_);
+    for (const auto& object : objectFiles_) {
+        for (const auto& section : object.sections) {
+            if (section.name == IRSectionName && !optimizer.addModule(section.contents, object.path.string())) {
+                error = optimizer.getLastError();
+                return false;
+            }
+        }
+    }
+    if (optimizer.empty()) {
+        return true;
+    }
+
+    optimizer.optimize();
+    std::vector<ObjectImage> images;
+    if (!optimizer.generateObjects(jobs_, images)) {
+        error = optimizer.getLastError();
+        return false;
+    }
+    if (!addObjectImages(std::move(images))) {
+        error = "No se pudieron añadir los objetos generados por LTO";
+        return false;
+    }
+
+    ltoModules_ = optimizer.getStatistics().modules;
+    ltoPartitions_ = optimizer.getStatistics().partitions;
+    ltoCachedFunctions_ = optimizer.getStatistics().cachedFunctions;
+    return true;
+}
+
 bool MiniLinker::parseLibraryFile(const std::filesystem::path& libraryFile) {
-    // En una implementación real, aquí se parsearía archivos .lib
-    // Por simplicidad, asumimos que es válido
+    LibraryInfo library(libraryFile);
+    library.mapping = common::utils::MappedFile::open(libraryFile);
+    if (library.mapping) {
+        std::span<const uint8_t> data(reinterpret_cast<const uint8_t*>(library.mapping->data()),
+                                      library.mapping->size());
+        if (ArchiveReader::readSymbolIndex(data, library.symbolIndex)) {
+            libraries_.push_back(std::move(library));
+            return true;
+        }
+    }
+
+    // Sin índice de símbolos: se toma como nombre de la DLL
     ImportInfo import(libraryFile.filename().string());
     imports_.push_back(import);
     return true;
 }
 
+void MiniLinker::loadLibraryMembers() {
+    std::unordered_set<std::string_view> defined;
+    std::vector<std::string_view> undefined;
+    size_t scanned = 0;
+
+    bool loadedAny = true;
+    while (loadedAny) {
+        loadedAny = false;
+
+        // Solo los objetos añadidos desde la vuelta anterior
+        for (; scanned < objectFiles_.size(); ++scanned) {
+            for (const auto& symbol : objectFiles_[scanned].symbols) {
+                if (symbol.storageClass != coff::IMAGE_SYM_CLASS_EXTERNAL) continue;
+                if (symbol.isDefined) {
+                    defined.insert(symbol.name);
+                } else {
+                    undefined.push_back(symbol.name);
+                }
+            }
+        }
+
+        std::vector<std::string_view> pending;
+        for (std::string_view name : undefined) {
+            if (defined.contains(name) || importedSymbols_.contains(name)) continue;
+
+            bool found = false;
+            for (auto& library : libraries_) {
+                auto entry = std::lower_bound(library.symbolIndex.begin(), library.symbolIndex.end(), name,
+                                              [](const ArchiveSymbol& s, std::string_view n) { return s.name < n; });
+                if (entry == library.symbolIndex.end() || entry->name != name) continue;
+                found = true;
+
+                std::span<const uint8_t> data(reinterpret_cast<const uint8_t*>(library.mapping->data()),
+                                              library.mapping->size());
+                std::span<const uint8_t> member = ArchiveReader::memberAt(data, entry->memberOffset);
+                bool firstLoad = library.loadedMembers.insert(entry->memberOffset).second;
+
+                std::string_view importName, dllName;
+                uint16_t hint = 0;
+                if (ArchiveReader::readImportObject(member, importName, dllName, hint)) {
+                    // Tanto "f" como "__imp_f" apuntan al mismo miembro
+                    importedSymbols_.insert(name);
+                    if (firstLoad) {
+                        auto import = std::find_if(imports_.begin(), imports_.end(),
+                                                   [&](const ImportInfo& i) { return i.dllName == dllName; });
+                        if (import == imports_.end()) {
+                            imports_.emplace_back(std::string(dllName));
+                            import = std::prev(imports_.end());
+                        }
+                        import->functionNames.emplace_back(importName);
+                        import->hintOrdinals.push_back(hint);
+                        ++loadedMembers_;
+                    }
+                } else if (firstLoad) {
+                    ObjectFileInfo objInfo(library.path);
+                    if (COFFReader::readObject(library.mapping, member, objInfo) &&
+                        checkObjectCompatibility(objInfo)) {
+                        for (auto& symbol : objInfo.symbols) {
+                            symbol.objectIndex = static_cast<uint32_t>(objectFiles_.size());
+                        }
+                        objectFiles_.push_back(std::move(objInfo));
+                        ++loadedMembers_;
+                        loadedAny = true;
+                    }
+                }
+                break;
+            }
+            if (!found) pending.push_back(name);
+        }
+        undefined.swap(pending);
+    }
+}
+
+void MiniLinker::synthesizeImports(bool delayLoaded) {
+    using namespace coff;
+
+    // Primer uso de cada función: orden de la primera relocación contra f o __imp_f
+    std::unordered_map<std::string_view, size_t> firstUse;
+    for (const auto& object : objectFiles_) {
+        for (const auto& section : object.sections) {
+            for (const auto& reloc : section.relocations) {
+                std::string_view name = reloc.symbolName;
+                if (!importedSymbols_.contains(name)) continue;
+                if (name.starts_with("__imp_")) name.remove_prefix(6);
+                firstUse.try_emplace(name, firstUse.size());
+            }
+        }
+    }
+
+    struct Function {
+        std::string name;
+        uint16_t hint;
+        size_t rank;
+    };
+    struct Dll {
+        std::string name;
+        std::vector<Function> functions;
+        size_t rank = SIZE_MAX;
+    };
+    std::vector<Dll> dlls;
+    for (auto& import : imports_) {
+        std::string lower(import.dllName);
+        std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+        import.delayLoaded = delayLoads_.contains(lower);
+        if (import.delayLoaded != delayLoaded || import.functionNames.empty()) continue;
+
+        Dll dll{import.dllName, {}};
+        for (size_t i = 0; i < import.functionNames.size(); ++i) {
+            auto use = firstUse.find(import.functionNames[i]);
+            size_t rank = use == firstUse.end() ? SIZE_MAX : use->second;
+            dll.functions.push_back({import.functionNames[i], import.hintOrdinals[i], rank});
+            dll.rank = std::min(dll.rank, rank);
+        }
+        std::stable_sort(dll.functions.begin(), dll.functions.end(),
+                         [](const Function& a, const Function& b) { return a.rank < b.rank; });
+        dlls.push_back(std::move(dll));
+    }
+    std::stable_sort(dlls.begin(), dlls.end(), [](const Dll& a, const Dll& b) { return a.rank < b.rank; });
+    (delayLoaded ? delayLoadedDlls_ : importedDlls_) = dlls.size();
+    if (dlls.empty()) {
+        return;
+    }
+
+    ImportObjectBuilder builder;
+    size_t text = builder.addSection(".text", IMAGE_SCN_CNT_CODE | IMAGE_SCN_MEM_EXECUTE | IMAGE_SCN_MEM_READ |
+                                                  IMAGE_SCN_ALIGN_16BYTES);
+    size_t tables = builder.addSection(delayLoaded ? ".didat" : ".idata",
+                                       IMAGE_SCN_CNT_INITIALIZED_DATA | IMAGE_SCN_MEM_READ | IMAGE_SCN_MEM_WRITE |
+                                           IMAGE_SCN_ALIGN_8BYTES);
+
+    // Descriptores con uno a cero de terminador, el HMODULE de cada DLL
+    // diferida, las IAT seguidas, las listas de nombres (ILT o INT) y las cadenas
+    uint32_t descriptorSize = delayLoaded ? 32 : 20;
+    uint32_t offset = static_cast<uint32_t>(dlls.size() + 1) * descriptorSize;
+    std::vector<uint32_t> module(dlls.size()), iat(dlls.size()), names(dlls.size()), dllName(dlls.size());
+    std::vector<std::vector<uint32_t>> hintName(dlls.size());
+    for (size_t d = 0; delayLoaded && d < dlls.size(); ++d) {
+        module[d] = offset;
+        offset += 8;
+    }
+    uint32_t iatStart = offset;
+    for (size_t d = 0; d < dlls.size(); ++d) {
+        iat[d] = offset;
+        offset += static_cast<uint32_t>(dlls[d].functions.size() + 1) * 8;
+    }
+    uint32_t iatSize = offset - iatStart;
+    for (size_t d = 0; d < dlls.size(); ++d) {
+        names[d] = offset;
+        offset += static_cast<uint32_t>(dlls[d].functions.size() + 1) * 8;
+    }
+    for (size_t d = 0; d < dlls.size(); ++d) {
+        for (const Function& function : dlls[d].functions) {
+            hintName[d].push_back(offset);
+            offset += (static_cast<uint32_t>(function.name.size()) + 4) & ~1u;     // Hint, nombre, '\0' y par
+        }
+    }
+    for (size_t d = 0; d < dlls.size(); ++d) {
+        dllName[d] = offset;
+        offset += static_cast<uint32_t>(dlls[d].name.size()) + 1;
+    }
+    auto& data = builder.object.sections[tables].data;
+    data.resize(offset);
+    for (size_t d = 0; d < dlls.size(); ++d) {
+        for (size_t i = 0; i < dlls[d].functions.size(); ++i) {
+            builder.put(tables, hintName[d][i], dlls[d].functions[i].hint, 2);
+            std::memcpy(data.data() + hintName[d][i] + 2, dlls[d].functions[i].name.data(),
+                        dlls[d].functions[i].name.size());
+        }
+        std::memcpy(data.data() + dllName[d], dlls[d].name.data(), dlls[d].name.size());
+    }
+
+    // f: jmp qword ptr [rip + __imp_f], solo si el código llama a f directamente
+    auto jumpThunks = [&](size_t d) {
+        for (size_t i = 0; i < dlls[d].functions.size(); ++i) {
+            if (!importedSymbols_.contains(dlls[d].functions[i].name)) continue;
+            uint32_t at = builder.emit(text, {0xFF, 0x25, 0, 0, 0, 0});
+            builder.define(dlls[d].functions[i].name, text, at);
+            builder.reference(text, at + 2, IMAGE_REL_AMD64_REL32, tables, iat[d] + static_cast<uint32_t>(i) * 8);
+        }
+    };
+
+    for (size_t d = 0; d < dlls.size(); ++d) {
+        uint32_t descriptor = static_cast<uint32_t>(d) * descriptorSize;
+        if (!delayLoaded) {
+            // IMAGE_IMPORT_DESCRIPTOR: ILT, fecha, forwarder, nombre e IAT
+            builder.define("__IMPORT_DESCRIPTOR_" + dllStem(dlls[d].name), tables, descriptor);
+            builder.reference(tables, descriptor, IMAGE_REL_AMD64_ADDR32NB, tables, names[d]);
+            builder.reference(tables, descriptor + 12, IMAGE_REL_AMD64_ADDR32NB, tables, dllName[d]);
+            builder.reference(tables, descriptor + 16, IMAGE_REL_AMD64_ADDR32NB, tables, iat[d]);
+            for (size_t i = 0; i < dlls[d].functions.size(); ++i) {
+                uint32_t entry = static_cast<uint32_t>(i) * 8;
+                builder.define("__imp_" + dlls[d].functions[i].name, tables, iat[d] + entry);
+                builder.reference(tables, iat[d] + entry, IMAGE_REL_AMD64_ADDR32NB, tables, hintName[d][i]);
+                builder.reference(tables, names[d] + entry, IMAGE_REL_AMD64_ADDR32NB, tables, hintName[d][i]);
+            }
+            jumpThunks(d);
+            continue;
+        }
+
+        // ImgDelayDescr: atributos (RVA), nombre, HMODULE, IAT e INT
+        builder.define("__DELAY_IMPORT_DESCRIPTOR_" + dllStem(dlls[d].name), tables, descriptor);
+        builder.put(tables, descriptor, 1, 4);
+        builder.reference(tables, descriptor + 4, IMAGE_REL_AMD64_ADDR32NB, tables, dllName[d]);
+        builder.reference(tables, descriptor + 8, IMAGE_REL_AMD64_ADDR32NB, tables, module[d]);
+        builder.reference(tables, descriptor + 12, IMAGE_REL_AMD64_ADDR32NB, tables, iat[d]);
+        builder.reference(tables, descriptor + 16, IMAGE_REL_AMD64_ADDR32NB, tables, names[d]);
+
+        // Mezcla de la DLL: guarda los argumentos (RCX, RDX, R8, R9 y XMM0-XMM3),
+        // __delayLoadHelper2(descriptor, entrada de la IAT) carga la DLL y
+        // escribe la entrada, y se salta a la dirección que devuelve
+        auto& code = builder.object.sections[text].data;
+        code.resize((code.size() + 15) & ~size_t{15}, 0xCC);
+        uint32_t merge = builder.emit(text, {
+            0x51, 0x52, 0x41, 0x50, 0x41, 0x51,         // push rcx; push rdx; push r8; push r9
+            0x48, 0x83, 0xEC, 0x68,                     // sub rsp, 0x68
+            0x66, 0x0F, 0x7F, 0x44, 0x24, 0x20,         // movdqa [rsp+0x20], xmm0
+            0x66, 0x0F, 0x7F, 0x4C, 0x24, 0x30,         // movdqa [rsp+0x30], xmm1
+            0x66, 0x0F, 0x7F, 0x54, 0x24, 0x40,         // movdqa [rsp+0x40], xmm2
+            0x66, 0x0F, 0x7F, 0x5C, 0x24, 0x50,         // movdqa [rsp+0x50], xmm3
+            0x48, 0x8B, 0xD0,                           // mov rdx, rax
+            0x48, 0x8D, 0x0D, 0, 0, 0, 0,               // lea rcx, [rip + descriptor]
+            0xE8, 0, 0, 0, 0,                           // call __delayLoadHelper2
+            0x66, 0x0F, 0x6F, 0x44, 0x24, 0x20,         // movdqa xmm0, [rsp+0x20]
+            0x66, 0x0F, 0x6F, 0x4C, 0x24, 0x30,
+            0x66, 0x0F, 0x6F, 0x54, 0x24, 0x40,
+            0x66, 0x0F, 0x6F, 0x5C, 0x24, 0x50,
+            0x48, 0x83, 0xC4, 0x68,                     // add rsp, 0x68
+            0x41, 0x59, 0x41, 0x58, 0x5A, 0x59,         // pop r9; pop r8; pop rdx; pop rcx
+            0xFF, 0xE0});                               // jmp rax
+        builder.reference(text, merge + 40, IMAGE_REL_AMD64_REL32, tables, descriptor);
+        builder.referenceSymbol(text, merge + 45, IMAGE_REL_AMD64_REL32, "__delayLoadHelper2");
+
+        // Hasta la primera llamada, cada entrada de la IAT apunta a su thunk de carga:
+        // lea rax, [rip + __imp_f]; jmp mezcla
+        for (size_t i = 0; i < dlls[d].functions.size(); ++i) {
+            const std::string& name = dlls[d].functions[i].name;
+            uint32_t entry = iat[d] + static_cast<uint32_t>(i) * 8;
+            uint32_t load = builder.emit(text, {0x48, 0x8D, 0x05, 0, 0, 0, 0, 0xE9, 0, 0, 0, 0});
+            builder.define("__imp_load_" + name, text, load);
+            builder.reference(text, load + 3, IMAGE_REL_AMD64_REL32, tables, entry);
+            builder.reference(text, load + 8, IMAGE_REL_AMD64_REL32, text, merge);
+
+            builder.define("__imp_" + name, tables, entry);
+            builder.reference(tables, entry, IMAGE_REL_AMD64_ADDR64, text, load);
+            builder.reference(tables, names[d] + static_cast<uint32_t>(i) * 8, IMAGE_REL_AMD64_ADDR32NB, tables,
+                              hintName[d][i]);
+        }
+        jumpThunks(d);
+    }
+
+    uint32_t directorySize = static_cast<uint32_t>(dlls.size() + 1) * descriptorSize;
+    if (delayLoaded) {
+        dataDirectories_[IMAGE_DIRECTORY_ENTRY_DELAY_IMPORT] =
+            {"__DELAY_IMPORT_DESCRIPTOR_" + dllStem(dlls[0].name), directorySize};
+    } else {
+        dataDirectories_[IMAGE_DIRECTORY_ENTRY_IMPORT] = {"__IMPORT_DESCRIPTOR_" + dllStem(dlls[0].name), directorySize};
+        dataDirectories_[IMAGE_DIRECTORY_ENTRY_IAT] = {"__imp_" + dlls[0].functions[0].name, iatSize};
+    }
+
+    ObjectImage image{delayLoaded ? "<delay imports>" : "<imports>", {}};
+    if (COFFWriter().writeObject(builder.object, image.bytes)) {
+        addObjectImages({std::move(image)});
+    }
+}
+
 void MiniLinker::buildGlobalSymbolTable() {
     globalSymbols_.clear();
 
-    // Añadir símbolos de runtime estándar
-    addRuntimeSymbols();
+    // Añadir símbolos de runtime estándar y los que importan las bibliotecas
+    addRuntimeSymbols();
+    for (std::string_view name : importedSymbols_) {
+        SymbolInfo info(name, 0, 0);
+        info.isExternal = true;
+        globalSymbols_.insert(info, 0);
+    }
+
+    // Procesar símbolos de cada archivo objeto; la tabla fusiona en paralelo
+    common::utils::parallelFor(objectFiles_.size(), jobs_, [&](size_t index) {
+        const auto& objFile = objectFiles_[index];
+        for (const auto& symbol : objFile.symbols) {
+            // Los locales (secciones, estáticos) no se ven desde otros objetos,
+            // y los de un COMDAT descartado los aporta la copia que se queda
+            if (symbol.storageClass != coff::IMAGE_SYM_CLASS_EXTERNAL) continue;
+            if (symbol.sectionNumber > 0 &&
+                objFile.sections[symbol.sectionNumber - 1].discarded) {
+                continue;
+            }
+            globalSymbols_.insert(symbol, static_cast<uint32_t>(index) + 1);
+        }
+    });
+
+    totalSymbols_ = globalSymbols_.size();
+}
+
+bool MiniLinker::resolveSymbols() {
+    // La tabla ya tiene la definición de cada objeto: lo que sigue sin
+    // definir no lo define ninguno
+    resolvedSymbols_ = 0;
+    globalSymbols_.forEach([&](const SymbolInfo& symbol) {
+        if (symbol.isDefined) resolvedSymbols_++;
+    });
+
+    // Verificar símbolos débiles
+    handleWeakSymbols();
+
+    // Verificar conflictos
+    return resolveSymbolConflicts();
+}
+
+bool MiniLinker::foldComdatSections(std::string& duplicate) {
+    using namespace coff;
+    std::unordered_map<std::string_view, SectionInfo*> chosen;
+
+    for (auto& objFile : objectFiles_) {
+        for (auto& section : objFile.sections) {
+            if (section.comdatSelection == 0 || section.comdatSelection == IMAGE_COMDAT_SELECT_ASSOCIATIVE) {
+                continue;
+            }
+
+            auto [it, inserted] = chosen.try_emplace(section.comdatSymbol, &section);
+            if (inserted) continue;
+
+            SectionInfo* kept = it->second;
+            switch (section.comdatSelection) {
+                case IMAGE_COMDAT_SELECT_NODUPLICATES:
+                    duplicate = std::string(section.comdatSymbol);
+                    return false;
+                case IMAGE_COMDAT_SELECT_SAME_SIZE:
+                    if (section.rawSize != kept->rawSize) {
+                        duplicate = std::string(section.comdatSymbol);
+                        return false;
+                    }
+                    break;
+                case IMAGE_COMDAT_SELECT_EXACT_MATCH:
+                    if (!std::ranges::equal(section.contents, kept->contents)) {
+                        duplicate = std::string(section.comdatSymbol);
+                        return false;
+                    }
+                    break;
+                case IMAGE_COMDAT_SELECT_LARGEST:
+                    if (section.rawSize > kept->rawSize) {
+                        kept->discarded = true;
+                        it->second = &section;
+                        continue;
+                    }
+                    break;
+                default: // IMAGE_COMDAT_SELECT_ANY
+                    break;
+            }
+            section.discarded = true;
+        }
+    }
+
+    // Las asociativas (.pdata/.xdata de la función) siguen a su sección
+    for (auto& objFile : objectFiles_) {
+        for (auto& section : objFile.sections) {
+            const SectionInfo* parent = &section;
+            while (parent->comdatSelection == IMAGE_COMDAT_SELECT_ASSOCIATIVE && !parent->discarded &&
+                   parent->associatedSection > 0 && parent->associatedSection <= objFile.sections.size() &&
+                   &objFile.sections[parent->associatedSection - 1] != parent) {
+                parent = &objFile.sections[parent->associatedSection - 1];
+            }
+            section.discarded = section.discarded || parent->discarded;
+        }
+    }
+
+    discardedSections_ = 0;
+    for (const auto& objFile : objectFiles_) {
+        discardedSections_ += std::count_if(objFile.sections.begin(), objFile.sections.end(),
+                                            [](const SectionInfo& s) { return s.discarded; });
+    }
+    return true;
+}
+
+void MiniLinker::removeUnreferencedSections() {
+    std::vector<std::vector<bool>> live(objectFiles_.size());
+    std::vector<std::vector<std::vector<size_t>>> associated(objectFiles_.size());
+    for (size_t i = 0; i < objectFiles_.size(); ++i) {
+        const auto& sections = objectFiles_[i].sections;
+        live[i].assign(sections.size(), false);
+        associated[i].resize(sections.size());
+        for (size_t j = 0; j < sections.size(); ++j) {
+            uint16_t parent = sections[j].associatedSection;
+            if (sections[j].comdatSelection == coff::IMAGE_COMDAT_SELECT_ASSOCIATIVE &&
+                parent > 0 && parent <= sections.size()) {
+                associated[i][parent - 1].push_back(j);
+            }
+        }
+    }
+
+    std::vector<std::pair<size_t, size_t>> worklist;
+    auto mark = [&](size_t object, size_t section) {
+        if (section >= live[object].size() || live[object][section] ||
+            objectFiles_[object].sections[section].discarded) {
+            return;
+        }
+        live[object][section] = true;
+        worklist.emplace_back(object, section);
+    };
+    auto markSymbol = [&](std::string_view name) {
+        const SymbolInfo* symbol = globalSymbols_.find(name);
+        if (!symbol || !symbol->isDefined || symbol->sectionNumber <= 0 ||
+            symbol->objectIndex >= objectFiles_.size()) {
+            return;
+        }
+        mark(symbol->objectIndex, static_cast<size_t>(symbol->sectionNumber - 1));
+    };
+
+    for (size_t i = 0; i < objectFiles_.size(); ++i) {
+        for (size_t j = 0; j < objectFiles_[i].sections.size(); ++j) {
+            if (objectFiles_[i].sections[j].comdatSelection == 0) mark(i, j);
+        }
+    }
+    markSymbol(entryPoint_);
+
+    while (!worklist.empty()) {
+        auto [object, section] = worklist.back();
+        worklist.pop_back();
+        for (const auto& reloc : objectFiles_[object].sections[section].relocations) {
+            if (reloc.targetSection > 0) {
+                mark(object, static_cast<size_t>(reloc.targetSection - 1));
+            } else {
+                markSymbol(reloc.symbolName);
+            }
+        }
+        for (size_t child : associated[object][section]) {
+            mark(object, child);
+        }
+    }
+
+    for (size_t i = 0; i < objectFiles_.size(); ++i) {
+        auto& sections = objectFiles_[i].sections;
+        for (size_t j = 0; j < sections.size(); ++j) {
+            if (!live[i][j] && !sections[j].discarded) {
+                sections[j].discarded = true;
+                ++discardedSections_;
+            }
+        }
+    }
+
+    // Lo definido en secciones descartadas deja de existir en la imagen
+    globalSymbols_.eraseIf([&](const SymbolInfo& symbol) {
+        return symbol.isDefined && symbol.sectionNumber > 0 && symbol.objectIndex < objectFiles_.size() &&
+               objectFiles_[symbol.objectIndex].sections[symbol.sectionNumber - 1].discarded;
+    });
+}
+
+void MiniLinker::foldIdenticalSections() {
+    using namespace coff;
+
+    // Candidatas: funciones y datos de solo lectura COMDAT enlazados, con sus secciones asociativas
+    struct Candidate {
+        uint32_t object;
+        uint32_t section;
+        std::vector<uint32_t> children;
+    };
+    std::vector<Candidate> candidates;
+    for (size_t i = 0; i < objectFiles_.size(); ++i) {
+        const auto& sections = objectFiles_[i].sections;
+        std::vector<int64_t> candidateOf(sections.size(), -1);
+        for (size_t j = 0; j < sections.size(); ++j) {
+            const SectionInfo& section = sections[j];
+            if (isLinkedSection(section) && section.comdatSelection != 0 &&
+                section.comdatSelection != IMAGE_COMDAT_SELECT_ASSOCIATIVE &&
+                ((section.characteristics & IMAGE_SCN_CNT_CODE) ||
+                 (section.characteristics & (IMAGE_SCN_CNT_INITIALIZED_DATA | IMAGE_SCN_MEM_WRITE)) ==
+                     IMAGE_SCN_CNT_INITIALIZED_DATA)) {
+                candidateOf[j] = static_cast<int64_t>(candidates.size());
+                candidates.push_back({static_cast<uint32_t>(i), static_cast<uint32_t>(j), {}});
+            }
+        }
+        for (size_t j = 0; j < sections.size(); ++j) {
+            uint16_t parent = sections[j].associatedSection;
+            if (isLinkedSection(sections[j]) && sections[j].comdatSelection == IMAGE_COMDAT_SELECT_ASSOCIATIVE &&
+                parent > 0 && parent <= sections.size() && candidateOf[parent - 1] >= 0) {
+                candidates[candidateOf[parent - 1]].children.push_back(static_cast<uint32_t>(j));
+            }
+        }
+    }
+    if (candidates.size() < 2) return;
+
+    // Sección que queda en lugar de una plegada
+    auto leader = [&](uint32_t object, uint32_t section) {
+        const SectionInfo* current = &objectFiles_[object].sections[section];
+        while (current->foldedObject >= 0) {
+            object = static_cast<uint32_t>(current->foldedObject);
+            section = current->foldedSection;
+            current = &objectFiles_[object].sections[section];
+        }
+        return std::pair{object, section};
+    };
+
+    auto appendValue = [](std::string& signature, auto value) {
+        signature.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+
+    // Firma: bytes, características y relocations; los destinos se
+    // canonizan para que dos copias que llaman a funciones ya plegadas
+    // (o a sí mismas) coincidan
+    auto appendSection = [&](std::string& signature, const Candidate& candidate, uint32_t section) {
+        const SectionInfo& info = objectFiles_[candidate.object].sections[section];
+        appendValue(signature, info.characteristics);
+        appendValue(signature, info.virtualSize);
+        appendValue(signature, info.contents.size());
+        signature.append(reinterpret_cast<const char*>(info.contents.data()), info.contents.size());
+        appendValue(signature, info.relocations.size());
+        for (const auto& reloc : info.relocations) {
+            appendValue(signature, reloc.virtualAddress);
+            appendValue(signature, reloc.type);
+            if (reloc.targetSection > 0) {
+                uint32_t target = static_cast<uint32_t>(reloc.targetSection - 1);
+                auto child = std::find(candidate.children.begin(), candidate.children.end(), target);
+                if (target == candidate.section) {
+                    signature += 'S';
+                } else if (child != candidate.children.end()) {
+                    signature += 'C';
+                    appendValue(signature, static_cast<uint32_t>(child - candidate.children.begin()));
+                } else {
+                    auto [object, kept] = leader(candidate.object, target);
+                    signature += 'L';
+                    appendValue(signature, object);
+                    appendValue(signature, kept);
+                    signature.append(reloc.symbolName);
+                    signature += '\0';
+                }
+                continue;
+            }
+
+            const SymbolInfo* symbol = globalSymbols_.find(reloc.symbolName);
+            if (!symbol || !symbol->isDefined || symbol->sectionNumber <= 0 ||
+                symbol->objectIndex >= objectFiles_.size()) {
+                signature += 'N';
+                signature.append(reloc.symbolName);
+                signature += '\0';
+                continue;
+            }
+            auto target = leader(symbol->objectIndex, static_cast<uint32_t>(symbol->sectionNumber - 1));
+            if (target == std::pair{candidate.object, candidate.section}) {
+                signature += 'S';
+            } else {
+                signature += 'G';
+                appendValue(signature, target.first);
+                appendValue(signature, target.second);
+            }
+            appendValue(signature, symbol->value);
+        }
+    };
+
+    std::vector<std::string> signatures(candidates.size());
+    bool folded = true;
+    while (folded) {
+        folded = false;
+        common::utils::parallelFor(candidates.size(), jobs_, [&](size_t index) {
+            const Candidate& candidate = candidates[index];
+            std::string& signature = signatures[index];
+            signature.clear();
+            if (objectFiles_[candidate.object].sections[candidate.section].foldedObject >= 0) return;
+            appendSection(signature, candidate, candidate.section);
+            appendValue(signature, candidate.children.size());
+            for (uint32_t child : candidate.children) {
+                appendSection(signature, candidate, child);
+            }
+        });
+
+        // La primera de cada grupo se queda; las demás (y sus asociativas) se descartan
+        std::unordered_map<std::string_view, size_t> kept;
+        for (size_t index = 0; index < candidates.size(); ++index) {
+            if (signatures[index].empty()) continue;
+            auto [it, inserted] = kept.try_emplace(signatures[index], index);
+            if (inserted) continue;
+
+            const Candidate& copy = candidates[index];
+            const Candidate& original = candidates[it->second];
+            auto foldInto = [&](uint32_t section, uint32_t keptSection) {
+                SectionInfo& info = objectFiles_[copy.object].sections[section];
+                info.discarded = true;
+                info.foldedObject = static_cast<int32_t>(original.object);
+                info.foldedSection = static_cast<uint16_t>(keptSection);
+                ++discardedSections_;
+            };
+            foldInto(copy.section, original.section);
+            for (size_t child = 0; child < copy.children.size(); ++child) {
+                foldInto(copy.children[child], original.children[child]);
+            }
+            ++foldedSections_;
+            folded = true;
+        }
+    }
+
+    // Los símbolos de las copias apuntan a la sección que se queda
+    globalSymbols_.forEach([&](SymbolInfo& symbol) {
+        if (!symbol.isDefined || symbol.sectionNumber <= 0 || symbol.objectIndex >= objectFiles_.size()) return;
+        auto [object, section] = leader(symbol.objectIndex, static_cast<uint32_t>(symbol.sectionNumber - 1));
+        symbol.objectIndex = object;
+        symbol.sectionNumber = static_cast<int16_t>(section + 1);
+    });
+}
+
+void MiniLinker::combineSections() {
+    using namespace coff;
+    std::unordered_map<std::string, size_t> sectionMap;
+    combinedSections_.clear();
+
+    // Orden de colocación: el de los objetos, salvo las secciones de las
+    // funciones de functionOrder_ (o del perfil), que van delante
+    struct Placement {
+        uint32_t object;
+        uint32_t section;
+        uint32_t rank;
+    };
+    std::vector<Placement> placements;
+    for (size_t i = 0; i < objectFiles_.size(); ++i) {
+        for (size_t j = 0; j < objectFiles_[i].sections.size(); ++j) {
+            if (isLinkedSection(objectFiles_[i].sections[j])) {
+                placements.push_back({static_cast<uint32_t>(i), static_cast<uint32_t>(j), UINT32_MAX});
+            }
+        }
+    }
+    std::vector<std::string> profileOrder;
+    if (functionOrder_.empty() && profile_) {
+        profileOrder = profile_->hotFunctionOrder();
+    }
+    const auto& functionOrder = functionOrder_.empty() ? profileOrder : functionOrder_;
+    if (!functionOrder.empty()) {
+        std::unordered_map<uint64_t, uint32_t> ranks;
+        for (uint32_t rank = 0; rank < functionOrder.size(); ++rank) {
+            const SymbolInfo* symbol = globalSymbols_.find(functionOrder[rank]);
+            if (!symbol || !symbol->isDefined || symbol->sectionNumber <= 0) continue;
+            uint64_t key = static_cast<uint64_t>(symbol->objectIndex) << 32 | (symbol->sectionNumber - 1);
+            ranks.try_emplace(key, rank);
+        }
+        for (auto& placement : placements) {
+            auto rank = ranks.find(static_cast<uint64_t>(placement.object) << 32 | placement.section);
+            if (rank != ranks.end()) placement.rank = rank->second;
+        }
+        std::stable_sort(placements.begin(), placements.end(),
+                         [](const Placement& a, const Placement& b) { return a.rank < b.rank; });
+    }
+
+    // Combinar secciones de todos los archivos objeto
+    for (const auto& placement : placements) {
+        uint32_t objectIndex = placement.object;
+        auto& section = objectFiles_[objectIndex].sections[placement.section];
+
+        auto [it, inserted] = sectionMap.try_emplace(sectionGroupName(section), combinedSections_.size());
+        if (inserted) {
+            combinedSections_.emplace_back(it->first);
+        }
+        auto& combined = combinedSections_[it->second];
+
+        // Respetar la alineación de cada contribución (IMAGE_SCN_ALIGN_*)
+        uint32_t alignment = sectionAlignment(section);
+        uint32_t offset = (combined.virtualSize + alignment - 1) & ~(alignment - 1);
+        section.outputOffset = offset;
+
+        // En modo incremental cada trozo deja hueco para crecer
+        uint32_t reserved = incremental_ ? incrementalCapacity(section.virtualSize) : section.virtualSize;
+        section.outputCapacity = reserved;
+
+        // Solo se anota el trozo: los bytes se copian al escribir
+        if (contributesBytes(section, incremental_)) {
+            section.outputContribution = static_cast<int32_t>(combined.contributions.size());
+            combined.contributions.push_back({offset, section.contents, {}, incremental_ ? reserved : 0,
+                                              objectIndex});
+            uint32_t end = offset + (incremental_ ? reserved : static_cast<uint32_t>(section.contents.size()));
+            combined.rawSize = std::max(combined.rawSize, end);
+        }
+
+        // Actualizar tamaño
+        combined.virtualSize = offset + reserved;
+
+        // Combinar características
+        combined.characteristics |= section.characteristics & ~(IMAGE_SCN_LNK_COMDAT | kAlignMask);
+        combined.isBSS = combined.isBSS || section.isBSS;
+    }
+
+    // Optimizar layout si está habilitado
+    if (optimize_) {
+        optimizeSectionLayout();
+    }
+
+    // Con el orden final: índice combinado de cada contribución
+    sectionMap.clear();
+    for (size_t i = 0; i < combinedSections_.size(); ++i) {
+        sectionMap[combinedSections_[i].name] = i;
+    }
+    for (auto& objFile : objectFiles_) {
+        for (auto& section : objFile.sections) {
+            if (isLinkedSection(section)) {
+                section.outputSection = static_cast<uint32_t>(sectionMap[sectionGroupName(section)]);
+            }
+        }
+    }
+
+    attachContributions();
+}
 
-    // Procesar símbolos de cada archivo objeto
+void MiniLinker::attachContributions() {
+    // Relocations de cada trozo (ajustar offsets); los destinos locales
+    // pasan a la sección combinada
     for (const auto& objFile : objectFiles_) {
-        for (const auto& symbol : objFile.symbols) {
-            auto it = globalSymbols_.find(symbol.name);
-
-            if (it == globalSymbols_.end()) {
-                // Nuevo símbolo
-                globalSymbols_[symbol.name] = symbol;
-            } else {
-                // Resolver conflictos
-                if (symbol.isDefined && !it->second.isDefined) {
-                    // Nuevo símbolo definido, reemplaza indefinido
-                    it->second = symbol;
-                } else if (symbol.isDefined && it->second.isDefined) {
-                    // Conflicto: dos definiciones
-                    // En un linker real, esto sería un error
-                    // Por simplicidad, usamos el último
-                    it->second = symbol;
+        for (const auto& section : objFile.sections) {
+            if (!isLinkedSection(section) || section.outputContribution < 0) continue;
+            auto& combined = combinedSections_[section.outputSection];
+            auto& contribution = combined.contributions[section.outputContribution];
+            for (const auto& reloc : section.relocations) {
+                RelocationInfo adjustedReloc = reloc;
+                adjustedReloc.virtualAddress += section.outputOffset;
+                if (reloc.targetSection > 0) {
+                    // Una sección plegada por ICF se sustituye por la que se queda
+                    const SectionInfo* folded = &objFile.sections[reloc.targetSection - 1];
+                    if (folded->foldedObject >= 0) {
+                        folded = &objectFiles_[folded->foldedObject].sections[folded->foldedSection];
+                    }
+                    const SectionInfo& target = *folded;
+                    if (!isLinkedSection(target)) continue;
+                    adjustedReloc.targetSection = static_cast<int16_t>(target.outputSection + 1);
+                    adjustedReloc.addend = target.outputOffset;
                 }
+                contribution.relocations.push_back(adjustedReloc);
             }
         }
     }
 
-    totalSymbols_ = globalSymbols_.size();
-}
+    // Símbolos definidos: desplazamiento dentro de su sección combinada
+    globalSymbols_.forEach([&](SymbolInfo& symbol) {
+        if (!symbol.isDefined || symbol.sectionNumber <= 0 || symbol.objectIndex >= objectFiles_.size()) return;
+        const SectionInfo& section = objectFiles_[symbol.objectIndex].sections[symbol.sectionNumber - 1];
+        symbol.value += section.outputOffset;
+        symbol.sectionNumber = static_cast<int16_t>(section.outputSection + 1);
+    });
+}
+
+bool MiniLinker::reusePreviousLayout(const IncrementalDatabase& previous, const std::filesystem::path& outputFile,
+                                     std::vector<bool>& changedObjects) {
+    std::error_code error;
+    if (previous.entryPoint != entryPoint_ || previous.imageBase != imageBase_ ||
+        previous.objects.size() != objectFiles_.size() ||
+        std::filesystem::file_size(outputFile, error) != previous.fileSize || error) {
+        return false;
+    }
 
-bool MiniLinker::resolveSymbols() {
-    // Resolver referencias cruzadas
-    for (auto& [name, symbol] : globalSymbols_) {
-        if (!symbol.isDefined && !symbol.isExternal) {
-            // Buscar en otros archivos objeto
-            for (const auto& objFile : objectFiles_) {
-                auto it = std::find_if(objFile.symbols.begin(), objFile.symbols.end(),
-                    [&name](const SymbolInfo& s) { return s.name == name && s.isDefined; });
-
-                if (it != objFile.symbols.end()) {
-                    symbol = *it;
-                    symbol.isDefined = true;
-                    resolvedSymbols_++;
-                    break;
-                }
+    // Mismos objetos y secciones enlazadas, y cada una cabe en su hueco
+    changedObjects.assign(objectFiles_.size(), false);
+    for (size_t i = 0; i < objectFiles_.size(); ++i) {
+        const auto& object = previous.objects[i];
+        if (object.path != objectFiles_[i].path.string()) return false;
+        auto size = std::filesystem::file_size(objectFiles_[i].path, error);
+        auto modified = std::filesystem::last_write_time(objectFiles_[i].path, error);
+        if (error) return false;
+        changedObjects[i] = size != object.size || modified.time_since_epoch().count() != object.modified;
+
+        size_t placement = 0;
+        for (const auto& section : objectFiles_[i].sections) {
+            if (!isLinkedSection(section)) continue;
+            if (placement >= object.placements.size()) return false;
+            const auto& place = object.placements[placement++];
+            if (place.outputSection >= previous.sections.size() ||
+                previous.sections[place.outputSection].name != sectionGroupName(section) ||
+                section.virtualSize > place.capacity || place.offset % sectionAlignment(section) != 0) {
+                return false;
             }
-        } else if (symbol.isDefined) {
-            resolvedSymbols_++;
         }
+        if (placement != object.placements.size()) return false;
     }
 
-    // Verificar símbolos débiles
-    handleWeakSymbols();
+    combinedSections_.clear();
+    for (const auto& previousSection : previous.sections) {
+        SectionInfo& combined = combinedSections_.emplace_back(previousSection.name);
+        combined.characteristics = previousSection.characteristics;
+        combined.virtualSize = previousSection.virtualSize;
+        combined.rawSize = previousSection.rawSize;
+        combined.isBSS = previousSection.isBSS;
+    }
+    for (size_t i = 0; i < objectFiles_.size(); ++i) {
+        size_t placement = 0;
+        for (auto& section : objectFiles_[i].sections) {
+            if (!isLinkedSection(section)) continue;
+            const auto& place = previous.objects[i].placements[placement++];
+            section.outputSection = place.outputSection;
+            section.outputOffset = place.offset;
+            section.outputCapacity = place.capacity;
+            if (contributesBytes(section, incremental_)) {
+                auto& contributions = combinedSections_[place.outputSection].contributions;
+                section.outputContribution = static_cast<int32_t>(contributions.size());
+                contributions.push_back(
+                    {place.offset, section.contents, {}, place.capacity, static_cast<uint32_t>(i)});
+            }
+        }
+    }
 
-    // Verificar conflictos
-    return resolveSymbolConflicts();
+    attachContributions();
+    return true;
 }
 
-void MiniLinker::combineSections() {
-    std::unordered_map<std::string, SectionInfo> sectionMap;
+IncrementalDatabase MiniLinker::captureLayout(const std::filesystem::path& outputFile) const {
+    IncrementalDatabase database;
+    database.entryPoint = entryPoint_;
+    database.imageBase = imageBase_;
+    std::error_code error;
+    database.fileSize = std::filesystem::file_size(outputFile, error);
 
-    // Combinar secciones de todos los archivos objeto
     for (const auto& objFile : objectFiles_) {
+        auto& object = database.objects.emplace_back();
+        object.path = objFile.path.string();
+        object.size = std::filesystem::file_size(objFile.path, error);
+        object.modified = std::filesystem::last_write_time(objFile.path, error).time_since_epoch().count();
         for (const auto& section : objFile.sections) {
-            auto it = sectionMap.find(section.name);
-
-            if (it == sectionMap.end()) {
-                // Nueva sección
-                sectionMap[section.name] = section;
-            } else {
-                // Combinar con sección existente
-                auto& combined = it->second;
-
-                // Concatenar datos
-                combined.data.insert(combined.data.end(),
-                                   section.data.begin(),
-                                   section.data.end());
-
-                // Combinar relocations (ajustar offsets)
-                uint32_t offset = combined.rawSize;
-                for (const auto& reloc : section.relocations) {
-                    RelocationInfo adjustedReloc = reloc;
-                    adjustedReloc.virtualAddress += offset;
-                    combined.relocations.push_back(adjustedReloc);
-                }
-
-                // Actualizar tamaño
-                combined.rawSize += section.rawSize;
-                combined.virtualSize += section.virtualSize;
-
-                // Combinar características
-                combined.characteristics |= section.characteristics;
-            }
+            if (!isLinkedSection(section)) continue;
+            object.placements.push_back({section.outputSection, section.outputOffset, section.outputCapacity});
         }
     }
 
-    // Convertir mapa a vector
-    combinedSections_.reserve(sectionMap.size());
-    for (auto& [name, section] : sectionMap) {
-        combinedSections_.push_back(std::move(section));
+    for (const auto& combined : combinedSections_) {
+        database.sections.push_back({combined.name, combined.characteristics, combined.virtualSize,
+                                     combined.rawSize, combined.isBSS});
+    }
+    globalSymbols_.forEach([&](const SymbolInfo& symbol) {
+        if (symbol.isDefined) database.symbols[std::string(symbol.name)] = symbol.value;
+    });
+    return database;
+}
+
+bool MiniLinker::writeContribution(const SectionInfo& section, size_t index, std::span<uint8_t> window,
+                                   uint32_t windowOffset) const {
+    const auto& contribution = section.contributions[index];
+    auto local = [&](size_t offset) { return window.data() + (offset - windowOffset); };
+    uint8_t fill = (section.characteristics & coff::IMAGE_SCN_CNT_CODE) ? 0xCC : 0x00;
+
+    // Relleno desde el trozo anterior (INT3 entre funciones) y los bytes del objeto
+    size_t gapBegin = windowOffset;
+    if (index > 0) {
+        const auto& previous = section.contributions[index - 1];
+        gapBegin = std::max<size_t>(gapBegin, previous.offset + std::max<size_t>(previous.bytes.size(),
+                                                                                 previous.reserved));
+    }
+    if (contribution.offset > gapBegin) {
+        std::memset(local(gapBegin), fill, contribution.offset - gapBegin);
+    }
+    if (!contribution.bytes.empty()) {
+        std::memcpy(local(contribution.offset), contribution.bytes.data(), contribution.bytes.size());
+    }
+    // Hueco incremental: lo que quede de una versión anterior más larga
+    if (contribution.reserved > contribution.bytes.size()) {
+        std::memset(local(contribution.offset + contribution.bytes.size()), fill,
+                    contribution.reserved - contribution.bytes.size());
     }
 
-    // Optimizar layout si está habilitado
-    if (optimize_) {
-        optimizeSectionLayout();
+    // Cada relocation toca bytes de su propio trozo
+    if (windowOffset == 0) {
+        return RelocationApplier::applySectionRelocations(window, contribution.relocations, globalSymbols_,
+                                                          combinedSections_, section.virtualAddress);
+    }
+    std::vector<RelocationInfo> relocations = contribution.relocations;
+    for (auto& reloc : relocations) {
+        reloc.virtualAddress -= windowOffset;
     }
+    return RelocationApplier::applySectionRelocations(window, relocations, globalSymbols_, combinedSections_,
+                                                      section.virtualAddress + windowOffset);
 }
 
-bool MiniLinker::applyRelocations() {
-    for (auto& section : combinedSections_) {
-        if (!RelocationApplier::applySectionRelocations(
-                section.data, section.relocations, globalSymbols_, combinedSections_)) {
-            return false;
+bool MiniLinker::writeSections(uint8_t* image, const std::vector<size_t>& rawOffsets) {
+    struct Task {
+        size_t section;
+        size_t contribution;
+    };
+    std::vector<Task> tasks;
+    for (size_t i = 0; i < combinedSections_.size(); ++i) {
+        for (size_t j = 0; j < combinedSections_[i].contributions.size(); ++j) {
+            tasks.push_back({i, j});
         }
-        totalRelocations_ += section.relocations.size();
     }
-    return true;
+
+    // Los trozos no se solapan en la salida: cada uno es una tarea independiente
+    std::atomic<bool> failed{false};
+    std::atomic<size_t> relocations{0};
+    common::utils::parallelFor(tasks.size(), jobs_, [&](size_t index) {
+        const auto& section = combinedSections_[tasks[index].section];
+        std::span<uint8_t> data(image + rawOffsets[tasks[index].section], section.rawSize);
+        if (!writeContribution(section, tasks[index].contribution, data, 0)) {
+            failed = true;
+        }
+        relocations += section.contributions[tasks[index].contribution].relocations.size();
+    });
+
+    totalRelocations_ += relocations;
+    return !failed;
 }
 
 void MiniLinker::assignVirtualAddresses() {
@@ -302,11 +1530,11 @@ void MiniLinker::assignVirtualAddresses() {
         currentRVA += section.virtualSize;
 
         // Actualizar símbolos que apuntan a esta sección
-        for (auto& [name, symbol] : globalSymbols_) {
-            if (symbol.sectionIndex == (&section - &combinedSections_[0] + 1)) {
+        globalSymbols_.forEach([&](SymbolInfo& symbol) {
+            if (symbol.sectionNumber == (&section - &combinedSections_[0] + 1)) {
                 symbol.value += section.virtualAddress;
             }
-        }
+        });
     }
 }
 
@@ -323,13 +1551,13 @@ std::vector<uint8_t> MiniLinker::createPEHeader(uint32_t entryPointRVA) {
 
     // COFF Header
     COFFHeader coffHeader = {};
-    coffHeader.machine = (machineType_ == "X64") ? 0x8664 : 0x014C;
-    coffHeader.numberOfSections = static_cast<uint16_t>(combinedSections_.size());
-    coffHeader.timeDateStamp = static_cast<uint32_t>(time(nullptr));
-    coffHeader.pointerToSymbolTable = 0;
-    coffHeader.numberOfSymbols = 0;
-    coffHeader.sizeOfOptionalHeader = 240; // PE32+
-    coffHeader.characteristics = 0x010F; // Executable, 32-bit, etc.
+    coffHeader.Machine = (machineType_ == "X64") ? 0x8664 : 0x014C;
+    coffHeader.NumberOfSections = static_cast<uint16_t>(combinedSections_.size());
+    coffHeader.TimeDateStamp = static_cast<uint32_t>(time(nullptr));
+    coffHeader.PointerToSymbolTable = 0;
+    coffHeader.NumberOfSymbols = 0;
+    coffHeader.SizeOfOptionalHeader = 240; // PE32+
+    coffHeader.Characteristics = 0x010F; // Executable, 32-bit, etc.
 
     const uint8_t* coffBytes = reinterpret_cast<const uint8_t*>(&coffHeader);
     header.insert(header.end(), coffBytes, coffBytes + sizeof(COFFHeader));
@@ -368,7 +1596,7 @@ std::vector<uint8_t> MiniLinker::createPEHeader(uint32_t entryPointRVA) {
     uint32_t win32VersionValue = 0;
     uint32_t sizeOfImage = imageSize;
     uint32_t sizeOfHeaders = 0x400; // Asumiendo tamaño estándar
-    uint32_t checkSum = 0; // Se calcula después
+    uint32_t checkSum = 0; // Se calcula al escribir la imagen (calculatePEChecksum)
     uint16_t subsystem = (subsystem_ == "WINDOWS") ? 2 : 3; // 2=GUI, 3=Console
     uint16_t dllCharacteristics = 0x8160; // NX, ASLR, etc.
     uint64_t sizeOfStackReserve = 0x100000;
@@ -399,6 +1627,7 @@ std::vector<uint8_t> MiniLinker::createPEHeader(uint32_t entryPointRVA) {
     header.insert(header.end(), reinterpret_cast<uint8_t*>(&win32VersionValue), reinterpret_cast<uint8_t*>(&win32VersionValue) + 4);
     header.insert(header.end(), reinterpret_cast<uint8_t*>(&sizeOfImage), reinterpret_cast<uint8_t*>(&sizeOfImage) + 4);
     header.insert(header.end(), reinterpret_cast<uint8_t*>(&sizeOfHeaders), reinterpret_cast<uint8_t*>(&sizeOfHeaders) + 4);
+    checksumOffset_ = header.size();
     header.insert(header.end(), reinterpret_cast<uint8_t*>(&checkSum), reinterpret_cast<uint8_t*>(&checkSum) + 4);
     header.insert(header.end(), reinterpret_cast<uint8_t*>(&subsystem), reinterpret_cast<uint8_t*>(&subsystem) + 2);
     header.insert(header.end(), reinterpret_cast<uint8_t*>(&dllCharacteristics), reinterpret_cast<uint8_t*>(&dllCharacteristics) + 2);
@@ -409,9 +1638,12 @@ std::vector<uint8_t> MiniLinker::createPEHeader(uint32_t entryPointRVA) {
     header.insert(header.end(), reinterpret_cast<uint8_t*>(&loaderFlags), reinterpret_cast<uint8_t*>(&loaderFlags) + 4);
     header.insert(header.end(), reinterpret_cast<uint8_t*>(&numberOfRvaAndSizes), reinterpret_cast<uint8_t*>(&numberOfRvaAndSizes) + 4);
 
-    // Data directories (16 entradas, todas cero por simplicidad)
-    for (int i = 0; i < 16 * 8; ++i) {
-        header.push_back(0);
+    // Data directories: las tablas que el linker genera (importaciones); el resto a cero
+    for (const DataDirectory& directory : dataDirectories_) {
+        uint32_t rva = directory.symbol.empty() ? 0 : getSymbolRVA(directory.symbol);
+        uint32_t size = rva != 0 ? directory.size : 0;
+        header.insert(header.end(), reinterpret_cast<uint8_t*>(&rva), reinterpret_cast<uint8_t*>(&rva) + 4);
+        header.insert(header.end(), reinterpret_cast<uint8_t*>(&size), reinterpret_cast<uint8_t*>(&size) + 4);
     }
 
     return header;
@@ -425,17 +1657,17 @@ std::vector<uint8_t> MiniLinker::createSectionTable() {
 
         // Copiar nombre (máximo 8 caracteres)
         std::string name = section.name.substr(0, 8);
-        std::memcpy(header.name, name.c_str(), name.size());
-
-        header.virtualSize = section.virtualSize;
-        header.virtualAddress = section.virtualAddress;
-        header.sizeOfRawData = section.rawSize;
-        header.pointerToRawData = 0; // Se calcula después
-        header.pointerToRelocations = 0;
-        header.pointerToLinenumbers = 0;
-        header.numberOfRelocations = 0;
-        header.numberOfLinenumbers = 0;
-        header.characteristics = section.characteristics;
+        std::memcpy(header.Name, name.c_str(), name.size());
+
+        header.Misc.VirtualSize = section.virtualSize;
+        header.VirtualAddress = section.virtualAddress;
+        header.SizeOfRawData = section.rawSize;
+        header.PointerToRawData = 0; // Se calcula después
+        header.PointerToRelocations = 0;
+        header.PointerToLinenumbers = 0;
+        header.NumberOfRelocations = 0;
+        header.NumberOfLinenumbers = 0;
+        header.Characteristics = section.characteristics;
 
         const uint8_t* headerBytes = reinterpret_cast<const uint8_t*>(&header);
         sectionTable.insert(sectionTable.end(), headerBytes, headerBytes + sizeof(SectionHeader));
@@ -445,9 +1677,7 @@ std::vector<uint8_t> MiniLinker::createSectionTable() {
 }
 
 std::vector<uint8_t> MiniLinker::createImportDirectory() {
-    // Simplificado: no implementamos import directory completo
-    // En un linker real, esto sería mucho más complejo
-    return std::vector<uint8_t>(20, 0); // Estructura mínima
+    return {};
 }
 
 std::vector<uint8_t> MiniLinker::createExportDirectory() {
@@ -456,8 +1686,51 @@ std::vector<uint8_t> MiniLinker::createExportDirectory() {
 }
 
 std::vector<uint8_t> MiniLinker::createBaseRelocations() {
-    // Simplificado: sin relocations base
-    return std::vector<uint8_t>();
+    using namespace coff;
+    std::vector<std::vector<uint8_t>> blocks(combinedSections_.size());
+    common::utils::parallelFor(combinedSections_.size(), jobs_, [&](size_t index) {
+        const SectionInfo& section = combinedSections_[index];
+
+        // RVA y tipo en un solo entero: ordenarlos agrupa por página
+        std::vector<uint64_t> fixups;
+        for (const auto& contribution : section.contributions) {
+            for (const auto& reloc : contribution.relocations) {
+                uint16_t type = reloc.type == IMAGE_REL_AMD64_ADDR64   ? IMAGE_REL_BASED_DIR64
+                                : reloc.type == IMAGE_REL_AMD64_ADDR32 ? IMAGE_REL_BASED_HIGHLOW
+                                                                       : IMAGE_REL_BASED_ABSOLUTE;
+                if (type != IMAGE_REL_BASED_ABSOLUTE) {
+                    fixups.push_back(static_cast<uint64_t>(section.virtualAddress + reloc.virtualAddress) << 4 | type);
+                }
+            }
+        }
+        std::sort(fixups.begin(), fixups.end());
+
+        auto& block = blocks[index];
+        auto put16 = [&](uint16_t value) {
+            block.push_back(static_cast<uint8_t>(value));
+            block.push_back(static_cast<uint8_t>(value >> 8));
+        };
+        for (size_t i = 0; i < fixups.size();) {
+            uint32_t page = static_cast<uint32_t>(fixups[i] >> 4) & ~(kPageSize - 1);
+            size_t start = block.size();
+            block.resize(start + sizeof(IMAGE_BASE_RELOCATION));
+            for (; i < fixups.size() && (static_cast<uint32_t>(fixups[i] >> 4) & ~(kPageSize - 1)) == page; ++i) {
+                put16(static_cast<uint16_t>((fixups[i] & 0xF) << 12 | ((fixups[i] >> 4) & (kPageSize - 1))));
+            }
+            if ((block.size() - start) % 4 != 0) {
+                put16(IMAGE_REL_BASED_ABSOLUTE);
+            }
+            IMAGE_BASE_RELOCATION header{page, static_cast<uint32_t>(block.size() - start)};
+            std::memcpy(block.data() + start, &header, sizeof(header));
+        }
+    });
+
+    // Las secciones van por RVA creciente: basta concatenar
+    std::vector<uint8_t> baseRelocations;
+    for (const auto& block : blocks) {
+        baseRelocations.insert(baseRelocations.end(), block.begin(), block.end());
+    }
+    return baseRelocations;
 }
 
 bool MiniLinker::writePEFile(const std::filesystem::path& outputFile,
@@ -467,19 +1740,181 @@ bool MiniLinker::writePEFile(const std::filesystem::path& outputFile,
                             const std::vector<uint8_t>& exportDirectory,
                             const std::vector<uint8_t>& baseRelocations) {
 
-    std::vector<std::vector<uint8_t>> sectionData;
+    // Mismas partes y orden que PEWriter::writePEFile, con el tamaño final conocido
+    auto dosStub = PEWriter::createDOSStub();
+    size_t headersSize = dosStub.size() + peHeader.size() + sectionTable.size();
+    std::vector<size_t> rawOffsets = rawSectionOffsets(headersSize);
+    size_t offset = imageFileSize(headersSize, 0);
+    size_t fileSize = offset + importDirectory.size() + exportDirectory.size() + baseRelocations.size();
+
+    // Sin proyección (sistema de archivos que no la admite): un buffer del tamaño final
+    auto output = common::utils::MappedOutputFile::create(outputFile, fileSize);
+    std::vector<uint8_t> buffer;
+    if (!output) {
+        buffer.resize(fileSize);
+    }
+    uint8_t* image = output ? reinterpret_cast<uint8_t*>(output->data()) : buffer.data();
+
+    size_t position = 0;
+    auto put = [&](const std::vector<uint8_t>& bytes) {
+        if (!bytes.empty()) {
+            std::memcpy(image + position, bytes.data(), bytes.size());
+        }
+        position += bytes.size();
+    };
+    put(dosStub);
+    put(peHeader);
+    put(sectionTable);
+
+    position = offset;
+    put(importDirectory);
+    put(exportDirectory);
+    put(baseRelocations);
+
+    // Cada trozo va de la proyección del objeto a su sitio en la salida
+    if (!writeSections(image, rawOffsets)) {
+        return false;
+    }
+
+    // Con la imagen completa ya se puede sumar
+    uint32_t checksum = calculatePEChecksum({image, fileSize}, dosStub.size() + checksumOffset_);
+    std::memcpy(image + dosStub.size() + checksumOffset_, &checksum, sizeof(checksum));
+
+    if (!output) {
+        std::ofstream file(outputFile, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        return file.good();
+    }
+    return true;
+}
+
+size_t MiniLinker::imageFileSize(size_t headersSize, size_t trailerSize) const {
+    std::vector<size_t> rawOffsets = rawSectionOffsets(headersSize);
+    size_t end = rawOffsets.empty() ? headersSize : rawOffsets.back() + combinedSections_.back().rawSize;
+    return end + trailerSize;
+}
+
+std::vector<size_t> MiniLinker::rawSectionOffsets(size_t headersSize) const {
+    std::vector<size_t> rawOffsets;
+    size_t offset = headersSize;
     for (const auto& section : combinedSections_) {
-        sectionData.push_back(section.data);
+        rawOffsets.push_back(offset);
+        offset += section.rawSize;
+    }
+    return rawOffsets;
+}
+
+bool MiniLinker::patchPEFile(const std::filesystem::path& outputFile,
+                             const std::vector<uint8_t>& peHeader,
+                             const std::vector<uint8_t>& sectionTable,
+                             const std::vector<uint8_t>& baseRelocations,
+                             const IncrementalDatabase& previous,
+                             const std::vector<bool>& changedObjects) {
+    // Símbolos cuya dirección no es la que quedó escrita en la imagen
+    std::unordered_set<std::string_view> moved;
+    for (const auto& [name, value] : previous.symbols) {
+        const SymbolInfo* symbol = globalSymbols_.find(name);
+        if (!symbol || !symbol->isDefined || symbol->value != value) moved.insert(name);
+    }
+    globalSymbols_.forEach([&](const SymbolInfo& symbol) {
+        if (symbol.isDefined && !previous.symbols.count(std::string(symbol.name))) moved.insert(symbol.name);
+    });
+
+    struct Task {
+        size_t section;
+        size_t contribution;
+        std::vector<uint8_t> bytes;
+    };
+    std::vector<Task> tasks;
+    for (size_t i = 0; i < combinedSections_.size(); ++i) {
+        const auto& contributions = combinedSections_[i].contributions;
+        for (size_t j = 0; j < contributions.size(); ++j) {
+            bool dirty = changedObjects[contributions[j].objectIndex] ||
+                         std::any_of(contributions[j].relocations.begin(), contributions[j].relocations.end(),
+                                     [&](const RelocationInfo& reloc) {
+                                         return reloc.targetSection == 0 && moved.contains(reloc.symbolName);
+                                     });
+            if (dirty) tasks.push_back({i, j, {}});
+        }
+    }
+
+    // Cada hueco se compone aparte y luego se escribe en su sitio
+    std::atomic<bool> failed{false};
+    common::utils::parallelFor(tasks.size(), jobs_, [&](size_t index) {
+        Task& task = tasks[index];
+        const auto& section = combinedSections_[task.section];
+        const auto& contribution = section.contributions[task.contribution];
+        task.bytes.resize(std::max<size_t>(contribution.bytes.size(), contribution.reserved));
+        if (!writeContribution(section, task.contribution, task.bytes, contribution.offset)) {
+            failed = true;
+        }
+    });
+    if (failed) {
+        return false;
+    }
+
+    std::fstream file(outputFile, std::ios::binary | std::ios::in | std::ios::out);
+    if (!file.is_open()) {
+        return false;
+    }
+    const auto dosStub = PEWriter::createDOSStub();
+    for (const auto* part : {&dosStub, &peHeader, &sectionTable}) {
+        file.write(reinterpret_cast<const char*>(part->data()), static_cast<std::streamsize>(part->size()));
+    }
+    std::vector<size_t> rawOffsets = rawSectionOffsets(dosStub.size() + peHeader.size() + sectionTable.size());
+    for (const auto& task : tasks) {
+        const auto& contribution = combinedSections_[task.section].contributions[task.contribution];
+        file.seekp(static_cast<std::streamoff>(rawOffsets[task.section] + contribution.offset));
+        file.write(reinterpret_cast<const char*>(task.bytes.data()), static_cast<std::streamsize>(task.bytes.size()));
+        totalRelocations_ += contribution.relocations.size();
+    }
+
+    // Las relocations base cierran el archivo
+    file.seekp(static_cast<std::streamoff>(previous.fileSize - baseRelocations.size()));
+    file.write(reinterpret_cast<const char*>(baseRelocations.data()),
+               static_cast<std::streamsize>(baseRelocations.size()));
+    file.close();
+    if (!file) {
+        return false;
+    }
+
+    // El checksum cubre todo el archivo, también lo que no se reescribió
+    uint32_t checksum;
+    {
+        auto image = common::utils::MappedFile::open(outputFile);
+        if (!image) {
+            return false;
+        }
+        checksum = calculatePEChecksum({reinterpret_cast<const uint8_t*>(image->data()), image->size()},
+                                       dosStub.size() + checksumOffset_);
     }
+    file.open(outputFile, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(static_cast<std::streamoff>(dosStub.size() + checksumOffset_));
+    file.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+
+    patchedContributions_ = tasks.size();
+    return file.good();
+}
 
-    return PEWriter::writePEFile(outputFile,
-                                PEWriter::createDOSStub(),
-                                peHeader,
-                                sectionTable,
-                                sectionData,
-                                importDirectory,
-                                exportDirectory,
-                                baseRelocations);
+uint32_t MiniLinker::calculatePEChecksum(std::span<const uint8_t> image, size_t checksumOffset) const {
+    size_t chunks = (image.size() + kChecksumChunk - 1) / kChecksumChunk;
+    std::vector<uint64_t> partial(chunks, 0);
+    common::utils::parallelFor(chunks, jobs_, [&](size_t index) {
+        size_t begin = index * kChecksumChunk;
+        partial[index] = sumWords(image.data() + begin, std::min(kChecksumChunk, image.size() - begin));
+    });
+
+    uint64_t sum = 0;
+    for (uint64_t value : partial) {
+        sum += value;
+    }
+    if (checksumOffset + 4 <= image.size()) {
+        sum -= sumWords(image.data() + checksumOffset, 4);
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return static_cast<uint32_t>(sum) + static_cast<uint32_t>(image.size());
 }
 
 bool MiniLinker::checkObjectCompatibility(const ObjectFileInfo& obj) const {
@@ -499,7 +1934,7 @@ bool MiniLinker::resolveSymbolConflicts() {
         // En un linker real, esto sería un error
         // Por simplicidad, reportamos pero continuamos
         for (const auto& conflict : conflicts) {
-            std::cerr << "Warning: Symbol conflict for '" << conflict << "'" << std::endl;
+            std::cerr << "Warning: Symbol conflict for '" << describeSymbol(conflict) << "'" << std::endl;
         }
     }
 
@@ -532,10 +1967,10 @@ uint32_t MiniLinker::calculateImageSize() const {
     return (lastEnd + sectionAlignment_ - 1) & ~(sectionAlignment_ - 1);
 }
 
-uint32_t MiniLinker::getSymbolRVA(const std::string& symbolName) const {
-    auto it = globalSymbols_.find(symbolName);
-    if (it != globalSymbols_.end() && it->second.isDefined) {
-        return it->second.value;
+uint32_t MiniLinker::getSymbolRVA(std::string_view symbolName) const {
+    const SymbolInfo* symbol = globalSymbols_.find(symbolName);
+    if (symbol && symbol->isDefined) {
+        return symbol->value;
     }
     return 0;
 }
@@ -554,17 +1989,23 @@ bool MiniLinker::isExternallyDefined(const std::string& symbolName) const {
 
 void MiniLinker::addRuntimeSymbols() {
     // Añadir símbolos de runtime estándar
-    const std::vector<std::string> runtimeSymbols = {
+    static constexpr std::string_view runtimeSymbols[] = {
         "_mainCRTStartup", "main", "_start", "__libc_start_main",
         "printf", "puts", "malloc", "free", "memcpy", "memset"
     };
 
-    for (const auto& symbol : runtimeSymbols) {
+    for (std::string_view symbol : runtimeSymbols) {
         SymbolInfo info(symbol, 0, 0);
         info.isDefined = false; // Se resolverán externamente
         info.isExternal = true;
-        globalSymbols_[symbol] = info;
+        globalSymbols_.insert(info, 0);
     }
+
+    // __ImageBase: RVA 0, base de los saltos por tabla de los Switch
+    SymbolInfo imageBase(coff::ImageBaseSymbol, 0, 0);
+    imageBase.isDefined = true;
+    imageBase.storageClass = coff::IMAGE_SYM_CLASS_EXTERNAL;
+    globalSymbols_.insert(imageBase, 0);
 }
 
 void MiniLinker::handleWeakSymbols() {
@@ -573,62 +2014,168 @@ void MiniLinker::handleWeakSymbols() {
 
 void MiniLinker::updateStatistics() {
     resolvedSymbols_ = 0;
-    for (const auto& [name, symbol] : globalSymbols_) {
+    globalSymbols_.forEach([&](const SymbolInfo& symbol) {
         if (symbol.isDefined) {
             resolvedSymbols_++;
         }
-    }
+    });
 }
 
 // ============================================================================
-// COFFReader - Implementación
+// IncrementalDatabase - Implementación
 // ============================================================================
 
-bool COFFReader::readObjectFile(const std::filesystem::path& filePath,
-                               ObjectFileInfo& objInfo) {
+std::filesystem::path IncrementalDatabase::pathFor(const std::filesystem::path& outputFile) {
+    std::filesystem::path database = outputFile;
+    return database.replace_extension(".ilk");
+}
 
-    if (!validateCOFFFormat(filePath)) {
-        return false;
+bool IncrementalDatabase::write(const std::filesystem::path& path) const {
+    std::string out(kDatabaseMagic, sizeof(kDatabaseMagic));
+    auto put = [&](uint64_t value, size_t width) {
+        for (size_t i = 0; i < width; ++i) out += static_cast<char>(value >> (8 * i));
+    };
+    auto putString = [&](std::string_view text) {
+        put(text.size(), 4);
+        out += text;
+    };
+
+    putString(entryPoint);
+    put(imageBase, 8);
+    put(fileSize, 8);
+    put(sections.size(), 4);
+    for (const auto& section : sections) {
+        putString(section.name);
+        put(section.characteristics, 4);
+        put(section.virtualSize, 4);
+        put(section.rawSize, 4);
+        put(section.isBSS, 1);
+    }
+    put(objects.size(), 4);
+    for (const auto& object : objects) {
+        putString(object.path);
+        put(object.size, 8);
+        put(static_cast<uint64_t>(object.modified), 8);
+        put(object.placements.size(), 4);
+        for (const auto& place : object.placements) {
+            put(place.outputSection, 4);
+            put(place.offset, 4);
+            put(place.capacity, 4);
+        }
+    }
+    put(symbols.size(), 4);
+    for (const auto& [name, value] : symbols) {
+        putString(name);
+        put(value, 4);
     }
 
-    std::ifstream file(filePath, std::ios::binary);
-    if (!file.is_open()) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(out.data(), static_cast<std::streamsize>(out.size()));
+    return file.good();
+}
+
+bool IncrementalDatabase::read(const std::filesystem::path& path) {
+    auto mapping = common::utils::MappedFile::open(path);
+    if (!mapping || mapping->size() < sizeof(kDatabaseMagic) ||
+        std::memcmp(mapping->data(), kDatabaseMagic, sizeof(kDatabaseMagic)) != 0) {
         return false;
     }
 
-    try {
-        COFFHeader coffHeader;
-        if (!readCOFFHeader(file, coffHeader)) {
-            return false;
+    std::string_view data = mapping->view();
+    size_t position = sizeof(kDatabaseMagic);
+    bool valid = true;
+    auto get = [&](size_t width) {
+        uint64_t value = 0;
+        if (position + width > data.size()) {
+            valid = false;
+            return value;
         }
-
-        // Leer section headers
-        std::vector<SectionHeader> sectionHeaders;
-        if (!readSectionHeaders(file, coffHeader, sectionHeaders)) {
-            return false;
+        for (size_t i = 0; i < width; ++i) {
+            value |= static_cast<uint64_t>(static_cast<uint8_t>(data[position + i])) << (8 * i);
+        }
+        position += width;
+        return value;
+    };
+    auto getString = [&]() {
+        size_t length = get(4);
+        if (!valid || position + length > data.size()) {
+            valid = false;
+            return std::string();
         }
+        std::string text(data.substr(position, length));
+        position += length;
+        return text;
+    };
 
-        // Leer symbol table
-        std::vector<COFFSymbol> symbols;
-        std::vector<std::string> stringTable;
-        if (!readSymbolTable(file, coffHeader, symbols, stringTable)) {
-            return false;
+    entryPoint = getString();
+    imageBase = get(8);
+    fileSize = get(8);
+    sections.resize(valid ? get(4) : 0);
+    for (auto& section : sections) {
+        section.name = getString();
+        section.characteristics = static_cast<uint32_t>(get(4));
+        section.virtualSize = static_cast<uint32_t>(get(4));
+        section.rawSize = static_cast<uint32_t>(get(4));
+        section.isBSS = get(1) != 0;
+        if (!valid) return false;
+    }
+    objects.resize(valid ? get(4) : 0);
+    for (auto& object : objects) {
+        object.path = getString();
+        object.size = get(8);
+        object.modified = static_cast<int64_t>(get(8));
+        object.placements.resize(valid ? get(4) : 0);
+        for (auto& place : object.placements) {
+            place.outputSection = static_cast<uint32_t>(get(4));
+            place.offset = static_cast<uint32_t>(get(4));
+            place.capacity = static_cast<uint32_t>(get(4));
         }
+        if (!valid) return false;
+    }
+    size_t symbolCount = valid ? get(4) : 0;
+    symbols.clear();
+    for (size_t i = 0; i < symbolCount && valid; ++i) {
+        std::string name = getString();
+        symbols[std::move(name)] = static_cast<uint32_t>(get(4));
+    }
+    return valid && position == data.size();
+}
 
-        // Extraer secciones
-        objInfo.sections = extractSections(std::vector<uint8_t>(), coffHeader);
+// ============================================================================
+// COFFReader - Implementación
+// ============================================================================
 
-        // Extraer símbolos
-        objInfo.symbols = extractSymbols(std::vector<uint8_t>(), coffHeader);
+bool COFFReader::readObjectFile(const std::filesystem::path& filePath,
+                               ObjectFileInfo& objInfo) {
 
-        objInfo.machineType = (coffHeader.machine == 0x8664) ? "X64" : "X86";
-        objInfo.isValid = true;
+    // Proyección compartida: las secciones son vistas sobre ella
+    std::shared_ptr<const common::utils::MappedFile> mapping = common::utils::MappedFile::open(filePath);
+    if (!mapping) {
+        return false;
+    }
+    std::span<const uint8_t> data(reinterpret_cast<const uint8_t*>(mapping->data()), mapping->size());
+    return readObject(std::move(mapping), data, objInfo);
+}
 
-    } catch (const std::exception&) {
+bool COFFReader::readObject(std::shared_ptr<const void> mapping,
+                            std::span<const uint8_t> data, ObjectFileInfo& objInfo) {
+    if (!isCOFFObject(data) || data.size() < sizeof(COFFHeader)) {
         return false;
     }
 
-    return true;
+    COFFHeader coffHeader;
+    std::memcpy(&coffHeader, data.data(), sizeof(COFFHeader));
+
+    // Extraer secciones
+    objInfo.sections = extractSections(data, coffHeader);
+
+    // Extraer símbolos
+    objInfo.symbols = extractSymbols(data, coffHeader);
+
+    objInfo.mapping = std::move(mapping);
+    objInfo.machineType = (coffHeader.Machine == coff::IMAGE_FILE_MACHINE_AMD64) ? "X64" : "X86";
+    objInfo.isValid = objInfo.sections.size() == coffHeader.NumberOfSections;
+    return objInfo.isValid;
 }
 
 bool COFFReader::validateCOFFFormat(const std::filesystem::path& filePath) {
@@ -638,83 +2185,337 @@ bool COFFReader::validateCOFFFormat(const std::filesystem::path& filePath) {
     }
 
     // Leer signature (4 bytes)
-    char signature[4];
-    file.read(signature, 4);
+    uint8_t signature[4];
+    file.read(reinterpret_cast<char*>(signature), 4);
+    return file.good() && isCOFFObject(signature);
+}
+
+bool COFFReader::isCOFFObject(std::span<const uint8_t> data) {
+    if (data.size() < 4) {
+        return false;
+    }
+
+    // Objeto COFF: empieza por la máquina (AMD64 o i386)
+    uint16_t machine = static_cast<uint16_t>(data[0] | (data[1] << 8));
+    if (machine == coff::IMAGE_FILE_MACHINE_AMD64 || machine == 0x014C) {
+        return true;
+    }
 
     // Verificar signature COFF
-    return std::memcmp(signature, "\x00\x00\xff\xff", 4) == 0 ||
-           std::memcmp(signature, "PE\x00\x00", 4) == 0;
+    return std::memcmp(data.data(), "\x00\x00\xff\xff", 4) == 0 ||
+           std::memcmp(data.data(), "PE\x00\x00", 4) == 0;
+}
+
+std::string_view COFFReader::symbolName(std::span<const uint8_t> data, const COFFHeader& header,
+                                        uint32_t index) {
+    // Vistas sobre la proyección: ni el nombre corto ni el largo se copian
+    size_t entry = header.PointerToSymbolTable + index * sizeof(coff::IMAGE_SYMBOL);
+    const char* shortName = reinterpret_cast<const char*>(data.data() + entry);
+    uint32_t zeroes, offset;
+    std::memcpy(&zeroes, shortName, sizeof(zeroes));
+    std::memcpy(&offset, shortName + sizeof(zeroes), sizeof(offset));
+    if (zeroes != 0) {
+        return std::string_view(shortName, strnlen(shortName, 8));
+    }
+
+    // Nombre largo: offset en la tabla de cadenas, que sigue a los símbolos
+    size_t strings = header.PointerToSymbolTable + header.NumberOfSymbols * sizeof(coff::IMAGE_SYMBOL);
+    if (offset < sizeof(uint32_t) || strings + offset >= data.size()) {
+        return {};
+    }
+    const char* name = reinterpret_cast<const char*>(data.data() + strings + offset);
+    return std::string_view(name, strnlen(name, data.size() - strings - offset));
 }
 
-std::vector<SymbolInfo> COFFReader::extractSymbols(const std::vector<uint8_t>& data,
+std::vector<SymbolInfo> COFFReader::extractSymbols(std::span<const uint8_t> data,
                                                   const COFFHeader& header) {
     std::vector<SymbolInfo> symbols;
-    // Implementación simplificada - en un linker real esto sería más complejo
+    size_t table = header.PointerToSymbolTable;
+    if (table == 0 || table + header.NumberOfSymbols * sizeof(coff::IMAGE_SYMBOL) > data.size()) {
+        return symbols;
+    }
+
+    for (uint32_t i = 0; i < header.NumberOfSymbols; ++i) {
+        coff::IMAGE_SYMBOL entry;
+        std::memcpy(&entry, data.data() + table + i * sizeof(coff::IMAGE_SYMBOL), sizeof(entry));
+
+        SymbolInfo symbol(symbolName(data, header, i), entry.Value, entry.SectionNumber);
+        symbol.type = entry.Type;
+        symbol.storageClass = entry.StorageClass;
+        symbol.isDefined = entry.SectionNumber > 0;
+        symbol.isWeak = entry.StorageClass == coff::IMAGE_SYM_CLASS_WEAK_EXTERNAL;
+        symbols.push_back(std::move(symbol));
+
+        // Los registros auxiliares no son símbolos
+        i += entry.NumberOfAuxSymbols;
+    }
     return symbols;
 }
 
-std::vector<SectionInfo> COFFReader::extractSections(const std::vector<uint8_t>& data,
+std::vector<SectionInfo> COFFReader::extractSections(std::span<const uint8_t> data,
                                                     const COFFHeader& header) {
     std::vector<SectionInfo> sections;
-    // Implementación simplificada
+    size_t headers = sizeof(COFFHeader) + header.SizeOfOptionalHeader;
+    if (headers + header.NumberOfSections * sizeof(SectionHeader) > data.size()) {
+        return sections;
+    }
+
+    for (uint16_t i = 0; i < header.NumberOfSections; ++i) {
+        SectionHeader sectionHeader;
+        std::memcpy(&sectionHeader, data.data() + headers + i * sizeof(SectionHeader), sizeof(SectionHeader));
+
+        SectionInfo section(std::string(sectionHeader.Name, strnlen(sectionHeader.Name, 8)));
+        section.characteristics = sectionHeader.Characteristics;
+        section.isBSS = (sectionHeader.Characteristics & coff::IMAGE_SCN_CNT_UNINITIALIZED_DATA) != 0;
+        section.rawSize = sectionHeader.SizeOfRawData;
+        section.virtualSize = std::max(sectionHeader.Misc.VirtualSize, sectionHeader.SizeOfRawData);
+        if (!section.isBSS && sectionHeader.SizeOfRawData > 0) {
+            if (sectionHeader.PointerToRawData + sectionHeader.SizeOfRawData > data.size()) {
+                return {};
+            }
+            section.contents = data.subspan(sectionHeader.PointerToRawData, sectionHeader.SizeOfRawData);
+        }
+        section.relocations = extractRelocations(data, sectionHeader, header.NumberOfSymbols);
+        sections.push_back(std::move(section));
+    }
+
+    // Símbolos: destino de cada relocation y definición de los COMDAT
+    size_t table = header.PointerToSymbolTable;
+    if (table == 0 || table + header.NumberOfSymbols * sizeof(coff::IMAGE_SYMBOL) > data.size()) {
+        return sections;
+    }
+    auto entryAt = [&](uint32_t index) {
+        coff::IMAGE_SYMBOL entry;
+        std::memcpy(&entry, data.data() + table + index * sizeof(coff::IMAGE_SYMBOL), sizeof(entry));
+        return entry;
+    };
+
+    for (auto& section : sections) {
+        for (auto& reloc : section.relocations) {
+            coff::IMAGE_SYMBOL target = entryAt(reloc.symbolIndex);
+            reloc.symbolName = symbolName(data, header, reloc.symbolIndex);
+            if (target.StorageClass != coff::IMAGE_SYM_CLASS_EXTERNAL && target.SectionNumber > 0) {
+                reloc.targetSection = target.SectionNumber;
+            }
+        }
+    }
+
+    // El primer símbolo de una sección COMDAT es el de sección, con la
+    // selección en su registro auxiliar; el siguiente le da nombre
+    for (uint32_t i = 0; i < header.NumberOfSymbols; ++i) {
+        coff::IMAGE_SYMBOL entry = entryAt(i);
+        uint32_t next = i + 1 + entry.NumberOfAuxSymbols;
+        if (entry.SectionNumber <= 0 || entry.SectionNumber > static_cast<int>(sections.size())) {
+            i = next - 1;
+            continue;
+        }
+
+        SectionInfo& section = sections[entry.SectionNumber - 1];
+        if ((section.characteristics & coff::IMAGE_SCN_LNK_COMDAT) && section.comdatSelection == 0 &&
+            entry.StorageClass == coff::IMAGE_SYM_CLASS_STATIC && entry.NumberOfAuxSymbols > 0) {
+            coff::IMAGE_AUX_SYMBOL_SECTION definition;
+            std::memcpy(&definition, data.data() + table + (i + 1) * sizeof(coff::IMAGE_SYMBOL),
+                        sizeof(definition));
+            section.comdatSelection = definition.Selection;
+            section.associatedSection = definition.Number;
+            if (definition.Selection != coff::IMAGE_COMDAT_SELECT_ASSOCIATIVE && next < header.NumberOfSymbols) {
+                section.comdatSymbol = symbolName(data, header, next);
+            }
+        }
+        i = next - 1;
+    }
+
     return sections;
 }
 
-std::vector<RelocationInfo> COFFReader::extractRelocations(const std::vector<uint8_t>& data,
+std::vector<RelocationInfo> COFFReader::extractRelocations(std::span<const uint8_t> data,
                                                           const SectionHeader& section,
                                                           uint32_t symbolCount) {
     std::vector<RelocationInfo> relocations;
-    // Implementación simplificada
+    size_t table = section.PointerToRelocations;
+    if (table + section.NumberOfRelocations * sizeof(coff::IMAGE_RELOCATION) > data.size()) {
+        return relocations;
+    }
+
+    for (uint16_t i = 0; i < section.NumberOfRelocations; ++i) {
+        coff::IMAGE_RELOCATION entry;
+        std::memcpy(&entry, data.data() + table + i * sizeof(coff::IMAGE_RELOCATION), sizeof(entry));
+        if (entry.SymbolTableIndex >= symbolCount) {
+            continue;
+        }
+        relocations.emplace_back(entry.VirtualAddress, entry.SymbolTableIndex, entry.Type);
+    }
     return relocations;
 }
 
-bool COFFReader::readCOFFHeader(std::ifstream& file, COFFHeader& header) {
-    file.read(reinterpret_cast<char*>(&header), sizeof(COFFHeader));
-    return file.good();
+// ============================================================================
+// ArchiveReader - Implementación
+// ============================================================================
+
+bool ArchiveReader::isArchive(std::span<const uint8_t> data) {
+    return data.size() >= coff::IMAGE_ARCHIVE_START_SIZE &&
+           std::memcmp(data.data(), coff::IMAGE_ARCHIVE_START, coff::IMAGE_ARCHIVE_START_SIZE) == 0;
 }
 
-bool COFFReader::readSectionHeaders(std::ifstream& file, const COFFHeader& coffHeader,
-                                   std::vector<SectionHeader>& sectionHeaders) {
-    sectionHeaders.resize(coffHeader.numberOfSections);
-    for (auto& section : sectionHeaders) {
-        file.read(reinterpret_cast<char*>(&section), sizeof(SectionHeader));
-        if (!file.good()) return false;
+bool ArchiveReader::readMemberHeader(std::span<const uint8_t> data, size_t offset,
+                                     std::string_view& name, std::span<const uint8_t>& contents) {
+    coff::IMAGE_ARCHIVE_MEMBER_HEADER header;
+    if (offset + sizeof(header) > data.size()) {
+        return false;
+    }
+    std::memcpy(&header, data.data() + offset, sizeof(header));
+    if (std::memcmp(header.EndHeader, coff::IMAGE_ARCHIVE_END, sizeof(header.EndHeader)) != 0) {
+        return false;
     }
-    return true;
-}
 
-bool COFFReader::readSymbolTable(std::ifstream& file, const COFFHeader& coffHeader,
-                                std::vector<COFFSymbol>& symbols,
-                                std::vector<std::string>& stringTable) {
-    if (coffHeader.pointerToSymbolTable == 0) return true;
+    size_t size = 0;
+    for (char digit : header.Size) {
+        if (digit < '0' || digit > '9') break;
+        size = size * 10 + static_cast<size_t>(digit - '0');
+    }
+    size_t begin = offset + sizeof(header);
+    if (size > data.size() - begin) {
+        return false;
+    }
 
-    // Implementación simplificada
+    name = std::string_view(reinterpret_cast<const char*>(data.data() + offset), sizeof(header.Name));
+    name = name.substr(0, name.find_last_not_of(' ') + 1);
+    contents = data.subspan(begin, size);
     return true;
 }
 
-bool COFFReader::readSectionData(std::ifstream& file, const SectionHeader& section,
-                                std::vector<uint8_t>& data) {
-    if (section.sizeOfRawData == 0) return true;
+bool ArchiveReader::readSymbolIndex(std::span<const uint8_t> data, std::vector<ArchiveSymbol>& index) {
+    index.clear();
+    if (!isArchive(data)) {
+        return false;
+    }
 
-    file.seekg(section.pointerToRawData);
-    data.resize(section.sizeOfRawData);
-    file.read(reinterpret_cast<char*>(data.data()), section.sizeOfRawData);
+    std::string_view name;
+    std::span<const uint8_t> first, second;
+    size_t offset = coff::IMAGE_ARCHIVE_START_SIZE;
+    if (!readMemberHeader(data, offset, name, first) || name != "/") {
+        return false;
+    }
+    offset += sizeof(coff::IMAGE_ARCHIVE_MEMBER_HEADER) + first.size() + (first.size() & 1);
+    bool hasSecond = readMemberHeader(data, offset, name, second) && name == "/";
 
-    return file.good();
+    auto readLE = [](std::span<const uint8_t> bytes, size_t at, size_t width) {
+        uint32_t value = 0;
+        for (size_t i = 0; i < width; ++i) value |= static_cast<uint32_t>(bytes[at + i]) << (8 * i);
+        return value;
+    };
+    auto readStrings = [&](std::span<const uint8_t> bytes, size_t at, uint32_t count, auto&& memberOf) {
+        const char* text = reinterpret_cast<const char*>(bytes.data());
+        for (uint32_t i = 0; i < count && at < bytes.size(); ++i) {
+            size_t length = strnlen(text + at, bytes.size() - at);
+            index.push_back({std::string_view(text + at, length), memberOf(i)});
+            at += length + 1;
+        }
+        return index.size() == count;
+    };
+
+    if (hasSecond) {
+        // Segundo miembro: offsets de miembro, índices (base 1) por símbolo y nombres ordenados
+        if (second.size() < 4) return false;
+        uint32_t members = readLE(second, 0, 4);
+        size_t symbolsAt = 4 + static_cast<size_t>(members) * 4;
+        if (symbolsAt + 4 > second.size()) return false;
+        uint32_t symbols = readLE(second, symbolsAt, 4);
+        size_t stringsAt = symbolsAt + 4 + static_cast<size_t>(symbols) * 2;
+        if (stringsAt > second.size()) return false;
+        bool complete = readStrings(second, stringsAt, symbols, [&](uint32_t i) {
+            uint32_t member = readLE(second, symbolsAt + 4 + i * 2, 2);
+            return member >= 1 && member <= members ? readLE(second, member * 4, 4) : 0u;
+        });
+        if (!complete) return false;
+    } else {
+        // Primer miembro: contador y offsets big-endian, nombres en orden de miembro
+        auto readBE = [&](size_t at) {
+            return static_cast<uint32_t>(first[at]) << 24 | static_cast<uint32_t>(first[at + 1]) << 16 |
+                   static_cast<uint32_t>(first[at + 2]) << 8 | static_cast<uint32_t>(first[at + 3]);
+        };
+        if (first.size() < 4) return false;
+        uint32_t symbols = readBE(0);
+        size_t stringsAt = 4 + static_cast<size_t>(symbols) * 4;
+        if (stringsAt > first.size()) return false;
+        if (!readStrings(first, stringsAt, symbols, [&](uint32_t i) { return readBE(4 + i * 4); })) {
+            return false;
+        }
+    }
+
+    std::stable_sort(index.begin(), index.end(),
+                     [](const ArchiveSymbol& a, const ArchiveSymbol& b) { return a.name < b.name; });
+    return true;
+}
+
+std::span<const uint8_t> ArchiveReader::memberAt(std::span<const uint8_t> data, uint32_t offset) {
+    std::string_view name;
+    std::span<const uint8_t> contents;
+    if (offset < coff::IMAGE_ARCHIVE_START_SIZE || !readMemberHeader(data, offset, name, contents)) {
+        return {};
+    }
+    return contents;
 }
 
-bool COFFReader::readSectionRelocations(std::ifstream& file, const SectionHeader& section,
-                                       std::vector<RelocationInfo>& relocations) {
-    if (section.numberOfRelocations == 0) return true;
+bool ArchiveReader::readMembers(std::span<const uint8_t> data, std::vector<ArchiveMember>& members) {
+    members.clear();
+    if (!isArchive(data)) {
+        return false;
+    }
 
-    file.seekg(section.pointerToRelocations);
-    relocations.resize(section.numberOfRelocations);
+    std::string_view longNames;
+    size_t offset = coff::IMAGE_ARCHIVE_START_SIZE;
+    while (offset < data.size()) {
+        std::string_view name;
+        std::span<const uint8_t> contents;
+        if (!readMemberHeader(data, offset, name, contents)) {
+            return false;
+        }
 
-    for (auto& reloc : relocations) {
-        file.read(reinterpret_cast<char*>(&reloc), sizeof(RelocationInfo));
-        if (!file.good()) return false;
+        if (name == "//") {
+            longNames = std::string_view(reinterpret_cast<const char*>(contents.data()), contents.size());
+        } else if (name != "/") {
+            if (name.size() > 1 && name[0] == '/' && name[1] >= '0' && name[1] <= '9') {
+                // "/n": desplazamiento en la tabla de nombres largos, terminado en '\0' (o "/\n" de GNU)
+                size_t at = 0;
+                for (char digit : name.substr(1)) {
+                    if (digit < '0' || digit > '9') break;
+                    at = at * 10 + static_cast<size_t>(digit - '0');
+                }
+                name = at < longNames.size() ? longNames.substr(at) : std::string_view();
+                name = name.substr(0, name.find_first_of(std::string_view("\0\n", 2)));
+            }
+            if (!name.empty() && name.back() == '/') {
+                name.remove_suffix(1);
+            }
+            members.push_back({name, static_cast<uint32_t>(offset), contents});
+        }
+        offset += sizeof(coff::IMAGE_ARCHIVE_MEMBER_HEADER) + contents.size() + (contents.size() & 1);
+    }
+    return true;
+}
+
+bool ArchiveReader::readImportObject(std::span<const uint8_t> member, std::string_view& symbol,
+                                     std::string_view& dllName, uint16_t& hint) {
+    coff::IMPORT_OBJECT_HEADER header;
+    if (member.size() < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, member.data(), sizeof(header));
+    if (header.Sig1 != 0 || header.Sig2 != coff::IMPORT_OBJECT_HDR_SIG2 ||
+        header.SizeOfData > member.size() - sizeof(header)) {
+        return false;
     }
 
+    std::string_view names(reinterpret_cast<const char*>(member.data() + sizeof(header)), header.SizeOfData);
+    size_t end = names.find('\0');
+    if (end == std::string_view::npos) {
+        return false;
+    }
+    symbol = names.substr(0, end);
+    names.remove_prefix(end + 1);
+    dllName = names.substr(0, names.find('\0'));
+    hint = header.OrdinalOrHint;
     return true;
 }
 
@@ -817,13 +2618,13 @@ uint32_t PEWriter::calculateFileSize(const std::vector<uint8_t>& dosHeader,
 // SymbolResolver - Implementación
 // ============================================================================
 
-bool SymbolResolver::resolveSymbol(const std::string& symbolName,
-                                  const std::unordered_map<std::string, SymbolInfo>& globalSymbols,
+bool SymbolResolver::resolveSymbol(std::string_view symbolName,
+                                  const GlobalSymbolTable& globalSymbols,
                                   uint32_t& resolvedAddress) {
 
-    auto it = globalSymbols.find(symbolName);
-    if (it != globalSymbols.end() && it->second.isDefined) {
-        resolvedAddress = it->second.value;
+    const SymbolInfo* symbol = globalSymbols.find(symbolName);
+    if (symbol && symbol->isDefined) {
+        resolvedAddress = symbol->value;
         return true;
     }
 
@@ -831,62 +2632,52 @@ bool SymbolResolver::resolveSymbol(const std::string& symbolName,
 }
 
 std::vector<std::string> SymbolResolver::findUndefinedSymbols(
-    const std::unordered_map<std::string, SymbolInfo>& globalSymbols) {
+    const GlobalSymbolTable& globalSymbols) {
 
     std::vector<std::string> undefined;
 
-    for (const auto& [name, symbol] : globalSymbols) {
+    globalSymbols.forEach([&](const SymbolInfo& symbol) {
         if (!symbol.isDefined && !symbol.isExternal) {
-            undefined.push_back(name);
+            undefined.emplace_back(symbol.name);
         }
-    }
+    });
 
     return undefined;
 }
 
 std::vector<std::string> SymbolResolver::findSymbolConflicts(
-    const std::unordered_map<std::string, SymbolInfo>& globalSymbols) {
+    const GlobalSymbolTable& globalSymbols) {
 
+    // Las definiciones se cuentan al insertar en la tabla
     std::vector<std::string> conflicts;
-    std::unordered_map<std::string, int> definitionCount;
-
-    for (const auto& [name, symbol] : globalSymbols) {
-        if (symbol.isDefined) {
-            definitionCount[name]++;
-        }
+    for (std::string_view name : globalSymbols.conflicts()) {
+        conflicts.emplace_back(name);
     }
-
-    for (const auto& [name, count] : definitionCount) {
-        if (count > 1) {
-            conflicts.push_back(name);
-        }
-    }
-
     return conflicts;
 }
 
 void SymbolResolver::resolveWeakSymbols(
-    std::unordered_map<std::string, SymbolInfo>& globalSymbols) {
+    GlobalSymbolTable& globalSymbols) {
 
-    for (auto& [name, symbol] : globalSymbols) {
+    globalSymbols.forEach([](SymbolInfo& symbol) {
         if (symbol.isWeak && !symbol.isDefined) {
             // Resolver símbolo débil con valor por defecto
             symbol.value = 0;
             symbol.isDefined = true;
         }
-    }
+    });
 }
 
 std::vector<std::string> SymbolResolver::getExportedSymbols(
-    const std::unordered_map<std::string, SymbolInfo>& globalSymbols) {
+    const GlobalSymbolTable& globalSymbols) {
 
     std::vector<std::string> exported;
 
-    for (const auto& [name, symbol] : globalSymbols) {
+    globalSymbols.forEach([&](const SymbolInfo& symbol) {
         if (symbol.isDefined && symbol.storageClass == 2) { // IMAGE_SYM_CLASS_EXTERNAL
-            exported.push_back(name);
+            exported.emplace_back(symbol.name);
         }
-    }
+    });
 
     return exported;
 }
@@ -909,7 +2700,7 @@ const std::unordered_set<std::string>& SymbolResolver::getRuntimeSymbols() {
     static const std::unordered_set<std::string> runtimeSymbols = {
         "_mainCRTStartup", "main", "_start", "__libc_start_main",
         "printf", "puts", "malloc", "free", "memcpy", "memset",
-        "strlen", "strcmp", "strcpy", "exit", "_exit"
+        "strlen", "strcmp", "strcpy", "exit", "_exit", ir::ProfileWriteFunction
     };
 
     return runtimeSymbols;
@@ -919,7 +2710,7 @@ const std::unordered_set<std::string>& SymbolResolver::getRuntimeSymbols() {
 // RelocationApplier - Implementación
 // ============================================================================
 
-bool RelocationApplier::applyRelocation(std::vector<uint8_t>& sectionData,
+bool RelocationApplier::applyRelocation(std::span<uint8_t> sectionData,
                                        const RelocationInfo& relocation,
                                        uint32_t symbolAddress,
                                        uint32_t sectionRVA) {
@@ -934,6 +2725,7 @@ bool RelocationApplier::applyRelocation(std::vector<uint8_t>& sectionData,
             return applyAddr64Relocation(sectionData, relocation.virtualAddress, value);
 
         case 0x0002: // IMAGE_REL_AMD64_ADDR32
+        case 0x0003: // IMAGE_REL_AMD64_ADDR32NB (RVA: .pdata, .xdata)
             return applyAddr32Relocation(sectionData, relocation.virtualAddress, value);
 
         case 0x0004: // IMAGE_REL_AMD64_REL32
@@ -944,26 +2736,31 @@ bool RelocationApplier::applyRelocation(std::vector<uint8_t>& sectionData,
     }
 }
 
-bool RelocationApplier::applySectionRelocations(std::vector<uint8_t>& sectionData,
+bool RelocationApplier::applySectionRelocations(std::span<uint8_t> sectionData,
                                                const std::vector<RelocationInfo>& relocations,
-                                               const std::unordered_map<std::string, SymbolInfo>& globalSymbols,
-                                               const std::vector<SectionInfo>& sections) {
+                                               const GlobalSymbolTable& globalSymbols,
+                                               const std::vector<SectionInfo>& sections,
+                                               uint32_t sectionRVA) {
 
     for (const auto& reloc : relocations) {
-        // Encontrar el símbolo referenciado
-        auto symbolIt = globalSymbols.find(std::to_string(reloc.symbolTableIndex));
-        if (symbolIt == globalSymbols.end()) {
-            return false;
-        }
+        uint32_t symbolAddress = 0;
+
+        if (reloc.targetSection > 0) {
+            // Símbolo local: inicio de su contribución en la sección combinada
+            symbolAddress = sections[reloc.targetSection - 1].virtualAddress + reloc.addend;
+        } else {
+            // Encontrar el símbolo referenciado
+            const SymbolInfo* symbol = globalSymbols.find(reloc.symbolName);
+            if (!symbol) {
+                return false;
+            }
 
-        const auto& symbol = symbolIt->second;
-        if (!symbol.isDefined) {
-            continue; // Símbolo no definido, se resolverá después
+            if (!symbol->isDefined) {
+                continue; // Símbolo no definido, se resolverá después
+            }
+            symbolAddress = symbol->value;
         }
 
-        uint32_t symbolAddress = symbol.value;
-        uint32_t sectionRVA = sections[symbol.sectionIndex - 1].virtualAddress;
-
         if (!applyRelocation(sectionData, reloc, symbolAddress, sectionRVA)) {
             return false;
         }
@@ -1013,38 +2810,41 @@ uint32_t RelocationApplier::calculateRelocationValue(uint16_t type,
     return convertRelocationToRVA(type, symbolValue, sectionRVA, offset);
 }
 
-bool RelocationApplier::applyAddr32Relocation(std::vector<uint8_t>& data,
+bool RelocationApplier::applyAddr32Relocation(std::span<uint8_t> data,
                                              size_t offset,
                                              uint32_t value) {
     if (offset + 4 > data.size()) {
         return false;
     }
 
-    *reinterpret_cast<uint32_t*>(&data[offset]) = value;
+    // El addend va en los propios bytes (COFF no usa addend explícito)
+    uint32_t addend;
+    std::memcpy(&addend, &data[offset], sizeof(addend));
+    value += addend;
+    std::memcpy(&data[offset], &value, sizeof(value));
     return true;
 }
 
-bool RelocationApplier::applyAddr64Relocation(std::vector<uint8_t>& data,
+bool RelocationApplier::applyAddr64Relocation(std::span<uint8_t> data,
                                              size_t offset,
                                              uint64_t value) {
     if (offset + 8 > data.size()) {
         return false;
     }
 
-    *reinterpret_cast<uint64_t*>(&data[offset]) = value;
+    uint64_t addend;
+    std::memcpy(&addend, &data[offset], sizeof(addend));
+    value += addend;
+    std::memcpy(&data[offset], &value, sizeof(value));
     return true;
 }
 
-bool RelocationApplier::applyRel32Relocation(std::vector<uint8_t>& data,
+bool RelocationApplier::applyRel32Relocation(std::span<uint8_t> data,
                                             size_t offset,
                                             uint32_t value,
                                             uint32_t currentRVA) {
-    if (offset + 4 > data.size()) {
-        return false;
-    }
-
-    *reinterpret_cast<uint32_t*>(&data[offset]) = value;
-    return true;
+    (void)currentRVA; // Ya descontado en calculateRelocationValue
+    return applyAddr32Relocation(data, offset, value);
 }
 
 } // namespace cpp20::compiler::backend::link
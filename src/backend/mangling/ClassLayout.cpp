@@ -5,6 +5,7 @@
 
 #include <compiler/backend/mangling/ClassLayout.h>
 #include <algorithm>
+#include <sstream>
 
 namespace cpp20::compiler::backend::mangling {
 
@@ -14,7 +15,7 @@ namespace cpp20::compiler::backend::mangling {
 
 ClassLayout::ClassLayout(const std::string& className, const std::string& scope)
     : className_(className), scope_(scope), totalSize_(0), alignment_(1),
-      vtableOffset_(0), layoutComputed_(false), nameMangler_() {
+      vtableOffset_(0), dataStart_(0), layoutComputed_(false), cache_(nullptr), nameMangler_() {
 }
 
 ClassLayout::~ClassLayout() = default;
@@ -44,29 +45,29 @@ void ClassLayout::addInheritance(const InheritanceInfo& inheritance) {
 void ClassLayout::computeLayout() {
     if (layoutComputed_) return;
 
-    // 1. Procesar herencia primero (define el orden base)
-    computeInheritanceLayout();
-
-    // 2. Calcular posiciones de funciones virtuales
+    // 1. Asignar índices en la vtable
     computeVirtualFunctionLayout();
 
-    // 3. Calcular offsets de miembros de datos
-    computeDataMemberOffsets();
+    // 2. vptr al inicio si hay funciones virtuales
+    size_t offset = 0;
+    vtableOffset_ = 0;
+    if (hasVirtualFunctions()) {
+        offset += 8; // Tamaño de puntero en x64
+    }
+
+    // 3. Bases no virtuales y después los miembros, en orden de declaración
+    offset = computeInheritanceLayout(offset);
+    dataStart_ = offset;
+    offset = computeDataMemberOffsets(offset);
 
     // 4. Calcular tamaño total y alineación
-    computeSizeAndAlignment();
+    computeSizeAndAlignment(offset);
 
     layoutComputed_ = true;
 }
 
-void ClassLayout::computeDataMemberOffsets() {
-    size_t currentOffset = 0;
-
-    // Si hay funciones virtuales, reservar espacio para vptr al inicio
-    if (hasVirtualFunctions()) {
-        vtableOffset_ = currentOffset;
-        currentOffset += 8; // Tamaño de puntero en x64
-    }
+size_t ClassLayout::computeDataMemberOffsets(size_t offset) {
+    size_t currentOffset = offset;
 
     // Procesar cada miembro de datos
     for (auto& member : dataMembers_) {
@@ -92,26 +93,30 @@ void ClassLayout::computeDataMemberOffsets() {
             currentOffset += typeSize;
         }
     }
+    return currentOffset;
 }
 
-void ClassLayout::computeInheritanceLayout() {
+size_t ClassLayout::computeInheritanceLayout(size_t offset) {
     // Implementación simplificada de layout de herencia
     // En MSVC, el orden de herencia afecta el layout
 
-    size_t currentOffset = 0;
+    size_t currentOffset = offset;
 
     for (auto& inherit : inheritance_) {
         if (inherit.isVirtual) {
             // Herencia virtual - más compleja
             // TODO: Implementar layout de herencia virtual
+            currentOffset = alignOffset(currentOffset, 8);
             inherit.offset = currentOffset;
-            currentOffset += 8; // vptr para base virtual
+            currentOffset += 8; // vbptr para base virtual
         } else {
-            // Herencia simple
+            // Herencia simple: el subobjeto base completo
+            currentOffset = alignOffset(currentOffset, getTypeAlignment(inherit.baseClass));
             inherit.offset = currentOffset;
-            // El tamaño se añade al final en computeSizeAndAlignment
+            currentOffset += getTypeSize(inherit.baseClass);
         }
     }
+    return currentOffset;
 }
 
 void ClassLayout::computeVirtualFunctionLayout() {
@@ -123,30 +128,19 @@ void ClassLayout::computeVirtualFunctionLayout() {
     }
 }
 
-void ClassLayout::computeSizeAndAlignment() {
+void ClassLayout::computeSizeAndAlignment(size_t end) {
     size_t maxAlignment = 1;
-    size_t currentSize = 0;
 
     // Considerar alineación de clases base
     for (const auto& inherit : inheritance_) {
-        if (!inherit.isVirtual) {
-            // Añadir tamaño de clase base (simplificado)
-            size_t baseSize = getTypeSize(inherit.baseClass);
-            size_t baseAlignment = getTypeAlignment(inherit.baseClass);
-
-            currentSize += baseSize;
-            maxAlignment = std::max(maxAlignment, baseAlignment);
-        }
+        maxAlignment = std::max(maxAlignment, inherit.isVirtual ? size_t(8)
+                                                                : getTypeAlignment(inherit.baseClass));
     }
 
     // Considerar alineación de miembros de datos
     for (const auto& member : dataMembers_) {
         if (!member.isStatic) {
-            size_t typeSize = getTypeSize(member.type);
-            size_t typeAlignment = getTypeAlignment(member.type);
-
-            currentSize += typeSize;
-            maxAlignment = std::max(maxAlignment, typeAlignment);
+            maxAlignment = std::max(maxAlignment, getTypeAlignment(member.type));
         }
     }
 
@@ -155,11 +149,18 @@ void ClassLayout::computeSizeAndAlignment() {
         maxAlignment = std::max(maxAlignment, size_t(8)); // Alineación de puntero
     }
 
-    // Alinear el tamaño final
-    totalSize_ = alignOffset(currentSize, maxAlignment);
+    // Alinear el tamaño final; una clase vacía ocupa un byte
+    totalSize_ = std::max<size_t>(alignOffset(end, maxAlignment), 1);
     alignment_ = maxAlignment;
 }
 
+const ClassLayout* ClassLayout::classLayoutOf(const std::string& typeName) const {
+    if (!cache_ || typeName.find_first_of("*&") != std::string::npos) {
+        return nullptr;
+    }
+    return cache_->getLayout(typeName);
+}
+
 size_t ClassLayout::getTypeSize(const std::string& typeName) const {
     // Tabla simplificada de tamaños de tipos
     if (typeName == "bool" || typeName == "char") return 1;
@@ -167,6 +168,7 @@ size_t ClassLayout::getTypeSize(const std::string& typeName) const {
     if (typeName == "int" || typeName == "long" || typeName == "float") return 4;
     if (typeName == "long long" || typeName == "double" || typeName == "long double") return 8;
     if (typeName.find('*') != std::string::npos) return 8; // Punteros
+    if (const ClassLayout* layout = classLayoutOf(typeName)) return layout->getSize();
 
     // Para tipos no encontrados, asumir tamaño de puntero
     return 8;
@@ -179,6 +181,7 @@ size_t ClassLayout::getTypeAlignment(const std::string& typeName) const {
     if (typeName == "int" || typeName == "long" || typeName == "float") return 4;
     if (typeName == "long long" || typeName == "double" || typeName == "long double") return 8;
     if (typeName.find('*') != std::string::npos) return 8; // Punteros
+    if (const ClassLayout* layout = classLayoutOf(typeName)) return layout->getAlignment();
 
     // Para tipos no encontrados, asumir alineación de puntero
     return 8;
@@ -219,6 +222,10 @@ std::string ClassLayout::generateTypeInfoName() const {
     return nameMangler_.generateTypeInfoName(className_, scope_);
 }
 
+std::string ClassLayout::getQualifiedName() const {
+    return scope_.empty() ? className_ : scope_ + "::" + className_;
+}
+
 bool ClassLayout::isMSVCCompatible() const {
     if (!layoutComputed_) {
         return false;
@@ -226,6 +233,146 @@ bool ClassLayout::isMSVCCompatible() const {
     return validateMSVCRules();
 }
 
+PaddingReport ClassLayout::analyzePadding() const {
+    PaddingReport report;
+    report.className = getQualifiedName();
+    if (!layoutComputed_) {
+        return report;
+    }
+    report.size = totalSize_;
+    report.cacheLines = (totalSize_ + 63) / 64;
+
+    // Miembros que ocupan espacio, por offset
+    std::vector<const MemberInfo*> members;
+    bool hasBitFields = false;
+    for (const auto& member : dataMembers_) {
+        if (member.isStatic) continue;
+        hasBitFields = hasBitFields || member.isBitField;
+        members.push_back(&member);
+    }
+    std::stable_sort(members.begin(), members.end(),
+                     [](const MemberInfo* a, const MemberInfo* b) { return a->offset < b->offset; });
+
+    size_t end = dataStart_;
+    std::string previous = inheritance_.empty() ? (hasVirtualFunctions() ? "vptr" : "") : inheritance_.back().baseClass;
+    for (const MemberInfo* member : members) {
+        if (member->offset > end) {
+            report.holes.push_back({previous, end, member->offset - end});
+        }
+        end = std::max(end, member->offset + (member->isBitField ? 0 : getTypeSize(member->type)));
+        previous = member->name;
+    }
+    if (totalSize_ > end && !members.empty()) {
+        report.holes.push_back({previous, end, totalSize_ - end});
+    }
+    for (const auto& hole : report.holes) {
+        report.paddingBytes += hole.bytes;
+    }
+
+    // Por alineación decreciente y, a igualdad, tamaño decreciente
+    report.suggestedSize = totalSize_;
+    report.suggestedCacheLines = report.cacheLines;
+    if (hasBitFields || report.paddingBytes == 0) {
+        return report;
+    }
+    std::vector<const MemberInfo*> ordered = members;
+    std::stable_sort(ordered.begin(), ordered.end(), [this](const MemberInfo* a, const MemberInfo* b) {
+        size_t alignA = getTypeAlignment(a->type);
+        size_t alignB = getTypeAlignment(b->type);
+        if (alignA != alignB) return alignA > alignB;
+        return getTypeSize(a->type) > getTypeSize(b->type);
+    });
+
+    size_t offset = dataStart_;
+    for (const MemberInfo* member : ordered) {
+        offset = alignOffset(offset, getTypeAlignment(member->type)) + getTypeSize(member->type);
+    }
+    size_t suggestedSize = std::max<size_t>(alignOffset(offset, alignment_), 1);
+    if (suggestedSize >= totalSize_) {
+        return report;
+    }
+
+    report.suggestedSize = suggestedSize;
+    report.suggestedCacheLines = (suggestedSize + 63) / 64;
+    for (const MemberInfo* member : ordered) {
+        report.suggestedOrder.push_back(member->name);
+    }
+    return report;
+}
+
+std::string PaddingReport::format() const {
+    std::ostringstream out;
+    out << "warning: '" << className << "' tiene " << paddingBytes << " bytes de relleno de "
+        << size << " [-Wpadded]\n";
+    for (const auto& hole : holes) {
+        out << "  " << hole.bytes << " bytes en el offset " << hole.offset;
+        if (!hole.afterMember.empty()) {
+            out << " tras '" << hole.afterMember << "'";
+        }
+        out << "\n";
+    }
+    if (!suggestedOrder.empty()) {
+        out << "  con el orden ";
+        for (size_t i = 0; i < suggestedOrder.size(); ++i) {
+            out << (i ? ", " : "") << suggestedOrder[i];
+        }
+        out << " ocuparía " << suggestedSize << " bytes (" << bytesSaved() << " menos por instancia";
+        if (suggestedCacheLines < cacheLines) {
+            out << ", " << suggestedCacheLines << " líneas de caché en vez de " << cacheLines;
+        }
+        out << ")\n";
+    }
+    return out.str();
+}
+
+// ============================================================================
+// ClassLayoutCache - Implementación
+// ============================================================================
+
+ClassLayout& ClassLayoutCache::declareClass(const std::string& className, const std::string& scope) {
+    std::string key = scope.empty() ? className : scope + "::" + className;
+    auto& layout = layouts_[key];
+    if (!layout) {
+        layout = std::make_unique<ClassLayout>(className, scope);
+        layout->cache_ = this;
+    }
+    return *layout;
+}
+
+const ClassLayout* ClassLayoutCache::getLayout(const std::string& qualifiedName) {
+    auto it = layouts_.find(qualifiedName);
+    if (it == layouts_.end()) {
+        return nullptr;
+    }
+
+    ClassLayout& layout = *it->second;
+    if (layout.layoutComputed_) {
+        ++hits_;
+        return &layout;
+    }
+
+    // Una clase que se contiene a sí misma no tiene layout
+    if (!computing_.insert(qualifiedName).second) {
+        return nullptr;
+    }
+    layout.computeLayout();
+    computing_.erase(qualifiedName);
+    ++computed_;
+
+    if (paddingAnalysis_) {
+        PaddingReport report = layout.analyzePadding();
+        if (report.paddingBytes > 0 && report.paddingBytes * 100 >= minimumPaddingPercent_ * report.size) {
+            paddingReports_.push_back(std::move(report));
+        }
+    }
+    return &layout;
+}
+
+void ClassLayoutCache::setPaddingAnalysis(bool enabled, size_t minimumPercent) {
+    paddingAnalysis_ = enabled;
+    minimumPaddingPercent_ = minimumPercent;
+}
+
 // ============================================================================
 // ClassLayoutGenerator - Implementación
 // ============================================================================
@@ -0,0 +1,431 @@
+/**
+ * @file MSVCDemangler.cpp
+ * @brief Demangler de los nombres de MSVCNameMangler e índice de símbolos
+ */
+
+#include <compiler/backend/mangling/MSVCDemangler.h>
+#include <compiler/common/utils/ThreadPool.h>
+#include <algorithm>
+#include <array>
+
+namespace cpp20::compiler::backend::mangling {
+
+namespace {
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+/**
+ * @brief Lector de un nombre; escribe directamente en el buffer de salida
+ *
+ * El mangler escribe el nombre antes que su ámbito y el tipo de retorno
+ * después del nombre. Para no necesitar buffers temporales, cada parte se
+ * añade al final y se lleva a su sitio con std::rotate.
+ */
+class Parser {
+public:
+    Parser(std::string_view input, std::string& out) : in_(input), out_(out), base_(out.size()) {}
+
+    bool parse() {
+        if (in_.substr(0, 4) == "??_7") {
+            pos_ = 4;
+            return parseVTable();
+        }
+        if (in_.substr(0, 8) == "??_R0?AV") {
+            pos_ = 8;
+            return parseTypeInfo();
+        }
+        if (in_.size() > 1 && in_[0] == '?') {
+            pos_ = 1;
+            return parseEntity();
+        }
+        return false;
+    }
+
+private:
+    struct Reference {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    std::string_view in_;
+    std::string& out_;
+    size_t base_;               // Lo que ya había en out_ no se toca
+    size_t pos_ = 0;
+    std::array<Reference, 10> references_{};
+    size_t referenceCount_ = 0;
+
+    bool parseVTable() {
+        if (!parseScopedName("@@6B@")) return false;
+        out_ += "::`vftable'";
+        out_.insert(base_, "const ");
+        return true;
+    }
+
+    bool parseTypeInfo() {
+        if (!parseScopedName("@@@8")) return false;
+        out_.insert(base_, "class ");
+        out_ += " `RTTI Type Descriptor'";
+        return true;
+    }
+
+    bool parseEntity() {
+        size_t start = out_.size();
+        if (!parseQualifiedName()) return false;
+        if (pos_ == in_.size()) return true;      // Clase
+
+        size_t signature = pos_;
+        size_t mark = out_.size();
+        auto reset = [&] {
+            pos_ = signature;
+            out_.resize(mark);
+            referenceCount_ = 0;
+        };
+
+        // Variable: un único tipo
+        if (parseType() && pos_ == in_.size()) {
+            out_ += ' ';
+            std::rotate(out_.begin() + start, out_.begin() + mark, out_.end());
+            return true;
+        }
+        reset();
+
+        if (parseFunction(start, mark, 0)) return true;
+        reset();
+
+        char qualifier = signature < in_.size() ? in_[signature] : '\0';
+        if (qualifierText(qualifier).empty()) return false;
+        ++pos_;
+        return parseFunction(start, mark, qualifier);
+    }
+
+    char peek(size_t ahead = 0) const {
+        return pos_ + ahead < in_.size() ? in_[pos_ + ahead] : '\0';
+    }
+
+    bool consume(char c) {
+        if (peek() != c) return false;
+        ++pos_;
+        return true;
+    }
+
+    static std::string_view qualifierText(char c) {
+        switch (c) {
+            case 'B': return " const";
+            case 'C': return " volatile";
+            case 'D': return " const volatile";
+            case 'I': return " __restrict";
+            case 'J': return " const __restrict";
+            case 'K': return " volatile __restrict";
+            case 'L': return " const volatile __restrict";
+            default: return {};
+        }
+    }
+
+    // Un dígito, o @n@ para longitudes de 10 en adelante
+    bool parseLength(size_t& length) {
+        if (isDigit(peek())) {
+            length = static_cast<size_t>(in_[pos_++] - '0');
+            return true;
+        }
+        if (peek() != '@' || !isDigit(peek(1))) return false;
+        ++pos_;
+        length = 0;
+        while (isDigit(peek())) {
+            length = length * 10 + static_cast<size_t>(in_[pos_++] - '0');
+            if (length > in_.size()) return false;
+        }
+        return consume('@');
+    }
+
+    // Nombre con su longitud en caracteres originales; ?hh es un byte escapado
+    bool parseName() {
+        size_t length;
+        if (!parseLength(length)) return false;
+        for (size_t i = 0; i < length; ++i) {
+            char c = peek();
+            if (c == '\0') return false;
+            if (c == '?') {
+                int high = hexValue(peek(1));
+                int low = hexValue(peek(2));
+                if (high < 0 || low < 0) return false;
+                out_ += static_cast<char>((high << 4) | low);
+                pos_ += 3;
+            } else {
+                out_ += c;
+                ++pos_;
+            }
+        }
+        return true;
+    }
+
+    // El terminador @@ nunca va seguido de un dígito; @@n@ abre una parte larga
+    bool atTerminator() const {
+        return peek() == '@' && !isDigit(peek(1));
+    }
+
+    // nombre @ [parte @ ...] @ — el ámbito va después del nombre
+    bool parseQualifiedName() {
+        size_t start = out_.size();
+        if (!parseName()) return false;
+        size_t nameEnd = out_.size();
+        if (!consume('@')) return false;
+
+        while (!atTerminator()) {
+            if (!parseName()) return false;
+            out_ += "::";
+            if (!consume('@')) return false;
+        }
+        ++pos_;
+        std::rotate(out_.begin() + start, out_.begin() + nameEnd, out_.end());
+        return true;
+    }
+
+    // Nombre seguido directamente de su ámbito y de un sufijo fijo (vtable, type_info)
+    bool parseScopedName(std::string_view suffix) {
+        size_t start = out_.size();
+        if (!parseName()) return false;
+        size_t nameEnd = out_.size();
+
+        if (in_.substr(pos_) != suffix) {
+            while (true) {
+                if (!parseName()) return false;
+                out_ += "::";
+                if (in_.substr(pos_) == suffix) break;
+                if (!consume('@')) return false;
+            }
+        }
+        pos_ = in_.size();
+        std::rotate(out_.begin() + start, out_.begin() + nameEnd, out_.end());
+        return true;
+    }
+
+    bool parseType() {
+        char c = peek();
+        ++pos_;
+        switch (c) {
+            case 'X': out_ += "void"; return true;
+            case 'D': out_ += "char"; return true;
+            case 'E': out_ += "unsigned char"; return true;
+            case 'F': out_ += "short"; return true;
+            case 'G': out_ += "unsigned short"; return true;
+            case 'H': out_ += "int"; return true;
+            case 'I': out_ += "unsigned int"; return true;
+            case 'J': out_ += "long"; return true;
+            case 'K': out_ += "unsigned long"; return true;
+            case 'M': out_ += "float"; return true;
+            case 'N': out_ += "double"; return true;
+            case 'O': out_ += "long double"; return true;
+            case 'V': out_ += '?'; return true;        // Tipo que el mangler no conoce
+            case 'P':
+                if (!parseType()) return false;
+                out_ += '*';
+                return true;
+            case 'A':
+                if (!parseType()) return false;
+                out_ += '&';
+                return true;
+            case '_': {
+                char extended = peek();
+                ++pos_;
+                if (extended == 'N') { out_ += "bool"; return true; }
+                if (extended == 'J') { out_ += "long long"; return true; }
+                if (extended == 'K') { out_ += "unsigned long long"; return true; }
+                return false;
+            }
+            default:
+                return false;
+        }
+    }
+
+    // retorno (X | tipos... @) [Z]; el retorno no entra en las back-references
+    bool parseFunction(size_t start, size_t mark, char qualifier) {
+        if (!parseType()) return false;
+        out_ += ' ';
+        size_t returnEnd = out_.size();
+
+        out_ += '(';
+        if (consume('X')) {
+            out_ += "void";
+        } else {
+            bool first = true;
+            while (!consume('@')) {
+                if (!first) out_ += ", ";
+                first = false;
+
+                if (isDigit(peek())) {
+                    size_t index = static_cast<size_t>(in_[pos_++] - '0');
+                    if (index >= referenceCount_) return false;
+                    out_.append(out_, references_[index].offset, references_[index].length);
+                    continue;
+                }
+
+                size_t fragmentStart = pos_;
+                size_t textStart = out_.size();
+                if (!parseType()) return false;
+                if (pos_ - fragmentStart > 1 && referenceCount_ < references_.size()) {
+                    references_[referenceCount_++] = {static_cast<uint32_t>(textStart),
+                                                      static_cast<uint32_t>(out_.size() - textStart)};
+                }
+            }
+            if (first) return false;                // Lista vacía: se escribe X
+        }
+        out_ += ')';
+        out_ += qualifierText(qualifier);
+
+        bool isVirtual = consume('Z');
+        if (pos_ != in_.size()) return false;
+
+        // Hasta aquí el nombre sigue delante: un fallo deja out_ listo para reintentar
+        std::rotate(out_.begin() + start, out_.begin() + mark, out_.begin() + returnEnd);
+        if (isVirtual) {
+            out_.insert(start, "virtual ");
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+bool MSVCDemangler::demangle(std::string_view mangled, std::string& out) {
+    size_t start = out.size();
+    if (Parser(mangled, out).parse()) {
+        return true;
+    }
+    out.resize(start);
+    return false;
+}
+
+std::string MSVCDemangler::demangle(std::string_view mangled) {
+    std::string result;
+    if (!demangle(mangled, result)) {
+        result.assign(mangled);
+    }
+    return result;
+}
+
+// ============================================================================
+// SymbolIndex
+// ============================================================================
+
+SymbolIndex SymbolIndex::build(std::vector<std::string> names, size_t jobs) {
+    using common::utils::parallelFor;
+    using common::utils::ThreadPool;
+
+    SymbolIndex index;
+    index.names_ = std::move(names);
+    size_t count = index.names_.size();
+    if (jobs == 0) jobs = ThreadPool::defaultThreadCount();
+
+    constexpr size_t ChunkSize = 4096;
+    size_t chunks = (count + ChunkSize - 1) / ChunkSize;
+
+    // Cada bloque desmanglea en su propio buffer, que se reutiliza símbolo a símbolo
+    struct Chunk {
+        std::string text;
+        std::vector<Entry> entries;
+    };
+    std::vector<Chunk> parts(chunks);
+    parallelFor(chunks, jobs, [&](size_t c) {
+        Chunk& part = parts[c];
+        size_t begin = c * ChunkSize;
+        size_t end = std::min(count, begin + ChunkSize);
+        part.entries.reserve(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            size_t offset = part.text.size();
+            if (!MSVCDemangler::demangle(index.names_[i], part.text)) {
+                part.text += index.names_[i];
+            }
+            part.entries.push_back({static_cast<uint32_t>(i), static_cast<uint32_t>(offset),
+                                    static_cast<uint32_t>(part.text.size() - offset)});
+        }
+    });
+
+    std::vector<size_t> bases(chunks);
+    size_t total = 0;
+    for (size_t c = 0; c < chunks; ++c) {
+        bases[c] = total;
+        total += parts[c].text.size();
+    }
+    index.text_.resize(total);
+    index.entries_.resize(count);
+
+    auto less = [&index](const Entry& a, const Entry& b) {
+        std::string_view left = index.demangledOf(a);
+        std::string_view right = index.demangledOf(b);
+        return left != right ? left < right : a.ordinal < b.ordinal;
+    };
+
+    // Copia al buffer común y orden de cada bloque en su hilo
+    parallelFor(chunks, jobs, [&](size_t c) {
+        Chunk& part = parts[c];
+        std::copy(part.text.begin(), part.text.end(), index.text_.begin() + bases[c]);
+        auto first = index.entries_.begin() + c * ChunkSize;
+        for (size_t i = 0; i < part.entries.size(); ++i) {
+            Entry entry = part.entries[i];
+            entry.offset += static_cast<uint32_t>(bases[c]);
+            first[i] = entry;
+        }
+        std::sort(first, first + part.entries.size(), less);
+        std::string().swap(part.text);
+    });
+
+    // Mezcla por parejas de bloques; las parejas de un nivel son independientes
+    for (size_t width = ChunkSize; width < count; width *= 2) {
+        size_t pairs = (count + 2 * width - 1) / (2 * width);
+        parallelFor(pairs, jobs, [&](size_t p) {
+            size_t begin = p * 2 * width;
+            size_t middle = std::min(count, begin + width);
+            size_t end = std::min(count, begin + 2 * width);
+            std::inplace_merge(index.entries_.begin() + begin, index.entries_.begin() + middle,
+                               index.entries_.begin() + end, less);
+        });
+    }
+
+    index.byOrdinal_.resize(count);
+    index.byMangled_.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        index.byOrdinal_[index.entries_[i].ordinal] = static_cast<uint32_t>(i);
+        index.byMangled_[i] = static_cast<uint32_t>(i);
+    }
+    std::sort(index.byMangled_.begin(), index.byMangled_.end(), [&index](uint32_t a, uint32_t b) {
+        return index.names_[index.entries_[a].ordinal] < index.names_[index.entries_[b].ordinal];
+    });
+    return index;
+}
+
+std::string_view SymbolIndex::demangledByOrdinal(uint32_t ordinal) const {
+    if (ordinal >= byOrdinal_.size()) return {};
+    return demangledOf(entries_[byOrdinal_[ordinal]]);
+}
+
+std::pair<size_t, size_t> SymbolIndex::findPrefix(std::string_view prefix) const {
+    auto first = std::lower_bound(entries_.begin(), entries_.end(), prefix,
+                                  [this](const Entry& entry, std::string_view value) {
+                                      return demangledOf(entry) < value;
+                                  });
+    auto last = std::partition_point(first, entries_.end(), [&](const Entry& entry) {
+        return demangledOf(entry).substr(0, prefix.size()) == prefix;
+    });
+    return {static_cast<size_t>(first - entries_.begin()), static_cast<size_t>(last - entries_.begin())};
+}
+
+size_t SymbolIndex::findMangled(std::string_view mangled) const {
+    auto it = std::lower_bound(byMangled_.begin(), byMangled_.end(), mangled,
+                               [this](uint32_t position, std::string_view value) {
+                                   return std::string_view(names_[entries_[position].ordinal]) < value;
+                               });
+    if (it == byMangled_.end() || names_[entries_[*it].ordinal] != mangled) {
+        return entries_.size();
+    }
+    return *it;
+}
+
+} // namespace cpp20::compiler::backend::mangling
@@ -4,7 +4,7 @@
  */
 
 #include <compiler/backend/mangling/MSVCNameMangler.h>
-#include <sstream>
+#include <compiler/backend/mangling/MSVCDemangler.h>
 #include <algorithm>
 #include <unordered_map>
 #include <iomanip>
@@ -39,66 +39,86 @@ MSVCNameMangler::MSVCNameMangler() = default;
 MSVCNameMangler::~MSVCNameMangler() = default;
 
 std::string MSVCNameMangler::mangleFunction(const FunctionInfo& funcInfo) {
-    std::stringstream result;
+    buffer_.clear();
 
     // Prefijo para funciones
-    result << "?";
+    buffer_ += '?';
 
     // Nombre base
-    result << mangleBaseName(funcInfo.name);
+    appendBaseName(buffer_, funcInfo.name);
 
     // Scope/namespace si existe
     if (!funcInfo.scope.empty()) {
-        result << "@" << mangleScope(funcInfo.scope);
+        buffer_ += '@';
+        buffer_ += cachedScope(funcInfo.scope);
     }
 
     // Sufijo con información de tipos
-    result << generateFunctionSuffix(funcInfo);
+    buffer_ += "@@";
+    if (funcInfo.qualifiers != FunctionQualifiers::None) {
+        buffer_ += mangleQualifiers(funcInfo.qualifiers);
+    }
+    buffer_ += cachedType(funcInfo.returnType);
+    appendParameterList(buffer_, funcInfo.parameterTypes);
 
-    return result.str();
+    // Información adicional para funciones virtuales
+    if (funcInfo.isVirtual) {
+        buffer_ += 'Z'; // Indicador de función virtual
+    }
+
+    return buffer_;
 }
 
 std::string MSVCNameMangler::mangleVariable(const VariableInfo& varInfo) {
-    std::stringstream result;
+    buffer_.clear();
 
     // Prefijo para variables
-    result << "?";
+    buffer_ += '?';
 
     // Nombre base
-    result << mangleBaseName(varInfo.name);
+    appendBaseName(buffer_, varInfo.name);
 
     // Scope si existe
     if (!varInfo.scope.empty()) {
-        result << "@" << mangleScope(varInfo.scope);
+        buffer_ += '@';
+        buffer_ += cachedScope(varInfo.scope);
     }
 
     // Tipo
-    result << "@@" << mangleType(varInfo.type);
+    buffer_ += "@@";
+    buffer_ += cachedType(varInfo.type);
 
-    return result.str();
+    return buffer_;
 }
 
 std::string MSVCNameMangler::mangleClass(const ClassInfo& classInfo) const {
-    std::stringstream result;
-
-    // Prefijo para clases
-    result << "?";
+    std::string result = "?";
 
     // Nombre base
-    result << mangleBaseName(classInfo.name);
+    appendBaseName(result, classInfo.name);
 
     // Scope si existe
     if (!classInfo.scope.empty()) {
-        result << "@" << mangleScope(classInfo.scope);
+        result += '@';
+        appendScope(result, classInfo.scope);
     }
 
     // Sufijo
-    result << "@@";
+    result += "@@";
 
-    return result.str();
+    return result;
 }
 
 std::string MSVCNameMangler::mangleType(const std::string& typeName) {
+    return cachedType(typeName);
+}
+
+const std::string& MSVCNameMangler::cachedType(const std::string& typeName) {
+    auto cached = typeCache_.find(typeName);
+    if (cached != typeCache_.end()) {
+        return cached->second;
+    }
+
     // Mapa de tipos básicos
     static const std::unordered_map<std::string, std::string> basicTypes = {
         {"void", VOID_CODE},
@@ -118,153 +138,150 @@ std::string MSVCNameMangler::mangleType(const std::string& typeName) {
         {"long double", LONGDOUBLE_CODE}
     };
 
+    std::string fragment;
     auto it = basicTypes.find(typeName);
     if (it != basicTypes.end()) {
-        return it->second;
+        fragment = it->second;
+    } else if (size_t star = typeName.find('*'); star != std::string::npos) {
+        // Tipos compuestos - simplificados para esta implementación
+        fragment = "P" + cachedType(typeName.substr(0, star));
+    } else if (size_t amp = typeName.find('&'); amp != std::string::npos) {
+        fragment = "A" + cachedType(typeName.substr(0, amp));
+    } else {
+        // Para tipos no reconocidos, usar código genérico
+        fragment = "V"; // Tipo desconocido
     }
 
-    // Tipos compuestos - simplificados para esta implementación
-    if (typeName.find("*") != std::string::npos) {
-        return manglePointerType(typeName.substr(0, typeName.find("*")));
-    }
+    // Los nodos de unordered_map no se mueven: la referencia sigue válida
+    return typeCache_.emplace(typeName, std::move(fragment)).first->second;
+}
 
-    if (typeName.find("&") != std::string::npos) {
-        return mangleReferenceType(typeName.substr(0, typeName.find("&")));
+const std::string& MSVCNameMangler::cachedScope(const std::string& scope) {
+    auto cached = scopeCache_.find(scope);
+    if (cached != scopeCache_.end()) {
+        return cached->second;
     }
 
-    // Para tipos no reconocidos, usar código genérico
-    return "V"; // Tipo desconocido
+    std::string fragment;
+    appendScope(fragment, scope);
+    return scopeCache_.emplace(scope, std::move(fragment)).first->second;
 }
 
-std::string MSVCNameMangler::manglePointerType(const std::string& pointeeType) {
-    std::stringstream result;
-
-    // Código para puntero
-    result << "P";
-
-    // Tipo apuntado
-    result << mangleType(pointeeType);
+void MSVCNameMangler::clearCache() {
+    typeCache_.clear();
+    scopeCache_.clear();
+}
 
-    return result.str();
+std::string MSVCNameMangler::manglePointerType(const std::string& pointeeType) {
+    // Código para puntero seguido del tipo apuntado
+    return "P" + cachedType(pointeeType);
 }
 
 std::string MSVCNameMangler::mangleReferenceType(const std::string& refereeType) {
-    std::stringstream result;
-
-    // Código para referencia (l-value reference)
-    result << "A";
-
-    // Tipo referenciado
-    result << mangleType(refereeType);
-
-    return result.str();
+    // Código para referencia (l-value reference) seguido del tipo referenciado
+    return "A" + cachedType(refereeType);
 }
 
 std::string MSVCNameMangler::mangleArrayType(const std::string& elementType, size_t size) {
-    std::stringstream result;
-
-    // Código para array
-    result << "Y";
-
-    // Tamaño del array
-    if (size > 0) {
-        result << encodeLength(size);
+    // Sin tamaño conocido el array decae a puntero const, como en los parámetros
+    if (size == 0) {
+        return "QA" + cachedType(elementType);
     }
 
-    // Tipo de elementos
-    result << mangleType(elementType);
-
-    return result.str();
+    // Y, número de dimensiones, cada dimensión y el tipo de los elementos
+    std::string result = "Y";
+    appendNumber(result, 1);
+    appendNumber(result, size);
+    result += cachedType(elementType);
+    return result;
 }
 
 std::string MSVCNameMangler::mangleFunctionType(const std::string& returnType,
                                                const std::vector<std::string>& paramTypes) {
-    std::stringstream result;
-
     // Código para tipo función
-    result << "$$A6";
+    std::string result = "$$A6";
 
     // Tipo de retorno
-    result << mangleType(returnType);
+    result += cachedType(returnType);
 
     // Parámetros
-    result << mangleParameterList(paramTypes);
+    appendParameterList(result, paramTypes);
 
-    return result.str();
+    return result;
 }
 
 std::string MSVCNameMangler::generateFunctionPrefix(const FunctionInfo& funcInfo) {
-    std::stringstream result;
-
     // Prefijo específico según tipo de función
-    if (funcInfo.isVirtual) {
-        result << "?";
-    } else if (funcInfo.isStatic) {
-        result << "?";
-    } else {
-        result << "?";
-    }
-
-    return result.str();
+    (void)funcInfo;
+    return "?";
 }
 
 std::string MSVCNameMangler::generateFunctionSuffix(const FunctionInfo& funcInfo) {
-    std::stringstream result;
-
-    // Separador
-    result << "@@";
+    std::string result = "@@";
 
     // Calificadores
     if (funcInfo.qualifiers != FunctionQualifiers::None) {
-        result << mangleQualifiers(funcInfo.qualifiers);
+        result += mangleQualifiers(funcInfo.qualifiers);
     }
 
     // Tipo de retorno
-    result << mangleType(funcInfo.returnType);
+    result += cachedType(funcInfo.returnType);
 
     // Lista de parámetros
-    result << mangleParameterList(funcInfo.parameterTypes);
+    appendParameterList(result, funcInfo.parameterTypes);
 
     // Información adicional para funciones virtuales
     if (funcInfo.isVirtual) {
-        result << "Z"; // Indicador de función virtual
+        result += 'Z'; // Indicador de función virtual
     }
 
-    return result.str();
+    return result;
 }
 
 std::string MSVCNameMangler::mangleBaseName(const std::string& name) const {
-    std::stringstream result;
+    std::string result;
+    appendBaseName(result, name);
+    return result;
+}
 
+void MSVCNameMangler::appendBaseName(std::string& out, std::string_view name) const {
     // Codificar longitud del nombre
-    result << encodeLength(name.length());
+    appendLength(out, name.length());
 
     // Escapar caracteres especiales
-    result << escapeSpecialChars(name);
-
-    return result.str();
+    static constexpr char hexDigits[] = "0123456789abcdef";
+    for (char c : name) {
+        if (isValidMangledChar(c)) {
+            out += c;
+        } else {
+            auto byte = static_cast<unsigned char>(c);
+            out += '?';
+            out += hexDigits[byte >> 4];
+            out += hexDigits[byte & 0xf];
+        }
+    }
 }
 
 std::string MSVCNameMangler::mangleScope(const std::string& scope) const {
-    std::stringstream result;
+    std::string result;
+    appendScope(result, scope);
+    return result;
+}
 
+void MSVCNameMangler::appendScope(std::string& out, std::string_view scope) const {
     // Dividir scope por ::
     size_t pos = 0;
     size_t found;
-    std::string remaining = scope;
-
-    while ((found = remaining.find("::", pos)) != std::string::npos) {
-        std::string part = remaining.substr(pos, found - pos);
-        result << mangleBaseName(part) << "@";
+    while ((found = scope.find("::", pos)) != std::string_view::npos) {
+        appendBaseName(out, scope.substr(pos, found - pos));
+        out += '@';
         pos = found + 2;
     }
 
     // Última parte
-    if (pos < remaining.length()) {
-        result << mangleBaseName(remaining.substr(pos));
+    if (pos < scope.length()) {
+        appendBaseName(out, scope.substr(pos));
     }
-
-    return result.str();
 }
 
 std::string MSVCNameMangler::mangleQualifiers(FunctionQualifiers qualifiers) {
@@ -291,51 +308,100 @@ std::string MSVCNameMangler::mangleQualifiers(FunctionQualifiers qualifiers) {
 }
 
 std::string MSVCNameMangler::mangleParameterList(const std::vector<std::string>& paramTypes) {
-    std::stringstream result;
+    std::string result;
+    appendParameterList(result, paramTypes);
+    return result;
+}
 
+void MSVCNameMangler::appendParameterList(std::string& out, const std::vector<std::string>& paramTypes) {
     if (paramTypes.empty()) {
-        result << VOID_CODE; // Sin parámetros
-    } else {
-        for (const auto& paramType : paramTypes) {
-            result << mangleType(paramType);
-        }
-        result << "@"; // Terminador
+        out += VOID_CODE; // Sin parámetros
+        return;
     }
 
-    return result.str();
+    // Como en MSVC, los tipos de un solo carácter no entran en la tabla y,
+    // una vez llena con 10, los siguientes se escriben enteros
+    ParameterBackReferences backReferences;
+    for (const auto& paramType : paramTypes) {
+        const std::string& fragment = cachedType(paramType);
+
+        size_t index = 0;
+        if (fragment.size() > 1) {
+            while (index < backReferences.count && *backReferences.types[index] != fragment) {
+                ++index;
+            }
+        }
+        if (fragment.size() > 1 && index < backReferences.count) {
+            out += static_cast<char>('0' + index);
+            continue;
+        }
+
+        out += fragment;
+        if (fragment.size() > 1 && backReferences.count < backReferences.types.size()) {
+            backReferences.types[backReferences.count++] = &fragment;
+        }
+    }
+    out += '@'; // Terminador
 }
 
 std::string MSVCNameMangler::encodeLength(size_t length) const {
+    std::string result;
+    appendLength(result, length);
+    return result;
+}
+
+void MSVCNameMangler::appendLength(std::string& out, size_t length) const {
     if (length < 10) {
-        return std::to_string(length);
+        out += static_cast<char>('0' + length);
     } else {
         // Para longitudes mayores, usar codificación especial
-        std::stringstream result;
-        result << "@" << length << "@";
-        return result.str();
+        out += '@';
+        out += std::to_string(length);
+        out += '@';
+    }
+}
+
+void MSVCNameMangler::appendNumber(std::string& out, size_t value) const {
+    // 1..10 como un dígito (valor - 1); el resto en hexadecimal con 'A'..'P' y '@'
+    if (value >= 1 && value <= 10) {
+        out += static_cast<char>('0' + value - 1);
+        return;
+    }
+    char digits[sizeof(size_t) * 2];
+    size_t count = 0;
+    do {
+        digits[count++] = static_cast<char>('A' + (value & 0xf));
+        value >>= 4;
+    } while (value != 0);
+    while (count > 0) {
+        out += digits[--count];
     }
+    out += '@';
 }
 
 bool MSVCNameMangler::isValidMangledChar(char c) const {
     return (c >= 'A' && c <= 'Z') ||
+           (c >= 'a' && c <= 'z') ||
            (c >= '0' && c <= '9') ||
            c == '_' || c == '@' || c == '$';
 }
 
 std::string MSVCNameMangler::escapeSpecialChars(const std::string& str) const {
-    std::stringstream result;
-
+    std::string result;
+    result.reserve(str.size());
+    static constexpr char hexDigits[] = "0123456789abcdef";
     for (char c : str) {
         if (isValidMangledChar(c)) {
-            result << c;
+            result += c;
         } else {
             // Escapar caracteres especiales
-            result << "?" << std::hex << std::setw(2) << std::setfill('0')
-                   << static_cast<int>(static_cast<unsigned char>(c));
+            auto byte = static_cast<unsigned char>(c);
+            result += '?';
+            result += hexDigits[byte >> 4];
+            result += hexDigits[byte & 0xf];
         }
     }
-
-    return result.str();
+    return result;
 }
 
 // ============================================================================
@@ -343,50 +409,8 @@ std::string MSVCNameMangler::escapeSpecialChars(const std::string& str) const {
 // ============================================================================
 
 std::string MangledNameUtils::demangle(const std::string& mangled) {
-    // Implementación simplificada de demangling
-    // En un compilador real, esto sería mucho más complejo
-
-    if (mangled.empty() || mangled[0] != '?') {
-        return mangled; // No está mangled
-    }
-
-    std::stringstream result;
-    size_t pos = 1; // Saltar el '?'
-
-    // Extraer nombre base
-    if (pos < mangled.length() && isdigit(mangled[pos])) {
-        int length = mangled[pos] - '0';
-        pos++;
-        if (pos + length <= mangled.length()) {
-            result << mangled.substr(pos, length);
-            pos += length;
-        }
-    }
-
-    // Buscar scope
-    if (pos < mangled.length() && mangled[pos] == '@') {
-        pos++; // Saltar '@'
-        result << "::";
-
-        // Extraer componentes del scope
-        while (pos < mangled.length() && mangled[pos] != '@') {
-            if (isdigit(mangled[pos])) {
-                int length = mangled[pos] - '0';
-                pos++;
-                if (pos + length <= mangled.length()) {
-                    result << mangled.substr(pos, length);
-                    pos += length;
-                }
-            }
-
-            if (pos < mangled.length() && mangled[pos] == '@') {
-                result << "::";
-                pos++;
-            }
-        }
-    }
-
-    return result.str();
+    // Lo que no reconoce MSVCDemangler (o no está mangled) se devuelve tal cual
+    return MSVCDemangler::demangle(mangled);
 }
 
 bool MangledNameUtils::isMangled(const std::string& name) {
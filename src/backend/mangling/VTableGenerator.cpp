@@ -100,6 +100,42 @@ std::vector<uint8_t> VTableGenerator::generateRTTIData(const RTTIInfo& rttiInfo)
     return data;
 }
 
+const VirtualFunctionInfo* VTableGenerator::keyFunction(const ClassLayout& layout) {
+    for (const auto& vfunc : layout.getVirtualFunctions()) {
+        if (!vfunc.isPureVirtual && !vfunc.isInline) {
+            return &vfunc;
+        }
+    }
+    return nullptr;
+}
+
+VTableLinkage VTableGenerator::vtableLinkage(const ClassLayout& layout) {
+    if (!layout.hasVirtualFunctions()) {
+        return VTableLinkage::None;
+    }
+    const VirtualFunctionInfo* key = keyFunction(layout);
+    if (!key) {
+        return VTableLinkage::Comdat;
+    }
+    return key->isDefined ? VTableLinkage::Strong : VTableLinkage::None;
+}
+
+bool VTableGenerator::requireRTTI(const std::string& qualifiedName, RTTIUse use) {
+    if (!rttiEnabled_ && use != RTTIUse::Exception) {
+        return false;
+    }
+    rttiUses_.insert(qualifiedName);
+    return true;
+}
+
+VTableLinkage VTableGenerator::rttiLinkage(const ClassLayout& layout) const {
+    // Con RTTI, la vtable apunta al type_info: se emiten juntos
+    if (rttiEnabled_ && layout.hasVirtualFunctions()) {
+        return vtableLinkage(layout);
+    }
+    return rttiUses_.count(layout.getQualifiedName()) ? VTableLinkage::Comdat : VTableLinkage::None;
+}
+
 size_t VTableGenerator::calculateVTableSize(const std::vector<VTableEntry>& entries) {
     return entries.size() * 8; // 8 bytes por entrada en x64
 }
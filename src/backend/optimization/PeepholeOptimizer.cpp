@@ -18,51 +18,100 @@ PeepholeOptimizer::PeepholeOptimizer() {
 
 PeepholeOptimizer::~PeepholeOptimizer() = default;
 
-std::vector<X86Instruction> PeepholeOptimizer::optimize(const std::vector<X86Instruction>& instructions) {
-    stats_.instructionsProcessed = instructions.size();
-
-    auto optimized = instructions;
-
-    // Aplicar múltiples pasadas de optimización
-    bool changed = true;
-    int maxPasses = 3; // Límite para evitar bucles infinitos
-    int pass = 0;
+namespace {
 
-    while (changed && pass < maxPasses) {
-        changed = false;
-        size_t originalSize = optimized.size();
+/**
+ * @brief Las etiquetas de bloque son NOP con el nombre en el comentario
+ */
+bool isLabel(const X86Instruction& inst) {
+    return inst.opcode == X86Opcode::NOP && !inst.comment.empty();
+}
 
-        // Aplicar optimizaciones de mirilla
-        optimized = applyPeepholeOptimizations(optimized);
+bool isRegisterImmediate(const X86Instruction& inst) {
+    return inst.operands.size() >= 2 &&
+           inst.operands[0].mode == AddressingMode::Register &&
+           inst.operands[1].mode == AddressingMode::Immediate;
+}
 
-        // Eliminar NOPs
-        optimized = removeNops(optimized);
+/**
+ * @brief Valor con signo que aporta un ADD/SUB reg, imm
+ */
+int64_t signedImmediate(const X86Instruction& inst) {
+    return inst.opcode == X86Opcode::SUB ? -inst.operands[1].immediate : inst.operands[1].immediate;
+}
 
-        // Fusionar instrucciones
-        optimized = fuseInstructions(optimized);
+} // namespace
 
-        // Optimizar uso de registros
-        optimized = optimizeRegisterUsage(optimized);
+std::vector<X86Instruction> PeepholeOptimizer::optimize(std::vector<X86Instruction> instructions) {
+    stats_.instructionsProcessed = instructions.size();
 
-        // Verificar si hubo cambios
-        if (optimized.size() != originalSize) {
-            changed = true;
+    // [0, done) ya está optimizado y [next, size) falta por ver; los
+    // reemplazos se escriben justo antes de next para revisarlos otra vez.
+    // El presupuesto solo importa con patrones propios que no converjan.
+    size_t done = 0;
+    size_t next = 0;
+    size_t budget = 4 * instructions.size() + 16;
+    std::vector<X86Instruction> replacement;
+
+    while (next < instructions.size()) {
+        if (isEffectiveNop(instructions[next])) {
+            ++next;
+            continue;
         }
-
-        pass++;
+        if (done != next) instructions[done] = std::move(instructions[next]);
+        ++done;
+        ++next;
+        if (budget == 0) continue;
+
+        auto [index, length] = findMatch(std::span<const X86Instruction>(instructions.data(), done));
+        if (length == 0) continue;
+        --budget;
+
+        const PeepholePattern& pattern = patterns_[index];
+        size_t start = done - length;
+        PeepholeWindow window(instructions.data() + start, length);
+
+        replacement.clear();
+        for (size_t i = 0; i < pattern.replacement.size(); ++i) {
+            X86Instruction inst(pattern.replacement[i]);
+            inst.operands = window[std::min(i, length - 1)].operands;
+            inst.comment = pattern.description;
+            replacement.push_back(std::move(inst));
+        }
+        if (pattern.rewrite) pattern.rewrite(window, replacement);
+
+        // El hueco entre start y next siempre cabe un reemplazo que no crece
+        size_t room = next - start;
+        if (replacement.size() > room) {
+            instructions.insert(instructions.begin() + static_cast<std::ptrdiff_t>(next),
+                                replacement.size() - room, X86Instruction());
+            next += replacement.size() - room;
+        }
+        next -= replacement.size();
+        std::move(replacement.begin(), replacement.end(),
+                  instructions.begin() + static_cast<std::ptrdiff_t>(next));
+        done = start;
+
+        stats_.optimizationsApplied++;
+        stats_.patternUsage[pattern.description]++;
+        if (replacement.size() > length) stats_.instructionsAdded += replacement.size() - length;
     }
 
-    stats_.instructionsRemoved = stats_.instructionsProcessed - optimized.size();
+    instructions.resize(done);
+    stats_.instructionsRemoved = stats_.instructionsProcessed > done ? stats_.instructionsProcessed - done : 0;
 
-    return optimized;
+    return instructions;
 }
 
 void PeepholeOptimizer::addPattern(const PeepholePattern& pattern) {
     patterns_.push_back(pattern);
+    indexPattern(patterns_.size() - 1);
 }
 
 void PeepholeOptimizer::clearPatterns() {
     patterns_.clear();
+    patternsByOpcode_.clear();
+    maxPatternLength_ = 0;
     initializeStandardPatterns();
 }
 
@@ -70,13 +119,20 @@ void PeepholeOptimizer::resetStats() {
     stats_ = OptimizationStats{};
 }
 
+void PeepholeOptimizer::indexPattern(size_t index) {
+    const PeepholePattern& pattern = patterns_[index];
+    if (pattern.pattern.empty()) return;
+    patternsByOpcode_[pattern.pattern.front()].push_back(index);
+    maxPatternLength_ = std::max(maxPatternLength_, pattern.pattern.size());
+}
+
 void PeepholeOptimizer::initializeStandardPatterns() {
     // Patrón 1: MOV reg, reg -> eliminar (mov redundante)
     patterns_.emplace_back(
         std::vector<X86Opcode>{X86Opcode::MOV},
         std::vector<X86Opcode>{}, // Eliminar
         "Redundant MOV elimination",
-        [this](const std::vector<X86Instruction>& window) {
+        [](PeepholeWindow window) {
             if (window.size() >= 1) {
                 const auto& inst = window[0];
                 return InstructionAnalysis::isIneffectiveMove(inst);
@@ -90,7 +146,7 @@ void PeepholeOptimizer::initializeStandardPatterns() {
         std::vector<X86Opcode>{X86Opcode::ADD},
         std::vector<X86Opcode>{},
         "ADD by zero elimination",
-        [](const std::vector<X86Instruction>& window) {
+        [](PeepholeWindow window) {
             if (window.size() >= 1) {
                 const auto& inst = window[0];
                 return inst.opcode == X86Opcode::ADD &&
@@ -107,7 +163,7 @@ void PeepholeOptimizer::initializeStandardPatterns() {
         std::vector<X86Opcode>{X86Opcode::SUB},
         std::vector<X86Opcode>{},
         "SUB by zero elimination",
-        [](const std::vector<X86Instruction>& window) {
+        [](PeepholeWindow window) {
             if (window.size() >= 1) {
                 const auto& inst = window[0];
                 return inst.opcode == X86Opcode::SUB &&
@@ -124,7 +180,7 @@ void PeepholeOptimizer::initializeStandardPatterns() {
         std::vector<X86Opcode>{X86Opcode::MOV, X86Opcode::MOV},
         std::vector<X86Opcode>{X86Opcode::MOV}, // Simplificar a un MOV
         "MOV pair optimization",
-        [this](const std::vector<X86Instruction>& window) {
+        [this](PeepholeWindow window) {
             if (window.size() >= 2) {
                 const auto& inst1 = window[0];
                 const auto& inst2 = window[1];
@@ -136,73 +192,75 @@ void PeepholeOptimizer::initializeStandardPatterns() {
         }
     );
 
-    // Patrón 5: CMP reg, 0; JE/JNE -> TEST reg, reg; JE/JNE
+    // Patrón 5: CMP reg, 0 -> TEST reg, reg (mismos flags para JE/JNE/JL/JGE)
     patterns_.emplace_back(
         std::vector<X86Opcode>{X86Opcode::CMP},
         std::vector<X86Opcode>{X86Opcode::TEST},
         "CMP to TEST optimization",
-        [](const std::vector<X86Instruction>& window) {
+        [](PeepholeWindow window) {
             if (window.size() >= 1) {
                 const auto& inst = window[0];
                 return inst.opcode == X86Opcode::CMP &&
-                       inst.operands.size() >= 2 &&
-                       inst.operands[1].mode == AddressingMode::Immediate &&
+                       isRegisterImmediate(inst) &&
                        inst.operands[1].immediate == 0;
             }
             return false;
+        },
+        [](PeepholeWindow, std::span<X86Instruction> replacement) {
+            replacement[0].operands[1] = replacement[0].operands[0];
         }
     );
-}
-
-std::vector<X86Instruction> PeepholeOptimizer::applyPeepholeOptimizations(
-    const std::vector<X86Instruction>& instructions,
-    size_t windowSize) {
-
-    std::vector<X86Instruction> result;
-    size_t i = 0;
 
-    while (i < instructions.size()) {
-        bool matched = false;
-
-        // Probar cada patrón
-        for (const auto& pattern : patterns_) {
-            if (pattern.pattern.size() > instructions.size() - i) {
-                continue; // No hay suficientes instrucciones
-            }
-
-            // Extraer ventana
-            std::vector<X86Instruction> window(
-                instructions.begin() + i,
-                instructions.begin() + i + pattern.pattern.size()
+    // Patrón 6: ADD/SUB reg, imm; ADD/SUB reg, imm -> ADD reg, imm1 + imm2
+    for (X86Opcode first : {X86Opcode::ADD, X86Opcode::SUB}) {
+        for (X86Opcode second : {X86Opcode::ADD, X86Opcode::SUB}) {
+            patterns_.emplace_back(
+                std::vector<X86Opcode>{first, second},
+                std::vector<X86Opcode>{X86Opcode::ADD},
+                "ADD/SUB immediate folding",
+                [](PeepholeWindow window) {
+                    if (window.size() < 2) return false;
+                    const auto& inst1 = window[0];
+                    const auto& inst2 = window[1];
+                    if (!isRegisterImmediate(inst1) || !isRegisterImmediate(inst2) ||
+                        inst1.operands[0].reg != inst2.operands[0].reg) {
+                        return false;
+                    }
+                    int64_t sum = signedImmediate(inst1) + signedImmediate(inst2);
+                    return sum >= INT32_MIN && sum <= INT32_MAX;
+                },
+                [](PeepholeWindow window, std::span<X86Instruction> replacement) {
+                    replacement[0].operands[1].immediate = signedImmediate(window[0]) + signedImmediate(window[1]);
+                }
             );
+        }
+    }
 
-            // Verificar coincidencia
-            if (matchesPattern(window, pattern)) {
-                // Aplicar reemplazo
-                auto replacement = applyPattern(window, pattern);
-                result.insert(result.end(), replacement.begin(), replacement.end());
-
-                // Actualizar estadísticas
-                stats_.optimizationsApplied++;
-                stats_.patternUsage[pattern.description]++;
+    for (size_t i = 0; i < patterns_.size(); ++i) indexPattern(i);
+}
 
-                i += pattern.pattern.size();
-                matched = true;
-                break;
-            }
+std::pair<size_t, size_t> PeepholeOptimizer::findMatch(std::span<const X86Instruction> done) const {
+    // Las ventanas no cruzan etiquetas: se llega a un bloque desde fuera
+    size_t longest = std::min(maxPatternLength_, done.size());
+    for (size_t length = 1; length <= longest; ++length) {
+        if (isLabel(done[done.size() - length])) {
+            longest = length - 1;
+            break;
         }
+    }
 
-        if (!matched) {
-            // No hubo coincidencia, copiar instrucción tal cual
-            result.push_back(instructions[i]);
-            i++;
+    for (size_t length = longest; length > 0; --length) {
+        PeepholeWindow window = done.last(length);
+        auto it = patternsByOpcode_.find(window[0].opcode);
+        if (it == patternsByOpcode_.end()) continue;
+        for (size_t index : it->second) {
+            if (matchesPattern(window, patterns_[index])) return {index, length};
         }
     }
-
-    return result;
+    return {patterns_.size(), 0};
 }
 
-bool PeepholeOptimizer::matchesPattern(const std::vector<X86Instruction>& window,
+bool PeepholeOptimizer::matchesPattern(PeepholeWindow window,
                                       const PeepholePattern& pattern) const {
 
     // Verificar opcodes
@@ -224,118 +282,6 @@ bool PeepholeOptimizer::matchesPattern(const std::vector<X86Instruction>& window
     return true;
 }
 
-std::vector<X86Instruction> PeepholeOptimizer::applyPattern(
-    const std::vector<X86Instruction>& window,
-    const PeepholePattern& pattern) const {
-
-    std::vector<X86Instruction> result;
-
-    // Si el reemplazo está vacío, no añadir nada (eliminación)
-    if (pattern.replacement.empty()) {
-        return result;
-    }
-
-    // Para esta implementación simplificada, crear instrucciones básicas
-    // En un compilador real, esto sería más sofisticado
-    for (auto opcode : pattern.replacement) {
-        X86Instruction inst(opcode);
-        // Copiar operandos de la primera instrucción de la ventana (simplificado)
-        if (!window.empty()) {
-            inst.operands = window[0].operands;
-            inst.comment = pattern.description;
-        }
-        result.push_back(inst);
-    }
-
-    return result;
-}
-
-std::vector<X86Instruction> PeepholeOptimizer::removeNops(const std::vector<X86Instruction>& instructions) {
-    std::vector<X86Instruction> result;
-
-    for (const auto& inst : instructions) {
-        if (!isEffectiveNop(inst)) {
-            result.push_back(inst);
-        } else {
-            stats_.instructionsRemoved++;
-        }
-    }
-
-    return result;
-}
-
-std::vector<X86Instruction> PeepholeOptimizer::fuseInstructions(const std::vector<X86Instruction>& instructions) {
-    std::vector<X86Instruction> result;
-
-    for (size_t i = 0; i < instructions.size(); ++i) {
-        const auto& inst = instructions[i];
-
-        // Intentar fusionar con la siguiente instrucción
-        if (i + 1 < instructions.size()) {
-            const auto& nextInst = instructions[i + 1];
-
-            if (InstructionAnalysis::canFuseInstructions(inst, nextInst)) {
-                // Fusionar instrucciones (simplificado)
-                X86Instruction fusedInst = inst; // Mantener la primera
-                fusedInst.comment = "Fused instruction";
-                result.push_back(fusedInst);
-                i++; // Saltar la siguiente
-                stats_.optimizationsApplied++;
-                continue;
-            }
-        }
-
-        result.push_back(inst);
-    }
-
-    return result;
-}
-
-std::vector<X86Instruction> PeepholeOptimizer::optimizeRegisterUsage(const std::vector<X86Instruction>& instructions) {
-    // Optimizaciones de uso de registros (simplificado)
-    // En un compilador real, esto incluiría análisis de interferencia, etc.
-
-    std::vector<X86Instruction> result = instructions;
-
-    // Optimización simple: eliminar asignaciones temporales no utilizadas
-    std::unordered_map<X86Register, size_t> lastUse;
-
-    // Primera pasada: registrar último uso de cada registro
-    for (size_t i = 0; i < result.size(); ++i) {
-        const auto& inst = result[i];
-        auto usedRegs = InstructionAnalysis::getUsedRegisters(inst);
-
-        for (auto reg : usedRegs) {
-            lastUse[reg] = i;
-        }
-    }
-
-    // Segunda pasada: eliminar instrucciones que definen registros no utilizados
-    std::vector<X86Instruction> optimized;
-    for (size_t i = 0; i < result.size(); ++i) {
-        const auto& inst = result[i];
-        auto definedRegs = InstructionAnalysis::getDefinedRegisters(inst);
-
-        bool allDead = true;
-        for (auto reg : definedRegs) {
-            auto it = lastUse.find(reg);
-            if (it == lastUse.end() || it->second > i) {
-                // Registro se usa después o no se encontró
-                allDead = false;
-                break;
-            }
-        }
-
-        if (!allDead || InstructionAnalysis::hasSideEffects(inst)) {
-            optimized.push_back(inst);
-        } else {
-            stats_.instructionsRemoved++;
-        }
-    }
-
-    return optimized;
-}
-
 bool PeepholeOptimizer::operandsEqual(const X86Operand& a, const X86Operand& b) const {
     if (a.mode != b.mode) return false;
 
@@ -352,13 +298,8 @@ bool PeepholeOptimizer::operandsEqual(const X86Operand& a, const X86Operand& b)
 }
 
 bool PeepholeOptimizer::isEffectiveNop(const X86Instruction& inst) const {
-    // Verificar si es un NOP efectivo
-    if (inst.opcode == X86Opcode::NOP) {
-        return true;
-    }
-
-    // Verificar movs redundantes
-    return InstructionAnalysis::isIneffectiveMove(inst);
+    // Los MOV reg, reg con el mismo registro los quita el patrón 1
+    return inst.opcode == X86Opcode::NOP && inst.comment.empty();
 }
 
 // ============================================================================
@@ -431,6 +372,12 @@ int InstructionAnalysis::calculateInstructionCost(const X86Instruction& inst) {
             return 1;
         case X86Opcode::JMP:
             return 1;
+        case X86Opcode::CMOVE: case X86Opcode::CMOVNE: case X86Opcode::CMOVL: case X86Opcode::CMOVLE:
+        case X86Opcode::CMOVG: case X86Opcode::CMOVGE: case X86Opcode::CMOVB: case X86Opcode::CMOVBE:
+        case X86Opcode::CMOVA: case X86Opcode::CMOVAE:
+            return 1;   // No se predice: nunca paga un fallo de predicción
+        case X86Opcode::MINSS: case X86Opcode::MINSD: case X86Opcode::MAXSS: case X86Opcode::MAXSD:
+            return 3;
         case X86Opcode::CALL:
             return 2;
         case X86Opcode::RET:
@@ -445,6 +392,8 @@ bool InstructionAnalysis::hasSideEffects(const X86Instruction& inst) {
     switch (inst.opcode) {
         case X86Opcode::CALL:
         case X86Opcode::RET:
+        case X86Opcode::TAILJMP:
+        case X86Opcode::JMPTABLE:
         case X86Opcode::PUSH:
         case X86Opcode::POP:
         case X86Opcode::JMP:
@@ -477,6 +426,12 @@ std::vector<X86Register> InstructionAnalysis::getDefinedRegisters(const X86Instr
 std::vector<X86Register> InstructionAnalysis::getUsedRegisters(const X86Instruction& inst) {
     std::vector<X86Register> used;
 
+    // CMOVcc deja el destino como estaba si no se cumple: también lo lee
+    if (inst.opcode >= X86Opcode::CMOVE && inst.opcode <= X86Opcode::CMOVAE && !inst.operands.empty() &&
+        inst.operands[0].mode == AddressingMode::Register) {
+        used.push_back(inst.operands[0].reg);
+    }
+
     // Analizar operandos fuente
     for (size_t i = 1; i < inst.operands.size(); ++i) {
         const auto& op = inst.operands[i];
@@ -8,6 +8,18 @@
 
 namespace cpp20::compiler::backend::unwind {
 
+namespace {
+
+void appendULEB128(std::vector<uint8_t>& data, uint64_t value) {
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        data.push_back(value != 0 ? (byte | 0x80) : byte);
+    } while (value != 0);
+}
+
+} // namespace
+
 // ============================================================================
 // ExceptionMapper - Implementación
 // ============================================================================
@@ -60,52 +72,57 @@ std::vector<uint8_t> ExceptionMapper::generateExceptionData() {
 std::vector<uint8_t> ExceptionMapper::generateWindowsExceptionData() {
     std::vector<uint8_t> data;
 
-    // Windows Exception Data Format (simplified)
-    // This is a placeholder implementation. In a real compiler, this would
-    // generate the proper exception data structures for Windows EH.
-
-    // Number of try/catch regions
-    uint32_t regionCount = static_cast<uint32_t>(tryCatchRegions_.size());
-    const uint8_t* countBytes = reinterpret_cast<const uint8_t*>(&regionCount);
-    data.insert(data.end(), countBytes, countBytes + 4);
-
-    // Try/catch region data
-    for (const auto& region : tryCatchRegions_) {
-        // Try start RVA
-        const uint8_t* tryStartBytes = reinterpret_cast<const uint8_t*>(&region.tryStart);
-        data.insert(data.end(), tryStartBytes, tryStartBytes + 4);
-
-        // Try end RVA
-        const uint8_t* tryEndBytes = reinterpret_cast<const uint8_t*>(&region.tryEnd);
-        data.insert(data.end(), tryEndBytes, tryEndBytes + 4);
-
-        // Catch start RVA
-        const uint8_t* catchStartBytes = reinterpret_cast<const uint8_t*>(&region.catchStart);
-        data.insert(data.end(), catchStartBytes, catchStartBytes + 4);
-
-        // Catch end RVA
-        const uint8_t* catchEndBytes = reinterpret_cast<const uint8_t*>(&region.catchEnd);
-        data.insert(data.end(), catchEndBytes, catchEndBytes + 4);
+    // Tabla de tipos sin repetidos, en orden de primera aparición
+    std::vector<uint32_t> types;
+    auto typeIndex = [&](uint32_t typeRVA) {
+        auto it = std::find(types.begin(), types.end(), typeRVA);
+        if (it != types.end()) return static_cast<uint32_t>(it - types.begin());
+        types.push_back(typeRVA);
+        return static_cast<uint32_t>(types.size() - 1);
+    };
+
+    std::vector<TryCatchRegion> regions = tryCatchRegions_;
+    std::stable_sort(regions.begin(), regions.end(), [](const TryCatchRegion& a, const TryCatchRegion& b) {
+        return a.tryStart < b.tryStart;
+    });
+    std::vector<ThrowSite> throws = throwSites_;
+    std::stable_sort(throws.begin(), throws.end(), [](const ThrowSite& a, const ThrowSite& b) {
+        return a.throwRVA < b.throwRVA;
+    });
+    std::vector<uint32_t> regionTypes;
+    for (const auto& region : regions) {
+        regionTypes.push_back(typeIndex(region.exceptionTypeRVA));
+    }
+    std::vector<uint32_t> throwTypes;
+    for (const auto& throwSite : throws) {
+        throwTypes.push_back(typeIndex(throwSite.exceptionTypeRVA));
+    }
 
-        // Exception type RVA
-        const uint8_t* typeBytes = reinterpret_cast<const uint8_t*>(&region.exceptionTypeRVA);
+    appendULEB128(data, types.size());
+    for (uint32_t type : types) {
+        const uint8_t* typeBytes = reinterpret_cast<const uint8_t*>(&type);
         data.insert(data.end(), typeBytes, typeBytes + 4);
     }
 
-    // Number of throw sites
-    uint32_t throwCount = static_cast<uint32_t>(throwSites_.size());
-    const uint8_t* throwCountBytes = reinterpret_cast<const uint8_t*>(&throwCount);
-    data.insert(data.end(), throwCountBytes, throwCountBytes + 4);
-
-    // Throw site data
-    for (const auto& throwSite : throwSites_) {
-        // Throw RVA
-        const uint8_t* throwBytes = reinterpret_cast<const uint8_t*>(&throwSite.throwRVA);
-        data.insert(data.end(), throwBytes, throwBytes + 4);
+    // Regiones: delta del inicio del try, longitudes y offset del catch
+    appendULEB128(data, regions.size());
+    uint32_t previous = functionStart_;
+    for (size_t i = 0; i < regions.size(); ++i) {
+        const auto& region = regions[i];
+        appendULEB128(data, region.tryStart - previous);
+        appendULEB128(data, region.tryEnd - region.tryStart);
+        appendULEB128(data, region.catchStart - functionStart_);
+        appendULEB128(data, region.catchEnd - region.catchStart);
+        appendULEB128(data, regionTypes[i]);
+        previous = region.tryStart;
+    }
 
-        // Exception type RVA
-        const uint8_t* typeBytes = reinterpret_cast<const uint8_t*>(&throwSite.exceptionTypeRVA);
-        data.insert(data.end(), typeBytes, typeBytes + 4);
+    appendULEB128(data, throws.size());
+    previous = functionStart_;
+    for (size_t i = 0; i < throws.size(); ++i) {
+        appendULEB128(data, throws[i].throwRVA - previous);
+        appendULEB128(data, throwTypes[i]);
+        previous = throws[i].throwRVA;
     }
 
     return data;
@@ -6,6 +6,7 @@
 #include <compiler/backend/unwind/UnwindTypes.h>
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 
 namespace cpp20::compiler::backend::unwind {
 
@@ -20,22 +21,29 @@ std::vector<UnwindCode> UnwindCodeGenerator::generateFromPrologue(
 
     std::vector<UnwindCode> codes;
     size_t offset = 0;
+    uint32_t probedSize = 0;    // EAX antes de __chkstk
 
-    // Analizar prólogo byte por byte
+    // Analizar prólogo byte por byte; cada código lleva el offset del final de su instrucción
     while (offset < prologueBytes.size()) {
         uint8_t byte = prologueBytes[offset];
 
-        // PUSH reg (0x50 + reg)
+        // PUSH reg (0x50 + reg), con REX.B (0x41) para R8-R15
         if (byte >= 0x50 && byte <= 0x57) {
             uint8_t reg = byte - 0x50;
-            codes.push_back(generatePushNonvol(static_cast<uint8_t>(offset), reg));
+            codes.push_back(generatePushNonvol(static_cast<uint8_t>(offset + 1), reg));
             offset += 1;
         }
+        else if (byte == 0x41 && offset + 1 < prologueBytes.size() &&
+                 prologueBytes[offset + 1] >= 0x50 && prologueBytes[offset + 1] <= 0x57) {
+            uint8_t reg = static_cast<uint8_t>(8 + prologueBytes[offset + 1] - 0x50);
+            codes.push_back(generatePushNonvol(static_cast<uint8_t>(offset + 2), reg));
+            offset += 2;
+        }
         // SUB RSP, imm8 (0x83 0xEC imm8)
         else if (byte == 0x83 && offset + 2 < prologueBytes.size() &&
                  prologueBytes[offset + 1] == 0xEC) {
             uint8_t size = prologueBytes[offset + 2];
-            auto allocCodes = generateAlloc(static_cast<uint8_t>(offset), size);
+            auto allocCodes = generateAlloc(static_cast<uint8_t>(offset + 3), size);
             codes.insert(codes.end(), allocCodes.begin(), allocCodes.end());
             offset += 3;
         }
@@ -43,16 +51,30 @@ std::vector<UnwindCode> UnwindCodeGenerator::generateFromPrologue(
         else if (byte == 0x81 && offset + 5 < prologueBytes.size() &&
                  prologueBytes[offset + 1] == 0xEC) {
             uint32_t size = *reinterpret_cast<const uint32_t*>(&prologueBytes[offset + 2]);
-            auto allocCodes = generateAlloc(static_cast<uint8_t>(offset), size);
+            auto allocCodes = generateAlloc(static_cast<uint8_t>(offset + 6), size);
             codes.insert(codes.end(), allocCodes.begin(), allocCodes.end());
             offset += 6;
         }
+        // Reserva con sonda: MOV EAX, imm32 (0xB8); CALL __chkstk (0xE8 rel32); SUB RSP, RAX (0x48 0x29 0xC4)
+        else if (byte == 0xB8 && offset + 4 < prologueBytes.size()) {
+            std::memcpy(&probedSize, &prologueBytes[offset + 1], sizeof(probedSize));
+            offset += 5;
+        }
+        else if (byte == 0xE8 && offset + 4 < prologueBytes.size()) {
+            offset += 5;
+        }
+        else if (byte == 0x48 && offset + 2 < prologueBytes.size() &&
+                 prologueBytes[offset + 1] == 0x29 && prologueBytes[offset + 2] == 0xC4) {
+            auto allocCodes = generateAlloc(static_cast<uint8_t>(offset + 3), probedSize);
+            codes.insert(codes.end(), allocCodes.begin(), allocCodes.end());
+            offset += 3;
+        }
         // MOV [RSP + offset], reg (0x89 reg 0x44 0x24 offset)
         else if (byte == 0x89 && offset + 3 < prologueBytes.size() &&
                  prologueBytes[offset + 2] == 0x44 && prologueBytes[offset + 3] == 0x24) {
             uint8_t reg = prologueBytes[offset + 1] >> 3; // Extract reg from ModR/M
             uint8_t saveOffset = prologueBytes[offset + 4];
-            codes.push_back(generateSaveNonvol(static_cast<uint8_t>(offset), reg, saveOffset));
+            codes.push_back(generateSaveNonvol(static_cast<uint8_t>(offset + 5), reg, saveOffset));
             offset += 5;
         }
         // MOV reg, RSP (0x89 0xE0 + reg*8)
@@ -60,7 +82,7 @@ std::vector<UnwindCode> UnwindCodeGenerator::generateFromPrologue(
             uint8_t modrm = prologueBytes[offset + 1];
             if ((modrm & 0xF8) == 0xE0) { // MOV reg, RSP
                 uint8_t reg = (modrm >> 3) & 0x07;
-                codes.push_back(generateSetFpreg(static_cast<uint8_t>(offset), reg, 0));
+                codes.push_back(generateSetFpreg(static_cast<uint8_t>(offset + 2), reg, 0));
                 offset += 2;
             } else {
                 offset += 1; // Skip unknown byte
@@ -71,6 +93,8 @@ std::vector<UnwindCode> UnwindCodeGenerator::generateFromPrologue(
         }
     }
 
+    // UNWIND_INFO lista los códigos del último al primero
+    std::reverse(codes.begin(), codes.end());
     return codes;
 }
 
@@ -138,8 +162,8 @@ UnwindInfo UnwindInfoGenerator::generateUnwindInfo(
 uint32_t UnwindInfoGenerator::calculateUnwindInfoSize(const UnwindInfo& info) {
     uint32_t size = sizeof(UnwindInfo);
 
-    // Add size of unwind codes (each is 2 bytes)
-    size += info.countOfCodes * sizeof(UnwindCode);
+    // Add size of unwind codes (each is 2 bytes, always an even count)
+    size += ((info.countOfCodes + 1u) & ~1u) * sizeof(UnwindCode);
 
     // Add size of exception handler info if present
     if ((info.flags & static_cast<uint8_t>(UnwindFlags::EHHandler)) ||
@@ -6,6 +6,9 @@
 #include <compiler/backend/unwind/UnwindEmitter.h>
 #include <algorithm>
 #include <cassert>
+#include <numeric>
+#include <string>
+#include <unordered_map>
 
 namespace cpp20::compiler::backend::unwind {
 
@@ -14,7 +17,7 @@ namespace cpp20::compiler::backend::unwind {
 // ============================================================================
 
 UnwindEmitter::UnwindEmitter()
-    : xdataBaseRVA_(0), currentXdataOffset_(0) {
+    : xdataBaseRVA_(0) {
 }
 
 UnwindEmitter::~UnwindEmitter() = default;
@@ -49,19 +52,42 @@ void UnwindEmitter::addFunctionUnwind(
     functions_.push_back(std::move(functionInfo));
 }
 
-std::vector<uint8_t> UnwindEmitter::generatePdataSection() {
-    std::vector<uint8_t> pdata;
+bool UnwindEmitter::addChainedUnwind(uint32_t fragmentRVA, uint32_t fragmentSize, uint32_t primaryRVA) {
+    auto primary = std::find_if(functions_.begin(), functions_.end(), [&](const auto& func) {
+        return func->chainedTo == FunctionUnwindInfo::NotChained &&
+               func->runtimeFunction.beginAddress == primaryRVA;
+    });
+    if (primary == functions_.end()) {
+        return false;
+    }
 
-    for (size_t i = 0; i < functions_.size(); ++i) {
-        const auto& func = functions_[i];
+    // Sin códigos propios: los del prólogo de la principal
+    UnwindInfo chainInfo(UnwindVersion::Version1, UnwindFlags::ChainInfo);
+    auto fragment = std::make_unique<FunctionUnwindInfo>(
+        fragmentRVA, fragmentRVA + fragmentSize, chainInfo,
+        std::vector<UnwindCode>(), std::vector<uint8_t>(), 0, false);
+    fragment->chainedTo = static_cast<size_t>(primary - functions_.begin());
+    functions_.push_back(std::move(fragment));
+    return true;
+}
 
-        // Calcular RVA de UNWIND_INFO
-        uint32_t unwindInfoRVA = calculateUnwindInfoRVA(i);
+std::vector<uint8_t> UnwindEmitter::generatePdataSection() {
+    std::vector<uint32_t> offsets;
+    buildXdata(offsets);
 
-        // Actualizar el RuntimeFunction con el RVA correcto
+    std::vector<size_t> order(functions_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return functions_[a]->runtimeFunction.beginAddress < functions_[b]->runtimeFunction.beginAddress;
+    });
+
+    std::vector<uint8_t> pdata;
+    pdata.reserve(order.size() * sizeof(RuntimeFunction));
+    for (size_t index : order) {
+        const auto& func = functions_[index];
         RuntimeFunction rf(func->runtimeFunction.beginAddress,
                           func->runtimeFunction.endAddress,
-                          unwindInfoRVA);
+                          xdataRVA(offsets[index]));
 
         // Serializar RuntimeFunction (12 bytes en little-endian)
         const uint8_t* rfBytes = reinterpret_cast<const uint8_t*>(&rf);
@@ -72,15 +98,8 @@ std::vector<uint8_t> UnwindEmitter::generatePdataSection() {
 }
 
 std::vector<uint8_t> UnwindEmitter::generateXdataSection() {
-    std::vector<uint8_t> xdata;
-    currentXdataOffset_ = 0;
-
-    for (const auto& func : functions_) {
-        auto unwindData = generateUnwindInfoData(*func);
-        xdata.insert(xdata.end(), unwindData.begin(), unwindData.end());
-    }
-
-    return xdata;
+    std::vector<uint32_t> offsets;
+    return buildXdata(offsets);
 }
 
 uint32_t UnwindEmitter::getPdataSize() const {
@@ -88,11 +107,15 @@ uint32_t UnwindEmitter::getPdataSize() const {
 }
 
 uint32_t UnwindEmitter::getXdataSize() const {
-    uint32_t totalSize = 0;
-    for (const auto& func : functions_) {
-        totalSize += UnwindInfoGenerator::calculateUnwindInfoSize(func->unwindInfo);
-    }
-    return totalSize;
+    std::vector<uint32_t> offsets;
+    return static_cast<uint32_t>(buildXdata(offsets).size());
+}
+
+size_t UnwindEmitter::getUniqueUnwindInfoCount() const {
+    std::vector<uint32_t> offsets;
+    buildXdata(offsets);
+    std::sort(offsets.begin(), offsets.end());
+    return static_cast<size_t>(std::unique(offsets.begin(), offsets.end()) - offsets.begin());
 }
 
 bool UnwindEmitter::validateAll() const {
@@ -104,7 +127,31 @@ bool UnwindEmitter::validateAll() const {
     return true;
 }
 
-std::vector<uint8_t> UnwindEmitter::generateUnwindInfoData(const FunctionUnwindInfo& info) {
+std::vector<uint8_t> UnwindEmitter::buildXdata(std::vector<uint32_t>& offsets) const {
+    std::vector<uint8_t> xdata;
+    offsets.assign(functions_.size(), 0);
+
+    // Registro serializado -> offset de su primera aparición
+    std::unordered_map<std::string, uint32_t> emitted;
+    for (size_t i = 0; i < functions_.size(); ++i) {
+        const auto& func = *functions_[i];
+        uint32_t primaryRVA = func.chainedTo == FunctionUnwindInfo::NotChained
+                                  ? 0 : xdataRVA(offsets[func.chainedTo]);
+        auto unwindData = generateUnwindInfoData(func, primaryRVA);
+
+        auto [it, inserted] = emitted.try_emplace(
+            std::string(unwindData.begin(), unwindData.end()), static_cast<uint32_t>(xdata.size()));
+        if (inserted) {
+            xdata.insert(xdata.end(), unwindData.begin(), unwindData.end());
+        }
+        offsets[i] = it->second;
+    }
+
+    return xdata;
+}
+
+std::vector<uint8_t> UnwindEmitter::generateUnwindInfoData(const FunctionUnwindInfo& info,
+                                                           uint32_t primaryRVA) const {
     std::vector<uint8_t> data;
 
     // Serializar UNWIND_INFO header
@@ -113,11 +160,16 @@ std::vector<uint8_t> UnwindEmitter::generateUnwindInfoData(const FunctionUnwindI
     data.push_back(info.unwindInfo.countOfCodes);
     data.push_back(info.unwindInfo.frameRegister | (info.unwindInfo.frameOffset << 4));
 
-    // Serializar UNWIND_CODEs
+    // Serializar UNWIND_CODEs; el array ocupa siempre un número par de
+    // entradas, así cada registro mide un múltiplo de 4 y se puede compartir
     for (const auto& code : info.unwindCodes) {
         data.push_back(code.codeOffset);
         data.push_back(code.unwindOp | (code.opInfo << 4));
     }
+    if (info.unwindCodes.size() % 2 != 0) {
+        data.push_back(0);
+        data.push_back(0);
+    }
 
     // Si hay exception handler, añadir información adicional
     if (info.hasExceptionHandler) {
@@ -132,25 +184,15 @@ std::vector<uint8_t> UnwindEmitter::generateUnwindInfoData(const FunctionUnwindI
         data.insert(data.end(), edBytes, edBytes + 4);
     }
 
-    // Actualizar offset para siguiente función
-    currentXdataOffset_ += static_cast<uint32_t>(data.size());
-
-    return data;
-}
-
-uint32_t UnwindEmitter::calculateUnwindInfoRVA(size_t functionIndex) const {
-    if (xdataBaseRVA_ == 0) {
-        return 0; // No base RVA set
-    }
-
-    uint32_t offset = 0;
-
-    // Calcular offset sumando tamaños de funciones anteriores
-    for (size_t i = 0; i < functionIndex; ++i) {
-        offset += UnwindInfoGenerator::calculateUnwindInfoSize(functions_[i]->unwindInfo);
+    // Fragmento: RUNTIME_FUNCTION de la función principal
+    if (info.chainedTo != FunctionUnwindInfo::NotChained) {
+        const RuntimeFunction& primary = functions_[info.chainedTo]->runtimeFunction;
+        RuntimeFunction rf(primary.beginAddress, primary.endAddress, primaryRVA);
+        const uint8_t* rfBytes = reinterpret_cast<const uint8_t*>(&rf);
+        data.insert(data.end(), rfBytes, rfBytes + sizeof(RuntimeFunction));
     }
 
-    return xdataBaseRVA_ + offset;
+    return data;
 }
 
 bool UnwindEmitter::validateFunctionUnwind(const FunctionUnwindInfo& info) const {
@@ -0,0 +1,144 @@
+/**
+ * @file CacheBackend.cpp
+ * @brief Almacén secundario compartido para las cachés de plantillas y constexpr
+ */
+
+#include <compiler/common/CacheBackend.h>
+#include <compiler/common/utils/HashUtils.h>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+#include <thread>
+
+namespace cpp20::compiler {
+
+// ============================================================================
+// DirectoryCacheBackend
+// ============================================================================
+
+DirectoryCacheBackend::DirectoryCacheBackend(std::filesystem::path root)
+    : root_(std::move(root)) {
+}
+
+std::filesystem::path DirectoryCacheBackend::pathFor(const std::string& address) const {
+    return root_ / address.substr(0, 2) / address;
+}
+
+std::optional<std::string> DirectoryCacheBackend::fetch(const std::string& address) {
+    std::ifstream in(pathFor(address), std::ios::binary);
+    if (!in) {
+        return std::nullopt;
+    }
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (in.bad()) {
+        return std::nullopt;
+    }
+    return data;
+}
+
+bool DirectoryCacheBackend::put(const std::string& address, std::string_view data) {
+    std::filesystem::path file = pathFor(address);
+    std::error_code error;
+    if (std::filesystem::exists(file, error)) {
+        return true;
+    }
+    std::filesystem::create_directories(file.parent_path(), error);
+
+    // Otra máquina puede publicar la misma dirección a la vez: temporal único
+    std::filesystem::path temporary = file;
+    temporary += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()) ^
+                                      static_cast<size_t>(std::chrono::steady_clock::now()
+                                                              .time_since_epoch().count())) + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!out) {
+            out.close();
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporary, file, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// SecondaryCache
+// ============================================================================
+
+SecondaryCache::SecondaryCache(std::shared_ptr<CacheBackend> backend, uint64_t namespaceKey,
+                               size_t threadCount)
+    : backend_(std::move(backend)), namespaceKey_(namespaceKey),
+      pool_(threadCount == 0 ? 1 : threadCount) {
+}
+
+SecondaryCache::~SecondaryCache() {
+    pool_.wait();
+}
+
+uint64_t SecondaryCache::namespaceKeyFor(std::string_view compilerVersion, uint64_t optionsHash) {
+    return common::utils::hashMix(common::utils::fnv1a64(compilerVersion), optionsHash);
+}
+
+std::string SecondaryCache::address(uint32_t kind, uint64_t fingerprint) const {
+    static constexpr char digits[] = "0123456789abcdef";
+
+    // Dos mitades independientes: 128 bits de dirección
+    uint64_t parts[2] = {
+        common::utils::hashMix(common::utils::hashMix(namespaceKey_, kind), fingerprint),
+        common::utils::hashMix(common::utils::hashMix(fingerprint, kind), namespaceKey_),
+    };
+
+    std::string result;
+    result.reserve(32);
+    for (uint64_t part : parts) {
+        for (int shift = 60; shift >= 0; shift -= 4) {
+            result.push_back(digits[(part >> shift) & 0xf]);
+        }
+    }
+    return result;
+}
+
+bool SecondaryCache::markRequested(const std::string& address) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return requested_.insert(address).second;
+}
+
+void SecondaryCache::prefetch(const std::string& address,
+                              std::function<void(std::string_view)> deliver) {
+    if (!markRequested(address)) return;
+
+    pool_.submit([this, address, deliver = std::move(deliver)]() {
+        fetches_.fetch_add(1, std::memory_order_relaxed);
+        std::optional<std::string> data = backend_->fetch(address);
+        if (data) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            deliver(*data);
+        }
+    });
+}
+
+void SecondaryCache::writeBehind(const std::string& address, std::string data) {
+    markRequested(address);
+
+    pool_.submit([this, address, data = std::move(data)]() {
+        if (backend_->put(address, data)) {
+            writes_.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+}
+
+void SecondaryCache::wait() {
+    pool_.wait();
+}
+
+} // namespace cpp20::compiler
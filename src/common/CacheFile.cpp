@@ -0,0 +1,174 @@
+/**
+ * @file CacheFile.cpp
+ * @brief Formato binario proyectable en memoria para cachés persistentes
+ */
+
+#include <compiler/common/CacheFile.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <system_error>
+#include <thread>
+
+namespace cpp20::compiler {
+
+namespace {
+
+constexpr char kCacheMagic[8] = {'C', 'P', 'P', 'C', 'A', 'C', 'H', 'E'};
+
+uint64_t readLE(const char* data, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace
+
+// ============================================================================
+// CacheFileWriter
+// ============================================================================
+
+void CacheFileWriter::add(uint64_t fingerprint, std::string key, std::string value) {
+    records_.push_back(Record{fingerprint, std::move(key), std::move(value)});
+}
+
+bool CacheFileWriter::write(const std::filesystem::path& path, uint32_t kind) const {
+    std::vector<const Record*> sorted;
+    sorted.reserve(records_.size());
+    for (const Record& record : records_) {
+        sorted.push_back(&record);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const Record* a, const Record* b) {
+        return a->fingerprint < b->fingerprint;
+    });
+
+    CacheRecordWriter fields;
+    fields.u32(cache_file::FormatVersion);
+    fields.u32(kind);
+    fields.u64(sorted.size());
+    for (uint64_t counter : counters_) {
+        fields.u64(counter);
+    }
+
+    CacheRecordWriter index;
+    uint64_t offset = cache_file::HeaderSize + sorted.size() * cache_file::IndexEntrySize;
+    for (const Record* record : sorted) {
+        index.u64(record->fingerprint);
+        index.u64(offset);
+        index.u32(static_cast<uint32_t>(record->key.size()));
+        index.u32(static_cast<uint32_t>(record->value.size()));
+        offset += record->key.size() + record->value.size();
+    }
+
+    // Varios procesos pueden guardar la misma caché a la vez: temporal único
+    std::filesystem::path temporary = path;
+    temporary += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()) ^
+                                      static_cast<size_t>(std::chrono::steady_clock::now()
+                                                              .time_since_epoch().count())) + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        std::string headerBytes = std::string(kCacheMagic, sizeof(kCacheMagic)) + fields.take();
+        std::string indexBytes = index.take();
+        out.write(headerBytes.data(), static_cast<std::streamsize>(headerBytes.size()));
+        out.write(indexBytes.data(), static_cast<std::streamsize>(indexBytes.size()));
+        for (const Record* record : sorted) {
+            out.write(record->key.data(), static_cast<std::streamsize>(record->key.size()));
+            out.write(record->value.data(), static_cast<std::streamsize>(record->value.size()));
+        }
+        if (!out) {
+            out.close();
+            std::error_code ignored;
+            std::filesystem::remove(temporary, ignored);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// CacheFileReader
+// ============================================================================
+
+std::unique_ptr<CacheFileReader> CacheFileReader::open(const std::filesystem::path& path,
+                                                       uint32_t kind) {
+    auto mapping = common::utils::MappedFile::open(path);
+    if (!mapping || mapping->size() < cache_file::HeaderSize) {
+        return nullptr;
+    }
+
+    const char* data = mapping->data();
+    if (std::string_view(data, sizeof(kCacheMagic)) !=
+        std::string_view(kCacheMagic, sizeof(kCacheMagic))) {
+        return nullptr;
+    }
+    if (readLE(data + 8, 4) != cache_file::FormatVersion || readLE(data + 12, 4) != kind) {
+        return nullptr;
+    }
+
+    uint64_t count = readLE(data + 16, 8);
+    size_t available = mapping->size() - cache_file::HeaderSize;
+    if (count > available / cache_file::IndexEntrySize) {
+        return nullptr;
+    }
+
+    return std::unique_ptr<CacheFileReader>(
+        new CacheFileReader(std::move(mapping), static_cast<size_t>(count)));
+}
+
+uint64_t CacheFileReader::counter(size_t index) const {
+    return readLE(mapping_->data() + 24 + index * 8, 8);
+}
+
+uint64_t CacheFileReader::fingerprintAt(size_t index) const {
+    return readLE(mapping_->data() + cache_file::HeaderSize + index * cache_file::IndexEntrySize, 8);
+}
+
+std::optional<CacheFileReader::Record> CacheFileReader::record(size_t index) const {
+    const char* entry = mapping_->data() + cache_file::HeaderSize + index * cache_file::IndexEntrySize;
+    uint64_t offset = readLE(entry + 8, 8);
+    uint64_t keySize = readLE(entry + 16, 4);
+    uint64_t valueSize = readLE(entry + 20, 4);
+
+    if (offset > mapping_->size() || mapping_->size() - offset < keySize + valueSize) {
+        return std::nullopt;
+    }
+
+    const char* payload = mapping_->data() + offset;
+    return Record{readLE(entry, 8),
+                  std::string_view(payload, static_cast<size_t>(keySize)),
+                  std::string_view(payload + keySize, static_cast<size_t>(valueSize))};
+}
+
+std::pair<size_t, size_t> CacheFileReader::equalRange(uint64_t fingerprint) const {
+    size_t first = 0;
+    size_t last = count_;
+    while (first < last) {
+        size_t middle = first + (last - first) / 2;
+        if (fingerprintAt(middle) < fingerprint) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+
+    size_t end = first;
+    while (end < count_ && fingerprintAt(end) == fingerprint) {
+        ++end;
+    }
+    return {first, end};
+}
+
+} // namespace cpp20::compiler
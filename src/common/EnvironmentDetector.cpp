@@ -4,11 +4,26 @@
  */
 
 #include <compiler/common/EnvironmentDetector.h>
+#include <compiler/common/utils/StringUtils.h>
 #include <algorithm>
 #include <sstream>
 #include <regex>
 #include <iostream>
 #include <fstream>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <tuple>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define CPP20_HAS_CPUID 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define CPP20_HAS_CPUID 1
+#endif
 
 #ifdef _WIN32
 #include <windows.h>
@@ -20,6 +35,112 @@
 
 namespace cpp20::compiler {
 
+namespace {
+
+// Raíces donde se buscan las instalaciones
+const std::vector<std::filesystem::path> kVisualStudioRoots = {
+    "C:/Program Files/Microsoft Visual Studio",
+    "C:/Program Files (x86)/Microsoft Visual Studio"
+};
+
+const std::vector<std::filesystem::path> kVisualStudioEditions = {
+    "C:/Program Files/Microsoft Visual Studio/2022",
+    "C:/Program Files (x86)/Microsoft Visual Studio/2019",
+    "C:/Program Files (x86)/Microsoft Visual Studio/2017"
+};
+
+const std::vector<std::filesystem::path> kWindowsKitsRoots = {
+    "C:/Program Files (x86)/Windows Kits/10",
+    "C:/Program Files/Windows Kits/10"
+};
+
+// Formato de texto de la caché: un campo por línea, separados por tabuladores
+//   A <arquitectura>     V <válido>
+//   M <major> <minor> <build> <revision> <versión> <toolset> <ruta>
+//   S <major> <minor> <build> <versión> <ruta>
+//   I <ruta include>     L <ruta librería>     P <definición>
+//   D <mtime> <directorio de huella>
+//   C <fabricante> <firma> <microarquitectura> <extensiones> <L1d> <L2> <L3>
+constexpr const char* kEnvironmentCacheHeader = "cpp20-environment-cache 2";
+constexpr int64_t kMissingDirectory = -1;
+
+int64_t directoryTime(const std::filesystem::path& directory) {
+    std::error_code error;
+    auto time = std::filesystem::last_write_time(directory, error);
+    return error ? kMissingDirectory : static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+std::vector<std::string> splitFields(const std::string& line) {
+    // Conserva los campos vacíos del final (versión o ruta sin detectar)
+    std::vector<std::string> fields;
+    for (std::string_view field : common::utils::splitView(line, '\t')) {
+        fields.emplace_back(field);
+    }
+    return fields;
+}
+
+// Orden de los bits de CPUFeatures en la línea C
+constexpr bool CPUFeatures::* kFeatureBits[] = {
+    &CPUFeatures::sse2, &CPUFeatures::sse41, &CPUFeatures::sse42, &CPUFeatures::popcnt,
+    &CPUFeatures::avx, &CPUFeatures::avx2, &CPUFeatures::bmi1, &CPUFeatures::bmi2,
+    &CPUFeatures::lzcnt, &CPUFeatures::avx512f
+};
+
+uint32_t featureBits(const CPUFeatures& features) {
+    uint32_t bits = 0;
+    for (size_t i = 0; i < std::size(kFeatureBits); ++i) {
+        bits |= features.*kFeatureBits[i] ? 1u << i : 0;
+    }
+    return bits;
+}
+
+CPUFeatures featuresFromBits(uint32_t bits) {
+    CPUFeatures features;
+    for (size_t i = 0; i < std::size(kFeatureBits); ++i) {
+        features.*kFeatureBits[i] = (bits >> i) & 1;
+    }
+    return features;
+}
+
+/**
+ * @brief Familia y modelo extendidos de la firma, como los define Intel (AMD usa la misma regla)
+ */
+void decodeSignature(HostCPU& cpu) {
+    cpu.family = (cpu.signature >> 8) & 0xF;
+    cpu.model = (cpu.signature >> 4) & 0xF;
+    if (cpu.family == 0xF) {
+        cpu.family += (cpu.signature >> 20) & 0xFF;
+    }
+    if (cpu.family == 6 || cpu.family >= 0xF) {
+        cpu.model |= ((cpu.signature >> 16) & 0xF) << 4;
+    }
+}
+
+#ifdef CPP20_HAS_CPUID
+void cpuidLeaf(uint32_t leaf, uint32_t subleaf, uint32_t info[4]) {
+#ifdef _MSC_VER
+    int registers[4];
+    __cpuidex(registers, static_cast<int>(leaf), static_cast<int>(subleaf));
+    std::memcpy(info, registers, sizeof(registers));
+#else
+    __cpuid_count(leaf, subleaf, info[0], info[1], info[2], info[3]);
+#endif
+}
+
+uint64_t readXcr0() {
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    // Sin -mxsave no hay intrínseco: XGETBV con ECX = 0
+    uint32_t low, high;
+    __asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+    return (static_cast<uint64_t>(high) << 32) | low;
+#endif
+}
+#endif
+
+} // namespace
+
 // ============================================================================
 // EnvironmentDetector - Implementación
 // ============================================================================
@@ -32,6 +153,7 @@ EnvironmentDetector::~EnvironmentDetector() = default;
 DetectedEnvironment EnvironmentDetector::detectEnvironment(const std::string& targetArch) {
     DetectedEnvironment env;
     env.targetArchitecture = getCanonicalArchitecture(targetArch);
+    env.hostCPU = detectHostCPU();
 
     // Detectar MSVC
     auto msvcOpt = findMSVCInstallation(env.targetArchitecture);
@@ -62,7 +184,120 @@ DetectedEnvironment EnvironmentDetector::detectEnvironment(const std::string& ta
     return env;
 }
 
-std::optional<MSVCVersion> EnvironmentDetector::findMSVCInstallation(const std::string& targetArch) {
+CPUFeatures EnvironmentDetector::detectCPUFeatures() {
+    CPUFeatures features;
+#ifdef CPP20_HAS_CPUID
+    uint32_t info[4];
+    cpuidLeaf(0, 0, info);
+    uint32_t maxLeaf = info[0];
+
+    cpuidLeaf(1, 0, info);
+    features.sse2 = (info[3] & cpuid::Leaf1EdxSSE2) != 0;
+    features.sse41 = (info[2] & cpuid::Leaf1EcxSSE41) != 0;
+    features.sse42 = (info[2] & cpuid::Leaf1EcxSSE42) != 0;
+    features.popcnt = (info[2] & cpuid::Leaf1EcxPOPCNT) != 0;
+    uint64_t xcr0 = (info[2] & cpuid::Leaf1EcxOSXSAVE) != 0 ? readXcr0() : 0;
+    bool ymmEnabled = (xcr0 & cpuid::XcrYmmState) == cpuid::XcrYmmState;
+    bool zmmEnabled = (xcr0 & cpuid::XcrZmmState) == cpuid::XcrZmmState;
+    features.avx = ymmEnabled && (info[2] & cpuid::Leaf1EcxAVX) != 0;
+
+    if (maxLeaf >= 7) {
+        cpuidLeaf(7, 0, info);
+        features.avx2 = features.avx && (info[1] & cpuid::Leaf7EbxAVX2) != 0;
+        features.bmi1 = (info[1] & cpuid::Leaf7EbxBMI1) != 0;
+        features.bmi2 = (info[1] & cpuid::Leaf7EbxBMI2) != 0;
+        features.avx512f = zmmEnabled && (info[1] & cpuid::Leaf7EbxAVX512F) != 0;
+    }
+
+    cpuidLeaf(0x80000000, 0, info);
+    if (info[0] >= 0x80000001) {
+        cpuidLeaf(0x80000001, 0, info);
+        features.lzcnt = (info[2] & cpuid::Ext1EcxLZCNT) != 0;
+    }
+#endif
+    return features;
+}
+
+std::pair<std::string, uint32_t> EnvironmentDetector::hostSignature() {
+#ifdef CPP20_HAS_CPUID
+    uint32_t info[4];
+    cpuidLeaf(0, 0, info);
+    // El fabricante va en EBX, EDX, ECX
+    char vendor[12];
+    std::memcpy(vendor, &info[1], 4);
+    std::memcpy(vendor + 4, &info[3], 4);
+    std::memcpy(vendor + 8, &info[2], 4);
+    cpuidLeaf(1, 0, info);
+    return {std::string(vendor, sizeof(vendor)), info[0]};
+#else
+    return {};
+#endif
+}
+
+Microarchitecture EnvironmentDetector::microarchitectureFor(const std::string& vendor, unsigned family,
+                                                            unsigned model) {
+    if (vendor == "GenuineIntel" && family == 6) {
+        switch (model) {
+            case 0x4E: case 0x5E: case 0x8E: case 0x9E: case 0xA5: case 0xA6:   // Skylake cliente y derivados
+            case 0x55:                                                          // Skylake-SP, Cascade Lake
+            case 0x66: case 0x6A: case 0x6C: case 0x7D: case 0x7E:              // Cannon Lake, Ice Lake
+            case 0x8C: case 0x8D: case 0xA7:                                    // Tiger Lake, Rocket Lake
+            case 0x8F: case 0xCF: case 0xAD: case 0xAE:                         // Sapphire, Emerald, Granite Rapids
+            case 0x97: case 0x9A: case 0xB7: case 0xBA: case 0xBF:              // Alder Lake, Raptor Lake
+                return Microarchitecture::Skylake;
+            default:
+                return Microarchitecture::Generic;
+        }
+    }
+    if (vendor == "AuthenticAMD" && family == 0x19) {
+        bool zen4 = (model >= 0x10 && model <= 0x1F) || (model >= 0x60 && model <= 0x7F) ||
+                    (model >= 0xA0 && model <= 0xAF);
+        return zen4 ? Microarchitecture::Zen4 : Microarchitecture::Zen3;
+    }
+    if (vendor == "AuthenticAMD" && family == 0x1A) {
+        return Microarchitecture::Zen4;
+    }
+    return Microarchitecture::Generic;
+}
+
+HostCPU EnvironmentDetector::detectHostCPU() {
+    HostCPU cpu;
+    cpu.features = detectCPUFeatures();
+    std::tie(cpu.vendor, cpu.signature) = hostSignature();
+    decodeSignature(cpu);
+    cpu.microarchitecture = microarchitectureFor(cpu.vendor, cpu.family, cpu.model);
+
+#ifdef CPP20_HAS_CPUID
+    // Parámetros de caché deterministas: hoja 4 en Intel, 0x8000001D en AMD
+    uint32_t info[4];
+    uint32_t leaf = 4;
+    if (cpu.vendor == "AuthenticAMD") {
+        cpuidLeaf(0x80000000, 0, info);
+        leaf = info[0] >= 0x8000001D ? 0x8000001D : 0;
+    } else {
+        cpuidLeaf(0, 0, info);
+        leaf = info[0] >= 4 ? 4 : 0;
+    }
+    for (uint32_t index = 0; leaf != 0 && index < 16; ++index) {
+        cpuidLeaf(leaf, index, info);
+        uint32_t type = info[0] & 0x1F;         // 0: no hay más; 2: solo instrucciones
+        if (type == 0) break;
+        if (type == 2) continue;
+        uint32_t level = (info[0] >> 5) & 0x7;
+        uint64_t bytes = static_cast<uint64_t>((info[1] >> 22) + 1) *          // Vías
+                         (((info[1] >> 12) & 0x3FF) + 1) *                     // Particiones
+                         ((info[1] & 0xFFF) + 1) *                             // Línea
+                         (static_cast<uint64_t>(info[2]) + 1);                 // Conjuntos
+        uint32_t kilobytes = static_cast<uint32_t>(bytes / 1024);
+        if (level == 1) cpu.l1DataKB = kilobytes;
+        if (level == 2) cpu.l2KB = kilobytes;
+        if (level == 3) cpu.l3KB = kilobytes;
+    }
+#endif
+    return cpu;
+}
+
+std::optional<MSVCVersion> EnvironmentDetector::findMSVCInstallation([[maybe_unused]] const std::string& targetArch) {
     auto versions = listAvailableMSVCVersions();
     if (versions.empty()) {
         return std::nullopt;
@@ -80,6 +315,20 @@ std::optional<SDKVersion> EnvironmentDetector::findWindowsSDK() {
     return selectBestSDKVersion(versions);
 }
 
+std::vector<std::filesystem::path> EnvironmentDetector::fingerprintDirectories(const DetectedEnvironment& env) {
+    std::vector<std::filesystem::path> directories(kVisualStudioRoots);
+    directories.insert(directories.end(), kVisualStudioEditions.begin(), kVisualStudioEditions.end());
+    for (const auto& root : kWindowsKitsRoots) {
+        directories.push_back(root / "Include");
+    }
+
+    // Un toolset nuevo en la instalación elegida no cambia las raíces
+    if (!env.msvcInstallPath.empty()) {
+        directories.push_back(env.msvcInstallPath / "VC/Tools/MSVC");
+    }
+    return directories;
+}
+
 std::vector<MSVCVersion> EnvironmentDetector::listAvailableMSVCVersions() {
     std::vector<MSVCVersion> versions;
 
@@ -111,13 +360,7 @@ std::vector<MSVCVersion> EnvironmentDetector::scanRegistryForMSVC() {
     // para encontrar instalaciones de Visual Studio
 
     // Placeholder: buscar en ubicaciones estándar
-    std::vector<std::filesystem::path> searchPaths = {
-        "C:/Program Files/Microsoft Visual Studio/2022",
-        "C:/Program Files (x86)/Microsoft Visual Studio/2019",
-        "C:/Program Files (x86)/Microsoft Visual Studio/2017"
-    };
-
-    for (const auto& basePath : searchPaths) {
+    for (const auto& basePath : kVisualStudioEditions) {
         if (std::filesystem::exists(basePath)) {
             for (const auto& entry : std::filesystem::directory_iterator(basePath)) {
                 if (entry.is_directory()) {
@@ -137,12 +380,7 @@ std::vector<MSVCVersion> EnvironmentDetector::scanRegistryForMSVC() {
 std::vector<MSVCVersion> EnvironmentDetector::scanDirectoriesForMSVC() {
     std::vector<MSVCVersion> versions;
 
-    std::vector<std::filesystem::path> searchPaths = {
-        "C:/Program Files/Microsoft Visual Studio",
-        "C:/Program Files (x86)/Microsoft Visual Studio"
-    };
-
-    for (const auto& basePath : searchPaths) {
+    for (const auto& basePath : kVisualStudioRoots) {
         if (std::filesystem::exists(basePath)) {
             try {
                 for (const auto& entry : std::filesystem::directory_iterator(basePath)) {
@@ -165,12 +403,7 @@ std::vector<MSVCVersion> EnvironmentDetector::scanDirectoriesForMSVC() {
 std::vector<SDKVersion> EnvironmentDetector::scanDirectoriesForSDK() {
     std::vector<SDKVersion> versions;
 
-    std::vector<std::filesystem::path> searchPaths = {
-        "C:/Program Files (x86)/Windows Kits/10",
-        "C:/Program Files/Windows Kits/10"
-    };
-
-    for (const auto& basePath : searchPaths) {
+    for (const auto& basePath : kWindowsKitsRoots) {
         if (std::filesystem::exists(basePath)) {
             try {
                 std::filesystem::path includePath = basePath / "Include";
@@ -315,7 +548,7 @@ bool EnvironmentDetector::validateSDKInstallation(const std::filesystem::path& p
 std::vector<std::filesystem::path> EnvironmentDetector::getStandardIncludePaths(
     const MSVCVersion& msvc,
     const SDKVersion& sdk,
-    const std::string& targetArch) {
+    [[maybe_unused]] const std::string& targetArch) {
 
     std::vector<std::filesystem::path> paths;
 
@@ -484,7 +717,7 @@ std::optional<std::filesystem::path> EnvironmentDetector::findFileInEnvironment(
     return std::nullopt;
 }
 
-std::string EnvironmentDetector::getCompilerVersionString(const std::filesystem::path& compilerPath) {
+std::string EnvironmentDetector::getCompilerVersionString([[maybe_unused]] const std::filesystem::path& compilerPath) {
     // En una implementación real, ejecutaría cl.exe /? y parsearía la salida
     return "Microsoft (R) C/C++ Optimizing Compiler Version 19.30.30709 for x64";
 }
@@ -497,7 +730,7 @@ MSVCVersion EnvironmentDetector::selectBestMSVCVersion(const std::vector<MSVCVer
     // Seleccionar la versión más reciente
     MSVCVersion best = versions[0];
     for (const auto& version : versions) {
-        if (version > best) {
+        if (best < version) {
             best = version;
         }
     }
@@ -513,7 +746,7 @@ SDKVersion EnvironmentDetector::selectBestSDKVersion(const std::vector<SDKVersio
     // Seleccionar la versión más reciente
     SDKVersion best = versions[0];
     for (const auto& version : versions) {
-        if (version > best) {
+        if (best < version) {
             best = version;
         }
     }
@@ -536,9 +769,9 @@ bool EnvironmentDetector::areVersionsCompatible(const MSVCVersion& msvc, const S
 }
 
 std::string EnvironmentDetector::getCanonicalArchitecture(const std::string& arch) {
-    if (arch == "x86_64" || arch == "amd64") {
+    if (arch == "x86_64" || arch == "amd64" || arch == "X64") {
         return "x64";
-    } else if (arch == "i386" || arch == "i686") {
+    } else if (arch == "i386" || arch == "i686" || arch == "X86") {
         return "x86";
     } else if (arch == "arm64") {
         return "arm64";
@@ -551,7 +784,7 @@ std::string EnvironmentDetector::getCanonicalArchitecture(const std::string& arc
 // EnvironmentUtils - Implementación
 // ============================================================================
 
-std::string EnvironmentUtils::executeCommand(const std::string& command) {
+std::string EnvironmentUtils::executeCommand([[maybe_unused]] const std::string& command) {
 #ifdef _WIN32
     std::array<char, 128> buffer;
     std::string result;
@@ -586,11 +819,16 @@ std::optional<std::string> EnvironmentUtils::getEnvironmentVariable(const std::s
         free(value);
         return result;
     }
+#else
+    if (const char* value = std::getenv(name.c_str())) {
+        return std::string(value);
+    }
 #endif
     return std::nullopt;
 }
 
-bool EnvironmentUtils::setEnvironmentVariable(const std::string& name, const std::string& value) {
+bool EnvironmentUtils::setEnvironmentVariable([[maybe_unused]] const std::string& name,
+                                              [[maybe_unused]] const std::string& value) {
 #ifdef _WIN32
     return _putenv_s(name.c_str(), value.c_str()) == 0;
 #else
@@ -686,9 +924,9 @@ bool EnvironmentUtils::isCIEnvironment() {
 // CompilerConfigManager - Implementación
 // ============================================================================
 
-CompilerConfigManager::CompilerConfigManager() = default;
+CompilerConfigManager::CompilerConfigManager() : cacheFile_(defaultCacheFile()) {}
 
-bool CompilerConfigManager::loadConfig(const std::filesystem::path& configFile) {
+bool CompilerConfigManager::loadConfig([[maybe_unused]] const std::filesystem::path& configFile) {
     // En una implementación real, parsearía JSON o similar
     return false; // Placeholder
 }
@@ -732,6 +970,176 @@ void CompilerConfigManager::updateConfig(DetectedEnvironment& existing,
     existing.isValid = detected.isValid;
 }
 
+DetectedEnvironment CompilerConfigManager::loadOrDetect(const std::string& targetArch) {
+    DetectedEnvironment env;
+    if (!cacheFile_.empty() && loadCache(cacheFile_, targetArch, env)) {
+        return env;
+    }
+
+    EnvironmentDetector detector;
+    env = detector.detectEnvironment(targetArch);
+
+    // Sin caché escribible se detecta en cada invocación, como antes
+    if (!cacheFile_.empty()) {
+        saveCache(cacheFile_, env);
+    }
+    return env;
+}
+
+bool CompilerConfigManager::loadCache(const std::filesystem::path& cacheFile,
+                                      const std::string& targetArch,
+                                      DetectedEnvironment& env) {
+    std::ifstream in(cacheFile, std::ios::binary);
+    std::string line;
+    if (!in || !std::getline(in, line) || line != kEnvironmentCacheHeader) {
+        return false;
+    }
+
+    DetectedEnvironment loaded;
+    HostCPU cachedCPU;
+    bool hasCPU = false;
+    bool fingerprinted = false;
+    try {
+        while (std::getline(in, line)) {
+            auto fields = splitFields(line);
+            const std::string tag = fields.empty() ? std::string() : fields[0];
+
+            if (tag == "A" && fields.size() == 2) {
+                loaded.targetArchitecture = fields[1];
+            } else if (tag == "V" && fields.size() == 2) {
+                loaded.isValid = fields[1] == "1";
+            } else if (tag == "M" && fields.size() == 8) {
+                loaded.msvcVersion = MSVCVersion(std::stoi(fields[1]), std::stoi(fields[2]),
+                                                 std::stoi(fields[3]), std::stoi(fields[4]),
+                                                 fields[5], fields[7], fields[6]);
+                loaded.msvcInstallPath = fields[7];
+            } else if (tag == "S" && fields.size() == 6) {
+                loaded.windowsSDK = SDKVersion(std::stoi(fields[1]), std::stoi(fields[2]),
+                                               std::stoi(fields[3]), fields[4], fields[5]);
+                loaded.sdkInstallPath = fields[5];
+            } else if (tag == "I" && fields.size() == 2) {
+                loaded.includePaths.push_back(fields[1]);
+            } else if (tag == "L" && fields.size() == 2) {
+                loaded.libraryPaths.push_back(fields[1]);
+            } else if (tag == "P" && fields.size() == 2) {
+                loaded.preprocessorDefinitions.push_back(fields[1]);
+            } else if (tag == "C" && fields.size() == 8) {
+                cachedCPU.vendor = fields[1];
+                cachedCPU.signature = static_cast<uint32_t>(std::stoul(fields[2]));
+                cachedCPU.microarchitecture = static_cast<Microarchitecture>(std::stoi(fields[3]));
+                cachedCPU.features = featuresFromBits(static_cast<uint32_t>(std::stoul(fields[4])));
+                cachedCPU.l1DataKB = static_cast<uint32_t>(std::stoul(fields[5]));
+                cachedCPU.l2KB = static_cast<uint32_t>(std::stoul(fields[6]));
+                cachedCPU.l3KB = static_cast<uint32_t>(std::stoul(fields[7]));
+                hasCPU = true;
+            } else if (tag == "D" && fields.size() == 3) {
+                // Alguna instalación cambió: la detección guardada ya no vale
+                if (directoryTime(fields[2]) != std::stoll(fields[1])) {
+                    return false;
+                }
+                fingerprinted = true;
+            } else {
+                return false; // Archivo corrupto: se vuelve a detectar
+            }
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    EnvironmentDetector detector;
+    if (!fingerprinted || loaded.targetArchitecture != detector.getCanonicalArchitecture(targetArch)) {
+        return false;
+    }
+
+    // La CPU no invalida la instalación: si la caché es de otra (directorio
+    // personal compartido entre máquinas) solo se vuelve a detectar la CPU
+    if (hasCPU && std::make_pair(cachedCPU.vendor, cachedCPU.signature) == EnvironmentDetector::hostSignature()) {
+        decodeSignature(cachedCPU);
+        loaded.hostCPU = cachedCPU;
+    } else {
+        loaded.hostCPU = EnvironmentDetector::detectHostCPU();
+    }
+    env = std::move(loaded);
+    return true;
+}
+
+bool CompilerConfigManager::saveCache(const std::filesystem::path& cacheFile,
+                                      const DetectedEnvironment& env) {
+    std::ostringstream out;
+    out << kEnvironmentCacheHeader << '\n';
+    out << "A\t" << env.targetArchitecture << '\n';
+    out << "V\t" << (env.isValid ? 1 : 0) << '\n';
+
+    const auto& msvc = env.msvcVersion;
+    out << "M\t" << msvc.major << '\t' << msvc.minor << '\t' << msvc.build << '\t' << msvc.revision
+        << '\t' << msvc.fullVersion << '\t' << msvc.toolchainVersion << '\t'
+        << env.msvcInstallPath.string() << '\n';
+
+    const auto& sdk = env.windowsSDK;
+    out << "S\t" << sdk.major << '\t' << sdk.minor << '\t' << sdk.build << '\t' << sdk.fullVersion
+        << '\t' << env.sdkInstallPath.string() << '\n';
+
+    for (const auto& path : env.includePaths) {
+        out << "I\t" << path.string() << '\n';
+    }
+    for (const auto& path : env.libraryPaths) {
+        out << "L\t" << path.string() << '\n';
+    }
+    for (const auto& define : env.preprocessorDefinitions) {
+        out << "P\t" << define << '\n';
+    }
+    const HostCPU& cpu = env.hostCPU;
+    out << "C\t" << cpu.vendor << '\t' << cpu.signature << '\t' << static_cast<int>(cpu.microarchitecture)
+        << '\t' << featureBits(cpu.features) << '\t' << cpu.l1DataKB << '\t' << cpu.l2KB << '\t' << cpu.l3KB << '\n';
+    for (const auto& directory : EnvironmentDetector::fingerprintDirectories(env)) {
+        out << "D\t" << directoryTime(directory) << '\t' << directory.string() << '\n';
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(cacheFile.parent_path(), error);
+
+    // Varios compiladores pueden guardar a la vez: escribir aparte y renombrar
+    std::filesystem::path temporary = cacheFile;
+    temporary += "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()) ^
+                                      static_cast<size_t>(std::chrono::steady_clock::now()
+                                                              .time_since_epoch().count())) + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file || !(file << out.str())) {
+            file.close();
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporary, cacheFile, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+std::filesystem::path CompilerConfigManager::defaultCacheFile() {
+    std::filesystem::path base;
+#ifdef _WIN32
+    if (auto localAppData = EnvironmentUtils::getEnvironmentVariable("LOCALAPPDATA")) {
+        base = *localAppData;
+    }
+#else
+    auto xdgCache = EnvironmentUtils::getEnvironmentVariable("XDG_CACHE_HOME");
+    if (xdgCache && !xdgCache->empty()) {
+        base = *xdgCache;
+    } else if (auto home = EnvironmentUtils::getEnvironmentVariable("HOME")) {
+        base = std::filesystem::path(*home) / ".cache";
+    }
+#endif
+    if (base.empty()) {
+        return {};
+    }
+    return base / "cpp20-compiler" / "environment.cache";
+}
+
 std::string CompilerConfigManager::serializeConfigToJSON(const DetectedEnvironment& env) {
     std::stringstream ss;
 
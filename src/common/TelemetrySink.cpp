@@ -0,0 +1,406 @@
+/**
+ * @file TelemetrySink.cpp
+ * @brief Archivo de métricas del build y agregación en distribuciones
+ */
+
+#include <compiler/common/TelemetrySink.h>
+#include <compiler/common/utils/FileLock.h>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace cpp20::compiler {
+
+namespace {
+
+void appendEscaped(std::string& out, std::string_view text) {
+    out += '"';
+    for (char c : text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    out += buffer;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+}
+
+void appendNumber(std::string& out, double value) {
+    if (!std::isfinite(value)) {
+        out += '0';
+        return;
+    }
+    char buffer[32];
+    auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, error == std::errc() ? end : buffer);
+}
+
+/**
+ * @brief Lector del subconjunto de JSON que escribe formatRecord
+ */
+class RecordParser {
+public:
+    explicit RecordParser(std::string_view text) : text_(text) {}
+
+    bool ok() const { return ok_; }
+
+    bool atEnd() {
+        skipSpace();
+        return pos_ == text_.size();
+    }
+
+    bool consume(char expected) {
+        skipSpace();
+        if (pos_ < text_.size() && text_[pos_] == expected) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char expected) {
+        if (!consume(expected)) ok_ = false;
+    }
+
+    std::string string() {
+        std::string result;
+        expect('"');
+        while (ok_ && pos_ < text_.size() && text_[pos_] != '"') {
+            char c = text_[pos_++];
+            if (c != '\\') {
+                result += c;
+                continue;
+            }
+            if (pos_ >= text_.size()) break;
+            char escaped = text_[pos_++];
+            switch (escaped) {
+                case 'n': result += '\n'; break;
+                case 'r': result += '\r'; break;
+                case 't': result += '\t'; break;
+                case 'u': {
+                    unsigned code = 0;
+                    auto [end, error] = std::from_chars(text_.data() + pos_,
+                                                        text_.data() + std::min(pos_ + 4, text_.size()),
+                                                        code, 16);
+                    if (error != std::errc() || end != text_.data() + pos_ + 4 || code > 0x7f) {
+                        ok_ = false;
+                    }
+                    result += static_cast<char>(code);
+                    pos_ += 4;
+                    break;
+                }
+                default: result += escaped; break;
+            }
+        }
+        expect('"');
+        return result;
+    }
+
+    double number() {
+        skipSpace();
+        double value = 0;
+        auto [end, error] = std::from_chars(text_.data() + pos_, text_.data() + text_.size(), value);
+        if (error != std::errc()) {
+            ok_ = false;
+            return 0;
+        }
+        pos_ = static_cast<size_t>(end - text_.data());
+        return value;
+    }
+
+private:
+    std::string_view text_;
+    size_t pos_ = 0;
+    bool ok_ = true;
+
+    void skipSpace() {
+        while (pos_ < text_.size() && (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\r')) {
+            ++pos_;
+        }
+    }
+};
+
+double percentile(const std::vector<double>& sorted, double fraction) {
+    size_t rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+std::string formatValue(double value) {
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(std::fabs(value) >= 100 ? 0 : 2) << value;
+    return ss.str();
+}
+
+} // namespace
+
+// ============================================================================
+// TelemetrySink
+// ============================================================================
+
+std::string TelemetrySink::formatRecord(const TelemetryRecord& record) {
+    std::string line = "{\"unit\":";
+    appendEscaped(line, record.unit);
+    line += ",\"version\":";
+    appendEscaped(line, record.compilerVersion);
+    line += ",\"metrics\":{";
+    bool first = true;
+    for (const auto& [name, value] : record.metrics) {
+        if (!first) line += ',';
+        first = false;
+        appendEscaped(line, name);
+        line += ':';
+        appendNumber(line, value);
+    }
+    line += "}}";
+    return line;
+}
+
+std::optional<TelemetryRecord> TelemetrySink::parseRecord(std::string_view line) {
+    RecordParser parser(line);
+    TelemetryRecord record;
+    bool sawMetrics = false;
+
+    parser.expect('{');
+    while (parser.ok() && !parser.consume('}')) {
+        std::string field = parser.string();
+        parser.expect(':');
+        if (field == "unit") {
+            record.unit = parser.string();
+        } else if (field == "version") {
+            record.compilerVersion = parser.string();
+        } else if (field == "metrics") {
+            sawMetrics = true;
+            parser.expect('{');
+            while (parser.ok() && !parser.consume('}')) {
+                std::string name = parser.string();
+                parser.expect(':');
+                record.metrics[name] = parser.number();
+                if (!parser.consume(',')) {
+                    parser.expect('}');
+                    break;
+                }
+            }
+        } else {
+            return std::nullopt;
+        }
+        if (!parser.consume(',')) {
+            parser.expect('}');
+            break;
+        }
+    }
+
+    if (!parser.ok() || !parser.atEnd() || !sawMetrics) {
+        return std::nullopt;
+    }
+    return record;
+}
+
+bool TelemetrySink::append(const TelemetryRecord& record) const {
+    return append(std::vector<TelemetryRecord>{record});
+}
+
+bool TelemetrySink::append(const std::vector<TelemetryRecord>& records) const {
+    if (records.empty()) return true;
+
+    std::string text;
+    for (const auto& record : records) {
+        text += formatRecord(record);
+        text += '\n';
+    }
+
+    // Un solo write por proceso y bajo el bloqueo: las líneas no se mezclan
+    std::filesystem::path lockPath = path_;
+    lockPath += ".lock";
+    auto lock = common::utils::FileLock::acquire(lockPath);
+    if (!lock) return false;
+
+    std::ofstream file(path_, std::ios::binary | std::ios::app);
+    if (!file) return false;
+    file.write(text.data(), static_cast<std::streamsize>(text.size()));
+    return static_cast<bool>(file);
+}
+
+std::vector<TelemetryRecord> TelemetrySink::read(const std::filesystem::path& path, size_t* malformed) {
+    std::vector<TelemetryRecord> records;
+    size_t skipped = 0;
+
+    std::ifstream file(path, std::ios::binary);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty()) continue;
+        if (auto record = parseRecord(line)) {
+            records.push_back(std::move(*record));
+        } else {
+            ++skipped;
+        }
+    }
+
+    if (malformed) *malformed = skipped;
+    return records;
+}
+
+// ============================================================================
+// TelemetryAggregator
+// ============================================================================
+
+void TelemetryAggregator::add(const TelemetryRecord& record) {
+    if (!versionFilter_.empty() && record.compilerVersion != versionFilter_) return;
+
+    ++records_;
+    for (const auto& [name, value] : record.metrics) {
+        samples_[name].push_back(value);
+    }
+}
+
+void TelemetryAggregator::add(const std::vector<TelemetryRecord>& records) {
+    for (const auto& record : records) {
+        add(record);
+    }
+}
+
+std::vector<MetricDistribution> TelemetryAggregator::distributions() const {
+    std::vector<MetricDistribution> result;
+    result.reserve(samples_.size());
+
+    for (const auto& [name, values] : samples_) {
+        if (values.empty()) continue;
+
+        std::vector<double> sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+
+        MetricDistribution distribution;
+        distribution.name = name;
+        distribution.count = sorted.size();
+        distribution.min = sorted.front();
+        distribution.max = sorted.back();
+        for (double value : sorted) {
+            distribution.total += value;
+        }
+        distribution.mean = distribution.total / static_cast<double>(sorted.size());
+        distribution.p50 = percentile(sorted, 0.50);
+        distribution.p90 = percentile(sorted, 0.90);
+        distribution.p99 = percentile(sorted, 0.99);
+        result.push_back(std::move(distribution));
+    }
+    return result;
+}
+
+std::string TelemetryAggregator::generateReport() const {
+    std::stringstream ss;
+    ss << "=== Build Telemetry (" << records_ << " records) ===\n";
+    ss << std::left << std::setw(40) << "Metric" << std::right
+       << std::setw(8) << "Count" << std::setw(12) << "Min" << std::setw(12) << "p50"
+       << std::setw(12) << "p90" << std::setw(12) << "p99" << std::setw(12) << "Max"
+       << std::setw(14) << "Total" << "\n";
+
+    for (const auto& distribution : distributions()) {
+        ss << std::left << std::setw(40) << distribution.name << std::right
+           << std::setw(8) << distribution.count
+           << std::setw(12) << formatValue(distribution.min)
+           << std::setw(12) << formatValue(distribution.p50)
+           << std::setw(12) << formatValue(distribution.p90)
+           << std::setw(12) << formatValue(distribution.p99)
+           << std::setw(12) << formatValue(distribution.max)
+           << std::setw(14) << formatValue(distribution.total) << "\n";
+    }
+    return ss.str();
+}
+
+std::string TelemetryAggregator::generateJSON() const {
+    std::string json = "{\"records\":" + std::to_string(records_) + ",\"metrics\":[";
+    bool first = true;
+    for (const auto& distribution : distributions()) {
+        if (!first) json += ',';
+        first = false;
+        json += "\n  {\"name\":";
+        appendEscaped(json, distribution.name);
+        json += ",\"count\":" + std::to_string(distribution.count);
+        const std::pair<const char*, double> fields[] = {
+            {"min", distribution.min}, {"mean", distribution.mean}, {"p50", distribution.p50},
+            {"p90", distribution.p90}, {"p99", distribution.p99}, {"max", distribution.max},
+            {"total", distribution.total}};
+        for (const auto& [field, value] : fields) {
+            json += ",\"";
+            json += field;
+            json += "\":";
+            appendNumber(json, value);
+        }
+        json += '}';
+    }
+    json += "\n]}\n";
+    return json;
+}
+
+std::vector<MetricRegression> TelemetryAggregator::findRegressions(
+    const std::vector<MetricDistribution>& baseline,
+    const std::vector<MetricDistribution>& current,
+    double tolerance, size_t minSamples) {
+
+    std::map<std::string_view, const MetricDistribution*> baselineByName;
+    for (const auto& distribution : baseline) {
+        baselineByName[distribution.name] = &distribution;
+    }
+
+    // Incremento relativo; sin referencia útil (0) cualquier subida cuenta
+    auto growth = [](double before, double after) {
+        if (before == after) return 0.0;
+        if (before == 0) return after > 0 ? 1.0 : -1.0;
+        return (after - before) / std::fabs(before);
+    };
+
+    std::vector<MetricRegression> regressions;
+    for (const auto& distribution : current) {
+        auto it = baselineByName.find(distribution.name);
+        if (it == baselineByName.end()) continue;
+        const MetricDistribution& reference = *it->second;
+        if (reference.count < minSamples || distribution.count < minSamples) continue;
+
+        bool higherIsBetter = distribution.name.size() >= 8 &&
+            distribution.name.compare(distribution.name.size() - 8, 8, "hit_rate") == 0;
+        double sign = higherIsBetter ? -1.0 : 1.0;
+        double change = std::max(sign * growth(reference.p50, distribution.p50),
+                                 sign * growth(reference.p90, distribution.p90));
+        if (change <= tolerance) continue;
+
+        MetricRegression regression;
+        regression.name = distribution.name;
+        regression.baseline = reference.p50;
+        regression.current = distribution.p50;
+        regression.baselineP90 = reference.p90;
+        regression.currentP90 = distribution.p90;
+        regression.change = change;
+        regressions.push_back(std::move(regression));
+    }
+
+    std::sort(regressions.begin(), regressions.end(),
+              [](const MetricRegression& a, const MetricRegression& b) { return a.change > b.change; });
+    return regressions;
+}
+
+std::string TelemetryAggregator::formatRegressions(const std::vector<MetricRegression>& regressions) {
+    std::stringstream ss;
+    ss << "=== Regressions (" << regressions.size() << ") ===\n";
+    for (const auto& regression : regressions) {
+        ss << std::left << std::setw(40) << regression.name << std::right
+           << "  p50 " << formatValue(regression.baseline) << " -> " << formatValue(regression.current)
+           << "  p90 " << formatValue(regression.baselineP90) << " -> " << formatValue(regression.currentP90)
+           << "  (+" << std::fixed << std::setprecision(1) << regression.change * 100 << "%)\n";
+    }
+    return ss.str();
+}
+
+} // namespace cpp20::compiler
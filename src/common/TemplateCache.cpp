@@ -4,18 +4,190 @@
  */
 
 #include <compiler/common/TemplateCache.h>
-#include <fstream>
+#include <compiler/common/TimingProfiler.h>
+#include <compiler/common/utils/MemoryTracker.h>
 #include <sstream>
 #include <algorithm>
+#include <iomanip>
 #include <numeric>
 
 namespace cpp20::compiler {
 
+namespace {
+
+/**
+ * @brief Partición para un hash de clave
+ *
+ * Descarta los bits bajos, que son los que usa unordered_map dentro de la
+ * partición, para no concentrar cada tabla en unos pocos buckets.
+ */
+size_t shardIndex(uint64_t fingerprint, size_t shardCount) {
+    return static_cast<size_t>(fingerprint >> 58) & (shardCount - 1);
+}
+
+uint64_t hashTypeId(const types::Type* type) {
+    // Los tipos son canónicos (TypeContext): el puntero es su identidad
+    return common::utils::mix64(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(type)));
+}
+
+// ----------------------------------------------------------------------------
+// Registros en disco (CacheFile.h). Los punteros de tipo solo valen dentro
+// de la invocación, así que la clave persistente usa el texto de los tipos.
+// ----------------------------------------------------------------------------
+
+uint64_t persistentFingerprint(std::string_view encodedKey) {
+    return common::utils::mix64(common::utils::fnv1a64(encodedKey));
+}
+
+/**
+ * @brief Valor publicado en el almacén secundario: clave y valor codificados
+ *
+ * La clave viaja con el valor para descartar colisiones de dirección.
+ */
+std::string encodeSecondary(const std::string& key, const std::string& value) {
+    CacheRecordWriter writer;
+    writer.str(key);
+    writer.str(value);
+    return writer.take();
+}
+
+std::optional<std::string_view> decodeSecondary(std::string_view data, std::string_view expectedKey) {
+    CacheRecordReader reader(data);
+    std::string_view key = reader.str();
+    std::string_view value = reader.str();
+    if (!reader.ok() || key != expectedKey) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+std::string typeText(const types::Type* type) {
+    return type ? type->toString() : std::string();
+}
+
+std::chrono::system_clock::time_point decodeTimestamp(uint64_t ticks) {
+    return std::chrono::system_clock::time_point(std::chrono::system_clock::duration(
+        static_cast<std::chrono::system_clock::rep>(ticks)));
+}
+
+std::string encodeKey(const TemplateInstantiationKey& key) {
+    CacheRecordWriter writer;
+    writer.str(key.templateName);
+    writer.u32(static_cast<uint32_t>(key.argumentTypes.size()));
+    for (const types::Type* type : key.argumentTypes) {
+        writer.str(typeText(type));
+    }
+    writer.str(key.sourceLocation);
+    writer.str(key.compilationContext);
+    return writer.take();
+}
+
+std::string encodeValue(const TemplateInstantiationValue& value) {
+    CacheRecordWriter writer;
+    writer.u64(static_cast<uint64_t>(value.timestamp.time_since_epoch().count()));
+    writer.u64(value.memorySize);
+    writer.u8(value.isValid ? 1 : 0);
+    writer.u32(static_cast<uint32_t>(value.dependencies.size()));
+    for (const auto& dep : value.dependencies) {
+        writer.str(dep);
+    }
+    return writer.take();
+}
+
+std::unique_ptr<TemplateInstantiationValue> decodeTemplateValue(std::string_view data) {
+    CacheRecordReader reader(data);
+    auto value = std::make_unique<TemplateInstantiationValue>();
+    value->timestamp = decodeTimestamp(reader.u64());
+    value->memorySize = static_cast<size_t>(reader.u64());
+    value->isValid = reader.u8() != 0;
+    for (uint32_t i = 0, n = reader.u32(); i < n && reader.ok(); ++i) {
+        value->dependencies.emplace_back(reader.str());
+    }
+
+    // Nota: El AST no se serializa en esta implementación simplificada
+    value->instantiatedAST = nullptr;
+    return reader.ok() ? std::move(value) : nullptr;
+}
+
+std::string encodeKey(const ConstexprEvaluationKey& key) {
+    // El orden de unordered_map no es estable entre procesos
+    std::vector<std::pair<std::string_view, std::string>> parameters;
+    parameters.reserve(key.parameters.size());
+    for (const auto& [name, type] : key.parameters) {
+        parameters.emplace_back(name, typeText(type));
+    }
+    std::sort(parameters.begin(), parameters.end());
+
+    CacheRecordWriter writer;
+    writer.str(key.expression);
+    writer.str(key.context);
+    writer.u32(static_cast<uint32_t>(parameters.size()));
+    for (const auto& [name, type] : parameters) {
+        writer.str(name);
+        writer.str(type);
+    }
+    writer.str(key.compilationFlags);
+    return writer.take();
+}
+
+std::string encodeValue(const ConstexprEvaluationValue& value) {
+    CacheRecordWriter writer;
+    writer.str(value.result);
+    writer.u8(value.isConstant ? 1 : 0);
+    writer.u64(static_cast<uint64_t>(value.timestamp.time_since_epoch().count()));
+    writer.u64(value.evaluationSteps);
+    writer.u8(value.evaluationSucceeded ? 1 : 0);
+    writer.str(value.errorMessage);
+    return writer.take();
+}
+
+std::unique_ptr<ConstexprEvaluationValue> decodeConstexprValue(std::string_view data) {
+    CacheRecordReader reader(data);
+    auto value = std::make_unique<ConstexprEvaluationValue>();
+    value->result = std::string(reader.str());
+    value->isConstant = reader.u8() != 0;
+    value->timestamp = decodeTimestamp(reader.u64());
+    value->evaluationSteps = static_cast<size_t>(reader.u64());
+    value->evaluationSucceeded = reader.u8() != 0;
+    value->errorMessage = std::string(reader.str());
+    return reader.ok() ? std::move(value) : nullptr;
+}
+
+} // namespace
+
 // ============================================================================
-// TemplateInstantiationKey - Implementación
+// Huellas de las claves
 // ============================================================================
 
-// Ya definido en header
+uint64_t TemplateInstantiationKey::fingerprint() const {
+    using namespace common::utils;
+
+    uint64_t hash = fnv1a64(templateName);
+    hash = hashMix(hash, argumentTypes.size());
+    for (const types::Type* type : argumentTypes) {
+        hash = hashMix(hash, hashTypeId(type));
+    }
+    hash = hashMix(hash, fnv1a64(sourceLocation));
+    hash = hashMix(hash, fnv1a64(compilationContext));
+    return hash;
+}
+
+uint64_t ConstexprEvaluationKey::fingerprint() const {
+    using namespace common::utils;
+
+    uint64_t hash = fnv1a64(expression);
+    hash = hashMix(hash, fnv1a64(context));
+    hash = hashMix(hash, fnv1a64(compilationFlags));
+
+    // Suma de términos ya mezclados: independiente del orden de iteración
+    // del mapa sin que pares iguales se cancelen como con XOR
+    uint64_t params = 0;
+    for (const auto& [name, type] : parameters) {
+        params += hashMix(fnv1a64(name), hashTypeId(type));
+    }
+    hash = hashMix(hash, parameters.size());
+    return hashMix(hash, params);
+}
 
 // ============================================================================
 // TemplateInstantiationCache - Implementación
@@ -25,31 +197,80 @@ TemplateInstantiationCache::TemplateInstantiationCache(size_t maxMemory)
     : enabled_(true), maxMemory_(maxMemory) {
 }
 
-TemplateInstantiationCache::~TemplateInstantiationCache() = default;
+TemplateInstantiationCache::~TemplateInstantiationCache() {
+    if (secondary_) {
+        secondary_->wait();
+    }
+}
+
+TemplateInstantiationCache::Shard& TemplateInstantiationCache::shardFor(uint64_t fingerprint) {
+    return shards_[shardIndex(fingerprint, ShardCount)];
+}
+
+const TemplateInstantiationCache::Shard& TemplateInstantiationCache::shardFor(
+    uint64_t fingerprint) const {
+    return shards_[shardIndex(fingerprint, ShardCount)];
+}
+
+TemplateInstantiationCache::EntryMap::iterator TemplateInstantiationCache::findLocked(
+    Shard& shard, const TemplateInstantiationKey& key, uint64_t fingerprint) {
+    auto [first, last] = shard.entries.equal_range(fingerprint);
+    for (auto it = first; it != last; ++it) {
+        if (it->second.key == key) return it;
+    }
+    return shard.entries.end();
+}
+
+TemplateInstantiationCache::EntryMap::const_iterator TemplateInstantiationCache::findLocked(
+    const Shard& shard, const TemplateInstantiationKey& key, uint64_t fingerprint) {
+    auto [first, last] = shard.entries.equal_range(fingerprint);
+    for (auto it = first; it != last; ++it) {
+        if (it->second.key == key) return it;
+    }
+    return shard.entries.end();
+}
 
 const TemplateInstantiationValue* TemplateInstantiationCache::lookup(
     const TemplateInstantiationKey& key) const {
 
     if (!enabled_) return nullptr;
+    // Los aciertos del archivo persistido se decodifican aquí
+    common::utils::MemoryScope memoryScope(common::utils::MemorySubsystem::Caches);
+
+    totalInstantiations_.fetch_add(1, std::memory_order_relaxed);
+
+    const uint64_t fingerprint = key.fingerprint();
+    const Shard& shard = shardFor(fingerprint);
+    std::lock_guard<std::mutex> lock(shard.mutex);
 
-    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = findLocked(shard, key, fingerprint);
+    if (it != shard.entries.end()) {
+        // Mover al frente de la LRU: O(1), sin marcas de tiempo
+        lruUnlink(shard, it->second);
+        lruPushFront(shard, it->second);
 
-    auto it = cache_.find(key);
-    if (it != cache_.end()) {
-        // Actualizar tiempo de acceso para LRU
-        accessTimes_[key] = std::chrono::system_clock::now();
+        cacheHits_.fetch_add(1, std::memory_order_relaxed);
+        return it->second.value.get();
+    }
 
-        stats_.cacheHits++;
-        stats_.totalInstantiations++;
-        stats_.updateHitRate();
+    if (auto value = loadPersistedLocked(shard, key)) {
+        // Cargar un registro del archivo no cambia el contenido lógico del
+        // caché: solo lo materializa en memoria
+        auto& self = const_cast<TemplateInstantiationCache&>(*this);
+        Shard& writable = const_cast<Shard&>(shard);
+        if (needsCleanup()) {
+            self.evictLocked(writable);
+        }
 
-        return it->second.get();
+        cacheHits_.fetch_add(1, std::memory_order_relaxed);
+        return self.insertLocked(writable, key, fingerprint, std::move(value)).value.get();
     }
 
-    stats_.cacheMisses++;
-    stats_.totalInstantiations++;
-    stats_.updateHitRate();
+    if (secondary_) {
+        requestSecondary(key);
+    }
 
+    cacheMisses_.fetch_add(1, std::memory_order_relaxed);
     return nullptr;
 }
 
@@ -59,74 +280,85 @@ void TemplateInstantiationCache::store(
     const std::vector<std::string>& dependencies) {
 
     if (!enabled_) return;
-
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    // Verificar si necesitamos limpieza
-    if (needsCleanup()) {
-        performLRUCleanup();
-    }
+    common::utils::MemoryScope memoryScope(common::utils::MemorySubsystem::Caches);
 
     auto value = std::make_unique<TemplateInstantiationValue>();
     value->instantiatedAST = std::move(instantiatedAST);
     value->dependencies = dependencies;
     value->memorySize = calculateEntrySize(*value);
 
+    if (secondary_) {
+        publishSecondary(key, *value);
+    }
+
+    const uint64_t fingerprint = key.fingerprint();
+    Shard& shard = shardFor(fingerprint);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // Verificar si necesitamos limpieza
+    if (needsCleanup()) {
+        evictLocked(shard);
+    }
+
     // Verificar límites de memoria
-    if (stats_.memoryUsed + value->memorySize > maxMemory_) {
+    if (memoryUsed_.load(std::memory_order_relaxed) + value->memorySize > maxMemory_) {
         // No almacenar si excede el límite
         return;
     }
 
-    cache_[key] = std::move(value);
-    accessTimes_[key] = std::chrono::system_clock::now();
-
-    updateStats();
+    insertLocked(shard, key, fingerprint, std::move(value));
 }
 
 bool TemplateInstantiationCache::contains(const TemplateInstantiationKey& key) const {
     if (!enabled_) return false;
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    return cache_.find(key) != cache_.end();
+    const uint64_t fingerprint = key.fingerprint();
+    const Shard& shard = shardFor(fingerprint);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return findLocked(shard, key, fingerprint) != shard.entries.end();
 }
 
 void TemplateInstantiationCache::invalidate(const TemplateInstantiationKey& key) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    const uint64_t fingerprint = key.fingerprint();
+    Shard& shard = shardFor(fingerprint);
+    std::lock_guard<std::mutex> lock(shard.mutex);
 
-    auto it = cache_.find(key);
-    if (it != cache_.end()) {
-        stats_.memoryUsed -= it->second->memorySize;
-        cache_.erase(it);
-        accessTimes_.erase(key);
+    auto it = findLocked(shard, key, fingerprint);
+    if (it != shard.entries.end()) {
+        eraseLocked(shard, it);
+    }
+    if (persisted_) {
+        shard.hiddenPersisted.insert(persistentFingerprint(encodeKey(key)));
     }
-
-    updateStats();
 }
 
 void TemplateInstantiationCache::clear() {
-    std::lock_guard<std::mutex> lock(mutex_);
+    clearAllShards();
+}
 
-    cache_.clear();
-    accessTimes_.clear();
-    stats_ = TemplateCacheStats();
+TemplateCacheStats TemplateInstantiationCache::getStats() const {
+    TemplateCacheStats stats;
+    stats.totalInstantiations = totalInstantiations_.load(std::memory_order_relaxed);
+    stats.cacheHits = cacheHits_.load(std::memory_order_relaxed);
+    stats.cacheMisses = cacheMisses_.load(std::memory_order_relaxed);
+    stats.memoryUsed = memoryUsed_.load(std::memory_order_relaxed);
+    stats.maxMemory = maxMemory_.load(std::memory_order_relaxed);
+    stats.updateHitRate();
+    return stats;
 }
 
 void TemplateInstantiationCache::setMaxMemory(size_t maxMemory) {
-    std::lock_guard<std::mutex> lock(mutex_);
     maxMemory_ = maxMemory;
-    stats_.maxMemory = maxMemory;
 
     // Realizar limpieza si es necesario
-    if (needsCleanup()) {
-        performLRUCleanup();
-    }
+    performLRUCleanup();
 }
 
 void TemplateInstantiationCache::performLRUCleanup() {
-    while (needsCleanup() && !cache_.empty()) {
-        auto lruKey = findLRUEntry();
-        invalidate(lruKey);
+    for (Shard& shard : shards_) {
+        if (!needsCleanup()) break;
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        evictLocked(shard);
     }
 }
 
@@ -134,59 +366,43 @@ bool TemplateInstantiationCache::serializeToFile(const std::filesystem::path& fi
     if (!enabled_) return false;
 
     try {
-        std::ofstream file(filePath, std::ios::binary);
-        if (!file.is_open()) return false;
-
-        std::lock_guard<std::mutex> lock(mutex_);
-
-        // Serializar estadísticas
-        file.write(reinterpret_cast<const char*>(&stats_), sizeof(stats_));
-
-        // Serializar número de entradas
-        size_t entryCount = cache_.size();
-        file.write(reinterpret_cast<const char*>(&entryCount), sizeof(entryCount));
-
-        // Serializar cada entrada
-        for (const auto& [key, value] : cache_) {
-            // Serializar clave
-            size_t nameLen = key.templateName.size();
-            file.write(reinterpret_cast<const char*>(&nameLen), sizeof(nameLen));
-            file.write(key.templateName.data(), nameLen);
-
-            size_t argCount = key.argumentTypes.size();
-            file.write(reinterpret_cast<const char*>(&argCount), sizeof(argCount));
-            for (const auto& type : key.argumentTypes) {
-                std::string typeStr = type.toString();
-                size_t typeLen = typeStr.size();
-                file.write(reinterpret_cast<const char*>(&typeLen), sizeof(typeLen));
-                file.write(typeStr.data(), typeLen);
+        CacheFileWriter writer;
+
+        // Bloquear todas las particiones para escribir una vista coherente
+        auto locks = lockAllShards();
+
+        writer.setCounter(0, totalInstantiations_.load(std::memory_order_relaxed));
+        writer.setCounter(1, cacheHits_.load(std::memory_order_relaxed));
+        writer.setCounter(2, cacheMisses_.load(std::memory_order_relaxed));
+
+        std::unordered_set<uint64_t> memoryFingerprints;
+        std::unordered_set<std::string> memoryKeys;
+        std::unordered_set<uint64_t> hidden;
+        for (const Shard& shard : shards_) {
+            for (const auto& [fingerprint, entry] : shard.entries) {
+                std::string key = encodeKey(entry.key);
+                uint64_t persistent = persistentFingerprint(key);
+                memoryFingerprints.insert(persistent);
+                writer.add(persistent, *memoryKeys.insert(std::move(key)).first,
+                           encodeValue(*entry.value));
             }
+            hidden.insert(shard.hiddenPersisted.begin(), shard.hiddenPersisted.end());
+        }
+
+        // Registros del archivo anterior que nadie llegó a pedir
+        for (size_t i = 0; persisted_ && i < persisted_->size(); ++i) {
+            uint64_t persistent = persisted_->fingerprintAt(i);
+            if (hidden.count(persistent)) continue;
 
-            size_t locLen = key.sourceLocation.size();
-            file.write(reinterpret_cast<const char*>(&locLen), sizeof(locLen));
-            file.write(key.sourceLocation.data(), locLen);
-
-            size_t ctxLen = key.compilationContext.size();
-            file.write(reinterpret_cast<const char*>(&ctxLen), sizeof(ctxLen));
-            file.write(key.compilationContext.data(), ctxLen);
-
-            // Serializar valor (simplificado)
-            auto timestamp = value->timestamp.time_since_epoch().count();
-            file.write(reinterpret_cast<const char*>(&timestamp), sizeof(timestamp));
-            file.write(reinterpret_cast<const char*>(&value->memorySize), sizeof(value->memorySize));
-            file.write(reinterpret_cast<const char*>(&value->isValid), sizeof(value->isValid));
-
-            size_t depCount = value->dependencies.size();
-            file.write(reinterpret_cast<const char*>(&depCount), sizeof(depCount));
-            for (const auto& dep : value->dependencies) {
-                size_t depLen = dep.size();
-                file.write(reinterpret_cast<const char*>(&depLen), sizeof(depLen));
-                file.write(dep.data(), depLen);
+            auto record = persisted_->record(i);
+            if (!record) continue;
+            if (memoryFingerprints.count(persistent) && memoryKeys.count(std::string(record->key))) {
+                continue;
             }
+            writer.add(persistent, std::string(record->key), std::string(record->value));
         }
 
-        file.close();
-        return true;
+        return writer.write(filePath, FileKind);
 
     } catch (const std::exception&) {
         return false;
@@ -194,96 +410,90 @@ bool TemplateInstantiationCache::serializeToFile(const std::filesystem::path& fi
 }
 
 bool TemplateInstantiationCache::deserializeFromFile(const std::filesystem::path& filePath) {
-    try {
-        std::ifstream file(filePath, std::ios::binary);
-        if (!file.is_open()) return false;
-
-        std::lock_guard<std::mutex> lock(mutex_);
-
-        // Limpiar caché actual
-        clear();
-
-        // Deserializar estadísticas
-        file.read(reinterpret_cast<char*>(&stats_), sizeof(stats_));
-
-        // Deserializar número de entradas
-        size_t entryCount;
-        file.read(reinterpret_cast<char*>(&entryCount), sizeof(entryCount));
-
-        // Deserializar cada entrada
-        for (size_t i = 0; i < entryCount; ++i) {
-            TemplateInstantiationKey key;
-
-            // Deserializar clave
-            size_t nameLen;
-            file.read(reinterpret_cast<char*>(&nameLen), sizeof(nameLen));
-            key.templateName.resize(nameLen);
-            file.read(key.templateName.data(), nameLen);
-
-            size_t argCount;
-            file.read(reinterpret_cast<char*>(&argCount), sizeof(argCount));
-            key.argumentTypes.reserve(argCount);
-            for (size_t j = 0; j < argCount; ++j) {
-                size_t typeLen;
-                file.read(reinterpret_cast<char*>(&typeLen), sizeof(typeLen));
-                std::string typeStr(typeLen, '\0');
-                file.read(typeStr.data(), typeLen);
-                // En un compilador real, aquí se convertiría el string a Type
-                key.argumentTypes.emplace_back(Type::fromString(typeStr));
-            }
+    auto reader = CacheFileReader::open(filePath, FileKind);
+    if (!reader) return false;
+
+    // Limpiar caché actual; la memoria usada crece a medida que se cargan entradas
+    clearAllShards();
+
+    auto locks = lockAllShards();
+    totalInstantiations_ = reader->counter(0);
+    cacheHits_ = reader->counter(1);
+    cacheMisses_ = reader->counter(2);
+    persisted_ = std::move(reader);
+    return true;
+}
 
-            size_t locLen;
-            file.read(reinterpret_cast<char*>(&locLen), sizeof(locLen));
-            key.sourceLocation.resize(locLen);
-            file.read(key.sourceLocation.data(), locLen);
-
-            size_t ctxLen;
-            file.read(reinterpret_cast<char*>(&ctxLen), sizeof(ctxLen));
-            key.compilationContext.resize(ctxLen);
-            file.read(key.compilationContext.data(), ctxLen);
-
-            // Deserializar valor
-            auto value = std::make_unique<TemplateInstantiationValue>();
-
-            long long timestamp;
-            file.read(reinterpret_cast<char*>(&timestamp), sizeof(timestamp));
-            value->timestamp = std::chrono::system_clock::time_point(
-                std::chrono::system_clock::duration(timestamp));
-
-            file.read(reinterpret_cast<char*>(&value->memorySize), sizeof(value->memorySize));
-            file.read(reinterpret_cast<char*>(&value->isValid), sizeof(value->isValid));
-
-            size_t depCount;
-            file.read(reinterpret_cast<char*>(&depCount), sizeof(depCount));
-            value->dependencies.reserve(depCount);
-            for (size_t j = 0; j < depCount; ++j) {
-                size_t depLen;
-                file.read(reinterpret_cast<char*>(&depLen), sizeof(depLen));
-                std::string dep(depLen, '\0');
-                file.read(dep.data(), depLen);
-                value->dependencies.push_back(dep);
-            }
+std::unique_ptr<TemplateInstantiationValue> TemplateInstantiationCache::loadPersistedLocked(
+    const Shard& shard, const TemplateInstantiationKey& key) const {
 
-            // Nota: El AST no se serializa en esta implementación simplificada
-            value->instantiatedAST = nullptr;
+    if (!persisted_) return nullptr;
 
-            cache_[key] = std::move(value);
-        }
+    std::string encoded = encodeKey(key);
+    uint64_t persistent = persistentFingerprint(encoded);
+    if (shard.hiddenPersisted.count(persistent)) return nullptr;
 
-        file.close();
-        updateStats();
-        return true;
+    auto [first, last] = persisted_->equalRange(persistent);
+    for (size_t i = first; i < last; ++i) {
+        auto record = persisted_->record(i);
+        if (record && record->key == encoded) {
+            return decodeTemplateValue(record->value);
+        }
+    }
+    return nullptr;
+}
 
-    } catch (const std::exception&) {
-        return false;
+std::array<std::unique_lock<std::mutex>, TemplateInstantiationCache::ShardCount>
+TemplateInstantiationCache::lockAllShards() const {
+    std::array<std::unique_lock<std::mutex>, ShardCount> locks;
+    for (size_t i = 0; i < ShardCount; ++i) {
+        locks[i] = std::unique_lock<std::mutex>(shards_[i].mutex);
     }
+    return locks;
+}
+
+void TemplateInstantiationCache::requestSecondary(const TemplateInstantiationKey& key) const {
+    std::string encoded = encodeKey(key);
+    std::string address = secondary_->address(FileKind, persistentFingerprint(encoded));
+
+    // La entrega llega desde un hilo del almacén; como en lookup(), cargar
+    // una entrada no cambia el contenido lógico del caché
+    auto* self = const_cast<TemplateInstantiationCache*>(this);
+    secondary_->prefetch(address, [self, key, encoded = std::move(encoded)](std::string_view data) {
+        if (auto value = decodeSecondary(data, encoded)) {
+            if (auto decoded = decodeTemplateValue(*value)) {
+                self->storeFetched(key, std::move(decoded));
+            }
+        }
+    });
 }
 
-void TemplateInstantiationCache::updateStats() {
-    stats_.memoryUsed = 0;
-    for (const auto& [key, value] : cache_) {
-        stats_.memoryUsed += value->memorySize;
+void TemplateInstantiationCache::publishSecondary(const TemplateInstantiationKey& key,
+                                                  const TemplateInstantiationValue& value) const {
+    std::string encoded = encodeKey(key);
+    std::string address = secondary_->address(FileKind, persistentFingerprint(encoded));
+    secondary_->writeBehind(address, encodeSecondary(encoded, encodeValue(value)));
+}
+
+void TemplateInstantiationCache::storeFetched(const TemplateInstantiationKey& key,
+                                              std::unique_ptr<TemplateInstantiationValue> value) {
+    if (!enabled_) return;
+    common::utils::MemoryScope memoryScope(common::utils::MemorySubsystem::Caches);
+
+    const uint64_t fingerprint = key.fingerprint();
+    Shard& shard = shardFor(fingerprint);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // Un store() posterior al fallo tiene preferencia
+    if (findLocked(shard, key, fingerprint) != shard.entries.end()) return;
+
+    if (needsCleanup()) {
+        evictLocked(shard);
     }
+    if (memoryUsed_.load(std::memory_order_relaxed) + value->memorySize > maxMemory_) {
+        return;
+    }
+    insertLocked(shard, key, fingerprint, std::move(value));
 }
 
 size_t TemplateInstantiationCache::calculateEntrySize(const TemplateInstantiationValue& value) const {
@@ -302,22 +512,95 @@ size_t TemplateInstantiationCache::calculateEntrySize(const TemplateInstantiatio
     return size;
 }
 
-TemplateInstantiationKey TemplateInstantiationCache::findLRUEntry() const {
-    auto oldestTime = std::chrono::system_clock::now();
-    TemplateInstantiationKey oldestKey;
+TemplateInstantiationCache::CacheEntry& TemplateInstantiationCache::insertLocked(
+    Shard& shard,
+    const TemplateInstantiationKey& key,
+    uint64_t fingerprint,
+    std::unique_ptr<TemplateInstantiationValue> value) {
+
+    auto it = findLocked(shard, key, fingerprint);
+    if (it == shard.entries.end()) {
+        it = shard.entries.emplace(fingerprint, CacheEntry{});
+        it->second.key = key;
+        it->second.fingerprint = fingerprint;
+    } else {
+        memoryUsed_.fetch_sub(it->second.value->memorySize, std::memory_order_relaxed);
+        lruUnlink(shard, it->second);
+    }
+    CacheEntry& entry = it->second;
+
+    memoryUsed_.fetch_add(value->memorySize, std::memory_order_relaxed);
+    entry.value = std::move(value);
+    lruPushFront(shard, entry);
+    return entry;
+}
 
-    for (const auto& [key, time] : accessTimes_) {
-        if (time < oldestTime) {
-            oldestTime = time;
-            oldestKey = key;
-        }
+void TemplateInstantiationCache::eraseLocked(Shard& shard, EntryMap::iterator it) {
+    memoryUsed_.fetch_sub(it->second.value->memorySize, std::memory_order_relaxed);
+    lruUnlink(shard, it->second);
+    shard.entries.erase(it);
+}
+
+void TemplateInstantiationCache::evictLocked(Shard& shard) {
+    while (needsCleanup() && shard.lruTail) {
+        const CacheEntry& tail = *shard.lruTail;
+        eraseLocked(shard, findLocked(shard, tail.key, tail.fingerprint));
+    }
+}
+
+void TemplateInstantiationCache::clearLocked(Shard& shard) {
+    size_t released = 0;
+    for (const auto& [fingerprint, entry] : shard.entries) {
+        released += entry.value->memorySize;
+    }
+    memoryUsed_.fetch_sub(released, std::memory_order_relaxed);
+
+    shard.entries.clear();
+    shard.lruHead = nullptr;
+    shard.lruTail = nullptr;
+}
+
+void TemplateInstantiationCache::clearAllShards() {
+    auto locks = lockAllShards();
+    for (Shard& shard : shards_) {
+        clearLocked(shard);
+        shard.hiddenPersisted.clear();
+    }
+    persisted_.reset();
+    totalInstantiations_ = 0;
+    cacheHits_ = 0;
+    cacheMisses_ = 0;
+}
+
+void TemplateInstantiationCache::lruUnlink(const Shard& shard, const CacheEntry& entry) {
+    if (entry.lruPrev) {
+        entry.lruPrev->lruNext = entry.lruNext;
+    } else if (shard.lruHead == &entry) {
+        shard.lruHead = entry.lruNext;
+    }
+    if (entry.lruNext) {
+        entry.lruNext->lruPrev = entry.lruPrev;
+    } else if (shard.lruTail == &entry) {
+        shard.lruTail = entry.lruPrev;
     }
+    entry.lruPrev = nullptr;
+    entry.lruNext = nullptr;
+}
 
-    return oldestKey;
+void TemplateInstantiationCache::lruPushFront(const Shard& shard, const CacheEntry& entry) {
+    entry.lruPrev = nullptr;
+    entry.lruNext = shard.lruHead;
+    if (shard.lruHead) {
+        shard.lruHead->lruPrev = &entry;
+    }
+    shard.lruHead = &entry;
+    if (!shard.lruTail) {
+        shard.lruTail = &entry;
+    }
 }
 
 bool TemplateInstantiationCache::needsCleanup() const {
-    return stats_.memoryUsed > maxMemory_;
+    return memoryUsed_.load(std::memory_order_relaxed) > maxMemory_.load(std::memory_order_relaxed);
 }
 
 // ============================================================================
@@ -328,27 +611,74 @@ ConstexprEvaluationCache::ConstexprEvaluationCache(size_t maxEntries)
     : enabled_(true), maxEntries_(maxEntries) {
 }
 
-ConstexprEvaluationCache::~ConstexprEvaluationCache() = default;
+ConstexprEvaluationCache::~ConstexprEvaluationCache() {
+    if (secondary_) {
+        secondary_->wait();
+    }
+}
+
+ConstexprEvaluationCache::Shard& ConstexprEvaluationCache::shardFor(uint64_t fingerprint) {
+    return shards_[shardIndex(fingerprint, ShardCount)];
+}
+
+const ConstexprEvaluationCache::Shard& ConstexprEvaluationCache::shardFor(
+    uint64_t fingerprint) const {
+    return shards_[shardIndex(fingerprint, ShardCount)];
+}
+
+ConstexprEvaluationCache::EntryMap::iterator ConstexprEvaluationCache::findLocked(
+    Shard& shard, const ConstexprEvaluationKey& key, uint64_t fingerprint) {
+    auto [first, last] = shard.entries.equal_range(fingerprint);
+    for (auto it = first; it != last; ++it) {
+        if (it->second.key == key) return it;
+    }
+    return shard.entries.end();
+}
+
+ConstexprEvaluationCache::EntryMap::const_iterator ConstexprEvaluationCache::findLocked(
+    const Shard& shard, const ConstexprEvaluationKey& key, uint64_t fingerprint) {
+    auto [first, last] = shard.entries.equal_range(fingerprint);
+    for (auto it = first; it != last; ++it) {
+        if (it->second.key == key) return it;
+    }
+    return shard.entries.end();
+}
 
 const ConstexprEvaluationValue* ConstexprEvaluationCache::lookup(
     const ConstexprEvaluationKey& key) const {
 
     if (!enabled_) return nullptr;
+    common::utils::MemoryScope memoryScope(common::utils::MemorySubsystem::Caches);
 
-    std::lock_guard<std::mutex> lock(mutex_);
+    totalEvaluations_.fetch_add(1, std::memory_order_relaxed);
 
-    auto it = cache_.find(key);
-    if (it != cache_.end()) {
-        stats_.cacheHits++;
-        stats_.totalEvaluations++;
-        stats_.updateHitRate();
-        return it->second.get();
+    const uint64_t fingerprint = key.fingerprint();
+    const Shard& shard = shardFor(fingerprint);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = findLocked(shard, key, fingerprint);
+    if (it != shard.entries.end()) {
+        cacheHits_.fetch_add(1, std::memory_order_relaxed);
+        return it->second.value.get();
     }
 
-    stats_.cacheMisses++;
-    stats_.totalEvaluations++;
-    stats_.updateHitRate();
+    if (auto value = loadPersistedLocked(shard, key)) {
+        // Igual que en TemplateInstantiationCache::lookup()
+        auto& self = const_cast<ConstexprEvaluationCache&>(*this);
+        Shard& writable = const_cast<Shard&>(shard);
+        if (entryCount_.load(std::memory_order_relaxed) >= maxEntries_) {
+            self.evictLocked(writable);
+        }
 
+        cacheHits_.fetch_add(1, std::memory_order_relaxed);
+        return self.insertLocked(writable, key, fingerprint, std::move(value)).value.get();
+    }
+
+    if (secondary_) {
+        requestSecondary(key);
+    }
+
+    cacheMisses_.fetch_add(1, std::memory_order_relaxed);
     return nullptr;
 }
 
@@ -361,13 +691,7 @@ void ConstexprEvaluationCache::store(
     const std::string& errorMessage) {
 
     if (!enabled_) return;
-
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    // Verificar si necesitamos limpieza
-    if (cache_.size() >= maxEntries_) {
-        performLRUCleanup();
-    }
+    common::utils::MemoryScope memoryScope(common::utils::MemorySubsystem::Caches);
 
     auto value = std::make_unique<ConstexprEvaluationValue>();
     value->result = result;
@@ -377,38 +701,71 @@ void ConstexprEvaluationCache::store(
     value->errorMessage = errorMessage;
 
     if (!evaluationSucceeded) {
-        stats_.failedEvaluations++;
+        failedEvaluations_.fetch_add(1, std::memory_order_relaxed);
     }
 
-    cache_[key] = std::move(value);
-    updateStats();
+    if (secondary_) {
+        publishSecondary(key, *value);
+    }
+
+    const uint64_t fingerprint = key.fingerprint();
+    Shard& shard = shardFor(fingerprint);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // Verificar si necesitamos limpieza
+    if (findLocked(shard, key, fingerprint) == shard.entries.end() &&
+        entryCount_.load(std::memory_order_relaxed) >= maxEntries_) {
+        evictLocked(shard);
+    }
+
+    insertLocked(shard, key, fingerprint, std::move(value));
 }
 
 bool ConstexprEvaluationCache::contains(const ConstexprEvaluationKey& key) const {
     if (!enabled_) return false;
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    return cache_.find(key) != cache_.end();
+    const uint64_t fingerprint = key.fingerprint();
+    const Shard& shard = shardFor(fingerprint);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return findLocked(shard, key, fingerprint) != shard.entries.end();
 }
 
 void ConstexprEvaluationCache::invalidate(const ConstexprEvaluationKey& key) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    cache_.erase(key);
-    updateStats();
+    const uint64_t fingerprint = key.fingerprint();
+    Shard& shard = shardFor(fingerprint);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = findLocked(shard, key, fingerprint);
+    if (it != shard.entries.end()) {
+        shard.entries.erase(it);
+        entryCount_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    if (persisted_) {
+        shard.hiddenPersisted.insert(persistentFingerprint(encodeKey(key)));
+    }
 }
 
 void ConstexprEvaluationCache::clear() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    cache_.clear();
-    stats_ = ConstexprCacheStats();
+    clearAllShards();
+}
+
+ConstexprCacheStats ConstexprEvaluationCache::getStats() const {
+    ConstexprCacheStats stats;
+    stats.totalEvaluations = totalEvaluations_.load(std::memory_order_relaxed);
+    stats.cacheHits = cacheHits_.load(std::memory_order_relaxed);
+    stats.cacheMisses = cacheMisses_.load(std::memory_order_relaxed);
+    stats.failedEvaluations = failedEvaluations_.load(std::memory_order_relaxed);
+    stats.updateHitRate();
+    return stats;
 }
 
 void ConstexprEvaluationCache::setMaxEntries(size_t maxEntries) {
-    std::lock_guard<std::mutex> lock(mutex_);
     maxEntries_ = maxEntries;
 
-    if (cache_.size() > maxEntries_) {
-        performLRUCleanup();
+    for (Shard& shard : shards_) {
+        if (entryCount_.load(std::memory_order_relaxed) <= maxEntries_) break;
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        evictLocked(shard);
     }
 }
 
@@ -416,66 +773,43 @@ bool ConstexprEvaluationCache::serializeToFile(const std::filesystem::path& file
     if (!enabled_) return false;
 
     try {
-        std::ofstream file(filePath, std::ios::binary);
-        if (!file.is_open()) return false;
-
-        std::lock_guard<std::mutex> lock(mutex_);
-
-        // Serializar estadísticas
-        file.write(reinterpret_cast<const char*>(&stats_), sizeof(stats_));
-
-        // Serializar número de entradas
-        size_t entryCount = cache_.size();
-        file.write(reinterpret_cast<const char*>(&entryCount), sizeof(entryCount));
-
-        // Serializar cada entrada
-        for (const auto& [key, value] : cache_) {
-            // Serializar clave
-            size_t exprLen = key.expression.size();
-            file.write(reinterpret_cast<const char*>(&exprLen), sizeof(exprLen));
-            file.write(key.expression.data(), exprLen);
-
-            size_t ctxLen = key.context.size();
-            file.write(reinterpret_cast<const char*>(&ctxLen), sizeof(ctxLen));
-            file.write(key.context.data(), ctxLen);
-
-            size_t paramCount = key.parameters.size();
-            file.write(reinterpret_cast<const char*>(&paramCount), sizeof(paramCount));
-            for (const auto& [name, type] : key.parameters) {
-                size_t nameLen = name.size();
-                file.write(reinterpret_cast<const char*>(&nameLen), sizeof(nameLen));
-                file.write(name.data(), nameLen);
-
-                std::string typeStr = type.toString();
-                size_t typeLen = typeStr.size();
-                file.write(reinterpret_cast<const char*>(&typeLen), sizeof(typeLen));
-                file.write(typeStr.data(), typeLen);
+        CacheFileWriter writer;
+
+        // Bloquear todas las particiones para escribir una vista coherente
+        auto locks = lockAllShards();
+
+        writer.setCounter(0, totalEvaluations_.load(std::memory_order_relaxed));
+        writer.setCounter(1, cacheHits_.load(std::memory_order_relaxed));
+        writer.setCounter(2, cacheMisses_.load(std::memory_order_relaxed));
+        writer.setCounter(3, failedEvaluations_.load(std::memory_order_relaxed));
+
+        std::unordered_set<uint64_t> memoryFingerprints;
+        std::unordered_set<std::string> memoryKeys;
+        std::unordered_set<uint64_t> hidden;
+        for (const Shard& shard : shards_) {
+            for (const auto& [fingerprint, entry] : shard.entries) {
+                std::string key = encodeKey(entry.key);
+                uint64_t persistent = persistentFingerprint(key);
+                memoryFingerprints.insert(persistent);
+                writer.add(persistent, *memoryKeys.insert(std::move(key)).first,
+                           encodeValue(*entry.value));
             }
+            hidden.insert(shard.hiddenPersisted.begin(), shard.hiddenPersisted.end());
+        }
 
-            size_t flagsLen = key.compilationFlags.size();
-            file.write(reinterpret_cast<const char*>(&flagsLen), sizeof(flagsLen));
-            file.write(key.compilationFlags.data(), flagsLen);
-
-            // Serializar valor
-            size_t resultLen = value->result.size();
-            file.write(reinterpret_cast<const char*>(&resultLen), sizeof(resultLen));
-            file.write(value->result.data(), resultLen);
-
-            file.write(reinterpret_cast<const char*>(&value->isConstant), sizeof(value->isConstant));
-
-            auto timestamp = value->timestamp.time_since_epoch().count();
-            file.write(reinterpret_cast<const char*>(&timestamp), sizeof(timestamp));
-
-            file.write(reinterpret_cast<const char*>(&value->evaluationSteps), sizeof(value->evaluationSteps));
-            file.write(reinterpret_cast<const char*>(&value->evaluationSucceeded), sizeof(value->evaluationSucceeded));
+        for (size_t i = 0; persisted_ && i < persisted_->size(); ++i) {
+            uint64_t persistent = persisted_->fingerprintAt(i);
+            if (hidden.count(persistent)) continue;
 
-            size_t errorLen = value->errorMessage.size();
-            file.write(reinterpret_cast<const char*>(&errorLen), sizeof(errorLen));
-            file.write(value->errorMessage.data(), errorLen);
+            auto record = persisted_->record(i);
+            if (!record) continue;
+            if (memoryFingerprints.count(persistent) && memoryKeys.count(std::string(record->key))) {
+                continue;
+            }
+            writer.add(persistent, std::string(record->key), std::string(record->value));
         }
 
-        file.close();
-        return true;
+        return writer.write(filePath, FileKind);
 
     } catch (const std::exception&) {
         return false;
@@ -483,105 +817,123 @@ bool ConstexprEvaluationCache::serializeToFile(const std::filesystem::path& file
 }
 
 bool ConstexprEvaluationCache::deserializeFromFile(const std::filesystem::path& filePath) {
-    try {
-        std::ifstream file(filePath, std::ios::binary);
-        if (!file.is_open()) return false;
-
-        std::lock_guard<std::mutex> lock(mutex_);
-
-        // Limpiar caché actual
-        clear();
-
-        // Deserializar estadísticas
-        file.read(reinterpret_cast<char*>(&stats_), sizeof(stats_));
-
-        // Deserializar número de entradas
-        size_t entryCount;
-        file.read(reinterpret_cast<char*>(&entryCount), sizeof(entryCount));
-
-        // Deserializar cada entrada
-        for (size_t i = 0; i < entryCount; ++i) {
-            ConstexprEvaluationKey key;
-
-            // Deserializar clave
-            size_t exprLen;
-            file.read(reinterpret_cast<char*>(&exprLen), sizeof(exprLen));
-            key.expression.resize(exprLen);
-            file.read(key.expression.data(), exprLen);
-
-            size_t ctxLen;
-            file.read(reinterpret_cast<char*>(&ctxLen), sizeof(ctxLen));
-            key.context.resize(ctxLen);
-            file.read(key.context.data(), ctxLen);
-
-            size_t paramCount;
-            file.read(reinterpret_cast<char*>(&paramCount), sizeof(paramCount));
-            for (size_t j = 0; j < paramCount; ++j) {
-                size_t nameLen;
-                file.read(reinterpret_cast<char*>(&nameLen), sizeof(nameLen));
-                std::string name(nameLen, '\0');
-                file.read(name.data(), nameLen);
-
-                size_t typeLen;
-                file.read(reinterpret_cast<char*>(&typeLen), sizeof(typeLen));
-                std::string typeStr(typeLen, '\0');
-                file.read(typeStr.data(), typeLen);
-
-                key.parameters[name] = Type::fromString(typeStr);
-            }
-
-            size_t flagsLen;
-            file.read(reinterpret_cast<char*>(&flagsLen), sizeof(flagsLen));
-            key.compilationFlags.resize(flagsLen);
-            file.read(key.compilationFlags.data(), flagsLen);
+    auto reader = CacheFileReader::open(filePath, FileKind);
+    if (!reader) return false;
+
+    clearAllShards();
+
+    auto locks = lockAllShards();
+    totalEvaluations_ = reader->counter(0);
+    cacheHits_ = reader->counter(1);
+    cacheMisses_ = reader->counter(2);
+    failedEvaluations_ = reader->counter(3);
+    persisted_ = std::move(reader);
+    return true;
+}
 
-            // Deserializar valor
-            auto value = std::make_unique<ConstexprEvaluationValue>();
+std::unique_ptr<ConstexprEvaluationValue> ConstexprEvaluationCache::loadPersistedLocked(
+    const Shard& shard, const ConstexprEvaluationKey& key) const {
 
-            size_t resultLen;
-            file.read(reinterpret_cast<char*>(&resultLen), sizeof(resultLen));
-            value->result.resize(resultLen);
-            file.read(value->result.data(), resultLen);
+    if (!persisted_) return nullptr;
 
-            file.read(reinterpret_cast<char*>(&value->isConstant), sizeof(value->isConstant));
+    std::string encoded = encodeKey(key);
+    uint64_t persistent = persistentFingerprint(encoded);
+    if (shard.hiddenPersisted.count(persistent)) return nullptr;
 
-            long long timestamp;
-            file.read(reinterpret_cast<char*>(&timestamp), sizeof(timestamp));
-            value->timestamp = std::chrono::system_clock::time_point(
-                std::chrono::system_clock::duration(timestamp));
+    auto [first, last] = persisted_->equalRange(persistent);
+    for (size_t i = first; i < last; ++i) {
+        auto record = persisted_->record(i);
+        if (record && record->key == encoded) {
+            return decodeConstexprValue(record->value);
+        }
+    }
+    return nullptr;
+}
 
-            file.read(reinterpret_cast<char*>(&value->evaluationSteps), sizeof(value->evaluationSteps));
-            file.read(reinterpret_cast<char*>(&value->evaluationSucceeded), sizeof(value->evaluationSucceeded));
+std::array<std::unique_lock<std::mutex>, ConstexprEvaluationCache::ShardCount>
+ConstexprEvaluationCache::lockAllShards() const {
+    std::array<std::unique_lock<std::mutex>, ShardCount> locks;
+    for (size_t i = 0; i < ShardCount; ++i) {
+        locks[i] = std::unique_lock<std::mutex>(shards_[i].mutex);
+    }
+    return locks;
+}
 
-            size_t errorLen;
-            file.read(reinterpret_cast<char*>(&errorLen), sizeof(errorLen));
-            value->errorMessage.resize(errorLen);
-            file.read(value->errorMessage.data(), errorLen);
+void ConstexprEvaluationCache::requestSecondary(const ConstexprEvaluationKey& key) const {
+    std::string encoded = encodeKey(key);
+    std::string address = secondary_->address(FileKind, persistentFingerprint(encoded));
 
-            cache_[key] = std::move(value);
+    auto* self = const_cast<ConstexprEvaluationCache*>(this);
+    secondary_->prefetch(address, [self, key, encoded = std::move(encoded)](std::string_view data) {
+        if (auto value = decodeSecondary(data, encoded)) {
+            if (auto decoded = decodeConstexprValue(*value)) {
+                self->storeFetched(key, std::move(decoded));
+            }
         }
+    });
+}
 
-        file.close();
-        updateStats();
-        return true;
+void ConstexprEvaluationCache::publishSecondary(const ConstexprEvaluationKey& key,
+                                                const ConstexprEvaluationValue& value) const {
+    std::string encoded = encodeKey(key);
+    std::string address = secondary_->address(FileKind, persistentFingerprint(encoded));
+    secondary_->writeBehind(address, encodeSecondary(encoded, encodeValue(value)));
+}
 
-    } catch (const std::exception&) {
-        return false;
+void ConstexprEvaluationCache::storeFetched(const ConstexprEvaluationKey& key,
+                                            std::unique_ptr<ConstexprEvaluationValue> value) {
+    if (!enabled_) return;
+    common::utils::MemoryScope memoryScope(common::utils::MemorySubsystem::Caches);
+
+    const uint64_t fingerprint = key.fingerprint();
+    Shard& shard = shardFor(fingerprint);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    if (findLocked(shard, key, fingerprint) != shard.entries.end()) return;
+
+    if (entryCount_.load(std::memory_order_relaxed) >= maxEntries_) {
+        evictLocked(shard);
     }
+    insertLocked(shard, key, fingerprint, std::move(value));
 }
 
-void ConstexprEvaluationCache::updateStats() {
-    // Las estadísticas se actualizan en tiempo real en lookup() y store()
+void ConstexprEvaluationCache::evictLocked(Shard& shard) {
+    // Sin información de acceso: se eliminan entradas arbitrarias de la
+    // partición que necesita espacio hasta dejar sitio para una nueva
+    while (entryCount_.load(std::memory_order_relaxed) >= maxEntries_ &&
+           !shard.entries.empty()) {
+        shard.entries.erase(shard.entries.begin());
+        entryCount_.fetch_sub(1, std::memory_order_relaxed);
+    }
 }
 
-void ConstexprEvaluationCache::performLRUCleanup() {
-    // En una implementación real, mantendríamos un timestamp de acceso
-    // Por simplicidad, eliminamos entradas antiguas hasta llegar al límite
+ConstexprEvaluationCache::CacheEntry& ConstexprEvaluationCache::insertLocked(
+    Shard& shard,
+    const ConstexprEvaluationKey& key,
+    uint64_t fingerprint,
+    std::unique_ptr<ConstexprEvaluationValue> value) {
+
+    auto it = findLocked(shard, key, fingerprint);
+    if (it == shard.entries.end()) {
+        it = shard.entries.emplace(fingerprint, CacheEntry{key, nullptr});
+        entryCount_.fetch_add(1, std::memory_order_relaxed);
+    }
+    it->second.value = std::move(value);
+    return it->second;
+}
 
-    while (cache_.size() > maxEntries_ && !cache_.empty()) {
-        // Eliminar la primera entrada (simplificado)
-        cache_.erase(cache_.begin());
+void ConstexprEvaluationCache::clearAllShards() {
+    auto locks = lockAllShards();
+    for (Shard& shard : shards_) {
+        entryCount_.fetch_sub(shard.entries.size(), std::memory_order_relaxed);
+        shard.entries.clear();
+        shard.hiddenPersisted.clear();
     }
+    persisted_.reset();
+    totalEvaluations_ = 0;
+    cacheHits_ = 0;
+    cacheMisses_ = 0;
+    failedEvaluations_ = 0;
 }
 
 // ============================================================================
@@ -592,7 +944,25 @@ UnifiedCache::UnifiedCache(size_t templateCacheMemory, size_t constexprCacheEntr
     : templateCache_(templateCacheMemory), constexprCache_(constexprCacheEntries) {
 }
 
-UnifiedCache::~UnifiedCache() = default;
+UnifiedCache::~UnifiedCache() {
+    setSecondaryBackend(nullptr, {}, 0);
+}
+
+void UnifiedCache::setSecondaryBackend(std::shared_ptr<CacheBackend> backend,
+                                       std::string_view compilerVersion,
+                                       uint64_t optionsHash) {
+    // Desconectar antes de destruir: el anterior espera sus entregas
+    templateCache_.setSecondary(nullptr);
+    constexprCache_.setSecondary(nullptr);
+    secondary_.reset();
+
+    if (!backend) return;
+
+    secondary_ = std::make_unique<SecondaryCache>(
+        std::move(backend), SecondaryCache::namespaceKeyFor(compilerVersion, optionsHash));
+    templateCache_.setSecondary(secondary_.get());
+    constexprCache_.setSecondary(secondary_.get());
+}
 
 bool UnifiedCache::loadFromFiles(const std::filesystem::path& templateCacheFile,
                                 const std::filesystem::path& constexprCacheFile) {
@@ -637,9 +1007,33 @@ std::string UnifiedCache::getUnifiedStats() const {
     ss << "  Failed evaluations: " << constexprStats.failedEvaluations << "\n";
     ss << "  Hit rate: " << std::fixed << std::setprecision(1) << constexprStats.hitRate << "%\n";
 
+    if (secondary_) {
+        ss << "\nSecondary Cache:\n";
+        ss << "  Fetches: " << secondary_->fetchCount() << "\n";
+        ss << "  Hits: " << secondary_->hitCount() << "\n";
+        ss << "  Writes: " << secondary_->writeCount() << "\n";
+    }
+
     return ss.str();
 }
 
+void UnifiedCache::recordTelemetry(CompilationTelemetry& telemetry) const {
+    const auto templateStats = templateCache_.getStats();
+    telemetry.recordMetric("cache.template.lookups", static_cast<double>(templateStats.totalInstantiations));
+    telemetry.recordMetric("cache.template.hits", static_cast<double>(templateStats.cacheHits));
+    telemetry.recordMetric("cache.template.memory_bytes", static_cast<double>(templateStats.memoryUsed));
+    if (templateStats.totalInstantiations > 0) {
+        telemetry.recordMetric("cache.template.hit_rate", templateStats.hitRate);
+    }
+
+    const auto constexprStats = constexprCache_.getStats();
+    telemetry.recordMetric("cache.constexpr.lookups", static_cast<double>(constexprStats.totalEvaluations));
+    telemetry.recordMetric("cache.constexpr.hits", static_cast<double>(constexprStats.cacheHits));
+    if (constexprStats.totalEvaluations > 0) {
+        telemetry.recordMetric("cache.constexpr.hit_rate", constexprStats.hitRate);
+    }
+}
+
 void UnifiedCache::setEnabled(bool enabled) {
     templateCache_.setEnabled(enabled);
     constexprCache_.setEnabled(enabled);
@@ -4,7 +4,10 @@
  */
 
 #include <compiler/common/TimingProfiler.h>
+#include <compiler/common/utils/MemoryTracker.h>
 #include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <numeric>
@@ -14,10 +17,76 @@
 #include <windows.h>
 #include <psapi.h>
 #pragma comment(lib, "psapi.lib")
+#elif defined(__linux__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define CPP20_TRACE_USE_TSC 1
 #endif
 
 namespace cpp20::compiler {
 
+namespace {
+
+// Generaciones únicas entre todos los profilers del proceso
+std::atomic<uint64_t> nextTraceGeneration{1};
+
+std::string escapeJSON(const std::string& text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\r': escaped += "\\r"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    escaped += buffer;
+                } else {
+                    escaped += c;
+                }
+        }
+    }
+    return escaped;
+}
+
+// Ámbito abierto más interno de cada hilo, para descontar el tiempo propio
+thread_local AutoTimer* currentTimer = nullptr;
+
+std::string formatBytes(size_t bytes) {
+    const char* units[] = {"B", "KB", "MB", "GB"};
+    size_t unitIndex = 0;
+    double size = static_cast<double>(bytes);
+
+    while (size >= 1024 && unitIndex < 3) {
+        size /= 1024;
+        unitIndex++;
+    }
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2) << size << " " << units[unitIndex];
+    return ss.str();
+}
+
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+} // namespace
+
 // ============================================================================
 // PhaseTiming - Implementación
 // ============================================================================
@@ -35,17 +104,61 @@ namespace cpp20::compiler {
 // ============================================================================
 
 AutoTimer::AutoTimer(TimingProfiler& profiler, CompilationPhase phase, const std::string& details)
+    : AutoTimer(&profiler, phase, details) {
+}
+
+AutoTimer::AutoTimer(TimingProfiler* profiler, CompilationPhase phase, const std::string& details)
     : profiler_(profiler), phase_(phase), details_(details),
       operations_(0), memoryUsed_(0) {
+    if (!profiler_) return;
+    if (common::utils::MemoryTracker::isEnabled()) {
+        trackingMemory_ = true;
+        startMemory_ = common::utils::MemoryTracker::totalCurrent();
+        outerPeakWindow_ = common::utils::MemoryTracker::beginPeakWindow();
+    }
     startTime_ = std::chrono::steady_clock::now();
-    profiler_.startPhase(phase_, details_);
+    if (profiler_->isTracing() || profiler_->isTrackingEntities()) {
+        startTicks_ = TimingProfiler::now();
+        parent_ = currentTimer;
+        currentTimer = this;
+    }
 }
 
 AutoTimer::~AutoTimer() {
+    if (!profiler_) return;
+
+    // Ámbitos abiertos antes de enableTrace() no tienen inicio en ticks
+    if (startTicks_ != 0) {
+        uint64_t endTicks = TimingProfiler::now();
+        uint64_t elapsed = endTicks - startTicks_;
+        currentTimer = parent_;
+        if (parent_) {
+            parent_->childTicks_ += elapsed;
+        }
+
+        if (profiler_->isTracing()) {
+            profiler_->recordTraceEvent(phase_, startTicks_, endTicks, details_);
+        }
+        if (profiler_->isTrackingEntities() && !details_.empty()) {
+            profiler_->recordEntity(phase_, details_, elapsed,
+                                    elapsed - std::min(elapsed, childTicks_), memoryUsed_);
+        }
+    }
+
     auto endTime = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime_);
 
-    profiler_.recordPhaseTiming(phase_, duration, memoryUsed_, operations_, details_);
+    size_t peakMemory = 0;
+    if (trackingMemory_) {
+        size_t endMemory = common::utils::MemoryTracker::totalCurrent();
+        peakMemory = common::utils::MemoryTracker::endPeakWindow(outerPeakWindow_);
+        peakMemory -= std::min(peakMemory, startMemory_);
+        if (endMemory > startMemory_) {
+            memoryUsed_ = std::max(memoryUsed_, endMemory - startMemory_);
+        }
+    }
+
+    profiler_->recordPhaseTiming(phase_, duration, memoryUsed_, operations_, details_, peakMemory);
 }
 
 void AutoTimer::addDetails(const std::string& details) {
@@ -69,6 +182,9 @@ void AutoTimer::recordMemoryUsage(size_t bytes) {
 
 TimingProfiler::TimingProfiler() : enabled_(true) {
     initializePhaseNames();
+    traceStartTime_ = std::chrono::steady_clock::now();
+    traceStartTicks_ = now();
+    generation_.store(nextTraceGeneration.fetch_add(1), std::memory_order_relaxed);
 }
 
 TimingProfiler::~TimingProfiler() = default;
@@ -78,11 +194,13 @@ void TimingProfiler::initializePhaseNames() {
         {CompilationPhase::Lexing, "Lexing"},
         {CompilationPhase::Parsing, "Parsing"},
         {CompilationPhase::Preprocessing, "Preprocessing"},
+        {CompilationPhase::HeaderInclusion, "Header Inclusion"},
         {CompilationPhase::SemanticAnalysis, "Semantic Analysis"},
         {CompilationPhase::TemplateInstantiation, "Template Instantiation"},
         {CompilationPhase::ConstexprEvaluation, "Constexpr Evaluation"},
         {CompilationPhase::ConceptChecking, "Concept Checking"},
         {CompilationPhase::IRGeneration, "IR Generation"},
+        {CompilationPhase::CodeGeneration, "Code Generation"},
         {CompilationPhase::InstructionSelection, "Instruction Selection"},
         {CompilationPhase::RegisterAllocation, "Register Allocation"},
         {CompilationPhase::CodeOptimization, "Code Optimization"},
@@ -99,6 +217,7 @@ void TimingProfiler::initializePhaseNames() {
         {CompilationPhase::DiagnosticEmission, "Diagnostic Emission"},
         {CompilationPhase::FileIO, "File I/O"},
         {CompilationPhase::MemoryManagement, "Memory Management"},
+        {CompilationPhase::TranslationUnit, "Translation Unit"},
         {CompilationPhase::TotalCompilation, "Total Compilation"},
         {CompilationPhase::CustomPhase, "Custom Phase"}
     };
@@ -130,10 +249,10 @@ void TimingProfiler::endPhase(CompilationPhase phase) {
         auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
             endTime - it->second);
 
-        recordPhaseTiming(phase, duration,
-                         activeMemory_[phase],
-                         activeOperations_[phase],
-                         activeDetails_[phase]);
+        recordPhaseTimingLocked(phase, duration,
+                                activeMemory_[phase],
+                                activeOperations_[phase],
+                                activeDetails_[phase]);
 
         activeTimers_.erase(it);
         activeDetails_.erase(phase);
@@ -144,17 +263,23 @@ void TimingProfiler::endPhase(CompilationPhase phase) {
 
 void TimingProfiler::recordPhaseTiming(CompilationPhase phase, std::chrono::microseconds duration,
                                       size_t memoryUsed, size_t operations,
-                                      const std::string& details) {
+                                      const std::string& details, size_t peakMemory) {
     if (!enabled_) return;
 
     std::lock_guard<std::mutex> lock(mutex_);
+    recordPhaseTimingLocked(phase, duration, memoryUsed, operations, details, peakMemory);
+}
 
+void TimingProfiler::recordPhaseTimingLocked(CompilationPhase phase,
+                                             std::chrono::microseconds duration,
+                                             size_t memoryUsed, size_t operations,
+                                             const std::string& details, size_t peakMemory) {
     PhaseTiming timing(phase, getPhaseName(phase));
     timing.duration = duration;
     timing.memoryUsed = memoryUsed;
     timing.operationsCount = operations;
     timing.details = details;
-    timing.peakMemory = memoryUsed; // Simplificado
+    timing.peakMemory = std::max(peakMemory, memoryUsed);
 
     phaseHistory_[phase].push_back(timing);
     phaseStats_[phase].update(timing);
@@ -212,15 +337,13 @@ std::string TimingProfiler::generateJSONReport() const {
     std::stringstream ss;
     ss << "{\n";
     ss << "  \"compilation_report\": {\n";
-    ss << "    \"total_time\": \"" << formatDuration(getTotalCompilationTime()) << "\",\n";
+    ss << "    \"total_time\": \"" << formatDuration(totalCompilationTimeLocked()) << "\",\n";
     ss << "    \"phases\": [\n";
 
-    auto phases = getMeasuredPhases();
-    for (size_t i = 0; i < phases.size(); ++i) {
-        const auto& phase = phases[i];
-        const auto* stats = getPhaseStats(phase);
-
-        if (stats) {
+    size_t i = 0;
+    for (const auto& [phase, phaseStats] : phaseStats_) {
+        const auto* stats = &phaseStats;
+        {
             ss << "      {\n";
             ss << "        \"name\": \"" << getPhaseName(phase) << "\",\n";
             ss << "        \"total_time\": \"" << formatDuration(stats->totalTime) << "\",\n";
@@ -229,10 +352,11 @@ std::string TimingProfiler::generateJSONReport() const {
             ss << "        \"max_time\": \"" << formatDuration(stats->maxTime) << "\",\n";
             ss << "        \"call_count\": " << stats->callCount << ",\n";
             ss << "        \"total_memory\": \"" << formatMemorySize(stats->totalMemory) << "\",\n";
+            ss << "        \"peak_memory\": \"" << formatMemorySize(stats->peakMemory) << "\",\n";
             ss << "        \"total_operations\": " << stats->totalOperations << "\n";
             ss << "      }";
 
-            if (i < phases.size() - 1) {
+            if (++i < phaseStats_.size()) {
                 ss << ",";
             }
             ss << "\n";
@@ -255,16 +379,29 @@ void TimingProfiler::reset() {
     activeMemory_.clear();
     phaseHistory_.clear();
     phaseStats_.clear();
+
+    // Los hilos vuelven a pedir buffer en la siguiente traza
+    threadTraces_.clear();
+    generation_.store(nextTraceGeneration.fetch_add(1), std::memory_order_release);
+    tracing_.store(false, std::memory_order_relaxed);
 }
 
 std::chrono::microseconds TimingProfiler::getTotalCompilationTime() const {
-    const auto* totalStats = getPhaseStats(CompilationPhase::TotalCompilation);
-    return totalStats ? totalStats->totalTime : std::chrono::microseconds(0);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return totalCompilationTimeLocked();
+}
+
+std::chrono::microseconds TimingProfiler::totalCompilationTimeLocked() const {
+    auto it = phaseStats_.find(CompilationPhase::TotalCompilation);
+    return it != phaseStats_.end() ? it->second.totalTime : std::chrono::microseconds(0);
 }
 
 CompilationPhase TimingProfiler::getSlowestPhase() const {
     std::lock_guard<std::mutex> lock(mutex_);
+    return slowestPhaseLocked();
+}
 
+CompilationPhase TimingProfiler::slowestPhaseLocked() const {
     CompilationPhase slowest = CompilationPhase::TotalCompilation;
     std::chrono::microseconds maxTime(0);
 
@@ -280,7 +417,10 @@ CompilationPhase TimingProfiler::getSlowestPhase() const {
 
 CompilationPhase TimingProfiler::getMostMemoryIntensivePhase() const {
     std::lock_guard<std::mutex> lock(mutex_);
+    return mostMemoryIntensivePhaseLocked();
+}
 
+CompilationPhase TimingProfiler::mostMemoryIntensivePhaseLocked() const {
     CompilationPhase mostMemory = CompilationPhase::TotalCompilation;
     size_t maxMemory = 0;
 
@@ -308,22 +448,11 @@ std::string TimingProfiler::formatDuration(std::chrono::microseconds duration) c
 }
 
 std::string TimingProfiler::formatMemorySize(size_t bytes) const {
-    const char* units[] = {"B", "KB", "MB", "GB"};
-    size_t unitIndex = 0;
-    double size = static_cast<double>(bytes);
-
-    while (size >= 1024 && unitIndex < 3) {
-        size /= 1024;
-        unitIndex++;
-    }
-
-    std::stringstream ss;
-    ss << std::fixed << std::setprecision(2) << size << " " << units[unitIndex];
-    return ss.str();
+    return formatBytes(bytes);
 }
 
 double TimingProfiler::calculatePercentage(std::chrono::microseconds duration) const {
-    auto total = getTotalCompilationTime();
+    auto total = totalCompilationTimeLocked();
     if (total.count() == 0) return 0.0;
 
     return (static_cast<double>(duration.count()) / total.count()) * 100.0;
@@ -362,9 +491,9 @@ std::string TimingProfiler::generateSummarySection() const {
 
     ss << "Compilation Summary:\n";
     ss << "==================\n";
-    ss << "Total time: " << formatDuration(getTotalCompilationTime()) << "\n";
-    ss << "Slowest phase: " << getPhaseName(getSlowestPhase()) << "\n";
-    ss << "Most memory-intensive: " << getPhaseName(getMostMemoryIntensivePhase()) << "\n\n";
+    ss << "Total time: " << formatDuration(totalCompilationTimeLocked()) << "\n";
+    ss << "Slowest phase: " << getPhaseName(slowestPhaseLocked()) << "\n";
+    ss << "Most memory-intensive: " << getPhaseName(mostMemoryIntensivePhaseLocked()) << "\n\n";
 
     ss << "Phase Breakdown (sorted by time):\n";
     ss << "---------------------------------\n";
@@ -437,6 +566,10 @@ std::string TimingProfiler::generateStatsSection() const {
             ss << "  Memory: " << formatMemorySize(stats.totalMemory) << "\n";
         }
 
+        if (stats.peakMemory > 0) {
+            ss << "  Peak memory: " << formatMemorySize(stats.peakMemory) << "\n";
+        }
+
         if (stats.totalOperations > 0) {
             ss << "  Operations: " << stats.totalOperations << "\n";
         }
@@ -445,6 +578,274 @@ std::string TimingProfiler::generateStatsSection() const {
     return ss.str();
 }
 
+// ============================================================================
+// TimingProfiler - Traza por hilo
+// ============================================================================
+
+std::atomic<TimingProfiler*> TimingProfiler::active_{nullptr};
+
+uint64_t TimingProfiler::now() {
+#ifdef CPP20_TRACE_USE_TSC
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+void TimingProfiler::enableTrace(size_t eventsPerThread) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    threadTraces_.clear();
+    traceCapacity_ = roundUpToPowerOfTwo(std::max<size_t>(eventsPerThread, 1));
+    traceStartTime_ = std::chrono::steady_clock::now();
+    traceStartTicks_ = now();
+    generation_.store(nextTraceGeneration.fetch_add(1), std::memory_order_release);
+    tracing_.store(true, std::memory_order_relaxed);
+}
+
+TimingProfiler::ThreadTrace& TimingProfiler::currentThreadTrace() {
+    // Caché del hilo: válida mientras no cambie la generación
+    thread_local uint64_t cachedGeneration = 0;
+    thread_local ThreadTrace* cachedTrace = nullptr;
+
+    uint64_t generation = generation_.load(std::memory_order_acquire);
+    if (cachedGeneration == generation && cachedTrace) {
+        return *cachedTrace;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& trace = threadTraces_[std::this_thread::get_id()];
+    if (!trace) {
+        trace = std::make_unique<ThreadTrace>();
+        if (isTracing()) {
+            trace->events.resize(traceCapacity_);
+        }
+        trace->index = static_cast<uint32_t>(threadTraces_.size() - 1);
+    }
+    cachedGeneration = generation_.load(std::memory_order_relaxed);
+    cachedTrace = trace.get();
+    return *trace;
+}
+
+void TimingProfiler::recordTraceEvent(CompilationPhase phase, uint64_t begin, uint64_t end,
+                                      std::string detail) {
+    if (!isTracing()) return;
+
+    ThreadTrace& trace = currentThreadTrace();
+    if (trace.events.empty()) return;
+    uint64_t written = trace.written.load(std::memory_order_relaxed);
+    TraceEvent& event = trace.events[written & (trace.events.size() - 1)];
+    event.begin = begin;
+    event.end = end;
+    event.phase = phase;
+    event.detail = std::move(detail);
+    trace.written.store(written + 1, std::memory_order_release);
+}
+
+size_t TimingProfiler::getTraceThreadCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return threadTraces_.size();
+}
+
+std::vector<TraceEvent> TimingProfiler::getTraceEvents(size_t threadIndex) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::vector<TraceEvent> events;
+    for (const auto& [id, trace] : threadTraces_) {
+        if (trace->index != threadIndex) continue;
+
+        uint64_t written = trace->written.load(std::memory_order_acquire);
+        uint64_t capacity = trace->events.size();
+        for (uint64_t i = written > capacity ? written - capacity : 0; i < written; ++i) {
+            events.push_back(trace->events[i & (capacity - 1)]);
+        }
+    }
+
+    // Inicio ascendente y, a igual inicio, el ámbito de fuera primero
+    std::sort(events.begin(), events.end(), [](const TraceEvent& a, const TraceEvent& b) {
+        return a.begin != b.begin ? a.begin < b.begin : a.end > b.end;
+    });
+    return events;
+}
+
+uint64_t TimingProfiler::getDroppedTraceEvents() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    uint64_t dropped = 0;
+    for (const auto& [id, trace] : threadTraces_) {
+        uint64_t written = trace->written.load(std::memory_order_acquire);
+        if (written > trace->events.size()) {
+            dropped += written - trace->events.size();
+        }
+    }
+    return dropped;
+}
+
+std::string TimingProfiler::generateChromeTrace() const {
+    double ticksPerMicro = ticksPerMicrosecond();
+    uint64_t startTicks;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        startTicks = traceStartTicks_;
+    }
+    auto toMicros = [&](uint64_t ticks) {
+        return ticks > startTicks ? static_cast<double>(ticks - startTicks) / ticksPerMicro : 0.0;
+    };
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << "{\"traceEvents\":[\n";
+
+    bool first = true;
+    size_t threads = getTraceThreadCount();
+    for (size_t thread = 0; thread < threads; ++thread) {
+        if (!first) ss << ",\n";
+        first = false;
+        ss << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << thread
+           << ",\"name\":\"thread_name\",\"args\":{\"name\":\"thread " << thread << "\"}}";
+
+        for (const TraceEvent& event : getTraceEvents(thread)) {
+            double begin = toMicros(event.begin);
+            double duration = std::max(0.0, toMicros(event.end) - begin);
+            ss << ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":" << thread
+               << ",\"ts\":" << begin << ",\"dur\":" << duration
+               << ",\"cat\":\"compiler\",\"name\":\"" << escapeJSON(getPhaseName(event.phase)) << "\"";
+            if (!event.detail.empty()) {
+                ss << ",\"args\":{\"detail\":\"" << escapeJSON(event.detail) << "\"}";
+            }
+            ss << "}";
+        }
+    }
+
+    ss << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":"
+       << getDroppedTraceEvents() << "}}\n";
+    return ss.str();
+}
+
+double TimingProfiler::ticksPerMicrosecond() const {
+#ifdef CPP20_TRACE_USE_TSC
+    // Medido sobre todo el intervalo desde el inicio: el error relativo baja con la duración
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(
+        std::chrono::steady_clock::now() - traceStartTime_).count();
+    if (elapsed > 1.0) {
+        return static_cast<double>(now() - traceStartTicks_) / elapsed;
+    }
+#endif
+    return 1000.0;
+}
+
+void TimingProfiler::recordEntity(CompilationPhase phase, std::string_view name, uint64_t totalTicks,
+                                  uint64_t selfTicks, size_t memory) {
+    EntityTable& table = currentThreadTrace().entities[phase];
+    auto it = table.find(name);
+    if (it == table.end()) {
+        it = table.emplace(std::string(name), EntityTotals()).first;
+    }
+    it->second.count++;
+    it->second.totalTicks += totalTicks;
+    it->second.selfTicks += selfTicks;
+    it->second.memory += memory;
+}
+
+std::vector<EntityStats> TimingProfiler::getTopEntities(CompilationPhase phase, size_t limit) const {
+    double ticksPerMicro = ticksPerMicrosecond();
+    auto toMicros = [&](uint64_t ticks) {
+        return std::chrono::microseconds(static_cast<int64_t>(static_cast<double>(ticks) / ticksPerMicro));
+    };
+
+    // Sumar las tablas de todos los hilos
+    EntityTable merged;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& [id, trace] : threadTraces_) {
+            auto table = trace->entities.find(phase);
+            if (table == trace->entities.end()) continue;
+            for (const auto& [name, totals] : table->second) {
+                EntityTotals& target = merged[name];
+                target.count += totals.count;
+                target.totalTicks += totals.totalTicks;
+                target.selfTicks += totals.selfTicks;
+                target.memory += totals.memory;
+            }
+        }
+    }
+
+    std::vector<EntityStats> entities;
+    entities.reserve(merged.size());
+    for (auto& [name, totals] : merged) {
+        EntityStats stats;
+        stats.phase = phase;
+        stats.name = name;
+        stats.count = totals.count;
+        stats.totalTime = toMicros(totals.totalTicks);
+        stats.selfTime = toMicros(totals.selfTicks);
+        stats.memory = totals.memory;
+        entities.push_back(std::move(stats));
+    }
+
+    auto byTime = [](const EntityStats& a, const EntityStats& b) {
+        return a.totalTime != b.totalTime ? a.totalTime > b.totalTime : a.name < b.name;
+    };
+    if (entities.size() > limit) {
+        std::partial_sort(entities.begin(), entities.begin() + static_cast<std::ptrdiff_t>(limit),
+                          entities.end(), byTime);
+        entities.resize(limit);
+    } else {
+        std::sort(entities.begin(), entities.end(), byTime);
+    }
+    return entities;
+}
+
+std::string TimingProfiler::generateEntityReport(size_t limit) const {
+    std::stringstream ss;
+    ss << "=== Most Expensive Entities ===\n";
+
+    for (int index = 0; index <= static_cast<int>(CompilationPhase::CustomPhase); ++index) {
+        auto phase = static_cast<CompilationPhase>(index);
+        auto entities = getTopEntities(phase, limit);
+        if (entities.empty()) continue;
+
+        ss << "\n" << getPhaseName(phase) << ":\n";
+        ss << std::right << std::setw(12) << "Total" << std::setw(12) << "Self"
+           << std::setw(8) << "Count" << std::setw(12) << "Memory" << "  Name\n";
+        for (const auto& entity : entities) {
+            ss << std::right << std::setw(12) << formatDuration(entity.totalTime)
+               << std::setw(12) << formatDuration(entity.selfTime)
+               << std::setw(8) << entity.count
+               << std::setw(12) << (entity.memory > 0 ? formatMemorySize(entity.memory) : "-")
+               << "  " << entity.name << "\n";
+        }
+    }
+
+    return ss.str();
+}
+
+std::string TimingProfiler::generatePhaseMemoryReport() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::stringstream ss;
+    ss << "=== Memory by Phase ===\n";
+    ss << std::right << std::setw(14) << "Peak" << std::setw(14) << "Retained"
+       << std::setw(8) << "Calls" << "  Phase\n";
+    for (const auto& [phase, stats] : phaseStats_) {
+        if (stats.callCount == 0 || (stats.peakMemory == 0 && stats.totalMemory == 0)) continue;
+
+        ss << std::right << std::setw(14) << formatMemorySize(stats.peakMemory)
+           << std::setw(14) << formatMemorySize(stats.totalMemory)
+           << std::setw(8) << stats.callCount
+           << "  " << getPhaseName(phase) << "\n";
+    }
+    return ss.str();
+}
+
+bool TimingProfiler::writeChromeTrace(const std::filesystem::path& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+    file << generateChromeTrace();
+    return static_cast<bool>(file);
+}
+
 // ============================================================================
 // MemoryProfiler - Implementación
 // ============================================================================
@@ -457,6 +858,17 @@ size_t MemoryProfiler::getCurrentMemoryUsage() {
     if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
         return pmc.WorkingSetSize;
     }
+#elif defined(__linux__)
+    // Segundo campo de statm: páginas residentes
+    if (FILE* statm = std::fopen("/proc/self/statm", "r")) {
+        unsigned long pages = 0;
+        unsigned long resident = 0;
+        int fields = std::fscanf(statm, "%lu %lu", &pages, &resident);
+        std::fclose(statm);
+        if (fields == 2) {
+            return static_cast<size_t>(resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        }
+    }
 #endif
     return 0; // Placeholder para otros sistemas
 }
@@ -467,11 +879,16 @@ size_t MemoryProfiler::getPeakMemoryUsage() {
     if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
         return pmc.PeakWorkingSetSize;
     }
+#elif defined(__linux__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return static_cast<size_t>(usage.ru_maxrss) * 1024; // ru_maxrss va en KB
+    }
 #endif
     return 0; // Placeholder para otros sistemas
 }
 
-void MemoryProfiler::recordMemoryCheckpoint(const std::string& label) {
+void MemoryProfiler::recordMemoryCheckpoint([[maybe_unused]] const std::string& label) {
     lastCheckpoint_ = getCurrentMemoryUsage();
     // En un compilador real, aquí se guardaría el label para debugging
 }
@@ -481,6 +898,34 @@ size_t MemoryProfiler::getMemoryDelta() {
     return current > lastCheckpoint_ ? current - lastCheckpoint_ : 0;
 }
 
+std::string MemoryProfiler::generateSubsystemReport() {
+    using common::utils::MemorySubsystem;
+    using common::utils::MemoryTracker;
+
+    std::stringstream ss;
+    ss << "Memory Report:\n";
+    ss << "==============\n";
+    ss << "Peak RSS: " << formatBytes(getPeakMemoryUsage()) << "\n";
+    ss << "Tracked peak: " << formatBytes(MemoryTracker::totalPeak())
+       << " (current " << formatBytes(MemoryTracker::totalCurrent()) << ")\n\n";
+
+    ss << std::left << std::setw(10) << "Subsystem"
+       << std::right << std::setw(14) << "Peak"
+       << std::setw(14) << "Current"
+       << std::setw(14) << "Allocations" << "\n";
+    for (size_t i = 0; i < MemoryTracker::SubsystemCount; ++i) {
+        auto subsystem = static_cast<MemorySubsystem>(i);
+        auto counters = MemoryTracker::counters(subsystem);
+        if (counters.allocations == 0) continue;
+
+        ss << std::left << std::setw(10) << MemoryTracker::subsystemName(subsystem)
+           << std::right << std::setw(14) << formatBytes(counters.peak)
+           << std::setw(14) << formatBytes(counters.current)
+           << std::setw(14) << counters.allocations << "\n";
+    }
+    return ss.str();
+}
+
 // ============================================================================
 // CompilationTelemetry - Implementación
 // ============================================================================
@@ -599,4 +1044,36 @@ std::string CompilationTelemetry::exportToJSON() const {
     return ss.str();
 }
 
+void CompilationTelemetry::recordPhaseTimes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto phase : profiler_.getMeasuredPhases()) {
+        const PhaseStats* stats = profiler_.getPhaseStats(phase);
+        if (!stats || stats->callCount == 0) continue;
+
+        // Sin espacios en los nombres: "Template Instantiation" -> TemplateInstantiation
+        std::string name = profiler_.getPhaseName(phase);
+        name.erase(std::remove(name.begin(), name.end(), ' '), name.end());
+        metrics_["phase." + name + ".us"].push_back(static_cast<double>(stats->totalTime.count()));
+        if (stats->peakMemory > 0) {
+            metrics_["phase." + name + ".peak_bytes"].push_back(static_cast<double>(stats->peakMemory));
+        }
+    }
+}
+
+TelemetryRecord CompilationTelemetry::toRecord(const std::string& unit,
+                                               const std::string& compilerVersion) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    TelemetryRecord record;
+    record.unit = unit;
+    record.compilerVersion = compilerVersion;
+    for (const auto& [name, values] : metrics_) {
+        record.metrics[name] = std::accumulate(values.begin(), values.end(), 0.0);
+    }
+    if (!errors_.empty()) {
+        record.metrics["errors"] = static_cast<double>(errors_.size());
+    }
+    return record;
+}
+
 } // namespace cpp20::compiler
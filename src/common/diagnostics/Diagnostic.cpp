@@ -17,9 +17,65 @@ Diagnostic::Diagnostic(
     : level_(level), code_(code), location_(location), message_(std::move(message)) {
 }
 
-std::string Diagnostic::formatMessage() const {
-    // TODO: Implement proper message formatting with arguments
-    return message_;
+namespace {
+
+std::string formatArgument(const DiagnosticArgument& argument, const DiagnosticNameResolver& resolver) {
+    switch (argument.type()) {
+        case DiagnosticArgument::Type::String:
+            return argument.asString();
+        case DiagnosticArgument::Type::Integer:
+            return std::to_string(argument.asInteger());
+        case DiagnosticArgument::Type::Unsigned:
+            return std::to_string(argument.asUnsigned());
+        case DiagnosticArgument::Type::Location:
+            return argument.asLocation().toString();
+        case DiagnosticArgument::Type::Range:
+            return argument.asRange().toString();
+        case DiagnosticArgument::Type::Type:
+            if (resolver) return resolver(argument.type(), argument.asTypeId());
+            return "type#" + std::to_string(argument.asTypeId());
+        case DiagnosticArgument::Type::Symbol:
+            if (resolver) return resolver(argument.type(), argument.asDeclId());
+            return "decl#" + std::to_string(argument.asDeclId());
+    }
+    return {};
+}
+
+} // namespace
+
+std::string Diagnostic::formatMessage(const DiagnosticNameResolver& resolver) const {
+    if (arguments_.empty() && message_.find('%') == std::string::npos) {
+        return message_;
+    }
+
+    std::string result;
+    result.reserve(message_.size());
+    for (size_t i = 0; i < message_.size(); ++i) {
+        char c = message_[i];
+        if (c != '%' || i + 1 == message_.size()) {
+            result += c;
+            continue;
+        }
+        if (message_[i + 1] == '%') {
+            result += '%';
+            ++i;
+            continue;
+        }
+        size_t end = i + 1;
+        size_t index = 0;
+        while (end < message_.size() && message_[end] >= '0' && message_[end] <= '9') {
+            index = index * 10 + static_cast<size_t>(message_[end] - '0');
+            ++end;
+        }
+        if (end == i + 1 || index >= arguments_.size()) {
+            // No es un marcador o no tiene argumento: se deja tal cual
+            result.append(message_, i, end - i);
+        } else {
+            result += formatArgument(arguments_[index], resolver);
+        }
+        i = end - 1;
+    }
+    return result;
 }
 
 DiagnosticCategory Diagnostic::category() const {
@@ -4,19 +4,58 @@
  */
 
 #include <compiler/common/diagnostics/DiagnosticEngine.h>
+#include <algorithm>
 #include <iostream>
 #include <format>
+#include <tuple>
 
 namespace cpp20::compiler::diagnostics {
 
+namespace {
+
+std::atomic<uint64_t> nextEngineId{1};
+
+/**
+ * @brief Clave de orden de la salida paralela: ubicación y después contenido
+ */
+auto orderKey(const Diagnostic& diagnostic) {
+    const SourceLocation& location = diagnostic.location();
+    return std::make_tuple(location.fileId(), location.line(), location.column(),
+                           static_cast<int>(diagnostic.level()), static_cast<int>(diagnostic.code()),
+                           std::cref(diagnostic.message()));
+}
+
+} // namespace
+
+/**
+ * @brief Diagnósticos de un hilo pendientes de flush
+ *
+ * Solo lo toman su hilo y flush, que corre cuando la fase ha terminado:
+ * el mutex no tiene contención.
+ */
+struct DiagnosticEngine::ThreadBuffer {
+    std::mutex mutex;
+    std::vector<Diagnostic> pending;
+};
+
 // DiagnosticEngine implementation
 DiagnosticEngine::DiagnosticEngine(std::shared_ptr<SourceManager> sourceManager)
-    : sourceManager_(std::move(sourceManager)) {
+    : sourceManager_(std::move(sourceManager)), id_(nextEngineId.fetch_add(1, std::memory_order_relaxed)) {
     // Add default stream consumer to stderr
     addConsumer(std::make_unique<StreamConsumer>(std::cerr, true));
 }
 
-DiagnosticEngine::~DiagnosticEngine() = default;
+DiagnosticEngine::~DiagnosticEngine() {
+    flush();
+    if (renderThread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(renderMutex_);
+            stopRendering_ = true;
+        }
+        renderReady_.notify_one();
+        renderThread_.join();
+    }
+}
 
 void DiagnosticEngine::addConsumer(std::unique_ptr<Consumer> consumer) {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -28,17 +67,145 @@ void DiagnosticEngine::clearConsumers() {
     consumers_.clear();
 }
 
+bool DiagnosticEngine::trapDiagnostic(DiagnosticLevel level, DiagnosticCode code,
+                                      SourceLocation location) const {
+    DiagnosticTrap* trap = activeTrap_;
+    while (trap && &trap->engine_ != this) {
+        trap = trap->previous_;
+    }
+    if (!trap) {
+        return false;
+    }
+    ++trap->trapped_;
+    if ((level == DiagnosticLevel::Error || level == DiagnosticLevel::Fatal) && trap->errors_++ == 0) {
+        trap->firstErrorCode_ = code;
+        trap->firstErrorLocation_ = location;
+    }
+    return true;
+}
+
 void DiagnosticEngine::emit(const Diagnostic& diagnostic) {
+    if (activeTrap_ && trapDiagnostic(diagnostic.level(), diagnostic.code(), diagnostic.location())) {
+        return;
+    }
+    if (!shouldEmit(diagnostic) || !updateStatistics(diagnostic)) {
+        return;
+    }
+
+    if (options_.parallel) {
+        ThreadBuffer& buffer = threadBuffer();
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        buffer.pending.push_back(diagnostic);
+        return;
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
-    processDiagnostic(diagnostic);
+    diagnostics_.push_back(diagnostic);
+    emitToConsumers(diagnostic);
+}
+
+void DiagnosticEngine::flush() {
+    // Grupos: un diagnóstico y las notas que lo siguieron en su hilo
+    std::vector<std::vector<Diagnostic>> groups;
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex_);
+        for (const auto& buffer : buffers_) {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            bool open = false;
+            for (Diagnostic& diagnostic : buffer->pending) {
+                if (!open || !diagnostic.isNote()) groups.emplace_back();
+                groups.back().push_back(std::move(diagnostic));
+                open = true;
+            }
+            buffer->pending.clear();
+        }
+    }
+    if (groups.empty()) return;
+
+    std::stable_sort(groups.begin(), groups.end(), [](const auto& a, const auto& b) {
+        return orderKey(a.front()) < orderKey(b.front());
+    });
+    std::vector<Diagnostic> batch;
+    for (auto& group : groups) {
+        std::move(group.begin(), group.end(), std::back_inserter(batch));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        diagnostics_.insert(diagnostics_.end(), batch.begin(), batch.end());
+    }
+    {
+        std::lock_guard<std::mutex> lock(renderMutex_);
+        renderQueue_.push_back(std::move(batch));
+        if (!renderThread_.joinable()) {
+            renderThread_ = std::thread(&DiagnosticEngine::renderLoop, this);
+        }
+    }
+    renderReady_.notify_one();
+}
+
+void DiagnosticEngine::waitRendered() {
+    std::unique_lock<std::mutex> lock(renderMutex_);
+    renderIdle_.wait(lock, [this]() { return renderQueue_.empty() && !rendering_; });
+}
+
+DiagnosticEngine::ThreadBuffer& DiagnosticEngine::threadBuffer() {
+    // Los identificadores no se reutilizan: una entrada de un motor ya
+    // destruido no coincide con ninguno vivo
+    thread_local std::vector<std::pair<uint64_t, ThreadBuffer*>> cache;
+    for (const auto& [engine, buffer] : cache) {
+        if (engine == id_) return *buffer;
+    }
+
+    auto buffer = std::make_unique<ThreadBuffer>();
+    ThreadBuffer* result = buffer.get();
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex_);
+        buffers_.push_back(std::move(buffer));
+    }
+    if (cache.size() == 8) cache.erase(cache.begin());
+    cache.emplace_back(id_, result);
+    return *result;
+}
+
+void DiagnosticEngine::renderLoop() {
+    std::unique_lock<std::mutex> lock(renderMutex_);
+    while (true) {
+        renderReady_.wait(lock, [this]() { return stopRendering_ || !renderQueue_.empty(); });
+        if (renderQueue_.empty()) return;
+
+        std::vector<Diagnostic> batch = std::move(renderQueue_.front());
+        renderQueue_.pop_front();
+        rendering_ = true;
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> consumersLock(mutex_);
+            for (const Diagnostic& diagnostic : batch) {
+                emitToConsumers(diagnostic);
+            }
+        }
+        lock.lock();
+        rendering_ = false;
+        if (renderQueue_.empty()) renderIdle_.notify_all();
+    }
 }
 
 void DiagnosticEngine::emit(DiagnosticLevel level, DiagnosticCode code,
                            SourceLocation location, std::string message) {
+    if ((activeTrap_ && trapDiagnostic(level, code, location)) || !isEnabled(level, code, location)) {
+        return;
+    }
     Diagnostic diagnostic(level, code, location, std::move(message));
     emit(diagnostic);
 }
 
+void DiagnosticEngine::markSystemHeader(uint32_t fileId) {
+    if (fileId >= systemFiles_.size()) {
+        systemFiles_.resize(fileId + 1, false);
+    }
+    systemFiles_[fileId] = true;
+}
+
 void DiagnosticEngine::reportError(DiagnosticCode code, SourceLocation loc, std::string msg) {
     emit(DiagnosticLevel::Error, code, loc, std::move(msg));
 }
@@ -56,6 +223,13 @@ void DiagnosticEngine::reportFatal(DiagnosticCode code, SourceLocation loc, std:
 }
 
 void DiagnosticEngine::clearDiagnostics() {
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex_);
+        for (const auto& buffer : buffers_) {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            buffer->pending.clear();
+        }
+    }
     std::lock_guard<std::mutex> lock(mutex_);
     diagnostics_.clear();
     errorCount_ = 0;
@@ -85,7 +259,7 @@ std::string DiagnosticEngine::formatDiagnostic(const Diagnostic& diagnostic) con
     result += "[" + std::to_string(static_cast<int>(diagnostic.code())) + "] ";
 
     // Add message
-    result += diagnostic.message();
+    result += diagnostic.formatMessage(nameResolver_);
 
     // Add location if valid
     if (diagnostic.location().isValid()) {
@@ -106,27 +280,6 @@ std::string DiagnosticEngine::formatSourceLine(SourceLocation location, int cont
     return sourceManager_->getContextLines(location, contextLines, contextLines);
 }
 
-void DiagnosticEngine::processDiagnostic(const Diagnostic& diagnostic) {
-    // Check if we should emit this diagnostic
-    if (!shouldEmit(diagnostic)) {
-        return;
-    }
-
-    // Add to diagnostics list
-    diagnostics_.push_back(diagnostic);
-
-    // Update statistics
-    updateStatistics(diagnostic);
-
-    // Emit to all consumers
-    emitToConsumers(diagnostic);
-
-    // Handle fatal errors
-    if (diagnostic.level() == DiagnosticLevel::Fatal) {
-        // TODO: Implement proper fatal error handling
-    }
-}
-
 void DiagnosticEngine::emitToConsumers(const Diagnostic& diagnostic) {
     for (const auto& consumer : consumers_) {
         if (consumer) {
@@ -135,41 +288,33 @@ void DiagnosticEngine::emitToConsumers(const Diagnostic& diagnostic) {
     }
 }
 
-void DiagnosticEngine::updateStatistics(const Diagnostic& diagnostic) {
+bool DiagnosticEngine::updateStatistics(const Diagnostic& diagnostic) {
     switch (diagnostic.level()) {
         case DiagnosticLevel::Error:
-            ++errorCount_;
+        case DiagnosticLevel::Fatal: {
+            // Reserva el hueco: con varios hilos, el límite no se supera
+            auto limit = static_cast<size_t>(options_.maxErrors);
+            if (errorCount_.fetch_add(1, std::memory_order_relaxed) >= limit) {
+                errorCount_.fetch_sub(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (diagnostic.level() == DiagnosticLevel::Fatal) {
+                fatalCount_.fetch_add(1, std::memory_order_relaxed);
+            }
             break;
+        }
         case DiagnosticLevel::Warning:
-            ++warningCount_;
+            warningCount_.fetch_add(1, std::memory_order_relaxed);
             break;
         case DiagnosticLevel::Note:
-            ++noteCount_;
-            break;
-        case DiagnosticLevel::Fatal:
-            ++fatalCount_;
-            ++errorCount_;
+            noteCount_.fetch_add(1, std::memory_order_relaxed);
             break;
     }
+    return true;
 }
 
 bool DiagnosticEngine::shouldEmit(const Diagnostic& diagnostic) const {
-    // Check warning level
-    if (diagnostic.level() == DiagnosticLevel::Warning && !options_.showWarnings) {
-        return false;
-    }
-
-    // Check note level
-    if (diagnostic.level() == DiagnosticLevel::Note && !options_.showNotes) {
-        return false;
-    }
-
-    // Check error limit
-    if (diagnostic.isError() && errorCount_ >= static_cast<size_t>(options_.maxErrors)) {
-        return false;
-    }
-
-    return true;
+    return isEnabled(diagnostic.level(), diagnostic.code(), diagnostic.location());
 }
 
 // StreamConsumer implementation
@@ -178,9 +323,9 @@ StreamConsumer::StreamConsumer(std::ostream& stream, bool useColors)
 }
 
 bool StreamConsumer::handleDiagnostic(const Diagnostic& diagnostic) {
-    // Format the diagnostic (simple implementation for now)
+    // El mensaje se formatea aquí, en el hilo de render si lo hay
     std::string formatted = "[" + std::to_string(static_cast<int>(diagnostic.code())) + "] " +
-                           diagnostic.message();
+                           diagnostic.formatMessage(nameResolver_);
 
     // Apply colors if enabled
     if (useColors_) {
@@ -198,12 +343,13 @@ bool StreamConsumer::handleDiagnostic(const Diagnostic& diagnostic) {
         }
     }
 
-    stream_ << formatted << std::endl;
+    // Sin std::endl: volcar el stream en cada diagnóstico domina con muchos
+    stream_ << formatted << '\n';
     return true;
 }
 
 void StreamConsumer::finish() {
-    // Nothing to do for stream consumer
+    stream_.flush();
 }
 
 std::string StreamConsumer::formatWithColor(const std::string& text,
@@ -218,6 +364,100 @@ std::string StreamConsumer::formatWithColor(const std::string& text,
     return colorCode + text + "\033[0m";
 }
 
+// SarifConsumer implementation
+SarifConsumer::SarifConsumer(std::ostream& stream, std::shared_ptr<SourceManager> sourceManager,
+                             bool includeSnippets)
+    : stream_(stream), sourceManager_(std::move(sourceManager)), includeSnippets_(includeSnippets) {
+}
+
+SarifConsumer::~SarifConsumer() {
+    finish();
+}
+
+void SarifConsumer::open() {
+    if (open_) {
+        return;
+    }
+    open_ = true;
+    stream_ << "{\"version\":\"2.1.0\","
+            << "\"$schema\":\"https://json.schemastore.org/sarif-2.1.0.json\","
+            << "\"runs\":[{\"tool\":{\"driver\":{\"name\":\"cpp20-compiler\"}},\"results\":[";
+}
+
+bool SarifConsumer::handleDiagnostic(const Diagnostic& diagnostic) {
+    if (closed_) {
+        return false;
+    }
+    open();
+    if (resultCount_++ > 0) {
+        stream_ << ',';
+    }
+
+    const char* level = "error";
+    if (diagnostic.isWarning()) level = "warning";
+    else if (diagnostic.isNote()) level = "note";
+
+    stream_ << "\n{\"ruleId\":\"" << static_cast<int>(diagnostic.code())
+            << "\",\"level\":\"" << level << "\",\"message\":{\"text\":";
+    writeString(diagnostic.formatMessage(nameResolver_));
+    stream_ << '}';
+
+    const SourceLocation& location = diagnostic.location();
+    const SourceFile* file = sourceManager_ && location.isValid()
+                                 ? sourceManager_->getFileForLocation(location) : nullptr;
+    if (file) {
+        stream_ << ",\"locations\":[{\"physicalLocation\":{\"artifactLocation\":{\"uri\":";
+        writeString(file->displayName.empty() ? file->path.generic_string() : file->displayName);
+        stream_ << "},\"region\":{\"startLine\":" << location.line()
+                << ",\"startColumn\":" << location.column();
+        if (includeSnippets_) {
+            stream_ << ",\"snippet\":{\"text\":";
+            writeString(file->lineText(location.line()));
+            stream_ << '}';
+        }
+        stream_ << "}}}]";
+    }
+    stream_ << '}';
+    return true;
+}
+
+void SarifConsumer::finish() {
+    if (closed_) {
+        return;
+    }
+    open();
+    stream_ << "\n]}]}\n";
+    stream_.flush();
+    closed_ = true;
+}
+
+void SarifConsumer::writeString(std::string_view text) {
+    static constexpr char Hex[] = "0123456789abcdef";
+    stream_ << '"';
+    size_t plain = 0;   // Inicio del tramo que no necesita escape
+    for (size_t i = 0; i < text.size(); ++i) {
+        auto c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        stream_.write(text.data() + plain, static_cast<std::streamsize>(i - plain));
+        plain = i + 1;
+        switch (c) {
+            case '"': stream_ << "\\\""; break;
+            case '\\': stream_ << "\\\\"; break;
+            case '\n': stream_ << "\\n"; break;
+            case '\r': stream_ << "\\r"; break;
+            case '\t': stream_ << "\\t"; break;
+            default: {
+                char escaped[] = {'\\', 'u', '0', '0', Hex[c >> 4], Hex[c & 0xF]};
+                stream_.write(escaped, sizeof(escaped));
+            }
+        }
+    }
+    stream_.write(text.data() + plain, static_cast<std::streamsize>(text.size() - plain));
+    stream_ << '"';
+}
+
 // MemoryConsumer implementation
 bool MemoryConsumer::handleDiagnostic(const Diagnostic& diagnostic) {
     diagnostics_.push_back(diagnostic);
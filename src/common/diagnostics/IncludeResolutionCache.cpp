@@ -0,0 +1,199 @@
+/**
+ * @file IncludeResolutionCache.cpp
+ * @brief Caché persistente de resolución de includes validada por mtime de directorio
+ */
+
+#include <compiler/common/diagnostics/IncludeResolutionCache.h>
+#include <compiler/common/utils/MemoryTracker.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+
+namespace cpp20::compiler::diagnostics {
+
+namespace {
+
+// Formato de texto: una entrada por línea, campos separados por tabuladores
+//   E <clave> <ruta resuelta> <número de directorios>
+//   D <mtime> <directorio>
+constexpr const char* kCacheHeader = "cpp20-include-cache 1";
+
+} // namespace
+
+IncludeResolutionCache::IncludeResolutionCache(std::filesystem::path cacheFile)
+    : cacheFile_(std::move(cacheFile)) {}
+
+bool IncludeResolutionCache::load() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    common::utils::MemoryScope memoryScope(common::utils::MemorySubsystem::Caches);
+    if (cacheFile_.empty()) {
+        return false;
+    }
+
+    std::ifstream in(cacheFile_, std::ios::binary);
+    std::string line;
+    if (!in || !std::getline(in, line) || line != kCacheHeader) {
+        return false;
+    }
+
+    std::unordered_map<std::string, Entry> loaded;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string tag, key, resolved;
+        size_t count = 0;
+        if (!std::getline(fields, tag, '\t') || tag != "E" || !std::getline(fields, key, '\t') ||
+            !std::getline(fields, resolved, '\t') || !(fields >> count)) {
+            return false; // Archivo corrupto: se reconstruye desde cero
+        }
+
+        Entry entry;
+        entry.resolvedPath = resolved;
+        entry.directories.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            std::string mtime, directory;
+            if (!std::getline(in, line)) {
+                return false;
+            }
+            std::istringstream dirFields(line);
+            if (!std::getline(dirFields, tag, '\t') || tag != "D" || !std::getline(dirFields, mtime, '\t') ||
+                !std::getline(dirFields, directory)) {
+                return false;
+            }
+            entry.directories.push_back({directory, std::stoll(mtime)});
+        }
+        loaded[key] = std::move(entry);
+    }
+
+    entries_ = std::move(loaded);
+    dirty_ = false;
+    return true;
+}
+
+bool IncludeResolutionCache::save() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (cacheFile_.empty() || !dirty_) {
+        return !cacheFile_.empty();
+    }
+
+    // Otro proceso puede estar leyendo: escribir aparte y renombrar
+    std::filesystem::path temporary = cacheFile_;
+    temporary += ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        out << kCacheHeader << '\n';
+        for (const auto& [key, entry] : entries_) {
+            out << "E\t" << key << '\t' << entry.resolvedPath << '\t' << entry.directories.size() << '\n';
+            for (const auto& directory : entry.directories) {
+                out << "D\t" << directory.mtime << '\t' << directory.path << '\n';
+            }
+        }
+        if (!out) {
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, cacheFile_, error);
+    return !error;
+}
+
+IncludeResolutionCache::Resolution IncludeResolutionCache::lookup(uint64_t searchPathHash,
+                                                                  const std::string& includeName,
+                                                                  bool isAngled) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(makeKey(searchPathHash, includeName, isAngled));
+    if (it == entries_.end()) {
+        ++misses_;
+        return std::nullopt;
+    }
+
+    for (const auto& directory : it->second.directories) {
+        if (directoryTime(directory.path) != directory.mtime) {
+            entries_.erase(it);
+            dirty_ = true;
+            ++misses_;
+            return std::nullopt;
+        }
+    }
+
+    ++hits_;
+    return std::filesystem::path(it->second.resolvedPath);
+}
+
+void IncludeResolutionCache::store(uint64_t searchPathHash, const std::string& includeName, bool isAngled,
+                                   const std::filesystem::path& resolvedPath,
+                                   const std::vector<std::filesystem::path>& probedDirectories) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    common::utils::MemoryScope memoryScope(common::utils::MemorySubsystem::Caches);
+
+    // Tabuladores o saltos de línea romperían el formato: esa resolución no se persiste
+    auto isStorable = [](const std::string& text) {
+        return text.find_first_of("\t\n\r") == std::string::npos;
+    };
+    if (!isStorable(includeName) || !isStorable(resolvedPath.string())) {
+        return;
+    }
+
+    Entry entry;
+    entry.resolvedPath = resolvedPath.string();
+    entry.directories.reserve(probedDirectories.size());
+    for (const auto& directory : probedDirectories) {
+        std::string path = directory.string();
+        if (!isStorable(path)) {
+            return;
+        }
+        entry.directories.push_back({path, directoryTime(path)});
+    }
+
+    entries_[makeKey(searchPathHash, includeName, isAngled)] = std::move(entry);
+    dirty_ = true;
+}
+
+std::vector<std::filesystem::path> IncludeResolutionCache::resolvedPaths(uint64_t searchPathHash) const {
+    std::string prefix = makeKey(searchPathHash, "", true);
+    prefix.pop_back();      // Sin el '<': vale para ambos tipos de include
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::filesystem::path> paths;
+    for (const auto& [key, entry] : entries_) {
+        if (!entry.resolvedPath.empty() && key.size() > prefix.size() && key.compare(0, prefix.size(), prefix) == 0 &&
+            (key[prefix.size()] == '<' || key[prefix.size()] == '"')) {
+            paths.emplace_back(entry.resolvedPath);
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+    return paths;
+}
+
+size_t IncludeResolutionCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+std::string IncludeResolutionCache::makeKey(uint64_t searchPathHash, const std::string& includeName,
+                                            bool isAngled) {
+    std::ostringstream key;
+    key << std::hex << searchPathHash << (isAngled ? '<' : '"') << includeName;
+    return key.str();
+}
+
+int64_t IncludeResolutionCache::directoryTime(const std::string& directory) {
+    auto it = directoryTimes_.find(directory);
+    if (it != directoryTimes_.end()) {
+        return it->second;
+    }
+
+    std::error_code error;
+    auto time = std::filesystem::last_write_time(directory, error);
+    int64_t value = error ? kMissingDirectory
+                          : static_cast<int64_t>(time.time_since_epoch().count());
+    directoryTimes_.emplace(directory, value);
+    return value;
+}
+
+} // namespace cpp20::compiler::diagnostics
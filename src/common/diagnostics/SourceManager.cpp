@@ -4,6 +4,8 @@
  */
 
 #include <compiler/common/diagnostics/SourceManager.h>
+#include <compiler/common/utils/HashUtils.h>
+#include <compiler/common/utils/MemoryTracker.h>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
@@ -19,27 +21,8 @@ namespace cpp20::compiler::diagnostics {
 
 SourceFile::SourceFile(uint32_t id, std::filesystem::path path, std::string rawContent,
                        Encoding encoding)
-    : id(id), path(std::move(path)), rawContent(std::move(rawContent)), encoding(encoding) {
-    // Normalizar finales de línea (implementación inline)
-    std::string result;
-    result.reserve(rawContent.size());
-
-    for (size_t i = 0; i < rawContent.size(); ++i) {
-        if (rawContent[i] == '\r') {
-            // Convertir \r\n a \n, o \r solo a \n
-            if (i + 1 < rawContent.size() && rawContent[i + 1] == '\n') {
-                ++i; // Saltar el \n después de \r
-            }
-            result += '\n';
-        } else {
-            result += rawContent[i];
-        }
-    }
-
-    normalizedContent = std::move(result);
-
-    // Calcular offsets de línea en contenido normalizado
-    lineOffsets = SourceFile::computeLineOffsets(normalizedContent);
+    : id(id), canonicalId(id), path(std::move(path)), rawContent(std::move(rawContent)), encoding(encoding) {
+    normalize(this->rawContent);
 
     // Inicializar display name
     displayName = this->path.filename().string();
@@ -55,69 +38,144 @@ SourceFile::SourceFile(uint32_t id, std::filesystem::path path, std::string rawC
     }
 }
 
-std::vector<uint32_t> SourceFile::computeLineOffsets(const std::string& content) {
+SourceFile::SourceFile(uint32_t id, std::filesystem::path path,
+                       std::shared_ptr<const common::utils::MappedFile> mapping,
+                       Encoding encoding)
+    : id(id), canonicalId(id), path(std::move(path)), mapping(std::move(mapping)), encoding(encoding) {
+    normalize(this->mapping->view());
+
+    displayName = this->path.filename().string();
+    fileSize = this->mapping->size();
+    // lastModified lo establece quien proyecta el archivo
+}
+
+SourceFile::SourceFile(uint32_t id, std::filesystem::path path, const SourceFile& canonical)
+    : id(id), canonicalId(canonical.canonicalId), path(std::move(path)), mapping(canonical.mapping),
+      encoding(canonical.encoding), canonical_(canonical.canonical_ ? canonical.canonical_ : &canonical),
+      text_(canonical.text_) {
+    // Los SourceFile no se destruyen mientras viva el SourceManager: la vista sigue válida
+    displayName = this->path.filename().string();
+    fileSize = canonical.fileSize;
+    lastModified = canonical.lastModified;
+}
+
+void SourceFile::normalize(std::string_view raw) {
+    // Sin \r el contenido ya está normalizado: usar la vista tal cual
+    if (raw.find('\r') == std::string_view::npos) {
+        text_ = raw;
+        return;
+    }
+
+    // Convertir \r\n a \n, o \r solo a \n
+    std::string result;
+    result.reserve(raw.size());
+
+    for (size_t i = 0; i < raw.size(); ++i) {
+        if (raw[i] == '\r') {
+            if (i + 1 < raw.size() && raw[i + 1] == '\n') {
+                ++i; // Saltar el \n después de \r
+            }
+            result += '\n';
+        } else {
+            result += raw[i];
+        }
+    }
+
+    normalizedContent = std::move(result);
+    text_ = normalizedContent;
+}
+
+std::string_view SourceFile::rawText() const {
+    if (canonical_) return canonical_->rawText();
+    return mapping ? mapping->view() : std::string_view(rawContent);
+}
+
+const std::vector<uint32_t>& SourceFile::lineOffsets() const {
+    if (canonical_) return canonical_->lineOffsets();
+
+    // Se calcula con el primer diagnóstico; muchos headers nunca lo necesitan
+    std::call_once(lineOffsetsOnce_, [this]() {
+        lineOffsets_ = computeLineOffsets(text_);
+    });
+    return lineOffsets_;
+}
+
+std::vector<uint32_t> SourceFile::computeLineOffsets(std::string_view content) {
     std::vector<uint32_t> offsets;
     offsets.push_back(0); // Primera línea comienza en offset 0
 
-    for (size_t i = 0; i < content.size(); ++i) {
-        if (content[i] == '\n') {
-            offsets.push_back(static_cast<uint32_t>(i + 1));
-        }
+    size_t pos = 0;
+    while ((pos = content.find('\n', pos)) != std::string_view::npos) {
+        ++pos;
+        offsets.push_back(static_cast<uint32_t>(pos));
     }
 
     return offsets;
 }
 
 SourceLocation SourceFile::locationForOffset(uint32_t offset) const {
-    if (offset >= normalizedContent.size()) {
+    if (offset >= text_.size()) {
         return SourceLocation::invalid();
     }
 
-    // Búsqueda binaria para encontrar la línea que contiene este offset
-    auto it = std::upper_bound(lineOffsets.begin(), lineOffsets.end(), offset);
-    size_t lineIndex = static_cast<size_t>(it - lineOffsets.begin()) - 1;
-
-    uint32_t line = static_cast<uint32_t>(lineIndex + 1);
-    uint32_t column = offset - lineOffsets[lineIndex] + 1;
+    uint32_t line = lineForOffset(offset);
+    uint32_t column = offset - lineOffsets()[line - 1] + 1;
 
     return SourceLocation(line, column, offset, id);
 }
 
+uint32_t SourceFile::lineForOffset(uint32_t offset) const {
+    if (offset >= text_.size()) {
+        return 0;
+    }
+
+    // Búsqueda binaria para encontrar la línea que contiene este offset
+    const auto& offsets = lineOffsets();
+    auto it = std::upper_bound(offsets.begin(), offsets.end(), offset);
+    return static_cast<uint32_t>(it - offsets.begin());
+}
+
 uint32_t SourceFile::offsetForLocation(const SourceLocation& location) const {
-    if (location.line() == 0 || location.line() > lineOffsets.size()) {
+    const auto& offsets = lineOffsets();
+    if (location.line() == 0 || location.line() > offsets.size()) {
         return 0;
     }
 
-    uint32_t lineStart = lineOffsets[location.line() - 1];
+    uint32_t lineStart = offsets[location.line() - 1];
     return lineStart + location.column() - 1;
 }
 
 std::string SourceFile::getLine(uint32_t lineNumber) const {
-    if (lineNumber == 0 || lineNumber > lineOffsets.size()) {
-        return "";
+    return std::string(lineText(lineNumber));
+}
+
+std::string_view SourceFile::lineText(uint32_t lineNumber) const {
+    const auto& offsets = lineOffsets();
+    if (lineNumber == 0 || lineNumber > offsets.size()) {
+        return {};
     }
 
-    uint32_t start = lineOffsets[lineNumber - 1];
-    uint32_t end = (lineNumber < lineOffsets.size()) ?
-                   lineOffsets[lineNumber] : static_cast<uint32_t>(normalizedContent.size());
+    uint32_t start = offsets[lineNumber - 1];
+    uint32_t end = (lineNumber < offsets.size()) ?
+                   offsets[lineNumber] : static_cast<uint32_t>(text_.size());
 
     // Remover caracteres de nueva línea al final
-    while (end > start && (normalizedContent[end - 1] == '\n' || normalizedContent[end - 1] == '\r')) {
+    while (end > start && (text_[end - 1] == '\n' || text_[end - 1] == '\r')) {
         --end;
     }
 
-    return normalizedContent.substr(start, end - start);
+    return text_.substr(start, end - start);
 }
 
 std::string SourceFile::getText(SourceRange range) const {
     uint32_t startOffset = offsetForLocation(range.start());
     uint32_t endOffset = offsetForLocation(range.end());
 
-    if (startOffset >= endOffset || endOffset > normalizedContent.size()) {
+    if (startOffset >= endOffset || endOffset > text_.size()) {
         return "";
     }
 
-    return normalizedContent.substr(startOffset, endOffset - startOffset);
+    return std::string(text_.substr(startOffset, endOffset - startOffset));
 }
 
 void SourceFile::addMacroExpansion(uint32_t offset, const std::string& expansion) {
@@ -144,71 +202,144 @@ SourceLocation SourceFile::mapToOriginalLocation(uint32_t offset) const {
 
 void IncludeSearchPath::addSystemPath(const std::filesystem::path& path) {
     systemPaths_.push_back(path);
+    updatePathsHash();
 }
 
 void IncludeSearchPath::addUserPath(const std::filesystem::path& path) {
     userPaths_.push_back(path);
+    updatePathsHash();
 }
 
 void IncludeSearchPath::clearPaths() {
     systemPaths_.clear();
     userPaths_.clear();
+    updatePathsHash();
+}
+
+std::vector<std::filesystem::path> IncludeSearchPath::previousResolutions() const {
+    return cache_ ? cache_->resolvedPaths(pathsHash_) : std::vector<std::filesystem::path>();
+}
+
+void IncludeSearchPath::updatePathsHash() {
+    std::string key;
+    for (const auto& path : userPaths_) {
+        key += "u:" + path.string() + '\n';
+    }
+    for (const auto& path : systemPaths_) {
+        key += "s:" + path.string() + '\n';
+    }
+    pathsHash_ = common::utils::fnv1a64(key);
 }
 
 std::optional<std::filesystem::path> IncludeSearchPath::findInclude(
     const std::string& includeName,
     bool isSystemInclude) const {
 
-    const auto& searchPaths = isSystemInclude ? systemPaths_ : userPaths_;
-
-    for (const auto& basePath : searchPaths) {
-        std::filesystem::path fullPath = basePath / includeName;
-        if (std::filesystem::exists(fullPath) && std::filesystem::is_regular_file(fullPath)) {
-            return fullPath;
+    if (cache_) {
+        if (auto cached = cache_->lookup(pathsHash_, includeName, isSystemInclude)) {
+            if (cached->empty()) {
+                return std::nullopt;
+            }
+            return *cached;
         }
     }
 
-    // Si es include de usuario y no se encontró, intentar en rutas de sistema como fallback
-    if (!isSystemInclude) {
-        for (const auto& basePath : systemPaths_) {
+    // Un stat por candidato; los directorios sondeados validan la entrada de caché
+    std::vector<std::filesystem::path> probedDirectories;
+    std::optional<std::filesystem::path> found;
+    auto probe = [&](const std::vector<std::filesystem::path>& searchPaths) {
+        for (const auto& basePath : searchPaths) {
             std::filesystem::path fullPath = basePath / includeName;
-            if (std::filesystem::exists(fullPath) && std::filesystem::is_regular_file(fullPath)) {
-                return fullPath;
+            probedDirectories.push_back(fullPath.parent_path());
+            std::error_code error;
+            if (std::filesystem::is_regular_file(fullPath, error)) {
+                found = std::move(fullPath);
+                return true;
             }
         }
+        return false;
+    };
+
+    // Si es include de usuario y no se encontró, intentar en rutas de sistema como fallback
+    if (!probe(isSystemInclude ? systemPaths_ : userPaths_) && !isSystemInclude) {
+        probe(systemPaths_);
     }
 
-    return std::nullopt;
+    if (cache_) {
+        cache_->store(pathsHash_, includeName, isSystemInclude,
+                      found.value_or(std::filesystem::path()), probedDirectories);
+    }
+    return found;
 }
 
 // === SourceManager Implementation ===
 
 SourceManager::SourceManager() = default;
-SourceManager::~SourceManager() = default;
+
+SourceManager::~SourceManager() {
+    // Los trabajos pendientes terminan sin leer; el que esté leyendo acaba antes de destruir nada
+    prefetchCancelled_ = true;
+    prefetchPool_.reset();
+}
 
 // === CARGA DE ARCHIVOS ===
 
 uint32_t SourceManager::loadFile(const std::filesystem::path& path,
                                 const std::string& displayName,
                                 bool isHeaderUnit) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    common::utils::MemoryScope memoryScope(common::utils::MemorySubsystem::Sources);
+
     // Verificar si ya está cargado
     auto it = pathToId_.find(path);
     if (it != pathToId_.end()) {
         return it->second;
     }
 
-    // Cargar contenido del archivo con detección de encoding
+    // Otra ruta al mismo archivo (enlace, "..", mayúsculas en Windows): alias
+    common::utils::FileStamp stamp;
+    bool hasStamp = common::utils::statFile(path.string(), stamp);
+    FileIdentity identity{stamp.device, stamp.fileId};
+    if (hasStamp) {
+        auto known = canonicalByIdentity_.find(identity);
+        if (known != canonicalByIdentity_.end() && known->second.stamp == stamp) {
+            std::lock_guard<std::mutex> prefetchLock(prefetchMutex_);
+            prefetched_.erase(path);    // El contenido ya está cargado por otra ruta
+            return addAlias(path, *files_[known->second.id - 1], displayName, isHeaderUnit);
+        }
+    }
+
+    // Cargar contenido del archivo con detección de encoding; si el hilo de
+    // E/S ya lo leyó, solo se toma
     std::string rawContent;
+    std::shared_ptr<const common::utils::MappedFile> mapping;
     Encoding encoding;
     std::filesystem::file_time_type lastModified;
 
-    if (!loadFileContent(path, rawContent, encoding, lastModified)) {
+    if (!takePrefetched(path, rawContent, mapping, encoding, lastModified, isHeaderUnit) &&
+        !loadFileContent(path, rawContent, mapping, encoding, lastModified)) {
         return 0; // ID de archivo inválido
     }
 
+    // Una copia idéntica en otra ruta: se descarta lo leído y se comparte el canónico
+    std::string contentHash;
+    if (deduplicateByContent_) {
+        std::string_view raw = mapping ? mapping->view() : std::string_view(rawContent);
+        contentHash = common::utils::hash128(raw).toHex();
+        auto same = canonicalByContent_.find(contentHash);
+        if (same != canonicalByContent_.end()) {
+            const SourceFile& canonical = *files_[same->second - 1];
+            if (canonical.encoding == encoding && canonical.rawText() == raw) {
+                return addAlias(path, canonical, displayName, isHeaderUnit);
+            }
+        }
+    }
+
     // Crear archivo fuente
     uint32_t fileId = assignFileId();
-    auto sourceFile = std::make_unique<SourceFile>(fileId, path, std::move(rawContent), encoding);
+    auto sourceFile = mapping
+        ? std::make_unique<SourceFile>(fileId, path, std::move(mapping), encoding)
+        : std::make_unique<SourceFile>(fileId, path, std::move(rawContent), encoding);
     sourceFile->lastModified = lastModified;
     sourceFile->isHeaderUnit = isHeaderUnit;
 
@@ -216,14 +347,35 @@ uint32_t SourceManager::loadFile(const std::filesystem::path& path,
         sourceFile->displayName = displayName;
     }
 
-    files_.push_back(std::move(sourceFile));
+    addFile(std::move(sourceFile));
     pathToId_[path] = fileId;
+    if (hasStamp) {
+        canonicalByIdentity_[identity] = {fileId, stamp};
+    }
+    if (!contentHash.empty()) {
+        canonicalByContent_.emplace(std::move(contentHash), fileId);
+    }
 
     return fileId;
 }
 
+uint32_t SourceManager::addAlias(const std::filesystem::path& path, const SourceFile& canonical,
+                                 const std::string& displayName, bool isHeaderUnit) {
+    uint32_t fileId = assignFileId();
+    auto alias = std::make_unique<SourceFile>(fileId, path, canonical);
+    alias->isHeaderUnit = isHeaderUnit;
+    if (!displayName.empty()) {
+        alias->displayName = displayName;
+    }
+    addFile(std::move(alias));
+    pathToId_[path] = fileId;
+    ++aliasCount_;
+    return fileId;
+}
+
 uint32_t SourceManager::createVirtualFile(std::string content,
                                          const std::string& displayName) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     uint32_t fileId = assignFileId();
     auto sourceFile = std::make_unique<SourceFile>(
         fileId,
@@ -234,14 +386,105 @@ uint32_t SourceManager::createVirtualFile(std::string content,
     sourceFile->displayName = displayName;
     sourceFile->isPreprocessed = true;
 
-    files_.push_back(std::move(sourceFile));
+    addFile(std::move(sourceFile));
     return fileId;
 }
 
 void SourceManager::preloadHeaders(const std::vector<std::filesystem::path>& paths) {
+    prefetchFiles(paths, true);
+}
+
+void SourceManager::prefetchFiles(const std::vector<std::filesystem::path>& paths, bool headerUnits) {
+    if (paths.empty()) {
+        return;
+    }
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (!prefetchPool_) {
+        prefetchPool_ = std::make_unique<common::utils::ThreadPool>(1);
+    }
+
+    std::lock_guard<std::mutex> prefetchLock(prefetchMutex_);
     for (const auto& path : paths) {
-        loadFile(path, "", true);
+        if (pathToId_.count(path) > 0) {
+            continue;
+        }
+        auto [entry, inserted] = prefetched_.try_emplace(path);
+        entry->second.headerUnit = entry->second.headerUnit || headerUnits;
+        if (inserted) {
+            prefetchPool_->submit([this, path]() { prefetchOne(path); });
+        }
+    }
+}
+
+size_t SourceManager::prefetchPreviousIncludes() {
+    std::vector<std::filesystem::path> paths = includeSearchPath_.previousResolutions();
+    prefetchFiles(paths);
+    return paths.size();
+}
+
+void SourceManager::waitForPrefetch() {
+    if (prefetchPool_) {
+        prefetchPool_->wait();
+    }
+}
+
+void SourceManager::prefetchOne(const std::filesystem::path& path) {
+    PrefetchedContent result;
+    if (!prefetchCancelled_) {
+        result.loaded = loadFileContent(path, result.content, result.mapping, result.encoding,
+                                        result.lastModified);
+    }
+    if (result.mapping) {
+        // Las páginas se traen aquí, no al normalizar en el hilo del preprocesador
+        result.mapping->prefetch();
+        std::string_view view = result.mapping->view();
+        volatile char sink = 0;
+        for (size_t offset = 0; offset < view.size() && !prefetchCancelled_; offset += 4096) {
+            sink = sink + view[offset];
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(prefetchMutex_);
+    auto it = prefetched_.find(path);
+    if (it == prefetched_.end()) {
+        return;     // clearCache lo descartó
+    }
+    result.headerUnit = it->second.headerUnit;
+    result.ready = true;
+    it->second = std::move(result);
+    prefetchReady_.notify_all();
+}
+
+bool SourceManager::takePrefetched(const std::filesystem::path& path, std::string& content,
+                                   std::shared_ptr<const common::utils::MappedFile>& mapping,
+                                   Encoding& encoding, std::filesystem::file_time_type& lastModified,
+                                   bool& headerUnit) {
+    std::unique_lock<std::mutex> lock(prefetchMutex_);
+    auto it = prefetched_.find(path);
+    if (it == prefetched_.end()) {
+        return false;
+    }
+    // Ya en camino: esperar es más barato que leerlo otra vez
+    prefetchReady_.wait(lock, [&]() {
+        it = prefetched_.find(path);
+        return it == prefetched_.end() || it->second.ready;
+    });
+    if (it == prefetched_.end()) {
+        return false;
     }
+
+    PrefetchedContent entry = std::move(it->second);
+    prefetched_.erase(it);
+    if (!entry.loaded) {
+        return false;
+    }
+    content = std::move(entry.content);
+    mapping = std::move(entry.mapping);
+    encoding = entry.encoding;
+    lastModified = entry.lastModified;
+    headerUnit = headerUnit || entry.headerUnit;
+    prefetchHits_.fetch_add(1, std::memory_order_relaxed);
+    return true;
 }
 
 // === GESTIÓN DE INCLUDES ===
@@ -249,6 +492,8 @@ void SourceManager::preloadHeaders(const std::vector<std::filesystem::path>& pat
 uint32_t SourceManager::findAndLoadInclude(const std::string& includeName,
                                           [[maybe_unused]] uint32_t currentFileId,
                                           bool isSystemInclude) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+
     // Verificar caché primero
     auto cacheIt = includeCache_.find(includeName);
     if (cacheIt != includeCache_.end()) {
@@ -276,10 +521,41 @@ uint32_t SourceManager::findAndLoadInclude(const std::string& includeName,
     return fileId;
 }
 
+std::optional<IncludeCacheEntry> SourceManager::getIncludeCacheEntry(const std::string& includeName) const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    auto it = includeCache_.find(includeName);
+    if (it == includeCache_.end() || !it->second.isValid) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void SourceManager::recordMultipleIncludeInfo(uint32_t fileId, const std::string& includeGuard,
+                                              bool pragmaOnce) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    uint32_t canonicalId = getCanonicalFileId(fileId);
+    for (auto& [name, entry] : includeCache_) {
+        if (getCanonicalFileId(entry.fileId) == canonicalId) {
+            entry.includeGuard = includeGuard;
+            entry.pragmaOnce = pragmaOnce;
+        }
+    }
+}
+
 void SourceManager::setIncludeSearchPath(const IncludeSearchPath& searchPath) {
     includeSearchPath_ = searchPath;
 }
 
+uint64_t SourceManager::includePathsHash() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return includeSearchPath_.pathsHash();
+}
+
+void SourceManager::setIncludeResolutionCache(std::shared_ptr<IncludeResolutionCache> cache) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    includeSearchPath_.setResolutionCache(std::move(cache));
+}
+
 void SourceManager::addIncludePath(const std::filesystem::path& path, bool isSystemPath) {
     if (isSystemPath) {
         includeSearchPath_.addSystemPath(path);
@@ -291,6 +567,7 @@ void SourceManager::addIncludePath(const std::filesystem::path& path, bool isSys
 // === ACCESO A ARCHIVOS ===
 
 const SourceFile* SourceManager::getFile(uint32_t fileId) const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     if (fileId == 0 || fileId > files_.size()) {
         return nullptr;
     }
@@ -347,6 +624,14 @@ std::string SourceManager::getLine(const SourceLocation& location) const {
     return file->getLine(location.line());
 }
 
+std::string_view SourceManager::getLineText(const SourceLocation& location) const {
+    const SourceFile* file = getFileForLocation(location);
+    if (!file) {
+        return {};
+    }
+    return file->lineText(location.line());
+}
+
 std::string SourceManager::getContextLines(const SourceLocation& location,
                                           int beforeLines,
                                           int afterLines) const {
@@ -358,16 +643,22 @@ std::string SourceManager::getContextLines(const SourceLocation& location,
     uint32_t startLine = std::max(1u, location.line() - static_cast<uint32_t>(beforeLines));
     uint32_t endLine = std::min(file->lineCount(), location.line() + static_cast<uint32_t>(afterLines));
 
-    std::stringstream result;
+    // Directo sobre las vistas de línea: sin copiar cada línea ni pasar por stringstream
+    std::string result;
     for (uint32_t line = startLine; line <= endLine; ++line) {
-        std::string lineText = file->getLine(line);
-        result << std::setw(6) << line << " | " << lineText;
+        std::string number = std::to_string(line);
+        if (number.size() < 6) {
+            result.append(6 - number.size(), ' ');
+        }
+        result += number;
+        result += " | ";
+        result += file->lineText(line);
         if (line < endLine) {
-            result << "\n";
+            result += '\n';
         }
     }
 
-    return result.str();
+    return result;
 }
 
 // === SOPORTE PARA PREPROCESADOR ===
@@ -389,6 +680,120 @@ void SourceManager::registerLineMapping(const SourceLocation& currentLocation,
     }
 }
 
+// === UBICACIONES COMPACTAS ===
+
+void SourceManager::addFile(std::unique_ptr<SourceFile> file) {
+    // Un hueco de un byte tras cada archivo: la ubicación de fin de archivo es suya
+    uint64_t end = uint64_t{nextFileBase_} + file->text().size() + 1;
+    if (end <= CompactSourceLocation::MacroBit) {
+        file->baseOffset = nextFileBase_;
+        nextFileBase_ = static_cast<uint32_t>(end);
+    } else {
+        // Espacio agotado: este y los siguientes solo tienen SourceLocation
+        nextFileBase_ = CompactSourceLocation::MacroBit;
+    }
+    files_.push_back(std::move(file));
+}
+
+const SourceFile* SourceManager::fileForCompactOffset(uint32_t raw) const {
+    // Las bases crecen con el fileId; los archivos sin base solo pueden ir al final
+    auto it = std::partition_point(files_.begin(), files_.end(), [raw](const auto& file) {
+        return file->baseOffset != 0 && file->baseOffset <= raw;
+    });
+    if (it == files_.begin()) {
+        return nullptr;
+    }
+    const SourceFile* file = std::prev(it)->get();
+    return raw - file->baseOffset <= file->text().size() ? file : nullptr;
+}
+
+const SourceManager::ExpansionRecord* SourceManager::findExpansion(CompactSourceLocation location) const {
+    auto it = std::upper_bound(expansions_.begin(), expansions_.end(), location.raw(),
+                               [](uint32_t raw, const ExpansionRecord& record) { return raw < record.base; });
+    if (it == expansions_.begin()) {
+        return nullptr;
+    }
+    const ExpansionRecord& record = *std::prev(it);
+    return location.raw() - record.base < record.length ? &record : nullptr;
+}
+
+CompactSourceLocation SourceManager::getCompactLocation(uint32_t fileId, uint32_t offset) const {
+    const SourceFile* file = getFile(fileId);
+    if (!file || file->baseOffset == 0 || offset > file->text().size()) {
+        return {};
+    }
+    return CompactSourceLocation::fromRaw(file->baseOffset + offset);
+}
+
+CompactSourceLocation SourceManager::getCompactLocation(const SourceLocation& location) const {
+    const SourceFile* file = getFileForLocation(location);
+    if (!file || !location.isValid()) {
+        return {};
+    }
+    return getCompactLocation(location.fileId(), file->offsetForLocation(location));
+}
+
+SourceLocation SourceManager::getSourceLocation(CompactSourceLocation location) const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    CompactSourceLocation fileLocation = getExpansionLocation(location);
+    if (!fileLocation.isFileLocation()) {
+        return SourceLocation::invalid();
+    }
+    const SourceFile* file = fileForCompactOffset(fileLocation.raw());
+    if (!file) {
+        return SourceLocation::invalid();
+    }
+    return file->locationForOffset(fileLocation.raw() - file->baseOffset);
+}
+
+uint32_t SourceManager::getFileId(CompactSourceLocation location) const {
+    if (!location.isFileLocation()) {
+        return 0;
+    }
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    const SourceFile* file = fileForCompactOffset(location.raw());
+    return file ? file->id : 0;
+}
+
+CompactSourceLocation SourceManager::createExpansionLocation(CompactSourceLocation spelling,
+                                                             CompactSourceLocation expansion,
+                                                             uint32_t length) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    length = std::max<uint32_t>(length, 1);
+    uint32_t base = expansions_.empty()
+        ? CompactSourceLocation::MacroBit
+        : expansions_.back().base + expansions_.back().length;
+    if (base < CompactSourceLocation::MacroBit || uint64_t{base} + length > UINT32_MAX) {
+        return {};
+    }
+    expansions_.push_back({base, length, spelling, expansion});
+    return CompactSourceLocation::fromRaw(base);
+}
+
+CompactSourceLocation SourceManager::getSpellingLocation(CompactSourceLocation location) const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    while (location.isMacroLocation()) {
+        const ExpansionRecord* record = findExpansion(location);
+        if (!record) {
+            return {};
+        }
+        location = record->spelling + (location.raw() - record->base);
+    }
+    return location;
+}
+
+CompactSourceLocation SourceManager::getExpansionLocation(CompactSourceLocation location) const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    while (location.isMacroLocation()) {
+        const ExpansionRecord* record = findExpansion(location);
+        if (!record) {
+            return {};
+        }
+        location = record->expansion;
+    }
+    return location;
+}
+
 // === GESTIÓN DE HEADER UNITS ===
 
 void SourceManager::markAsHeaderUnit(uint32_t fileId, const std::string& /*moduleName*/) {
@@ -403,33 +808,116 @@ bool SourceManager::isHeaderUnit(uint32_t fileId) const {
     return file ? file->isHeaderUnit : false;
 }
 
+uint32_t SourceManager::getCanonicalFileId(uint32_t fileId) const {
+    const SourceFile* file = getFile(fileId);
+    return file ? file->canonicalId : fileId;
+}
+
 // === ESTADÍSTICAS Y GESTIÓN ===
 
 size_t SourceManager::totalSize() const {
     size_t total = 0;
     for (const auto& file : files_) {
-        total += file->fileSize;
+        if (!file->isAlias()) {     // Un alias no tiene contenido propio
+            total += file->fileSize;
+        }
     }
     return total;
 }
 
 void SourceManager::clearCache() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     files_.clear();
     pathToId_.clear();
     includeCache_.clear();
+    canonicalByIdentity_.clear();
+    canonicalByContent_.clear();
+    aliasCount_ = 0;
+    {
+        // Una lectura en curso encuentra su entrada borrada y descarta el resultado
+        std::lock_guard<std::mutex> prefetchLock(prefetchMutex_);
+        prefetched_.clear();
+        prefetchReady_.notify_all();
+    }
     nextFileId_ = 1;
+    nextFileBase_ = 1;
+    expansions_.clear();
     cacheHits_ = 0;
     cacheMisses_ = 0;
 }
 
 void SourceManager::clearIncludeCache() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     includeCache_.clear();
 }
 
 void SourceManager::preloadFiles(const std::vector<std::filesystem::path>& paths) {
-    for (const auto& path : paths) {
-        loadFile(path);
+    prefetchFiles(paths);
+}
+
+bool SourceManager::invalidateFile(const std::filesystem::path& path) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+
+    // Las claves de pathToId_ son las rutas tal como se pidieron: si no
+    // coincide literalmente, comparar las formas absolutas
+    uint32_t fileId = 0;
+    auto exact = pathToId_.find(path);
+    if (exact != pathToId_.end()) {
+        fileId = exact->second;
+        pathToId_.erase(exact);
+    } else {
+        std::error_code ec;
+        auto target = std::filesystem::absolute(path, ec).lexically_normal();
+        for (auto it = pathToId_.begin(); it != pathToId_.end(); ++it) {
+            if (std::filesystem::absolute(it->first, ec).lexically_normal() == target) {
+                fileId = it->second;
+                pathToId_.erase(it);
+                break;
+            }
+        }
     }
+    if (fileId == 0) {
+        return false;
+    }
+
+    // La siguiente carga por cualquier ruta vuelve a leer el archivo
+    uint32_t canonicalId = getCanonicalFileId(fileId);
+    std::erase_if(canonicalByIdentity_, [&](const auto& entry) { return entry.second.id == canonicalId; });
+    std::erase_if(canonicalByContent_, [&](const auto& entry) { return entry.second == canonicalId; });
+
+    for (auto it = includeCache_.begin(); it != includeCache_.end();) {
+        it = it->second.fileId == fileId ? includeCache_.erase(it) : std::next(it);
+    }
+    return true;
+}
+
+size_t SourceManager::invalidateChangedFiles() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+
+    std::vector<std::filesystem::path> changed;
+    for (const auto& [path, fileId] : pathToId_) {
+        const SourceFile* file = files_[fileId - 1].get();
+        std::error_code ec;
+        auto modified = std::filesystem::last_write_time(path, ec);
+        if (ec || modified != file->lastModified) {
+            changed.push_back(path);
+        }
+    }
+
+    for (const auto& path : changed) {
+        invalidateFile(path);
+    }
+    return changed.size();
+}
+
+std::vector<std::filesystem::path> SourceManager::loadedFilePaths() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::vector<std::filesystem::path> paths;
+    paths.reserve(pathToId_.size());
+    for (const auto& entry : pathToId_) {
+        paths.push_back(entry.first);
+    }
+    return paths;
 }
 
 // === UTILIDADES ===
@@ -499,6 +987,10 @@ std::string SourceManager::normalizeLineEndings(const std::string& content) cons
 
 // === MÉTODOS INTERNOS ===
 
+size_t SourceManager::FileIdentityHash::operator()(const FileIdentity& identity) const {
+    return static_cast<size_t>(common::utils::hashMix(identity.device, identity.fileId));
+}
+
 uint32_t SourceManager::assignFileId() {
     return nextFileId_++;
 }
@@ -506,30 +998,51 @@ uint32_t SourceManager::assignFileId() {
 
 bool SourceManager::loadFileContent(const std::filesystem::path& path,
                                    std::string& content,
+                                   std::shared_ptr<const common::utils::MappedFile>& mapping,
                                    Encoding& encoding,
                                    std::filesystem::file_time_type& lastModified) const {
     try {
-        // Leer archivo en modo binario
-        std::ifstream file(path, std::ios::binary | std::ios::ate);
-        if (!file) {
+        std::error_code ec;
+        auto size = std::filesystem::file_size(path, ec);
+        if (ec) {
             return false;
         }
 
-        std::streamsize size = file.tellg();
-        file.seekg(0, std::ios::beg);
-
-        content.resize(static_cast<size_t>(size));
-        if (!file.read(content.data(), size)) {
-            return false;
+        // Archivos grandes: proyección de solo lectura, sin copia
+        if (useMemoryMapping_ && size >= kMemoryMapThreshold) {
+            mapping = common::utils::MappedFile::open(path);
         }
 
-        // Detectar encoding
-        encoding = detectEncoding(content);
+        if (mapping) {
+            std::string_view view = mapping->view();
+            encoding = detectEncoding(std::string(view.substr(0, 4)));
+
+            // Las codificaciones que requieren transcodificar no pueden ser vistas
+            if (encoding != Encoding::UTF8 && encoding != Encoding::ASCII) {
+                content = decodeContent(std::string(view), encoding);
+                encoding = Encoding::UTF8;
+                mapping.reset();
+            }
+        } else {
+            // Leer archivo en modo binario
+            std::ifstream file(path, std::ios::binary);
+            if (!file) {
+                return false;
+            }
+
+            content.resize(static_cast<size_t>(size));
+            if (!file.read(content.data(), static_cast<std::streamsize>(size))) {
+                return false;
+            }
 
-        // Decodificar si es necesario
-        if (encoding != Encoding::UTF8 && encoding != Encoding::ASCII) {
-            content = decodeContent(content, encoding);
-            encoding = Encoding::UTF8; // Después de decodificar es UTF-8
+            // Detectar encoding
+            encoding = detectEncoding(content);
+
+            // Decodificar si es necesario
+            if (encoding != Encoding::UTF8 && encoding != Encoding::ASCII) {
+                content = decodeContent(content, encoding);
+                encoding = Encoding::UTF8; // Después de decodificar es UTF-8
+            }
         }
 
         // Obtener timestamp de modificación
@@ -583,13 +1096,8 @@ std::string SourceManager::decodeContent(const std::string& rawContent, Encoding
     }
 }
 
-std::string SourceManager::computeContentHash(const std::string& content) const {
-    // Implementación simple de hash - en producción usaríamos un hash criptográfico
-    size_t hash = 0;
-    for (char c : content) {
-        hash = hash * 31 + static_cast<size_t>(static_cast<unsigned char>(c));
-    }
-    return std::to_string(hash);
+std::string SourceManager::computeContentHash(std::string_view content) const {
+    return common::utils::hash128(content).toHex();
 }
 
 bool SourceManager::isCacheValid(const std::filesystem::path& path, const IncludeCacheEntry& entry) const {
@@ -613,12 +1121,22 @@ void SourceManager::updateIncludeCache(const std::string& includeName,
         entry.lastModified = std::filesystem::last_write_time(resolvedPath);
         const SourceFile* file = getFile(fileId);
         if (file) {
-            entry.contentHash = computeContentHash(file->normalizedContent);
+            entry.contentHash = computeContentHash(file->text());
         }
     } catch (...) {
         entry.isValid = false;
     }
 
+    // Otro nombre que resuelve al mismo archivo, o a un alias suyo, ya pudo detectar su guarda
+    uint32_t canonicalId = getCanonicalFileId(fileId);
+    for (const auto& [name, existing] : includeCache_) {
+        if (getCanonicalFileId(existing.fileId) == canonicalId && existing.isValid && name != includeName) {
+            entry.includeGuard = existing.includeGuard;
+            entry.pragmaOnce = existing.pragmaOnce;
+            break;
+        }
+    }
+
     includeCache_[includeName] = entry;
 }
 
@@ -0,0 +1,116 @@
+/**
+ * @file AllocationHooks.cpp
+ * @brief operator new/delete globales contabilizados en MemoryTracker
+ *
+ * Solo se compila en el ejecutable con CPP20_COMPILER_TRACK_ALLOCATIONS:
+ * sustituir los operadores globales afecta a todo el proceso. Cada bloque
+ * lleva delante una cabecera con su tamaño y el subsistema al que se
+ * atribuyó, para que la liberación descuente lo mismo aunque ocurra en
+ * otro hilo o con otro ámbito. Las variantes con alineación explícita no
+ * se sustituyen y no se contabilizan.
+ */
+
+#include <compiler/common/utils/MemoryTracker.h>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+using cpp20::compiler::common::utils::MemorySubsystem;
+using cpp20::compiler::common::utils::MemoryTracker;
+
+struct alignas(16) AllocationHeader {
+    size_t size;
+    MemorySubsystem subsystem;
+    bool counted;               // Registrada con el seguimiento activo
+};
+
+static_assert(sizeof(AllocationHeader) == 16);
+static_assert(alignof(AllocationHeader) >= alignof(std::max_align_t));
+
+void* trackedAllocate(size_t size) noexcept {
+    auto* header = static_cast<AllocationHeader*>(std::malloc(sizeof(AllocationHeader) + size));
+    if (!header) return nullptr;
+
+    header->size = size;
+    header->subsystem = MemoryTracker::current();
+    header->counted = MemoryTracker::isEnabled();
+    if (header->counted) {
+        MemoryTracker::recordAllocation(header->subsystem, size);
+    }
+    return header + 1;
+}
+
+void trackedRelease(void* ptr) noexcept {
+    if (!ptr) return;
+
+    auto* header = static_cast<AllocationHeader*>(ptr) - 1;
+    if (header->counted) {
+        MemoryTracker::recordRelease(header->subsystem, header->size);
+    }
+    std::free(header);
+}
+
+void* allocateOrThrow(size_t size) {
+    if (size == 0) size = 1;
+    for (;;) {
+        if (void* memory = trackedAllocate(size)) {
+            return memory;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+    return allocateOrThrow(size);
+}
+
+void* operator new[](size_t size) {
+    return allocateOrThrow(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocateOrThrow(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocateOrThrow(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* ptr) noexcept {
+    trackedRelease(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    trackedRelease(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    trackedRelease(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    trackedRelease(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    trackedRelease(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    trackedRelease(ptr);
+}
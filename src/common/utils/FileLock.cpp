@@ -0,0 +1,79 @@
+/**
+ * @file FileLock.cpp
+ * @brief Bloqueo consultivo de archivos entre procesos
+ */
+
+#include <compiler/common/utils/FileLock.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstdint>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace cpp20::compiler::common::utils {
+
+std::unique_ptr<FileLock> FileLock::acquire(const std::filesystem::path& path) {
+    return lock(path, true);
+}
+
+std::unique_ptr<FileLock> FileLock::tryAcquire(const std::filesystem::path& path) {
+    return lock(path, false);
+}
+
+#ifdef _WIN32
+
+std::unique_ptr<FileLock> FileLock::lock(const std::filesystem::path& path, bool wait) {
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                              OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+
+    OVERLAPPED overlapped = {};
+    DWORD flags = LOCKFILE_EXCLUSIVE_LOCK | (wait ? 0 : LOCKFILE_FAIL_IMMEDIATELY);
+    if (!LockFileEx(file, flags, 0, MAXDWORD, MAXDWORD, &overlapped)) {
+        CloseHandle(file);
+        return nullptr;
+    }
+    return std::unique_ptr<FileLock>(new FileLock(file));
+}
+
+FileLock::~FileLock() {
+    OVERLAPPED overlapped = {};
+    UnlockFileEx(static_cast<HANDLE>(handle_), 0, MAXDWORD, MAXDWORD, &overlapped);
+    CloseHandle(static_cast<HANDLE>(handle_));
+}
+
+#else
+
+std::unique_ptr<FileLock> FileLock::lock(const std::filesystem::path& path, bool wait) {
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    int result;
+    do {
+        result = ::flock(fd, LOCK_EX | (wait ? 0 : LOCK_NB));
+    } while (result != 0 && errno == EINTR);
+    if (result != 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    return std::unique_ptr<FileLock>(new FileLock(reinterpret_cast<void*>(static_cast<intptr_t>(fd))));
+}
+
+FileLock::~FileLock() {
+    // Cerrar el descriptor libera el bloqueo
+    ::close(static_cast<int>(reinterpret_cast<intptr_t>(handle_)));
+}
+
+#endif
+
+} // namespace cpp20::compiler::common::utils
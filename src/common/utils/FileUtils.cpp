@@ -7,6 +7,13 @@
 #include <compiler/common/utils/StringUtils.h>
 #include <filesystem>
 #include <fstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
 
 namespace cpp20::compiler::common::utils {
 namespace fs = std::filesystem;
@@ -60,6 +67,60 @@ std::string readFile(const std::string& path) {
     return content;
 }
 
+#ifdef _WIN32
+
+bool statFile(const std::string& path, FileStamp& stamp) {
+    HANDLE file = CreateFileW(fs::path(path).c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    BY_HANDLE_FILE_INFORMATION info;
+    bool ok = GetFileInformationByHandle(file, &info) != 0;
+    CloseHandle(file);
+    if (!ok) {
+        return false;
+    }
+
+    // FILETIME cuenta intervalos de 100 ns desde 1601
+    constexpr int64_t UnixEpochIn100ns = 116444736000000000LL;
+    int64_t writeTime = static_cast<int64_t>((uint64_t{info.ftLastWriteTime.dwHighDateTime} << 32) |
+                                             info.ftLastWriteTime.dwLowDateTime);
+    stamp.size = (uint64_t{info.nFileSizeHigh} << 32) | info.nFileSizeLow;
+    stamp.modifiedNs = (writeTime - UnixEpochIn100ns) * 100;
+    stamp.device = info.dwVolumeSerialNumber;
+    stamp.fileId = (uint64_t{info.nFileIndexHigh} << 32) | info.nFileIndexLow;
+    return true;
+}
+
+#else
+
+bool statFile(const std::string& path, FileStamp& stamp) {
+    struct stat info;
+    if (::stat(path.c_str(), &info) != 0) {
+        return false;
+    }
+#ifdef __APPLE__
+    const struct timespec& modified = info.st_mtimespec;
+#else
+    const struct timespec& modified = info.st_mtim;
+#endif
+    stamp.size = static_cast<uint64_t>(info.st_size);
+    stamp.modifiedNs = static_cast<int64_t>(modified.tv_sec) * 1000000000 + modified.tv_nsec;
+    stamp.device = static_cast<uint64_t>(info.st_dev);
+    stamp.fileId = static_cast<uint64_t>(info.st_ino);
+    return true;
+}
+
+#endif
+
+FileBuffer readFileBuffer(const std::string& path) {
+    if (auto mapping = MappedFile::open(path)) {
+        return FileBuffer(std::move(mapping));
+    }
+    return FileBuffer(readFile(path));
+}
+
 void writeFile(const std::string& path, const std::string& content) {
     std::ofstream file(path, std::ios::binary);
     if (!file) {
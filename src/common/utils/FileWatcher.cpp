@@ -0,0 +1,132 @@
+/**
+ * @file FileWatcher.cpp
+ * @brief Vigilancia de directorios con inotify
+ */
+
+#include <compiler/common/utils/FileWatcher.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace cpp20::compiler::common::utils {
+
+#ifdef __linux__
+
+FileWatcher::FileWatcher(Callback onChange) : onChange_(std::move(onChange)) {
+    inotifyFd_ = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+    if (inotifyFd_ < 0) {
+        return;
+    }
+    if (pipe2(wakeFds_, O_CLOEXEC) != 0) {
+        close(inotifyFd_);
+        inotifyFd_ = -1;
+        return;
+    }
+    thread_ = std::thread([this]() { run(); });
+}
+
+FileWatcher::~FileWatcher() {
+    if (inotifyFd_ < 0) {
+        return;
+    }
+    char byte = 0;
+    [[maybe_unused]] ssize_t written = write(wakeFds_[1], &byte, 1);
+    thread_.join();
+    close(wakeFds_[0]);
+    close(wakeFds_[1]);
+    close(inotifyFd_);
+}
+
+bool FileWatcher::watchDirectory(const std::filesystem::path& directory) {
+    if (inotifyFd_ < 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!watched_.insert(directory.string()).second) {
+        return false;
+    }
+
+    constexpr uint32_t kEvents = IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_CREATE |
+                                 IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                                 IN_DELETE_SELF | IN_MOVE_SELF;
+    int descriptor = inotify_add_watch(inotifyFd_, directory.c_str(), kEvents);
+    if (descriptor < 0) {
+        watched_.erase(directory.string());
+        return false;
+    }
+    directories_[descriptor] = directory;
+    return true;
+}
+
+void FileWatcher::run() {
+    alignas(inotify_event) char buffer[64 * 1024];
+    pollfd fds[2] = {{inotifyFd_, POLLIN, 0}, {wakeFds_[0], POLLIN, 0}};
+
+    while (true) {
+        if (poll(fds, 2, -1) < 0) {
+            continue; // EINTR
+        }
+        if (fds[1].revents != 0) {
+            return;
+        }
+
+        ssize_t length = read(inotifyFd_, buffer, sizeof(buffer));
+        if (length <= 0) {
+            continue;
+        }
+
+        for (ssize_t offset = 0; offset < length;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                onChange_({});
+                continue;
+            }
+
+            std::filesystem::path changed;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = directories_.find(event->wd);
+                if (it == directories_.end()) {
+                    continue;
+                }
+                changed = it->second;
+
+                // Directorio borrado o movido: se deja de vigilar y se
+                // vuelve a añadir si alguien lo pide de nuevo
+                if (event->mask & IN_IGNORED) {
+                    watched_.erase(it->second.string());
+                    directories_.erase(it);
+                }
+            }
+
+            if (event->len > 0) {
+                onChange_(changed / event->name);
+            } else if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+                onChange_({});
+            }
+        }
+    }
+}
+
+#else
+
+FileWatcher::FileWatcher(Callback onChange) : onChange_(std::move(onChange)) {}
+
+FileWatcher::~FileWatcher() = default;
+
+bool FileWatcher::watchDirectory(const std::filesystem::path&) {
+    return false;
+}
+
+void FileWatcher::run() {}
+
+#endif
+
+} // namespace cpp20::compiler::common::utils
@@ -4,8 +4,14 @@
  */
 
 #include <compiler/common/utils/HashUtils.h>
+#include <algorithm>
+#include <cstring>
 #include <functional>
 
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
 namespace cpp20::compiler::common::utils {
 
 // ========================================================================
@@ -21,11 +27,24 @@ size_t hashCombine(size_t seed, size_t value) {
     return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
 }
 
+uint64_t mix64(uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ull;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebull;
+    value ^= value >> 31;
+    return value;
+}
+
+uint64_t hashMix(uint64_t seed, uint64_t value) {
+    return mix64(seed ^ (mix64(value) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2)));
+}
+
 size_t hashPointer(const void* ptr) {
     return std::hash<const void*>{}(ptr);
 }
 
-uint32_t fnv1a32(const std::string& str) {
+uint32_t fnv1a32(std::string_view str) {
     uint32_t hash = 2166136261u;
     for (char c : str) {
         hash ^= static_cast<uint8_t>(c);
@@ -34,8 +53,8 @@ uint32_t fnv1a32(const std::string& str) {
     return hash;
 }
 
-uint64_t fnv1a64(const std::string& str) {
-    uint64_t hash = 14695981039346656037ull;
+uint64_t fnv1a64(std::string_view str, uint64_t seed) {
+    uint64_t hash = seed;
     for (char c : str) {
         hash ^= static_cast<uint8_t>(c);
         hash *= 1099511628211ull;
@@ -43,4 +62,335 @@ uint64_t fnv1a64(const std::string& str) {
     return hash;
 }
 
+// ========================================================================
+// Hash rápido de contenido
+// ========================================================================
+
+namespace {
+
+constexpr uint64_t Prime0 = 0xa0761d6478bd642full;
+constexpr uint64_t Prime1 = 0xe7037ed1a0b428dbull;
+constexpr uint64_t Prime2 = 0x8ebc6af09c88c6e3ull;
+constexpr uint64_t Prime3 = 0x589965cc75374cc3ull;
+constexpr uint64_t Prime4 = 0x1d8e4e27c47d124full;
+
+// Producto completo de 128 bits plegado a 64: una MUL en x86-64 y AArch64
+inline uint64_t multiplyFold(uint64_t a, uint64_t b) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    uint64_t high;
+    uint64_t low = _umul128(a, b, &high);
+    return low ^ high;
+#else
+    __uint128_t product = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#endif
+}
+
+inline uint64_t read64(const unsigned char* bytes) {
+    uint64_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+inline uint64_t rotateLeft(uint64_t value, unsigned bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+const char HexDigits[] = "0123456789abcdef";
+
+void appendHex(std::string& out, uint64_t value) {
+    for (int shift = 60; shift >= 0; shift -= 4) {
+        out += HexDigits[(value >> shift) & 0xf];
+    }
+}
+
+} // namespace
+
+std::string Hash128::toHex() const {
+    std::string result;
+    result.reserve(32);
+    appendHex(result, high);
+    appendHex(result, low);
+    return result;
+}
+
+StreamingHasher::StreamingHasher(uint64_t seed)
+    : lanes_{seed ^ Prime0, rotateLeft(seed, 32) ^ Prime1} {}
+
+void StreamingHasher::consumeStripe(const unsigned char* stripe) {
+    // Los dos carriles no dependen entre sí: sus multiplicaciones se solapan
+    lanes_[0] = multiplyFold(read64(stripe) ^ Prime1, read64(stripe + 8) ^ lanes_[0]);
+    lanes_[1] = multiplyFold(read64(stripe + 16) ^ Prime2, read64(stripe + 24) ^ lanes_[1]);
+}
+
+void StreamingHasher::update(const void* data, size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    length_ += size;
+
+    if (buffered_ > 0) {
+        size_t take = std::min(size, StripeSize - buffered_);
+        std::memcpy(buffer_ + buffered_, bytes, take);
+        buffered_ += take;
+        bytes += take;
+        size -= take;
+        if (buffered_ < StripeSize) return;
+        consumeStripe(buffer_);
+        buffered_ = 0;
+    }
+    // Se deja siempre el resto en el buffer, aunque sea una franja entera:
+    // así el último bloque se trata igual sea cual sea el troceo
+    while (size > StripeSize) {
+        consumeStripe(bytes);
+        bytes += StripeSize;
+        size -= StripeSize;
+    }
+    std::memcpy(buffer_, bytes, size);
+    buffered_ = size;
+}
+
+Hash128 StreamingHasher::digest128() const {
+    uint64_t lane0 = lanes_[0];
+    uint64_t lane1 = lanes_[1];
+    if (buffered_ > 0) {
+        // Última franja rellena con ceros; la longitud total la desambigua
+        unsigned char tail[StripeSize] = {};
+        std::memcpy(tail, buffer_, buffered_);
+        lane0 = multiplyFold(read64(tail) ^ Prime1, read64(tail + 8) ^ lane0);
+        lane1 = multiplyFold(read64(tail + 16) ^ Prime2, read64(tail + 24) ^ lane1);
+    }
+
+    Hash128 result;
+    result.low = multiplyFold(lane0 ^ Prime3 ^ length_, lane1 ^ Prime4);
+    result.low = multiplyFold(result.low ^ Prime0, length_ ^ Prime1);
+    result.high = multiplyFold(lane1 ^ Prime2 ^ rotateLeft(length_, 32), lane0 ^ Prime3);
+    result.high = multiplyFold(result.high ^ Prime4, result.low ^ Prime0);
+    return result;
+}
+
+uint64_t hash64(std::string_view data, uint64_t seed) {
+    return hash128(data, seed).low;
+}
+
+Hash128 hash128(std::string_view data, uint64_t seed) {
+    StreamingHasher hasher(seed);
+    hasher.update(data);
+    return hasher.digest128();
+}
+
+// ========================================================================
+// BLAKE3
+// ========================================================================
+
+namespace {
+
+constexpr uint32_t Blake3IV[8] = {0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+                                  0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19};
+
+constexpr uint8_t Blake3Permutation[16] = {2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8};
+
+constexpr uint32_t ChunkStart = 1;
+constexpr uint32_t ChunkEnd = 2;
+constexpr uint32_t Parent = 4;
+constexpr uint32_t Root = 8;
+
+constexpr size_t BlockSize = 64;
+constexpr size_t ChunkSize = 1024;
+
+inline uint32_t rotateRight(uint32_t value, unsigned bits) {
+    return (value >> bits) | (value << (32 - bits));
+}
+
+inline void mixColumn(uint32_t state[16], int a, int b, int c, int d, uint32_t x, uint32_t y) {
+    state[a] = state[a] + state[b] + x;
+    state[d] = rotateRight(state[d] ^ state[a], 16);
+    state[c] = state[c] + state[d];
+    state[b] = rotateRight(state[b] ^ state[c], 12);
+    state[a] = state[a] + state[b] + y;
+    state[d] = rotateRight(state[d] ^ state[a], 8);
+    state[c] = state[c] + state[d];
+    state[b] = rotateRight(state[b] ^ state[c], 7);
+}
+
+void loadWords(const uint8_t block[BlockSize], uint32_t words[16]) {
+    for (int i = 0; i < 16; ++i) {
+        words[i] = uint32_t{block[4 * i]} | uint32_t{block[4 * i + 1]} << 8 |
+                   uint32_t{block[4 * i + 2]} << 16 | uint32_t{block[4 * i + 3]} << 24;
+    }
+}
+
+/**
+ * @brief Función de compresión: 7 rondas sobre un bloque de 16 palabras
+ */
+void compress(const uint32_t chainingValue[8], const uint32_t blockWords[16], uint64_t counter,
+              uint32_t blockLength, uint32_t flags, uint32_t out[16]) {
+    uint32_t state[16] = {chainingValue[0], chainingValue[1], chainingValue[2], chainingValue[3],
+                          chainingValue[4], chainingValue[5], chainingValue[6], chainingValue[7],
+                          Blake3IV[0], Blake3IV[1], Blake3IV[2], Blake3IV[3],
+                          static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32),
+                          blockLength, flags};
+    uint32_t m[16];
+    std::memcpy(m, blockWords, sizeof(m));
+
+    for (int round = 0; round < 7; ++round) {
+        mixColumn(state, 0, 4, 8, 12, m[0], m[1]);
+        mixColumn(state, 1, 5, 9, 13, m[2], m[3]);
+        mixColumn(state, 2, 6, 10, 14, m[4], m[5]);
+        mixColumn(state, 3, 7, 11, 15, m[6], m[7]);
+        mixColumn(state, 0, 5, 10, 15, m[8], m[9]);
+        mixColumn(state, 1, 6, 11, 12, m[10], m[11]);
+        mixColumn(state, 2, 7, 8, 13, m[12], m[13]);
+        mixColumn(state, 3, 4, 9, 14, m[14], m[15]);
+        if (round < 6) {
+            uint32_t permuted[16];
+            for (int i = 0; i < 16; ++i) permuted[i] = m[Blake3Permutation[i]];
+            std::memcpy(m, permuted, sizeof(m));
+        }
+    }
+    for (int i = 0; i < 8; ++i) {
+        out[i] = state[i] ^ state[i + 8];
+        out[i + 8] = state[i + 8] ^ chainingValue[i];
+    }
+}
+
+/**
+ * @brief Nodo pendiente de comprimir: su salida es un valor de encadenamiento o la raíz
+ */
+struct Blake3Output {
+    uint32_t chainingValue[8];
+    uint32_t blockWords[16];
+    uint64_t counter;
+    uint32_t blockLength;
+    uint32_t flags;
+
+    void chainingValueTo(uint32_t out[8]) const {
+        uint32_t full[16];
+        compress(chainingValue, blockWords, counter, blockLength, flags, full);
+        std::memcpy(out, full, 8 * sizeof(uint32_t));
+    }
+};
+
+Blake3Output parentOutput(const uint32_t left[8], const uint32_t right[8]) {
+    Blake3Output output;
+    std::memcpy(output.chainingValue, Blake3IV, sizeof(Blake3IV));
+    std::memcpy(output.blockWords, left, 8 * sizeof(uint32_t));
+    std::memcpy(output.blockWords + 8, right, 8 * sizeof(uint32_t));
+    output.counter = 0;
+    output.blockLength = BlockSize;
+    output.flags = Parent;
+    return output;
+}
+
+} // namespace
+
+Blake3Hasher::Blake3Hasher() {
+    startChunk(0);
+}
+
+void Blake3Hasher::startChunk(uint64_t counter) {
+    std::memcpy(chunk_.chainingValue, Blake3IV, sizeof(Blake3IV));
+    chunk_.chunkCounter = counter;
+    chunk_.blockLength = 0;
+    chunk_.blocksCompressed = 0;
+}
+
+void Blake3Hasher::updateChunk(const uint8_t* data, size_t size) {
+    while (size > 0) {
+        // Como en update(), el bloque lleno espera: puede ser el último del fragmento
+        if (chunk_.blockLength == BlockSize) {
+            uint32_t words[16];
+            uint32_t out[16];
+            loadWords(chunk_.block, words);
+            compress(chunk_.chainingValue, words, chunk_.chunkCounter, BlockSize,
+                     chunk_.blocksCompressed == 0 ? ChunkStart : 0, out);
+            std::memcpy(chunk_.chainingValue, out, 8 * sizeof(uint32_t));
+            ++chunk_.blocksCompressed;
+            chunk_.blockLength = 0;
+        }
+        size_t take = std::min(size, BlockSize - chunk_.blockLength);
+        std::memcpy(chunk_.block + chunk_.blockLength, data, take);
+        chunk_.blockLength = static_cast<uint8_t>(chunk_.blockLength + take);
+        data += take;
+        size -= take;
+    }
+}
+
+void Blake3Hasher::pushChunk(const uint32_t chainingValue[8], uint64_t totalChunks) {
+    // Cada cero final en el número de fragmentos es un subárbol completo que se cierra
+    uint32_t merged[8];
+    std::memcpy(merged, chainingValue, sizeof(merged));
+    while ((totalChunks & 1) == 0) {
+        --stackSize_;
+        parentOutput(stack_[stackSize_], merged).chainingValueTo(merged);
+        totalChunks >>= 1;
+    }
+    std::memcpy(stack_[stackSize_++], merged, sizeof(merged));
+}
+
+void Blake3Hasher::update(const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        if (chunk_.length() == ChunkSize) {
+            Blake3Output output;
+            std::memcpy(output.chainingValue, chunk_.chainingValue, sizeof(output.chainingValue));
+            loadWords(chunk_.block, output.blockWords);
+            output.counter = chunk_.chunkCounter;
+            output.blockLength = chunk_.blockLength;
+            output.flags = ChunkEnd;
+
+            uint32_t chainingValue[8];
+            output.chainingValueTo(chainingValue);
+            uint64_t totalChunks = chunk_.chunkCounter + 1;
+            pushChunk(chainingValue, totalChunks);
+            startChunk(totalChunks);
+        }
+        size_t take = std::min(size, ChunkSize - chunk_.length());
+        updateChunk(bytes, take);
+        bytes += take;
+        size -= take;
+    }
+}
+
+std::array<uint8_t, Blake3Hasher::OutputSize> Blake3Hasher::digest() const {
+    Blake3Output output;
+    std::memcpy(output.chainingValue, chunk_.chainingValue, sizeof(output.chainingValue));
+    uint8_t block[BlockSize] = {};
+    std::memcpy(block, chunk_.block, chunk_.blockLength);
+    loadWords(block, output.blockWords);
+    output.counter = chunk_.chunkCounter;
+    output.blockLength = chunk_.blockLength;
+    output.flags = ChunkEnd | (chunk_.blocksCompressed == 0 ? ChunkStart : 0);
+
+    for (size_t i = stackSize_; i > 0; --i) {
+        uint32_t right[8];
+        output.chainingValueTo(right);
+        output = parentOutput(stack_[i - 1], right);
+    }
+
+    uint32_t words[16];
+    compress(output.chainingValue, output.blockWords, 0, output.blockLength, output.flags | Root, words);
+    std::array<uint8_t, OutputSize> result;
+    for (size_t i = 0; i < 8; ++i) {
+        for (size_t b = 0; b < 4; ++b) {
+            result[4 * i + b] = static_cast<uint8_t>(words[i] >> (8 * b));
+        }
+    }
+    return result;
+}
+
+std::string Blake3Hasher::hexDigest() const {
+    std::string result;
+    result.reserve(2 * OutputSize);
+    for (uint8_t byte : digest()) {
+        result += HexDigits[byte >> 4];
+        result += HexDigits[byte & 0xf];
+    }
+    return result;
+}
+
+std::array<uint8_t, Blake3Hasher::OutputSize> blake3(std::string_view data) {
+    Blake3Hasher hasher;
+    hasher.update(data);
+    return hasher.digest();
+}
+
 } // namespace cpp20::compiler::common::utils
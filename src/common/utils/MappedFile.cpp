@@ -0,0 +1,164 @@
+/**
+ * @file MappedFile.cpp
+ * @brief Proyección de archivos en memoria, de lectura y de salida
+ */
+
+#include <compiler/common/utils/MappedFile.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cpp20::compiler::common::utils {
+
+#ifdef _WIN32
+
+std::unique_ptr<MappedFile> MappedFile::open(const std::filesystem::path& path) {
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return nullptr;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file); // La proyección mantiene el archivo abierto
+    if (!mapping) {
+        return nullptr;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        return nullptr;
+    }
+
+    return std::unique_ptr<MappedFile>(new MappedFile(
+        static_cast<const char*>(view), static_cast<size_t>(fileSize.QuadPart), mapping));
+}
+
+MappedFile::~MappedFile() {
+    UnmapViewOfFile(data_);
+    CloseHandle(static_cast<HANDLE>(mappingHandle_));
+}
+
+void MappedFile::prefetch() const {
+#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0602
+    WIN32_MEMORY_RANGE_ENTRY range{const_cast<char*>(data_), size_};
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#endif
+}
+
+std::unique_ptr<MappedOutputFile> MappedOutputFile::create(const std::filesystem::path& path, size_t size) {
+    if (size == 0) {
+        return nullptr;
+    }
+
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+
+    // Con el tamaño máximo la proyección extiende el archivo y reserva el espacio
+    ULARGE_INTEGER maximum;
+    maximum.QuadPart = size;
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, maximum.HighPart,
+                                        maximum.LowPart, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        return nullptr;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size);
+    if (!view) {
+        CloseHandle(mapping);
+        return nullptr;
+    }
+
+    return std::unique_ptr<MappedOutputFile>(new MappedOutputFile(static_cast<char*>(view), size, mapping));
+}
+
+MappedOutputFile::~MappedOutputFile() {
+    UnmapViewOfFile(data_);
+    CloseHandle(static_cast<HANDLE>(mappingHandle_));
+}
+
+#else
+
+std::unique_ptr<MappedFile> MappedFile::open(const std::filesystem::path& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void* view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // La proyección mantiene el archivo abierto
+    if (view == MAP_FAILED) {
+        return nullptr;
+    }
+
+    return std::unique_ptr<MappedFile>(new MappedFile(static_cast<const char*>(view), size, nullptr));
+}
+
+MappedFile::~MappedFile() {
+    ::munmap(const_cast<char*>(data_), size_);
+}
+
+void MappedFile::prefetch() const {
+    ::madvise(const_cast<char*>(data_), size_, MADV_WILLNEED);
+}
+
+std::unique_ptr<MappedOutputFile> MappedOutputFile::create(const std::filesystem::path& path, size_t size) {
+    if (size == 0) {
+        return nullptr;
+    }
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    // ftruncate solo fija el tamaño; sin reservar, un disco lleno daría SIGBUS al escribir
+    bool sized = ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+#ifndef __APPLE__
+    sized = sized && ::posix_fallocate(fd, 0, static_cast<off_t>(size)) == 0;
+#endif
+    if (!sized) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    void* view = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        return nullptr;
+    }
+
+    return std::unique_ptr<MappedOutputFile>(new MappedOutputFile(static_cast<char*>(view), size, nullptr));
+}
+
+MappedOutputFile::~MappedOutputFile() {
+    ::munmap(data_, size_);
+}
+
+#endif
+
+} // namespace cpp20::compiler::common::utils
@@ -4,75 +4,468 @@
  */
 
 #include <compiler/common/utils/MemoryPool.h>
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <new>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#endif
+
 namespace cpp20::compiler::common::utils {
 
+namespace {
+
+uintptr_t alignUp(uintptr_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+}
+
+size_t roundUp(size_t value, size_t granularity) {
+    return (value + granularity - 1) / granularity * granularity;
+}
+
+/**
+ * @brief Región virtual reservada para los bloques de un pool
+ */
+struct Region {
+    char* base = nullptr;
+    size_t size = 0;
+    bool largePages = false;
+};
+
+#ifdef _WIN32
+
+// MEM_LARGE_PAGES exige SeLockMemoryPrivilege activado en el token del proceso
+bool enableLockMemoryPrivilege() {
+    static const bool enabled = []() {
+        HANDLE token;
+        if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) {
+            return false;
+        }
+        TOKEN_PRIVILEGES privileges{};
+        privileges.PrivilegeCount = 1;
+        privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+        bool ok = LookupPrivilegeValueW(nullptr, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid) &&
+                  AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr) &&
+                  GetLastError() == ERROR_SUCCESS;
+        CloseHandle(token);
+        return ok;
+    }();
+    return enabled;
+}
+
+DWORD preferredNode(int numaNode) {
+    return numaNode >= 0 ? static_cast<DWORD>(numaNode) : NUMA_NO_PREFERRED_NODE;
+}
+
+Region reserveRegion(size_t bytes, bool largePages, int numaNode) {
+    // Las páginas grandes no se pueden reservar sin comprometer: la región entera queda fijada
+    if (largePages && enableLockMemoryPrivilege()) {
+        size_t largePageSize = GetLargePageMinimum();
+        if (largePageSize > 0) {
+            size_t size = roundUp(bytes, largePageSize);
+            void* base = VirtualAllocExNuma(GetCurrentProcess(), nullptr, size,
+                                            MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                                            PAGE_READWRITE, preferredNode(numaNode));
+            if (base) {
+                return {static_cast<char*>(base), size, true};
+            }
+        }
+    }
+
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    size_t size = roundUp(bytes, info.dwAllocationGranularity);
+    void* base = VirtualAllocExNuma(GetCurrentProcess(), nullptr, size, MEM_RESERVE,
+                                    PAGE_READWRITE, preferredNode(numaNode));
+    return base ? Region{static_cast<char*>(base), size, false} : Region{};
+}
+
+bool commitRegion(char* at, size_t size, bool largePages, int numaNode) {
+    return largePages || VirtualAllocExNuma(GetCurrentProcess(), at, size, MEM_COMMIT,
+                                            PAGE_READWRITE, preferredNode(numaNode));
+}
+
+void discardRegion(char* at, size_t size, bool largePages) {
+    if (!largePages && size > 0) {
+        VirtualFree(at, size, MEM_DECOMMIT);
+    }
+}
+
+void releaseRegion(char* base, size_t) {
+    VirtualFree(base, 0, MEM_RELEASE);
+}
+
+#else
+
+constexpr size_t kLargePageSize = 2 * 1024 * 1024;
+
+#ifdef __linux__
+// Constantes de <numaif.h>, para no depender de libnuma
+constexpr int kMpolPreferred = 1;
+constexpr size_t kMaxNumaNodes = 1024;
+
+void bindToNode(char* base, size_t size, int numaNode) {
+    if (numaNode < 0 || static_cast<size_t>(numaNode) >= kMaxNumaNodes) {
+        return;
+    }
+    constexpr size_t bitsPerWord = sizeof(unsigned long) * 8;
+    unsigned long mask[kMaxNumaNodes / bitsPerWord] = {};
+    mask[numaNode / bitsPerWord] |= 1UL << (numaNode % bitsPerWord);
+    // Preferencia, no obligación: si el nodo se queda sin memoria se usa otro
+    syscall(SYS_mbind, base, size, kMpolPreferred, mask, kMaxNumaNodes + 1, 0);
+}
+#endif
+
+Region reserveRegion(size_t bytes, bool largePages, int numaNode) {
+    constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+    Region region;
+
+#ifdef MAP_HUGETLB
+    // Páginas grandes reservadas por el administrador (vm.nr_hugepages). Sin
+    // MAP_NORESERVE: si no quedan bastantes, mmap falla en vez de dar SIGBUS al tocarlas
+    if (largePages) {
+        size_t size = roundUp(bytes, kLargePageSize);
+        void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (base != MAP_FAILED) {
+            region = {static_cast<char*>(base), size, true};
+        }
+    }
+#endif
+
+    if (!region.base) {
+        // Sin páginas reservadas: región alineada a página grande y THP con madvise
+        size_t alignment = largePages ? kLargePageSize : static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t size = roundUp(bytes, alignment);
+        void* mapped = mmap(nullptr, size + alignment, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (mapped == MAP_FAILED) {
+            return {};
+        }
+        char* raw = static_cast<char*>(mapped);
+        char* base = reinterpret_cast<char*>(alignUp(reinterpret_cast<uintptr_t>(raw), alignment));
+        if (base > raw) {
+            munmap(raw, base - raw);
+        }
+        munmap(base + size, raw + size + alignment - (base + size));
+        region = {base, size, false};
+#ifdef MADV_HUGEPAGE
+        if (largePages) {
+            region.largePages = madvise(base, size, MADV_HUGEPAGE) == 0;
+        }
+#endif
+    }
+
+#ifdef __linux__
+    bindToNode(region.base, region.size, numaNode);
+#else
+    (void)numaNode;
+#endif
+    return region;
+}
+
+// Las páginas se ocupan al tocarlas por primera vez
+bool commitRegion(char*, size_t, bool, int) {
+    return true;
+}
+
+void discardRegion(char* at, size_t size, bool) {
+    if (size > 0) {
+        madvise(at, size, MADV_DONTNEED);
+    }
+}
+
+void releaseRegion(char* base, size_t size) {
+    munmap(base, size);
+}
+
+#endif
+
+} // namespace
+
+int ArenaBacking::currentNumaNode() {
+#ifdef _WIN32
+    PROCESSOR_NUMBER processor;
+    GetCurrentProcessorNumberEx(&processor);
+    USHORT node = 0;
+    return GetNumaProcessorNodeEx(&processor, &node) ? node : 0;
+#elif defined(__linux__)
+    unsigned cpu = 0;
+    unsigned node = 0;
+    return syscall(SYS_getcpu, &cpu, &node, nullptr) == 0 ? static_cast<int>(node) : 0;
+#else
+    return 0;
+#endif
+}
+
 // ========================================================================
 // MemoryPool implementation
 // ========================================================================
 
 MemoryPool::MemoryPool(size_t blockSize, size_t initialBlocks)
-    : blockSize_(blockSize), initialBlocks_(initialBlocks) {
-    allocateNewBlock();
+    : blockSize_(blockSize), initialBlocks_(initialBlocks == 0 ? 1 : initialBlocks),
+      subsystem_(MemoryTracker::current()) {
+    initializeBlocks();
+}
+
+MemoryPool::MemoryPool(size_t blockSize, size_t initialBlocks, const ArenaBacking& backing)
+    : blockSize_(blockSize), initialBlocks_(initialBlocks == 0 ? 1 : initialBlocks),
+      subsystem_(MemoryTracker::current()) {
+    if (backing.reserveBytes > 0) {
+        Region region = reserveRegion(std::max(backing.reserveBytes, blockSize_), backing.largePages,
+                                      backing.numaNode);
+        region_ = region.base;
+        regionSize_ = region.size;
+        regionLargePages_ = region.largePages;
+        regionNode_ = backing.numaNode;
+    }
+    initializeBlocks();
+}
+
+void MemoryPool::initializeBlocks() {
+    blocks_.reserve(initialBlocks_);
+    for (size_t i = 0; i < initialBlocks_; ++i) {
+        allocateNewBlock();
+    }
+
+    currentBlockIndex_ = 0;
+    currentBlock_ = static_cast<char*>(blocks_[0]);
+    used_ = 0;
 }
 
 MemoryPool::~MemoryPool() {
+    runDestructors();
+    freeLargeBlocks();
     for (auto* block : blocks_) {
-        std::free(block);
+        freeBlock(block);
     }
+    if (region_) {
+        releaseRegion(region_, regionSize_);
+    }
+    trackRelease(trackedBytes_);
 }
 
-void* MemoryPool::allocate(size_t size) {
+void* MemoryPool::allocate(size_t size, size_t alignment) {
     if (size == 0) return nullptr;
 
-    // For simplicity, just use malloc for now
-    // TODO: Implement proper pooling for Capa 4+
-    void* ptr = std::malloc(size);
-    if (!ptr) {
-        throw std::bad_alloc();
+    // Asignaciones pequeñas: primero la lista libre de su clase. Solo se
+    // reutilizan para alineaciones que la granularidad de clase garantiza.
+    // Un hueco libre es tan alineado como la petición que lo creó, así que
+    // toda asignación pequeña sale alineada al menos a la granularidad.
+    if (size <= kMaxSmallSize) {
+        size_t index = sizeClassIndex(size);
+        if (alignment <= kSizeClassGranularity && freeLists_[index] && speculationDepth_ == 0) {
+            FreeNode* node = freeLists_[index];
+            freeLists_[index] = node->next;
+            return node;
+        }
+        // Redondear a la clase para que deallocate() pueda reciclar el hueco
+        size = (index + 1) * kSizeClassGranularity;
+        alignment = std::max(alignment, kSizeClassGranularity);
+    }
+
+    // Asignaciones que no caben en un bloque van aparte
+    if (size + alignment > blockSize_) {
+        void* memory = ::operator new(size, std::align_val_t(alignment));
+        largeBlocks_.push_back({memory, size, alignment});
+        largeBytes_ += size;
+        trackAllocation(size);
+        return memory;
+    }
+
+    auto base = reinterpret_cast<uintptr_t>(currentBlock_);
+    uintptr_t aligned = alignUp(base + used_, alignment);
+    if (aligned + size > base + blockSize_) {
+        advanceBlock();
+        base = reinterpret_cast<uintptr_t>(currentBlock_);
+        aligned = alignUp(base, alignment);
+    }
+
+    used_ = static_cast<size_t>(aligned - base) + size;
+    return reinterpret_cast<void*>(aligned);
+}
+
+void MemoryPool::deallocate(void* ptr, size_t size) {
+    // Un hueco reciclado dentro de memoria especulativa sobreviviría al rollback
+    if (!ptr || size == 0 || speculationDepth_ > 0) return;
+
+    // Solo los huecos pequeños se reciclan; el resto vuelve con reset()
+    if (size <= kMaxSmallSize) {
+        size_t index = sizeClassIndex(size);
+        auto* node = static_cast<FreeNode*>(ptr);
+        node->next = freeLists_[index];
+        freeLists_[index] = node;
+    }
+}
+
+MemoryPool::Checkpoint MemoryPool::checkpoint() {
+    ++speculationDepth_;
+    return {currentBlockIndex_, used_, usedInFullBlocks_, destructors_.size(), largeBlocks_.size()};
+}
+
+void MemoryPool::rollback(const Checkpoint& checkpoint) {
+    for (size_t i = destructors_.size(); i > checkpoint.destructors; --i) {
+        destructors_[i - 1].destroy(destructors_[i - 1].object);
     }
-    return ptr;
+    destructors_.resize(checkpoint.destructors);
+
+    for (size_t i = checkpoint.largeBlocks; i < largeBlocks_.size(); ++i) {
+        ::operator delete(largeBlocks_[i].memory, std::align_val_t(largeBlocks_[i].alignment));
+        largeBytes_ -= largeBlocks_[i].size;
+        trackRelease(largeBlocks_[i].size);
+    }
+    largeBlocks_.resize(checkpoint.largeBlocks);
+
+    // Los bloques que se pidieron después se conservan para reutilizarse
+    currentBlockIndex_ = checkpoint.blockIndex;
+    currentBlock_ = static_cast<char*>(blocks_[currentBlockIndex_]);
+    used_ = checkpoint.used;
+    usedInFullBlocks_ = checkpoint.usedInFullBlocks;
+    commit(checkpoint);
 }
 
-void MemoryPool::deallocate(void* ptr, size_t /*size*/) {
-    // For simplicity, just use free for now
-    // TODO: Implement proper pooling for Capa 4+
-    std::free(ptr);
+void MemoryPool::commit(const Checkpoint&) {
+    if (speculationDepth_ > 0) {
+        --speculationDepth_;
+    }
 }
 
 void MemoryPool::reset() {
-    // Free all blocks except the first one
-    for (size_t i = 1; i < blocks_.size(); ++i) {
-        std::free(blocks_[i]);
+    runDestructors();
+    freeLargeBlocks();
+    freeLists_.fill(nullptr);
+
+    currentBlockIndex_ = 0;
+    currentBlock_ = static_cast<char*>(blocks_[0]);
+    used_ = 0;
+    usedInFullBlocks_ = 0;
+}
+
+void MemoryPool::release() {
+    reset();
+
+    // Conservar los bloques iniciales, liberar los que se añadieron después
+    for (size_t i = initialBlocks_; i < blocks_.size(); ++i) {
+        freeBlock(blocks_[i]);
+        trackRelease(blockSize_);
     }
+    blocks_.resize(initialBlocks_);
 
-    if (!blocks_.empty()) {
-        blocks_.resize(1);
-        currentBlock_ = static_cast<char*>(blocks_[0]);
-        used_ = 0;
+    // La parte de la región que queda libre vuelve al sistema y se reparte de nuevo
+    if (region_) {
+        size_t kept = 0;
+        for (auto* block : blocks_) {
+            char* start = static_cast<char*>(block);
+            if (start >= region_ && start < region_ + regionSize_) {
+                kept = std::max(kept, static_cast<size_t>(start - region_) + blockSize_);
+            }
+        }
+        discardRegion(region_ + kept, regionUsed_ - kept, regionLargePages_);
+        regionUsed_ = kept;
     }
 }
 
 size_t MemoryPool::totalAllocated() const {
-    return blocks_.size() * blockSize_;
+    return blocks_.size() * blockSize_ + largeBytes_;
 }
 
 size_t MemoryPool::totalUsed() const {
-    return used_;
+    return usedInFullBlocks_ + used_ + largeBytes_;
+}
+
+void MemoryPool::setSubsystem(MemorySubsystem subsystem) {
+    if (subsystem == subsystem_) return;
+
+    size_t tracked = trackedBytes_;
+    trackRelease(tracked);
+    subsystem_ = subsystem;
+    if (tracked > 0) {
+        MemoryTracker::recordAllocation(subsystem_, tracked);
+        trackedBytes_ = tracked;
+    }
+}
+
+void MemoryPool::trackAllocation(size_t bytes) {
+    if (!MemoryTracker::isEnabled()) return;
+    MemoryTracker::recordAllocation(subsystem_, bytes);
+    trackedBytes_ += bytes;
+}
+
+void MemoryPool::trackRelease(size_t bytes) {
+    // Lo reservado antes de activar el seguimiento no se registró
+    bytes = std::min(bytes, trackedBytes_);
+    if (bytes == 0) return;
+    MemoryTracker::recordRelease(subsystem_, bytes);
+    trackedBytes_ -= bytes;
 }
 
 void MemoryPool::allocateNewBlock() {
-    void* block = std::malloc(blockSize_);
+    void* block = nullptr;
+    if (region_ && regionUsed_ + blockSize_ <= regionSize_ &&
+        commitRegion(region_ + regionUsed_, blockSize_, regionLargePages_, regionNode_)) {
+        block = region_ + regionUsed_;
+        regionUsed_ += blockSize_;
+    } else {
+        // Región agotada o sin reservar
+        block = std::malloc(blockSize_);
+    }
     if (!block) {
         throw std::bad_alloc();
     }
 
     blocks_.push_back(block);
+    trackAllocation(blockSize_);
+    currentBlockIndex_ = blocks_.size() - 1;
     currentBlock_ = static_cast<char*>(block);
     used_ = 0;
 }
 
+void MemoryPool::freeBlock(void* block) {
+    char* start = static_cast<char*>(block);
+    if (!region_ || start < region_ || start >= region_ + regionSize_) {
+        std::free(block);
+    }
+}
+
+void MemoryPool::advanceBlock() {
+    usedInFullBlocks_ += used_;
+
+    // Reutilizar bloques conservados por reset() antes de pedir más
+    if (currentBlockIndex_ + 1 < blocks_.size()) {
+        ++currentBlockIndex_;
+        currentBlock_ = static_cast<char*>(blocks_[currentBlockIndex_]);
+        used_ = 0;
+        return;
+    }
+
+    allocateNewBlock();
+}
+
+void MemoryPool::runDestructors() {
+    for (auto it = destructors_.rbegin(); it != destructors_.rend(); ++it) {
+        it->destroy(it->object);
+    }
+    destructors_.clear();
+}
+
+void MemoryPool::freeLargeBlocks() {
+    for (const auto& block : largeBlocks_) {
+        ::operator delete(block.memory, std::align_val_t(block.alignment));
+        trackRelease(block.size);
+    }
+    largeBlocks_.clear();
+    largeBytes_ = 0;
+}
+
+size_t MemoryPool::sizeClassIndex(size_t size) {
+    return (size - 1) / kSizeClassGranularity;
+}
+
 } // namespace cpp20::compiler::common::utils
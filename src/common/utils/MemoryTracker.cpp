@@ -0,0 +1,140 @@
+/**
+ * @file MemoryTracker.cpp
+ * @brief Contabilidad de memoria por subsistema
+ */
+
+#include <compiler/common/utils/MemoryTracker.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+
+namespace cpp20::compiler::common::utils {
+
+namespace {
+
+struct SubsystemCounters {
+    std::atomic<size_t> current{0};
+    std::atomic<size_t> peak{0};
+    std::atomic<size_t> allocations{0};
+};
+
+std::atomic<bool> trackingEnabled{false};
+std::array<SubsystemCounters, MemoryTracker::SubsystemCount> subsystemCounters;
+std::atomic<size_t> totalBytes{0};
+std::atomic<size_t> totalPeakBytes{0};
+std::atomic<size_t> highWater{0};      // Pico de la ventana abierta más interna
+
+thread_local MemorySubsystem currentSubsystem = MemorySubsystem::Other;
+
+void updateMax(std::atomic<size_t>& target, size_t value) {
+    size_t observed = target.load(std::memory_order_relaxed);
+    while (observed < value &&
+           !target.compare_exchange_weak(observed, value, std::memory_order_relaxed)) {
+    }
+}
+
+// Resta sin dar la vuelta: una liberación registrada tras activar el
+// seguimiento puede corresponder a una asignación anterior
+void saturatingSub(std::atomic<size_t>& target, size_t value) {
+    size_t observed = target.load(std::memory_order_relaxed);
+    while (!target.compare_exchange_weak(observed, observed > value ? observed - value : 0,
+                                         std::memory_order_relaxed)) {
+    }
+}
+
+SubsystemCounters& countersFor(MemorySubsystem subsystem) {
+    size_t index = static_cast<size_t>(subsystem);
+    return subsystemCounters[index < MemoryTracker::SubsystemCount ? index : 0];
+}
+
+} // namespace
+
+void MemoryTracker::setEnabled(bool enabled) {
+    trackingEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool MemoryTracker::isEnabled() {
+    return trackingEnabled.load(std::memory_order_relaxed);
+}
+
+void MemoryTracker::recordAllocation(MemorySubsystem subsystem, size_t bytes) {
+    SubsystemCounters& counters = countersFor(subsystem);
+    size_t current = counters.current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    updateMax(counters.peak, current);
+
+    size_t total = totalBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    updateMax(totalPeakBytes, total);
+    updateMax(highWater, total);
+}
+
+void MemoryTracker::recordRelease(MemorySubsystem subsystem, size_t bytes) {
+    saturatingSub(countersFor(subsystem).current, bytes);
+    saturatingSub(totalBytes, bytes);
+}
+
+MemorySubsystem MemoryTracker::current() {
+    return currentSubsystem;
+}
+
+void MemoryTracker::setCurrent(MemorySubsystem subsystem) {
+    currentSubsystem = subsystem;
+}
+
+MemoryCounters MemoryTracker::counters(MemorySubsystem subsystem) {
+    const SubsystemCounters& counters = countersFor(subsystem);
+    MemoryCounters result;
+    result.current = counters.current.load(std::memory_order_relaxed);
+    result.peak = counters.peak.load(std::memory_order_relaxed);
+    result.allocations = counters.allocations.load(std::memory_order_relaxed);
+    return result;
+}
+
+size_t MemoryTracker::totalCurrent() {
+    return totalBytes.load(std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::totalPeak() {
+    return totalPeakBytes.load(std::memory_order_relaxed);
+}
+
+void MemoryTracker::resetPeaks() {
+    for (auto& counters : subsystemCounters) {
+        counters.peak.store(counters.current.load(std::memory_order_relaxed),
+                            std::memory_order_relaxed);
+    }
+    size_t total = totalBytes.load(std::memory_order_relaxed);
+    totalPeakBytes.store(total, std::memory_order_relaxed);
+    highWater.store(total, std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::beginPeakWindow() {
+    return highWater.exchange(totalBytes.load(std::memory_order_relaxed),
+                              std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::endPeakWindow(size_t previous) {
+    size_t peak = std::max(highWater.load(std::memory_order_relaxed),
+                           totalBytes.load(std::memory_order_relaxed));
+    // La ventana de fuera también vio este pico
+    updateMax(highWater, previous);
+    return peak;
+}
+
+std::string_view MemoryTracker::subsystemName(MemorySubsystem subsystem) {
+    switch (subsystem) {
+        case MemorySubsystem::Other: return "Other";
+        case MemorySubsystem::Sources: return "Sources";
+        case MemorySubsystem::Tokens: return "Tokens";
+        case MemorySubsystem::AST: return "AST";
+        case MemorySubsystem::Types: return "Types";
+        case MemorySubsystem::IR: return "IR";
+        case MemorySubsystem::Backend: return "Backend";
+        case MemorySubsystem::Caches: return "Caches";
+        case MemorySubsystem::BMI: return "BMI";
+        case MemorySubsystem::Count: break;
+    }
+    return "Unknown";
+}
+
+} // namespace cpp20::compiler::common::utils
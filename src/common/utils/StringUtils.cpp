@@ -9,85 +9,124 @@
 
 namespace cpp20::compiler::common::utils {
 
+namespace {
+
+constexpr std::string_view kWhitespace = " \t\n\r\f\v";
+
+char lowerChar(char c) {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+}
+
+char upperChar(char c) {
+    return static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+}
+
+} // namespace
+
 // ========================================================================
 // Funciones de manipulación de strings
 // ========================================================================
 
-std::string toLower(const std::string& str) {
-    std::string result = str;
-    std::transform(result.begin(), result.end(), result.begin(),
-                   [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+std::string toLower(std::string_view str) {
+    std::string result(str);
+    toLowerInPlace(result);
     return result;
 }
 
-std::string toUpper(const std::string& str) {
-    std::string result = str;
-    std::transform(result.begin(), result.end(), result.begin(),
-                   [](char c) { return static_cast<char>(std::toupper(static_cast<unsigned char>(c))); });
+std::string toUpper(std::string_view str) {
+    std::string result(str);
+    toUpperInPlace(result);
     return result;
 }
 
-std::string trim(const std::string& str) {
-    // Trim left
-    auto start = str.find_first_not_of(" \t\n\r\f\v");
-    if (start == std::string::npos) return "";
+void toLowerInPlace(std::string& str) {
+    std::transform(str.begin(), str.end(), str.begin(), lowerChar);
+}
 
-    // Trim right
-    auto end = str.find_last_not_of(" \t\n\r\f\v");
-    return str.substr(start, end - start + 1);
+void toUpperInPlace(std::string& str) {
+    std::transform(str.begin(), str.end(), str.begin(), upperChar);
 }
 
-std::string trimLeft(const std::string& str) {
-    auto start = str.find_first_not_of(" \t\n\r\f\v");
-    return (start == std::string::npos) ? "" : str.substr(start);
+std::string trim(std::string_view str) {
+    return std::string(trimView(str));
 }
 
-std::string trimRight(const std::string& str) {
-    auto end = str.find_last_not_of(" \t\n\r\f\v");
-    return (end == std::string::npos) ? "" : str.substr(0, end + 1);
+std::string trimLeft(std::string_view str) {
+    return std::string(trimLeftView(str));
 }
 
-bool startsWith(const std::string& str, const std::string& prefix) {
-    return str.size() >= prefix.size() &&
-           str.compare(0, prefix.size(), prefix) == 0;
+std::string trimRight(std::string_view str) {
+    return std::string(trimRightView(str));
 }
 
-bool endsWith(const std::string& str, const std::string& suffix) {
-    return str.size() >= suffix.size() &&
-           str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+std::string_view trimView(std::string_view str) {
+    return trimRightView(trimLeftView(str));
 }
 
-std::vector<std::string> split(const std::string& str, char delimiter) {
-    std::vector<std::string> tokens;
-    std::string token;
-    std::istringstream tokenStream(str);
+std::string_view trimLeftView(std::string_view str) {
+    auto start = str.find_first_not_of(kWhitespace);
+    return (start == std::string_view::npos) ? std::string_view() : str.substr(start);
+}
 
-    while (std::getline(tokenStream, token, delimiter)) {
-        tokens.push_back(token);
-    }
+std::string_view trimRightView(std::string_view str) {
+    auto end = str.find_last_not_of(kWhitespace);
+    return (end == std::string_view::npos) ? std::string_view() : str.substr(0, end + 1);
+}
 
+bool startsWith(std::string_view str, std::string_view prefix) {
+    return str.starts_with(prefix);
+}
+
+bool endsWith(std::string_view str, std::string_view suffix) {
+    return str.ends_with(suffix);
+}
+
+std::vector<std::string> split(std::string_view str, char delimiter) {
+    // Como std::getline: sin campo vacío al final ni para el texto vacío
+    std::vector<std::string> tokens;
+    for (std::string_view field : splitView(str, delimiter)) {
+        tokens.emplace_back(field);
+    }
+    if (!tokens.empty() && tokens.back().empty()) {
+        tokens.pop_back();
+    }
     return tokens;
 }
 
-std::string join(const std::vector<std::string>& parts, const std::string& separator) {
+std::string join(const std::vector<std::string>& parts, std::string_view separator) {
     if (parts.empty()) return "";
 
-    std::string result = parts[0];
+    size_t size = separator.size() * (parts.size() - 1);
+    for (const std::string& part : parts) {
+        size += part.size();
+    }
+
+    std::string result;
+    result.reserve(size);
+    result += parts[0];
     for (size_t i = 1; i < parts.size(); ++i) {
-        result += separator + parts[i];
+        result += separator;
+        result += parts[i];
     }
     return result;
 }
 
-std::string replace(const std::string& str, const std::string& from, const std::string& to) {
-    std::string result = str;
-    size_t pos = 0;
-
-    while ((pos = result.find(from, pos)) != std::string::npos) {
-        result.replace(pos, from.length(), to);
-        pos += to.length();
+std::string replace(std::string_view str, std::string_view from, std::string_view to) {
+    if (from.empty()) {
+        return std::string(str);
     }
 
+    // Una pasada copiando tramos: sin desplazar el resto en cada reemplazo
+    std::string result;
+    result.reserve(str.size());
+    size_t start = 0;
+    size_t pos;
+    while ((pos = str.find(from, start)) != std::string_view::npos) {
+        result.append(str, start, pos - start);
+        result += to;
+        start = pos + from.size();
+    }
+    result.append(str, start);
     return result;
 }
 
@@ -0,0 +1,146 @@
+/**
+ * @file ThreadPool.cpp
+ * @brief Pool de hilos y utilidades de paralelismo
+ */
+
+#include <compiler/common/utils/ThreadPool.h>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace cpp20::compiler::common::utils {
+
+// ========================================================================
+// ThreadPool implementation
+// ========================================================================
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = defaultThreadCount();
+    }
+
+    workers_.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers_.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    taskAvailable_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this]() { return tasks_.empty() && activeTasks_ == 0; });
+}
+
+size_t ThreadPool::defaultThreadCount() {
+    unsigned int hardware = std::thread::hardware_concurrency();
+    return hardware == 0 ? 1 : static_cast<size_t>(hardware);
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push(std::move(task));
+    }
+    taskAvailable_.notify_one();
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            taskAvailable_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+
+            if (tasks_.empty()) {
+                return; // stopping_ y sin trabajo pendiente
+            }
+
+            task = std::move(tasks_.front());
+            tasks_.pop();
+            ++activeTasks_;
+        }
+
+        // packaged_task captura las excepciones en el future
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --activeTasks_;
+            if (tasks_.empty() && activeTasks_ == 0) {
+                idle_.notify_all();
+            }
+        }
+    }
+}
+
+// ========================================================================
+// parallelFor
+// ========================================================================
+
+void parallelFor(size_t count, size_t jobs, const std::function<void(size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+
+    if (jobs <= 1 || count == 1) {
+        for (size_t i = 0; i < count; ++i) {
+            body(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> nextIndex{0};
+    std::exception_ptr firstError;
+    std::mutex errorMutex;
+
+    auto worker = [&]() {
+        while (true) {
+            size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+            if (index >= count) {
+                return;
+            }
+
+            try {
+                body(index);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!firstError) {
+                    firstError = std::current_exception();
+                }
+            }
+        }
+    };
+
+    size_t threadCount = std::min(jobs, count);
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (size_t i = 1; i < threadCount; ++i) {
+        threads.emplace_back(worker);
+    }
+
+    // El hilo llamante también trabaja
+    worker();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+}
+
+} // namespace cpp20::compiler::common::utils
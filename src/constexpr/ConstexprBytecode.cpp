@@ -0,0 +1,522 @@
+/**
+ * @file ConstexprBytecode.cpp
+ * @brief Compilación de funciones y expresiones constexpr a bytecode
+ */
+
+#include <compiler/constexpr/ConstexprBytecode.h>
+
+namespace cpp20::compiler::constexpr_eval {
+
+namespace {
+
+/**
+ * @brief ¿El tipo escrito lleva const o constexpr como palabra?
+ */
+bool isConstQualified(std::string_view typeName) {
+    size_t position = 0;
+    while (position < typeName.size()) {
+        size_t end = typeName.find_first_of(" \t*&", position);
+        if (end == std::string_view::npos) end = typeName.size();
+        std::string_view word = typeName.substr(position, end - position);
+        if (word == "const" || word == "constexpr") {
+            return true;
+        }
+        position = end + 1;
+    }
+    return false;
+}
+
+/**
+ * @brief Operador binario de una asignación compuesta
+ */
+std::optional<ast::BinaryOp::OpKind> binaryOpFor(ast::Assignment::OpKind op) {
+    using A = ast::Assignment::OpKind;
+    using B = ast::BinaryOp::OpKind;
+    switch (op) {
+        case A::AddAssign: return B::Add;
+        case A::SubtractAssign: return B::Subtract;
+        case A::MultiplyAssign: return B::Multiply;
+        case A::DivideAssign: return B::Divide;
+        case A::ModuloAssign: return B::Modulo;
+        case A::BitwiseAndAssign: return B::BitwiseAnd;
+        case A::BitwiseOrAssign: return B::BitwiseOr;
+        case A::BitwiseXorAssign: return B::BitwiseXor;
+        case A::LeftShiftAssign: return B::LeftShift;
+        case A::RightShiftAssign: return B::RightShift;
+        case A::Assign: return std::nullopt;
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+BytecodeCompiler::BytecodeCompiler(FunctionResolver resolver)
+    : resolver_(std::move(resolver)) {
+}
+
+std::unique_ptr<BytecodeFunction> BytecodeCompiler::compileFunction(const ast::FunctionDecl* function,
+                                                                    std::string& error) {
+    if (!function || !function->getBody()) {
+        error = "La función no tiene cuerpo disponible";
+        return nullptr;
+    }
+
+    auto result = std::make_unique<BytecodeFunction>();
+    result->name = std::string(function->getName());
+    result->returnsValue = function->getReturnType() != "void";
+    reset(result.get());
+
+    for (const ast::ParameterDecl* parameter : function->getParameters()) {
+        declare(parameter->getName(), allocate(), isConstQualified(parameter->getTypeName()));
+    }
+    result->parameterCount = top_;
+
+    compileCompound(function->getBody());
+    emit({OpCode::ReturnVoid});
+
+    if (failed()) {
+        error = error_;
+        return nullptr;
+    }
+    return result;
+}
+
+std::unique_ptr<BytecodeFunction> BytecodeCompiler::compileStandalone(
+    const ast::ASTNode* node,
+    const std::vector<std::string>& freeVariables,
+    std::string& error) {
+
+    if (!node) {
+        error = "Expresión nula";
+        return nullptr;
+    }
+
+    auto result = std::make_unique<BytecodeFunction>();
+    result->freeVariables = freeVariables;
+    reset(result.get());
+
+    // Las vistas apuntan a result->freeVariables, que vive con la función
+    for (const std::string& name : result->freeVariables) {
+        declare(name, allocate(), true);
+    }
+    result->parameterCount = top_;
+
+    if (isExpression(node->getKind())) {
+        uint32_t value = compileOperand(node);
+        emit({OpCode::Return, 0, 0, value});
+    } else {
+        compileStatement(node);
+        emit({OpCode::ReturnVoid});
+    }
+
+    if (failed()) {
+        error = error_;
+        return nullptr;
+    }
+    return result;
+}
+
+void BytecodeCompiler::reset(BytecodeFunction* function) {
+    function_ = function;
+    scopes_.clear();
+    scopes_.emplace_back();
+    top_ = 0;
+    error_.clear();
+}
+
+bool BytecodeCompiler::fail(std::string message) {
+    if (error_.empty()) {
+        error_ = std::move(message);
+    }
+    return false;
+}
+
+uint32_t BytecodeCompiler::allocate() {
+    uint32_t reg = top_++;
+    if (top_ > function_->registerCount) {
+        function_->registerCount = top_;
+    }
+    return reg;
+}
+
+uint32_t BytecodeCompiler::addConstant(ConstexprValue value) {
+    function_->constants.push_back(value);
+    return static_cast<uint32_t>(function_->constants.size() - 1);
+}
+
+size_t BytecodeCompiler::emit(Instruction instruction) {
+    function_->code.push_back(instruction);
+    return function_->code.size() - 1;
+}
+
+void BytecodeCompiler::patchJump(size_t at, size_t target) {
+    Instruction& jump = function_->code[at];
+    if (jump.op == OpCode::Jump) {
+        jump.a = static_cast<uint32_t>(target);
+    } else {
+        jump.b = static_cast<uint32_t>(target);
+    }
+}
+
+const BytecodeCompiler::LocalVariable* BytecodeCompiler::lookup(std::string_view name) const {
+    for (auto it = scopes_.rbegin(); it != scopes_.rend(); ++it) {
+        auto found = it->find(name);
+        if (found != it->end()) {
+            return &found->second;
+        }
+    }
+    return nullptr;
+}
+
+void BytecodeCompiler::declare(std::string_view name, uint32_t reg, bool isConst) {
+    if (!name.empty()) {
+        scopes_.back()[name] = LocalVariable{reg, isConst};
+    }
+}
+
+bool BytecodeCompiler::isExpression(ast::ASTNodeKind kind) {
+    switch (kind) {
+        case ast::ASTNodeKind::Literal:
+        case ast::ASTNodeKind::IntegerLiteral:
+        case ast::ASTNodeKind::FloatingPointLiteral:
+        case ast::ASTNodeKind::CharacterLiteral:
+        case ast::ASTNodeKind::StringLiteral:
+        case ast::ASTNodeKind::BooleanLiteral:
+        case ast::ASTNodeKind::Identifier:
+        case ast::ASTNodeKind::BinaryOp:
+        case ast::ASTNodeKind::UnaryOp:
+        case ast::ASTNodeKind::FunctionCall:
+        case ast::ASTNodeKind::TernaryOp:
+        case ast::ASTNodeKind::Assignment:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// ============================================================================
+// Sentencias
+// ============================================================================
+
+void BytecodeCompiler::compileStatement(const ast::ASTNode* node) {
+    if (!node || failed()) return;
+
+    switch (node->getKind()) {
+        case ast::ASTNodeKind::CompoundStmt:
+            compileCompound(static_cast<const ast::CompoundStmt*>(node));
+            break;
+        case ast::ASTNodeKind::ExprStmt:
+            if (const ast::ASTNode* expression = static_cast<const ast::ExprStmt*>(node)->getExpression()) {
+                uint32_t mark = top_;
+                compileOperand(expression);
+                top_ = mark;
+            }
+            break;
+        case ast::ASTNodeKind::VariableDecl:
+            compileVariable(static_cast<const ast::VariableDecl*>(node));
+            break;
+        case ast::ASTNodeKind::IfStmt:
+            compileIf(static_cast<const ast::IfStmt*>(node));
+            break;
+        case ast::ASTNodeKind::WhileStmt:
+            compileWhile(static_cast<const ast::WhileStmt*>(node));
+            break;
+        case ast::ASTNodeKind::ForStmt:
+            compileFor(static_cast<const ast::ForStmt*>(node));
+            break;
+        case ast::ASTNodeKind::ReturnStmt:
+            compileReturn(static_cast<const ast::ReturnStmt*>(node));
+            break;
+        default:
+            if (isExpression(node->getKind())) {
+                uint32_t mark = top_;
+                compileOperand(node);
+                top_ = mark;
+            } else {
+                fail(std::string("Sentencia no soportada en constexpr: ") + ast::nodeKindName(node->getKind()));
+            }
+            break;
+    }
+}
+
+void BytecodeCompiler::compileCompound(const ast::CompoundStmt* node) {
+    // Los registros de las variables del bloque se reutilizan al salir
+    uint32_t mark = top_;
+    scopes_.emplace_back();
+    for (const ast::ASTNode* statement : node->getStatements()) {
+        compileStatement(statement);
+    }
+    scopes_.pop_back();
+    top_ = mark;
+}
+
+void BytecodeCompiler::compileVariable(const ast::VariableDecl* node) {
+    uint32_t reg = allocate();
+    if (node->getInitializer()) {
+        compileInto(node->getInitializer(), reg);
+    } else {
+        // Cada iteración de un bucle vuelve a empezar sin inicializar
+        emit({OpCode::LoadConst, 0, 0, reg, addConstant(ConstexprValue())});
+    }
+    // Declarar después del inicializador: "int x = x;" no ve la nueva x
+    declare(node->getName(), reg, isConstQualified(node->getTypeName()));
+}
+
+void BytecodeCompiler::compileIf(const ast::IfStmt* node) {
+    uint32_t mark = top_;
+    uint32_t condition = compileOperand(node->getCondition());
+    top_ = mark;
+    size_t jumpToElse = emit({OpCode::JumpIfFalse, 0, 0, condition});
+
+    compileStatement(node->getThen());
+    if (node->getElse()) {
+        size_t jumpToEnd = emit({OpCode::Jump});
+        patchJump(jumpToElse, function_->code.size());
+        compileStatement(node->getElse());
+        patchJump(jumpToEnd, function_->code.size());
+    } else {
+        patchJump(jumpToElse, function_->code.size());
+    }
+}
+
+void BytecodeCompiler::compileWhile(const ast::WhileStmt* node) {
+    size_t loopStart = function_->code.size();
+    uint32_t mark = top_;
+    uint32_t condition = compileOperand(node->getCondition());
+    top_ = mark;
+    size_t exitJump = emit({OpCode::JumpIfFalse, 0, 0, condition});
+
+    compileStatement(node->getBody());
+    emit({OpCode::Jump, 0, 0, static_cast<uint32_t>(loopStart)});
+    patchJump(exitJump, function_->code.size());
+}
+
+void BytecodeCompiler::compileFor(const ast::ForStmt* node) {
+    uint32_t mark = top_;
+    scopes_.emplace_back();
+    compileStatement(node->getInit());
+
+    size_t loopStart = function_->code.size();
+    std::optional<size_t> exitJump;
+    if (node->getCondition()) {
+        uint32_t conditionMark = top_;
+        uint32_t condition = compileOperand(node->getCondition());
+        top_ = conditionMark;
+        exitJump = emit({OpCode::JumpIfFalse, 0, 0, condition});
+    }
+
+    compileStatement(node->getBody());
+    compileStatement(node->getIncrement());
+    emit({OpCode::Jump, 0, 0, static_cast<uint32_t>(loopStart)});
+    if (exitJump) {
+        patchJump(*exitJump, function_->code.size());
+    }
+
+    scopes_.pop_back();
+    top_ = mark;
+}
+
+void BytecodeCompiler::compileReturn(const ast::ReturnStmt* node) {
+    if (!node->getValue()) {
+        emit({OpCode::ReturnVoid});
+        return;
+    }
+    uint32_t mark = top_;
+    uint32_t value = compileOperand(node->getValue());
+    top_ = mark;
+    emit({OpCode::Return, 0, 0, value});
+}
+
+// ============================================================================
+// Expresiones
+// ============================================================================
+
+uint32_t BytecodeCompiler::compileOperand(const ast::ASTNode* node) {
+    if (node && node->getKind() == ast::ASTNodeKind::Identifier) {
+        auto name = static_cast<const ast::Identifier*>(node)->getName();
+        if (const LocalVariable* variable = lookup(name)) {
+            return variable->reg;
+        }
+    }
+    uint32_t reg = allocate();
+    compileInto(node, reg);
+    return reg;
+}
+
+void BytecodeCompiler::compileInto(const ast::ASTNode* node, uint32_t dst) {
+    if (failed()) return;
+    if (!node) {
+        fail("Expresión nula");
+        return;
+    }
+
+    switch (node->getKind()) {
+        case ast::ASTNodeKind::IntegerLiteral: {
+            int64_t value = static_cast<const ast::IntegerLiteral*>(node)->getValue();
+            emit({OpCode::LoadConst, 0, 0, dst, addConstant(ConstexprValue(static_cast<long>(value)))});
+            break;
+        }
+        case ast::ASTNodeKind::BooleanLiteral:
+            emit({OpCode::LoadConst, 0, 0, dst,
+                  addConstant(ConstexprValue(static_cast<const ast::BooleanLiteral*>(node)->getValue()))});
+            break;
+        case ast::ASTNodeKind::CharacterLiteral:
+            emit({OpCode::LoadConst, 0, 0, dst,
+                  addConstant(ConstexprValue(static_cast<const ast::CharacterLiteral*>(node)->getValue()))});
+            break;
+        case ast::ASTNodeKind::FloatingPointLiteral:
+            emit({OpCode::LoadConst, 0, 0, dst,
+                  addConstant(ConstexprValue(static_cast<const ast::FloatingPointLiteral*>(node)->getValue()))});
+            break;
+        case ast::ASTNodeKind::StringLiteral:
+            emit({OpCode::LoadConst, 0, 0, dst,
+                  addConstant(ConstexprValue(static_cast<const ast::StringLiteral*>(node)->getValue()))});
+            break;
+        case ast::ASTNodeKind::Identifier: {
+            auto name = static_cast<const ast::Identifier*>(node)->getName();
+            const LocalVariable* variable = lookup(name);
+            if (!variable) {
+                fail("'" + std::string(name) + "' no es una variable utilizable en constexpr");
+                return;
+            }
+            if (variable->reg != dst) {
+                emit({OpCode::Move, 0, 0, dst, variable->reg});
+            }
+            break;
+        }
+        case ast::ASTNodeKind::BinaryOp:
+            compileBinary(static_cast<const ast::BinaryOp*>(node), dst);
+            break;
+        case ast::ASTNodeKind::UnaryOp: {
+            const auto* unary = static_cast<const ast::UnaryOp*>(node);
+            if (unary->getOp() == ast::UnaryOp::OpKind::AddressOf ||
+                unary->getOp() == ast::UnaryOp::OpKind::Dereference) {
+                fail("Punteros no soportados en constexpr");
+                return;
+            }
+            uint32_t mark = top_;
+            uint32_t operand = compileOperand(unary->getOperand());
+            emit({OpCode::Unary, static_cast<uint8_t>(unary->getOp()), 0, dst, operand});
+            top_ = mark;
+            break;
+        }
+        case ast::ASTNodeKind::TernaryOp:
+            compileTernary(static_cast<const ast::TernaryOp*>(node), dst);
+            break;
+        case ast::ASTNodeKind::Assignment:
+            compileAssignment(static_cast<const ast::Assignment*>(node), dst);
+            break;
+        case ast::ASTNodeKind::FunctionCall:
+            compileCall(static_cast<const ast::FunctionCall*>(node), dst);
+            break;
+        default:
+            fail(std::string("Expresión no soportada en constexpr: ") + ast::nodeKindName(node->getKind()));
+            break;
+    }
+}
+
+void BytecodeCompiler::compileBinary(const ast::BinaryOp* node, uint32_t dst) {
+    using Op = ast::BinaryOp::OpKind;
+    uint32_t mark = top_;
+
+    if (node->getOp() == Op::LogicalAnd || node->getOp() == Op::LogicalOr) {
+        // Cortocircuito: el operando derecho solo se evalúa si hace falta
+        uint32_t result = allocate();
+        compileInto(node->getLeft(), result);
+        emit({OpCode::ToBool, 0, 0, result, result});
+        size_t shortCircuit = emit({node->getOp() == Op::LogicalAnd ? OpCode::JumpIfFalse : OpCode::JumpIfTrue,
+                                    0, 0, result});
+        compileInto(node->getRight(), result);
+        emit({OpCode::ToBool, 0, 0, result, result});
+        patchJump(shortCircuit, function_->code.size());
+        emit({OpCode::Move, 0, 0, dst, result});
+        top_ = mark;
+        return;
+    }
+
+    uint32_t left = compileOperand(node->getLeft());
+    uint32_t right = compileOperand(node->getRight());
+    emit({OpCode::Binary, static_cast<uint8_t>(node->getOp()), 0, dst, left, right});
+    top_ = mark;
+}
+
+void BytecodeCompiler::compileAssignment(const ast::Assignment* node, uint32_t dst) {
+    const ast::ASTNode* target = node->getLeft();
+    if (!target || target->getKind() != ast::ASTNodeKind::Identifier) {
+        fail("Solo se admite asignar a variables locales en constexpr");
+        return;
+    }
+
+    auto name = static_cast<const ast::Identifier*>(target)->getName();
+    const LocalVariable* variable = lookup(name);
+    if (!variable) {
+        fail("'" + std::string(name) + "' no es una variable utilizable en constexpr");
+        return;
+    }
+    if (variable->isConst) {
+        fail("Asignación a la variable const '" + std::string(name) + "'");
+        return;
+    }
+    uint32_t reg = variable->reg;
+
+    uint32_t mark = top_;
+    if (auto op = binaryOpFor(node->getOp())) {
+        uint32_t right = compileOperand(node->getRight());
+        emit({OpCode::Binary, static_cast<uint8_t>(*op), 0, reg, reg, right});
+    } else {
+        // Por un temporal: el lado derecho puede leer la propia variable
+        uint32_t value = compileOperand(node->getRight());
+        if (value != reg) {
+            emit({OpCode::Move, 0, 0, reg, value});
+        }
+    }
+    top_ = mark;
+
+    if (dst != reg) {
+        emit({OpCode::Move, 0, 0, dst, reg});
+    }
+}
+
+void BytecodeCompiler::compileTernary(const ast::TernaryOp* node, uint32_t dst) {
+    uint32_t mark = top_;
+    uint32_t condition = compileOperand(node->getCondition());
+    top_ = mark;
+    size_t jumpToFalse = emit({OpCode::JumpIfFalse, 0, 0, condition});
+
+    compileInto(node->getTrueExpr(), dst);
+    size_t jumpToEnd = emit({OpCode::Jump});
+    patchJump(jumpToFalse, function_->code.size());
+    compileInto(node->getFalseExpr(), dst);
+    patchJump(jumpToEnd, function_->code.size());
+}
+
+void BytecodeCompiler::compileCall(const ast::FunctionCall* node, uint32_t dst) {
+    const ast::ASTNode* callee = node->getCallee();
+    if (!callee || callee->getKind() != ast::ASTNodeKind::Identifier) {
+        fail("Solo se admiten llamadas directas a funciones constexpr");
+        return;
+    }
+
+    auto name = static_cast<const ast::Identifier*>(callee)->getName();
+    std::optional<uint32_t> index = resolver_ ? resolver_(name) : std::nullopt;
+    if (!index) {
+        fail("'" + std::string(name) + "' no es una función constexpr conocida");
+        return;
+    }
+
+    // Los argumentos van en registros consecutivos
+    uint32_t mark = top_;
+    uint32_t base = top_;
+    auto arguments = node->getArguments();
+    for (size_t i = 0; i < arguments.size(); ++i) {
+        allocate();
+    }
+    for (size_t i = 0; i < arguments.size(); ++i) {
+        compileInto(arguments[i], base + static_cast<uint32_t>(i));
+    }
+
+    emit({OpCode::Call, 0, static_cast<uint16_t>(arguments.size()), dst, *index, base});
+    top_ = mark;
+}
+
+} // namespace cpp20::compiler::constexpr_eval
@@ -4,7 +4,20 @@
  */
 
 #include <compiler/constexpr/ConstexprEvaluator.h>
+#include <compiler/constexpr/ConstexprBytecode.h>
+#include <compiler/constexpr/ConstexprJIT.h>
+#include <compiler/ast/ASTVisitor.h>
+#include <compiler/ast/DeclarationAST.h>
+#include <compiler/common/TimingProfiler.h>
+#include <compiler/common/utils/HashUtils.h>
+#include <compiler/common/utils/ThreadPool.h>
+#include <algorithm>
+#include <bit>
 #include <chrono>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <unordered_set>
 
 namespace cpp20::compiler::constexpr_eval {
 
@@ -12,6 +25,55 @@ namespace cpp20::compiler::constexpr_eval {
 // ConstexprValue - Implementación
 // ============================================================================
 
+const std::string& ConstexprValue::asString() const {
+    static const std::string empty;
+    return isString() ? *stringValue_ : empty;
+}
+
+const std::string* ConstexprValue::internString(std::string_view text) {
+    // Nodos de unordered_set: las direcciones no cambian al crecer
+    static std::mutex mutex;
+    static std::unordered_set<std::string> strings;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return &*strings.emplace(text).first;
+}
+
+bool ConstexprValue::identical(const ConstexprValue& other) const {
+    if (type_ != other.type_) {
+        return false;
+    }
+    switch (type_) {
+        case ValueType::Integer: return intValue_ == other.intValue_;
+        case ValueType::Boolean: return boolValue_ == other.boolValue_;
+        case ValueType::Character: return charValue_ == other.charValue_;
+        case ValueType::FloatingPoint:
+            return std::bit_cast<uint64_t>(doubleValue_) == std::bit_cast<uint64_t>(other.doubleValue_);
+        case ValueType::String: return stringValue_ == other.stringValue_;
+        case ValueType::Pointer:
+        case ValueType::Reference: return handleValue_ == other.handleValue_;
+        case ValueType::Nullptr:
+        case ValueType::Uninitialized: return true;
+    }
+    return false;
+}
+
+uint64_t ConstexprValue::hash() const {
+    uint64_t payload = 0;
+    switch (type_) {
+        case ValueType::Integer: payload = static_cast<uint64_t>(static_cast<int64_t>(intValue_)); break;
+        case ValueType::Boolean: payload = boolValue_; break;
+        case ValueType::Character: payload = static_cast<uint8_t>(charValue_); break;
+        case ValueType::FloatingPoint: payload = std::bit_cast<uint64_t>(doubleValue_); break;
+        case ValueType::String: payload = reinterpret_cast<uintptr_t>(stringValue_); break;
+        case ValueType::Pointer:
+        case ValueType::Reference: payload = handleValue_; break;
+        case ValueType::Nullptr:
+        case ValueType::Uninitialized: break;
+    }
+    return common::utils::hashMix(static_cast<uint64_t>(type_), payload);
+}
+
 std::string ConstexprValue::toString() const {
     switch (type_) {
         case ValueType::Integer:
@@ -23,13 +85,13 @@ std::string ConstexprValue::toString() const {
         case ValueType::FloatingPoint:
             return std::to_string(doubleValue_);
         case ValueType::String:
-            return "\"" + stringValue_ + "\"";
+            return "\"" + *stringValue_ + "\"";
         case ValueType::Pointer:
-            return "<pointer>";
+            return "<pointer #" + std::to_string(handleValue_) + ">";
         case ValueType::Nullptr:
             return "nullptr";
         case ValueType::Reference:
-            return "<reference>";
+            return "<reference #" + std::to_string(handleValue_) + ">";
         case ValueType::Uninitialized:
             return "<uninitialized>";
         default:
@@ -41,140 +103,462 @@ std::string ConstexprValue::toString() const {
 // EvaluationScope - Implementación
 // ============================================================================
 
-void EvaluationScope::declareVariable(const std::string& name, const ConstexprValue& value, bool isConst) {
+size_t EvaluationScope::pushScope(size_t slotCount) {
+    scopes_.push_back(ScopeRecord{top_, bindings_.size()});
+    reserveTo(top_ + slotCount);
+    top_ += slotCount;
+    return scopes_.back().base;
+}
+
+void EvaluationScope::popScope() {
     if (scopes_.empty()) {
-        pushScope();
+        return;
     }
-    scopes_.back()[name] = ConstexprVariable(name, value, isConst);
+    top_ = scopes_.back().base;
+    bindings_.resize(scopes_.back().bindingsBegin);
+    scopes_.pop_back();
 }
 
-bool EvaluationScope::hasVariable(const std::string& name) const {
-    for (auto it = scopes_.rbegin(); it != scopes_.rend(); ++it) {
-        if (it->find(name) != it->end()) {
-            return true;
-        }
+uint32_t EvaluationScope::declareVariable(const std::string& name, const ConstexprValue& value, bool isConst) {
+    if (scopes_.empty()) {
+        pushScope();
     }
-    return false;
+    size_t slot = top_++;
+    reserveTo(top_);
+    values_[slot] = value;
+    bindings_.push_back(Binding{name, slot, isConst});
+    return static_cast<uint32_t>(slot - scopes_.back().base);
 }
 
-const ConstexprVariable* EvaluationScope::getVariable(const std::string& name) const {
-    for (auto it = scopes_.rbegin(); it != scopes_.rend(); ++it) {
-        auto varIt = it->find(name);
-        if (varIt != it->end()) {
-            return &varIt->second;
+std::optional<VariableSlot> EvaluationScope::resolve(std::string_view name) const {
+    const Binding* binding = findBinding(name);
+    if (!binding) {
+        return std::nullopt;
+    }
+    for (size_t i = scopes_.size(); i-- > 0;) {
+        if (binding->slot >= scopes_[i].base) {
+            return VariableSlot{static_cast<uint32_t>(scopes_.size() - 1 - i),
+                                static_cast<uint32_t>(binding->slot - scopes_[i].base)};
         }
     }
-    return nullptr;
+    return std::nullopt;
+}
+
+const ConstexprValue* EvaluationScope::getVariable(const std::string& name) const {
+    const Binding* binding = findBinding(name);
+    return binding ? &values_[binding->slot] : nullptr;
 }
 
 bool EvaluationScope::updateVariable(const std::string& name, const ConstexprValue& value) {
-    for (auto it = scopes_.rbegin(); it != scopes_.rend(); ++it) {
-        auto varIt = it->find(name);
-        if (varIt != it->end()) {
-            if (!varIt->second.isConst) {
-                varIt->second.value = value;
-                varIt->second.isInitialized = true;
-                return true;
-            }
-            return false; // Variable es const
-        }
+    const Binding* binding = findBinding(name);
+    if (!binding || binding->isConst) {
+        return false;
     }
-    return false; // Variable no encontrada
+    values_[binding->slot] = value;
+    return true;
 }
 
-void EvaluationScope::pushScope() {
-    scopes_.emplace_back();
+void EvaluationScope::clear() {
+    scopes_.clear();
+    bindings_.clear();
+    top_ = 0;
 }
 
-void EvaluationScope::popScope() {
-    if (!scopes_.empty()) {
-        scopes_.pop_back();
+void EvaluationScope::reserveTo(size_t size) {
+    if (values_.size() < size) {
+        values_.resize(std::max(size, values_.size() * 2));
     }
 }
 
+const EvaluationScope::Binding* EvaluationScope::findBinding(std::string_view name) const {
+    for (auto it = bindings_.rbegin(); it != bindings_.rend(); ++it) {
+        if (it->name == name) {
+            return &*it;
+        }
+    }
+    return nullptr;
+}
+
 // ============================================================================
 // AbstractMemory - Implementación
 // ============================================================================
 
-size_t AbstractMemory::allocate(const std::string& type, size_t size) {
-    size_t address = nextAddress_++;
-    objects_[address] = std::make_unique<MemoryObject>(type, size);
+AbstractMemory::AbstractMemory()
+    : pool_(16 * 1024) {
+}
+
+size_t AbstractMemory::allocate(std::string_view type, size_t size) {
+    uint32_t index;
+    if (firstFree_ != 0) {
+        index = firstFree_ - 1;
+        firstFree_ = slots_[index].nextFree;
+    } else {
+        index = static_cast<uint32_t>(slots_.size());
+        slots_.emplace_back();
+    }
+
+    Slot& slot = slots_[index];
+    slot.live = true;
+    slot.object.type = *ConstexprValue::internString(type);
+    slot.object.size = size;
+    slot.object.isInitialized = false;
+    slot.object.data = size ? static_cast<char*>(pool_.allocate(size)) : nullptr;
+    if (slot.object.data) {
+        std::memset(slot.object.data, 0, size);
+    }
+
+    ++liveObjects_;
     totalAllocated_ += size;
-    return address;
+    return makeHandle(index, slot.generation);
 }
 
 bool AbstractMemory::deallocate(size_t address) {
-    auto it = objects_.find(address);
-    if (it != objects_.end()) {
-        totalAllocated_ -= it->second->size;
-        objects_.erase(it);
-        return true;
+    const Slot* found = resolve(address);
+    if (!found) {
+        return false;
     }
-    return false;
+
+    uint32_t index = static_cast<uint32_t>(found - slots_.data());
+    Slot& slot = slots_[index];
+    pool_.deallocate(slot.object.data, slot.object.size);
+    totalAllocated_ -= slot.object.size;
+    --liveObjects_;
+
+    slot.live = false;
+    slot.object = MemoryObject{};
+    ++slot.generation;
+    slot.nextFree = firstFree_;
+    firstFree_ = index + 1;
+    return true;
 }
 
 AbstractMemory::MemoryObject* AbstractMemory::getObject(size_t address) {
-    auto it = objects_.find(address);
-    return it != objects_.end() ? it->second.get() : nullptr;
+    const Slot* slot = resolve(address);
+    return slot ? &slots_[static_cast<size_t>(slot - slots_.data())].object : nullptr;
 }
 
 const AbstractMemory::MemoryObject* AbstractMemory::getObject(size_t address) const {
-    auto it = objects_.find(address);
-    return it != objects_.end() ? it->second.get() : nullptr;
+    const Slot* slot = resolve(address);
+    return slot ? &slot->object : nullptr;
+}
+
+std::vector<size_t> AbstractMemory::liveObjects() const {
+    std::vector<size_t> live;
+    live.reserve(liveObjects_);
+    for (size_t i = 0; i < slots_.size() && live.size() < liveObjects_; ++i) {
+        if (slots_[i].live) {
+            live.push_back(makeHandle(static_cast<uint32_t>(i), slots_[i].generation));
+        }
+    }
+    return live;
 }
 
 void AbstractMemory::clear() {
-    objects_.clear();
-    nextAddress_ = 1;
+    // Handles de evaluaciones anteriores no deben resolver tras el reset
+    firstFree_ = 0;
+    for (size_t i = slots_.size(); i-- > 0;) {
+        Slot& slot = slots_[i];
+        if (slot.live) {
+            slot.live = false;
+            slot.object = MemoryObject{};
+            ++slot.generation;
+        }
+        slot.nextFree = firstFree_;
+        firstFree_ = static_cast<uint32_t>(i) + 1;
+    }
+    pool_.reset();
+    liveObjects_ = 0;
     totalAllocated_ = 0;
 }
 
+const AbstractMemory::Slot* AbstractMemory::resolve(size_t address) const {
+    size_t index = (address & 0xffffffffu);
+    if (index == 0 || index > slots_.size()) {
+        return nullptr;
+    }
+    const Slot& slot = slots_[index - 1];
+    if (!slot.live || slot.generation != static_cast<uint32_t>(address >> 32)) {
+        return nullptr;
+    }
+    return &slot;
+}
+
 // ============================================================================
 // ConstexprVM - Implementación
 // ============================================================================
 
+namespace {
+
+/**
+ * @brief Valor entero de int, bool o char (promoción integral)
+ */
+std::optional<int64_t> integralValue(const ConstexprValue& value) {
+    switch (value.getType()) {
+        case ConstexprValue::ValueType::Integer: return value.asInteger();
+        case ConstexprValue::ValueType::Boolean: return value.asBoolean() ? 1 : 0;
+        case ConstexprValue::ValueType::Character: return value.asCharacter();
+        default: return std::nullopt;
+    }
+}
+
+std::optional<double> floatingValue(const ConstexprValue& value) {
+    if (value.isFloatingPoint()) {
+        return value.asFloatingPoint();
+    }
+    if (auto integral = integralValue(value)) {
+        return static_cast<double>(*integral);
+    }
+    return std::nullopt;
+}
+
+bool truthValue(const ConstexprValue& value, bool& result, std::string& error) {
+    if (value.isFloatingPoint()) {
+        result = value.asFloatingPoint() != 0.0;
+        return true;
+    }
+    if (value.isNullptr()) {
+        result = false;
+        return true;
+    }
+    if (auto integral = integralValue(value)) {
+        result = *integral != 0;
+        return true;
+    }
+    error = value.isUninitialized() ? "Lectura de una variable no inicializada"
+                                    : "El valor " + value.toString() + " no es convertible a bool";
+    return false;
+}
+
+bool integerResult(int64_t value, ConstexprValue& result, std::string& error) {
+    if (value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max()) {
+        error = "Desbordamiento aritmético en expresión constexpr";
+        return false;
+    }
+    result = ConstexprValue(static_cast<int>(value));
+    return true;
+}
+
+bool applyBinary(ast::BinaryOp::OpKind op, const ConstexprValue& left, const ConstexprValue& right,
+                 ConstexprValue& result, std::string& error) {
+    using Op = ast::BinaryOp::OpKind;
+
+    if (left.isUninitialized() || right.isUninitialized()) {
+        error = "Lectura de una variable no inicializada";
+        return false;
+    }
+
+    if (left.isString() || right.isString()) {
+        if (left.isString() && right.isString() && (op == Op::Equal || op == Op::NotEqual)) {
+            result = ConstexprValue((left.asString() == right.asString()) == (op == Op::Equal));
+            return true;
+        }
+        error = std::string("Operador '") + ast::BinaryOp::opSpelling(op) + "' no soportado sobre cadenas";
+        return false;
+    }
+
+    if (left.isFloatingPoint() || right.isFloatingPoint()) {
+        auto l = floatingValue(left);
+        auto r = floatingValue(right);
+        if (!l || !r) {
+            error = std::string("Operandos no aritméticos para '") + ast::BinaryOp::opSpelling(op) + "'";
+            return false;
+        }
+        switch (op) {
+            case Op::Add: result = ConstexprValue(*l + *r); return true;
+            case Op::Subtract: result = ConstexprValue(*l - *r); return true;
+            case Op::Multiply: result = ConstexprValue(*l * *r); return true;
+            case Op::Divide:
+                if (*r == 0.0) {
+                    error = "División por cero en expresión constexpr";
+                    return false;
+                }
+                result = ConstexprValue(*l / *r);
+                return true;
+            case Op::Equal: result = ConstexprValue(*l == *r); return true;
+            case Op::NotEqual: result = ConstexprValue(*l != *r); return true;
+            case Op::Less: result = ConstexprValue(*l < *r); return true;
+            case Op::LessEqual: result = ConstexprValue(*l <= *r); return true;
+            case Op::Greater: result = ConstexprValue(*l > *r); return true;
+            case Op::GreaterEqual: result = ConstexprValue(*l >= *r); return true;
+            default:
+                error = std::string("Operador '") + ast::BinaryOp::opSpelling(op) + "' no válido con coma flotante";
+                return false;
+        }
+    }
+
+    auto l = integralValue(left);
+    auto r = integralValue(right);
+    if (!l || !r) {
+        error = std::string("Operandos no aritméticos para '") + ast::BinaryOp::opSpelling(op) + "'";
+        return false;
+    }
+
+    // int64 tiene margen para cualquier operación entre dos int
+    switch (op) {
+        case Op::Add: return integerResult(*l + *r, result, error);
+        case Op::Subtract: return integerResult(*l - *r, result, error);
+        case Op::Multiply: return integerResult(*l * *r, result, error);
+        case Op::Divide:
+        case Op::Modulo:
+            if (*r == 0) {
+                error = "División por cero en expresión constexpr";
+                return false;
+            }
+            return integerResult(op == Op::Divide ? *l / *r : *l % *r, result, error);
+        case Op::Equal: result = ConstexprValue(*l == *r); return true;
+        case Op::NotEqual: result = ConstexprValue(*l != *r); return true;
+        case Op::Less: result = ConstexprValue(*l < *r); return true;
+        case Op::LessEqual: result = ConstexprValue(*l <= *r); return true;
+        case Op::Greater: result = ConstexprValue(*l > *r); return true;
+        case Op::GreaterEqual: result = ConstexprValue(*l >= *r); return true;
+        case Op::LogicalAnd: result = ConstexprValue(*l != 0 && *r != 0); return true;
+        case Op::LogicalOr: result = ConstexprValue(*l != 0 || *r != 0); return true;
+        case Op::BitwiseAnd: return integerResult(*l & *r, result, error);
+        case Op::BitwiseOr: return integerResult(*l | *r, result, error);
+        case Op::BitwiseXor: return integerResult(*l ^ *r, result, error);
+        case Op::LeftShift:
+        case Op::RightShift:
+            if (*r < 0 || *r >= std::numeric_limits<int>::digits + 1) {
+                error = "Desplazamiento fuera de rango en expresión constexpr";
+                return false;
+            }
+            if (op == Op::LeftShift) {
+                if (*l < 0) {
+                    error = "Desplazamiento a la izquierda de un valor negativo";
+                    return false;
+                }
+                return integerResult(*l << *r, result, error);
+            }
+            return integerResult(*l >> *r, result, error);
+    }
+    error = "Operador binario desconocido";
+    return false;
+}
+
+bool applyUnary(ast::UnaryOp::OpKind op, const ConstexprValue& operand,
+                ConstexprValue& result, std::string& error) {
+    using Op = ast::UnaryOp::OpKind;
+
+    if (op == Op::Not) {
+        bool truth = false;
+        if (!truthValue(operand, truth, error)) {
+            return false;
+        }
+        result = ConstexprValue(!truth);
+        return true;
+    }
+
+    if (operand.isFloatingPoint() && (op == Op::Plus || op == Op::Minus)) {
+        result = ConstexprValue(op == Op::Minus ? -operand.asFloatingPoint() : operand.asFloatingPoint());
+        return true;
+    }
+
+    auto value = integralValue(operand);
+    if (!value) {
+        error = operand.isUninitialized() ? "Lectura de una variable no inicializada"
+                                          : std::string("Operando no válido para '") +
+                                                ast::UnaryOp::opSpelling(op) + "'";
+        return false;
+    }
+    switch (op) {
+        case Op::Plus: return integerResult(*value, result, error);
+        case Op::Minus: return integerResult(-*value, result, error);
+        case Op::BitwiseNot: return integerResult(~*value, result, error);
+        default:
+            error = "Punteros no soportados en constexpr";
+            return false;
+    }
+}
+
+} // namespace
+
 ConstexprVM::ConstexprVM(diagnostics::DiagnosticEngine& diagEngine)
     : diagEngine_(diagEngine) {
-    scope_.pushScope(); // Scope global
 }
 
 ConstexprVM::~ConstexprVM() = default;
 
 EvaluationContext ConstexprVM::evaluate(const ast::ASTNode* expression,
                                        const std::unordered_map<std::string, ConstexprValue>& parameters) {
-    // Configurar parámetros como variables
+    // Orden estable de registros: los parámetros ordenados por nombre
+    std::vector<std::string> names;
+    names.reserve(parameters.size());
     for (const auto& [name, value] : parameters) {
-        scope_.declareVariable(name, value);
+        names.push_back(name);
     }
+    std::sort(names.begin(), names.end());
 
-    currentRecursion_ = 0;
-    stats_.stepsExecuted = 0;
+    std::string error;
+    BytecodeCompiler compiler([this](std::string_view name) { return resolveFunction(name); });
+    auto code = compiler.compileStandalone(expression, names, error);
+    if (!code) {
+        stats_.evaluationsPerformed++;
+        stats_.errors++;
+        return EvaluationContext(EvaluationResult::NotConstexpr, error);
+    }
 
-    auto result = evaluateExpression(expression);
+    std::vector<ConstexprValue> arguments;
+    arguments.reserve(names.size());
+    for (const std::string& name : names) {
+        arguments.push_back(parameters.at(name));
+    }
+    return execute(code.get(), arguments);
+}
 
-    // Actualizar estadísticas
-    stats_.evaluationsPerformed++;
-    if (currentRecursion_ > stats_.maxRecursionDepth) {
-        stats_.maxRecursionDepth = currentRecursion_;
+void ConstexprVM::registerFunction(const std::string& name, const ast::FunctionDecl* function) {
+    auto [it, inserted] = functionIndex_.try_emplace(name, static_cast<uint32_t>(functions_.size()));
+    if (inserted) {
+        functions_.emplace_back();
     }
-    if (memory_.getTotalAllocated() > stats_.memoryPeak) {
-        stats_.memoryPeak = memory_.getTotalAllocated();
+    FunctionEntry& entry = functions_[it->second];
+    if (entry.decl != function) {
+        entry.decl = function;
+        entry.code.reset();
+        entry.native.reset();
+        entry.calls = 0;
+        entry.nativeRejected = false;
+        // Las llamadas memoizadas pueden haber pasado por la declaración anterior
+        memo_.clear();
+        stats_.memoEntries = 0;
     }
+}
 
-    return result;
+EvaluationContext ConstexprVM::call(const std::string& name, const std::vector<ConstexprValue>& arguments) {
+    auto index = resolveFunction(name);
+    if (!index) {
+        stats_.errors++;
+        return EvaluationContext(EvaluationResult::NotConstexpr,
+                                 "'" + name + "' no es una función constexpr registrada");
+    }
+
+    std::string error;
+    const BytecodeFunction* function = compiledFunction(*index, error);
+    if (!function) {
+        stats_.errors++;
+        return EvaluationContext(EvaluationResult::NotConstexpr, error);
+    }
+    if (arguments.size() != function->parameterCount) {
+        stats_.errors++;
+        return createError("Número de argumentos incorrecto en la llamada a '" + name + "'");
+    }
+    return execute(function, arguments, *index);
 }
 
 bool ConstexprVM::isValidConstexpr(const ast::ASTNode* expression,
                                   std::string& errorMessage) {
-    // Implementación simplificada - verificar estructura básica
     if (!expression) {
         errorMessage = "Expresión nula";
         return false;
     }
 
-    // Aquí iría verificación detallada según reglas de [expr.const]
-    // Por ahora, asumimos que es válido si no es nullptr
-    return true;
+    BytecodeCompiler compiler([this](std::string_view name) { return resolveFunction(name); });
+    std::unique_ptr<BytecodeFunction> code;
+    if (expression->getKind() == ast::ASTNodeKind::FunctionDecl) {
+        code = compiler.compileFunction(static_cast<const ast::FunctionDecl*>(expression), errorMessage);
+    } else {
+        code = compiler.compileStandalone(expression, {}, errorMessage);
+    }
+    return code != nullptr;
 }
 
 void ConstexprVM::setLimits(size_t maxSteps, size_t maxRecursion, size_t maxMemory) {
@@ -184,176 +568,331 @@ void ConstexprVM::setLimits(size_t maxSteps, size_t maxRecursion, size_t maxMemo
 }
 
 void ConstexprVM::clear() {
-    scope_ = EvaluationScope();
     memory_.clear();
-    scope_.pushScope();
-    currentRecursion_ = 0;
+    functions_.clear();
+    functionIndex_.clear();
+    scope_.clear();
+    frames_.clear();
+    memo_.clear();
+    memoArguments_.clear();
+    stats_.memoEntries = 0;
 }
 
-EvaluationContext ConstexprVM::evaluateExpression(const ast::ASTNode* node) {
-    if (node == nullptr) {
-        return createError("Expresión nula");
+const BytecodeFunction* ConstexprVM::compiledFunction(uint32_t index, std::string& error) {
+    FunctionEntry& entry = functions_[index];
+    if (!entry.code) {
+        BytecodeCompiler compiler([this](std::string_view name) { return resolveFunction(name); });
+        entry.code = compiler.compileFunction(entry.decl, error);
+        if (!entry.code) {
+            return nullptr;
+        }
+        stats_.functionsCompiled++;
     }
+    return entry.code.get();
+}
 
-    if (!checkLimits()) {
-        return EvaluationContext(EvaluationResult::Timeout);
+std::optional<uint32_t> ConstexprVM::resolveFunction(std::string_view name) const {
+    auto it = functionIndex_.find(std::string(name));
+    if (it == functionIndex_.end()) {
+        return std::nullopt;
     }
+    return it->second;
+}
 
-    incrementSteps();
-
-    switch (node->getKind()) {
-        case ast::ASTNodeKind::BinaryOp:
-            return evaluateBinaryOp(node);
-
-        case ast::ASTNodeKind::Identifier:
-            return evaluateVariable(node);
+EvaluationContext ConstexprVM::execute(const BytecodeFunction* function,
+                                       const std::vector<ConstexprValue>& arguments,
+                                       uint32_t index) {
+    stats_.evaluationsPerformed++;
 
-        // Literales básicos soportados
-        case ast::ASTNodeKind::IntegerLiteral:
-        case ast::ASTNodeKind::BooleanLiteral:
-        case ast::ASTNodeKind::CharacterLiteral:
-        case ast::ASTNodeKind::FloatingPointLiteral:
-        case ast::ASTNodeKind::StringLiteral:
-        case ast::ASTNodeKind::Literal:
-            return evaluateLiteral(node);
+    bool memoize = index != NoFunction && function->pure;
+    if (memoize) {
+        if (const ConstexprValue* known = findMemo(index, arguments.data(), arguments.size())) {
+            EvaluationContext result;
+            result.value = *known;
+            return result;
+        }
+    }
+    if (index != NoFunction) {
+        EvaluationContext result;
+        if (callNative(index, arguments.data(), arguments.size(), result.value)) {
+            return result;
+        }
+    }
 
-        default:
-            // Para tipos no soportados, devolver error
-            return createError("Tipo de expresión no soportado en constexpr");
+    scope_.clear();
+    scope_.pushScope(function->registerCount);
+    std::copy(arguments.begin(), arguments.end(), scope_.frame());
+    frames_.clear();
+    memoArguments_.assign(arguments.begin(), arguments.end());
+    frames_.push_back(Frame{function, 0, 0, index, 0, memoize});
+
+    // Coste por función constexpr, solo si alguien lo está acumulando
+    TimingProfiler* profiler = TimingProfiler::active();
+    if (profiler && !profiler->isTrackingEntities()) {
+        profiler = nullptr;
+    }
+    if (profiler) {
+        frames_.back().startTicks = TimingProfiler::now();
     }
-}
 
-EvaluationContext ConstexprVM::evaluateLiteral(const ast::ASTNode* node) {
+    size_t steps = 0;
+    std::string error;
     EvaluationContext result;
 
-    // Implementación simplificada - en un compilador real esto sería más complejo
-    switch (node->getKind()) {
-        case ast::ASTNodeKind::IntegerLiteral:
-            result.value = ConstexprValue(42); // Valor dummy
-            break;
-        case ast::ASTNodeKind::BooleanLiteral:
-            result.value = ConstexprValue(true); // Valor dummy
-            break;
-        case ast::ASTNodeKind::CharacterLiteral:
-            result.value = ConstexprValue('a'); // Valor dummy
-            break;
-        case ast::ASTNodeKind::FloatingPointLiteral:
-            result.value = ConstexprValue(3.14); // Valor dummy
-            break;
-        case ast::ASTNodeKind::StringLiteral:
-            result.value = ConstexprValue("hello"); // Valor dummy
-            break;
-        case ast::ASTNodeKind::Literal:
-            result.value = ConstexprValue(0); // Valor dummy genérico
-            break;
-        default:
-            return createError("Literal no soportado");
-    }
+    auto finish = [&](EvaluationContext context) {
+        // C++20: lo asignado durante la evaluación debe liberarse en ella
+        stats_.memoryPeak = std::max(stats_.memoryPeak, memory_.getTotalAllocated());
+        if (context.result == EvaluationResult::Success && memory_.getLiveObjectCount() != 0) {
+            context = createError("La evaluación constexpr termina con " +
+                                  std::to_string(memory_.getLiveObjectCount()) +
+                                  " objetos asignados sin liberar");
+            for (size_t handle : memory_.liveObjects()) {
+                const AbstractMemory::MemoryObject* object = memory_.getObject(handle);
+                context.diagnosticNotes.push_back("objeto de tipo '" + std::string(object->type) +
+                                                  "' (" + std::to_string(object->size) + " bytes)");
+            }
+        }
+        memory_.clear();
 
-    return result;
-}
+        context.stepsExecuted = steps;
+        stats_.stepsExecuted += steps;
+        if (context.result != EvaluationResult::Success) {
+            stats_.errors++;
+        }
+        frames_.clear();
+        scope_.clear();
+        memoArguments_.clear();
+        return context;
+    };
+
+    // Devuelve un valor al llamador; false cuando termina la evaluación
+    auto returnValue = [&](ConstexprValue value) {
+        const Frame finished = frames_.back();
+        frames_.pop_back();
+        scope_.popScope();
+
+        // Los argumentos se copiaron al entrar: el cuerpo puede modificar sus parámetros
+        if (finished.memoize && memo_.size() < MaxMemoEntries) {
+            auto first = memoArguments_.begin() + static_cast<std::ptrdiff_t>(finished.memoBase);
+            memo_.emplace(MemoKey{finished.index, std::vector<ConstexprValue>(first, memoArguments_.end())}, value);
+            stats_.memoEntries = memo_.size();
+        }
+        if (finished.index != NoFunction) {
+            memoArguments_.resize(finished.memoBase);
+        }
+        if (!finished.memoize && !frames_.empty()) {
+            frames_.back().memoize = false;
+        }
+        if (profiler && finished.index != NoFunction) {
+            uint64_t elapsed = TimingProfiler::now() - finished.startTicks;
+            profiler->recordEntity(CompilationPhase::ConstexprEvaluation, finished.function->name, elapsed,
+                                   elapsed - std::min(elapsed, finished.childTicks));
+            if (!frames_.empty()) {
+                frames_.back().childTicks += elapsed;
+            }
+        }
 
-EvaluationContext ConstexprVM::evaluateBinaryOp(const ast::ASTNode* node) {
-    // Implementación simplificada de operadores binarios
-    // En un compilador real, esto evaluaría los operandos izquierdo y derecho
-    // y aplicaría el operador correspondiente
+        uint32_t target = finished.result;
+        if (frames_.empty()) {
+            result.value = value;
+            return false;
+        }
+        scope_.frame()[target] = value;
+        return true;
+    };
 
-    EvaluationContext result;
-    result.value = ConstexprValue(0); // Resultado dummy
-    return result;
-}
+    while (true) {
+        if (++steps > maxSteps_) {
+            return finish(EvaluationContext(EvaluationResult::Timeout,
+                                            "Se superó el límite de " + std::to_string(maxSteps_) +
+                                                " pasos de evaluación"));
+        }
 
-EvaluationContext ConstexprVM::evaluateUnaryOp(const ast::ASTNode* node) {
-    // Implementación simplificada de operadores unarios
-    EvaluationContext result;
-    result.value = ConstexprValue(0); // Resultado dummy
-    return result;
-}
+        Frame& frame = frames_.back();
+        const Instruction& instruction = frame.function->code[frame.pc++];
+        ConstexprValue* r = scope_.frame();
+
+        switch (instruction.op) {
+            case OpCode::LoadConst:
+                r[instruction.a] = frame.function->constants[instruction.b];
+                break;
+
+            case OpCode::Move:
+                r[instruction.a] = r[instruction.b];
+                break;
+
+            case OpCode::Binary: {
+                ConstexprValue value;
+                if (!applyBinary(static_cast<ast::BinaryOp::OpKind>(instruction.kind),
+                                 r[instruction.b], r[instruction.c], value, error)) {
+                    return finish(createError(error));
+                }
+                r[instruction.a] = value;
+                break;
+            }
 
-EvaluationContext ConstexprVM::evaluateFunctionCall(const ast::ASTNode* node) {
-    // Implementación simplificada de llamadas a función
-    // En un compilador real, esto buscaría la función y evaluaría sus argumentos
+            case OpCode::Unary: {
+                ConstexprValue value;
+                if (!applyUnary(static_cast<ast::UnaryOp::OpKind>(instruction.kind),
+                                r[instruction.b], value, error)) {
+                    return finish(createError(error));
+                }
+                r[instruction.a] = value;
+                break;
+            }
 
-    EvaluationContext result;
-    result.value = ConstexprValue(0); // Resultado dummy
-    return result;
-}
+            case OpCode::ToBool: {
+                bool truth = false;
+                if (!truthValue(r[instruction.b], truth, error)) {
+                    return finish(createError(error));
+                }
+                r[instruction.a] = ConstexprValue(truth);
+                break;
+            }
 
-EvaluationContext ConstexprVM::evaluateVariable(const ast::ASTNode* node) {
-    // Implementación simplificada de acceso a variables
-    EvaluationContext result;
+            case OpCode::Jump:
+                frame.pc = instruction.a;
+                break;
+
+            case OpCode::JumpIfFalse:
+            case OpCode::JumpIfTrue: {
+                bool truth = false;
+                if (!truthValue(r[instruction.a], truth, error)) {
+                    return finish(createError(error));
+                }
+                if (truth == (instruction.op == OpCode::JumpIfTrue)) {
+                    frame.pc = instruction.b;
+                }
+                break;
+            }
 
-    // Dummy - en un compilador real esto buscaría el nombre de la variable
-    // en el scope actual y devolvería su valor
-    result.value = ConstexprValue(42);
-    return result;
-}
+            case OpCode::Call: {
+                const BytecodeFunction* callee = compiledFunction(instruction.b, error);
+                if (!callee) {
+                    return finish(createError(error));
+                }
+                if (instruction.count != callee->parameterCount) {
+                    return finish(createError("Número de argumentos incorrecto en la llamada a '" +
+                                              callee->name + "'"));
+                }
+                if (frames_.size() >= maxRecursion_) {
+                    return finish(EvaluationContext(EvaluationResult::RecursionLimit,
+                                                    "Se superó el límite de " + std::to_string(maxRecursion_) +
+                                                        " llamadas anidadas"));
+                }
+
+                const ConstexprValue* arguments = r + instruction.c;
+                if (callee->pure) {
+                    if (const ConstexprValue* known = findMemo(instruction.b, arguments, instruction.count)) {
+                        r[instruction.a] = *known;
+                        break;
+                    }
+                }
+                if (callNative(instruction.b, arguments, instruction.count, r[instruction.a])) {
+                    break;
+                }
+                size_t memoBase = memoArguments_.size();
+                memoArguments_.insert(memoArguments_.end(), arguments, arguments + instruction.count);
+
+                // pushScope puede mover el almacenamiento: no usar r después
+                uint32_t target = instruction.a;
+                scope_.pushScope(callee->registerCount);
+                std::copy(memoArguments_.begin() + static_cast<std::ptrdiff_t>(memoBase), memoArguments_.end(),
+                          scope_.frame());
+                frames_.push_back(Frame{callee, 0, target, instruction.b, memoBase, callee->pure});
+                if (profiler) {
+                    frames_.back().startTicks = TimingProfiler::now();
+                }
+                stats_.maxRecursionDepth = std::max(stats_.maxRecursionDepth, frames_.size());
+                break;
+            }
 
-EvaluationContext ConstexprVM::evaluateAssignment(const ast::ASTNode* node) {
-    // Implementación simplificada de asignaciones
-    EvaluationContext result;
-    result.value = ConstexprValue(0); // Resultado dummy
-    return result;
+            case OpCode::Return:
+                if (!returnValue(r[instruction.a])) {
+                    return finish(std::move(result));
+                }
+                break;
+
+            case OpCode::ReturnVoid:
+                if (frame.function->returnsValue && !frame.function->name.empty()) {
+                    return finish(createError("La función '" + frame.function->name +
+                                              "' termina sin devolver un valor"));
+                }
+                if (!returnValue(ConstexprValue())) {
+                    return finish(std::move(result));
+                }
+                break;
+        }
+    }
 }
 
-EvaluationContext ConstexprVM::evaluateDeclaration(const ast::ASTNode* node) {
-    // Implementación simplificada de declaraciones
-    EvaluationContext result;
-    result.value = ConstexprValue(0); // Resultado dummy
-    return result;
+bool ConstexprVM::callNative(uint32_t index, const ConstexprValue* arguments, size_t count,
+                             ConstexprValue& result) {
+    FunctionEntry& entry = functions_[index];
+    if (!entry.native) {
+        if (entry.nativeRejected || jitThreshold_ == 0 || ++entry.calls < jitThreshold_) {
+            return false;
+        }
+        if (!jit_) {
+            jit_ = std::make_unique<ConstexprJIT>();
+        }
+        std::string reason;
+        entry.native = jit_->compile(*entry.code, reason);
+        if (!entry.native) {
+            entry.nativeRejected = true;
+            return false;
+        }
+        stats_.nativeCompilations++;
+    }
+
+    if (!entry.native->call(arguments, count, result)) {
+        stats_.nativeBailouts++;
+        return false;
+    }
+    stats_.nativeCalls++;
+    return true;
 }
 
-EvaluationContext ConstexprVM::evaluateIfConstexpr(const ast::ASTNode* node) {
-    // Implementación simplificada de if constexpr
-    EvaluationContext result;
-    result.value = ConstexprValue(0); // Resultado dummy
-    return result;
+const ConstexprValue* ConstexprVM::findMemo(uint32_t index, const ConstexprValue* arguments, size_t count) {
+    auto it = memo_.find(MemoKeyView{index, arguments, count});
+    if (it == memo_.end()) {
+        return nullptr;
+    }
+    stats_.memoHits++;
+    return &it->second;
 }
 
-EvaluationContext ConstexprVM::evaluateTernaryOp(const ast::ASTNode* node) {
-    // Implementación simplificada del operador ternario
-    EvaluationContext result;
-    result.value = ConstexprValue(0); // Resultado dummy
-    return result;
+size_t ConstexprVM::MemoHash::operator()(const MemoKey& key) const {
+    return (*this)(MemoEqual::view(key));
 }
 
-bool ConstexprVM::checkLimits() {
-    if (stats_.stepsExecuted >= maxSteps_) {
-        return false;
+size_t ConstexprVM::MemoHash::operator()(const MemoKeyView& key) const {
+    uint64_t hash = common::utils::mix64(key.function);
+    for (size_t i = 0; i < key.count; ++i) {
+        hash = common::utils::hashMix(hash, key.arguments[i].hash());
     }
-    if (currentRecursion_ >= maxRecursion_) {
+    return static_cast<size_t>(hash);
+}
+
+bool ConstexprVM::MemoEqual::operator()(const MemoKeyView& a, const MemoKeyView& b) const {
+    if (a.function != b.function || a.count != b.count) {
         return false;
     }
-    if (memory_.getTotalAllocated() >= maxMemory_) {
-        return false;
+    for (size_t i = 0; i < a.count; ++i) {
+        if (!a.arguments[i].identical(b.arguments[i])) {
+            return false;
+        }
     }
     return true;
 }
 
-void ConstexprVM::incrementSteps() {
-    stats_.stepsExecuted++;
-}
-
 EvaluationContext ConstexprVM::createError(const std::string& message,
                                           const std::vector<std::string>& notes) {
     EvaluationContext result(EvaluationResult::Error, message);
     result.diagnosticNotes = notes;
-    stats_.errors++;
     return result;
 }
 
-std::optional<ConstexprValue> ConstexprVM::getVariableValue(const std::string& name) {
-    const auto* var = scope_.getVariable(name);
-    if (var && var->isInitialized) {
-        return var->value;
-    }
-    return std::nullopt;
-}
-
-bool ConstexprVM::setVariableValue(const std::string& name, const ConstexprValue& value) {
-    return scope_.updateVariable(name, value);
-}
-
 // ============================================================================
 // ConstexprEvaluator - Implementación
 // ============================================================================
@@ -371,11 +910,16 @@ EvaluationContext ConstexprEvaluator::evaluateFunction(
 
     auto startTime = std::chrono::high_resolution_clock::now();
 
-    // Preparar contexto con argumentos
-    std::unordered_map<std::string, ConstexprValue> context;
-    // Dummy - en un compilador real esto mapearía nombres de parámetros a valores
-
-    auto result = vm_->evaluate(functionBody, context);
+    EvaluationContext result;
+    if (functionBody && functionBody->getKind() == ast::ASTNodeKind::FunctionDecl) {
+        registerConstexprFunction(functionName, functionBody);
+        result = vm_->call(functionName, arguments);
+    } else if (constexprFunctions_.count(functionName)) {
+        result = vm_->call(functionName, arguments);
+    } else {
+        // Cuerpo suelto sin parámetros con nombre
+        result = vm_->evaluate(functionBody);
+    }
 
     auto endTime = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
@@ -413,6 +957,124 @@ EvaluationContext ConstexprEvaluator::evaluateExpression(
     return result;
 }
 
+namespace {
+
+template<typename Func>
+void forEachIdentifier(const ast::ASTNode* node, Func&& func) {
+    if (node->getKind() == ast::ASTNodeKind::Identifier) {
+        func(static_cast<const ast::Identifier*>(node)->getName());
+    }
+    ast::forEachChild(const_cast<ast::ASTNode*>(node),
+                      [&func](ast::ASTNode* child) { forEachIdentifier(child, func); });
+}
+
+} // namespace
+
+std::vector<EvaluationContext> ConstexprEvaluator::evaluateInitializers(
+    const std::vector<ConstexprInitializer>& initializers,
+    size_t jobs) {
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    if (jobs == 0) {
+        jobs = common::utils::ThreadPool::defaultThreadCount();
+    }
+
+    // Oleada de cada inicializador: una más que la de la variable más tardía que usa
+    std::vector<std::vector<size_t>> dependencies(initializers.size());
+    std::vector<size_t> waveOf(initializers.size());
+    std::vector<std::vector<size_t>> waves;
+    std::unordered_map<std::string_view, size_t> declared;
+    for (size_t i = 0; i < initializers.size(); ++i) {
+        size_t wave = 0;
+        if (initializers[i].expression) {
+            forEachIdentifier(initializers[i].expression, [&](std::string_view name) {
+                auto it = declared.find(name);
+                if (it == declared.end() ||
+                    std::find(dependencies[i].begin(), dependencies[i].end(), it->second) != dependencies[i].end()) {
+                    return;
+                }
+                dependencies[i].push_back(it->second);
+            });
+        }
+        for (size_t dependency : dependencies[i]) {
+            wave = std::max(wave, waveOf[dependency] + 1);
+        }
+        if (wave == waves.size()) {
+            waves.emplace_back();
+        }
+        waveOf[i] = wave;
+        waves[wave].push_back(i);
+        if (!initializers[i].name.empty()) {
+            declared[initializers[i].name] = i;
+        }
+    }
+
+    // Un VM por hilo, conservado entre oleadas; el del hilo 0 es vm_
+    std::vector<EvaluationContext> results(initializers.size());
+    std::vector<std::unique_ptr<ConstexprVM>> workerVMs(jobs);
+    auto vmFor = [&](size_t worker) -> ConstexprVM& {
+        if (worker == 0) {
+            return *vm_;
+        }
+        if (!workerVMs[worker]) {
+            workerVMs[worker] = std::make_unique<ConstexprVM>(diagEngine_);
+            workerVMs[worker]->setLimits(maxSteps_, maxRecursion_, maxMemory_);
+            for (const auto& [name, decl] : constexprFunctions_) {
+                if (decl && decl->getKind() == ast::ASTNodeKind::FunctionDecl) {
+                    workerVMs[worker]->registerFunction(name, static_cast<const ast::FunctionDecl*>(decl));
+                }
+            }
+        }
+        return *workerVMs[worker];
+    };
+
+    auto evaluateOne = [&](ConstexprVM& vm, size_t i) {
+        const ConstexprInitializer& initializer = initializers[i];
+        std::unordered_map<std::string, ConstexprValue> parameters;
+        for (size_t dependency : dependencies[i]) {
+            if (results[dependency].result != EvaluationResult::Success) {
+                results[i] = EvaluationContext(EvaluationResult::NotConstexpr,
+                                               "Depende de '" + initializers[dependency].name +
+                                               "', que no es una constante");
+                return;
+            }
+            parameters.emplace(initializers[dependency].name, results[dependency].value);
+        }
+        results[i] = vm.evaluate(initializer.expression, parameters);
+        if (initializer.isStaticAssert && results[i].result == EvaluationResult::Success &&
+            !results[i].value.asBoolean()) {
+            results[i].result = EvaluationResult::Error;
+            results[i].errorMessage = "static_assert falló";
+        }
+    };
+
+    for (const std::vector<size_t>& wave : waves) {
+        size_t workers = std::min(jobs, wave.size());
+        for (size_t worker = 1; worker < workers; ++worker) {
+            vmFor(worker);      // Crearlos aquí: vmFor no es seguro en paralelo
+        }
+        common::utils::parallelFor(workers, workers, [&](size_t worker) {
+            ConstexprVM& vm = vmFor(worker);
+            for (size_t k = worker; k < wave.size(); k += workers) {
+                evaluateOne(vm, wave[k]);
+            }
+        });
+        ++stats_.initializerWaves;
+    }
+
+    for (const EvaluationContext& result : results) {
+        stats_.expressionsEvaluated++;
+        stats_.totalSteps += result.stepsExecuted;
+        if (result.result != EvaluationResult::Success) {
+            stats_.errors++;
+        }
+    }
+    auto endTime = std::chrono::high_resolution_clock::now();
+    stats_.timeSpentMs += std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
+
+    return results;
+}
+
 bool ConstexprEvaluator::isConstexprFunction(const ast::ASTNode* functionDecl,
                                             std::string& errorMessage) {
     return validateConstexprFunction(functionDecl, errorMessage);
@@ -426,20 +1088,21 @@ bool ConstexprEvaluator::isConstexprExpression(const ast::ASTNode* expression,
 void ConstexprEvaluator::registerConstexprFunction(const std::string& name,
                                                   const ast::ASTNode* functionDecl) {
     constexprFunctions_[name] = functionDecl;
+    if (functionDecl && functionDecl->getKind() == ast::ASTNodeKind::FunctionDecl) {
+        vm_->registerFunction(name, static_cast<const ast::FunctionDecl*>(functionDecl));
+    }
 }
 
 void ConstexprEvaluator::setLimits(size_t maxSteps, size_t maxRecursion, size_t maxMemory) {
+    maxSteps_ = maxSteps;
+    maxRecursion_ = maxRecursion;
+    maxMemory_ = maxMemory;
     vm_->setLimits(maxSteps, maxRecursion, maxMemory);
 }
 
 ConstexprEvaluator::EvaluatorStats ConstexprEvaluator::getStats() const {
-    EvaluatorStats combinedStats = stats_;
-
-    // Agregar estadísticas de la VM
-    auto vmStats = vm_->getStats();
-    combinedStats.totalSteps += vmStats.stepsExecuted;
-
-    return combinedStats;
+    // totalSteps ya acumula los pasos de cada evaluación
+    return stats_;
 }
 
 void ConstexprEvaluator::clear() {
@@ -459,13 +1122,8 @@ bool ConstexprEvaluator::validateConstexprFunction(const ast::ASTNode* functionD
         return false;
     }
 
-    // Aquí irían verificaciones detalladas:
-    // - Solo instrucciones permitidas en constexpr
-    // - No llamadas a funciones no-constexpr
-    // - No variables static/local no-const
-    // - etc.
-
-    return true;
+    // Lo que el compilador de bytecode acepta es lo que el VM sabe evaluar
+    return vm_->isValidConstexpr(functionDecl, errorMessage);
 }
 
 bool ConstexprEvaluator::validateConstexprExpression(const ast::ASTNode* expression,
@@ -479,13 +1137,7 @@ bool ConstexprEvaluator::validateConstexprExpression(const ast::ASTNode* express
         return false;
     }
 
-    // Aquí irían verificaciones detalladas:
-    // - Solo operaciones permitidas en constexpr
-    // - No acceso a memoria no-const
-    // - No llamadas a funciones virtuales
-    // - etc.
-
-    return true;
+    return vm_->isValidConstexpr(expression, errorMessage);
 }
 
 std::unordered_map<std::string, ConstexprValue> ConstexprEvaluator::prepareContext(
@@ -493,10 +1145,14 @@ std::unordered_map<std::string, ConstexprValue> ConstexprEvaluator::prepareConte
     const std::vector<ConstexprValue>& arguments) {
 
     std::unordered_map<std::string, ConstexprValue> context;
+    if (!functionDecl || functionDecl->getKind() != ast::ASTNodeKind::FunctionDecl) {
+        return context;
+    }
 
-    // Dummy - en un compilador real esto mapearía los nombres de parámetros
-    // de la función con los valores de argumentos proporcionados
-
+    auto parameters = static_cast<const ast::FunctionDecl*>(functionDecl)->getParameters();
+    for (size_t i = 0; i < parameters.size() && i < arguments.size(); ++i) {
+        context[std::string(parameters[i]->getName())] = arguments[i];
+    }
     return context;
 }
 
@@ -0,0 +1,725 @@
+/**
+ * @file ConstexprJIT.cpp
+ * @brief Nivel nativo del VM constexpr sobre el back-end x86-64
+ */
+
+#include <compiler/constexpr/ConstexprJIT.h>
+#include <compiler/constexpr/ConstexprBytecode.h>
+#include <compiler/backend/codegen/CodeGenerator.h>
+#include <compiler/backend/codegen/X86Encoder.h>
+#include <compiler/ir/IR.h>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace cpp20::compiler::constexpr_eval {
+
+namespace {
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CPP20_CONSTEXPR_JIT 1
+// El back-end genera código con la convención de Windows x64
+#ifdef _WIN32
+using NativeEntry = int64_t (*)(int64_t* frame);
+#else
+using NativeEntry = int64_t (__attribute__((ms_abi)) *)(int64_t* frame);
+#endif
+#endif
+
+using ir::IROpcode;
+using BinaryKind = ast::BinaryOp::OpKind;
+using UnaryKind = ast::UnaryOp::OpKind;
+
+const ir::TypeInfo kInt64(ir::IRType::LongLong, 8, 8, "long long");
+const ir::TypeInfo kPointer(ir::IRType::Pointer, 8, 8, "ptr");
+const ir::TypeInfo kBool(ir::IRType::Bool, 1, 1, "bool");
+
+constexpr int64_t kIntMin = std::numeric_limits<int>::min();
+constexpr int64_t kIntMax = std::numeric_limits<int>::max();
+
+// Valor de retorno: (resultado << 2) | estado
+constexpr int64_t kBailout = 0;
+constexpr int64_t kReturnsInt = 1;
+constexpr int64_t kReturnsBool = 2;
+
+constexpr size_t MaxNativeParameters = 16;
+constexpr size_t MaxLoweredInstructions = 4096;     // Suma de todos los caminos
+
+bool inIntRange(int64_t value) {
+    return value >= kIntMin && value <= kIntMax;
+}
+
+/**
+ * @brief Lo que un camino sabe de un registro del bytecode
+ *
+ * Int y Bool llevan un valor de la IR de 64 bits. Compare es una
+ * comparación aún sin materializar: el back-end solo la sabe bajar
+ * fusionada con un salto, así que se consume en el siguiente salto o
+ * bifurcando el camino en sus dos resultados constantes.
+ */
+struct Slot {
+    enum class Kind : uint8_t { Undefined, Int, Bool, Compare };
+    Kind kind = Kind::Undefined;
+    ir::ValueId value = ir::NoValue;
+    IROpcode compare = IROpcode::CmpNE;     // Compare: value <compare> other
+    ir::ValueId other = ir::NoValue;
+};
+
+struct Path {
+    size_t pc;
+    ir::BlockId block;
+    std::vector<Slot> slots;
+};
+
+/**
+ * @brief Bajada de un BytecodeFunction a IR camino a camino
+ */
+class Lowering {
+public:
+    Lowering(const BytecodeFunction& function, ir::IRFunction& target)
+        : function_(function), target_(target), builder_(target) {}
+
+    bool run(std::string& reason);
+
+private:
+    const BytecodeFunction& function_;
+    ir::IRFunction& target_;
+    ir::IRBuilder builder_;
+    ir::BlockId bailout_ = ir::NoBlock;
+    std::vector<Path> worklist_;
+    size_t lowered_ = 0;
+    std::string reason_;
+
+    bool fail(std::string reason) {
+        reason_ = std::move(reason);
+        return false;
+    }
+
+    std::optional<int64_t> constantOf(ir::ValueId value) const {
+        const ir::IRConstant* constant = target_.constant(value);
+        return constant ? std::optional<int64_t>(constant->intValue) : std::nullopt;
+    }
+
+    Slot integer(int64_t value) {
+        return Slot{Slot::Kind::Int, builder_.getInt(value, kInt64)};
+    }
+    Slot boolean(bool value) {
+        return Slot{Slot::Kind::Bool, builder_.getInt(value ? 1 : 0, kInt64)};
+    }
+
+    /**
+     * @brief Salto según lhs <compare> rhs, con las constantes ya decididas
+     */
+    void branch(IROpcode compare, ir::ValueId lhs, ir::ValueId rhs, ir::BlockId ifTrue, ir::BlockId ifFalse);
+
+    /**
+     * @brief Sigue en un bloque nuevo si value está fuera del rango de int; si no, abandona
+     */
+    void checkIntRange(Path& path, ir::ValueId value);
+
+    /**
+     * @brief Bifurca el camino en los dos valores de la comparación de un registro
+     */
+    void fork(Path& path, uint32_t reg);
+
+    bool lowerPath(Path path);
+    bool lowerBinary(Path& path, const Instruction& instruction, bool& ended);
+    bool lowerUnary(Path& path, const Instruction& instruction, bool& ended);
+    bool lowerReturn(const Slot& slot);
+};
+
+void Lowering::branch(IROpcode compare, ir::ValueId lhs, ir::ValueId rhs, ir::BlockId ifTrue, ir::BlockId ifFalse) {
+    auto l = constantOf(lhs);
+    auto r = constantOf(rhs);
+    if (l && r) {
+        bool result = false;
+        switch (compare) {
+            case IROpcode::CmpEQ: result = *l == *r; break;
+            case IROpcode::CmpNE: result = *l != *r; break;
+            case IROpcode::CmpLT: result = *l < *r; break;
+            case IROpcode::CmpLE: result = *l <= *r; break;
+            case IROpcode::CmpGT: result = *l > *r; break;
+            default: result = *l >= *r; break;
+        }
+        builder_.createBranch(result ? ifTrue : ifFalse);
+        return;
+    }
+    if (l) {
+        // El CMP del back-end quiere la constante a la derecha
+        std::swap(lhs, rhs);
+        switch (compare) {
+            case IROpcode::CmpLT: compare = IROpcode::CmpGT; break;
+            case IROpcode::CmpLE: compare = IROpcode::CmpGE; break;
+            case IROpcode::CmpGT: compare = IROpcode::CmpLT; break;
+            case IROpcode::CmpGE: compare = IROpcode::CmpLE; break;
+            default: break;
+        }
+    }
+    ir::ValueId condition = builder_.createBinary(compare, lhs, rhs, kBool);
+    builder_.createConditionalBranch(condition, ifTrue, ifFalse);
+}
+
+void Lowering::checkIntRange(Path& path, ir::ValueId value) {
+    ir::BlockId aboveMin = builder_.createBlock();
+    branch(IROpcode::CmpLT, value, builder_.getInt(kIntMin, kInt64), bailout_, aboveMin);
+    builder_.setInsertPoint(aboveMin);
+    ir::BlockId inRange = builder_.createBlock();
+    branch(IROpcode::CmpGT, value, builder_.getInt(kIntMax, kInt64), bailout_, inRange);
+    builder_.setInsertPoint(inRange);
+    path.block = inRange;
+}
+
+void Lowering::fork(Path& path, uint32_t reg) {
+    const Slot& slot = path.slots[reg];
+    ir::BlockId ifTrue = builder_.createBlock();
+    ir::BlockId ifFalse = builder_.createBlock();
+    branch(slot.compare, slot.value, slot.other, ifTrue, ifFalse);
+
+    Path whenFalse{path.pc, ifFalse, path.slots};
+    whenFalse.slots[reg] = boolean(false);
+    worklist_.push_back(std::move(whenFalse));
+    Path whenTrue{path.pc, ifTrue, std::move(path.slots)};
+    whenTrue.slots[reg] = boolean(true);
+    worklist_.push_back(std::move(whenTrue));
+}
+
+bool Lowering::run(std::string& reason) {
+    if (!function_.returnsValue || function_.parameterCount > MaxNativeParameters) {
+        reason = "La función no devuelve un valor o tiene demasiados parámetros";
+        return false;
+    }
+    for (const Instruction& instruction : function_.code) {
+        if (instruction.op == OpCode::Call) {
+            reason = "Las llamadas quedan en el intérprete";
+            return false;
+        }
+    }
+
+    target_.addParameter("frame", kPointer);
+    ir::BlockId entry = builder_.createBlock("entry");
+    bailout_ = builder_.createBlock("bailout");
+    builder_.setInsertPoint(bailout_);
+    builder_.createReturn(builder_.getInt(kBailout, kInt64));
+
+    // Los argumentos se leen todos al entrar: el marco no vive más allá
+    builder_.setInsertPoint(entry);
+    Path start{0, entry, std::vector<Slot>(function_.registerCount)};
+    ir::ValueId frame = target_.parameter(0);
+    for (uint32_t i = 0; i < function_.parameterCount; ++i) {
+        ir::ValueId address = i == 0 ? frame
+                                     : builder_.createBinary(IROpcode::Add, frame,
+                                                             builder_.getInt(8 * i, kInt64), kPointer);
+        start.slots[i] = Slot{Slot::Kind::Int, builder_.createLoad(address, kInt64)};
+    }
+    worklist_.push_back(std::move(start));
+
+    while (!worklist_.empty()) {
+        Path path = std::move(worklist_.back());
+        worklist_.pop_back();
+        if (!lowerPath(std::move(path))) {
+            reason = reason_;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Lowering::lowerPath(Path path) {
+    builder_.setInsertPoint(path.block);
+    while (true) {
+        if (++lowered_ > MaxLoweredInstructions) {
+            return fail("Demasiados caminos en el bytecode");
+        }
+        if (path.pc >= function_.code.size()) {
+            return fail("El bytecode termina sin return");
+        }
+        const Instruction& instruction = function_.code[path.pc];
+
+        switch (instruction.op) {
+            case OpCode::LoadConst: {
+                const ConstexprValue& constant = function_.constants[instruction.b];
+                if (constant.isInteger()) {
+                    path.slots[instruction.a] = integer(constant.asInteger());
+                } else if (constant.isBoolean()) {
+                    path.slots[instruction.a] = boolean(constant.asBoolean());
+                } else {
+                    return fail("Constante no escalar: " + constant.toString());
+                }
+                ++path.pc;
+                break;
+            }
+
+            case OpCode::Move:
+                path.slots[instruction.a] = path.slots[instruction.b];
+                ++path.pc;
+                break;
+
+            case OpCode::Binary:
+            case OpCode::Unary: {
+                bool ended = false;
+                bool lowered = instruction.op == OpCode::Binary ? lowerBinary(path, instruction, ended)
+                                                                : lowerUnary(path, instruction, ended);
+                if (!lowered) {
+                    return false;
+                }
+                if (ended) {
+                    return true;
+                }
+                ++path.pc;
+                break;
+            }
+
+            case OpCode::ToBool: {
+                const Slot& operand = path.slots[instruction.b];
+                if (operand.kind == Slot::Kind::Undefined) {
+                    return fail("Lectura de un registro sin inicializar");
+                }
+                if (operand.kind == Slot::Kind::Compare) {
+                    path.slots[instruction.a] = operand;
+                } else if (auto value = constantOf(operand.value)) {
+                    path.slots[instruction.a] = boolean(*value != 0);
+                } else {
+                    path.slots[instruction.a] = Slot{Slot::Kind::Compare, operand.value, IROpcode::CmpNE,
+                                                     builder_.getInt(0, kInt64)};
+                }
+                ++path.pc;
+                break;
+            }
+
+            case OpCode::Jump:
+                if (instruction.a <= path.pc) {
+                    return fail("Los bucles quedan en el intérprete");
+                }
+                path.pc = instruction.a;
+                break;
+
+            case OpCode::JumpIfFalse:
+            case OpCode::JumpIfTrue: {
+                if (instruction.b <= path.pc) {
+                    return fail("Los bucles quedan en el intérprete");
+                }
+                Slot condition = path.slots[instruction.a];
+                if (condition.kind == Slot::Kind::Undefined) {
+                    return fail("Lectura de un registro sin inicializar");
+                }
+                bool jumpWhen = instruction.op == OpCode::JumpIfTrue;
+                if (condition.kind != Slot::Kind::Compare) {
+                    if (auto value = constantOf(condition.value)) {
+                        path.pc = (*value != 0) == jumpWhen ? instruction.b : path.pc + 1;
+                        break;
+                    }
+                    condition = Slot{Slot::Kind::Compare, condition.value, IROpcode::CmpNE,
+                                     builder_.getInt(0, kInt64)};
+                }
+
+                ir::BlockId ifTrue = builder_.createBlock();
+                ir::BlockId ifFalse = builder_.createBlock();
+                branch(condition.compare, condition.value, condition.other, ifTrue, ifFalse);
+                size_t next = path.pc + 1;
+                worklist_.push_back(Path{jumpWhen ? next : instruction.b, ifFalse, path.slots});
+                worklist_.push_back(Path{jumpWhen ? instruction.b : next, ifTrue, std::move(path.slots)});
+                return true;
+            }
+
+            case OpCode::Return: {
+                const Slot& slot = path.slots[instruction.a];
+                if (slot.kind == Slot::Kind::Compare) {
+                    fork(path, instruction.a);
+                    return true;
+                }
+                return lowerReturn(slot);
+            }
+
+            case OpCode::Call:
+            case OpCode::ReturnVoid:
+                return fail("Instrucción sin bajada nativa");
+        }
+    }
+}
+
+bool Lowering::lowerReturn(const Slot& slot) {
+    if (slot.kind == Slot::Kind::Undefined) {
+        return fail("Lectura de un registro sin inicializar");
+    }
+    int64_t status = slot.kind == Slot::Kind::Bool ? kReturnsBool : kReturnsInt;
+    if (auto value = constantOf(slot.value)) {
+        builder_.createReturn(builder_.getInt(static_cast<int64_t>(static_cast<uint64_t>(*value) << 2) | status,
+                                              kInt64));
+        return true;
+    }
+    ir::ValueId shifted = builder_.createBinary(IROpcode::Shl, slot.value, builder_.getInt(2, kInt64), kInt64);
+    builder_.createReturn(builder_.createBinary(IROpcode::Or, shifted, builder_.getInt(status, kInt64), kInt64));
+    return true;
+}
+
+bool Lowering::lowerBinary(Path& path, const Instruction& instruction, bool& ended) {
+    auto kind = static_cast<BinaryKind>(instruction.kind);
+    for (uint32_t reg : {instruction.b, instruction.c}) {
+        if (path.slots[reg].kind == Slot::Kind::Undefined) {
+            return fail("Lectura de un registro sin inicializar");
+        }
+        if (path.slots[reg].kind == Slot::Kind::Compare) {
+            fork(path, reg);
+            ended = true;
+            return true;
+        }
+    }
+    ir::ValueId left = path.slots[instruction.b].value;
+    ir::ValueId right = path.slots[instruction.c].value;
+    auto l = constantOf(left);
+    auto r = constantOf(right);
+    Slot& result = path.slots[instruction.a];
+
+    auto bailout = [&]() {
+        builder_.createBranch(bailout_);
+        ended = true;
+        return true;
+    };
+
+    // Lo que el intérprete comprueba sale por el bloque de abandono
+    auto arithmetic = [&](IROpcode opcode, int64_t folded, bool checkRange) {
+        if (l && r) {
+            if (checkRange && !inIntRange(folded)) {
+                return bailout();
+            }
+            result = integer(folded);
+            return true;
+        }
+        ir::ValueId value = builder_.createBinary(opcode, left, right, kInt64);
+        if (checkRange) {
+            checkIntRange(path, value);
+        }
+        result = Slot{Slot::Kind::Int, value};
+        return true;
+    };
+    auto comparison = [&](IROpcode opcode, bool folded) {
+        result = l && r ? boolean(folded) : Slot{Slot::Kind::Compare, left, opcode, right};
+        return true;
+    };
+    int64_t a = l.value_or(0);
+    int64_t b = r.value_or(0);
+
+    switch (kind) {
+        case BinaryKind::Add: return arithmetic(IROpcode::Add, a + b, true);
+        case BinaryKind::Subtract: return arithmetic(IROpcode::Sub, a - b, true);
+        case BinaryKind::Multiply: return arithmetic(IROpcode::Mul, a * b, true);
+        case BinaryKind::BitwiseAnd: return arithmetic(IROpcode::And, a & b, false);
+        case BinaryKind::BitwiseOr: return arithmetic(IROpcode::Or, a | b, false);
+        case BinaryKind::BitwiseXor: return arithmetic(IROpcode::Xor, a ^ b, false);
+        case BinaryKind::Equal: return comparison(IROpcode::CmpEQ, a == b);
+        case BinaryKind::NotEqual: return comparison(IROpcode::CmpNE, a != b);
+        case BinaryKind::Less: return comparison(IROpcode::CmpLT, a < b);
+        case BinaryKind::LessEqual: return comparison(IROpcode::CmpLE, a <= b);
+        case BinaryKind::Greater: return comparison(IROpcode::CmpGT, a > b);
+        case BinaryKind::GreaterEqual: return comparison(IROpcode::CmpGE, a >= b);
+
+        case BinaryKind::LeftShift:
+        case BinaryKind::RightShift: {
+            // El back-end solo desplaza por inmediato
+            if (!r) {
+                return fail("Desplazamiento por una cantidad variable");
+            }
+            if (b < 0 || b >= std::numeric_limits<int>::digits + 1) {
+                return bailout();
+            }
+            if (kind == BinaryKind::RightShift) {
+                return arithmetic(IROpcode::Shr, a >> b, false);
+            }
+            if (l && a < 0) {
+                return bailout();
+            }
+            if (!l) {
+                ir::BlockId nonNegative = builder_.createBlock();
+                branch(IROpcode::CmpLT, left, builder_.getInt(0, kInt64), bailout_, nonNegative);
+                builder_.setInsertPoint(nonNegative);
+                path.block = nonNegative;
+            }
+            return arithmetic(IROpcode::Shl, l ? (a << b) : 0, true);
+        }
+
+        default:
+            // División y módulo necesitan IDIV, que el selector aún no baja
+            return fail(std::string("Operador '") + ast::BinaryOp::opSpelling(kind) + "' sin bajada nativa");
+    }
+}
+
+bool Lowering::lowerUnary(Path& path, const Instruction& instruction, bool& ended) {
+    auto kind = static_cast<UnaryKind>(instruction.kind);
+    Slot operand = path.slots[instruction.b];
+    Slot& result = path.slots[instruction.a];
+    if (operand.kind == Slot::Kind::Undefined) {
+        return fail("Lectura de un registro sin inicializar");
+    }
+
+    if (kind == UnaryKind::Not) {
+        if (operand.kind == Slot::Kind::Compare) {
+            IROpcode negated = IROpcode::CmpNE;
+            switch (operand.compare) {
+                case IROpcode::CmpEQ: negated = IROpcode::CmpNE; break;
+                case IROpcode::CmpNE: negated = IROpcode::CmpEQ; break;
+                case IROpcode::CmpLT: negated = IROpcode::CmpGE; break;
+                case IROpcode::CmpLE: negated = IROpcode::CmpGT; break;
+                case IROpcode::CmpGT: negated = IROpcode::CmpLE; break;
+                default: negated = IROpcode::CmpLT; break;
+            }
+            result = Slot{Slot::Kind::Compare, operand.value, negated, operand.other};
+        } else if (auto value = constantOf(operand.value)) {
+            result = boolean(*value == 0);
+        } else {
+            result = Slot{Slot::Kind::Compare, operand.value, IROpcode::CmpEQ, builder_.getInt(0, kInt64)};
+        }
+        return true;
+    }
+
+    if (operand.kind == Slot::Kind::Compare) {
+        fork(path, instruction.b);
+        ended = true;
+        return true;
+    }
+    auto value = constantOf(operand.value);
+    switch (kind) {
+        case UnaryKind::Plus:
+            result = Slot{Slot::Kind::Int, operand.value};
+            return true;
+        case UnaryKind::Minus:
+            if (value) {
+                if (!inIntRange(-*value)) {
+                    builder_.createBranch(bailout_);
+                    ended = true;
+                    return true;
+                }
+                result = integer(-*value);
+                return true;
+            }
+            result = Slot{Slot::Kind::Int, builder_.createUnary(IROpcode::Neg, operand.value, kInt64)};
+            checkIntRange(path, result.value);
+            return true;
+        case UnaryKind::BitwiseNot:
+            result = value ? integer(~*value)
+                           : Slot{Slot::Kind::Int, builder_.createUnary(IROpcode::Not, operand.value, kInt64)};
+            return true;
+        default:
+            return fail(std::string("Operador '") + ast::UnaryOp::opSpelling(kind) + "' sin bajada nativa");
+    }
+}
+
+void* mapExecutable(const std::vector<uint8_t>& code, size_t& mappedSize) {
+    mappedSize = (code.size() + 4095) & ~size_t(4095);
+#ifdef _WIN32
+    void* memory = VirtualAlloc(nullptr, mappedSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (!memory) {
+        return nullptr;
+    }
+    std::memcpy(memory, code.data(), code.size());
+    DWORD previous = 0;
+    if (!VirtualProtect(memory, mappedSize, PAGE_EXECUTE_READ, &previous)) {
+        VirtualFree(memory, 0, MEM_RELEASE);
+        return nullptr;
+    }
+    FlushInstructionCache(GetCurrentProcess(), memory, mappedSize);
+    return memory;
+#else
+    void* memory = ::mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return nullptr;
+    }
+    std::memcpy(memory, code.data(), code.size());
+    if (::mprotect(memory, mappedSize, PROT_READ | PROT_EXEC) != 0) {
+        ::munmap(memory, mappedSize);
+        return nullptr;
+    }
+    return memory;
+#endif
+}
+
+backend::X86Operand registerOperand(backend::X86Register reg) {
+    backend::X86Operand operand(backend::AddressingMode::Register);
+    operand.reg = reg;
+    return operand;
+}
+
+backend::X86Operand immediateOperand(int64_t value) {
+    backend::X86Operand operand(backend::AddressingMode::Immediate);
+    operand.immediate = value;
+    return operand;
+}
+
+/**
+ * @brief Stub de entrada: guarda los no volátiles y llama al cuerpo con el marco en frameRegister
+ *
+ * El cuerpo guarda solo los registros que usa, pero el marco entra en su
+ * registro antes de ese prólogo: el stub salva todos los no volátiles de
+ * Windows x64 (que incluyen los de System V) para no depender de cuáles.
+ */
+std::vector<backend::X86Instruction> entryStub(backend::X86Register frameRegister) {
+    using backend::X86Instruction;
+    using backend::X86Opcode;
+    using backend::X86Register;
+    static constexpr X86Register saved[] = {
+        X86Register::RBX, X86Register::RBP, X86Register::RSI, X86Register::RDI,
+        X86Register::R12, X86Register::R13, X86Register::R14, X86Register::R15,
+    };
+
+    std::vector<X86Instruction> stub;
+    auto emit = [&](X86Opcode opcode, std::vector<backend::X86Operand> operands) {
+        X86Instruction instruction(opcode);
+        instruction.operands = std::move(operands);
+        stub.push_back(std::move(instruction));
+    };
+    for (X86Register reg : saved) {
+        emit(X86Opcode::PUSH, {registerOperand(reg)});
+    }
+    // 8 pushes dejan RSP alineado a 8: 8 más 32 de shadow space
+    emit(X86Opcode::SUB, {registerOperand(X86Register::RSP), immediateOperand(40)});
+    if (frameRegister != X86Register::RCX) {
+        emit(X86Opcode::MOV, {registerOperand(frameRegister), registerOperand(X86Register::RCX)});
+    }
+    X86Instruction call(X86Opcode::CALL);
+    call.comment = "body";
+    stub.push_back(std::move(call));
+    emit(X86Opcode::ADD, {registerOperand(X86Register::RSP), immediateOperand(40)});
+    for (size_t i = std::size(saved); i-- > 0;) {
+        emit(X86Opcode::POP, {registerOperand(saved[i])});
+    }
+    stub.emplace_back(X86Opcode::RET);
+    return stub;
+}
+
+} // namespace
+
+// ============================================================================
+// NativeFunction - Implementación
+// ============================================================================
+
+NativeFunction::~NativeFunction() {
+    if (!memory_) {
+        return;
+    }
+#ifdef _WIN32
+    VirtualFree(memory_, 0, MEM_RELEASE);
+#else
+    ::munmap(memory_, mappedSize_);
+#endif
+}
+
+bool NativeFunction::call(const ConstexprValue* arguments, size_t count, ConstexprValue& result) const {
+#ifdef CPP20_CONSTEXPR_JIT
+    if (count != parameterCount_) {
+        return false;
+    }
+    int64_t frame[MaxNativeParameters];
+    for (size_t i = 0; i < count; ++i) {
+        // Un bool o un char como argumento cambiaría el tipo de lo que se devuelve
+        if (!arguments[i].isInteger()) {
+            return false;
+        }
+        frame[i] = arguments[i].asInteger();
+    }
+
+    int64_t packed = reinterpret_cast<NativeEntry>(memory_)(frame);
+    int64_t status = packed & 3;
+    int64_t value = packed >> 2;
+    if (status == kReturnsInt) {
+        result = ConstexprValue(static_cast<int>(value));
+        return true;
+    }
+    if (status == kReturnsBool) {
+        result = ConstexprValue(value != 0);
+        return true;
+    }
+#else
+    (void)arguments;
+    (void)count;
+    (void)result;
+#endif
+    return false;
+}
+
+// ============================================================================
+// ConstexprJIT - Implementación
+// ============================================================================
+
+ConstexprJIT::ConstexprJIT() : abiContract_(std::make_unique<backend::abi::ABIContract>()) {
+}
+
+ConstexprJIT::~ConstexprJIT() = default;
+
+bool ConstexprJIT::isSupported() {
+#ifdef CPP20_CONSTEXPR_JIT
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::unique_ptr<ir::IRFunction> ConstexprJIT::lowerToIR(const BytecodeFunction& function, std::string& reason) {
+    auto target = std::make_unique<ir::IRFunction>("__constexpr_" + function.name, kInt64,
+                                                   std::vector<ir::TypeInfo>{kPointer});
+    Lowering lowering(function, *target);
+    if (!lowering.run(reason)) {
+        return nullptr;
+    }
+    return target;
+}
+
+std::unique_ptr<NativeFunction> ConstexprJIT::compile(const BytecodeFunction& function, std::string& reason) const {
+    if (!isSupported()) {
+        reason = "El anfitrión no es x86-64";
+        return nullptr;
+    }
+    auto lowered = lowerToIR(function, reason);
+    if (!lowered) {
+        return nullptr;
+    }
+
+    backend::FunctionCode body = backend::CodeGenerator(*abiContract_).generateFunction(*lowered);
+    if (body.code.empty() || !body.relocations.empty()) {
+        reason = body.encodingError.empty() ? "El cuerpo nativo tiene relocaciones"
+                                            : "X86Encoder: " + body.encodingError;
+        return nullptr;
+    }
+
+    // CodeGenerator no expone la asignación; repetirla da la misma (es determinista)
+    backend::RegisterAllocator allocator(*abiContract_);
+    auto mapping = backend::RegisterAllocationUtils::createRegisterMapping(
+        allocator.allocateRegisters(*lowered));
+    auto frameRegister = mapping.find(static_cast<int>(lowered->parameter(0)));
+    if (function.parameterCount > 0 &&
+        (frameRegister == mapping.end() || frameRegister->second.isSpilled)) {
+        reason = "El puntero al marco no está en un registro";
+        return nullptr;
+    }
+
+    std::vector<uint8_t> code;
+    std::vector<backend::coff::COFFFunctionRelocation> relocations;
+    backend::X86Encoder encoder;
+    backend::X86Register frame = frameRegister == mapping.end() ? backend::X86Register::RCX
+                                                                : frameRegister->second.physicalReg;
+    if (!encoder.encode(entryStub(frame), code, relocations) || relocations.size() != 1) {
+        reason = "X86Encoder: " + encoder.getLastError();
+        return nullptr;
+    }
+    size_t bodyOffset = (code.size() + 15) & ~size_t(15);
+    int32_t displacement = static_cast<int32_t>(bodyOffset - (relocations[0].offset + 4));
+    std::memcpy(code.data() + relocations[0].offset, &displacement, sizeof(displacement));
+    code.resize(bodyOffset, 0xCC);
+    code.insert(code.end(), body.code.begin(), body.code.end());
+
+    auto native = std::unique_ptr<NativeFunction>(new NativeFunction());
+    native->memory_ = mapExecutable(code, native->mappedSize_);
+    if (!native->memory_) {
+        reason = "No se pudo reservar memoria ejecutable";
+        return nullptr;
+    }
+    native->codeSize_ = code.size();
+    native->parameterCount_ = function.parameterCount;
+    return native;
+}
+
+} // namespace cpp20::compiler::constexpr_eval
@@ -0,0 +1,203 @@
+/**
+ * @file CoroutineFrame.cpp
+ * @brief Implementación de la disposición del marco de corrutina, de HALO y del pool de marcos
+ */
+
+#include <compiler/coroutines/CoroutineFrame.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <new>
+
+namespace cpp20::compiler::coroutines {
+
+namespace {
+
+uint32_t alignTo(uint32_t value, uint32_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * @brief Contadores de un hilo; solo los escribe su dueño, sin instrucciones atómicas
+ */
+struct ThreadFrameCounters {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> poolHits{0};
+    std::atomic<uint64_t> heapFallbacks{0};
+    std::atomic<uint64_t> deallocations{0};
+};
+
+void bump(std::atomic<uint64_t>& counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void addTo(FramePoolStatistics& total, const ThreadFrameCounters& counters) {
+    total.allocations += counters.allocations.load(std::memory_order_relaxed);
+    total.poolHits += counters.poolHits.load(std::memory_order_relaxed);
+    total.heapFallbacks += counters.heapFallbacks.load(std::memory_order_relaxed);
+    total.deallocations += counters.deallocations.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Contadores de los hilos vivos y suma de los que ya terminaron
+ */
+struct FrameCounterRegistry {
+    std::mutex mutex;
+    std::vector<const ThreadFrameCounters*> live;
+    FramePoolStatistics retired;
+
+    static FrameCounterRegistry& instance() {
+        static FrameCounterRegistry registry;
+        return registry;
+    }
+};
+
+struct FreeFrame {
+    FreeFrame* next;
+};
+
+/**
+ * @brief Listas libres del hilo; al terminar el hilo devuelven los marcos al heap
+ */
+class ThreadFrameCache {
+public:
+    ThreadFrameCache() : registry_(FrameCounterRegistry::instance()) {
+        std::lock_guard<std::mutex> lock(registry_.mutex);
+        registry_.live.push_back(&counters);
+    }
+
+    ~ThreadFrameCache() {
+        for (FreeFrame* head : lists) {
+            while (head) {
+                FreeFrame* next = head->next;
+                ::operator delete(head);
+                head = next;
+            }
+        }
+        std::lock_guard<std::mutex> lock(registry_.mutex);
+        registry_.live.erase(std::find(registry_.live.begin(), registry_.live.end(), &counters));
+        addTo(registry_.retired, counters);
+    }
+
+    std::array<FreeFrame*, CoroutineFrameAllocator::SizeClassCount> lists{};
+    std::array<size_t, CoroutineFrameAllocator::SizeClassCount> lengths{};
+    ThreadFrameCounters counters;
+
+private:
+    FrameCounterRegistry& registry_;
+};
+
+thread_local ThreadFrameCache frameCache;
+
+} // namespace
+
+void CoroutineFrameLayout::setPromise(uint32_t size, uint32_t alignment) {
+    promiseSize_ = size;
+    promiseAlignment_ = std::max<uint32_t>(1, alignment);
+}
+
+void CoroutineFrameLayout::addSuspendPoint(uint32_t position) {
+    suspendPoints_.insert(std::upper_bound(suspendPoints_.begin(), suspendPoints_.end(), position), position);
+}
+
+void CoroutineFrameLayout::addVariable(FrameVariable variable) {
+    variable.alignment = std::max<uint32_t>(1, variable.alignment);
+    variables_.push_back(std::move(variable));
+}
+
+bool CoroutineFrameLayout::isLiveAcrossSuspend(const FrameVariable& variable) const {
+    // Primera suspensión tras la definición: si el último uso la sigue, cruza
+    auto next = std::upper_bound(suspendPoints_.begin(), suspendPoints_.end(), variable.definition);
+    return next != suspendPoints_.end() && *next < variable.lastUse;
+}
+
+void CoroutineFrameLayout::compute() {
+    slots_.clear();
+    localCount_ = 0;
+
+    std::vector<const FrameVariable*> spilled;
+    for (const FrameVariable& variable : variables_) {
+        if (isLiveAcrossSuspend(variable)) {
+            spilled.push_back(&variable);
+        } else {
+            ++localCount_;
+        }
+    }
+    std::stable_sort(spilled.begin(), spilled.end(), [](const FrameVariable* a, const FrameVariable* b) {
+        if (a->alignment != b->alignment) return a->alignment > b->alignment;
+        return a->size > b->size;
+    });
+
+    frameAlignment_ = std::max<uint32_t>(8, promiseAlignment_);
+    promiseOffset_ = alignTo(HeaderSize, promiseAlignment_);
+    uint32_t offset = promiseOffset_ + promiseSize_;
+    for (const FrameVariable* variable : spilled) {
+        offset = alignTo(offset, variable->alignment);
+        slots_.push_back({variable->name, offset, variable->size});
+        offset += variable->size;
+        frameAlignment_ = std::max(frameAlignment_, variable->alignment);
+    }
+    frameSize_ = alignTo(offset, frameAlignment_);
+}
+
+const FrameSlot* CoroutineFrameLayout::findSlot(const std::string& name) const {
+    auto it = std::find_if(slots_.begin(), slots_.end(), [&](const FrameSlot& slot) { return slot.name == name; });
+    return it == slots_.end() ? nullptr : &*it;
+}
+
+FrameAllocation chooseFrameAllocation(const CoroutineUse& use, uint32_t frameSize, uint32_t maxStackFrame) {
+    if (!use.calleeKnown || use.handleEscapes || !use.destroyedInCaller) return FrameAllocation::Heap;
+    return frameSize <= maxStackFrame ? FrameAllocation::CallerStack : FrameAllocation::Heap;
+}
+
+// ============================================================================
+// CoroutineFrameAllocator
+// ============================================================================
+
+void* CoroutineFrameAllocator::allocate(size_t size) {
+    ThreadFrameCache& cache = frameCache;
+    bump(cache.counters.allocations);
+
+    size_t sizeClass = sizeClassOf(size);
+    if (sizeClass == SizeClassCount) {
+        bump(cache.counters.heapFallbacks);
+        return ::operator new(size);
+    }
+    if (FreeFrame* frame = cache.lists[sizeClass]) {
+        cache.lists[sizeClass] = frame->next;
+        --cache.lengths[sizeClass];
+        bump(cache.counters.poolHits);
+        return frame;
+    }
+    // Siempre el tamaño de la clase: el bloque sirve luego para cualquier marco de ella
+    return ::operator new((sizeClass + 1) * Granularity);
+}
+
+void CoroutineFrameAllocator::deallocate(void* frame, size_t size) noexcept {
+    if (!frame) return;
+    ThreadFrameCache& cache = frameCache;
+    bump(cache.counters.deallocations);
+
+    size_t sizeClass = sizeClassOf(size);
+    if (sizeClass == SizeClassCount || cache.lengths[sizeClass] >= MaxCachedPerClass) {
+        ::operator delete(frame);
+        return;
+    }
+    auto* node = static_cast<FreeFrame*>(frame);
+    node->next = cache.lists[sizeClass];
+    cache.lists[sizeClass] = node;
+    ++cache.lengths[sizeClass];
+}
+
+FramePoolStatistics CoroutineFrameAllocator::statistics() {
+    FrameCounterRegistry& registry = FrameCounterRegistry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    FramePoolStatistics total = registry.retired;
+    for (const ThreadFrameCounters* counters : registry.live) {
+        addTo(total, *counters);
+    }
+    return total;
+}
+
+} // namespace cpp20::compiler::coroutines
@@ -0,0 +1,242 @@
+/**
+ * @file CoroutineScheduler.cpp
+ * @brief Implementación del planificador de corrutinas y de la rueda de temporizadores
+ */
+
+#include <compiler/coroutines/CoroutineScheduler.h>
+#include <algorithm>
+
+namespace cpp20::compiler::coroutines {
+
+namespace {
+
+// Hilo del planificador que ejecuta el código actual (nullptr fuera de ellos)
+thread_local CoroutineScheduler* currentScheduler = nullptr;
+thread_local size_t currentWorker = 0;
+
+uint64_t nextRandom(uint64_t& state) {
+    // xorshift64: basta para repartir las víctimas del robo
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+} // namespace
+
+// ============================================================================
+// TimerWheel
+// ============================================================================
+
+TimerWheel::TimerWheel(std::chrono::microseconds tick, size_t slots, Clock::time_point start)
+    : tick_(std::max(tick, std::chrono::microseconds(1))), start_(start), slots_(std::max<size_t>(1, slots)) {
+}
+
+uint64_t TimerWheel::tickOf(Clock::time_point time) const {
+    if (time <= start_) return 0;
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(time - start_) / tick_);
+}
+
+void TimerWheel::add(Clock::time_point deadline, void* item) {
+    // Redondeo hacia arriba: nunca vence antes de tiempo
+    uint64_t tick = tickOf(deadline);
+    if (start_ + tick * tick_ < deadline) ++tick;
+    tick = std::max(tick, current_);
+    slots_[tick % slots_.size()].push_back({tick, item});
+    ++size_;
+}
+
+void TimerWheel::expireSlot(size_t slot, uint64_t upTo, std::vector<void*>& expired) {
+    auto& entries = slots_[slot];
+    auto kept = std::stable_partition(entries.begin(), entries.end(),
+                                      [&](const Entry& entry) { return entry.tick > upTo; });
+    for (auto it = kept; it != entries.end(); ++it) {
+        expired.push_back(it->item);
+    }
+    size_ -= static_cast<size_t>(entries.end() - kept);
+    entries.erase(kept, entries.end());
+}
+
+void TimerWheel::advance(Clock::time_point now, std::vector<void*>& expired) {
+    uint64_t nowTick = tickOf(now);
+    if (nowTick < current_) return;
+
+    // Más de una vuelta sin avanzar: basta con barrer cada hueco una vez
+    uint64_t ticks = nowTick - current_ + 1;
+    if (size_ > 0) {
+        size_t visit = static_cast<size_t>(std::min<uint64_t>(ticks, slots_.size()));
+        for (size_t i = 0; i < visit && size_ > 0; ++i) {
+            expireSlot(static_cast<size_t>((current_ + i) % slots_.size()), nowTick, expired);
+        }
+    }
+    current_ = nowTick + 1;
+}
+
+std::optional<TimerWheel::Clock::time_point> TimerWheel::nextDeadline() const {
+    if (size_ == 0) return std::nullopt;
+
+    // Primera vuelta: el primer hueco con una entrada de esa vuelta es el mínimo
+    for (uint64_t tick = current_; tick < current_ + slots_.size(); ++tick) {
+        for (const Entry& entry : slots_[tick % slots_.size()]) {
+            if (entry.tick == tick) return start_ + tick * tick_;
+        }
+    }
+    uint64_t earliest = UINT64_MAX;
+    for (const auto& slot : slots_) {
+        for (const Entry& entry : slot) {
+            earliest = std::min(earliest, entry.tick);
+        }
+    }
+    return start_ + earliest * tick_;
+}
+
+// ============================================================================
+// CoroutineScheduler
+// ============================================================================
+
+CoroutineScheduler::CoroutineScheduler(size_t workerCount, std::chrono::microseconds timerTick)
+    : timers_(timerTick) {
+    if (workerCount == 0) {
+        workerCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < workerCount; ++i) {
+        auto worker = std::make_unique<Worker>();
+        worker->randomState = 0x9E3779B97F4A7C15ull * (i + 1);
+        workers_.push_back(std::move(worker));
+    }
+    // Los hilos arrancan con todas las colas creadas: pueden robar de cualquiera
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers_[i]->thread = std::thread([this, i]() { workerLoop(i); });
+    }
+}
+
+CoroutineScheduler::~CoroutineScheduler() {
+    waitIdle();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker->thread.join();
+    }
+}
+
+void CoroutineScheduler::schedule(std::coroutine_handle<> handle) {
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    if (currentScheduler == this) {
+        workers_[currentWorker]->queue.push(handle.address());
+        // Empareja con el incremento de sleeping_ en workerLoop: o el que
+        // duerme ve la cola llena o aquí se ve que hay alguien durmiendo
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping_.load(std::memory_order_relaxed) > 0) wakeOne();
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        injected_.push_back(handle.address());
+    }
+    wake_.notify_one();
+}
+
+void CoroutineScheduler::scheduleAt(Clock::time_point deadline, std::coroutine_handle<> handle) {
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        timers_.add(deadline, handle.address());
+    }
+    // Quien duerme recalcula su plazo con el nuevo temporizador
+    wake_.notify_one();
+}
+
+void CoroutineScheduler::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this]() { return pending_.load(std::memory_order_acquire) == 0; });
+}
+
+SchedulerStatistics CoroutineScheduler::getStatistics() const {
+    SchedulerStatistics statistics;
+    statistics.resumed = resumed_.load(std::memory_order_relaxed);
+    statistics.stolen = stolen_.load(std::memory_order_relaxed);
+    statistics.timersFired = timersFired_.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+void CoroutineScheduler::wakeOne() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    wake_.notify_one();
+}
+
+void CoroutineScheduler::finishOne() {
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.notify_all();
+    }
+}
+
+bool CoroutineScheduler::anyQueuedWork() const {
+    return std::any_of(workers_.begin(), workers_.end(),
+                       [](const auto& worker) { return !worker->queue.emptyApprox(); });
+}
+
+void* CoroutineScheduler::findWork(size_t index) {
+    Worker& self = *workers_[index];
+    if (auto handle = self.queue.pop()) return *handle;
+
+    // Robo empezando por una víctima al azar para no cargar siempre la misma
+    size_t count = workers_.size();
+    size_t first = static_cast<size_t>(nextRandom(self.randomState) % count);
+    for (size_t i = 0; i < count; ++i) {
+        size_t victim = (first + i) % count;
+        if (victim == index) continue;
+        if (auto handle = workers_[victim]->queue.steal()) {
+            stolen_.fetch_add(1, std::memory_order_relaxed);
+            return *handle;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (injected_.empty()) return nullptr;
+    void* handle = injected_.front();
+    injected_.pop_front();
+    return handle;
+}
+
+void CoroutineScheduler::workerLoop(size_t index) {
+    currentScheduler = this;
+    currentWorker = index;
+    std::vector<void*> expired;
+
+    while (true) {
+        if (void* address = findWork(index)) {
+            std::coroutine_handle<>::from_address(address).resume();
+            resumed_.fetch_add(1, std::memory_order_relaxed);
+            finishOne();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        expired.clear();
+        timers_.advance(Clock::now(), expired);
+        if (!expired.empty()) {
+            timersFired_.fetch_add(expired.size(), std::memory_order_relaxed);
+            injected_.insert(injected_.end(), expired.begin(), expired.end());
+            if (expired.size() > 1) wake_.notify_all();
+            continue;
+        }
+        if (!injected_.empty()) continue;
+        if (stopping_) return;
+
+        sleeping_.fetch_add(1, std::memory_order_seq_cst);
+        if (!anyQueuedWork()) {
+            if (auto deadline = timers_.nextDeadline()) {
+                wake_.wait_until(lock, *deadline);
+            } else {
+                wake_.wait(lock);
+            }
+        }
+        sleeping_.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace cpp20::compiler::coroutines
@@ -44,8 +44,6 @@ void PingPongCoroutine::resume()
 {
     if (done_) return;
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-
     std::cout << "[CORO] " << name_ << " (" << *counter_ << ")" << std::endl;
 
     (*counter_)++;
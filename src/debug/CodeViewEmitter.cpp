@@ -4,13 +4,325 @@
  */
 
 #include <compiler/debug/CodeViewEmitter.h>
+#include <compiler/common/utils/HashUtils.h>
+#include <compiler/common/utils/MappedFile.h>
+#include <compiler/common/utils/ThreadPool.h>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 #include <algorithm>
 #include <cstring>
+#include <functional>
+#include <optional>
 
 namespace cpp20::compiler::debug {
 
+namespace {
+
+constexpr uint32_t kCodeViewSignature = 4;         // CV_SIGNATURE_C13
+constexpr uint32_t kDebugSSymbols = 0xF1;          // DEBUG_S_SYMBOLS
+constexpr uint32_t kDebugSLines = 0xF2;            // DEBUG_S_LINES
+constexpr uint32_t kLineIsStatement = 0x80000000u;
+constexpr uint32_t kGHashMagic = 0x133C9C5;        // Cabecera de .debug$H
+// FNV-1a de 64 bits; no es uno de los de MSVC (SHA1, BLAKE3), así que
+// link.exe ignora la sección y recalcula
+constexpr uint16_t kGHashFnv1a64 = 0x100;
+
+// Registro de tipo: longitud, tipo y datos, rellenado a 4 bytes con LF_PAD
+std::string encodeTypeRecord(CodeViewRecordType kind, const std::vector<uint8_t>& data) {
+    size_t padding = (4 - (4 + data.size()) % 4) % 4;
+    uint16_t length = static_cast<uint16_t>(2 + data.size() + padding);
+    uint16_t leaf = static_cast<uint16_t>(kind);
+    std::string record;
+    record.reserve(4 + data.size() + padding);
+    record.append(reinterpret_cast<const char*>(&length), 2);
+    record.append(reinterpret_cast<const char*>(&leaf), 2);
+    record.append(data.begin(), data.end());
+    for (size_t remaining = padding; remaining > 0; --remaining) {
+        record.push_back(static_cast<char>(0xF0 | remaining));
+    }
+    return record;
+}
+
+/**
+ * GHASH de un registro ya codificado: los campos de referencia se ponen a
+ * cero y después se encadena el hash de cada tipo referenciado, que da
+ * resolve(índice). Los tipos simples (< 0x1000) se mezclan tal cual.
+ */
+template <typename Resolve>
+uint64_t hashTypeRecord(std::string record, const std::vector<uint32_t>& referenceOffsets, Resolve resolve) {
+    std::vector<uint64_t> referenced;
+    for (uint32_t offset : referenceOffsets) {
+        size_t position = 4 + size_t{offset};    // Tras longitud y tipo
+        if (position + sizeof(uint32_t) > record.size()) continue;
+        uint32_t index;
+        std::memcpy(&index, record.data() + position, sizeof(index));
+        std::memset(record.data() + position, 0, sizeof(index));
+        referenced.push_back(index < CodeViewTypeTable::kFirstTypeIndex ? index : resolve(index));
+    }
+    uint64_t hash = common::utils::fnv1a64(record);
+    for (uint64_t value : referenced) {
+        hash = common::utils::hashMix(hash, value);
+    }
+    return hash;
+}
+
+std::vector<const DebugType*> sortedByIndex(const std::vector<DebugType>& types) {
+    std::vector<const DebugType*> ordered;
+    ordered.reserve(types.size());
+    for (const auto& type : types) {
+        ordered.push_back(&type);
+    }
+    std::stable_sort(ordered.begin(), ordered.end(),
+                     [](const DebugType* a, const DebugType* b) { return a->typeIndex < b->typeIndex; });
+    return ordered;
+}
+
+// Abre una función en .debug$S: lo que le sigue es suyo hasta el próximo
+bool startsFunction(CodeViewRecordType type) {
+    return type == CodeViewRecordType::S_GPROC32 || type == CodeViewRecordType::S_LPROC32;
+}
+
+bool isTopLevel(CodeViewRecordType type) {
+    return startsFunction(type) || type == CodeViewRecordType::S_GDATA32 ||
+           type == CodeViewRecordType::S_LDATA32 || type == CodeViewRecordType::S_PUB32;
+}
+
+// ---------------------------------------------------------------------------
+// MSF (Multi-Stream File): páginas de 4 KiB; la 0 es el superbloque y las
+// páginas 1 y 2 de cada intervalo de 4096 son los dos mapas de páginas libres
+// ---------------------------------------------------------------------------
+
+constexpr uint32_t kMsfBlockSize = 0x1000;
+constexpr char kMsfMagic[] = "Microsoft C/C++ MSF 7.00\r\n\x1A" "DS\0\0";   // 32 bytes con el 0 final
+constexpr uint32_t kPdbVersion = 20000404;                  // VC70
+constexpr uint32_t kPdbFeatureVC140 = 20140508;
+constexpr uint32_t kTpiVersion = 20040203;                  // V80
+constexpr uint32_t kDbiVersion = 19990903;                  // V70
+constexpr uint32_t kGsiVersion = 0xEFFE0000u + 19990810;
+constexpr uint32_t kGsiBuckets = 4096;                      // IPHR_HASH
+constexpr uint16_t kSymPub32 = 0x110E;                      // S_PUB32 de 32 bits
+constexpr uint16_t kMachineAmd64 = 0x8664;
+constexpr uint16_t kNoStream = 0xFFFF;
+
+// Streams del PDB, en el orden del directorio
+enum PDBStream : uint16_t {
+    kOldDirectoryStream,
+    kPdbInfoStream,
+    kTpiStream,
+    kDbiStream,
+    kIpiStream,
+    kSymbolRecordStream,
+    kGlobalHashStream,
+    kLineInfoStream,
+    kStreamCount
+};
+
+template <typename T>
+void putValue(std::vector<uint8_t>& out, T value) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+void putString(std::vector<uint8_t>& out, const std::string& text) {
+    out.insert(out.end(), text.begin(), text.end());
+    out.push_back(0);
+}
+
+// Cabecera de TPI/IPI: los registros van detrás, sin tabla de hashes
+std::vector<uint8_t> typeStreamHeader(uint32_t recordCount, uint32_t recordBytes) {
+    std::vector<uint8_t> header;
+    putValue(header, kTpiVersion);
+    putValue(header, uint32_t{56});
+    putValue(header, CodeViewTypeTable::kFirstTypeIndex);
+    putValue(header, CodeViewTypeTable::kFirstTypeIndex + recordCount);
+    putValue(header, recordBytes);
+    putValue(header, kNoStream);                            // Stream de hashes
+    putValue(header, kNoStream);                            // Stream auxiliar de hashes
+    putValue(header, uint32_t{4});                          // Tamaño de la clave
+    putValue(header, uint32_t{0x3FFFF});                    // Cubetas
+    header.resize(56, 0);                                   // Buffers de hashes vacíos
+    return header;
+}
+
+// Stream 1: versión, firma, edad y GUID; sin streams con nombre
+std::vector<uint8_t> pdbInfoStream(uint32_t signature, const common::utils::Hash128& guid) {
+    std::vector<uint8_t> stream;
+    putValue(stream, kPdbVersion);
+    putValue(stream, signature);
+    putValue(stream, uint32_t{1});                          // Edad
+    putValue(stream, guid.low);
+    putValue(stream, guid.high);
+    putValue(stream, uint32_t{0});                          // Bytes de nombres
+    putValue(stream, uint32_t{0});                          // Entradas de la tabla
+    putValue(stream, uint32_t{1});                          // Capacidad
+    putValue(stream, uint32_t{0});                          // Palabras del bitmap de presentes
+    putValue(stream, uint32_t{0});                          // Palabras del bitmap de borrados
+    putValue(stream, uint32_t{0});                          // niMac
+    putValue(stream, kPdbFeatureVC140);
+    return stream;
+}
+
+// hashStringV1 de la PDB: XOR de palabras de 4 bytes, sin distinguir mayúsculas
+uint32_t hashStringV1(std::string_view name) {
+    uint32_t result = 0;
+    size_t words = name.size() / 4;
+    for (size_t i = 0; i < words; ++i) {
+        uint32_t word;
+        std::memcpy(&word, name.data() + 4 * i, sizeof(word));
+        result ^= word;
+    }
+    const char* tail = name.data() + 4 * words;
+    size_t rest = name.size() % 4;
+    if (rest >= 2) {
+        uint16_t half;
+        std::memcpy(&half, tail, sizeof(half));
+        result ^= half;
+        tail += 2;
+        rest -= 2;
+    }
+    if (rest == 1) {
+        result ^= static_cast<uint8_t>(*tail);
+    }
+    result |= 0x20202020u;
+    result ^= result >> 11;
+    return result ^ (result >> 16);
+}
+
+bool isFreePageMapBlock(uint32_t block) {
+    uint32_t position = block % kMsfBlockSize;
+    return position == 1 || position == 2;
+}
+
+/**
+ * Páginas de cada stream, del directorio y del mapa del directorio,
+ * repartidas antes de escribir nada: cada stream se copia después a sus
+ * páginas sin depender de los demás.
+ */
+struct MSFLayout {
+    std::vector<std::vector<uint32_t>> streamBlocks;
+    std::vector<uint32_t> directoryBlocks;
+    uint32_t directorySize = 0;
+    uint32_t blockMapBlock = 0;
+    uint32_t blockCount = 0;
+};
+
+std::optional<MSFLayout> allocatePages(const std::vector<size_t>& streamSizes) {
+    MSFLayout layout;
+    uint64_t next = 3;
+    auto take = [&](uint64_t bytes) {
+        std::vector<uint32_t> blocks((bytes + kMsfBlockSize - 1) / kMsfBlockSize);
+        for (uint32_t& block : blocks) {
+            while (isFreePageMapBlock(static_cast<uint32_t>(next))) ++next;
+            block = static_cast<uint32_t>(next++);
+        }
+        return blocks;
+    };
+
+    uint64_t directorySize = 4 * (1 + uint64_t{streamSizes.size()});
+    for (size_t size : streamSizes) {
+        if (size > UINT32_MAX) return std::nullopt;
+        layout.streamBlocks.push_back(take(size));
+        directorySize += 4 * uint64_t{layout.streamBlocks.back().size()};
+    }
+    layout.directoryBlocks = take(directorySize);
+    // El mapa del directorio ocupa una sola página
+    if (layout.directoryBlocks.size() > kMsfBlockSize / 4) return std::nullopt;
+    layout.blockMapBlock = take(kMsfBlockSize).front();
+    if (next > UINT32_MAX) return std::nullopt;
+    layout.directorySize = static_cast<uint32_t>(directorySize);
+    layout.blockCount = static_cast<uint32_t>(next);
+    return layout;
+}
+
+// Copia bytes a las páginas dadas, una a una (los mapas de páginas libres cortan las rachas)
+void writeBlocks(uint8_t* file, const std::vector<uint32_t>& blocks, const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        size_t offset = i * kMsfBlockSize;
+        std::memcpy(file + size_t{blocks[i]} * kMsfBlockSize, data + offset,
+                    std::min<size_t>(kMsfBlockSize, size - offset));
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// CodeViewTypeTable - Implementación
+// ============================================================================
+
+std::unordered_map<uint32_t, uint32_t> CodeViewTypeTable::merge(const std::vector<DebugType>& types) {
+    std::vector<const DebugType*> ordered = sortedByIndex(types);
+
+    std::unordered_map<uint32_t, uint32_t> remap;
+    for (const DebugType* type : ordered) {
+        // Las referencias ya vistas pasan a índices de la tabla; las de
+        // tipos simples (< 0x1000) no cambian
+        std::vector<uint8_t> data = type->data;
+        for (uint32_t offset : type->referenceOffsets) {
+            if (offset + sizeof(uint32_t) > data.size()) continue;
+            uint32_t referenced;
+            std::memcpy(&referenced, data.data() + offset, sizeof(referenced));
+            auto it = remap.find(referenced);
+            if (it != remap.end()) {
+                std::memcpy(data.data() + offset, &it->second, sizeof(it->second));
+            }
+        }
+
+        auto [it, inserted] = indices_.try_emplace(encodeTypeRecord(type->type, data),
+                                                   kFirstTypeIndex + static_cast<uint32_t>(records_.size()));
+        if (inserted) {
+            records_.push_back(&it->first);
+            references_.push_back(type->referenceOffsets);
+        }
+        remap[type->typeIndex] = it->second;
+    }
+    return remap;
+}
+
+std::vector<uint8_t> CodeViewTypeTable::serialize() const {
+    std::vector<uint8_t> bytes;
+    for (const std::string* record : records_) {
+        bytes.insert(bytes.end(), record->begin(), record->end());
+    }
+    return bytes;
+}
+
+std::vector<uint64_t> CodeViewTypeTable::globalHashes() const {
+    // Las referencias apuntan siempre a registros anteriores
+    std::vector<uint64_t> hashes;
+    hashes.reserve(records_.size());
+    for (size_t i = 0; i < records_.size(); ++i) {
+        hashes.push_back(hashTypeRecord(*records_[i], references_[i], [&](uint32_t index) {
+            uint32_t position = index - kFirstTypeIndex;
+            return position < hashes.size() ? hashes[position] : uint64_t{index};
+        }));
+    }
+    return hashes;
+}
+
+std::vector<uint64_t> CodeViewTypeTable::hashTypes(const std::vector<DebugType>& types) {
+    std::unordered_map<uint32_t, uint64_t> byIndex;
+    std::vector<uint64_t> hashes;
+    hashes.reserve(types.size());
+    for (const DebugType* type : sortedByIndex(types)) {
+        uint64_t hash = hashTypeRecord(encodeTypeRecord(type->type, type->data), type->referenceOffsets,
+                                       [&](uint32_t index) {
+            auto it = byIndex.find(index);
+            return it != byIndex.end() ? it->second : uint64_t{index};
+        });
+        byIndex[type->typeIndex] = hash;
+        hashes.push_back(hash);
+    }
+    return hashes;
+}
+
+void CodeViewTypeTable::clear() {
+    indices_.clear();
+    records_.clear();
+    references_.clear();
+}
+
 // ============================================================================
 // SourceLineInfo - Implementación
 // ============================================================================
@@ -35,58 +347,144 @@ CodeViewEmitter::~CodeViewEmitter() = default;
 
 void CodeViewEmitter::addSourceFile(const std::filesystem::path& sourceFile,
                                   const std::vector<SourceLineInfo>& lineInfo) {
-    // Añadir índice de archivo
-    if (fileNameMap_.find(sourceFile.string()) == fileNameMap_.end()) {
-        fileNameMap_[sourceFile.string()] = nextFileIndex_++;
-    }
+    getFileIndex(sourceFile.string());
 
-    // Añadir información de línea
-    sourceLines_.insert(sourceLines_.end(), lineInfo.begin(), lineInfo.end());
+    auto compressed = compressLineInfo(lineInfo);
+    lineSubsections_.insert(lineSubsections_.end(), compressed.begin(), compressed.end());
+    lineCount_ += lineInfo.size();
+}
+
+void CodeViewEmitter::beginFunctionLines(uint32_t address) {
+    pendingLines_.clear();
+    functionAddress_ = address;
+}
+
+void CodeViewEmitter::addLine(const std::string& fileName, uint32_t address, uint32_t line) {
+    pendingLines_.emplace_back(fileName, line, address);
+}
+
+void CodeViewEmitter::endFunctionLines(uint32_t codeSize) {
+    if (!pendingLines_.empty()) {
+        // La tabla empieza en la función aunque su primera línea llegue después
+        if (pendingLines_.front().address != functionAddress_) {
+            pendingLines_.insert(pendingLines_.begin(),
+                                 SourceLineInfo(pendingLines_.front().fileName,
+                                                pendingLines_.front().lineNumber, functionAddress_));
+        }
+        auto compressed = compressLineInfo(pendingLines_, codeSize);
+        lineSubsections_.insert(lineSubsections_.end(), compressed.begin(), compressed.end());
+        lineCount_ += pendingLines_.size();
+    }
+    pendingLines_.clear();
 }
 
 void CodeViewEmitter::addDebugSymbol(const DebugSymbol& symbol) {
+    if (lineTablesOnly_) {
+        if (!startsFunction(symbol.type)) {
+            ++skippedRecords_;
+            return;
+        }
+        debugSymbols_.push_back(symbol);
+        debugSymbols_.back().typeIndex = 0;
+        return;
+    }
     debugSymbols_.push_back(symbol);
 }
 
-void CodeViewEmitter::addDebugType(const DebugType& type) {
+uint32_t CodeViewEmitter::addDebugType(const DebugType& type) {
+    if (lineTablesOnly_) {
+        ++skippedRecords_;
+        return 0;
+    }
     debugTypes_.push_back(type);
+    if (debugTypes_.back().typeIndex == 0) {
+        debugTypes_.back().typeIndex = nextTypeIndex_++;
+    } else {
+        nextTypeIndex_ = std::max(nextTypeIndex_, debugTypes_.back().typeIndex + 1);
+    }
+    typesMerged_ = false;
+    return debugTypes_.back().typeIndex;
+}
+
+void CodeViewEmitter::mergeTypes() {
+    if (typesMerged_) return;
+    typeTable_.clear();
+    typeIndexMap_ = typeTable_.merge(debugTypes_);
+    typesMerged_ = true;
+}
+
+uint32_t CodeViewEmitter::remapTypeIndex(uint32_t typeIndex) const {
+    auto it = typeIndexMap_.find(typeIndex);
+    return it != typeIndexMap_.end() ? it->second : typeIndex;
 }
 
 std::vector<uint8_t> CodeViewEmitter::generateDebugSSymbols() {
-    std::vector<uint8_t> debugS;
+    mergeTypes();
+
+    // Rangos [inicio, fin) de debugSymbols_: una función con sus símbolos,
+    // o un dato global suelto
+    std::vector<std::pair<size_t, size_t>> groups;
+    for (size_t begin = 0; begin < debugSymbols_.size();) {
+        size_t end = begin + 1;
+        while (end < debugSymbols_.size() && !isTopLevel(debugSymbols_[end].type)) {
+            ++end;
+        }
+        groups.emplace_back(begin, end);
+        begin = end;
+    }
 
-    // Header CodeView
-    const char* cvHeader = "Microsoft C/C++ MSF 7.00\r\n\x1A\x44\x53";
-    debugS.insert(debugS.end(), cvHeader, cvHeader + 31);
+    std::vector<std::vector<uint8_t>> subsections(groups.size());
+    common::utils::parallelFor(groups.size(), jobs_, [&](size_t index) {
+        auto [begin, end] = groups[index];
+        std::vector<uint8_t> records;
+        for (size_t i = begin; i < end; ++i) {
+            auto serialized = serializeSymbol(debugSymbols_[i]);
+            records.insert(records.end(), serialized.begin(), serialized.end());
+        }
+        if (startsFunction(debugSymbols_[begin].type)) {
+            const uint8_t endRecord[] = {0x02, 0x00, static_cast<uint8_t>(CodeViewRecordType::S_END), 0x00};
+            records.insert(records.end(), std::begin(endRecord), std::end(endRecord));
+        }
 
-    uint32_t version = 4; // CV 7.00
-    const uint8_t* verBytes = reinterpret_cast<const uint8_t*>(&version);
-    debugS.insert(debugS.end(), verBytes, verBytes + 4);
+        auto& subsection = subsections[index];
+        subsection = createSubsectionHeader(kDebugSSymbols, static_cast<uint32_t>(records.size()));
+        subsection.insert(subsection.end(), records.begin(), records.end());
+        subsection.resize((subsection.size() + 3) & ~size_t{3}, 0);
+    });
 
-    // Generar símbolos
-    for (const auto& symbol : debugSymbols_) {
-        auto serialized = serializeSymbol(symbol);
-        debugS.insert(debugS.end(), serialized.begin(), serialized.end());
+    std::vector<uint8_t> debugS(sizeof(kCodeViewSignature));
+    std::memcpy(debugS.data(), &kCodeViewSignature, sizeof(kCodeViewSignature));
+    for (const auto& subsection : subsections) {
+        debugS.insert(debugS.end(), subsection.begin(), subsection.end());
     }
-
     return debugS;
 }
 
 std::vector<uint8_t> CodeViewEmitter::generateDebugTTypes() {
-    std::vector<uint8_t> debugT;
+    if (lineTablesOnly_) return {};
+    mergeTypes();
 
-    // Header de tipos CodeView
-    uint32_t signature = 0x00000004; // CV 7.00
-    const uint8_t* sigBytes = reinterpret_cast<const uint8_t*>(&signature);
-    debugT.insert(debugT.end(), sigBytes, sigBytes + 4);
+    std::vector<uint8_t> debugT(sizeof(kCodeViewSignature));
+    std::memcpy(debugT.data(), &kCodeViewSignature, sizeof(kCodeViewSignature));
+    std::vector<uint8_t> records = typeTable_.serialize();
+    debugT.insert(debugT.end(), records.begin(), records.end());
+    return debugT;
+}
 
-    // Generar tipos
-    for (const auto& type : debugTypes_) {
-        auto serialized = serializeType(type);
-        debugT.insert(debugT.end(), serialized.begin(), serialized.end());
+std::vector<uint8_t> CodeViewEmitter::generateDebugHHashes() {
+    if (lineTablesOnly_) return {};
+    mergeTypes();
+
+    std::vector<uint64_t> hashes = typeTable_.globalHashes();
+    std::vector<uint8_t> debugH(8 + hashes.size() * sizeof(uint64_t));
+    uint16_t version = 0;
+    std::memcpy(debugH.data(), &kGHashMagic, 4);
+    std::memcpy(debugH.data() + 4, &version, 2);
+    std::memcpy(debugH.data() + 6, &kGHashFnv1a64, 2);
+    if (!hashes.empty()) {
+        std::memcpy(debugH.data() + 8, hashes.data(), hashes.size() * sizeof(uint64_t));
     }
-
-    return debugT;
+    return debugH;
 }
 
 std::vector<uint8_t> CodeViewEmitter::generateDebugFFiles() {
@@ -107,6 +505,10 @@ std::vector<uint8_t> CodeViewEmitter::generateDebugFFiles() {
         // Nombre del archivo
         debugF.insert(debugF.end(), fileName.begin(), fileName.end());
         debugF.push_back(0); // Null terminator
+
+        // Checksum del contenido, calculado al registrar el archivo
+        const uint8_t* sumBytes = reinterpret_cast<const uint8_t*>(&fileChecksums_[index - 1]);
+        debugF.insert(debugF.end(), sumBytes, sumBytes + 4);
     }
 
     return debugF;
@@ -120,9 +522,8 @@ std::vector<uint8_t> CodeViewEmitter::generateLineNumbers() {
     const uint8_t* sigBytes = reinterpret_cast<const uint8_t*>(&signature);
     lineNumbers.insert(lineNumbers.end(), sigBytes, sigBytes + 4);
 
-    // Generar información de línea comprimida
-    auto compressed = compressLineInfo(sourceLines_);
-    lineNumbers.insert(lineNumbers.end(), compressed.begin(), compressed.end());
+    // Subsecciones ya comprimidas, en el orden en que se cerraron
+    lineNumbers.insert(lineNumbers.end(), lineSubsections_.begin(), lineSubsections_.end());
 
     return lineNumbers;
 }
@@ -134,18 +535,28 @@ void CodeViewEmitter::setTargetArchitecture(const std::string& arch) {
 void CodeViewEmitter::clear() {
     debugSymbols_.clear();
     debugTypes_.clear();
-    sourceLines_.clear();
+    pendingLines_.clear();
+    lineSubsections_.clear();
+    lineCount_ = 0;
+    functionAddress_ = 0;
     fileNameMap_.clear();
+    fileChecksums_.clear();
     nextTypeIndex_ = 0x1000;
     nextFileIndex_ = 1;
+    typeTable_.clear();
+    typeIndexMap_.clear();
+    typesMerged_ = false;
+    skippedRecords_ = 0;
 }
 
 std::unordered_map<std::string, size_t> CodeViewEmitter::getDebugStatistics() const {
     return {
         {"debug_symbols", debugSymbols_.size()},
         {"debug_types", debugTypes_.size()},
-        {"source_lines", sourceLines_.size()},
-        {"source_files", fileNameMap_.size()}
+        {"unique_types", typeTable_.size()},
+        {"source_lines", lineCount_},
+        {"source_files", fileNameMap_.size()},
+        {"skipped_records", skippedRecords_}
     };
 }
 
@@ -163,19 +574,19 @@ std::vector<uint8_t> CodeViewEmitter::createSubsectionHeader(uint32_t type, uint
     return header;
 }
 
-std::vector<uint8_t> CodeViewEmitter::serializeSymbol(const DebugSymbol& symbol) {
+std::vector<uint8_t> CodeViewEmitter::serializeSymbol(const DebugSymbol& symbol) const {
     std::vector<uint8_t> data;
 
-    // Tipo de registro
-    uint16_t recordType = static_cast<uint16_t>(symbol.type);
-    const uint8_t* typeBytes = reinterpret_cast<const uint8_t*>(&recordType);
-    data.insert(data.end(), typeBytes, typeBytes + 2);
-
     // Longitud (se calcula después)
     uint16_t length = 0;
     const uint8_t* lenBytes = reinterpret_cast<const uint8_t*>(&length);
     data.insert(data.end(), lenBytes, lenBytes + 2);
 
+    // Tipo de registro
+    uint16_t recordType = static_cast<uint16_t>(symbol.type);
+    const uint8_t* typeBytes = reinterpret_cast<const uint8_t*>(&recordType);
+    data.insert(data.end(), typeBytes, typeBytes + 2);
+
     // Datos específicos del símbolo
     switch (symbol.type) {
         case CodeViewRecordType::S_GPROC32: {
@@ -186,7 +597,7 @@ std::vector<uint8_t> CodeViewEmitter::serializeSymbol(const DebugSymbol& symbol)
             uint32_t procLen = symbol.size;
             uint32_t debugStart = symbol.address;
             uint32_t debugEnd = symbol.address + symbol.size;
-            uint32_t typeIndex = 0; // TODO: calcular índice de tipo
+            uint32_t typeIndex = remapTypeIndex(symbol.typeIndex);
             uint8_t flags = 0;
 
             const uint8_t* parentBytes = reinterpret_cast<const uint8_t*>(&pParent);
@@ -221,7 +632,7 @@ std::vector<uint8_t> CodeViewEmitter::serializeSymbol(const DebugSymbol& symbol)
 
         case CodeViewRecordType::S_GDATA32: {
             // Global data, 32-bit
-            uint32_t typeIndex = 0; // TODO: calcular índice de tipo
+            uint32_t typeIndex = remapTypeIndex(symbol.typeIndex);
 
             const uint8_t* typeBytes = reinterpret_cast<const uint8_t*>(&typeIndex);
             data.insert(data.end(), typeBytes, typeBytes + 4);
@@ -242,54 +653,31 @@ std::vector<uint8_t> CodeViewEmitter::serializeSymbol(const DebugSymbol& symbol)
             break;
     }
 
-    // Actualizar longitud
-    length = static_cast<uint16_t>(data.size() - 4); // -4 para type y length
-    std::memcpy(&data[2], &length, 2);
+    // Registros alineados a 4; la longitud no cuenta su propio campo
+    data.resize((data.size() + 3) & ~size_t{3}, 0);
+    length = static_cast<uint16_t>(data.size() - 2);
+    std::memcpy(&data[0], &length, 2);
 
     return data;
 }
 
 std::vector<uint8_t> CodeViewEmitter::serializeType(const DebugType& type) {
-    std::vector<uint8_t> data;
-
-    // Tipo de registro
-    uint16_t recordType = static_cast<uint16_t>(type.type);
-    const uint8_t* typeBytes = reinterpret_cast<const uint8_t*>(&recordType);
-    data.insert(data.end(), typeBytes, typeBytes + 2);
-
-    // Longitud
-    uint16_t length = static_cast<uint16_t>(type.data.size());
-    const uint8_t* lenBytes = reinterpret_cast<const uint8_t*>(&length);
-    data.insert(data.end(), lenBytes, lenBytes + 2);
-
-    // Datos del tipo
-    data.insert(data.end(), type.data.begin(), type.data.end());
-
-    return data;
-}
-
-std::vector<uint8_t> CodeViewEmitter::serializeLineInfo(const SourceLineInfo& lineInfo) {
-    std::vector<uint8_t> data;
-
-    // Índice de archivo
-    uint32_t fileIndex = getFileIndex(lineInfo.fileName);
-    const uint8_t* fileBytes = reinterpret_cast<const uint8_t*>(&fileIndex);
-    data.insert(data.end(), fileBytes, fileBytes + 4);
-
-    // Número de línea
-    const uint8_t* lineBytes = reinterpret_cast<const uint8_t*>(&lineInfo.lineNumber);
-    data.insert(data.end(), lineBytes, lineBytes + 4);
-
-    // Dirección
-    const uint8_t* addrBytes = reinterpret_cast<const uint8_t*>(&lineInfo.address);
-    data.insert(data.end(), addrBytes, addrBytes + 4);
-
-    return data;
+    std::string record = encodeTypeRecord(type.type, type.data);
+    return std::vector<uint8_t>(record.begin(), record.end());
 }
 
 uint32_t CodeViewEmitter::getFileIndex(const std::string& fileName) {
-    auto it = fileNameMap_.find(fileName);
-    return (it != fileNameMap_.end()) ? it->second : 0;
+    auto [it, inserted] = fileNameMap_.try_emplace(fileName, nextFileIndex_);
+    if (inserted) {
+        ++nextFileIndex_;
+        std::vector<uint8_t> contents;
+        std::ifstream file(fileName, std::ios::binary);
+        if (file) {
+            contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+        fileChecksums_.push_back(calculateChecksum(contents));
+    }
+    return it->second;
 }
 
 uint32_t CodeViewEmitter::calculateChecksum(const std::vector<uint8_t>& data) {
@@ -301,19 +689,49 @@ uint32_t CodeViewEmitter::calculateChecksum(const std::vector<uint8_t>& data) {
     return checksum;
 }
 
-std::vector<uint8_t> CodeViewEmitter::compressLineInfo(const std::vector<SourceLineInfo>& lines) {
+std::vector<uint8_t> CodeViewEmitter::compressLineInfo(const std::vector<SourceLineInfo>& lines, uint32_t codeSize) {
     std::vector<uint8_t> compressed;
 
     if (lines.empty()) return compressed;
 
-    // Implementación simplificada de compresión
-    // En un compilador real, se usaría un algoritmo más sofisticado
+    auto append = [](std::vector<uint8_t>& out, uint32_t value) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), bytes, bytes + 4);
+    };
 
-    for (const auto& line : lines) {
-        auto serialized = serializeLineInfo(line);
-        compressed.insert(compressed.end(), serialized.begin(), serialized.end());
+    uint32_t base = lines.front().address;
+    if (codeSize == 0) codeSize = lines.back().address - base;
+
+    // Cabecera: offCon (reubicado al enlazar), segCon y flags = 0 (sin columnas), cbCon
+    std::vector<uint8_t> body;
+    append(body, base);
+    append(body, 0);
+    append(body, codeSize);
+
+    for (size_t begin = 0; begin < lines.size();) {
+        size_t end = begin;
+        std::vector<uint8_t> entries;
+        uint32_t count = 0;
+        uint32_t previousLine = 0;
+        while (end < lines.size() && lines[end].fileName == lines[begin].fileName) {
+            const auto& line = lines[end++];
+            if (count > 0 && line.lineNumber == previousLine) continue;
+            append(entries, line.address - base);
+            append(entries, (line.lineNumber & 0x00FFFFFFu) | kLineIsStatement);
+            previousLine = line.lineNumber;
+            ++count;
+        }
+
+        append(body, getFileIndex(lines[begin].fileName));
+        append(body, count);
+        append(body, 12 + static_cast<uint32_t>(entries.size()));
+        body.insert(body.end(), entries.begin(), entries.end());
+        begin = end;
     }
 
+    compressed = createSubsectionHeader(kDebugSLines, static_cast<uint32_t>(body.size()));
+    compressed.insert(compressed.end(), body.begin(), body.end());
+    compressed.resize((compressed.size() + 3) & ~size_t{3}, 0);
     return compressed;
 }
 
@@ -331,38 +749,95 @@ void PDBGenerator::addDebugInfo(const DebugObjectFile& debugInfo) {
 }
 
 bool PDBGenerator::generatePDB(const std::filesystem::path& pdbPath) {
-    // En una implementación real, aquí se crearía un archivo PDB completo
-    // con múltiples streams según el formato MSF (Multi-Stream File)
-
-    // Por simplicidad, creamos un archivo básico
-    std::ofstream file(pdbPath, std::ios::binary);
-    if (!file.is_open()) {
-        return false;
-    }
-
     try {
-        // Header PDB básico
-        const char* pdbHeader = "Microsoft C/C++ PDB 7.00\r\n\x1A\x4A\x53";
-        file.write(pdbHeader, 28);
-
-        // Timestamp
-        file.write(reinterpret_cast<const char*>(&timestamp_), sizeof(timestamp_));
-
-        // Tamaño de página
-        uint32_t pageSize = 0x1000;
-        file.write(reinterpret_cast<const char*>(&pageSize), sizeof(pageSize));
-
-        // Número de páginas de directorio
-        uint32_t numDirPages = 1;
-        file.write(reinterpret_cast<const char*>(&numDirPages), sizeof(numDirPages));
+        // 1. Los streams grandes se construyen a la vez; cada uno reparte además su trabajo
+        std::vector<std::vector<uint8_t>> streams(kStreamCount);
+        const std::function<void()> builders[] = {
+            [&] { streams[kTpiStream] = createTypeStream(); },
+            [&] { streams[kDbiStream] = createModuleInfoStream(); },
+            [&] {
+                streams[kSymbolRecordStream] = createGlobalSymbolStream();
+                streams[kGlobalHashStream] = createGlobalHashStream(streams[kSymbolRecordStream]);
+            },
+            [&] { streams[kLineInfoStream] = createLineInfoStream(); },
+        };
+        common::utils::parallelFor(std::size(builders), jobs_, [&](size_t b) { builders[b](); });
+        streams[kIpiStream] = typeStreamHeader(0, 0);
+
+        // El GUID sale del contenido: el mismo programa da el mismo PDB
+        auto contentHash = [](const std::vector<uint8_t>& data) {
+            return common::utils::hash128(std::string_view(reinterpret_cast<const char*>(data.data()), data.size()));
+        };
+        common::utils::Hash128 guid = contentHash(streams[kTpiStream]);
+        common::utils::Hash128 symbols = contentHash(streams[kSymbolRecordStream]);
+        guid.low = common::utils::hashMix(guid.low, symbols.low);
+        guid.high = common::utils::hashMix(guid.high, symbols.high);
+        streams[kPdbInfoStream] = pdbInfoStream(timestamp_, guid);
+
+        // 2. Páginas de todo el archivo antes de escribir
+        std::vector<size_t> sizes;
+        for (const auto& stream : streams) {
+            sizes.push_back(stream.size());
+        }
+        std::optional<MSFLayout> layout = allocatePages(sizes);
+        if (!layout) {
+            return false;
+        }
+        size_t fileSize = size_t{layout->blockCount} * kMsfBlockSize;
 
-        // Placeholder para datos adicionales
-        uint32_t zero = 0;
-        for (int i = 0; i < 10; ++i) {
-            file.write(reinterpret_cast<const char*>(&zero), sizeof(zero));
+        // Sin proyección (sistema de archivos que no la admite): un buffer del tamaño final
+        auto output = common::utils::MappedOutputFile::create(pdbPath, fileSize);
+        std::vector<uint8_t> buffer;
+        if (!output) {
+            buffer.resize(fileSize);
+        }
+        uint8_t* file = output ? reinterpret_cast<uint8_t*>(output->data()) : buffer.data();
+
+        // 3. Cada stream va a sus páginas en paralelo y se libera en cuanto está escrito
+        common::utils::parallelFor(streams.size(), jobs_, [&](size_t s) {
+            writeBlocks(file, layout->streamBlocks[s], streams[s].data(), streams[s].size());
+            std::vector<uint8_t>().swap(streams[s]);
+        });
+
+        std::vector<uint8_t> directory;
+        putValue(directory, static_cast<uint32_t>(sizes.size()));
+        for (size_t size : sizes) {
+            putValue(directory, static_cast<uint32_t>(size));
+        }
+        for (const auto& blocks : layout->streamBlocks) {
+            for (uint32_t block : blocks) {
+                putValue(directory, block);
+            }
+        }
+        writeBlocks(file, layout->directoryBlocks, directory.data(), directory.size());
+        std::memcpy(file + size_t{layout->blockMapBlock} * kMsfBlockSize, layout->directoryBlocks.data(),
+                    layout->directoryBlocks.size() * sizeof(uint32_t));
+
+        // Mapa de páginas libres (bit a 1 = libre): la primera página de cada intervalo
+        // cubre 8 * 4096 páginas; todo lo que está detrás de la última queda libre
+        uint64_t mappedBlocks = (uint64_t{layout->blockCount} + 8 * kMsfBlockSize - 1) / (8 * kMsfBlockSize) *
+                                (8 * kMsfBlockSize);
+        for (uint64_t block = layout->blockCount; block < mappedBlocks; ++block) {
+            uint64_t byte = block / 8;
+            uint64_t page = 1 + byte / kMsfBlockSize * kMsfBlockSize;
+            if (page >= layout->blockCount) break;
+            file[page * kMsfBlockSize + byte % kMsfBlockSize] |= static_cast<uint8_t>(1u << (block % 8));
         }
 
-        file.close();
+        std::vector<uint8_t> superBlock(kMsfMagic, kMsfMagic + sizeof(kMsfMagic));
+        putValue(superBlock, kMsfBlockSize);
+        putValue(superBlock, uint32_t{1});                  // Mapa de páginas libres activo
+        putValue(superBlock, layout->blockCount);
+        putValue(superBlock, layout->directorySize);
+        putValue(superBlock, uint32_t{0});
+        putValue(superBlock, layout->blockMapBlock);
+        std::memcpy(file, superBlock.data(), superBlock.size());
+
+        if (!output) {
+            std::ofstream out(pdbPath, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+            return out.good();
+        }
         return true;
 
     } catch (const std::exception&) {
@@ -379,43 +854,235 @@ void PDBGenerator::setTimestamp(uint32_t timestamp) {
 }
 
 std::vector<uint8_t> PDBGenerator::createModuleInfoStream() {
-    std::vector<uint8_t> stream;
+    // Un módulo por objeto, sin stream propio de símbolos
+    std::vector<std::vector<uint8_t>> modules(debugObjects_.size());
+    common::utils::parallelFor(modules.size(), jobs_, [&](size_t m) {
+        auto& module = modules[m];
+        putValue(module, uint32_t{0});
+        putValue(module, uint16_t{0xFFFF});                 // Contribución: sin sección
+        module.resize(32, 0);
+        putValue(module, uint16_t{0});                      // Flags
+        putValue(module, kNoStream);
+        module.resize(64, 0);                               // Tamaños, archivos y nombres
+        std::string name = debugObjects_[m].path.string();
+        putString(module, name);
+        putString(module, name);
+        module.resize((module.size() + 3) & ~size_t{3}, 0);
+    });
+    size_t moduleInfoSize = 0;
+    for (const auto& module : modules) {
+        moduleInfoSize += module.size();
+    }
 
-    // En una implementación real, aquí se crearían los streams del PDB:
-    // - Stream 0: PDB info
-    // - Stream 1: TPI (Type Program Interface)
-    // - Stream 2: DBI (Debug Info)
-    // - Stream 3: IPI (Item Program Interface)
-    // - Etc.
+    // Archivos fuente por módulo: ninguno, pero los lectores cuentan los módulos aquí
+    std::vector<uint8_t> fileInfo;
+    putValue(fileInfo, static_cast<uint16_t>(modules.size()));
+    putValue(fileInfo, uint16_t{0});
+    fileInfo.resize(fileInfo.size() + 4 * modules.size(), 0);
+    fileInfo.resize((fileInfo.size() + 3) & ~size_t{3}, 0);
 
+    std::vector<uint8_t> stream;
+    stream.reserve(64 + moduleInfoSize + fileInfo.size());
+    putValue(stream, uint32_t{0xFFFFFFFF});
+    putValue(stream, kDbiVersion);
+    putValue(stream, uint32_t{1});                          // Edad
+    putValue(stream, static_cast<uint16_t>(kGlobalHashStream));
+    putValue(stream, uint16_t{0x8E00});                     // Versión del enlazador: 14.0, formato nuevo
+    putValue(stream, kNoStream);                            // Públicos
+    putValue(stream, uint16_t{0});
+    putValue(stream, static_cast<uint16_t>(kSymbolRecordStream));
+    putValue(stream, uint16_t{0});
+    putValue(stream, static_cast<uint32_t>(moduleInfoSize));
+    putValue(stream, uint32_t{0});                          // Contribuciones de sección
+    putValue(stream, uint32_t{0});                          // Mapa de secciones
+    putValue(stream, static_cast<uint32_t>(fileInfo.size()));
+    stream.resize(56, 0);                                   // Resto de subflujos vacíos
+    putValue(stream, uint16_t{0});                          // Flags
+    putValue(stream, kMachineAmd64);
+    putValue(stream, uint32_t{0});
+    for (const auto& module : modules) {
+        stream.insert(stream.end(), module.begin(), module.end());
+    }
+    stream.insert(stream.end(), fileInfo.begin(), fileInfo.end());
     return stream;
 }
 
 std::vector<uint8_t> PDBGenerator::createGlobalSymbolStream() {
+    // S_PUB32 de cada símbolo de primer nivel con nombre, en orden de objetos
+    std::vector<std::vector<uint8_t>> records(debugObjects_.size());
+    common::utils::parallelFor(records.size(), jobs_, [&](size_t o) {
+        for (const auto& symbol : debugObjects_[o].symbols) {
+            if (!isTopLevel(symbol.type) || symbol.name.empty()) continue;
+            size_t start = records[o].size();
+            auto& out = records[o];
+            putValue(out, uint16_t{0});
+            putValue(out, kSymPub32);
+            putValue(out, uint32_t{startsFunction(symbol.type) ? 2u : 0u});   // cvpsfFunction
+            putValue(out, symbol.address);
+            putValue(out, uint16_t{1});                     // Sección
+            putString(out, symbol.name);
+            out.resize((out.size() + 3) & ~size_t{3}, 0);
+            uint16_t length = static_cast<uint16_t>(out.size() - start - 2);
+            std::memcpy(out.data() + start, &length, sizeof(length));
+        }
+    });
+
     std::vector<uint8_t> stream;
+    for (const auto& object : records) {
+        stream.insert(stream.end(), object.begin(), object.end());
+    }
+    return stream;
+}
 
-    // Stream de símbolos globales
-    for (const auto& obj : debugObjects_) {
-        for (const auto& symbol : obj.symbols) {
-            // Serializar símbolo para PDB
-            // Implementación simplificada
+std::vector<uint8_t> PDBGenerator::createGlobalHashStream(const std::vector<uint8_t>& symbols) {
+    struct Entry {
+        std::string_view name;
+        uint32_t offset;
+        uint32_t bucket = 0;
+    };
+
+    // Registros S_PUB32: longitud, tipo, flags, offset y sección antes del nombre
+    std::vector<Entry> entries;
+    for (size_t offset = 0; offset + 4 <= symbols.size();) {
+        uint16_t length;
+        std::memcpy(&length, symbols.data() + offset, sizeof(length));
+        const char* name = reinterpret_cast<const char*>(symbols.data() + offset + 14);
+        entries.push_back({std::string_view(name, ::strnlen(name, length - 12)), static_cast<uint32_t>(offset)});
+        offset += 2 + size_t{length};
+    }
+    common::utils::parallelFor(entries.size(), jobs_, [&](size_t e) {
+        entries[e].bucket = hashStringV1(entries[e].name) % kGsiBuckets;
+    });
+
+    // Cada hilo recoge y ordena su rango de cubetas; juntos quedan en orden de cubeta
+    size_t shardCount = std::min<size_t>(jobs_, kGsiBuckets);
+    std::vector<std::vector<const Entry*>> shards(shardCount);
+    common::utils::parallelFor(shardCount, jobs_, [&](size_t s) {
+        uint32_t first = static_cast<uint32_t>(s * kGsiBuckets / shardCount);
+        uint32_t last = static_cast<uint32_t>((s + 1) * kGsiBuckets / shardCount);
+        for (const Entry& entry : entries) {
+            if (entry.bucket >= first && entry.bucket < last) {
+                shards[s].push_back(&entry);
+            }
+        }
+        std::stable_sort(shards[s].begin(), shards[s].end(), [](const Entry* a, const Entry* b) {
+            return a->bucket != b->bucket ? a->bucket < b->bucket : a->name < b->name;
+        });
+    });
+
+    std::vector<uint8_t> records;
+    std::vector<uint32_t> bitmap((kGsiBuckets + 32) / 32, 0);
+    std::vector<uint32_t> bucketStarts;
+    uint32_t index = 0;
+    for (const auto& shard : shards) {
+        for (const Entry* entry : shard) {
+            putValue(records, entry->offset + 1);
+            putValue(records, uint32_t{1});                 // Referencias
+            if (!(bitmap[entry->bucket / 32] & (1u << (entry->bucket % 32)))) {
+                bitmap[entry->bucket / 32] |= 1u << (entry->bucket % 32);
+                bucketStarts.push_back(index * 12);         // Tamaño de HROffsetCalc en el lector
+            }
+            ++index;
         }
     }
 
+    std::vector<uint8_t> stream;
+    putValue(stream, uint32_t{0xFFFFFFFF});
+    putValue(stream, kGsiVersion);
+    putValue(stream, static_cast<uint32_t>(records.size()));
+    putValue(stream, static_cast<uint32_t>((bitmap.size() + bucketStarts.size()) * sizeof(uint32_t)));
+    stream.insert(stream.end(), records.begin(), records.end());
+    for (uint32_t word : bitmap) {
+        putValue(stream, word);
+    }
+    for (uint32_t start : bucketStarts) {
+        putValue(stream, start);
+    }
     return stream;
 }
 
 std::vector<uint8_t> PDBGenerator::createTypeStream() {
-    std::vector<uint8_t> stream;
+    struct ObjectTypes {
+        std::vector<const DebugType*> ordered;
+        std::vector<uint64_t> hashes;
+        std::unordered_map<uint32_t, uint32_t> positions;    // typeIndex local -> posición en ordered
+    };
+    struct Owner {
+        uint32_t object;
+        uint32_t position;
+        uint32_t index = 0;                                   // Índice en el stream (TPI)
+    };
 
-    // Stream de tipos
-    for (const auto& obj : debugObjects_) {
-        for (const auto& type : obj.types) {
-            // Serializar tipo para PDB
-            // Implementación simplificada
+    // 1. Hashes globales: los de .debug$H o, si faltan, calculados aquí
+    std::vector<ObjectTypes> objects(debugObjects_.size());
+    common::utils::parallelFor(objects.size(), jobs_, [&](size_t o) {
+        const auto& obj = debugObjects_[o];
+        auto& types = objects[o];
+        types.ordered = sortedByIndex(obj.types);
+        types.hashes = obj.typeHashes.size() == obj.types.size() ? obj.typeHashes
+                                                                  : CodeViewTypeTable::hashTypes(obj.types);
+        for (size_t i = 0; i < types.ordered.size(); ++i) {
+            types.positions[types.ordered[i]->typeIndex] = static_cast<uint32_t>(i);
+        }
+    });
+
+    // 2. Cada tabla se queda con su rango de hashes; la primera aparición
+    //    en orden de objetos es la que cuenta
+    size_t shardCount = jobs_;
+    std::vector<std::unordered_map<uint64_t, Owner>> shards(shardCount);
+    common::utils::parallelFor(shardCount, jobs_, [&](size_t s) {
+        for (size_t o = 0; o < objects.size(); ++o) {
+            const auto& hashes = objects[o].hashes;
+            for (size_t i = 0; i < hashes.size(); ++i) {
+                if (hashes[i] % shardCount == s) {
+                    shards[s].try_emplace(hashes[i], Owner{static_cast<uint32_t>(o), static_cast<uint32_t>(i)});
+                }
+            }
+        }
+    });
+
+    // 3. Índices en orden de aparición, como los asignaría una fusión secuencial
+    std::vector<Owner*> records;
+    for (size_t o = 0; o < objects.size(); ++o) {
+        const auto& hashes = objects[o].hashes;
+        for (size_t i = 0; i < hashes.size(); ++i) {
+            Owner& owner = shards[hashes[i] % shardCount].at(hashes[i]);
+            if (owner.object == o && owner.position == i) {
+                owner.index = CodeViewTypeTable::kFirstTypeIndex + static_cast<uint32_t>(records.size());
+                records.push_back(&owner);
+            }
         }
     }
 
+    // 4. Serializar cada registro con sus referencias traducidas al stream
+    std::vector<std::string> encoded(records.size());
+    common::utils::parallelFor(records.size(), jobs_, [&](size_t r) {
+        const auto& types = objects[records[r]->object];
+        const DebugType& type = *types.ordered[records[r]->position];
+        std::vector<uint8_t> data = type.data;
+        for (uint32_t offset : type.referenceOffsets) {
+            if (offset + sizeof(uint32_t) > data.size()) continue;
+            uint32_t referenced;
+            std::memcpy(&referenced, data.data() + offset, sizeof(referenced));
+            auto it = types.positions.find(referenced);
+            if (referenced < CodeViewTypeTable::kFirstTypeIndex || it == types.positions.end()) continue;
+            uint64_t hash = types.hashes[it->second];
+            uint32_t index = shards[hash % shardCount].at(hash).index;
+            std::memcpy(data.data() + offset, &index, sizeof(index));
+        }
+        encoded[r] = encodeTypeRecord(type.type, data);
+    });
+
+    size_t recordBytes = 0;
+    for (const auto& record : encoded) {
+        recordBytes += record.size();
+    }
+    std::vector<uint8_t> stream = typeStreamHeader(static_cast<uint32_t>(encoded.size()),
+                                                   static_cast<uint32_t>(recordBytes));
+    stream.reserve(stream.size() + recordBytes);
+    for (const auto& record : encoded) {
+        stream.insert(stream.end(), record.begin(), record.end());
+    }
     return stream;
 }
 
@@ -434,10 +1101,8 @@ std::vector<uint8_t> PDBGenerator::createLineInfoStream() {
 }
 
 std::string PDBGenerator::calculateContentHash(const std::vector<uint8_t>& data) {
-    // Implementación simplificada de hash
-    std::hash<std::string> hasher;
-    std::string dataStr(data.begin(), data.end());
-    return std::to_string(hasher(dataStr));
+    return common::utils::hash128(
+        std::string_view(reinterpret_cast<const char*>(data.data()), data.size())).toHex();
 }
 
 // ============================================================================
@@ -554,6 +1219,23 @@ std::string CodeViewUtils::formatRecord(const std::vector<uint8_t>& record) {
     return ss.str();
 }
 
+bool CodeViewUtils::parseGlobalHashes(const std::vector<uint8_t>& section, std::vector<uint64_t>& hashes) {
+    if (section.size() < 8 || (section.size() - 8) % sizeof(uint64_t) != 0) return false;
+
+    uint32_t magic;
+    uint16_t version, algorithm;
+    std::memcpy(&magic, section.data(), 4);
+    std::memcpy(&version, section.data() + 4, 2);
+    std::memcpy(&algorithm, section.data() + 6, 2);
+    if (magic != kGHashMagic || version != 0 || algorithm != kGHashFnv1a64) return false;
+
+    hashes.resize((section.size() - 8) / sizeof(uint64_t));
+    if (!hashes.empty()) {
+        std::memcpy(hashes.data(), section.data() + 8, hashes.size() * sizeof(uint64_t));
+    }
+    return true;
+}
+
 // ============================================================================
 // DebugIntegration - Implementación
 // ============================================================================
@@ -570,6 +1252,7 @@ void DebugIntegration::enableDebugGeneration(bool enable) {
 
 void DebugIntegration::setDebugLevel(int level) {
     debugLevel_ = level;
+    codeViewEmitter_.setLineTablesOnly(level == 1);
 }
 
 void DebugIntegration::addDebugInfoFromAST(const ast::ASTNode* node,
@@ -600,12 +1283,14 @@ std::vector<uint8_t> DebugIntegration::generateCompleteDebugInfo() {
     // Generar información de debug completa
     auto debugS = codeViewEmitter_.generateDebugSSymbols();
     auto debugT = codeViewEmitter_.generateDebugTTypes();
+    auto debugH = codeViewEmitter_.generateDebugHHashes();
     auto debugF = codeViewEmitter_.generateDebugFFiles();
 
     // Combinar todas las secciones
     std::vector<uint8_t> completeDebug;
     completeDebug.insert(completeDebug.end(), debugS.begin(), debugS.end());
     completeDebug.insert(completeDebug.end(), debugT.begin(), debugT.end());
+    completeDebug.insert(completeDebug.end(), debugH.begin(), debugH.end());
     completeDebug.insert(completeDebug.end(), debugF.begin(), debugF.end());
 
     return completeDebug;
@@ -642,8 +1327,9 @@ void DebugIntegration::processFunctionForDebug(const ast::ASTNode* func,
 
     // Añadir información de línea
     auto lineInfo = extractSourceLocation(func, sourceFile);
-    std::vector<SourceLineInfo> lines = {lineInfo};
-    codeViewEmitter_.addSourceFile(sourceFile, lines);
+    codeViewEmitter_.beginFunctionLines(funcSymbol.address);
+    codeViewEmitter_.addLine(lineInfo.fileName, funcSymbol.address, lineInfo.lineNumber);
+    codeViewEmitter_.endFunctionLines(funcSymbol.size);
 }
 
 void DebugIntegration::processVariableForDebug(const ast::ASTNode* var,
@@ -4,347 +4,514 @@
  */
 
 #include <compiler/driver/CommandLineParser.h>
+#include <compiler/common/EnvironmentDetector.h>
+#include <compiler/common/utils/FileUtils.h>
+#include <compiler/common/utils/HashUtils.h>
 #include <iostream>
 #include <fstream>
+#include <limits>
 #include <sstream>
 #include <algorithm>
+#include <charconv>
 #include <filesystem>
+#include <thread>
+#include <unordered_set>
 
 namespace cpp20::compiler {
 
-CommandLineParser::CommandLineParser() = default;
+/**
+ * @brief Estado de un parseo: destino y lo ya visto para deduplicar
+ */
+struct CommandLineParser::ParseState {
+    CompilerOptions& options;
+    std::unordered_set<std::string> includePaths;
+    std::unordered_set<std::string> defines;
+    std::vector<ParsedOptionsCache::ResponseFileStamp> responseFiles;
 
-bool CommandLineParser::parse(int argc, char* argv[], CompilerOptions& options) {
-    processedResponseFiles_.clear();
+    explicit ParseState(CompilerOptions& target)
+        : options(target),
+          includePaths(target.includePaths.begin(), target.includePaths.end()),
+          defines(target.defines.begin(), target.defines.end()) {}
+};
 
-    // Procesar argumentos uno por uno
-    for (int i = 1; i < argc; ++i) {
-        std::string arg = argv[i];
+namespace {
 
-        // Verificar si es un archivo de respuesta
-        if (isResponseFile(arg)) {
-            std::filesystem::path responsePath = arg.substr(1); // Remover '@'
-            if (!parseResponseFile(responsePath, options)) {
-                std::cerr << "Error: no se pudo procesar archivo de respuesta '" << arg << "'" << std::endl;
-                return false;
-            }
-            continue;
-        }
-
-        // Verificar si es un archivo fuente
-        if (isSourceFile(arg)) {
-            options.inputFiles.push_back(arg);
-            continue;
-        }
+using FlagHandler = void (*)(CompilerOptions&);
+using ValueHandler = bool (*)(std::string_view value, CompilerOptions& options,
+                              std::unordered_set<std::string>& seen);
 
-        // Verificar si es un flag u opción
-        if (arg[0] == '-') {
-            if (!parseArgument(arg, options)) {
-                std::cerr << "Error: argumento desconocido '" << arg << "'" << std::endl;
-                return false;
-            }
-        } else {
-            // Asumir que es un archivo fuente
-            options.inputFiles.push_back(arg);
-        }
+/**
+ * @brief Opción con valor: -name=valor y, según la opción, -namevalor o -name valor
+ */
+struct ValueOption {
+    ValueHandler handler;
+    bool joined = false;        // -Ipath (solo nombres de dos caracteres)
+    bool separate = false;      // -I path
+    bool dedupIncludes = false; // Qué conjunto recibe en seen
+};
+
+// Añade value si no se vio antes; una ruta -I o una definición -D repetida no cambia nada
+void appendUnique(std::vector<std::string>& list, std::unordered_set<std::string>& seen,
+                  std::string_view value) {
+    auto [it, inserted] = seen.emplace(value);
+    if (inserted) {
+        list.push_back(*it);
     }
+}
+
+// Solo dígitos decimales y dentro de size_t; una cifra enorme es un valor inválido, no una excepción
+bool parseCount(std::string_view value, size_t& result) {
+    const char* end = value.data() + value.size();
+    auto [last, error] = std::from_chars(value.data(), end, result);
+    return !value.empty() && error == std::errc() && last == end;
+}
 
-    // Validar consistencia de opciones
-    if (!validateOptions(options)) {
+bool parseJobCount(std::string_view value, CompilerOptions& options) {
+    size_t jobs = 0;
+    if (!parseCount(value, jobs)) {
         return false;
     }
-
+    // -j0 = usar todos los núcleos disponibles
+    options.jobs = jobs == 0 ? std::max(1u, std::thread::hardware_concurrency()) : jobs;
     return true;
 }
 
-bool CommandLineParser::parseResponseFile(const std::filesystem::path& responseFile, CompilerOptions& options) {
-    // Evitar recursión infinita
-    if (std::find(processedResponseFiles_.begin(), processedResponseFiles_.end(), responseFile) !=
-        processedResponseFiles_.end()) {
-        std::cerr << "Error: archivo de respuesta recursivo detectado: " << responseFile << std::endl;
+bool parseArenaReserve(std::string_view value, CompilerOptions& options) {
+    size_t megabytes = 0;
+    // El driver lo pasa a bytes: también ese producto tiene que caber
+    if (!parseCount(value, megabytes) || megabytes > std::numeric_limits<size_t>::max() / (1024 * 1024)) {
         return false;
     }
+    options.arenaReserveMB = megabytes;
+    return true;
+}
 
-    processedResponseFiles_.push_back(responseFile);
-
-    auto args = readResponseFile(responseFile);
-    if (args.empty()) {
+bool parseWarning(std::string_view spec, CompilerOptions& options) {
+    if (spec.empty()) {
         return false;
     }
-
-    // Convertir vector de strings a estilo argv
-    std::vector<char*> argv;
-    for (auto& arg : args) {
-        argv.push_back(arg.data());
+    if (spec.starts_with("no-")) {
+        options.disabledWarnings.emplace_back(spec.substr(3));
+    } else {
+        options.enabledWarnings.emplace_back(spec);
     }
+    return true;
+}
 
-    // Parsear recursivamente
-    return parse(static_cast<int>(argv.size()), argv.data(), options);
+// Opciones de valor que solo guardan el texto: el valor vacío es un error
+template <auto Member>
+bool storeValue(std::string_view value, CompilerOptions& options, std::unordered_set<std::string>&) {
+    if (value.empty()) return false;
+    options.*Member = std::string(value);
+    return true;
 }
 
-bool CommandLineParser::parseArgument(const std::string& arg, CompilerOptions& options) {
-    // Primero intentar opciones compuestas (con =)
-    if (parseCompoundOption(arg, options)) {
-        return true;
-    }
+template <auto Member>
+bool appendValue(std::string_view value, CompilerOptions& options, std::unordered_set<std::string>&) {
+    if (value.empty()) return false;
+    (options.*Member).emplace_back(value);
+    return true;
+}
 
-    // Luego opciones con valor separado
-    if (parseFlag(arg, options)) {
-        return true;
-    }
+template <auto Member>
+bool appendUniqueValue(std::string_view value, CompilerOptions& options, std::unordered_set<std::string>& seen) {
+    if (value.empty()) return false;
+    appendUnique(options.*Member, seen, value);
+    return true;
+}
 
-    return false;
+const std::unordered_map<std::string_view, FlagHandler>& flagTable() {
+    static const std::unordered_map<std::string_view, FlagHandler> table = {
+        // Ayuda y versión
+        {"-h", [](CompilerOptions& o) { o.showHelp = true; }},
+        {"--help", [](CompilerOptions& o) { o.showHelp = true; }},
+        {"/?", [](CompilerOptions& o) { o.showHelp = true; }},
+        {"--version", [](CompilerOptions& o) { o.showVersion = true; }},
+        {"-V", [](CompilerOptions& o) { o.showVersion = true; }},
+
+        // Fases de compilación
+        {"-c", [](CompilerOptions& o) { o.compileOnly = true; }},
+        {"-S", [](CompilerOptions& o) { o.assembleOnly = true; }},
+        {"-E", [](CompilerOptions& o) { o.preprocessOnly = true; }},
+        {"-M", [](CompilerOptions& o) { o.dependencyScan = true; }},
+        {"-fpreprocessed-tokens", [](CompilerOptions& o) { o.preprocessedTokens = true; }},
+
+        // Output y verbose
+        {"-v", [](CompilerOptions& o) { o.verbose = true; }},
+        {"--verbose", [](CompilerOptions& o) { o.verbose = true; }},
+
+        // Debug
+        {"-g", [](CompilerOptions& o) { o.debugInfo = true; o.lineTablesOnly = false; }},
+        {"-g2", [](CompilerOptions& o) { o.debugInfo = true; o.lineTablesOnly = false; }},
+        {"-ggdb", [](CompilerOptions& o) { o.debugInfo = true; o.lineTablesOnly = false; }},
+        {"-g1", [](CompilerOptions& o) { o.debugInfo = true; o.lineTablesOnly = true; }},
+        {"-gline-tables-only", [](CompilerOptions& o) { o.debugInfo = true; o.lineTablesOnly = true; }},
+
+        // Lenguaje
+        {"-pedantic", [](CompilerOptions& o) { o.pedantic = true; }},
+        {"-pedantic-errors", [](CompilerOptions& o) { o.pedantic = true; o.warningsAsErrors = true; }},
+
+        // Tiempos
+        {"-ftime-report", [](CompilerOptions& o) { o.timing = true; }},
+        {"-ftime-trace", [](CompilerOptions& o) { o.timeTrace = true; }},
+        {"-fmemory-report", [](CompilerOptions& o) { o.memoryReport = true; }},
+
+        // Parser
+        {"-fdelayed-function-bodies", [](CompilerOptions& o) { o.delayFunctionBodies = true; }},
+
+        // Memoria
+        {"-farena-large-pages", [](CompilerOptions& o) { o.arenaLargePages = true; }},
+
+        // Warnings
+        {"-w", [](CompilerOptions& o) { o.warningLevel = 0; }},    // Deshabilitar warnings
+        {"-Werror", [](CompilerOptions& o) { o.warningsAsErrors = true; }},
+
+        // Optimización
+        {"-O0", [](CompilerOptions& o) { o.optimizationLevel = 0; }},
+        {"-O1", [](CompilerOptions& o) { o.optimizationLevel = 1; }},
+        {"-O2", [](CompilerOptions& o) { o.optimizationLevel = 2; }},
+        {"-O3", [](CompilerOptions& o) { o.optimizationLevel = 3; }},
+        {"-Os", [](CompilerOptions& o) { o.optimizationLevel = 2; }},     // Optimize for size
+        {"-flto", [](CompilerOptions& o) { o.lto = true; }},
+        {"-fprofile-generate", [](CompilerOptions& o) { o.profileGenerate = true; }},
+
+        // Linker
+        {"-fincremental-link", [](CompilerOptions& o) { o.incrementalLink = true; }},
+    };
+    return table;
 }
 
-bool CommandLineParser::parseFlag(const std::string& flag, CompilerOptions& options) {
-    // === FLAGS SIMPLES ===
+const std::unordered_map<std::string_view, ValueOption>& valueTable() {
+    using O = CompilerOptions;
+    static const std::unordered_map<std::string_view, ValueOption> table = {
+        {"-std", {storeValue<&O::standard>}},
+        {"-o", {storeValue<&O::outputFile>, false, true}},
+
+        // Búsqueda y preprocesador
+        {"-I", {appendUniqueValue<&O::includePaths>, true, true, true}},
+        {"-D", {appendUniqueValue<&O::defines>, true, true}},
+        {"-U", {appendValue<&O::undefines>, true, true}},
+        {"-L", {appendValue<&O::libraryPaths>, true, true}},
+        {"-l", {appendValue<&O::libraries>, true, true}},
+        {"-finclude-cache", {storeValue<&O::includeCacheFile>}},
+        {"-fpp-snapshot-dir", {storeValue<&O::snapshotDirectory>}},
+        {"-fauto-header-units", {storeValue<&O::autoHeaderUnitsFile>}},
+        {"-fobject-cache", {storeValue<&O::objectCacheDirectory>}},
+        {"-fcodegen-cache", {storeValue<&O::codegenCacheDirectory>}},
+
+        // CPU destino: extensiones y microarquitectura para el planificador
+        {"-march", {[](std::string_view value, O& o, std::unordered_set<std::string>&) {
+            if (value != "native" && !parseArchitecture(std::string(value))) return false;
+            o.arch = std::string(value);
+            return true;
+        }}},
+        {"-mtune", {[](std::string_view value, O& o, std::unordered_set<std::string>&) {
+            if (value != "native" && !parseMicroarchitecture(std::string(value))) return false;
+            o.tune = std::string(value);
+            return true;
+        }}},
+
+        // Perfil y orden de funciones
+        {"-fprofile-use", {storeValue<&O::profileUse>}},
+        {"-forder-file", {storeValue<&O::orderFile>}},
+        {"-fdelay-load", {appendValue<&O::delayLoadDlls>}},
+
+        // Tiempos y telemetría
+        {"-ftime-report", {[](std::string_view value, O& o, std::unordered_set<std::string>&) {
+            if (value != "entities") return false;
+            o.timing = true;
+            o.timingEntities = true;
+            return true;
+        }}},
+        {"-ftime-trace", {[](std::string_view value, O& o, std::unordered_set<std::string>&) {
+            if (value.empty()) return false;
+            o.timeTrace = true;
+            o.timeTraceFile = std::string(value);
+            return true;
+        }}},
+        {"-ftelemetry", {storeValue<&O::telemetryFile>}},
+
+        // Arenas de las unidades
+        {"-farena-reserve", {[](std::string_view value, O& o, std::unordered_set<std::string>&) {
+            return parseArenaReserve(value, o);
+        }}},
+
+        // Modo servidor y cliente del servidor
+        {"-fserver", {storeValue<&O::serverSocket>}},
+        {"-fuse-server", {storeValue<&O::useServerSocket>}},
+
+        // Compilación paralela: -j N, -j=N, -jN
+        {"-j", {[](std::string_view value, O& o, std::unordered_set<std::string>&) {
+            return parseJobCount(value, o);
+        }, true, true}},
+
+        // Warnings: -Wall, -Wno-unused (-Werror y -w son flags)
+        {"-W", {[](std::string_view value, O& o, std::unordered_set<std::string>&) {
+            return parseWarning(value, o);
+        }, true}},
+    };
+    return table;
+}
 
-    // Ayuda y versión
-    if (flag == "-h" || flag == "--help" || flag == "/?") {
-        options.showHelp = true;
-        return true;
-    }
+} // namespace
 
-    if (flag == "--version" || flag == "-V") {
-        options.showVersion = true;
-        return true;
-    }
+// ============================================================================
+// ParsedOptionsCache
+// ============================================================================
 
-    // Fases de compilación
-    if (flag == "-c") {
-        options.compileOnly = true;
-        return true;
-    }
+ParsedOptionsCache& ParsedOptionsCache::shared() {
+    static ParsedOptionsCache cache;
+    return cache;
+}
 
-    if (flag == "-S") {
-        options.assembleOnly = true;
-        return true;
+std::optional<CompilerOptions> ParsedOptionsCache::lookup(uint64_t key) const {
+    std::vector<ResponseFileStamp> responseFiles;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it == entries_.end()) {
+            return std::nullopt;
+        }
+        responseFiles = it->second.responseFiles;
     }
 
-    if (flag == "-E") {
-        options.preprocessOnly = true;
-        return true;
+    // Fuera del lock: releer y hashear los archivos de respuesta
+    for (const auto& stamp : responseFiles) {
+        try {
+            auto content = common::utils::readFileBuffer(stamp.path.string());
+            if (common::utils::fnv1a64(content.view()) != stamp.contentHash) {
+                return std::nullopt;
+            }
+        } catch (const std::exception&) {
+            return std::nullopt;
+        }
     }
 
-    // Output y verbose
-    if (flag == "-v" || flag == "--verbose") {
-        options.verbose = true;
-        return true;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        return std::nullopt;
     }
+    ++hits_;
+    return it->second.options;
+}
 
-    // Debug
-    if (flag == "-g" || flag == "-g2" || flag == "-ggdb") {
-        options.debugInfo = true;
-        return true;
+void ParsedOptionsCache::store(uint64_t key, const CompilerOptions& options,
+                               std::vector<ResponseFileStamp> responseFiles) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.size() >= kMaxEntries && !entries_.count(key)) {
+        entries_.clear();   // Las líneas de un build se repiten: basta con vaciar de vez en cuando
     }
+    entries_[key] = Entry{options, std::move(responseFiles)};
+}
 
-    // Lenguaje
-    if (flag == "-pedantic" || flag == "-pedantic-errors") {
-        options.pedantic = true;
-        if (flag == "-pedantic-errors") {
-            options.warningsAsErrors = true;
-        }
-        return true;
-    }
+void ParsedOptionsCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    hits_ = 0;
+}
 
-    // Warnings
-    if (flag == "-w") {
-        options.warningLevel = 0; // Deshabilitar warnings
-        return true;
-    }
+size_t ParsedOptionsCache::hitCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
 
-    if (flag == "-Werror") {
-        options.warningsAsErrors = true;
-        return true;
-    }
+size_t ParsedOptionsCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
 
-    // Optimización
-    if (flag == "-O0") {
-        options.optimizationLevel = 0;
-        return true;
-    }
+// ============================================================================
+// CommandLineParser
+// ============================================================================
 
-    if (flag == "-O1") {
-        options.optimizationLevel = 1;
-        return true;
-    }
+CommandLineParser::CommandLineParser() = default;
+CommandLineParser::~CommandLineParser() = default;
 
-    if (flag == "-O2") {
-        options.optimizationLevel = 2;
-        return true;
-    }
+bool CommandLineParser::parse(int argc, char* argv[], CompilerOptions& options) {
+    activeResponseFiles_.clear();
 
-    if (flag == "-O3") {
-        options.optimizationLevel = 3;
-        return true;
+    std::vector<std::string_view> args;
+    args.reserve(argc > 1 ? static_cast<size_t>(argc - 1) : 0);
+    uint64_t key = common::utils::fnv1a64("cpp20-command-line");
+    for (int i = 1; i < argc; ++i) {
+        args.emplace_back(argv[i]);
+        key = common::utils::hashMix(key, common::utils::fnv1a64(args.back()));
     }
 
-    if (flag == "-Os") {
-        options.optimizationLevel = 2; // Optimize for size
-        return true;
+    if (cache_) {
+        if (auto cached = cache_->lookup(key)) {
+            options = std::move(*cached);
+            return true;
+        }
     }
 
-    // === OPCIONES CON VALOR SEPARADO ===
-
-    // Output file (se maneja especialmente en el loop principal)
-    if (flag == "-o") {
-        return true;
+    ParseState state(options);
+    if (!parseArguments(args, state) || !validateOptions(options)) {
+        return false;
     }
 
-    return false;
+    if (cache_) {
+        cache_->store(key, options, std::move(state.responseFiles));
+    }
+    return true;
 }
 
-bool CommandLineParser::parseCompoundOption(const std::string& arg, CompilerOptions& options) {
-    // Buscar separador '='
-    size_t equalPos = arg.find('=');
-    std::string option, value;
-
-    if (equalPos != std::string::npos) {
-        option = arg.substr(0, equalPos);
-        value = arg.substr(equalPos + 1);
-    } else {
-        option = arg;
-        // Para opciones pegadas sin '=', el valor está después del prefijo
-    }
+bool CommandLineParser::parseResponseFile(const std::filesystem::path& responseFile, CompilerOptions& options) {
+    activeResponseFiles_.clear();
+    ParseState state(options);
+    return expandResponseFile(responseFile, state) && validateOptions(options);
+}
 
-    // === OPCIONES CON VALOR COMPUESTO ===
+bool CommandLineParser::parseArguments(const std::vector<std::string_view>& args, ParseState& state) {
+    CompilerOptions& options = state.options;
 
-    // Standard
-    if (option == "-std") {
-        if (!value.empty()) {
-            options.standard = value;
-            return true;
+    // Procesar argumentos uno por uno
+    for (size_t i = 0; i < args.size(); ++i) {
+        std::string_view arg = args[i];
+        if (arg.empty()) {
+            continue;
         }
-    }
 
-    // Include paths
-    if (option == "-I") {
-        if (!value.empty()) {
-            options.includePaths.push_back(value);
-            return true;
+        // Verificar si es un archivo de respuesta
+        if (isResponseFile(arg)) {
+            if (!expandResponseFile(std::filesystem::path(arg.substr(1)), state)) {  // Remover '@'
+                std::cerr << "Error: no se pudo procesar archivo de respuesta '" << arg << "'" << std::endl;
+                return false;
+            }
+            continue;
         }
-    }
 
-    // Library paths
-    if (option == "-L") {
-        if (!value.empty()) {
-            options.libraryPaths.push_back(value);
-            return true;
+        // Verificar si es un archivo fuente
+        if (isSourceFile(arg) || arg[0] != '-') {
+            options.inputFiles.emplace_back(arg);
+            continue;
         }
-    }
 
-    // Libraries
-    if (option == "-l") {
-        if (!value.empty()) {
-            options.libraries.push_back(value);
-            return true;
+        // Verificar si es un flag u opción
+        bool consumedNext = false;
+        const std::string_view* next = i + 1 < args.size() ? &args[i + 1] : nullptr;
+        if (!parseArgument(arg, next, consumedNext, state)) {
+            std::cerr << "Error: argumento desconocido o valor inválido '" << arg << "'" << std::endl;
+            return false;
         }
-    }
-
-    // Defines
-    if (option == "-D") {
-        if (!value.empty()) {
-            options.defines.push_back(value);
-            return true;
+        if (consumedNext) {
+            ++i;
         }
     }
 
-    // Undefines
-    if (option == "-U") {
-        if (!value.empty()) {
-            options.undefines.push_back(value);
-            return true;
-        }
+    return true;
+}
+
+bool CommandLineParser::expandResponseFile(const std::filesystem::path& path, ParseState& state) {
+    // Evitar recursión infinita (el mismo archivo dos veces seguidas sí vale)
+    if (std::find(activeResponseFiles_.begin(), activeResponseFiles_.end(), path) !=
+        activeResponseFiles_.end()) {
+        std::cerr << "Error: archivo de respuesta recursivo detectado: " << path << std::endl;
+        return false;
     }
 
-    // Output file
-    if (option == "-o") {
-        if (!value.empty()) {
-            options.outputFile = value;
-            return true;
-        }
+    common::utils::FileBuffer content;
+    try {
+        content = common::utils::readFileBuffer(path.string());
+    } catch (const std::exception&) {
+        std::cerr << "Error: no se puede abrir archivo de respuesta '" << path.string() << "'" << std::endl;
+        return false;
     }
+    state.responseFiles.push_back({path, common::utils::fnv1a64(content.view())});
 
-    // Warnings
-    if (option.substr(0, 2) == "-W") {
-        std::string warningSpec = option.substr(2);
-        if (!warningSpec.empty()) {
-            bool enable = (warningSpec.substr(0, 2) != "no-");
-            if (!enable) {
-                warningSpec = warningSpec.substr(3);
-            }
-            parseWarningOption(warningSpec, enable, options);
-            return true;
-        }
+    // Las vistas apuntan a la proyección, que vive hasta terminar de parsear el archivo
+    std::vector<std::string_view> args = tokenizeResponseFile(content.view());
+    if (args.empty()) {
+        return false;
     }
 
-    // === OPCIONES PEGADAS (GCC style) ===
+    activeResponseFiles_.push_back(path);
+    bool ok = parseArguments(args, state);
+    activeResponseFiles_.pop_back();
+    return ok;
+}
 
-    // Include paths pegadas
-    if (option.substr(0, 2) == "-I") {
-        std::string path = option.substr(2);
-        if (!path.empty()) {
-            options.includePaths.push_back(path);
-            return true;
+std::vector<std::string_view> CommandLineParser::tokenizeResponseFile(std::string_view content) {
+    std::vector<std::string_view> args;
+    size_t i = 0;
+    auto isSpace = [](char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v'; };
+
+    while (i < content.size()) {
+        char c = content[i];
+        if (isSpace(c)) {
+            ++i;
+        } else if (c == '#') {
+            // Comentario hasta fin de línea
+            size_t end = content.find('\n', i);
+            i = end == std::string_view::npos ? content.size() : end + 1;
+        } else if (c == '"') {
+            size_t end = content.find('"', i + 1);
+            if (end == std::string_view::npos) end = content.size();
+            args.push_back(content.substr(i + 1, end - i - 1));
+            i = end + 1;
+        } else {
+            size_t start = i;
+            while (i < content.size() && !isSpace(content[i])) ++i;
+            args.push_back(content.substr(start, i - start));
         }
     }
 
-    // Defines pegadas
-    if (option.substr(0, 2) == "-D") {
-        std::string def = option.substr(2);
-        if (!def.empty()) {
-            options.defines.push_back(def);
-            return true;
-        }
+    return args;
+}
+
+bool CommandLineParser::parseArgument(std::string_view arg, const std::string_view* next, bool& consumedNext,
+                                      ParseState& state) {
+    // Flags exactos (antes que los prefijos: -Werror no es el warning "error")
+    const auto& flags = flagTable();
+    if (auto it = flags.find(arg); it != flags.end()) {
+        it->second(state.options);
+        return true;
     }
 
-    // Undefines pegadas
-    if (option.substr(0, 2) == "-U") {
-        std::string undef = option.substr(2);
-        if (!undef.empty()) {
-            options.undefines.push_back(undef);
-            return true;
+    const auto& values = valueTable();
+    auto apply = [&](const ValueOption& option, std::string_view value) {
+        auto& seen = option.dedupIncludes ? state.includePaths : state.defines;
+        return option.handler(value, state.options, seen);
+    };
+
+    // -name=valor
+    size_t equalPos = arg.find('=');
+    if (equalPos != std::string_view::npos) {
+        if (auto it = values.find(arg.substr(0, equalPos)); it != values.end()) {
+            return apply(it->second, arg.substr(equalPos + 1));
         }
     }
 
-    // Libraries pegadas
-    if (option.substr(0, 2) == "-l") {
-        std::string lib = option.substr(2);
-        if (!lib.empty()) {
-            options.libraries.push_back(lib);
-            return true;
+    // -name valor
+    if (auto it = values.find(arg); it != values.end()) {
+        if (!it->second.separate || !next) {
+            return false;
         }
+        consumedNext = true;
+        return apply(it->second, *next);
     }
 
-    // Library paths pegadas
-    if (option.substr(0, 2) == "-L") {
-        std::string path = option.substr(2);
-        if (!path.empty()) {
-            options.libraryPaths.push_back(path);
-            return true;
+    // -namevalor (GCC style)
+    if (arg.size() > 2) {
+        if (auto it = values.find(arg.substr(0, 2)); it != values.end() && it->second.joined) {
+            return apply(it->second, arg.substr(2));
         }
     }
 
     return false;
 }
 
-void CommandLineParser::parseWarningOption(const std::string& warningSpec, bool enable, CompilerOptions& options) {
-    if (enable) {
-        options.enabledWarnings.push_back(warningSpec);
-    } else {
-        options.disabledWarnings.push_back(warningSpec);
-    }
-}
-
 bool CommandLineParser::validateOptions(const CompilerOptions& options) const {
     // Validar combinaciones mutuamente exclusivas
     int phaseCount = 0;
     if (options.preprocessOnly) phaseCount++;
+    if (options.dependencyScan) phaseCount++;
     if (options.compileOnly) phaseCount++;
     if (options.assembleOnly) phaseCount++;
 
     if (phaseCount > 1) {
-        std::cerr << "Error: solo se puede especificar una fase de compilación (-E, -S, -c)" << std::endl;
+        std::cerr << "Error: solo se puede especificar una fase de compilación (-E, -M, -S, -c)" << std::endl;
         return false;
     }
 
@@ -356,7 +523,8 @@ bool CommandLineParser::validateOptions(const CompilerOptions& options) const {
     }
 
     // Validar archivos de entrada
-    if (options.inputFiles.empty() && !options.showHelp && !options.showVersion) {
+    if (options.inputFiles.empty() && !options.showHelp && !options.showVersion &&
+        options.serverSocket.empty()) {
         std::cerr << "Error: no se especificaron archivos de entrada" << std::endl;
         return false;
     }
@@ -364,17 +532,16 @@ bool CommandLineParser::validateOptions(const CompilerOptions& options) const {
     return true;
 }
 
-bool CommandLineParser::isSourceFile(const std::string& filename) const {
+bool CommandLineParser::isSourceFile(std::string_view filename) const {
     // Extensiones comunes de archivos fuente C/C++
-    static const std::vector<std::string> extensions = {
+    static constexpr std::string_view extensions[] = {
         ".cpp", ".cxx", ".cc", ".c++", ".C",
         ".hpp", ".hxx", ".hh", ".h++", ".H",
         ".c", ".h", ".ixx", ".cppm"  // C++20 modules
     };
 
-    for (const auto& ext : extensions) {
-        if (filename.size() > ext.size() &&
-            filename.substr(filename.size() - ext.size()) == ext) {
+    for (std::string_view ext : extensions) {
+        if (filename.size() > ext.size() && filename.ends_with(ext)) {
             return true;
         }
     }
@@ -382,48 +549,10 @@ bool CommandLineParser::isSourceFile(const std::string& filename) const {
     return false;
 }
 
-bool CommandLineParser::isResponseFile(const std::string& filename) const {
+bool CommandLineParser::isResponseFile(std::string_view filename) const {
     return !filename.empty() && filename[0] == '@';
 }
 
-std::vector<std::string> CommandLineParser::readResponseFile(const std::filesystem::path& path) const {
-    std::vector<std::string> args;
-    std::ifstream file(path);
-
-    if (!file) {
-        std::cerr << "Error: no se puede abrir archivo de respuesta '" << path << "'" << std::endl;
-        return args;
-    }
-
-    std::string line;
-    while (std::getline(file, line)) {
-        // Remover comentarios (desde # hasta fin de línea)
-        size_t commentPos = line.find('#');
-        if (commentPos != std::string::npos) {
-            line = line.substr(0, commentPos);
-        }
-
-        // Trim whitespace
-        line.erase(line.begin(), std::find_if(line.begin(), line.end(), [](unsigned char ch) {
-            return !std::isspace(ch);
-        }));
-        line.erase(std::find_if(line.rbegin(), line.rend(), [](unsigned char ch) {
-            return !std::isspace(ch);
-        }).base(), line.end());
-
-        if (!line.empty()) {
-            // Parsear línea en argumentos (simple split por espacios)
-            std::istringstream iss(line);
-            std::string arg;
-            while (iss >> arg) {
-                args.push_back(arg);
-            }
-        }
-    }
-
-    return args;
-}
-
 void CommandLineParser::showHelp() const {
     std::cout << "Compilador C++20 para Windows x64" << std::endl;
     std::cout << "Uso: cpp20-compiler [opciones] archivos..." << std::endl;
@@ -435,8 +564,10 @@ void CommandLineParser::showHelp() const {
     std::cout << "  -c                   Compilar a objeto, no linkear" << std::endl;
     std::cout << "  -S                   Generar código ensamblador" << std::endl;
     std::cout << "  -E                   Solo preprocesamiento" << std::endl;
+    std::cout << "  -M                   Solo reglas de dependencias (#include e import)" << std::endl;
     std::cout << "  -o <archivo>         Archivo de salida" << std::endl;
     std::cout << "  -v, --verbose        Salida detallada" << std::endl;
+    std::cout << "  -j <N>               Compilar N unidades de traducción en paralelo (0 = todos los núcleos)" << std::endl;
     std::cout << std::endl;
 
     std::cout << "Opciones de lenguaje:" << std::endl;
@@ -447,6 +578,7 @@ void CommandLineParser::showHelp() const {
 
     std::cout << "Opciones de búsqueda:" << std::endl;
     std::cout << "  -I<directorio>       Agregar directorio de include" << std::endl;
+    std::cout << "  -finclude-cache=<f>  Reutilizar entre invocaciones la resolución de includes" << std::endl;
     std::cout << "  -L<directorio>       Agregar directorio de librería" << std::endl;
     std::cout << "  -l<lib>             Linkear con librería" << std::endl;
     std::cout << std::endl;
@@ -454,6 +586,9 @@ void CommandLineParser::showHelp() const {
     std::cout << "Opciones del preprocesador:" << std::endl;
     std::cout << "  -D<macro>[=valor]    Definir macro" << std::endl;
     std::cout << "  -U<macro>           Indefinir macro" << std::endl;
+    std::cout << "  -fpp-snapshot-dir=<d> Reutilizar el estado tras los #include iniciales" << std::endl;
+    std::cout << "  -fauto-header-units=<f> Importar como header units los headers más incluidos del build" << std::endl;
+    std::cout << "  -fpreprocessed-tokens Con -E, escribir tokens binarios que se cargan sin volver a tokenizar" << std::endl;
     std::cout << std::endl;
 
     std::cout << "Opciones de warnings:" << std::endl;
@@ -467,10 +602,46 @@ void CommandLineParser::showHelp() const {
     std::cout << "  -O0                  Sin optimizaciones" << std::endl;
     std::cout << "  -O1, -O2, -O3        Nivel de optimización" << std::endl;
     std::cout << "  -Os                  Optimizar para tamaño" << std::endl;
+    std::cout << "  -flto                Guardar el IR en el objeto y optimizar el programa entero al enlazar" << std::endl;
+    std::cout << "  -fprofile-generate   Contar las ejecuciones de cada bloque; el programa escribe default.cppprof al salir" << std::endl;
+    std::cout << "  -fprofile-use=<file> Optimizar con el perfil: inlining, orden de bloques, spills y orden de .text" << std::endl;
+    std::cout << "  -fobject-cache=<d>   Reutilizar el objeto de una unidad ya compilada con las mismas fuentes y opciones" << std::endl;
+    std::cout << "  -fcodegen-cache=<d>  Reutilizar con -flto el código de las funciones cuyo IR optimizado no cambió" << std::endl;
+    std::cout << "  -march=<arch>        Extensiones del destino: x86-64, x86-64-v2, x86-64-v3, x86-64-v4 o native" << std::endl;
+    std::cout << "  -mtune=<cpu>         Planificar para generic, skylake, znver3, znver4 o native (por defecto, según -march)" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "Opciones de tiempos:" << std::endl;
+    std::cout << "  -ftime-report        Mostrar el tiempo de cada fase" << std::endl;
+    std::cout << "  -ftime-report=entities Añadir las plantillas, funciones constexpr, headers y funciones más caras" << std::endl;
+    std::cout << "  -ftime-trace[=<file>] Guardar una traza por hilo para chrome://tracing o Perfetto" << std::endl;
+    std::cout << "  -fmemory-report      Mostrar la memoria de cada subsistema y el pico de cada fase" << std::endl;
+    std::cout << "  -ftelemetry=<file>   Añadir las métricas de cada unidad y del enlace a un archivo del build" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "Opciones del parser:" << std::endl;
+    std::cout << "  -fdelayed-function-bodies Parsear cuerpos de función solo cuando una etapa los usa" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "Opciones de memoria:" << std::endl;
+    std::cout << "  -farena-reserve=<MB> Reservar esa región para la arena de cada unidad, en el nodo NUMA del worker" << std::endl;
+    std::cout << "  -farena-large-pages  Respaldar la región con páginas grandes (256 MB si no se indica -farena-reserve)" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "Opciones del linker:" << std::endl;
+    std::cout << "  -fincremental-link   Dejar hueco en el ejecutable y reescribir solo los objetos que cambian" << std::endl;
+    std::cout << "  -forder-file=<file>  Colocar primero en .text las funciones listadas (símbolo [recuento])" << std::endl;
+    std::cout << "  -fdelay-load=<dll>   Cargar la DLL en la primera llamada a una de sus funciones (/DELAYLOAD)" << std::endl;
     std::cout << std::endl;
 
     std::cout << "Opciones de debug:" << std::endl;
     std::cout << "  -g                   Incluir información de debug" << std::endl;
+    std::cout << "  -gline-tables-only   Solo funciones y líneas (pilas simbolizables, sin tipos ni locales)" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "Modo servidor:" << std::endl;
+    std::cout << "  -fserver=<socket>    Atender compilaciones manteniendo las cachés en memoria" << std::endl;
+    std::cout << "  -fuse-server=<socket> Compilar en el servidor (en este proceso si no responde)" << std::endl;
     std::cout << std::endl;
 
     std::cout << "Archivos de respuesta:" << std::endl;
@@ -482,6 +653,7 @@ void CommandLineParser::showHelp() const {
     std::cout << "  cpp20-compiler -c main.cpp -I./include" << std::endl;
     std::cout << "  cpp20-compiler -E main.cpp -o main.i" << std::endl;
     std::cout << "  cpp20-compiler @build.rsp main.cpp" << std::endl;
+    std::cout << "  cpp20-compiler -j 8 -c a.cpp b.cpp c.cpp" << std::endl;
     std::cout << std::endl;
 }
 
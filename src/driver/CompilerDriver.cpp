@@ -5,16 +5,127 @@
 
 #include <compiler/driver/CompilerDriver.h>
 #include <compiler/driver/CommandLineParser.h>
+#include <compiler/driver/CompilerServer.h>
+#include <compiler/driver/ObjectCache.h>
+#include <compiler/common/CacheBackend.h>
+#include <compiler/common/EnvironmentDetector.h>
+#include <compiler/common/TimingProfiler.h>
+#include <compiler/frontend/lexer/Lexer.h>
+#include <compiler/frontend/Preprocessor.h>
+#include <compiler/frontend/HeaderUnitTable.h>
+#include <compiler/frontend/PreprocessorSnapshot.h>
+#include <compiler/frontend/PreprocessedOutput.h>
+#include <compiler/frontend/DependencyScanner.h>
+#include <compiler/frontend/Parser.h>
+#include <compiler/backend/codegen/CodegenDatabase.h>
+#include <compiler/backend/coff/COFFWriter.h>
+#include <compiler/backend/link/MiniLinker.h>
+#include <compiler/backend/link/LinkTimeOptimizer.h>
+#include <compiler/backend/codegen/LinkerIntegration.h>
+#include <compiler/ir/Profile.h>
+#include <compiler/common/utils/MemoryPool.h>
+#include <compiler/common/utils/MemoryTracker.h>
+#include <compiler/common/utils/HashUtils.h>
+#include <compiler/common/utils/ThreadPool.h>
+#include <algorithm>
+#include <cctype>
 #include <iostream>
 #include <chrono>
+#include <exception>
 #include <filesystem>
+#include <fstream>
 #include <iomanip>
+#include <limits>
+#include <optional>
+#include <sstream>
+
+// Versión que acompaña a cada registro de -ftelemetry (la pone CMake)
+#ifndef CPP20_COMPILER_VERSION
+#define CPP20_COMPILER_VERSION "unknown"
+#endif
 
 namespace cpp20::compiler {
 
+namespace {
+
+// Región de -farena-large-pages sin -farena-reserve. En Windows se compromete entera al crearla
+constexpr size_t kDefaultLargePageArena = 256 * 1024 * 1024;
+
+// Lo que el MiniLinker no sabe hacer y obliga a usar link.exe; vacío si no hay nada
+std::string externalLinkerFeature(const CompilerOptions& options) {
+    if (options.outputFormat == "dll") return "la salida DLL";
+    if (options.debugInfo) return "el PDB de -g";
+    if (!options.linkerScript.empty()) return "el script de linker -T";
+    return {};
+}
+
+// Opciones que cambian el objeto o los diagnósticos de una unidad (no -o, -j ni -v)
+uint64_t objectCacheOptionsHash(const CompilerOptions& options) {
+    common::utils::StreamingHasher hasher;
+    auto text = [&](std::string_view value) {
+        hasher.updateValue(static_cast<uint64_t>(value.size()));
+        hasher.update(value);
+    };
+    auto list = [&](const std::vector<std::string>& values) {
+        hasher.updateValue(static_cast<uint64_t>(values.size()));
+        for (const auto& value : values) text(value);
+    };
+
+    text(options.standard);
+    text(options.targetTriple);
+    text(options.abi);
+    text(options.arch);
+    text(options.tune);
+    text(options.profileUse.string());
+    hasher.updateValue(options.optimizationLevel);
+    hasher.updateValue(options.warningLevel);
+    hasher.updateValue(static_cast<uint64_t>(options.maxErrors));
+    bool flags[] = {options.debugInfo, options.lineTablesOnly, options.lto, options.profileGenerate,
+                    options.pedantic, options.msExtensions, options.gnuExtensions, options.warningsAsErrors,
+                    options.enableModules, options.enableCoroutines, options.enableConcepts,
+                    options.delayFunctionBodies};
+    hasher.update(flags, sizeof(flags));
+    list(options.includePaths);
+    list(options.defines);
+    list(options.undefines);
+    list(options.disabledWarnings);
+    list(options.enabledWarnings);
+    return hasher.digest64();
+}
+
+// Objeto ya generado en memoria, escrito de una vez
+bool writeObjectImage(const std::filesystem::path& path, const std::vector<uint8_t>& image) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+    if (!out) {
+        std::cerr << "Error writing COFF object to file '" << path.string() << "'" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// -march / -mtune; "native" sale del HostCPU del perfil de entorno en caché
+std::pair<CPUFeatures, Microarchitecture> resolveTarget(const CompilerOptions& options) {
+    bool nativeTune = options.tune == "native" || (options.tune.empty() && options.arch == "native");
+    HostCPU host;
+    if (options.arch == "native" || nativeTune) {
+        CompilerConfigManager configManager;
+        host = configManager.loadOrDetect(options.targetTriple.substr(0, options.targetTriple.find('-'))).hostCPU;
+    }
+
+    CPUFeatures features = options.arch == "native" ? host.features
+                                                    : parseArchitecture(options.arch).value_or(CPUFeatures());
+    Microarchitecture tune = nativeTune ? host.microarchitecture
+                                        : parseMicroarchitecture(options.tune).value_or(Microarchitecture::Generic);
+    return {features, tune};
+}
+
+} // namespace
+
 CompilerDriver::CompilerDriver()
     : sourceManager_(std::make_shared<diagnostics::SourceManager>()),
-      diagnosticEngine_(std::make_shared<diagnostics::DiagnosticEngine>(sourceManager_)) {
+      diagnosticEngine_(std::make_shared<diagnostics::DiagnosticEngine>(sourceManager_)),
+      conditionCache_(std::make_shared<frontend::ConditionCache>()) {
 }
 
 CompilerDriver::~CompilerDriver() = default;
@@ -37,6 +148,38 @@ int CompilerDriver::run(int argc, char* argv[]) {
             return EXIT_SUCCESS;
         }
 
+        // Modo servidor: atender invocaciones hasta que termine el proceso
+        if (!options.serverSocket.empty()) {
+            CompilerServer server(options.serverSocket, options.jobs > 1 ? options.jobs : 0);
+            return server.serve() ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+
+        // Cliente: reenviar la invocación; si no hay servidor, compilar aquí
+        if (!options.useServerSocket.empty() && !CompilerServer::handlingRequest()) {
+            ServerRequest request;
+            std::error_code ec;
+            request.workingDirectory = std::filesystem::current_path(ec);
+            for (int i = 1; i < argc; ++i) {
+                std::string_view argument = argv[i];
+                if (argument.rfind("-fuse-server=", 0) != 0) {
+                    request.arguments.emplace_back(argument);
+                }
+            }
+
+            if (auto response = CompilerServer::send(options.useServerSocket, request)) {
+                std::cout << response->standardOutput << std::flush;
+                std::cerr << response->standardError << std::flush;
+                return response->exitCode;
+            }
+            if (options.verbose) {
+                std::cerr << "Aviso: no hay servidor en " << options.useServerSocket
+                          << "; se compila en este proceso" << std::endl;
+            }
+        }
+
+        // Un driver reutilizado por el servidor no arrastra diagnósticos
+        diagnosticEngine_->clearDiagnostics();
+
         // Configurar entorno
         if (!validateOptions(options)) {
             return EXIT_FAILURE;
@@ -51,16 +194,69 @@ int CompilerDriver::run(int argc, char* argv[]) {
             std::cout << "Nivel de optimización: O" << options.optimizationLevel << std::endl;
         }
 
+        // Profiler de esta invocación; la instanciación de plantillas lo
+        // encuentra a través de TimingProfiler::active()
+        profiler_.reset();
+        if (options.memoryReport) {
+            common::utils::MemoryTracker::setEnabled(true);
+            common::utils::MemoryTracker::resetPeaks();
+        }
+        if (options.timing || options.timeTrace || options.memoryReport || headerUnits_) {
+            profiler_ = std::make_unique<TimingProfiler>();
+            // -fauto-header-units decide con el coste por header
+            profiler_->setEntityTracking(options.timingEntities || headerUnits_);
+            if (options.timeTrace) {
+                profiler_->enableTrace();
+            }
+            TimingProfiler::setActive(profiler_.get());
+        }
+
         // Ejecutar compilación
-        CompilationResult result = compile(
-            std::vector<std::filesystem::path>(options.inputFiles.begin(), options.inputFiles.end()),
-            options
-        );
+        CompilationResult result;
+        {
+            AutoTimer total(profiler_.get(), CompilationPhase::TotalCompilation);
+            result = compile(
+                std::vector<std::filesystem::path>(options.inputFiles.begin(), options.inputFiles.end()),
+                options
+            );
+        }
+
+        if (profiler_) {
+            TimingProfiler::setActive(nullptr);
+        }
+
+        // Los headers más incluidos y caros hasta ahora se importan desde la siguiente compilación
+        if (headerUnits_) {
+            size_t promoted = headerUnits_->update(
+                profiler_->getTopEntities(CompilationPhase::HeaderInclusion, std::numeric_limits<size_t>::max()),
+                *sourceManager_);
+            if (!headerUnits_->save()) {
+                std::cerr << "Advertencia: no se pudo escribir " << headerUnits_->file() << std::endl;
+            }
+            if (options.verbose && promoted > 0) {
+                std::cout << "Headers promovidos a header unit: " << promoted << std::endl;
+            }
+        }
+
+        if (options.timeTrace && !options.inputFiles.empty()) {
+            std::filesystem::path traceFile = options.timeTraceFile;
+            if (traceFile.empty()) {
+                std::vector<std::filesystem::path> inputs(options.inputFiles.begin(), options.inputFiles.end());
+                traceFile = objectFileFor(inputs.front(), options, inputs);
+                traceFile.replace_extension(".json");
+            }
+            if (!profiler_->writeChromeTrace(traceFile)) {
+                std::cerr << "Advertencia: no se pudo escribir la traza en " << traceFile << std::endl;
+            }
+        }
 
         // Reportar tiempos si solicitado
         if (options.timing) {
             reportTiming(result.compilationTime, options);
         }
+        if (options.memoryReport) {
+            reportMemory();
+        }
 
         // Reportar resultado
         if (options.verbose || !result.success) {
@@ -89,6 +285,10 @@ int CompilerDriver::run(int argc, char* argv[]) {
 CompilerOptions CompilerDriver::parseCommandLine(int argc, char* argv[]) {
     CompilerOptions options;
     CommandLineParser parser;
+    if (CompilerServer::handlingRequest()) {
+        // En el servidor las mismas líneas de comando se repiten en cada build
+        parser.setCache(&ParsedOptionsCache::shared());
+    }
 
     // El parser avanzado maneja todo automáticamente, incluyendo archivos de respuesta
     if (!parser.parse(argc, argv, options)) {
@@ -127,7 +327,9 @@ CompilationResult CompilerDriver::compile(
         }
 
         // Ejecutar fases de compilación
-        if (options.preprocessOnly) {
+        if (options.dependencyScan) {
+            result.success = runDependencyScan(inputFiles, options);
+        } else if (options.preprocessOnly) {
             result.success = runPreprocessing(inputFiles, options);
             result.outputFiles = {determineOutputFile(inputFiles, options).string()};
         } else if (options.compileOnly) {
@@ -147,6 +349,11 @@ CompilationResult CompilerDriver::compile(
         result.errorMessage = std::string("Error durante la compilación: ") + e.what();
     }
 
+    // La siguiente invocación arranca con las resoluciones de esta
+    if (includeCache_ && !includeCache_->save() && options.verbose) {
+        std::cerr << "Aviso: no se pudo guardar " << includeCache_->cacheFile() << std::endl;
+    }
+
     auto endTime = std::chrono::high_resolution_clock::now();
     result.compilationTime = std::chrono::duration<double>(endTime - startTime).count();
 
@@ -163,6 +370,7 @@ bool CompilerDriver::validateOptions(const CompilerOptions& options) {
     // Validar combinaciones de fases
     int phaseCount = 0;
     if (options.preprocessOnly) phaseCount++;
+    if (options.dependencyScan) phaseCount++;
     if (options.compileOnly) phaseCount++;
     if (options.assembleOnly) phaseCount++;
 
@@ -175,6 +383,9 @@ bool CompilerDriver::validateOptions(const CompilerOptions& options) {
 }
 
 void CompilerDriver::setupEnvironment(const CompilerOptions& options) {
+    // Partir de rutas vacías: en el servidor el mismo driver atiende varias invocaciones
+    sourceManager_->setIncludeSearchPath(diagnostics::IncludeSearchPath());
+
     // Configurar rutas de búsqueda de includes
     for (const auto& includePath : options.includePaths) {
         sourceManager_->addIncludePath(includePath, true); // Sistema
@@ -183,11 +394,59 @@ void CompilerDriver::setupEnvironment(const CompilerOptions& options) {
     // Configurar rutas de búsqueda de includes de usuario
     sourceManager_->addIncludePath(".", false); // Directorio actual
 
+    if (options.includeCacheFile.empty()) {
+        includeCache_.reset();
+    } else if (!includeCache_ || includeCache_->cacheFile() != options.includeCacheFile) {
+        includeCache_ = std::make_shared<diagnostics::IncludeResolutionCache>(options.includeCacheFile);
+        includeCache_->load();
+    }
+    if (includeCache_) {
+        sourceManager_->setIncludeResolutionCache(includeCache_);
+    }
+
+    if (options.autoHeaderUnitsFile.empty()) {
+        headerUnits_.reset();
+    } else if (!headerUnits_ || headerUnits_->file() != options.autoHeaderUnitsFile) {
+        headerUnits_ = std::make_shared<frontend::HeaderUnitTable>(options.autoHeaderUnitsFile);
+        headerUnits_->load();
+    }
+
     // Configurar otras rutas según el estándar de Windows
     if (options.standard == "c++20") {
-        // Agregar rutas estándar de MSVC/CRT
-        sourceManager_->addIncludePath("C:/Program Files/Microsoft Visual Studio/2022/Community/VC/Tools/MSVC/14.35.32215/include", true);
-        sourceManager_->addIncludePath("C:/Program Files (x86)/Windows Kits/10/Include/10.0.22000.0/ucrt", true);
+        // Rutas de MSVC/CRT detectadas; la caché por usuario evita repetir la
+        // detección en cada invocación
+        CompilerConfigManager configManager;
+        DetectedEnvironment environment =
+            configManager.loadOrDetect(options.targetTriple.substr(0, options.targetTriple.find('-')));
+        if (environment.isValid) {
+            for (const auto& includePath : environment.includePaths) {
+                sourceManager_->addIncludePath(includePath, true);
+            }
+        } else {
+            // Sin instalación detectada: rutas estándar de MSVC/CRT
+            sourceManager_->addIncludePath("C:/Program Files/Microsoft Visual Studio/2022/Community/VC/Tools/MSVC/14.35.32215/include", true);
+            sourceManager_->addIncludePath("C:/Program Files (x86)/Windows Kits/10/Include/10.0.22000.0/ucrt", true);
+        }
+    }
+
+    // Los headers que resolvió el build anterior se leen mientras se prepara la unidad
+    if (includeCache_) {
+        sourceManager_->prefetchPreviousIncludes();
+    }
+
+    // La clave lleva el compilador exacto, las opciones, las rutas de búsqueda
+    // y el directorio de trabajo, que decide a qué archivo llevan las relativas
+    if (options.objectCacheDirectory.empty()) {
+        objectCache_.reset();
+    } else {
+        std::error_code ignored;
+        common::utils::StreamingHasher environment(objectCacheOptionsHash(options));
+        environment.updateValue(sourceManager_->includePathsHash());
+        environment.update(std::filesystem::current_path(ignored).string());
+        uint64_t namespaceKey = SecondaryCache::namespaceKeyFor(
+            compilerVersion() + " " __DATE__ " " __TIME__, environment.digest64());
+        objectCache_ = std::make_unique<ObjectCache>(
+            std::make_shared<DirectoryCacheBackend>(options.objectCacheDirectory), sourceManager_, namespaceKey);
     }
 }
 
@@ -212,43 +471,557 @@ bool CompilerDriver::runPreprocessing(const std::vector<std::filesystem::path>&
         std::cout << "Ejecutando preprocesamiento..." << std::endl;
     }
 
-    // Implementación básica: solo copiar archivos por ahora
     for (const auto& input : inputs) {
+        uint32_t fileId = sourceManager_->loadFile(input);
+        const diagnostics::SourceFile* file = sourceManager_->getFile(fileId);
+        if (!file) {
+            std::cerr << "Error: Archivo de entrada no encontrado: " << input << std::endl;
+            return false;
+        }
+
+        // "-o -" escribe en la salida estándar
         std::filesystem::path outputFile = determineOutputFile({input}, options);
+        std::ofstream stream;
+        if (outputFile != "-") {
+            stream.open(outputFile, std::ios::binary | std::ios::trunc);
+            if (!stream) {
+                std::cerr << "Error: no se pudo escribir " << outputFile << std::endl;
+                return false;
+            }
+        }
+        std::ostream& out = outputFile == "-" ? std::cout : stream;
+
+        frontend::lexer::LexerConfig lexerConfig;
+        lexerConfig.fileId = fileId;
+        frontend::lexer::Lexer lexer(file->text(), *diagnosticEngine_, lexerConfig);
+        frontend::PreprocessorConfig ppConfig;
+        ppConfig.includePaths = options.includePaths;
+        ppConfig.conditionCache = conditionCache_;
+        ppConfig.headerUnits = headerUnits_;
+        frontend::Preprocessor preprocessor(*diagnosticEngine_, ppConfig);
+        preprocessor.applyCommandLineMacros(options.defines, options.undefines);
+
+        // Los tokens van al escritor según salen: la unidad no se materializa
+        bool written = false;
+        preprocessor.begin(lexer);
+        if (options.preprocessedTokens) {
+            frontend::PreprocessedTokenWriter writer(out, sourceManager_);
+            while (auto token = preprocessor.nextToken()) {
+                writer.write(*token);
+            }
+            written = writer.finish();
+        } else {
+            frontend::PreprocessedTextWriter writer(out, sourceManager_);
+            while (auto token = preprocessor.nextToken()) {
+                writer.write(*token);
+            }
+            written = writer.finish();
+        }
+        if (!written) {
+            std::cerr << "Error: no se pudo escribir " << outputFile << std::endl;
+            return false;
+        }
 
-        // Simular preprocesamiento básico
         if (options.verbose) {
             std::cout << "Preprocesado: " << input << " -> " << outputFile << std::endl;
         }
     }
 
-    return true;
+    return !diagnosticEngine_->hasErrors();
+}
+
+bool CompilerDriver::runDependencyScan(const std::vector<std::filesystem::path>& inputs,
+                                      const CompilerOptions& options) {
+    if (options.verbose) {
+        std::cout << "Escaneando dependencias..." << std::endl;
+    }
+
+    std::vector<uint32_t> fileIds;
+    fileIds.reserve(inputs.size());
+    for (const auto& input : inputs) {
+        uint32_t fileId = sourceManager_->loadFile(input);
+        if (fileId == 0) {
+            std::cerr << "Error: Archivo de entrada no encontrado: " << input << std::endl;
+            return false;
+        }
+        fileIds.push_back(fileId);
+    }
+
+    frontend::DependencyScanOptions scanOptions;
+    scanOptions.preprocessor.includePaths = options.includePaths;
+    scanOptions.defines = options.defines;
+    scanOptions.undefines = options.undefines;
+    scanOptions.jobs = std::max<size_t>(1, std::min(options.jobs, inputs.size()));
+
+    // Todas las unidades comparten el SourceManager y con él la caché de includes
+    frontend::DependencyScanner scanner(sourceManager_, scanOptions);
+    std::vector<frontend::DependencyScanResult> results = scanner.scanAll(fileIds);
+
+    std::ofstream file;
+    if (!options.outputFile.empty()) {
+        file.open(options.outputFile);
+        if (!file) {
+            std::cerr << "Error: no se pudo escribir " << options.outputFile << std::endl;
+            return false;
+        }
+    }
+    std::ostream& out = options.outputFile.empty() ? std::cout : file;
+
+    bool success = true;
+    for (size_t i = 0; i < results.size(); ++i) {
+        for (const auto& diagnostic : results[i].diagnostics) {
+            diagnosticEngine_->emit(diagnostic);
+        }
+        success = success && results[i].success;
+
+        std::filesystem::path target = inputs[i].stem().string() + ".obj";
+        out << frontend::DependencyScanner::formatMakeRule(results[i], target.string());
+    }
+
+    return success;
 }
 
 bool CompilerDriver::runCompilation(const std::vector<std::filesystem::path>& inputs,
-                                   const CompilerOptions& options) {
+                                   const CompilerOptions& options,
+                                   bool inMemory) {
     if (options.verbose) {
         std::cout << "Ejecutando compilación..." << std::endl;
     }
 
-    // Simular compilación básica
-    for (const auto& input : inputs) {
-        std::filesystem::path outputFile = determineOutputFile({input}, options);
+    objectFiles_.clear();
+    objectImages_.clear();
 
-        if (options.verbose) {
-            std::cout << "Compilando: " << input << " -> " << outputFile << std::endl;
+    // Con un solo worker y varias unidades, las fases de unidades
+    // consecutivas se solapan en un pipeline en lugar de ir en serie
+    size_t jobs = std::max<size_t>(1, std::min(options.jobs, inputs.size()));
+    bool pipelined = jobs == 1 && inputs.size() > 1;
+
+    // Resolver IDs antes de repartir: una entrada que falta detiene la
+    // compilación sin empezar ninguna unidad
+    std::vector<uint32_t> fileIds(inputs.size(), 0);
+    for (size_t i = 0; i < inputs.size() && !pipelined; ++i) {
+        fileIds[i] = sourceManager_->loadFile(inputs[i]);
+        if (fileIds[i] == 0) {
+            std::cerr << "Error: Archivo de entrada no encontrado: " << inputs[i] << std::endl;
+            return false;
         }
+    }
 
-        // Verificar que el archivo existe
-        if (!std::filesystem::exists(input)) {
-            std::cerr << "Error: Archivo de entrada no encontrado: " << input << std::endl;
+    if (options.verbose && jobs > 1) {
+        std::cout << "Compilando " << inputs.size() << " unidades con " << jobs
+                  << " workers" << std::endl;
+    }
+
+    // Anunciar las unidades desde este hilo: la salida de los workers no
+    // llegaría a la respuesta del servidor, que se captura por hilo
+    if (options.verbose) {
+        for (const auto& input : inputs) {
+            std::cout << "Compilando: " << input << " -> "
+                      << (inMemory ? "(memoria)" : objectFileFor(input, options, inputs).string())
+                      << std::endl;
+        }
+    }
+
+    std::vector<TranslationUnitResult> results(inputs.size());
+    if (pipelined) {
+        if (!compilePipelined(inputs, options, inMemory, fileIds, results)) {
             return false;
         }
+    } else {
+        common::utils::parallelFor(inputs.size(), jobs, [&](size_t index) {
+            results[index] = compileTranslationUnit(inputs[index], fileIds[index],
+                                                    options, inputs, inMemory);
+        });
+    }
+
+    // Volcar diagnósticos en orden determinista (orden de entrada)
+    mergeDiagnostics(results);
+
+    if (options.verbose && objectCache_) {
+        std::cout << "Caché de objetos: " << objectCache_->hitCount() << " aciertos, "
+                  << objectCache_->missCount() << " fallos" << std::endl;
+    }
+
+    if (!options.telemetryFile.empty()) {
+        std::vector<TelemetryRecord> records;
+        for (size_t i = 0; i < results.size(); ++i) {
+            const auto& result = results[i];
+            if (!result.profile) continue;
+            CompilationTelemetry telemetry(*result.profile);
+            telemetry.recordPhaseTimes();
+            telemetry.recordMetric("unit.success", result.success ? 1.0 : 0.0);
+            telemetry.recordMetric("unit.diagnostics", static_cast<double>(result.diagnostics.size()));
+            if (const auto* file = sourceManager_->getFile(fileIds[i])) {
+                telemetry.recordMetric("unit.source_bytes", static_cast<double>(file->text().size()));
+            }
+            records.push_back(telemetry.toRecord(result.inputFile.string(), compilerVersion()));
+        }
+        appendTelemetry(records, options);
     }
 
+    bool success = true;
+    for (auto& result : results) {
+        if (!result.success) {
+            success = false;
+            continue;
+        }
+        objectFiles_.push_back(result.objectFile);
+        if (inMemory) {
+            objectImages_.push_back(std::move(result.objectImage));
+        }
+    }
+
+    return success;
+}
+
+/**
+ * @brief Unidad ya parseada que espera al backend
+ *
+ * Lleva consigo todo lo que el AST referencia: la arena (declarada antes
+ * que tokens y AST para sobrevivirles), el shard de diagnósticos, el
+ * lexer y los tokens que el parser no copia.
+ */
+struct CompilerDriver::ParsedUnit {
+    ParsedUnit(std::shared_ptr<diagnostics::SourceManager> sources,
+               const common::utils::ArenaBacking& backing)
+        : arena(64 * 1024, 1, backing), shard(std::move(sources)) {}
+
+    TranslationUnitResult result;
+    common::utils::MemoryPool arena;
+    diagnostics::DiagnosticEngine shard;
+    std::unique_ptr<frontend::lexer::Lexer> lexer;
+    std::vector<frontend::lexer::Token> tokens;
+    std::unique_ptr<frontend::Parser> parser;
+    ast::TranslationUnit* translationUnit = nullptr;
+    uint32_t fileId = 0;
+    std::vector<uint32_t> dependencies;     // Archivos incluidos, para la caché de objetos
+    size_t bodyJobs = 1;
+    bool parsed = false;    // Sin errores: la unidad pasa a emitirse
+    bool cached = false;    // Objeto y diagnósticos ya en result, de la caché de objetos
+};
+
+TranslationUnitResult CompilerDriver::compileTranslationUnit(const std::filesystem::path& input,
+                                                             uint32_t fileId,
+                                                             const CompilerOptions& options,
+                                                             const std::vector<std::filesystem::path>& inputs,
+                                                             bool inMemory) const {
+    AutoTimer unitTimer(profiler_.get(), CompilationPhase::TranslationUnit, input.string());
+    std::unique_ptr<ParsedUnit> unit = parseTranslationUnit(input, fileId, options, inputs);
+    return emitTranslationUnit(*unit, options, inMemory);
+}
+
+std::unique_ptr<CompilerDriver::ParsedUnit> CompilerDriver::parseTranslationUnit(
+        const std::filesystem::path& input, uint32_t fileId, const CompilerOptions& options,
+        const std::vector<std::filesystem::path>& inputs) const {
+    // Con -farena-reserve la arena ocupa una región propia en el nodo NUMA de este worker
+    common::utils::ArenaBacking backing;
+    backing.reserveBytes = options.arenaReserveMB * 1024 * 1024;
+    backing.largePages = options.arenaLargePages;
+    if (backing.largePages && backing.reserveBytes == 0) {
+        backing.reserveBytes = kDefaultLargePageArena;
+    }
+    if (backing.reserveBytes > 0) {
+        backing.numaNode = common::utils::ArenaBacking::currentNumaNode();
+    }
+    auto unit = std::make_unique<ParsedUnit>(sourceManager_, backing);
+    unit->fileId = fileId;
+    TranslationUnitResult& result = unit->result;
+    result.inputFile = input;
+    result.objectFile = objectFileFor(input, options, inputs);
+
+    // Con -ftelemetry cada unidad mide además sus fases por separado
+    if (!options.telemetryFile.empty()) {
+        result.profile = std::make_unique<TimingProfiler>();
+    }
+
+    // Shard de diagnósticos local al worker: sin consumers, solo historial
+    diagnostics::DiagnosticEngine& shard = unit->shard;
+    shard.clearConsumers();
+    auto shardOptions = diagnosticEngine_->options();
+    shardOptions.maxErrors = static_cast<int>(options.maxErrors);
+    shard.setOptions(shardOptions);
+
+    const diagnostics::SourceFile* file = sourceManager_->getFile(fileId);
+    if (!file) {
+        return unit;
+    }
+
+    // Acierto en la caché de objetos: ni preprocesar ni parsear
+    if (objectCache_) {
+        if (auto cached = objectCache_->lookup(fileId)) {
+            result.objectImage = std::move(cached->image);
+            result.diagnostics = std::move(cached->diagnostics);
+            unit->cached = true;
+            return unit;
+        }
+    }
+
+    // Arena de la unidad. Guarda sobre todo nodos del AST, así que se le atribuye entera
+    common::utils::MemoryPool& arena = unit->arena;
+    arena.setSubsystem(common::utils::MemorySubsystem::AST);
+
+    // Lexing bajo demanda sobre la vista del SourceManager (sin copia)
+    frontend::lexer::LexerConfig lexerConfig;
+    lexerConfig.fileId = fileId;
+    unit->lexer = std::make_unique<frontend::lexer::Lexer>(file->text(), shard, lexerConfig, &arena);
+
+    // Preprocesamiento: extrae los tokens del lexer a medida que los necesita
+    std::optional<AutoTimer> phaseTimer;
+    std::optional<AutoTimer> unitPhaseTimer;
+    std::optional<common::utils::MemoryScope> memoryScope;
+    auto beginPhase = [&](CompilationPhase phase, const std::string& detail,
+                          common::utils::MemorySubsystem subsystem) {
+        phaseTimer.emplace(profiler_.get(), phase, detail);
+        unitPhaseTimer.emplace(result.profile.get(), phase);
+        memoryScope.emplace(subsystem);
+    };
+    beginPhase(CompilationPhase::Preprocessing, input.string(), common::utils::MemorySubsystem::Tokens);
+    frontend::PreprocessorConfig ppConfig;
+    ppConfig.includePaths = options.includePaths;
+    ppConfig.conditionCache = conditionCache_;
+    ppConfig.headerUnits = headerUnits_;
+    frontend::Preprocessor preprocessor(shard, ppConfig);
+    preprocessor.applyCommandLineMacros(options.defines, options.undefines);
+
+    // Las unidades con los mismos #include iniciales y opciones comparten instantánea
+    std::filesystem::path snapshotFile;
+    uint64_t snapshotKey = 0;
+    std::string_view prologue = frontend::PreprocessorSnapshot::prologueOf(file->text());
+    if (!options.snapshotDirectory.empty() && !prologue.empty()) {
+        snapshotKey = frontend::PreprocessorSnapshot::computeKey(prologue, ppConfig, options.defines,
+                                                                 options.undefines);
+        snapshotFile = frontend::PreprocessorSnapshot::fileFor(options.snapshotDirectory, snapshotKey);
+        auto snapshot = frontend::PreprocessorSnapshot::load(snapshotFile);
+        if (!snapshot || snapshot->key != snapshotKey || !preprocessor.restoreSnapshot(*snapshot, fileId)) {
+            preprocessor.requestSnapshot(fileId, prologue.size());
+        }
+    }
+
+    unit->tokens = preprocessor.process(*unit->lexer);
+    if (objectCache_) {
+        for (const auto& record : preprocessor.includeGraph()) {
+            if (record.fileId != 0) {
+                unit->dependencies.push_back(record.fileId);
+            }
+        }
+    }
+    if (auto captured = preprocessor.takeSnapshot()) {
+        captured->key = snapshotKey;
+        std::error_code ignored;
+        std::filesystem::create_directories(options.snapshotDirectory, ignored);
+        captured->save(snapshotFile);
+    }
+
+    // Parsing
+    beginPhase(CompilationPhase::Parsing, input.string(), common::utils::MemorySubsystem::AST);
+    // Los hilos de -j que sobran cuando hay menos unidades que workers
+    // parsean cuerpos de función: primero declaraciones, luego cuerpos
+    size_t unitJobs = std::max<size_t>(1, std::min(options.jobs, inputs.size()));
+    unit->bodyJobs = std::max<size_t>(1, options.jobs / unitJobs);
+
+    frontend::ParserConfig parserConfig;
+    parserConfig.delayFunctionBodies = options.delayFunctionBodies || unit->bodyJobs > 1;
+    unit->parser = std::make_unique<frontend::Parser>(unit->tokens, shard, parserConfig, &arena);
+    unit->translationUnit = unit->parser->parse();
+    if (!options.delayFunctionBodies) {
+        unit->parser->parseDelayedBodies(unit->bodyJobs);
+    }
+    // Con -fdelayed-function-bodies, las etapas que necesiten un cuerpo
+    // llaman a parser.parseDelayedBody(); la emisión actual no usa ninguno.
+
+    unit->parsed = unit->translationUnit && unit->parser->isSuccessful() && !shard.hasErrors();
+    return unit;
+}
+
+TranslationUnitResult CompilerDriver::emitTranslationUnit(ParsedUnit& unit, const CompilerOptions& options,
+                                                          bool inMemory) const {
+    TranslationUnitResult& result = unit.result;
+    if (unit.cached) {
+        result.success = inMemory || writeObjectImage(result.objectFile, result.objectImage);
+        return std::move(result);
+    }
+    if (!unit.parsed) {
+        result.diagnostics = unit.shard.diagnostics();
+        return std::move(result);
+    }
+
+    // Emisión del objeto COFF de la unidad; con caché de objetos, en memoria para publicarlo
+    bool toMemory = inMemory || objectCache_;
+    {
+        AutoTimer phaseTimer(profiler_.get(), CompilationPhase::ObjectEmission, result.objectFile.string());
+        AutoTimer unitPhaseTimer(result.profile.get(), CompilationPhase::ObjectEmission);
+        common::utils::MemoryScope memoryScope(common::utils::MemorySubsystem::Backend);
+        auto object = backend::coff::createBasicCOFFObject();
+        if (options.lto) {
+            // El front-end aún no baja el AST a IR: el módulo de la unidad va vacío
+            ir::IRModule module(result.inputFile.stem().string());
+            if (options.profileGenerate) {
+                ir::ProfileInstrumentationPass().run(module);
+            }
+            backend::link::embedIRModule(object, module);
+        }
+        backend::coff::COFFWriter writer;
+        result.success = toMemory ? writer.writeObject(object, result.objectImage, unit.bodyJobs)
+                                  : writer.writeObject(object, result.objectFile.string(), unit.bodyJobs);
+    }
+
+    result.diagnostics = unit.shard.diagnostics();
+    if (result.success && objectCache_) {
+        objectCache_->store(unit.fileId, unit.dependencies, result.objectImage, result.diagnostics);
+        if (!inMemory) {
+            result.success = writeObjectImage(result.objectFile, result.objectImage);
+        }
+    }
+    if (!inMemory) {
+        std::vector<uint8_t>().swap(result.objectImage);
+    }
+    return std::move(result);
+}
+
+bool CompilerDriver::compilePipelined(const std::vector<std::filesystem::path>& inputs,
+                                      const CompilerOptions& options,
+                                      bool inMemory,
+                                      std::vector<uint32_t>& fileIds,
+                                      std::vector<TranslationUnitResult>& results) {
+    // Unidades en espera entre dos etapas: mientras una se emite, la
+    // siguiente se parsea y la de después ya se está leyendo
+    constexpr size_t StageDepth = 2;
+    common::utils::BoundedQueue<size_t> loaded(StageDepth);
+    common::utils::BoundedQueue<std::pair<size_t, std::unique_ptr<ParsedUnit>>> parsed(StageDepth);
+    common::utils::BoundedQueue<size_t> emitted(StageDepth);
+
+    // Un fallo en cualquier etapa cierra todas las colas para que las demás terminen
+    std::mutex errorMutex;
+    std::exception_ptr firstError;
+    auto fail = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!firstError) {
+                firstError = std::current_exception();
+            }
+        }
+        loaded.close();
+        parsed.close();
+        emitted.close();
+    };
+
+    size_t missing = inputs.size();     // Primera entrada que no existe
+    std::thread loader([&]() {
+        try {
+            for (size_t i = 0; i < inputs.size(); ++i) {
+                fileIds[i] = sourceManager_->loadFile(inputs[i]);
+                if (fileIds[i] == 0) {
+                    missing = i;
+                    break;
+                }
+                if (!loaded.push(i)) {
+                    break;
+                }
+            }
+        } catch (...) {
+            fail();
+        }
+        loaded.close();
+    });
+
+    std::thread frontend([&]() {
+        try {
+            while (auto index = loaded.pop()) {
+                AutoTimer unitTimer(profiler_.get(), CompilationPhase::TranslationUnit, inputs[*index].string());
+                auto unit = parseTranslationUnit(inputs[*index], fileIds[*index], options, inputs);
+                if (!parsed.push({*index, std::move(unit)})) {
+                    break;
+                }
+            }
+        } catch (...) {
+            fail();
+        }
+        parsed.close();
+    });
+
+    // El objeto se emite en memoria y un hilo aparte lo escribe a disco
+    std::thread writer([&]() {
+        try {
+            while (auto index = emitted.pop()) {
+                TranslationUnitResult& result = results[*index];
+                result.success = writeObjectImage(result.objectFile, result.objectImage);
+                std::vector<uint8_t>().swap(result.objectImage);
+            }
+        } catch (...) {
+            fail();
+        }
+    });
+
+    // Backend en este hilo; el AST de cada unidad se libera al emitirla
+    try {
+        while (auto unit = parsed.pop()) {
+            size_t index = unit->first;
+            results[index] = emitTranslationUnit(*unit->second, options, true);
+            unit.reset();
+            if (!inMemory && results[index].success && !emitted.push(index)) {
+                break;
+            }
+        }
+    } catch (...) {
+        fail();
+    }
+    emitted.close();
+
+    loader.join();
+    frontend.join();
+    writer.join();
+
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+    if (missing < inputs.size()) {
+        std::cerr << "Error: Archivo de entrada no encontrado: " << inputs[missing] << std::endl;
+        return false;
+    }
     return true;
 }
 
+void CompilerDriver::mergeDiagnostics(const std::vector<TranslationUnitResult>& results) {
+    for (const auto& result : results) {
+        for (const auto& diagnostic : result.diagnostics) {
+            diagnosticEngine_->emit(diagnostic);
+        }
+    }
+}
+
+std::filesystem::path CompilerDriver::objectFileFor(const std::filesystem::path& input,
+                                                    const CompilerOptions& options,
+                                                    const std::vector<std::filesystem::path>& inputs) const {
+    // -c -o archivo solo tiene sentido con una única entrada
+    if (options.compileOnly && inputs.size() == 1 && !options.outputFile.empty()) {
+        return options.outputFile;
+    }
+
+    // a/foo.cpp y b/foo.cpp no pueden compartir foo.obj: con -j dos workers
+    // lo escribirían a la vez. Si otra entrada tiene el mismo stem (sin
+    // distinguir mayúsculas, como en Windows) se añade un hash de la ruta.
+    auto foldedStem = [](const std::filesystem::path& path) {
+        std::string stem = path.stem().string();
+        std::transform(stem.begin(), stem.end(), stem.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return stem;
+    };
+    std::string stem = input.stem().string();
+    std::string folded = foldedStem(input);
+    std::filesystem::path normalized = input.lexically_normal();
+    bool shared = std::any_of(inputs.begin(), inputs.end(), [&](const std::filesystem::path& other) {
+        return other.lexically_normal() != normalized && foldedStem(other) == folded;
+    });
+    if (!shared) {
+        return stem + ".obj";
+    }
+
+    std::ostringstream name;
+    name << stem << '-' << std::hex << std::setw(8) << std::setfill('0')
+         << static_cast<uint32_t>(common::utils::fnv1a64(normalized.generic_string()));
+    return name.str() + ".obj";
+}
+
 bool CompilerDriver::runAssembly(const std::vector<std::filesystem::path>& /*inputs*/,
                                 const CompilerOptions& /*options*/) {
     // TODO: Implementar ensamblado
@@ -256,10 +1029,116 @@ bool CompilerDriver::runAssembly(const std::vector<std::filesystem::path>& /*inp
     return true;
 }
 
-bool CompilerDriver::runLinking(const std::vector<std::filesystem::path>& /*inputs*/,
-                               const CompilerOptions& /*options*/) {
-    // TODO: Implementar linking
-    std::cout << "Fase de linking - TODO" << std::endl;
+bool CompilerDriver::runLinking(const std::vector<std::filesystem::path>& inputs,
+                               const CompilerOptions& options) {
+    // Se enlaza en el proceso salvo que haga falta algo que solo sabe hacer link.exe
+    std::string feature = externalLinkerFeature(options);
+    std::unique_ptr<backend::LinkerIntegration> external;
+    if (!feature.empty()) {
+        backend::LinkerConfig config;
+        config.debugSymbols = options.debugInfo;
+        config.incrementalLinking = options.incrementalLink;
+        external = std::make_unique<backend::LinkerIntegration>(config);
+        if (!external->isLinkerAvailable()) {
+            std::cerr << "Advertencia: link.exe no disponible; se enlaza sin " << feature << std::endl;
+            external.reset();
+        }
+    }
+
+    // Sin .obj temporales, salvo que se pidan (-save-temps) o que el enlace
+    // incremental necesite sus fechas para saber qué cambió
+    bool inMemory = !external && options.saveTemps.empty() && !options.incrementalLink;
+    if (!runCompilation(inputs, options, inMemory)) {
+        return false;
+    }
+
+    if (options.verbose) {
+        std::cout << "Ejecutando linking" << (external ? " con link.exe (" + feature + ")" : std::string()) << "..."
+                  << std::endl;
+    }
+
+    std::filesystem::path outputFile = determineOutputFile(inputs, options);
+    if (external) {
+        auto linkResult = options.outputFormat == "dll"
+            ? external->linkDLL(objectFiles_, outputFile, options.libraries, options.libraryPaths)
+            : external->linkExecutable(objectFiles_, outputFile, options.libraries, options.libraryPaths);
+        if (!linkResult.success) {
+            std::cerr << "Error de linking: " << linkResult.errorMessage << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Los objetos de cada worker van directamente al MiniLinker
+    backend::link::MiniLinker linker;
+    linker.setOptimize(options.optimizationLevel > 0);   // /OPT:REF: quita las funciones sin usar
+    linker.setJobs(options.jobs);
+    linker.setIncremental(options.incrementalLink);
+    linker.setLTOOptimizationLevel(options.optimizationLevel);
+    auto [features, tune] = resolveTarget(options);
+    linker.setTarget(features, tune);
+    if (!options.codegenCacheDirectory.empty()) {
+        linker.setCodeCache(std::make_shared<backend::MachineCodeCache>(
+            std::make_shared<DirectoryCacheBackend>(options.codegenCacheDirectory),
+            compilerVersion() + " " __DATE__ " " __TIME__));
+    }
+    if (!options.profileUse.empty()) {
+        auto profile = std::make_shared<ir::ProfileData>();
+        if (!profile->readFile(options.profileUse)) {
+            std::cerr << "Error: " << profile->getLastError() << std::endl;
+            return false;
+        }
+        linker.setProfile(std::move(profile));
+    }
+    if (!options.orderFile.empty() && !linker.loadOrderFile(options.orderFile)) {
+        std::cerr << "Error: no se puede abrir el archivo de orden " << options.orderFile << std::endl;
+        return false;
+    }
+    bool added;
+    if (inMemory) {
+        std::vector<backend::link::ObjectImage> images;
+        for (size_t i = 0; i < objectFiles_.size(); ++i) {
+            images.push_back({objectFiles_[i], std::move(objectImages_[i])});
+        }
+        objectImages_.clear();
+        added = linker.addObjectImages(std::move(images));
+    } else {
+        added = linker.addObjectFiles(objectFiles_);
+    }
+    if (!added) {
+        std::cerr << "Error: no se pudieron añadir todos los objetos" << std::endl;
+        return false;
+    }
+
+    for (const auto& library : options.libraries) {
+        linker.addLibrary(library);
+    }
+    for (const auto& dll : options.delayLoadDlls) {
+        linker.addDelayLoad(dll);
+    }
+
+    TimingProfiler linkProfiler;
+    backend::link::LinkResult linkResult;
+    {
+        AutoTimer linkTimer(linkProfiler, CompilationPhase::FinalLinking);
+        linkResult = linker.link(outputFile);
+    }
+
+    if (!options.telemetryFile.empty()) {
+        CompilationTelemetry telemetry(linkProfiler);
+        telemetry.recordPhaseTimes();
+        for (const auto& [name, value] : linker.getLinkStatistics()) {
+            telemetry.recordMetric("link." + name, static_cast<double>(value));
+        }
+        telemetry.recordMetric("link.success", linkResult.success ? 1.0 : 0.0);
+        appendTelemetry({telemetry.toRecord(outputFile.string(), compilerVersion())}, options);
+    }
+
+    if (!linkResult.success) {
+        std::cerr << "Error de linking: " << linkResult.errorMessage << std::endl;
+        return false;
+    }
+
     return true;
 }
 
@@ -308,11 +1187,37 @@ void CompilerDriver::cleanupTempFiles(const CompilerOptions& /*options*/) {
     // TODO: Implementar limpieza de archivos temporales
 }
 
-void CompilerDriver::reportTiming(double totalTime, const CompilerOptions& /*options*/) const {
+void CompilerDriver::reportTiming(double totalTime, const CompilerOptions& options) const {
     std::cout << "Tiempo total de compilación: " << std::fixed << std::setprecision(3)
               << totalTime << " segundos" << std::endl;
 
-    // TODO: Reportar tiempos por fase cuando estén implementadas
+    if (profiler_) {
+        std::cout << profiler_->generateTimingReport() << std::flush;
+        if (options.timingEntities) {
+            std::cout << "\n" << profiler_->generateEntityReport() << std::flush;
+        }
+    }
+}
+
+std::string CompilerDriver::compilerVersion() {
+    return CPP20_COMPILER_VERSION;
+}
+
+void CompilerDriver::appendTelemetry(const std::vector<TelemetryRecord>& records,
+                                     const CompilerOptions& options) const {
+    // La telemetría no debe romper el build: un fallo solo se avisa
+    TelemetrySink sink(options.telemetryFile);
+    if (!sink.append(records)) {
+        std::cerr << "Advertencia: no se pudo escribir la telemetría en " << options.telemetryFile << std::endl;
+    }
+}
+
+void CompilerDriver::reportMemory() const {
+    std::cout << MemoryProfiler::generateSubsystemReport();
+    if (profiler_) {
+        std::cout << "\n" << profiler_->generatePhaseMemoryReport();
+    }
+    std::cout << std::flush;
 }
 
 
@@ -0,0 +1,616 @@
+/**
+ * @file CompilerServer.cpp
+ * @brief Servidor residente del compilador y cliente para reenviarle invocaciones
+ */
+
+#include <compiler/driver/CompilerServer.h>
+#include <compiler/driver/CommandLineParser.h>
+#include <compiler/driver/CompilerDriver.h>
+#include <compiler/common/CacheFile.h>
+#include <compiler/common/utils/HashUtils.h>
+#include <compiler/common/utils/ThreadPool.h>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <unordered_set>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <afunix.h>
+#else
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace cpp20::compiler {
+
+namespace {
+
+#ifdef _WIN32
+using NativeSocket = SOCKET;
+constexpr NativeSocket kInvalidSocket = INVALID_SOCKET;
+
+void closeSocket(NativeSocket socket) {
+    closesocket(socket);
+}
+
+bool initSockets() {
+    static const bool initialized = []() {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    return initialized;
+}
+
+bool interrupted() {
+    return false;
+}
+#else
+using NativeSocket = int;
+constexpr NativeSocket kInvalidSocket = -1;
+
+void closeSocket(NativeSocket socket) {
+    close(socket);
+}
+
+bool initSockets() {
+    return true;
+}
+
+bool interrupted() {
+    return errno == EINTR;
+}
+#endif
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;  // Un cliente que se va no mata al servidor
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+constexpr uint32_t kFrameMagic = 0x56525343;        // "CSRV"
+constexpr uint32_t kProtocolVersion = 1;
+constexpr uint32_t kMaxFrameSize = 256u * 1024 * 1024;
+
+bool makeAddress(const std::filesystem::path& endpoint, sockaddr_un& address) {
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::string path = endpoint.string();
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+    return true;
+}
+
+NativeSocket connectTo(const std::filesystem::path& endpoint) {
+    sockaddr_un address;
+    if (!makeAddress(endpoint, address)) {
+        return kInvalidSocket;
+    }
+    NativeSocket connection = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connection == kInvalidSocket) {
+        return kInvalidSocket;
+    }
+    if (connect(connection, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        closeSocket(connection);
+        return kInvalidSocket;
+    }
+    return connection;
+}
+
+bool sendAll(NativeSocket connection, const char* data, size_t size) {
+    while (size > 0) {
+        auto chunk = static_cast<int>(std::min<size_t>(size, 1u << 30));
+        auto sent = ::send(connection, data, chunk, kSendFlags);
+        if (sent < 0 && interrupted()) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool receiveAll(NativeSocket connection, char* data, size_t size) {
+    while (size > 0) {
+        auto chunk = static_cast<int>(std::min<size_t>(size, 1u << 30));
+        auto received = ::recv(connection, data, chunk, 0);
+        if (received < 0 && interrupted()) {
+            continue;
+        }
+        if (received <= 0) {
+            return false;
+        }
+        data += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+// Trama: magia y longitud (u32 little-endian) seguidas del registro
+bool writeFrame(NativeSocket connection, const std::string& payload) {
+    CacheRecordWriter header;
+    header.u32(kFrameMagic);
+    header.u32(static_cast<uint32_t>(payload.size()));
+    std::string bytes = header.take();
+    return sendAll(connection, bytes.data(), bytes.size()) &&
+           sendAll(connection, payload.data(), payload.size());
+}
+
+std::optional<std::string> readFrame(NativeSocket connection) {
+    char header[8];
+    if (!receiveAll(connection, header, sizeof(header))) {
+        return std::nullopt;
+    }
+    CacheRecordReader reader(std::string_view(header, sizeof(header)));
+    uint32_t magic = reader.u32();
+    uint32_t size = reader.u32();
+    if (magic != kFrameMagic || size > kMaxFrameSize) {
+        return std::nullopt;
+    }
+    std::string payload(size, '\0');
+    if (!receiveAll(connection, payload.data(), payload.size())) {
+        return std::nullopt;
+    }
+    return payload;
+}
+
+std::string encodeRequest(const ServerRequest& request) {
+    CacheRecordWriter writer;
+    writer.u32(kProtocolVersion);
+    writer.str(request.workingDirectory.string());
+    writer.u32(static_cast<uint32_t>(request.arguments.size()));
+    for (const auto& argument : request.arguments) {
+        writer.str(argument);
+    }
+    return writer.take();
+}
+
+bool decodeRequest(std::string_view payload, ServerRequest& request) {
+    CacheRecordReader reader(payload);
+    if (reader.u32() != kProtocolVersion) {
+        return false;
+    }
+    request.workingDirectory = std::string(reader.str());
+    uint32_t count = reader.u32();
+    for (uint32_t i = 0; i < count && reader.ok(); ++i) {
+        request.arguments.emplace_back(reader.str());
+    }
+    return reader.ok() && reader.atEnd();
+}
+
+std::string encodeResponse(const ServerResponse& response) {
+    CacheRecordWriter writer;
+    writer.u32(kProtocolVersion);
+    writer.u32(static_cast<uint32_t>(response.exitCode));
+    writer.str(response.standardOutput);
+    writer.str(response.standardError);
+    return writer.take();
+}
+
+bool decodeResponse(std::string_view payload, ServerResponse& response) {
+    CacheRecordReader reader(payload);
+    if (reader.u32() != kProtocolVersion) {
+        return false;
+    }
+    response.exitCode = static_cast<int>(reader.u32());
+    response.standardOutput = std::string(reader.str());
+    response.standardError = std::string(reader.str());
+    return reader.ok() && reader.atEnd();
+}
+
+// Destino de std::cout (0) y std::cerr (1) del hilo actual; nullptr = sin capturar
+thread_local std::string* captureTargets[2] = {nullptr, nullptr};
+
+/**
+ * @brief streambuf que escribe en la respuesta del hilo o, si no hay, en el original
+ *
+ * No tiene área de escritura propia: cada escritura consulta el destino del
+ * hilo, así que peticiones concurrentes no mezclan su salida.
+ */
+class RoutedStreamBuffer : public std::streambuf {
+public:
+    RoutedStreamBuffer(std::streambuf* fallback, int slot) : fallback_(fallback), slot_(slot) {}
+
+protected:
+    int_type overflow(int_type c) override {
+        if (traits_type::eq_int_type(c, traits_type::eof())) {
+            return traits_type::not_eof(c);
+        }
+        if (std::string* target = captureTargets[slot_]) {
+            target->push_back(traits_type::to_char_type(c));
+            return c;
+        }
+        return fallback_->sputc(traits_type::to_char_type(c));
+    }
+
+    std::streamsize xsputn(const char* data, std::streamsize count) override {
+        if (std::string* target = captureTargets[slot_]) {
+            target->append(data, static_cast<size_t>(count));
+            return count;
+        }
+        return fallback_->sputn(data, count);
+    }
+
+    int sync() override {
+        return captureTargets[slot_] ? 0 : fallback_->pubsync();
+    }
+
+private:
+    std::streambuf* fallback_;
+    int slot_;
+};
+
+/**
+ * @brief Dirige la salida del hilo a dos cadenas mientras vive el objeto
+ */
+class CaptureScope {
+public:
+    CaptureScope(std::string& output, std::string& error)
+        : previousOutput_(captureTargets[0]), previousError_(captureTargets[1]) {
+        captureTargets[0] = &output;
+        captureTargets[1] = &error;
+    }
+
+    ~CaptureScope() {
+        captureTargets[0] = previousOutput_;
+        captureTargets[1] = previousError_;
+    }
+
+private:
+    std::string* previousOutput_;
+    std::string* previousError_;
+};
+
+thread_local bool insideRequest = false;
+
+} // namespace
+
+CompilerServer::CompilerServer(std::filesystem::path endpoint, size_t jobs)
+    : endpoint_(std::move(endpoint)),
+      jobs_(jobs == 0 ? common::utils::ThreadPool::defaultThreadCount() : jobs) {
+    originalOutput_ = std::cout.rdbuf();
+    originalError_ = std::cerr.rdbuf();
+    routedOutput_ = std::make_unique<RoutedStreamBuffer>(originalOutput_, 0);
+    routedError_ = std::make_unique<RoutedStreamBuffer>(originalError_, 1);
+    std::cout.rdbuf(routedOutput_.get());
+    std::cerr.rdbuf(routedError_.get());
+
+    watcher_ = std::make_unique<common::utils::FileWatcher>(
+        [this](const std::filesystem::path& path) { recordChange(path); });
+}
+
+CompilerServer::~CompilerServer() {
+    // El watcher llama a recordChange desde su hilo: detenerlo primero
+    watcher_.reset();
+    std::cout.rdbuf(originalOutput_);
+    std::cerr.rdbuf(originalError_);
+}
+
+bool CompilerServer::serve() {
+    if (!initSockets()) {
+        std::cerr << "Error: no se pudieron inicializar los sockets" << std::endl;
+        return false;
+    }
+
+    sockaddr_un address;
+    if (!makeAddress(endpoint_, address)) {
+        std::cerr << "Error: ruta de socket no válida: " << endpoint_ << std::endl;
+        return false;
+    }
+
+    // Un socket que acepta conexiones pertenece a otro servidor; uno que no,
+    // es el resto de un servidor que terminó sin borrarlo
+    if (NativeSocket probe = connectTo(endpoint_); probe != kInvalidSocket) {
+        closeSocket(probe);
+        std::cerr << "Error: ya hay un servidor escuchando en " << endpoint_ << std::endl;
+        return false;
+    }
+    std::error_code ec;
+    std::filesystem::remove(endpoint_, ec);
+
+    NativeSocket listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener == kInvalidSocket ||
+        bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listener, SOMAXCONN) != 0) {
+        if (listener != kInvalidSocket) {
+            closeSocket(listener);
+        }
+        std::cerr << "Error: no se pudo escuchar en " << endpoint_ << std::endl;
+        return false;
+    }
+
+    stopping_ = false;
+    {
+        common::utils::ThreadPool pool(jobs_);
+        while (true) {
+            NativeSocket connection = accept(listener, nullptr, nullptr);
+            if (stopping_) {
+                if (connection != kInvalidSocket) {
+                    closeSocket(connection);
+                }
+                break;
+            }
+            if (connection == kInvalidSocket) {
+                continue;
+            }
+
+            pool.submit([this, connection]() {
+                auto payload = readFrame(connection);
+                ServerRequest request;
+                if (payload && decodeRequest(*payload, request)) {
+                    writeFrame(connection, encodeResponse(handle(request)));
+                }
+                closeSocket(connection);
+            });
+        }
+        pool.wait();
+    }
+
+    closeSocket(listener);
+    std::filesystem::remove(endpoint_, ec);
+    return true;
+}
+
+void CompilerServer::stop() {
+    stopping_ = true;
+
+    // Despertar a accept() con una conexión vacía
+    if (NativeSocket wake = connectTo(endpoint_); wake != kInvalidSocket) {
+        closeSocket(wake);
+    }
+}
+
+ServerResponse CompilerServer::handle(const ServerRequest& request) {
+    ServerResponse response;
+    CaptureScope capture(response.standardOutput, response.standardError);
+    insideRequest = true;
+
+    if (!enterDirectory(request.workingDirectory)) {
+        std::cerr << "Error: directorio de trabajo no válido: " << request.workingDirectory << std::endl;
+        insideRequest = false;
+        return response;
+    }
+
+    Session* session = acquireSession(sessionKey(request));
+    applyChanges(*session);
+
+    std::vector<std::string> arguments;
+    arguments.reserve(request.arguments.size() + 1);
+    arguments.push_back("cpp20-compiler");
+    arguments.insert(arguments.end(), request.arguments.begin(), request.arguments.end());
+
+    std::vector<char*> argv;
+    for (auto& argument : arguments) {
+        argv.push_back(argument.data());
+    }
+    argv.push_back(nullptr);
+
+    response.exitCode = session->driver->run(static_cast<int>(arguments.size()), argv.data());
+
+    watchLoadedFiles(*session);
+    releaseSession(session);
+    leaveDirectory();
+    insideRequest = false;
+    return response;
+}
+
+size_t CompilerServer::sessionCount() const {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    return sessions_.size();
+}
+
+std::optional<ServerResponse> CompilerServer::send(const std::filesystem::path& endpoint,
+                                                   const ServerRequest& request) {
+    if (!initSockets()) {
+        return std::nullopt;
+    }
+
+    NativeSocket connection = connectTo(endpoint);
+    if (connection == kInvalidSocket) {
+        return std::nullopt;
+    }
+
+    std::optional<ServerResponse> result;
+    if (writeFrame(connection, encodeRequest(request))) {
+        auto payload = readFrame(connection);
+        ServerResponse response;
+        if (payload && decodeResponse(*payload, response)) {
+            result = std::move(response);
+        }
+    }
+    closeSocket(connection);
+    return result;
+}
+
+bool CompilerServer::handlingRequest() {
+    return insideRequest;
+}
+
+uint64_t CompilerServer::sessionKey(const ServerRequest& request) const {
+    std::vector<std::string> arguments = {"cpp20-compiler"};
+    arguments.insert(arguments.end(), request.arguments.begin(), request.arguments.end());
+    std::vector<char*> argv;
+    for (auto& argument : arguments) {
+        argv.push_back(argument.data());
+    }
+
+    // Los errores de parseo los volverá a informar el driver
+    CompilerOptions options;
+    std::string discarded;
+    {
+        CaptureScope quiet(discarded, discarded);
+        try {
+            CommandLineParser parser;
+            parser.setCache(&ParsedOptionsCache::shared());
+            parser.parse(static_cast<int>(argv.size()), argv.data(), options);
+        } catch (const std::exception&) {
+        }
+    }
+
+    // Solo lo que determina qué archivo resuelve cada #include
+    std::string key = request.workingDirectory.string();
+    for (const auto& path : options.includePaths) {
+        key += '\0';
+        key += path;
+    }
+    key += '\0';
+    key += options.standard;
+    key += '\0';
+    key += options.includeCacheFile.string();
+    return common::utils::fnv1a64(key);
+}
+
+CompilerServer::Session* CompilerServer::acquireSession(uint64_t key) {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+
+    for (auto& session : sessions_) {
+        if (!session->busy && session->key == key) {
+            session->busy = true;
+            return session.get();
+        }
+    }
+
+    // Sin sesión libre con esa configuración: crear otra, descartando la
+    // libre usada hace más tiempo si se alcanzó el límite
+    if (sessions_.size() >= kMaxSessions) {
+        auto victim = sessions_.end();
+        for (auto it = sessions_.begin(); it != sessions_.end(); ++it) {
+            if (!(*it)->busy && (victim == sessions_.end() || (*it)->lastUsed < (*victim)->lastUsed)) {
+                victim = it;
+            }
+        }
+        if (victim != sessions_.end()) {
+            sessions_.erase(victim);
+        }
+    }
+
+    auto session = std::make_unique<Session>();
+    session->key = key;
+    session->driver = std::make_unique<CompilerDriver>();
+    session->appliedChanges = changesBase_ + changes_.size();
+    session->busy = true;
+    sessions_.push_back(std::move(session));
+    return sessions_.back().get();
+}
+
+void CompilerServer::releaseSession(Session* session) {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    session->busy = false;
+    session->lastUsed = std::chrono::steady_clock::now();
+
+    // Descartar los cambios que ya aplicaron todas las sesiones
+    uint64_t oldest = changesBase_ + changes_.size();
+    for (const auto& other : sessions_) {
+        oldest = std::min(oldest, other->appliedChanges);
+    }
+    while (changesBase_ < oldest && !changes_.empty()) {
+        changes_.pop_front();
+        ++changesBase_;
+    }
+}
+
+void CompilerServer::applyChanges(Session& session) {
+    bool checkAll = !watcher_->isSupported();
+    std::vector<std::filesystem::path> changed;
+    {
+        std::lock_guard<std::mutex> lock(sessionsMutex_);
+        uint64_t end = changesBase_ + changes_.size();
+        if (session.appliedChanges < changesBase_) {
+            checkAll = true;
+        } else {
+            for (uint64_t i = session.appliedChanges; i < end && !checkAll; ++i) {
+                const auto& path = changes_[i - changesBase_];
+                if (path.empty()) {
+                    checkAll = true;
+                } else {
+                    changed.push_back(path);
+                }
+            }
+        }
+        session.appliedChanges = end;
+    }
+
+    const auto& sourceManager = session.driver->sourceManager();
+    if (checkAll) {
+        sourceManager->invalidateChangedFiles();
+        return;
+    }
+    for (const auto& path : changed) {
+        sourceManager->invalidateFile(path);
+    }
+}
+
+void CompilerServer::watchLoadedFiles(Session& session) {
+    if (!watcher_->isSupported()) {
+        return;
+    }
+
+    const auto& sourceManager = session.driver->sourceManager();
+    std::unordered_set<std::string> directories;
+    bool added = false;
+    for (const auto& path : sourceManager->loadedFilePaths()) {
+        std::error_code ec;
+        auto directory = std::filesystem::absolute(path, ec).lexically_normal().parent_path();
+        if (!ec && directories.insert(directory.string()).second) {
+            added |= watcher_->watchDirectory(directory);
+        }
+    }
+
+    // Un archivo pudo cambiar entre su lectura y el alta de su directorio
+    if (added) {
+        sourceManager->invalidateChangedFiles();
+    }
+}
+
+void CompilerServer::recordChange(const std::filesystem::path& path) {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+
+    // Un editor suele generar varios eventos seguidos para el mismo archivo
+    if (!changes_.empty() && changes_.back() == path) {
+        return;
+    }
+
+    // Con un registro demasiado largo las sesiones atrasadas revisan todo
+    if (changes_.size() >= kMaxPendingChanges) {
+        changesBase_ += changes_.size();
+        changes_.clear();
+    }
+    changes_.push_back(path);
+}
+
+bool CompilerServer::enterDirectory(const std::filesystem::path& directory) {
+    std::unique_lock<std::mutex> lock(directoryMutex_);
+    directoryReleased_.wait(lock, [&]() {
+        return activeInDirectory_ == 0 || currentDirectory_ == directory;
+    });
+
+    if (currentDirectory_ != directory || activeInDirectory_ == 0) {
+        std::error_code ec;
+        if (!directory.empty()) {
+            std::filesystem::current_path(directory, ec);
+        }
+        if (ec) {
+            directoryReleased_.notify_all();
+            return false;
+        }
+        currentDirectory_ = directory;
+    }
+    ++activeInDirectory_;
+    return true;
+}
+
+void CompilerServer::leaveDirectory() {
+    std::lock_guard<std::mutex> lock(directoryMutex_);
+    if (--activeInDirectory_ == 0) {
+        directoryReleased_.notify_all();
+    }
+}
+
+} // namespace cpp20::compiler
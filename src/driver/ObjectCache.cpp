@@ -0,0 +1,302 @@
+/**
+ * @file ObjectCache.cpp
+ * @brief Implementación de la caché de objetos por unidad de traducción
+ */
+
+#include <compiler/driver/ObjectCache.h>
+#include <compiler/common/CacheFile.h>
+#include <compiler/common/utils/HashUtils.h>
+#include <unordered_map>
+
+namespace cpp20::compiler {
+
+namespace {
+
+constexpr uint32_t kFormatVersion = 2;   // 2: nombres mangled sin escapar minúsculas
+constexpr uint32_t kManifestKind = 1;
+constexpr uint32_t kEntryKind = 2;
+
+// Huella del contenido normalizado, el mismo que vio la compilación
+std::string contentDigest(const diagnostics::SourceFile& file) {
+    auto digest = common::utils::blake3(file.text());
+    return std::string(reinterpret_cast<const char*>(digest.data()), digest.size());
+}
+
+std::string addressFor(uint64_t namespaceKey, uint32_t kind, const common::utils::Blake3Hasher& payload) {
+    common::utils::Blake3Hasher hasher;
+    hasher.updateValue(namespaceKey);
+    hasher.updateValue(kind);
+    auto digest = payload.digest();
+    hasher.update(digest.data(), digest.size());
+    return hasher.hexDigest();
+}
+
+// Los fileId se guardan como posición: 0 sin archivo, 1 la fuente, 2.. las dependencias
+void writeLocation(CacheRecordWriter& writer, const diagnostics::SourceLocation& location,
+                   const std::unordered_map<uint32_t, uint32_t>& positions) {
+    auto position = positions.find(location.fileId());
+    writer.u32(location.line());
+    writer.u32(location.column());
+    writer.u32(location.offset());
+    writer.u32(position == positions.end() ? 0 : position->second);
+}
+
+diagnostics::SourceLocation readLocation(CacheRecordReader& reader, const std::vector<uint32_t>& fileIds) {
+    uint32_t line = reader.u32();
+    uint32_t column = reader.u32();
+    uint32_t offset = reader.u32();
+    uint32_t position = reader.u32();
+    uint32_t fileId = position < fileIds.size() ? fileIds[position] : 0;
+    return diagnostics::SourceLocation(line, column, offset, fileId);
+}
+
+void writeDiagnostic(CacheRecordWriter& writer, const diagnostics::Diagnostic& diagnostic,
+                     const std::unordered_map<uint32_t, uint32_t>& positions) {
+    using Type = diagnostics::DiagnosticArgument::Type;
+    writer.u8(static_cast<uint8_t>(diagnostic.level()));
+    writer.u32(static_cast<uint32_t>(diagnostic.code()));
+    writeLocation(writer, diagnostic.location(), positions);
+    writer.str(diagnostic.message());
+    writer.u32(static_cast<uint32_t>(diagnostic.arguments().size()));
+    for (const auto& argument : diagnostic.arguments()) {
+        writer.u8(static_cast<uint8_t>(argument.type()));
+        switch (argument.type()) {
+        case Type::String:
+            writer.str(argument.asString());
+            break;
+        case Type::Integer:
+            writer.u64(static_cast<uint64_t>(argument.asInteger()));
+            break;
+        case Type::Location:
+            writeLocation(writer, argument.asLocation(), positions);
+            break;
+        case Type::Range:
+            writeLocation(writer, argument.asRange().start(), positions);
+            writeLocation(writer, argument.asRange().end(), positions);
+            break;
+        case Type::Unsigned:
+        case Type::Type:
+        case Type::Symbol:
+            writer.u64(argument.asUnsigned());
+            break;
+        }
+    }
+}
+
+std::optional<diagnostics::Diagnostic> readDiagnostic(CacheRecordReader& reader,
+                                                      const std::vector<uint32_t>& fileIds) {
+    using Type = diagnostics::DiagnosticArgument::Type;
+    auto level = static_cast<diagnostics::DiagnosticLevel>(reader.u8());
+    auto code = static_cast<diagnostics::DiagnosticCode>(reader.u32());
+    diagnostics::SourceLocation location = readLocation(reader, fileIds);
+    diagnostics::Diagnostic diagnostic(level, code, location, std::string(reader.str()));
+    uint32_t count = reader.u32();
+    for (uint32_t i = 0; i < count && reader.ok(); ++i) {
+        switch (static_cast<Type>(reader.u8())) {
+        case Type::String:
+            diagnostic.addArgument(std::string(reader.str()));
+            break;
+        case Type::Integer:
+            diagnostic.addArgument(static_cast<int64_t>(reader.u64()));
+            break;
+        case Type::Unsigned:
+            diagnostic.addArgument(reader.u64());
+            break;
+        case Type::Location:
+            diagnostic.addArgument(readLocation(reader, fileIds));
+            break;
+        case Type::Range: {
+            diagnostics::SourceLocation start = readLocation(reader, fileIds);
+            diagnostic.addArgument(diagnostics::SourceRange(start, readLocation(reader, fileIds)));
+            break;
+        }
+        case Type::Type:
+            diagnostic.addArgument(diagnostics::TypeRef{static_cast<uint32_t>(reader.u64())});
+            break;
+        case Type::Symbol:
+            diagnostic.addArgument(diagnostics::DeclRef{static_cast<uint32_t>(reader.u64())});
+            break;
+        default:
+            return std::nullopt;
+        }
+    }
+    if (!reader.ok()) {
+        return std::nullopt;
+    }
+    return diagnostic;
+}
+
+std::optional<std::vector<std::filesystem::path>> decodeManifest(std::string_view data) {
+    CacheRecordReader reader(data);
+    if (reader.u32() != kFormatVersion) {
+        return std::nullopt;
+    }
+    std::vector<std::filesystem::path> paths;
+    uint32_t count = reader.u32();
+    for (uint32_t i = 0; i < count && reader.ok(); ++i) {
+        paths.emplace_back(std::string(reader.str()));
+    }
+    if (!reader.ok() || !reader.atEnd()) {
+        return std::nullopt;
+    }
+    return paths;
+}
+
+} // namespace
+
+ObjectCache::ObjectCache(std::shared_ptr<CacheBackend> backend,
+                         std::shared_ptr<diagnostics::SourceManager> sources,
+                         uint64_t namespaceKey)
+    : backend_(std::move(backend)), sources_(std::move(sources)), namespaceKey_(namespaceKey) {
+}
+
+std::string ObjectCache::manifestAddress(const diagnostics::SourceFile& source) const {
+    // El nombre entra en la clave como en ccache: con -flto el módulo embebido lo lleva
+    common::utils::Blake3Hasher payload;
+    std::string name = source.path.filename().string();
+    payload.updateValue(static_cast<uint64_t>(name.size()));
+    payload.update(name);
+    payload.update(contentDigest(source));
+    return addressFor(namespaceKey_, kManifestKind, payload);
+}
+
+std::string ObjectCache::entryAddress(const std::string& manifest,
+                                      const std::vector<std::filesystem::path>& paths) const {
+    common::utils::Blake3Hasher payload;
+    payload.update(manifest);
+    for (const auto& path : paths) {
+        uint32_t fileId = sources_->loadFile(path);
+        const diagnostics::SourceFile* file = sources_->getFile(fileId);
+        if (!file) {
+            return {};
+        }
+        std::string name = path.string();
+        payload.updateValue(static_cast<uint64_t>(name.size()));
+        payload.update(name);
+        payload.update(contentDigest(*file));
+    }
+    return addressFor(namespaceKey_, kEntryKind, payload);
+}
+
+std::optional<CachedObject> ObjectCache::lookup(uint32_t fileId) {
+    auto miss = [this]() -> std::optional<CachedObject> {
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    };
+
+    const diagnostics::SourceFile* source = sources_->getFile(fileId);
+    if (!source) {
+        return miss();
+    }
+    std::string manifest = manifestAddress(*source);
+    auto manifestData = backend_->fetch(manifest);
+    auto paths = manifestData ? decodeManifest(*manifestData) : std::nullopt;
+    if (!paths) {
+        return miss();
+    }
+    std::string address = entryAddress(manifest, *paths);
+    auto entryData = address.empty() ? std::nullopt : backend_->fetch(address);
+    if (!entryData) {
+        return miss();
+    }
+
+    // Cada dependencia real debe seguir teniendo el contenido con el que se compiló
+    CacheRecordReader reader(*entryData);
+    if (reader.u32() != kFormatVersion) {
+        return miss();
+    }
+    std::vector<uint32_t> fileIds = {0, fileId};
+    uint32_t dependencyCount = reader.u32();
+    for (uint32_t i = 0; i < dependencyCount && reader.ok(); ++i) {
+        std::filesystem::path path(std::string(reader.str()));
+        std::string_view digest = reader.str();
+        uint32_t dependency = sources_->loadFile(path);
+        const diagnostics::SourceFile* file = sources_->getFile(dependency);
+        if (!reader.ok() || !file || contentDigest(*file) != digest) {
+            return miss();
+        }
+        fileIds.push_back(dependency);
+    }
+
+    CachedObject cached;
+    std::string_view image = reader.str();
+    cached.image.assign(image.begin(), image.end());
+    uint32_t diagnosticCount = reader.u32();
+    for (uint32_t i = 0; i < diagnosticCount && reader.ok(); ++i) {
+        auto diagnostic = readDiagnostic(reader, fileIds);
+        if (!diagnostic) {
+            return miss();
+        }
+        cached.diagnostics.push_back(std::move(*diagnostic));
+    }
+    if (!reader.ok() || !reader.atEnd()) {
+        return miss();
+    }
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return cached;
+}
+
+bool ObjectCache::store(uint32_t fileId, const std::vector<uint32_t>& dependencies,
+                        const std::vector<uint8_t>& image,
+                        const std::vector<diagnostics::Diagnostic>& diagnostics) {
+    const diagnostics::SourceFile* source = sources_->getFile(fileId);
+    if (!source) {
+        return false;
+    }
+
+    // Dependencias sin repetir, en el orden de la primera inclusión
+    std::unordered_map<uint32_t, uint32_t> positions = {{fileId, 1}};
+    std::vector<const diagnostics::SourceFile*> files;
+    for (uint32_t dependency : dependencies) {
+        const diagnostics::SourceFile* file = sources_->getFile(dependency);
+        if (!file || positions.count(dependency)) {
+            continue;
+        }
+        positions.emplace(dependency, static_cast<uint32_t>(files.size() + 2));
+        files.push_back(file);
+    }
+
+    // Un manifiesto ya publicado manda: las búsquedas direccionan con su lista
+    std::string manifest = manifestAddress(*source);
+    std::optional<std::vector<std::filesystem::path>> paths;
+    if (auto existing = backend_->fetch(manifest)) {
+        paths = decodeManifest(*existing);
+    }
+    if (!paths) {
+        paths.emplace();
+        CacheRecordWriter writer;
+        writer.u32(kFormatVersion);
+        writer.u32(static_cast<uint32_t>(files.size()));
+        for (const diagnostics::SourceFile* file : files) {
+            writer.str(file->path.string());
+            paths->push_back(file->path);
+        }
+        if (!backend_->put(manifest, writer.take())) {
+            return false;
+        }
+    }
+    std::string address = entryAddress(manifest, *paths);
+    if (address.empty()) {
+        return false;
+    }
+
+    CacheRecordWriter writer;
+    writer.u32(kFormatVersion);
+    writer.u32(static_cast<uint32_t>(files.size()));
+    for (const diagnostics::SourceFile* file : files) {
+        writer.str(file->path.string());
+        writer.str(contentDigest(*file));
+    }
+    writer.str(std::string_view(reinterpret_cast<const char*>(image.data()), image.size()));
+    writer.u32(static_cast<uint32_t>(diagnostics.size()));
+    for (const auto& diagnostic : diagnostics) {
+        writeDiagnostic(writer, diagnostic, positions);
+    }
+    if (!backend_->put(address, writer.take())) {
+        return false;
+    }
+    stores_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+} // namespace cpp20::compiler
@@ -0,0 +1,115 @@
+/**
+ * @file DependencyScanner.cpp
+ * @brief Implementación del escaneo de dependencias en modo solo-directivas
+ */
+
+#include <compiler/frontend/DependencyScanner.h>
+#include <compiler/frontend/lexer/Lexer.h>
+#include <compiler/common/utils/ThreadPool.h>
+#include <sstream>
+#include <unordered_set>
+
+namespace cpp20::compiler::frontend {
+
+namespace {
+
+/**
+ * @brief Escapar una ruta para make (espacios y '$')
+ */
+std::string escapeMakePath(const std::string& path) {
+    std::string escaped;
+    escaped.reserve(path.size());
+    for (char c : path) {
+        if (c == ' ') {
+            escaped += '\\';
+        } else if (c == '$') {
+            escaped += '$';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+} // namespace
+
+DependencyScanner::DependencyScanner(std::shared_ptr<diagnostics::SourceManager> sourceManager,
+                                     DependencyScanOptions options)
+    : sourceManager_(std::move(sourceManager)), options_(std::move(options)) {
+    options_.preprocessor.dependencyScan = true;
+}
+
+DependencyScanResult DependencyScanner::scan(uint32_t fileId) const {
+    DependencyScanResult result;
+    result.fileId = fileId;
+
+    const diagnostics::SourceFile* file = sourceManager_->getFile(fileId);
+    if (!file) {
+        return result;
+    }
+    result.inputFile = file->path;
+
+    // Shard de diagnósticos local al hilo: sin consumers, solo historial
+    diagnostics::DiagnosticEngine shard(sourceManager_);
+    shard.clearConsumers();
+
+    std::string minimized = PreprocessorUtils::minimizeToDirectives(file->text());
+    lexer::LexerConfig lexerConfig;
+    lexerConfig.fileId = fileId;
+    lexerConfig.identifiers = options_.preprocessor.identifiers;
+    lexer::Lexer lexer(minimized, shard, lexerConfig);
+
+    Preprocessor preprocessor(shard, options_.preprocessor);
+    preprocessor.applyCommandLineMacros(options_.defines, options_.undefines);
+    preprocessor.process(lexer);
+
+    result.includeGraph = preprocessor.includeGraph();
+    result.modules = preprocessor.moduleDependencies();
+
+    std::unordered_set<uint32_t> seen;
+    for (const IncludeRecord& record : result.includeGraph) {
+        if (!seen.insert(record.fileId).second) {
+            continue;
+        }
+        if (const diagnostics::SourceFile* included = sourceManager_->getFile(record.fileId)) {
+            result.includes.push_back(included->path);
+        }
+    }
+
+    result.diagnostics = shard.diagnostics();
+    result.success = !shard.hasErrors();
+    return result;
+}
+
+std::vector<DependencyScanResult> DependencyScanner::scanAll(const std::vector<uint32_t>& fileIds) const {
+    std::vector<DependencyScanResult> results(fileIds.size());
+    common::utils::parallelFor(fileIds.size(), options_.jobs, [&](size_t index) {
+        results[index] = scan(fileIds[index]);
+    });
+    return results;
+}
+
+std::string DependencyScanner::formatMakeRule(const DependencyScanResult& result, const std::string& target) {
+    std::ostringstream out;
+    out << escapeMakePath(target) << ':';
+
+    std::vector<std::filesystem::path> prerequisites;
+    prerequisites.reserve(result.includes.size() + 1);
+    prerequisites.push_back(result.inputFile);
+    prerequisites.insert(prerequisites.end(), result.includes.begin(), result.includes.end());
+    for (const auto& prerequisite : prerequisites) {
+        out << " \\\n  " << escapeMakePath(prerequisite.generic_string());
+    }
+    out << '\n';
+
+    // Mismo formato que -fmodules-ts: el sistema de build ordena las unidades
+    if (!result.modules.moduleName.empty()) {
+        out << result.modules.moduleName << ".c++m: " << escapeMakePath(target) << '\n';
+    }
+    for (const auto& import : result.modules.imports) {
+        bool isHeaderUnit = import.front() == '<' || import.front() == '"';
+        out << "CXX_IMPORTS += " << import << (isHeaderUnit ? "" : ".c++m") << '\n';
+    }
+    return out.str();
+}
+
+} // namespace cpp20::compiler::frontend
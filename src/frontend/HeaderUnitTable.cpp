@@ -0,0 +1,221 @@
+/**
+ * @file HeaderUnitTable.cpp
+ * @brief Implementación de la promoción automática de headers a header units
+ */
+
+#include <compiler/frontend/HeaderUnitTable.h>
+#include <compiler/common/CacheFile.h>
+#include <compiler/common/TimingProfiler.h>
+#include <compiler/common/utils/HashUtils.h>
+#include <cctype>
+
+namespace cpp20::compiler::frontend {
+
+namespace {
+
+std::string_view trimLeft(std::string_view text) {
+    size_t start = text.find_first_not_of(" \t\r\f\v");
+    return start == std::string_view::npos ? std::string_view() : text.substr(start);
+}
+
+/**
+ * @brief Identificador al principio del texto (vacío si no empieza por uno)
+ */
+std::string_view leadingWord(std::string_view text) {
+    size_t length = 0;
+    while (length < text.size() && (std::isalnum(static_cast<unsigned char>(text[length])) || text[length] == '_')) {
+        ++length;
+    }
+    return text.substr(0, length);
+}
+
+} // namespace
+
+HeaderUnitTable::HeaderUnitTable(std::filesystem::path file)
+    : file_(std::move(file)) {
+}
+
+HeaderUnitTable::HeaderUnitTable(std::filesystem::path file, Policy policy)
+    : file_(std::move(file)), policy_(policy) {
+}
+
+bool HeaderUnitTable::isEligible(std::string_view text) {
+    std::string directives = PreprocessorUtils::minimizeToDirectives(text);
+    std::string_view rest = directives;
+    std::string_view guard;
+    bool pragmaOnce = false;
+    bool guardDefined = false;
+    bool guardClosed = false;
+    bool continued = false;          // La línea anterior acababa en '\'
+
+    while (!rest.empty()) {
+        size_t end = rest.find('\n');
+        std::string_view line = rest.substr(0, end);
+        rest = end == std::string_view::npos ? std::string_view() : rest.substr(end + 1);
+        bool continuation = continued;
+        continued = !line.empty() && line.back() == '\\';
+        line = trimLeft(line);
+        if (continuation || line.empty()) {
+            continue;
+        }
+        // Del cuerpo solo quedan restos; module / export / import no son de un header tradicional
+        if (line[0] != '#') {
+            std::string_view word = leadingWord(line);
+            if (word == "module" || word == "export" || word == "import") {
+                return false;
+            }
+            continue;
+        }
+
+        line = trimLeft(line.substr(1));
+        std::string_view name = leadingWord(line);
+        std::string_view argument = leadingWord(trimLeft(line.substr(name.size())));
+        if (name.empty() || name == "pragma") {
+            pragmaOnce = pragmaOnce || argument == "once";
+        } else if (name == "ifndef" && guard.empty() && !argument.empty()) {
+            guard = argument;
+        } else if (name == "define" && !guard.empty() && !guardDefined) {
+            // La guarda se define justo tras su #ifndef
+            if (argument != guard) {
+                return false;
+            }
+            guardDefined = true;
+        } else if (name == "define") {
+            if (guard.empty() && !pragmaOnce) {
+                return false;
+            }
+        } else if (name == "endif" && guardDefined && !guardClosed) {
+            guardClosed = true;
+        } else {
+            // #include, #undef, #if, #ifdef, #elif, #else, #error, #line...
+            return false;
+        }
+    }
+    return pragmaOnce ? guard.empty() || guardClosed : guardClosed;
+}
+
+size_t HeaderUnitTable::update(const std::vector<EntityStats>& headers, diagnostics::SourceManager& sources) {
+    size_t promoted = 0;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const EntityStats& header : headers) {
+        if (header.phase != CompilationPhase::HeaderInclusion || header.name.empty()) {
+            continue;
+        }
+        Entry& entry = entries_[header.name];
+        entry.includes += header.count;
+        entry.selfTime += header.selfTime;
+        if (entry.includes < policy_.minIncludes || entry.selfTime < policy_.minSelfTime) {
+            continue;
+        }
+
+        // Solo se reevalúa un header nuevo o que cambió desde la última vez
+        const diagnostics::SourceFile* file = sources.getFile(sources.loadFile(header.name));
+        if (!file) {
+            continue;
+        }
+        uint64_t contentHash = common::utils::fnv1a64(file->text());
+        if (entry.contentHash == contentHash) {
+            continue;
+        }
+        entry.contentHash = contentHash;
+        entry.unit.reset();
+        entry.promoted = isEligible(file->text());
+        if (entry.promoted) {
+            ++promoted;
+        }
+    }
+    return promoted;
+}
+
+bool HeaderUnitTable::isPromoted(const std::string& path, std::string_view text) const {
+    uint64_t expected = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(path);
+        if (it == entries_.end() || !it->second.promoted) {
+            return false;
+        }
+        expected = it->second.contentHash;
+    }
+    // El hash, fuera del lock: la mayoría de los #include no llegan aquí
+    return common::utils::fnv1a64(text) == expected;
+}
+
+std::shared_ptr<const HeaderUnitTable::Unit> HeaderUnitTable::unit(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(path);
+    return it != entries_.end() ? it->second.unit : nullptr;
+}
+
+std::shared_ptr<const HeaderUnitTable::Unit> HeaderUnitTable::storeUnit(const std::string& path,
+                                                                        std::shared_ptr<const Unit> unit) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[path];
+    if (!entry.unit) {
+        entry.unit = std::move(unit);
+    }
+    return entry.unit;
+}
+
+void HeaderUnitTable::demote(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(path);
+    if (it != entries_.end()) {
+        it->second.promoted = false;
+        it->second.unit.reset();
+    }
+}
+
+size_t HeaderUnitTable::promotedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const auto& [path, entry] : entries_) {
+        count += entry.promoted ? 1 : 0;
+    }
+    return count;
+}
+
+bool HeaderUnitTable::load() {
+    auto reader = CacheFileReader::open(file_, FileKind);
+    if (!reader) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < reader->size(); ++i) {
+        auto record = reader->record(i);
+        if (!record) {
+            continue;
+        }
+        CacheRecordReader value(record->value);
+        Entry entry;
+        entry.includes = value.u64();
+        entry.selfTime = std::chrono::microseconds(static_cast<int64_t>(value.u64()));
+        entry.contentHash = value.u64();
+        entry.promoted = value.u8() != 0;
+        if (value.ok()) {
+            entries_.try_emplace(std::string(record->key), std::move(entry));
+        }
+    }
+    return true;
+}
+
+bool HeaderUnitTable::save() const {
+    if (file_.empty()) {
+        return false;
+    }
+
+    CacheFileWriter writer;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [path, entry] : entries_) {
+        CacheRecordWriter value;
+        value.u64(entry.includes);
+        value.u64(static_cast<uint64_t>(entry.selfTime.count()));
+        value.u64(entry.contentHash);
+        value.u8(entry.promoted ? 1 : 0);
+        writer.add(common::utils::fnv1a64(path), path, value.take());
+    }
+    return writer.write(file_, FileKind);
+}
+
+} // namespace cpp20::compiler::frontend
@@ -7,6 +7,7 @@
  *
  * Características principales:
  * - Parser recursivo descendente con recuperación de errores
+ * - Expresiones por precedence climbing sobre la tabla de TokenUtils
  * - Soporte completo para sintaxis C++20
  * - Construcción de AST con información de ubicación precisa
  * - Sistema de recuperación de errores para continuar análisis tras fallos
@@ -18,27 +19,243 @@
  */
 
 #include <compiler/frontend/Parser.h>
+#include <compiler/common/utils/ThreadPool.h>
 #include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <optional>
+#include <iostream>
 
 namespace cpp20::compiler::frontend {
 
+namespace {
+
+/**
+ * @brief Valor de un literal entero (prefijos 0x/0b/0, separadores ' y sufijos)
+ */
+int64_t integerLiteralValue(const std::string& lexeme) {
+    std::string digits;
+    digits.reserve(lexeme.size());
+    for (char c : lexeme) {
+        if (c != '\'') {
+            digits += c;
+        }
+    }
+
+    int base = 10;
+    size_t start = 0;
+    if (digits.size() > 1 && digits[0] == '0') {
+        if (digits[1] == 'x' || digits[1] == 'X') {
+            base = 16;
+            start = 2;
+        } else if (digits[1] == 'b' || digits[1] == 'B') {
+            base = 2;
+            start = 2;
+        } else {
+            base = 8;
+        }
+    }
+    // strtoull se detiene en el sufijo (u, l, ll, z...)
+    return static_cast<int64_t>(std::strtoull(digits.c_str() + start, nullptr, base));
+}
+
+double floatingLiteralValue(const std::string& lexeme) {
+    std::string digits;
+    digits.reserve(lexeme.size());
+    for (char c : lexeme) {
+        if (c != '\'') {
+            digits += c;
+        }
+    }
+    return std::strtod(digits.c_str(), nullptr);
+}
+
+// Sin sufijo y en rango de int; si no, el literal es unsigned o long
+bool integerLiteralIsInt(const std::string& lexeme, int64_t value) {
+    return lexeme.find_first_of("uUlLzZ") == std::string::npos &&
+           value >= 0 && value <= std::numeric_limits<int>::max();
+}
+
+bool floatingLiteralIsDouble(const std::string& lexeme) {
+    return lexeme.empty() || std::string_view("fFlL").find(lexeme.back()) == std::string_view::npos;
+}
+
+/**
+ * @brief Operando de un pliegue: literal escrito o ya plegado
+ */
+struct ConstantOperand {
+    bool isFloating = false;
+    bool isPromoted = true;               // int o double; los demás tipos no se pliegan
+    int64_t integer = 0;
+    double floating = 0.0;
+    diagnostics::SourceRange range;       // Del literal o de la expresión que se plegó en él
+};
+
+std::optional<ConstantOperand> constantOperand(const ast::ASTNode* node) {
+    if (!node) {
+        return std::nullopt;
+    }
+    ConstantOperand operand;
+    const diagnostics::SourceRange* folded = nullptr;
+    if (node->kind() == ast::ASTNodeKind::IntegerLiteral) {
+        const auto* literal = static_cast<const ast::IntegerLiteral*>(node);
+        operand.integer = literal->getValue();
+        operand.isPromoted = literal->isInt();
+        folded = literal->getFoldedRange();
+    } else if (node->kind() == ast::ASTNodeKind::FloatingPointLiteral) {
+        const auto* literal = static_cast<const ast::FloatingPointLiteral*>(node);
+        operand.isFloating = true;
+        operand.floating = literal->getValue();
+        operand.isPromoted = literal->isDouble();
+        folded = literal->getFoldedRange();
+    } else {
+        return std::nullopt;
+    }
+    operand.range = folded ? *folded : diagnostics::SourceRange(node->location(), node->location());
+    return operand;
+}
+
+std::optional<int64_t> intResult(int64_t value) {
+    if (value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+// Aritmética de int como la del ConstexprVM (applyBinary): los operandos son
+// int, así que int64 no desborda; lo que no cabe en int queda sin plegar
+std::optional<int64_t> foldIntegers(ast::BinaryOp::OpKind op, int64_t left, int64_t right) {
+    using Op = ast::BinaryOp::OpKind;
+    switch (op) {
+        case Op::Add: return intResult(left + right);
+        case Op::Subtract: return intResult(left - right);
+        case Op::Multiply: return intResult(left * right);
+        case Op::Divide:
+        case Op::Modulo:
+            if (right == 0) {
+                return std::nullopt;
+            }
+            return intResult(op == Op::Divide ? left / right : left % right);
+        case Op::BitwiseAnd: return left & right;
+        case Op::BitwiseOr: return left | right;
+        case Op::BitwiseXor: return left ^ right;
+        case Op::LeftShift:
+        case Op::RightShift:
+            if (right < 0 || right > std::numeric_limits<int>::digits) {
+                return std::nullopt;
+            }
+            if (op == Op::LeftShift) {
+                return left < 0 ? std::nullopt : intResult(left << right);
+            }
+            return left >> right;
+        default:
+            return std::nullopt;      // Comparaciones y lógicos dan bool
+    }
+}
+
+std::optional<double> foldFloatings(ast::BinaryOp::OpKind op, double left, double right) {
+    using Op = ast::BinaryOp::OpKind;
+    switch (op) {
+        case Op::Add: return left + right;
+        case Op::Subtract: return left - right;
+        case Op::Multiply: return left * right;
+        case Op::Divide:
+            if (right == 0.0) {
+                return std::nullopt;  // Se diagnostica más adelante
+            }
+            return left / right;
+        default:
+            return std::nullopt;
+    }
+}
+
+std::optional<ast::BinaryOp::OpKind> binaryOpFor(lexer::TokenType type) {
+    using Op = ast::BinaryOp::OpKind;
+    switch (type) {
+        case lexer::TokenType::PLUS: return Op::Add;
+        case lexer::TokenType::MINUS: return Op::Subtract;
+        case lexer::TokenType::STAR: return Op::Multiply;
+        case lexer::TokenType::SLASH: return Op::Divide;
+        case lexer::TokenType::PERCENT: return Op::Modulo;
+        case lexer::TokenType::EQUAL: return Op::Equal;
+        case lexer::TokenType::NOT_EQUAL: return Op::NotEqual;
+        case lexer::TokenType::LESS: return Op::Less;
+        case lexer::TokenType::LESS_EQUAL: return Op::LessEqual;
+        case lexer::TokenType::GREATER: return Op::Greater;
+        case lexer::TokenType::GREATER_EQUAL: return Op::GreaterEqual;
+        case lexer::TokenType::LOGICAL_AND: return Op::LogicalAnd;
+        case lexer::TokenType::LOGICAL_OR: return Op::LogicalOr;
+        case lexer::TokenType::BIT_AND: return Op::BitwiseAnd;
+        case lexer::TokenType::BIT_OR: return Op::BitwiseOr;
+        case lexer::TokenType::BIT_XOR: return Op::BitwiseXor;
+        case lexer::TokenType::LEFT_SHIFT: return Op::LeftShift;
+        case lexer::TokenType::RIGHT_SHIFT: return Op::RightShift;
+        default: return std::nullopt;
+    }
+}
+
+std::optional<ast::Assignment::OpKind> assignmentOpFor(lexer::TokenType type) {
+    using Op = ast::Assignment::OpKind;
+    switch (type) {
+        case lexer::TokenType::ASSIGN: return Op::Assign;
+        case lexer::TokenType::PLUS_ASSIGN: return Op::AddAssign;
+        case lexer::TokenType::MINUS_ASSIGN: return Op::SubtractAssign;
+        case lexer::TokenType::MUL_ASSIGN: return Op::MultiplyAssign;
+        case lexer::TokenType::DIV_ASSIGN: return Op::DivideAssign;
+        case lexer::TokenType::MOD_ASSIGN: return Op::ModuloAssign;
+        case lexer::TokenType::AND_ASSIGN: return Op::BitwiseAndAssign;
+        case lexer::TokenType::OR_ASSIGN: return Op::BitwiseOrAssign;
+        case lexer::TokenType::XOR_ASSIGN: return Op::BitwiseXorAssign;
+        case lexer::TokenType::LEFT_SHIFT_ASSIGN: return Op::LeftShiftAssign;
+        case lexer::TokenType::RIGHT_SHIFT_ASSIGN: return Op::RightShiftAssign;
+        default: return std::nullopt;
+    }
+}
+
+std::optional<ast::UnaryOp::OpKind> unaryOpFor(lexer::TokenType type) {
+    using Op = ast::UnaryOp::OpKind;
+    switch (type) {
+        case lexer::TokenType::PLUS: return Op::Plus;
+        case lexer::TokenType::MINUS: return Op::Minus;
+        case lexer::TokenType::LOGICAL_NOT: return Op::Not;
+        case lexer::TokenType::BIT_NOT: return Op::BitwiseNot;
+        case lexer::TokenType::BIT_AND: return Op::AddressOf;
+        case lexer::TokenType::STAR: return Op::Dereference;
+        default: return std::nullopt;
+    }
+}
+
+} // namespace
+
 // ============================================================================
 // Parser - Implementación
 // ============================================================================
 
 Parser::Parser(const std::vector<lexer::Token>& tokens,
                diagnostics::DiagnosticEngine& diagEngine,
+               const ParserConfig& config,
+               common::utils::MemoryPool* pool)
+    : cursor_(tokens), diagEngine_(diagEngine), config_(config), stats_(), context_(pool) {
+}
+
+Parser::Parser(const TokenCursor& cursor, diagnostics::DiagnosticEngine& diagEngine,
                const ParserConfig& config)
-    : tokens_(tokens), diagEngine_(diagEngine), config_(config), stats_() {
+    : cursor_(cursor), diagEngine_(diagEngine), config_(config), stats_(), context_(nullptr) {
+    // Retener los errores: el parser principal los emite en orden de fuente
+    tentativeDepth_ = 1;
 }
 
 Parser::~Parser() = default;
 
-std::unique_ptr<ast::TranslationUnit> Parser::parse() {
+ast::TranslationUnit* Parser::parse() {
     success_ = true;
-    currentTokenIndex_ = 0;
+    cursor_.reset();
+    delayedFunctions_.clear();
+    for (auto& memo : memo_) {
+        memo.clear();
+    }
 
-    auto translationUnit = parseTranslationUnit();
+    auto* translationUnit = parseTranslationUnit();
 
     if (!isAtEnd()) {
         reportError("tokens inesperados al final del archivo", currentLocation());
@@ -49,31 +266,18 @@ std::unique_ptr<ast::TranslationUnit> Parser::parse() {
 }
 
 const lexer::Token& Parser::currentToken() const {
-    if (currentTokenIndex_ >= tokens_.size()) {
-        static lexer::Token eof(lexer::TokenType::END_OF_FILE, "",
-                               diagnostics::SourceLocation("", 0, 0));
-        return eof;
-    }
-    return tokens_[currentTokenIndex_];
+    return cursor_.current();
 }
 
 const lexer::Token& Parser::peekToken(size_t offset) const {
-    size_t index = currentTokenIndex_ + offset;
-    if (index >= tokens_.size()) {
-        static lexer::Token eof(lexer::TokenType::END_OF_FILE, "",
-                               diagnostics::SourceLocation("", 0, 0));
-        return eof;
-    }
-    return tokens_[index];
+    return cursor_.peek(offset);
 }
 
 const lexer::Token& Parser::consumeToken() {
-    const lexer::Token& token = currentToken();
-    if (currentTokenIndex_ < tokens_.size()) {
-        ++currentTokenIndex_;
+    if (cursor_.position() < cursor_.size()) {
         ++stats_.tokensConsumed;
     }
-    return token;
+    return cursor_.advance();
 }
 
 bool Parser::checkToken(lexer::TokenType type) const {
@@ -89,16 +293,47 @@ bool Parser::matchToken(lexer::TokenType type) {
 }
 
 bool Parser::isAtEnd() const {
-    return currentTokenIndex_ >= tokens_.size() ||
-           currentToken().getType() == lexer::TokenType::END_OF_FILE;
+    return cursor_.atEnd();
 }
 
 void Parser::reportError(const std::string& message, const diagnostics::SourceLocation& location) {
+    if (tentativeDepth_ > 0) {
+        deferredErrors_.push_back({message, location});
+        return;
+    }
     std::cerr << "Error de parsing en " << location.toString() << ": " << message << std::endl;
     success_ = false;
     ++stats_.errorsReported;
 }
 
+void Parser::replayMemoEntry(const MemoEntry& entry) {
+    for (size_t i = 0; i < entry.consumed; ++i) {
+        consumeToken();
+    }
+    for (const DeferredError& error : entry.errors) {
+        reportError(error.message, error.location);
+    }
+}
+
+void Parser::pruneMemo() {
+    if (speculationDepth_ > 0) {
+        return;
+    }
+    for (auto& memo : memo_) {
+        if (!memo.empty()) {
+            memo.clear();
+        }
+    }
+}
+
+void Parser::flushDeferredErrors() {
+    std::vector<DeferredError> errors = std::move(deferredErrors_);
+    deferredErrors_.clear();
+    for (const DeferredError& error : errors) {
+        reportError(error.message, error.location);
+    }
+}
+
 void Parser::recoverFromError() {
     // Recuperación simple: saltar hasta punto de sincronización
     while (!isAtEnd()) {
@@ -115,66 +350,69 @@ void Parser::recoverFromError() {
 
 // === PARSING DE UNIDADES DE TRADUCCIÓN ===
 
-std::unique_ptr<ast::TranslationUnit> Parser::parseTranslationUnit() {
-    auto translationUnit = std::make_unique<ast::TranslationUnit>();
-    ++stats_.nodesCreated;
+ast::TranslationUnit* Parser::parseTranslationUnit() {
+    diagnostics::SourceLocation location = currentLocation();
+    std::vector<ast::ASTNode*> declarations;
 
     while (!isAtEnd()) {
-        try {
-            auto declaration = parseExternalDeclaration();
-            if (declaration) {
-                // En un AST real, añadiríamos la declaración a la unidad de traducción
-                ++stats_.nodesCreated;
-            }
-        } catch (const std::exception& e) {
-            reportError(std::string("error durante parsing: ") + e.what(), currentLocation());
-            if (config_.enableErrorRecovery) {
-                recoverFromError();
-            } else {
-                break;
-            }
+        pruneMemo();
+        size_t startIndex = cursor_.position();
+        ast::ASTNode* declaration = parseExternalDeclaration();
+        if (declaration) {
+            declarations.push_back(declaration);
+        } else if (config_.enableErrorRecovery) {
+            recoverFromError();
+        } else {
+            break;
+        }
+
+        // Garantizar progreso aunque la recuperación no consuma nada
+        if (cursor_.position() == startIndex) {
+            consumeToken();
         }
     }
 
-    return translationUnit;
+    return createASTNode<ast::TranslationUnit>(context_.makeList(declarations), location);
 }
 
-std::unique_ptr<ast::ASTNode> Parser::parseExternalDeclaration() {
+ast::ASTNode* Parser::parseExternalDeclaration() {
     // Simplificado: solo declaraciones básicas
     if (ParserUtils::canStartDeclaration(currentToken())) {
         return parseDeclaration();
     }
 
-    // Si no es una declaración, asumir expresión
-    return parseExpression();
+    // Si no es una declaración, asumir sentencia de expresión
+    return parseExpressionStatement();
 }
 
 // === PARSING DE DECLARACIONES ===
 
-std::unique_ptr<ast::ASTNode> Parser::parseDeclaration() {
-    // Simplificado: asumir declaración de variable o función
-    if (peekToken(1).getType() == lexer::TokenType::LEFT_PAREN ||
-        peekToken(2).getType() == lexer::TokenType::LEFT_PAREN) {
-        return parseFunctionDeclaration();
-    } else {
-        return parseVariableDeclaration();
+ast::ASTNode* Parser::parseDeclaration() {
+    // Simplificado: tipo nombre ( ... ) es una función; si no hay '(' tras el
+    // nombre, el intento se descarta sin coste y se reparsea como variable
+    if (ast::ASTNode* function = tentativeParse(ParseRule::FunctionDeclaration,
+                                                [this] { return parseFunctionDeclaration(); })) {
+        return function;
     }
+    return parseVariableDeclaration();
 }
 
-std::unique_ptr<ast::ASTNode> Parser::parseFunctionDeclaration() {
+ast::ASTNode* Parser::parseFunctionDeclaration() {
+    diagnostics::SourceLocation location = currentLocation();
+
     // Parsear tipo de retorno
-    auto typeSpecifiers = parseTypeSpecifiers();
-    if (typeSpecifiers.empty()) {
+    std::string_view returnType = parseTypeSpecifiers();
+    if (returnType.empty()) {
         reportError("se esperaba especificador de tipo", currentLocation());
         return nullptr;
     }
 
     // Parsear nombre de función
-    if (!checkToken(lexer::TokenType::IDENTIFIER)) {
+    std::string_view functionName = parseDeclarator();
+    if (functionName.empty()) {
         reportError("se esperaba nombre de función", currentLocation());
         return nullptr;
     }
-    std::string functionName = consumeToken().getLexeme();
 
     // Parsear parámetros
     if (!matchToken(lexer::TokenType::LEFT_PAREN)) {
@@ -182,7 +420,7 @@ std::unique_ptr<ast::ASTNode> Parser::parseFunctionDeclaration() {
         return nullptr;
     }
 
-    auto parameters = parseParameterList();
+    ast::NodeList<ast::ParameterDecl> parameters = parseParameterList();
 
     if (!matchToken(lexer::TokenType::RIGHT_PAREN)) {
         reportError("se esperaba ')' en declaración de función", currentLocation());
@@ -190,35 +428,141 @@ std::unique_ptr<ast::ASTNode> Parser::parseFunctionDeclaration() {
     }
 
     // Parsear cuerpo (opcional para declaraciones)
-    std::unique_ptr<ast::ASTNode> body = nullptr;
+    ast::CompoundStmt* body = nullptr;
+    uint32_t bodyBegin = 0;
+    uint32_t bodyEnd = 0;
     if (checkToken(lexer::TokenType::LEFT_BRACE)) {
-        body = parseCompoundStatement();
+        if (config_.delayFunctionBodies) {
+            skipFunctionBody(bodyBegin, bodyEnd);
+        } else {
+            body = parseCompoundStatement();
+        }
     } else if (!matchToken(lexer::TokenType::SEMICOLON)) {
         reportError("se esperaba ';' o '{' en declaración de función", currentLocation());
     }
 
-    ++stats_.nodesCreated;
-    return std::make_unique<ast::ASTNode>(ast::ASTNodeKind::FunctionDecl);
+    auto* function = createASTNode<ast::FunctionDecl>(functionName, returnType, parameters, body, location);
+    if (bodyEnd != 0) {
+        function->setDelayedBody(bodyBegin, bodyEnd);
+        delayedFunctions_.push_back(function);
+        ++stats_.delayedBodies;
+    }
+    return function;
 }
 
-std::unique_ptr<ast::ASTNode> Parser::parseVariableDeclaration() {
+bool Parser::skipFunctionBody(uint32_t& begin, uint32_t& end) {
+    begin = static_cast<uint32_t>(cursor_.position());
+    diagnostics::SourceLocation location = currentLocation();
+
+    // Solo se cuentan llaves: el cuerpo se parsea entero más tarde
+    size_t depth = 0;
+    do {
+        lexer::TokenType type = cursor_.advance().getType();
+        if (type == lexer::TokenType::LEFT_BRACE) {
+            ++depth;
+        } else if (type == lexer::TokenType::RIGHT_BRACE) {
+            --depth;
+        }
+    } while (depth > 0 && !cursor_.atEnd());
+
+    end = static_cast<uint32_t>(cursor_.position());
+    if (depth > 0) {
+        reportError("se esperaba '}' al final del cuerpo de la función", location);
+        return false;
+    }
+    return true;
+}
+
+ast::CompoundStmt* Parser::parseDelayedBody(ast::FunctionDecl* function) {
+    if (!function || !function->hasDelayedBody()) {
+        return function ? function->getBody() : nullptr;
+    }
+
+    // El cursor acotado impide que la recuperación de errores salga del cuerpo
+    TokenCursor saved = cursor_;
+    cursor_ = saved.slice(function->delayedBodyBegin(), function->delayedBodyEnd());
+    ast::CompoundStmt* body = parseCompoundStatement();
+    cursor_ = saved;
+
+    function->setBody(body);
+    ++stats_.delayedBodiesParsed;
+    return body;
+}
+
+size_t Parser::parseDelayedBodies(size_t jobs) {
+    std::vector<ast::FunctionDecl*> pending;
+    for (ast::FunctionDecl* function : delayedFunctions_) {
+        if (function->hasDelayedBody()) {
+            pending.push_back(function);
+        }
+    }
+
+    if (jobs <= 1 || pending.size() <= 1) {
+        for (ast::FunctionDecl* function : pending) {
+            parseDelayedBody(function);
+        }
+        return pending.size();
+    }
+
+    // Varios tramos por hilo para equilibrar cuerpos de tamaño dispar
+    size_t chunkCount = std::min(pending.size(), jobs * 4);
+    size_t chunkSize = (pending.size() + chunkCount - 1) / chunkCount;
+    chunkCount = (pending.size() + chunkSize - 1) / chunkSize;
+
+    std::vector<std::unique_ptr<Parser>> workers;
+    workers.reserve(chunkCount);
+    for (size_t i = 0; i < chunkCount; ++i) {
+        workers.push_back(std::unique_ptr<Parser>(new Parser(cursor_, diagEngine_, config_)));
+    }
+
+    // Cada tramo toca solo sus FunctionDecl y la arena de su parser
+    common::utils::parallelFor(chunkCount, jobs, [&](size_t chunk) {
+        size_t begin = chunk * chunkSize;
+        size_t end = std::min(pending.size(), begin + chunkSize);
+        for (size_t i = begin; i < end; ++i) {
+            workers[chunk]->parseDelayedBody(pending[i]);
+        }
+    });
+
+    for (std::unique_ptr<Parser>& worker : workers) {
+        for (const DeferredError& error : worker->deferredErrors_) {
+            reportError(error.message, error.location);
+        }
+        worker->deferredErrors_.clear();
+        stats_.tokensConsumed += worker->stats_.tokensConsumed;
+        stats_.nodesCreated += worker->stats_.nodesCreated;
+        stats_.tentativeParses += worker->stats_.tentativeParses;
+        stats_.memoHits += worker->stats_.memoHits;
+        stats_.constantsFolded += worker->stats_.constantsFolded;
+        stats_.literalsInterned += worker->stats_.literalsInterned;
+        stats_.errorRecoveries += worker->stats_.errorRecoveries;
+        stats_.delayedBodiesParsed += worker->stats_.delayedBodiesParsed;
+        bodyParsers_.push_back(std::move(worker));
+    }
+    return pending.size();
+}
+
+ast::ASTNode* Parser::parseVariableDeclaration() {
+    diagnostics::SourceLocation location = currentLocation();
+
     // Parsear especificadores de tipo
-    auto typeSpecifiers = parseTypeSpecifiers();
-    if (typeSpecifiers.empty()) {
+    std::string_view typeName = parseTypeSpecifiers();
+    if (typeName.empty()) {
         reportError("se esperaba especificador de tipo", currentLocation());
         return nullptr;
     }
 
     // Parsear declarador
-    auto declarator = parseDeclarator();
-    if (!declarator) {
+    std::string_view name = parseDeclarator();
+    if (name.empty()) {
         reportError("se esperaba declarador", currentLocation());
         return nullptr;
     }
 
     // Parsear inicializador opcional
+    ast::ASTNode* initializer = nullptr;
     if (matchToken(lexer::TokenType::ASSIGN)) {
-        auto initializer = parseAssignmentExpression();
+        initializer = parseAssignmentExpression();
         if (!initializer) {
             reportError("se esperaba expresión de inicialización", currentLocation());
         }
@@ -228,306 +572,320 @@ std::unique_ptr<ast::ASTNode> Parser::parseVariableDeclaration() {
         reportError("se esperaba ';'", currentLocation());
     }
 
-    ++stats_.nodesCreated;
-    return std::make_unique<ast::ASTNode>(ast::ASTNodeKind::VariableDecl);
+    return createASTNode<ast::VariableDecl>(name, typeName, initializer, location);
+}
+
+std::string_view Parser::parseTypeSpecifiers() {
+    return memoized(ParseRule::TypeSpecifiers, [this] { return parseTypeSpecifierSequence(); });
 }
 
-std::vector<std::string> Parser::parseTypeSpecifiers() {
-    std::vector<std::string> specifiers;
+std::string_view Parser::parseTypeSpecifierSequence() {
+    std::string specifiers;
 
     while (ParserUtils::isTypeKeyword(currentToken().getLexeme()) ||
            checkToken(lexer::TokenType::CONST) ||
-           checkToken(lexer::TokenType::VOLATILE)) {
-        specifiers.push_back(consumeToken().getLexeme());
+           checkToken(lexer::TokenType::VOLATILE) ||
+           checkToken(lexer::TokenType::STATIC) ||
+           checkToken(lexer::TokenType::EXTERN) ||
+           checkToken(lexer::TokenType::INLINE)) {
+        if (!specifiers.empty()) {
+            specifiers += ' ';
+        }
+        specifiers += consumeToken().getLexeme();
     }
 
-    return specifiers;
+    return context_.copyString(specifiers);
 }
 
-std::unique_ptr<ast::ASTNode> Parser::parseDeclarator() {
-    if (!checkToken(lexer::TokenType::IDENTIFIER)) {
-        return nullptr;
-    }
-
-    consumeToken(); // Consumir identificador
-    ++stats_.nodesCreated;
-    return std::make_unique<ast::ASTNode>(ast::ASTNodeKind::Identifier);
+std::string_view Parser::parseDeclarator() {
+    return memoized(ParseRule::Declarator, [this] {
+        if (!checkToken(lexer::TokenType::IDENTIFIER)) {
+            return std::string_view();
+        }
+        return context_.copyString(consumeToken().getLexeme());
+    });
 }
 
-std::vector<std::unique_ptr<ast::ASTNode>> Parser::parseParameterList() {
-    std::vector<std::unique_ptr<ast::ASTNode>> parameters;
+ast::NodeList<ast::ParameterDecl> Parser::parseParameterList() {
+    std::vector<ast::ParameterDecl*> parameters;
 
     if (checkToken(lexer::TokenType::RIGHT_PAREN)) {
-        return parameters; // Lista vacía
+        return ast::NodeList<ast::ParameterDecl>(); // Lista vacía
     }
 
     while (true) {
+        diagnostics::SourceLocation location = currentLocation();
+
         // Parsear tipo de parámetro
-        auto typeSpecifiers = parseTypeSpecifiers();
-        if (typeSpecifiers.empty()) {
+        std::string_view typeName = parseTypeSpecifiers();
+        if (typeName.empty()) {
             reportError("se esperaba tipo de parámetro", currentLocation());
             break;
         }
 
         // Parsear nombre de parámetro (opcional)
-        if (checkToken(lexer::TokenType::IDENTIFIER)) {
-            consumeToken();
-        }
-
-        ++stats_.nodesCreated;
-        parameters.push_back(std::make_unique<ast::ASTNode>(ast::ASTNodeKind::ParameterDecl));
+        std::string_view name = parseDeclarator();
+        parameters.push_back(createASTNode<ast::ParameterDecl>(name, typeName, location));
 
         if (!matchToken(lexer::TokenType::COMMA)) {
             break;
         }
     }
 
-    return parameters;
+    return context_.makeList(parameters);
 }
 
 // === PARSING DE EXPRESIONES ===
 
-std::unique_ptr<ast::ASTNode> Parser::parseExpression() {
+ast::ASTNode* Parser::parseExpression() {
     return parseAssignmentExpression();
 }
 
-std::unique_ptr<ast::ASTNode> Parser::parseAssignmentExpression() {
-    auto left = parseConditionalExpression();
-
-    if (ParserUtils::isAssignmentOperator(currentToken().getType())) {
-        lexer::TokenType op = consumeToken().getType();
-        auto right = parseAssignmentExpression();
-
-        ++stats_.nodesCreated;
-        return std::make_unique<ast::ASTNode>(ast::ASTNodeKind::BinaryOperator);
-    }
-
-    return left;
+ast::ASTNode* Parser::parseAssignmentExpression() {
+    return parseBinaryExpression(getOperatorPrecedence(lexer::TokenType::ASSIGN));
 }
 
-std::unique_ptr<ast::ASTNode> Parser::parseConditionalExpression() {
-    auto condition = parseLogicalOrExpression();
+ast::ASTNode* Parser::parseBinaryExpression(int maxPrecedence) {
+    ast::ASTNode* left = parseUnaryExpression();
 
-    if (matchToken(lexer::TokenType::QUESTION)) {
-        auto trueExpr = parseExpression();
-        if (!matchToken(lexer::TokenType::COLON)) {
-            reportError("se esperaba ':' en expresión condicional", currentLocation());
-            return nullptr;
+    while (true) {
+        lexer::TokenType type = currentToken().getType();
+        int precedence = getOperatorPrecedence(type);
+        if (precedence == 0 || precedence > maxPrecedence) {
+            break;
         }
-        auto falseExpr = parseConditionalExpression();
 
-        ++stats_.nodesCreated;
-        return std::make_unique<ast::ASTNode>(ast::ASTNodeKind::ConditionalOperator);
-    }
-
-    return condition;
-}
-
-std::unique_ptr<ast::ASTNode> Parser::parseLogicalOrExpression() {
-    auto left = parseLogicalAndExpression();
+        // Los operadores de la derecha asociativa admiten su propio nivel a la derecha
+        int rightPrecedence = isRightAssociative(type) ? precedence : precedence - 1;
 
-    while (matchToken(lexer::TokenType::LOGICAL_OR)) {
-        auto right = parseLogicalAndExpression();
-        ++stats_.nodesCreated;
-        left = std::make_unique<ast::ASTNode>(ast::ASTNodeKind::BinaryOperator);
+        if (auto op = binaryOpFor(type)) {
+            diagnostics::SourceLocation location = consumeToken().getLocation();
+            ast::ASTNode* right = parseBinaryExpression(rightPrecedence);
+            if (ast::ASTNode* folded = foldBinary(left, right, *op)) {
+                left = folded;
+            } else {
+                left = createASTNode<ast::BinaryOp>(left, right, *op, location);
+            }
+        } else if (auto op = assignmentOpFor(type)) {
+            diagnostics::SourceLocation location = consumeToken().getLocation();
+            ast::ASTNode* right = parseBinaryExpression(rightPrecedence);
+            left = createASTNode<ast::Assignment>(left, right, *op, location);
+        } else if (type == lexer::TokenType::QUESTION) {
+            // condición ? expresión : expresión-de-asignación
+            diagnostics::SourceLocation location = consumeToken().getLocation();
+            ast::ASTNode* trueExpr = parseExpression();
+            if (!matchToken(lexer::TokenType::COLON)) {
+                reportError("se esperaba ':' en expresión condicional", currentLocation());
+                return nullptr;
+            }
+            ast::ASTNode* falseExpr = parseAssignmentExpression();
+            left = createASTNode<ast::TernaryOp>(left, trueExpr, falseExpr, location);
+        } else {
+            break; // ::, ++, .*, ',' ... no son operadores infijos aquí
+        }
     }
 
     return left;
 }
 
-std::unique_ptr<ast::ASTNode> Parser::parseLogicalAndExpression() {
-    auto left = parseBitwiseOrExpression();
-
-    while (matchToken(lexer::TokenType::LOGICAL_AND)) {
-        auto right = parseBitwiseOrExpression();
-        ++stats_.nodesCreated;
-        left = std::make_unique<ast::ASTNode>(ast::ASTNodeKind::BinaryOperator);
+ast::ASTNode* Parser::parseUnaryExpression() {
+    if (checkToken(lexer::TokenType::PLUS) ||
+        checkToken(lexer::TokenType::MINUS) ||
+        checkToken(lexer::TokenType::LOGICAL_NOT) ||
+        checkToken(lexer::TokenType::BIT_NOT)) {
+        const lexer::Token& op = consumeToken();
+        ast::ASTNode* operand = parseUnaryExpression();
+        ast::UnaryOp::OpKind kind = *unaryOpFor(op.getType());
+        if (ast::ASTNode* folded = foldUnary(operand, kind, op.getLocation())) {
+            return folded;
+        }
+        return createASTNode<ast::UnaryOp>(operand, kind, op.getLocation());
     }
 
-    return left;
-}
-
-std::unique_ptr<ast::ASTNode> Parser::parseBitwiseOrExpression() {
-    auto left = parseBitwiseXorExpression();
-
-    while (matchToken(lexer::TokenType::BIT_OR)) {
-        auto right = parseBitwiseXorExpression();
-        ++stats_.nodesCreated;
-        left = std::make_unique<ast::ASTNode>(ast::ASTNodeKind::BinaryOperator);
+    // Postfijos: de momento solo llamadas f(a, b)
+    ast::ASTNode* expr = parsePrimaryExpression();
+    while (expr && checkToken(lexer::TokenType::LEFT_PAREN)) {
+        diagnostics::SourceLocation location = consumeToken().getLocation();
+        std::vector<ast::ASTNode*> arguments;
+        if (!checkToken(lexer::TokenType::RIGHT_PAREN)) {
+            do {
+                arguments.push_back(parseAssignmentExpression());
+            } while (matchToken(lexer::TokenType::COMMA));
+        }
+        if (!matchToken(lexer::TokenType::RIGHT_PAREN)) {
+            reportError("se esperaba ')'", currentLocation());
+            return nullptr;
+        }
+        expr = createASTNode<ast::FunctionCall>(expr, context_.makeList(arguments), location);
     }
-
-    return left;
+    return expr;
 }
 
-std::unique_ptr<ast::ASTNode> Parser::parseBitwiseXorExpression() {
-    auto left = parseBitwiseAndExpression();
-
-    while (matchToken(lexer::TokenType::BIT_XOR)) {
-        auto right = parseBitwiseAndExpression();
-        ++stats_.nodesCreated;
-        left = std::make_unique<ast::ASTNode>(ast::ASTNodeKind::BinaryOperator);
-    }
+ast::ASTNode* Parser::parsePrimaryExpression() {
+    const lexer::Token& token = currentToken();
+    diagnostics::SourceLocation location = token.getLocation();
 
-    return left;
-}
+    switch (token.getType()) {
+        case lexer::TokenType::IDENTIFIER:
+            consumeToken();
+            return createASTNode<ast::Identifier>(context_.copyString(token.getLexeme()), location);
 
-std::unique_ptr<ast::ASTNode> Parser::parseBitwiseAndExpression() {
-    auto left = parseEqualityExpression();
+        case lexer::TokenType::INTEGER_LITERAL: {
+            consumeToken();
+            int64_t value = integerLiteralValue(token.getLexeme());
+            return createASTNode<ast::IntegerLiteral>(value, location, nullptr,
+                                                      integerLiteralIsInt(token.getLexeme(), value));
+        }
 
-    while (matchToken(lexer::TokenType::BIT_AND)) {
-        auto right = parseEqualityExpression();
-        ++stats_.nodesCreated;
-        left = std::make_unique<ast::ASTNode>(ast::ASTNodeKind::BinaryOperator);
-    }
+        case lexer::TokenType::FLOAT_LITERAL:
+            consumeToken();
+            return createASTNode<ast::FloatingPointLiteral>(floatingLiteralValue(token.getLexeme()), location,
+                                                            nullptr, floatingLiteralIsDouble(token.getLexeme()));
 
-    return left;
-}
+        case lexer::TokenType::CHAR_LITERAL: {
+            consumeToken();
+            std::string value = lexer::TokenUtils::unescapeLiteral(token.getLexeme());
+            return createASTNode<ast::CharacterLiteral>(value.empty() ? '\0' : value[0], location);
+        }
 
-std::unique_ptr<ast::ASTNode> Parser::parseEqualityExpression() {
-    auto left = parseRelationalExpression();
+        case lexer::TokenType::STRING_LITERAL:
+            consumeToken();
+            return createASTNode<ast::StringLiteral>(
+                internLiteral(lexer::TokenUtils::unescapeLiteral(token.getLexeme())), location);
 
-    while (matchToken(lexer::TokenType::EQUAL) ||
-           matchToken(lexer::TokenType::NOT_EQUAL)) {
-        auto right = parseRelationalExpression();
-        ++stats_.nodesCreated;
-        left = std::make_unique<ast::ASTNode>(ast::ASTNodeKind::BinaryOperator);
-    }
+        case lexer::TokenType::TRUE_LITERAL:
+        case lexer::TokenType::FALSE_LITERAL:
+            consumeToken();
+            return createASTNode<ast::BooleanLiteral>(token.getType() == lexer::TokenType::TRUE_LITERAL,
+                                                      location);
 
-    return left;
-}
+        case lexer::TokenType::NULLPTR_LITERAL:
+            consumeToken();
+            return createASTNode<ast::Literal>(internLiteral(token.getLexeme()), location);
 
-std::unique_ptr<ast::ASTNode> Parser::parseRelationalExpression() {
-    auto left = parseShiftExpression();
+        case lexer::TokenType::LEFT_PAREN: {
+            consumeToken();
+            ast::ASTNode* expr = parseExpression();
+            if (!matchToken(lexer::TokenType::RIGHT_PAREN)) {
+                reportError("se esperaba ')'", currentLocation());
+            }
+            return expr;
+        }
 
-    while (matchToken(lexer::TokenType::LESS) ||
-           matchToken(lexer::TokenType::GREATER) ||
-           matchToken(lexer::TokenType::LESS_EQUAL) ||
-           matchToken(lexer::TokenType::GREATER_EQUAL)) {
-        auto right = parseShiftExpression();
-        ++stats_.nodesCreated;
-        left = std::make_unique<ast::ASTNode>(ast::ASTNodeKind::BinaryOperator);
+        default:
+            reportError("expresión primaria inválida", location);
+            return nullptr;
     }
-
-    return left;
 }
 
-std::unique_ptr<ast::ASTNode> Parser::parseShiftExpression() {
-    auto left = parseAdditiveExpression();
-
-    while (matchToken(lexer::TokenType::LEFT_SHIFT) ||
-           matchToken(lexer::TokenType::RIGHT_SHIFT)) {
-        auto right = parseAdditiveExpression();
-        ++stats_.nodesCreated;
-        left = std::make_unique<ast::ASTNode>(ast::ASTNodeKind::BinaryOperator);
+ast::ASTNode* Parser::foldBinary(ast::ASTNode* left, ast::ASTNode* right, ast::BinaryOp::OpKind op) {
+    if (!config_.foldConstants) {
+        return nullptr;
     }
-
-    return left;
-}
-
-std::unique_ptr<ast::ASTNode> Parser::parseAdditiveExpression() {
-    auto left = parseMultiplicativeExpression();
-
-    while (matchToken(lexer::TokenType::PLUS) ||
-           matchToken(lexer::TokenType::MINUS)) {
-        auto right = parseMultiplicativeExpression();
-        ++stats_.nodesCreated;
-        left = std::make_unique<ast::ASTNode>(ast::ASTNodeKind::BinaryOperator);
+    auto lhs = constantOperand(left);
+    auto rhs = lhs ? constantOperand(right) : std::nullopt;
+    if (!rhs || !lhs->isPromoted || !rhs->isPromoted) {
+        return nullptr;           // unsigned, long o float: su aritmética no es la de int/double
     }
 
-    return left;
-}
-
-std::unique_ptr<ast::ASTNode> Parser::parseMultiplicativeExpression() {
-    auto left = parseUnaryExpression();
-
-    while (matchToken(lexer::TokenType::STAR) ||
-           matchToken(lexer::TokenType::SLASH) ||
-           matchToken(lexer::TokenType::PERCENT)) {
-        auto right = parseUnaryExpression();
-        ++stats_.nodesCreated;
-        left = std::make_unique<ast::ASTNode>(ast::ASTNodeKind::BinaryOperator);
+    diagnostics::SourceRange range(lhs->range.start(), rhs->range.end());
+    if (!lhs->isFloating && !rhs->isFloating) {
+        auto value = foldIntegers(op, lhs->integer, rhs->integer);
+        if (!value) {
+            return nullptr;
+        }
+        ++stats_.constantsFolded;
+        return createASTNode<ast::IntegerLiteral>(*value, range.start(),
+                                                  context_.createRecord<diagnostics::SourceRange>(range));
     }
 
-    return left;
-}
-
-std::unique_ptr<ast::ASTNode> Parser::parseUnaryExpression() {
-    if (matchToken(lexer::TokenType::PLUS) ||
-        matchToken(lexer::TokenType::MINUS) ||
-        matchToken(lexer::TokenType::LOGICAL_NOT) ||
-        matchToken(lexer::TokenType::BIT_NOT)) {
-        auto operand = parseUnaryExpression();
-        ++stats_.nodesCreated;
-        return std::make_unique<ast::ASTNode>(ast::ASTNodeKind::UnaryOperator);
+    // Conversiones aritméticas habituales: el entero pasa a double
+    double l = lhs->isFloating ? lhs->floating : static_cast<double>(lhs->integer);
+    double r = rhs->isFloating ? rhs->floating : static_cast<double>(rhs->integer);
+    auto value = foldFloatings(op, l, r);
+    if (!value) {
+        return nullptr;
     }
-
-    return parsePrimaryExpression();
+    ++stats_.constantsFolded;
+    return createASTNode<ast::FloatingPointLiteral>(*value, range.start(),
+                                                    context_.createRecord<diagnostics::SourceRange>(range));
 }
 
-std::unique_ptr<ast::ASTNode> Parser::parsePrimaryExpression() {
-    if (matchToken(lexer::TokenType::IDENTIFIER)) {
-        ++stats_.nodesCreated;
-        return std::make_unique<ast::ASTNode>(ast::ASTNodeKind::Identifier);
+ast::ASTNode* Parser::foldUnary(ast::ASTNode* operand, ast::UnaryOp::OpKind op,
+                                diagnostics::SourceLocation location) {
+    using Op = ast::UnaryOp::OpKind;
+    if (!config_.foldConstants || (op != Op::Plus && op != Op::Minus && op != Op::BitwiseNot)) {
+        return nullptr;
     }
-
-    if (matchToken(lexer::TokenType::INTEGER_LITERAL) ||
-        matchToken(lexer::TokenType::FLOAT_LITERAL) ||
-        matchToken(lexer::TokenType::CHAR_LITERAL) ||
-        matchToken(lexer::TokenType::STRING_LITERAL) ||
-        matchToken(lexer::TokenType::TRUE_LITERAL) ||
-        matchToken(lexer::TokenType::FALSE_LITERAL) ||
-        matchToken(lexer::TokenType::NULLPTR_LITERAL)) {
-        ++stats_.nodesCreated;
-        return std::make_unique<ast::ASTNode>(ast::ASTNodeKind::Literal);
+    auto value = constantOperand(operand);
+    // Cambiar el signo es exacto en cualquier tipo flotante; los enteros solo si son int
+    if (!value || (value->isFloating && op == Op::BitwiseNot) || (!value->isFloating && !value->isPromoted) ||
+        (!value->isFloating && op == Op::Minus && value->integer == std::numeric_limits<int>::min())) {
+        return nullptr;
     }
 
-    if (matchToken(lexer::TokenType::LEFT_PAREN)) {
-        auto expr = parseExpression();
-        if (!matchToken(lexer::TokenType::RIGHT_PAREN)) {
-            reportError("se esperaba ')'", currentLocation());
-        }
-        return expr;
+    const auto* range = context_.createRecord<diagnostics::SourceRange>(location, value->range.end());
+    ++stats_.constantsFolded;
+    if (value->isFloating) {
+        return createASTNode<ast::FloatingPointLiteral>(op == Op::Minus ? -value->floating : value->floating,
+                                                        location, range, value->isPromoted);
     }
+    int64_t result = op == Op::Minus ? -value->integer : op == Op::BitwiseNot ? ~value->integer : value->integer;
+    return createASTNode<ast::IntegerLiteral>(result, location, range);
+}
 
-    reportError("expresión primaria inválida", currentLocation());
-    return nullptr;
+std::string_view Parser::internLiteral(std::string_view text) {
+    size_t hits = context_.internHits();
+    std::string_view result = context_.internString(text);
+    stats_.literalsInterned += context_.internHits() - hits;
+    return result;
 }
 
 // === PARSING DE SENTENCIAS ===
 
-std::unique_ptr<ast::ASTNode> Parser::parseStatement() {
-    if (matchToken(lexer::TokenType::LEFT_BRACE)) {
-        return parseCompoundStatement();
-    }
-
-    if (matchToken(lexer::TokenType::IF)) {
-        return parseIfStatement();
-    }
-
-    if (matchToken(lexer::TokenType::WHILE)) {
-        return parseWhileStatement();
-    }
-
-    if (matchToken(lexer::TokenType::FOR)) {
-        return parseForStatement();
+ast::ASTNode* Parser::parseStatement() {
+    switch (currentToken().getType()) {
+        case lexer::TokenType::LEFT_BRACE:
+            return parseCompoundStatement();
+        case lexer::TokenType::IF:
+            return parseIfStatement();
+        case lexer::TokenType::WHILE:
+            return parseWhileStatement();
+        case lexer::TokenType::FOR:
+            return parseForStatement();
+        case lexer::TokenType::RETURN:
+            return parseReturnStatement();
+        case lexer::TokenType::LEFT_BRACKET:
+            if (peekToken(1).getType() == lexer::TokenType::LEFT_BRACKET) return parseAttributedStatement();
+            break;
+        default:
+            break;
     }
 
-    if (matchToken(lexer::TokenType::RETURN)) {
-        return parseReturnStatement();
+    if (ParserUtils::canStartDeclaration(currentToken())) {
+        return parseDeclaration();
     }
 
     // Sentencia de expresión
     return parseExpressionStatement();
 }
 
-std::unique_ptr<ast::ASTNode> Parser::parseCompoundStatement() {
-    ++stats_.nodesCreated;
-    auto compoundStmt = std::make_unique<ast::ASTNode>(ast::ASTNodeKind::CompoundStmt);
+ast::CompoundStmt* Parser::parseCompoundStatement() {
+    diagnostics::SourceLocation location = currentLocation();
+    if (!matchToken(lexer::TokenType::LEFT_BRACE)) {
+        reportError("se esperaba '{'", location);
+        return nullptr;
+    }
 
+    std::vector<ast::ASTNode*> statements;
     while (!checkToken(lexer::TokenType::RIGHT_BRACE) && !isAtEnd()) {
-        auto stmt = parseStatement();
+        pruneMemo();
+        size_t startIndex = cursor_.position();
+        ast::ASTNode* stmt = parseStatement();
         if (stmt) {
-            // Añadir a la lista de sentencias
+            statements.push_back(stmt);
+        } else if (config_.enableErrorRecovery && cursor_.position() == startIndex) {
+            recoverFromError();
         }
     }
 
@@ -535,74 +893,73 @@ std::unique_ptr<ast::ASTNode> Parser::parseCompoundStatement() {
         reportError("se esperaba '}'", currentLocation());
     }
 
-    return compoundStmt;
+    return createASTNode<ast::CompoundStmt>(context_.makeList(statements), location);
 }
 
-std::unique_ptr<ast::ASTNode> Parser::parseIfStatement() {
+ast::ASTNode* Parser::parseIfStatement() {
+    diagnostics::SourceLocation location = consumeToken().getLocation(); // 'if'
     if (!matchToken(lexer::TokenType::LEFT_PAREN)) {
         reportError("se esperaba '(' después de 'if'", currentLocation());
         return nullptr;
     }
 
-    auto condition = parseExpression();
+    ast::ASTNode* condition = parseExpression();
 
     if (!matchToken(lexer::TokenType::RIGHT_PAREN)) {
         reportError("se esperaba ')'", currentLocation());
         return nullptr;
     }
 
-    auto thenStmt = parseStatement();
-    std::unique_ptr<ast::ASTNode> elseStmt = nullptr;
+    ast::ASTNode* thenStmt = parseStatement();
+    ast::ASTNode* elseStmt = nullptr;
 
     if (matchToken(lexer::TokenType::ELSE)) {
         elseStmt = parseStatement();
     }
 
-    ++stats_.nodesCreated;
-    return std::make_unique<ast::ASTNode>(ast::ASTNodeKind::IfStmt);
+    return createASTNode<ast::IfStmt>(condition, thenStmt, elseStmt, location);
 }
 
-std::unique_ptr<ast::ASTNode> Parser::parseWhileStatement() {
+ast::ASTNode* Parser::parseWhileStatement() {
+    diagnostics::SourceLocation location = consumeToken().getLocation(); // 'while'
     if (!matchToken(lexer::TokenType::LEFT_PAREN)) {
         reportError("se esperaba '(' después de 'while'", currentLocation());
         return nullptr;
     }
 
-    auto condition = parseExpression();
+    ast::ASTNode* condition = parseExpression();
 
     if (!matchToken(lexer::TokenType::RIGHT_PAREN)) {
         reportError("se esperaba ')'", currentLocation());
         return nullptr;
     }
 
-    auto body = parseStatement();
-
-    ++stats_.nodesCreated;
-    return std::make_unique<ast::ASTNode>(ast::ASTNodeKind::WhileStmt);
+    ast::ASTNode* body = parseStatement();
+    return createASTNode<ast::WhileStmt>(condition, body, location);
 }
 
-std::unique_ptr<ast::ASTNode> Parser::parseForStatement() {
+ast::ASTNode* Parser::parseForStatement() {
+    diagnostics::SourceLocation location = consumeToken().getLocation(); // 'for'
     if (!matchToken(lexer::TokenType::LEFT_PAREN)) {
         reportError("se esperaba '(' después de 'for'", currentLocation());
         return nullptr;
     }
 
-    // Parsear inicialización (opcional)
-    std::unique_ptr<ast::ASTNode> init = nullptr;
-    if (!checkToken(lexer::TokenType::SEMICOLON)) {
-        if (ParserUtils::canStartDeclaration(currentToken())) {
-            init = parseDeclaration();
-        } else {
+    // Parsear inicialización (opcional); la declaración consume su ';'
+    ast::ASTNode* init = nullptr;
+    if (ParserUtils::canStartDeclaration(currentToken())) {
+        init = parseVariableDeclaration();
+    } else {
+        if (!checkToken(lexer::TokenType::SEMICOLON)) {
             init = parseExpression();
         }
-    }
-
-    if (!matchToken(lexer::TokenType::SEMICOLON)) {
-        reportError("se esperaba ';'", currentLocation());
+        if (!matchToken(lexer::TokenType::SEMICOLON)) {
+            reportError("se esperaba ';'", currentLocation());
+        }
     }
 
     // Parsear condición (opcional)
-    std::unique_ptr<ast::ASTNode> condition = nullptr;
+    ast::ASTNode* condition = nullptr;
     if (!checkToken(lexer::TokenType::SEMICOLON)) {
         condition = parseExpression();
     }
@@ -612,7 +969,7 @@ std::unique_ptr<ast::ASTNode> Parser::parseForStatement() {
     }
 
     // Parsear incremento (opcional)
-    std::unique_ptr<ast::ASTNode> increment = nullptr;
+    ast::ASTNode* increment = nullptr;
     if (!checkToken(lexer::TokenType::RIGHT_PAREN)) {
         increment = parseExpression();
     }
@@ -621,14 +978,13 @@ std::unique_ptr<ast::ASTNode> Parser::parseForStatement() {
         reportError("se esperaba ')'", currentLocation());
     }
 
-    auto body = parseStatement();
-
-    ++stats_.nodesCreated;
-    return std::make_unique<ast::ASTNode>(ast::ASTNodeKind::ForStmt);
+    ast::ASTNode* body = parseStatement();
+    return createASTNode<ast::ForStmt>(init, condition, increment, body, location);
 }
 
-std::unique_ptr<ast::ASTNode> Parser::parseReturnStatement() {
-    std::unique_ptr<ast::ASTNode> expr = nullptr;
+ast::ASTNode* Parser::parseReturnStatement() {
+    diagnostics::SourceLocation location = consumeToken().getLocation(); // 'return'
+    ast::ASTNode* expr = nullptr;
 
     if (!checkToken(lexer::TokenType::SEMICOLON)) {
         expr = parseExpression();
@@ -638,19 +994,65 @@ std::unique_ptr<ast::ASTNode> Parser::parseReturnStatement() {
         reportError("se esperaba ';'", currentLocation());
     }
 
-    ++stats_.nodesCreated;
-    return std::make_unique<ast::ASTNode>(ast::ASTNodeKind::ReturnStmt);
+    return createASTNode<ast::ReturnStmt>(expr, location);
+}
+
+ast::ASTNode* Parser::parseAttributedStatement() {
+    diagnostics::SourceLocation location = currentLocation();
+    consumeToken(); // '['
+    consumeToken(); // '['
+
+    // Nombres separados por comas; los argumentos entre paréntesis no cuentan
+    bool mustTail = false;
+    std::string name;
+    int depth = 0;
+    while (!isAtEnd() && !(depth == 0 && checkToken(lexer::TokenType::RIGHT_BRACKET))) {
+        lexer::TokenType type = currentToken().getType();
+        if (type == lexer::TokenType::LEFT_PAREN) {
+            ++depth;
+        } else if (type == lexer::TokenType::RIGHT_PAREN) {
+            --depth;
+        } else if (depth == 0 && type == lexer::TokenType::COMMA) {
+            mustTail = mustTail || name == "clang::musttail";
+            name.clear();
+        } else if (depth == 0) {
+            name += currentToken().getLexeme();
+        }
+        consumeToken();
+    }
+    mustTail = mustTail || name == "clang::musttail";
+    if (!matchToken(lexer::TokenType::RIGHT_BRACKET) || !matchToken(lexer::TokenType::RIGHT_BRACKET)) {
+        reportError("se esperaba ']]'", currentLocation());
+        return nullptr;
+    }
+
+    ast::ASTNode* statement = parseStatement();
+    if (!mustTail || !statement) return statement;
+    auto* returned = statement->kind() == ast::ASTNodeKind::ReturnStmt ? static_cast<ast::ReturnStmt*>(statement)
+                                                                        : nullptr;
+    if (!returned || !returned->getValue() || returned->getValue()->kind() != ast::ASTNodeKind::FunctionCall) {
+        reportError("[[clang::musttail]] solo se aplica a un return de una llamada", location);
+        return statement;
+    }
+    returned->setMustTail();
+    return statement;
 }
 
-std::unique_ptr<ast::ASTNode> Parser::parseExpressionStatement() {
-    auto expr = parseExpression();
+ast::ASTNode* Parser::parseExpressionStatement() {
+    diagnostics::SourceLocation location = currentLocation();
+    ast::ASTNode* expr = nullptr;
+    if (!checkToken(lexer::TokenType::SEMICOLON)) {
+        expr = parseExpression();
+        if (!expr) {
+            return nullptr;
+        }
+    }
 
     if (!matchToken(lexer::TokenType::SEMICOLON)) {
         reportError("se esperaba ';'", currentLocation());
     }
 
-    ++stats_.nodesCreated;
-    return std::make_unique<ast::ASTNode>(ast::ASTNodeKind::ExprStmt);
+    return createASTNode<ast::ExprStmt>(expr, location);
 }
 
 // === UTILIDADES ===
@@ -660,8 +1062,8 @@ int Parser::getOperatorPrecedence(lexer::TokenType type) const {
 }
 
 bool Parser::isRightAssociative(lexer::TokenType type) const {
-    // Operadores de asignación son asociativos a la derecha
-    return lexer::TokenUtils::isAssignmentOperator(type);
+    // Asignaciones y ?: son asociativos a la derecha
+    return lexer::TokenUtils::isAssignmentOperator(type) || type == lexer::TokenType::QUESTION;
 }
 
 diagnostics::SourceLocation Parser::currentLocation() const {
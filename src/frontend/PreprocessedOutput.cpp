@@ -0,0 +1,247 @@
+/**
+ * @file PreprocessedOutput.cpp
+ * @brief Escritura de la salida de -E en texto y en flujo binario de tokens
+ */
+
+#include <compiler/frontend/PreprocessedOutput.h>
+#include <compiler/frontend/lexer/IdentifierTable.h>
+#include <cctype>
+
+namespace cpp20::compiler::frontend {
+
+namespace {
+
+constexpr std::string_view kTokenStreamMagic = "CPPTOKS1";
+constexpr uint8_t kFileRecord = 0;
+constexpr uint8_t kTokenRecord = 1;
+constexpr uint8_t kIdentifierRecord = 2;     // Token con IdentifierInfo
+
+bool isWordChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// Pares de puntuación que, escritos juntos, se tokenizarían como uno más largo
+bool formsLongerPunctuator(char last, char first) {
+    static constexpr std::string_view pairs[] = {
+        "++", "--", "->", "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "==", "!=", "<=", ">=",
+        "<<", ">>", "&&", "||", "::", "##", ".*", "..", "//", "/*", "<:", "<%", ":>", "%>", "%:",
+    };
+    for (std::string_view pair : pairs) {
+        if (pair[0] == last && pair[1] == first) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Si hace falta un espacio para que el token no se pegue al anterior
+ */
+bool needsSeparator(char last, bool lastWasNumber, std::string_view next) {
+    char first = next.front();
+    if (isWordChar(last)) {
+        // u8"x" o L'x' son otro literal; un número absorbe '.', signos y letras (pp-number)
+        return isWordChar(first) || first == '"' || first == '\'' ||
+               (lastWasNumber && (first == '.' || first == '+' || first == '-'));
+    }
+    if (last == '.' && std::isdigit(static_cast<unsigned char>(first))) {
+        return true;
+    }
+    return formsLongerPunctuator(last, first);
+}
+
+void appendQuotedPath(std::string& out, const std::string& path) {
+    out += '"';
+    for (char c : path) {
+        if (c == '\\' || c == '"') out += '\\';
+        out += c;
+    }
+    out += '"';
+}
+
+} // namespace
+
+// ============================================================================
+// PreprocessedTextWriter
+// ============================================================================
+
+PreprocessedTextWriter::PreprocessedTextWriter(std::ostream& out,
+                                               std::shared_ptr<diagnostics::SourceManager> sources,
+                                               bool lineMarkers)
+    : out_(out), sources_(std::move(sources)), lineMarkers_(lineMarkers) {
+    buffer_.reserve(BufferSize + 4096);
+}
+
+PreprocessedTextWriter::~PreprocessedTextWriter() {
+    if (!finished_) {
+        finish();
+    }
+}
+
+void PreprocessedTextWriter::write(const lexer::Token& token) {
+    const std::string& lexeme = token.getLexeme();
+    if (lexeme.empty()) {
+        return;
+    }
+
+    // Los tokens sin archivo (-D, predefinidas) siguen en la línea en curso
+    const diagnostics::SourceLocation& location = token.getLocation();
+    uint32_t fileId = location.fileId();
+    if (fileId != 0 && (fileId != fileId_ || (token.isAtStartOfLine() && location.line() > line_))) {
+        moveTo(fileId, location.line());
+    }
+
+    if (lineHasTokens_ && ((token.flags() & lexer::TOKEN_FLAG_LEADING_SPACE) ||
+                           needsSeparator(lastChar_, lastWasNumber_, lexeme))) {
+        buffer_ += ' ';
+    }
+    buffer_ += lexeme;
+    lineHasTokens_ = true;
+    lastChar_ = lexeme.back();
+    lastWasNumber_ = token.getType() == lexer::TokenType::INTEGER_LITERAL ||
+                     token.getType() == lexer::TokenType::FLOAT_LITERAL;
+    flushIfFull();
+}
+
+void PreprocessedTextWriter::moveTo(uint32_t fileId, uint32_t line) {
+    // La salida está al principio o en mitad de line_: en ambos casos faltan line - line_ saltos
+    if (fileId == fileId_ && line >= line_ && line - line_ <= MaxBlankLines) {
+        buffer_.append(line - line_, '\n');
+    } else {
+        if (lineHasTokens_) {
+            buffer_ += '\n';
+        }
+        const diagnostics::SourceFile* file = sources_ ? sources_->getFile(fileId) : nullptr;
+        if (lineMarkers_ && file) {
+            buffer_ += "# ";
+            buffer_ += std::to_string(line);
+            buffer_ += ' ';
+            appendQuotedPath(buffer_, file->displayName.empty() ? file->path.string() : file->displayName);
+            buffer_ += '\n';
+            ++markers_;
+        }
+    }
+    fileId_ = fileId;
+    line_ = line;
+    lineHasTokens_ = false;
+}
+
+void PreprocessedTextWriter::flushIfFull() {
+    if (buffer_.size() >= BufferSize) {
+        out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+    }
+}
+
+bool PreprocessedTextWriter::finish() {
+    if (!finished_) {
+        finished_ = true;
+        if (lineHasTokens_) {
+            buffer_ += '\n';
+        }
+        out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+        out_.flush();
+    }
+    return static_cast<bool>(out_);
+}
+
+// ============================================================================
+// PreprocessedTokenWriter
+// ============================================================================
+
+PreprocessedTokenWriter::PreprocessedTokenWriter(std::ostream& out,
+                                                 std::shared_ptr<diagnostics::SourceManager> sources)
+    : out_(out), sources_(std::move(sources)) {
+    out_.write(kTokenStreamMagic.data(), static_cast<std::streamsize>(kTokenStreamMagic.size()));
+}
+
+PreprocessedTokenWriter::~PreprocessedTokenWriter() {
+    if (!finished_) {
+        finish();
+    }
+}
+
+void PreprocessedTokenWriter::write(const lexer::Token& token) {
+    const diagnostics::SourceLocation& location = token.getLocation();
+    uint32_t localId = 0;
+    if (location.fileId() != 0) {
+        auto [it, inserted] = localIds_.emplace(location.fileId(), static_cast<uint32_t>(localIds_.size() + 1));
+        if (inserted) {
+            const diagnostics::SourceFile* file = sources_ ? sources_->getFile(location.fileId()) : nullptr;
+            record_.u8(kFileRecord);
+            record_.str(!file ? std::string() : file->displayName.empty() ? file->path.string() : file->displayName);
+        }
+        localId = it->second;
+    }
+
+    record_.u8(token.getIdentifierInfo() ? kIdentifierRecord : kTokenRecord);
+    record_.u32(static_cast<uint32_t>(token.getType()) | (static_cast<uint32_t>(token.flags()) << 16));
+    record_.u32(localId);
+    record_.u32(location.line());
+    record_.u32(location.column());
+    record_.u32(location.offset());
+    record_.str(token.getLexeme());
+    record_.str(token.getValue());
+
+    if (record_.size() >= PreprocessedTextWriter::BufferSize) {
+        std::string block = record_.take();
+        out_.write(block.data(), static_cast<std::streamsize>(block.size()));
+    }
+}
+
+bool PreprocessedTokenWriter::finish() {
+    if (!finished_) {
+        finished_ = true;
+        std::string block = record_.take();
+        out_.write(block.data(), static_cast<std::streamsize>(block.size()));
+        out_.flush();
+    }
+    return static_cast<bool>(out_);
+}
+
+std::optional<std::vector<lexer::Token>> PreprocessedTokenWriter::readTokens(std::string_view data,
+                                                                             diagnostics::SourceManager& sources,
+                                                                             lexer::IdentifierTable* identifiers) {
+    if (data.substr(0, kTokenStreamMagic.size()) != kTokenStreamMagic) {
+        return std::nullopt;
+    }
+    lexer::IdentifierTable& table = identifiers ? *identifiers : lexer::IdentifierTable::global();
+
+    std::vector<lexer::Token> tokens;
+    std::vector<uint32_t> fileIds = {0};
+    CacheRecordReader reader(data.substr(kTokenStreamMagic.size()));
+    while (reader.ok() && !reader.atEnd()) {
+        uint8_t kind = reader.u8();
+        if (kind == kFileRecord) {
+            fileIds.push_back(sources.createVirtualFile(std::string(), std::string(reader.str())));
+            continue;
+        }
+        if (kind != kTokenRecord && kind != kIdentifierRecord) {
+            return std::nullopt;
+        }
+        uint32_t typeAndFlags = reader.u32();
+        uint32_t localId = reader.u32();
+        uint32_t line = reader.u32();
+        uint32_t column = reader.u32();
+        uint32_t offset = reader.u32();
+        std::string_view lexeme = reader.str();
+        std::string_view value = reader.str();
+        if (!reader.ok() || localId >= fileIds.size()) {
+            return std::nullopt;
+        }
+
+        lexer::Token& token = tokens.emplace_back(static_cast<lexer::TokenType>(typeAndFlags & 0xffff),
+                                                  std::string(lexeme),
+                                                  diagnostics::SourceLocation(line, column, offset, fileIds[localId]),
+                                                  std::string(value));
+        token.setFlags(static_cast<uint16_t>(typeAndFlags >> 16));
+        if (kind == kIdentifierRecord) {
+            token.setIdentifierInfo(table.get(token.getLexeme()));
+        }
+    }
+    if (!reader.ok()) {
+        return std::nullopt;
+    }
+    return tokens;
+}
+
+} // namespace cpp20::compiler::frontend
@@ -27,72 +27,775 @@
  */
 
 #include <compiler/frontend/Preprocessor.h>
+#include <compiler/frontend/HeaderUnitTable.h>
+#include <compiler/frontend/PreprocessorSnapshot.h>
+#include <compiler/frontend/lexer/Lexer.h>
+#include <compiler/frontend/lexer/IdentifierTable.h>
+#include <compiler/frontend/lexer/CharScanner.h>
+#include <compiler/common/TimingProfiler.h>
+#include <compiler/common/utils/HashUtils.h>
 #include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <iostream>
+#include <optional>
 #include <sstream>
 
 namespace cpp20::compiler::frontend {
 
+namespace {
+
+/**
+ * @brief Argumentos de una invocación dentro de una lista de tokens
+ * @param open Índice del '('
+ * @return Índice tras el ')' (nullopt si la invocación no se cierra en la lista)
+ */
+std::optional<size_t> collectArguments(const std::vector<lexer::Token>& tokens, size_t open,
+                                       std::vector<std::vector<lexer::Token>>& arguments) {
+    arguments.assign(1, {});
+    int depth = 0;
+    for (size_t i = open + 1; i < tokens.size(); ++i) {
+        lexer::TokenType type = tokens[i].getType();
+        if (type == lexer::TokenType::RIGHT_PAREN && depth == 0) {
+            return i + 1;
+        }
+        if (type == lexer::TokenType::COMMA && depth == 0) {
+            arguments.emplace_back();
+            continue;
+        }
+        if (type == lexer::TokenType::LEFT_PAREN) {
+            ++depth;
+        } else if (type == lexer::TokenType::RIGHT_PAREN) {
+            --depth;
+        }
+        arguments.back().push_back(tokens[i]);
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Operador #: literal de string con el texto del argumento
+ */
+lexer::Token stringifyTokens(const std::vector<lexer::Token>& tokens,
+                             const diagnostics::SourceLocation& location) {
+    std::string text = "\"";
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const lexer::Token& token = tokens[i];
+        if (i > 0 && (token.flags() & (lexer::TOKEN_FLAG_LEADING_SPACE | lexer::TOKEN_FLAG_START_OF_LINE))) {
+            text += ' ';
+        }
+
+        bool isQuoted = token.getType() == lexer::TokenType::STRING_LITERAL ||
+                        token.getType() == lexer::TokenType::CHAR_LITERAL;
+        for (char c : token.getLexeme()) {
+            if (isQuoted && (c == '"' || c == '\\')) {
+                text += '\\';
+            }
+            text += c;
+        }
+    }
+    text += '"';
+    return lexer::Token(lexer::TokenType::STRING_LITERAL, text, location,
+                        lexer::TokenUtils::unescapeLiteral(text));
+}
+
+/**
+ * @brief Evaluador de expresiones de #if por descenso recursivo
+ *
+ * Recibe la expresión ya expandida: los identificadores que quedan valen 0.
+ * Los operandos no evaluados por &&, || y ?: no reportan división por cero.
+ */
+class ConditionalExpressionEvaluator {
+public:
+    explicit ConditionalExpressionEvaluator(const std::vector<lexer::Token>& tokens)
+        : tokens_(tokens) {}
+
+    /**
+     * @brief Valor de la expresión (nullopt si está mal formada, ver error())
+     */
+    std::optional<intmax_t> evaluate() {
+        intmax_t value = parseConditional();
+        if (!failed_ && position_ < tokens_.size()) {
+            fail("token inesperado en la expresión de #if: " + tokens_[position_].getLexeme());
+        }
+        if (failed_) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    const std::string& error() const { return error_; }
+
+private:
+    const std::vector<lexer::Token>& tokens_;
+    size_t position_ = 0;
+    size_t unevaluatedDepth_ = 0;
+    bool failed_ = false;
+    std::string error_;
+
+    lexer::TokenType peek() const {
+        return position_ < tokens_.size() ? tokens_[position_].getType() : lexer::TokenType::END_OF_FILE;
+    }
+
+    bool accept(lexer::TokenType type) {
+        if (peek() != type) {
+            return false;
+        }
+        ++position_;
+        return true;
+    }
+
+    intmax_t fail(const std::string& message) {
+        if (!failed_) {
+            failed_ = true;
+            error_ = message;
+        }
+        position_ = tokens_.size();
+        return 0;
+    }
+
+    static int precedence(lexer::TokenType type) {
+        switch (type) {
+            case lexer::TokenType::LOGICAL_OR: return 1;
+            case lexer::TokenType::LOGICAL_AND: return 2;
+            case lexer::TokenType::BIT_OR: return 3;
+            case lexer::TokenType::BIT_XOR: return 4;
+            case lexer::TokenType::BIT_AND: return 5;
+            case lexer::TokenType::EQUAL: case lexer::TokenType::NOT_EQUAL: return 6;
+            case lexer::TokenType::LESS: case lexer::TokenType::GREATER:
+            case lexer::TokenType::LESS_EQUAL: case lexer::TokenType::GREATER_EQUAL: return 7;
+            case lexer::TokenType::LEFT_SHIFT: case lexer::TokenType::RIGHT_SHIFT: return 8;
+            case lexer::TokenType::PLUS: case lexer::TokenType::MINUS: return 9;
+            case lexer::TokenType::STAR: case lexer::TokenType::SLASH:
+            case lexer::TokenType::PERCENT: return 10;
+            default: return -1;
+        }
+    }
+
+    intmax_t parseConditional() {
+        intmax_t condition = parseBinary(1);
+        if (!accept(lexer::TokenType::QUESTION)) {
+            return condition;
+        }
+
+        unevaluatedDepth_ += condition ? 0 : 1;
+        intmax_t whenTrue = parseConditional();
+        unevaluatedDepth_ -= condition ? 0 : 1;
+
+        if (!accept(lexer::TokenType::COLON)) {
+            return fail("se esperaba ':' en la expresión de #if");
+        }
+
+        unevaluatedDepth_ += condition ? 1 : 0;
+        intmax_t whenFalse = parseConditional();
+        unevaluatedDepth_ -= condition ? 1 : 0;
+
+        return condition ? whenTrue : whenFalse;
+    }
+
+    intmax_t parseBinary(int minPrecedence) {
+        intmax_t left = parseUnary();
+        while (true) {
+            lexer::TokenType op = peek();
+            int opPrecedence = precedence(op);
+            if (opPrecedence < minPrecedence) {
+                return left;
+            }
+            ++position_;
+
+            // El operando derecho de && / || puede no evaluarse
+            bool shortCircuit = (op == lexer::TokenType::LOGICAL_AND && !left) ||
+                                (op == lexer::TokenType::LOGICAL_OR && left);
+            unevaluatedDepth_ += shortCircuit ? 1 : 0;
+            intmax_t right = parseBinary(opPrecedence + 1);
+            unevaluatedDepth_ -= shortCircuit ? 1 : 0;
+
+            left = apply(op, left, right);
+        }
+    }
+
+    intmax_t apply(lexer::TokenType op, intmax_t left, intmax_t right) {
+        // Aritmética en complemento a dos sin comportamiento indefinido
+        auto wrap = [](uintmax_t value) { return static_cast<intmax_t>(value); };
+        auto ul = static_cast<uintmax_t>(left);
+        auto ur = static_cast<uintmax_t>(right);
+
+        switch (op) {
+            case lexer::TokenType::LOGICAL_OR: return left || right;
+            case lexer::TokenType::LOGICAL_AND: return left && right;
+            case lexer::TokenType::BIT_OR: return left | right;
+            case lexer::TokenType::BIT_XOR: return left ^ right;
+            case lexer::TokenType::BIT_AND: return left & right;
+            case lexer::TokenType::EQUAL: return left == right;
+            case lexer::TokenType::NOT_EQUAL: return left != right;
+            case lexer::TokenType::LESS: return left < right;
+            case lexer::TokenType::GREATER: return left > right;
+            case lexer::TokenType::LESS_EQUAL: return left <= right;
+            case lexer::TokenType::GREATER_EQUAL: return left >= right;
+            case lexer::TokenType::LEFT_SHIFT:
+                return right < 0 || right >= 64 ? 0 : wrap(ul << right);
+            case lexer::TokenType::RIGHT_SHIFT:
+                if (right < 0 || right >= 64) {
+                    return left < 0 ? -1 : 0;
+                }
+                return left >> right;
+            case lexer::TokenType::PLUS: return wrap(ul + ur);
+            case lexer::TokenType::MINUS: return wrap(ul - ur);
+            case lexer::TokenType::STAR: return wrap(ul * ur);
+            case lexer::TokenType::SLASH:
+            case lexer::TokenType::PERCENT:
+                if (right == 0) {
+                    return unevaluatedDepth_ > 0 ? 0 : fail("división por cero en #if");
+                }
+                if (left == INTMAX_MIN && right == -1) {
+                    return op == lexer::TokenType::SLASH ? left : 0;
+                }
+                return op == lexer::TokenType::SLASH ? left / right : left % right;
+            default:
+                return fail("operador inválido en #if");
+        }
+    }
+
+    intmax_t parseUnary() {
+        if (position_ >= tokens_.size()) {
+            return fail("expresión de #if incompleta");
+        }
+
+        const lexer::Token& token = tokens_[position_++];
+        switch (token.getType()) {
+            case lexer::TokenType::LOGICAL_NOT: return !parseUnary();
+            case lexer::TokenType::BIT_NOT: return ~parseUnary();
+            case lexer::TokenType::MINUS: return static_cast<intmax_t>(0 - static_cast<uintmax_t>(parseUnary()));
+            case lexer::TokenType::PLUS: return parseUnary();
+            case lexer::TokenType::LEFT_PAREN: {
+                intmax_t value = parseConditional();
+                if (!accept(lexer::TokenType::RIGHT_PAREN)) {
+                    return fail("se esperaba ')' en la expresión de #if");
+                }
+                return value;
+            }
+            case lexer::TokenType::INTEGER_LITERAL: return parseInteger(token.getLexeme());
+            case lexer::TokenType::CHAR_LITERAL: return parseCharacter(token.getLexeme());
+            case lexer::TokenType::TRUE_LITERAL: return 1;
+            case lexer::TokenType::FALSE_LITERAL: return 0;
+            case lexer::TokenType::IDENTIFIER:
+                return 0;
+            default:
+                if (token.isKeyword()) {
+                    return 0; // En el preprocesador las palabras clave son identificadores
+                }
+                return fail("token inesperado en la expresión de #if: " + token.getLexeme());
+        }
+    }
+
+    intmax_t parseInteger(const std::string& lexeme) {
+        std::string digits;
+        digits.reserve(lexeme.size());
+        for (char c : lexeme) {
+            if (c != '\'') {
+                digits += c;
+            }
+        }
+
+        int base = 10;
+        size_t start = 0;
+        if (digits.size() > 1 && digits[0] == '0') {
+            char prefix = static_cast<char>(std::tolower(static_cast<unsigned char>(digits[1])));
+            if (prefix == 'x') {
+                base = 16;
+                start = 2;
+            } else if (prefix == 'b') {
+                base = 2;
+                start = 2;
+            } else {
+                base = 8;
+                start = 1;
+            }
+        }
+
+        // El sufijo (u, l, ll, z) queda tras el último dígito válido
+        uintmax_t value = 0;
+        const char* first = digits.data() + start;
+        const char* last = digits.data() + digits.size();
+        auto [ptr, ec] = std::from_chars(first, last, value, base);
+        if (ec == std::errc::result_out_of_range) {
+            return fail("literal entero demasiado grande en #if: " + lexeme);
+        }
+        return static_cast<intmax_t>(value);
+    }
+
+    intmax_t parseCharacter(const std::string& lexeme) {
+        size_t quote = lexeme.find('\'');
+        std::string value = lexer::TokenUtils::unescapeLiteral(
+            quote == std::string::npos ? std::string_view(lexeme) : std::string_view(lexeme).substr(quote));
+        return value.empty() ? 0 : static_cast<unsigned char>(value[0]);
+    }
+};
+
+/**
+ * @brief Si [p, end) empieza por la palabra dada seguida de un no-identificador
+ */
+/**
+ * @brief Copia de un token con otro archivo en su ubicación (ids de instantánea)
+ */
+lexer::Token withFileId(const lexer::Token& token, uint32_t fileId) {
+    const diagnostics::SourceLocation& location = token.getLocation();
+    lexer::Token copy(token.getType(), token.getLexeme(),
+                      diagnostics::SourceLocation(location.line(), location.column(), location.offset(), fileId),
+                      token.getValue());
+    copy.setFlags(token.flags());
+    copy.setIdentifierInfo(token.getIdentifierInfo());
+    return copy;
+}
+
+bool startsWithWord(const char* p, const char* end, std::string_view word) {
+    if (static_cast<size_t>(end - p) < word.size() || std::string_view(p, word.size()) != word) {
+        return false;
+    }
+    const char* after = p + word.size();
+    return after == end || !(std::isalnum(static_cast<unsigned char>(*after)) || *after == '_');
+}
+
+bool isHorizontalSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\f' || c == '\v' || c == '\r';
+}
+
+bool isIdentifierChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+/**
+ * @brief Inicio del identificador o número que termina justo antes de p
+ */
+const char* identifierStart(const char* begin, const char* p) {
+    while (p > begin && isIdentifierChar(p[-1])) {
+        --p;
+    }
+    return p;
+}
+
+/**
+ * @brief Fin de un literal entre comillas (se queda en el '\n' si no se cierra)
+ */
+const char* skipQuoted(const char* p, const char* end, char quote) {
+    for (++p; p < end; ++p) {
+        if (*p == '\\' && p + 1 < end) {
+            ++p;
+        } else if (*p == quote) {
+            return p + 1;
+        } else if (*p == '\n') {
+            return p;
+        }
+    }
+    return end;
+}
+
+/**
+ * @brief Fin de un raw string R"delim(...)delim" (p apunta a la comilla)
+ */
+const char* skipRawString(const char* p, const char* end) {
+    const char* open = p + 1;
+    while (open < end && *open != '(' && *open != '\n' && open - p <= 17) {
+        ++open;
+    }
+    if (open >= end || *open != '(') {
+        return skipQuoted(p, end, '"'); // Delimitador inválido: tratar como string normal
+    }
+
+    std::string closing = ")" + std::string(p + 1, open) + "\"";
+    std::string_view rest(open + 1, static_cast<size_t>(end - open - 1));
+    size_t found = rest.find(closing);
+    return found == std::string_view::npos ? end : open + 1 + found + closing.size();
+}
+
+/**
+ * @brief Avanzar sobre una línea lógica (continuaciones y construcciones multilínea incluidas)
+ * @param hasContent Se activa si la línea tiene algo más que espacios y comentarios
+ * @return Puntero tras el '\n' final (o end)
+ */
+const char* skipLogicalLine(const char* begin, const char* p, const char* end, bool& hasContent) {
+    while (p < end) {
+        char c = *p;
+        switch (c) {
+            case '\n':
+                return p + 1;
+
+            case '\\':
+                if (p + 1 < end && p[1] == '\n') {
+                    p += 2;
+                    continue;
+                }
+                if (p + 2 < end && p[1] == '\r' && p[2] == '\n') {
+                    p += 3;
+                    continue;
+                }
+                hasContent = true;
+                ++p;
+                continue;
+
+            case '/':
+                if (p + 1 < end && p[1] == '/') {
+                    // Comentario de línea: continúa mientras el salto esté escapado
+                    while (true) {
+                        const char* newline = lexer::CharScanner::findNewline(p, end);
+                        if (newline == end) {
+                            return end;
+                        }
+                        const char* last = newline - 1;
+                        if (*last == '\r' && last > p) {
+                            --last;
+                        }
+                        if (*last != '\\') {
+                            return newline + 1;
+                        }
+                        p = newline + 1;
+                    }
+                }
+                if (p + 1 < end && p[1] == '*') {
+                    const char* close = lexer::CharScanner::findBlockCommentEnd(p + 2, end);
+                    p = close == end ? end : close + 2;
+                    continue;
+                }
+                hasContent = true;
+                ++p;
+                continue;
+
+            case '"': {
+                hasContent = true;
+                const char* prefixStart = identifierStart(begin, p);
+                std::string_view prefix(prefixStart, static_cast<size_t>(p - prefixStart));
+                bool isRaw = prefix == "R" || prefix == "u8R" || prefix == "uR" ||
+                             prefix == "UR" || prefix == "LR";
+                p = isRaw ? skipRawString(p, end) : skipQuoted(p, end, '"');
+                continue;
+            }
+
+            case '\'': {
+                hasContent = true;
+                // 1'000'000: separador de dígitos, no literal de carácter
+                const char* tokenStart = identifierStart(begin, p);
+                if (tokenStart < p && std::isdigit(static_cast<unsigned char>(*tokenStart))) {
+                    ++p;
+                } else {
+                    p = skipQuoted(p, end, '\'');
+                }
+                continue;
+            }
+
+            default:
+                if (!isHorizontalSpace(c)) {
+                    hasContent = true;
+                }
+                ++p;
+                continue;
+        }
+    }
+    return end;
+}
+
+/**
+ * @brief La línea (ya sin espacios iniciales) es una declaración module / import
+ */
+bool isModuleDeclarationLine(const char* p, const char* end) {
+    if (startsWithWord(p, end, "module") || startsWithWord(p, end, "import")) {
+        return true;
+    }
+    if (!startsWithWord(p, end, "export")) {
+        return false;
+    }
+    p += 6;
+    while (p < end && isHorizontalSpace(*p)) {
+        ++p;
+    }
+    return startsWithWord(p, end, "module") || startsWithWord(p, end, "import");
+}
+
+/**
+ * @brief Valor de __has_cpp_attribute: el de la versión del estándar que lo introdujo
+ */
+long cppAttributeVersion(std::string_view name) {
+    static constexpr std::pair<std::string_view, long> attributes[] = {
+        {"carries_dependency", 200809}, {"deprecated", 201309},   {"fallthrough", 201603},
+        {"likely", 201803},             {"maybe_unused", 201603}, {"no_unique_address", 201803},
+        {"nodiscard", 201907},          {"noreturn", 200809},     {"unlikely", 201803},
+        {"clang::musttail", 1},
+    };
+    for (const auto& [attribute, version] : attributes) {
+        if (attribute == name) return version;
+    }
+    return 0;
+}
+
+uint64_t hashExpression(const std::vector<lexer::Token>& expression) {
+    common::utils::StreamingHasher hasher;
+    for (const auto& token : expression) {
+        hasher.update(token.getLexeme());
+        hasher.updateValue('\0');
+    }
+    return hasher.digest64();
+}
+
+uint64_t conditionKey(uint32_t fileId, uint32_t offset) {
+    return (static_cast<uint64_t>(fileId) << 32) | offset;
+}
+
+} // namespace
+
+// ============================================================================
+// IncludeState - Implementación
+// ============================================================================
+
+IncludeState::IncludeState(const std::string& fname, bool system, size_t depth)
+    : filename(fname), isSystemInclude(system), includeDepth(depth) {}
+
+IncludeState::IncludeState(IncludeState&&) noexcept = default;
+IncludeState& IncludeState::operator=(IncludeState&&) noexcept = default;
+IncludeState::~IncludeState() = default;
+
+// ============================================================================
+// ConditionCache - Implementación
+// ============================================================================
+
+std::vector<std::shared_ptr<const CompiledCondition>> ConditionCache::variants(uint32_t fileId,
+                                                                               uint32_t offset) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(conditionKey(fileId, offset));
+    return it != entries_.end() ? it->second : std::vector<std::shared_ptr<const CompiledCondition>>();
+}
+
+void ConditionCache::store(uint32_t fileId, uint32_t offset, std::shared_ptr<const CompiledCondition> condition) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& variants = entries_[conditionKey(fileId, offset)];
+    if (variants.size() >= MaxVariants) {
+        variants.erase(variants.begin());
+    }
+    variants.push_back(std::move(condition));
+}
+
+size_t ConditionCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const auto& [key, variants] : entries_) {
+        count += variants.size();
+    }
+    return count;
+}
+
+void ConditionCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+}
+
+// ============================================================================
+// MacroDefinition - Implementación
+// ============================================================================
+
+void MacroDefinition::resolveParameters() {
+    parameterIndices.assign(body.size(), -1);
+    hasOperators = false;
+
+    // Sin ubicaciones: la misma definición en otra unidad tiene la misma huella
+    common::utils::StreamingHasher hasher;
+    hasher.updateValue(static_cast<uint8_t>((isFunctionLike ? 1 : 0) | (isVariadic ? 2 : 0)));
+    for (const auto& parameter : parameters) {
+        hasher.update(parameter);
+        hasher.updateValue('\0');
+    }
+    hasher.updateValue('\1');
+    for (const auto& token : body) {
+        hasher.update(token.getLexeme());
+        hasher.updateValue(static_cast<uint8_t>(token.flags() & lexer::TOKEN_FLAG_LEADING_SPACE ? 1 : 0));
+    }
+    fingerprint = hasher.digest64() | 1;
+
+    for (size_t i = 0; i < body.size(); ++i) {
+        const lexer::Token& token = body[i];
+        if (token.getType() == lexer::TokenType::HASH_HASH ||
+            (isFunctionLike && token.getType() == lexer::TokenType::HASH)) {
+            hasOperators = true;
+        }
+
+        if (!isFunctionLike || token.getType() != lexer::TokenType::IDENTIFIER) {
+            continue;
+        }
+        auto it = std::find(parameters.begin(), parameters.end(), token.getLexeme());
+        if (it != parameters.end()) {
+            parameterIndices[i] = static_cast<int>(it - parameters.begin());
+        }
+    }
+}
+
 // ============================================================================
 // Preprocessor - Implementación
 // ============================================================================
 
 Preprocessor::Preprocessor(diagnostics::DiagnosticEngine& diagEngine,
                           const PreprocessorConfig& config)
-    : diagEngine_(diagEngine), config_(config), stats_() {
+    : diagEngine_(diagEngine), config_(config), stats_(),
+      identifiers_(config.identifiers ? config.identifiers : &lexer::IdentifierTable::global()),
+      conditionCache_(config.conditionCache ? config.conditionCache : std::make_shared<ConditionCache>()) {
     initializePredefinedMacros();
 }
 
-Preprocessor::~Preprocessor() = default;
+Preprocessor::~Preprocessor() {
+    // La tabla sobrevive al preprocesador: retirar sus definiciones del bit de macro
+    for (const auto& [name, macro] : macros_) {
+        const_cast<lexer::IdentifierInfo*>(name)->removeMacroDefinition();
+    }
+}
 
 std::vector<lexer::Token> Preprocessor::process(const std::vector<lexer::Token>& inputTokens) {
+    mainSource_ = nullptr;
+    tokenSource_ = nullptr;
     inputTokens_ = inputTokens;
-    outputTokens_.clear();
     currentTokenIndex_ = 0;
+    beginUnit();
 
-    while (!isAtEnd()) {
-        if (currentToken().getType() == lexer::TokenType::HASH) {
-            processDirective();
-        } else {
-            processToken();
-        }
+    std::vector<lexer::Token> output = drainTokens();
+    inputTokens_.clear();
+    return output;
+}
+
+std::vector<lexer::Token> Preprocessor::process(lexer::Lexer& lexer) {
+    begin(lexer);
+    return drainTokens();
+}
+
+void Preprocessor::begin(lexer::Lexer& lexer) {
+    mainSource_ = &lexer;
+    tokenSource_ = &lexer;
+    inputTokens_.clear();
+    currentTokenIndex_ = 0;
+    beginUnit();
+}
+
+std::vector<lexer::Token> Preprocessor::drainTokens() {
+    std::vector<lexer::Token> output;
+    while (std::optional<lexer::Token> token = nextToken()) {
+        output.push_back(std::move(*token));
     }
+    return output;
+}
 
-    return outputTokens_;
+std::optional<lexer::Token> Preprocessor::nextToken() {
+    while (outputIndex_ >= outputTokens_.size()) {
+        // Mientras falte la instantánea, la salida del prólogo se conserva para capturarla
+        if (!snapshotPending_) {
+            outputTokens_.clear();
+            outputIndex_ = 0;
+        }
+        if (!processNext()) {
+            mainSource_ = nullptr;
+            tokenSource_ = nullptr;
+            return std::nullopt;
+        }
+    }
+    if (snapshotPending_) {
+        return outputTokens_[outputIndex_++];
+    }
+    return std::move(outputTokens_[outputIndex_++]);
 }
 
-void Preprocessor::defineMacro(const std::string& name, const std::string& value) {
-    // Crear tokens simples para el valor
-    std::vector<lexer::Token> body;
-    if (!value.empty()) {
-        body.emplace_back(lexer::TokenType::IDENTIFIER, value,
-                         diagnostics::SourceLocation("", 0, 0), value);
+void Preprocessor::beginUnit() {
+    moduleDependencies_ = ModuleDependencies();
+    unresolvedIncludes_.clear();
+    hasIncludeResults_.clear();
+    capturedSnapshot_.reset();
+    outputIndex_ = 0;
+
+    // Una unidad anterior abandonada a medias deja archivos abiertos
+    while (!includeStack_.empty()) {
+        includeStack_.pop_back();
     }
+    guardStates_.clear();
 
-    MacroDefinition macro(name, body, false, false);
-    macros_[name] = macro;
-    ++stats_.macrosDefined;
+    if (!restored_) {
+        outputTokens_.clear();
+        includeGraph_.clear();
+        return;
+    }
+
+    restored_ = false;
+    while (!isAtEnd() && currentToken().getLocation().offset() < resumeOffset_) {
+        advanceToken();
+    }
+}
+
+void Preprocessor::defineMacro(const std::string& name, const std::string& value) {
+    if (name.empty()) return;
+    MacroDefinition macro(name, lexText(value, diagnostics::SourceLocation()), false, false);
+    storeMacro(identifiers_->get(name), macro);
 }
 
 void Preprocessor::defineMacro(const MacroDefinition& macro) {
-    macros_[macro.name] = macro;
-    ++stats_.macrosDefined;
+    if (macro.name.empty()) return;
+    storeMacro(identifiers_->get(macro.name), macro);
 }
 
 void Preprocessor::undefineMacro(const std::string& name) {
-    if (macros_.erase(name) > 0) {
+    lexer::IdentifierInfo* info = identifiers_->find(name);
+    if (info && macros_.erase(info) > 0) {
+        info->removeMacroDefinition();
+        invalidateExpansionMemo(info);
         ++stats_.macrosUndefined;
     }
 }
 
 bool Preprocessor::isMacroDefined(const std::string& name) const {
-    return macros_.find(name) != macros_.end();
+    return getMacro(identifiers_->find(name)) != nullptr;
+}
+
+bool Preprocessor::isMacroDefined(const lexer::IdentifierInfo* name) const {
+    return getMacro(name) != nullptr;
 }
 
 const MacroDefinition* Preprocessor::getMacro(const std::string& name) const {
+    return getMacro(identifiers_->find(name));
+}
+
+const MacroDefinition* Preprocessor::getMacro(const lexer::IdentifierInfo* name) const {
+    if (!name || !name->mayHaveMacroDefinition()) {
+        return nullptr;
+    }
     auto it = macros_.find(name);
     return it != macros_.end() ? &it->second : nullptr;
 }
 
+void Preprocessor::storeMacro(lexer::IdentifierInfo* name, const MacroDefinition& macro) {
+    auto [it, inserted] = macros_.insert_or_assign(name, macro);
+    if (inserted) {
+        name->addMacroDefinition();
+    }
+    it->second.resolveParameters();
+    invalidateExpansionMemo(name);
+    ++stats_.macrosDefined;
+}
+
+lexer::IdentifierInfo* Preprocessor::identifierOf(const lexer::Token& token) const {
+    if (token.getIdentifierInfo()) {
+        return token.getIdentifierInfo();
+    }
+    return identifiers_->get(token.getLexeme());
+}
+
+void Preprocessor::applyCommandLineMacros(const std::vector<std::string>& defines,
+                                          const std::vector<std::string>& undefines) {
+    commandLineDefines_.insert(commandLineDefines_.end(), defines.begin(), defines.end());
+    commandLineUndefines_.insert(commandLineUndefines_.end(), undefines.begin(), undefines.end());
+    for (const auto& define : defines) {
+        size_t equalPos = define.find('=');
+        if (equalPos == std::string::npos) {
+            defineMacro(define, "1");
+        } else {
+            defineMacro(define.substr(0, equalPos), define.substr(equalPos + 1));
+        }
+    }
+    for (const auto& undefine : undefines) {
+        undefineMacro(undefine);
+    }
+}
+
 void Preprocessor::addIncludePath(const std::string& path, bool system) {
     if (system) {
         config_.systemIncludePaths.push_back(path);
@@ -101,98 +804,551 @@ void Preprocessor::addIncludePath(const std::string& path, bool system) {
     }
 }
 
+// === INSTANTÁNEAS DEL PRÓLOGO ===
+
+void Preprocessor::requestSnapshot(uint32_t mainFileId, size_t prologueLength) {
+    snapshotPending_ = true;
+    snapshotFileId_ = mainFileId;
+    snapshotOffset_ = prologueLength;
+}
+
+std::unique_ptr<PreprocessorSnapshot> Preprocessor::takeSnapshot() {
+    return std::move(capturedSnapshot_);
+}
+
+void Preprocessor::captureSnapshot() {
+    snapshotPending_ = false;
+
+    const auto& sourceManager = diagEngine_.sourceManager();
+    if (!sourceManager || diagEngine_.hasErrors() || !conditionalStack_.empty()) {
+        return;
+    }
+
+    auto snapshot = std::make_unique<PreprocessorSnapshot>();
+    snapshot->prologueLength = static_cast<uint32_t>(snapshotOffset_);
+
+    // Ids locales: 0 = sin archivo, 1 = archivo principal, 2.. = headers
+    std::unordered_map<uint32_t, uint32_t> localIds{{0, 0}, {snapshotFileId_, 1}};
+    auto localId = [&](uint32_t fileId) {
+        auto it = localIds.find(fileId);
+        return it != localIds.end() ? it->second : 0;
+    };
+
+    for (const auto& record : includeGraph_) {
+        if (localIds.count(record.fileId) == 0) {
+            const diagnostics::SourceFile* file = sourceManager->getFile(record.fileId);
+            if (!file) {
+                return;
+            }
+            PreprocessorSnapshot::File entry;
+            entry.contentHash = common::utils::fnv1a64(file->text());
+            if (auto info = sourceManager->getIncludeCacheEntry(record.name)) {
+                entry.includeGuard = info->includeGuard;
+                entry.pragmaOnce = info->pragmaOnce;
+            }
+            snapshot->files.push_back(std::move(entry));
+            localIds.emplace(record.fileId, static_cast<uint32_t>(snapshot->files.size() + 1));
+        }
+
+        IncludeRecord local = record;
+        local.includerFileId = localId(record.includerFileId);
+        local.fileId = localId(record.fileId);
+        snapshot->includes.push_back(std::move(local));
+    }
+
+    // Los no encontrados invalidan la instantánea si llegan a aparecer
+    for (const auto& record : unresolvedIncludes_) {
+        IncludeRecord local = record;
+        local.includerFileId = localId(record.includerFileId);
+        snapshot->includes.push_back(std::move(local));
+    }
+
+    snapshot->macros.reserve(macros_.size());
+    for (const auto& [name, macro] : macros_) {
+        MacroDefinition local(macro.name, {}, macro.isFunctionLike, macro.isVariadic);
+        local.parameters = macro.parameters;
+        local.body.reserve(macro.body.size());
+        for (const auto& token : macro.body) {
+            local.body.push_back(withFileId(token, localId(token.getLocation().fileId())));
+        }
+        snapshot->macros.push_back(std::move(local));
+    }
+
+    snapshot->tokens.reserve(outputTokens_.size());
+    for (const auto& token : outputTokens_) {
+        snapshot->tokens.push_back(withFileId(token, localId(token.getLocation().fileId())));
+    }
+
+    capturedSnapshot_ = std::move(snapshot);
+}
+
+bool Preprocessor::restoreSnapshot(const PreprocessorSnapshot& snapshot, uint32_t mainFileId) {
+    const auto& sourceManager = diagEngine_.sourceManager();
+    if (!sourceManager) {
+        return false;
+    }
+
+    // Validar antes de tocar el estado: misma resolución y mismo contenido
+    std::vector<uint32_t> fileIds(snapshot.files.size() + 2, 0);
+    fileIds[1] = mainFileId;
+    for (const auto& record : snapshot.includes) {
+        if (record.includerFileId >= fileIds.size() || record.fileId >= fileIds.size() ||
+            record.fileId == 1 || (record.includerFileId != 0 && fileIds[record.includerFileId] == 0)) {
+            return false;
+        }
+
+        uint32_t resolved = sourceManager->findAndLoadInclude(record.name, fileIds[record.includerFileId],
+                                                              record.isSystem);
+        if (record.fileId == 0) {
+            if (resolved != 0) {
+                return false;
+            }
+            continue;
+        }
+
+        uint32_t& expected = fileIds[record.fileId];
+        if (expected == 0) {
+            const diagnostics::SourceFile* file = sourceManager->getFile(resolved);
+            if (!file || common::utils::fnv1a64(file->text()) != snapshot.files[record.fileId - 2].contentHash) {
+                return false;
+            }
+            expected = resolved;
+        } else if (expected != resolved) {
+            return false;
+        }
+    }
+
+    auto realId = [&](uint32_t localId) { return localId < fileIds.size() ? fileIds[localId] : 0; };
+
+    for (size_t i = 0; i < snapshot.files.size(); ++i) {
+        const auto& entry = snapshot.files[i];
+        if (fileIds[i + 2] != 0 && (!entry.includeGuard.empty() || entry.pragmaOnce)) {
+            sourceManager->recordMultipleIncludeInfo(fileIds[i + 2], entry.includeGuard, entry.pragmaOnce);
+        }
+    }
+
+    for (const auto& [name, macro] : macros_) {
+        const_cast<lexer::IdentifierInfo*>(name)->removeMacroDefinition();
+    }
+    macros_.clear();
+    expansionMemo_.clear();
+    memoDependencies_.clear();
+    for (const auto& macro : snapshot.macros) {
+        MacroDefinition local(macro.name, {}, macro.isFunctionLike, macro.isVariadic);
+        local.parameters = macro.parameters;
+        local.body.reserve(macro.body.size());
+        for (const auto& token : macro.body) {
+            local.body.push_back(withFileId(token, realId(token.getLocation().fileId())));
+        }
+        storeMacro(identifiers_->get(local.name), local);
+    }
+
+    enteredFiles_.clear();
+    for (auto it = fileIds.begin() + 2; it != fileIds.end(); ++it) {
+        enteredFiles_.insert(sourceManager->getCanonicalFileId(*it));
+    }
+
+    includeGraph_.clear();
+    for (const auto& record : snapshot.includes) {
+        if (record.fileId == 0) {
+            continue;
+        }
+        IncludeRecord real = record;
+        real.includerFileId = realId(record.includerFileId);
+        real.fileId = realId(record.fileId);
+        includeGraph_.push_back(std::move(real));
+    }
+
+    outputTokens_.clear();
+    outputTokens_.reserve(snapshot.tokens.size());
+    for (const auto& token : snapshot.tokens) {
+        outputTokens_.push_back(withFileId(token, realId(token.getLocation().fileId())));
+    }
+
+    restored_ = true;
+    resumeOffset_ = snapshot.prologueLength;
+    return true;
+}
+
 // === PROCESAMIENTO PRINCIPAL ===
 
-void Preprocessor::processToken() {
-    const lexer::Token& token = currentToken();
+bool Preprocessor::processNext() {
+    while (isAtEnd()) {
+        if (includeStack_.empty()) {
+            if (snapshotPending_) {
+                captureSnapshot(); // El archivo principal no tiene nada tras el prólogo
+            }
+            return false;
+        }
+        leaveIncludedFile();
+    }
+
+    const lexer::Token& token = currentToken();
+    if (snapshotPending_ && includeStack_.empty() && token.getLocation().offset() >= snapshotOffset_) {
+        captureSnapshot();
+    }
+    lexer::TokenType type = token.getType();
+    if (type == lexer::TokenType::HASH && token.isAtStartOfLine()) {
+        processDirective();
+    } else if (token.isAtStartOfLine() && !isSkippingTokens() &&
+               (type == lexer::TokenType::MODULE || type == lexer::TokenType::IMPORT ||
+                type == lexer::TokenType::EXPORT)) {
+        processModuleDeclaration();
+    } else {
+        processToken();
+    }
+    return true;
+}
+
+void Preprocessor::processToken() {
+    noteNonGuardContent();
+
+    // En el escaneo de dependencias el cuerpo solo importa para la detección de guardas
+    if (isSkippingTokens() || config_.dependencyScan) {
+        advanceToken();
+        return;
+    }
+
+    const lexer::Token& token = currentToken();
+
+    // Verificar si es una macro a expandir
+    if (token.getType() == lexer::TokenType::IDENTIFIER) {
+        lexer::IdentifierInfo* name = identifierOf(token);
+        const MacroDefinition* macro = getMacro(name);
+        if (macro) {
+            diagnostics::SourceLocation location = token.getLocation();
+            size_t firstOutput = outputTokens_.size();
+            // La expansión ocupa el sitio del nombre: hereda su inicio de línea y su espacio previo
+            auto placeExpansion = [this, firstOutput](uint16_t nameFlags) {
+                if (outputTokens_.size() > firstOutput) {
+                    lexer::Token& first = outputTokens_[firstOutput];
+                    constexpr uint16_t placement = lexer::TOKEN_FLAG_START_OF_LINE | lexer::TOKEN_FLAG_LEADING_SPACE;
+                    first.setFlags(static_cast<uint16_t>((first.flags() & ~placement) | (nameFlags & placement)));
+                }
+            };
+            if (!macro->isFunctionLike) {
+                uint16_t nameFlags = token.flags();
+                expandMacro(name, *macro, {}, location, outputTokens_);
+                placeExpansion(nameFlags);
+                advanceToken();
+                return;
+            }
+
+            // Una macro de función solo se invoca si le sigue '('
+            lexer::Token nameToken = token;
+            advanceToken();
+            if (!isAtEnd() && currentToken().getType() == lexer::TokenType::LEFT_PAREN) {
+                std::vector<std::vector<lexer::Token>> arguments;
+                if (collectArgumentsFromInput(arguments) &&
+                    normalizeArguments(*macro, arguments, location)) {
+                    expandMacro(name, *macro, arguments, location, outputTokens_);
+                    placeExpansion(nameToken.flags());
+                }
+                return;
+            }
+
+            outputTokens_.push_back(std::move(nameToken));
+            ++stats_.tokensProcessed;
+            return;
+        }
+    }
+
+    // Token normal
+    outputTokens_.push_back(token);
+    advanceToken();
+    ++stats_.tokensProcessed;
+}
+
+void Preprocessor::processDirective() {
+    advanceToken(); // Consumir #
+
+    // Directiva nula: # solo en su línea
+    if (isAtEnd() || currentToken().isAtStartOfLine()) {
+        return;
+    }
+
+    // if y else son palabras clave: el nombre de directiva puede ser cualquiera de ambos
+    const lexer::Token& directiveToken = currentToken();
+    if (directiveToken.getType() != lexer::TokenType::IDENTIFIER && !directiveToken.isKeyword()) {
+        reportError("se esperaba nombre de directiva", directiveToken.getLocation());
+        skipToEndOfLine();
+        return;
+    }
+
+    std::string directive = directiveToken.getLexeme();
+    diagnostics::SourceLocation directiveLocation = directiveToken.getLocation();
+    advanceToken();
+
+    bool isConditional = directive == "ifdef" || directive == "ifndef" || directive == "if" ||
+                         directive == "else" || directive == "elif" || directive == "endif";
+    if (isSkippingTokens() && !isConditional) {
+        skipToEndOfLine(); // Solo las condicionales cuentan dentro de una sección inactiva
+        return;
+    }
+
+    bool opensGuard = directive == "ifndef" && !guardStates_.empty() &&
+                      guardStates_.back().phase == MultipleIncludeState::Phase::Start;
+    if (!opensGuard && directive != "pragma") {
+        noteNonGuardContent();
+    }
+
+    if (directive == "include") {
+        processInclude();
+        return; // Ya consumió su línea; la entrada puede seguir en el archivo incluido
+    } else if (directive == "define") {
+        processDefine();
+    } else if (directive == "undef") {
+        processUndef();
+    } else if (directive == "ifdef") {
+        processIfdef(true);
+    } else if (directive == "ifndef") {
+        processIfdef(false);
+    } else if (directive == "if") {
+        processIf();
+    } else if (directive == "else") {
+        processElseOrElif(false);
+    } else if (directive == "elif") {
+        processElseOrElif(true);
+    } else if (directive == "endif") {
+        processEndif();
+    } else if (directive == "pragma") {
+        processPragma();
+    } else if (directive == "line") {
+        processLine();
+    } else if (directive == "error") {
+        processDiagnostic(true);
+    } else if (directive == "warning") {
+        processDiagnostic(false);
+    } else {
+        reportWarning("directiva de preprocesador desconocida: " + directive, directiveLocation);
+    }
+
+    skipToEndOfLine(); // Tokens sobrantes tras la directiva
+}
+
+// === PROCESAMIENTO DE DIRECTIVAS ===
+
+void Preprocessor::processInclude() {
+    diagnostics::SourceLocation location = currentToken().getLocation();
+    auto tokens = getTokensUntilEndOfLine();
+
+    if (tokens.empty()) {
+        reportError("#include sin archivo especificado", location);
+        return;
+    }
+    ++stats_.includesProcessed;
+
+    std::string includeName;
+    bool isSystem = false;
+    if (tokens[0].getType() == lexer::TokenType::STRING_LITERAL) {
+        const std::string& lexeme = tokens[0].getLexeme();
+        includeName = lexeme.substr(1, lexeme.size() >= 2 ? lexeme.size() - 2 : 0);
+    } else if (tokens[0].getType() == lexer::TokenType::LESS) {
+        isSystem = true;
+        for (size_t i = 1; i < tokens.size() && tokens[i].getType() != lexer::TokenType::GREATER; ++i) {
+            includeName += tokens[i].getLexeme();
+        }
+    }
+
+    if (includeName.empty()) {
+        reportError("nombre de archivo de #include inválido", location);
+        return;
+    }
+
+    const auto& sourceManager = diagEngine_.sourceManager();
+    if (!sourceManager) {
+        return;
+    }
+
+    if (includeStack_.size() >= config_.maxIncludeDepth) {
+        reportError("profundidad máxima de #include excedida en " + includeName, location);
+        return;
+    }
+
+    uint32_t fileId = sourceManager->findAndLoadInclude(includeName, location.fileId(), isSystem);
+    if (fileId == 0) {
+        // Sin la biblioteca estándar instalada los headers de sistema no se resuelven
+        reportWarning("no se encontró el archivo de #include: " + includeName, location);
+        IncludeRecord record;
+        record.includerFileId = location.fileId();
+        record.name = includeName;
+        record.isSystem = isSystem;
+        unresolvedIncludes_.push_back(std::move(record));
+        return;
+    }
+
+    IncludeRecord record;
+    record.includerFileId = location.fileId();
+    record.fileId = fileId;
+    record.name = includeName;
+    record.isSystem = isSystem;
+    record.skipped = shouldSkipInclude(includeName, fileId);
+    includeGraph_.push_back(record);
+
+    if (record.skipped) {
+        ++stats_.includesSkipped;
+        return;
+    }
+    if (config_.headerUnits && importHeaderUnit(fileId, includeName, isSystem)) {
+        return;
+    }
+
+    enterIncludedFile(fileId, includeName, isSystem);
+}
+
+bool Preprocessor::shouldSkipInclude(const std::string& includeName, uint32_t fileId) const {
+    auto entry = diagEngine_.sourceManager()->getIncludeCacheEntry(includeName);
+    if (!entry) {
+        return false;
+    }
+
+    // Por ID canónico: el mismo archivo por otra ruta también cuenta como ya incluido
+    uint32_t canonicalId = diagEngine_.sourceManager()->getCanonicalFileId(fileId);
+    if (entry->pragmaOnce && enteredFiles_.count(canonicalId) > 0) {
+        return true;
+    }
+    return !entry->includeGuard.empty() && isMacroDefined(entry->includeGuard);
+}
+
+bool Preprocessor::importHeaderUnit(uint32_t fileId, const std::string& includeName, bool isSystem) {
+    const diagnostics::SourceFile* file = diagEngine_.sourceManager()->getFile(fileId);
+    if (!file || config_.dependencyScan) {
+        return false;
+    }
+    std::string path = file->path.string();
+    if (!config_.headerUnits->isPromoted(path, file->text())) {
+        return false;
+    }
+
+    // Importar otra vez el mismo header unit no añade nada
+    if (!enteredFiles_.insert(file->canonicalId).second) {
+        ++stats_.includesSkipped;
+        return true;
+    }
 
-    // Verificar si es una macro a expandir
-    if (token.getType() == lexer::TokenType::IDENTIFIER) {
-        const MacroDefinition* macro = getMacro(token.getLexeme());
-        if (macro && !macro->isFunctionLike) {
-            // Expandir macro de objeto
-            auto expanded = expandMacro(*macro);
-            outputTokens_.insert(outputTokens_.end(), expanded.begin(), expanded.end());
-            advanceToken();
-            return;
+    std::shared_ptr<const HeaderUnitTable::Unit> unit = config_.headerUnits->unit(path);
+    if (!unit) {
+        auto built = std::make_shared<HeaderUnitTable::Unit>();
+        if (!preprocessIsolated(fileId, built->tokens, built->macros)) {
+            config_.headerUnits->demote(path);
+            enteredFiles_.erase(file->canonicalId);
+            return false;
         }
+        unit = config_.headerUnits->storeUnit(path, std::move(built));
     }
 
-    // Token normal
-    outputTokens_.push_back(token);
-    advanceToken();
-    ++stats_.tokensProcessed;
+    for (const MacroDefinition& macro : unit->macros) {
+        defineMacro(macro);
+    }
+    outputTokens_.insert(outputTokens_.end(), unit->tokens.begin(), unit->tokens.end());
+    moduleDependencies_.imports.push_back(isSystem ? "<" + includeName + ">" : "\"" + includeName + "\"");
+    ++stats_.headerUnitImports;
+    return true;
 }
 
-void Preprocessor::processDirective() {
-    advanceToken(); // Consumir #
+bool Preprocessor::preprocessIsolated(uint32_t fileId, std::vector<lexer::Token>& tokens,
+                                      std::vector<MacroDefinition>& macros) {
+    const diagnostics::SourceFile* file = diagEngine_.sourceManager()->getFile(fileId);
+    PreprocessorConfig config = config_;
+    config.identifiers = identifiers_;
+    config.headerUnits.reset();
+    Preprocessor isolated(diagEngine_, config);
+    isolated.applyCommandLineMacros(commandLineDefines_, commandLineUndefines_);
+
+    // Lo que ya estaba definido antes del header no se exporta
+    std::unordered_map<const lexer::IdentifierInfo*, uint64_t> inherited;
+    for (const auto& [name, macro] : isolated.macros_) {
+        inherited.emplace(name, macro.fingerprint);
+    }
 
-    if (isAtEnd()) {
-        reportError("directiva de preprocesador incompleta", currentToken().getLocation());
-        return;
+    size_t errors = diagEngine_.errorCount();
+    lexer::LexerConfig lexerConfig;
+    lexerConfig.fileId = fileId;
+    lexerConfig.identifiers = identifiers_;
+    lexer::Lexer lexer(file->text(), diagEngine_, lexerConfig);
+    tokens = isolated.process(lexer);
+    if (diagEngine_.errorCount() != errors || !isolated.includeGraph().empty()) {
+        return false;
     }
 
-    const lexer::Token& directiveToken = currentToken();
-    if (directiveToken.getType() != lexer::TokenType::IDENTIFIER) {
-        reportError("se esperaba nombre de directiva", directiveToken.getLocation());
-        skipToEndOfLine();
+    for (const auto& [name, macro] : isolated.macros_) {
+        auto it = inherited.find(name);
+        if (it == inherited.end() || it->second != macro.fingerprint) {
+            macros.push_back(macro);
+        }
+    }
+    return true;
+}
+
+void Preprocessor::enterIncludedFile(uint32_t fileId, const std::string& includeName, bool isSystem) {
+    const auto& sourceManager = diagEngine_.sourceManager();
+    const diagnostics::SourceFile* file = sourceManager->getFile(fileId);
+    if (!file) {
         return;
     }
+    enteredFiles_.insert(file->canonicalId);
+
+    IncludeState& state = includeStack_.emplace_back(includeName, isSystem, includeStack_.size() + 1);
+    state.fileId = fileId;
+    state.conditionalDepth = conditionalStack_.size();
+
+    // Coste por header, con los que incluye descontados en el tiempo propio;
+    // la memoria es el texto que el SourceManager mantiene cargado
+    TimingProfiler* profiler = TimingProfiler::active();
+    state.timer = std::make_unique<AutoTimer>(profiler, CompilationPhase::HeaderInclusion,
+                                              profiler ? file->path.string() : std::string());
+    state.timer->recordMemoryUsage(file->text().size());
+
+    // El escaneo de dependencias solo tokeniza las directivas del archivo
+    std::string_view text = file->text();
+    if (config_.dependencyScan) {
+        state.minimizedText = std::make_unique<std::string>(PreprocessorUtils::minimizeToDirectives(text));
+        text = *state.minimizedText;
+    }
 
-    std::string directive = directiveToken.getLexeme();
-    advanceToken();
+    lexer::LexerConfig lexerConfig;
+    lexerConfig.fileId = fileId;
+    lexerConfig.identifiers = identifiers_;
+    state.lexer = std::make_unique<lexer::Lexer>(text, diagEngine_, lexerConfig);
+    tokenSource_ = state.lexer.get();
 
-    if (directive == "include") {
-        processInclude();
-    } else if (directive == "define") {
-        processDefine();
-    } else if (directive == "undef") {
-        processUndef();
-    } else if (directive == "ifdef") {
-        processIfdef(true);
-    } else if (directive == "ifndef") {
-        processIfdef(false);
-    } else if (directive == "if") {
-        processIf();
-    } else if (directive == "else") {
-        processElseOrElif();
-    } else if (directive == "elif") {
-        processElseOrElif();
-    } else if (directive == "endif") {
-        processEndif();
-    } else if (directive == "pragma") {
-        processPragma();
-    } else if (directive == "line") {
-        processLine();
-    } else if (directive == "error") {
-        processDiagnostic(true);
-    } else if (directive == "warning") {
-        processDiagnostic(false);
-    } else {
-        reportWarning("directiva de preprocesador desconocida: " + directive,
-                     directiveToken.getLocation());
-        skipToEndOfLine();
-    }
+    guardStates_.emplace_back();
+    guardStates_.back().fileId = fileId;
 }
 
-// === PROCESAMIENTO DE DIRECTIVAS ===
+void Preprocessor::leaveIncludedFile() {
+    IncludeState& included = includeStack_.back();
+    if (conditionalStack_.size() > included.conditionalDepth) {
+        reportError("#if sin #endif al final de " + included.filename, currentToken().getLocation());
+        conditionalStack_.resize(included.conditionalDepth);
+    }
 
-void Preprocessor::processInclude() {
-    // Implementación simplificada de #include
-    auto tokens = getTokensUntilEndOfLine();
+    MultipleIncludeState state = guardStates_.back();
+    guardStates_.pop_back();
+    bool guarded = state.phase == MultipleIncludeState::Phase::AfterGuard && state.guardMacro;
+    if (guarded || state.pragmaOnce) {
+        diagEngine_.sourceManager()->recordMultipleIncludeInfo(
+            state.fileId, guarded ? std::string(state.guardMacro->name()) : std::string(), state.pragmaOnce);
+    }
 
-    if (tokens.empty()) {
-        reportError("#include sin archivo especificado", currentToken().getLocation());
+    includeStack_.pop_back();
+    tokenSource_ = includeStack_.empty() ? mainSource_ : includeStack_.back().lexer.get();
+}
+
+void Preprocessor::noteNonGuardContent() {
+    if (guardStates_.empty()) {
         return;
     }
 
-    // Aquí iría la lógica real de inclusión de archivos
-    // Por simplicidad, solo contamos la directiva
-    ++stats_.includesProcessed;
+    MultipleIncludeState& state = guardStates_.back();
+    if (state.phase == MultipleIncludeState::Phase::Start ||
+        state.phase == MultipleIncludeState::Phase::AfterGuard) {
+        state.phase = MultipleIncludeState::Phase::Invalid;
+    }
 }
 
 void Preprocessor::processDefine() {
-    if (isAtEnd()) {
+    if (isAtEnd() || currentToken().isAtStartOfLine()) {
         reportError("#define incompleto", currentToken().getLocation());
         return;
     }
@@ -211,14 +1367,22 @@ void Preprocessor::processDefine() {
     bool isFunctionLike = false;
     std::vector<std::string> parameters;
 
-    if (!isAtEnd() && currentToken().getType() == lexer::TokenType::LEFT_PAREN) {
+    // "#define F(x)" es de función; "#define F (x)" es de objeto
+    bool isVariadic = false;
+    if (!isAtEnd() && !currentToken().isAtStartOfLine() &&
+        currentToken().getType() == lexer::TokenType::LEFT_PAREN &&
+        !(currentToken().flags() & lexer::TOKEN_FLAG_LEADING_SPACE)) {
         isFunctionLike = true;
         advanceToken(); // Consumir (
 
         // Parsear parámetros
-        while (!isAtEnd() && currentToken().getType() != lexer::TokenType::RIGHT_PAREN) {
+        while (!isAtEnd() && !currentToken().isAtStartOfLine() &&
+               currentToken().getType() != lexer::TokenType::RIGHT_PAREN) {
             if (currentToken().getType() == lexer::TokenType::IDENTIFIER) {
                 parameters.push_back(currentToken().getLexeme());
+            } else if (currentToken().getType() == lexer::TokenType::ELLIPSIS) {
+                isVariadic = true;
+                parameters.push_back("__VA_ARGS__");
             }
             advanceToken();
 
@@ -235,14 +1399,14 @@ void Preprocessor::processDefine() {
     // Obtener cuerpo de la macro
     auto bodyTokens = getTokensUntilEndOfLine();
 
-    MacroDefinition macro(macroName, bodyTokens, isFunctionLike, false);
+    MacroDefinition macro(macroName, bodyTokens, isFunctionLike, isVariadic);
     macro.parameters = parameters;
 
     defineMacro(macro);
 }
 
 void Preprocessor::processUndef() {
-    if (isAtEnd()) {
+    if (isAtEnd() || currentToken().isAtStartOfLine()) {
         reportError("#undef sin nombre de macro", currentToken().getLocation());
         return;
     }
@@ -259,9 +1423,11 @@ void Preprocessor::processUndef() {
 }
 
 void Preprocessor::processIfdef(bool checkDefined) {
-    if (isAtEnd()) {
+    if (isAtEnd() || currentToken().isAtStartOfLine()) {
         reportError((checkDefined ? "#ifdef" : "#ifndef") + std::string(" sin nombre"),
                    currentToken().getLocation());
+        pushConditional(false); // Mantener el emparejamiento con #endif
+        noteNonGuardContent();
         return;
     }
 
@@ -272,33 +1438,131 @@ void Preprocessor::processIfdef(bool checkDefined) {
         return;
     }
 
-    bool isDefined = isMacroDefined(nameToken.getLexeme());
+    lexer::IdentifierInfo* name = identifierOf(nameToken);
+    bool isDefined = isMacroDefined(name);
     bool condition = checkDefined ? isDefined : !isDefined;
 
-    conditionalStack_.push_back(condition);
-    ++stats_.conditionalsProcessed;
+    // #ifndef como primer contenido del archivo: candidato a guarda de inclusión
+    if (!checkDefined && !guardStates_.empty() &&
+        guardStates_.back().phase == MultipleIncludeState::Phase::Start) {
+        MultipleIncludeState& state = guardStates_.back();
+        state.phase = MultipleIncludeState::Phase::InGuard;
+        state.guardMacro = name;
+        state.guardDepth = conditionalStack_.size();
+    }
+
+    pushConditional(condition);
 
     advanceToken();
 }
 
 void Preprocessor::processIf() {
-    // Implementación simplificada
+    diagnostics::SourceLocation location = currentToken().getLocation();
     auto expression = getTokensUntilEndOfLine();
-    bool condition = !expression.empty(); // Simplificado
 
-    conditionalStack_.push_back(condition);
+    // Dentro de una sección inactiva la expresión no se evalúa
+    bool condition = isInActiveConditionalSection() &&
+                     evaluateConditionalExpression(expression, location);
+    pushConditional(condition);
+}
+
+void Preprocessor::pushConditional(bool condition) {
+    ConditionalFrame frame;
+    frame.parentActive = isInActiveConditionalSection();
+    frame.active = frame.parentActive && condition;
+    frame.branchTaken = condition;
+    conditionalStack_.push_back(frame);
     ++stats_.conditionalsProcessed;
 }
 
-void Preprocessor::processElseOrElif() {
-    // Implementación simplificada
+void Preprocessor::processElseOrElif(bool isElif) {
+    diagnostics::SourceLocation location = currentToken().getLocation();
     if (conditionalStack_.empty()) {
-        reportError("#else/#elif sin #if correspondiente", currentToken().getLocation());
+        reportError("#else/#elif sin #if correspondiente", location);
+        return;
+    }
+
+    // Un #else de la guarda significa que el archivo tiene contenido fuera de ella
+    if (!guardStates_.empty() && guardStates_.back().phase == MultipleIncludeState::Phase::InGuard &&
+        conditionalStack_.size() == guardStates_.back().guardDepth + 1) {
+        guardStates_.back().phase = MultipleIncludeState::Phase::Invalid;
+    }
+
+    if (conditionalStack_.back().seenElse) {
+        reportError(isElif ? "#elif tras #else" : "#else duplicado", location);
+    }
+
+    if (!isElif) {
+        ConditionalFrame& frame = conditionalStack_.back();
+        frame.active = frame.parentActive && !frame.branchTaken;
+        frame.branchTaken = true;
+        frame.seenElse = true;
+        return;
+    }
+
+    // #elif solo se evalúa si ninguna rama anterior fue verdadera
+    auto expression = getTokensUntilEndOfLine();
+    ConditionalFrame& frame = conditionalStack_.back();
+    bool condition = frame.parentActive && !frame.branchTaken &&
+                     evaluateConditionalExpression(expression, location);
+    frame.active = condition;
+    frame.branchTaken = frame.branchTaken || condition;
+}
+
+void Preprocessor::processModuleDeclaration() {
+    noteNonGuardContent();
+
+    std::vector<lexer::Token> tokens;
+    auto take = [&]() {
+        tokens.push_back(currentToken());
+        advanceToken();
+    };
+    auto emit = [&]() {
+        if (!config_.dependencyScan) {
+            outputTokens_.insert(outputTokens_.end(), tokens.begin(), tokens.end());
+            stats_.tokensProcessed += tokens.size();
+        }
+    };
+
+    // "export" solo abre una declaración de módulo si le sigue module o import
+    bool isExported = currentToken().getType() == lexer::TokenType::EXPORT;
+    take();
+    if (isExported && (isAtEnd() || (currentToken().getType() != lexer::TokenType::MODULE &&
+                                     currentToken().getType() != lexer::TokenType::IMPORT))) {
+        emit();
+        return;
+    }
+
+    lexer::TokenType kind = isExported ? currentToken().getType() : tokens.front().getType();
+    if (isExported) {
+        take();
+    }
+
+    // El nombre llega hasta ';' (puede ocupar varias líneas, nunca cruzar una directiva)
+    std::string name;
+    while (!isAtEnd() && currentToken().getType() != lexer::TokenType::SEMICOLON &&
+           !(currentToken().isAtStartOfLine() && currentToken().getType() == lexer::TokenType::HASH)) {
+        name += currentToken().getLexeme();
+        take();
+    }
+    if (!isAtEnd() && currentToken().getType() == lexer::TokenType::SEMICOLON) {
+        take();
+    }
+    emit();
+
+    // "module;" abre el fragmento global y "module :private;" no depende de nada
+    if (name.empty() || name == ":private") {
         return;
     }
 
-    // Cambiar el estado del último condicional
-    conditionalStack_.back() = !conditionalStack_.back();
+    if (kind == lexer::TokenType::IMPORT) {
+        moduleDependencies_.imports.push_back(name);
+    } else if (isExported) {
+        moduleDependencies_.moduleName = name;
+    } else {
+        // Una unidad de implementación importa implícitamente su interfaz
+        moduleDependencies_.imports.push_back(name);
+    }
 }
 
 void Preprocessor::processEndif() {
@@ -308,11 +1572,19 @@ void Preprocessor::processEndif() {
     }
 
     conditionalStack_.pop_back();
+
+    if (!guardStates_.empty() && guardStates_.back().phase == MultipleIncludeState::Phase::InGuard &&
+        conditionalStack_.size() == guardStates_.back().guardDepth) {
+        guardStates_.back().phase = MultipleIncludeState::Phase::AfterGuard;
+    }
 }
 
 void Preprocessor::processPragma() {
-    // Implementación simplificada - solo saltar la línea
-    skipToEndOfLine();
+    auto tokens = getTokensUntilEndOfLine();
+
+    if (!tokens.empty() && tokens[0].getLexeme() == "once" && !guardStates_.empty()) {
+        guardStates_.back().pragmaOnce = true;
+    }
 }
 
 void Preprocessor::processLine() {
@@ -333,10 +1605,461 @@ void Preprocessor::processDiagnostic(bool isError) {
 
 // === EXPANSIÓN DE MACROS ===
 
-std::vector<lexer::Token> Preprocessor::expandMacro(const MacroDefinition& macro,
-                                                   const std::vector<std::vector<lexer::Token>>& arguments) {
-    // Implementación simplificada
-    return macro.body;
+void Preprocessor::expandMacro(const lexer::IdentifierInfo* name, const MacroDefinition& macro,
+                               const std::vector<std::vector<lexer::Token>>& arguments,
+                               const diagnostics::SourceLocation& /*location*/,
+                               std::vector<lexer::Token>& output) {
+    ++stats_.macrosExpanded;
+
+    // Al evaluar un #if la memo ocultaría los nombres que lee la expansión
+    bool memoizable = !macro.isFunctionLike && !conditionReads_;
+    if (memoizable) {
+        auto it = expansionMemo_.find(name);
+        if (it != expansionMemo_.end()) {
+            ++stats_.expansionCacheHits;
+            output.insert(output.end(), it->second.begin(), it->second.end());
+            return;
+        }
+    }
+
+    // Sin parámetros ni operadores la lista de reemplazo se reescanea tal cual
+    std::vector<lexer::Token> substituted;
+    const std::vector<lexer::Token>* replacement = &macro.body;
+    if (macro.isFunctionLike || macro.hasOperators) {
+        substituted = substituteArguments(macro, arguments);
+        replacement = &substituted;
+    }
+
+    std::vector<lexer::Token> expansion;
+    activeExpansions_.push_back(name);
+    memoizingDepth_ += memoizable ? 1 : 0;
+    rescan(*replacement, expansion);
+    memoizingDepth_ -= memoizable ? 1 : 0;
+    activeExpansions_.pop_back();
+
+    output.insert(output.end(), expansion.begin(), expansion.end());
+    if (memoizable) {
+        expansionMemo_.emplace(name, std::move(expansion));
+    }
+}
+
+void Preprocessor::rescan(const std::vector<lexer::Token>& tokens, std::vector<lexer::Token>& output) {
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const lexer::Token& token = tokens[i];
+        if (token.getType() != lexer::TokenType::IDENTIFIER) {
+            output.push_back(token);
+            continue;
+        }
+
+        lexer::IdentifierInfo* name = identifierOf(token);
+        if (memoizingDepth_ > 0) {
+            memoDependencies_.insert(name); // Definirlo más tarde cambiaría la expansión
+        }
+        if (conditionReads_) {
+            recordConditionRead(name);
+        }
+
+        const MacroDefinition* macro = getMacro(name);
+        if (!macro || std::find(activeExpansions_.begin(), activeExpansions_.end(), name) != activeExpansions_.end()) {
+            output.push_back(token);
+            continue;
+        }
+
+        if (!macro->isFunctionLike) {
+            expandMacro(name, *macro, {}, token.getLocation(), output);
+            continue;
+        }
+
+        // Invocaciones cuyos argumentos siguen fuera de la lista no se expanden
+        std::vector<std::vector<lexer::Token>> arguments;
+        std::optional<size_t> end;
+        if (i + 1 < tokens.size() && tokens[i + 1].getType() == lexer::TokenType::LEFT_PAREN) {
+            end = collectArguments(tokens, i + 1, arguments);
+        }
+        if (!end) {
+            output.push_back(token);
+            continue;
+        }
+
+        if (normalizeArguments(*macro, arguments, token.getLocation())) {
+            expandMacro(name, *macro, arguments, token.getLocation(), output);
+        }
+        i = *end - 1;
+    }
+}
+
+std::vector<lexer::Token> Preprocessor::substituteArguments(
+    const MacroDefinition& macro, const std::vector<std::vector<lexer::Token>>& arguments) {
+
+    const std::vector<lexer::Token>& body = macro.body;
+    std::vector<lexer::Token> result;
+    result.reserve(body.size());
+
+    // Cada argumento se expande como mucho una vez
+    std::vector<std::optional<std::vector<lexer::Token>>> expandedArguments(arguments.size());
+
+    auto parameterAt = [&](size_t index) {
+        return index < macro.parameterIndices.size() ? macro.parameterIndices[index] : -1;
+    };
+    auto isPasteOperand = [&](size_t index) {
+        return (index > 0 && body[index - 1].getType() == lexer::TokenType::HASH_HASH) ||
+               (index + 1 < body.size() && body[index + 1].getType() == lexer::TokenType::HASH_HASH);
+    };
+
+    for (size_t i = 0; i < body.size(); ++i) {
+        const lexer::Token& token = body[i];
+
+        // #param
+        if (macro.isFunctionLike && token.getType() == lexer::TokenType::HASH &&
+            i + 1 < body.size() && parameterAt(i + 1) >= 0) {
+            result.push_back(stringifyTokens(arguments[parameterAt(i + 1)], token.getLocation()));
+            ++i;
+            continue;
+        }
+
+        // izquierda ## derecha: el resultado se vuelve a tokenizar
+        if (token.getType() == lexer::TokenType::HASH_HASH && i + 1 < body.size()) {
+            int rightParameter = parameterAt(i + 1);
+            std::vector<lexer::Token> right = rightParameter >= 0
+                ? arguments[rightParameter] : std::vector<lexer::Token>{body[i + 1]};
+
+            if (!result.empty() && !right.empty()) {
+                lexer::Token left = std::move(result.back());
+                result.pop_back();
+                auto pasted = lexText(left.getLexeme() + right.front().getLexeme(), left.getLocation());
+                result.insert(result.end(), pasted.begin(), pasted.end());
+                result.insert(result.end(), right.begin() + 1, right.end());
+            } else {
+                result.insert(result.end(), right.begin(), right.end());
+            }
+            ++i;
+            continue;
+        }
+
+        int parameter = parameterAt(i);
+        if (parameter < 0) {
+            result.push_back(token);
+            continue;
+        }
+
+        // Los operandos de ## se sustituyen sin expandir
+        if (isPasteOperand(i)) {
+            result.insert(result.end(), arguments[parameter].begin(), arguments[parameter].end());
+            continue;
+        }
+
+        auto& expanded = expandedArguments[parameter];
+        if (!expanded) {
+            expanded.emplace();
+            rescan(arguments[parameter], *expanded);
+        }
+        result.insert(result.end(), expanded->begin(), expanded->end());
+    }
+
+    return result;
+}
+
+bool Preprocessor::collectArgumentsFromInput(std::vector<std::vector<lexer::Token>>& arguments) {
+    diagnostics::SourceLocation location = currentToken().getLocation();
+    advanceToken(); // Consumir (
+
+    arguments.assign(1, {});
+    int depth = 0;
+    while (!isAtEnd()) {
+        const lexer::Token& token = currentToken();
+        lexer::TokenType type = token.getType();
+
+        if (type == lexer::TokenType::RIGHT_PAREN && depth == 0) {
+            advanceToken();
+            return true;
+        }
+        if (type == lexer::TokenType::COMMA && depth == 0) {
+            arguments.emplace_back();
+            advanceToken();
+            continue;
+        }
+        if (type == lexer::TokenType::LEFT_PAREN) {
+            ++depth;
+        } else if (type == lexer::TokenType::RIGHT_PAREN) {
+            --depth;
+        }
+        arguments.back().push_back(token);
+        advanceToken();
+    }
+
+    reportError("invocación de macro sin ')' de cierre", location);
+    return false;
+}
+
+bool Preprocessor::normalizeArguments(const MacroDefinition& macro,
+                                      std::vector<std::vector<lexer::Token>>& arguments,
+                                      const diagnostics::SourceLocation& location) {
+    size_t parameterCount = macro.parameters.size();
+
+    // F() aporta un argumento vacío, que para una macro sin parámetros es ninguno
+    if (parameterCount == 0 && arguments.size() == 1 && arguments[0].empty()) {
+        arguments.clear();
+    }
+
+    if (macro.isVariadic && parameterCount > 0) {
+        if (arguments.size() > parameterCount) {
+            // Los argumentos sobrantes forman __VA_ARGS__, separados por comas
+            std::vector<lexer::Token>& variadic = arguments[parameterCount - 1];
+            for (size_t i = parameterCount; i < arguments.size(); ++i) {
+                variadic.emplace_back(lexer::TokenType::COMMA, ",", location);
+                variadic.insert(variadic.end(), arguments[i].begin(), arguments[i].end());
+            }
+            arguments.resize(parameterCount);
+        } else if (arguments.size() + 1 == parameterCount) {
+            arguments.emplace_back(); // __VA_ARGS__ vacío
+        }
+    }
+
+    if (arguments.size() != parameterCount) {
+        reportError("número incorrecto de argumentos para la macro " + macro.name, location);
+        return false;
+    }
+    return true;
+}
+
+void Preprocessor::invalidateExpansionMemo(const lexer::IdentifierInfo* name) {
+    expansionMemo_.erase(name);
+    if (memoDependencies_.count(name) > 0) {
+        expansionMemo_.clear();
+        memoDependencies_.clear();
+    }
+}
+
+std::vector<lexer::Token> Preprocessor::lexText(const std::string& text,
+                                                const diagnostics::SourceLocation& location) {
+    lexer::LexerConfig lexerConfig;
+    lexerConfig.identifiers = identifiers_;
+    lexer::Lexer lexer(text, diagEngine_, lexerConfig);
+
+    std::vector<lexer::Token> tokens;
+    while (true) {
+        lexer::Token token = lexer.getNextToken();
+        if (token.getType() == lexer::TokenType::END_OF_FILE) {
+            break;
+        }
+        // Los tokens se insertan en otra línea: solo se conserva el espacio previo
+        tokens.emplace_back(token.getType(), token.getLexeme(), location, token.getValue());
+        tokens.back().setFlags(token.flags() & lexer::TOKEN_FLAG_LEADING_SPACE);
+        tokens.back().setIdentifierInfo(token.getIdentifierInfo());
+    }
+    return tokens;
+}
+
+bool Preprocessor::evaluateConditionalExpression(const std::vector<lexer::Token>& expression,
+                                                 const diagnostics::SourceLocation& location) {
+    if (expression.empty()) {
+        reportError("#if sin expresión", location);
+        return false;
+    }
+
+    // Texto sin archivo (-D, pegados) no tiene posición estable
+    uint32_t fileId = location.fileId();
+    if (fileId == 0) {
+        return computeConditionalExpression(expression, location).value_or(false);
+    }
+
+    uint64_t expressionHash = hashExpression(expression);
+    for (const auto& cached : conditionCache_->variants(fileId, location.offset())) {
+        if (cached->expressionHash == expressionHash && isConditionCurrent(*cached, fileId)) {
+            ++stats_.conditionCacheHits;
+            return cached->value;
+        }
+    }
+
+    auto compiled = std::make_shared<CompiledCondition>();
+    compiled->expressionHash = expressionHash;
+    conditionReads_ = compiled.get();
+    std::optional<bool> value = computeConditionalExpression(expression, location);
+    conditionReads_ = nullptr;
+
+    // Las expresiones con errores no se guardan: el error se repite en cada evaluación
+    if (!value) {
+        return false;
+    }
+    compiled->value = *value;
+    conditionCache_->store(fileId, location.offset(), std::move(compiled));
+    return *value;
+}
+
+bool Preprocessor::isConditionCurrent(const CompiledCondition& condition, uint32_t fileId) {
+    for (const auto& read : condition.macros) {
+        const MacroDefinition* macro = getMacro(identifiers_->find(read.name));
+        if ((macro ? macro->fingerprint : 0) != read.fingerprint) {
+            return false;
+        }
+    }
+    for (const auto& query : condition.includes) {
+        if (hasInclude(query.name, query.isSystem, fileId) != query.found) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Preprocessor::recordConditionRead(const lexer::IdentifierInfo* name) {
+    std::string_view text = name->name();
+    for (const auto& read : conditionReads_->macros) {
+        if (read.name == text) {
+            return;
+        }
+    }
+    const MacroDefinition* macro = getMacro(name);
+    conditionReads_->macros.push_back({std::string(text), macro ? macro->fingerprint : 0});
+}
+
+bool Preprocessor::hasInclude(const std::string& includeName, bool isSystem, uint32_t fileId) {
+    // Las comillas buscan primero junto al archivo que pregunta
+    std::string key = (isSystem ? "<" : "\"") + includeName;
+    if (!isSystem) {
+        key += '\0';
+        key += std::to_string(fileId);
+    }
+    auto it = hasIncludeResults_.find(key);
+    if (it != hasIncludeResults_.end()) {
+        return it->second;
+    }
+    const auto& sourceManager = diagEngine_.sourceManager();
+    bool found = sourceManager && sourceManager->findAndLoadInclude(includeName, fileId, isSystem) != 0;
+    hasIncludeResults_.emplace(std::move(key), found);
+    return found;
+}
+
+std::optional<bool> Preprocessor::computeConditionalExpression(const std::vector<lexer::Token>& expression,
+                                                               const diagnostics::SourceLocation& location) {
+    // defined y __has_include se resuelven antes de expandir: sus operandos no son macros
+    std::vector<lexer::Token> resolved;
+    resolved.reserve(expression.size());
+    for (size_t i = 0; i < expression.size(); ++i) {
+        const lexer::Token& token = expression[i];
+        bool isIdentifier = token.getType() == lexer::TokenType::IDENTIFIER;
+
+        if (isIdentifier && token.getLexeme() == "defined") {
+            size_t next = i + 1;
+            bool parenthesized = next < expression.size() &&
+                                 expression[next].getType() == lexer::TokenType::LEFT_PAREN;
+            next += parenthesized ? 1 : 0;
+
+            if (next >= expression.size() ||
+                (expression[next].getType() != lexer::TokenType::IDENTIFIER && !expression[next].isKeyword())) {
+                reportError("se esperaba nombre de macro tras defined", token.getLocation());
+                return std::nullopt;
+            }
+            lexer::IdentifierInfo* name = identifierOf(expression[next]);
+            if (conditionReads_) {
+                recordConditionRead(name);
+            }
+            bool isDefined = isMacroDefined(name);
+
+            if (parenthesized) {
+                if (next + 1 >= expression.size() ||
+                    expression[next + 1].getType() != lexer::TokenType::RIGHT_PAREN) {
+                    reportError("se esperaba ')' tras defined", token.getLocation());
+                    return std::nullopt;
+                }
+                ++next;
+            }
+
+            resolved.emplace_back(lexer::TokenType::INTEGER_LITERAL, isDefined ? "1" : "0",
+                                  token.getLocation());
+            i = next;
+            continue;
+        }
+
+        if (isIdentifier && token.getLexeme() == "__has_include") {
+            // __has_include("x") o __has_include(<x>)
+            size_t next = i + 1;
+            if (next >= expression.size() || expression[next].getType() != lexer::TokenType::LEFT_PAREN) {
+                reportError("se esperaba '(' tras __has_include", token.getLocation());
+                return std::nullopt;
+            }
+            ++next;
+
+            std::string includeName;
+            bool isSystem = false;
+            if (next < expression.size() && expression[next].getType() == lexer::TokenType::STRING_LITERAL) {
+                const std::string& lexeme = expression[next].getLexeme();
+                includeName = lexeme.substr(1, lexeme.size() >= 2 ? lexeme.size() - 2 : 0);
+                ++next;
+            } else if (next < expression.size() && expression[next].getType() == lexer::TokenType::LESS) {
+                isSystem = true;
+                for (++next; next < expression.size() &&
+                             expression[next].getType() != lexer::TokenType::GREATER; ++next) {
+                    includeName += expression[next].getLexeme();
+                }
+                ++next;
+            }
+
+            if (includeName.empty() || next >= expression.size() ||
+                expression[next].getType() != lexer::TokenType::RIGHT_PAREN) {
+                reportError("argumento de __has_include inválido", token.getLocation());
+                return std::nullopt;
+            }
+
+            bool found = hasInclude(includeName, isSystem, location.fileId());
+            if (conditionReads_) {
+                conditionReads_->includes.push_back({includeName, isSystem, found});
+            }
+            resolved.emplace_back(lexer::TokenType::INTEGER_LITERAL, found ? "1" : "0",
+                                  token.getLocation());
+            i = next;
+            continue;
+        }
+
+        if (isIdentifier && token.getLexeme() == "__has_cpp_attribute") {
+            // __has_cpp_attribute(nombre) o (espacio::nombre): no depende de macros ni de archivos
+            size_t next = i + 1;
+            std::string attribute;
+            if (next < expression.size() && expression[next].getType() == lexer::TokenType::LEFT_PAREN) {
+                for (++next; next < expression.size() &&
+                             expression[next].getType() != lexer::TokenType::RIGHT_PAREN; ++next) {
+                    attribute += expression[next].getLexeme();
+                }
+            }
+            if (attribute.empty() || next >= expression.size()) {
+                reportError("argumento de __has_cpp_attribute inválido", token.getLocation());
+                return std::nullopt;
+            }
+            resolved.emplace_back(lexer::TokenType::INTEGER_LITERAL, std::to_string(cppAttributeVersion(attribute)),
+                                  token.getLocation());
+            i = next;
+            continue;
+        }
+
+        resolved.push_back(token);
+    }
+
+    std::vector<lexer::Token> expanded;
+    rescan(resolved, expanded);
+
+    // El lexer entrega "<<" y ">>" como dos tokens (por las plantillas): unirlos aquí
+    std::vector<lexer::Token> merged;
+    merged.reserve(expanded.size());
+    for (size_t i = 0; i < expanded.size(); ++i) {
+        lexer::TokenType type = expanded[i].getType();
+        bool isAngle = type == lexer::TokenType::LESS || type == lexer::TokenType::GREATER;
+        if (isAngle && i + 1 < expanded.size() && expanded[i + 1].getType() == type &&
+            !(expanded[i + 1].flags() & lexer::TOKEN_FLAG_LEADING_SPACE)) {
+            bool isLeft = type == lexer::TokenType::LESS;
+            merged.emplace_back(isLeft ? lexer::TokenType::LEFT_SHIFT : lexer::TokenType::RIGHT_SHIFT,
+                                isLeft ? "<<" : ">>", expanded[i].getLocation());
+            ++i;
+            continue;
+        }
+        merged.push_back(expanded[i]);
+    }
+
+    ConditionalExpressionEvaluator evaluator(merged);
+    std::optional<intmax_t> value = evaluator.evaluate();
+    if (!value) {
+        reportError(evaluator.error(), location);
+        return std::nullopt;
+    }
+    return *value != 0;
 }
 
 // === FUNCIONES AUXILIARES ===
@@ -344,7 +2067,8 @@ std::vector<lexer::Token> Preprocessor::expandMacro(const MacroDefinition& macro
 std::vector<lexer::Token> Preprocessor::getTokensUntilEndOfLine() {
     std::vector<lexer::Token> result;
 
-    while (!isAtEnd() && currentToken().getType() != lexer::TokenType::END_OF_FILE) {
+    // La línea de la directiva termina en el siguiente token que abre línea
+    while (!isAtEnd() && !currentToken().isAtStartOfLine()) {
         result.push_back(currentToken());
         advanceToken();
     }
@@ -353,27 +2077,37 @@ std::vector<lexer::Token> Preprocessor::getTokensUntilEndOfLine() {
 }
 
 const lexer::Token& Preprocessor::currentToken() const {
+    if (tokenSource_) {
+        return tokenSource_->peekNextToken();
+    }
     if (currentTokenIndex_ >= inputTokens_.size()) {
         static lexer::Token eof(lexer::TokenType::END_OF_FILE, "",
-                               diagnostics::SourceLocation("", 0, 0));
+                               diagnostics::SourceLocation());
         return eof;
     }
     return inputTokens_[currentTokenIndex_];
 }
 
 void Preprocessor::advanceToken() {
+    if (tokenSource_) {
+        tokenSource_->getNextToken();
+        return;
+    }
     if (currentTokenIndex_ < inputTokens_.size()) {
         ++currentTokenIndex_;
     }
 }
 
 bool Preprocessor::isAtEnd() const {
+    if (tokenSource_) {
+        return currentToken().getType() == lexer::TokenType::END_OF_FILE;
+    }
     return currentTokenIndex_ >= inputTokens_.size() ||
            currentToken().getType() == lexer::TokenType::END_OF_FILE;
 }
 
 void Preprocessor::skipToEndOfLine() {
-    while (!isAtEnd() && currentToken().getType() != lexer::TokenType::END_OF_FILE) {
+    while (!isAtEnd() && !currentToken().isAtStartOfLine()) {
         advanceToken();
     }
 }
@@ -399,13 +2133,8 @@ void Preprocessor::initializePredefinedMacros() {
 }
 
 bool Preprocessor::isInActiveConditionalSection() const {
-    // Simplificado - verificar si todos los condicionales son true
-    for (bool condition : conditionalStack_) {
-        if (!condition) {
-            return false;
-        }
-    }
-    return true;
+    // Cada nivel ya incorpora el estado de la sección que lo contiene
+    return conditionalStack_.empty() || conditionalStack_.back().active;
 }
 
 bool Preprocessor::isSkippingTokens() const {
@@ -445,6 +2174,51 @@ std::string PreprocessorUtils::tokensToString(const std::vector<lexer::Token>& t
     return result;
 }
 
+std::string PreprocessorUtils::minimizeToDirectives(std::string_view source) {
+    std::string result;
+    result.reserve(source.size() / 4);
+
+    const char* begin = source.data();
+    const char* end = begin + source.size();
+    const char* p = begin;
+    bool inContentRun = false;
+
+    while (p < end) {
+        const char* lineStart = p;
+        const char* first = lineStart;
+        while (first < end && isHorizontalSpace(*first)) {
+            ++first;
+        }
+
+        bool isDirective = first < end && *first == '#';
+        bool isModuleLine = !isDirective && isModuleDeclarationLine(first, end);
+
+        bool hasContent = false;
+        const char* next = skipLogicalLine(begin, first, end, hasContent);
+
+        if (isDirective || isModuleLine) {
+            // Una declaración de módulo puede continuar en las líneas siguientes hasta ';'
+            while (isModuleLine && next < end &&
+                   std::string_view(lineStart, static_cast<size_t>(next - lineStart)).find(';') == std::string_view::npos) {
+                next = skipLogicalLine(begin, next, end, hasContent);
+            }
+            result.append(lineStart, next);
+            inContentRun = false;
+        } else {
+            // Un ';' por tramo de contenido mantiene la detección exacta de guardas
+            if (hasContent && !inContentRun) {
+                result += ';';
+                inContentRun = true;
+            }
+            result.append(lexer::CharScanner::countNewlines(lineStart, next), '\n');
+        }
+
+        p = next;
+    }
+
+    return result;
+}
+
 std::vector<std::string> PreprocessorUtils::parseMacroParameters(const std::vector<lexer::Token>& tokens) {
     std::vector<std::string> parameters;
 
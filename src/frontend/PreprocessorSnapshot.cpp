@@ -0,0 +1,350 @@
+/**
+ * @file PreprocessorSnapshot.cpp
+ * @brief Serialización de instantáneas del preprocesador
+ */
+
+#include <compiler/frontend/PreprocessorSnapshot.h>
+#include <compiler/frontend/lexer/IdentifierTable.h>
+#include <compiler/common/utils/HashUtils.h>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <system_error>
+#include <thread>
+
+namespace cpp20::compiler::frontend {
+
+namespace {
+
+// Binario little-endian de tamaño fijo; cadenas con prefijo de longitud u32
+constexpr char kSnapshotMagic[8] = {'C', 'P', 'P', 'S', 'N', 'A', 'P', '1'};
+
+class SnapshotWriter {
+public:
+    void u8(uint8_t value) { buffer_.push_back(static_cast<char>(value)); }
+
+    void u16(uint16_t value) { raw(value, 2); }
+    void u32(uint32_t value) { raw(value, 4); }
+    void u64(uint64_t value) { raw(value, 8); }
+
+    void str(const std::string& value) {
+        u32(static_cast<uint32_t>(value.size()));
+        buffer_.append(value);
+    }
+
+    void token(const lexer::Token& token) {
+        const auto& location = token.getLocation();
+        u16(static_cast<uint16_t>(token.getType()));
+        u16(token.flags());
+        u8(token.getIdentifierInfo() ? 1 : 0);
+        str(token.getLexeme());
+        str(token.getValue());
+        u32(location.line());
+        u32(location.column());
+        u32(location.offset());
+        u32(location.fileId());
+    }
+
+    const std::string& buffer() const { return buffer_; }
+
+private:
+    std::string buffer_;
+
+    void raw(uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            buffer_.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+        }
+    }
+};
+
+class SnapshotReader {
+public:
+    explicit SnapshotReader(std::string_view data) : data_(data) {}
+
+    bool ok() const { return ok_; }
+
+    uint8_t u8() { return static_cast<uint8_t>(raw(1)); }
+    uint16_t u16() { return static_cast<uint16_t>(raw(2)); }
+    uint32_t u32() { return static_cast<uint32_t>(raw(4)); }
+    uint64_t u64() { return raw(8); }
+
+    std::string str() {
+        uint32_t size = u32();
+        if (!ok_ || data_.size() - position_ < size) {
+            ok_ = false;
+            return std::string();
+        }
+        std::string value(data_.substr(position_, size));
+        position_ += size;
+        return value;
+    }
+
+    /**
+     * @brief Número de elementos de una lista; cada uno ocupa al menos un byte
+     */
+    uint32_t count() {
+        uint32_t value = u32();
+        if (value > data_.size() - position_) {
+            ok_ = false;
+            return 0;
+        }
+        return value;
+    }
+
+    lexer::Token token(lexer::IdentifierTable& identifiers) {
+        auto type = static_cast<lexer::TokenType>(u16());
+        uint16_t flags = u16();
+        bool hasIdentifier = u8() != 0;
+        std::string lexeme = str();
+        std::string value = str();
+        uint32_t line = u32();
+        uint32_t column = u32();
+        uint32_t offset = u32();
+        uint32_t fileId = u32();
+
+        lexer::Token token(type, lexeme, diagnostics::SourceLocation(line, column, offset, fileId), value);
+        token.setFlags(flags);
+        if (hasIdentifier) {
+            token.setIdentifierInfo(identifiers.get(token.getLexeme()));
+        }
+        return token;
+    }
+
+    bool atEnd() const { return position_ == data_.size(); }
+
+private:
+    std::string_view data_;
+    size_t position_ = 0;
+    bool ok_ = true;
+
+    uint64_t raw(int bytes) {
+        if (!ok_ || data_.size() - position_ < static_cast<size_t>(bytes)) {
+            ok_ = false;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(static_cast<uint8_t>(data_[position_ + i])) << (8 * i);
+        }
+        position_ += bytes;
+        return value;
+    }
+};
+
+bool isHorizontalSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\v' || c == '\f' || c == '\r';
+}
+
+} // namespace
+
+std::string_view PreprocessorSnapshot::prologueOf(std::string_view source) {
+    size_t end = 0;      // Fin de la última línea #include aceptada
+    size_t position = 0;
+
+    while (position < source.size()) {
+        size_t lineEnd = source.find('\n', position);
+        if (lineEnd == std::string_view::npos) {
+            break; // Una última línea sin '\n' no cierra el prólogo
+        }
+
+        std::string_view line = source.substr(position, lineEnd - position);
+        size_t first = 0;
+        while (first < line.size() && isHorizontalSpace(line[first])) {
+            ++first;
+        }
+        line.remove_prefix(first);
+
+        if (!line.empty() && line.back() == '\\') {
+            break; // Las líneas empalmadas se dejan al preprocesador
+        }
+
+        if (line.empty() || line.substr(0, 2) == "//") {
+            // Blanca o comentario: forma parte del prólogo si le sigue otro #include
+        } else if (line[0] == '#') {
+            line.remove_prefix(1);
+            while (!line.empty() && isHorizontalSpace(line.front())) {
+                line.remove_prefix(1);
+            }
+            if (line.substr(0, 7) != "include" || line.find("/*") != std::string_view::npos) {
+                break;
+            }
+            end = lineEnd + 1;
+        } else {
+            break;
+        }
+
+        position = lineEnd + 1;
+    }
+
+    return source.substr(0, end);
+}
+
+uint64_t PreprocessorSnapshot::computeKey(std::string_view prologue, const PreprocessorConfig& config,
+                                          const std::vector<std::string>& defines,
+                                          const std::vector<std::string>& undefines) {
+    using common::utils::fnv1a64;
+
+    // Separadores que no aparecen en rutas ni en -D para que los campos no se confundan
+    uint64_t hash = fnv1a64(std::string_view(kSnapshotMagic, sizeof(kSnapshotMagic)));
+    hash = fnv1a64(prologue, hash);
+    for (const auto& path : config.includePaths) {
+        hash = fnv1a64("\x01", fnv1a64(path, hash));
+    }
+    for (const auto& path : config.systemIncludePaths) {
+        hash = fnv1a64("\x02", fnv1a64(path, hash));
+    }
+    for (const auto& define : defines) {
+        hash = fnv1a64("\x03", fnv1a64(define, hash));
+    }
+    for (const auto& undefine : undefines) {
+        hash = fnv1a64("\x04", fnv1a64(undefine, hash));
+    }
+    char flags[2] = {config.keepComments ? '1' : '0', config.dependencyScan ? '1' : '0'};
+    return fnv1a64(std::string_view(flags, sizeof(flags)), hash);
+}
+
+std::filesystem::path PreprocessorSnapshot::fileFor(const std::filesystem::path& directory, uint64_t key) {
+    static constexpr char kHexDigits[] = "0123456789abcdef";
+    std::string name(16, '0');
+    for (int i = 15; i >= 0; --i, key >>= 4) {
+        name[i] = kHexDigits[key & 0xf];
+    }
+    return directory / (name + ".ppsnap");
+}
+
+bool PreprocessorSnapshot::save(const std::filesystem::path& file) const {
+    SnapshotWriter writer;
+    writer.u64(key);
+    writer.u32(prologueLength);
+
+    writer.u32(static_cast<uint32_t>(files.size()));
+    for (const auto& entry : files) {
+        writer.u64(entry.contentHash);
+        writer.str(entry.includeGuard);
+        writer.u8(entry.pragmaOnce ? 1 : 0);
+    }
+
+    writer.u32(static_cast<uint32_t>(includes.size()));
+    for (const auto& record : includes) {
+        writer.u32(record.includerFileId);
+        writer.u32(record.fileId);
+        writer.str(record.name);
+        writer.u8((record.isSystem ? 1 : 0) | (record.skipped ? 2 : 0));
+    }
+
+    writer.u32(static_cast<uint32_t>(macros.size()));
+    for (const auto& macro : macros) {
+        writer.str(macro.name);
+        writer.u8((macro.isFunctionLike ? 1 : 0) | (macro.isVariadic ? 2 : 0));
+        writer.u32(static_cast<uint32_t>(macro.parameters.size()));
+        for (const auto& parameter : macro.parameters) {
+            writer.str(parameter);
+        }
+        writer.u32(static_cast<uint32_t>(macro.body.size()));
+        for (const auto& token : macro.body) {
+            writer.token(token);
+        }
+    }
+
+    writer.u32(static_cast<uint32_t>(tokens.size()));
+    for (const auto& token : tokens) {
+        writer.token(token);
+    }
+
+    // Varias unidades pueden escribir la misma clave a la vez: temporal único por hilo
+    std::filesystem::path temporary = file;
+    temporary += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()) ^
+                                      static_cast<size_t>(std::chrono::steady_clock::now()
+                                                              .time_since_epoch().count())) + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        out.write(kSnapshotMagic, sizeof(kSnapshotMagic));
+        out.write(writer.buffer().data(), static_cast<std::streamsize>(writer.buffer().size()));
+        if (!out) {
+            out.close();
+            std::error_code ignored;
+            std::filesystem::remove(temporary, ignored);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, file, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+std::optional<PreprocessorSnapshot> PreprocessorSnapshot::load(const std::filesystem::path& file,
+                                                               lexer::IdentifierTable* identifierTable) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in) {
+        return std::nullopt;
+    }
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (data.size() < sizeof(kSnapshotMagic) ||
+        std::string_view(data).substr(0, sizeof(kSnapshotMagic)) !=
+            std::string_view(kSnapshotMagic, sizeof(kSnapshotMagic))) {
+        return std::nullopt;
+    }
+
+    lexer::IdentifierTable& identifiers = identifierTable ? *identifierTable : lexer::IdentifierTable::global();
+    SnapshotReader reader(std::string_view(data).substr(sizeof(kSnapshotMagic)));
+    PreprocessorSnapshot snapshot;
+    snapshot.key = reader.u64();
+    snapshot.prologueLength = reader.u32();
+
+    for (uint32_t i = 0, n = reader.count(); i < n && reader.ok(); ++i) {
+        File entry;
+        entry.contentHash = reader.u64();
+        entry.includeGuard = reader.str();
+        entry.pragmaOnce = reader.u8() != 0;
+        snapshot.files.push_back(std::move(entry));
+    }
+
+    for (uint32_t i = 0, n = reader.count(); i < n && reader.ok(); ++i) {
+        IncludeRecord record;
+        record.includerFileId = reader.u32();
+        record.fileId = reader.u32();
+        record.name = reader.str();
+        uint8_t flags = reader.u8();
+        record.isSystem = (flags & 1) != 0;
+        record.skipped = (flags & 2) != 0;
+        snapshot.includes.push_back(std::move(record));
+    }
+
+    for (uint32_t i = 0, n = reader.count(); i < n && reader.ok(); ++i) {
+        std::string name = reader.str();
+        uint8_t flags = reader.u8();
+        std::vector<std::string> parameters;
+        for (uint32_t p = 0, np = reader.count(); p < np && reader.ok(); ++p) {
+            parameters.push_back(reader.str());
+        }
+        std::vector<lexer::Token> body;
+        for (uint32_t t = 0, nt = reader.count(); t < nt && reader.ok(); ++t) {
+            body.push_back(reader.token(identifiers));
+        }
+        MacroDefinition macro(name, body, (flags & 1) != 0, (flags & 2) != 0);
+        macro.parameters = std::move(parameters);
+        snapshot.macros.push_back(std::move(macro));
+    }
+
+    uint32_t tokenCount = reader.count();
+    snapshot.tokens.reserve(tokenCount);
+    for (uint32_t i = 0; i < tokenCount && reader.ok(); ++i) {
+        snapshot.tokens.push_back(reader.token(identifiers));
+    }
+
+    if (!reader.ok() || !reader.atEnd()) {
+        return std::nullopt;
+    }
+    return snapshot;
+}
+
+} // namespace cpp20::compiler::frontend
@@ -0,0 +1,310 @@
+/**
+ * @file CharScanner.cpp
+ * @brief Escaneo vectorizado (SSE2/AVX2) con selección en tiempo de ejecución
+ */
+
+#include <compiler/frontend/lexer/CharScanner.h>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CPP20_LEXER_HAS_SSE2 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(CPP20_LEXER_HAS_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define CPP20_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CPP20_TARGET_AVX2
+#endif
+
+namespace cpp20::compiler::frontend::lexer {
+
+namespace {
+
+// ============================================================================
+// Implementación escalar (referencia y colas de los bucles vectoriales)
+// ============================================================================
+
+inline bool isIdentifierChar(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           (c >= '0' && c <= '9') || c == '_';
+}
+
+inline bool isWhitespaceChar(unsigned char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+const char* scalarSkipIdentifierChars(const char* p, const char* end) {
+    while (p < end && isIdentifierChar(static_cast<unsigned char>(*p))) ++p;
+    return p;
+}
+
+const char* scalarSkipWhitespace(const char* p, const char* end) {
+    while (p < end && isWhitespaceChar(static_cast<unsigned char>(*p))) ++p;
+    return p;
+}
+
+const char* scalarFindNewline(const char* p, const char* end) {
+    while (p < end && *p != '\n') ++p;
+    return p;
+}
+
+const char* scalarFindBlockCommentEnd(const char* p, const char* end) {
+    for (; p + 1 < end; ++p) {
+        if (p[0] == '*' && p[1] == '/') return p;
+    }
+    return end;
+}
+
+size_t scalarCountNewlines(const char* p, const char* end) {
+    size_t count = 0;
+    for (; p < end; ++p) {
+        count += (*p == '\n');
+    }
+    return count;
+}
+
+inline unsigned countTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+inline unsigned popCount(uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return static_cast<unsigned>(__popcnt(mask));
+#else
+    return static_cast<unsigned>(__builtin_popcount(mask));
+#endif
+}
+
+#ifdef CPP20_LEXER_HAS_SSE2
+
+// ============================================================================
+// SSE2: 16 bytes por iteración
+// ============================================================================
+
+// Rango [lo, hi] con comparaciones con signo: los bytes >= 0x80 son negativos
+// y quedan fuera de cualquier rango ASCII.
+inline __m128i inRange16(__m128i v, char lo, char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                         _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(hi + 1)), v));
+}
+
+inline uint32_t identifierMask16(__m128i v) {
+    __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    __m128i ident = _mm_or_si128(inRange16(lower, 'a', 'z'), inRange16(v, '0', '9'));
+    ident = _mm_or_si128(ident, _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+    return static_cast<uint32_t>(_mm_movemask_epi8(ident));
+}
+
+inline uint32_t whitespaceMask16(__m128i v) {
+    __m128i ws = _mm_or_si128(inRange16(v, '\t', '\r'), _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+    return static_cast<uint32_t>(_mm_movemask_epi8(ws));
+}
+
+const char* sse2SkipIdentifierChars(const char* p, const char* end) {
+    for (; end - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        uint32_t stop = ~identifierMask16(v) & 0xFFFFu;
+        if (stop) return p + countTrailingZeros(stop);
+    }
+    return scalarSkipIdentifierChars(p, end);
+}
+
+const char* sse2SkipWhitespace(const char* p, const char* end) {
+    for (; end - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        uint32_t stop = ~whitespaceMask16(v) & 0xFFFFu;
+        if (stop) return p + countTrailingZeros(stop);
+    }
+    return scalarSkipWhitespace(p, end);
+}
+
+const char* sse2FindNewline(const char* p, const char* end) {
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; end - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        uint32_t hit = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, newline)));
+        if (hit) return p + countTrailingZeros(hit);
+    }
+    return scalarFindNewline(p, end);
+}
+
+const char* sse2FindBlockCommentEnd(const char* p, const char* end) {
+    const __m128i star = _mm_set1_epi8('*');
+    const __m128i slash = _mm_set1_epi8('/');
+    for (; end - p >= 17; p += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 1));
+        __m128i both = _mm_and_si128(_mm_cmpeq_epi8(v, star), _mm_cmpeq_epi8(next, slash));
+        uint32_t hit = static_cast<uint32_t>(_mm_movemask_epi8(both));
+        if (hit) return p + countTrailingZeros(hit);
+    }
+    return scalarFindBlockCommentEnd(p, end);
+}
+
+size_t sse2CountNewlines(const char* p, const char* end) {
+    const __m128i newline = _mm_set1_epi8('\n');
+    size_t count = 0;
+    for (; end - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        count += popCount(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, newline))));
+    }
+    return count + scalarCountNewlines(p, end);
+}
+
+// ============================================================================
+// AVX2: 32 bytes por iteración
+// ============================================================================
+
+CPP20_TARGET_AVX2 inline __m256i inRange32(__m256i v, char lo, char hi) {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(static_cast<char>(lo - 1))),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), v));
+}
+
+CPP20_TARGET_AVX2 const char* avx2SkipIdentifierChars(const char* p, const char* end) {
+    for (; end - p >= 32; p += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+        __m256i ident = _mm256_or_si256(inRange32(lower, 'a', 'z'), inRange32(v, '0', '9'));
+        ident = _mm256_or_si256(ident, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')));
+        uint32_t stop = ~static_cast<uint32_t>(_mm256_movemask_epi8(ident));
+        if (stop) return p + countTrailingZeros(stop);
+    }
+    return sse2SkipIdentifierChars(p, end);
+}
+
+CPP20_TARGET_AVX2 const char* avx2SkipWhitespace(const char* p, const char* end) {
+    for (; end - p >= 32; p += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i ws = _mm256_or_si256(inRange32(v, '\t', '\r'),
+                                     _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')));
+        uint32_t stop = ~static_cast<uint32_t>(_mm256_movemask_epi8(ws));
+        if (stop) return p + countTrailingZeros(stop);
+    }
+    return sse2SkipWhitespace(p, end);
+}
+
+CPP20_TARGET_AVX2 const char* avx2FindNewline(const char* p, const char* end) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    for (; end - p >= 32; p += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        uint32_t hit = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, newline)));
+        if (hit) return p + countTrailingZeros(hit);
+    }
+    return sse2FindNewline(p, end);
+}
+
+CPP20_TARGET_AVX2 const char* avx2FindBlockCommentEnd(const char* p, const char* end) {
+    const __m256i star = _mm256_set1_epi8('*');
+    const __m256i slash = _mm256_set1_epi8('/');
+    for (; end - p >= 33; p += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 1));
+        __m256i both = _mm256_and_si256(_mm256_cmpeq_epi8(v, star), _mm256_cmpeq_epi8(next, slash));
+        uint32_t hit = static_cast<uint32_t>(_mm256_movemask_epi8(both));
+        if (hit) return p + countTrailingZeros(hit);
+    }
+    return sse2FindBlockCommentEnd(p, end);
+}
+
+CPP20_TARGET_AVX2 size_t avx2CountNewlines(const char* p, const char* end) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    size_t count = 0;
+    for (; end - p >= 32; p += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        count += popCount(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, newline))));
+    }
+    return count + sse2CountNewlines(p, end);
+}
+
+bool cpuSupportsAVX2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) return false; // Estado YMM habilitado por el SO
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // CPP20_LEXER_HAS_SSE2
+
+// ============================================================================
+// Selección de implementación
+// ============================================================================
+
+struct ScanFunctions {
+    const char* (*skipIdentifierChars)(const char*, const char*);
+    const char* (*skipWhitespace)(const char*, const char*);
+    const char* (*findNewline)(const char*, const char*);
+    const char* (*findBlockCommentEnd)(const char*, const char*);
+    size_t (*countNewlines)(const char*, const char*);
+    const char* name;
+};
+
+ScanFunctions selectScanFunctions() {
+#ifdef CPP20_LEXER_HAS_SSE2
+    if (cpuSupportsAVX2()) {
+        return {avx2SkipIdentifierChars, avx2SkipWhitespace, avx2FindNewline,
+                avx2FindBlockCommentEnd, avx2CountNewlines, "avx2"};
+    }
+    return {sse2SkipIdentifierChars, sse2SkipWhitespace, sse2FindNewline,
+            sse2FindBlockCommentEnd, sse2CountNewlines, "sse2"};
+#else
+    return {scalarSkipIdentifierChars, scalarSkipWhitespace, scalarFindNewline,
+            scalarFindBlockCommentEnd, scalarCountNewlines, "scalar"};
+#endif
+}
+
+const ScanFunctions& scanFunctions() {
+    static const ScanFunctions functions = selectScanFunctions();
+    return functions;
+}
+
+} // namespace
+
+// ============================================================================
+// CharScanner - Implementación
+// ============================================================================
+
+const char* CharScanner::skipIdentifierChars(const char* begin, const char* end) {
+    return scanFunctions().skipIdentifierChars(begin, end);
+}
+
+const char* CharScanner::skipWhitespace(const char* begin, const char* end) {
+    return scanFunctions().skipWhitespace(begin, end);
+}
+
+const char* CharScanner::findNewline(const char* begin, const char* end) {
+    return scanFunctions().findNewline(begin, end);
+}
+
+const char* CharScanner::findBlockCommentEnd(const char* begin, const char* end) {
+    return scanFunctions().findBlockCommentEnd(begin, end);
+}
+
+size_t CharScanner::countNewlines(const char* begin, const char* end) {
+    return scanFunctions().countNewlines(begin, end);
+}
+
+const char* CharScanner::implementationName() {
+    return scanFunctions().name;
+}
+
+} // namespace cpp20::compiler::frontend::lexer
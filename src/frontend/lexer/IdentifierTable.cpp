@@ -0,0 +1,69 @@
+/**
+ * @file IdentifierTable.cpp
+ * @brief Implementación de la tabla de identificadores internados
+ */
+
+#include <compiler/frontend/lexer/IdentifierTable.h>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <new>
+
+namespace cpp20::compiler::frontend::lexer {
+
+IdentifierTable::IdentifierTable() = default;
+
+IdentifierTable::~IdentifierTable() = default;
+
+IdentifierTable& IdentifierTable::global() {
+    static IdentifierTable table;
+    return table;
+}
+
+IdentifierInfo* IdentifierTable::get(std::string_view name) {
+    size_t hash = std::hash<std::string_view>{}(name);
+    Shard& shard = shardFor(hash);
+
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.entries.find(name);
+        if (it != shard.entries.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.entries.find(name);
+    if (it != shard.entries.end()) {
+        return it->second; // Otro hilo lo internó entre ambos locks
+    }
+
+    char* text = static_cast<char*>(shard.pool.allocate(name.size() + 1, 1));
+    std::memcpy(text, name.data(), name.size());
+    text[name.size()] = '\0';
+    std::string_view stored(text, name.size());
+
+    // IdentifierInfo es trivialmente destructible: basta con liberar la arena
+    void* memory = shard.pool.allocate(sizeof(IdentifierInfo), alignof(IdentifierInfo));
+    IdentifierInfo* info = new (memory) IdentifierInfo(stored, TokenUtils::getKeywordType(stored));
+    shard.entries.emplace(stored, info);
+    return info;
+}
+
+IdentifierInfo* IdentifierTable::find(std::string_view name) const {
+    const Shard& shard = shardFor(std::hash<std::string_view>{}(name));
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.entries.find(name);
+    return it != shard.entries.end() ? it->second : nullptr;
+}
+
+size_t IdentifierTable::size() const {
+    size_t total = 0;
+    for (const Shard& shard : shards_) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        total += shard.entries.size();
+    }
+    return total;
+}
+
+} // namespace cpp20::compiler::frontend::lexer
@@ -13,13 +13,10 @@
  * - Estadísticas detalladas de procesamiento léxico
  * - Sistema de recuperación de errores con ubicación precisa
  *
- * Las fases de traducción implementadas son:
- * 1. Codificación física del archivo fuente
- * 2. Eliminación de caracteres de control
- * 3. Concatenación de líneas lógicas
- * 4. Reemplazo de trigraphs
- * 5. Eliminación de espacios y comentarios
- * 6. Tokenización y evaluación de preprocesador
+ * Las fases de traducción no se materializan: el cursor de caracteres
+ * salta caracteres de control y continuaciones de línea, decodifica
+ * trigraphs y trata los comentarios como espacio en blanco mientras lee.
+ * Los tokens se producen bajo demanda con getNextToken().
  *
  * @author Equipo de desarrollo del compilador C++20
  * @version 1.0
@@ -27,23 +24,236 @@
  */
 
 #include <compiler/frontend/lexer/Lexer.h>
+#include <compiler/frontend/lexer/CharScanner.h>
+#include <compiler/frontend/lexer/IdentifierTable.h>
+#include <compiler/frontend/lexer/KeywordTable.h>
+#include <compiler/frontend/lexer/TokenBuffer.h>
+#include <compiler/common/utils/ThreadPool.h>
 #include <algorithm>
 #include <cctype>
-#include <sstream>
+#include <future>
 #include <iostream>
 
 namespace cpp20::compiler::frontend::lexer {
 
+namespace {
+
+/**
+ * @brief Carácter que representa un trigraph "??x" (0 si no lo es)
+ */
+char trigraphReplacement(char c) {
+    switch (c) {
+        case '=': return '#';
+        case '/': return '\\';
+        case '\'': return '^';
+        case '(': return '[';
+        case ')': return ']';
+        case '!': return '|';
+        case '<': return '{';
+        case '>': return '}';
+        case '-': return '~';
+        default: return '\0';
+    }
+}
+
+/**
+ * @brief Caracteres de control que se descartan (todos salvo \n, \t y \f)
+ */
+bool isDiscardedControlChar(char c) {
+    return c >= 0 && c < 32 && c != '\n' && c != '\t' && c != '\f';
+}
+
+/**
+ * @brief Posición del siguiente carácter lógico desde pos (ver Lexer::logicalPosition)
+ */
+size_t skipSplices(std::string_view source, size_t pos, bool trigraphs) {
+    while (pos < source.size()) {
+        char c = source[pos];
+
+        if (c == '\\') {
+            // Continuación de línea: \ seguido de \n (o \r\n)
+            if (pos + 1 < source.size() && source[pos + 1] == '\n') {
+                pos += 2;
+                continue;
+            }
+            if (pos + 2 < source.size() && source[pos + 1] == '\r' && source[pos + 2] == '\n') {
+                pos += 3;
+                continue;
+            }
+            return pos;
+        }
+
+        if (c == '?' && trigraphs && pos + 3 < source.size() &&
+            source[pos + 1] == '?' && source[pos + 2] == '/' && source[pos + 3] == '\n') {
+            pos += 4; // ??/ como continuación de línea
+            continue;
+        }
+
+        if (isDiscardedControlChar(c)) {
+            ++pos;
+            continue;
+        }
+
+        return pos;
+    }
+    return pos;
+}
+
+/**
+ * @brief Decodificar el carácter en pos (ver Lexer::decodeAt)
+ */
+size_t decodeChar(std::string_view source, size_t pos, bool trigraphs, char& c) {
+    c = source[pos];
+    if (c == '?' && trigraphs && pos + 2 < source.size() && source[pos + 1] == '?') {
+        char replacement = trigraphReplacement(source[pos + 2]);
+        if (replacement != '\0') {
+            c = replacement;
+            return 3;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief El '\n' en pos va precedido de \ o ??/ (y quizá \r): no acaba la línea
+ */
+bool isSplicedNewline(std::string_view source, size_t pos, size_t lineStart, bool trigraphs) {
+    size_t before = pos;
+    if (before > lineStart && source[before - 1] == '\r') --before;
+    return (before > lineStart && source[before - 1] == '\\') ||
+           (trigraphs && before >= lineStart + 3 && source.substr(before - 3, 3) == "?\?/");
+}
+
+bool isIdentifierChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+/**
+ * @brief Pre-escaneo de Lexer::findSplitPoints()
+ *
+ * Recorre el fuente con el mismo cursor lógico que el lexer y reproduce
+ * las reglas de tokenize*() que deciden dónde acaba un comentario, un
+ * literal o un pp-number (por los separadores '); el resto de caracteres
+ * solo se salta. Así un corte nunca cae donde el lexer secuencial estaría
+ * a mitad de un token o de un comentario.
+ */
+class SplitScanner {
+public:
+    SplitScanner(std::string_view source, bool trigraphs)
+        : source_(source), trigraphs_(trigraphs) {}
+
+    /**
+     * @brief Carácter lógico en pos ('\0' al final); pos pasa a apuntar tras él
+     */
+    char next(size_t& pos) const {
+        pos = skipSplices(source_, pos, trigraphs_);
+        if (pos >= source_.size()) return '\0';
+        char c;
+        pos += decodeChar(source_, pos, trigraphs_, c);
+        return c;
+    }
+
+    char peek(size_t pos) const { return next(pos); }
+
+    /**
+     * @brief Fin del comentario // que empieza en pos (el \n no se consume)
+     */
+    size_t skipLineComment(size_t pos) const {
+        const char* begin = source_.data();
+        const char* end = begin + source_.size();
+        while (true) {
+            size_t newline = static_cast<size_t>(CharScanner::findNewline(begin + pos, end) - begin);
+            if (newline >= source_.size() || !isSplicedNewline(source_, newline, pos, trigraphs_)) {
+                return std::min(newline, source_.size());
+            }
+            pos = newline + 1;
+        }
+    }
+
+    /**
+     * @brief Fin del comentario de bloque cuyo contenido empieza en pos
+     */
+    size_t skipBlockComment(size_t pos) const {
+        const char* begin = source_.data();
+        const char* end = begin + source_.size();
+        const char* close = CharScanner::findBlockCommentEnd(begin + pos, end);
+        return close == end ? source_.size() : static_cast<size_t>(close - begin) + 2;
+    }
+
+    /**
+     * @brief Fin del literal cuyo contenido empieza en pos (como tokenizeStringLiteral())
+     */
+    size_t skipLiteral(size_t pos, char quote) const {
+        while (pos < source_.size()) {
+            char c = next(pos);
+            if (c == quote) break;
+            if (c == '\\') next(pos); // El carácter escapado no cierra el literal
+        }
+        return pos;
+    }
+
+    /**
+     * @brief Fin del identificador que empieza en pos
+     */
+    size_t skipIdentifier(size_t pos) const {
+        const char* begin = source_.data();
+        const char* end = begin + source_.size();
+        while (true) {
+            pos = static_cast<size_t>(CharScanner::skipIdentifierChars(begin + pos, end) - begin);
+            size_t after = pos;
+            if (!isIdentifierChar(next(after))) return pos;
+            pos = after;
+        }
+    }
+
+    /**
+     * @brief Fin del pp-number que empieza en pos (como tokenizeNumber())
+     */
+    size_t skipNumber(size_t pos) const {
+        size_t second = pos;
+        next(second);
+        bool isHex = peek(pos) == '0' && (peek(second) == 'x' || peek(second) == 'X');
+        char previous = '\0';
+
+        while (pos < source_.size()) {
+            size_t after = pos;
+            char c = next(after);
+            bool followsExponent = isHex ? (previous == 'p' || previous == 'P')
+                                         : (previous == 'e' || previous == 'E');
+            bool accepted = c == '.' || (isHex ? (c == 'p' || c == 'P') : (c == 'e' || c == 'E')) ||
+                            ((c == '+' || c == '-') && followsExponent) ||
+                            (c == '\'' && isIdentifierChar(peek(after))) ||
+                            isIdentifierChar(c);
+            if (!accepted) break;
+            previous = c;
+            pos = after;
+        }
+        return pos;
+    }
+
+private:
+    std::string_view source_;
+    bool trigraphs_;
+};
+
+} // namespace
+
 // ============================================================================
 // Lexer - Implementación
 // ============================================================================
 
-Lexer::Lexer(const std::string& source, diagnostics::DiagnosticEngine& diagEngine,
-             const LexerConfig& config)
+Lexer::Lexer(std::string_view source, diagnostics::DiagnosticEngine& diagEngine,
+             const LexerConfig& config, common::utils::MemoryPool* pool)
     : source_(source), diagEngine_(diagEngine), config_(config),
-      state_(), stats_() {
+      state_(), stats_(), pool_(pool),
+      identifiers_(config.identifiers ? config.identifiers : &IdentifierTable::global()) {
+    if (!pool_) {
+        ownedPool_ = std::make_unique<common::utils::MemoryPool>(4096);
+        ownedPool_->setSubsystem(common::utils::MemorySubsystem::Tokens);
+        pool_ = ownedPool_.get();
+    }
     stats_.totalCharacters = source_.size();
-    stats_.totalLines = static_cast<size_t>(std::count(source_.begin(), source_.end(), '\n') + 1);
+    stats_.totalLines = CharScanner::countNewlines(source_.data(), source_.data() + source_.size()) + 1;
 }
 
 Lexer::~Lexer() = default;
@@ -53,173 +263,375 @@ std::vector<Token> Lexer::tokenize() {
         return tokens_; // Ya tokenizado
     }
 
-    // Ejecutar fases de traducción
-    phase1_PhysicalSource();
-    phase2_RemoveControlChars();
-    phase3_LineConcatenation();
-    phase4_TrigraphReplacement();
-    phase5_RemoveWhitespaceAndComments();
-    phase6_Tokenization();
+    while (true) {
+        Token token = getNextToken();
+        bool isEnd = token.getType() == TokenType::END_OF_FILE;
+        tokens_.push_back(std::move(token));
+        if (isEnd) break;
+    }
 
     return tokens_;
 }
 
-Token Lexer::peekNextToken() {
-    if (currentTokenIndex_ >= tokens_.size()) {
-        return createToken(TokenType::END_OF_FILE);
+void Lexer::tokenize(TokenBuffer& buffer) {
+    buffer.addSource(config_.fileId, source_);
+    buffer.reserve(buffer.size() + source_.size() / 4);
+    lexInto(buffer, true);
+    eofConsumed_ = true;
+}
+
+void Lexer::tokenize(TokenBuffer& buffer, common::utils::ThreadPool& pool) {
+    size_t chunkCount = std::min(pool.threadCount(), source_.size() / kMinParallelChunk);
+    std::vector<size_t> splits = findSplitPoints(source_, chunkCount, config_);
+    if (splits.empty() || state_.position != 0) {
+        tokenize(buffer);
+        return;
+    }
+
+    // Cada trozo ve el fuente hasta su final y empieza en su corte: offsets y líneas absolutos
+    std::vector<size_t> starts{0};
+    std::vector<size_t> lines{1};
+    for (size_t split : splits) {
+        lines.push_back(lines.back() + CharScanner::countNewlines(source_.data() + starts.back(),
+                                                                  source_.data() + split));
+        starts.push_back(split);
+    }
+
+    std::vector<TokenBuffer> parts(starts.size());
+    std::vector<LexerStats> partStats(starts.size());
+    std::vector<std::future<void>> pending;
+    for (size_t i = 0; i < starts.size(); ++i) {
+        size_t end = i + 1 < starts.size() ? starts[i + 1] : source_.size();
+        pending.push_back(pool.submit([this, &parts, &partStats, &starts, &lines, i, end]() {
+            Lexer chunk(source_.substr(0, end), diagEngine_, config_);
+            chunk.state_.position = starts[i];
+            chunk.state_.line = lines[i];
+            chunk.lexInto(parts[i], end == source_.size());
+            partStats[i] = chunk.stats_;
+        }));
+    }
+    // Los trozos referencian variables locales: primero que terminen todos
+    for (auto& future : pending) {
+        future.wait();
+    }
+    for (auto& future : pending) {
+        future.get();
+    }
+
+    buffer.addSource(config_.fileId, source_);
+    for (size_t i = 0; i < parts.size(); ++i) {
+        buffer.append(std::move(parts[i]));
+        stats_.totalTokens += partStats[i].totalTokens;
+        stats_.commentLines += partStats[i].commentLines;
+        stats_.errorCount += partStats[i].errorCount;
+    }
+    state_.position = source_.size();
+    state_.line = stats_.totalLines;
+    eofConsumed_ = true;
+}
+
+std::vector<size_t> Lexer::findSplitPoints(std::string_view source, size_t chunkCount,
+                                           const LexerConfig& config) {
+    std::vector<size_t> splits;
+    if (chunkCount < 2) {
+        return splits;
     }
-    return tokens_[currentTokenIndex_];
+
+    SplitScanner scanner(source, config.enableTrigraphs);
+    size_t step = source.size() / chunkCount;
+    size_t target = step;
+    size_t pos = 0;
+
+    while (pos < source.size()) {
+        size_t start = pos;
+        char c = scanner.next(pos);
+
+        if (c == '\n') {
+            size_t newline = pos - 1;
+            if (newline >= target && !isSplicedNewline(source, newline, 0, config.enableTrigraphs)) {
+                splits.push_back(newline);
+                if (splits.size() + 1 == chunkCount) break;
+                target = newline + step;
+            }
+        } else if (c == '/') {
+            size_t after = pos;
+            char following = scanner.next(after);
+            if (following == '/') {
+                pos = scanner.skipLineComment(after);
+            } else if (following == '*') {
+                pos = scanner.skipBlockComment(after);
+            }
+        } else if (c == '"' || c == '\'') {
+            pos = scanner.skipLiteral(pos, c);
+        } else if (isIdentifierChar(c)) {
+            // Tras un identificador, ' y " abren literal (u8'x', L"s"); tras un número, ' separa dígitos
+            pos = (c >= '0' && c <= '9') ? scanner.skipNumber(start) : scanner.skipIdentifier(pos);
+        } else if (c == '.' && scanner.peek(pos) >= '0' && scanner.peek(pos) <= '9') {
+            pos = scanner.skipNumber(start);
+        }
+    }
+    return splits;
+}
+
+void Lexer::lexInto(TokenBuffer& buffer, bool endOfFile) {
+    while (true) {
+        TokenType type = lexTokenType();
+        uint32_t offset = static_cast<uint32_t>(tokenStartOffset_);
+
+        if (type == TokenType::END_OF_FILE) {
+            if (endOfFile) {
+                buffer.pushSpan(type, config_.fileId, offset, 0, tokenFlags_);
+            }
+            break;
+        }
+
+        if (tokenNeedsRebuild_) {
+            buffer.pushSpelled(type, config_.fileId, offset, spelling(tokenStartOffset_), tokenFlags_);
+        } else {
+            buffer.pushSpan(type, config_.fileId, offset,
+                            static_cast<uint32_t>(state_.position - tokenStartOffset_), tokenFlags_);
+        }
+    }
+}
+
+const Token& Lexer::peekNextToken() {
+    if (lookahead_.empty()) {
+        lookahead_.push_back(lexNextToken());
+    }
+    return lookahead_.front();
 }
 
 Token Lexer::getNextToken() {
-    if (currentTokenIndex_ >= tokens_.size()) {
-        return createToken(TokenType::END_OF_FILE);
+    if (lookahead_.empty()) {
+        lookahead_.push_back(lexNextToken());
+    }
+
+    Token token = std::move(lookahead_.front());
+    lookahead_.pop_front();
+    if (token.getType() == TokenType::END_OF_FILE) {
+        eofConsumed_ = true;
     }
-    return tokens_[currentTokenIndex_++];
+    return token;
 }
 
 bool Lexer::hasMoreTokens() const {
-    return currentTokenIndex_ < tokens_.size();
+    return !eofConsumed_;
 }
 
 void Lexer::reset() {
     state_ = LexerState();
     tokens_.clear();
-    currentTokenIndex_ = 0;
+    lookahead_.clear();
+    eofConsumed_ = false;
+    atStartOfLine_ = true;
     stats_ = LexerStats();
     stats_.totalCharacters = source_.size();
-    stats_.totalLines = static_cast<size_t>(std::count(source_.begin(), source_.end(), '\n') + 1);
+    stats_.totalLines = CharScanner::countNewlines(source_.data(), source_.data() + source_.size()) + 1;
 }
 
-// === FASES DE TRADUCCIÓN ===
+// === CURSOR LÓGICO (FASES 1-5) ===
 
-void Lexer::phase1_PhysicalSource() {
-    // Asumimos que el código fuente ya está en UTF-8
+size_t Lexer::logicalPosition(size_t pos) const {
+    return skipSplices(source_, pos, config_.enableTrigraphs);
 }
 
-void Lexer::phase2_RemoveControlChars() {
-    std::string result;
-    for (char c : source_) {
-        if (c >= 0 && c < 32 && c != '\n' && c != '\t' && c != '\f') {
-            continue;
-        }
-        result += c;
-    }
-    source_ = result;
+size_t Lexer::decodeAt(size_t pos, char& c) const {
+    return decodeChar(source_, pos, config_.enableTrigraphs, c);
 }
 
-void Lexer::phase3_LineConcatenation() {
-    std::string result;
-    size_t i = 0;
-
-    while (i < source_.size()) {
-        if (source_[i] == '\\' && i + 1 < source_.size() && source_[i + 1] == '\n') {
-            i += 2;
-            continue;
-        }
-
-        result += source_[i];
-        ++i;
+std::string Lexer::spelling(size_t start) {
+    size_t end = state_.position;
+    if (!tokenNeedsRebuild_) {
+        return std::string(source_.substr(start, end - start));
     }
 
-    source_ = result;
-}
+    // El token cruza continuaciones o trigraphs: reconstruir su texto lógico
+    ScratchBuffer buffer{common::utils::ArenaAllocator<char>(*pool_)};
+    buffer.reserve(end - start);
+    for (size_t pos = logicalPosition(start); pos < end; pos = logicalPosition(pos)) {
+        char c;
+        pos += decodeAt(pos, c);
+        buffer.push_back(c);
+    }
 
-void Lexer::phase4_TrigraphReplacement() {
-    static const std::vector<std::pair<std::string, char>> trigraphs = {
-        {"??=", '#'}, {"??/", '\\'}, {"??'", '^'},
-        {"??(", '['}, {"??)", ']'}, {"??!", '|'},
-        {"??<", '{'}, {"??>", '}'}, {"??-", '~'}
-    };
+    std::string result(buffer.data(), buffer.size());
+    buffer = ScratchBuffer{common::utils::ArenaAllocator<char>(*pool_)};
 
-    for (const auto& trigraph : trigraphs) {
-        size_t pos = 0;
-        while ((pos = source_.find(trigraph.first, pos)) != std::string::npos) {
-            source_.replace(pos, 3, 1, trigraph.second);
-        }
+    // Una arena ajena puede contener datos del llamante: solo se rebobina la propia
+    if (ownedPool_) {
+        pool_->reset();
     }
+    return result;
 }
 
-void Lexer::phase5_RemoveWhitespaceAndComments() {
-    std::string result;
-    size_t i = 0;
+void Lexer::skipWhitespaceAndComments() {
+    const char* begin = source_.data();
+    const char* end = begin + source_.size();
+    size_t skipStart = state_.position;
 
-    while (i < source_.size()) {
-        char c = source_[i];
+    while (true) {
+        advanceTo(static_cast<size_t>(CharScanner::skipWhitespace(begin + state_.position, end) - begin));
 
+        size_t pos = logicalPosition(state_.position);
+        if (pos >= source_.size()) {
+            advanceTo(pos);
+            break;
+        }
+
+        char c;
+        decodeAt(pos, c);
         if (isWhitespace(c)) {
-            ++i;
+            getChar(); // Espacio tras una continuación de línea
             continue;
         }
 
-        if (c == '/' && i + 1 < source_.size()) {
-            if (source_[i + 1] == '/') {
+        if (c == '/') {
+            char next = peekChar(1);
+            if (next == '/') {
                 skipLineComment();
-                i = state_.position;
                 continue;
-            } else if (source_[i + 1] == '*') {
+            }
+            if (next == '*') {
                 skipBlockComment();
-                i = state_.position;
                 continue;
             }
         }
+        break;
+    }
 
-        result += c;
-        ++i;
+    tokenFlags_ = TOKEN_FLAG_NONE;
+    if (atStartOfLine_ || containsLineBreak(skipStart, state_.position)) {
+        tokenFlags_ |= TOKEN_FLAG_START_OF_LINE;
     }
+    if (logicalPosition(skipStart) < state_.position) {
+        tokenFlags_ |= TOKEN_FLAG_LEADING_SPACE; // Algo más que continuaciones de línea
+    }
+    atStartOfLine_ = false;
+}
+
+bool Lexer::containsLineBreak(size_t from, size_t to) const {
+    const char* begin = source_.data();
+    while (from < to) {
+        size_t newline = static_cast<size_t>(CharScanner::findNewline(begin + from, begin + to) - begin);
+        if (newline >= to) return false;
 
-    source_ = result;
+        // Una barra invertida (o ??/) antes del salto es una continuación, no un fin de línea
+        if (!isSplicedNewline(source_, newline, 0, config_.enableTrigraphs)) return true;
+        from = newline + 1;
+    }
+    return false;
 }
 
-void Lexer::phase6_Tokenization() {
-    reset();
+// === FASE 6: TOKENIZACIÓN BAJO DEMANDA ===
 
-    while (!isAtEnd()) {
-        char c = peekChar();
+Token Lexer::lexNextToken() {
+    return makeToken(lexTokenType());
+}
 
-        if (isWhitespace(c)) {
-            getChar();
-            continue;
-        }
+TokenType Lexer::lexTokenType() {
+    while (true) {
+        skipWhitespaceAndComments();
 
-        Token token = tokenizeOperatorOrPunctuation();
-        if (token.getType() != TokenType::INVALID) {
-            tokens_.push_back(token);
-            continue;
+        tokenStart_ = currentLocation();
+        tokenStartOffset_ = state_.position;
+        tokenNeedsRebuild_ = false;
+        tokenIdentifier_ = nullptr;
+
+        if (isAtEnd()) {
+            advanceTo(source_.size());
+            tokenStart_ = currentLocation();
+            tokenStartOffset_ = state_.position;
+            return TokenType::END_OF_FILE;
         }
 
-        if (isAlpha(c) || c == '_') {
-            tokens_.push_back(tokenizeIdentifier());
-        } else if (isDigit(c)) {
-            tokens_.push_back(tokenizeNumber());
-        } else if (c == '"' || (c == 'R' && peekChar() == '"')) {
-            tokens_.push_back(tokenizeStringLiteral());
-        } else if (c == '\'' || (c == 'L' && peekChar() == '\'') ||
-                   (c == 'u' && peekChar() == '\'') ||
-                   (c == 'U' && peekChar() == '\'')) {
-            tokens_.push_back(tokenizeCharacterLiteral());
-        } else {
-            reportError("carácter desconocido: " + std::string(1, c), currentLocation());
-            getChar();
+        char c = peekChar();
+
+        TokenType type = tokenizeOperatorOrPunctuation();
+        if (type == TokenType::INVALID) {
+            if (size_t prefix = encodingPrefixLength()) {
+                // L'b', u8"x": el prefijo forma parte del literal
+                for (size_t i = 0; i < prefix; ++i) {
+                    getChar();
+                }
+                type = peekChar() == '"' ? tokenizeStringLiteral() : tokenizeCharacterLiteral();
+            } else if (isAlpha(c) || c == '_') {
+                type = tokenizeIdentifier();
+            } else if (isDigit(c) || c == '.') {
+                type = tokenizeNumber();
+            } else if (c == '"') {
+                type = tokenizeStringLiteral();
+            } else if (c == '\'') {
+                type = tokenizeCharacterLiteral();
+            } else {
+                reportError("carácter desconocido: " + std::string(1, c), currentLocation());
+                getChar();
+                continue;
+            }
         }
+
+        ++stats_.totalTokens;
+        return type;
+    }
+}
+
+Token Lexer::makeToken(TokenType type) {
+    Token token = type == TokenType::END_OF_FILE
+        ? Token(type, "", tokenStart_)
+        : Token(type, spelling(tokenStartOffset_), tokenStart_);
+
+    switch (type) {
+        case TokenType::STRING_LITERAL:
+        case TokenType::CHAR_LITERAL:
+            token = Token(type, token.getLexeme(), tokenStart_,
+                          TokenUtils::unescapeLiteral(token.getLexeme()));
+            break;
+        case TokenType::INTEGER_LITERAL:
+        case TokenType::FLOAT_LITERAL:
+            token = Token(type, token.getLexeme(), tokenStart_, token.getLexeme());
+            break;
+        default:
+            break;
     }
 
-    tokens_.push_back(createToken(TokenType::END_OF_FILE));
-    stats_.totalTokens = tokens_.size();
+    token.setFlags(tokenFlags_);
+    token.setIdentifierInfo(tokenIdentifier_);
+    return token;
 }
 
 // === FUNCIONES AUXILIARES ===
 
-char Lexer::peekChar() const {
-    if (isAtEnd()) return '\0';
-    return source_[state_.position];
+char Lexer::peekChar(size_t lookahead) const {
+    size_t pos = state_.position;
+    while (true) {
+        pos = logicalPosition(pos);
+        if (pos >= source_.size()) return '\0';
+
+        char c;
+        size_t width = decodeAt(pos, c);
+        if (lookahead == 0) return c;
+
+        pos += width;
+        --lookahead;
+    }
 }
 
 char Lexer::getChar() {
-    if (isAtEnd()) return '\0';
+    size_t pos = logicalPosition(state_.position);
+    if (pos != state_.position) {
+        tokenNeedsRebuild_ = true;
+        advanceTo(pos);
+    }
+    if (pos >= source_.size()) return '\0';
 
-    char c = source_[state_.position++];
-    advancePosition(c);
+    char c;
+    size_t width = decodeAt(pos, c);
+    if (width == 1) {
+        ++state_.position;
+        advancePosition(c);
+    } else {
+        tokenNeedsRebuild_ = true;
+        advanceTo(pos + width);
+    }
     return c;
 }
 
@@ -230,14 +642,15 @@ void Lexer::ungetChar() {
 }
 
 bool Lexer::isAtEnd() const {
-    return state_.position >= source_.size();
+    return logicalPosition(state_.position) >= source_.size();
 }
 
 diagnostics::SourceLocation Lexer::currentLocation() const {
     return diagnostics::SourceLocation(
         static_cast<uint32_t>(state_.line),
         static_cast<uint32_t>(state_.column),
-        static_cast<uint32_t>(state_.position)
+        static_cast<uint32_t>(state_.position),
+        config_.fileId
     );
 }
 
@@ -250,16 +663,24 @@ void Lexer::advancePosition(char c) {
     }
 }
 
+void Lexer::advanceTo(size_t newPosition) {
+    const char* begin = source_.data();
+    size_t newlines = CharScanner::countNewlines(begin + state_.position, begin + newPosition);
+
+    if (newlines == 0) {
+        state_.column += newPosition - state_.position;
+    } else {
+        state_.line += newlines;
+        state_.column = newPosition - source_.rfind('\n', newPosition - 1);
+    }
+    state_.position = newPosition;
+}
+
 void Lexer::reportError(const std::string& message, const diagnostics::SourceLocation& location) {
     std::cerr << "Error léxico en " << location.toString() << ": " << message << std::endl;
     ++stats_.errorCount;
 }
 
-Token Lexer::createToken(TokenType type, const std::string& lexeme, const std::string& value) {
-    return Token(type, lexeme.empty() ? std::string(1, source_[state_.position - 1]) : lexeme,
-                 currentLocation(), value);
-}
-
 bool Lexer::isDigit(char c) const {
     return c >= '0' && c <= '9';
 }
@@ -277,73 +698,118 @@ bool Lexer::isWhitespace(char c) const {
 }
 
 void Lexer::skipLineComment() {
-    while (!isAtEnd() && peekChar() != '\n') {
-        getChar();
+    const char* begin = source_.data();
+    const char* end = begin + source_.size();
+
+    getChar(); // Consumir //
+    getChar();
+
+    while (true) {
+        size_t newline = static_cast<size_t>(CharScanner::findNewline(begin + state_.position, end) - begin);
+        if (newline >= source_.size()) {
+            advanceTo(newline);
+            break;
+        }
+
+        // Una continuación de línea extiende el comentario a la línea siguiente
+        if (!isSplicedNewline(source_, newline, state_.position, config_.enableTrigraphs)) {
+            advanceTo(newline); // El \n queda como espacio en blanco
+            break;
+        }
+        advanceTo(newline + 1);
     }
     ++stats_.commentLines;
 }
 
 void Lexer::skipBlockComment() {
-    while (!isAtEnd()) {
-        if (peekChar() == '*' && state_.position + 1 < source_.size() &&
-            source_[state_.position + 1] == '/') {
-            getChar();
-            getChar();
-            ++stats_.commentLines;
-            return;
-        }
-        if (peekChar() == '\n') {
-            ++stats_.commentLines;
-        }
-        getChar();
+    const char* begin = source_.data();
+    const char* end = begin + source_.size();
+
+    getChar(); // Consumir /* para que "/*/" no cierre el comentario
+    getChar();
+
+    const char* close = CharScanner::findBlockCommentEnd(begin + state_.position, end);
+    stats_.commentLines += CharScanner::countNewlines(begin + state_.position, close);
+
+    if (close == end) {
+        advanceTo(source_.size());
+        reportError("comentario de bloque sin cerrar", currentLocation());
+        return;
     }
-    reportError("comentario de bloque sin cerrar", currentLocation());
+
+    advanceTo(static_cast<size_t>(close - begin) + 2);
+    ++stats_.commentLines;
 }
 
-// Implementaciones básicas para completar la clase
-Token Lexer::tokenizeIdentifier() {
+TokenType Lexer::tokenizeIdentifier() {
     size_t start = state_.position;
-    diagnostics::SourceLocation location = currentLocation();
+    const char* begin = source_.data();
+    const char* end = begin + source_.size();
+
+    while (true) {
+        advanceTo(static_cast<size_t>(CharScanner::skipIdentifierChars(begin + state_.position, end) - begin));
 
-    while (!isAtEnd() && (isAlnum(peekChar()) || peekChar() == '_')) {
+        // El bloque vectorial se detiene en '\' o '?': puede ser una continuación o trigraph
+        char c = peekChar();
+        if (!(isAlnum(c) || c == '_')) break;
         getChar();
     }
 
-    std::string lexeme = source_.substr(start, state_.position - start);
-    TokenType type = TokenUtils::getKeywordType(lexeme);
+    // La palabra clave se calcula una sola vez por identificador distinto
+    tokenIdentifier_ = tokenNeedsRebuild_
+        ? identifiers_->get(spelling(start))
+        : identifiers_->get(source_.substr(start, state_.position - start));
+    return tokenIdentifier_->keywordKind();
+}
 
-    return createToken(type, lexeme);
+size_t Lexer::encodingPrefixLength() const {
+    size_t length = 0;
+    switch (peekChar()) {
+        case 'L':
+        case 'U':
+            length = 1;
+            break;
+        case 'u':
+            length = peekChar(1) == '8' ? 2 : 1;
+            break;
+        default:
+            return 0;
+    }
+    char quote = peekChar(length);
+    return quote == '\'' || quote == '"' ? length : 0;
 }
 
-Token Lexer::tokenizeNumber() {
-    size_t start = state_.position;
+TokenType Lexer::tokenizeNumber() {
+    // pp-number: prefijos (0x, 0b), sufijos (202002L, 1.5f), separadores ' y exponentes con signo
+    bool isHex = peekChar() == '0' && (peekChar(1) == 'x' || peekChar(1) == 'X');
     bool isFloat = false;
+    char previous = '\0';
 
-    while (!isAtEnd() && (isDigit(peekChar()) || peekChar() == '.' ||
-                          peekChar() == 'e' || peekChar() == 'E')) {
-        char c = getChar();
-        if (c == '.' || c == 'e' || c == 'E') {
+    while (!isAtEnd()) {
+        char c = peekChar();
+        bool followsExponent = isHex ? (previous == 'p' || previous == 'P')
+                                     : (previous == 'e' || previous == 'E');
+        if (c == '.' || (isHex ? (c == 'p' || c == 'P') : (c == 'e' || c == 'E'))) {
             isFloat = true;
+        } else if ((c == '+' || c == '-') && followsExponent) {
+            // Signo del exponente
+        } else if (c == '\'' && (isAlnum(peekChar(1)) || peekChar(1) == '_')) {
+            // Separador de dígitos
+        } else if (!isAlnum(c) && c != '_') {
+            break;
         }
+        previous = getChar();
     }
 
-    std::string lexeme = source_.substr(start, state_.position - start);
-    TokenType type = isFloat ? TokenType::FLOAT_LITERAL : TokenType::INTEGER_LITERAL;
-
-    return createToken(type, lexeme, lexeme);
+    return isFloat ? TokenType::FLOAT_LITERAL : TokenType::INTEGER_LITERAL;
 }
 
-Token Lexer::tokenizeCharacterLiteral() {
-    size_t start = state_.position;
+TokenType Lexer::tokenizeCharacterLiteral() {
     getChar(); // Consumir '
 
-    std::string value;
     while (!isAtEnd() && peekChar() != '\'') {
-        char c = getChar();
-        if (c == '\\') {
-            value += handleEscapeSequence();
-        } else {
-            value += c;
+        if (getChar() == '\\' && !isAtEnd()) {
+            getChar(); // El carácter escapado no cierra el literal
         }
     }
 
@@ -351,21 +817,15 @@ Token Lexer::tokenizeCharacterLiteral() {
         getChar();
     }
 
-    std::string lexeme = source_.substr(start, state_.position - start);
-    return createToken(TokenType::CHAR_LITERAL, lexeme, value);
+    return TokenType::CHAR_LITERAL;
 }
 
-Token Lexer::tokenizeStringLiteral() {
-    size_t start = state_.position;
+TokenType Lexer::tokenizeStringLiteral() {
     getChar(); // Consumir "
 
-    std::string value;
     while (!isAtEnd() && peekChar() != '"') {
-        char c = getChar();
-        if (c == '\\') {
-            value += handleEscapeSequence();
-        } else {
-            value += c;
+        if (getChar() == '\\' && !isAtEnd()) {
+            getChar(); // El carácter escapado no cierra el literal
         }
     }
 
@@ -373,27 +833,11 @@ Token Lexer::tokenizeStringLiteral() {
         getChar();
     }
 
-    std::string lexeme = source_.substr(start, state_.position - start);
-    return createToken(TokenType::STRING_LITERAL, lexeme, value);
+    return TokenType::STRING_LITERAL;
 }
 
-std::string Lexer::handleEscapeSequence() {
-    if (isAtEnd()) return "?";
-
-    char c = getChar();
-    switch (c) {
-        case 'n': return "\n";
-        case 't': return "\t";
-        case 'r': return "\r";
-        case '\\': return "\\";
-        case '"': return "\"";
-        case '\'': return "'";
-        default: return std::string(1, c);
-    }
-}
-
-Token Lexer::tokenizeOperatorOrPunctuation() {
-    if (isAtEnd()) return createToken(TokenType::INVALID);
+TokenType Lexer::tokenizeOperatorOrPunctuation() {
+    if (isAtEnd()) return TokenType::INVALID;
 
     char c = peekChar();
 
@@ -402,81 +846,169 @@ Token Lexer::tokenizeOperatorOrPunctuation() {
             getChar();
             if (peekChar() == '+') {
                 getChar();
-                return createToken(TokenType::INCREMENT, "++");
+                return TokenType::INCREMENT;
             } else if (peekChar() == '=') {
                 getChar();
-                return createToken(TokenType::PLUS_ASSIGN, "+=");
+                return TokenType::PLUS_ASSIGN;
             }
-            return createToken(TokenType::PLUS, "+");
+            return TokenType::PLUS;
         }
         case '-': {
             getChar();
+            if (peekChar() == '>') {
+                getChar();
+                return TokenType::ARROW;
+            }
             if (peekChar() == '-') {
                 getChar();
-                return createToken(TokenType::DECREMENT, "--");
+                return TokenType::DECREMENT;
             } else if (peekChar() == '=') {
                 getChar();
-                return createToken(TokenType::MINUS_ASSIGN, "-=");
+                return TokenType::MINUS_ASSIGN;
             }
-            return createToken(TokenType::MINUS, "-");
+            return TokenType::MINUS;
         }
         case '=': {
             getChar();
             if (peekChar() == '=') {
                 getChar();
-                return createToken(TokenType::EQUAL, "==");
+                return TokenType::EQUAL;
             }
-            return createToken(TokenType::ASSIGN, "=");
+            return TokenType::ASSIGN;
         }
         case '!': {
             getChar();
             if (peekChar() == '=') {
                 getChar();
-                return createToken(TokenType::NOT_EQUAL, "!=");
+                return TokenType::NOT_EQUAL;
             }
-            return createToken(TokenType::LOGICAL_NOT, "!");
+            return TokenType::LOGICAL_NOT;
         }
         case '<': {
             getChar();
             if (peekChar() == '=') {
                 getChar();
-                return createToken(TokenType::LESS_EQUAL, "<=");
+                if (peekChar() == '>') {
+                    getChar();
+                    return TokenType::SPACESHIP;
+                }
+                return TokenType::LESS_EQUAL;
+            }
+            // "<<" y ">>" quedan como dos tokens (por las plantillas); "<<=" y ">>=" no
+            if (peekChar() == '<' && peekChar(1) == '=') {
+                getChar();
+                getChar();
+                return TokenType::LEFT_SHIFT_ASSIGN;
             }
-            return createToken(TokenType::LESS, "<");
+            return TokenType::LESS;
         }
         case '>': {
             getChar();
             if (peekChar() == '=') {
                 getChar();
-                return createToken(TokenType::GREATER_EQUAL, ">=");
+                return TokenType::GREATER_EQUAL;
+            }
+            if (peekChar() == '>' && peekChar(1) == '=') {
+                getChar();
+                getChar();
+                return TokenType::RIGHT_SHIFT_ASSIGN;
             }
-            return createToken(TokenType::GREATER, ">");
+            return TokenType::GREATER;
         }
         case '&': {
             getChar();
             if (peekChar() == '&') {
                 getChar();
-                return createToken(TokenType::LOGICAL_AND, "&&");
+                return TokenType::LOGICAL_AND;
+            } else if (peekChar() == '=') {
+                getChar();
+                return TokenType::AND_ASSIGN;
             }
-            return createToken(TokenType::BIT_AND, "&");
+            return TokenType::BIT_AND;
         }
         case '|': {
             getChar();
             if (peekChar() == '|') {
                 getChar();
-                return createToken(TokenType::LOGICAL_OR, "||");
+                return TokenType::LOGICAL_OR;
+            } else if (peekChar() == '=') {
+                getChar();
+                return TokenType::OR_ASSIGN;
             }
-            return createToken(TokenType::BIT_OR, "|");
+            return TokenType::BIT_OR;
         }
-        case ';': return createToken(TokenType::SEMICOLON, std::string(1, getChar()));
-        case ',': return createToken(TokenType::COMMA, std::string(1, getChar()));
-        case '(': return createToken(TokenType::LEFT_PAREN, std::string(1, getChar()));
-        case ')': return createToken(TokenType::RIGHT_PAREN, std::string(1, getChar()));
-        case '{': return createToken(TokenType::LEFT_BRACE, std::string(1, getChar()));
-        case '}': return createToken(TokenType::RIGHT_BRACE, std::string(1, getChar()));
-        case '[': return createToken(TokenType::LEFT_BRACKET, std::string(1, getChar()));
-        case ']': return createToken(TokenType::RIGHT_BRACKET, std::string(1, getChar()));
-        default: return createToken(TokenType::INVALID);
+        case ';': getChar(); return TokenType::SEMICOLON;
+        case ',': getChar(); return TokenType::COMMA;
+        case '(': getChar(); return TokenType::LEFT_PAREN;
+        case ')': getChar(); return TokenType::RIGHT_PAREN;
+        case '{': getChar(); return TokenType::LEFT_BRACE;
+        case '}': getChar(); return TokenType::RIGHT_BRACE;
+        case '[': getChar(); return TokenType::LEFT_BRACKET;
+        case ']': getChar(); return TokenType::RIGHT_BRACKET;
+        case '*': {
+            getChar();
+            if (peekChar() == '=') {
+                getChar();
+                return TokenType::MUL_ASSIGN;
+            }
+            return TokenType::STAR;
+        }
+        case '/': {
+            getChar();
+            if (peekChar() == '=') {
+                getChar();
+                return TokenType::DIV_ASSIGN;
+            }
+            return TokenType::SLASH;
+        }
+        case '%': {
+            getChar();
+            if (peekChar() == '=') {
+                getChar();
+                return TokenType::MOD_ASSIGN;
+            }
+            return TokenType::PERCENT;
+        }
+        case '^': {
+            getChar();
+            if (peekChar() == '=') {
+                getChar();
+                return TokenType::XOR_ASSIGN;
+            }
+            return TokenType::BIT_XOR;
+        }
+        case '~': getChar(); return TokenType::BIT_NOT;
+        case '?': getChar(); return TokenType::QUESTION;
+        case ':': {
+            getChar();
+            if (peekChar() == ':') {
+                getChar();
+                return TokenType::SCOPE_RESOLUTION;
+            }
+            return TokenType::COLON;
+        }
+        case '.': {
+            if (peekChar(1) == '.' && peekChar(2) == '.') {
+                getChar();
+                getChar();
+                getChar();
+                return TokenType::ELLIPSIS;
+            }
+            if (isDigit(peekChar(1))) {
+                return TokenType::INVALID; // Literal flotante ".5"
+            }
+            getChar();
+            return TokenType::DOT;
+        }
+        case '#': {
+            getChar();
+            if (peekChar() == '#') {
+                getChar();
+                return TokenType::HASH_HASH;
+            }
+            return TokenType::HASH;
+        }
+        default: return TokenType::INVALID;
     }
 }
 
@@ -508,13 +1040,9 @@ int LexerUtils::digitValue(char c) {
     return -1;
 }
 
-bool LexerUtils::isCpp20Keyword(const std::string& word) {
-    static const std::vector<std::string> cpp20Keywords = {
-        "concept", "requires", "consteval", "constinit", "constexpr",
-        "co_await", "co_return", "co_yield", "module", "import", "export"
-    };
-
-    return std::find(cpp20Keywords.begin(), cpp20Keywords.end(), word) != cpp20Keywords.end();
+bool LexerUtils::isCpp20Keyword(std::string_view word) {
+    const KeywordInfo* keyword = KeywordTable::lookup(word);
+    return keyword && keyword->isCpp20;
 }
 
 std::string LexerUtils::normalizeNewlines(const std::string& source) {
@@ -4,6 +4,7 @@
  */
 
 #include <compiler/frontend/lexer/Token.h>
+#include <compiler/frontend/lexer/KeywordTable.h>
 #include <unordered_map>
 
 namespace cpp20::compiler::frontend::lexer {
@@ -270,70 +271,33 @@ std::string TokenUtils::tokenTypeToString(TokenType type) {
     return "UNKNOWN_TOKEN";
 }
 
-TokenType TokenUtils::getKeywordType(const std::string& identifier) {
-    static const std::unordered_map<std::string, TokenType> keywords = {
-        // Tipos fundamentales
-        {"void", TokenType::VOID}, {"int", TokenType::INT}, {"char", TokenType::CHAR},
-        {"short", TokenType::SHORT}, {"long", TokenType::LONG}, {"float", TokenType::FLOAT},
-        {"double", TokenType::DOUBLE}, {"bool", TokenType::BOOL},
-
-        // Calificadores
-        {"const", TokenType::CONST}, {"volatile", TokenType::VOLATILE},
-        {"consteval", TokenType::CONSTEVAL}, {"constexpr", TokenType::CONSTEXPR},
-        {"constinit", TokenType::CONSTINIT}, {"mutable", TokenType::MUTABLE},
-
-        // Especificadores de almacenamiento
-        {"static", TokenType::STATIC}, {"extern", TokenType::EXTERN},
-        {"inline", TokenType::INLINE}, {"thread_local", TokenType::THREAD_LOCAL},
-
-        // Control de acceso
-        {"public", TokenType::PUBLIC}, {"private", TokenType::PRIVATE}, {"protected", TokenType::PROTECTED},
-
-        // Estructuras de control
-        {"if", TokenType::IF}, {"else", TokenType::ELSE}, {"while", TokenType::WHILE},
-        {"for", TokenType::FOR}, {"do", TokenType::DO}, {"switch", TokenType::SWITCH},
-        {"case", TokenType::CASE}, {"default", TokenType::DEFAULT}, {"break", TokenType::BREAK},
-        {"continue", TokenType::CONTINUE}, {"return", TokenType::RETURN}, {"goto", TokenType::GOTO},
-
-        // Estructuras de datos
-        {"struct", TokenType::STRUCT}, {"class", TokenType::CLASS}, {"union", TokenType::UNION},
-        {"enum", TokenType::ENUM},
-
-        // Funciones y métodos
-        {"virtual", TokenType::VIRTUAL}, {"override", TokenType::OVERRIDE}, {"final", TokenType::FINAL},
-        {"noexcept", TokenType::NOEXCEPT},
-
-        // Excepciones
-        {"try", TokenType::TRY}, {"catch", TokenType::CATCH}, {"throw", TokenType::THROW},
-
-        // Templates y conceptos
-        {"template", TokenType::TEMPLATE}, {"typename", TokenType::TYPENAME},
-        {"concept", TokenType::CONCEPT}, {"requires", TokenType::REQUIRES},
-
-        // Espacios de nombres
-        {"namespace", TokenType::NAMESPACE}, {"using", TokenType::USING},
-
-        // Operadores y conversión
-        {"operator", TokenType::OPERATOR}, {"explicit", TokenType::EXPLICIT},
-
-        // Misceláneo
-        {"sizeof", TokenType::SIZEOF}, {"alignof", TokenType::ALIGNOF}, {"alignas", TokenType::ALIGNAS},
-        {"typeid", TokenType::TYPEID}, {"decltype", TokenType::DECLTYPE}, {"auto", TokenType::AUTO},
-
-        // C++20 específico
-        {"co_await", TokenType::CO_AWAIT}, {"co_return", TokenType::CO_RETURN}, {"co_yield", TokenType::CO_YIELD},
-        {"module", TokenType::MODULE}, {"import", TokenType::IMPORT}, {"export", TokenType::EXPORT},
+TokenType TokenUtils::getKeywordType(std::string_view identifier) {
+    return KeywordTable::typeOf(identifier);
+}
 
-        // Literales
-        {"true", TokenType::TRUE_LITERAL}, {"false", TokenType::FALSE_LITERAL},
-        {"nullptr", TokenType::NULLPTR_LITERAL}
-    };
+std::string TokenUtils::unescapeLiteral(std::string_view lexeme) {
+    // Saltar el prefijo de codificación (L, u, U, u8) y las comillas
+    size_t open = lexeme.find_first_of("'\"");
+    if (open != std::string_view::npos && lexeme.size() >= open + 2) {
+        lexeme = lexeme.substr(open + 1, lexeme.size() - open - 2);
+    }
 
-    auto it = keywords.find(identifier);
-    if (it != keywords.end()) {
-        return it->second;
+    std::string value;
+    value.reserve(lexeme.size());
+    for (size_t i = 0; i < lexeme.size(); ++i) {
+        if (lexeme[i] != '\\' || i + 1 == lexeme.size()) {
+            value += lexeme[i];
+            continue;
+        }
+
+        switch (lexeme[++i]) {
+            case 'n': value += '\n'; break;
+            case 't': value += '\t'; break;
+            case 'r': value += '\r'; break;
+            default: value += lexeme[i]; break; // \\, \", \' y el resto literal
+        }
     }
-    return TokenType::IDENTIFIER;
+    return value;
 }
 
 int TokenUtils::getOperatorPrecedence(TokenType type) {
@@ -0,0 +1,122 @@
+/**
+ * @file TokenBuffer.cpp
+ * @brief Implementación de tokens compactos y su buffer
+ */
+
+#include <compiler/frontend/lexer/TokenBuffer.h>
+#include <algorithm>
+
+namespace cpp20::compiler::frontend::lexer {
+
+// ============================================================================
+// TokenView - Implementación
+// ============================================================================
+
+std::string_view TokenView::getLexeme() const {
+    return buffer_->spelling(*token_);
+}
+
+std::string TokenView::getValue() const {
+    switch (token_->type) {
+        case TokenType::STRING_LITERAL:
+        case TokenType::CHAR_LITERAL:
+            return TokenUtils::unescapeLiteral(getLexeme());
+        case TokenType::INTEGER_LITERAL:
+        case TokenType::FLOAT_LITERAL:
+            return std::string(getLexeme());
+        default:
+            return std::string();
+    }
+}
+
+diagnostics::SourceLocation TokenView::getLocation() const {
+    return buffer_->location(*token_);
+}
+
+Token TokenView::toToken() const {
+    Token token(token_->type, std::string(getLexeme()), getLocation(), getValue());
+    token.setFlags(token_->flags & ~TOKEN_FLAG_SPELLING_IN_TABLE);
+    return token;
+}
+
+// ============================================================================
+// TokenBuffer - Implementación
+// ============================================================================
+
+void TokenBuffer::addSource(uint32_t fileId, std::string_view text) {
+    sources_[fileId] = SourceText{text, {}};
+}
+
+void TokenBuffer::pushSpan(TokenType type, uint32_t fileId, uint32_t offset, uint32_t length,
+                           uint16_t flags) {
+    tokens_.push_back(CompactToken{type, static_cast<uint16_t>(flags & ~TOKEN_FLAG_SPELLING_IN_TABLE),
+                                   fileId, offset, length});
+}
+
+void TokenBuffer::pushSpelled(TokenType type, uint32_t fileId, uint32_t offset, std::string spelling,
+                              uint16_t flags) {
+    spellings_.push_back(std::move(spelling));
+    tokens_.push_back(CompactToken{type, static_cast<uint16_t>(flags | TOKEN_FLAG_SPELLING_IN_TABLE),
+                                   fileId, offset, static_cast<uint32_t>(spellings_.size() - 1)});
+}
+
+void TokenBuffer::append(TokenBuffer&& other) {
+    uint32_t spellingBase = static_cast<uint32_t>(spellings_.size());
+    tokens_.reserve(tokens_.size() + other.tokens_.size());
+    for (CompactToken token : other.tokens_) {
+        if (token.flags & TOKEN_FLAG_SPELLING_IN_TABLE) {
+            token.spelling += spellingBase;
+        }
+        tokens_.push_back(token);
+    }
+    for (std::string& spelling : other.spellings_) {
+        spellings_.push_back(std::move(spelling));
+    }
+    for (auto& [fileId, source] : other.sources_) {
+        sources_.try_emplace(fileId, SourceText{source.text, {}});
+    }
+    other.clear();
+}
+
+void TokenBuffer::clear() {
+    tokens_.clear();
+    sources_.clear();
+    spellings_.clear();
+}
+
+std::string_view TokenBuffer::spelling(const CompactToken& token) const {
+    if (token.flags & TOKEN_FLAG_SPELLING_IN_TABLE) {
+        return spellings_[token.spelling];
+    }
+
+    auto it = sources_.find(token.fileId);
+    if (it == sources_.end()) {
+        return std::string_view();
+    }
+    return it->second.text.substr(token.offset, token.spelling);
+}
+
+diagnostics::SourceLocation TokenBuffer::location(const CompactToken& token) const {
+    auto it = sources_.find(token.fileId);
+    if (it == sources_.end()) {
+        return diagnostics::SourceLocation(0, 0, token.offset, token.fileId);
+    }
+
+    const SourceText& source = it->second;
+    if (source.lineOffsets.empty()) {
+        source.lineOffsets.push_back(0);
+        for (size_t i = 0; i < source.text.size(); ++i) {
+            if (source.text[i] == '\n') {
+                source.lineOffsets.push_back(static_cast<uint32_t>(i + 1));
+            }
+        }
+    }
+
+    auto line = std::upper_bound(source.lineOffsets.begin(), source.lineOffsets.end(), token.offset);
+    size_t lineIndex = static_cast<size_t>(line - source.lineOffsets.begin()) - 1;
+    return diagnostics::SourceLocation(static_cast<uint32_t>(lineIndex + 1),
+                                       token.offset - source.lineOffsets[lineIndex] + 1,
+                                       token.offset, token.fileId);
+}
+
+} // namespace cpp20::compiler::frontend::lexer
@@ -0,0 +1,286 @@
+/**
+ * @file BitIntrinsics.cpp
+ * @brief Implementación de la conversión de builtins y patrones de bits en intrínsecos
+ */
+
+#include <compiler/ir/IRPasses.h>
+#include <string_view>
+#include <unordered_map>
+
+namespace cpp20::compiler::ir {
+
+namespace {
+
+const TypeInfo BoolType(IRType::Bool, 1, 1, "bool");
+
+/**
+ * @brief Builtins de GCC/Clang e intrínsecos de MSVC / <immintrin.h> con un opcode equivalente
+ */
+const std::unordered_map<std::string_view, IROpcode>& builtinOpcodes() {
+    static const std::unordered_map<std::string_view, IROpcode> table = {
+        {"__builtin_popcount", IROpcode::PopCount},
+        {"__builtin_popcountl", IROpcode::PopCount},
+        {"__builtin_popcountll", IROpcode::PopCount},
+        {"__popcnt16", IROpcode::PopCount},
+        {"__popcnt", IROpcode::PopCount},
+        {"__popcnt64", IROpcode::PopCount},
+        {"_mm_popcnt_u32", IROpcode::PopCount},
+        {"_mm_popcnt_u64", IROpcode::PopCount},
+        {"_popcnt32", IROpcode::PopCount},
+        {"_popcnt64", IROpcode::PopCount},
+
+        {"__builtin_clz", IROpcode::CountLeadingZeros},
+        {"__builtin_clzl", IROpcode::CountLeadingZeros},
+        {"__builtin_clzll", IROpcode::CountLeadingZeros},
+        {"__lzcnt16", IROpcode::CountLeadingZeros},
+        {"__lzcnt", IROpcode::CountLeadingZeros},
+        {"__lzcnt64", IROpcode::CountLeadingZeros},
+        {"_lzcnt_u32", IROpcode::CountLeadingZeros},
+        {"_lzcnt_u64", IROpcode::CountLeadingZeros},
+
+        {"__builtin_ctz", IROpcode::CountTrailingZeros},
+        {"__builtin_ctzl", IROpcode::CountTrailingZeros},
+        {"__builtin_ctzll", IROpcode::CountTrailingZeros},
+        {"__tzcnt_u16", IROpcode::CountTrailingZeros},
+        {"_tzcnt_u32", IROpcode::CountTrailingZeros},
+        {"_tzcnt_u64", IROpcode::CountTrailingZeros},
+
+        {"__builtin_bswap16", IROpcode::ByteSwap},
+        {"__builtin_bswap32", IROpcode::ByteSwap},
+        {"__builtin_bswap64", IROpcode::ByteSwap},
+        {"_byteswap_ushort", IROpcode::ByteSwap},
+        {"_byteswap_ulong", IROpcode::ByteSwap},
+        {"_byteswap_uint64", IROpcode::ByteSwap},
+
+        {"__builtin_rotateleft8", IROpcode::RotateLeft},
+        {"__builtin_rotateleft16", IROpcode::RotateLeft},
+        {"__builtin_rotateleft32", IROpcode::RotateLeft},
+        {"__builtin_rotateleft64", IROpcode::RotateLeft},
+        {"_rotl8", IROpcode::RotateLeft},
+        {"_rotl16", IROpcode::RotateLeft},
+        {"_rotl", IROpcode::RotateLeft},
+        {"_rotl64", IROpcode::RotateLeft},
+        {"__rolb", IROpcode::RotateLeft},
+        {"__rolw", IROpcode::RotateLeft},
+        {"__rold", IROpcode::RotateLeft},
+        {"__rolq", IROpcode::RotateLeft},
+
+        {"__builtin_rotateright8", IROpcode::RotateRight},
+        {"__builtin_rotateright16", IROpcode::RotateRight},
+        {"__builtin_rotateright32", IROpcode::RotateRight},
+        {"__builtin_rotateright64", IROpcode::RotateRight},
+        {"_rotr8", IROpcode::RotateRight},
+        {"_rotr16", IROpcode::RotateRight},
+        {"_rotr", IROpcode::RotateRight},
+        {"_rotr64", IROpcode::RotateRight},
+        {"__rorb", IROpcode::RotateRight},
+        {"__rorw", IROpcode::RotateRight},
+        {"__rord", IROpcode::RotateRight},
+        {"__rorq", IROpcode::RotateRight},
+
+        {"_pdep_u32", IROpcode::BitDeposit},
+        {"_pdep_u64", IROpcode::BitDeposit},
+        {"_pext_u32", IROpcode::BitExtract},
+        {"_pext_u64", IROpcode::BitExtract},
+
+        {"_mm_crc32_u8", IROpcode::Crc32},
+        {"_mm_crc32_u16", IROpcode::Crc32},
+        {"_mm_crc32_u32", IROpcode::Crc32},
+        {"_mm_crc32_u64", IROpcode::Crc32},
+    };
+    return table;
+}
+
+bool isInteger(const TypeInfo& type) {
+    return !type.isFloatingPoint() && type.type != IRType::Void && type.type != IRType::Bool &&
+           type.type != IRType::Pointer && type.size > 0 && type.size <= 8;
+}
+
+int64_t bitWidth(const TypeInfo& type) {
+    return static_cast<int64_t>(type.size) * 8;
+}
+
+/**
+ * @brief El valor es la constante entera value
+ */
+bool isConstant(const IRFunction& function, ValueId id, int64_t value) {
+    const IRConstant* constant = function.constant(id);
+    return constant && constant->intValue == value;
+}
+
+/**
+ * @brief Instrucción que define el valor si su opcode es opcode, o NoInstr
+ */
+InstrId definedBy(const IRFunction& function, ValueId id, IROpcode opcode) {
+    InstrId def = function.definingInstruction(id);
+    return def != NoInstr && function.instruction(def).opcode == opcode ? def : NoInstr;
+}
+
+/**
+ * @brief Convierte value al tipo type (ZExt o Trunc según el ancho) antes de position
+ */
+ValueId convert(IRFunction& function, InstrId position, ValueId value, const TypeInfo& type) {
+    const TypeInfo& from = function.typeOf(value);
+    if (from.size == type.size && from.type == type.type) return value;
+    IROpcode opcode = from.size > type.size ? IROpcode::Trunc : IROpcode::ZExt;
+    InstrId cast = function.insertBefore(position, opcode, type, std::span<const ValueId>(&value, 1), true);
+    return function.instruction(cast).result;
+}
+
+/**
+ * @brief Rotación escrita a mano: Or(Shl(x, c), And(Shr(x, w - c), 2^c - 1))
+ *
+ * Shr es aritmético, así que la mitad baja solo es una rotación si la
+ * máscara quita los bits de signo replicados. Devuelve RotateLeft(x, c).
+ */
+bool matchRotate(IRFunction& function, InstrId id) {
+    const TypeInfo& type = function.typeOf(function.instruction(id).result);
+    if (!isInteger(type)) return false;
+    int64_t bits = bitWidth(type);
+
+    for (size_t side = 0; side < 2; ++side) {
+        InstrId shl = definedBy(function, function.operand(id, side), IROpcode::Shl);
+        InstrId mask = definedBy(function, function.operand(id, 1 - side), IROpcode::And);
+        if (shl == NoInstr || mask == NoInstr) continue;
+        const IRConstant* count = function.constant(function.operand(shl, 1));
+        if (!count || count->intValue <= 0 || count->intValue >= bits) continue;
+        ValueId x = function.operand(shl, 0);
+
+        int64_t low = (int64_t{1} << count->intValue) - 1;
+        for (size_t maskSide = 0; maskSide < 2; ++maskSide) {
+            InstrId shr = definedBy(function, function.operand(mask, maskSide), IROpcode::Shr);
+            if (shr == NoInstr || !isConstant(function, function.operand(mask, 1 - maskSide), low) ||
+                function.operand(shr, 0) != x || !isConstant(function, function.operand(shr, 1), bits - count->intValue)) {
+                continue;
+            }
+            ValueId operands[] = {x, function.operand(shl, 1)};
+            InstrId rotate = function.insertBefore(id, IROpcode::RotateLeft, type, operands, true);
+            function.replaceAllUsesWith(function.instruction(id).result, function.instruction(rotate).result);
+            function.erase(id);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Cuenta protegida contra cero: Select(x == 0, w, cttz(x)) y sus variantes
+ *
+ * CountLeadingZeros y CountTrailingZeros ya dan el ancho con 0 (LZCNT y
+ * TZCNT también), así que el Select sobra.
+ */
+bool matchGuardedCount(IRFunction& function, InstrId id) {
+    ValueId condition = function.operand(id, 0);
+    InstrId compare = function.definingInstruction(condition);
+    if (compare == NoInstr) return false;
+    IROpcode predicate = function.instruction(compare).opcode;
+    if (predicate != IROpcode::CmpEQ && predicate != IROpcode::CmpNE) return false;
+
+    ValueId x = function.operand(compare, 0);
+    if (!isConstant(function, function.operand(compare, 1), 0)) {
+        if (!isConstant(function, x, 0)) return false;
+        x = function.operand(compare, 1);
+    }
+    // Con CmpEQ el valor de cero es el brazo "si"; con CmpNE, el "no"
+    ValueId zeroArm = function.operand(id, predicate == IROpcode::CmpEQ ? 1 : 2);
+    ValueId countArm = function.operand(id, predicate == IROpcode::CmpEQ ? 2 : 1);
+
+    InstrId count = function.definingInstruction(countArm);
+    if (count == NoInstr) return false;
+    IROpcode opcode = function.instruction(count).opcode;
+    if ((opcode != IROpcode::CountTrailingZeros && opcode != IROpcode::CountLeadingZeros) ||
+        function.operand(count, 0) != x || !isConstant(function, zeroArm, bitWidth(function.typeOf(x))) ||
+        function.typeOf(countArm).size != function.typeOf(function.instruction(id).result).size) {
+        return false;
+    }
+    function.replaceAllUsesWith(function.instruction(id).result, countArm);
+    function.erase(id);
+    return true;
+}
+
+} // namespace
+
+bool BitIntrinsicsPass::run(IRFunction& function) {
+    bool changed = false;
+    const auto& table = builtinOpcodes();
+
+    for (BlockId block = 0; block < function.blockCount(); ++block) {
+        for (InstrId id : function.instructions(block)) {
+            const Instruction& inst = function.instruction(id);
+            if (inst.opcode == IROpcode::Or && matchRotate(function, id)) {
+                ++idiomCount_;
+                changed = true;
+                continue;
+            }
+            if (inst.opcode == IROpcode::Select && matchGuardedCount(function, id)) {
+                ++idiomCount_;
+                changed = true;
+                continue;
+            }
+
+            if (inst.opcode != IROpcode::Call || inst.tail || function.operandCount(id) < 2) continue;
+            ValueId callee = function.operand(id, 0);
+            if (function.value(callee).kind != ValueKind::Global) continue;
+            std::string_view name = function.globalName(callee);
+            ValueId result = inst.result;
+
+            // _BitScanForward(&index, mask): índice del bit y mask != 0
+            if (name.starts_with("_BitScanForward") || name.starts_with("_BitScanReverse")) {
+                if (function.operandCount(id) != 3) continue;
+                ValueId index = function.operand(id, 1);
+                ValueId mask = function.operand(id, 2);
+                const TypeInfo& type = function.typeOf(mask);
+                if (!isInteger(type)) continue;
+                bool forward = name.starts_with("_BitScanForward");
+                InstrId scan = function.insertBefore(id, forward ? IROpcode::CountTrailingZeros
+                                                                 : IROpcode::CountLeadingZeros,
+                                                     type, std::span<const ValueId>(&mask, 1), true);
+                ValueId position = function.instruction(scan).result;
+                if (!forward) {
+                    // Índice del bit más alto: (w - 1) - clz, que es un Xor porque clz < w
+                    ValueId operands[] = {position, function.constantInt(bitWidth(type) - 1, type)};
+                    position = function.instruction(function.insertBefore(id, IROpcode::Xor, type, operands, true)).result;
+                }
+                // El índice es un unsigned long: 32 bits en Windows
+                ValueId stored = convert(function, id, position, TypeInfo(IRType::Int, 4, 4, "i32"));
+                ValueId store[] = {stored, index};
+                function.insertBefore(id, IROpcode::Store, TypeInfo(), store, false);
+                if (result != NoValue) {
+                    ValueId compare[] = {mask, function.constantInt(0, type)};
+                    InstrId nonzero = function.insertBefore(id, IROpcode::CmpNE, BoolType, compare, true);
+                    function.replaceAllUsesWith(result, convert(function, id, function.instruction(nonzero).result,
+                                                                function.typeOf(result)));
+                }
+                function.erase(id);
+                ++intrinsicCount_;
+                changed = true;
+                continue;
+            }
+
+            auto found = table.find(name);
+            if (found == table.end()) continue;
+            IROpcode opcode = found->second;
+            bool binary = opcode >= IROpcode::RotateLeft;
+            if (function.operandCount(id) != (binary ? 3u : 2u)) continue;
+            ValueId value = function.operand(id, 1);
+            const TypeInfo& type = function.typeOf(value);
+            if (!isInteger(type) || (binary && !isInteger(function.typeOf(function.operand(id, 2))))) continue;
+
+            ValueId operands[] = {value, binary ? function.operand(id, 2) : NoValue};
+            // Crc32 da 32 bits útiles; el resto, un valor del ancho del operando
+            TypeInfo resultType = result != NoValue && opcode == IROpcode::Crc32 ? function.typeOf(result) : type;
+            InstrId intrinsic = function.insertBefore(id, opcode, resultType,
+                                                      std::span<const ValueId>(operands, binary ? 2 : 1), true);
+            if (result != NoValue) {
+                function.replaceAllUsesWith(result, convert(function, id, function.instruction(intrinsic).result,
+                                                            function.typeOf(result)));
+            }
+            function.erase(id);
+            ++intrinsicCount_;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+} // namespace cpp20::compiler::ir
@@ -0,0 +1,223 @@
+/**
+ * @file BlockPlacement.cpp
+ * @brief Implementación del orden de bloques guiado por el perfil y de los caminos fríos de excepción
+ */
+
+#include <compiler/ir/IRPasses.h>
+#include <compiler/ir/IRAnalysis.h>
+#include <algorithm>
+#include <numeric>
+
+namespace cpp20::compiler::ir {
+
+namespace {
+
+// Frecuencia estimada de la entrada y vueltas supuestas de cada bucle
+constexpr double kEntryFrequency = 1 << 16;
+constexpr double kLoopTripCount = 8;
+// Probabilidad de seguir en el bucle frente a salir de él
+constexpr double kStayInLoop = 15.0 / 16;
+
+/**
+ * @brief Bloques que solo llevan a código de excepción
+ *
+ * Un LandingPad o un Resume es frío, y también el bloque cuyos sucesores
+ * lo son todos: el camino que termina relanzando una excepción.
+ */
+std::vector<bool> coldBlocks(const IRFunction& function, const ControlFlowGraph& cfg) {
+    std::vector<bool> cold(function.blockCount(), false);
+    for (BlockId block = 1; block < function.blockCount(); ++block) {
+        for (InstrId id : function.instructions(block)) {
+            IROpcode opcode = function.instruction(id).opcode;
+            if (opcode == IROpcode::LandingPad || opcode == IROpcode::Resume) {
+                cold[block] = true;
+                break;
+            }
+        }
+    }
+    const auto& order = cfg.reversePostOrder();
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            const auto& succs = cfg.successors(*it);
+            if (cold[*it] || *it == 0 || succs.empty()) continue;
+            if (std::all_of(succs.begin(), succs.end(), [&](BlockId succ) { return cold[succ]; })) {
+                cold[*it] = true;
+                changed = true;
+            }
+        }
+    }
+    return cold;
+}
+
+/**
+ * @brief Frecuencias estáticas al estilo de Wu y Larus
+ *
+ * Cada arista recibe una probabilidad: la que sale del bucle más interno
+ * del bloque es improbable, la que lleva a un bloque frío nunca se toma
+ * y el resto se reparte a partes iguales. La cabecera de un bucle
+ * multiplica por kLoopTripCount lo que le llega de fuera.
+ */
+std::vector<uint64_t> estimateFrequencies(const IRFunction& function, const ControlFlowGraph& cfg,
+                                          const LoopInfo& loops) {
+    size_t blockCount = function.blockCount();
+    std::vector<bool> cold = coldBlocks(function, cfg);
+    std::vector<double> estimate(blockCount, 0.0);
+    std::vector<double> inflow(blockCount, 0.0);    // Sin contar las aristas de retorno
+    inflow[0] = kEntryFrequency;
+
+    auto stays = [&](BlockId from, BlockId to) {
+        uint32_t loop = loops.loopFor(from);
+        return loop == NoLoop || loops.contains(loop, to);
+    };
+    for (BlockId block : cfg.reversePostOrder()) {
+        bool header = loops.loopFor(block) != NoLoop && loops.loops()[loops.loopFor(block)].header == block;
+        estimate[block] = header ? inflow[block] * kLoopTripCount : inflow[block];
+        if (cold[block]) estimate[block] = 0;
+
+        // Reparto: primero entre los que siguen en el bucle, el resto a las salidas
+        const auto& succs = cfg.successors(block);
+        size_t warm = 0, staying = 0;
+        for (BlockId succ : succs) {
+            if (cold[succ]) continue;
+            ++warm;
+            if (stays(block, succ)) ++staying;
+        }
+        if (warm == 0) continue;
+        double stayShare = staying == warm ? 1.0 : staying == 0 ? 0.0 : kStayInLoop;
+        for (BlockId succ : succs) {
+            if (cold[succ] || cfg.postOrderIndex(succ) >= cfg.postOrderIndex(block)) continue;
+            inflow[succ] += stays(block, succ) ? estimate[block] * stayShare / static_cast<double>(staying)
+                                               : estimate[block] * (1 - stayShare) / static_cast<double>(warm - staying);
+        }
+    }
+
+    // Lo alcanzable y no frío nunca llega a cero: cero es "al final"
+    std::vector<uint64_t> frequency(blockCount, 0);
+    for (BlockId block : cfg.reversePostOrder()) {
+        if (!cold[block]) frequency[block] = std::max<uint64_t>(static_cast<uint64_t>(estimate[block]), 1);
+    }
+    return frequency;
+}
+
+} // namespace
+
+bool BlockPlacementPass::run(IRFunction& function) {
+    size_t blockCount = function.blockCount();
+    if (blockCount < 2) return false;
+
+    ControlFlowGraph cfg(function);
+    DominatorTree domTree(cfg);
+    LoopInfo loops(cfg, domTree);
+    std::vector<uint64_t> frequency(blockCount, 0);
+    if (function.hasProfile()) {
+        // Los bloques sin dato (creados tras anotar) heredan el mayor de sus predecesores
+        for (BlockId block : cfg.reversePostOrder()) {
+            uint64_t known = function.blockFrequency(block);
+            if (known != UnknownFrequency) {
+                frequency[block] = known;
+                continue;
+            }
+            for (BlockId pred : cfg.predecessors(block)) {
+                frequency[block] = std::max(frequency[block], frequency[pred]);
+            }
+        }
+    } else {
+        frequency = estimateFrequencies(function, cfg, loops);
+    }
+
+    // Cabeceras de los bucles más internos que se ejecutan
+    bool aligned = false;
+    if (loopAlignment_ > 1) {
+        std::vector<bool> outer(loops.loops().size(), false);
+        for (const Loop& loop : loops.loops()) {
+            if (loop.parent != NoLoop) outer[loop.parent] = true;
+        }
+        for (uint32_t i = 0; i < loops.loops().size(); ++i) {
+            BlockId header = loops.loops()[i].header;
+            if (outer[i] || header == 0 || frequency[header] == 0) continue;
+            if (function.block(header).alignment == loopAlignment_) continue;
+            function.setBlockAlignment(header, loopAlignment_);
+            aligned = true;
+        }
+    }
+
+    // Candidatos para empezar cadena nueva, de más a menos ejecutados
+    std::vector<BlockId> byFrequency(blockCount);
+    std::iota(byFrequency.begin(), byFrequency.end(), 0);
+    std::stable_sort(byFrequency.begin(), byFrequency.end(),
+                     [&](BlockId a, BlockId b) { return frequency[a] > frequency[b]; });
+    size_t cursor = 0;
+
+    std::vector<bool> placed(blockCount, false);
+    std::vector<BlockId> layout;
+    layout.reserve(blockCount);
+    BlockId current = 0;
+    while (current != NoBlock) {
+        placed[current] = true;
+        layout.push_back(current);
+
+        BlockId next = NoBlock;
+        for (BlockId succ : cfg.successors(current)) {
+            if (!placed[succ] && frequency[succ] > 0 && (next == NoBlock || frequency[succ] > frequency[next])) {
+                next = succ;
+            }
+        }
+        if (next == NoBlock) {
+            while (cursor < blockCount && placed[byFrequency[cursor]]) ++cursor;
+            if (cursor < blockCount && frequency[byFrequency[cursor]] > 0) next = byFrequency[cursor];
+        }
+        current = next;
+    }
+
+    // Lo que no se ejecutó, al final y en el orden original
+    for (BlockId block = 0; block < blockCount; ++block) {
+        if (!placed[block]) layout.push_back(block);
+    }
+
+    if (layout == function.blockLayout()) return aligned;
+    function.setBlockLayout(std::move(layout));
+    return true;
+}
+
+bool ColdExceptionPathsPass::run(IRFunction& function) {
+    size_t blockCount = function.blockCount();
+    if (blockCount < 2) return false;
+
+    ControlFlowGraph cfg(function);
+    std::vector<bool> cold(blockCount, false);
+    bool any = false;
+    for (BlockId block = 1; block < blockCount; ++block) {
+        for (InstrId id : function.instructions(block)) {
+            if (function.instruction(id).opcode == IROpcode::LandingPad) {
+                cold[block] = true;
+                any = true;
+                break;
+            }
+        }
+    }
+    if (!any) return false;
+
+    // Frío si todos sus predecesores lo son; un bucle dentro de un catch se queda caliente
+    const auto& order = cfg.reversePostOrder();
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (BlockId block : order) {
+            const auto& preds = cfg.predecessors(block);
+            if (cold[block] || block == 0 || preds.empty()) continue;
+            if (std::all_of(preds.begin(), preds.end(), [&](BlockId pred) { return cold[pred]; })) {
+                cold[block] = true;
+                changed = true;
+            }
+        }
+    }
+
+    std::vector<BlockId> layout = function.blockLayout();
+    std::stable_partition(layout.begin(), layout.end(), [&](BlockId block) { return !cold[block]; });
+    coldBlockCount_ += static_cast<size_t>(std::count(cold.begin(), cold.end(), true));
+    if (layout == function.blockLayout()) return false;
+    function.setBlockLayout(std::move(layout));
+    return true;
+}
+
+} // namespace cpp20::compiler::ir
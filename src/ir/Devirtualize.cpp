@@ -0,0 +1,253 @@
+/**
+ * @file Devirtualize.cpp
+ * @brief Implementación del pase de desvirtualización
+ */
+
+#include <compiler/ir/IRPasses.h>
+#include <optional>
+#include <unordered_map>
+
+namespace cpp20::compiler::ir {
+
+namespace {
+
+const TypeInfo BoolType(IRType::Bool, 1, 1, "bool");
+
+/**
+ * @brief Jerarquía de clases del módulo, indexada por nombre y por vtable
+ */
+class ClassHierarchy {
+public:
+    explicit ClassHierarchy(const std::vector<IRClassInfo>& classes) : classes_(classes) {
+        for (size_t i = 0; i < classes.size(); ++i) {
+            byName_.emplace(classes[i].name, i);
+            if (!classes[i].vtableSymbol.empty()) byVtable_.emplace(classes[i].vtableSymbol, i);
+        }
+        derived_.resize(classes.size());
+        for (size_t i = 0; i < classes.size(); ++i) {
+            for (const std::string& base : classes[i].bases) {
+                auto it = byName_.find(base);
+                if (it != byName_.end()) derived_[it->second].push_back(i);
+            }
+        }
+    }
+
+    const IRClassInfo* byName(const std::string& name) const {
+        auto it = byName_.find(name);
+        return it == byName_.end() ? nullptr : &classes_[it->second];
+    }
+
+    const IRClassInfo* byVtable(const std::string& symbol) const {
+        auto it = byVtable_.find(symbol);
+        return it == byVtable_.end() ? nullptr : &classes_[it->second];
+    }
+
+    /**
+     * @brief Implementación del slot común a info y todas sus derivadas
+     *
+     * Las clases con el slot virtual puro no se pueden instanciar y no
+     * cuentan. Devuelve nullptr si hay más de una implementación o ninguna.
+     */
+    const std::string* uniqueImplementation(const IRClassInfo& info, size_t slot) const {
+        const std::string* unique = nullptr;
+        std::vector<bool> visited(classes_.size(), false);
+        std::vector<size_t> pending{static_cast<size_t>(&info - classes_.data())};
+        while (!pending.empty()) {
+            size_t current = pending.back();
+            pending.pop_back();
+            if (visited[current]) continue;
+            visited[current] = true;
+
+            const auto& methods = classes_[current].virtualMethods;
+            if (slot >= methods.size()) return nullptr;
+            const std::string& implementation = methods[slot].implementation;
+            if (!implementation.empty()) {
+                if (unique && *unique != implementation) return nullptr;
+                unique = &implementation;
+            }
+            pending.insert(pending.end(), derived_[current].begin(), derived_[current].end());
+        }
+        return unique;
+    }
+
+private:
+    const std::vector<IRClassInfo>& classes_;
+    std::unordered_map<std::string, size_t> byName_;
+    std::unordered_map<std::string, size_t> byVtable_;
+    std::vector<std::vector<size_t>> derived_;
+};
+
+/**
+ * @brief Llamada virtual reconocida y su destino
+ */
+struct VirtualCall {
+    InstrId call;
+    std::string target;
+    bool guarded;
+};
+
+/**
+ * @brief Vtable guardada en object justo antes de la carga load del mismo bloque
+ *
+ * Es lo que deja un constructor tras inlining. Cualquier llamada o store
+ * intermedio podría cambiar el vptr y corta la búsqueda.
+ */
+ValueId storedVtable(const IRFunction& function, InstrId load, ValueId object) {
+    for (InstrId id = function.instruction(load).prev; id != NoInstr; id = function.instruction(id).prev) {
+        const Instruction& inst = function.instruction(id);
+        if (inst.opcode != IROpcode::Store) {
+            if (writesMemory(inst.opcode)) return NoValue;
+            continue;
+        }
+        if (function.operand(id, 1) != object) return NoValue;
+        ValueId stored = function.operand(id, 0);
+        return function.value(stored).kind == ValueKind::Global ? stored : NoValue;
+    }
+    return NoValue;
+}
+
+/**
+ * @brief Reconoce %vptr = Load %obj; %slot = GetElementPtr %vptr, k; %fn = Load %slot
+ */
+std::optional<VirtualCall> analyzeCall(const IRFunction& function, InstrId call,
+                                       const ClassHierarchy& hierarchy, bool wholeProgram) {
+    InstrId fnLoad = function.definingInstruction(function.operand(call, 0));
+    if (fnLoad == NoInstr || function.instruction(fnLoad).opcode != IROpcode::Load) return std::nullopt;
+
+    InstrId slotAddress = function.definingInstruction(function.operand(fnLoad, 0));
+    if (slotAddress == NoInstr || function.instruction(slotAddress).opcode != IROpcode::GetElementPtr ||
+        function.operandCount(slotAddress) != 2) {
+        return std::nullopt;
+    }
+    const IRConstant* index = function.constant(function.operand(slotAddress, 1));
+    if (!index || index->intValue < 0) return std::nullopt;
+    size_t slot = static_cast<size_t>(index->intValue);
+
+    // Tipo dinámico conocido: el vptr es una vtable concreta
+    ValueId vptr = function.operand(slotAddress, 0);
+    const IRClassInfo* dynamicClass = nullptr;
+    ValueId object = NoValue;
+    if (function.value(vptr).kind == ValueKind::Global) {
+        dynamicClass = hierarchy.byVtable(function.globalName(vptr));
+    } else {
+        InstrId vptrLoad = function.definingInstruction(vptr);
+        if (vptrLoad == NoInstr || function.instruction(vptrLoad).opcode != IROpcode::Load) return std::nullopt;
+        object = function.operand(vptrLoad, 0);
+        ValueId vtable = storedVtable(function, vptrLoad, object);
+        if (vtable != NoValue) dynamicClass = hierarchy.byVtable(function.globalName(vtable));
+    }
+
+    auto implementationOf = [&](const IRClassInfo& info) -> const IRClassInfo::VirtualMethod* {
+        if (slot >= info.virtualMethods.size() || info.virtualMethods[slot].implementation.empty()) {
+            return nullptr;
+        }
+        return &info.virtualMethods[slot];
+    };
+
+    if (dynamicClass) {
+        if (const auto* method = implementationOf(*dynamicClass)) {
+            return VirtualCall{call, method->implementation, false};
+        }
+        return std::nullopt;
+    }
+    if (object == NoValue) return std::nullopt;
+
+    // Tipo estático: el del puntero al objeto
+    std::string className = function.typeOf(object).typeName;
+    if (className.empty() || className.back() != '*') return std::nullopt;
+    className.pop_back();
+    const IRClassInfo* staticClass = hierarchy.byName(className);
+    if (!staticClass) return std::nullopt;
+
+    const auto* method = implementationOf(*staticClass);
+    if (method && (staticClass->isFinal || method->isFinal)) {
+        return VirtualCall{call, method->implementation, false};
+    }
+    if (!wholeProgram) return std::nullopt;
+
+    const std::string* unique = hierarchy.uniqueImplementation(*staticClass, slot);
+    if (!unique) return std::nullopt;
+    return VirtualCall{call, *unique, true};
+}
+
+/**
+ * @brief if (%fn == @target) call @target(...) else call %fn(...)
+ */
+void guardCall(IRFunction& function, InstrId call, ValueId target) {
+    ValueId pointer = function.operand(call, 0);
+    BlockId original = function.instruction(call).block;
+    TypeInfo resultType = function.type(function.instruction(call).type);
+    ValueId indirectResult = function.instruction(call).result;
+
+    ValueId compareOperands[] = {pointer, target};
+    InstrId compare = function.insertBefore(call, IROpcode::CmpEQ, BoolType, compareOperands, true);
+
+    BlockId cont = function.splitBlockAfter(call, "devirt.cont");
+    BlockId direct = function.createBlock("devirt.direct");
+    BlockId indirect = function.createBlock("devirt.indirect");
+
+    std::vector<ValueId> operands{target};
+    for (size_t i = 1; i < function.operandCount(call); ++i) {
+        operands.push_back(function.operand(call, i));
+    }
+    InstrId directCall = function.append(direct, IROpcode::Call, resultType, operands,
+                                         indirectResult != NoValue);
+    ValueId branchOperands[] = {function.blockLabel(cont)};
+    function.append(direct, IROpcode::Br, TypeInfo(), branchOperands, false);
+
+    function.moveToEnd(call, indirect);
+    function.append(indirect, IROpcode::Br, TypeInfo(), branchOperands, false);
+
+    ValueId condOperands[] = {function.instruction(compare).result, function.blockLabel(direct),
+                              function.blockLabel(indirect)};
+    function.append(original, IROpcode::BrCond, TypeInfo(), condOperands, false);
+
+    if (indirectResult != NoValue) {
+        InstrId phi = function.prepend(cont, IROpcode::Phi, resultType, {}, true);
+        function.replaceAllUsesWith(indirectResult, function.instruction(phi).result);
+        function.addOperand(phi, function.instruction(directCall).result);
+        function.addOperand(phi, function.blockLabel(direct));
+        function.addOperand(phi, indirectResult);
+        function.addOperand(phi, function.blockLabel(indirect));
+    }
+}
+
+} // namespace
+
+bool DevirtualizePass::run(IRModule& module) {
+    if (module.getClasses().empty()) return false;
+    ClassHierarchy hierarchy(module.getClasses());
+
+    bool changed = false;
+    for (const auto& function : module.getFunctions()) {
+        // Primero se analizan todas: las protecciones parten bloques
+        std::vector<VirtualCall> calls;
+        for (BlockId block = 0; block < function->blockCount(); ++block) {
+            for (InstrId id : function->instructions(block)) {
+                IROpcode opcode = function->instruction(id).opcode;
+                if (opcode != IROpcode::Call && opcode != IROpcode::Invoke) continue;
+                if (auto call = analyzeCall(*function, id, hierarchy, wholeProgram_)) {
+                    // Un Invoke no se duplica: sus sucesores tendrían dos predecesores nuevos
+                    if (call->guarded && opcode == IROpcode::Invoke) continue;
+                    calls.push_back(std::move(*call));
+                }
+            }
+        }
+
+        for (const VirtualCall& call : calls) {
+            const TypeInfo& pointerType = function->typeOf(function->operand(call.call, 0));
+            ValueId target = function->global(call.target, pointerType);
+            if (call.guarded) {
+                guardCall(*function, call.call, target);
+                ++guardedCount_;
+            } else {
+                function->setOperand(call.call, 0, target);
+                ++devirtualizedCount_;
+            }
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+} // namespace cpp20::compiler::ir
@@ -8,77 +8,6 @@
 
 namespace cpp20::compiler::ir {
 
-// ============================================================================
-// InvokeInstruction - Implementación
-// ============================================================================
-
-std::string InvokeInstruction::toString() const {
-    std::stringstream ss;
-
-    if (result_) {
-        ss << result_->toString() << " = ";
-    }
-
-    ss << "invoke " << operands_[0]->toString() << "(";
-
-    for (size_t i = 1; i < operands_.size(); ++i) {
-        if (i > 1) ss << ", ";
-        ss << operands_[i]->toString();
-    }
-
-    ss << ") to label %" << invokeInfo_->normalBlock
-       << " unwind label %" << invokeInfo_->unwindBlock;
-
-    return ss.str();
-}
-
-// ============================================================================
-// LandingPadInstruction - Implementación
-// ============================================================================
-
-std::string LandingPadInstruction::toString() const {
-    std::stringstream ss;
-
-    if (result_) {
-        ss << result_->toString() << " = ";
-    }
-
-    ss << "landingpad ";
-
-    if (!catchTypes_.empty()) {
-        ss << "catch ";
-        for (size_t i = 0; i < catchTypes_.size(); ++i) {
-            if (i > 0) ss << ", ";
-            ss << catchTypes_[i];
-        }
-    }
-
-    if (!cleanupActions_.empty()) {
-        if (!catchTypes_.empty()) ss << " ";
-        ss << "cleanup";
-        for (const auto& action : cleanupActions_) {
-            ss << " [" << action << "]";
-        }
-    }
-
-    return ss.str();
-}
-
-// ============================================================================
-// ResumeInstruction - Implementación
-// ============================================================================
-
-std::string ResumeInstruction::toString() const {
-    std::stringstream ss;
-    ss << "resume";
-
-    if (!operands_.empty()) {
-        ss << " " << operands_[0]->toString();
-    }
-
-    return ss.str();
-}
-
 // ============================================================================
 // ExceptionHandler - Implementación
 // ============================================================================
@@ -106,8 +35,18 @@ std::shared_ptr<InvokeInfo> ExceptionHandler::createInvokeInfo(uint32_t normalBl
     return std::make_shared<InvokeInfo>(normalBlock, unwindBlock);
 }
 
+void ExceptionHandler::setLandingPadInfo(InstrId landingPad, LandingPadInfo info) {
+    landingPads_[landingPad] = std::move(info);
+}
+
+const LandingPadInfo* ExceptionHandler::getLandingPadInfo(InstrId landingPad) const {
+    auto it = landingPads_.find(landingPad);
+    return it != landingPads_.end() ? &it->second : nullptr;
+}
+
 void ExceptionHandler::clear() {
     exceptionRegions_.clear();
+    landingPads_.clear();
     nextRegionId_ = 1;
 }
 
@@ -119,72 +58,73 @@ ExceptionIRBuilder::ExceptionIRBuilder(IRBuilder& irBuilder, ExceptionHandler& e
     : irBuilder_(irBuilder), exceptionHandler_(exceptionHandler) {
 }
 
-std::unique_ptr<InvokeInstruction> ExceptionIRBuilder::createInvoke(
-    std::shared_ptr<IROperand> function,
-    const std::vector<std::shared_ptr<IROperand>>& args,
+ValueId ExceptionIRBuilder::createInvoke(
+    ValueId function,
+    std::span<const ValueId> args,
     const TypeInfo& resultType,
-    uint32_t normalBlock,
-    uint32_t unwindBlock) {
-
-    // Crear información de invoke
-    auto invokeInfo = exceptionHandler_.createInvokeInfo(normalBlock, unwindBlock);
-
-    // Crear la instrucción invoke
-    auto invokeInst = std::make_unique<InvokeInstruction>(
-        function, args, resultType, invokeInfo);
-
-    // Establecer resultado si hay tipo de retorno
-    if (resultType.type != IRType::Void) {
-        invokeInst->setResult(irBuilder_.createRegister(resultType));
-    }
-
-    return invokeInst;
+    BlockId normalBlock,
+    BlockId unwindBlock) {
+
+    IRFunction& irFunction = irBuilder_.getFunction();
+
+    // Operandos: función, argumentos y las dos etiquetas de destino
+    std::vector<ValueId> operands;
+    operands.reserve(args.size() + 3);
+    operands.push_back(function);
+    operands.insert(operands.end(), args.begin(), args.end());
+    operands.push_back(irFunction.blockLabel(normalBlock));
+    operands.push_back(irFunction.blockLabel(unwindBlock));
+
+    bool producesValue = resultType.type != IRType::Void;
+    InstrId id = irBuilder_.createInstruction(IROpcode::Invoke, resultType, operands, producesValue);
+    return irFunction.instruction(id).result;
 }
 
-std::unique_ptr<LandingPadInstruction> ExceptionIRBuilder::createLandingPad(
+ValueId ExceptionIRBuilder::createLandingPad(
     const std::vector<std::string>& catchTypes,
     const std::vector<std::string>& cleanupActions,
     const TypeInfo& resultType) {
 
-    auto landingPadInst = std::make_unique<LandingPadInstruction>(
-        catchTypes, cleanupActions, resultType);
-
-    // Establecer resultado
-    landingPadInst->setResult(irBuilder_.createRegister(resultType));
-
-    return landingPadInst;
+    InstrId id = irBuilder_.createInstruction(IROpcode::LandingPad, resultType, {}, true);
+    exceptionHandler_.setLandingPadInfo(id, LandingPadInfo{catchTypes, cleanupActions});
+    return irBuilder_.getFunction().instruction(id).result;
 }
 
-std::unique_ptr<ResumeInstruction> ExceptionIRBuilder::createResume(std::shared_ptr<IROperand> exceptionValue) {
-    return std::make_unique<ResumeInstruction>(exceptionValue);
+InstrId ExceptionIRBuilder::createResume(ValueId exceptionValue) {
+    if (exceptionValue == NoValue) {
+        return irBuilder_.createInstruction(IROpcode::Resume, TypeInfo(), {}, false);
+    }
+    ValueId operands[] = {exceptionValue};
+    return irBuilder_.createInstruction(IROpcode::Resume, TypeInfo(), operands, false);
 }
 
-std::unique_ptr<BasicBlock> ExceptionIRBuilder::createLandingPadBlock(uint32_t blockId) {
-    auto block = irBuilder_.createBasicBlock("landingpad_" + std::to_string(blockId));
+BlockId ExceptionIRBuilder::createLandingPadBlock(uint32_t blockId) {
+    BlockId block = irBuilder_.createBlock("landingpad_" + std::to_string(blockId));
+    BlockId previous = irBuilder_.getInsertBlock();
+    irBuilder_.setInsertPoint(block);
 
     // Crear landing pad instruction
     std::vector<std::string> catchTypes = {"..."}; // catch-all
     std::vector<std::string> cleanupActions = {"cleanup_stack", "destroy_locals"};
 
     TypeInfo exceptionType(IRType::Pointer, 8, 8, "std::exception_ptr");
-    auto landingPadInst = createLandingPad(catchTypes, cleanupActions, exceptionType);
-
-    block->addInstruction(std::move(landingPadInst));
+    createLandingPad(catchTypes, cleanupActions, exceptionType);
 
+    irBuilder_.setInsertPoint(previous);
     return block;
 }
 
-std::unique_ptr<BasicBlock> ExceptionIRBuilder::createCleanupBlock(uint32_t blockId) {
-    auto block = irBuilder_.createBasicBlock("cleanup_" + std::to_string(blockId));
+BlockId ExceptionIRBuilder::createCleanupBlock(uint32_t blockId) {
+    BlockId block = irBuilder_.createBlock("cleanup_" + std::to_string(blockId));
+    BlockId previous = irBuilder_.getInsertBlock();
+    irBuilder_.setInsertPoint(block);
 
     // Crear instrucciones de cleanup (simplificado)
     // En un compilador real, esto incluiría llamadas a destructores,
     // liberación de recursos, etc.
+    createResume();
 
-    TypeInfo voidType(IRType::Void);
-    auto resumeInst = createResume(nullptr);
-    block->addInstruction(std::move(resumeInst));
-
+    irBuilder_.setInsertPoint(previous);
     return block;
 }
 
@@ -4,159 +4,673 @@
  */
 
 #include <compiler/ir/IR.h>
+#include <algorithm>
+#include <bit>
+#include <cassert>
 #include <sstream>
 
 namespace cpp20::compiler::ir {
 
 // ============================================================================
-// Implementaciones de operandos
+// Opcodes
 // ============================================================================
 
-std::string Immediate::toString() const {
-    std::stringstream ss;
+const char* opcodeName(IROpcode opcode) {
+    switch (opcode) {
+        case IROpcode::Add: return "add";
+        case IROpcode::Sub: return "sub";
+        case IROpcode::Mul: return "mul";
+        case IROpcode::Div: return "div";
+        case IROpcode::Mod: return "mod";
+        case IROpcode::Neg: return "neg";
+        case IROpcode::CmpEQ: return "cmp eq";
+        case IROpcode::CmpNE: return "cmp ne";
+        case IROpcode::CmpLT: return "cmp lt";
+        case IROpcode::CmpLE: return "cmp le";
+        case IROpcode::CmpGT: return "cmp gt";
+        case IROpcode::CmpGE: return "cmp ge";
+        case IROpcode::And: return "and";
+        case IROpcode::Or: return "or";
+        case IROpcode::Xor: return "xor";
+        case IROpcode::Not: return "not";
+        case IROpcode::Shl: return "shl";
+        case IROpcode::Shr: return "shr";
+        case IROpcode::Load: return "load";
+        case IROpcode::Store: return "store";
+        case IROpcode::Alloca: return "alloca";
+        case IROpcode::GetElementPtr: return "getelementptr";
+        case IROpcode::Br: return "br";
+        case IROpcode::BrCond: return "br";
+        case IROpcode::Call: return "call";
+        case IROpcode::Ret: return "ret";
+        case IROpcode::Trunc: return "trunc";
+        case IROpcode::ZExt: return "zext";
+        case IROpcode::SExt: return "sext";
+        case IROpcode::FPTrunc: return "fptrunc";
+        case IROpcode::FPExt: return "fpext";
+        case IROpcode::FPToSI: return "fptosi";
+        case IROpcode::SIToFP: return "sitofp";
+        case IROpcode::Phi: return "phi";
+        case IROpcode::Select: return "select";
+        case IROpcode::Broadcast: return "broadcast";
+        case IROpcode::Invoke: return "invoke";
+        case IROpcode::LandingPad: return "landingpad";
+        case IROpcode::Resume: return "resume";
+        case IROpcode::Switch: return "switch";
+        case IROpcode::MemCpy: return "memcpy";
+        case IROpcode::MemSet: return "memset";
+        case IROpcode::MemCmp: return "memcmp";
+        case IROpcode::CPUFeatures: return "cpufeatures";
+        case IROpcode::PopCount: return "popcount";
+        case IROpcode::CountLeadingZeros: return "ctlz";
+        case IROpcode::CountTrailingZeros: return "cttz";
+        case IROpcode::ByteSwap: return "bswap";
+        case IROpcode::RotateLeft: return "rotl";
+        case IROpcode::RotateRight: return "rotr";
+        case IROpcode::BitDeposit: return "pdep";
+        case IROpcode::BitExtract: return "pext";
+        case IROpcode::Crc32: return "crc32";
+    }
+    return "<unknown>";
+}
+
+bool isTerminator(IROpcode opcode) {
+    switch (opcode) {
+        case IROpcode::Br:
+        case IROpcode::BrCond:
+        case IROpcode::Ret:
+        case IROpcode::Invoke:
+        case IROpcode::Resume:
+        case IROpcode::Switch:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool isPure(IROpcode opcode) {
+    switch (opcode) {
+        case IROpcode::Load:
+        case IROpcode::Store:
+        case IROpcode::Alloca:
+        case IROpcode::Call:
+        case IROpcode::Invoke:
+        case IROpcode::LandingPad:
+        case IROpcode::Resume:
+        case IROpcode::Phi:
+        case IROpcode::MemCpy:
+        case IROpcode::MemSet:
+        case IROpcode::MemCmp:
+        case IROpcode::CPUFeatures:     // CPUID serializa el núcleo: no se especula ni se duplica
+            return false;
+        default:
+            return !isTerminator(opcode);
+    }
+}
+
+bool hasSideEffects(IROpcode opcode) {
+    switch (opcode) {
+        case IROpcode::LandingPad:
+            return true;
+        default:
+            return writesMemory(opcode) || isTerminator(opcode);
+    }
+}
+
+bool writesMemory(IROpcode opcode) {
+    switch (opcode) {
+        case IROpcode::Store:
+        case IROpcode::Call:
+        case IROpcode::Invoke:
+        case IROpcode::MemCpy:
+        case IROpcode::MemSet:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// ============================================================================
+// IRFunction - Firma, tipos y valores
+// ============================================================================
+
+IRFunction::IRFunction(const std::string& name, const TypeInfo& returnType,
+                       const std::vector<TypeInfo>& paramTypes)
+    : name_(name), returnType_(returnType) {
+    for (const auto& type : paramTypes) {
+        addParameter("", type);
+    }
+}
+
+void IRFunction::addParameter(const std::string& name, const TypeInfo& type) {
+    paramNames_.push_back(name);
+    paramTypes_.push_back(type);
+    parameters_.push_back(addValue(ValueKind::Parameter, internType(type),
+                                   static_cast<uint32_t>(parameters_.size())));
+}
+
+TypeId IRFunction::internType(const TypeInfo& type) {
+    // Una función usa pocos tipos distintos: la búsqueda lineal basta
+    for (size_t i = 0; i < types_.size(); ++i) {
+        if (types_[i] == type) {
+            return static_cast<TypeId>(i);
+        }
+    }
+    types_.push_back(type);
+    return static_cast<TypeId>(types_.size() - 1);
+}
+
+ValueId IRFunction::addValue(ValueKind kind, TypeId type, uint32_t index) {
+    values_.push_back(Value{kind, type, index, NoUse});
+    return static_cast<ValueId>(values_.size() - 1);
+}
 
-    switch (type_.type) {
-        case IRType::Bool:
-            ss << (std::get<bool>(value_) ? "true" : "false");
+ValueId IRFunction::addConstant(IRConstant constant, uint64_t bits, const TypeInfo& type) {
+    TypeId typeId = internType(type);
+    auto [it, inserted] = constantIds_.try_emplace({typeId, bits}, NoValue);
+    if (inserted) {
+        constants_.push_back(constant);
+        it->second = addValue(ValueKind::Constant, typeId,
+                              static_cast<uint32_t>(constants_.size() - 1));
+    }
+    return it->second;
+}
+
+ValueId IRFunction::constantInt(int64_t value, const TypeInfo& type) {
+    IRConstant constant;
+    constant.intValue = value;
+    return addConstant(constant, static_cast<uint64_t>(value), type);
+}
+
+ValueId IRFunction::constantFloat(double value, const TypeInfo& type) {
+    IRConstant constant;
+    constant.floatValue = value;
+    return addConstant(constant, std::bit_cast<uint64_t>(value), type);
+}
+
+ValueId IRFunction::constantBool(bool value) {
+    return constantInt(value ? 1 : 0, TypeInfo(IRType::Bool, 1, 1, "bool"));
+}
+
+ValueId IRFunction::undef(const TypeInfo& type) {
+    TypeId typeId = internType(type);
+    auto [it, inserted] = undefIds_.try_emplace(typeId, NoValue);
+    if (inserted) {
+        it->second = addValue(ValueKind::Undef, typeId, 0);
+    }
+    return it->second;
+}
+
+ValueId IRFunction::global(std::string_view name, const TypeInfo& type) {
+    std::string key(name);
+    auto it = globalIds_.find(key);
+    if (it != globalIds_.end()) {
+        return it->second;
+    }
+    globals_.push_back(key);
+    ValueId id = addValue(ValueKind::Global, internType(type),
+                          static_cast<uint32_t>(globals_.size() - 1));
+    globalIds_.emplace(std::move(key), id);
+    return id;
+}
+
+const IRConstant* IRFunction::constant(ValueId id) const {
+    if (id == NoValue || values_[id].kind != ValueKind::Constant) {
+        return nullptr;
+    }
+    return &constants_[values_[id].index];
+}
+
+InstrId IRFunction::definingInstruction(ValueId id) const {
+    if (id == NoValue || values_[id].kind != ValueKind::Instruction) {
+        return NoInstr;
+    }
+    return values_[id].index;
+}
+
+// ============================================================================
+// IRFunction - Bloques
+// ============================================================================
+
+BlockId IRFunction::createBlock(const std::string& name) {
+    BlockId id = static_cast<BlockId>(blocks_.size());
+    BasicBlock block;
+    block.name = name;
+    block.label = addValue(ValueKind::Block, internType(TypeInfo(IRType::Void)), id);
+    blocks_.push_back(std::move(block));
+    if (!layout_.empty()) layout_.push_back(id);
+    return id;
+}
+
+void IRFunction::setBlockFrequency(BlockId id, uint64_t frequency) {
+    blocks_[id].frequency = frequency;
+    hasProfile_ = hasProfile_ || frequency != UnknownFrequency;
+}
+
+double IRFunction::relativeFrequency(BlockId id) const {
+    uint64_t entry = blocks_.empty() ? UnknownFrequency : blocks_[0].frequency;
+    if (!hasProfile_ || entry == UnknownFrequency || blocks_[id].frequency == UnknownFrequency) {
+        return -1.0;
+    }
+    return static_cast<double>(blocks_[id].frequency) / static_cast<double>(std::max<uint64_t>(entry, 1));
+}
+
+std::vector<BlockId> IRFunction::blockLayout() const {
+    if (!layout_.empty()) return layout_;
+    std::vector<BlockId> layout(blocks_.size());
+    for (BlockId id = 0; id < layout.size(); ++id) {
+        layout[id] = id;
+    }
+    return layout;
+}
+
+void IRFunction::setBlockLayout(std::vector<BlockId> layout) {
+    layout_ = std::move(layout);
+}
+
+InstrId IRFunction::terminator(BlockId id) const {
+    InstrId last = blocks_[id].last;
+    if (last != NoInstr && isTerminator(instructions_[last].opcode)) {
+        return last;
+    }
+    return NoInstr;
+}
+
+void IRFunction::successors(BlockId id, std::vector<BlockId>& out) const {
+    out.clear();
+    InstrId term = terminator(id);
+    if (term == NoInstr) return;
+
+    const Instruction& inst = instructions_[term];
+    switch (inst.opcode) {
+        case IROpcode::Br:
+            out.push_back(labelBlock(operand(term, 0)));
             break;
-        case IRType::Char:
-            ss << "'" << std::get<int64_t>(value_) << "'";
+        case IROpcode::BrCond:
+            out.push_back(labelBlock(operand(term, 1)));
+            if (operand(term, 2) != operand(term, 1)) {
+                out.push_back(labelBlock(operand(term, 2)));
+            }
             break;
-        case IRType::Int:
-        case IRType::Long:
-        case IRType::LongLong:
-            ss << std::get<int64_t>(value_);
+        case IROpcode::Invoke:
+            out.push_back(labelBlock(operand(term, inst.operandCount - 2)));
+            out.push_back(labelBlock(operand(term, inst.operandCount - 1)));
             break;
-        case IRType::Float:
-        case IRType::Double:
-            ss << std::get<double>(value_);
+        case IROpcode::Switch:
+            // Cada destino una vez, aunque lo compartan varios casos
+            out.push_back(labelBlock(operand(term, 1)));
+            for (size_t i = 3; i < inst.operandCount; i += 2) {
+                BlockId target = labelBlock(operand(term, i));
+                if (std::find(out.begin(), out.end(), target) == out.end()) out.push_back(target);
+            }
             break;
         default:
-            ss << "<immediate>";
             break;
     }
-
-    return ss.str();
 }
 
 // ============================================================================
-// Implementaciones de instrucciones
+// IRFunction - Instrucciones
 // ============================================================================
 
-std::string BinaryInstruction::toString() const {
-    if (!result_) return "<invalid binary instruction>";
+InstrId IRFunction::create(BlockId block, IROpcode opcode, const TypeInfo& type,
+                           std::span<const ValueId> operands, bool producesValue) {
+    InstrId id = static_cast<InstrId>(instructions_.size());
+
+    Instruction inst;
+    inst.opcode = opcode;
+    inst.type = internType(type);
+    inst.result = NoValue;
+    inst.block = block;
+    inst.firstOperand = static_cast<uint32_t>(operands_.size());
+    inst.operandCount = static_cast<uint32_t>(operands.size());
+    inst.operandCapacity = inst.operandCount;
+    inst.prev = NoInstr;
+    inst.next = NoInstr;
+
+    if (producesValue) {
+        TypeId resultType = inst.type;
+        if (opcode == IROpcode::Alloca) {
+            resultType = internType(TypeInfo(IRType::Pointer, 8, 8, type.typeName + "*"));
+        }
+        inst.result = addValue(ValueKind::Instruction, resultType, id);
+    }
+    instructions_.push_back(inst);
 
-    std::stringstream ss;
-    ss << result_->toString() << " = ";
-
-    std::string opStr;
-    switch (opcode_) {
-        case IROpcode::Add: opStr = "add"; break;
-        case IROpcode::Sub: opStr = "sub"; break;
-        case IROpcode::Mul: opStr = "mul"; break;
-        case IROpcode::Div: opStr = "div"; break;
-        case IROpcode::Mod: opStr = "mod"; break;
-        case IROpcode::And: opStr = "and"; break;
-        case IROpcode::Or: opStr = "or"; break;
-        case IROpcode::Xor: opStr = "xor"; break;
-        case IROpcode::Shl: opStr = "shl"; break;
-        case IROpcode::Shr: opStr = "shr"; break;
-        case IROpcode::CmpEQ: opStr = "cmp eq"; break;
-        case IROpcode::CmpNE: opStr = "cmp ne"; break;
-        case IROpcode::CmpLT: opStr = "cmp lt"; break;
-        case IROpcode::CmpLE: opStr = "cmp le"; break;
-        case IROpcode::CmpGT: opStr = "cmp gt"; break;
-        case IROpcode::CmpGE: opStr = "cmp ge"; break;
-        default: opStr = "<unknown>"; break;
-    }
-
-    ss << opStr << " " << operands_[0]->toString() << ", " << operands_[1]->toString();
-    return ss.str();
+    for (ValueId operand : operands) {
+        uint32_t slot = static_cast<uint32_t>(operands_.size());
+        operands_.push_back(OperandSlot{NoValue, id, NoUse, NoUse});
+        addUse(slot, operand);
+    }
+    return id;
 }
 
-std::string UnaryInstruction::toString() const {
-    if (!result_) return "<invalid unary instruction>";
+void IRFunction::link(InstrId id, BlockId block, InstrId before) {
+    Instruction& inst = instructions_[id];
+    BasicBlock& bb = blocks_[block];
+    inst.block = block;
+    inst.next = before;
 
-    std::stringstream ss;
-    ss << result_->toString() << " = ";
+    if (before == NoInstr) {
+        inst.prev = bb.last;
+        bb.last = id;
+    } else {
+        inst.prev = instructions_[before].prev;
+        instructions_[before].prev = id;
+    }
 
-    std::string opStr;
-    switch (opcode_) {
-        case IROpcode::Neg: opStr = "neg"; break;
-        case IROpcode::Not: opStr = "not"; break;
-        default: opStr = "<unknown>"; break;
+    if (inst.prev == NoInstr) {
+        bb.first = id;
+    } else {
+        instructions_[inst.prev].next = id;
     }
+}
 
-    ss << opStr << " " << operands_[0]->toString();
-    return ss.str();
+void IRFunction::unlink(InstrId id) {
+    Instruction& inst = instructions_[id];
+    BasicBlock& bb = blocks_[inst.block];
+
+    if (inst.prev == NoInstr) {
+        bb.first = inst.next;
+    } else {
+        instructions_[inst.prev].next = inst.next;
+    }
+
+    if (inst.next == NoInstr) {
+        bb.last = inst.prev;
+    } else {
+        instructions_[inst.next].prev = inst.prev;
+    }
 }
 
-std::string LoadInstruction::toString() const {
-    if (!result_) return "<invalid load instruction>";
+InstrId IRFunction::append(BlockId block, IROpcode opcode, const TypeInfo& type,
+                           std::span<const ValueId> operands, bool producesValue) {
+    InstrId id = create(block, opcode, type, operands, producesValue);
+    link(id, block, NoInstr);
+    return id;
+}
 
-    std::stringstream ss;
-    ss << result_->toString() << " = load " << operands_[0]->toString();
-    return ss.str();
+InstrId IRFunction::prepend(BlockId block, IROpcode opcode, const TypeInfo& type,
+                            std::span<const ValueId> operands, bool producesValue) {
+    InstrId id = create(block, opcode, type, operands, producesValue);
+    link(id, block, blocks_[block].first);
+    return id;
 }
 
-std::string StoreInstruction::toString() const {
-    std::stringstream ss;
-    ss << "store " << operands_[0]->toString() << ", " << operands_[1]->toString();
-    return ss.str();
+InstrId IRFunction::insertBefore(InstrId position, IROpcode opcode, const TypeInfo& type,
+                                 std::span<const ValueId> operands, bool producesValue) {
+    BlockId block = instructions_[position].block;
+    InstrId id = create(block, opcode, type, operands, producesValue);
+    link(id, block, position);
+    return id;
 }
 
-std::string BranchInstruction::toString() const {
-    std::stringstream ss;
+void IRFunction::erase(InstrId id) {
+    Instruction& inst = instructions_[id];
+    if (inst.erased) return;
+    assert((inst.result == NoValue || !hasUses(inst.result)) && "erase de un valor con usos");
 
-    if (opcode_ == IROpcode::BrCond) {
-        ss << "br " << operands_[0]->toString() << ", "
-           << operands_[1]->toString() << ", " << operands_[2]->toString();
-    } else {
-        ss << "br " << operands_[0]->toString();
+    for (uint32_t i = 0; i < inst.operandCount; ++i) {
+        removeUse(inst.firstOperand + i);
     }
 
-    return ss.str();
+    // unlink no toca inst.next: la iteración en curso puede continuar
+    unlink(id);
+    inst.erased = true;
+    ++erasedCount_;
 }
 
-std::string ReturnInstruction::toString() const {
-    std::stringstream ss;
-    ss << "ret";
+void IRFunction::clearBlock(BlockId block) {
+    std::vector<InstrId> doomed;
+    for (InstrId id : instructions(block)) {
+        doomed.push_back(id);
+        for (size_t i = 0; i < operandCount(id); ++i) {
+            setOperand(id, i, NoValue);
+        }
+    }
+    for (InstrId id : doomed) {
+        ValueId result = instructions_[id].result;
+        if (result != NoValue && hasUses(result)) {
+            replaceAllUsesWith(result, undef(typeOf(result)));
+        }
+        erase(id);
+    }
+}
 
-    if (!operands_.empty()) {
-        ss << " " << operands_[0]->toString();
+void IRFunction::moveBefore(InstrId id, InstrId position) {
+    if (id == position) return;
+    unlink(id);
+    link(id, instructions_[position].block, position);
+}
+
+void IRFunction::moveToEnd(InstrId id, BlockId block) {
+    unlink(id);
+    link(id, block, NoInstr);
+}
+
+BlockId IRFunction::splitBlockAfter(InstrId id, const std::string& name) {
+    BlockId original = instructions_[id].block;
+    BlockId tail = createBlock(name);
+    blocks_[tail].frequency = blocks_[original].frequency;
+
+    InstrId next = instructions_[id].next;
+    while (next != NoInstr) {
+        InstrId moving = next;
+        next = instructions_[moving].next;
+        moveToEnd(moving, tail);
     }
 
-    return ss.str();
+    std::vector<BlockId> successorBlocks;
+    successors(tail, successorBlocks);
+    ValueId from = blocks_[original].label;
+    ValueId to = blocks_[tail].label;
+    for (BlockId succ : successorBlocks) {
+        for (InstrId phi = blocks_[succ].first;
+             phi != NoInstr && instructions_[phi].opcode == IROpcode::Phi;
+             phi = instructions_[phi].next) {
+            for (size_t i = 1; i < instructions_[phi].operandCount; i += 2) {
+                if (operand(phi, i) == from) setOperand(phi, i, to);
+            }
+        }
+    }
+    return tail;
 }
 
-std::string CallInstruction::toString() const {
-    std::stringstream ss;
+void IRFunction::setOperand(InstrId id, size_t index, ValueId value) {
+    uint32_t slot = instructions_[id].firstOperand + static_cast<uint32_t>(index);
+    removeUse(slot);
+    addUse(slot, value);
+}
+
+void IRFunction::addOperand(InstrId id, ValueId value) {
+    Instruction& inst = instructions_[id];
 
-    if (result_) {
-        ss << result_->toString() << " = ";
+    if (inst.operandCount == inst.operandCapacity) {
+        // Reubicar al final del vector con el doble de capacidad. Los huecos
+        // que quedan atrás no se reutilizan: las funciones son de vida corta.
+        uint32_t capacity = inst.operandCapacity == 0 ? 4 : inst.operandCapacity * 2;
+        uint32_t first = static_cast<uint32_t>(operands_.size());
+        operands_.resize(operands_.size() + capacity, OperandSlot{NoValue, id, NoUse, NoUse});
+
+        for (uint32_t i = 0; i < inst.operandCount; ++i) {
+            ValueId moved = operands_[inst.firstOperand + i].value;
+            removeUse(inst.firstOperand + i);
+            addUse(first + i, moved);
+        }
+        inst.firstOperand = first;
+        inst.operandCapacity = capacity;
     }
 
-    ss << "call " << operands_[0]->toString() << "(";
+    addUse(inst.firstOperand + inst.operandCount, value);
+    ++inst.operandCount;
+}
 
-    for (size_t i = 1; i < operands_.size(); ++i) {
-        if (i > 1) ss << ", ";
-        ss << operands_[i]->toString();
+void IRFunction::removeOperand(InstrId id, size_t index) {
+    Instruction& inst = instructions_[id];
+    for (uint32_t i = static_cast<uint32_t>(index); i + 1 < inst.operandCount; ++i) {
+        ValueId next = operands_[inst.firstOperand + i + 1].value;
+        removeUse(inst.firstOperand + i);
+        addUse(inst.firstOperand + i, next);
     }
+    removeUse(inst.firstOperand + inst.operandCount - 1);
+    --inst.operandCount;
+}
 
-    ss << ")";
-    return ss.str();
+void IRFunction::removeIncoming(BlockId block, BlockId predecessor) {
+    ValueId label = blocks_[predecessor].label;
+
+    // Los phis están siempre al principio del bloque
+    for (InstrId id = blocks_[block].first;
+         id != NoInstr && instructions_[id].opcode == IROpcode::Phi;
+         id = instructions_[id].next) {
+        for (size_t i = instructions_[id].operandCount; i >= 2; i -= 2) {
+            if (operand(id, i - 1) == label) {
+                removeOperand(id, i - 1);
+                removeOperand(id, i - 2);
+            }
+        }
+    }
 }
 
 // ============================================================================
-// Implementaciones de bloques y funciones
+// IRFunction - Listas de usos
 // ============================================================================
 
-std::string BasicBlock::toString() const {
+void IRFunction::addUse(uint32_t slot, ValueId value) {
+    OperandSlot& use = operands_[slot];
+    use.value = value;
+    use.prevUse = NoUse;
+    use.nextUse = NoUse;
+    if (value == NoValue) return;
+
+    Value& target = values_[value];
+    use.nextUse = target.firstUse;
+    if (target.firstUse != NoUse) {
+        operands_[target.firstUse].prevUse = slot;
+    }
+    target.firstUse = slot;
+}
+
+void IRFunction::removeUse(uint32_t slot) {
+    OperandSlot& use = operands_[slot];
+    if (use.value == NoValue) return;
+
+    if (use.prevUse == NoUse) {
+        values_[use.value].firstUse = use.nextUse;
+    } else {
+        operands_[use.prevUse].nextUse = use.nextUse;
+    }
+    if (use.nextUse != NoUse) {
+        operands_[use.nextUse].prevUse = use.prevUse;
+    }
+
+    use.value = NoValue;
+    use.prevUse = NoUse;
+    use.nextUse = NoUse;
+}
+
+void IRFunction::replaceAllUsesWith(ValueId from, ValueId to) {
+    if (from == to) return;
+    while (values_[from].firstUse != NoUse) {
+        uint32_t slot = values_[from].firstUse;
+        removeUse(slot);
+        addUse(slot, to);
+    }
+}
+
+size_t IRFunction::useCount(ValueId id) const {
+    size_t count = 0;
+    for (uint32_t slot = values_[id].firstUse; slot != NoUse; slot = operands_[slot].nextUse) {
+        ++count;
+    }
+    return count;
+}
+
+// ============================================================================
+// IRFunction - Representación textual
+// ============================================================================
+
+std::string IRFunction::valueName(ValueId id) const {
+    if (id == NoValue) return "<none>";
+
+    const Value& v = values_[id];
+    switch (v.kind) {
+        case ValueKind::Instruction:
+            return "%" + std::to_string(id);
+        case ValueKind::Parameter:
+            if (!paramNames_[v.index].empty()) return "%" + paramNames_[v.index];
+            return "%arg" + std::to_string(v.index);
+        case ValueKind::Global:
+            return "@" + globals_[v.index];
+        case ValueKind::Block:
+            return blocks_[v.index].name;
+        case ValueKind::Undef:
+            return "undef";
+        case ValueKind::Constant: {
+            const IRConstant& c = constants_[v.index];
+            const TypeInfo& t = types_[v.type];
+            std::stringstream ss;
+            if (t.type == IRType::Bool) {
+                ss << (c.intValue ? "true" : "false");
+            } else if (t.isFloatingPoint()) {
+                ss << c.floatValue;
+            } else {
+                ss << c.intValue;
+            }
+            return ss.str();
+        }
+    }
+    return "<invalid>";
+}
+
+std::string IRFunction::instructionToString(InstrId id) const {
+    const Instruction& inst = instructions_[id];
     std::stringstream ss;
-    ss << name_ << ":\n";
 
-    for (const auto& inst : instructions_) {
-        ss << "  " << inst->toString() << "\n";
+    if (inst.result != NoValue) {
+        ss << valueName(inst.result) << " = ";
+    }
+    if (inst.tail) ss << "tail ";
+    ss << opcodeName(inst.opcode);
+
+    switch (inst.opcode) {
+        case IROpcode::Alloca:
+            ss << " " << types_[inst.type].typeName;
+            break;
+        case IROpcode::Call:
+        case IROpcode::Invoke: {
+            bool invoke = inst.opcode == IROpcode::Invoke;
+            size_t argEnd = inst.operandCount - (invoke ? 2 : 0);
+            ss << " " << valueName(operand(id, 0)) << "(";
+            for (size_t i = 1; i < argEnd; ++i) {
+                if (i > 1) ss << ", ";
+                ss << valueName(operand(id, i));
+            }
+            ss << ")";
+            if (invoke) {
+                ss << " to label " << valueName(operand(id, argEnd))
+                   << " unwind label " << valueName(operand(id, argEnd + 1));
+            }
+            break;
+        }
+        case IROpcode::Phi:
+            for (size_t i = 0; i + 1 < inst.operandCount; i += 2) {
+                ss << (i == 0 ? " " : ", ") << "[" << valueName(operand(id, i)) << ", "
+                   << valueName(operand(id, i + 1)) << "]";
+            }
+            break;
+        case IROpcode::Switch:
+            ss << " " << valueName(operand(id, 0)) << ", " << valueName(operand(id, 1));
+            for (size_t i = 2; i + 1 < inst.operandCount; i += 2) {
+                ss << (i == 2 ? " " : ", ") << "[" << valueName(operand(id, i)) << ", "
+                   << valueName(operand(id, i + 1)) << "]";
+            }
+            break;
+        default:
+            for (size_t i = 0; i < inst.operandCount; ++i) {
+                ss << (i == 0 ? " " : ", ") << valueName(operand(id, i));
+            }
+            break;
     }
 
     return ss.str();
@@ -170,29 +684,46 @@ std::string IRFunction::toString() const {
 
     for (size_t i = 0; i < paramTypes_.size(); ++i) {
         if (i > 0) ss << ", ";
-        ss << paramTypes_[i].typeName;
-        if (i < paramNames_.size()) {
-            ss << " %" << paramNames_[i];
-        }
+        ss << paramTypes_[i].typeName << " " << valueName(parameters_[i]);
     }
 
-    ss << ") {\n";
+    ss << ")";
+    if (!target_.empty()) ss << " target(\"" << target_ << "\")";
+    if (!targetClones_.empty()) {
+        ss << " target_clones(";
+        for (size_t i = 0; i < targetClones_.size(); ++i) {
+            ss << (i > 0 ? ", \"" : "\"") << targetClones_[i] << "\"";
+        }
+        ss << ")";
+    }
+    ss << " {\n";
 
     // Bloques básicos
-    for (const auto& block : blocks_) {
-        ss << block->toString();
+    for (BlockId b = 0; b < blocks_.size(); ++b) {
+        ss << blocks_[b].name << ":\n";
+        for (InstrId id : instructions(b)) {
+            ss << "  " << instructionToString(id) << "\n";
+        }
     }
 
     ss << "}\n";
     return ss.str();
 }
 
+// ============================================================================
+// Variables globales y módulos
+// ============================================================================
+
 std::string IRGlobalVariable::toString() const {
     std::stringstream ss;
     ss << "@" << name_ << " = global " << type_.typeName;
 
     if (initializer_) {
-        ss << " " << initializer_->toString();
+        if (type_.isFloatingPoint()) {
+            ss << " " << initializer_->floatValue;
+        } else {
+            ss << " " << initializer_->intValue;
+        }
     } else {
         ss << " zeroinitializer";
     }
@@ -225,126 +756,154 @@ std::string IRModule::toString() const {
 // IRBuilder - Implementación
 // ============================================================================
 
-IRBuilder::IRBuilder() = default;
-
-std::shared_ptr<Register> IRBuilder::createRegister(const TypeInfo& type) {
-    return std::make_shared<Register>(nextRegisterId_++, type);
+IRBuilder::IRBuilder(IRFunction& function) : function_(function) {
+    if (function_.blockCount() > 0) {
+        block_ = static_cast<BlockId>(function_.blockCount() - 1);
+    }
 }
 
-std::shared_ptr<Immediate> IRBuilder::createImmediate(int64_t value, const TypeInfo& type) {
-    return std::make_shared<Immediate>(value, type);
+BlockId IRBuilder::createBlock(const std::string& name) {
+    if (name.empty()) {
+        return function_.createBlock("L" + std::to_string(nextLabelId_++));
+    }
+    return function_.createBlock(name);
 }
 
-std::shared_ptr<Immediate> IRBuilder::createImmediate(double value, const TypeInfo& type) {
-    return std::make_shared<Immediate>(value, type);
+ValueId IRBuilder::getInt(int64_t value, const TypeInfo& type) {
+    return function_.constantInt(value, type);
 }
 
-std::shared_ptr<Immediate> IRBuilder::createImmediate(bool value, const TypeInfo& type) {
-    return std::make_shared<Immediate>(value, type);
+ValueId IRBuilder::getFloat(double value, const TypeInfo& type) {
+    return function_.constantFloat(value, type);
 }
 
-std::shared_ptr<Label> IRBuilder::createLabel(const std::string& name) {
-    if (name.empty()) {
-        return std::make_shared<Label>("L" + std::to_string(nextLabelId_++));
-    }
-    return std::make_shared<Label>(name);
+ValueId IRBuilder::getBool(bool value) {
+    return function_.constantBool(value);
 }
 
-std::shared_ptr<GlobalVar> IRBuilder::createGlobal(const std::string& name, const TypeInfo& type) {
-    return std::make_shared<GlobalVar>(name, type);
+ValueId IRBuilder::getGlobal(const std::string& name, const TypeInfo& type) {
+    return function_.global(name, type);
 }
 
-std::shared_ptr<Parameter> IRBuilder::createParameter(int index, const TypeInfo& type) {
-    return std::make_shared<Parameter>(index, type);
+InstrId IRBuilder::createInstruction(IROpcode opcode, const TypeInfo& type,
+                                     std::span<const ValueId> operands, bool producesValue) {
+    assert(block_ != NoBlock && "IRBuilder sin punto de inserción");
+    return function_.append(block_, opcode, type, operands, producesValue);
 }
 
-std::unique_ptr<BinaryInstruction> IRBuilder::createBinary(
-    IROpcode opcode,
-    std::shared_ptr<IROperand> left,
-    std::shared_ptr<IROperand> right,
-    const TypeInfo& resultType) {
+ValueId IRBuilder::createBinary(IROpcode opcode, ValueId left, ValueId right,
+                                const TypeInfo& resultType) {
+    ValueId operands[] = {left, right};
+    return function_.instruction(createInstruction(opcode, resultType, operands, true)).result;
+}
 
-    auto inst = std::make_unique<BinaryInstruction>(opcode, left, right, resultType);
-    inst->setResult(createRegister(resultType));
-    return inst;
+ValueId IRBuilder::createUnary(IROpcode opcode, ValueId operand, const TypeInfo& resultType) {
+    ValueId operands[] = {operand};
+    return function_.instruction(createInstruction(opcode, resultType, operands, true)).result;
 }
 
-std::unique_ptr<UnaryInstruction> IRBuilder::createUnary(
-    IROpcode opcode,
-    std::shared_ptr<IROperand> operand,
-    const TypeInfo& resultType) {
+ValueId IRBuilder::createCast(IROpcode opcode, ValueId operand, const TypeInfo& resultType) {
+    return createUnary(opcode, operand, resultType);
+}
 
-    auto inst = std::make_unique<UnaryInstruction>(opcode, operand, resultType);
-    inst->setResult(createRegister(resultType));
-    return inst;
+ValueId IRBuilder::createAlloca(const TypeInfo& allocatedType) {
+    return function_.instruction(createInstruction(IROpcode::Alloca, allocatedType, {}, true)).result;
 }
 
-std::unique_ptr<LoadInstruction> IRBuilder::createLoad(
-    std::shared_ptr<IROperand> address,
-    const TypeInfo& resultType) {
+ValueId IRBuilder::createLoad(ValueId address, const TypeInfo& resultType) {
+    ValueId operands[] = {address};
+    return function_.instruction(createInstruction(IROpcode::Load, resultType, operands, true)).result;
+}
 
-    auto inst = std::make_unique<LoadInstruction>(address, resultType);
-    inst->setResult(createRegister(resultType));
-    return inst;
+InstrId IRBuilder::createStore(ValueId value, ValueId address) {
+    ValueId operands[] = {value, address};
+    return createInstruction(IROpcode::Store, TypeInfo(), operands, false);
 }
 
-std::unique_ptr<StoreInstruction> IRBuilder::createStore(
-    std::shared_ptr<IROperand> value,
-    std::shared_ptr<IROperand> address) {
+InstrId IRBuilder::createBranch(BlockId target) {
+    ValueId operands[] = {function_.blockLabel(target)};
+    return createInstruction(IROpcode::Br, TypeInfo(), operands, false);
+}
 
-    return std::make_unique<StoreInstruction>(value, address);
+InstrId IRBuilder::createConditionalBranch(ValueId condition, BlockId trueBlock, BlockId falseBlock) {
+    ValueId operands[] = {condition, function_.blockLabel(trueBlock), function_.blockLabel(falseBlock)};
+    return createInstruction(IROpcode::BrCond, TypeInfo(), operands, false);
 }
 
-std::unique_ptr<BranchInstruction> IRBuilder::createBranch(std::shared_ptr<Label> target) {
-    return std::make_unique<BranchInstruction>(target);
+InstrId IRBuilder::createSwitch(ValueId value, BlockId defaultBlock,
+                                std::span<const std::pair<int64_t, BlockId>> cases) {
+    TypeInfo type = function_.typeOf(value);   // Copia: constantInt puede añadir tipos
+    std::vector<ValueId> operands = {value, function_.blockLabel(defaultBlock)};
+    operands.reserve(2 + 2 * cases.size());
+    for (const auto& [caseValue, target] : cases) {
+        operands.push_back(function_.constantInt(caseValue, type));
+        operands.push_back(function_.blockLabel(target));
+    }
+    return createInstruction(IROpcode::Switch, TypeInfo(), operands, false);
 }
 
-std::unique_ptr<BranchInstruction> IRBuilder::createConditionalBranch(
-    std::shared_ptr<IROperand> condition,
-    std::shared_ptr<Label> trueLabel,
-    std::shared_ptr<Label> falseLabel) {
+InstrId IRBuilder::createReturn(ValueId value) {
+    if (value == NoValue) {
+        return createInstruction(IROpcode::Ret, TypeInfo(), {}, false);
+    }
+    ValueId operands[] = {value};
+    return createInstruction(IROpcode::Ret, TypeInfo(), operands, false);
+}
 
-    return std::make_unique<BranchInstruction>(condition, trueLabel, falseLabel);
+ValueId IRBuilder::createSelect(ValueId condition, ValueId trueValue, ValueId falseValue,
+                                const TypeInfo& resultType) {
+    ValueId operands[] = {condition, trueValue, falseValue};
+    return function_.instruction(createInstruction(IROpcode::Select, resultType, operands, true)).result;
 }
 
-std::unique_ptr<ReturnInstruction> IRBuilder::createReturn(std::shared_ptr<IROperand> value) {
-    return std::make_unique<ReturnInstruction>(value);
+InstrId IRBuilder::createMemCpy(ValueId destination, ValueId source, ValueId size) {
+    ValueId operands[] = {destination, source, size};
+    return createInstruction(IROpcode::MemCpy, TypeInfo(), operands, false);
 }
 
-std::unique_ptr<CallInstruction> IRBuilder::createCall(
-    std::shared_ptr<IROperand> function,
-    const std::vector<std::shared_ptr<IROperand>>& args,
-    const TypeInfo& resultType) {
+InstrId IRBuilder::createMemSet(ValueId destination, ValueId byte, ValueId size) {
+    ValueId operands[] = {destination, byte, size};
+    return createInstruction(IROpcode::MemSet, TypeInfo(), operands, false);
+}
 
-    auto inst = std::make_unique<CallInstruction>(function, args, resultType);
-    if (resultType.type != IRType::Void) {
-        inst->setResult(createRegister(resultType));
-    }
-    return inst;
+ValueId IRBuilder::createMemCmp(ValueId left, ValueId right, ValueId size, const TypeInfo& resultType) {
+    ValueId operands[] = {left, right, size};
+    return function_.instruction(createInstruction(IROpcode::MemCmp, resultType, operands, true)).result;
 }
 
-std::unique_ptr<BasicBlock> IRBuilder::createBasicBlock(const std::string& name) {
-    return std::make_unique<BasicBlock>(name);
+ValueId IRBuilder::createCPUFeatures(const TypeInfo& resultType) {
+    return function_.instruction(createInstruction(IROpcode::CPUFeatures, resultType, {}, true)).result;
 }
 
-std::unique_ptr<IRFunction> IRBuilder::createFunction(
-    const std::string& name,
-    const TypeInfo& returnType,
-    const std::vector<TypeInfo>& paramTypes) {
+ValueId IRBuilder::createCall(ValueId function, std::span<const ValueId> args,
+                              const TypeInfo& resultType) {
+    std::vector<ValueId> operands;
+    operands.reserve(args.size() + 1);
+    operands.push_back(function);
+    operands.insert(operands.end(), args.begin(), args.end());
 
-    return std::make_unique<IRFunction>(name, returnType, paramTypes);
+    bool producesValue = resultType.type != IRType::Void;
+    InstrId id = createInstruction(IROpcode::Call, resultType, operands, producesValue);
+    return function_.instruction(id).result;
 }
 
-std::unique_ptr<IRGlobalVariable> IRBuilder::createGlobalVariable(
-    const std::string& name,
-    const TypeInfo& type,
-    std::shared_ptr<IROperand> initializer) {
+InstrId IRBuilder::createTailCall(ValueId function, std::span<const ValueId> args,
+                                  const TypeInfo& resultType) {
+    ValueId result = createCall(function, args, resultType);
+    InstrId call = function_.block(block_).last;
+    function_.setTailCall(call);
+    createReturn(result);
+    return call;
+}
 
-    return std::make_unique<IRGlobalVariable>(name, type, initializer);
+ValueId IRBuilder::createPhi(const TypeInfo& type) {
+    return function_.instruction(createInstruction(IROpcode::Phi, type, {}, true)).result;
 }
 
-std::unique_ptr<IRModule> IRBuilder::createModule(const std::string& name) {
-    return std::make_unique<IRModule>(name);
+void IRBuilder::addIncoming(ValueId phi, ValueId value, BlockId from) {
+    InstrId id = function_.definingInstruction(phi);
+    function_.addOperand(id, value);
+    function_.addOperand(id, function_.blockLabel(from));
 }
 
 } // namespace cpp20::compiler::ir
@@ -0,0 +1,239 @@
+/**
+ * @file IRAnalysis.cpp
+ * @brief Implementación de los análisis de flujo de control
+ */
+
+#include <compiler/ir/IRAnalysis.h>
+#include <algorithm>
+#include <utility>
+
+namespace cpp20::compiler::ir {
+
+// ============================================================================
+// ControlFlowGraph
+// ============================================================================
+
+ControlFlowGraph::ControlFlowGraph(const IRFunction& function)
+    : successors_(function.blockCount()), predecessors_(function.blockCount()),
+      postOrderIndex_(function.blockCount(), NoBlock) {
+
+    for (BlockId block = 0; block < function.blockCount(); ++block) {
+        function.successors(block, successors_[block]);
+        for (BlockId succ : successors_[block]) {
+            predecessors_[succ].push_back(block);
+        }
+    }
+
+    if (function.blockCount() == 0) return;
+
+    // DFS iterativo desde la entrada: (bloque, siguiente sucesor a visitar)
+    std::vector<bool> visited(function.blockCount(), false);
+    std::vector<std::pair<BlockId, size_t>> stack;
+    std::vector<BlockId> postOrder;
+    stack.emplace_back(0, 0);
+    visited[0] = true;
+
+    while (!stack.empty()) {
+        auto& [block, next] = stack.back();
+        if (next < successors_[block].size()) {
+            BlockId succ = successors_[block][next++];
+            if (!visited[succ]) {
+                visited[succ] = true;
+                stack.emplace_back(succ, 0);
+            }
+            continue;
+        }
+        postOrderIndex_[block] = static_cast<uint32_t>(postOrder.size());
+        postOrder.push_back(block);
+        stack.pop_back();
+    }
+
+    reversePostOrder_.assign(postOrder.rbegin(), postOrder.rend());
+}
+
+// ============================================================================
+// DominatorTree
+// ============================================================================
+
+DominatorTree::DominatorTree(const ControlFlowGraph& cfg)
+    : idom_(cfg.blockCount(), NoBlock), children_(cfg.blockCount()),
+      enter_(cfg.blockCount(), 0), exit_(cfg.blockCount(), 0) {
+
+    const auto& rpo = cfg.reversePostOrder();
+    if (rpo.empty()) return;
+
+    BlockId entry = rpo.front();
+    entry_ = entry;
+    idom_[entry] = entry;
+
+    auto intersect = [&](BlockId a, BlockId b) {
+        while (a != b) {
+            while (cfg.postOrderIndex(a) < cfg.postOrderIndex(b)) a = idom_[a];
+            while (cfg.postOrderIndex(b) < cfg.postOrderIndex(a)) b = idom_[b];
+        }
+        return a;
+    };
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 1; i < rpo.size(); ++i) {
+            BlockId block = rpo[i];
+            BlockId newIdom = NoBlock;
+            for (BlockId pred : cfg.predecessors(block)) {
+                if (idom_[pred] == NoBlock) continue;   // Inalcanzable o sin procesar
+                newIdom = newIdom == NoBlock ? pred : intersect(pred, newIdom);
+            }
+            if (newIdom != idom_[block]) {
+                idom_[block] = newIdom;
+                changed = true;
+            }
+        }
+    }
+
+    idom_[entry] = NoBlock;
+    for (size_t i = 1; i < rpo.size(); ++i) {
+        children_[idom_[rpo[i]]].push_back(rpo[i]);
+    }
+
+    // Preorden e intervalos [enter, exit] para responder dominates() en O(1)
+    uint32_t clock = 0;
+    std::vector<std::pair<BlockId, size_t>> stack;
+    stack.emplace_back(entry, 0);
+    enter_[entry] = clock++;
+    preorder_.push_back(entry);
+
+    while (!stack.empty()) {
+        auto& [block, next] = stack.back();
+        if (next < children_[block].size()) {
+            BlockId child = children_[block][next++];
+            enter_[child] = clock++;
+            preorder_.push_back(child);
+            stack.emplace_back(child, 0);
+            continue;
+        }
+        exit_[block] = clock++;
+        stack.pop_back();
+    }
+}
+
+bool DominatorTree::dominates(BlockId a, BlockId b) const {
+    auto reachable = [&](BlockId block) { return block == entry_ || idom_[block] != NoBlock; };
+    if (!reachable(a) || !reachable(b)) return false;
+    return enter_[a] <= enter_[b] && exit_[b] <= exit_[a];
+}
+
+std::vector<std::vector<BlockId>> DominatorTree::dominanceFrontiers(const ControlFlowGraph& cfg) const {
+    std::vector<std::vector<BlockId>> frontiers(cfg.blockCount());
+
+    for (BlockId block : cfg.reversePostOrder()) {
+        const auto& preds = cfg.predecessors(block);
+        if (preds.size() < 2) continue;
+
+        for (BlockId pred : preds) {
+            if (!cfg.isReachable(pred)) continue;
+            for (BlockId runner = pred; runner != NoBlock && runner != idom_[block]; runner = idom_[runner]) {
+                auto& frontier = frontiers[runner];
+                if (frontier.empty() || frontier.back() != block) {
+                    frontier.push_back(block);
+                }
+            }
+        }
+    }
+
+    return frontiers;
+}
+
+// ============================================================================
+// LoopInfo
+// ============================================================================
+
+LoopInfo::LoopInfo(const ControlFlowGraph& cfg, const DominatorTree& domTree)
+    : loopFor_(cfg.blockCount(), NoLoop) {
+
+    std::vector<std::vector<bool>> members;
+
+    for (BlockId header : cfg.reversePostOrder()) {
+        Loop loop;
+        loop.header = header;
+        for (BlockId pred : cfg.predecessors(header)) {
+            if (cfg.isReachable(pred) && domTree.dominates(header, pred)) {
+                loop.latches.push_back(pred);
+            }
+        }
+        if (loop.latches.empty()) continue;
+
+        // Cuerpo: bloques que llegan a alguna cola sin pasar por la cabecera
+        std::vector<bool> member(cfg.blockCount(), false);
+        member[header] = true;
+        std::vector<BlockId> worklist(loop.latches.begin(), loop.latches.end());
+        while (!worklist.empty()) {
+            BlockId block = worklist.back();
+            worklist.pop_back();
+            if (member[block]) continue;
+            member[block] = true;
+            for (BlockId pred : cfg.predecessors(block)) {
+                if (!member[pred] && cfg.isReachable(pred)) worklist.push_back(pred);
+            }
+        }
+
+        for (BlockId block : cfg.reversePostOrder()) {
+            if (member[block]) loop.blocks.push_back(block);
+        }
+        loops_.push_back(std::move(loop));
+        members.push_back(std::move(member));
+    }
+
+    // Un bucle anidado tiene estrictamente menos bloques que el que lo contiene
+    std::vector<size_t> order(loops_.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return loops_[a].blocks.size() < loops_[b].blocks.size();
+    });
+
+    std::vector<Loop> sorted;
+    std::vector<std::vector<bool>> sortedMembers;
+    for (size_t index : order) {
+        sorted.push_back(std::move(loops_[index]));
+        sortedMembers.push_back(std::move(members[index]));
+    }
+    loops_ = std::move(sorted);
+
+    for (uint32_t i = 0; i < loops_.size(); ++i) {
+        for (uint32_t j = i + 1; j < loops_.size(); ++j) {
+            if (sortedMembers[j][loops_[i].header]) {
+                loops_[i].parent = j;
+                break;
+            }
+        }
+        for (BlockId block : loops_[i].blocks) {
+            if (loopFor_[block] == NoLoop) loopFor_[block] = i;
+        }
+    }
+
+    // Profundidad: los padres van después, así que se recorre de fuera hacia dentro
+    for (size_t i = loops_.size(); i-- > 0;) {
+        uint32_t parent = loops_[i].parent;
+        loops_[i].depth = parent == NoLoop ? 1 : loops_[parent].depth + 1;
+    }
+}
+
+bool LoopInfo::contains(uint32_t loop, BlockId block) const {
+    for (uint32_t current = loopFor_[block]; current != NoLoop; current = loops_[current].parent) {
+        if (current == loop) return true;
+    }
+    return false;
+}
+
+BlockId LoopInfo::preheader(const ControlFlowGraph& cfg, uint32_t loop) const {
+    BlockId candidate = NoBlock;
+    for (BlockId pred : cfg.predecessors(loops_[loop].header)) {
+        if (contains(loop, pred)) continue;
+        if (candidate != NoBlock) return NoBlock;
+        candidate = pred;
+    }
+    if (candidate == NoBlock || cfg.successors(candidate).size() != 1) return NoBlock;
+    return candidate;
+}
+
+} // namespace cpp20::compiler::ir
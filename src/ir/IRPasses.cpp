@@ -0,0 +1,1041 @@
+/**
+ * @file IRPasses.cpp
+ * @brief Implementación de los pases de optimización de la IR
+ */
+
+#include <compiler/ir/IRPasses.h>
+#include <compiler/ir/IRAnalysis.h>
+#include <compiler/ir/Profile.h>
+#include <compiler/common/utils/MemoryTracker.h>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace cpp20::compiler::ir {
+
+namespace {
+
+// ============================================================================
+// Plegado de constantes
+// ============================================================================
+
+bool isIntegral(const TypeInfo& type) {
+    return !type.isFloatingPoint() && type.type != IRType::Void;
+}
+
+/**
+ * @brief Reduce un entero al ancho del tipo, con extensión de signo
+ */
+int64_t normalize(int64_t value, const TypeInfo& type) {
+    if (type.type == IRType::Bool) return value != 0;
+    if (type.size == 0 || type.size >= 8) return value;
+    unsigned shift = 64 - static_cast<unsigned>(type.size) * 8;
+    return static_cast<int64_t>(static_cast<uint64_t>(value) << shift) >> shift;
+}
+
+bool isCompare(IROpcode opcode) {
+    return opcode >= IROpcode::CmpEQ && opcode <= IROpcode::CmpGE;
+}
+
+template <typename T>
+bool compare(IROpcode opcode, T a, T b) {
+    switch (opcode) {
+        case IROpcode::CmpEQ: return a == b;
+        case IROpcode::CmpNE: return a != b;
+        case IROpcode::CmpLT: return a < b;
+        case IROpcode::CmpLE: return a <= b;
+        case IROpcode::CmpGT: return a > b;
+        default: return a >= b;
+    }
+}
+
+/**
+ * @brief Pliega una operación binaria; false si no es plegable
+ */
+bool foldBinary(IROpcode opcode, const TypeInfo& operandType, const IRConstant& a,
+                const IRConstant& b, const TypeInfo& resultType, IRConstant& out) {
+    if (operandType.isFloatingPoint()) {
+        double x = a.floatValue;
+        double y = b.floatValue;
+        if (isCompare(opcode)) {
+            out.intValue = compare(opcode, x, y);
+            return true;
+        }
+        switch (opcode) {
+            case IROpcode::Add: out.floatValue = x + y; break;
+            case IROpcode::Sub: out.floatValue = x - y; break;
+            case IROpcode::Mul: out.floatValue = x * y; break;
+            case IROpcode::Div: out.floatValue = x / y; break;
+            default: return false;
+        }
+        if (resultType.type == IRType::Float) {
+            out.floatValue = static_cast<float>(out.floatValue);
+        }
+        return true;
+    }
+
+    int64_t x = a.intValue;
+    int64_t y = b.intValue;
+    if (isCompare(opcode)) {
+        out.intValue = compare(opcode, x, y);
+        return true;
+    }
+
+    // Aritmética en uint64_t: el desbordamiento se trunca al ancho del tipo
+    uint64_t ux = static_cast<uint64_t>(x);
+    uint64_t uy = static_cast<uint64_t>(y);
+    uint64_t bits = operandType.size == 0 ? 64 : std::min<uint64_t>(operandType.size * 8, 64);
+    int64_t result;
+
+    switch (opcode) {
+        case IROpcode::Add: result = static_cast<int64_t>(ux + uy); break;
+        case IROpcode::Sub: result = static_cast<int64_t>(ux - uy); break;
+        case IROpcode::Mul: result = static_cast<int64_t>(ux * uy); break;
+        case IROpcode::Div:
+        case IROpcode::Mod:
+            if (y == 0 || (x == std::numeric_limits<int64_t>::min() && y == -1)) return false;
+            result = opcode == IROpcode::Div ? x / y : x % y;
+            break;
+        case IROpcode::And: result = x & y; break;
+        case IROpcode::Or: result = x | y; break;
+        case IROpcode::Xor: result = x ^ y; break;
+        case IROpcode::Shl:
+            if (y < 0 || static_cast<uint64_t>(y) >= bits) return false;
+            result = static_cast<int64_t>(ux << y);
+            break;
+        case IROpcode::Shr:
+            if (y < 0 || static_cast<uint64_t>(y) >= bits) return false;
+            result = x >> y;
+            break;
+        case IROpcode::RotateLeft:
+        case IROpcode::RotateRight: {
+            uint64_t mask = bits == 64 ? ~uint64_t{0} : (uint64_t{1} << bits) - 1;
+            uint64_t count = (opcode == IROpcode::RotateLeft ? uy : 0 - uy) % bits;
+            ux &= mask;
+            result = static_cast<int64_t>(count == 0 ? ux : ((ux << count) | (ux >> (bits - count))) & mask);
+            break;
+        }
+        case IROpcode::BitDeposit:
+        case IROpcode::BitExtract: {
+            // PDEP / PEXT bit a bit por la máscara
+            uint64_t value = 0;
+            uint64_t bit = 1;
+            for (uint64_t mask = uy; mask != 0; mask &= mask - 1, bit <<= 1) {
+                uint64_t lowest = mask & (0 - mask);
+                if (opcode == IROpcode::BitDeposit ? (ux & bit) : (ux & lowest)) {
+                    value |= opcode == IROpcode::BitDeposit ? lowest : bit;
+                }
+            }
+            result = static_cast<int64_t>(value);
+            break;
+        }
+        default:
+            return false;
+    }
+
+    out.intValue = normalize(result, resultType);
+    return true;
+}
+
+/**
+ * @brief Pliega una operación unaria o una conversión
+ */
+bool foldUnary(IROpcode opcode, const TypeInfo& operandType, const IRConstant& a,
+               const TypeInfo& resultType, IRConstant& out) {
+    switch (opcode) {
+        case IROpcode::Neg:
+            if (operandType.isFloatingPoint()) {
+                out.floatValue = -a.floatValue;
+            } else {
+                out.intValue = normalize(static_cast<int64_t>(0 - static_cast<uint64_t>(a.intValue)),
+                                         resultType);
+            }
+            return true;
+        case IROpcode::Not:
+            if (!isIntegral(operandType)) return false;
+            out.intValue = resultType.type == IRType::Bool ? !a.intValue
+                                                           : normalize(~a.intValue, resultType);
+            return true;
+        case IROpcode::Trunc:
+        case IROpcode::SExt:
+            out.intValue = normalize(a.intValue, resultType);
+            return true;
+        case IROpcode::ZExt: {
+            uint64_t value = static_cast<uint64_t>(a.intValue);
+            if (operandType.size > 0 && operandType.size < 8) {
+                value &= (uint64_t{1} << (operandType.size * 8)) - 1;
+            }
+            out.intValue = normalize(static_cast<int64_t>(value), resultType);
+            return true;
+        }
+        case IROpcode::SIToFP:
+            out.floatValue = static_cast<double>(a.intValue);
+            if (resultType.type == IRType::Float) {
+                out.floatValue = static_cast<float>(out.floatValue);
+            }
+            return true;
+        case IROpcode::FPToSI: {
+            double value = std::trunc(a.floatValue);
+            if (!(value >= -9223372036854775808.0 && value < 9223372036854775808.0)) return false;
+            out.intValue = normalize(static_cast<int64_t>(value), resultType);
+            return true;
+        }
+        case IROpcode::FPTrunc:
+            out.floatValue = static_cast<float>(a.floatValue);
+            return true;
+        case IROpcode::FPExt:
+            out.floatValue = a.floatValue;
+            return true;
+        case IROpcode::PopCount:
+        case IROpcode::CountLeadingZeros:
+        case IROpcode::CountTrailingZeros:
+        case IROpcode::ByteSwap: {
+            if (!isIntegral(operandType)) return false;
+            unsigned bits = operandType.size == 0 ? 64 : std::min<unsigned>(operandType.size * 8, 64);
+            uint64_t value = static_cast<uint64_t>(a.intValue);
+            if (bits < 64) value &= (uint64_t{1} << bits) - 1;
+            int64_t result;
+            if (opcode == IROpcode::PopCount) {
+                result = std::popcount(value);
+            } else if (opcode == IROpcode::CountLeadingZeros) {
+                result = std::countl_zero(value) - (64 - bits);
+            } else if (opcode == IROpcode::CountTrailingZeros) {
+                result = value == 0 ? bits : std::countr_zero(value);
+            } else {
+                uint64_t swapped = 0;
+                for (unsigned i = 0; i < bits / 8; ++i) swapped |= ((value >> (i * 8)) & 0xFF) << (bits - 8 - i * 8);
+                result = static_cast<int64_t>(swapped);
+            }
+            out.intValue = normalize(result, resultType);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+ValueId materialize(IRFunction& function, const IRConstant& constant, const TypeInfo& type) {
+    if (type.isFloatingPoint()) {
+        return function.constantFloat(constant.floatValue, type);
+    }
+    return function.constantInt(constant.intValue, type);
+}
+
+} // namespace
+
+// ============================================================================
+// Mem2RegPass
+// ============================================================================
+
+bool Mem2RegPass::run(IRFunction& function) {
+    if (function.blockCount() == 0) return false;
+
+    // Allocas promocionables del bloque de entrada
+    std::vector<ValueId> allocas;
+    std::unordered_map<ValueId, uint32_t> allocaIndex;
+
+    for (InstrId id : function.instructions(0)) {
+        const Instruction& inst = function.instruction(id);
+        if (inst.opcode != IROpcode::Alloca) continue;
+
+        bool promotable = true;
+        function.forEachUse(inst.result, [&](InstrId user, size_t index) {
+            IROpcode opcode = function.instruction(user).opcode;
+            if (!(opcode == IROpcode::Load && index == 0) && !(opcode == IROpcode::Store && index == 1)) {
+                promotable = false;
+            }
+        });
+
+        if (promotable) {
+            allocaIndex.emplace(inst.result, static_cast<uint32_t>(allocas.size()));
+            allocas.push_back(inst.result);
+        }
+    }
+
+    if (allocas.empty()) return false;
+
+    ControlFlowGraph cfg(function);
+    DominatorTree domTree(cfg);
+    auto frontiers = domTree.dominanceFrontiers(cfg);
+
+    auto promotedIndex = [&](ValueId address) -> uint32_t {
+        auto it = allocaIndex.find(address);
+        return it == allocaIndex.end() ? NoValue : it->second;
+    };
+
+    // Phis en la frontera de dominancia iterada de los bloques con stores
+    std::unordered_map<InstrId, uint32_t> phiAlloca;
+    for (uint32_t a = 0; a < allocas.size(); ++a) {
+        TypeInfo type = function.type(function.instruction(function.definingInstruction(allocas[a])).type);
+
+        std::vector<bool> hasPhi(function.blockCount(), false);
+        std::vector<bool> queued(function.blockCount(), false);
+        std::vector<BlockId> worklist;
+        function.forEachUse(allocas[a], [&](InstrId user, size_t) {
+            BlockId block = function.instruction(user).block;
+            if (function.instruction(user).opcode == IROpcode::Store && cfg.isReachable(block) && !queued[block]) {
+                queued[block] = true;
+                worklist.push_back(block);
+            }
+        });
+
+        while (!worklist.empty()) {
+            BlockId block = worklist.back();
+            worklist.pop_back();
+            for (BlockId frontier : frontiers[block]) {
+                if (hasPhi[frontier]) continue;
+                hasPhi[frontier] = true;
+                InstrId phi = function.prepend(frontier, IROpcode::Phi, type, {}, true);
+                phiAlloca.emplace(phi, a);
+                if (!queued[frontier]) {
+                    queued[frontier] = true;
+                    worklist.push_back(frontier);
+                }
+            }
+        }
+    }
+
+    // Renombrado en preorden del árbol de dominadores
+    std::vector<std::vector<ValueId>> current(allocas.size());
+    for (uint32_t a = 0; a < allocas.size(); ++a) {
+        TypeInfo type = function.type(function.instruction(function.definingInstruction(allocas[a])).type);
+        current[a].push_back(function.undef(type));
+    }
+
+    std::vector<uint32_t> undoLog;
+    auto rewriteBlock = [&](BlockId block) {
+        for (InstrId id : function.instructions(block)) {
+            const Instruction& inst = function.instruction(id);
+            if (inst.opcode == IROpcode::Phi) {
+                auto it = phiAlloca.find(id);
+                if (it != phiAlloca.end()) {
+                    current[it->second].push_back(inst.result);
+                    undoLog.push_back(it->second);
+                }
+            } else if (inst.opcode == IROpcode::Load) {
+                uint32_t a = promotedIndex(function.operand(id, 0));
+                if (a == NoValue) continue;
+                function.replaceAllUsesWith(inst.result, current[a].back());
+                function.erase(id);
+            } else if (inst.opcode == IROpcode::Store) {
+                uint32_t a = promotedIndex(function.operand(id, 1));
+                if (a == NoValue) continue;
+                current[a].push_back(function.operand(id, 0));
+                undoLog.push_back(a);
+                function.erase(id);
+            }
+        }
+
+        for (BlockId succ : cfg.successors(block)) {
+            for (InstrId id : function.instructions(succ)) {
+                if (function.instruction(id).opcode != IROpcode::Phi) break;
+                auto it = phiAlloca.find(id);
+                if (it == phiAlloca.end()) continue;
+                function.addOperand(id, current[it->second].back());
+                function.addOperand(id, function.blockLabel(block));
+            }
+        }
+    };
+
+    // (bloque, tamaño del undoLog al entrar, siguiente hijo)
+    struct Visit {
+        BlockId block;
+        size_t undoMark;
+        size_t nextChild;
+    };
+    std::vector<Visit> stack;
+    stack.push_back({0, undoLog.size(), 0});
+    rewriteBlock(0);
+
+    while (!stack.empty()) {
+        Visit& visit = stack.back();
+        const auto& children = domTree.children(visit.block);
+        if (visit.nextChild < children.size()) {
+            BlockId child = children[visit.nextChild++];
+            stack.push_back({child, undoLog.size(), 0});
+            rewriteBlock(child);
+            continue;
+        }
+        while (undoLog.size() > visit.undoMark) {
+            current[undoLog.back()].pop_back();
+            undoLog.pop_back();
+        }
+        stack.pop_back();
+    }
+
+    // Bloques inalcanzables: sus loads leen undef
+    for (BlockId block = 0; block < function.blockCount(); ++block) {
+        if (!cfg.isReachable(block)) {
+            rewriteBlock(block);
+        }
+    }
+
+    for (ValueId alloca : allocas) {
+        function.erase(function.definingInstruction(alloca));
+    }
+    return true;
+}
+
+// ============================================================================
+// SCCPPass
+// ============================================================================
+
+namespace {
+
+struct LatticeValue {
+    enum State : uint8_t { Unknown, Constant, Overdefined };
+    State state = Unknown;
+    IRConstant constant;
+};
+
+class SCCPSolver {
+public:
+    explicit SCCPSolver(IRFunction& function)
+        : function_(function), lattice_(function.valueCount()),
+          executable_(function.blockCount(), false) {
+        for (ValueId id = 0; id < function.valueCount(); ++id) {
+            switch (function.value(id).kind) {
+                case ValueKind::Constant:
+                    lattice_[id].state = LatticeValue::Constant;
+                    lattice_[id].constant = *function.constant(id);
+                    break;
+                case ValueKind::Parameter:
+                case ValueKind::Global:
+                case ValueKind::Block:
+                    lattice_[id].state = LatticeValue::Overdefined;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    void solve() {
+        markExecutable(0);
+        do {
+            propagate();
+        } while (resolveUndefinedBranches());
+    }
+
+    bool apply();
+
+private:
+    /**
+     * @brief Switch con una sola arista ejecutable -> Br
+     */
+    bool foldSwitch(BlockId block, InstrId term);
+
+    IRFunction& function_;
+    std::vector<LatticeValue> lattice_;
+    std::vector<bool> executable_;
+    std::unordered_set<uint64_t> executableEdges_;
+    std::vector<BlockId> blockWorklist_;
+    std::vector<InstrId> instructionWorklist_;
+
+    void propagate() {
+        while (!blockWorklist_.empty() || !instructionWorklist_.empty()) {
+            while (!instructionWorklist_.empty()) {
+                InstrId id = instructionWorklist_.back();
+                instructionWorklist_.pop_back();
+                const Instruction& inst = function_.instruction(id);
+                if (!inst.erased && executable_[inst.block]) {
+                    visit(id);
+                }
+            }
+            while (!blockWorklist_.empty()) {
+                BlockId block = blockWorklist_.back();
+                blockWorklist_.pop_back();
+                for (InstrId id : function_.instructions(block)) {
+                    visit(id);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Un salto sobre una condición que sigue indefinida (undef) puede
+     * ir a cualquier lado: se marcan ambas aristas
+     */
+    bool resolveUndefinedBranches() {
+        bool resolved = false;
+        for (BlockId block = 0; block < function_.blockCount(); ++block) {
+            InstrId term = function_.terminator(block);
+            if (!executable_[block] || term == NoInstr ||
+                (function_.instruction(term).opcode != IROpcode::BrCond &&
+                 function_.instruction(term).opcode != IROpcode::Switch) ||
+                get(function_.operand(term, 0)).state != LatticeValue::Unknown) {
+                continue;
+            }
+            size_t before = executableEdges_.size();
+            std::vector<BlockId> successors;
+            function_.successors(block, successors);
+            for (BlockId succ : successors) {
+                markEdge(block, succ);
+            }
+            resolved |= executableEdges_.size() != before;
+        }
+        return resolved;
+    }
+
+    /**
+     * @brief Destino de un Switch para un valor conocido
+     */
+    BlockId switchTarget(InstrId id, int64_t value) const {
+        for (size_t i = 2; i + 1 < function_.operandCount(id); i += 2) {
+            if (function_.constant(function_.operand(id, i))->intValue == value) {
+                return function_.labelBlock(function_.operand(id, i + 1));
+            }
+        }
+        return function_.labelBlock(function_.operand(id, 1));
+    }
+
+    static uint64_t edgeKey(BlockId from, BlockId to) {
+        return (static_cast<uint64_t>(from) << 32) | to;
+    }
+
+    bool isEdgeExecutable(BlockId from, BlockId to) const {
+        return executableEdges_.count(edgeKey(from, to)) != 0;
+    }
+
+    const LatticeValue& get(ValueId id) const { return lattice_[id]; }
+
+    void markExecutable(BlockId block) {
+        if (!executable_[block]) {
+            executable_[block] = true;
+            blockWorklist_.push_back(block);
+        }
+    }
+
+    void markEdge(BlockId from, BlockId to) {
+        if (!executableEdges_.insert(edgeKey(from, to)).second) return;
+        if (executable_[to]) {
+            // Nueva entrada para los phis de un bloque ya visitado
+            for (InstrId id : function_.instructions(to)) {
+                if (function_.instruction(id).opcode != IROpcode::Phi) break;
+                instructionWorklist_.push_back(id);
+            }
+        } else {
+            markExecutable(to);
+        }
+    }
+
+    void update(ValueId id, const LatticeValue& value) {
+        LatticeValue& slot = lattice_[id];
+        if (slot.state == LatticeValue::Overdefined || value.state == LatticeValue::Unknown) return;
+        if (slot.state == LatticeValue::Constant && value.state == LatticeValue::Constant) return;
+        slot = value;
+        function_.forEachUse(id, [&](InstrId user, size_t) {
+            instructionWorklist_.push_back(user);
+        });
+    }
+
+    void overdefine(ValueId id) {
+        LatticeValue value;
+        value.state = LatticeValue::Overdefined;
+        update(id, value);
+    }
+
+    static bool sameConstant(const IRConstant& a, const IRConstant& b) {
+        return a.intValue == b.intValue &&
+               std::memcmp(&a.floatValue, &b.floatValue, sizeof(double)) == 0;
+    }
+
+    void visit(InstrId id);
+    void visitPhi(InstrId id, const Instruction& inst);
+};
+
+void SCCPSolver::visitPhi(InstrId id, const Instruction& inst) {
+    LatticeValue merged;
+    for (size_t i = 0; i + 1 < inst.operandCount; i += 2) {
+        BlockId from = function_.labelBlock(function_.operand(id, i + 1));
+        if (!isEdgeExecutable(from, inst.block)) continue;
+
+        const LatticeValue& incoming = get(function_.operand(id, i));
+        if (incoming.state == LatticeValue::Unknown) continue;
+        if (incoming.state == LatticeValue::Overdefined ||
+            (merged.state == LatticeValue::Constant && !sameConstant(merged.constant, incoming.constant))) {
+            overdefine(inst.result);
+            return;
+        }
+        merged = incoming;
+    }
+    update(inst.result, merged);
+}
+
+void SCCPSolver::visit(InstrId id) {
+    const Instruction& inst = function_.instruction(id);
+
+    switch (inst.opcode) {
+        case IROpcode::Phi:
+            visitPhi(id, inst);
+            return;
+
+        case IROpcode::Br:
+            markEdge(inst.block, function_.labelBlock(function_.operand(id, 0)));
+            return;
+
+        case IROpcode::BrCond: {
+            const LatticeValue& cond = get(function_.operand(id, 0));
+            BlockId trueBlock = function_.labelBlock(function_.operand(id, 1));
+            BlockId falseBlock = function_.labelBlock(function_.operand(id, 2));
+            if (cond.state == LatticeValue::Constant) {
+                markEdge(inst.block, cond.constant.intValue ? trueBlock : falseBlock);
+            } else if (cond.state == LatticeValue::Overdefined) {
+                markEdge(inst.block, trueBlock);
+                markEdge(inst.block, falseBlock);
+            }
+            return;
+        }
+
+        case IROpcode::Switch: {
+            const LatticeValue& value = get(function_.operand(id, 0));
+            if (value.state == LatticeValue::Constant) {
+                markEdge(inst.block, switchTarget(id, value.constant.intValue));
+            } else if (value.state == LatticeValue::Overdefined) {
+                std::vector<BlockId> successors;
+                function_.successors(inst.block, successors);
+                for (BlockId succ : successors) {
+                    markEdge(inst.block, succ);
+                }
+            }
+            return;
+        }
+
+        case IROpcode::Invoke: {
+            std::vector<BlockId> successors;
+            function_.successors(inst.block, successors);
+            for (BlockId succ : successors) {
+                markEdge(inst.block, succ);
+            }
+            if (inst.result != NoValue) overdefine(inst.result);
+            return;
+        }
+
+        case IROpcode::Select: {
+            const LatticeValue& cond = get(function_.operand(id, 0));
+            if (cond.state == LatticeValue::Constant) {
+                update(inst.result, get(function_.operand(id, cond.constant.intValue ? 1 : 2)));
+            } else if (cond.state == LatticeValue::Overdefined) {
+                const LatticeValue& a = get(function_.operand(id, 1));
+                const LatticeValue& b = get(function_.operand(id, 2));
+                if (a.state == LatticeValue::Constant && b.state == LatticeValue::Constant &&
+                    sameConstant(a.constant, b.constant)) {
+                    update(inst.result, a);
+                } else if (a.state == LatticeValue::Overdefined || b.state == LatticeValue::Overdefined ||
+                           (a.state == LatticeValue::Constant && b.state == LatticeValue::Constant)) {
+                    overdefine(inst.result);
+                }
+            }
+            return;
+        }
+
+        default:
+            break;
+    }
+
+    if (inst.result == NoValue) return;
+
+    if (!isPure(inst.opcode) || inst.operandCount == 0 || inst.operandCount > 2 ||
+        inst.opcode == IROpcode::GetElementPtr) {
+        overdefine(inst.result);
+        return;
+    }
+
+    for (size_t i = 0; i < inst.operandCount; ++i) {
+        const LatticeValue& operand = get(function_.operand(id, i));
+        if (operand.state == LatticeValue::Overdefined) {
+            overdefine(inst.result);
+            return;
+        }
+        if (operand.state == LatticeValue::Unknown) return;
+    }
+
+    const TypeInfo& operandType = function_.typeOf(function_.operand(id, 0));
+    const TypeInfo& resultType = function_.type(inst.type);
+    LatticeValue folded;
+    bool ok = inst.operandCount == 2
+        ? foldBinary(inst.opcode, operandType, get(function_.operand(id, 0)).constant,
+                     get(function_.operand(id, 1)).constant, resultType, folded.constant)
+        : foldUnary(inst.opcode, operandType, get(function_.operand(id, 0)).constant,
+                    resultType, folded.constant);
+
+    if (ok) {
+        folded.state = LatticeValue::Constant;
+        update(inst.result, folded);
+    } else {
+        overdefine(inst.result);
+    }
+}
+
+bool SCCPSolver::apply() {
+    bool changed = false;
+
+    // Bloques inalcanzables: primero se quitan sus entradas de los phis
+    std::vector<BlockId> successors;
+    for (BlockId block = 0; block < function_.blockCount(); ++block) {
+        if (executable_[block] || function_.block(block).first == NoInstr) continue;
+        function_.successors(block, successors);
+        for (BlockId succ : successors) {
+            function_.removeIncoming(succ, block);
+        }
+        function_.clearBlock(block);
+        changed = true;
+    }
+
+    for (BlockId block = 0; block < function_.blockCount(); ++block) {
+        if (!executable_[block]) continue;
+
+        for (InstrId id : function_.instructions(block)) {
+            const Instruction& inst = function_.instruction(id);
+            if (inst.result == NoValue || hasSideEffects(inst.opcode)) continue;
+
+            const LatticeValue& value = lattice_[inst.result];
+            if (value.state != LatticeValue::Constant) continue;
+
+            ValueId constant = materialize(function_, value.constant, function_.typeOf(inst.result));
+            function_.replaceAllUsesWith(inst.result, constant);
+            function_.erase(id);
+            changed = true;
+        }
+
+        // Saltos con una sola arista ejecutable
+        InstrId term = function_.terminator(block);
+        if (term != NoInstr && function_.instruction(term).opcode == IROpcode::Switch) {
+            changed |= foldSwitch(block, term);
+            continue;
+        }
+        if (term == NoInstr || function_.instruction(term).opcode != IROpcode::BrCond) continue;
+
+        BlockId trueBlock = function_.labelBlock(function_.operand(term, 1));
+        BlockId falseBlock = function_.labelBlock(function_.operand(term, 2));
+        bool takesTrue = isEdgeExecutable(block, trueBlock);
+        bool takesFalse = isEdgeExecutable(block, falseBlock);
+        if (trueBlock == falseBlock || takesTrue == takesFalse) continue;
+
+        BlockId target = takesTrue ? trueBlock : falseBlock;
+        BlockId dropped = takesTrue ? falseBlock : trueBlock;
+        function_.erase(term);
+        ValueId label = function_.blockLabel(target);
+        function_.append(block, IROpcode::Br, TypeInfo(), std::span<const ValueId>(&label, 1), false);
+        function_.removeIncoming(dropped, block);
+        changed = true;
+    }
+
+    return changed;
+}
+
+bool SCCPSolver::foldSwitch(BlockId block, InstrId term) {
+    std::vector<BlockId> successors;
+    function_.successors(block, successors);
+    BlockId target = NoBlock;
+    for (BlockId succ : successors) {
+        if (!isEdgeExecutable(block, succ)) continue;
+        if (target != NoBlock) return false;
+        target = succ;
+    }
+    if (target == NoBlock) return false;
+
+    function_.erase(term);
+    ValueId label = function_.blockLabel(target);
+    function_.append(block, IROpcode::Br, TypeInfo(), std::span<const ValueId>(&label, 1), false);
+    for (BlockId succ : successors) {
+        if (succ != target) function_.removeIncoming(succ, block);
+    }
+    return true;
+}
+
+} // namespace
+
+bool SCCPPass::run(IRFunction& function) {
+    if (function.blockCount() == 0) return false;
+    SCCPSolver solver(function);
+    solver.solve();
+    return solver.apply();
+}
+
+// ============================================================================
+// GVNPass
+// ============================================================================
+
+namespace {
+
+struct ExpressionKey {
+    IROpcode opcode;
+    TypeId type;
+    ValueId operands[3];
+
+    bool operator==(const ExpressionKey& other) const {
+        return opcode == other.opcode && type == other.type &&
+               operands[0] == other.operands[0] && operands[1] == other.operands[1] &&
+               operands[2] == other.operands[2];
+    }
+};
+
+struct ExpressionKeyHash {
+    size_t operator()(const ExpressionKey& key) const {
+        uint64_t h = static_cast<uint64_t>(key.opcode) * 0x9e3779b97f4a7c15ull ^ key.type;
+        for (ValueId operand : key.operands) {
+            h = (h ^ operand) * 0x100000001b3ull;
+        }
+        return static_cast<size_t>(h ^ (h >> 29));
+    }
+};
+
+bool isCommutative(IROpcode opcode) {
+    switch (opcode) {
+        case IROpcode::Add:
+        case IROpcode::Mul:
+        case IROpcode::And:
+        case IROpcode::Or:
+        case IROpcode::Xor:
+        case IROpcode::CmpEQ:
+        case IROpcode::CmpNE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Valor único de un phi si todas sus entradas (salvo él mismo) coinciden
+ */
+ValueId trivialPhiValue(const IRFunction& function, InstrId phi) {
+    ValueId self = function.instruction(phi).result;
+    ValueId unique = NoValue;
+    for (size_t i = 0; i + 1 < function.operandCount(phi); i += 2) {
+        ValueId incoming = function.operand(phi, i);
+        if (incoming == self || incoming == unique) continue;
+        if (unique != NoValue) return NoValue;
+        unique = incoming;
+    }
+    return unique;
+}
+
+} // namespace
+
+bool GVNPass::run(IRFunction& function) {
+    if (function.blockCount() == 0) return false;
+
+    ControlFlowGraph cfg(function);
+    DominatorTree domTree(cfg);
+
+    bool changed = false;
+    std::unordered_map<ExpressionKey, ValueId, ExpressionKeyHash> table;
+    std::vector<ExpressionKey> undoLog;
+
+    auto processBlock = [&](BlockId block) {
+        for (InstrId id : function.instructions(block)) {
+            const Instruction& inst = function.instruction(id);
+
+            if (inst.opcode == IROpcode::Phi) {
+                ValueId unique = trivialPhiValue(function, id);
+                if (unique != NoValue) {
+                    function.replaceAllUsesWith(inst.result, unique);
+                    function.erase(id);
+                    changed = true;
+                }
+                continue;
+            }
+
+            if (inst.result == NoValue || !isPure(inst.opcode) || inst.operandCount > 3) continue;
+
+            ExpressionKey key{inst.opcode, inst.type, {NoValue, NoValue, NoValue}};
+            for (size_t i = 0; i < inst.operandCount; ++i) {
+                key.operands[i] = function.operand(id, i);
+            }
+            if (isCommutative(inst.opcode) && key.operands[1] < key.operands[0]) {
+                std::swap(key.operands[0], key.operands[1]);
+            }
+
+            auto [it, inserted] = table.try_emplace(key, inst.result);
+            if (inserted) {
+                undoLog.push_back(key);
+            } else {
+                function.replaceAllUsesWith(inst.result, it->second);
+                function.erase(id);
+                changed = true;
+            }
+        }
+    };
+
+    struct Visit {
+        BlockId block;
+        size_t undoMark;
+        size_t nextChild;
+    };
+    std::vector<Visit> stack;
+    stack.push_back({0, 0, 0});
+    processBlock(0);
+
+    while (!stack.empty()) {
+        Visit& visit = stack.back();
+        const auto& children = domTree.children(visit.block);
+        if (visit.nextChild < children.size()) {
+            BlockId child = children[visit.nextChild++];
+            stack.push_back({child, undoLog.size(), 0});
+            processBlock(child);
+            continue;
+        }
+        while (undoLog.size() > visit.undoMark) {
+            table.erase(undoLog.back());
+            undoLog.pop_back();
+        }
+        stack.pop_back();
+    }
+
+    return changed;
+}
+
+// ============================================================================
+// DeadCodeEliminationPass
+// ============================================================================
+
+bool DeadCodeEliminationPass::run(IRFunction& function) {
+    std::vector<bool> live(function.instructionCapacity(), false);
+    std::vector<InstrId> worklist;
+
+    for (BlockId block = 0; block < function.blockCount(); ++block) {
+        for (InstrId id : function.instructions(block)) {
+            if (hasSideEffects(function.instruction(id).opcode)) {
+                live[id] = true;
+                worklist.push_back(id);
+            }
+        }
+    }
+
+    while (!worklist.empty()) {
+        InstrId id = worklist.back();
+        worklist.pop_back();
+        for (size_t i = 0; i < function.operandCount(id); ++i) {
+            InstrId def = function.definingInstruction(function.operand(id, i));
+            if (def != NoInstr && !live[def]) {
+                live[def] = true;
+                worklist.push_back(def);
+            }
+        }
+    }
+
+    // Dos fases: los muertos pueden usarse entre sí (ciclos de phis)
+    std::vector<InstrId> dead;
+    for (BlockId block = 0; block < function.blockCount(); ++block) {
+        for (InstrId id : function.instructions(block)) {
+            if (!live[id]) {
+                dead.push_back(id);
+                for (size_t i = 0; i < function.operandCount(id); ++i) {
+                    function.setOperand(id, i, NoValue);
+                }
+            }
+        }
+    }
+    for (InstrId id : dead) {
+        function.erase(id);
+    }
+
+    return !dead.empty();
+}
+
+// ============================================================================
+// PassManager
+// ============================================================================
+
+void PassManager::addPass(std::unique_ptr<FunctionPass> pass) {
+    PassStats stats;
+    stats.name = pass->getName();
+    stats_.push_back(std::move(stats));
+    passes_.push_back(std::move(pass));
+}
+
+bool PassManager::run(IRFunction& function) {
+    common::utils::MemoryScope memoryScope(common::utils::MemorySubsystem::IR);
+    bool changed = false;
+    for (size_t i = 0; i < passes_.size(); ++i) {
+        size_t before = function.instructionCount();
+        bool passChanged = passes_[i]->run(function);
+
+        PassStats& stats = stats_[i];
+        ++stats.runs;
+        if (passChanged) ++stats.changes;
+        if (function.instructionCount() < before) {
+            stats.instructionsRemoved += before - function.instructionCount();
+        }
+        changed |= passChanged;
+    }
+    return changed;
+}
+
+void PassManager::addModulePass(std::unique_ptr<ModulePass> pass) {
+    PassStats stats;
+    stats.name = pass->getName();
+    moduleStats_.push_back(std::move(stats));
+    modulePasses_.push_back(std::move(pass));
+}
+
+std::vector<PassManager::PassStats> PassManager::getStats() const {
+    std::vector<PassStats> all(moduleStats_);
+    all.insert(all.end(), stats_.begin(), stats_.end());
+    return all;
+}
+
+bool PassManager::run(IRModule& module) {
+    common::utils::MemoryScope memoryScope(common::utils::MemorySubsystem::IR);
+    bool changed = false;
+    for (size_t i = 0; i < modulePasses_.size(); ++i) {
+        bool passChanged = modulePasses_[i]->run(module);
+        ++moduleStats_[i].runs;
+        if (passChanged) ++moduleStats_[i].changes;
+        changed |= passChanged;
+    }
+
+    for (const auto& function : module.getFunctions()) {
+        changed |= run(*function);
+    }
+    return changed;
+}
+
+PassManager PassManager::createForOptimizationLevel(int level, VectorTarget target, bool wholeProgram,
+                                                    ProfileOptions pgo) {
+    PassManager manager;
+    if (pgo.instrument) {
+        manager.addModulePass(std::make_unique<ProfileInstrumentationPass>());
+    } else if (pgo.profile) {
+        manager.addModulePass(std::make_unique<ProfileAnnotatePass>(*pgo.profile));
+    }
+    // target_clones es semántica, no una optimización: también a -O0
+    manager.addModulePass(std::make_unique<MultiversioningPass>());
+    if (level <= 0) return manager;
+
+    if (level >= 2) {
+        manager.addModulePass(std::make_unique<DevirtualizePass>(wholeProgram));
+    }
+    manager.addModulePass(std::make_unique<InlinerPass>(InlineCostModel::forOptimizationLevel(level)));
+    manager.addPass(std::make_unique<Mem2RegPass>());
+    manager.addPass(std::make_unique<BitIntrinsicsPass>());
+    manager.addPass(std::make_unique<SCCPPass>());
+    if (level >= 2) {
+        manager.addPass(std::make_unique<GVNPass>());
+        manager.addPass(std::make_unique<LICMPass>());
+        manager.addPass(level >= 3 ? std::make_unique<LoopUnrollPass>(16, 256)
+                                   : std::make_unique<LoopUnrollPass>(8, 128));
+        manager.addPass(std::make_unique<LoopVectorizePass>(target));
+        manager.addPass(std::make_unique<LoopStrengthReductionPass>());
+        manager.addPass(std::make_unique<SCCPPass>());
+    }
+    manager.addPass(std::make_unique<DeadCodeEliminationPass>());
+    manager.addPass(std::make_unique<MemoryIntrinsicsPass>(target));
+    if (level >= 2) {
+        manager.addPass(std::make_unique<IfConversionPass>());
+        manager.addPass(std::make_unique<TailCallPass>());
+    }
+    manager.addPass(std::make_unique<SwitchLoweringPass>());
+    if (level >= 2 && !pgo.instrument) {
+        manager.addPass(std::make_unique<BlockPlacementPass>());
+    }
+    manager.addPass(std::make_unique<ColdExceptionPathsPass>());
+    return manager;
+}
+
+} // namespace cpp20::compiler::ir
@@ -0,0 +1,552 @@
+/**
+ * @file IRSerialization.cpp
+ * @brief Escritura y lectura del formato binario de la IR
+ */
+
+#include <compiler/ir/IRSerialization.h>
+#include <bit>
+#include <cstring>
+#include <unordered_map>
+
+namespace cpp20::compiler::ir {
+
+namespace {
+
+constexpr char kMagic[6] = {'C', 'P', 'P', 'I', 'R', '1'};
+
+constexpr uint8_t kLastType = static_cast<uint8_t>(IRType::Vector);
+constexpr uint8_t kLastOpcode = static_cast<uint8_t>(IROpcode::Crc32);
+constexpr uint8_t kLastKind = static_cast<uint8_t>(ValueKind::Undef);
+constexpr uint8_t kNoValue = 0xFF;      // Operando vacío, en lugar de la clase de valor
+
+// ============================================================================
+// Codificación
+// ============================================================================
+
+class Encoder {
+public:
+    explicit Encoder(std::vector<uint8_t>& out) : out_(out) {}
+
+    void u8(uint8_t value) { out_.push_back(value); }
+
+    void u64(uint64_t value) {
+        for (int i = 0; i < 8; ++i) out_.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            out_.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out_.push_back(static_cast<uint8_t>(value));
+    }
+
+    // Zigzag: los negativos pequeños también ocupan poco
+    void svarint(int64_t value) {
+        varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    void bytes(std::span<const uint8_t> data) { out_.insert(out_.end(), data.begin(), data.end()); }
+
+private:
+    std::vector<uint8_t>& out_;
+};
+
+class Decoder {
+public:
+    explicit Decoder(std::span<const uint8_t> data) : data_(data) {}
+
+    bool ok() const { return ok_; }
+    bool atEnd() const { return position_ == data_.size(); }
+    void fail() { ok_ = false; }
+
+    uint8_t u8() {
+        if (!ok_ || position_ >= data_.size()) return failed();
+        return data_[position_++];
+    }
+
+    uint64_t u64() {
+        if (!ok_ || data_.size() - position_ < 8) return failed();
+        uint64_t value = 0;
+        for (int i = 0; i < 8; ++i) value |= static_cast<uint64_t>(data_[position_++]) << (8 * i);
+        return value;
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = u8();
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        return failed();
+    }
+
+    int64_t svarint() {
+        uint64_t value = varint();
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    /**
+     * @brief Índice o recuento que debe ser menor que limit
+     */
+    uint32_t index(size_t limit) {
+        uint64_t value = varint();
+        if (value >= limit) return static_cast<uint32_t>(failed());
+        return static_cast<uint32_t>(value);
+    }
+
+    std::string_view view(size_t size) {
+        if (!ok_ || data_.size() - position_ < size) {
+            failed();
+            return {};
+        }
+        std::string_view result(reinterpret_cast<const char*>(data_.data() + position_), size);
+        position_ += size;
+        return result;
+    }
+
+    size_t remaining() const { return data_.size() - position_; }
+
+private:
+    std::span<const uint8_t> data_;
+    size_t position_ = 0;
+    bool ok_ = true;
+
+    uint64_t failed() {
+        ok_ = false;
+        return 0;
+    }
+};
+
+// ============================================================================
+// Escritura
+// ============================================================================
+
+class ModuleWriter {
+public:
+    explicit ModuleWriter(std::vector<uint8_t>& body) : body_(body) {}
+
+    void string(Encoder& encoder, const std::string& value) {
+        auto [it, inserted] = stringIds_.try_emplace(value, static_cast<uint32_t>(strings_.size()));
+        if (inserted) strings_.push_back(&it->first);
+        encoder.varint(it->second);
+    }
+
+    void type(Encoder& encoder, const TypeInfo& type) {
+        encoder.u8(static_cast<uint8_t>(type.type));
+        encoder.varint(type.size);
+        encoder.varint(type.alignment);
+        string(encoder, type.typeName);
+        encoder.u8(static_cast<uint8_t>(type.elementType));
+        encoder.varint(type.lanes);
+    }
+
+    void writeModule(const IRModule& module);
+
+    const std::vector<const std::string*>& strings() const { return strings_; }
+
+private:
+    std::vector<uint8_t>& body_;
+    std::unordered_map<std::string, uint32_t> stringIds_;
+    std::vector<const std::string*> strings_;
+
+    void writeFunction(Encoder& encoder, const IRFunction& function);
+};
+
+void ModuleWriter::writeModule(const IRModule& module) {
+    Encoder encoder(body_);
+    string(encoder, module.getName());
+
+    encoder.varint(module.getGlobals().size());
+    for (const auto& global : module.getGlobals()) {
+        string(encoder, global->getName());
+        type(encoder, global->getType());
+        const auto& initializer = global->getInitializer();
+        encoder.u8(initializer ? 1 : 0);
+        if (initializer) {
+            encoder.svarint(initializer->intValue);
+            encoder.u64(std::bit_cast<uint64_t>(initializer->floatValue));
+        }
+    }
+
+    encoder.varint(module.getClasses().size());
+    for (const auto& info : module.getClasses()) {
+        string(encoder, info.name);
+        string(encoder, info.vtableSymbol);
+        encoder.varint(info.bases.size());
+        for (const auto& base : info.bases) string(encoder, base);
+        encoder.varint(info.virtualMethods.size());
+        for (const auto& method : info.virtualMethods) {
+            string(encoder, method.implementation);
+            encoder.u8(method.isFinal ? 1 : 0);
+        }
+        encoder.u8(info.isFinal ? 1 : 0);
+    }
+
+    encoder.varint(module.getInitializers().size());
+    for (const auto& initializer : module.getInitializers()) string(encoder, initializer);
+
+    encoder.varint(module.getFunctions().size());
+    for (const auto& function : module.getFunctions()) {
+        writeFunction(encoder, *function);
+    }
+}
+
+void ModuleWriter::writeFunction(Encoder& encoder, const IRFunction& function) {
+    // Tipos propios del formato: solo los que se usan, en orden de aparición
+    std::vector<TypeInfo> types;
+    auto typeIndex = [&](const TypeInfo& info) {
+        for (size_t i = 0; i < types.size(); ++i) {
+            if (types[i] == info) return static_cast<uint32_t>(i);
+        }
+        types.push_back(info);
+        return static_cast<uint32_t>(types.size() - 1);
+    };
+
+    // Número de cada resultado en el orden de los bloques
+    std::vector<uint32_t> results(function.valueCount(), ~0u);
+    uint32_t resultCount = 0;
+    for (BlockId block = 0; block < function.blockCount(); ++block) {
+        for (InstrId id : function.instructions(block)) {
+            ValueId result = function.instruction(id).result;
+            if (result != NoValue) results[result] = resultCount++;
+        }
+    }
+
+    std::vector<uint8_t> code;
+    Encoder body(code);
+    body.varint(typeIndex(function.getReturnType()));
+    body.varint(function.getParamTypes().size());
+    for (size_t i = 0; i < function.getParamTypes().size(); ++i) {
+        body.varint(typeIndex(function.getParamTypes()[i]));
+        string(body, function.getParamNames()[i]);
+    }
+
+    body.varint(function.blockCount());
+    for (BlockId block = 0; block < function.blockCount(); ++block) {
+        string(body, function.block(block).name);
+    }
+
+    std::vector<InstrId> instructions;
+    for (BlockId block = 0; block < function.blockCount(); ++block) {
+        instructions.clear();
+        for (InstrId id : function.instructions(block)) instructions.push_back(id);
+        body.varint(instructions.size());
+
+        for (InstrId id : instructions) {
+            const Instruction& inst = function.instruction(id);
+            body.u8(static_cast<uint8_t>(inst.opcode));
+            body.varint(typeIndex(function.type(inst.type)));
+            body.u8((inst.result != NoValue ? 1 : 0) | (inst.tail ? 2 : 0));
+            body.varint(function.operandCount(id));
+
+            for (size_t i = 0; i < function.operandCount(id); ++i) {
+                ValueId operand = function.operand(id, i);
+                if (operand == NoValue) {
+                    body.u8(kNoValue);
+                    continue;
+                }
+                const Value& value = function.value(operand);
+                body.u8(static_cast<uint8_t>(value.kind));
+                switch (value.kind) {
+                    case ValueKind::Instruction:
+                        body.varint(results[operand]);
+                        break;
+                    case ValueKind::Constant: {
+                        const TypeInfo& constantType = function.typeOf(operand);
+                        body.varint(typeIndex(constantType));
+                        if (constantType.isFloatingPoint()) {
+                            body.u64(std::bit_cast<uint64_t>(function.constant(operand)->floatValue));
+                        } else {
+                            body.svarint(function.constant(operand)->intValue);
+                        }
+                        break;
+                    }
+                    case ValueKind::Parameter:
+                        body.varint(value.index);
+                        break;
+                    case ValueKind::Global:
+                        string(body, function.globalName(operand));
+                        body.varint(typeIndex(function.typeOf(operand)));
+                        break;
+                    case ValueKind::Block:
+                        body.varint(function.labelBlock(operand));
+                        break;
+                    case ValueKind::Undef:
+                        body.varint(typeIndex(function.typeOf(operand)));
+                        break;
+                }
+            }
+        }
+    }
+
+    string(encoder, function.getName());
+    encoder.u8(static_cast<uint8_t>(function.getInlineHint()));
+    encoder.u8(static_cast<uint8_t>(function.getLinkage()));
+    encoder.varint(function.getTargetClones().size());
+    for (const auto& target : function.getTargetClones()) string(encoder, target);
+    string(encoder, function.getTarget());
+    encoder.varint(resultCount);
+    encoder.varint(types.size());
+    for (const auto& info : types) type(encoder, info);
+    encoder.varint(code.size());
+    encoder.bytes(code);
+}
+
+// ============================================================================
+// Lectura
+// ============================================================================
+
+class ModuleReader {
+public:
+    ModuleReader(Decoder& decoder, std::vector<std::string_view> strings)
+        : decoder_(decoder), strings_(std::move(strings)) {}
+
+    std::string string() { return string(decoder_); }
+
+    std::string string(Decoder& decoder) {
+        uint32_t index = decoder.index(strings_.size());
+        return decoder.ok() ? std::string(strings_[index]) : std::string();
+    }
+
+    TypeInfo type() {
+        uint8_t kind = decoder_.u8();
+        if (kind > kLastType) decoder_.fail();
+        TypeInfo info(static_cast<IRType>(kind));
+        info.size = decoder_.varint();
+        info.alignment = decoder_.varint();
+        info.typeName = string();
+        uint8_t element = decoder_.u8();
+        if (element > kLastType) decoder_.fail();
+        info.elementType = static_cast<IRType>(element);
+        info.lanes = static_cast<uint32_t>(decoder_.varint());
+        return info;
+    }
+
+    std::unique_ptr<IRModule> readModule();
+
+private:
+    Decoder& decoder_;
+    std::vector<std::string_view> strings_;
+
+    std::unique_ptr<IRFunction> readFunction();
+};
+
+std::unique_ptr<IRModule> ModuleReader::readModule() {
+    auto module = std::make_unique<IRModule>(string());
+
+    // Cada elemento ocupa al menos un byte: un recuento mayor que lo que queda es basura
+    size_t globalCount = decoder_.index(decoder_.remaining() + 1);
+    for (size_t i = 0; i < globalCount && decoder_.ok(); ++i) {
+        std::string name = string();
+        TypeInfo globalType = type();
+        std::optional<IRConstant> initializer;
+        if (decoder_.u8()) {
+            IRConstant constant;
+            constant.intValue = decoder_.svarint();
+            constant.floatValue = std::bit_cast<double>(decoder_.u64());
+            initializer = constant;
+        }
+        module->addGlobalVariable(std::make_unique<IRGlobalVariable>(name, globalType, initializer));
+    }
+
+    size_t classCount = decoder_.index(decoder_.remaining() + 1);
+    for (size_t i = 0; i < classCount && decoder_.ok(); ++i) {
+        IRClassInfo info;
+        info.name = string();
+        info.vtableSymbol = string();
+        size_t baseCount = decoder_.index(decoder_.remaining() + 1);
+        for (size_t j = 0; j < baseCount && decoder_.ok(); ++j) info.bases.push_back(string());
+        size_t methodCount = decoder_.index(decoder_.remaining() + 1);
+        for (size_t j = 0; j < methodCount && decoder_.ok(); ++j) {
+            IRClassInfo::VirtualMethod method;
+            method.implementation = string();
+            method.isFinal = decoder_.u8() != 0;
+            info.virtualMethods.push_back(std::move(method));
+        }
+        info.isFinal = decoder_.u8() != 0;
+        module->addClass(std::move(info));
+    }
+
+    size_t initializerCount = decoder_.index(decoder_.remaining() + 1);
+    for (size_t i = 0; i < initializerCount && decoder_.ok(); ++i) module->addInitializer(string());
+
+    size_t functionCount = decoder_.index(decoder_.remaining() + 1);
+    for (size_t i = 0; i < functionCount && decoder_.ok(); ++i) {
+        auto function = readFunction();
+        if (!function) return nullptr;
+        module->addFunction(std::move(function));
+    }
+    if (!decoder_.ok()) return nullptr;
+    return module;
+}
+
+std::unique_ptr<IRFunction> ModuleReader::readFunction() {
+    std::string name = string();
+    uint8_t hint = decoder_.u8();
+    uint8_t linkage = decoder_.u8();
+    if (hint > static_cast<uint8_t>(InlineHint::Never) || linkage > static_cast<uint8_t>(Linkage::LinkOnce)) {
+        return nullptr;
+    }
+    std::vector<std::string> targetClones(decoder_.index(decoder_.remaining() + 1));
+    for (auto& target : targetClones) target = string();
+    std::string target = string();
+    size_t resultCount = decoder_.index(decoder_.remaining() + 1);
+    std::vector<TypeInfo> types(decoder_.index(decoder_.remaining() + 1));
+    for (auto& info : types) info = type();
+    size_t codeSize = decoder_.index(decoder_.remaining() + 1);
+    if (!decoder_.ok() || types.empty()) return nullptr;
+
+    Decoder code(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(decoder_.view(codeSize).data()), codeSize));
+    if (!decoder_.ok()) return nullptr;
+    auto typeAt = [&]() -> const TypeInfo& { return types[code.index(types.size())]; };
+
+    auto function = std::make_unique<IRFunction>(name, typeAt(), std::vector<TypeInfo>{});
+    function->setInlineHint(static_cast<InlineHint>(hint));
+    function->setLinkage(static_cast<Linkage>(linkage));
+    function->setTargetClones(std::move(targetClones));
+    function->setTarget(target);
+
+    size_t paramCount = code.index(code.remaining() + 1);
+    for (size_t i = 0; i < paramCount && code.ok(); ++i) {
+        const TypeInfo& paramType = typeAt();
+        function->addParameter(string(code), paramType);
+    }
+
+    size_t blockCount = code.index(code.remaining() + 1);
+    for (size_t i = 0; i < blockCount && code.ok(); ++i) {
+        function->createBlock(string(code));
+    }
+
+    // Los phis pueden usar resultados posteriores: se enlazan al final
+    struct ForwardUse {
+        InstrId user;
+        size_t operand;
+        uint32_t result;
+    };
+    std::vector<ValueId> results(resultCount, NoValue);
+    uint32_t nextResult = 0;
+    std::vector<ForwardUse> forwardUses;
+    std::vector<ValueId> operands;
+    ValueId placeholder = NoValue;
+
+    for (BlockId block = 0; block < blockCount && code.ok(); ++block) {
+        size_t instructionCount = code.index(code.remaining() + 1);
+        for (size_t i = 0; i < instructionCount && code.ok(); ++i) {
+            uint8_t opcode = code.u8();
+            if (opcode > kLastOpcode) return nullptr;
+            const TypeInfo& resultType = typeAt();
+            uint8_t flags = code.u8();
+            if (flags > 3) return nullptr;
+            bool producesValue = flags & 1;
+            size_t operandCount = code.index(code.remaining() + 1);
+
+            operands.clear();
+            size_t firstForward = forwardUses.size();
+            for (size_t j = 0; j < operandCount && code.ok(); ++j) {
+                uint8_t kind = code.u8();
+                if (kind == kNoValue) {
+                    operands.push_back(NoValue);
+                    continue;
+                }
+                if (kind > kLastKind) return nullptr;
+                switch (static_cast<ValueKind>(kind)) {
+                    case ValueKind::Instruction: {
+                        uint32_t result = code.index(resultCount);
+                        if (code.ok() && results[result] == NoValue) {
+                            if (placeholder == NoValue) placeholder = function->undef(TypeInfo());
+                            forwardUses.push_back({NoInstr, j, result});
+                            operands.push_back(placeholder);
+                        } else {
+                            operands.push_back(code.ok() ? results[result] : NoValue);
+                        }
+                        break;
+                    }
+                    case ValueKind::Constant: {
+                        const TypeInfo& constantType = typeAt();
+                        if (!code.ok()) return nullptr;
+                        operands.push_back(constantType.isFloatingPoint()
+                                               ? function->constantFloat(std::bit_cast<double>(code.u64()),
+                                                                         constantType)
+                                               : function->constantInt(code.svarint(), constantType));
+                        break;
+                    }
+                    case ValueKind::Parameter: {
+                        uint32_t index = code.index(paramCount);
+                        operands.push_back(code.ok() ? function->parameter(index) : NoValue);
+                        break;
+                    }
+                    case ValueKind::Global: {
+                        std::string global = string(code);
+                        const TypeInfo& globalType = typeAt();
+                        operands.push_back(function->global(global, globalType));
+                        break;
+                    }
+                    case ValueKind::Block: {
+                        uint32_t target = code.index(blockCount);
+                        operands.push_back(code.ok() ? function->blockLabel(target) : NoValue);
+                        break;
+                    }
+                    case ValueKind::Undef:
+                        operands.push_back(function->undef(typeAt()));
+                        break;
+                }
+            }
+            if (!code.ok()) return nullptr;
+
+            InstrId id = function->append(static_cast<BlockId>(block), static_cast<IROpcode>(opcode),
+                                          resultType, operands, producesValue);
+            if (flags & 2) function->setTailCall(id);
+            for (size_t k = firstForward; k < forwardUses.size(); ++k) forwardUses[k].user = id;
+            if (producesValue) {
+                if (nextResult == resultCount) return nullptr;
+                results[nextResult++] = function->instruction(id).result;
+            }
+        }
+    }
+    if (!code.ok() || !code.atEnd()) return nullptr;
+
+    for (const ForwardUse& use : forwardUses) {
+        if (results[use.result] == NoValue) return nullptr;
+        function->setOperand(use.user, use.operand, results[use.result]);
+    }
+    return function;
+}
+
+} // namespace
+
+void serializeModule(const IRModule& module, std::vector<uint8_t>& out) {
+    std::vector<uint8_t> body;
+    ModuleWriter writer(body);
+    writer.writeModule(module);
+
+    Encoder encoder(out);
+    encoder.bytes(std::span(reinterpret_cast<const uint8_t*>(kMagic), sizeof(kMagic)));
+    encoder.varint(writer.strings().size());
+    for (const std::string* value : writer.strings()) {
+        encoder.varint(value->size());
+        encoder.bytes(std::span(reinterpret_cast<const uint8_t*>(value->data()), value->size()));
+    }
+    encoder.bytes(body);
+}
+
+std::unique_ptr<IRModule> deserializeModule(std::span<const uint8_t> bytes) {
+    if (bytes.size() < sizeof(kMagic) || std::memcmp(bytes.data(), kMagic, sizeof(kMagic)) != 0) {
+        return nullptr;
+    }
+
+    Decoder decoder(bytes.subspan(sizeof(kMagic)));
+    std::vector<std::string_view> strings(decoder.index(decoder.remaining() + 1));
+    for (auto& value : strings) {
+        value = decoder.view(decoder.index(decoder.remaining() + 1));
+    }
+    if (!decoder.ok()) return nullptr;
+
+    ModuleReader reader(decoder, std::move(strings));
+    auto module = reader.readModule();
+    if (!module || !decoder.ok() || !decoder.atEnd()) return nullptr;
+    return module;
+}
+
+} // namespace cpp20::compiler::ir
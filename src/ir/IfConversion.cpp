@@ -0,0 +1,222 @@
+/**
+ * @file IfConversion.cpp
+ * @brief Implementación de la conversión de rombos y triángulos pequeños en Select
+ */
+
+#include <compiler/ir/IRPasses.h>
+#include <compiler/ir/IRAnalysis.h>
+#include <algorithm>
+
+namespace cpp20::compiler::ir {
+
+namespace {
+
+const TypeInfo BoolType(IRType::Bool, 1, 1, "bool");
+
+bool isCompare(IROpcode opcode) {
+    return opcode >= IROpcode::CmpEQ && opcode <= IROpcode::CmpGE;
+}
+
+/**
+ * @brief Comparación que produjo el valor, o NoInstr
+ */
+InstrId compareOf(const IRFunction& function, ValueId value) {
+    if (function.value(value).kind != ValueKind::Instruction) return NoInstr;
+    InstrId id = function.definingInstruction(value);
+    return isCompare(function.instruction(id).opcode) ? id : NoInstr;
+}
+
+/**
+ * @brief Rama de un rombo: el bloque lateral (o NoBlock si la arista va directa a la unión)
+ */
+struct Arm {
+    BlockId block = NoBlock;
+    BlockId join = NoBlock;
+};
+
+} // namespace
+
+int IfConversionPass::speculationCost(const IRFunction& function, InstrId id) {
+    const Instruction& inst = function.instruction(id);
+    if (!isPure(inst.opcode) || inst.opcode == IROpcode::Switch) return -1;
+    bool floating = inst.result != NoValue && function.typeOf(inst.result).isFloatingPoint();
+    switch (inst.opcode) {
+        // Las divisiones enteras pueden lanzar #DE: no se ejecutan si la rama no se toma
+        case IROpcode::Div:
+        case IROpcode::Mod:
+            return floating ? 12 : -1;
+        case IROpcode::Mul:
+            return floating ? 4 : 3;
+        case IROpcode::Add:
+        case IROpcode::Sub:
+            return floating ? 3 : 1;
+        case IROpcode::FPTrunc:
+        case IROpcode::FPExt:
+        case IROpcode::FPToSI:
+        case IROpcode::SIToFP:
+            return 3;
+        case IROpcode::Broadcast:
+            return -1;
+        default:
+            return 1;
+    }
+}
+
+bool IfConversionPass::run(IRFunction& function) {
+    bool changed = false;
+    for (bool swept = true; swept;) {
+        swept = false;
+        ControlFlowGraph cfg(function);
+        std::vector<bool> touched(function.blockCount(), false);
+
+        // En postorden: los rombos interiores se convierten antes que los que los contienen
+        const auto& order = cfg.reversePostOrder();
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            BlockId head = *it;
+            InstrId term = function.terminator(head);
+            if (term == NoInstr || function.instruction(term).opcode != IROpcode::BrCond) continue;
+            BlockId onTrue = function.labelBlock(function.operand(term, 1));
+            BlockId onFalse = function.labelBlock(function.operand(term, 2));
+            if (onTrue == onFalse || touched[head] || touched[onTrue] || touched[onFalse]) continue;
+
+            // Un lado es un bloque con un único predecesor que salta a la unión
+            auto sideOf = [&](BlockId block) -> Arm {
+                const auto& preds = cfg.predecessors(block);
+                InstrId last = function.terminator(block);
+                if (preds.size() != 1 || last == NoInstr || function.instruction(last).opcode != IROpcode::Br) {
+                    return {};
+                }
+                return {block, function.labelBlock(function.operand(last, 0))};
+            };
+            Arm trueArm = sideOf(onTrue), falseArm = sideOf(onFalse);
+            BlockId join = NoBlock;
+            if (trueArm.block != NoBlock && falseArm.block != NoBlock && trueArm.join == falseArm.join) {
+                join = trueArm.join;
+            } else if (trueArm.block != NoBlock && trueArm.join == onFalse) {
+                join = onFalse;
+                falseArm = {};
+            } else if (falseArm.block != NoBlock && falseArm.join == onTrue) {
+                join = onTrue;
+                trueArm = {};
+            } else {
+                continue;
+            }
+            if (join == head || touched[join]) continue;
+
+            // Con perfil, una rama casi siempre igual la acierta el predictor
+            if (function.hasProfile() && function.blockFrequency(head) != UnknownFrequency) {
+                uint64_t total = function.blockFrequency(head);
+                uint64_t rare = UnknownFrequency;
+                for (const Arm& arm : {trueArm, falseArm}) {
+                    if (arm.block != NoBlock && function.blockFrequency(arm.block) != UnknownFrequency) {
+                        rare = std::min(rare, std::min(function.blockFrequency(arm.block),
+                                                       total - std::min(total, function.blockFrequency(arm.block))));
+                    }
+                }
+                if (rare != UnknownFrequency && rare * options_.predictableRatio < total) continue;
+            }
+
+            // Coste de ejecutar los dos lados y de un Select por phi
+            int cost = 0;
+            bool speculatable = true;
+            for (const Arm& arm : {trueArm, falseArm}) {
+                if (arm.block == NoBlock) continue;
+                for (InstrId id : function.instructions(arm.block)) {
+                    if (id == function.terminator(arm.block)) break;
+                    int instructionCost = speculationCost(function, id);
+                    if (instructionCost < 0) speculatable = false;
+                    cost += instructionCost;
+                }
+            }
+            size_t selects = 0;
+            for (InstrId id : function.instructions(join)) {
+                if (function.instruction(id).opcode != IROpcode::Phi) break;
+                ++selects;
+            }
+            if (!speculatable || selects > options_.maxSelects ||
+                cost + static_cast<int>(selects) > options_.maxSpeculatedCost) {
+                continue;
+            }
+
+            // Las comparaciones de coma flotante por igualdad necesitan la paridad: se dejan
+            ValueId condition = function.operand(term, 0);
+            InstrId compare = compareOf(function, condition);
+            if (compare != NoInstr && function.typeOf(function.operand(compare, 0)).isFloatingPoint() &&
+                (function.instruction(compare).opcode == IROpcode::CmpEQ ||
+                 function.instruction(compare).opcode == IROpcode::CmpNE)) {
+                continue;
+            }
+
+            for (const Arm& arm : {trueArm, falseArm}) {
+                if (arm.block == NoBlock) continue;
+                InstrId last = function.terminator(arm.block);
+                for (InstrId id = function.block(arm.block).first; id != last;) {
+                    InstrId next = function.instruction(id).next;
+                    function.moveBefore(id, term);
+                    id = next;
+                }
+            }
+
+            // Un Select por phi; cada uno con su copia de la comparación justo delante,
+            // así el back-end fija los flags en la misma instrucción que el CMOVcc
+            BlockId fromTrue = trueArm.block != NoBlock ? trueArm.block : head;
+            BlockId fromFalse = falseArm.block != NoBlock ? falseArm.block : head;
+            std::vector<std::pair<InstrId, ValueId>> merged;
+            for (InstrId phi : function.instructions(join)) {
+                if (function.instruction(phi).opcode != IROpcode::Phi) break;
+                ValueId whenTrue = NoValue, whenFalse = NoValue;
+                for (size_t i = 0; i + 1 < function.operandCount(phi); i += 2) {
+                    BlockId from = function.labelBlock(function.operand(phi, i + 1));
+                    if (from == fromTrue) whenTrue = function.operand(phi, i);
+                    if (from == fromFalse) whenFalse = function.operand(phi, i);
+                }
+                ValueId value = whenTrue;
+                if (whenTrue != whenFalse) {
+                    ValueId flag = condition;
+                    if (compare != NoInstr) {
+                        ValueId operands[] = {function.operand(compare, 0), function.operand(compare, 1)};
+                        flag = function.instruction(function.insertBefore(term, function.instruction(compare).opcode,
+                                                                          BoolType, operands, true)).result;
+                    }
+                    ValueId operands[] = {flag, whenTrue, whenFalse};
+                    value = function.instruction(function.insertBefore(term, IROpcode::Select,
+                                                                       function.typeOf(function.instruction(phi).result),
+                                                                       operands, true)).result;
+                    ++selectCount_;
+                }
+                merged.emplace_back(phi, value);
+            }
+            for (BlockId from : {fromTrue, fromFalse}) {
+                if (from != head) function.removeIncoming(join, from);
+            }
+            function.removeIncoming(join, head);
+            for (const auto& [phi, value] : merged) {
+                function.addOperand(phi, value);
+                function.addOperand(phi, function.blockLabel(head));
+            }
+
+            function.erase(term);
+            ValueId label = function.blockLabel(join);
+            function.append(head, IROpcode::Br, TypeInfo(), std::span<const ValueId>(&label, 1), false);
+            for (const Arm& arm : {trueArm, falseArm}) {
+                if (arm.block != NoBlock) function.clearBlock(arm.block);
+            }
+            if (compare != NoInstr && !function.hasUses(condition)) function.erase(compare);
+
+            // Si head era la única entrada de la unión, cada phi ya es su valor
+            if (cfg.predecessors(join).size() == 2) {
+                for (const auto& [phi, value] : merged) {
+                    function.replaceAllUsesWith(function.instruction(phi).result, value);
+                    function.erase(phi);
+                }
+            }
+
+            ++convertedCount_;
+            touched[head] = touched[join] = touched[onTrue] = touched[onFalse] = true;
+            swept = changed = true;
+        }
+    }
+    return changed;
+}
+
+} // namespace cpp20::compiler::ir
@@ -0,0 +1,323 @@
+/**
+ * @file Inliner.cpp
+ * @brief Implementación del pase de inlining
+ */
+
+#include <compiler/ir/IRPasses.h>
+#include <compiler/ir/IRAnalysis.h>
+#include <algorithm>
+#include <unordered_map>
+
+namespace cpp20::compiler::ir {
+
+namespace {
+
+bool isLeaf(const IRFunction& function) {
+    for (BlockId block = 0; block < function.blockCount(); ++block) {
+        for (InstrId id : function.instructions(block)) {
+            IROpcode opcode = function.instruction(id).opcode;
+            if (opcode == IROpcode::Call || opcode == IROpcode::Invoke) return false;
+        }
+    }
+    return true;
+}
+
+bool usesExceptions(const IRFunction& function) {
+    for (BlockId block = 0; block < function.blockCount(); ++block) {
+        for (InstrId id : function.instructions(block)) {
+            switch (function.instruction(id).opcode) {
+                case IROpcode::Invoke:
+                case IROpcode::LandingPad:
+                case IROpcode::Resume:
+                    return true;
+                default:
+                    break;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Nombre del callee directo de una llamada, o nullptr si es indirecta
+ */
+const std::string* directCallee(const IRFunction& function, InstrId call) {
+    ValueId target = function.operand(call, 0);
+    if (target == NoValue || function.value(target).kind != ValueKind::Global) return nullptr;
+    return &function.globalName(target);
+}
+
+} // namespace
+
+// ============================================================================
+// InlineCostModel
+// ============================================================================
+
+InlineCostModel InlineCostModel::forOptimizationLevel(int level) {
+    InlineCostModel model;
+    if (level <= 1) {
+        model.threshold = 0;
+        model.hintThreshold = 0;
+        model.loopBonus = 0;
+    } else if (level >= 3) {
+        model.threshold = 80;
+        model.hintThreshold = 200;
+        model.loopBonus = 80;
+    }
+    return model;
+}
+
+// ============================================================================
+// InlinerPass
+// ============================================================================
+
+InlinerPass::InlinerPass(InlineCostModel model) : model_(model) {
+}
+
+bool InlinerPass::shouldInline(const IRFunction& caller, InstrId call, const IRFunction& callee,
+                               bool inLoop) const {
+    if (&caller == &callee || callee.blockCount() == 0) return false;
+    if (callee.getInlineHint() == InlineHint::Never || usesExceptions(callee)) return false;
+    if (caller.operandCount(call) - 1 != callee.getParamTypes().size()) return false;
+
+    size_t size = callee.instructionCount();
+    if (callee.getInlineHint() == InlineHint::Always) return true;
+    if (size <= model_.alwaysInlineSize && isLeaf(callee)) return true;
+
+    // Una llamada que el perfil no vio ejecutarse solo haría crecer el código
+    uint64_t count = caller.blockFrequency(caller.instruction(call).block);
+    bool profiled = caller.hasProfile() && count != UnknownFrequency;
+    if (profiled && count == 0) return false;
+
+    if (caller.instructionCount() + size > model_.maxCallerSize) return false;
+
+    size_t bonus = 1;   // La propia llamada desaparece
+    for (size_t i = 1; i < caller.operandCount(call); ++i) {
+        if (caller.value(caller.operand(call, i)).kind == ValueKind::Constant) {
+            bonus += model_.constantArgumentBonus;
+        }
+    }
+    size_t cost = size > bonus ? size - bonus : 0;
+
+    size_t threshold = callee.getInlineHint() == InlineHint::Inline ? model_.hintThreshold
+                                                                     : model_.threshold;
+    if (threshold > 0) {
+        if (profiled) {
+            if (count >= hotCallCount_) threshold += model_.hotCallBonus;
+        } else if (inLoop) {
+            threshold += model_.loopBonus;
+        }
+    }
+    return cost <= threshold;
+}
+
+bool InlinerPass::inlineCall(IRFunction& caller, InstrId call, const IRFunction& callee) {
+    if (caller.instruction(call).opcode != IROpcode::Call || callee.blockCount() == 0) return false;
+
+    BlockId callBlock = caller.instruction(call).block;
+    ValueId callResult = caller.instruction(call).result;
+    size_t argCount = caller.operandCount(call) - 1;
+    if (argCount != callee.getParamTypes().size()) return false;
+
+    BlockId cont = caller.splitBlockAfter(call, caller.block(callBlock).name + ".cont");
+
+    // Valores del callee -> valores del llamador
+    std::vector<ValueId> valueMap(callee.valueCount(), NoValue);
+    for (size_t i = 0; i < argCount; ++i) {
+        valueMap[callee.parameter(i)] = caller.operand(call, i + 1);
+    }
+
+    std::vector<BlockId> blockMap(callee.blockCount());
+    for (BlockId block = 0; block < callee.blockCount(); ++block) {
+        blockMap[block] = caller.createBlock(callee.getName() + "." + callee.block(block).name);
+        valueMap[callee.blockLabel(block)] = caller.blockLabel(blockMap[block]);
+    }
+
+    // Frecuencias del callee escaladas a las ejecuciones de esta llamada
+    uint64_t callCount = caller.blockFrequency(callBlock);
+    if (callCount != UnknownFrequency) {
+        for (BlockId block = 0; block < callee.blockCount(); ++block) {
+            double relative = callee.relativeFrequency(block);
+            caller.setBlockFrequency(blockMap[block], relative < 0.0 ? callCount
+                                                                     : static_cast<uint64_t>(relative * callCount));
+        }
+    }
+
+    auto mapValue = [&](ValueId value) -> ValueId {
+        if (value == NoValue) return NoValue;
+        if (valueMap[value] != NoValue) return valueMap[value];
+
+        TypeInfo type = callee.typeOf(value);
+        ValueId mapped = NoValue;
+        switch (callee.value(value).kind) {
+            case ValueKind::Constant: {
+                const IRConstant* constant = callee.constant(value);
+                mapped = type.isFloatingPoint() ? caller.constantFloat(constant->floatValue, type)
+                                                : caller.constantInt(constant->intValue, type);
+                break;
+            }
+            case ValueKind::Global:
+                mapped = caller.global(callee.globalName(value), type);
+                break;
+            default:
+                mapped = caller.undef(type);
+                break;
+        }
+        valueMap[value] = mapped;
+        return mapped;
+    };
+
+    // Fase 1: instrucciones sin operandos (los phis y los bloques fuera de
+    // orden pueden referirse a valores aún no clonados)
+    std::vector<std::pair<InstrId, InstrId>> cloned;
+    std::vector<std::pair<ValueId, BlockId>> returns;
+    ValueId contLabel = caller.blockLabel(cont);
+
+    for (BlockId block = 0; block < callee.blockCount(); ++block) {
+        for (InstrId id : callee.instructions(block)) {
+            const Instruction& inst = callee.instruction(id);
+            if (inst.opcode == IROpcode::Ret) {
+                returns.emplace_back(inst.operandCount > 0 ? callee.operand(id, 0) : NoValue,
+                                     blockMap[block]);
+                caller.append(blockMap[block], IROpcode::Br, TypeInfo(),
+                              std::span<const ValueId>(&contLabel, 1), false);
+                continue;
+            }
+
+            std::vector<ValueId> placeholders(inst.operandCount, NoValue);
+            InstrId copy = caller.append(blockMap[block], inst.opcode, callee.type(inst.type),
+                                         placeholders, inst.result != NoValue);
+            if (inst.result != NoValue) {
+                valueMap[inst.result] = caller.instruction(copy).result;
+            }
+            cloned.emplace_back(id, copy);
+        }
+    }
+
+    // Fase 2: operandos
+    for (auto [original, copy] : cloned) {
+        for (size_t i = 0; i < callee.operandCount(original); ++i) {
+            caller.setOperand(copy, i, mapValue(callee.operand(original, i)));
+        }
+    }
+
+    // El resultado de la llamada pasa a ser el valor devuelto
+    if (callResult != NoValue) {
+        ValueId replacement;
+        if (returns.size() == 1) {
+            replacement = mapValue(returns.front().first);
+        } else if (returns.empty()) {
+            replacement = caller.undef(caller.typeOf(callResult));
+        } else {
+            TypeInfo type = caller.typeOf(callResult);
+            InstrId phi = caller.prepend(cont, IROpcode::Phi, type, {}, true);
+            for (auto [value, from] : returns) {
+                caller.addOperand(phi, mapValue(value));
+                caller.addOperand(phi, caller.blockLabel(from));
+            }
+            replacement = caller.instruction(phi).result;
+        }
+        caller.replaceAllUsesWith(callResult, replacement);
+    }
+
+    caller.erase(call);
+    ValueId entryLabel = caller.blockLabel(blockMap[0]);
+    caller.append(callBlock, IROpcode::Br, TypeInfo(), std::span<const ValueId>(&entryLabel, 1), false);
+
+    // Allocas del callee al bloque de entrada del llamador
+    std::vector<InstrId> allocas;
+    for (InstrId id : caller.instructions(blockMap[0])) {
+        if (caller.instruction(id).opcode == IROpcode::Alloca) allocas.push_back(id);
+    }
+    for (InstrId id : allocas) {
+        caller.moveBefore(id, caller.block(0).first);
+    }
+
+    return true;
+}
+
+bool InlinerPass::run(IRModule& module) {
+    std::unordered_map<std::string, IRFunction*> functions;
+    uint64_t hottest = 0;
+    for (const auto& function : module.getFunctions()) {
+        functions.emplace(function->getName(), function.get());
+        if (!function->hasProfile()) continue;
+        for (BlockId block = 0; block < function->blockCount(); ++block) {
+            uint64_t count = function->blockFrequency(block);
+            if (count != UnknownFrequency) hottest = std::max(hottest, count);
+        }
+    }
+    hotCallCount_ = std::max<uint64_t>(1, static_cast<uint64_t>(hottest * model_.hotCallFraction));
+
+    auto calleeOf = [&](const IRFunction& caller, InstrId call) -> IRFunction* {
+        const std::string* name = directCallee(caller, call);
+        if (!name) return nullptr;
+        auto it = functions.find(*name);
+        return it == functions.end() ? nullptr : it->second;
+    };
+
+    // Orden de abajo arriba: postorden del grafo de llamadas
+    std::vector<IRFunction*> order;
+    std::unordered_map<IRFunction*, uint8_t> state;     // 1 = en curso, 2 = hecho
+    for (const auto& root : module.getFunctions()) {
+        if (state[root.get()] != 0) continue;
+
+        std::vector<std::pair<IRFunction*, std::vector<IRFunction*>>> stack;
+        auto push = [&](IRFunction* function) {
+            std::vector<IRFunction*> callees;
+            for (BlockId block = 0; block < function->blockCount(); ++block) {
+                for (InstrId id : function->instructions(block)) {
+                    if (function->instruction(id).opcode != IROpcode::Call) continue;
+                    if (IRFunction* callee = calleeOf(*function, id)) callees.push_back(callee);
+                }
+            }
+            state[function] = 1;
+            stack.emplace_back(function, std::move(callees));
+        };
+
+        push(root.get());
+        while (!stack.empty()) {
+            auto& [function, callees] = stack.back();
+            if (!callees.empty()) {
+                IRFunction* callee = callees.back();
+                callees.pop_back();
+                if (state[callee] == 0) push(callee);
+                continue;
+            }
+            state[function] = 2;
+            order.push_back(function);
+            stack.pop_back();
+        }
+    }
+
+    bool changed = false;
+    for (IRFunction* caller : order) {
+        ControlFlowGraph cfg(*caller);
+        DominatorTree domTree(cfg);
+        LoopInfo loops(cfg, domTree);
+
+        // Instantánea de las llamadas: las que traiga el código integrado
+        // no se vuelven a considerar en esta pasada
+        std::vector<std::pair<InstrId, bool>> calls;
+        for (BlockId block = 0; block < caller->blockCount(); ++block) {
+            for (InstrId id : caller->instructions(block)) {
+                if (caller->instruction(id).opcode == IROpcode::Call) {
+                    calls.emplace_back(id, loops.loopFor(block) != NoLoop);
+                }
+            }
+        }
+
+        for (auto [call, hot] : calls) {
+            IRFunction* callee = calleeOf(*caller, call);
+            if (!callee || !shouldInline(*caller, call, *callee, hot)) continue;
+            if (inlineCall(*caller, call, *callee)) {
+                ++inlinedCount_;
+                changed = true;
+            }
+        }
+    }
+
+    return changed;
+}
+
+} // namespace cpp20::compiler::ir
@@ -0,0 +1,876 @@
+/**
+ * @file LoopPasses.cpp
+ * @brief Implementación de los pases de bucles: LICM, reducción de fuerza y desenrollado
+ */
+
+#include <compiler/ir/IRPasses.h>
+#include <compiler/ir/IRAnalysis.h>
+#include <compiler/common/EnvironmentDetector.h>
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+namespace cpp20::compiler::ir {
+
+namespace {
+
+/**
+ * @brief CFG, dominadores y bucles de una función en un momento dado
+ */
+struct LoopAnalysis {
+    explicit LoopAnalysis(const IRFunction& function)
+        : cfg(function), domTree(cfg), loops(cfg, domTree) {}
+
+    ControlFlowGraph cfg;
+    DominatorTree domTree;
+    LoopInfo loops;
+};
+
+bool isIntegerType(const TypeInfo& type) {
+    return type.type >= IRType::Char && type.type <= IRType::LongLong;
+}
+
+bool isLoopInstruction(const IRFunction& function, const LoopInfo& loops, uint32_t loop, ValueId value) {
+    if (value == NoValue || function.value(value).kind != ValueKind::Instruction) return false;
+    return loops.contains(loop, function.instruction(function.definingInstruction(value)).block);
+}
+
+/**
+ * @brief Cambia el destino from -> oldTarget del terminador por newTarget
+ */
+void redirectEdge(IRFunction& function, BlockId from, BlockId oldTarget, BlockId newTarget) {
+    InstrId term = function.terminator(from);
+    ValueId oldLabel = function.blockLabel(oldTarget);
+    for (size_t i = 0; i < function.operandCount(term); ++i) {
+        if (function.operand(term, i) == oldLabel) {
+            function.setOperand(term, i, function.blockLabel(newTarget));
+        }
+    }
+}
+
+/**
+ * @brief Crea un preheader para el bucle si no lo tiene
+ *
+ * Las aristas de fuera del bucle hacia la cabecera pasan por un bloque
+ * nuevo; si había varias, sus entradas en los phis de la cabecera se
+ * reúnen en phis del preheader.
+ *
+ * @return true si creó el bloque
+ */
+bool ensurePreheader(IRFunction& function, const LoopAnalysis& analysis, uint32_t loop) {
+    const ControlFlowGraph& cfg = analysis.cfg;
+    BlockId header = analysis.loops.loops()[loop].header;
+    if (analysis.loops.preheader(cfg, loop) != NoBlock) return false;
+
+    std::vector<BlockId> outside;
+    for (BlockId pred : cfg.predecessors(header)) {
+        if (analysis.loops.contains(loop, pred) || !cfg.isReachable(pred)) continue;
+        if (std::find(outside.begin(), outside.end(), pred) == outside.end()) outside.push_back(pred);
+    }
+    if (outside.empty()) return false;      // La cabecera es la entrada de la función
+
+    BlockId preheader = function.createBlock(function.block(header).name + ".preheader");
+    ValueId preheaderLabel = function.blockLabel(preheader);
+
+    std::vector<InstrId> phis;
+    for (InstrId id : function.instructions(header)) {
+        if (function.instruction(id).opcode != IROpcode::Phi) break;
+        phis.push_back(id);
+    }
+
+    for (InstrId phi : phis) {
+        std::vector<ValueId> entries;
+        for (size_t i = 0; i + 1 < function.operandCount(phi); i += 2) {
+            BlockId from = function.labelBlock(function.operand(phi, i + 1));
+            if (std::find(outside.begin(), outside.end(), from) == outside.end()) continue;
+            if (outside.size() == 1) {
+                function.setOperand(phi, i + 1, preheaderLabel);
+            } else {
+                entries.push_back(function.operand(phi, i));
+                entries.push_back(function.operand(phi, i + 1));
+            }
+        }
+        if (outside.size() > 1) {
+            TypeInfo type = function.typeOf(function.instruction(phi).result);
+            InstrId merged = function.append(preheader, IROpcode::Phi, type, entries, true);
+            for (BlockId pred : outside) function.removeIncoming(header, pred);
+            function.addOperand(phi, function.instruction(merged).result);
+            function.addOperand(phi, preheaderLabel);
+        }
+    }
+
+    for (BlockId pred : outside) redirectEdge(function, pred, header, preheader);
+    ValueId headerLabel = function.blockLabel(header);
+    function.append(preheader, IROpcode::Br, TypeInfo(), std::span<const ValueId>(&headerLabel, 1), false);
+    return true;
+}
+
+bool ensurePreheaders(IRFunction& function) {
+    LoopAnalysis analysis(function);
+    bool changed = false;
+    for (uint32_t loop = 0; loop < analysis.loops.loops().size(); ++loop) {
+        changed |= ensurePreheader(function, analysis, loop);
+    }
+    return changed;
+}
+
+/**
+ * @brief Entrada de un phi que llega desde el bloque, o NoValue
+ */
+ValueId incomingFrom(const IRFunction& function, InstrId phi, BlockId block) {
+    ValueId label = function.blockLabel(block);
+    for (size_t i = 0; i + 1 < function.operandCount(phi); i += 2) {
+        if (function.operand(phi, i + 1) == label) return function.operand(phi, i);
+    }
+    return NoValue;
+}
+
+/**
+ * @brief Variable de inducción básica: phi [inicio, preheader], [phi +/- paso, latch]
+ */
+struct InductionVariable {
+    InstrId phi = NoInstr;
+    ValueId start = NoValue;
+    InstrId increment = NoInstr;    // Add o Sub del latch
+    ValueId step = NoValue;         // Constante
+};
+
+bool matchInductionVariable(const IRFunction& function, const LoopInfo& loops, uint32_t loop,
+                            InstrId phi, BlockId preheader, BlockId latch, InductionVariable& out) {
+    const Instruction& inst = function.instruction(phi);
+    if (inst.opcode != IROpcode::Phi || inst.operandCount != 4) return false;
+    if (!isIntegerType(function.type(inst.type))) return false;
+
+    ValueId start = incomingFrom(function, phi, preheader);
+    ValueId next = incomingFrom(function, phi, latch);
+    if (start == NoValue || !isLoopInstruction(function, loops, loop, next)) return false;
+
+    InstrId increment = function.definingInstruction(next);
+    IROpcode opcode = function.instruction(increment).opcode;
+    if (opcode != IROpcode::Add && opcode != IROpcode::Sub) return false;
+
+    ValueId lhs = function.operand(increment, 0);
+    ValueId rhs = function.operand(increment, 1);
+    if (opcode == IROpcode::Add && rhs == inst.result) std::swap(lhs, rhs);
+    if (lhs != inst.result || !function.constant(rhs)) return false;
+
+    out = {phi, start, increment, rhs};
+    return true;
+}
+
+// ============================================================================
+// LICM
+// ============================================================================
+
+bool hoistLoop(IRFunction& function, const LoopAnalysis& analysis, uint32_t loop) {
+    const LoopInfo& loops = analysis.loops;
+    BlockId preheader = loops.preheader(analysis.cfg, loop);
+    if (preheader == NoBlock) return false;
+    const Loop& info = loops.loops()[loop];
+
+    bool writes = false;
+    for (BlockId block : info.blocks) {
+        for (InstrId id : function.instructions(block)) {
+            writes |= writesMemory(function.instruction(id).opcode);
+        }
+    }
+
+    auto invariant = [&](ValueId value) { return !isLoopInstruction(function, loops, loop, value); };
+
+    auto hoistable = [&](InstrId id) {
+        const Instruction& inst = function.instruction(id);
+        if (inst.result == NoValue) return false;
+
+        if (inst.opcode == IROpcode::Load) {
+            if (writes) return false;
+            ValueId address = function.operand(id, 0);
+            bool dereferenceable = function.value(address).kind == ValueKind::Global ||
+                (function.value(address).kind == ValueKind::Instruction &&
+                 function.instruction(function.definingInstruction(address)).opcode == IROpcode::Alloca);
+            if (!dereferenceable && inst.block != info.header) return false;
+        } else if (!isPure(inst.opcode)) {
+            return false;
+        }
+
+        if ((inst.opcode == IROpcode::Div || inst.opcode == IROpcode::Mod) &&
+            !function.type(inst.type).isFloatingPoint()) {
+            const IRConstant* divisor = function.constant(function.operand(id, 1));
+            if (!divisor || divisor->intValue == 0 || divisor->intValue == -1) return false;
+        }
+
+        for (size_t i = 0; i < function.operandCount(id); ++i) {
+            if (!invariant(function.operand(id, i))) return false;
+        }
+        return true;
+    };
+
+    // Mover una instrucción cambia su next: primero se recogen, después se mueven
+    bool changed = false;
+    bool progress = true;
+    std::vector<InstrId> candidates;
+    while (progress) {
+        progress = false;
+        for (BlockId block : info.blocks) {
+            candidates.clear();
+            for (InstrId id : function.instructions(block)) candidates.push_back(id);
+            for (InstrId id : candidates) {
+                if (function.instruction(id).block != block || !hoistable(id)) continue;
+                function.moveBefore(id, function.terminator(preheader));
+                progress = changed = true;
+            }
+        }
+    }
+    return changed;
+}
+
+// ============================================================================
+// Reducción de fuerza
+// ============================================================================
+
+bool reduceLoop(IRFunction& function, const LoopAnalysis& analysis, uint32_t loop) {
+    const LoopInfo& loops = analysis.loops;
+    const Loop& info = loops.loops()[loop];
+    BlockId preheader = loops.preheader(analysis.cfg, loop);
+    if (preheader == NoBlock || info.latches.size() != 1) return false;
+    BlockId latch = info.latches.front();
+
+    std::vector<InstrId> phis;
+    for (InstrId id : function.instructions(info.header)) {
+        if (function.instruction(id).opcode != IROpcode::Phi) break;
+        phis.push_back(id);
+    }
+
+    bool changed = false;
+    for (InstrId phi : phis) {
+        InductionVariable iv;
+        if (!matchInductionVariable(function, loops, loop, phi, preheader, latch, iv)) continue;
+        ValueId i = function.instruction(phi).result;
+        TypeInfo type = function.typeOf(i);
+
+        std::vector<InstrId> products;
+        function.forEachUse(i, [&](InstrId user, size_t index) {
+            const Instruction& inst = function.instruction(user);
+            if (inst.opcode != IROpcode::Mul || !loops.contains(loop, inst.block)) return;
+            if (!(function.typeOf(inst.result) == type)) return;
+            if (function.constant(function.operand(user, 1 - index))) products.push_back(user);
+        });
+
+        // Una variable de inducción nueva por factor distinto
+        std::unordered_map<ValueId, ValueId> reduced;
+        for (InstrId mul : products) {
+            ValueId factor = function.operand(mul, function.operand(mul, 0) == i ? 1 : 0);
+            auto [it, inserted] = reduced.emplace(factor, NoValue);
+            if (inserted) {
+                InstrId anchor = function.terminator(preheader);
+                ValueId startOps[] = {iv.start, factor};
+                ValueId stepOps[] = {iv.step, factor};
+                InstrId start = function.insertBefore(anchor, IROpcode::Mul, type, startOps, true);
+                InstrId step = function.insertBefore(anchor, IROpcode::Mul, type, stepOps, true);
+
+                InstrId j = function.prepend(info.header, IROpcode::Phi, type, {}, true);
+                ValueId jValue = function.instruction(j).result;
+                function.addOperand(j, function.instruction(start).result);
+                function.addOperand(j, function.blockLabel(preheader));
+
+                ValueId nextOps[] = {jValue, function.instruction(step).result};
+                InstrId next = function.insertBefore(function.instruction(iv.increment).next,
+                                                     function.instruction(iv.increment).opcode,
+                                                     type, nextOps, true);
+                function.addOperand(j, function.instruction(next).result);
+                function.addOperand(j, function.blockLabel(latch));
+                it->second = jValue;
+            }
+            function.replaceAllUsesWith(function.instruction(mul).result, it->second);
+            function.erase(mul);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+// ============================================================================
+// Desenrollado
+// ============================================================================
+
+bool evaluateCompare(IROpcode opcode, int64_t a, int64_t b) {
+    switch (opcode) {
+        case IROpcode::CmpEQ: return a == b;
+        case IROpcode::CmpNE: return a != b;
+        case IROpcode::CmpLT: return a < b;
+        case IROpcode::CmpLE: return a <= b;
+        case IROpcode::CmpGT: return a > b;
+        default: return a >= b;
+    }
+}
+
+IROpcode mirrorCompare(IROpcode opcode) {
+    switch (opcode) {
+        case IROpcode::CmpLT: return IROpcode::CmpGT;
+        case IROpcode::CmpLE: return IROpcode::CmpGE;
+        case IROpcode::CmpGT: return IROpcode::CmpLT;
+        case IROpcode::CmpGE: return IROpcode::CmpLE;
+        default: return opcode;
+    }
+}
+
+/**
+ * @brief Iteraciones del bucle simulando la variable de inducción
+ * @return false si no es constante, desborda el tipo o supera el límite
+ */
+bool computeTripCount(const IRFunction& function, const InductionVariable& iv, IROpcode predicate,
+                      int64_t bound, bool continueOnTrue, size_t limit, size_t& tripCount) {
+    const IRConstant* start = function.constant(iv.start);
+    if (!start) return false;
+
+    TypeInfo type = function.typeOf(function.instruction(iv.phi).result);
+    unsigned bits = type.size == 0 || type.size >= 8 ? 64 : static_cast<unsigned>(type.size) * 8;
+    int64_t max = bits == 64 ? std::numeric_limits<int64_t>::max() : (int64_t{1} << (bits - 1)) - 1;
+    int64_t min = -max - 1;
+
+    int64_t step = function.constant(iv.step)->intValue;
+    if (function.instruction(iv.increment).opcode == IROpcode::Sub) {
+        if (step == std::numeric_limits<int64_t>::min()) return false;
+        step = -step;
+    }
+
+    int64_t value = start->intValue;
+    tripCount = 0;
+    while (evaluateCompare(predicate, value, bound) == continueOnTrue) {
+        if (++tripCount > limit) return false;
+        // Comprobar el rango antes de sumar: ni int64 ni el tipo pueden desbordar
+        if (step > 0 ? value > max - step : value < min - step) return false;
+        value += step;
+        if (value < min || value > max) return false;
+    }
+    return true;
+}
+
+bool unrollLoop(IRFunction& function, const LoopAnalysis& analysis, uint32_t loop,
+                size_t maxTripCount, size_t maxUnrolledSize) {
+    const LoopInfo& loops = analysis.loops;
+    const Loop& info = loops.loops()[loop];
+    BlockId header = info.header;
+    BlockId preheader = loops.preheader(analysis.cfg, loop);
+    if (preheader == NoBlock || info.blocks.size() != 2 || info.latches.size() != 1) return false;
+    BlockId body = info.latches.front();
+    if (body == header) return false;
+
+    // Cabecera: compara y sale o entra en el cuerpo; el cuerpo vuelve a la cabecera
+    InstrId branch = function.terminator(header);
+    InstrId back = function.terminator(body);
+    if (branch == NoInstr || function.instruction(branch).opcode != IROpcode::BrCond) return false;
+    if (back == NoInstr || function.instruction(back).opcode != IROpcode::Br) return false;
+
+    BlockId onTrue = function.labelBlock(function.operand(branch, 1));
+    BlockId onFalse = function.labelBlock(function.operand(branch, 2));
+    if ((onTrue == body) == (onFalse == body)) return false;
+    bool continueOnTrue = onTrue == body;
+    BlockId exit = continueOnTrue ? onFalse : onTrue;
+    if (loops.contains(loop, exit)) return false;
+
+    ValueId condition = function.operand(branch, 0);
+    if (!isLoopInstruction(function, loops, loop, condition)) return false;
+    InstrId compare = function.definingInstruction(condition);
+    IROpcode predicate = function.instruction(compare).opcode;
+    if (function.instruction(compare).block != header ||
+        predicate < IROpcode::CmpEQ || predicate > IROpcode::CmpGE) return false;
+
+    ValueId lhs = function.operand(compare, 0);
+    ValueId rhs = function.operand(compare, 1);
+    if (function.constant(lhs)) {
+        std::swap(lhs, rhs);
+        predicate = mirrorCompare(predicate);
+    }
+    const IRConstant* bound = function.constant(rhs);
+    if (!bound || !isLoopInstruction(function, loops, loop, lhs)) return false;
+
+    InductionVariable iv;
+    if (!matchInductionVariable(function, loops, loop, function.definingInstruction(lhs),
+                                preheader, body, iv)) return false;
+    if (function.instruction(iv.phi).block != header) return false;
+
+    size_t tripCount = 0;
+    if (!computeTripCount(function, iv, predicate, bound->intValue, continueOnTrue,
+                          maxTripCount, tripCount)) return false;
+
+    size_t loopSize = 0;
+    for (BlockId block : info.blocks) {
+        for ([[maybe_unused]] InstrId id : function.instructions(block)) ++loopSize;
+    }
+    if (loopSize * (tripCount + 1) > maxUnrolledSize) return false;
+
+    // Copias en el preheader: tripCount veces cabecera + cuerpo y una última
+    // cabecera, cuyos valores son los que ve la salida
+    std::vector<InstrId> phis;
+    for (InstrId id : function.instructions(header)) {
+        if (function.instruction(id).opcode != IROpcode::Phi) break;
+        phis.push_back(id);
+    }
+
+    std::unordered_map<ValueId, ValueId> current;
+    auto mapped = [&](ValueId value) {
+        auto it = current.find(value);
+        return it == current.end() ? value : it->second;
+    };
+    for (InstrId phi : phis) {
+        current[function.instruction(phi).result] = incomingFrom(function, phi, preheader);
+    }
+
+    InstrId anchor = function.terminator(preheader);
+    std::vector<ValueId> operands;
+    auto cloneBlock = [&](BlockId block) {
+        for (InstrId id : function.instructions(block)) {
+            Instruction inst = function.instruction(id);
+            if (inst.opcode == IROpcode::Phi || isTerminator(inst.opcode)) continue;
+            operands.clear();
+            for (size_t i = 0; i < inst.operandCount; ++i) operands.push_back(mapped(function.operand(id, i)));
+            TypeInfo type = function.type(inst.type);
+            InstrId copy = function.insertBefore(anchor, inst.opcode, type, operands, inst.result != NoValue);
+            if (inst.result != NoValue) current[inst.result] = function.instruction(copy).result;
+        }
+    };
+
+    std::vector<ValueId> nextValues(phis.size());
+    for (size_t iteration = 0; iteration < tripCount; ++iteration) {
+        cloneBlock(header);
+        cloneBlock(body);
+        // Copia paralela: todos los phis leen los valores de la iteración anterior
+        for (size_t k = 0; k < phis.size(); ++k) {
+            nextValues[k] = mapped(incomingFrom(function, phis[k], body));
+        }
+        for (size_t k = 0; k < phis.size(); ++k) {
+            current[function.instruction(phis[k]).result] = nextValues[k];
+        }
+    }
+    cloneBlock(header);
+
+    // Los usos fuera del bucle pasan a los valores de la última copia
+    std::vector<std::pair<InstrId, size_t>> outsideUses;
+    for (BlockId block : info.blocks) {
+        for (InstrId id : function.instructions(block)) {
+            ValueId result = function.instruction(id).result;
+            if (result == NoValue) continue;
+            outsideUses.clear();
+            function.forEachUse(result, [&](InstrId user, size_t index) {
+                if (!loops.contains(loop, function.instruction(user).block)) outsideUses.emplace_back(user, index);
+            });
+            for (auto [user, index] : outsideUses) function.setOperand(user, index, mapped(result));
+        }
+    }
+
+    ValueId headerLabel = function.blockLabel(header);
+    for (InstrId id : function.instructions(exit)) {
+        if (function.instruction(id).opcode != IROpcode::Phi) break;
+        for (size_t i = 1; i < function.operandCount(id); i += 2) {
+            if (function.operand(id, i) == headerLabel) {
+                function.setOperand(id, i, function.blockLabel(preheader));
+            }
+        }
+    }
+
+    redirectEdge(function, preheader, header, exit);
+    function.clearBlock(header);
+    function.clearBlock(body);
+    return true;
+}
+
+// ============================================================================
+// Vectorización
+// ============================================================================
+
+bool isVectorElement(const TypeInfo& type) {
+    return (isIntegerType(type) || type.isFloatingPoint()) && (type.size == 4 || type.size == 8);
+}
+
+bool isVectorizableOperation(IROpcode opcode, const TypeInfo& type, const VectorTarget& target) {
+    switch (opcode) {
+        case IROpcode::Add:
+        case IROpcode::Sub:
+            return true;
+        case IROpcode::Mul:
+            return type.isFloatingPoint() || (target.integerMultiply && type.size == 4);
+        case IROpcode::Div:
+            return type.isFloatingPoint();
+        case IROpcode::And:
+        case IROpcode::Or:
+        case IROpcode::Xor:
+            return !type.isFloatingPoint();
+        default:
+            return false;
+    }
+}
+
+bool vectorizeLoop(IRFunction& function, const LoopAnalysis& analysis, uint32_t loop,
+                   const VectorTarget& target) {
+    const LoopInfo& loops = analysis.loops;
+    const Loop& info = loops.loops()[loop];
+    BlockId header = info.header;
+    BlockId preheader = loops.preheader(analysis.cfg, loop);
+    if (preheader == NoBlock || info.blocks.size() != 2 || info.latches.size() != 1) return false;
+    BlockId body = info.latches.front();
+    if (body == header) return false;
+
+    // Cabecera exacta: i = phi; c = i < n; br c, cuerpo, salida
+    InstrId branch = function.terminator(header);
+    InstrId back = function.terminator(body);
+    if (branch == NoInstr || function.instruction(branch).opcode != IROpcode::BrCond) return false;
+    if (back == NoInstr || function.instruction(back).opcode != IROpcode::Br) return false;
+    if (function.labelBlock(function.operand(branch, 1)) != body) return false;
+    if (loops.contains(loop, function.labelBlock(function.operand(branch, 2)))) return false;
+
+    std::vector<InstrId> headerInstructions;
+    for (InstrId id : function.instructions(header)) headerInstructions.push_back(id);
+    if (headerInstructions.size() != 3) return false;
+
+    InstrId compare = headerInstructions[1];
+    ValueId condition = function.instruction(compare).result;
+    if (function.instruction(compare).opcode != IROpcode::CmpLT || function.operand(branch, 0) != condition) {
+        return false;
+    }
+    ValueId bound = function.operand(compare, 1);
+    if (isLoopInstruction(function, loops, loop, bound)) return false;
+
+    InductionVariable iv;
+    if (function.operand(compare, 0) != function.instruction(headerInstructions[0]).result ||
+        !matchInductionVariable(function, loops, loop, headerInstructions[0], preheader, body, iv)) {
+        return false;
+    }
+    ValueId i = function.instruction(iv.phi).result;
+    const IRConstant* start = function.constant(iv.start);
+    if (function.instruction(iv.increment).opcode != IROpcode::Add ||
+        function.constant(iv.step)->intValue != 1 || !start || start->intValue < 0) {
+        return false;
+    }
+
+    // i solo puede usarse como índice de base[i]; el incremento, solo en el phi
+    bool indexOnly = true;
+    function.forEachUse(i, [&](InstrId user, size_t index) {
+        const Instruction& inst = function.instruction(user);
+        if (user == compare || user == iv.increment || !loops.contains(loop, inst.block)) return;
+        if (inst.opcode != IROpcode::GetElementPtr || index != 1 || inst.operandCount != 2) indexOnly = false;
+    });
+    function.forEachUse(function.instruction(iv.increment).result, [&](InstrId user, size_t) {
+        if (user != iv.phi) indexOnly = false;
+    });
+    if (!indexOnly) return false;
+
+    // Clasificación del cuerpo: direcciones base[i] y valores vectoriales
+    enum class Shape : uint8_t { Address, Vector };
+    std::unordered_map<ValueId, Shape> shapes;
+    std::unordered_map<ValueId, ValueId> baseOf;            // Dirección -> base
+    std::vector<std::pair<ValueId, bool>> accesses;         // (base, es store)
+    size_t elementSize = 0;
+    std::vector<InstrId> bodyInstructions;
+
+    auto invariant = [&](ValueId value) { return !isLoopInstruction(function, loops, loop, value); };
+    auto elementOk = [&](const TypeInfo& type) {
+        if (!isVectorElement(type) || (elementSize != 0 && elementSize != type.size)) return false;
+        elementSize = type.size;
+        return true;
+    };
+    auto vectorOperand = [&](ValueId value, const TypeInfo& type) {
+        auto it = shapes.find(value);
+        if (it != shapes.end()) return it->second == Shape::Vector;
+        return invariant(value) && function.typeOf(value) == type;
+    };
+
+    for (InstrId id : function.instructions(body)) {
+        if (id == back || id == iv.increment) continue;
+        const Instruction& inst = function.instruction(id);
+        TypeInfo type = function.type(inst.type);
+        bodyInstructions.push_back(id);
+
+        switch (inst.opcode) {
+            case IROpcode::GetElementPtr:
+                if (inst.operandCount != 2 || function.operand(id, 1) != i || !invariant(function.operand(id, 0))) {
+                    return false;
+                }
+                shapes[inst.result] = Shape::Address;
+                baseOf[inst.result] = function.operand(id, 0);
+                break;
+
+            case IROpcode::Load: {
+                auto it = shapes.find(function.operand(id, 0));
+                if (it == shapes.end() || it->second != Shape::Address || !elementOk(type)) return false;
+                shapes[inst.result] = Shape::Vector;
+                accesses.emplace_back(baseOf[function.operand(id, 0)], false);
+                break;
+            }
+
+            case IROpcode::Store: {
+                ValueId value = function.operand(id, 0);
+                auto it = shapes.find(function.operand(id, 1));
+                TypeInfo valueType = function.typeOf(value);
+                if (it == shapes.end() || it->second != Shape::Address || !elementOk(valueType) ||
+                    !vectorOperand(value, valueType)) {
+                    return false;
+                }
+                accesses.emplace_back(baseOf[function.operand(id, 1)], true);
+                break;
+            }
+
+            default: {
+                if (inst.operandCount != 2 || !elementOk(type) ||
+                    !isVectorizableOperation(inst.opcode, type, target)) return false;
+                ValueId lhs = function.operand(id, 0);
+                ValueId rhs = function.operand(id, 1);
+                if (!vectorOperand(lhs, type) || !vectorOperand(rhs, type)) return false;
+                if (!shapes.count(lhs) && !shapes.count(rhs)) return false;    // Invariante: para LICM
+                shapes[inst.result] = Shape::Vector;
+                break;
+            }
+        }
+
+        // Los valores del cuerpo no pueden salir del bucle
+        bool escapes = false;
+        if (inst.result != NoValue) {
+            function.forEachUse(inst.result, [&](InstrId user, size_t) {
+                if (function.instruction(user).block != body) escapes = true;
+            });
+        }
+        if (escapes) return false;
+    }
+
+    bool stores = std::any_of(accesses.begin(), accesses.end(), [](const auto& access) { return access.second; });
+    uint32_t lanes = elementSize == 0 ? 0 : static_cast<uint32_t>(target.registerBytes / elementSize);
+    if (!stores || lanes < 2) return false;
+
+    // Transformación: preheader -> [comprobación] -> bucle vectorial -> bucle escalar (resto)
+    TypeInfo ivType = function.typeOf(i);
+    TypeInfo boolType = function.typeOf(condition);
+    InstrId preheaderBranch = function.terminator(preheader);
+    auto emitBefore = [&](InstrId position, IROpcode opcode, const TypeInfo& type,
+                          std::initializer_list<ValueId> operands) {
+        return function.instruction(function.insertBefore(position, opcode, type,
+                                                          std::span<const ValueId>(operands.begin(), operands.size()),
+                                                          true)).result;
+    };
+
+    // Solapamiento: [a, a + n) y [b, b + n) deben ser disjuntos para cada
+    // par de bases distintas con al menos un store
+    ValueId safe = NoValue;
+    for (size_t x = 0; x < accesses.size(); ++x) {
+        for (size_t y = x + 1; y < accesses.size(); ++y) {
+            auto [a, storeA] = accesses[x];
+            auto [b, storeB] = accesses[y];
+            if (a == b || (!storeA && !storeB)) continue;
+            ValueId endA = emitBefore(preheaderBranch, IROpcode::GetElementPtr, function.typeOf(a), {a, bound});
+            ValueId endB = emitBefore(preheaderBranch, IROpcode::GetElementPtr, function.typeOf(b), {b, bound});
+            ValueId before = emitBefore(preheaderBranch, IROpcode::CmpLE, boolType, {endA, b});
+            ValueId after = emitBefore(preheaderBranch, IROpcode::CmpLE, boolType, {endB, a});
+            ValueId disjoint = emitBefore(preheaderBranch, IROpcode::Or, boolType, {before, after});
+            safe = safe == NoValue ? disjoint
+                                   : emitBefore(preheaderBranch, IROpcode::And, boolType, {safe, disjoint});
+        }
+    }
+
+    BlockId vectorHeader = function.createBlock(function.block(header).name + ".vec");
+    BlockId vectorBody = function.createBlock(function.block(body).name + ".vec");
+    BlockId remainder = function.createBlock(function.block(header).name + ".scalar");
+    ValueId vectorHeaderLabel = function.blockLabel(vectorHeader);
+
+    // Con comprobación, el bucle vectorial tiene su propio preheader y los
+    // broadcasts no se ejecutan cuando se va directamente al escalar
+    BlockId vectorPreheader = preheader;
+    InstrId splatPosition = preheaderBranch;
+    if (safe != NoValue) {
+        vectorPreheader = function.createBlock(function.block(header).name + ".vec.preheader");
+        splatPosition = function.append(vectorPreheader, IROpcode::Br, TypeInfo(),
+                                        std::span<const ValueId>(&vectorHeaderLabel, 1), false);
+    }
+
+    auto appendTo = [&](BlockId block, IROpcode opcode, const TypeInfo& type,
+                        std::initializer_list<ValueId> operands) {
+        return function.instruction(function.append(block, opcode, type,
+                                                    std::span<const ValueId>(operands.begin(), operands.size()),
+                                                    true)).result;
+    };
+
+    // vi avanza de lanes en lanes mientras queden al menos lanes iteraciones;
+    // i < n garantiza que n - vi no desborda porque vi >= 0
+    ValueId laneCount = function.constantInt(lanes, ivType);
+    InstrId viPhi = function.append(vectorHeader, IROpcode::Phi, ivType, {}, true);
+    ValueId vi = function.instruction(viPhi).result;
+    ValueId inRange = appendTo(vectorHeader, IROpcode::CmpLT, boolType, {vi, bound});
+    ValueId remaining = appendTo(vectorHeader, IROpcode::Sub, ivType, {bound, vi});
+    ValueId fullVector = appendTo(vectorHeader, IROpcode::CmpGE, boolType, {remaining, laneCount});
+    ValueId go = appendTo(vectorHeader, IROpcode::And, boolType, {inRange, fullVector});
+    ValueId vectorLoopOps[] = {go, function.blockLabel(vectorBody), function.blockLabel(remainder)};
+    function.append(vectorHeader, IROpcode::BrCond, TypeInfo(), vectorLoopOps, false);
+
+    // Cuerpo vectorial; los invariantes se replican en el preheader
+    std::unordered_map<ValueId, ValueId> mapped;
+    auto vectorValue = [&](ValueId value) {
+        auto it = mapped.find(value);
+        if (it != mapped.end()) return it->second;
+        ValueId splat = emitBefore(splatPosition, IROpcode::Broadcast,
+                                   TypeInfo::vectorOf(function.typeOf(value), lanes), {value});
+        mapped.emplace(value, splat);
+        return splat;
+    };
+
+    for (InstrId id : bodyInstructions) {
+        Instruction inst = function.instruction(id);
+        TypeInfo type = function.type(inst.type);
+        switch (inst.opcode) {
+            case IROpcode::GetElementPtr:
+                mapped[inst.result] = appendTo(vectorBody, IROpcode::GetElementPtr, type,
+                                               {function.operand(id, 0), vi});
+                break;
+            case IROpcode::Load:
+                mapped[inst.result] = appendTo(vectorBody, IROpcode::Load, TypeInfo::vectorOf(type, lanes),
+                                               {mapped[function.operand(id, 0)]});
+                break;
+            case IROpcode::Store: {
+                ValueId storeOps[] = {vectorValue(function.operand(id, 0)), mapped[function.operand(id, 1)]};
+                function.append(vectorBody, IROpcode::Store, TypeInfo(), storeOps, false);
+                break;
+            }
+            default: {
+                ValueId lhs = vectorValue(function.operand(id, 0));
+                ValueId rhs = vectorValue(function.operand(id, 1));
+                mapped[inst.result] = appendTo(vectorBody, inst.opcode, TypeInfo::vectorOf(type, lanes), {lhs, rhs});
+                break;
+            }
+        }
+    }
+
+    ValueId viNext = appendTo(vectorBody, IROpcode::Add, ivType, {vi, laneCount});
+    function.append(vectorBody, IROpcode::Br, TypeInfo(), std::span<const ValueId>(&vectorHeaderLabel, 1), false);
+    function.addOperand(viPhi, iv.start);
+    function.addOperand(viPhi, function.blockLabel(vectorPreheader));
+    function.addOperand(viPhi, viNext);
+    function.addOperand(viPhi, function.blockLabel(vectorBody));
+
+    // El bucle original hace el resto desde donde lo dejó el vectorial
+    ValueId resume = vi;
+    if (safe != NoValue) {
+        resume = appendTo(remainder, IROpcode::Phi, ivType, {vi, vectorHeaderLabel, iv.start,
+                                                             function.blockLabel(preheader)});
+    }
+    ValueId headerLabel = function.blockLabel(header);
+    function.append(remainder, IROpcode::Br, TypeInfo(), std::span<const ValueId>(&headerLabel, 1), false);
+
+    ValueId preheaderLabel = function.blockLabel(preheader);
+    for (size_t k = 1; k < function.operandCount(iv.phi); k += 2) {
+        if (function.operand(iv.phi, k) == preheaderLabel) {
+            function.setOperand(iv.phi, k - 1, resume);
+            function.setOperand(iv.phi, k, function.blockLabel(remainder));
+        }
+    }
+
+    function.erase(preheaderBranch);
+    if (safe != NoValue) {
+        ValueId checkOps[] = {safe, function.blockLabel(vectorPreheader), function.blockLabel(remainder)};
+        function.append(preheader, IROpcode::BrCond, TypeInfo(), checkOps, false);
+    } else {
+        function.append(preheader, IROpcode::Br, TypeInfo(), std::span<const ValueId>(&vectorHeaderLabel, 1), false);
+    }
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// LICMPass
+// ============================================================================
+
+bool LICMPass::run(IRFunction& function) {
+    if (function.blockCount() == 0) return false;
+
+    bool changed = ensurePreheaders(function);
+    LoopAnalysis analysis(function);
+
+    // De dentro hacia fuera: lo extraído de un bucle interno cae en su
+    // preheader, que pertenece al externo y puede seguir subiendo
+    for (uint32_t loop = 0; loop < analysis.loops.loops().size(); ++loop) {
+        changed |= hoistLoop(function, analysis, loop);
+    }
+    return changed;
+}
+
+// ============================================================================
+// LoopStrengthReductionPass
+// ============================================================================
+
+bool LoopStrengthReductionPass::run(IRFunction& function) {
+    if (function.blockCount() == 0) return false;
+
+    bool changed = ensurePreheaders(function);
+    LoopAnalysis analysis(function);
+    for (uint32_t loop = 0; loop < analysis.loops.loops().size(); ++loop) {
+        changed |= reduceLoop(function, analysis, loop);
+    }
+    return changed;
+}
+
+// ============================================================================
+// LoopUnrollPass
+// ============================================================================
+
+bool LoopUnrollPass::run(IRFunction& function) {
+    if (function.blockCount() == 0) return false;
+
+    bool changed = ensurePreheaders(function);
+
+    // Desenrollar cambia el CFG: se recalcula el análisis tras cada bucle
+    bool unrolled = true;
+    while (unrolled) {
+        unrolled = false;
+        LoopAnalysis analysis(function);
+        for (uint32_t loop = 0; loop < analysis.loops.loops().size(); ++loop) {
+            if (unrollLoop(function, analysis, loop, maxTripCount_, maxUnrolledSize_)) {
+                unrolled = changed = true;
+                break;
+            }
+        }
+    }
+    return changed;
+}
+
+// ============================================================================
+// LoopVectorizePass
+// ============================================================================
+
+VectorTarget VectorTarget::fromCPUFeatures(const CPUFeatures& features) {
+    VectorTarget target;
+    target.registerBytes = features.vectorBytes();
+    target.integerMultiply = features.sse41 || features.avx2;
+    return target;
+}
+
+bool LoopVectorizePass::run(IRFunction& function) {
+    if (function.blockCount() == 0) return false;
+
+    // Una copia de target_clones se vectoriza con sus propias extensiones
+    VectorTarget target = target_;
+    if (std::optional<CPUFeatures> features = parseTargetFeatures(function.getTarget())) {
+        VectorTarget own = VectorTarget::fromCPUFeatures(*features);
+        target.registerBytes = std::max(target.registerBytes, own.registerBytes);
+        target.integerMultiply = target.integerMultiply || own.integerMultiply;
+    }
+
+    bool changed = ensurePreheaders(function);
+
+    // El bucle original queda como resto con la misma forma: se recuerda su
+    // cabecera para no volver a vectorizarlo
+    std::vector<BlockId> done;
+    bool vectorized = true;
+    while (vectorized) {
+        vectorized = false;
+        LoopAnalysis analysis(function);
+        for (uint32_t loop = 0; loop < analysis.loops.loops().size(); ++loop) {
+            BlockId header = analysis.loops.loops()[loop].header;
+            if (std::find(done.begin(), done.end(), header) != done.end()) continue;
+            if (vectorizeLoop(function, analysis, loop, target)) {
+                done.push_back(header);
+                ++vectorizedCount_;
+                vectorized = changed = true;
+                break;
+            }
+        }
+    }
+    return changed;
+}
+
+} // namespace cpp20::compiler::ir
@@ -0,0 +1,149 @@
+/**
+ * @file MemoryIntrinsics.cpp
+ * @brief Implementación de la conversión entre llamadas a la CRT e intrínsecos de memoria
+ */
+
+#include <compiler/ir/IRPasses.h>
+#include <string_view>
+
+namespace cpp20::compiler::ir {
+
+namespace {
+
+const TypeInfo SizeType(IRType::LongLong, 8, 8, "i64");
+const TypeInfo PointerType(IRType::Pointer, 8, 8, "ptr");
+
+/**
+ * @brief Función de la CRT equivalente a cada intrínseco
+ */
+std::string_view libraryName(IROpcode opcode) {
+    switch (opcode) {
+        case IROpcode::MemCpy: return "memcpy";
+        case IROpcode::MemSet: return "memset";
+        default: return "memcmp";
+    }
+}
+
+/**
+ * @brief El valor es una constante entera entre 1 y limit
+ */
+bool smallConstant(const IRFunction& function, ValueId value, uint64_t limit) {
+    const IRConstant* constant = function.constant(value);
+    return constant && constant->intValue > 0 && static_cast<uint64_t>(constant->intValue) <= limit;
+}
+
+/**
+ * @brief El resultado de memcmp solo se compara con 0 por igualdad
+ */
+bool comparedOnlyWithZero(const IRFunction& function, ValueId result) {
+    bool equality = true;
+    function.forEachUse(result, [&](InstrId user, uint32_t index) {
+        IROpcode opcode = function.instruction(user).opcode;
+        const IRConstant* other = function.constant(function.operand(user, 1 - index));
+        equality = equality && (opcode == IROpcode::CmpEQ || opcode == IROpcode::CmpNE) && other &&
+                   other->intValue == 0;
+    });
+    return equality;
+}
+
+/**
+ * @brief Store que copia entero el resultado de un Load de struct o array, o NoInstr
+ */
+InstrId aggregateCopy(const IRFunction& function, InstrId load) {
+    const Instruction& inst = function.instruction(load);
+    IRType type = function.typeOf(inst.result).type;
+    if ((type != IRType::Struct && type != IRType::Array) || function.useCount(inst.result) != 1) return NoInstr;
+    InstrId store = NoInstr;
+    function.forEachUse(inst.result, [&](InstrId user, uint32_t index) {
+        if (function.instruction(user).opcode == IROpcode::Store && index == 0) store = user;
+    });
+    if (store == NoInstr) return NoInstr;
+
+    // En el mismo bloque y sin nada que escriba en memoria entre ambos
+    for (InstrId id = inst.next; id != NoInstr; id = function.instruction(id).next) {
+        if (id == store) return store;
+        if (writesMemory(function.instruction(id).opcode)) return NoInstr;
+    }
+    return NoInstr;
+}
+
+} // namespace
+
+bool MemoryIntrinsicsPass::run(IRFunction& function) {
+    bool changed = false;
+
+    // Llamadas pequeñas y copias de agregados a intrínsecos
+    for (BlockId block = 0; block < function.blockCount(); ++block) {
+        for (InstrId id : function.instructions(block)) {
+            const Instruction& inst = function.instruction(id);
+            if (inst.opcode == IROpcode::Load) {
+                InstrId store = aggregateCopy(function, id);
+                if (store == NoInstr) continue;
+                ValueId operands[] = {function.operand(store, 1), function.operand(id, 0),
+                                      function.constantInt(static_cast<int64_t>(function.typeOf(inst.result).size),
+                                                           SizeType)};
+                function.insertBefore(store, IROpcode::MemCpy, TypeInfo(), operands, false);
+                function.erase(store);
+                function.erase(id);
+                ++intrinsicCount_;
+                changed = true;
+                continue;
+            }
+
+            if (inst.opcode != IROpcode::Call || inst.tail || function.operandCount(id) != 4) continue;
+            ValueId callee = function.operand(id, 0);
+            if (function.value(callee).kind != ValueKind::Global) continue;
+            std::string_view name = function.globalName(callee);
+            IROpcode opcode = name == "memcpy" ? IROpcode::MemCpy
+                            : name == "memset" ? IROpcode::MemSet
+                            : name == "memcmp" ? IROpcode::MemCmp
+                                               : IROpcode::Call;
+            if (opcode == IROpcode::Call || !smallConstant(function, function.operand(id, 3), inlineLimit_)) continue;
+            if (opcode == IROpcode::MemSet && !function.constant(function.operand(id, 2))) continue;
+            if (opcode == IROpcode::MemCmp && (inst.result == NoValue || !comparedOnlyWithZero(function, inst.result))) {
+                continue;
+            }
+
+            ValueId operands[] = {function.operand(id, 1), function.operand(id, 2), function.operand(id, 3)};
+            ValueId result = inst.result;
+            bool producesValue = opcode == IROpcode::MemCmp;
+            TypeInfo type = producesValue ? function.typeOf(result) : TypeInfo();
+            InstrId intrinsic = function.insertBefore(id, opcode, type, operands, producesValue);
+            // memcpy y memset devuelven el destino
+            if (result != NoValue) {
+                function.replaceAllUsesWith(result, producesValue ? function.instruction(intrinsic).result : operands[0]);
+            }
+            function.erase(id);
+            ++intrinsicCount_;
+            changed = true;
+        }
+    }
+
+    // Lo que el back-end no expande vuelve a ser una llamada
+    for (BlockId block = 0; block < function.blockCount(); ++block) {
+        for (InstrId id : function.instructions(block)) {
+            const Instruction& inst = function.instruction(id);
+            if (inst.opcode != IROpcode::MemCpy && inst.opcode != IROpcode::MemSet && inst.opcode != IROpcode::MemCmp) {
+                continue;
+            }
+            if (smallConstant(function, function.operand(id, 2), inlineLimit_) &&
+                (inst.opcode != IROpcode::MemSet || function.constant(function.operand(id, 1)))) {
+                continue;
+            }
+
+            ValueId operands[] = {function.global(libraryName(inst.opcode), PointerType), function.operand(id, 0),
+                                  function.operand(id, 1), function.operand(id, 2)};
+            ValueId result = inst.result;
+            bool producesValue = result != NoValue;
+            TypeInfo type = producesValue ? function.typeOf(result) : TypeInfo();
+            InstrId call = function.insertBefore(id, IROpcode::Call, type, operands, producesValue);
+            if (producesValue) function.replaceAllUsesWith(result, function.instruction(call).result);
+            function.erase(id);
+            ++libraryCallCount_;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+} // namespace cpp20::compiler::ir
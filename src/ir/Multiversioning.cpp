@@ -0,0 +1,158 @@
+/**
+ * @file Multiversioning.cpp
+ * @brief Implementación de la multiversión de funciones con target_clones
+ */
+
+#include <compiler/ir/IRPasses.h>
+#include <compiler/common/EnvironmentDetector.h>
+#include <algorithm>
+#include <unordered_map>
+
+namespace cpp20::compiler::ir {
+
+namespace {
+
+const TypeInfo BoolType(IRType::Bool, 1, 1, "bool");
+const TypeInfo MaskType(IRType::Int, 4, 4, "i32");
+const TypeInfo PointerType(IRType::Pointer, 8, 8, "ptr");
+
+struct Target {
+    std::string name;
+    uint32_t mask;
+};
+
+/**
+ * @brief Función que guarda en F.ptr la mejor copia que admite la CPU
+ * @param targets Extensiones de mayor a menor, sin la default
+ */
+std::unique_ptr<IRFunction> buildResolver(const IRFunction& function, const std::vector<Target>& targets) {
+    auto resolver = std::make_unique<IRFunction>(function.getName() + ".resolver", TypeInfo(),
+                                                 std::vector<TypeInfo>());
+    resolver->setLinkage(function.getLinkage());
+    IRBuilder builder(*resolver);
+    builder.setInsertPoint(builder.createBlock("entry"));
+    ValueId pointer = builder.getGlobal(function.getName() + ".ptr", PointerType);
+    ValueId features = builder.createCPUFeatures(MaskType);
+
+    auto bind = [&](const std::string& target) {
+        builder.createStore(builder.getGlobal(function.getName() + "." + target, PointerType), pointer);
+        builder.createReturn();
+    };
+    for (const Target& target : targets) {
+        ValueId required = builder.getInt(target.mask, MaskType);
+        ValueId present = builder.createBinary(IROpcode::And, features, required, MaskType);
+        ValueId supported = builder.createBinary(IROpcode::CmpEQ, present, required, BoolType);
+        BlockId chosen = builder.createBlock(target.name);
+        BlockId next = builder.createBlock("");
+        builder.createConditionalBranch(supported, chosen, next);
+        builder.setInsertPoint(chosen);
+        bind(target.name);
+        builder.setInsertPoint(next);
+    }
+    bind("default");
+    return resolver;
+}
+
+/**
+ * @brief Sustituto de F con su firma: salto de cola a la copia elegida
+ */
+std::unique_ptr<IRFunction> buildThunk(const IRFunction& function) {
+    auto thunk = std::make_unique<IRFunction>(function.getName(), function.getReturnType(),
+                                              std::vector<TypeInfo>());
+    for (size_t i = 0; i < function.getParamTypes().size(); ++i) {
+        thunk->addParameter(function.getParamNames()[i], function.getParamTypes()[i]);
+    }
+    thunk->setLinkage(function.getLinkage());
+    thunk->setInlineHint(function.getInlineHint());
+    IRBuilder builder(*thunk);
+    builder.setInsertPoint(builder.createBlock("entry"));
+    ValueId callee = builder.createLoad(builder.getGlobal(function.getName() + ".ptr", PointerType), PointerType);
+    std::vector<ValueId> args;
+    for (size_t i = 0; i < function.getParamTypes().size(); ++i) args.push_back(thunk->parameter(i));
+    builder.createTailCall(callee, args, function.getReturnType());
+    return thunk;
+}
+
+} // namespace
+
+bool MultiversioningPass::run(IRModule& module) {
+    std::vector<std::unique_ptr<IRFunction>> functions = module.takeFunctions();
+    std::vector<std::unique_ptr<IRFunction>> added;
+    std::unordered_map<std::string, std::string> familyOf;     // Copia -> función original
+    std::unordered_map<std::string, bool> dispatched;          // Funciones que llaman por puntero
+
+    for (auto& function : functions) {
+        if (function->getTargetClones().empty()) continue;
+        std::vector<Target> targets;
+        for (const std::string& name : function->getTargetClones()) {
+            std::optional<CPUFeatures> features = parseTargetFeatures(name);
+            if (!features) {
+                ++ignoredTargetCount_;
+                continue;
+            }
+            if (features->mask() != 0) targets.push_back({name, features->mask()});
+        }
+        function->setTargetClones({});
+        if (targets.empty() || function->blockCount() == 0) continue;
+
+        // Las extensiones son acumulativas: la de más bits es la mejor
+        std::stable_sort(targets.begin(), targets.end(),
+                         [](const Target& a, const Target& b) { return a.mask > b.mask; });
+        targets.erase(std::unique(targets.begin(), targets.end(),
+                                  [](const Target& a, const Target& b) { return a.mask == b.mask; }),
+                      targets.end());
+
+        const std::string& name = function->getName();
+        std::vector<std::string> clones;
+        for (const Target& target : targets) clones.push_back(target.name);
+        clones.push_back("default");
+        for (const std::string& target : clones) {
+            auto clone = std::make_unique<IRFunction>(*function);
+            clone->setName(name + "." + target);
+            if (target != "default") clone->setTarget(target);
+            familyOf.emplace(clone->getName(), name);
+            added.push_back(std::move(clone));
+            ++cloneCount_;
+        }
+        module.addGlobalVariable(std::make_unique<IRGlobalVariable>(name + ".ptr", PointerType));
+        added.push_back(buildResolver(*function, targets));
+        module.addInitializer(name + ".resolver");
+        dispatched.emplace(name, true);
+        function = buildThunk(*function);
+    }
+    if (dispatched.empty()) {
+        for (auto& function : functions) module.addFunction(std::move(function));
+        return false;
+    }
+
+    for (auto& function : added) functions.push_back(std::move(function));
+    for (auto& function : functions) {
+        auto family = familyOf.find(function->getName());
+        for (BlockId block = 0; block < function->blockCount(); ++block) {
+            for (InstrId id : function->instructions(block)) {
+                const Instruction& inst = function->instruction(id);
+                if (inst.opcode != IROpcode::Call && inst.opcode != IROpcode::Invoke) continue;
+                ValueId callee = function->operand(id, 0);
+                if (function->value(callee).kind != ValueKind::Global ||
+                    !dispatched.count(function->globalName(callee))) {
+                    continue;
+                }
+                const std::string& target = function->globalName(callee);
+                // El thunk de F nunca se llama a sí mismo: F aquí es una llamada recursiva de una copia
+                if (family != familyOf.end() && family->second == target) {
+                    function->setOperand(id, 0, function->global(function->getName(), function->typeOf(callee)));
+                    continue;
+                }
+                ValueId address = function->global(target + ".ptr", PointerType);
+                InstrId load = function->insertBefore(id, IROpcode::Load, PointerType,
+                                                      std::span<const ValueId>(&address, 1), true);
+                function->setOperand(id, 0, function->instruction(load).result);
+                ++dispatchedCallCount_;
+            }
+        }
+    }
+    for (auto& function : functions) module.addFunction(std::move(function));
+    return true;
+}
+
+} // namespace cpp20::compiler::ir
@@ -0,0 +1,291 @@
+/**
+ * @file Profile.cpp
+ * @brief Instrumentación, lectura y escritura de perfiles y anotación de frecuencias
+ */
+
+#include <compiler/ir/Profile.h>
+#include <compiler/common/utils/HashUtils.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace cpp20::compiler::ir {
+
+namespace {
+
+constexpr char kMagic[8] = {'C', 'P', 'P', 'P', 'R', 'O', 'F', '1'};
+
+const TypeInfo CounterType(IRType::LongLong, 8, 8, "i64");
+const TypeInfo CounterPointerType(IRType::Pointer, 8, 8, "i64*");
+const TypeInfo WriteFunctionType(IRType::Pointer, 8, 8, "void()*");
+
+template <typename T>
+void writeLE(std::vector<uint8_t>& out, T value) {
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        out.push_back(static_cast<uint8_t>(static_cast<uint64_t>(value) >> (8 * i)));
+    }
+}
+
+/**
+ * @brief Lector con comprobación de límites
+ */
+class Reader {
+public:
+    explicit Reader(std::span<const uint8_t> bytes) : bytes_(bytes) {}
+
+    template <typename T>
+    bool read(T& value) {
+        if (bytes_.size() - position_ < sizeof(T)) return false;
+        uint64_t result = 0;
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            result |= static_cast<uint64_t>(bytes_[position_ + i]) << (8 * i);
+        }
+        position_ += sizeof(T);
+        value = static_cast<T>(result);
+        return true;
+    }
+
+    bool read(std::string& value, size_t length) {
+        if (bytes_.size() - position_ < length) return false;
+        value.assign(reinterpret_cast<const char*>(bytes_.data() + position_), length);
+        position_ += length;
+        return true;
+    }
+
+    bool atEnd() const { return position_ == bytes_.size(); }
+
+private:
+    std::span<const uint8_t> bytes_;
+    size_t position_ = 0;
+};
+
+/**
+ * @brief Primera instrucción del bloque que no es Phi ni LandingPad
+ */
+InstrId insertionPoint(const IRFunction& function, BlockId block) {
+    for (InstrId id : function.instructions(block)) {
+        IROpcode opcode = function.instruction(id).opcode;
+        if (opcode != IROpcode::Phi && opcode != IROpcode::LandingPad) return id;
+    }
+    return NoInstr;
+}
+
+} // namespace
+
+uint64_t profileHash(const IRFunction& function) {
+    using common::utils::hashMix;
+    uint64_t hash = hashMix(common::utils::fnv1a64(function.getName()), function.blockCount());
+    std::vector<BlockId> successors;
+    for (BlockId block = 0; block < function.blockCount(); ++block) {
+        function.successors(block, successors);
+        hash = hashMix(hash, successors.size());
+        for (BlockId successor : successors) {
+            hash = hashMix(hash, successor);
+        }
+    }
+    return hash;
+}
+
+// ============================================================================
+// ProfileData
+// ============================================================================
+
+void ProfileData::addFunction(const std::string& name, FunctionProfile profile) {
+    auto [it, inserted] = functions_.try_emplace(name, std::move(profile));
+    if (inserted) return;
+
+    FunctionProfile& existing = it->second;
+    if (existing.hash != profile.hash || existing.counts.size() != profile.counts.size()) {
+        existing = std::move(profile);
+        return;
+    }
+    for (size_t i = 0; i < existing.counts.size(); ++i) {
+        existing.counts[i] += profile.counts[i];
+    }
+}
+
+const FunctionProfile* ProfileData::find(const std::string& name) const {
+    auto it = functions_.find(name);
+    return it == functions_.end() ? nullptr : &it->second;
+}
+
+void ProfileData::serialize(std::vector<uint8_t>& out) const {
+    out.insert(out.end(), std::begin(kMagic), std::end(kMagic));
+    writeLE<uint32_t>(out, static_cast<uint32_t>(functions_.size()));
+    for (const auto& [name, profile] : functions_) {
+        writeLE<uint32_t>(out, static_cast<uint32_t>(name.size()));
+        out.insert(out.end(), name.begin(), name.end());
+        writeLE<uint64_t>(out, profile.hash);
+        writeLE<uint32_t>(out, static_cast<uint32_t>(profile.counts.size()));
+        for (uint64_t count : profile.counts) {
+            writeLE<uint64_t>(out, count);
+        }
+    }
+}
+
+bool ProfileData::merge(std::span<const uint8_t> bytes) {
+    if (bytes.size() < sizeof(kMagic) || std::memcmp(bytes.data(), kMagic, sizeof(kMagic)) != 0) {
+        lastError_ = "No es un perfil de este compilador";
+        return false;
+    }
+
+    // Se lee entero antes de sumar: un perfil truncado no deja nada a medias
+    Reader reader(bytes.subspan(sizeof(kMagic)));
+    uint32_t functionCount = 0;
+    if (!reader.read(functionCount)) {
+        lastError_ = "Perfil truncado";
+        return false;
+    }
+    std::vector<std::pair<std::string, FunctionProfile>> read;
+    for (uint32_t i = 0; i < functionCount; ++i) {
+        uint32_t length = 0;
+        uint32_t counters = 0;
+        std::pair<std::string, FunctionProfile> entry;
+        if (!reader.read(length) || !reader.read(entry.first, length) || !reader.read(entry.second.hash) ||
+            !reader.read(counters)) {
+            lastError_ = "Perfil truncado";
+            return false;
+        }
+        entry.second.counts.resize(counters);
+        for (uint64_t& count : entry.second.counts) {
+            if (!reader.read(count)) {
+                lastError_ = "Perfil truncado";
+                return false;
+            }
+        }
+        read.push_back(std::move(entry));
+    }
+    if (!reader.atEnd()) {
+        lastError_ = "Datos sobrantes al final del perfil";
+        return false;
+    }
+
+    for (auto& [name, profile] : read) {
+        addFunction(name, std::move(profile));
+    }
+    return true;
+}
+
+bool ProfileData::readFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        lastError_ = "No se puede abrir " + path.string();
+        return false;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return merge(bytes);
+}
+
+bool ProfileData::writeFile(const std::filesystem::path& path) const {
+    std::vector<uint8_t> bytes;
+    serialize(bytes);
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return static_cast<bool>(file);
+}
+
+std::vector<std::string> ProfileData::hotFunctionOrder() const {
+    std::vector<std::pair<uint64_t, const std::string*>> entries;
+    for (const auto& [name, profile] : functions_) {
+        if (!profile.counts.empty() && profile.counts[0] > 0) entries.emplace_back(profile.counts[0], &name);
+    }
+    // Empates por nombre (functions_ ya está ordenado): orden estable
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    std::vector<std::string> order;
+    order.reserve(entries.size());
+    for (const auto& entry : entries) {
+        order.push_back(*entry.second);
+    }
+    return order;
+}
+
+// ============================================================================
+// ProfileInstrumentationPass
+// ============================================================================
+
+bool ProfileInstrumentationPass::run(IRModule& module) {
+    bool changed = false;
+    for (const auto& function : module.getFunctions()) {
+        size_t blocks = function->blockCount();
+        if (blocks == 0) continue;
+
+        std::string counters = ProfileCounterPrefix + function->getName();
+        module.addGlobalVariable(std::make_unique<IRGlobalVariable>(
+            counters, TypeInfo(IRType::Array, 8 * blocks, 8, "i64[" + std::to_string(blocks) + "]"),
+            IRConstant{}));
+        ValueId base = function->global(counters, CounterPointerType);
+        ValueId one = function->constantInt(1, CounterType);
+
+        for (BlockId block = 0; block < blocks; ++block) {
+            InstrId position = insertionPoint(*function, block);
+            ValueId addressOperands[] = {base, function->constantInt(block, CounterType)};
+            auto emit = [&](IROpcode opcode, const TypeInfo& type, std::span<const ValueId> operands,
+                            bool producesValue) {
+                InstrId id = position == NoInstr
+                                 ? function->append(block, opcode, type, operands, producesValue)
+                                 : function->insertBefore(position, opcode, type, operands, producesValue);
+                return function->instruction(id).result;
+            };
+            ValueId address = emit(IROpcode::GetElementPtr, CounterPointerType, addressOperands, true);
+            ValueId loadOperands[] = {address};
+            ValueId count = emit(IROpcode::Load, CounterType, loadOperands, true);
+            ValueId addOperands[] = {count, one};
+            ValueId incremented = emit(IROpcode::Add, CounterType, addOperands, true);
+            ValueId storeOperands[] = {incremented, address};
+            emit(IROpcode::Store, TypeInfo(), storeOperands, false);
+        }
+
+        if (function->getName() == "main") {
+            ValueId writer = function->global(ProfileWriteFunction, WriteFunctionType);
+            for (BlockId block = 0; block < blocks; ++block) {
+                InstrId ret = function->terminator(block);
+                if (ret == NoInstr || function->instruction(ret).opcode != IROpcode::Ret) continue;
+                function->insertBefore(ret, IROpcode::Call, TypeInfo(), std::span<const ValueId>(&writer, 1),
+                                       false);
+            }
+        }
+
+        ++instrumentedCount_;
+        changed = true;
+    }
+    return changed;
+}
+
+// ============================================================================
+// ProfileAnnotatePass
+// ============================================================================
+
+bool ProfileAnnotatePass::run(IRModule& module) {
+    bool changed = false;
+    for (const auto& function : module.getFunctions()) {
+        if (function->blockCount() == 0) continue;
+        const FunctionProfile* profile = profile_.find(function->getName());
+
+        // Definida pero sin recuentos: no se ejecutó nunca
+        if (!profile) {
+            if (profile_.empty()) continue;
+            for (BlockId block = 0; block < function->blockCount(); ++block) {
+                function->setBlockFrequency(block, 0);
+            }
+            ++annotatedCount_;
+            changed = true;
+            continue;
+        }
+
+        if (profile->hash != profileHash(*function) || profile->counts.size() != function->blockCount()) {
+            ++mismatchedCount_;
+            continue;
+        }
+        for (BlockId block = 0; block < function->blockCount(); ++block) {
+            function->setBlockFrequency(block, profile->counts[block]);
+        }
+        ++annotatedCount_;
+        changed = true;
+    }
+    return changed;
+}
+
+} // namespace cpp20::compiler::ir
@@ -0,0 +1,339 @@
+/**
+ * @file SwitchLowering.cpp
+ * @brief Implementación de la bajada de Switch
+ */
+
+#include <compiler/ir/IRPasses.h>
+#include <algorithm>
+#include <bit>
+
+namespace cpp20::compiler::ir {
+
+namespace {
+
+const TypeInfo BoolType(IRType::Bool, 1, 1, "bool");
+
+struct SwitchCase {
+    int64_t value;
+    ValueId constant;
+    BlockId target;
+};
+
+/**
+ * @brief Casos consecutivos que resuelve una hoja del árbol
+ */
+struct Cluster {
+    enum Kind : uint8_t { Range, JumpTable, BitTest } kind;
+    size_t first;   // Casos [first, last] en orden de valor
+    size_t last;
+};
+
+/**
+ * @brief Valores de low a high, ambos incluidos (0 si no caben en 64 bits)
+ */
+uint64_t spanOf(int64_t low, int64_t high) {
+    return static_cast<uint64_t>(high) - static_cast<uint64_t>(low) + 1;
+}
+
+/**
+ * @brief Bajada de un Switch; las aristas nuevas se anotan para los phis
+ */
+class SwitchLowering {
+public:
+    SwitchLowering(IRFunction& function, const SwitchLoweringOptions& options, InstrId term)
+        : function_(function), options_(options), block_(function.instruction(term).block),
+          value_(function.operand(term, 0)), type_(function.typeOf(value_)),
+          defaultBlock_(function.labelBlock(function.operand(term, 1))), term_(term) {
+        for (size_t i = 2; i + 1 < function.operandCount(term); i += 2) {
+            ValueId constant = function.operand(term, i);
+            cases_.push_back({function.constant(constant)->intValue, constant,
+                              function.labelBlock(function.operand(term, i + 1))});
+        }
+        std::stable_sort(cases_.begin(), cases_.end(),
+                         [](const SwitchCase& a, const SwitchCase& b) { return a.value < b.value; });
+        cases_.erase(std::unique(cases_.begin(), cases_.end(),
+                                 [](const SwitchCase& a, const SwitchCase& b) { return a.value == b.value; }),
+                     cases_.end());
+        function.successors(block_, originalSuccessors_);
+    }
+
+    /**
+     * @return false si el Switch ya era una tabla y se deja como está
+     */
+    bool run(size_t& jumpTables, size_t& bitTests, size_t& comparisons) {
+        buildClusters();
+        for (const Cluster& cluster : clusters_) {
+            if (cluster.kind == Cluster::JumpTable) ++jumpTables;
+            if (cluster.kind == Cluster::BitTest) ++bitTests;
+        }
+        if (clusters_.size() == 1 && clusters_[0].kind == Cluster::JumpTable &&
+            clusters_[0].first == 0 && clusters_[0].last + 1 == cases_.size()) {
+            return false;
+        }
+
+        function_.erase(term_);
+        int64_t bits = static_cast<int64_t>(type_.size) * 8;
+        int64_t min = bits >= 64 ? INT64_MIN : -(int64_t{1} << (bits - 1));
+        int64_t max = bits >= 64 ? INT64_MAX : (int64_t{1} << (bits - 1)) - 1;
+        if (clusters_.empty()) {
+            branch(block_, defaultBlock_);
+        } else {
+            lower(0, clusters_.size() - 1, block_, min, max);
+        }
+        comparisons += comparisons_;
+        rewritePhis();
+        return true;
+    }
+
+private:
+    IRFunction& function_;
+    const SwitchLoweringOptions& options_;
+    BlockId block_;
+    ValueId value_;
+    TypeInfo type_;
+    BlockId defaultBlock_;
+    InstrId term_;
+    std::vector<SwitchCase> cases_;
+    std::vector<Cluster> clusters_;
+    std::vector<BlockId> originalSuccessors_;
+    std::vector<std::pair<BlockId, BlockId>> edges_;
+    size_t comparisons_ = 0;
+
+    int64_t low(const Cluster& cluster) const { return cases_[cluster.first].value; }
+    int64_t high(const Cluster& cluster) const { return cases_[cluster.last].value; }
+
+    void buildClusters() {
+        size_t minTable = std::max<size_t>(options_.minJumpTableCases, 2);
+        uint64_t bits = static_cast<uint64_t>(type_.size) * 8;
+
+        for (size_t i = 0; i < cases_.size();) {
+            // Tabla: el tramo más largo desde i con densidad suficiente
+            size_t best = i;
+            for (size_t j = i + minTable - 1; j < cases_.size(); ++j) {
+                uint64_t entries = spanOf(cases_[i].value, cases_[j].value);
+                if (entries == 0 || entries > options_.maxJumpTableEntries) break;
+                if ((j - i + 1) * 100 >= entries * options_.minJumpTableDensity) best = j;
+            }
+            if (best > i) {
+                clusters_.push_back({Cluster::JumpTable, i, best});
+                i = best + 1;
+                continue;
+            }
+
+            // Prueba de bits: el tramo más largo dentro de una palabra con pocos destinos
+            std::vector<BlockId> destinations;
+            for (size_t j = i; j < cases_.size(); ++j) {
+                uint64_t span = spanOf(cases_[i].value, cases_[j].value);
+                if (span == 0 || span > bits) break;
+                if (std::find(destinations.begin(), destinations.end(), cases_[j].target) == destinations.end()) {
+                    if (destinations.size() == options_.maxBitTestDestinations) break;
+                    destinations.push_back(cases_[j].target);
+                }
+                best = j;
+            }
+            bool contiguous = spanOf(cases_[i].value, cases_[best].value) == best - i + 1;
+            if (best - i + 1 >= options_.minBitTestCases && !(contiguous && destinations.size() == 1)) {
+                clusters_.push_back({Cluster::BitTest, i, best});
+                i = best + 1;
+                continue;
+            }
+
+            // Rango: valores consecutivos con el mismo destino
+            size_t last = i;
+            while (last + 1 < cases_.size() && cases_[last + 1].target == cases_[i].target &&
+                   cases_[last + 1].value == cases_[last].value + 1) {
+                ++last;
+            }
+            clusters_.push_back({Cluster::Range, i, last});
+            i = last + 1;
+        }
+    }
+
+    BlockId newBlock() {
+        return function_.createBlock(function_.block(block_).name + ".sw" +
+                                     std::to_string(function_.blockCount()));
+    }
+
+    ValueId constant(int64_t value) { return function_.constantInt(value, type_); }
+
+    ValueId emit(BlockId block, IROpcode opcode, const TypeInfo& type, ValueId left, ValueId right) {
+        ValueId operands[] = {left, right};
+        return function_.instruction(function_.append(block, opcode, type, operands, true)).result;
+    }
+
+    void branch(BlockId from, BlockId to) {
+        ValueId label = function_.blockLabel(to);
+        function_.append(from, IROpcode::Br, TypeInfo(), std::span<const ValueId>(&label, 1), false);
+        edges_.emplace_back(from, to);
+    }
+
+    /**
+     * @brief BrCond sobre value_ <opcode> bound
+     */
+    void branchIf(BlockId from, IROpcode opcode, int64_t bound, BlockId ifTrue, BlockId ifFalse) {
+        if (ifTrue == ifFalse) {
+            branch(from, ifTrue);
+            return;
+        }
+        ValueId condition = emit(from, opcode, BoolType, value_, constant(bound));
+        ValueId operands[] = {condition, function_.blockLabel(ifTrue), function_.blockLabel(ifFalse)};
+        function_.append(from, IROpcode::BrCond, TypeInfo(), operands, false);
+        edges_.emplace_back(from, ifTrue);
+        edges_.emplace_back(from, ifFalse);
+        ++comparisons_;
+    }
+
+    /**
+     * @brief Descarta lo que queda fuera de [lo, hi] si [min, max] no lo excluye ya
+     * @return Bloque en el que value_ está en [lo, hi]
+     */
+    BlockId checkBounds(BlockId block, int64_t lo, int64_t hi, int64_t min, int64_t max) {
+        if (lo > min) {
+            BlockId next = newBlock();
+            branchIf(block, IROpcode::CmpLT, lo, defaultBlock_, next);
+            block = next;
+        }
+        if (hi < max) {
+            BlockId next = newBlock();
+            branchIf(block, IROpcode::CmpGT, hi, defaultBlock_, next);
+            block = next;
+        }
+        return block;
+    }
+
+    /**
+     * @brief Árbol equilibrado sobre los grupos [first, last]; value_ está en [min, max]
+     */
+    void lower(size_t first, size_t last, BlockId block, int64_t min, int64_t max) {
+        if (first == last) {
+            lowerCluster(clusters_[first], block, min, max);
+            return;
+        }
+        size_t mid = (first + last + 1) / 2;
+        int64_t pivot = low(clusters_[mid]);
+        BlockId left = newBlock();
+        BlockId right = newBlock();
+        branchIf(block, IROpcode::CmpLT, pivot, left, right);
+        lower(first, mid - 1, left, min, pivot - 1);
+        lower(mid, last, right, pivot, max);
+    }
+
+    void lowerCluster(const Cluster& cluster, BlockId block, int64_t min, int64_t max) {
+        switch (cluster.kind) {
+            case Cluster::Range: {
+                BlockId target = cases_[cluster.first].target;
+                if (low(cluster) == high(cluster) && (low(cluster) != min || high(cluster) != max)) {
+                    branchIf(block, IROpcode::CmpEQ, low(cluster), target, defaultBlock_);
+                    return;
+                }
+                branch(checkBounds(block, low(cluster), high(cluster), min, max), target);
+                return;
+            }
+
+            case Cluster::JumpTable: {
+                // El back-end comprueba el rango antes de indexar la tabla
+                std::vector<ValueId> operands = {value_, function_.blockLabel(defaultBlock_)};
+                for (size_t i = cluster.first; i <= cluster.last; ++i) {
+                    operands.push_back(cases_[i].constant);
+                    operands.push_back(function_.blockLabel(cases_[i].target));
+                    edges_.emplace_back(block, cases_[i].target);
+                }
+                function_.append(block, IROpcode::Switch, TypeInfo(), operands, false);
+                edges_.emplace_back(block, defaultBlock_);
+                return;
+            }
+
+            case Cluster::BitTest: {
+                block = checkBounds(block, low(cluster), high(cluster), min, max);
+                ValueId shift = low(cluster) == 0 ? value_
+                                                  : emit(block, IROpcode::Sub, type_, value_, constant(low(cluster)));
+                ValueId bit = emit(block, IROpcode::Shl, type_, constant(1), shift);
+
+                // Una máscara por destino, primero el que más casos tiene
+                std::vector<std::pair<BlockId, uint64_t>> masks;
+                for (size_t i = cluster.first; i <= cluster.last; ++i) {
+                    auto it = std::find_if(masks.begin(), masks.end(),
+                                           [&](const auto& mask) { return mask.first == cases_[i].target; });
+                    if (it == masks.end()) it = masks.insert(masks.end(), {cases_[i].target, 0});
+                    it->second |= uint64_t{1} << (cases_[i].value - low(cluster));
+                }
+                std::stable_sort(masks.begin(), masks.end(), [](const auto& a, const auto& b) {
+                    return std::popcount(a.second) > std::popcount(b.second);
+                });
+
+                int bits = static_cast<int>(type_.size) * 8;
+                for (size_t m = 0; m < masks.size(); ++m) {
+                    // La máscara como constante del tipo, con el signo de su anchura
+                    uint64_t mask = masks[m].second;
+                    int64_t signedMask = bits >= 64 ? static_cast<int64_t>(mask)
+                                                    : static_cast<int64_t>(mask << (64 - bits)) >> (64 - bits);
+                    ValueId masked = emit(block, IROpcode::And, type_, bit, constant(signedMask));
+                    ValueId condition = emit(block, IROpcode::CmpNE, BoolType, masked, constant(0));
+                    BlockId otherwise = m + 1 < masks.size() ? newBlock() : defaultBlock_;
+                    ValueId operands[] = {condition, function_.blockLabel(masks[m].first),
+                                          function_.blockLabel(otherwise)};
+                    function_.append(block, IROpcode::BrCond, TypeInfo(), operands, false);
+                    edges_.emplace_back(block, masks[m].first);
+                    edges_.emplace_back(block, otherwise);
+                    ++comparisons_;
+                    block = otherwise;
+                }
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief La entrada de cada phi desde el bloque original pasa a sus nuevos predecesores
+     */
+    void rewritePhis() {
+        for (BlockId succ : originalSuccessors_) {
+            std::vector<BlockId> predecessors;
+            for (const auto& [from, to] : edges_) {
+                if (to == succ && std::find(predecessors.begin(), predecessors.end(), from) == predecessors.end()) {
+                    predecessors.push_back(from);
+                }
+            }
+
+            std::vector<std::pair<InstrId, ValueId>> incoming;
+            for (InstrId id : function_.instructions(succ)) {
+                if (function_.instruction(id).opcode != IROpcode::Phi) break;
+                for (size_t i = 0; i + 1 < function_.operandCount(id); i += 2) {
+                    if (function_.labelBlock(function_.operand(id, i + 1)) == block_) {
+                        incoming.emplace_back(id, function_.operand(id, i));
+                        break;
+                    }
+                }
+            }
+            if (incoming.empty()) continue;
+
+            function_.removeIncoming(succ, block_);
+            for (const auto& [phi, value] : incoming) {
+                for (BlockId pred : predecessors) {
+                    function_.addOperand(phi, value);
+                    function_.addOperand(phi, function_.blockLabel(pred));
+                }
+            }
+        }
+    }
+};
+
+} // namespace
+
+bool SwitchLoweringPass::run(IRFunction& function) {
+    std::vector<InstrId> switches;
+    for (BlockId block = 0; block < function.blockCount(); ++block) {
+        InstrId term = function.terminator(block);
+        if (term != NoInstr && function.instruction(term).opcode == IROpcode::Switch) {
+            switches.push_back(term);
+        }
+    }
+
+    bool changed = false;
+    for (InstrId term : switches) {
+        changed |= SwitchLowering(function, options_, term).run(jumpTableCount_, bitTestCount_, comparisonCount_);
+    }
+    return changed;
+}
+
+} // namespace cpp20::compiler::ir
@@ -0,0 +1,101 @@
+/**
+ * @file TailCalls.cpp
+ * @brief Implementación del marcado de llamadas en posición de cola
+ */
+
+#include <compiler/ir/IRPasses.h>
+#include <compiler/ir/IRAnalysis.h>
+
+namespace cpp20::compiler::ir {
+
+namespace {
+
+/**
+ * @brief La dirección se usa para algo más que cargar y guardar en ella
+ */
+bool escapes(const IRFunction& function, ValueId address) {
+    bool escaped = false;
+    function.forEachUse(address, [&](InstrId user, uint32_t index) {
+        IROpcode opcode = function.instruction(user).opcode;
+        escaped = escaped || !((opcode == IROpcode::Load && index == 0) || (opcode == IROpcode::Store && index == 1));
+    });
+    return escaped;
+}
+
+/**
+ * @brief El bloque solo devuelve: un Ret, quizá de su único phi
+ * @param returned Lo que devuelve al llegar desde from (NoValue si nada)
+ */
+bool returnsOnly(const IRFunction& function, BlockId block, BlockId from, ValueId& returned) {
+    InstrId first = function.block(block).first;
+    if (first == NoInstr) return false;
+    InstrId ret = first;
+    ValueId phi = NoValue;
+    if (function.instruction(first).opcode == IROpcode::Phi) {
+        phi = function.instruction(first).result;
+        ret = function.instruction(first).next;
+    }
+    if (ret == NoInstr || function.instruction(ret).opcode != IROpcode::Ret) return false;
+
+    returned = function.operandCount(ret) == 0 ? NoValue : function.operand(ret, 0);
+    if (phi == NoValue) return true;
+    if (returned != phi) return false;
+    returned = NoValue;
+    for (size_t i = 0; i + 1 < function.operandCount(first); i += 2) {
+        if (function.labelBlock(function.operand(first, i + 1)) == from) returned = function.operand(first, i);
+    }
+    return returned != NoValue;
+}
+
+} // namespace
+
+bool TailCallPass::run(IRFunction& function) {
+    // El llamado no puede recibir nada del marco, que se libera antes del salto
+    for (BlockId block = 0; block < function.blockCount(); ++block) {
+        for (InstrId id : function.instructions(block)) {
+            const Instruction& inst = function.instruction(id);
+            if (inst.opcode == IROpcode::Alloca && escapes(function, inst.result)) return false;
+        }
+    }
+
+    ControlFlowGraph cfg(function);
+    std::vector<size_t> predecessors(function.blockCount());
+    for (BlockId block = 0; block < function.blockCount(); ++block) {
+        predecessors[block] = cfg.predecessors(block).size();
+    }
+
+    bool changed = false;
+    for (BlockId block = 0; block < function.blockCount(); ++block) {
+        InstrId term = function.terminator(block);
+        if (term == NoInstr) continue;
+        InstrId call = function.instruction(term).prev;
+        if (call == NoInstr || function.instruction(call).opcode != IROpcode::Call || function.instruction(call).tail) {
+            continue;
+        }
+        ValueId result = function.instruction(call).result;
+
+        if (function.instruction(term).opcode == IROpcode::Br) {
+            // Call; br ret: el Ret se duplica en este bloque
+            BlockId target = function.labelBlock(function.operand(term, 0));
+            ValueId returned = NoValue;
+            if (target == block || !returnsOnly(function, target, block, returned)) continue;
+            if (returned != NoValue && returned != result) continue;
+            function.removeIncoming(target, block);
+            function.erase(term);
+            function.append(block, IROpcode::Ret, TypeInfo(), std::span<const ValueId>(&returned, returned != NoValue),
+                            false);
+            if (--predecessors[target] == 0 && target != 0) function.clearBlock(target);
+            ++duplicatedReturnCount_;
+        } else if (function.instruction(term).opcode != IROpcode::Ret ||
+                   (function.operandCount(term) != 0 && function.operand(term, 0) != result)) {
+            continue;
+        }
+
+        function.setTailCall(call);
+        ++tailCallCount_;
+        changed = true;
+    }
+    return changed;
+}
+
+} // namespace cpp20::compiler::ir
@@ -4,15 +4,92 @@
  */
 
 #include <compiler/modules/BinaryModuleInterface.h>
+#include <compiler/common/CacheFile.h>
+#include <compiler/common/utils/HashUtils.h>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <chrono>
 #include <algorithm>
+#include <cstring>
+#include <system_error>
+#include <thread>
 
 namespace cpp20::compiler::modules {
 
+namespace {
+
+/**
+ * Disposición de un BMI Version1_2 (little-endian):
+ *
+ *   cabecera      magic "CPPBMI\0\0", u32 versión, u32 codificación del
+ *                 AST (0 = sin comprimir), 5 x u32 cadenas de metadatos
+ *                 (módulo, timestamp, compilador, triple, hash fuente),
+ *                 u32 reservado, 3 x u64 tamaños de metadatos y, por cada
+ *                 bloque, u64 offset desde el inicio y u64 elementos
+ *   cadenas       u32 longitud y bytes; cada cadena distinta una vez, y se
+ *                 referencia por su offset dentro del bloque
+ *   entidades     40 bytes: u64 huella del nombre, u32 nombre, mangled,
+ *                 módulo, ubicación, tipo, primera dependencia, número de
+ *                 dependencias, reservado; ordenadas por huella
+ *   referencias   u32 por cadena de las listas (dependencias, entidades
+ *                 importadas)
+ *   imports       20 bytes: u32 módulo, partición, interfaz, primera
+ *                 entidad importada, número de entidades
+ *   requisitos    12 bytes: u32 módulo, versión mínima, opcional
+ *   AST           bytes de serializeAST
+ *
+ * Todo es de ancho fijo: una búsqueda toca la cabecera, las páginas de la
+ * búsqueda binaria y las cadenas de la entidad encontrada.
+ */
+constexpr char kBMIMagic[8] = {'C', 'P', 'P', 'B', 'M', 'I', '\0', '\0'};
+constexpr size_t kBlockTableOffset = 64;
+constexpr size_t kBlockCount = 6;
+constexpr size_t kHeaderSize = kBlockTableOffset + kBlockCount * 16;
+constexpr size_t kEntityEntrySize = 40;
+constexpr size_t kReferenceSize = 4;
+constexpr size_t kImportEntrySize = 20;
+constexpr size_t kRequirementEntrySize = 12;
+
+enum Block { StringsBlock, EntitiesBlock, ReferencesBlock, ImportsBlock, RequirementsBlock, ASTBlock };
+
+uint64_t nameFingerprint(std::string_view name) {
+    return common::utils::mix64(common::utils::fnv1a64(name));
+}
+
+uint64_t readLE(const char* data, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * Bloque de cadenas: la misma cadena (tipo, módulo, ruta) se guarda una vez
+ */
+class StringTable {
+public:
+    uint32_t add(const std::string& value) {
+        auto [it, inserted] = offsets_.try_emplace(value, static_cast<uint32_t>(bytes_.size()));
+        if (inserted) {
+            CacheRecordWriter writer;
+            writer.str(value);
+            bytes_ += writer.take();
+        }
+        return it->second;
+    }
+
+    const std::string& bytes() const { return bytes_; }
+
+private:
+    std::unordered_map<std::string, uint32_t> offsets_;
+    std::string bytes_;
+};
+
+} // namespace
+
 // ============================================================================
 // ExportedEntity - Implementación
 // ============================================================================
@@ -25,7 +102,7 @@ namespace cpp20::compiler::modules {
 
 BinaryModuleInterface::BinaryModuleInterface(const std::string& moduleName) {
     metadata_.moduleName = moduleName;
-    metadata_.formatVersion = BMIFormatVersion::Version1_0;
+    metadata_.formatVersion = BMIFormatVersion::Version1_2;
     metadata_.buildTimestamp = std::to_string(
         std::chrono::duration_cast<std::chrono::seconds>(
             std::chrono::system_clock::now().time_since_epoch()).count());
@@ -36,6 +113,7 @@ BinaryModuleInterface::BinaryModuleInterface(const std::string& moduleName) {
 BinaryModuleInterface::~BinaryModuleInterface() = default;
 
 void BinaryModuleInterface::addExportedEntity(std::unique_ptr<ExportedEntity> entity) {
+    loadAllEntities();
     exportedEntities_.push_back(std::move(entity));
     updateMetadata();
     buildIndices();
@@ -58,67 +136,111 @@ void BinaryModuleInterface::setModuleAST(std::unique_ptr<ast::ASTNode> ast) {
 
 bool BinaryModuleInterface::serializeToFile(const std::filesystem::path& filePath) {
     try {
-        std::ofstream file(filePath, std::ios::binary);
-        if (!file.is_open()) {
-            return false;
-        }
+        const auto& entities = getExportedEntities();
 
-        // Serializar metadatos
-        serializeMetadata(file);
+        StringTable strings;
+        CacheRecordWriter entityTable, references, imports, requirements;
 
-        // Serializar entidades exportadas
-        serializeEntities(file);
+        std::vector<std::pair<uint64_t, const ExportedEntity*>> sorted;
+        sorted.reserve(entities.size());
+        for (const auto& entity : entities) {
+            sorted.emplace_back(nameFingerprint(entity->name), entity.get());
+        }
+        std::stable_sort(sorted.begin(), sorted.end(),
+                         [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        uint32_t referenceCount = 0;
+        for (const auto& [fingerprint, entity] : sorted) {
+            entityTable.u64(fingerprint);
+            entityTable.u32(strings.add(entity->name));
+            entityTable.u32(strings.add(entity->mangledName));
+            entityTable.u32(strings.add(entity->moduleName));
+            entityTable.u32(strings.add(entity->sourceLocation));
+            entityTable.u32(static_cast<uint32_t>(entity->type));
+            entityTable.u32(referenceCount);
+            entityTable.u32(static_cast<uint32_t>(entity->dependencies.size()));
+            entityTable.u32(0);
+            for (const auto& dep : entity->dependencies) {
+                references.u32(strings.add(dep));
+                ++referenceCount;
+            }
+        }
 
-        // Serializar imports
-        size_t importCount = moduleImports_.size();
-        file.write(reinterpret_cast<const char*>(&importCount), sizeof(importCount));
         for (const auto& import : moduleImports_) {
-            size_t nameLen = import.moduleName.size();
-            file.write(reinterpret_cast<const char*>(&nameLen), sizeof(nameLen));
-            file.write(import.moduleName.data(), nameLen);
-
-            size_t partitionLen = import.partitionName.size();
-            file.write(reinterpret_cast<const char*>(&partitionLen), sizeof(partitionLen));
-            file.write(import.partitionName.data(), partitionLen);
-
-            file.write(reinterpret_cast<const char*>(&import.isInterfaceImport), sizeof(import.isInterfaceImport));
-
-            size_t entityCount = import.importedEntities.size();
-            file.write(reinterpret_cast<const char*>(&entityCount), sizeof(entityCount));
+            imports.u32(strings.add(import.moduleName));
+            imports.u32(strings.add(import.partitionName));
+            imports.u32(import.isInterfaceImport ? 1 : 0);
+            imports.u32(referenceCount);
+            imports.u32(static_cast<uint32_t>(import.importedEntities.size()));
             for (const auto& entity : import.importedEntities) {
-                size_t entityLen = entity.size();
-                file.write(reinterpret_cast<const char*>(&entityLen), sizeof(entityLen));
-                file.write(entity.data(), entityLen);
+                references.u32(strings.add(entity));
+                ++referenceCount;
             }
         }
 
-        // Serializar requerimientos
-        size_t reqCount = moduleRequirements_.size();
-        file.write(reinterpret_cast<const char*>(&reqCount), sizeof(reqCount));
         for (const auto& req : moduleRequirements_) {
-            size_t modLen = req.requiredModule.size();
-            file.write(reinterpret_cast<const char*>(&modLen), sizeof(modLen));
-            file.write(req.requiredModule.data(), modLen);
-
-            size_t verLen = req.minimumVersion.size();
-            file.write(reinterpret_cast<const char*>(&verLen), sizeof(verLen));
-            file.write(req.minimumVersion.data(), verLen);
+            requirements.u32(strings.add(req.requiredModule));
+            requirements.u32(strings.add(req.minimumVersion));
+            requirements.u32(req.isOptional ? 1 : 0);
+        }
 
-            file.write(reinterpret_cast<const char*>(&req.isOptional), sizeof(req.isOptional));
+        std::ostringstream ast(std::ios::binary);
+        serializeAST(ast);
+
+        CacheRecordWriter header;
+        header.u32(static_cast<uint32_t>(BMIFormatVersion::Version1_2));
+        header.u32(0); // AST sin comprimir
+        header.u32(strings.add(metadata_.moduleName));
+        header.u32(strings.add(metadata_.buildTimestamp));
+        header.u32(strings.add(metadata_.compilerVersion));
+        header.u32(strings.add(metadata_.targetTriple));
+        header.u32(strings.add(metadata_.sourceHash));
+        header.u32(0);
+        header.u64(metadata_.totalSize);
+        header.u64(metadata_.symbolTableSize);
+        header.u64(metadata_.astSize);
+
+        std::string blockBytes[kBlockCount] = {strings.bytes(), entityTable.take(), references.take(),
+                                               imports.take(), requirements.take(), ast.str()};
+        const uint64_t blockCounts[kBlockCount] = {
+            blockBytes[StringsBlock].size(), sorted.size(), referenceCount,
+            moduleImports_.size(), moduleRequirements_.size(), blockBytes[ASTBlock].size()};
+        uint64_t offset = kHeaderSize;
+        for (size_t block = 0; block < kBlockCount; ++block) {
+            header.u64(offset);
+            header.u64(blockCounts[block]);
+            offset += blockBytes[block].size();
         }
 
-        // Serializar AST (simplificado - en un compilador real sería más complejo)
-        bool hasAST = (moduleAST_ != nullptr);
-        file.write(reinterpret_cast<const char*>(&hasAST), sizeof(hasAST));
-        if (hasAST) {
-            // Placeholder: serialización simplificada del AST
-            std::string astData = "AST_PLACEHOLDER";
-            size_t astLen = astData.size();
-            file.write(reinterpret_cast<const char*>(&astLen), sizeof(astLen));
-            file.write(astData.data(), astLen);
+        // Un importador puede tener proyectado el BMI anterior: temporal y renombrar
+        std::filesystem::path temporary = filePath;
+        temporary += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()) ^
+                                          static_cast<size_t>(std::chrono::steady_clock::now()
+                                                                  .time_since_epoch().count())) + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                return false;
+            }
+            std::string headerBytes = std::string(kBMIMagic, sizeof(kBMIMagic)) + header.take();
+            file.write(headerBytes.data(), static_cast<std::streamsize>(headerBytes.size()));
+            for (const auto& bytes : blockBytes) {
+                file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+            }
+            if (!file) {
+                file.close();
+                std::error_code ignored;
+                std::filesystem::remove(temporary, ignored);
+                return false;
+            }
         }
 
-        file.close();
+        std::error_code error;
+        std::filesystem::rename(temporary, filePath, error);
+        if (error) {
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
         return true;
 
     } catch (const std::exception& e) {
@@ -130,6 +252,129 @@ bool BinaryModuleInterface::serializeToFile(const std::filesystem::path& filePat
 std::unique_ptr<BinaryModuleInterface> BinaryModuleInterface::deserializeFromFile(
     const std::filesystem::path& filePath) {
 
+    auto mapping = common::utils::MappedFile::open(filePath);
+    if (!mapping || mapping->size() < sizeof(kBMIMagic) ||
+        std::memcmp(mapping->data(), kBMIMagic, sizeof(kBMIMagic)) != 0) {
+        return deserializeLegacyFile(filePath);
+    }
+
+    auto bmi = std::make_unique<BinaryModuleInterface>("");
+    if (!bmi->mapBlocks(std::move(mapping))) {
+        return nullptr;
+    }
+    return bmi;
+}
+
+bool BinaryModuleInterface::mapBlocks(std::unique_ptr<common::utils::MappedFile> mapping) {
+    const char* data = mapping->data();
+    uint64_t size = mapping->size();
+    if (size < kHeaderSize || readLE(data + 8, 4) != static_cast<uint32_t>(BMIFormatVersion::Version1_2) ||
+        readLE(data + 12, 4) != 0) {
+        return false;
+    }
+
+    // Cada bloque debe caber en el archivo; después solo se comprueban las referencias
+    const uint64_t entrySizes[kBlockCount] = {1, kEntityEntrySize, kReferenceSize,
+                                              kImportEntrySize, kRequirementEntrySize, 1};
+    uint64_t offsets[kBlockCount], counts[kBlockCount];
+    for (size_t block = 0; block < kBlockCount; ++block) {
+        offsets[block] = readLE(data + kBlockTableOffset + block * 16, 8);
+        counts[block] = readLE(data + kBlockTableOffset + block * 16 + 8, 8);
+        if (offsets[block] > size || counts[block] > (size - offsets[block]) / entrySizes[block]) {
+            return false;
+        }
+    }
+
+    mapping_ = std::move(mapping);
+    blocks_ = MappedBlocks{offsets[StringsBlock], counts[StringsBlock],
+                           offsets[EntitiesBlock], counts[EntitiesBlock],
+                           offsets[ReferencesBlock], counts[ReferencesBlock],
+                           offsets[ASTBlock], counts[ASTBlock]};
+
+    metadata_.formatVersion = BMIFormatVersion::Version1_2;
+    metadata_.moduleName = std::string(mappedString(readLE(data + 16, 4)));
+    metadata_.buildTimestamp = std::string(mappedString(readLE(data + 20, 4)));
+    metadata_.compilerVersion = std::string(mappedString(readLE(data + 24, 4)));
+    metadata_.targetTriple = std::string(mappedString(readLE(data + 28, 4)));
+    metadata_.sourceHash = std::string(mappedString(readLE(data + 32, 4)));
+    metadata_.entityCount = static_cast<size_t>(blocks_.entityCount);
+    metadata_.totalSize = static_cast<size_t>(readLE(data + 40, 8));
+    metadata_.symbolTableSize = static_cast<size_t>(readLE(data + 48, 8));
+    metadata_.astSize = static_cast<size_t>(readLE(data + 56, 8));
+
+    auto reference = [&](uint64_t index) {
+        return index < blocks_.referenceCount
+            ? mappedString(readLE(data + blocks_.references + index * kReferenceSize, 4))
+            : std::string_view();
+    };
+
+    for (uint64_t i = 0; i < counts[ImportsBlock]; ++i) {
+        const char* entry = data + offsets[ImportsBlock] + i * kImportEntrySize;
+        ModuleImport import(std::string(mappedString(readLE(entry, 4))),
+                            std::string(mappedString(readLE(entry + 4, 4))),
+                            readLE(entry + 8, 4) != 0);
+        uint64_t first = readLE(entry + 12, 4);
+        uint64_t count = readLE(entry + 16, 4);
+        for (uint64_t j = 0; j < count; ++j) {
+            import.importedEntities.emplace_back(reference(first + j));
+        }
+        moduleImports_.push_back(std::move(import));
+    }
+
+    for (uint64_t i = 0; i < counts[RequirementsBlock]; ++i) {
+        const char* entry = data + offsets[RequirementsBlock] + i * kRequirementEntrySize;
+        moduleRequirements_.emplace_back(std::string(mappedString(readLE(entry, 4))),
+                                         std::string(mappedString(readLE(entry + 4, 4))),
+                                         readLE(entry + 8, 4) != 0);
+    }
+
+    allEntitiesLoaded_ = false;
+    astLoaded_ = false;
+    return true;
+}
+
+std::string_view BinaryModuleInterface::mappedString(uint64_t reference) const {
+    if (reference > blocks_.stringsSize || blocks_.stringsSize - reference < 4) {
+        return std::string_view();
+    }
+    const char* entry = mapping_->data() + blocks_.strings + reference;
+    uint64_t length = readLE(entry, 4);
+    if (blocks_.stringsSize - reference - 4 < length) {
+        return std::string_view();
+    }
+    return std::string_view(entry + 4, static_cast<size_t>(length));
+}
+
+std::string_view BinaryModuleInterface::mappedEntityName(size_t index) const {
+    const char* entry = mapping_->data() + blocks_.entities + index * kEntityEntrySize;
+    return mappedString(readLE(entry + 8, 4));
+}
+
+std::unique_ptr<ExportedEntity> BinaryModuleInterface::decodeMappedEntity(size_t index) const {
+    const char* data = mapping_->data();
+    const char* entry = data + blocks_.entities + index * kEntityEntrySize;
+    std::string_view name = mappedString(readLE(entry + 8, 4));
+    uint64_t first = readLE(entry + 28, 4);
+    uint64_t count = readLE(entry + 32, 4);
+    if (name.empty() || first > blocks_.referenceCount || blocks_.referenceCount - first < count) {
+        return nullptr;
+    }
+
+    auto entity = std::make_unique<ExportedEntity>(std::string(name),
+                                                   static_cast<ExportedEntityType>(readLE(entry + 24, 4)),
+                                                   std::string(mappedString(readLE(entry + 16, 4))));
+    entity->mangledName = std::string(mappedString(readLE(entry + 12, 4)));
+    entity->sourceLocation = std::string(mappedString(readLE(entry + 20, 4)));
+    for (uint64_t i = 0; i < count; ++i) {
+        entity->dependencies.emplace_back(
+            mappedString(readLE(data + blocks_.references + (first + i) * kReferenceSize, 4)));
+    }
+    return entity;
+}
+
+std::unique_ptr<BinaryModuleInterface> BinaryModuleInterface::deserializeLegacyFile(
+    const std::filesystem::path& filePath) {
+
     try {
         std::ifstream file(filePath, std::ios::binary);
         if (!file.is_open()) {
@@ -144,62 +389,14 @@ std::unique_ptr<BinaryModuleInterface> BinaryModuleInterface::deserializeFromFil
         // Deserializar entidades
         bmi->deserializeEntities(file);
 
-        // Deserializar imports
-        size_t importCount;
-        file.read(reinterpret_cast<char*>(&importCount), sizeof(importCount));
-        for (size_t i = 0; i < importCount; ++i) {
-            size_t nameLen;
-            file.read(reinterpret_cast<char*>(&nameLen), sizeof(nameLen));
-            std::string moduleName(nameLen, '\0');
-            file.read(moduleName.data(), nameLen);
-
-            size_t partitionLen;
-            file.read(reinterpret_cast<char*>(&partitionLen), sizeof(partitionLen));
-            std::string partitionName(partitionLen, '\0');
-            file.read(partitionName.data(), partitionLen);
-
-            bool isInterfaceImport;
-            file.read(reinterpret_cast<char*>(&isInterfaceImport), sizeof(isInterfaceImport));
-
-            ModuleImport import(moduleName, partitionName, isInterfaceImport);
-
-            size_t entityCount;
-            file.read(reinterpret_cast<char*>(&entityCount), sizeof(entityCount));
-            for (size_t j = 0; j < entityCount; ++j) {
-                size_t entityLen;
-                file.read(reinterpret_cast<char*>(&entityLen), sizeof(entityLen));
-                std::string entity(entityLen, '\0');
-                file.read(entity.data(), entityLen);
-                import.importedEntities.push_back(entity);
-            }
-
-            bmi->addModuleImport(import);
-        }
-
-        // Deserializar requerimientos
-        size_t reqCount;
-        file.read(reinterpret_cast<char*>(&reqCount), sizeof(reqCount));
-        for (size_t i = 0; i < reqCount; ++i) {
-            size_t modLen;
-            file.read(reinterpret_cast<char*>(&modLen), sizeof(modLen));
-            std::string requiredModule(modLen, '\0');
-            file.read(requiredModule.data(), modLen);
-
-            size_t verLen;
-            file.read(reinterpret_cast<char*>(&verLen), sizeof(verLen));
-            std::string minimumVersion(verLen, '\0');
-            file.read(minimumVersion.data(), verLen);
-
-            bool isOptional;
-            file.read(reinterpret_cast<char*>(&isOptional), sizeof(isOptional));
-
-            bmi->addModuleRequirement(ModuleRequirement(requiredModule, minimumVersion, isOptional));
-        }
+        // Deserializar imports y requerimientos
+        bmi->deserializeModuleInfo(file);
 
         // Deserializar AST
         bmi->deserializeAST(file);
 
         file.close();
+        bmi->updateMetadata();
         bmi->buildIndices();
 
         return bmi;
@@ -210,37 +407,168 @@ std::unique_ptr<BinaryModuleInterface> BinaryModuleInterface::deserializeFromFil
     }
 }
 
+void BinaryModuleInterface::deserializeModuleInfo(std::istream& stream) {
+    // Deserializar imports
+    size_t importCount;
+    stream.read(reinterpret_cast<char*>(&importCount), sizeof(importCount));
+    for (size_t i = 0; i < importCount; ++i) {
+        size_t nameLen;
+        stream.read(reinterpret_cast<char*>(&nameLen), sizeof(nameLen));
+        std::string moduleName(nameLen, '\0');
+        stream.read(moduleName.data(), nameLen);
+
+        size_t partitionLen;
+        stream.read(reinterpret_cast<char*>(&partitionLen), sizeof(partitionLen));
+        std::string partitionName(partitionLen, '\0');
+        stream.read(partitionName.data(), partitionLen);
+
+        bool isInterfaceImport;
+        stream.read(reinterpret_cast<char*>(&isInterfaceImport), sizeof(isInterfaceImport));
+
+        ModuleImport import(moduleName, partitionName, isInterfaceImport);
+
+        size_t entityCount;
+        stream.read(reinterpret_cast<char*>(&entityCount), sizeof(entityCount));
+        for (size_t j = 0; j < entityCount; ++j) {
+            size_t entityLen;
+            stream.read(reinterpret_cast<char*>(&entityLen), sizeof(entityLen));
+            std::string entity(entityLen, '\0');
+            stream.read(entity.data(), entityLen);
+            import.importedEntities.push_back(entity);
+        }
+
+        moduleImports_.push_back(import);
+    }
+
+    // Deserializar requerimientos
+    size_t reqCount;
+    stream.read(reinterpret_cast<char*>(&reqCount), sizeof(reqCount));
+    for (size_t i = 0; i < reqCount; ++i) {
+        size_t modLen;
+        stream.read(reinterpret_cast<char*>(&modLen), sizeof(modLen));
+        std::string requiredModule(modLen, '\0');
+        stream.read(requiredModule.data(), modLen);
+
+        size_t verLen;
+        stream.read(reinterpret_cast<char*>(&verLen), sizeof(verLen));
+        std::string minimumVersion(verLen, '\0');
+        stream.read(minimumVersion.data(), verLen);
+
+        bool isOptional;
+        stream.read(reinterpret_cast<char*>(&isOptional), sizeof(isOptional));
+
+        moduleRequirements_.emplace_back(requiredModule, minimumVersion, isOptional);
+    }
+}
+
 bool BinaryModuleInterface::isValid() const {
     return BMIValidator::validateBMI(*this);
 }
 
 const ExportedEntity* BinaryModuleInterface::findEntity(const std::string& name) const {
+    {
+        std::shared_lock<std::shared_mutex> lock(lazyMutex_);
+        auto it = entityIndex_.find(name);
+        if (it != entityIndex_.end()) {
+            return exportedEntities_[it->second].get();
+        }
+        if (!mapping_ || allEntitiesLoaded_) {
+            return nullptr;
+        }
+    }
+
+    // Otro hilo pudo decodificarla entre los dos cerrojos
+    std::unique_lock<std::shared_mutex> lock(lazyMutex_);
     auto it = entityIndex_.find(name);
     if (it != entityIndex_.end()) {
         return exportedEntities_[it->second].get();
     }
+    if (!mapping_ || allEntitiesLoaded_) {
+        return nullptr;
+    }
+
+    // Búsqueda binaria por huella sobre la tabla proyectada
+    uint64_t fingerprint = nameFingerprint(name);
+    auto fingerprintAt = [&](size_t index) {
+        return readLE(mapping_->data() + blocks_.entities + index * kEntityEntrySize, 8);
+    };
+    size_t first = 0;
+    size_t last = static_cast<size_t>(blocks_.entityCount);
+    while (first < last) {
+        size_t middle = first + (last - first) / 2;
+        if (fingerprintAt(middle) < fingerprint) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+
+    for (size_t i = first; i < blocks_.entityCount && fingerprintAt(i) == fingerprint; ++i) {
+        if (mappedEntityName(i) != name) continue;
+        auto entity = decodeMappedEntity(i);
+        if (!entity) return nullptr;
+        entityIndex_[name] = exportedEntities_.size();
+        exportedEntities_.push_back(std::move(entity));
+        return exportedEntities_.back().get();
+    }
     return nullptr;
 }
 
+void BinaryModuleInterface::loadAllEntities() const {
+    if (allEntitiesLoaded_.load(std::memory_order_acquire)) return;
+    std::unique_lock<std::shared_mutex> lock(lazyMutex_);
+    if (allEntitiesLoaded_) return;
+
+    for (size_t i = 0; i < blocks_.entityCount; ++i) {
+        std::string name(mappedEntityName(i));
+        if (entityIndex_.count(name)) continue;
+        if (auto entity = decodeMappedEntity(i)) {
+            entityIndex_[name] = exportedEntities_.size();
+            exportedEntities_.push_back(std::move(entity));
+        }
+    }
+    allEntitiesLoaded_.store(true, std::memory_order_release);
+}
+
+const ast::ASTNode* BinaryModuleInterface::getModuleAST() const {
+    if (astLoaded_.load(std::memory_order_acquire)) return moduleAST_.get();
+    std::unique_lock<std::shared_mutex> lock(lazyMutex_);
+    if (!astLoaded_) {
+        if (blocks_.astSize > 0) {
+            std::istringstream stream(std::string(mapping_->data() + blocks_.ast, blocks_.astSize),
+                                      std::ios::binary);
+            deserializeAST(stream);
+        }
+        astLoaded_.store(true, std::memory_order_release);
+    }
+    return moduleAST_.get();
+}
+
 bool BinaryModuleInterface::isEntityExported(const std::string& name) const {
     return findEntity(name) != nullptr;
 }
 
 std::string BinaryModuleInterface::calculateHash() const {
-    std::stringstream ss;
-
-    // Incluir información clave en el hash
-    ss << metadata_.moduleName << "|"
-       << metadata_.sourceHash << "|"
-       << metadata_.entityCount << "|";
-
-    for (const auto& entity : exportedEntities_) {
-        ss << entity->name << ":" << static_cast<int>(entity->type) << "|";
+    // Cada campo termina en '|' para que la concatenación no sea ambigua
+    common::utils::StreamingHasher hasher;
+    auto add = [&hasher](std::string_view field) {
+        hasher.update(field);
+        hasher.update("|");
+    };
+    add(metadata_.moduleName);
+    add(metadata_.sourceHash);
+    add(std::to_string(metadata_.entityCount));
+
+    // En orden de nombre: un BMI importado carga sus entidades en otro orden
+    std::vector<std::string> entries;
+    for (const auto& entity : getExportedEntities()) {
+        entries.push_back(entity->name + ":" + std::to_string(static_cast<int>(entity->type)));
     }
-
-    // Calcular hash simple (en un compilador real se usaría SHA256)
-    std::hash<std::string> hasher;
-    return std::to_string(hasher(ss.str()));
+    std::sort(entries.begin(), entries.end());
+    for (const auto& entry : entries) {
+        add(entry);
+    }
+    return hasher.digest128().toHex();
 }
 
 bool BinaryModuleInterface::isCompatibleWith(const BinaryModuleInterface& other) const {
@@ -250,7 +578,7 @@ bool BinaryModuleInterface::isCompatibleWith(const BinaryModuleInterface& other)
     }
 
     // Verificar que todas las entidades exportadas estén presentes
-    for (const auto& entity : exportedEntities_) {
+    for (const auto& entity : getExportedEntities()) {
         const auto* otherEntity = other.findEntity(entity->name);
         if (!otherEntity || otherEntity->type != entity->type) {
             return false;
@@ -463,7 +791,7 @@ void BinaryModuleInterface::serializeAST(std::ostream& stream) const {
     }
 }
 
-void BinaryModuleInterface::deserializeAST(std::istream& stream) {
+void BinaryModuleInterface::deserializeAST(std::istream& stream) const {
     bool hasAST;
     stream.read(reinterpret_cast<char*>(&hasAST), sizeof(hasAST));
 
@@ -4,6 +4,10 @@
  */
 
 #include <compiler/modules/HeaderUnits.h>
+#include <compiler/common/CacheFile.h>
+#include <compiler/common/utils/FileUtils.h>
+#include <compiler/common/utils/HashUtils.h>
+#include <compiler/common/utils/ThreadPool.h>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -11,6 +15,7 @@
 #include <regex>
 #include <thread>
 #include <future>
+#include <system_error>
 
 namespace cpp20::compiler::modules {
 
@@ -180,24 +185,54 @@ std::string HeaderUnitCompiler::calculateContentHash(const std::filesystem::path
         return "";
     }
 
-    std::ifstream file(headerPath, std::ios::binary);
-    if (!file.is_open()) {
+    // Se hashea la proyección del archivo, sin copiarlo a un std::string
+    try {
+        common::utils::FileBuffer content = common::utils::readFileBuffer(headerPath.string());
+        return common::utils::hash128(content.view()).toHex();
+    } catch (const std::runtime_error&) {
         return "";
     }
-
-    std::string content((std::istreambuf_iterator<char>(file)),
-                       std::istreambuf_iterator<char>());
-    file.close();
-
-    // Calcular hash simple (en un compilador real se usaría SHA256)
-    std::hash<std::string> hasher;
-    return std::to_string(hasher(content));
 }
 
 // ============================================================================
 // HeaderUnitCache - Implementación
 // ============================================================================
 
+namespace {
+
+// Cabecera del índice; un índice de otro formato se descarta entero
+constexpr uint64_t HeaderIndexMagic = 0x3258444955484350ull;    // "PCHUIDX2"
+
+/**
+ * @brief Si el stat ya puede hacer de prueba del contenido
+ *
+ * Un archivo escrito hace un instante puede volver a cambiar dentro del
+ * mismo tick de fecha y con el mismo tamaño; esos stats no se registran
+ * y la siguiente validación vuelve a hashear.
+ */
+bool isSettled(const common::utils::FileStamp& stamp) {
+    constexpr int64_t SettleNs = 2'000'000'000;
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    return now - stamp.modifiedNs > SettleNs;
+}
+
+void writeStamp(std::ofstream& file, const common::utils::FileStamp& stamp) {
+    file.write(reinterpret_cast<const char*>(&stamp.size), sizeof(stamp.size));
+    file.write(reinterpret_cast<const char*>(&stamp.modifiedNs), sizeof(stamp.modifiedNs));
+    file.write(reinterpret_cast<const char*>(&stamp.device), sizeof(stamp.device));
+    file.write(reinterpret_cast<const char*>(&stamp.fileId), sizeof(stamp.fileId));
+}
+
+void readStamp(std::ifstream& file, common::utils::FileStamp& stamp) {
+    file.read(reinterpret_cast<char*>(&stamp.size), sizeof(stamp.size));
+    file.read(reinterpret_cast<char*>(&stamp.modifiedNs), sizeof(stamp.modifiedNs));
+    file.read(reinterpret_cast<char*>(&stamp.device), sizeof(stamp.device));
+    file.read(reinterpret_cast<char*>(&stamp.fileId), sizeof(stamp.fileId));
+}
+
+} // namespace
+
 HeaderUnitCache::HeaderUnitCache(const std::filesystem::path& cacheDirectory)
     : cacheDirectory_(cacheDirectory), totalHits_(0), totalMisses_(0), totalInvalidations_(0) {
 
@@ -248,10 +283,17 @@ void HeaderUnitCache::store(std::shared_ptr<HeaderUnit> headerUnit) {
     if (!headerUnit) return;
 
     std::string cacheKey = generateCacheKey(headerUnit->headerPath);
+
+    // El stat con el que se calculó el hash habilita el camino rápido
+    auto hashed = contentHashes_.find(headerUnit->headerPath.string());
+    if (headerUnit->stamp.empty() && hashed != contentHashes_.end() &&
+        hashed->second.hash == headerUnit->contentHash) {
+        headerUnit->stamp = hashed->second.stamp;
+    }
     cache_[cacheKey] = headerUnit;
 
-    // Intentar serializar inmediatamente
-    serializeToDisk();
+    // Intentar serializar inmediatamente (mutex_ ya está tomado)
+    writeIndex();
 }
 
 bool HeaderUnitCache::isCached(const std::filesystem::path& headerPath) {
@@ -275,13 +317,43 @@ void HeaderUnitCache::invalidate(const std::filesystem::path& headerPath) {
     }
 }
 
+std::string HeaderUnitCache::contentHash(const std::filesystem::path& headerPath) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    common::utils::FileStamp stamp;
+    if (!common::utils::statFile(headerPath.string(), stamp)) {
+        return "";
+    }
+    return hashContent(headerPath, stamp);
+}
+
+std::string HeaderUnitCache::hashContent(const std::filesystem::path& headerPath,
+                                         const common::utils::FileStamp& stamp) const {
+    std::string key = headerPath.string();
+    auto it = contentHashes_.find(key);
+    if (it != contentHashes_.end() && it->second.stamp == stamp) {
+        return it->second.hash;
+    }
+
+    std::string hash = HeaderUnitCompiler().calculateContentHash(headerPath);
+    ++contentHashesComputed_;
+    if (!hash.empty() && isSettled(stamp)) {
+        contentHashes_[key] = {stamp, hash};
+        contentHashesChanged_ = true;
+    }
+    return hash;
+}
+
 void HeaderUnitCache::clear() {
     std::lock_guard<std::mutex> lock(mutex_);
 
     cache_.clear();
+    contentHashes_.clear();
+    contentHashesChanged_ = false;
     totalHits_ = 0;
     totalMisses_ = 0;
     totalInvalidations_ = 0;
+    contentHashesComputed_ = 0;
 }
 
 std::unordered_map<std::string, size_t> HeaderUnitCache::getCacheStatistics() const {
@@ -292,6 +364,7 @@ std::unordered_map<std::string, size_t> HeaderUnitCache::getCacheStatistics() co
         {"total_hits", totalHits_},
         {"total_misses", totalMisses_},
         {"total_invalidations", totalInvalidations_},
+        {"content_hashes_computed", contentHashesComputed_},
         {"hit_rate", totalHits_ + totalMisses_ > 0 ?
                     (totalHits_ * 100) / (totalHits_ + totalMisses_) : 0},
         {"cache_size_bytes", calculateCacheSize()}
@@ -302,13 +375,15 @@ void HeaderUnitCache::setCacheDirectory(const std::filesystem::path& cacheDir) {
     std::lock_guard<std::mutex> lock(mutex_);
 
     // Guardar caché actual
-    serializeToDisk();
+    writeIndex();
 
     cacheDirectory_ = cacheDir;
     std::filesystem::create_directories(cacheDirectory_);
 
     // Limpiar caché en memoria
     cache_.clear();
+    contentHashes_.clear();
+    contentHashesChanged_ = false;
 
     // Cargar caché desde nuevo directorio
     deserializeFromDisk();
@@ -316,24 +391,45 @@ void HeaderUnitCache::setCacheDirectory(const std::filesystem::path& cacheDir) {
 
 bool HeaderUnitCache::serializeToDisk() const {
     std::lock_guard<std::mutex> lock(mutex_);
+    return writeIndex();
+}
 
+bool HeaderUnitCache::writeIndex() const {
     try {
         std::filesystem::path cacheFile = cacheDirectory_ / "header_cache.dat";
-        std::ofstream file(cacheFile, std::ios::binary);
+
+        // Un solo escritor a la vez; las entradas de otros procesos se conservan
+        auto directoryLock = common::utils::FileLock::acquire(cacheDirectory_ / "header_cache.lock");
+        if (!directoryLock) return false;
+
+        std::unordered_map<std::string, std::shared_ptr<HeaderUnit>> entries;
+        size_t ignoredStatistics[3];
+        readIndex(entries, ignoredStatistics);
+        for (const auto& [key, headerUnit] : cache_) {
+            entries[key] = headerUnit;
+        }
+
+        std::filesystem::path temporary = cacheFile;
+        temporary += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()) ^
+                                          static_cast<size_t>(std::chrono::steady_clock::now()
+                                                                  .time_since_epoch().count())) + ".tmp";
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
 
         if (!file.is_open()) return false;
 
+        file.write(reinterpret_cast<const char*>(&HeaderIndexMagic), sizeof(HeaderIndexMagic));
+
         // Serializar estadísticas
         file.write(reinterpret_cast<const char*>(&totalHits_), sizeof(totalHits_));
         file.write(reinterpret_cast<const char*>(&totalMisses_), sizeof(totalMisses_));
         file.write(reinterpret_cast<const char*>(&totalInvalidations_), sizeof(totalInvalidations_));
 
         // Serializar número de entradas
-        size_t entryCount = cache_.size();
+        size_t entryCount = entries.size();
         file.write(reinterpret_cast<const char*>(&entryCount), sizeof(entryCount));
 
         // Serializar cada entrada
-        for (const auto& [key, headerUnit] : cache_) {
+        for (const auto& [key, headerUnit] : entries) {
             // Serializar clave
             size_t keyLen = key.size();
             file.write(reinterpret_cast<const char*>(&keyLen), sizeof(keyLen));
@@ -354,6 +450,7 @@ bool HeaderUnitCache::serializeToDisk() const {
 
             auto timestamp = headerUnit->lastModified.time_since_epoch().count();
             file.write(reinterpret_cast<const char*>(&timestamp), sizeof(timestamp));
+            writeStamp(file, headerUnit->stamp);
 
             size_t depCount = headerUnit->dependencies.size();
             file.write(reinterpret_cast<const char*>(&depCount), sizeof(depCount));
@@ -368,14 +465,102 @@ bool HeaderUnitCache::serializeToDisk() const {
         }
 
         file.close();
-        return true;
+        std::error_code error;
+        if (!file) {
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+        std::filesystem::rename(temporary, cacheFile, error);
+        if (error) {
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+        return writeContentHashes();
 
     } catch (const std::exception&) {
         return false;
     }
 }
 
+void HeaderUnitCache::readContentHashes() const {
+    auto reader = CacheFileReader::open(cacheDirectory_ / "header_hashes.dat", ContentHashFileKind);
+    if (!reader) return;
+
+    for (size_t i = 0; i < reader->size(); ++i) {
+        auto record = reader->record(i);
+        if (!record) continue;
+
+        CacheRecordReader value(record->value);
+        HashedContent entry;
+        entry.stamp.size = value.u64();
+        entry.stamp.modifiedNs = static_cast<int64_t>(value.u64());
+        entry.stamp.device = value.u64();
+        entry.stamp.fileId = value.u64();
+        entry.hash = std::string(value.str());
+        if (value.ok()) {
+            // Lo calculado en este proceso es más reciente que lo publicado
+            contentHashes_.try_emplace(std::string(record->key), std::move(entry));
+        }
+    }
+}
+
+bool HeaderUnitCache::writeContentHashes() const {
+    if (!contentHashesChanged_) return true;
+
+    // Se llama bajo el bloqueo del directorio: se conservan los hashes de otros procesos
+    readContentHashes();
+
+    CacheFileWriter writer;
+    for (const auto& [path, entry] : contentHashes_) {
+        CacheRecordWriter value;
+        value.u64(entry.stamp.size);
+        value.u64(static_cast<uint64_t>(entry.stamp.modifiedNs));
+        value.u64(entry.stamp.device);
+        value.u64(entry.stamp.fileId);
+        value.str(entry.hash);
+        writer.add(common::utils::fnv1a64(path), path, value.take());
+    }
+    if (!writer.write(cacheDirectory_ / "header_hashes.dat", ContentHashFileKind)) {
+        return false;
+    }
+    contentHashesChanged_ = false;
+    return true;
+}
+
 bool HeaderUnitCache::deserializeFromDisk() {
+    std::unordered_map<std::string, std::shared_ptr<HeaderUnit>> entries;
+    size_t statistics[3] = {0, 0, 0};
+    readContentHashes();
+    if (!readIndex(entries, statistics)) return false;
+
+    cache_ = std::move(entries);
+    totalHits_ = statistics[0];
+    totalMisses_ = statistics[1];
+    totalInvalidations_ = statistics[2];
+    return true;
+}
+
+bool HeaderUnitCache::mergeFromDisk() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::unordered_map<std::string, std::shared_ptr<HeaderUnit>> entries;
+    size_t ignoredStatistics[3];
+    if (!readIndex(entries, ignoredStatistics)) return false;
+
+    for (auto& [key, headerUnit] : entries) {
+        cache_.try_emplace(key, std::move(headerUnit));
+    }
+    return true;
+}
+
+std::unique_ptr<common::utils::FileLock> HeaderUnitCache::lockEntry(const std::filesystem::path& headerPath) const {
+    std::hash<std::string> hasher;
+    std::string lockName = std::to_string(hasher(generateCacheKey(headerPath))) + ".lock";
+    return common::utils::FileLock::acquire(cacheDirectory_ / lockName);
+}
+
+bool HeaderUnitCache::readIndex(std::unordered_map<std::string, std::shared_ptr<HeaderUnit>>& entries,
+                                size_t statistics[3]) const {
     try {
         std::filesystem::path cacheFile = cacheDirectory_ / "header_cache.dat";
         if (!std::filesystem::exists(cacheFile)) {
@@ -385,17 +570,21 @@ bool HeaderUnitCache::deserializeFromDisk() {
         std::ifstream file(cacheFile, std::ios::binary);
         if (!file.is_open()) return false;
 
-        // Limpiar caché actual
-        cache_.clear();
+        uint64_t magic = 0;
+        file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+        if (!file || magic != HeaderIndexMagic) {
+            return true; // Formato anterior: se reconstruye
+        }
 
         // Deserializar estadísticas
-        file.read(reinterpret_cast<char*>(&totalHits_), sizeof(totalHits_));
-        file.read(reinterpret_cast<char*>(&totalMisses_), sizeof(totalMisses_));
-        file.read(reinterpret_cast<char*>(&totalInvalidations_), sizeof(totalInvalidations_));
+        file.read(reinterpret_cast<char*>(&statistics[0]), sizeof(size_t));
+        file.read(reinterpret_cast<char*>(&statistics[1]), sizeof(size_t));
+        file.read(reinterpret_cast<char*>(&statistics[2]), sizeof(size_t));
 
         // Deserializar número de entradas
         size_t entryCount;
         file.read(reinterpret_cast<char*>(&entryCount), sizeof(entryCount));
+        if (!file) return false;
 
         // Deserializar cada entrada
         for (size_t i = 0; i < entryCount; ++i) {
@@ -429,6 +618,7 @@ bool HeaderUnitCache::deserializeFromDisk() {
             file.read(reinterpret_cast<char*>(&timestamp), sizeof(timestamp));
             headerUnit->lastModified = std::chrono::system_clock::time_point(
                 std::chrono::system_clock::duration(timestamp));
+            readStamp(file, headerUnit->stamp);
 
             size_t depCount;
             file.read(reinterpret_cast<char*>(&depCount), sizeof(depCount));
@@ -444,11 +634,10 @@ bool HeaderUnitCache::deserializeFromDisk() {
             file.read(reinterpret_cast<char*>(&headerUnit->isCompiled), sizeof(headerUnit->isCompiled));
             file.read(reinterpret_cast<char*>(&headerUnit->needsRebuild), sizeof(headerUnit->needsRebuild));
 
-            cache_[key] = headerUnit;
+            entries[key] = headerUnit;
         }
 
-        file.close();
-        return true;
+        return static_cast<bool>(file);
 
     } catch (const std::exception&) {
         return false;
@@ -492,26 +681,28 @@ std::filesystem::path HeaderUnitCache::generateCacheFileName(const std::string&
 }
 
 bool HeaderUnitCache::isCacheEntryValid(const std::shared_ptr<HeaderUnit>& headerUnit) const {
-    // Verificar que el archivo header aún existe
-    if (!std::filesystem::exists(headerUnit->headerPath)) {
+    if (!headerUnit->isCompiled) {
         return false;
     }
 
-    // Verificar que no ha cambiado
-    auto currentTime = std::filesystem::last_write_time(headerUnit->headerPath);
-    auto cachedTime = headerUnit->lastModified;
-
-    if (currentTime != cachedTime) {
+    // Verificar que el archivo header aún existe
+    common::utils::FileStamp current;
+    if (!common::utils::statFile(headerUnit->headerPath.string(), current)) {
         return false;
     }
 
-    // Verificar hash del contenido
-    std::string currentHash = HeaderUnitCompiler().calculateContentHash(headerUnit->headerPath);
-    if (currentHash != headerUnit->contentHash) {
-        return false;
+    // Mismo archivo, tamaño y fecha que al comprobar el hash: no se lee
+    if (!headerUnit->stamp.empty() && current == headerUnit->stamp) {
+        return true;
     }
 
-    return headerUnit->isCompiled;
+    if (hashContent(headerUnit->headerPath, current) != headerUnit->contentHash) {
+        return false;
+    }
+    if (isSettled(current)) {
+        headerUnit->stamp = current;
+    }
+    return true;
 }
 
 void HeaderUnitCache::updateStatistics(bool isHit) {
@@ -792,7 +983,7 @@ std::unordered_map<std::string, std::vector<std::string>> HeaderDependencyManage
 
 HeaderUnitCoordinator::HeaderUnitCoordinator(std::shared_ptr<HeaderUnitCache> cache,
                                            std::shared_ptr<HeaderDependencyManager> depManager)
-    : cache_(cache), dependencyManager_(depManager), maxParallelJobs_(std::thread::hardware_concurrency()),
+    : cache_(cache), dependencyManager_(depManager), maxParallelJobs_(common::utils::ThreadPool::defaultThreadCount()),
       totalCompiled_(0), totalFromCache_(0), totalFailed_(0) {
 
     if (!cache_) {
@@ -899,6 +1090,7 @@ void HeaderUnitCoordinator::forceRebuild(const std::vector<std::filesystem::path
 }
 
 std::unordered_map<std::string, size_t> HeaderUnitCoordinator::getCompilationStatistics() const {
+    std::lock_guard<std::mutex> lock(statisticsMutex_);
     return {
         {"total_compiled", totalCompiled_},
         {"total_from_cache", totalFromCache_},
@@ -923,6 +1115,16 @@ std::shared_ptr<HeaderUnit> HeaderUnitCoordinator::compileSingleHeaderUnit(
         return cachedUnit;
     }
 
+    // Otro proceso puede estar compilando el mismo header: esperar a que
+    // termine y reutilizar lo que haya publicado
+    auto entryLock = cache_->lockEntry(headerPath);
+    cache_->mergeFromDisk();
+    cachedUnit = cache_->lookup(headerPath);
+    if (cachedUnit && !needsRebuild(headerPath)) {
+        updateStatistics(true, true);
+        return cachedUnit;
+    }
+
     // Compilar header unit
     auto bmi = compiler_->compileHeaderUnit(headerPath, includePaths);
     if (!bmi) {
@@ -932,7 +1134,7 @@ std::shared_ptr<HeaderUnit> HeaderUnitCoordinator::compileSingleHeaderUnit(
 
     // Crear header unit
     auto headerUnit = std::make_shared<HeaderUnit>(headerPath, HeaderUnitUtils::getHeaderName(headerPath));
-    headerUnit->contentHash = compiler_->calculateContentHash(headerPath);
+    headerUnit->contentHash = cache_->contentHash(headerPath);
     headerUnit->lastModified = HeaderUnitUtils::getFileModificationTime(headerPath);
     headerUnit->bmi = std::move(bmi);
     headerUnit->isCompiled = true;
@@ -952,29 +1154,8 @@ std::shared_ptr<HeaderUnit> HeaderUnitCoordinator::compileSingleHeaderUnit(
 }
 
 bool HeaderUnitCoordinator::needsRebuild(const std::filesystem::path& headerPath) const {
-    // Verificar si existe en caché
-    if (!cache_->isCached(headerPath)) {
-        return true;
-    }
-
-    // Verificar si el archivo ha cambiado
-    auto cachedUnit = cache_->lookup(headerPath);
-    if (!cachedUnit) {
-        return true;
-    }
-
-    auto currentTime = HeaderUnitUtils::getFileModificationTime(headerPath);
-    if (currentTime != cachedUnit->lastModified) {
-        return true;
-    }
-
-    // Verificar hash del contenido
-    std::string currentHash = compiler_->calculateContentHash(headerPath);
-    if (currentHash != cachedUnit->contentHash) {
-        return true;
-    }
-
-    return false;
+    // isCached ya compara el stat y, si cambió, el hash del contenido
+    return !cache_->isCached(headerPath);
 }
 
 void HeaderUnitCoordinator::updateDependencies(const std::shared_ptr<HeaderUnit>& headerUnit) {
@@ -988,19 +1169,76 @@ std::vector<std::shared_ptr<HeaderUnit>> HeaderUnitCoordinator::compileInParalle
     const std::vector<std::filesystem::path>& headerPaths,
     const std::vector<std::filesystem::path>& includePaths) {
 
-    std::vector<std::shared_ptr<HeaderUnit>> results;
-    results.reserve(headerPaths.size());
+    std::unordered_map<std::string, size_t> indexByName;
+    for (size_t i = 0; i < headerPaths.size(); ++i) {
+        indexByName[HeaderUnitUtils::getHeaderName(headerPaths[i])] = i;
+    }
 
-    // Para simplificar, compilamos secuencialmente
-    // En un compilador real, aquí se usaría std::async para paralelización
+    // Con un ciclo ningún header del ciclo llegaría a estar listo
+    for (const auto& cycle : dependencyManager_->detectCycles()) {
+        bool involved = std::any_of(cycle.begin(), cycle.end(),
+                                    [&](const std::string& name) { return indexByName.count(name) > 0; });
+        if (involved) {
+            std::cerr << "Error: dependencia circular entre header units:";
+            for (const auto& name : cycle) std::cerr << " " << name;
+            std::cerr << std::endl;
+            return {};
+        }
+    }
 
-    for (const auto& path : headerPaths) {
-        auto result = compileSingleHeaderUnit(path, includePaths);
-        if (result) {
-            results.push_back(result);
+    // Grafo restringido a los headers pedidos: lo que falte fuera ya está compilado
+    std::vector<std::vector<size_t>> dependents(headerPaths.size());
+    std::vector<std::atomic<size_t>> pending(headerPaths.size());
+    for (const auto& [name, index] : indexByName) {
+        std::unordered_set<size_t> required;
+        for (const auto& dep : dependencyManager_->getDependencies(name)) {
+            auto it = indexByName.find(dep.toHeader);
+            if (it != indexByName.end() && it->second != index && required.insert(it->second).second) {
+                dependents[it->second].push_back(index);
+            }
         }
+        pending[index] = required.size();
     }
 
+    std::vector<std::shared_ptr<HeaderUnit>> compiled(headerPaths.size());
+    std::vector<std::atomic<bool>> dependencyFailed(headerPaths.size());
+    common::utils::ThreadPool pool(std::min(maxParallelJobs_, std::max<size_t>(headerPaths.size(), 1)));
+
+    // Al terminar un header se encolan los dependientes que quedan listos
+    std::function<void(size_t)> compileNode = [&](size_t index) {
+        if (dependencyFailed[index]) {
+            updateStatistics(false, false);
+        } else {
+            try {
+                compiled[index] = compileSingleHeaderUnit(headerPaths[index], includePaths);
+            } catch (const std::exception& e) {
+                std::cerr << "Error compilando header unit " << headerPaths[index] << ": " << e.what() << std::endl;
+                updateStatistics(false, false);
+            }
+        }
+
+        for (size_t dependent : dependents[index]) {
+            if (!compiled[index]) dependencyFailed[dependent] = true;
+            if (--pending[dependent] == 0) {
+                pool.submit([&compileNode, dependent]() { compileNode(dependent); });
+            }
+        }
+    };
+
+    for (size_t i = 0; i < headerPaths.size(); ++i) {
+        if (pending[i] == 0) {
+            pool.submit([&compileNode, i]() { compileNode(i); });
+        }
+    }
+    pool.wait();
+
+    std::vector<std::shared_ptr<HeaderUnit>> results;
+    results.reserve(headerPaths.size());
+    for (auto& unit : compiled) {
+        if (unit) {
+            results.push_back(std::move(unit));
+        }
+    }
     return results;
 }
 
@@ -1027,6 +1265,7 @@ bool HeaderUnitCoordinator::verifyDependencies(const std::vector<std::shared_ptr
 }
 
 void HeaderUnitCoordinator::updateStatistics(bool fromCache, bool success) {
+    std::lock_guard<std::mutex> lock(statisticsMutex_);
     if (fromCache && success) {
         totalFromCache_++;
     } else if (!fromCache && success) {
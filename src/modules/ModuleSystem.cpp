@@ -6,11 +6,21 @@
 #include <compiler/modules/ModuleSystem.h>
 #include <compiler/common/diagnostics/DiagnosticEngine.h>
 #include <compiler/common/utils/FileUtils.h>
+#include <compiler/common/utils/HashUtils.h>
+#include <compiler/common/utils/MappedFile.h>
+#include <compiler/common/utils/MemoryTracker.h>
+#include <compiler/common/TimingProfiler.h>
+#include <compiler/common/utils/ThreadPool.h>
 #include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <queue>
+#include <system_error>
+#include <thread>
 
 namespace cpp20::compiler::modules {
 
@@ -109,6 +119,11 @@ std::vector<uint8_t> BinaryModuleInterface::serialize() const {
 
         // Module name
         data.insert(data.end(), dep.moduleName.begin(), dep.moduleName.end());
+
+        // Interface hash of the import (8 bytes, version 2)
+        uint64_t interfaceHash = dep.interfaceHash;
+        data.insert(data.end(), reinterpret_cast<uint8_t*>(&interfaceHash),
+                    reinterpret_cast<uint8_t*>(&interfaceHash) + sizeof(uint64_t));
     }
 
     return data;
@@ -127,7 +142,7 @@ std::unique_ptr<BinaryModuleInterface> BinaryModuleInterface::deserialize(const
     std::memcpy(&version, &data[offset], sizeof(uint32_t));
     offset += sizeof(uint32_t);
 
-    if (version != 1) {
+    if (version != 1 && version != 2) {
         return nullptr; // Unsupported version
     }
 
@@ -148,6 +163,7 @@ std::unique_ptr<BinaryModuleInterface> BinaryModuleInterface::deserialize(const
     offset += nameLength;
 
     auto bmi = std::make_unique<BinaryModuleInterface>(moduleName);
+    bmi->version_ = version;
     bmi->timestamp_ = timestamp;
 
     // Compilation options hash
@@ -221,6 +237,11 @@ std::unique_ptr<BinaryModuleInterface> BinaryModuleInterface::deserialize(const
         offset += depNameLen;
 
         ModuleDependency dep(depName, isInterface != 0);
+        if (version >= 2) {
+            if (offset + sizeof(uint64_t) > data.size()) return nullptr;
+            std::memcpy(&dep.interfaceHash, &data[offset], sizeof(uint64_t));
+            offset += sizeof(uint64_t);
+        }
         bmi->dependencies_.push_back(dep);
     }
 
@@ -255,6 +276,29 @@ const CompilationOptionsHash& BinaryModuleInterface::getCompilationOptionsHash()
     return optionsHash_;
 }
 
+uint64_t BinaryModuleInterface::calculateInterfaceHash() const {
+    using common::utils::hashMix;
+
+    // Ordenar los hashes por entidad hace el resultado independiente del
+    // orden de declaración
+    std::vector<uint64_t> entityHashes;
+    entityHashes.reserve(exportedEntities_.size());
+    for (const auto& entity : exportedEntities_) {
+        uint64_t hash = common::utils::fnv1a64(entity.qualifiedName);
+        hash = hashMix(hash, common::utils::fnv1a64(entity.name));
+        hash = hashMix(hash, static_cast<uint64_t>(entity.type));
+        hash = hashMix(hash, (entity.isInline ? 1u : 0u) | (entity.isConstexpr ? 2u : 0u));
+        entityHashes.push_back(hash);
+    }
+    std::sort(entityHashes.begin(), entityHashes.end());
+
+    uint64_t hash = common::utils::fnv1a64(moduleName_);
+    for (uint64_t entityHash : entityHashes) {
+        hash = hashMix(hash, entityHash);
+    }
+    return hash;
+}
+
 // ============================================================================
 // ModuleInterface Implementation
 // ============================================================================
@@ -273,7 +317,7 @@ const std::vector<std::string>& ModuleInterface::getPartitions() const {
     return partitions_;
 }
 
-void ModuleInterface::setBMI(std::unique_ptr<BinaryModuleInterface> bmi) {
+void ModuleInterface::setBMI(std::shared_ptr<const BinaryModuleInterface> bmi) {
     bmi_ = std::move(bmi);
 }
 
@@ -282,7 +326,8 @@ const BinaryModuleInterface* ModuleInterface::getBMI() const {
 }
 
 bool ModuleInterface::isReady() const {
-    return bmi_ != nullptr && bmi_->isValid();
+    // Un módulo sin exportaciones (solo re-exporta o aporta definiciones) también está listo
+    return bmi_ != nullptr && !bmi_->getModuleName().empty();
 }
 
 // ============================================================================
@@ -310,109 +355,32 @@ const std::vector<std::string>& ModuleImplementation::getDependencies() const {
 ModuleDependencyScanner::ModuleDependencyScanner() = default;
 
 std::vector<ModuleDependency> ModuleDependencyScanner::scanFile(const std::filesystem::path& filePath) {
-    std::string filePathStr = filePath.string();
-
-    // Check cache first
-    auto it = scanCache_.find(filePathStr);
-    if (it != scanCache_.end()) {
-        return it->second;
-    }
-
     std::vector<ModuleDependency> dependencies;
-    std::ifstream file(filePath);
-
-    if (!file.is_open()) {
-        return dependencies;
-    }
-
-    std::string line;
-    size_t lineNumber = 1;
-
-    while (std::getline(file, line)) {
-        // Remove comments
-        size_t commentPos = line.find("//");
-        if (commentPos != std::string::npos) {
-            line = line.substr(0, commentPos);
-        }
-
-        // Check for module declarations
-        if (line.find("export module") != std::string::npos) {
-            size_t pos = line.find("export module");
-            std::string moduleDecl = line.substr(pos + 13); // Skip "export module"
-            // Module declaration found, but we don't add it as a dependency
-            continue;
-        }
-
-        // Check for module declarations (non-export)
-        if (line.find("module") != std::string::npos && line.find("export module") == std::string::npos) {
-            size_t pos = line.find("module");
-            std::string moduleDecl = line.substr(pos + 6); // Skip "module"
-            // Module declaration found, but we don't add it as a dependency
-            continue;
-        }
-
-        // Check for import declarations
-        if (line.find("import") != std::string::npos) {
-            size_t pos = line.find("import");
-            std::string importDecl = line.substr(pos + 6); // Skip "import"
-
-            // Handle different import forms
-            if (importDecl.find("<") != std::string::npos && importDecl.find(">") != std::string::npos) {
-                // Header unit: import <header>
-                size_t start = importDecl.find("<");
-                size_t end = importDecl.find(">", start);
-                if (start != std::string::npos && end != std::string::npos) {
-                    std::string headerName = importDecl.substr(start + 1, end - start - 1);
-                    dependencies.emplace_back(headerName, false, filePathStr + ":" + std::to_string(lineNumber));
-                }
-            } else {
-                // Module import: import module_name
-                size_t semicolonPos = importDecl.find(";");
-                if (semicolonPos != std::string::npos) {
-                    importDecl = importDecl.substr(0, semicolonPos);
-                }
-
-                // Remove whitespace
-                importDecl.erase(std::remove_if(importDecl.begin(), importDecl.end(), ::isspace),
-                               importDecl.end());
-
-                if (!importDecl.empty()) {
-                    dependencies.emplace_back(importDecl, true, filePathStr + ":" + std::to_string(lineNumber));
-                }
-            }
-        }
+    std::string filePathStr = filePath.string();
 
-        lineNumber++;
+    for (const auto& requirement : scanRule(filePath).requirements) {
+        dependencies.emplace_back(requirement.logicalName, !requirement.isHeaderUnit,
+                                  filePathStr + ":" + std::to_string(requirement.line));
     }
 
-    // Cache the result
-    scanCache_[filePathStr] = dependencies;
-
     return dependencies;
 }
 
-bool ModuleDependencyScanner::containsModuleDeclaration(const std::filesystem::path& filePath) {
-    std::ifstream file(filePath);
+const P1689Rule& ModuleDependencyScanner::scanRule(const std::filesystem::path& filePath) {
+    std::string filePathStr = filePath.string();
 
-    if (!file.is_open()) {
-        return false;
+    // Check cache first
+    auto it = scanCache_.find(filePathStr);
+    if (it != scanCache_.end()) {
+        return it->second;
     }
 
-    std::string line;
-    while (std::getline(file, line)) {
-        // Remove comments
-        size_t commentPos = line.find("//");
-        if (commentPos != std::string::npos) {
-            line = line.substr(0, commentPos);
-        }
-
-        // Check for module declarations
-        if (line.find("export module") != std::string::npos || line.find("module") != std::string::npos) {
-            return true;
-        }
-    }
+    return scanCache_[filePathStr] = P1689Scanner::scanFile(filePath);
+}
 
-    return false;
+bool ModuleDependencyScanner::containsModuleDeclaration(const std::filesystem::path& filePath) {
+    const auto& rule = scanRule(filePath);
+    return !rule.provides.empty() || !rule.implements.empty();
 }
 
 std::string ModuleDependencyScanner::extractModuleName(const std::string& line) {
@@ -457,6 +425,61 @@ bool ModuleDependencyScanner::isHeaderUnit(const std::string& importName) {
     return importName.find("<") != std::string::npos && importName.find(">") != std::string::npos;
 }
 
+// ============================================================================
+// BMIRegistry Implementation
+// ============================================================================
+
+BMIRegistry& BMIRegistry::global() {
+    static BMIRegistry registry;
+    return registry;
+}
+
+std::shared_ptr<const BinaryModuleInterface> BMIRegistry::acquire(
+    const common::utils::Hash128& hash,
+    const std::function<std::unique_ptr<BinaryModuleInterface>()>& load, bool* loaded) {
+    if (loaded) *loaded = false;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        auto it = entries_.find(hash);
+        if (it == entries_.end()) break;
+        if (auto bmi = it->second.bmi.lock()) return bmi;
+        if (!it->second.loading) break;
+        // Otro hilo lo está deserializando: su resultado sirve también aquí
+        loadFinished_.wait(lock);
+    }
+
+    // Se quitan los que ya nadie usa; las cargas son pocas (una por módulo)
+    std::erase_if(entries_, [](const auto& entry) { return !entry.second.loading && entry.second.bmi.expired(); });
+    entries_[hash].loading = true;
+    lock.unlock();
+
+    std::shared_ptr<const BinaryModuleInterface> bmi;
+    try {
+        bmi = load();
+    } catch (...) {
+        lock.lock();
+        entries_.erase(hash);
+        loadFinished_.notify_all();
+        throw;
+    }
+    if (loaded) *loaded = true;
+
+    lock.lock();
+    if (bmi) {
+        entries_[hash] = Entry{bmi, false};
+    } else {
+        entries_.erase(hash);
+    }
+    loadFinished_.notify_all();
+    return bmi;
+}
+
+size_t BMIRegistry::liveCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<size_t>(std::count_if(entries_.begin(), entries_.end(),
+                                             [](const auto& entry) { return !entry.second.bmi.expired(); }));
+}
+
 // ============================================================================
 // ModuleCache Implementation
 // ============================================================================
@@ -468,19 +491,39 @@ ModuleCache::ModuleCache(const std::filesystem::path& cacheDir)
 }
 
 bool ModuleCache::store(const std::string& moduleName, const BinaryModuleInterface& bmi) {
+    common::utils::MemoryScope memoryScope(common::utils::MemorySubsystem::BMI);
     try {
         std::string key = generateCacheKey(moduleName);
         std::filesystem::path cacheFile = getCacheFilePath(key);
 
         std::vector<uint8_t> data = bmi.serialize();
 
-        std::ofstream file(cacheFile, std::ios::binary);
-        if (!file.is_open()) {
-            return false;
+        // Otros compiladores leen el mismo directorio: se publica con un
+        // rename atómico para que nunca vean un BMI a medio escribir
+        std::filesystem::path temporary = cacheFile;
+        temporary += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()) ^
+                                          static_cast<size_t>(std::chrono::steady_clock::now()
+                                                                  .time_since_epoch().count())) + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                return false;
+            }
+            file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            if (!file) {
+                file.close();
+                std::error_code ignored;
+                std::filesystem::remove(temporary, ignored);
+                return false;
+            }
         }
 
-        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
-        file.close();
+        std::error_code error;
+        std::filesystem::rename(temporary, cacheFile, error);
+        if (error) {
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
 
         stats_.totalEntries++;
         return true;
@@ -489,36 +532,35 @@ bool ModuleCache::store(const std::string& moduleName, const BinaryModuleInterfa
     }
 }
 
-std::unique_ptr<BinaryModuleInterface> ModuleCache::retrieve(const std::string& moduleName) {
+std::shared_ptr<const BinaryModuleInterface> ModuleCache::retrieve(const std::string& moduleName) {
+    common::utils::MemoryScope memoryScope(common::utils::MemorySubsystem::BMI);
+    auto start = std::chrono::steady_clock::now();
     try {
         std::string key = generateCacheKey(moduleName);
         std::filesystem::path cacheFile = getCacheFilePath(key);
 
-        if (!std::filesystem::exists(cacheFile)) {
-            stats_.misses++;
-            return nullptr;
-        }
-
-        std::ifstream file(cacheFile, std::ios::binary | std::ios::ate);
-        if (!file.is_open()) {
+        auto mapping = common::utils::MappedFile::open(cacheFile);
+        if (!mapping) {
             stats_.misses++;
             return nullptr;
         }
 
-        std::streamsize size = file.tellg();
-        file.seekg(0, std::ios::beg);
-
-        std::vector<uint8_t> data(static_cast<size_t>(size));
-        if (!file.read(reinterpret_cast<char*>(data.data()), size)) {
-            stats_.misses++;
-            return nullptr;
-        }
-
-        file.close();
-
-        auto bmi = BinaryModuleInterface::deserialize(data);
-        if (bmi && bmi->isValid()) {
+        // Solo se deserializa si ningún otro trabajo tiene ya este mismo BMI
+        bool deserialized = false;
+        auto bmi = BMIRegistry::global().acquire(common::utils::hash128(mapping->view()), [&]() {
+            std::vector<uint8_t> data(mapping->data(), mapping->data() + mapping->size());
+            auto loaded = BinaryModuleInterface::deserialize(data);
+            return loaded && !loaded->getModuleName().empty() ? std::move(loaded) : nullptr;
+        }, &deserialized);
+        if (bmi) {
+            // La fecha de modificación hace de marca LRU para collectGarbage
+            std::error_code ignored;
+            std::filesystem::last_write_time(cacheFile, std::filesystem::file_time_type::clock::now(), ignored);
             stats_.hits++;
+            if (!deserialized) stats_.sharedHits++;
+            stats_.bytesLoaded += mapping->size();
+            stats_.loadTime += std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start);
             return bmi;
         } else {
             stats_.misses++;
@@ -540,6 +582,25 @@ bool ModuleCache::isValid(const std::string& moduleName, const CompilationOption
     return cachedHash.combined() == currentHash.combined();
 }
 
+bool ModuleCache::isValid(const std::string& moduleName, const CompilationOptionsHash& currentHash,
+                          const std::unordered_map<std::string, uint64_t>& importHashes) {
+    auto bmi = retrieve(moduleName);
+    if (!bmi || bmi->getCompilationOptionsHash().combined() != currentHash.combined()) {
+        return false;
+    }
+
+    for (const auto& dep : bmi->getDependencies()) {
+        if (!dep.isInterface) {
+            continue;
+        }
+        auto it = importHashes.find(dep.moduleName);
+        if (dep.interfaceHash == 0 || it == importHashes.end() || it->second != dep.interfaceHash) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void ModuleCache::invalidate(const std::string& moduleName) {
     try {
         std::string key = generateCacheKey(moduleName);
@@ -568,10 +629,85 @@ void ModuleCache::clear() {
     }
 }
 
+std::unique_ptr<common::utils::FileLock> ModuleCache::lockEntry(const std::string& moduleName) {
+    return common::utils::FileLock::acquire(cacheDir_ / (generateCacheKey(moduleName) + ".lock"));
+}
+
+size_t ModuleCache::collectGarbage(uint64_t maxBytes) {
+    auto collector = common::utils::FileLock::tryAcquire(cacheDir_ / "gc.lock");
+    if (!collector) {
+        return 0;
+    }
+
+    struct Entry {
+        std::filesystem::path path;
+        std::filesystem::file_time_type lastUse;
+        uint64_t size;
+    };
+    std::vector<Entry> entries;
+    uint64_t totalSize = 0;
+    size_t removed = 0;
+    std::error_code error;
+    auto now = std::filesystem::file_time_type::clock::now();
+
+    for (const auto& file : std::filesystem::directory_iterator(cacheDir_, error)) {
+        if (!file.is_regular_file(error)) {
+            continue;
+        }
+        auto lastUse = file.last_write_time(error);
+        if (error) {
+            continue;
+        }
+        if (file.path().extension() == ".tmp") {
+            // Temporales de compiladores que murieron antes de publicar
+            if (now - lastUse > std::chrono::hours(1) && std::filesystem::remove(file.path(), error)) {
+                removed++;
+            }
+            continue;
+        }
+        if (file.path().extension() == ".bmi") {
+            uint64_t size = file.file_size(error);
+            entries.push_back({file.path(), lastUse, size});
+            totalSize += size;
+        }
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.lastUse < b.lastUse;
+    });
+    for (const auto& entry : entries) {
+        if (totalSize <= maxBytes) {
+            break;
+        }
+        std::filesystem::path lockPath = entry.path;
+        lockPath.replace_extension(".lock");
+        auto entryLock = common::utils::FileLock::tryAcquire(lockPath);
+        if (!entryLock) {
+            continue; // Otro proceso lo está reconstruyendo
+        }
+        if (std::filesystem::remove(entry.path, error)) {
+            totalSize -= entry.size;
+            removed++;
+            if (stats_.totalEntries > 0) {
+                stats_.totalEntries--;
+            }
+        }
+    }
+    return removed;
+}
+
 ModuleCache::CacheStats ModuleCache::getStats() const {
     return stats_;
 }
 
+void ModuleCache::recordTelemetry(CompilationTelemetry& telemetry) const {
+    telemetry.recordMetric("bmi.hits", static_cast<double>(stats_.hits));
+    telemetry.recordMetric("bmi.misses", static_cast<double>(stats_.misses));
+    telemetry.recordMetric("bmi.shared", static_cast<double>(stats_.sharedHits));
+    telemetry.recordMetric("bmi.load.us", static_cast<double>(stats_.loadTime.count()));
+    telemetry.recordMetric("bmi.load.bytes", static_cast<double>(stats_.bytesLoaded));
+}
+
 std::string ModuleCache::generateCacheKey(const std::string& moduleName) const {
     // Simple hash for cache key
     size_t hash = std::hash<std::string>{}(moduleName);
@@ -636,7 +772,8 @@ void ModuleLoader::unloadModule(const std::string& moduleName) {
 ModuleSystem::ModuleSystem(const std::filesystem::path& cacheDir)
     : scanner_(std::make_shared<ModuleDependencyScanner>()),
       cache_(std::make_shared<ModuleCache>(cacheDir)),
-      loader_(std::make_shared<ModuleLoader>(cache_)) {
+      loader_(std::make_shared<ModuleLoader>(cache_)),
+      parallelJobs_(common::utils::ThreadPool::defaultThreadCount()) {
 }
 
 bool ModuleSystem::initialize() {
@@ -650,38 +787,21 @@ bool ModuleSystem::initialize() {
 
 bool ModuleSystem::processSourceFile(const std::filesystem::path& sourcePath) {
     try {
-        // Scan for dependencies
-        auto dependencies = scanner_->scanFile(sourcePath);
-
-        // Check if file contains module declaration
-        if (scanner_->containsModuleDeclaration(sourcePath)) {
-            // Read the file to extract module name
-            std::ifstream file(sourcePath);
-            if (!file.is_open()) {
-                return false;
-            }
+        const auto& rule = scanner_->scanRule(sourcePath);
+        if (!rule.success) {
+            return false;
+        }
 
-            std::string line;
-            while (std::getline(file, line)) {
-                if (line.find("export module") != std::string::npos) {
-                    std::string moduleName = scanner_->extractModuleName(line);
-                    if (!moduleName.empty()) {
-                        return processModuleDeclaration(sourcePath, moduleName);
-                    }
-                } else if (line.find("module") != std::string::npos &&
-                          line.find("export module") == std::string::npos) {
-                    std::string moduleName = scanner_->extractModuleName(line);
-                    if (!moduleName.empty()) {
-                        return processModuleDeclaration(sourcePath, moduleName);
-                    }
-                }
-            }
+        // Module declaration: interface, partition or implementation unit
+        const std::string& moduleName = rule.provides.empty() ? rule.implements : rule.provides;
+        if (!moduleName.empty()) {
+            return processModuleDeclaration(sourcePath, moduleName);
         }
 
         // Process imports
-        for (const auto& dep : dependencies) {
-            if (dep.isInterface) {
-                processImportDeclaration(sourcePath, dep.moduleName);
+        for (const auto& requirement : rule.requirements) {
+            if (!requirement.isHeaderUnit) {
+                processImportDeclaration(sourcePath, requirement.logicalName);
             }
         }
 
@@ -698,52 +818,270 @@ bool ModuleSystem::compileModule(const std::string& moduleName) {
         return false;
     }
 
-    auto& module = it->second;
+    // Los módulos ya compilados se revisan igualmente: un import con otra
+    // interfaz obliga a recompilarlos
+    return compileModuleGraph(buildModuleGraph(moduleName));
+}
 
-    // Check if already compiled
-    if (module->isReady()) {
-        return true;
+ModuleBuildGraph ModuleSystem::buildModuleGraph(const std::string& targetModule) {
+    ModuleBuildGraph graph;
+    if (interfaces_.find(targetModule) == interfaces_.end()) {
+        return graph;
     }
 
-    // Get dependencies
-    auto dependencies = getModuleDependencies(moduleName);
+    // DFS en postorden: cada módulo entra después de sus dependencias
+    std::unordered_map<std::string, size_t> index;
+    std::unordered_set<std::string> visiting;
+    std::vector<std::vector<std::string>> names;
 
-    // Compile dependencies first (topological order)
-    for (const auto& dep : dependencies) {
-        if (!compileModule(dep)) {
-            return false;
+    std::function<void(const std::string&)> visit = [&](const std::string& module) {
+        if (index.count(module)) {
+            return;
+        }
+        if (!visiting.insert(module).second) {
+            graph.acyclic = false;
+            return;
+        }
+
+        auto dependencies = collectInterfaceDependencies(module);
+        for (const auto& dep : dependencies) {
+            visit(dep);
+        }
+
+        visiting.erase(module);
+        index[module] = graph.modules.size();
+        graph.modules.push_back(module);
+        names.push_back(std::move(dependencies));
+    };
+    visit(targetModule);
+
+    size_t count = graph.modules.size();
+    graph.dependencies.resize(count);
+    graph.dependents.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        for (const auto& dep : names[i]) {
+            auto found = index.find(dep);
+            if (found == index.end() || found->second >= i) {
+                continue; // Arista de un ciclo, ya marcado
+            }
+            graph.dependencies[i].push_back(found->second);
+            graph.dependents[found->second].push_back(i);
         }
     }
 
-    // Compile this module
-    // In a real implementation, this would invoke the compiler
-    // For now, we'll create a mock BMI
-    auto bmi = std::make_unique<BinaryModuleInterface>(moduleName);
+    // Sin historial se estima con la media de los módulos ya medidos
+    double known = 0.0;
+    size_t measured = 0;
+    {
+        std::lock_guard<std::mutex> lock(buildMutex_);
+        graph.cost.resize(count, 0.0);
+        for (size_t i = 0; i < count; ++i) {
+            auto found = moduleCosts_.find(graph.modules[i]);
+            if (found != moduleCosts_.end()) {
+                graph.cost[i] = found->second;
+                known += found->second;
+                measured++;
+            }
+        }
+    }
+    double fallback = measured > 0 ? known / static_cast<double>(measured) : 1.0;
+    for (auto& cost : graph.cost) {
+        if (cost <= 0.0) {
+            cost = fallback;
+        }
+    }
+
+    graph.criticalPath.resize(count, 0.0);
+    for (size_t i = count; i-- > 0;) {
+        double longest = 0.0;
+        for (size_t dependent : graph.dependents[i]) {
+            longest = std::max(longest, graph.criticalPath[dependent]);
+        }
+        graph.criticalPath[i] = graph.cost[i] + longest;
+    }
+
+    return graph;
+}
+
+bool ModuleSystem::compileModuleGraph(const ModuleBuildGraph& graph) {
+    if (!graph.acyclic) {
+        return false;
+    }
+    size_t count = graph.modules.size();
+    if (count == 0) {
+        return true;
+    }
+
+    auto lowerPriority = [&graph](size_t a, size_t b) {
+        return graph.criticalPath[a] < graph.criticalPath[b];
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(lowerPriority)> ready(lowerPriority);
+    std::vector<size_t> pending(count);
+    std::vector<bool> skipped(count, false);
+    for (size_t i = 0; i < count; ++i) {
+        pending[i] = graph.dependencies[i].size();
+        if (pending[i] == 0) {
+            ready.push(i);
+        }
+    }
+
+    std::mutex queueMutex;
+    std::condition_variable queueChanged;
+    size_t remaining = count;
+    bool success = true;
+
+    auto worker = [&](size_t) {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        while (true) {
+            queueChanged.wait(lock, [&] { return !ready.empty() || remaining == 0; });
+            if (remaining == 0) {
+                return;
+            }
+
+            size_t node = ready.top();
+            ready.pop();
+            bool skip = skipped[node];
+            lock.unlock();
 
-    // Add some mock exported entities
-    bmi->addExportedEntity(ExportedEntity("MyClass", "MyModule::MyClass", ExportType::Type));
-    bmi->addExportedEntity(ExportedEntity("myFunction", "MyModule::myFunction", ExportType::Function));
+            bool built = false;
+            if (!skip) {
+                std::vector<std::string> dependencies;
+                for (size_t dep : graph.dependencies[node]) {
+                    dependencies.push_back(graph.modules[dep]);
+                }
+                built = buildInterface(graph.modules[node], dependencies);
+            }
 
-    // Add dependencies
-    for (const auto& dep : dependencies) {
-        bmi->addDependency(ModuleDependency(dep, true));
+            lock.lock();
+            success = success && built;
+            for (size_t dependent : graph.dependents[node]) {
+                if (!built) {
+                    skipped[dependent] = true;
+                }
+                if (--pending[dependent] == 0) {
+                    ready.push(dependent);
+                }
+            }
+            remaining--;
+            queueChanged.notify_all();
+        }
+    };
+
+    size_t jobs = std::min(parallelJobs_, count);
+    common::utils::parallelFor(jobs, jobs, worker);
+
+    if (cacheSizeLimit_ > 0) {
+        cache_->collectGarbage(cacheSizeLimit_);
     }
+    return success;
+}
+
+bool ModuleSystem::buildInterface(const std::string& moduleName,
+                                  const std::vector<std::string>& dependencies) {
+    try {
+        auto& module = interfaces_.at(moduleName);
+
+        // Un BMI sigue valiendo mientras cada import conserve el hash de
+        // interfaz con el que se compiló
+        std::vector<ModuleDependency> imports;
+        for (const auto& dep : dependencies) {
+            const auto* depBMI = interfaces_.at(dep)->getBMI();
+            if (!depBMI) {
+                return false;
+            }
+            imports.emplace_back(dep, true);
+            imports.back().interfaceHash = depBMI->calculateInterfaceHash();
+        }
+        if (module->isReady()) {
+            const auto& recorded = module->getBMI()->getDependencies();
+            bool current = std::all_of(imports.begin(), imports.end(), [&](const ModuleDependency& dep) {
+                return std::any_of(recorded.begin(), recorded.end(), [&](const ModuleDependency& old) {
+                    return old.moduleName == dep.moduleName && old.interfaceHash == dep.interfaceHash;
+                });
+            });
+            if (current) {
+                return true;
+            }
+        }
+
+        // Set compilation options hash (mock); the source hash stands in
+        // for the preprocessed content
+        uint64_t sourceHash = 0;
+        if (auto source = common::utils::MappedFile::open(module->getSourcePath())) {
+            sourceHash = common::utils::fnv1a64(source->view());
+        }
+        CompilationOptionsHash hash;
+        hash.preprocessorHash = static_cast<size_t>(
+            common::utils::hashMix(std::hash<std::string>{}("#define DEBUG"), sourceHash));
+        hash.compilerFlagsHash = std::hash<std::string>{}("-O2 -std=c++20");
+        hash.systemIncludesHash = std::hash<std::string>{}("/usr/include");
+
+        // Solo un proceso compila cada módulo; los demás esperan y reutilizan
+        // el BMI que publique
+        auto entryLock = cache_->lockEntry(moduleName);
+        {
+            std::unordered_map<std::string, uint64_t> importHashes;
+            for (const auto& dep : imports) {
+                importHashes[dep.moduleName] = dep.interfaceHash;
+            }
+            std::lock_guard<std::mutex> lock(buildMutex_);
+            if (cache_->isValid(moduleName, hash, importHashes)) {
+                if (auto cached = cache_->retrieve(moduleName)) {
+                    module->setBMI(std::move(cached));
+                    return true;
+                }
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
 
-    // Set compilation options hash (mock)
-    CompilationOptionsHash hash;
-    hash.preprocessorHash = std::hash<std::string>{}("#define DEBUG");
-    hash.compilerFlagsHash = std::hash<std::string>{}("-O2 -std=c++20");
-    hash.systemIncludesHash = std::hash<std::string>{}("/usr/include");
-    bmi->setCompilationOptionsHash(hash);
+        // Compile this module
+        // In a real implementation, this would invoke the compiler
+        // For now, we'll create a mock BMI
+        auto bmi = std::make_unique<BinaryModuleInterface>(moduleName);
 
-    // Store in cache
-    if (cache_->store(moduleName, *bmi)) {
+        // Add some mock exported entities
+        bmi->addExportedEntity(ExportedEntity("MyClass", "MyModule::MyClass", ExportType::Type));
+        bmi->addExportedEntity(ExportedEntity("myFunction", "MyModule::myFunction", ExportType::Function));
+
+        // Add dependencies
+        for (const auto& dep : imports) {
+            bmi->addDependency(dep);
+        }
+
+        bmi->setCompilationOptionsHash(hash);
+
+        // Store in cache
+        std::lock_guard<std::mutex> lock(buildMutex_);
+        if (!cache_->store(moduleName, *bmi)) {
+            return false;
+        }
         module->setBMI(std::move(bmi));
         stats_.interfacesCompiled++;
+        moduleCosts_[moduleName] = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
         return true;
+    } catch (const std::exception&) {
+        return false;
     }
+}
+
+void ModuleSystem::invalidateModule(const std::string& moduleName) {
+    auto it = interfaces_.find(moduleName);
+    if (it != interfaces_.end()) {
+        it->second->setBMI(nullptr);
+    }
+}
+
+void ModuleSystem::setModuleCost(const std::string& moduleName, double milliseconds) {
+    std::lock_guard<std::mutex> lock(buildMutex_);
+    moduleCosts_[moduleName] = milliseconds;
+}
 
-    return false;
+double ModuleSystem::getModuleCost(const std::string& moduleName) const {
+    std::lock_guard<std::mutex> lock(buildMutex_);
+    auto it = moduleCosts_.find(moduleName);
+    return it != moduleCosts_.end() ? it->second : 0.0;
 }
 
 std::vector<std::string> ModuleSystem::getModuleDependencies(const std::string& moduleName) {
@@ -802,41 +1140,71 @@ bool ModuleSystem::processImportDeclaration(const std::filesystem::path& /*fileP
 }
 
 std::vector<std::string> ModuleSystem::computeCompilationOrder(const std::string& targetModule) {
-    std::vector<std::string> order;
-    std::unordered_set<std::string> visited;
-    std::unordered_set<std::string> visiting;
+    ModuleBuildGraph graph = buildModuleGraph(targetModule);
+    if (!graph.acyclic) {
+        return {}; // Circular dependency
+    }
 
-    std::function<bool(const std::string&)> visit = [&](const std::string& module) -> bool {
-        if (visiting.count(module)) {
-            // Circular dependency detected
-            return false;
-        }
-        if (visited.count(module)) {
-            return true;
+    // Orden de un único hilo con la misma prioridad que compileModuleGraph
+    auto lowerPriority = [&graph](size_t a, size_t b) {
+        return graph.criticalPath[a] < graph.criticalPath[b];
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(lowerPriority)> ready(lowerPriority);
+    std::vector<size_t> pending(graph.modules.size());
+    for (size_t i = 0; i < graph.modules.size(); ++i) {
+        pending[i] = graph.dependencies[i].size();
+        if (pending[i] == 0) {
+            ready.push(i);
         }
+    }
 
-        visiting.insert(module);
-
-        // Visit dependencies
-        auto dependencies = getModuleDependencies(module);
-        for (const auto& dep : dependencies) {
-            if (!visit(dep)) {
-                return false;
+    std::vector<std::string> order;
+    while (!ready.empty()) {
+        size_t node = ready.top();
+        ready.pop();
+        order.push_back(graph.modules[node]);
+        for (size_t dependent : graph.dependents[node]) {
+            if (--pending[dependent] == 0) {
+                ready.push(dependent);
             }
         }
+    }
 
-        visiting.erase(module);
-        visited.insert(module);
-        order.push_back(module);
+    return order;
+}
 
-        return true;
+std::vector<std::string> ModuleSystem::collectInterfaceDependencies(const std::string& moduleName) {
+    std::vector<std::string> dependencies;
+    auto it = interfaces_.find(moduleName);
+    if (it == interfaces_.end()) {
+        return dependencies;
+    }
+
+    // "A:P" pertenece al módulo primario "A"
+    std::string primary = moduleName.substr(0, moduleName.find(':'));
+    std::unordered_set<std::string> seen;
+    auto add = [&](std::string name) {
+        if (!name.empty() && name.front() == ':') {
+            name = primary + name;
+        }
+        if (name != moduleName && interfaces_.count(name) && seen.insert(name).second) {
+            dependencies.push_back(name);
+        }
     };
 
-    if (!visit(targetModule)) {
-        return {}; // Circular dependency or error
+    for (const auto& dep : scanner_->scanFile(it->second->getSourcePath())) {
+        if (dep.isInterface) {
+            add(dep.moduleName);
+        }
+    }
+    for (const auto& partition : it->second->getPartitions()) {
+        add(partition.find(':') == std::string::npos ? ":" + partition : partition);
+    }
+    for (const auto& dep : getModuleDependencies(moduleName)) {
+        add(dep);
     }
 
-    return order;
+    return dependencies;
 }
 
 } // namespace cpp20::compiler::modules
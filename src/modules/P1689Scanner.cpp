@@ -0,0 +1,437 @@
+/**
+ * @file P1689Scanner.cpp
+ * @brief Escaneo de declaraciones module/import sobre el archivo proyectado
+ */
+
+#include <compiler/modules/P1689Scanner.h>
+#include <compiler/common/utils/MappedFile.h>
+#include <compiler/common/utils/ThreadPool.h>
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CPP20_P1689_HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace cpp20::compiler::modules {
+
+namespace {
+
+inline bool isIdentifierChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           (c >= '0' && c <= '9') || c == '_';
+}
+
+inline bool isHorizontalSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+inline bool isModuleNameChar(char c) {
+    return isIdentifierChar(c) || c == '.' || c == ':';
+}
+
+// Primer '\n', '/', '"' o '\'' de [p, end): los únicos caracteres que
+// pueden cambiar el estado del escaneo fuera del principio de línea
+const char* findSpecial(const char* p, const char* end) {
+#ifdef CPP20_P1689_HAS_SSE2
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i slash = _mm_set1_epi8('/');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i apostrophe = _mm_set1_epi8('\'');
+    for (; end - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, newline), _mm_cmpeq_epi8(v, slash)),
+                                   _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, apostrophe)));
+        auto mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+        if (mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return p + index;
+#else
+            return p + __builtin_ctz(mask);
+#endif
+        }
+    }
+#endif
+    while (p < end && *p != '\n' && *p != '/' && *p != '"' && *p != '\'') ++p;
+    return p;
+}
+
+const char* findNewline(const char* p, const char* end) {
+    const void* found = std::memchr(p, '\n', static_cast<size_t>(end - p));
+    return found ? static_cast<const char*>(found) : end;
+}
+
+// Devuelve el carácter siguiente a "*/", o end si el comentario no se cierra
+const char* skipBlockComment(const char* p, const char* end) {
+    while (p < end) {
+        const void* star = std::memchr(p, '*', static_cast<size_t>(end - p));
+        if (!star) return end;
+        p = static_cast<const char*>(star) + 1;
+        if (p < end && *p == '/') return p + 1;
+    }
+    return end;
+}
+
+// Literal ordinario o de carácter: termina en su delimitador o al final de
+// la línea (un literal sin cerrar no se propaga a la siguiente)
+const char* skipQuoted(const char* p, const char* end, char delimiter) {
+    while (p < end) {
+        char c = *p;
+        if (c == delimiter) return p + 1;
+        if (c == '\n') return p;
+        p += (c == '\\') ? 2 : 1;
+    }
+    return end;
+}
+
+// Identificador que termina justo antes de p ("R", "u8R", "L"...)
+std::string_view prefixBefore(const char* begin, const char* p) {
+    const char* start = p;
+    while (start > begin && isIdentifierChar(start[-1])) --start;
+    return std::string_view(start, static_cast<size_t>(p - start));
+}
+
+// p apunta a la '"' de R"delim( ... )delim"
+const char* skipRawString(const char* p, const char* end) {
+    const char* open = p + 1;
+    const char* paren = open;
+    while (paren < end && *paren != '(' && *paren != '\n' && paren - open <= 16) ++paren;
+    if (paren >= end || *paren != '(') return skipQuoted(p + 1, end, '"');
+
+    std::string closing = ")" + std::string(open, paren) + "\"";
+    std::string_view rest(paren + 1, static_cast<size_t>(end - paren - 1));
+    size_t found = rest.find(closing);
+    return found == std::string_view::npos ? end : rest.data() + found + closing.size();
+}
+
+// ¿El '\n' en p continúa la línea con una barra invertida?
+bool isSplicedNewline(const char* begin, const char* p) {
+    if (p > begin && p[-1] == '\r') --p;
+    return p > begin && p[-1] == '\\';
+}
+
+/**
+ * @brief Estado del escaneo de una unidad
+ */
+class UnitScanner {
+public:
+    UnitScanner(std::string_view source, P1689Rule& rule)
+        : begin_(source.data()), end_(source.data() + source.size()), rule_(rule) {}
+
+    void run() {
+        const char* p = begin_;
+        if (end_ - p >= 3 && std::memcmp(p, "\xEF\xBB\xBF", 3) == 0) p += 3;
+
+        bool atLineStart = true;
+        while (p < end_) {
+            if (atLineStart) {
+                p = skipLeadingSpace(p);
+                if (p < end_ && (*p == 'e' || *p == 'm' || *p == 'i')) {
+                    if (const char* after = parseDeclaration(p)) p = after;
+                }
+                atLineStart = false;
+                continue;
+            }
+
+            const char* q = findSpecial(p, end_);
+            if (q >= end_) break;
+            switch (*q) {
+                case '\n':
+                    atLineStart = !isSplicedNewline(begin_, q);
+                    line_++;
+                    p = q + 1;
+                    break;
+                case '/':
+                    if (q + 1 < end_ && q[1] == '/') {
+                        p = findNewline(q, end_);
+                    } else if (q + 1 < end_ && q[1] == '*') {
+                        p = skipCounting(q + 2, skipBlockComment(q + 2, end_));
+                    } else {
+                        p = q + 1;
+                    }
+                    break;
+                case '"': {
+                    std::string_view prefix = prefixBefore(begin_, q);
+                    if (prefix == "R" || prefix == "u8R" || prefix == "uR" || prefix == "UR" || prefix == "LR") {
+                        p = skipCounting(q, skipRawString(q, end_));
+                    } else {
+                        p = skipQuoted(q + 1, end_, '"');
+                    }
+                    break;
+                }
+                default: {
+                    // Un apóstrofo tras un número es un separador de dígitos
+                    std::string_view prefix = prefixBefore(begin_, q);
+                    bool charLiteral = prefix.empty() || prefix == "u" || prefix == "U" ||
+                                       prefix == "L" || prefix == "u8";
+                    p = charLiteral ? skipQuoted(q + 1, end_, '\'') : q + 1;
+                    break;
+                }
+            }
+        }
+        rule_.success = true;
+    }
+
+private:
+    const char* begin_;
+    const char* end_;
+    P1689Rule& rule_;
+    uint32_t line_ = 1;
+
+    const char* skipCounting(const char* from, const char* to) {
+        line_ += static_cast<uint32_t>(std::count(from, to, '\n'));
+        return to;
+    }
+
+    // Espacios y comentarios de bloque al principio de la línea
+    const char* skipLeadingSpace(const char* p) {
+        while (p < end_) {
+            if (isHorizontalSpace(*p)) {
+                ++p;
+            } else if (*p == '/' && p + 1 < end_ && p[1] == '*') {
+                p = skipCounting(p + 2, skipBlockComment(p + 2, end_));
+            } else {
+                break;
+            }
+        }
+        return p;
+    }
+
+    // Espacios, saltos de línea y comentarios dentro de una declaración
+    const char* skipSpace(const char* p) {
+        while (p < end_) {
+            if (isHorizontalSpace(*p)) {
+                ++p;
+            } else if (*p == '\n') {
+                line_++;
+                ++p;
+            } else if (*p == '/' && p + 1 < end_ && p[1] == '*') {
+                p = skipCounting(p + 2, skipBlockComment(p + 2, end_));
+            } else if (*p == '/' && p + 1 < end_ && p[1] == '/') {
+                p = findNewline(p, end_);
+            } else {
+                break;
+            }
+        }
+        return p;
+    }
+
+    std::string_view word(const char* p) const {
+        const char* q = p;
+        while (q < end_ && isIdentifierChar(*q)) ++q;
+        return std::string_view(p, static_cast<size_t>(q - p));
+    }
+
+    // Nombre de módulo hasta ';' o '[' (atributos), sin espacios; vacío si
+    // aparece algo que no puede formar parte de un nombre
+    std::string moduleName(const char*& p) {
+        std::string name;
+        while (p < end_ && *p != ';' && *p != '[') {
+            if (isModuleNameChar(*p)) {
+                name += *p++;
+            } else if (isHorizontalSpace(*p) || *p == '\n' || *p == '/') {
+                const char* next = skipSpace(p);
+                if (next == p) return {};
+                p = next;
+            } else {
+                return {};
+            }
+        }
+        return name;
+    }
+
+    const char* skipToSemicolon(const char* p) {
+        const char* semicolon = static_cast<const char*>(std::memchr(p, ';', static_cast<size_t>(end_ - p)));
+        const char* stop = semicolon ? semicolon + 1 : end_;
+        return skipCounting(p, stop);
+    }
+
+    std::string primaryModule() const {
+        const std::string& name = rule_.provides.empty() ? rule_.implements : rule_.provides;
+        return name.substr(0, name.find(':'));
+    }
+
+    // Devuelve el final de la declaración, o nullptr si p no empieza una
+    const char* parseDeclaration(const char* p) {
+        uint32_t startLine = line_;
+        bool exported = false;
+        std::string_view keyword = word(p);
+        const char* q = p + keyword.size();
+
+        if (keyword == "export") {
+            q = skipSpace(q);
+            keyword = word(q);
+            if (keyword != "module" && keyword != "import") {
+                line_ = startLine;
+                return nullptr;
+            }
+            exported = true;
+            q += keyword.size();
+        }
+        if (keyword != "module" && keyword != "import") return nullptr;
+        if (q < end_ && isIdentifierChar(*q)) return nullptr;
+
+        const char* r = skipSpace(q);
+        if (r >= end_) {
+            line_ = startLine;
+            return nullptr;
+        }
+
+        if (keyword == "module") {
+            if (*r == ';') return r + 1; // Fragmento global
+            if (!isIdentifierChar(*r) && *r != ':') {
+                line_ = startLine;
+                return nullptr;
+            }
+            std::string name = moduleName(r);
+            if (name.empty()) {
+                line_ = startLine;
+                return nullptr;
+            }
+            if (name.front() != ':') { // "module :private;" no declara nada
+                if (exported || name.find(':') != std::string::npos) {
+                    rule_.provides = name;
+                    rule_.isInterface = exported;
+                } else {
+                    rule_.implements = name;
+                    rule_.requirements.push_back({name, false, false, false, startLine});
+                }
+            }
+            return skipToSemicolon(r);
+        }
+
+        P1689Requirement requirement;
+        requirement.isExported = exported;
+        requirement.line = startLine;
+        if (*r == '<' || *r == '"') {
+            char close = (*r == '<') ? '>' : '"';
+            const char* nameEnd = r + 1;
+            while (nameEnd < end_ && *nameEnd != close && *nameEnd != '\n') ++nameEnd;
+            if (nameEnd >= end_ || *nameEnd != close) {
+                line_ = startLine;
+                return nullptr;
+            }
+            requirement.logicalName.assign(r + 1, nameEnd);
+            requirement.isHeaderUnit = true;
+            requirement.isAngled = (close == '>');
+            r = nameEnd + 1;
+        } else if (isIdentifierChar(*r) || *r == ':') {
+            requirement.logicalName = moduleName(r);
+            if (requirement.logicalName.empty()) {
+                line_ = startLine;
+                return nullptr;
+            }
+            if (requirement.logicalName.front() == ':') {
+                requirement.logicalName = primaryModule() + requirement.logicalName;
+            }
+        } else {
+            line_ = startLine;
+            return nullptr;
+        }
+
+        rule_.requirements.push_back(std::move(requirement));
+        return skipToSemicolon(r);
+    }
+};
+
+void appendJsonString(std::ostringstream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            case '\r': out << "\\r"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out << "\\u00" << "0123456789abcdef"[(c >> 4) & 0xF] << "0123456789abcdef"[c & 0xF];
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
+
+} // anonymous namespace
+
+P1689Rule P1689Scanner::scanBuffer(std::string_view source, const std::filesystem::path& path) {
+    P1689Rule rule;
+    rule.sourcePath = path;
+    UnitScanner(source, rule).run();
+    return rule;
+}
+
+P1689Rule P1689Scanner::scanFile(const std::filesystem::path& path) {
+    auto file = common::utils::MappedFile::open(path);
+    if (file) {
+        return scanBuffer(file->view(), path);
+    }
+
+    // MappedFile no proyecta archivos vacíos: son válidos y sin dependencias
+    P1689Rule rule;
+    rule.sourcePath = path;
+    std::error_code error;
+    rule.success = std::filesystem::is_regular_file(path, error) &&
+                   std::filesystem::file_size(path, error) == 0 && !error;
+    return rule;
+}
+
+std::vector<P1689Rule> P1689Scanner::scanFiles(const std::vector<std::filesystem::path>& paths,
+                                               size_t jobs) {
+    std::vector<P1689Rule> rules(paths.size());
+    common::utils::parallelFor(paths.size(), jobs, [&](size_t i) {
+        rules[i] = scanFile(paths[i]);
+    });
+    return rules;
+}
+
+std::string P1689Scanner::formatJson(const std::vector<P1689Rule>& rules) {
+    std::ostringstream out;
+    out << "{\n  \"revision\": 0,\n  \"rules\": [";
+    for (size_t i = 0; i < rules.size(); ++i) {
+        const auto& rule = rules[i];
+        out << (i ? ",\n" : "\n") << "    {";
+        const char* separator = "\n";
+        if (!rule.primaryOutput.empty()) {
+            out << separator << "      \"primary-output\": ";
+            appendJsonString(out, rule.primaryOutput);
+            separator = ",\n";
+        }
+        if (!rule.provides.empty()) {
+            out << separator << "      \"provides\": [\n        {\n"
+                << "          \"is-interface\": " << (rule.isInterface ? "true" : "false") << ",\n"
+                << "          \"logical-name\": ";
+            appendJsonString(out, rule.provides);
+            out << ",\n          \"source-path\": ";
+            appendJsonString(out, rule.sourcePath.generic_string());
+            out << "\n        }\n      ]";
+            separator = ",\n";
+        }
+        if (!rule.requirements.empty()) {
+            out << separator << "      \"requires\": [";
+            for (size_t j = 0; j < rule.requirements.size(); ++j) {
+                const auto& requirement = rule.requirements[j];
+                out << (j ? ",\n" : "\n") << "        {\n          \"logical-name\": ";
+                appendJsonString(out, requirement.logicalName);
+                if (requirement.isHeaderUnit) {
+                    out << ",\n          \"lookup-method\": \""
+                        << (requirement.isAngled ? "include-angle" : "include-quote") << "\"";
+                }
+                out << "\n        }";
+            }
+            out << "\n      ]";
+            separator = ",\n";
+        }
+        out << "\n    }";
+    }
+    out << (rules.empty() ? "],\n" : "\n  ],\n") << "  \"version\": 1\n}\n";
+    return out.str();
+}
+
+} // namespace cpp20::compiler::modules
@@ -12,95 +12,89 @@ namespace cpp20::compiler::semantic {
 
 // === SymbolTable Implementation ===
 
-SymbolTable::SymbolTable() {
-    // Crear scope global
-    enterScope();
+SymbolTable::SymbolTable(frontend::lexer::IdentifierTable& identifiers)
+    : identifiers_(&identifiers) {
+    // La cadena ya trae abierto el scope global
 }
 
 void SymbolTable::enterScope() {
-    scopeStack_.push(currentScope_);
-    currentScope_ = nextScopeId_++;
+    scopes_.enter();
 }
 
 void SymbolTable::exitScope() {
-    if (!scopeStack_.empty()) {
-        currentScope_ = scopeStack_.top();
-        scopeStack_.pop();
-    }
+    scopes_.exit();
 }
 
-bool SymbolTable::addSymbol(std::unique_ptr<symbols::Symbol> symbol) {
-    if (!symbol) return false;
+const symbols::Symbol* SymbolTable::addSymbol(symbols::SymbolKind kind, std::string_view name,
+                                              const types::Type* type) {
+    // Comprobar antes de crear: un duplicado no gasta arena
+    Name interned = identifiers_->get(name);
+    if (scopes_.findInCurrent(interned)) return nullptr;
 
-    const std::string& name = symbol->name();
-    SymbolTableEntry entry(std::move(symbol), currentScope_);
+    const symbols::Symbol* symbol = arena_.create(kind, interned, type);
+    scopes_.insert(interned, symbol);
+    return symbol;
+}
 
-    // Verificar si ya existe en el mismo scope
-    auto& entries = symbolMap_[name];
-    for (const auto& existing : entries) {
-        if (existing.scopeLevel == currentScope_) {
-            return false; // Ya existe en este scope
-        }
-    }
+const symbols::VariableSymbol* SymbolTable::addVariable(std::string_view name, const types::Type* type,
+                                                        bool isConst, bool isStatic) {
+    Name interned = identifiers_->get(name);
+    if (scopes_.findInCurrent(interned)) return nullptr;
 
-    entries.push_back(std::move(entry));
-    return true;
+    const symbols::VariableSymbol* symbol = arena_.createVariable(interned, type, isConst, isStatic);
+    scopes_.insert(interned, symbol);
+    return symbol;
+}
+
+const symbols::FunctionSymbol* SymbolTable::addFunction(std::string_view name, const types::Type* returnType,
+                                                        std::span<const types::Type* const> paramTypes,
+                                                        bool isStatic) {
+    Name interned = identifiers_->get(name);
+    if (scopes_.findInCurrent(interned)) return nullptr;
+
+    const symbols::FunctionSymbol* symbol = arena_.createFunction(interned, returnType, paramTypes, isStatic);
+    scopes_.insert(interned, symbol);
+    return symbol;
 }
 
 LookupResult SymbolTable::lookup(const std::string& name, LookupMode mode) const {
-    LookupResult result;
+    // Un nombre nunca internado no puede estar en la tabla
+    return lookup(identifiers_->find(name), mode);
+}
 
-    auto it = symbolMap_.find(name);
-    if (it == symbolMap_.end()) {
+LookupResult SymbolTable::lookup(const frontend::lexer::IdentifierInfo* name, LookupMode mode) const {
+    LookupResult result;
+    if (!name) {
         return result; // No encontrado
     }
 
-    const auto& entries = it->second;
-    std::vector<uint32_t> activeScopes;
-
-    // Recopilar scopes activos según el modo
+    const symbols::Symbol* symbol = nullptr;
     switch (mode) {
-        case LookupMode::Ordinary: {
-            // Buscar desde el scope actual hacia arriba
-            uint32_t scope = currentScope_;
-            while (scope != 0) {
-                activeScopes.push_back(scope);
-                // Buscar scope padre (simplificado)
-                scope = (scope > 1) ? scope - 1 : 0;
-            }
+        case LookupMode::Ordinary:
+            // El scope más interno oculta al resto
+            symbol = scopes_.find(name);
             break;
-        }
-        case LookupMode::Qualified: {
+        case LookupMode::Qualified:
             // Solo buscar en scope global
-            activeScopes.push_back(1);
+            symbol = scopes_.findInGlobal(name);
             break;
-        }
-        case LookupMode::Template: {
-            // Buscar en todos los scopes (two-phase lookup)
-            for (uint32_t s = 1; s <= currentScope_; ++s) {
-                activeScopes.push_back(s);
-            }
+        case LookupMode::Template:
+            // Buscar en toda la cadena (two-phase lookup)
+            result.symbols = scopes_.findAll(name);
             break;
-        }
-        case LookupMode::ADL: {
+        case LookupMode::ADL:
             // Argument Dependent Lookup - buscar en namespaces asociados
-            activeScopes.push_back(currentScope_);
+            symbol = scopes_.findInCurrent(name);
             break;
-        }
     }
-
-    // Recopilar símbolos visibles
-    for (const auto& entry : entries) {
-        if (entry.isVisible &&
-            std::find(activeScopes.begin(), activeScopes.end(), entry.scopeLevel) != activeScopes.end()) {
-            result.symbols.push_back(entry.symbol.get());
-        }
+    if (symbol) {
+        result.symbols.push_back(symbol);
     }
 
     // Verificar ambigüedad
     if (result.symbols.size() > 1) {
         result.isAmbiguous = true;
-        result.errorMessage = "Nombre ambiguo: '" + name + "'";
+        result.errorMessage = "Nombre ambiguo: '" + std::string(name->name()) + "'";
     }
 
     return result;
@@ -109,43 +103,28 @@ LookupResult SymbolTable::lookup(const std::string& name, LookupMode mode) const
 LookupResult SymbolTable::lookupInScope(const std::string& name, uint32_t scopeLevel) const {
     LookupResult result;
 
-    auto it = symbolMap_.find(name);
-    if (it == symbolMap_.end()) {
+    Name interned = identifiers_->find(name);
+    if (!interned) {
         return result;
     }
 
-    const auto& entries = it->second;
-    for (const auto& entry : entries) {
-        if (entry.scopeLevel == scopeLevel && entry.isVisible) {
-            result.symbols.push_back(entry.symbol.get());
-        }
+    if (const symbols::Symbol* symbol = scopes_.findInScope(interned, scopeLevel)) {
+        result.symbols.push_back(symbol);
     }
-
     return result;
 }
 
 void SymbolTable::clear() {
-    symbolMap_.clear();
-    while (!scopeStack_.empty()) {
-        scopeStack_.pop();
-    }
-    currentScope_ = 0;
-    nextScopeId_ = 1;
-    enterScope(); // Recrear scope global
+    scopes_.clear();
+    arena_.clear();
 }
 
 SymbolTable::Stats SymbolTable::getStats() const {
     Stats stats;
-    stats.scopes = nextScopeId_;
-    stats.maxDepth = 0;
-
-    for (const auto& [name, entries] : symbolMap_) {
-        stats.totalSymbols += entries.size();
-        for (const auto& entry : entries) {
-            stats.maxDepth = std::max(stats.maxDepth, entry.scopeLevel);
-        }
-    }
-
+    stats.totalSymbols = arena_.size();
+    stats.symbolMemory = arena_.memoryUsage();
+    stats.scopes = scopes_.scopesCreated();
+    stats.maxDepth = scopes_.maxDepth();
     return stats;
 }
 
@@ -153,8 +132,10 @@ SymbolTable::Stats SymbolTable::getStats() const {
 
 ExpressionAnalyzer::ExpressionAnalyzer(diagnostics::DiagnosticEngine& diagEngine,
                                      SymbolTable& symbolTable,
-                                     TemplateSystem& templateSystem)
-    : diagEngine_(diagEngine), symbolTable_(symbolTable), templateSystem_(templateSystem) {
+                                     TemplateSystem& templateSystem,
+                                     types::TypeContext& typeContext)
+    : diagEngine_(diagEngine), symbolTable_(symbolTable), templateSystem_(templateSystem),
+      typeContext_(typeContext) {
 }
 
 std::unique_ptr<types::Type> ExpressionAnalyzer::analyzeExpression(const ast::ASTNode* expr) {
@@ -196,7 +177,7 @@ bool ExpressionAnalyzer::checkTypeCompatibility(const types::Type* source, const
     if (!source || !target) return false;
 
     // Verificar igualdad de tipos
-    return source->equals(target);
+    return types::isSameType(source, target);
 }
 
 ConversionInfo ExpressionAnalyzer::findImplicitConversion(const types::Type* source, const types::Type* target) {
@@ -204,8 +185,11 @@ ConversionInfo ExpressionAnalyzer::findImplicitConversion(const types::Type* sou
 
     if (!source || !target) return info;
 
+    source = typeContext_.getCanonicalType(source);
+    target = typeContext_.getCanonicalType(target);
+
     // Conversiones implícitas básicas simplificadas
-    if (source->equals(target)) {
+    if (source == target) {
         info.conversionSteps = {"identity"};
         info.rank = 1;
         return info;
@@ -222,7 +206,18 @@ ConversionInfo ExpressionAnalyzer::findImplicitConversion(const types::Type* sou
 OverloadResolver::OverloadResolver(diagnostics::DiagnosticEngine& diagEngine,
                                  SymbolTable& symbolTable,
                                  ExpressionAnalyzer& exprAnalyzer)
-    : diagEngine_(diagEngine), symbolTable_(symbolTable), exprAnalyzer_(exprAnalyzer) {
+    : diagEngine_(diagEngine), symbolTable_(symbolTable), exprAnalyzer_(exprAnalyzer),
+      cache_(exprAnalyzer.typeContext()) {
+}
+
+OverloadResolver::Stats OverloadResolver::getStats() const {
+    symbols::OverloadCache::Stats cache = cache_.getStats();
+    Stats stats;
+    stats.cacheHits = cache.hits;
+    stats.cacheMisses = cache.misses;
+    stats.prunedCandidates = prunedCandidates_;
+    stats.rankedCandidates = rankedCandidates_;
+    return stats;
 }
 
 const symbols::FunctionSymbol* OverloadResolver::resolveOverload(
@@ -237,7 +232,7 @@ const symbols::FunctionSymbol* OverloadResolver::resolveOverload(
 
     std::vector<const symbols::FunctionSymbol*> candidates;
     for (const auto* symbol : lookupResult.symbols) {
-        if (auto* funcSymbol = dynamic_cast<const symbols::FunctionSymbol*>(symbol)) {
+        if (const symbols::FunctionSymbol* funcSymbol = symbol->asFunction()) {
             candidates.push_back(funcSymbol);
         }
     }
@@ -246,38 +241,45 @@ const symbols::FunctionSymbol* OverloadResolver::resolveOverload(
         return nullptr;
     }
 
+    // Memorización por (conjunto de sobrecargas, tipos canónicos de los argumentos)
+    symbols::OverloadCache::Key key = cache_.makeKey(candidates, argumentTypes);
+    if (auto cached = cache_.find(key)) {
+        return *cached;
+    }
+
     // Encontrar candidatos viables
+    const symbols::FunctionSymbol* best = nullptr;
     auto viableCandidates = findViableCandidates(candidates, argumentTypes);
-    if (viableCandidates.empty()) {
-        return nullptr;
+    if (!viableCandidates.empty()) {
+        // Seleccionar el mejor candidato (simplificado)
+        std::sort(viableCandidates.begin(), viableCandidates.end());
+        best = viableCandidates.back().function;
     }
 
-    // Seleccionar el mejor candidato (simplificado)
-    std::sort(viableCandidates.begin(), viableCandidates.end());
-    return viableCandidates.back().function;
+    // También se memorizan los fallos: repetir la llamada daría el mismo error
+    cache_.store(std::move(key), best);
+    return best;
 }
 
 std::vector<OverloadResolver::OverloadCandidate> OverloadResolver::findViableCandidates(
     const std::vector<const symbols::FunctionSymbol*>& candidates,
     const std::vector<const types::Type*>& argumentTypes) {
 
-    std::vector<OverloadCandidate> viableCandidates;
+    std::vector<OverloadCandidate> result;
 
     for (const auto* func : candidates) {
-        OverloadCandidate candidate{func};
-
         const auto& paramTypes = func->paramTypes();
 
-        // Verificar número de parámetros
-        if (paramTypes.size() != argumentTypes.size()) {
-            candidate.isViable = false;
-            candidate.errorMessage = "Número incorrecto de argumentos";
-            viableCandidates.push_back(candidate);
+        // Poda: aridad y primer argumento antes de ordenar conversiones
+        if (!symbols::mayBeViable(*func, argumentTypes)) {
+            ++prunedCandidates_;
             continue;
         }
+        ++rankedCandidates_;
+
+        OverloadCandidate candidate{func};
 
         // Verificar compatibilidad de tipos
-        bool allCompatible = true;
         for (size_t i = 0; i < paramTypes.size(); ++i) {
             if (!exprAnalyzer_.checkTypeCompatibility(argumentTypes[i], paramTypes[i])) {
                 auto conversion = exprAnalyzer_.findImplicitConversion(argumentTypes[i], paramTypes[i]);
@@ -287,7 +289,6 @@ std::vector<OverloadResolver::OverloadCandidate> OverloadResolver::findViableCan
                 } else {
                     candidate.isViable = false;
                     candidate.errorMessage = "No hay conversión válida para argumento " + std::to_string(i);
-                    allCompatible = false;
                     break;
                 }
             } else {
@@ -295,18 +296,9 @@ std::vector<OverloadResolver::OverloadCandidate> OverloadResolver::findViableCan
             }
         }
 
-        if (allCompatible) {
-            candidate.isViable = true;
-        }
-
-        viableCandidates.push_back(candidate);
-    }
-
-    // Filtrar solo candidatos viables
-    std::vector<OverloadCandidate> result;
-    for (const auto& candidate : viableCandidates) {
+        // Solo se devuelven candidatos viables
         if (candidate.isViable) {
-            result.push_back(candidate);
+            result.push_back(std::move(candidate));
         }
     }
 
@@ -319,9 +311,20 @@ SemanticAnalyzer::SemanticAnalyzer(diagnostics::DiagnosticEngine& diagEngine,
                                  diagnostics::SourceManager& sourceManager)
     : diagEngine_(diagEngine),
       sourceManager_(sourceManager),
-      expressionAnalyzer_(diagEngine, symbolTable_, templateSystem_),
-      overloadResolver_(diagEngine, symbolTable_, expressionAnalyzer_),
-      templateSystem_(diagEngine) {
+      ownedTemplateSystem_(std::make_unique<TemplateSystem>(diagEngine)),
+      templateSystem_(*ownedTemplateSystem_),
+      expressionAnalyzer_(diagEngine, symbolTable_, templateSystem_, typeContext_),
+      overloadResolver_(diagEngine, symbolTable_, expressionAnalyzer_) {
+}
+
+SemanticAnalyzer::SemanticAnalyzer(diagnostics::DiagnosticEngine& diagEngine,
+                                 diagnostics::SourceManager& sourceManager,
+                                 TemplateSystem& templateSystem)
+    : diagEngine_(diagEngine),
+      sourceManager_(sourceManager),
+      templateSystem_(templateSystem),
+      expressionAnalyzer_(diagEngine, symbolTable_, templateSystem_, typeContext_),
+      overloadResolver_(diagEngine, symbolTable_, expressionAnalyzer_) {
 }
 
 SemanticAnalyzer::~SemanticAnalyzer() = default;
@@ -386,10 +389,7 @@ bool SemanticAnalyzer::analyzeFunction(const ast::ASTNode* func) {
         }
     }
 
-    auto funcSymbol = std::make_unique<symbols::FunctionSymbol>(
-        funcName, returnType.get(), paramTypes);
-
-    if (!symbolTable_.addSymbol(std::move(funcSymbol))) {
+    if (!symbolTable_.addFunction(funcName, returnType.get(), paramTypes)) {
         reportSemanticError("Error al registrar función: " + funcName, func->getLocation());
         return false;
     }
@@ -410,11 +410,8 @@ bool SemanticAnalyzer::analyzeClass(const ast::ASTNode* classDecl) {
         return false;
     }
 
-    // Crear símbolo de tipo
-    auto classSymbol = std::make_unique<symbols::Symbol>(
-        symbols::SymbolKind::Type, className, nullptr); // Tipo simplificado
-
-    if (!symbolTable_.addSymbol(std::move(classSymbol))) {
+    // Crear símbolo de tipo (tipo simplificado)
+    if (!symbolTable_.addSymbol(symbols::SymbolKind::Type, className, nullptr)) {
         reportSemanticError("Error al registrar clase: " + className, classDecl->getLocation());
         return false;
     }
@@ -474,8 +471,12 @@ SemanticAnalyzer::AnalysisStats SemanticAnalyzer::getStats() const {
 }
 
 void SemanticAnalyzer::clear() {
+    overloadResolver_.clearCache();
     symbolTable_.clear();
-    templateSystem_.clearCache();
+    // La caché de un motor compartido es de toda la compilación
+    if (ownedTemplateSystem_) {
+        templateSystem_.clearCache();
+    }
     while (!templateContextStack_.empty()) {
         templateContextStack_.pop();
     }
@@ -518,10 +519,7 @@ bool SemanticAnalyzer::analyzeVariableDeclaration(const ast::ASTNode* varDecl) {
     }
 
     // Crear símbolo de variable
-    auto varSymbol = std::make_unique<symbols::VariableSymbol>(
-        varName, varType.get());
-
-    if (!symbolTable_.addSymbol(std::move(varSymbol))) {
+    if (!symbolTable_.addVariable(varName, varType.get())) {
         reportSemanticError("Error al registrar variable: " + varName, varDecl->getLocation());
         return false;
     }
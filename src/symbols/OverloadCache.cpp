@@ -0,0 +1,104 @@
+/**
+ * @file OverloadCache.cpp
+ * @brief Poda y memorización de la resolución de sobrecargas
+ */
+
+#include <compiler/symbols/OverloadCache.h>
+#include <compiler/common/utils/HashUtils.h>
+
+namespace cpp20::compiler::symbols {
+
+// ========================================================================
+// Poda de candidatos
+// ========================================================================
+
+bool mayConvert(const types::Type* argument, const types::Type* parameter) {
+    if (!argument || !parameter) return false;
+
+    // Un parámetro referencia se compara con el tipo referido
+    if (parameter->kind() == types::Type::Kind::Reference) {
+        parameter = static_cast<const types::ReferenceType*>(parameter)->referee();
+    }
+    if (argument->kind() == types::Type::Kind::Reference) {
+        argument = static_cast<const types::ReferenceType*>(argument)->referee();
+    }
+    if (!argument || !parameter || types::isSameType(argument, parameter)) return true;
+
+    using Kind = types::Type::Kind;
+    Kind from = argument->kind();
+    Kind to = parameter->kind();
+    if (from == to) return true;
+
+    // Conversiones definidas por el usuario y tipos aún sin deducir: no podar
+    auto isOpen = [](Kind kind) {
+        return kind == Kind::Class || kind == Kind::Auto || kind == Kind::Decltype;
+    };
+    if (isOpen(from) || isOpen(to)) return true;
+
+    // Conversiones estándar entre categorías distintas
+    switch (to) {
+        case Kind::Basic: return from == Kind::Enum || from == Kind::Pointer || from == Kind::Nullptr;
+        case Kind::Pointer: return from == Kind::Nullptr || from == Kind::Array || from == Kind::Function;
+        default: return false;
+    }
+}
+
+bool mayBeViable(const FunctionSymbol& candidate, std::span<const types::Type* const> argumentTypes) {
+    auto parameters = candidate.paramTypes();
+    if (parameters.size() != argumentTypes.size()) return false;
+    return parameters.empty() || mayConvert(argumentTypes[0], parameters[0]);
+}
+
+// ========================================================================
+// OverloadCache implementation
+// ========================================================================
+
+size_t OverloadCache::KeyHash::operator()(const std::vector<const void*>& key) const {
+    size_t hash = key.size();
+    for (const void* entry : key) {
+        hash = common::utils::hashCombine(hash, common::utils::hashPointer(entry));
+    }
+    return hash;
+}
+
+OverloadCache::Key OverloadCache::makeKey(std::span<const FunctionSymbol* const> candidates,
+                                          std::span<const types::Type* const> argumentTypes) const {
+    Key key;
+    key.entries.reserve(candidates.size() + 1 + argumentTypes.size());
+    key.entries.insert(key.entries.end(), candidates.begin(), candidates.end());
+    key.entries.push_back(nullptr);
+    for (const types::Type* type : argumentTypes) {
+        const types::Type* canonical = typeContext_->getCanonicalType(type);
+        // Un tipo que el contexto no unifica no tiene identidad estable
+        key.memoizable = key.memoizable && canonical && canonical->isCanonical();
+        key.entries.push_back(canonical);
+    }
+    return key;
+}
+
+std::optional<const FunctionSymbol*> OverloadCache::find(const Key& key) {
+    if (!key.memoizable) return std::nullopt;
+
+    auto cached = entries_.find(key.entries);
+    if (cached == entries_.end()) {
+        ++misses_;
+        return std::nullopt;
+    }
+    ++hits_;
+    return cached->second;
+}
+
+void OverloadCache::store(Key&& key, const FunctionSymbol* result) {
+    if (!key.memoizable) return;
+    entries_.insert_or_assign(std::move(key.entries), result);
+}
+
+OverloadCache::Stats OverloadCache::getStats() const {
+    Stats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.entries = entries_.size();
+    return stats;
+}
+
+} // namespace cpp20::compiler::symbols
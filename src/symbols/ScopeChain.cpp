@@ -0,0 +1,159 @@
+/**
+ * @file ScopeChain.cpp
+ * @brief Cadena de scopes con tablas hash abiertas por scope
+ */
+
+#include <compiler/symbols/ScopeChain.h>
+#include <algorithm>
+
+namespace cpp20::compiler::symbols {
+
+// ========================================================================
+// Scope implementation
+// ========================================================================
+
+size_t ScopeChain::Scope::hash(Name name) {
+    // Los IdentifierInfo están alineados: mezclar para no desperdiciar los bits bajos
+    uint64_t bits = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(name));
+    bits ^= bits >> 17;
+    bits *= 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(bits >> 29);
+}
+
+const Symbol* ScopeChain::Scope::find(Name name) const {
+    if (slots.empty() || !name) return nullptr;
+
+    size_t mask = slots.size() - 1;
+    for (size_t i = hash(name) & mask;; i = (i + 1) & mask) {
+        const Slot& slot = slots[i];
+        if (slot.name == name) return slot.symbol;
+        if (!slot.name) return nullptr;
+    }
+}
+
+bool ScopeChain::Scope::insert(Name name, const Symbol* symbol) {
+    // Factor de carga máximo 3/4 para que el sondeo siempre encuentre un hueco
+    if ((used.size() + 1) * 4 > slots.size() * 3) {
+        grow();
+    }
+
+    size_t mask = slots.size() - 1;
+    size_t i = hash(name) & mask;
+    while (slots[i].name) {
+        if (slots[i].name == name) return false; // Ya existe en este scope
+        i = (i + 1) & mask;
+    }
+
+    slots[i] = Slot{name, symbol};
+    used.push_back(static_cast<uint32_t>(i));
+    return true;
+}
+
+void ScopeChain::Scope::grow() {
+    std::vector<Slot> old = std::move(slots);
+    slots.assign(old.empty() ? 8 : old.size() * 2, Slot{});
+    used.clear();
+
+    size_t mask = slots.size() - 1;
+    for (const Slot& slot : old) {
+        if (!slot.name) continue;
+        size_t i = hash(slot.name) & mask;
+        while (slots[i].name) {
+            i = (i + 1) & mask;
+        }
+        slots[i] = slot;
+        used.push_back(static_cast<uint32_t>(i));
+    }
+}
+
+void ScopeChain::Scope::reset() {
+    // Solo se tocan las entradas usadas; la capacidad se conserva para el reuso
+    for (uint32_t index : used) {
+        slots[index] = Slot{};
+    }
+    used.clear();
+    parent = nullptr;
+}
+
+// ========================================================================
+// ScopeChain implementation
+// ========================================================================
+
+ScopeChain::ScopeChain() {
+    enter(); // Scope global
+}
+
+uint32_t ScopeChain::enter() {
+    std::unique_ptr<Scope> scope;
+    if (!freeScopes_.empty()) {
+        scope = std::move(freeScopes_.back());
+        freeScopes_.pop_back();
+    } else {
+        scope = std::make_unique<Scope>();
+    }
+
+    scope->id = nextScopeId_++;
+    scope->parent = current_;
+    current_ = scope.get();
+    scopes_.push_back(std::move(scope));
+    maxDepth_ = std::max(maxDepth_, scopes_.size());
+    return current_->id;
+}
+
+bool ScopeChain::exit() {
+    if (scopes_.size() <= 1) return false;
+
+    current_ = current_->parent;
+    scopes_.back()->reset();
+    freeScopes_.push_back(std::move(scopes_.back()));
+    scopes_.pop_back();
+    return true;
+}
+
+bool ScopeChain::insert(Name name, const Symbol* symbol) {
+    if (!name || !symbol) return false;
+    return current_->insert(name, symbol);
+}
+
+const Symbol* ScopeChain::find(Name name) const {
+    // Desde el scope actual hacia fuera; el más interno oculta al resto
+    for (const Scope* scope = current_; scope; scope = scope->parent) {
+        if (const Symbol* symbol = scope->find(name)) {
+            return symbol;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<const Symbol*> ScopeChain::findAll(Name name) const {
+    std::vector<const Symbol*> result;
+    for (const Scope* scope = current_; scope; scope = scope->parent) {
+        if (const Symbol* symbol = scope->find(name)) {
+            result.push_back(symbol);
+        }
+    }
+    return result;
+}
+
+const Symbol* ScopeChain::findInScope(Name name, uint32_t scopeId) const {
+    for (const Scope* scope = current_; scope; scope = scope->parent) {
+        if (scope->id == scopeId) {
+            return scope->find(name);
+        }
+    }
+    return nullptr;
+}
+
+void ScopeChain::clear() {
+    while (!scopes_.empty()) {
+        scopes_.back()->reset();
+        freeScopes_.push_back(std::move(scopes_.back()));
+        scopes_.pop_back();
+    }
+    current_ = nullptr;
+    nextScopeId_ = 1;
+    maxDepth_ = 0;
+    enter(); // Recrear scope global
+}
+
+} // namespace cpp20::compiler::symbols
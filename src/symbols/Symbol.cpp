@@ -4,6 +4,8 @@
  */
 
 #include <compiler/symbols/Symbol.h>
+#include <compiler/frontend/lexer/IdentifierTable.h>
+#include <algorithm>
 
 namespace cpp20::compiler::symbols {
 
@@ -11,57 +13,101 @@ namespace cpp20::compiler::symbols {
 // Symbol implementation
 // ========================================================================
 
-Symbol::Symbol(SymbolKind kind, std::string name, const types::Type* type)
-    : kind_(kind), name_(std::move(name)), type_(type) {}
+Symbol::Symbol(SymbolKind kind, Name name, const types::Type* type)
+    : name_(name), type_(type), kind_(kind) {}
 
-Symbol::~Symbol() = default;
+std::string_view Symbol::name() const {
+    return name_ ? name_->name() : std::string_view();
+}
+
+const VariableSymbol* Symbol::asVariable() const {
+    return kind_ == SymbolKind::Variable ? static_cast<const VariableSymbol*>(this) : nullptr;
+}
+
+const FunctionSymbol* Symbol::asFunction() const {
+    return kind_ == SymbolKind::Function ? static_cast<const FunctionSymbol*>(this) : nullptr;
+}
 
 std::string Symbol::toString() const {
     std::string result;
+    if (flags_ & Static) result += "static ";
+    if (flags_ & Const) result += "const ";
     switch (kind_) {
-        case SymbolKind::Variable: result = "variable"; break;
-        case SymbolKind::Function: result = "function"; break;
-        case SymbolKind::Type: result = "type"; break;
-        case SymbolKind::Namespace: result = "namespace"; break;
+        case SymbolKind::Variable: result += "variable"; break;
+        case SymbolKind::Function: result += "function"; break;
+        case SymbolKind::Type: result += "type"; break;
+        case SymbolKind::Namespace: result += "namespace"; break;
+    }
+    result += ' ';
+    result += name();
+
+    if (const FunctionSymbol* function = asFunction()) {
+        result += '(';
+        std::span<const types::Type* const> parameters = function->paramTypes();
+        for (size_t i = 0; i < parameters.size(); ++i) {
+            if (i > 0) result += ", ";
+            result += parameters[i]->toString();
+        }
+        result += ')';
     }
-    result += " " + name_;
     return result;
 }
 
 // ========================================================================
-// VariableSymbol implementation
+// FunctionSymbol implementation
 // ========================================================================
 
-VariableSymbol::VariableSymbol(std::string name, const types::Type* type,
-                             bool isConst, bool isStatic)
-    : Symbol(SymbolKind::Variable, std::move(name), type),
-      isConst_(isConst), isStatic_(isStatic) {}
-
-std::string VariableSymbol::toString() const {
-    std::string result = Symbol::toString();
-    if (isConst_) result = "const " + result;
-    if (isStatic_) result = "static " + result;
-    return result;
+std::span<const types::Type* const> FunctionSymbol::paramTypes() const {
+    return arena_ ? arena_->parameters_[payload_] : std::span<const types::Type* const>();
 }
 
 // ========================================================================
-// FunctionSymbol implementation
+// SymbolArena implementation
 // ========================================================================
 
-FunctionSymbol::FunctionSymbol(std::string name, const types::Type* returnType,
-                             std::vector<const types::Type*> paramTypes,
-                             bool isStatic)
-    : Symbol(SymbolKind::Function, std::move(name), returnType),
-      paramTypes_(std::move(paramTypes)), isStatic_(isStatic) {}
-
-std::string FunctionSymbol::toString() const {
-    std::string result = Symbol::toString() + "(";
-    for (size_t i = 0; i < paramTypes_.size(); ++i) {
-        if (i > 0) result += ", ";
-        result += paramTypes_[i]->toString();
+SymbolArena::SymbolArena() : pool_(64 * 1024) {}
+
+template<typename T>
+T* SymbolArena::place(SymbolKind kind, Symbol::Name name, const types::Type* type) {
+    T* symbol = pool_.create<T>(kind, name, type);
+    symbol->arena_ = this;
+    symbol->id_ = static_cast<uint32_t>(symbols_.size() + 1);
+    symbols_.push_back(symbol);
+    return symbol;
+}
+
+const Symbol* SymbolArena::create(SymbolKind kind, Symbol::Name name, const types::Type* type) {
+    return place<Symbol>(kind, name, type);
+}
+
+const VariableSymbol* SymbolArena::createVariable(Symbol::Name name, const types::Type* type,
+                                                  bool isConst, bool isStatic) {
+    VariableSymbol* symbol = place<VariableSymbol>(SymbolKind::Variable, name, type);
+    symbol->flags_ = (isConst ? Symbol::Const : 0) | (isStatic ? Symbol::Static : 0);
+    return symbol;
+}
+
+const FunctionSymbol* SymbolArena::createFunction(Symbol::Name name, const types::Type* returnType,
+                                                  std::span<const types::Type* const> paramTypes,
+                                                  bool isStatic) {
+    FunctionSymbol* symbol = place<FunctionSymbol>(SymbolKind::Function, name, returnType);
+    symbol->flags_ = isStatic ? Symbol::Static : 0;
+
+    const types::Type** parameters = nullptr;
+    if (!paramTypes.empty()) {
+        parameters = static_cast<const types::Type**>(
+            pool_.allocate(paramTypes.size() * sizeof(const types::Type*), alignof(const types::Type*)));
+        std::copy(paramTypes.begin(), paramTypes.end(), parameters);
     }
-    result += ")";
-    return result;
+    symbol->payload_ = static_cast<uint32_t>(parameters_.size());
+    parameters_.emplace_back(parameters, paramTypes.size());
+    return symbol;
+}
+
+void SymbolArena::clear() {
+    symbols_.clear();
+    parameters_.clear();
+    pool_.reset();
 }
 
 } // namespace cpp20::compiler::symbols
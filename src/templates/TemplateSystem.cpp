@@ -4,7 +4,13 @@
  */
 
 #include <compiler/templates/TemplateSystem.h>
+#include <compiler/ast/DeclarationAST.h>
+#include <compiler/common/TimingProfiler.h>
+#include <compiler/common/utils/HashUtils.h>
+#include <compiler/common/utils/ThreadPool.h>
 #include <algorithm>
+#include <cctype>
+#include <iterator>
 
 namespace cpp20::compiler::semantic {
 
@@ -12,13 +18,78 @@ namespace cpp20::compiler::semantic {
 // ConstraintSolver - Implementación
 // ============================================================================
 
+namespace {
+
+// Límite de cláusulas al normalizar; por encima la subsumption es false
+constexpr size_t MaxNormalFormClauses = 256;
+
+bool clausesIntersect(const std::vector<uint32_t>& left, const std::vector<uint32_t>& right) {
+    auto l = left.begin();
+    auto r = right.begin();
+    while (l != left.end() && r != right.end()) {
+        if (*l == *r) return true;
+        if (*l < *r) ++l; else ++r;
+    }
+    return false;
+}
+
+} // namespace
+
+size_t ConstraintSolver::KeyHash::operator()(const SatisfactionKey& key) const {
+    return common::utils::hashCombine(std::hash<std::string>()(key.conceptName),
+                                      common::utils::hashPointer(key.typeId));
+}
+
+size_t ConstraintSolver::KeyHash::operator()(const EvaluationKey& key) const {
+    size_t hash = common::utils::hashPointer(key.constraint);
+    for (const auto& [name, value] : key.bindings) {
+        hash = common::utils::hashCombine(hash, std::hash<std::string>()(name));
+        hash = common::utils::hashCombine(hash, std::hash<std::string>()(value));
+    }
+    return hash;
+}
+
+size_t ConstraintSolver::KeyHash::operator()(const SubsumptionKey& key) const {
+    return common::utils::hashCombine(common::utils::hashPointer(key.derived),
+                                      common::utils::hashPointer(key.base));
+}
+
 ConstraintSolver::ConstraintSolver(diagnostics::DiagnosticEngine& diagEngine)
     : diagEngine_(diagEngine) {
 }
 
 ConstraintEvaluationResult ConstraintSolver::evaluateConstraint(
     const ast::ConstraintExpression* constraint,
-    const std::unordered_map<std::string, std::string>& bindings) {
+    const Bindings& bindings) {
+
+    if (!constraint) {
+        return ConstraintEvaluationResult(ConstraintSatisfaction::Error);
+    }
+
+    // Los bindings se ordenan para que el orden del mapa no afecte a la clave
+    EvaluationKey key{constraint, {bindings.begin(), bindings.end()}};
+    std::sort(key.bindings.begin(), key.bindings.end());
+
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        auto it = evaluationCache_.find(key);
+        if (it != evaluationCache_.end()) {
+            ++cacheStats_.evaluationHits;
+            return it->second;
+        }
+        ++cacheStats_.evaluationMisses;
+    }
+
+    ConstraintEvaluationResult result = evaluateConstraintUncached(constraint, bindings);
+
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    evaluationCache_.emplace(std::move(key), result);
+    return result;
+}
+
+ConstraintEvaluationResult ConstraintSolver::evaluateConstraintUncached(
+    const ast::ConstraintExpression* constraint,
+    const Bindings& bindings) {
 
     if (!constraint) {
         return ConstraintEvaluationResult(ConstraintSatisfaction::Error);
@@ -49,7 +120,60 @@ ConstraintEvaluationResult ConstraintSolver::evaluateConstraint(
 ConstraintEvaluationResult ConstraintSolver::checkConceptSatisfaction(
     const std::string& conceptName,
     const std::string& typeName,
-    const std::unordered_map<std::string, std::string>& bindings) {
+    const Bindings& bindings) {
+
+    // El resultado depende solo de (concept, tipo); los bindings no entran en la clave
+    (void)bindings;
+    const void* typeId;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        typeId = &*typeNames_.insert(typeName).first;
+    }
+    return cachedConceptSatisfaction(conceptName, typeId, typeName);
+}
+
+ConstraintEvaluationResult ConstraintSolver::checkConceptSatisfaction(
+    const std::string& conceptName,
+    const types::Type* type,
+    const Bindings& bindings) {
+
+    if (!type) {
+        ConstraintEvaluationResult result(ConstraintSatisfaction::Error);
+        result.errorMessage = "Tipo nulo en concept '" + conceptName + "'";
+        return result;
+    }
+    if (!type->isCanonical()) {
+        return checkConceptSatisfaction(conceptName, type->toString(), bindings);
+    }
+    return cachedConceptSatisfaction(conceptName, type, type->toString());
+}
+
+ConstraintEvaluationResult ConstraintSolver::cachedConceptSatisfaction(
+    const std::string& conceptName,
+    const void* typeId,
+    const std::string& typeName) {
+
+    SatisfactionKey key{conceptName, typeId};
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        auto it = satisfactionCache_.find(key);
+        if (it != satisfactionCache_.end()) {
+            ++cacheStats_.satisfactionHits;
+            return it->second;
+        }
+        ++cacheStats_.satisfactionMisses;
+    }
+
+    ConstraintEvaluationResult result = evaluateConceptSatisfaction(conceptName, typeName);
+
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    satisfactionCache_.emplace(std::move(key), result);
+    return result;
+}
+
+ConstraintEvaluationResult ConstraintSolver::evaluateConceptSatisfaction(
+    const std::string& conceptName,
+    const std::string& typeName) {
 
     // Implementación simplificada - en un compilador real esto sería mucho más complejo
     ConstraintEvaluationResult result;
@@ -82,21 +206,129 @@ ConstraintEvaluationResult ConstraintSolver::checkConceptSatisfaction(
 
 bool ConstraintSolver::checkSubsumption(const ast::ConstraintExpression* derived,
                                        const ast::ConstraintExpression* base) {
-    // Implementación simplificada de subsumption
     if (!derived || !base) return false;
 
-    // Para esta implementación simplificada, asumimos que constraints idénticos se subsumen
-    if (derived->getConstraintType() == base->getConstraintType()) {
-        return true;
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    SubsumptionKey key{derived, base};
+    auto it = subsumptionCache_.find(key);
+    if (it != subsumptionCache_.end()) {
+        ++cacheStats_.subsumptionHits;
+        return it->second;
+    }
+    ++cacheStats_.subsumptionMisses;
+
+    const NormalForm& derivedForm = normalize(derived);
+    const NormalForm& baseForm = normalize(base);
+
+    bool subsumes = !derivedForm.overflow && !baseForm.overflow;
+    for (size_t i = 0; subsumes && i < derivedForm.disjunctive.size(); ++i) {
+        for (const auto& conjunct : baseForm.conjunctive) {
+            if (!clausesIntersect(derivedForm.disjunctive[i], conjunct)) {
+                subsumes = false;
+                break;
+            }
+        }
     }
 
-    return false;
+    subsumptionCache_.emplace(key, subsumes);
+    return subsumes;
+}
+
+void ConstraintSolver::clearCache() {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    satisfactionCache_.clear();
+    evaluationCache_.clear();
+    subsumptionCache_.clear();
+    normalForms_.clear();
+    atomIds_.clear();
+    typeNames_.clear();
+}
+
+ConstraintSolver::CacheStats ConstraintSolver::getCacheStats() const {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    return cacheStats_;
+}
+
+const ConstraintSolver::NormalForm& ConstraintSolver::normalize(const ast::ASTNode* constraint) {
+    auto it = normalForms_.find(constraint);
+    if (it != normalForms_.end()) {
+        return it->second;
+    }
+
+    NormalForm form;
+    const ast::ConstraintExpression* expression = ast::ConstraintExpression::dynCast(constraint);
+    using ConstraintType = ast::ConstraintExpression::ConstraintType;
+
+    auto isBinary = [](ConstraintType type) {
+        return type == ConstraintType::Conjunction || type == ConstraintType::LogicalAnd ||
+               type == ConstraintType::Disjunction || type == ConstraintType::LogicalOr;
+    };
+
+    if (expression && isBinary(expression->getConstraintType())) {
+        // Las referencias a elementos de normalForms_ sobreviven a las inserciones
+        const NormalForm& left = normalize(expression->getLeft());
+        const NormalForm& right = normalize(expression->getRight());
+        bool isAnd = expression->getConstraintType() == ConstraintType::Conjunction ||
+                     expression->getConstraintType() == ConstraintType::LogicalAnd;
+
+        form.overflow = left.overflow || right.overflow;
+        Clauses& product = isAnd ? form.disjunctive : form.conjunctive;
+        Clauses& joined = isAnd ? form.conjunctive : form.disjunctive;
+        const Clauses& leftProduct = isAnd ? left.disjunctive : left.conjunctive;
+        const Clauses& rightProduct = isAnd ? right.disjunctive : right.conjunctive;
+
+        if (!form.overflow && !combineClauses(leftProduct, rightProduct, product)) {
+            form.overflow = true;
+        }
+        joined = isAnd ? left.conjunctive : left.disjunctive;
+        const Clauses& rightJoined = isAnd ? right.conjunctive : right.disjunctive;
+        joined.insert(joined.end(), rightJoined.begin(), rightJoined.end());
+        if (joined.size() > MaxNormalFormClauses) {
+            form.overflow = true;
+        }
+    } else {
+        // Átomo: Concept<T> o cualquier otra expresión, incluida una negación
+        std::string atom;
+        if (expression && expression->getConstraintType() == ConstraintType::Atomic) {
+            atom = expression->getLeft() ? expression->getLeft()->toString() : "<null>";
+        } else {
+            atom = constraint ? constraint->toString() : "<null>";
+        }
+        uint32_t id = atomId(atom);
+        form.disjunctive = {{id}};
+        form.conjunctive = {{id}};
+    }
+
+    return normalForms_.emplace(constraint, std::move(form)).first->second;
+}
+
+uint32_t ConstraintSolver::atomId(const std::string& atom) {
+    return atomIds_.emplace(atom, static_cast<uint32_t>(atomIds_.size())).first->second;
+}
+
+bool ConstraintSolver::combineClauses(const Clauses& left, const Clauses& right, Clauses& result) {
+    if (left.size() * right.size() > MaxNormalFormClauses) {
+        return false;
+    }
+
+    result.clear();
+    result.reserve(left.size() * right.size());
+    for (const auto& l : left) {
+        for (const auto& r : right) {
+            std::vector<uint32_t> clause;
+            clause.reserve(l.size() + r.size());
+            std::set_union(l.begin(), l.end(), r.begin(), r.end(), std::back_inserter(clause));
+            result.push_back(std::move(clause));
+        }
+    }
+    return true;
 }
 
 ConstraintEvaluationResult ConstraintSolver::evaluateAtomicConstraint(
     const ast::ASTNode* atomic,
-    const std::unordered_map<std::string, std::string>& bindings) {
+    const Bindings& bindings) {
 
+    (void)bindings;
     ConstraintEvaluationResult result;
 
     // Implementación simplificada para constraints atómicos
@@ -113,46 +345,170 @@ ConstraintEvaluationResult ConstraintSolver::evaluateAtomicConstraint(
 
 ConstraintEvaluationResult ConstraintSolver::evaluateConjunction(
     const ast::ConstraintExpression* constraint,
-    const std::unordered_map<std::string, std::string>& bindings) {
+    const Bindings& bindings) {
 
     // Evaluar izquierda
-    auto leftResult = evaluateConstraint(
-        dynamic_cast<const ast::ConstraintExpression*>(constraint->getLeft()), bindings);
+    auto leftResult = evaluateConstraintUncached(
+        ast::ConstraintExpression::dynCast(constraint->getLeft()), bindings);
 
     if (leftResult.satisfaction != ConstraintSatisfaction::Satisfied) {
         return leftResult;
     }
 
     // Evaluar derecha
-    auto rightResult = evaluateConstraint(
-        dynamic_cast<const ast::ConstraintExpression*>(constraint->getRight()), bindings);
+    auto rightResult = evaluateConstraintUncached(
+        ast::ConstraintExpression::dynCast(constraint->getRight()), bindings);
 
     return rightResult;
 }
 
 ConstraintEvaluationResult ConstraintSolver::evaluateDisjunction(
     const ast::ConstraintExpression* constraint,
-    const std::unordered_map<std::string, std::string>& bindings) {
+    const Bindings& bindings) {
 
     // Evaluar izquierda
-    auto leftResult = evaluateConstraint(
-        dynamic_cast<const ast::ConstraintExpression*>(constraint->getLeft()), bindings);
+    auto leftResult = evaluateConstraintUncached(
+        ast::ConstraintExpression::dynCast(constraint->getLeft()), bindings);
 
     if (leftResult.satisfaction == ConstraintSatisfaction::Satisfied) {
         return leftResult;
     }
 
     // Evaluar derecha
-    auto rightResult = evaluateConstraint(
-        dynamic_cast<const ast::ConstraintExpression*>(constraint->getRight()), bindings);
+    auto rightResult = evaluateConstraintUncached(
+        ast::ConstraintExpression::dynCast(constraint->getRight()), bindings);
 
     return rightResult;
 }
 
+ConstraintEvaluationResult ConstraintSolver::evaluateNegation(
+    const ast::ConstraintExpression* constraint,
+    const Bindings& bindings) {
+
+    auto operandResult = evaluateConstraintUncached(
+        ast::ConstraintExpression::dynCast(constraint->getLeft()), bindings);
+
+    switch (operandResult.satisfaction) {
+        case ConstraintSatisfaction::Satisfied:
+            operandResult.satisfaction = ConstraintSatisfaction::NotSatisfied;
+            operandResult.errorMessage = "Negación de constraint satisfecha";
+            break;
+        case ConstraintSatisfaction::NotSatisfied:
+            operandResult.satisfaction = ConstraintSatisfaction::Satisfied;
+            operandResult.errorMessage.clear();
+            break;
+        case ConstraintSatisfaction::Error:
+            break;
+    }
+
+    return operandResult;
+}
+
 // ============================================================================
 // TemplateInstantiationEngine - Implementación
 // ============================================================================
 
+namespace {
+
+bool isTypeWordChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == ':';
+}
+
+// Palabras (con su cualificación ::) y signos sueltos; los espacios se descartan
+std::vector<std::string> splitTypeSpelling(std::string_view spelling) {
+    std::vector<std::string> tokens;
+    for (size_t i = 0; i < spelling.size();) {
+        char c = spelling[i];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            ++i;
+        } else if (isTypeWordChar(c)) {
+            size_t start = i;
+            while (i < spelling.size() && isTypeWordChar(spelling[i])) ++i;
+            tokens.emplace_back(spelling.substr(start, i - start));
+        } else {
+            tokens.emplace_back(1, c);
+            ++i;
+        }
+    }
+    return tokens;
+}
+
+std::string joinTypeTokens(std::vector<std::string>::const_iterator first,
+                           std::vector<std::string>::const_iterator last) {
+    std::string result;
+    for (auto it = first; it != last; ++it) {
+        if (!result.empty() && isTypeWordChar(result.back()) && isTypeWordChar(it->front())) {
+            result += ' ';
+        }
+        result += *it;
+    }
+    return result;
+}
+
+// Tipo tal como participa en la deducción: sin referencia ni const/volatile de nivel superior
+std::vector<std::string> adjustedTypeTokens(std::string_view spelling) {
+    std::vector<std::string> tokens = splitTypeSpelling(spelling);
+    while (!tokens.empty() && tokens.back() == "&") tokens.pop_back();
+    auto isQualifier = [](const std::string& token) { return token == "const" || token == "volatile"; };
+    while (!tokens.empty() && isQualifier(tokens.back())) tokens.pop_back();
+    // "const T" pero no "const T*": ahí el const es del apuntado
+    bool pointer = std::find(tokens.begin(), tokens.end(), "*") != tokens.end();
+    while (!pointer && !tokens.empty() && isQualifier(tokens.front())) tokens.erase(tokens.begin());
+    return tokens;
+}
+
+const ast::FunctionDecl* functionOf(const ast::ASTNode* definition) {
+    if (definition && definition->getKind() == ast::ASTNodeKind::TemplateDecl) {
+        definition = static_cast<const ast::TemplateDeclaration*>(definition)->getDeclaration();
+    }
+    if (definition && definition->getKind() == ast::ASTNodeKind::FunctionDecl) {
+        return static_cast<const ast::FunctionDecl*>(definition);
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Emparejar un patrón de parámetro con el tipo de su argumento
+ *
+ * Un parámetro del template en el patrón absorbe los tokens del argumento
+ * hasta el siguiente token del patrón al mismo nivel de <> y (); los demás
+ * tokens deben coincidir literalmente.
+ */
+bool matchTypePattern(const std::vector<std::string>& pattern, const std::vector<std::string>& argument,
+                      const std::unordered_map<std::string, size_t>& parameterIndex,
+                      std::vector<std::string>& deduced) {
+    size_t a = 0;
+    for (size_t p = 0; p < pattern.size(); ++p) {
+        auto parameter = parameterIndex.find(pattern[p]);
+        if (parameter == parameterIndex.end()) {
+            if (a >= argument.size() || argument[a] != pattern[p]) return false;
+            ++a;
+            continue;
+        }
+        size_t start = a;
+        int depth = 0;
+        bool last = p + 1 == pattern.size();
+        while (a < argument.size()) {
+            const std::string& token = argument[a];
+            if (depth == 0 && !last && token == pattern[p + 1]) break;
+            if (token == "<" || token == "(") ++depth;
+            if (token == ">" || token == ")") {
+                if (depth == 0) break;
+                --depth;
+            }
+            ++a;
+        }
+        if (a == start) return false;
+        std::string value = joinTypeTokens(argument.begin() + start, argument.begin() + a);
+        std::string& slot = deduced[parameter->second];
+        if (!slot.empty() && slot != value) return false;
+        slot = std::move(value);
+    }
+    return a == argument.size();
+}
+
+} // namespace
+
 TemplateInstantiationEngine::TemplateInstantiationEngine(diagnostics::DiagnosticEngine& diagEngine,
                                                        ConstraintSolver& constraintSolver)
     : diagEngine_(diagEngine), constraintSolver_(constraintSolver) {
@@ -160,6 +516,19 @@ TemplateInstantiationEngine::TemplateInstantiationEngine(diagnostics::Diagnostic
 
 void TemplateInstantiationEngine::registerTemplate(std::unique_ptr<TemplateInfo> templateInfo) {
     if (templateInfo) {
+        // Primera fase: lo que no depende de los parámetros se liga ahora, para todas las instancias
+        ast::TemplateNameUses uses = ast::collectTemplateNameUses(templateInfo->definition,
+                                                                  templateInfo->parameters);
+        for (std::string_view name : uses.nonDependent) {
+            const symbols::Symbol* symbol = nullptr;
+            if (nameLookup_) {
+                symbol = nameLookup_(std::string(name), {});
+                ++stats_.namesBoundAtDefinition;
+            }
+            templateInfo->boundNames.emplace(name, symbol);
+        }
+        templateInfo->dependentNames.assign(uses.dependent.begin(), uses.dependent.end());
+
         templates_[templateInfo->name] = std::move(templateInfo);
         ++stats_.templatesRegistered;
     }
@@ -169,8 +538,6 @@ std::unique_ptr<TemplateInstance> TemplateInstantiationEngine::instantiateTempla
     const std::string& templateName,
     const std::vector<std::string>& arguments) {
 
-    auto instance = std::make_unique<TemplateInstance>(templateName, arguments);
-
     // Verificar si ya está en cache
     std::string cacheKey = generateCacheKey(templateName, arguments);
     auto it = instanceCache_.find(cacheKey);
@@ -182,17 +549,41 @@ std::unique_ptr<TemplateInstance> TemplateInstantiationEngine::instantiateTempla
         result->instantiatedCode = nullptr; // No copiar el AST, será regenerado si es necesario
         result->isValid = cached->isValid;
         result->errorMessage = cached->errorMessage;
+        result->dependentBindings = cached->dependentBindings;
         return result;
     }
 
     ++stats_.cacheMisses;
 
+    auto instance = buildInstance(templateName, arguments);
+    stats_.dependentLookups += instance->dependentBindings.size();
+    if (!instance->isValid) {
+        ++stats_.errors;
+        return instance;
+    }
+
+    cacheInstance(cacheKey, *instance);
+    ++stats_.instancesCreated;
+
+    return instance;
+}
+
+std::unique_ptr<TemplateInstance> TemplateInstantiationEngine::buildInstance(
+    const std::string& templateName,
+    const std::vector<std::string>& arguments) {
+
+    // Cada instanciación es un ámbito de la traza con la plantilla como atributo
+    TimingProfiler* profiler = TimingProfiler::active();
+    AutoTimer timer(profiler, CompilationPhase::TemplateInstantiation,
+                    profiler ? generateCacheKey(templateName, arguments) : std::string());
+
+    auto instance = std::make_unique<TemplateInstance>(templateName, arguments);
+
     // Obtener información del template
     const TemplateInfo* templateInfo = getTemplateInfo(templateName);
     if (!templateInfo) {
         instance->isValid = false;
         instance->errorMessage = "Template '" + templateName + "' no encontrado";
-        ++stats_.errors;
         return instance;
     }
 
@@ -201,7 +592,6 @@ std::unique_ptr<TemplateInstance> TemplateInstantiationEngine::instantiateTempla
     if (!validateTemplateArguments(templateInfo, arguments, validationError)) {
         instance->isValid = false;
         instance->errorMessage = validationError;
-        ++stats_.errors;
         return instance;
     }
 
@@ -210,29 +600,97 @@ std::unique_ptr<TemplateInstance> TemplateInstantiationEngine::instantiateTempla
     if (!checkConstraints(templateInfo, arguments, constraintError)) {
         instance->isValid = false;
         instance->errorMessage = constraintError;
-        ++stats_.errors;
         return instance;
     }
 
+    // Segunda fase: solo los nombres que dependen de los argumentos
+    if (nameLookup_) {
+        for (const std::string& name : templateInfo->dependentNames) {
+            instance->dependentBindings.emplace(name, nameLookup_(name, arguments));
+        }
+    }
+
     // Crear mapeo de parámetros
     std::unordered_map<std::string, std::string> parameterMap;
     const auto& params = templateInfo->parameters->getParameters();
     for (size_t i = 0; i < params.size() && i < arguments.size(); ++i) {
-        parameterMap[params[i]->getName()] = arguments[i];
+        parameterMap[std::string(params[i]->getName())] = arguments[i];
     }
 
     // Sustituir parámetros en el AST
-    instance->instantiatedCode = substituteParameters(templateInfo->definition.get(), parameterMap);
+    instance->instantiatedCode = substituteParameters(templateInfo->definition, parameterMap);
+    return instance;
+}
 
+void TemplateInstantiationEngine::cacheInstance(const std::string& cacheKey,
+                                                const TemplateInstance& instance) {
     // Cachear la instancia (crear una nueva en lugar de copiar)
-    auto cachedInstance = std::make_unique<TemplateInstance>(instance->templateName, instance->arguments);
+    auto cachedInstance = std::make_unique<TemplateInstance>(instance.templateName, instance.arguments);
     cachedInstance->instantiatedCode = nullptr; // No cachear el AST por simplicidad
-    cachedInstance->isValid = instance->isValid;
-    cachedInstance->errorMessage = instance->errorMessage;
+    cachedInstance->isValid = instance.isValid;
+    cachedInstance->errorMessage = instance.errorMessage;
+    cachedInstance->dependentBindings = instance.dependentBindings;
     instanceCache_[cacheKey] = std::move(cachedInstance);
-    ++stats_.instancesCreated;
+}
 
-    return instance;
+bool TemplateInstantiationEngine::requestInstantiation(
+    const std::string& templateName,
+    const std::vector<std::string>& arguments,
+    const diagnostics::SourceLocation& pointOfInstantiation) {
+
+    ++stats_.deferredRequests;
+
+    // La caché deduplica: instanciada o ya en la lista, no se vuelve a encolar
+    std::string cacheKey = generateCacheKey(templateName, arguments);
+    if (instanceCache_.count(cacheKey) || !pendingKeys_.insert(cacheKey).second) {
+        ++stats_.deferredDuplicates;
+        return false;
+    }
+
+    worklist_.push_back({std::move(cacheKey), templateName, arguments, pointOfInstantiation});
+    return true;
+}
+
+size_t TemplateInstantiationEngine::performPendingInstantiations(size_t jobs) {
+    size_t instantiated = 0;
+
+    // Por oleadas: lo que se anote mientras tanto entra en la siguiente
+    while (!worklist_.empty()) {
+        std::vector<PendingInstantiation> wave = std::move(worklist_);
+        worklist_.clear();
+
+        std::vector<std::unique_ptr<TemplateInstance>> results(wave.size());
+        common::utils::parallelFor(wave.size(), jobs, [&](size_t i) {
+            results[i] = buildInstance(wave[i].templateName, wave[i].arguments);
+        });
+
+        // Caché, estadísticas y diagnósticos en orden de anotación
+        for (size_t i = 0; i < wave.size(); ++i) {
+            pendingKeys_.erase(wave[i].cacheKey);
+            ++stats_.cacheMisses;
+            stats_.dependentLookups += results[i]->dependentBindings.size();
+
+            if (!results[i]->isValid) {
+                ++stats_.errors;
+                diagEngine_.reportError(diagnostics::DiagnosticCode::ERR_TPL_INVALID_ARGUMENTS,
+                                        wave[i].pointOfInstantiation, results[i]->errorMessage);
+                continue;
+            }
+
+            cacheInstance(wave[i].cacheKey, *results[i]);
+            ++stats_.instancesCreated;
+            ++instantiated;
+        }
+    }
+
+    return instantiated;
+}
+
+const TemplateInstance* TemplateInstantiationEngine::findInstance(
+    const std::string& templateName,
+    const std::vector<std::string>& arguments) const {
+    auto it = instanceCache_.find(generateCacheKey(templateName, arguments));
+    return it != instanceCache_.end() ? it->second.get() : nullptr;
 }
 
 bool TemplateInstantiationEngine::canInstantiateTemplate(const std::string& templateName,
@@ -262,6 +720,112 @@ const TemplateInfo* TemplateInstantiationEngine::getTemplateInfo(const std::stri
 
 void TemplateInstantiationEngine::clearCache() {
     instanceCache_.clear();
+    worklist_.clear();
+    pendingKeys_.clear();
+    deductionCache_.clear();
+}
+
+DeductionResult TemplateInstantiationEngine::deduceTemplateArguments(
+    const std::string& templateName,
+    const std::vector<std::string>& explicitArguments,
+    const std::vector<std::string>& argumentTypes) {
+
+    const TemplateInfo* templateInfo = getTemplateInfo(templateName);
+    if (!templateInfo || !templateInfo->parameters) {
+        DeductionResult result;
+        result.errorMessage = "Template '" + templateName + "' no encontrado";
+        return result;
+    }
+
+    // La clave usa la grafía canónica: "const int &" y "const int&" comparten entrada
+    std::string key = generateCacheKey(templateName, explicitArguments);
+    key += '(';
+    for (const std::string& type : argumentTypes) {
+        std::vector<std::string> tokens = splitTypeSpelling(type);
+        key += joinTypeTokens(tokens.begin(), tokens.end());
+        key += ',';
+    }
+    key += ')';
+    auto cached = deductionCache_.find(key);
+    if (cached != deductionCache_.end()) {
+        ++stats_.deductionCacheHits;
+        return cached->second;
+    }
+
+    ++stats_.deductionsRun;
+    DeductionResult result = runDeduction(*templateInfo, explicitArguments, argumentTypes);
+    return deductionCache_.emplace(std::move(key), std::move(result)).first->second;
+}
+
+DeductionResult TemplateInstantiationEngine::runDeduction(
+    const TemplateInfo& templateInfo,
+    const std::vector<std::string>& explicitArguments,
+    const std::vector<std::string>& argumentTypes) {
+
+    DeductionResult result;
+    const auto& params = templateInfo.parameters->getParameters();
+    const ast::FunctionDecl* function = functionOf(templateInfo.definition);
+    if (!function) {
+        result.errorMessage = "'" + templateInfo.name + "' no es un template de función";
+        return result;
+    }
+    if (explicitArguments.size() > params.size()) {
+        result.errorMessage = "Demasiados argumentos explícitos para '" + templateInfo.name + "'";
+        return result;
+    }
+    auto functionParams = function->getParameters();
+    if (argumentTypes.size() != functionParams.size()) {
+        result.errorMessage = "Número incorrecto de argumentos en la llamada a '" + templateInfo.name + "'";
+        return result;
+    }
+
+    std::unordered_map<std::string, size_t> parameterIndex;
+    for (size_t i = 0; i < params.size(); ++i) {
+        parameterIndex.emplace(std::string(params[i]->getName()), i);
+    }
+    std::vector<std::string> deduced(params.size());
+    for (size_t i = 0; i < explicitArguments.size(); ++i) {
+        deduced[i] = explicitArguments[i];
+    }
+
+    bool fastPath = true;
+    for (size_t i = 0; i < functionParams.size(); ++i) {
+        std::vector<std::string> pattern = adjustedTypeTokens(functionParams[i]->getTypeName());
+        std::vector<std::string> argument = adjustedTypeTokens(argumentTypes[i]);
+
+        // T, const T&, T&&: el argumento ajustado es directamente T
+        auto parameter = pattern.size() == 1 ? parameterIndex.find(pattern[0]) : parameterIndex.end();
+        if (parameter != parameterIndex.end()) {
+            std::string value = joinTypeTokens(argument.begin(), argument.end());
+            std::string& slot = deduced[parameter->second];
+            if (value.empty() || (!slot.empty() && slot != value)) {
+                result.errorMessage = "Deducción contradictoria para '" + pattern[0] + "'";
+                return result;
+            }
+            slot = std::move(value);
+            continue;
+        }
+
+        fastPath = false;
+        if (!matchTypePattern(pattern, argument, parameterIndex, deduced)) {
+            result.errorMessage = "El argumento " + std::to_string(i + 1) + " ('" + argumentTypes[i] +
+                                  "') no encaja con '" + std::string(functionParams[i]->getTypeName()) + "'";
+            return result;
+        }
+    }
+
+    for (size_t i = 0; i < deduced.size(); ++i) {
+        if (deduced[i].empty()) {
+            result.errorMessage = "No se pudo deducir '" + std::string(params[i]->getName()) + "'";
+            return result;
+        }
+    }
+    if (fastPath) {
+        ++stats_.deductionFastPaths;
+    }
+    result.success = true;
+    result.arguments = std::move(deduced);
+    return result;
 }
 
 std::string TemplateInstantiationEngine::generateCacheKey(const std::string& templateName,
@@ -275,7 +839,7 @@ std::string TemplateInstantiationEngine::generateCacheKey(const std::string& tem
     return key;
 }
 
-std::unique_ptr<ast::ASTNode> TemplateInstantiationEngine::substituteParameters(
+ast::ASTNode* TemplateInstantiationEngine::substituteParameters(
     const ast::ASTNode* templateAST,
     const std::unordered_map<std::string, std::string>& parameterMap) {
 
@@ -328,7 +892,7 @@ bool TemplateInstantiationEngine::checkConstraints(
     std::unordered_map<std::string, std::string> bindings;
     const auto& params = templateInfo->parameters->getParameters();
     for (size_t i = 0; i < params.size() && i < arguments.size(); ++i) {
-        bindings[params[i]->getName()] = arguments[i];
+        bindings[std::string(params[i]->getName())] = arguments[i];
     }
 
     // Aquí iría la evaluación real de constraints
@@ -430,6 +994,12 @@ std::unique_ptr<TemplateInstance> TemplateSystem::instantiateTemplate(
     return instance;
 }
 
+size_t TemplateSystem::performPendingInstantiations(size_t jobs) {
+    size_t instantiated = instantiationEngine_->performPendingInstantiations(jobs);
+    stats_.instancesCreated += instantiated;
+    return instantiated;
+}
+
 ConstraintEvaluationResult TemplateSystem::checkConceptSatisfaction(
     const std::string& conceptName,
     const std::string& typeName) {
@@ -448,10 +1018,17 @@ std::vector<std::unique_ptr<TemplateInstance>> TemplateSystem::resolveOverload(
     // Implementación simplificada de resolución de sobrecarga
     // En un compilador real, esto buscaría todas las sobrecargas posibles
     // y aplicaría las reglas de resolución de sobrecarga de C++
+    const TemplateInfo* templateInfo = instantiationEngine_->getTemplateInfo(functionName);
+    std::vector<std::string> arguments = argumentTypes;
+    if (templateInfo && functionOf(templateInfo->definition)) {
+        DeductionResult deduction = deduceTemplateArguments(functionName, {}, argumentTypes);
+        if (!deduction.success) {
+            return candidates;
+        }
+        arguments = std::move(deduction.arguments);
+    }
 
-    // Para esta implementación, simplemente intentamos instanciar
-    // con los argumentos proporcionados
-    auto instance = instantiateTemplate(functionName, argumentTypes);
+    auto instance = instantiateTemplate(functionName, arguments);
     if (instance && instance->isValid) {
         candidates.push_back(std::move(instance));
     }
@@ -461,6 +1038,7 @@ std::vector<std::unique_ptr<TemplateInstance>> TemplateSystem::resolveOverload(
 
 void TemplateSystem::clearCache() {
     instantiationEngine_->clearCache();
+    constraintSolver_->clearCache();
     sfinaeHandler_->clear();
 }
 
@@ -470,6 +1048,8 @@ TemplateSystem::TemplateStats TemplateSystem::getStats() const {
     // Agregar estadísticas del instantiation engine
     auto instStats = instantiationEngine_->getStats();
     combinedStats.instancesCreated = instStats.instancesCreated;
+    combinedStats.cacheHits = instStats.cacheHits;
+    combinedStats.cacheMisses = instStats.cacheMisses;
 
     return combinedStats;
 }
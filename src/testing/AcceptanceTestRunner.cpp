@@ -4,12 +4,17 @@
  */
 
 #include <compiler/testing/AcceptanceTestRunner.h>
+#include <compiler/common/CacheFile.h>
+#include <compiler/common/utils/HashUtils.h>
+#include <compiler/common/utils/MappedFile.h>
+#include <compiler/common/utils/ThreadPool.h>
 #include <iostream>
 #include <sstream>
 #include <fstream>
 #include <algorithm>
 #include <thread>
 #include <future>
+#include <limits>
 
 namespace cpp20::compiler::testing {
 
@@ -403,27 +408,159 @@ int main() {
 }
 
 std::vector<TestResult> AcceptanceTestRunner::runAllTests() {
-    std::vector<TestResult> results;
-
+    std::vector<const AcceptanceTest*> selected;
     for (const auto& test : tests_) {
-        results.push_back(executeTest(*test));
+        if (shardCount_ <= 1 || shardOf(test->category) == shardIndex_) {
+            selected.push_back(test.get());
+        }
     }
-
-    return results;
+    return runTests(selected);
 }
 
 std::vector<TestResult> AcceptanceTestRunner::runTestsByCategory(TestCategory category) {
-    std::vector<TestResult> results;
-
+    std::vector<const AcceptanceTest*> selected;
     for (const auto& test : tests_) {
         if (test->category == category) {
-            results.push_back(executeTest(*test));
+            selected.push_back(test.get());
+        }
+    }
+    return runTests(selected);
+}
+
+std::vector<TestResult> AcceptanceTestRunner::runTests(const std::vector<const AcceptanceTest*>& tests) {
+    bool useCache = !resultCacheFile_.empty();
+    auto persisted = useCache ? CacheFileReader::open(resultCacheFile_, ResultCacheKind) : nullptr;
+
+    auto cachedFingerprint = [&](const std::string& name) -> std::optional<uint64_t> {
+        if (!persisted) return std::nullopt;
+        auto [first, last] = persisted->equalRange(common::utils::fnv1a64(name));
+        for (size_t i = first; i < last; ++i) {
+            auto record = persisted->record(i);
+            if (!record || record->key != name) continue;
+            CacheRecordReader reader(record->value);
+            uint64_t fingerprint = reader.u64();
+            if (reader.ok()) return fingerprint;
+        }
+        return std::nullopt;
+    };
+
+    std::vector<TestResult> results;
+    results.reserve(tests.size());
+    std::vector<uint64_t> fingerprints(tests.size(), 0);
+    for (size_t i = 0; i < tests.size(); ++i) {
+        results.emplace_back(tests[i]->name);
+        if (useCache) {
+            fingerprints[i] = testFingerprint(*tests[i]);
+        }
+    }
+
+    size_t jobs = jobs_ > 0 ? jobs_ : common::utils::ThreadPool::defaultThreadCount();
+    common::utils::parallelFor(tests.size(), jobs, [&](size_t i) {
+        if (useCache && cachedFingerprint(tests[i]->name) == fingerprints[i]) {
+            results[i].passed = true;
+            results[i].cached = true;
+            return;
+        }
+        results[i] = executeTest(*tests[i]);
+    });
+
+    if (useCache) {
+        // Se conservan las pruebas de otros shards o categorías; las que se
+        // ejecutaron ahora se recuerdan solo si pasaron
+        std::unordered_map<std::string, size_t> ran;
+        for (size_t i = 0; i < tests.size(); ++i) {
+            ran[tests[i]->name] = i;
+        }
+
+        CacheFileWriter writer;
+        auto add = [&](const std::string& name, uint64_t fingerprint) {
+            CacheRecordWriter value;
+            value.u64(fingerprint);
+            writer.add(common::utils::fnv1a64(name), name, value.take());
+        };
+        if (persisted) {
+            for (size_t i = 0; i < persisted->size(); ++i) {
+                auto record = persisted->record(i);
+                if (!record || ran.count(std::string(record->key))) continue;
+                CacheRecordReader reader(record->value);
+                uint64_t fingerprint = reader.u64();
+                if (reader.ok()) add(std::string(record->key), fingerprint);
+            }
+        }
+        for (size_t i = 0; i < tests.size(); ++i) {
+            if (results[i].passed) add(tests[i]->name, fingerprints[i]);
+        }
+
+        persisted.reset();      // Se libera la proyección antes de reemplazar el archivo
+        if (!writer.write(resultCacheFile_, ResultCacheKind)) {
+            std::cerr << "Advertencia: no se pudo escribir " << resultCacheFile_.string() << std::endl;
         }
     }
 
     return results;
 }
 
+void AcceptanceTestRunner::setShard(size_t index, size_t count) {
+    shardCount_ = count > 0 ? count : 1;
+    shardIndex_ = index < shardCount_ ? index : 0;
+}
+
+size_t AcceptanceTestRunner::shardOf(TestCategory category) const {
+    if (shardCount_ <= 1) return 0;
+
+    // Reparto voraz: de más a menos pruebas, cada categoría al shard con
+    // menos carga; los empates se resuelven por el orden del enum
+    std::vector<std::pair<size_t, TestCategory>> categories;
+    for (const auto& [cat, count] : getTestCounts()) {
+        categories.emplace_back(count, cat);
+    }
+    std::sort(categories.begin(), categories.end(), [](const auto& a, const auto& b) {
+        if (a.first != b.first) return a.first > b.first;
+        return static_cast<int>(a.second) < static_cast<int>(b.second);
+    });
+
+    std::vector<size_t> load(shardCount_, 0);
+    for (const auto& [count, cat] : categories) {
+        size_t target = static_cast<size_t>(std::min_element(load.begin(), load.end()) - load.begin());
+        if (cat == category) return target;
+        load[target] += count;
+    }
+    return 0;
+}
+
+bool AcceptanceTestRunner::setResultCache(const std::filesystem::path& cacheFile,
+                                          const std::filesystem::path& compilerBinary) {
+    auto binary = common::utils::MappedFile::open(compilerBinary);
+    if (!binary) {
+        resultCacheFile_.clear();
+        return false;
+    }
+    compilerHash_ = common::utils::fnv1a64(std::string_view(binary->data(), binary->size()));
+    resultCacheFile_ = cacheFile;
+    return true;
+}
+
+uint64_t AcceptanceTestRunner::testFingerprint(const AcceptanceTest& test) const {
+    using common::utils::fnv1a64;
+    using common::utils::hashMix;
+
+    uint64_t hash = hashMix(compilerHash_, fnv1a64(test.name));
+    for (const auto& source : test.sourceFiles) {
+        hash = hashMix(hash, fnv1a64(source.string()));
+        auto content = common::utils::MappedFile::open(source);
+        hash = hashMix(hash, content ? fnv1a64(std::string_view(content->data(), content->size())) : 0);
+    }
+    for (const auto& arg : test.compilerArgs) hash = hashMix(hash, fnv1a64(arg));
+    hash = hashMix(hash, test.compilerArgs.size());
+    for (const auto& arg : test.linkerArgs) hash = hashMix(hash, fnv1a64(arg));
+    hash = hashMix(hash, test.linkerArgs.size());
+    hash = hashMix(hash, fnv1a64(test.expectedOutput));
+    hash = hashMix(hash, static_cast<uint64_t>(static_cast<int64_t>(test.expectedExitCode)));
+    hash = hashMix(hash, (test.shouldCompile ? 1u : 0u) | (test.shouldLink ? 2u : 0u) |
+                         (test.shouldRun && runPrograms_ ? 4u : 0u));
+    return hash;
+}
+
 TestResult AcceptanceTestRunner::runTest(const std::string& testName) {
     auto it = testIndex_.find(testName);
     if (it == testIndex_.end()) {
@@ -472,7 +609,7 @@ std::string AcceptanceTestRunner::generateReport(const std::vector<TestResult>&
 
     for (const auto& result : results) {
         ss << "\nTest: " << result.testName << "\n";
-        ss << "  Status: " << (result.passed ? "PASSED" : "FAILED") << "\n";
+        ss << "  Status: " << (result.passed ? (result.cached ? "PASSED (cached)" : "PASSED") : "FAILED") << "\n";
         ss << "  Time: " << result.executionTime.count() << "ms\n";
 
         if (!result.passed) {
@@ -490,7 +627,7 @@ std::string AcceptanceTestRunner::generateReport(const std::vector<TestResult>&
     return ss.str();
 }
 
-void AcceptanceTestRunner::setCompilerDriver(std::unique_ptr<driver::CompilerDriver> driver) {
+void AcceptanceTestRunner::setCompilerDriver(std::unique_ptr<CompilerDriver> driver) {
     compilerDriver_ = std::move(driver);
 }
 
@@ -653,7 +790,7 @@ void AcceptanceTestRunner::cleanupTempFiles(const std::vector<std::filesystem::p
 std::filesystem::path AcceptanceTestRunner::generateTempFileName(const std::string& prefix,
                                                                const std::string& extension) {
     auto tempDir = tempDirectory_;
-    std::string filename = prefix + "_" + std::to_string(std::rand()) + extension;
+    std::string filename = prefix + "_" + std::to_string(tempCounter_.fetch_add(1)) + extension;
     return tempDir / filename;
 }
 
@@ -0,0 +1,107 @@
+/**
+ * @file CoverageMap.cpp
+ * @brief Callbacks de SanitizerCoverage y mapa de aristas del fuzzer
+ *
+ * Este archivo no debe instrumentarse: el callback de cada arista se
+ * llamaría a sí mismo.
+ */
+
+#include <compiler/testing/CoverageMap.h>
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+// Índices 1..guardCount; 0 deja una guarda desactivada
+uint32_t guardCount = 0;
+
+thread_local uint8_t* activeCounters = nullptr;
+thread_local size_t activeSize = 0;
+
+uint8_t bucketOf(uint8_t hits) {
+    if (hits >= 128) return 1u << 7;
+    if (hits >= 32) return 1u << 6;
+    if (hits >= 16) return 1u << 5;
+    if (hits >= 8) return 1u << 4;
+    if (hits >= 4) return 1u << 3;
+    return static_cast<uint8_t>(1u << (hits - 1));
+}
+
+} // namespace
+
+extern "C" void __sanitizer_cov_trace_pc_guard_init(uint32_t* start, uint32_t* stop) {
+    if (start == stop || *start) return;     // Ya numerado (se llama una vez por módulo)
+    for (uint32_t* guard = start; guard < stop; ++guard) {
+        *guard = ++guardCount;
+    }
+}
+
+extern "C" void __sanitizer_cov_trace_pc_guard(uint32_t* guard) {
+    uint32_t index = *guard;
+    if (index < activeSize) {
+        uint8_t& counter = activeCounters[index];
+        if (counter != 255) ++counter;
+    }
+}
+
+namespace cpp20::compiler::testing {
+
+CoverageTrace::CoverageTrace() : counters_(CoverageMap::edgeCount() + 1, 0) {}
+
+void CoverageTrace::reset() {
+    std::fill(counters_.begin(), counters_.end(), 0);
+}
+
+std::vector<uint32_t> CoverageTrace::features() const {
+    std::vector<uint32_t> result;
+    for (size_t edge = 1; edge < counters_.size(); ++edge) {
+        if (counters_[edge] != 0) {
+            uint32_t bucket = static_cast<uint32_t>(std::countr_zero(bucketOf(counters_[edge])));
+            result.push_back(static_cast<uint32_t>(edge) * 8 + bucket);
+        }
+    }
+    return result;
+}
+
+CoverageScope::CoverageScope(CoverageTrace& trace)
+    : previousCounters_(activeCounters), previousSize_(activeSize) {
+    activeCounters = trace.counters_.data();
+    activeSize = trace.counters_.size();
+}
+
+CoverageScope::~CoverageScope() {
+    activeCounters = previousCounters_;
+    activeSize = previousSize_;
+}
+
+CoverageMap::CoverageMap()
+    : size_(edgeCount() + 1), seen_(new std::atomic<uint8_t>[size_]) {
+    for (size_t i = 0; i < size_; ++i) {
+        seen_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t CoverageMap::edgeCount() {
+    return guardCount;
+}
+
+size_t CoverageMap::merge(const CoverageTrace& trace) {
+    const auto& counters = trace.counters();
+    size_t limit = std::min(counters.size(), size_);
+    size_t newBuckets = 0;
+    for (size_t edge = 1; edge < limit; ++edge) {
+        if (counters[edge] == 0) continue;
+
+        uint8_t bucket = bucketOf(counters[edge]);
+        uint8_t previous = seen_[edge].fetch_or(bucket, std::memory_order_relaxed);
+        if (previous & bucket) continue;
+
+        ++newBuckets;
+        if (previous == 0) {
+            coveredEdges_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    return newBuckets;
+}
+
+} // namespace cpp20::compiler::testing
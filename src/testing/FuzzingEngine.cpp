@@ -4,6 +4,12 @@
  */
 
 #include <compiler/testing/FuzzingEngine.h>
+#include <compiler/frontend/Parser.h>
+#include <compiler/frontend/Preprocessor.h>
+#include <compiler/frontend/lexer/IdentifierTable.h>
+#include <compiler/frontend/lexer/Lexer.h>
+#include <compiler/common/diagnostics/SourceManager.h>
+#include <compiler/common/utils/ThreadPool.h>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -12,9 +18,27 @@
 #include <future>
 #include <regex>
 #include <cstring>
+#include <atomic>
+#include <streambuf>
+#include <queue>
+#include <string_view>
+#include <unordered_set>
 
 namespace cpp20::compiler::testing {
 
+namespace {
+
+/**
+ * @brief Descarta todo lo escrito (seguro entre hilos: no guarda estado)
+ */
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return traits_type::not_eof(c); }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+} // namespace
+
 // ============================================================================
 // FuzzInputGenerator - Implementación
 // ============================================================================
@@ -566,22 +590,55 @@ std::string FuzzExecutor::getStackTrace() {
     return "Stack trace not available in this implementation";
 }
 
-std::string FuzzExecutor::minimizeInput(const std::string& crashingInput, FuzzTarget target) {
-    // Implementación simple de minimización de input
-    // En una implementación real, se usaría algoritmos más sofisticados
-    // como delta debugging
+std::string FuzzExecutor::minimizeInput(const std::string& crashingInput, FuzzTarget target,
+                                        size_t jobs) {
+    FuzzResult original = executeFuzzInput(crashingInput, target);
+    if (!original.isCrash) {
+        return crashingInput;
+    }
+    auto reproduces = [&](const std::string& candidate) {
+        FuzzResult result = executeFuzzInput(candidate, target);
+        return result.isCrash && result.errorType == original.errorType;
+    };
 
     std::string minimized = crashingInput;
+    size_t granularity = 2;
+    while (minimized.size() >= 2) {
+        size_t chunk = (minimized.size() + granularity - 1) / granularity;
+        size_t chunks = (minimized.size() + chunk - 1) / chunk;
+
+        // Candidatos 0..chunks-1: complementos; después, los trozos solos
+        // (con dos trozos coinciden con los complementos)
+        size_t candidates = chunks > 2 ? 2 * chunks : chunks;
+        auto candidate = [&](size_t index) {
+            size_t piece = index % chunks;
+            size_t begin = piece * chunk;
+            if (index < chunks) {
+                std::string complement = minimized.substr(0, begin);
+                if (begin + chunk < minimized.size()) complement += minimized.substr(begin + chunk);
+                return complement;
+            }
+            return minimized.substr(begin, chunk);
+        };
 
-    // Intentar eliminar partes del input mientras se preserve el crash
-    for (size_t i = 0; i < minimized.size(); ++i) {
-        std::string testInput = minimized;
-        testInput.erase(i, 1);
-
-        if (!validateCompilerBehavior(testInput, target)) {
-            // El crash se preserva, continuar con input más pequeño
-            minimized = testInput;
-            i = 0; // Reiniciar búsqueda
+        // Un índice solo se salta si ya reprodujo uno menor: siempre gana el
+        // menor que reproduce, con independencia de los hilos
+        std::atomic<size_t> best{candidates};
+        common::utils::parallelFor(candidates, jobs, [&](size_t index) {
+            if (index > best.load(std::memory_order_relaxed)) return;
+            if (!reproduces(candidate(index))) return;
+            size_t current = best.load(std::memory_order_relaxed);
+            while (index < current && !best.compare_exchange_weak(current, index)) {}
+        });
+
+        size_t found = best.load();
+        if (found < candidates) {
+            minimized = candidate(found);
+            granularity = found < chunks ? std::max<size_t>(granularity - 1, 2) : 2;
+        } else if (chunks >= minimized.size()) {
+            break;      // Ya se probó cada byte por separado: 1-mínimo
+        } else {
+            granularity = std::min(granularity * 2, minimized.size());
         }
     }
 
@@ -589,150 +646,82 @@ std::string FuzzExecutor::minimizeInput(const std::string& crashingInput, FuzzTa
 }
 
 FuzzResult FuzzExecutor::fuzzLexer(const std::string& input) {
-    FuzzResult result(input, FuzzTarget::Lexer);
-
-    // En una implementación real, aquí se probaría solo el lexer
-    // Simular ejecución
-    auto [output, exitCode, execTime] = executeCommand("echo Testing lexer", std::chrono::seconds(1));
-
-    result.executionTime = execTime;
-    result.isCrash = detectCrash(output, exitCode);
-
-    if (result.isCrash) {
-        result.errorType = "Lexer Crash";
-        result.errorMessage = "Lexer crashed with input: " + input.substr(0, 50) + "...";
-    }
-
-    return result;
+    return runFrontend(input, FuzzTarget::Lexer, false, false);
 }
 
 FuzzResult FuzzExecutor::fuzzParser(const std::string& input) {
-    FuzzResult result(input, FuzzTarget::Parser);
-
-    // Simular ejecución del parser
-    auto [output, exitCode, execTime] = executeCommand("echo Testing parser", std::chrono::seconds(1));
-
-    result.executionTime = execTime;
-    result.isCrash = detectCrash(output, exitCode);
-
-    if (result.isCrash) {
-        result.errorType = "Parser Crash";
-        result.errorMessage = "Parser crashed with input: " + input.substr(0, 50) + "...";
-    }
-
-    return result;
+    return runFrontend(input, FuzzTarget::Parser, false, true);
 }
 
 FuzzResult FuzzExecutor::fuzzPreprocessor(const std::string& input) {
-    FuzzResult result(input, FuzzTarget::Preprocessor);
-
-    // Simular ejecución del preprocesador
-    auto [output, exitCode, execTime] = executeCommand("echo Testing preprocessor", std::chrono::seconds(1));
-
-    result.executionTime = execTime;
-    result.isCrash = detectCrash(output, exitCode);
-
-    if (result.isCrash) {
-        result.errorType = "Preprocessor Crash";
-        result.errorMessage = "Preprocessor crashed with input: " + input.substr(0, 50) + "...";
-    }
-
-    return result;
+    return runFrontend(input, FuzzTarget::Preprocessor, true, false);
 }
 
 FuzzResult FuzzExecutor::fuzzSemantic(const std::string& input) {
-    FuzzResult result(input, FuzzTarget::Semantic);
-
-    // Simular ejecución del análisis semántico
-    auto [output, exitCode, execTime] = executeCommand("echo Testing semantic analysis", std::chrono::seconds(1));
-
-    result.executionTime = execTime;
-    result.isCrash = detectCrash(output, exitCode);
-
-    if (result.isCrash) {
-        result.errorType = "Semantic Crash";
-        result.errorMessage = "Semantic analysis crashed with input: " + input.substr(0, 50) + "...";
-    }
-
-    return result;
+    return runFrontend(input, FuzzTarget::Semantic, true, true);
 }
 
 FuzzResult FuzzExecutor::fuzzCodeGen(const std::string& input) {
-    FuzzResult result(input, FuzzTarget::CodeGen);
-
-    // Simular ejecución del generador de código
-    auto [output, exitCode, execTime] = executeCommand("echo Testing code generation", std::chrono::seconds(1));
-
-    result.executionTime = execTime;
-    result.isCrash = detectCrash(output, exitCode);
-
-    if (result.isCrash) {
-        result.errorType = "CodeGen Crash";
-        result.errorMessage = "Code generation crashed with input: " + input.substr(0, 50) + "...";
-    }
-
-    return result;
+    return runFrontend(input, FuzzTarget::CodeGen, true, true);
 }
 
 FuzzResult FuzzExecutor::fuzzFullPipeline(const std::string& input) {
-    FuzzResult result(input, FuzzTarget::FullPipeline);
+    return runFrontend(input, FuzzTarget::FullPipeline, true, true);
+}
 
-    // Simular ejecución de toda la pipeline
-    auto [output, exitCode, execTime] = executeCommand("echo Testing full pipeline", std::chrono::seconds(1));
+FuzzResult FuzzExecutor::runFrontend(const std::string& input, FuzzTarget target,
+                                     bool preprocess, bool parse) {
+    FuzzResult result(input, target);
 
-    result.executionTime = execTime;
-    result.isCrash = detectCrash(output, exitCode);
+    // Estado nuevo en cada ejecución: nada de la anterior puede influir
+    frontend::lexer::IdentifierTable identifiers;
+    auto sourceManager = std::make_shared<diagnostics::SourceManager>();
+    diagnostics::DiagnosticEngine diagEngine(sourceManager);
+    diagEngine.clearConsumers();
+
+    frontend::lexer::LexerConfig lexerConfig;
+    lexerConfig.identifiers = &identifiers;
+    frontend::lexer::Lexer lexer(input, diagEngine, lexerConfig);
+
+    std::vector<frontend::lexer::Token> tokens;
+    if (preprocess) {
+        frontend::PreprocessorConfig preprocessorConfig;
+        preprocessorConfig.enableWarnings = false;
+        preprocessorConfig.identifiers = &identifiers;
+        frontend::Preprocessor preprocessor(diagEngine, preprocessorConfig);
+        tokens = preprocessor.process(lexer);
+    } else {
+        tokens = lexer.tokenize();
+    }
 
-    if (result.isCrash) {
-        result.errorType = "Full Pipeline Crash";
-        result.errorMessage = "Full pipeline crashed with input: " + input.substr(0, 50) + "...";
+    if (parse) {
+        frontend::Parser parser(tokens, diagEngine);
+        parser.parse();
     }
 
     return result;
 }
 
-std::tuple<std::string, int, std::chrono::milliseconds> FuzzExecutor::executeCommand(
-    const std::string& command, std::chrono::milliseconds timeout) {
-
-    auto startTime = std::chrono::steady_clock::now();
-
-    // En una implementación real, aquí se ejecutaría el comando real
-    // con captura de salida y timeout
-    std::string output = "Simulated compiler output";
-    int exitCode = 0;
-
-    auto endTime = std::chrono::steady_clock::now();
-    auto execTime = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-
-    return {output, exitCode, execTime};
-}
-
-bool FuzzExecutor::validateOutput(const std::string& output, int exitCode) {
-    // Validar que la salida es razonable
-    return !output.empty() && exitCode >= 0;
-}
-
-std::string FuzzExecutor::detectErrorPattern(const std::string& output, int exitCode) {
-    // Detectar patrones de error específicos
-    if (exitCode == 139) return "Segmentation Fault";
-    if (exitCode == 134) return "Assertion Failed";
-    if (exitCode == 11) return "Segmentation Fault (SIGSEGV)";
-
-    if (output.find("segmentation") != std::string::npos) return "Segmentation Fault";
-    if (output.find("assertion") != std::string::npos) return "Assertion Failed";
-    if (output.find("stack overflow") != std::string::npos) return "Stack Overflow";
-
-    return "Unknown Error";
-}
-
 // ============================================================================
 // FuzzingEngine - Implementación
 // ============================================================================
 
+struct FuzzingEngine::Worker {
+    FuzzInputGenerator generator;
+    FuzzExecutor executor;
+    CoverageTrace trace;
+    std::mt19937 rng;
+
+    explicit Worker(size_t seed)
+        : generator(seed), rng(static_cast<std::mt19937::result_type>(seed)) {}
+};
+
 FuzzingEngine::FuzzingEngine(FuzzTarget target, FuzzStrategy strategy)
     : target_(target), strategy_(strategy), maxInputSize_(4096),
       timeout_(std::chrono::seconds(5)), mutationRate_(0.1),
-      verbose_(false), seed_(std::random_device{}()) {
+      verbose_(false), seed_(std::random_device{}()),
+      corpus_(std::make_unique<CorpusManager>(std::filesystem::path())),
+      coverage_(std::make_unique<CoverageMap>()) {
 
     initializeGenerators();
 }
@@ -742,25 +731,58 @@ FuzzingEngine::~FuzzingEngine() = default;
 FuzzStatistics FuzzingEngine::runFuzzing(size_t numIterations,
                                         std::chrono::minutes duration) {
     auto startTime = std::chrono::steady_clock::now();
-    size_t iteration = 0;
+    std::atomic<size_t> nextIteration{0};
 
-    std::cout << "Starting fuzzing session with " << numIterations << " iterations" << std::endl;
+    std::cout << "Starting fuzzing session with " << numIterations << " iterations on "
+              << workers_ << " workers" << std::endl;
 
-    while (iteration < numIterations && checkTimeLimits(startTime, duration)) {
-        FuzzResult result = runIteration(iteration);
-        processResult(result);
+    // Los targets escriben sus errores en std::cerr; a miles de ejecuciones
+    // por segundo eso domina el tiempo, así que se descartan salvo en verbose
+    NullBuffer discard;
+    std::streambuf* previousBuffer = verbose_ ? nullptr : std::cerr.rdbuf(&discard);
 
-        if (verbose_ && iteration % 100 == 0) {
-            reportProgress(iteration, result);
+    auto work = [&](size_t index) {
+        Worker worker(seed_ + index);
+        for (;;) {
+            size_t iteration = nextIteration.fetch_add(1, std::memory_order_relaxed);
+            if (iteration >= numIterations || !checkTimeLimits(startTime, duration)) {
+                break;
+            }
+
+            FuzzResult result = runIteration(worker);
+
+            std::lock_guard<std::mutex> lock(resultMutex_);
+            processResult(result);
+            if (verbose_ && iteration % 100 == 0) {
+                reportProgress(iteration, result);
+            }
         }
+    };
 
-        iteration++;
+    std::vector<std::thread> threads;
+    for (size_t index = 1; index < workers_; ++index) {
+        threads.emplace_back(work, index);
     }
+    work(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    statistics_.execsPerSecond = elapsed > 0 ? static_cast<double>(statistics_.totalInputs) / elapsed : 0;
+    statistics_.edgesCovered = coverage_->coveredEdges();
+    statistics_.corpusSize = corpus_->size();
 
     // Minimizar crashes encontrados
     minimizeCrashes();
 
-    std::cout << "Fuzzing session completed. Found " << statistics_.crashesFound << " crashes." << std::endl;
+    if (previousBuffer) {
+        std::cerr.rdbuf(previousBuffer);
+    }
+
+    std::cout << "Fuzzing session completed. Found " << statistics_.crashesFound << " crashes ("
+              << static_cast<size_t>(statistics_.execsPerSecond) << " exec/s, "
+              << statistics_.edgesCovered << " edges, corpus " << statistics_.corpusSize << ")." << std::endl;
 
     return statistics_;
 }
@@ -774,7 +796,25 @@ void FuzzingEngine::configure(size_t maxInputSize,
 }
 
 bool FuzzingEngine::loadCorpus(const std::filesystem::path& corpusDir) {
-    return inputGenerator_->loadCorpus(corpusDir);
+    if (!std::filesystem::is_directory(corpusDir)) {
+        return false;
+    }
+
+    // Semillas de FuzzInputGenerator (.cpp) y entradas de CorpusManager (.txt)
+    size_t before = corpus_->size();
+    for (const auto& entry : std::filesystem::directory_iterator(corpusDir)) {
+        auto extension = entry.path().extension();
+        if (!entry.is_regular_file() || (extension != ".cpp" && extension != ".txt")) {
+            continue;
+        }
+        std::ifstream file(entry.path(), std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(file)),
+                            std::istreambuf_iterator<char>());
+        if (!content.empty()) {
+            corpus_->addEntry(content, entry.path().filename().string());
+        }
+    }
+    return corpus_->size() > before;
 }
 
 void FuzzingEngine::saveCrashes(const std::filesystem::path& outputDir) const {
@@ -809,30 +849,59 @@ void FuzzingEngine::initializeGenerators() {
     executor_ = std::make_unique<FuzzExecutor>();
 }
 
-FuzzResult FuzzingEngine::runIteration(size_t iteration) {
-    std::string input;
+FuzzResult FuzzingEngine::runIteration(Worker& worker) {
+    std::string input = nextInput(worker);
 
-    // Generar input según estrategia
+    worker.trace.reset();
+    FuzzResult result;
+    {
+        CoverageScope scope(worker.trace);
+        result = worker.executor.executeFuzzInput(input, target_, timeout_);
+    }
+
+    // Lo que alcanza aristas nuevas pasa a ser semilla de todos los trabajadores
+    result.newCoverage = coverage_->merge(worker.trace);
+    if (result.newCoverage > 0) {
+        corpus_->addEntry(input, "cov+" + std::to_string(result.newCoverage), worker.trace.features());
+    }
+    return result;
+}
+
+std::string FuzzingEngine::nextInput(Worker& worker) {
+    auto corpusEntry = [&]() -> std::string {
+        size_t size = corpus_->size();
+        if (size == 0) return "";
+        std::uniform_int_distribution<size_t> pick(0, size - 1);
+        return corpus_->getEntry(pick(worker.rng));
+    };
+
+    std::string input;
     switch (strategy_) {
         case FuzzStrategy::Random:
-            input = inputGenerator_->generateRandomInput(maxInputSize_);
+            input = worker.generator.generateRandomInput(maxInputSize_);
             break;
         case FuzzStrategy::Mutational: {
-            std::string seed = inputGenerator_->getRandomSeed();
-            input = inputGenerator_->mutateInput(seed, mutationRate_);
+            std::string seed = corpusEntry();
+            if (seed.empty()) seed = worker.generator.getRandomSeed();
+            input = worker.generator.mutateInput(seed, mutationRate_);
             break;
         }
         case FuzzStrategy::GrammarBased:
-            input = inputGenerator_->generateGrammarBasedInput(target_, 2);
+            input = worker.generator.generateGrammarBasedInput(target_, 2);
             break;
-        case FuzzStrategy::CoverageGuided:
-            // En una implementación real, aquí se usaría información de cobertura
-            input = inputGenerator_->generateTargetedInput(target_);
+        case FuzzStrategy::CoverageGuided: {
+            // Sin instrumentación o sin semillas todavía se parte de la gramática
+            std::string seed = corpusEntry();
+            input = seed.empty() ? worker.generator.generateTargetedInput(target_)
+                                 : worker.generator.mutateInput(seed, mutationRate_);
             break;
+        }
     }
 
-    // Ejecutar fuzzing
-    return executor_->executeFuzzInput(input, target_, timeout_);
+    if (input.size() > maxInputSize_) {
+        input.resize(maxInputSize_);
+    }
+    return input;
 }
 
 void FuzzingEngine::processResult(const FuzzResult& result) {
@@ -857,6 +926,7 @@ bool FuzzingEngine::isNewCrash(const FuzzResult& result) {
 void FuzzingEngine::updateStatistics(const FuzzResult& result) {
     statistics_.totalInputs++;
     statistics_.totalTime += result.executionTime;
+    statistics_.coverageIncrease += result.newCoverage;
 
     if (result.isCrash) {
         statistics_.crashesFound++;
@@ -887,10 +957,58 @@ bool FuzzingEngine::checkTimeLimits(std::chrono::steady_clock::time_point startT
     return elapsed < maxDuration;
 }
 
+size_t FuzzingEngine::minimizeCorpus() {
+    const auto& entries = corpus_->getAllEntries();
+    std::vector<size_t> pending;
+    if (CoverageMap::isInstrumented()) {
+        const auto& features = corpus_->getAllFeatures();
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (features[i].empty()) pending.push_back(i);
+        }
+    }
+
+    if (!pending.empty()) {
+        NullBuffer discard;
+        std::streambuf* previousBuffer = verbose_ ? nullptr : std::cerr.rdbuf(&discard);
+
+        std::atomic<size_t> next{0};
+        auto work = [&]() {
+            FuzzExecutor executor;
+            CoverageTrace trace;
+            for (size_t slot; (slot = next.fetch_add(1, std::memory_order_relaxed)) < pending.size();) {
+                size_t index = pending[slot];
+                trace.reset();
+                {
+                    CoverageScope scope(trace);
+                    executor.executeFuzzInput(entries[index], target_, timeout_);
+                }
+                corpus_->setFeatures(index, trace.features());
+            }
+        };
+        std::vector<std::thread> threads;
+        for (size_t index = 1; index < workers_; ++index) {
+            threads.emplace_back(work);
+        }
+        work();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        if (previousBuffer) {
+            std::cerr.rdbuf(previousBuffer);
+        }
+    }
+
+    size_t removed = corpus_->deduplicate();
+    removed += corpus_->minimizeCorpus();
+    statistics_.corpusSize = corpus_->size();
+    return removed;
+}
+
 void FuzzingEngine::minimizeCrashes() {
     for (auto& crash : crashes_) {
         if (crash.isCrash) {
-            std::string minimized = executor_->minimizeInput(crash.input, crash.target);
+            std::string minimized = executor_->minimizeInput(crash.input, crash.target, workers_);
             if (minimized.size() < crash.input.size()) {
                 crash.input = minimized;
                 crash.inputSize = minimized.size();
@@ -910,18 +1028,23 @@ void FuzzingEngine::cleanup() {
 
 CorpusManager::CorpusManager(const std::filesystem::path& corpusDir)
     : corpusDir_(corpusDir) {
-    std::filesystem::create_directories(corpusDir_);
+    if (!corpusDir_.empty()) {
+        std::filesystem::create_directories(corpusDir_);
+    }
 }
 
 CorpusManager::~CorpusManager() = default;
 
 bool CorpusManager::loadCorpus() {
-    if (!std::filesystem::exists(corpusDir_)) {
+    if (corpusDir_.empty() || !std::filesystem::exists(corpusDir_)) {
         return false;
     }
 
+    std::lock_guard<std::mutex> lock(mutex_);
+
     entries_.clear();
     metadata_.clear();
+    features_.clear();
 
     for (const auto& entry : std::filesystem::directory_iterator(corpusDir_)) {
         if (entry.is_regular_file() && entry.path().extension() == ".txt") {
@@ -931,6 +1054,7 @@ bool CorpusManager::loadCorpus() {
                                    std::istreambuf_iterator<char>());
                 entries_.push_back(content);
                 metadata_.push_back(entry.path().filename().string());
+                features_.emplace_back();
                 file.close();
             }
         }
@@ -940,6 +1064,11 @@ bool CorpusManager::loadCorpus() {
 }
 
 bool CorpusManager::saveCorpus() const {
+    if (corpusDir_.empty()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
     for (size_t i = 0; i < entries_.size(); ++i) {
         std::string filename = "entry_" + std::to_string(i) + ".txt";
         std::filesystem::path filePath = corpusDir_ / filename;
@@ -956,12 +1085,23 @@ bool CorpusManager::saveCorpus() const {
     return true;
 }
 
-void CorpusManager::addEntry(const std::string& entry, const std::string& metadata) {
+void CorpusManager::addEntry(const std::string& entry, const std::string& metadata,
+                             std::vector<uint32_t> features) {
+    std::lock_guard<std::mutex> lock(mutex_);
     entries_.push_back(entry);
     metadata_.push_back(metadata);
+    features_.push_back(std::move(features));
+}
+
+void CorpusManager::setFeatures(size_t index, std::vector<uint32_t> features) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index < features_.size()) {
+        features_[index] = std::move(features);
+    }
 }
 
 std::string CorpusManager::getRandomEntry() {
+    std::lock_guard<std::mutex> lock(mutex_);
     if (entries_.empty()) {
         return "";
     }
@@ -973,30 +1113,55 @@ std::string CorpusManager::getRandomEntry() {
     return entries_[dist(gen)];
 }
 
-void CorpusManager::deduplicate() {
-    std::unordered_map<std::string, size_t> seen;
+std::string CorpusManager::getEntry(size_t index) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index < entries_.size() ? entries_[index] : std::string();
+}
+
+size_t CorpusManager::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+size_t CorpusManager::deduplicate() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<bool> keep(entries_.size(), true);
 
+    // Contenido: las vistas apuntan a entries_, que no cambia en esta pasada
+    std::unordered_set<std::string_view> contents;
     for (size_t i = 0; i < entries_.size(); ++i) {
-        std::string hash = calculateEntryHash(entries_[i]);
-        if (seen.find(hash) == seen.end()) {
-            seen[hash] = i;
-        }
+        keep[i] = contents.insert(entries_[i]).second;
     }
 
-    // Mantener solo entradas únicas
-    std::vector<std::string> uniqueEntries;
-    std::vector<std::string> uniqueMetadata;
-
-    for (const auto& [hash, index] : seen) {
-        uniqueEntries.push_back(entries_[index]);
-        uniqueMetadata.push_back(metadata_[index]);
+    // Firma de cobertura: por hash y comparando la firma ante una colisión
+    auto signatureHash = [](const std::vector<uint32_t>& features) {
+        return std::hash<std::string_view>{}(std::string_view(
+            reinterpret_cast<const char*>(features.data()), features.size() * sizeof(uint32_t)));
+    };
+    std::unordered_map<size_t, std::vector<size_t>> signatures;
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        if (!keep[i] || features_[i].empty()) continue;
+
+        auto& sameHash = signatures[signatureHash(features_[i])];
+        auto match = std::find_if(sameHash.begin(), sameHash.end(),
+                                  [&](size_t kept) { return features_[kept] == features_[i]; });
+        if (match == sameHash.end()) {
+            sameHash.push_back(i);
+        } else if (entries_[i].size() < entries_[*match].size()) {
+            keep[*match] = false;
+            *match = i;
+        } else {
+            keep[i] = false;
+        }
     }
 
-    entries_ = std::move(uniqueEntries);
-    metadata_ = std::move(uniqueMetadata);
+    size_t before = entries_.size();
+    retain(keep);
+    return before - entries_.size();
 }
 
 std::unordered_map<std::string, size_t> CorpusManager::getStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
     return {
         {"total_entries", entries_.size()},
         {"total_size_bytes", calculateCacheSize()}
@@ -1017,31 +1182,73 @@ bool CorpusManager::validateCorpus() const {
     return true;
 }
 
-void CorpusManager::minimizeCorpus() {
-    // Ordenar por tamaño (mantener entradas más pequeñas primero)
-    std::vector<std::pair<size_t, size_t>> indices;
+size_t CorpusManager::minimizeCorpus() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<bool> keep(entries_.size(), false);
+
+    uint32_t maxFeature = 0;
     for (size_t i = 0; i < entries_.size(); ++i) {
-        indices.emplace_back(entries_[i].size(), i);
+        if (features_[i].empty()) {
+            keep[i] = true;
+        } else {
+            maxFeature = std::max(maxFeature, features_[i].back());
+        }
     }
 
-    std::sort(indices.begin(), indices.end());
-
-    // Mantener solo las primeras N entradas más pequeñas
-    const size_t maxEntries = 1000;
-    if (indices.size() > maxEntries) {
-        indices.resize(maxEntries);
+    // (ganancia, índice); a igual ganancia sale antes la entrada más corta
+    using Candidate = std::pair<size_t, size_t>;
+    auto worse = [&](const Candidate& a, const Candidate& b) {
+        if (a.first != b.first) return a.first < b.first;
+        if (entries_[a.second].size() != entries_[b.second].size()) {
+            return entries_[a.second].size() > entries_[b.second].size();
+        }
+        return a.second > b.second;
+    };
+    std::priority_queue<Candidate, std::vector<Candidate>, decltype(worse)> heap(worse);
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        if (!features_[i].empty()) heap.emplace(features_[i].size(), i);
     }
 
-    std::vector<std::string> minimizedEntries;
-    std::vector<std::string> minimizedMetadata;
+    std::vector<bool> covered(static_cast<size_t>(maxFeature) + 1, false);
+    while (!heap.empty()) {
+        auto [gain, index] = heap.top();
+        heap.pop();
+
+        size_t current = 0;
+        for (uint32_t feature : features_[index]) {
+            if (!covered[feature]) ++current;
+        }
+        if (current == 0) continue;
+        if (current < gain) {
+            heap.emplace(current, index);   // Ganancia obsoleta: se reordena
+            continue;
+        }
 
-    for (const auto& [size, index] : indices) {
-        minimizedEntries.push_back(entries_[index]);
-        minimizedMetadata.push_back(metadata_[index]);
+        keep[index] = true;
+        for (uint32_t feature : features_[index]) {
+            covered[feature] = true;
+        }
     }
 
-    entries_ = std::move(minimizedEntries);
-    metadata_ = std::move(minimizedMetadata);
+    size_t before = entries_.size();
+    retain(keep);
+    return before - entries_.size();
+}
+
+void CorpusManager::retain(const std::vector<bool>& keep) {
+    size_t kept = 0;
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        if (!keep[i]) continue;
+        if (kept != i) {
+            entries_[kept] = std::move(entries_[i]);
+            metadata_[kept] = std::move(metadata_[i]);
+            features_[kept] = std::move(features_[i]);
+        }
+        ++kept;
+    }
+    entries_.resize(kept);
+    metadata_.resize(kept);
+    features_.resize(kept);
 }
 
 size_t CorpusManager::calculateCacheSize() const {
@@ -1095,26 +1302,38 @@ std::string FuzzUtils::sanitizeString(const std::string& str) {
 }
 
 size_t FuzzUtils::editDistance(const std::string& s1, const std::string& s2) {
-    const size_t m = s1.size();
-    const size_t n = s2.size();
-
-    std::vector<std::vector<size_t>> dp(m + 1, std::vector<size_t>(n + 1));
-
-    for (size_t i = 0; i <= m; ++i) {
-        for (size_t j = 0; j <= n; ++j) {
-            if (i == 0) {
-                dp[i][j] = j;
-            } else if (j == 0) {
-                dp[i][j] = i;
-            } else if (s1[i - 1] == s2[j - 1]) {
-                dp[i][j] = dp[i - 1][j - 1];
-            } else {
-                dp[i][j] = 1 + std::min({dp[i - 1][j], dp[i][j - 1], dp[i - 1][j - 1]});
-            }
+    std::string_view a = s1;
+    std::string_view b = s2;
+
+    // El prefijo y el sufijo comunes no cambian la distancia
+    size_t prefix = 0;
+    while (prefix < a.size() && prefix < b.size() && a[prefix] == b[prefix]) ++prefix;
+    a.remove_prefix(prefix);
+    b.remove_prefix(prefix);
+    while (!a.empty() && !b.empty() && a.back() == b.back()) {
+        a.remove_suffix(1);
+        b.remove_suffix(1);
+    }
+
+    if (a.size() < b.size()) std::swap(a, b);
+    if (b.empty()) return a.size();
+
+    // Una fila de la tabla, sobre la cadena corta
+    std::vector<size_t> row(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); ++j) row[j] = j;
+
+    for (size_t i = 1; i <= a.size(); ++i) {
+        size_t diagonal = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= b.size(); ++j) {
+            size_t above = row[j];
+            row[j] = a[i - 1] == b[j - 1] ? diagonal
+                                          : 1 + std::min({above, row[j - 1], diagonal});
+            diagonal = above;
         }
     }
 
-    return dp[m][n];
+    return row[b.size()];
 }
 
 bool FuzzUtils::isUniqueCrash(const FuzzResult& crash,
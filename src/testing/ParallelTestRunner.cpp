@@ -0,0 +1,426 @@
+/**
+ * @file ParallelTestRunner.cpp
+ * @brief Implementación del ejecutor de tests en procesos aislados
+ */
+
+#include <compiler/testing/ParallelTestRunner.h>
+#include <compiler/common/CacheFile.h>
+#include <compiler/common/utils/HashUtils.h>
+#include <compiler/common/utils/ThreadPool.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace cpp20::compiler::testing {
+
+namespace {
+
+// Solo se conserva el final de la salida de cada test: ahí está el fallo
+constexpr size_t kMaxOutputBytes = 64 * 1024;
+
+void appendJsonString(std::ostringstream& out, std::string_view text) {
+    out << '"';
+    for (char c : text) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            case '\r': out << "\\r"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out << "\\u00" << "0123456789abcdef"[(c >> 4) & 0xF] << "0123456789abcdef"[c & 0xF];
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
+
+#ifdef _WIN32
+
+std::string quoteArgument(const std::string& argument) {
+    if (!argument.empty() && argument.find_first_of(" \t\"") == std::string::npos) {
+        return argument;
+    }
+    std::string quoted = "\"";
+    for (char c : argument) {
+        if (c == '"') quoted += '\\';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+/**
+ * @brief Lanzar el test en un job object (al matarlo mueren también sus hijos)
+ */
+ParallelTestRunner::Result runProcess(const ParallelTestRunner::Test& test) {
+    static std::atomic<uint64_t> counter{0};
+    ParallelTestRunner::Result result;
+    result.name = test.name;
+
+    std::string commandLine;
+    for (const auto& argument : test.command) {
+        if (!commandLine.empty()) commandLine += ' ';
+        commandLine += quoteArgument(argument);
+    }
+
+    std::filesystem::path outputPath = std::filesystem::temp_directory_path() /
+        ("cpp20-test-" + std::to_string(GetCurrentProcessId()) + "-" + std::to_string(counter++) + ".log");
+    SECURITY_ATTRIBUTES inherit{sizeof(SECURITY_ATTRIBUTES), nullptr, TRUE};
+    HANDLE output = CreateFileA(outputPath.string().c_str(), GENERIC_READ | GENERIC_WRITE,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, &inherit,
+                                CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+    if (output == INVALID_HANDLE_VALUE) {
+        result.output = "no se pudo crear el archivo de salida";
+        return result;
+    }
+
+    STARTUPINFOA startup{};
+    startup.cb = sizeof(startup);
+    startup.dwFlags = STARTF_USESTDHANDLES;
+    startup.hStdOutput = output;
+    startup.hStdError = output;
+    PROCESS_INFORMATION process{};
+    HANDLE job = CreateJobObjectA(nullptr, nullptr);
+
+    auto start = std::chrono::steady_clock::now();
+    if (!CreateProcessA(nullptr, commandLine.data(), nullptr, nullptr, TRUE, CREATE_SUSPENDED,
+                        nullptr, nullptr, &startup, &process)) {
+        result.output = "no se pudo lanzar " + commandLine;
+        CloseHandle(job);
+        CloseHandle(output);
+        return result;
+    }
+    AssignProcessToJobObject(job, process.hProcess);
+    ResumeThread(process.hThread);
+
+    DWORD wait = WaitForSingleObject(process.hProcess, static_cast<DWORD>(test.timeout.count()));
+    bool timedOut = wait == WAIT_TIMEOUT;
+    if (timedOut) {
+        TerminateJobObject(job, 1);
+        WaitForSingleObject(process.hProcess, INFINITE);
+    }
+    result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    DWORD exitCode = 1;
+    GetExitCodeProcess(process.hProcess, &exitCode);
+    result.exitCode = static_cast<int>(exitCode);
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (K32GetProcessMemoryInfo(process.hProcess, &counters, sizeof(counters))) {
+        result.peakMemoryBytes = counters.PeakWorkingSetSize;
+    }
+    result.outcome = timedOut ? ParallelTestRunner::Outcome::TimedOut
+                   : exitCode == 0 ? ParallelTestRunner::Outcome::Passed
+                                   : ParallelTestRunner::Outcome::Failed;
+
+    LARGE_INTEGER size{};
+    GetFileSizeEx(output, &size);
+    LARGE_INTEGER offset{};
+    offset.QuadPart = std::max<LONGLONG>(0, size.QuadPart - static_cast<LONGLONG>(kMaxOutputBytes));
+    SetFilePointerEx(output, offset, nullptr, FILE_BEGIN);
+    result.output.resize(static_cast<size_t>(size.QuadPart - offset.QuadPart));
+    DWORD read = 0;
+    ReadFile(output, result.output.data(), static_cast<DWORD>(result.output.size()), &read, nullptr);
+    result.output.resize(read);
+
+    CloseHandle(process.hThread);
+    CloseHandle(process.hProcess);
+    CloseHandle(job);
+    CloseHandle(output);
+    return result;
+}
+
+#else
+
+/**
+ * @brief Lanzar el test en su propio grupo de procesos (al matarlo mueren también sus hijos)
+ */
+ParallelTestRunner::Result runProcess(const ParallelTestRunner::Test& test) {
+    ParallelTestRunner::Result result;
+    result.name = test.name;
+
+    // Archivo anónimo: se borra al crearlo y solo queda el descriptor
+    std::string pattern = (std::filesystem::temp_directory_path() / "cpp20-test-XXXXXX").string();
+    int output = mkostemp(pattern.data(), O_CLOEXEC);
+    if (output < 0) {
+        result.output = "no se pudo crear el archivo de salida";
+        return result;
+    }
+    unlink(pattern.c_str());
+
+    // Todo lo que el hijo necesita se prepara antes de fork(): el padre tiene otros hilos
+    std::vector<char*> argv;
+    for (const auto& argument : test.command) {
+        argv.push_back(const_cast<char*>(argument.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(output);
+        result.output = "fork() falló";
+        return result;
+    }
+    if (pid == 0) {
+        setpgid(0, 0);
+        int input = open("/dev/null", O_RDONLY);
+        dup2(input, STDIN_FILENO);
+        dup2(output, STDOUT_FILENO);
+        dup2(output, STDERR_FILENO);
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+    setpgid(pid, pid);
+
+    int status = 0;
+    struct rusage usage{};
+    bool timedOut = false;
+    auto deadline = start + test.timeout;
+    auto pause = std::chrono::microseconds(200);
+    while (true) {
+        pid_t done = wait4(pid, &status, WNOHANG, &usage);
+        if (done == pid || (done < 0 && errno != EINTR)) {
+            break;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            kill(-pid, SIGKILL);
+            while (wait4(pid, &status, 0, &usage) < 0 && errno == EINTR) {
+            }
+            timedOut = true;
+            break;
+        }
+        // Sondeo con espera creciente: los tests cortos no pagan 20 ms
+        std::this_thread::sleep_for(pause);
+        pause = std::min(pause * 2, std::chrono::microseconds(20000));
+    }
+    result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+#ifdef __APPLE__
+    result.peakMemoryBytes = static_cast<uint64_t>(usage.ru_maxrss);
+#else
+    result.peakMemoryBytes = static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+    if (WIFEXITED(status)) {
+        result.exitCode = WEXITSTATUS(status);
+    } else if (WIFSIGNALED(status)) {
+        result.exitCode = -WTERMSIG(status);
+    }
+    result.outcome = timedOut ? ParallelTestRunner::Outcome::TimedOut
+                   : result.exitCode == 0 ? ParallelTestRunner::Outcome::Passed
+                                          : ParallelTestRunner::Outcome::Failed;
+
+    off_t size = lseek(output, 0, SEEK_END);
+    off_t offset = std::max<off_t>(0, size - static_cast<off_t>(kMaxOutputBytes));
+    if (size > 0) {
+        result.output.resize(static_cast<size_t>(size - offset));
+        ssize_t read = pread(output, result.output.data(), result.output.size(), offset);
+        result.output.resize(read > 0 ? static_cast<size_t>(read) : 0);
+    }
+    close(output);
+    return result;
+}
+
+#endif
+
+} // namespace
+
+ParallelTestRunner::ParallelTestRunner(size_t jobs)
+    : jobs_(jobs > 0 ? jobs : common::utils::ThreadPool::defaultThreadCount()) {
+}
+
+void ParallelTestRunner::addTest(Test test) {
+    tests_.push_back(std::move(test));
+}
+
+size_t ParallelTestRunner::addGoogleTests(const std::filesystem::path& executable,
+                                          std::chrono::milliseconds timeout) {
+    Test list{executable.string(), {executable.string(), "--gtest_list_tests"}, std::chrono::seconds(30)};
+    Result listed = runIsolated(list);
+    if (listed.outcome != Outcome::Passed) {
+        return 0;
+    }
+
+    // "Suite." sin sangría y luego "  Test" por test, con "# GetParam() = ..." opcional
+    size_t added = 0;
+    std::string suite;
+    std::istringstream lines(listed.output);
+    std::string line;
+    while (std::getline(lines, line)) {
+        line = line.substr(0, line.find('#'));
+        while (!line.empty() && std::isspace(static_cast<unsigned char>(line.back()))) {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+        if (line[0] != ' ') {
+            suite = line;
+            continue;
+        }
+        std::string name = suite + line.substr(line.find_first_not_of(' '));
+        if (suite.empty() || name.find("DISABLED_") != std::string::npos) {
+            continue;
+        }
+        addTest(Test{name, {executable.string(), "--gtest_filter=" + name}, timeout});
+        ++added;
+    }
+    return added;
+}
+
+void ParallelTestRunner::setTimeout(std::string prefix, std::chrono::milliseconds timeout) {
+    timeouts_.emplace_back(std::move(prefix), timeout);
+}
+
+std::chrono::milliseconds ParallelTestRunner::timeoutFor(const Test& test) const {
+    std::chrono::milliseconds timeout = test.timeout;
+    size_t longest = 0;
+    for (const auto& [prefix, value] : timeouts_) {
+        if (prefix.size() >= longest && test.name.compare(0, prefix.size(), prefix) == 0) {
+            longest = prefix.size();
+            timeout = value;
+        }
+    }
+    return timeout;
+}
+
+std::vector<const ParallelTestRunner::Test*> ParallelTestRunner::schedule() const {
+    std::vector<const Test*> order;
+    for (const auto& test : tests_) {
+        order.push_back(&test);
+    }
+    std::stable_sort(order.begin(), order.end(), [this](const Test* a, const Test* b) {
+        const std::chrono::milliseconds* first = recordedDuration(a->name);
+        const std::chrono::milliseconds* second = recordedDuration(b->name);
+        if (!first || !second) {
+            return !first && second;
+        }
+        return *first > *second;
+    });
+    return order;
+}
+
+std::vector<ParallelTestRunner::Result> ParallelTestRunner::run() {
+    std::vector<const Test*> order = schedule();
+    std::vector<Result> results(tests_.size());
+    std::atomic<size_t> next{0};
+
+    auto worker = [&]() {
+        for (size_t i = next++; i < order.size(); i = next++) {
+            Test test = *order[i];
+            test.timeout = timeoutFor(test);
+            results[static_cast<size_t>(order[i] - tests_.data())] = runIsolated(test);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < std::min(jobs_, order.size()); ++i) {
+        workers.emplace_back(worker);
+    }
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    // Un timeout también se registra: la próxima vez ese test empieza de los primeros
+    for (const auto& result : results) {
+        history_[result.name] = result.duration;
+    }
+    return results;
+}
+
+ParallelTestRunner::Result ParallelTestRunner::runIsolated(const Test& test) {
+    if (test.command.empty()) {
+        Result result;
+        result.name = test.name;
+        result.output = "comando vacío";
+        return result;
+    }
+    return runProcess(test);
+}
+
+bool ParallelTestRunner::loadHistory(const std::filesystem::path& file) {
+    auto reader = CacheFileReader::open(file, FileKind);
+    if (!reader) {
+        return false;
+    }
+    for (size_t i = 0; i < reader->size(); ++i) {
+        auto record = reader->record(i);
+        if (!record) {
+            continue;
+        }
+        CacheRecordReader value(record->value);
+        std::chrono::milliseconds duration(static_cast<int64_t>(value.u64()));
+        if (value.ok()) {
+            history_[std::string(record->key)] = duration;
+        }
+    }
+    return true;
+}
+
+bool ParallelTestRunner::saveHistory(const std::filesystem::path& file) const {
+    CacheFileWriter writer;
+    for (const auto& [name, duration] : history_) {
+        CacheRecordWriter value;
+        value.u64(static_cast<uint64_t>(duration.count()));
+        writer.add(common::utils::fnv1a64(name), name, value.take());
+    }
+    return writer.write(file, FileKind);
+}
+
+const std::chrono::milliseconds* ParallelTestRunner::recordedDuration(const std::string& name) const {
+    auto it = history_.find(name);
+    return it != history_.end() ? &it->second : nullptr;
+}
+
+std::string ParallelTestRunner::formatJSON(const std::vector<Result>& results,
+                                           std::chrono::milliseconds wallTime) {
+    std::vector<const Result*> slowest;
+    for (const auto& result : results) {
+        slowest.push_back(&result);
+    }
+    std::stable_sort(slowest.begin(), slowest.end(), [](const Result* a, const Result* b) {
+        return a->duration > b->duration;
+    });
+
+    std::ostringstream out;
+    out << "{\n  \"wall_ms\": " << wallTime.count() << ",\n  \"tests\": [";
+    for (size_t i = 0; i < slowest.size(); ++i) {
+        const Result& result = *slowest[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+        appendJsonString(out, result.name);
+        out << ", \"outcome\": ";
+        appendJsonString(out, outcomeName(result.outcome));
+        out << ", \"exit_code\": " << result.exitCode
+            << ", \"time_ms\": " << result.duration.count()
+            << ", \"peak_memory_bytes\": " << result.peakMemoryBytes << "}";
+    }
+    out << "\n  ]\n}\n";
+    return out.str();
+}
+
+std::string_view ParallelTestRunner::outcomeName(Outcome outcome) {
+    switch (outcome) {
+        case Outcome::Passed: return "passed";
+        case Outcome::Failed: return "failed";
+        case Outcome::TimedOut: return "timeout";
+    }
+    return "failed";
+}
+
+} // namespace cpp20::compiler::testing
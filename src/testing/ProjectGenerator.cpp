@@ -0,0 +1,198 @@
+/**
+ * @file ProjectGenerator.cpp
+ * @brief Implementación del generador de proyectos sintéticos
+ */
+
+#include <compiler/testing/ProjectGenerator.h>
+#include <compiler/testing/FuzzingEngine.h>
+#include <fstream>
+#include <system_error>
+
+namespace cpp20::compiler::testing {
+
+namespace {
+
+std::string moduleName(size_t level, size_t index) {
+    return "m" + std::to_string(level) + "_" + std::to_string(index);
+}
+
+} // namespace
+
+std::vector<GeneratedFile> ProjectGenerator::generate() const {
+    std::vector<GeneratedFile> files;
+
+    for (size_t level = 0; level < shape_.includeDepth; ++level) {
+        files.push_back({std::filesystem::path("include") / ("chain" + std::to_string(level) + ".h"),
+                         makeChainHeader(level), GeneratedFile::Kind::Header});
+    }
+    if (shape_.templates > 0) {
+        files.push_back({std::filesystem::path("include") / "templates.h",
+                         makeTemplatesHeader(), GeneratedFile::Kind::Header});
+    }
+    if (shape_.constexprFunctions > 0) {
+        files.push_back({std::filesystem::path("include") / "constexpr.h",
+                         makeConstexprHeader(), GeneratedFile::Kind::Header});
+    }
+
+    // De las hojas a la raíz: cada interfaz ya tiene sus importaciones compiladas
+    if (shape_.moduleWidth > 0) {
+        for (size_t level = shape_.moduleDepth; level-- > 0;) {
+            for (size_t index = 0; index < shape_.moduleWidth; ++index) {
+                files.push_back({std::filesystem::path("modules") / (moduleName(level, index) + ".cppm"),
+                                 makeModule(level, index), GeneratedFile::Kind::ModuleInterface});
+            }
+        }
+    }
+
+    for (size_t unit = 0; unit < shape_.translationUnits; ++unit) {
+        files.push_back({std::filesystem::path("src") / ("unit" + std::to_string(unit) + ".cpp"),
+                         makeUnit(unit), GeneratedFile::Kind::Source});
+    }
+    return files;
+}
+
+bool ProjectGenerator::write(const std::filesystem::path& root, std::string* error) const {
+    auto fail = [&](const std::string& message) {
+        if (error) *error = message;
+        return false;
+    };
+
+    std::string buildOrder;
+    for (const auto& file : generate()) {
+        std::filesystem::path target = root / file.path;
+        std::error_code ec;
+        std::filesystem::create_directories(target.parent_path(), ec);
+        if (ec) {
+            return fail("no se puede crear " + target.parent_path().string() + ": " + ec.message());
+        }
+
+        std::ofstream out(target, std::ios::binary);
+        out << file.content;
+        if (!out) {
+            return fail("no se puede escribir " + target.string());
+        }
+        if (file.kind != GeneratedFile::Kind::Header) {
+            buildOrder += file.path.generic_string() + "\n";
+        }
+    }
+
+    std::ofstream list(root / "sources.txt", std::ios::binary);
+    list << buildOrder;
+    if (!list) {
+        return fail("no se puede escribir " + (root / "sources.txt").string());
+    }
+    return true;
+}
+
+std::string ProjectGenerator::makeChainHeader(size_t level) const {
+    std::string n = std::to_string(level);
+    std::string result = "#ifndef CHAIN" + n + "_H\n#define CHAIN" + n + "_H\n\n";
+    if (level + 1 < shape_.includeDepth) {
+        result += "#include \"chain" + std::to_string(level + 1) + ".h\"\n\n";
+    }
+    result += "#define CHAIN_BIAS" + n + " " + n + "\n";
+    result += "#define CHAIN_SCALE" + n + "(x) ((x) * " + std::to_string(level + 2) +
+              " + CHAIN_BIAS" + n + ")\n\n";
+    result += "inline int chainValue" + n + "(int x) { return CHAIN_SCALE" + n + "(x); }\n\n";
+    result += "#endif\n";
+    return result;
+}
+
+std::string ProjectGenerator::makeTemplatesHeader() const {
+    std::string result = "#pragma once\n\n";
+    for (size_t t = 0; t < shape_.templates; ++t) {
+        std::string n = std::to_string(t);
+        result += "template<int N>\nint tmpl" + n + "(int x) { return x * N + " + n + "; }\n\n";
+    }
+    return result;
+}
+
+std::string ProjectGenerator::makeConstexprHeader() const {
+    std::string result = "#pragma once\n\n";
+    for (size_t f = 0; f < shape_.constexprFunctions; ++f) {
+        std::string n = std::to_string(f);
+        result += "constexpr int cx" + n + "(int n) {\n"
+                  "    int s = 0;\n"
+                  "    for (int i = 0; i < n; ++i) {\n"
+                  "        s = (s + i * " + std::to_string(f + 1) + ") % 1000003;\n"
+                  "    }\n"
+                  "    return s;\n"
+                  "}\n\n";
+    }
+    return result;
+}
+
+std::string ProjectGenerator::makeModule(size_t level, size_t index) const {
+    std::string name = moduleName(level, index);
+    std::string result = "export module " + name + ";\n\n";
+
+    std::string sum = std::to_string(level * shape_.moduleWidth + index);
+    if (level + 1 < shape_.moduleDepth) {
+        for (size_t next = 0; next < shape_.moduleWidth; ++next) {
+            std::string imported = moduleName(level + 1, next);
+            result += "import " + imported + ";\n";
+            sum += " + " + imported + "_value()";
+        }
+        result += "\n";
+    }
+    result += "export int " + name + "_value() { return " + sum + "; }\n";
+    return result;
+}
+
+std::string ProjectGenerator::makeUnit(size_t unit) const {
+    std::string n = std::to_string(unit);
+    std::string result = "// Unidad " + n + " del proyecto sintético\n\n";
+
+    if (shape_.includeDepth > 0) result += "#include \"chain0.h\"\n";
+    if (shape_.templates > 0) result += "#include \"templates.h\"\n";
+    if (shape_.constexprFunctions > 0) result += "#include \"constexpr.h\"\n";
+    result += "\n";
+
+    bool importsModules = shape_.moduleWidth > 0 && shape_.moduleDepth > 0;
+    if (importsModules) {
+        for (size_t index = 0; index < shape_.moduleWidth; ++index) {
+            result += "import " + moduleName(0, index) + ";\n";
+        }
+        result += "\n";
+    }
+
+    if (shape_.fillerComplexity > 0) {
+        FuzzInputGenerator generator(shape_.seed * 1000003 + unit);
+        result += "namespace filler" + n + " {\n" +
+                  generator.generateGrammarBasedInput(FuzzTarget::Parser, shape_.fillerComplexity) +
+                  "\n} // namespace filler" + n + "\n\n";
+    }
+
+    // Argumento distinto por unidad: la memoización no cruza unidades
+    for (size_t f = 0; f < shape_.constexprFunctions; ++f) {
+        std::string fn = std::to_string(f);
+        result += "constexpr int unit" + n + "_cx" + fn + " = cx" + fn + "(" +
+                  std::to_string(shape_.constexprIterations + unit) + ");\n";
+    }
+    if (shape_.constexprFunctions > 0) result += "\n";
+
+    result += "int unit" + n + "_value(int x) {\n    int total = x;\n";
+    for (size_t level = 0; level < shape_.includeDepth; ++level) {
+        result += "    total += chainValue" + std::to_string(level) + "(x);\n";
+    }
+    size_t units = shape_.translationUnits > 0 ? shape_.translationUnits : 1;
+    for (size_t t = 0; t < shape_.templates; ++t) {
+        for (size_t k = 0; k < shape_.instantiationsPerTemplate; ++k) {
+            if ((t * shape_.instantiationsPerTemplate + k) % units == unit) {
+                result += "    total += tmpl" + std::to_string(t) + "<" + std::to_string(k) + ">(x);\n";
+            }
+        }
+    }
+    for (size_t f = 0; f < shape_.constexprFunctions; ++f) {
+        result += "    total += unit" + n + "_cx" + std::to_string(f) + ";\n";
+    }
+    if (importsModules) {
+        for (size_t index = 0; index < shape_.moduleWidth; ++index) {
+            result += "    total += " + moduleName(0, index) + "_value();\n";
+        }
+    }
+    result += "    return total;\n}\n";
+    return result;
+}
+
+} // namespace cpp20::compiler::testing
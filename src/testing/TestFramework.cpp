@@ -4,6 +4,9 @@
  */
 
 #include <compiler/testing/TestFramework.h>
+#include <compiler/backend/coff/COFFTypes.h>
+#include <compiler/backend/link/MiniLinker.h>
+#include <compiler/common/utils/MemoryTracker.h>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -11,6 +14,8 @@
 #include <thread>
 #include <future>
 #include <regex>
+#include <charconv>
+#include <iomanip>
 
 namespace cpp20::compiler::testing {
 
@@ -215,7 +220,7 @@ void TestFramework::setOutputDirectory(const std::filesystem::path& outputDir) {
     std::filesystem::create_directories(outputDirectory_);
 }
 
-void TestFramework::setCompilerDriver(std::unique_ptr<driver::CompilerDriver> driver) {
+void TestFramework::setCompilerDriver(std::unique_ptr<CompilerDriver> driver) {
     compilerDriver_ = std::move(driver);
 }
 
@@ -277,6 +282,39 @@ std::string TestFramework::generateTextReport(const std::vector<TestResult>& res
     return ss.str();
 }
 
+// ============================================================================
+// PerformanceMetrics - Implementación
+// ============================================================================
+
+std::string PerformanceMetrics::format() const {
+    std::ostringstream out;
+    out << std::setprecision(17);
+    for (const auto& [name, value] : values) {
+        out << name << ' ' << value << '\n';
+    }
+    return out.str();
+}
+
+std::optional<PerformanceMetrics> PerformanceMetrics::parse(std::string_view text) {
+    PerformanceMetrics metrics;
+    while (!text.empty()) {
+        size_t end = text.find('\n');
+        std::string_view line = text.substr(0, end);
+        text = end == std::string_view::npos ? std::string_view() : text.substr(end + 1);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.empty()) continue;
+
+        size_t space = line.find(' ');
+        if (space == 0 || space == std::string_view::npos) return std::nullopt;
+        std::string_view number = line.substr(space + 1);
+        double value = 0;
+        auto [ptr, ec] = std::from_chars(number.data(), number.data() + number.size(), value);
+        if (ec != std::errc() || ptr != number.data() + number.size()) return std::nullopt;
+        metrics.values[std::string(line.substr(0, space))] = value;
+    }
+    return metrics;
+}
+
 // ============================================================================
 // GoldenTestRunner - Implementación
 // ============================================================================
@@ -306,6 +344,35 @@ TestResult GoldenTestRunner::runGoldenTest(const std::filesystem::path& testFile
                              "Our output: " + ourOutput};
         }
 
+        // Presupuesto de rendimiento, solo si el test lo tiene
+        std::ifstream budgetFile(performanceFileFor(testFile));
+        if (budgetFile) {
+            std::string text((std::istreambuf_iterator<char>(budgetFile)),
+                             std::istreambuf_iterator<char>());
+            auto budget = PerformanceMetrics::parse(text);
+            if (!budget) {
+                result.passed = false;
+                result.errorMessage = "Malformed performance budget";
+                return result;
+            }
+
+            PerformanceMetrics actual = measurePerformance(testFile);
+            for (const auto& [name, value] : actual.values) {
+                std::ostringstream formatted;
+                formatted << value;
+                result.metadata["perf." + name] = formatted.str();
+            }
+
+            auto regressions = checkPerformance(*budget, actual, tolerance_);
+            if (!regressions.empty()) {
+                if (result.passed) {
+                    result.errorMessage = "Performance regression";
+                }
+                result.passed = false;
+                result.details.insert(result.details.end(), regressions.begin(), regressions.end());
+            }
+        }
+
     } catch (const std::exception& e) {
         result.passed = false;
         result.errorMessage = std::string("Exception: ") + e.what();
@@ -335,6 +402,108 @@ bool GoldenTestRunner::updateGoldenFiles(const std::vector<std::filesystem::path
     return true;
 }
 
+PerformanceMetrics GoldenTestRunner::measurePerformance(const std::filesystem::path& testFile) {
+    using common::utils::MemoryTracker;
+    PerformanceMetrics metrics;
+
+    // La primera compilación mide también el pico sobre lo que ya estaba vivo
+    bool trackerWasEnabled = MemoryTracker::isEnabled();
+    MemoryTracker::setEnabled(true);
+    size_t baseline = MemoryTracker::totalCurrent();
+    size_t window = MemoryTracker::beginPeakWindow();
+
+    double bestMillis = 0;
+    for (size_t run = 0; run < timingRepetitions_; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        compileWithOurCompiler(testFile);
+        double millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        bestMillis = run == 0 ? millis : std::min(bestMillis, millis);
+
+        if (run == 0) {
+            size_t peak = MemoryTracker::endPeakWindow(window);
+            MemoryTracker::setEnabled(trackerWasEnabled);
+            metrics.values["memory.peak_bytes"] = static_cast<double>(peak > baseline ? peak - baseline : 0);
+        }
+    }
+    metrics.values["compile.ms"] = bestMillis;
+
+    backend::link::ObjectFileInfo object(objectFileFor(testFile));
+    if (backend::link::COFFReader::readObjectFile(object.path, object)) {
+        double textBytes = 0;
+        for (size_t index = 0; index < object.sections.size(); ++index) {
+            const auto& section = object.sections[index];
+            if (!(section.characteristics & backend::coff::IMAGE_SCN_CNT_CODE)) continue;
+            textBytes += section.rawSize;
+
+            // Cada función llega hasta el siguiente símbolo de su sección
+            std::vector<std::pair<uint32_t, std::string_view>> functions;
+            for (const auto& symbol : object.symbols) {
+                if (symbol.sectionNumber == static_cast<int16_t>(index + 1) &&
+                    symbol.type == backend::coff::IMAGE_SYM_DTYPE_FUNCTION) {
+                    functions.emplace_back(symbol.value, symbol.name);
+                }
+            }
+            std::sort(functions.begin(), functions.end());
+            for (size_t i = 0; i < functions.size(); ++i) {
+                uint32_t end = i + 1 < functions.size() ? functions[i + 1].first : section.rawSize;
+                metrics.values["code.function_bytes." + std::string(functions[i].second)] =
+                    static_cast<double>(end > functions[i].first ? end - functions[i].first : 0);
+            }
+        }
+        metrics.values["code.text_bytes"] = textBytes;
+    }
+
+    return metrics;
+}
+
+bool GoldenTestRunner::recordPerformance(const std::vector<std::filesystem::path>& testFiles) {
+    for (const auto& testFile : testFiles) {
+        std::ofstream file(performanceFileFor(testFile));
+        file << measurePerformance(testFile).format();
+        if (!file) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<std::string> GoldenTestRunner::checkPerformance(const PerformanceMetrics& budget,
+                                                            const PerformanceMetrics& actual,
+                                                            const PerformanceTolerance& tolerance) {
+    std::vector<std::string> regressions;
+    for (const auto& [name, limit] : budget.values) {
+        auto it = actual.values.find(name);
+        if (it == actual.values.end()) continue;
+
+        double relative = tolerance.codeSize;
+        double slack = 0;
+        if (name.rfind("compile.", 0) == 0) {
+            relative = tolerance.compileTime;
+            slack = tolerance.compileTimeSlackMs;
+        } else if (name.rfind("memory.", 0) == 0) {
+            relative = tolerance.memory;
+        }
+
+        double allowed = limit * (1.0 + relative) + slack;
+        if (it->second > allowed) {
+            std::ostringstream line;
+            line << name << ": " << it->second << " > " << limit << " (+"
+                 << relative * 100 << "%" << (slack > 0 ? ", +" + std::to_string(static_cast<int>(slack)) + " ms" : "")
+                 << ")";
+            regressions.push_back(line.str());
+        }
+    }
+    return regressions;
+}
+
+std::filesystem::path GoldenTestRunner::objectFileFor(const std::filesystem::path& testFile) const {
+    return testDataDir_ / (testFile.stem().string() + ".obj");
+}
+
+std::filesystem::path GoldenTestRunner::performanceFileFor(const std::filesystem::path& testFile) const {
+    return testDataDir_ / (testFile.filename().string() + ".perf");
+}
+
 std::vector<std::filesystem::path> GoldenTestRunner::getAvailableTests() const {
     std::vector<std::filesystem::path> tests;
 
@@ -51,6 +51,7 @@ bool Type::equals(const Type* other) const {
 
 bool Type::compatible(const Type* other) const {
     // Basic compatibility check
+    if (this == other) return true;
     if (!other) return false;
     return kind_ == other->kind_;
 }
@@ -59,84 +60,110 @@ bool Type::compatible(const Type* other) const {
 // BasicType implementation
 // ========================================================================
 
-class BasicType : public Type {
-public:
-    enum class BasicKind {
-        Void,
-        Bool,
-        Char,
-        Short,
-        Int,
-        Long,
-        LongLong,
-        Float,
-        Double,
-        LongDouble
-    };
-
-    BasicType(BasicKind basicKind, CVQualifier cv = CVQualifier::None)
-        : Type(Kind::Basic, cv), basicKind_(basicKind) {}
-
-    std::string toString() const override {
-        std::string result;
-        switch (basicKind_) {
-            case BasicKind::Void: result = "void"; break;
-            case BasicKind::Bool: result = "bool"; break;
-            case BasicKind::Char: result = "char"; break;
-            case BasicKind::Short: result = "short"; break;
-            case BasicKind::Int: result = "int"; break;
-            case BasicKind::Long: result = "long"; break;
-            case BasicKind::LongLong: result = "long long"; break;
-            case BasicKind::Float: result = "float"; break;
-            case BasicKind::Double: result = "double"; break;
-            case BasicKind::LongDouble: result = "long double"; break;
-        }
-
-        // Add CV qualifiers
-        if (cv() == CVQualifier::Const) result = "const " + result;
-        else if (cv() == CVQualifier::Volatile) result = "volatile " + result;
-        else if (cv() == CVQualifier::ConstVolatile) result = "const volatile " + result;
-
-        return result;
-    }
+namespace {
 
-    size_t size() const override {
-        switch (basicKind_) {
-            case BasicKind::Void: return 0;
-            case BasicKind::Bool: return 1;
-            case BasicKind::Char: return 1;
-            case BasicKind::Short: return 2;
-            case BasicKind::Int: return 4;
-            case BasicKind::Long: return 8;
-            case BasicKind::LongLong: return 8;
-            case BasicKind::Float: return 4;
-            case BasicKind::Double: return 8;
-            case BasicKind::LongDouble: return 16;
-        }
-        return 0;
+std::string cvPrefix(CVQualifier cv) {
+    switch (cv) {
+        case CVQualifier::Const: return "const ";
+        case CVQualifier::Volatile: return "volatile ";
+        case CVQualifier::ConstVolatile: return "const volatile ";
+        case CVQualifier::None: break;
     }
+    return "";
+}
 
-    size_t alignment() const override {
-        return size();  // Basic types are self-aligned
+} // namespace
+
+std::string BasicType::toString() const {
+    std::string result;
+    switch (basicKind_) {
+        case BasicKind::Void: result = "void"; break;
+        case BasicKind::Bool: result = "bool"; break;
+        case BasicKind::Char: result = "char"; break;
+        case BasicKind::Short: result = "short"; break;
+        case BasicKind::Int: result = "int"; break;
+        case BasicKind::Long: result = "long"; break;
+        case BasicKind::LongLong: result = "long long"; break;
+        case BasicKind::Float: result = "float"; break;
+        case BasicKind::Double: result = "double"; break;
+        case BasicKind::LongDouble: result = "long double"; break;
     }
 
-    bool isComplete() const override {
-        return basicKind_ != BasicKind::Void;
-    }
+    // Add CV qualifiers
+    return cvPrefix(cv()) + result;
+}
 
-    bool equals(const Type* other) const override {
-        if (!Type::equals(other)) return false;
-        auto* basicOther = dynamic_cast<const BasicType*>(other);
-        return basicOther && basicKind_ == basicOther->basicKind_;
+size_t BasicType::size() const {
+    switch (basicKind_) {
+        case BasicKind::Void: return 0;
+        case BasicKind::Bool: return 1;
+        case BasicKind::Char: return 1;
+        case BasicKind::Short: return 2;
+        case BasicKind::Int: return 4;
+        case BasicKind::Long: return 8;
+        case BasicKind::LongLong: return 8;
+        case BasicKind::Float: return 4;
+        case BasicKind::Double: return 8;
+        case BasicKind::LongDouble: return 16;
     }
+    return 0;
+}
+
+size_t BasicType::alignment() const {
+    return size();  // Basic types are self-aligned
+}
+
+bool BasicType::isComplete() const {
+    return basicKind_ != BasicKind::Void;
+}
+
+bool BasicType::equals(const Type* other) const {
+    if (!Type::equals(other)) return false;
+    auto* basicOther = dynamic_cast<const BasicType*>(other);
+    return basicOther && basicKind_ == basicOther->basicKind_;
+}
+
+std::unique_ptr<Type> BasicType::withCV(CVQualifier cv) const {
+    return std::make_unique<BasicType>(basicKind_, cv);
+}
 
-    std::unique_ptr<Type> withCV(CVQualifier cv) const override {
-        return std::make_unique<BasicType>(basicKind_, cv);
+// ========================================================================
+// PointerType / ReferenceType implementation
+// ========================================================================
+
+std::string PointerType::toString() const {
+    std::string result = (pointee_ ? pointee_->toString() : "<null>") + "*";
+    std::string qualifiers = cvPrefix(cv());
+    if (!qualifiers.empty()) {
+        result += " " + qualifiers.substr(0, qualifiers.size() - 1);
     }
+    return result;
+}
 
-private:
-    BasicKind basicKind_;
-};
+bool PointerType::equals(const Type* other) const {
+    if (!Type::equals(other)) return false;
+    auto* pointerOther = dynamic_cast<const PointerType*>(other);
+    return pointerOther && isSameType(pointee_, pointerOther->pointee_);
+}
+
+std::unique_ptr<Type> PointerType::withCV(CVQualifier cv) const {
+    return std::make_unique<PointerType>(pointee_, cv);
+}
+
+std::string ReferenceType::toString() const {
+    return (referee_ ? referee_->toString() : "<null>") + (isRValue_ ? "&&" : "&");
+}
+
+bool ReferenceType::equals(const Type* other) const {
+    if (!Type::equals(other)) return false;
+    auto* referenceOther = dynamic_cast<const ReferenceType*>(other);
+    return referenceOther && isRValue_ == referenceOther->isRValue_ &&
+           isSameType(referee_, referenceOther->referee_);
+}
+
+std::unique_ptr<Type> ReferenceType::withCV(CVQualifier) const {
+    return std::make_unique<ReferenceType>(referee_, isRValue_);
+}
 
 // ========================================================================
 // Factory functions
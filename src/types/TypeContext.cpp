@@ -0,0 +1,86 @@
+/**
+ * @file TypeContext.cpp
+ * @brief Unificación de tipos (hash-consing) por unidad de traducción
+ */
+
+#include <compiler/types/TypeContext.h>
+#include <compiler/common/utils/HashUtils.h>
+
+namespace cpp20::compiler::types {
+
+size_t TypeContext::KeyHash::operator()(const Key& key) const {
+    size_t hash = common::utils::hashPointer(key.element);
+    hash = common::utils::hashCombine(hash, static_cast<size_t>(key.kind));
+    hash = common::utils::hashCombine(hash, static_cast<size_t>(key.cv) * 2 + key.isRValue);
+    return hash;
+}
+
+TypeContext::TypeContext() {
+    // Los fundamentales se crean por adelantado: buscarlos es indexar un array
+    for (size_t kind = 0; kind < BasicType::BasicKindCount; ++kind) {
+        for (size_t cv = 0; cv < 4; ++cv) {
+            basicTypes_[kind * 4 + cv] = create<BasicType>(static_cast<BasicType::BasicKind>(kind),
+                                                           static_cast<CVQualifier>(cv));
+        }
+    }
+}
+
+const PointerType* TypeContext::getPointerType(const Type* pointee, CVQualifier cv) {
+    pointee = getCanonicalType(pointee);
+
+    Key key{Type::Kind::Pointer, cv, false, pointee};
+    auto it = derivedTypes_.find(key);
+    if (it != derivedTypes_.end()) {
+        return static_cast<const PointerType*>(it->second);
+    }
+
+    const PointerType* type = create<PointerType>(pointee, cv);
+    derivedTypes_.emplace(key, type);
+    return type;
+}
+
+const ReferenceType* TypeContext::getReferenceType(const Type* referee, bool isRValue) {
+    referee = getCanonicalType(referee);
+
+    Key key{Type::Kind::Reference, CVQualifier::None, isRValue, referee};
+    auto it = derivedTypes_.find(key);
+    if (it != derivedTypes_.end()) {
+        return static_cast<const ReferenceType*>(it->second);
+    }
+
+    const ReferenceType* type = create<ReferenceType>(referee, isRValue);
+    derivedTypes_.emplace(key, type);
+    return type;
+}
+
+const Type* TypeContext::getQualifiedType(const Type* type, CVQualifier cv) {
+    type = getCanonicalType(type);
+    if (!type || type->cv() == cv) return type;
+
+    switch (type->kind()) {
+        case Type::Kind::Basic:
+            return getBasicType(static_cast<const BasicType*>(type)->basicKind(), cv);
+        case Type::Kind::Pointer:
+            return getPointerType(static_cast<const PointerType*>(type)->pointee(), cv);
+        default:
+            return type;
+    }
+}
+
+const Type* TypeContext::getCanonicalType(const Type* type) {
+    if (!type || type->isCanonical()) return type;
+
+    // Solo se unifican las clases concretas que existen; el resto no cambia
+    if (auto* basic = dynamic_cast<const BasicType*>(type)) {
+        return getBasicType(basic->basicKind(), basic->cv());
+    }
+    if (auto* pointer = dynamic_cast<const PointerType*>(type)) {
+        return getPointerType(pointer->pointee(), pointer->cv());
+    }
+    if (auto* reference = dynamic_cast<const ReferenceType*>(type)) {
+        return getReferenceType(reference->referee(), reference->isRValue());
+    }
+    return type;
+}
+
+} // namespace cpp20::compiler::types
@@ -4,9 +4,14 @@
  */
 
 #include <compiler/backend/abi/ABIContract.h>
+#include <compiler/backend/frame/FrameBuilder.h>
 #include <gtest/gtest.h>
 
 using namespace cpp20::compiler::backend::abi;
+using cpp20::compiler::backend::FrameBuilder;
+using cpp20::compiler::backend::FrameLayout;
+using cpp20::compiler::backend::FrameRequirements;
+using cpp20::compiler::backend::StackSlot;
 
 class ABIContractTest : public ::testing::Test {
 protected:
@@ -63,6 +68,75 @@ TEST_F(ABIContractTest, ClassifyLargeAggregate) {
     EXPECT_EQ(param.size, 24u);
 }
 
+TEST_F(ABIContractTest, Win64PassesSmallAggregatesAsIntegers) {
+    using ValueType = ABIContract::ValueType;
+
+    // struct Handle { uint32_t id; } y struct { float x, y; }: en registro entero
+    for (const ValueType& type : {ValueType::aggregate(4, 4), ValueType::aggregate(8, 4, 2)}) {
+        auto param = ABIContract::classifyParameter(type);
+        EXPECT_EQ(param.kind, ABIContract::ParameterInfo::Kind::Aggregate);
+        EXPECT_FALSE(param.byReference);
+        EXPECT_FALSE(param.usesXmm);
+    }
+
+    // 3, 12 y 16 bytes, y __m128, por referencia
+    EXPECT_TRUE(ABIContract::classifyParameter(ValueType::aggregate(3, 1)).byReference);
+    EXPECT_TRUE(ABIContract::classifyParameter(ValueType::aggregate(12, 4)).byReference);
+    EXPECT_TRUE(ABIContract::classifyParameter(ValueType::aggregate(16, 8)).byReference);
+    EXPECT_TRUE(ABIContract::classifyParameter(16, 16, true).byReference);
+
+    // Posicional: el double de la segunda posición va en XMM1 y el puntero
+    // de retorno oculto desplaza al resto
+    auto params = ABIContract::classifyParameters(
+        {ValueType::aggregate(8, 8), ValueType::floating(8), ValueType::integer(4), ValueType::integer(4)},
+        ABIContract::CallingConvention::Win64, true);
+    ASSERT_EQ(params.size(), 4u);
+    EXPECT_EQ(params[0].registerIndex, 1);
+    EXPECT_TRUE(params[1].usesXmm);
+    EXPECT_EQ(params[1].registerIndex, 2);
+    EXPECT_EQ(params[2].registerIndex, 3);
+    EXPECT_FALSE(params[3].inRegister);
+}
+
+TEST_F(ABIContractTest, InternalFastcallUsesMoreRegisters) {
+    using ValueType = ABIContract::ValueType;
+    constexpr auto Fastcall = ABIContract::CallingConvention::InternalFastcall;
+
+    EXPECT_EQ(ABIContract::conventionFor(true, false, true), Fastcall);
+    EXPECT_EQ(ABIContract::conventionFor(true, true, true), ABIContract::CallingConvention::Win64);
+    EXPECT_EQ(ABIContract::conventionFor(false, false, true), ABIContract::CallingConvention::Win64);
+    EXPECT_EQ(ABIContract::conventionFor(true, false, false), ABIContract::CallingConvention::Win64);
+
+    // Span {ptr, size} en dos registros, la pareja de float en un XMM y el
+    // resto de enteros hasta R11
+    auto params = ABIContract::classifyParameters(
+        {ValueType::aggregate(16, 8), ValueType::aggregate(8, 4, 2), ValueType::aggregate(16, 8, 2),
+         ValueType::integer(8), ValueType::integer(8), ValueType::integer(8), ValueType::integer(8),
+         ValueType::integer(8)},
+        Fastcall);
+    ASSERT_EQ(params.size(), 8u);
+    EXPECT_EQ(params[0].registerIndex, 0);
+    EXPECT_EQ(params[0].registerCount, 2);
+    EXPECT_FALSE(params[0].byReference);
+    EXPECT_TRUE(params[1].usesXmm);
+    EXPECT_EQ(params[1].registerIndex, 0);
+    EXPECT_TRUE(params[2].usesXmm);
+    EXPECT_EQ(params[2].registerIndex, 1);
+    EXPECT_EQ(params[2].registerCount, 2);
+    EXPECT_EQ(ABIContract::getIntegerArgRegister(params[6].registerIndex, Fastcall), "r11");
+    EXPECT_FALSE(params[7].inRegister);
+
+    // Retornos: Span en RAX:RDX y la pareja de double en XMM0:XMM1
+    auto span = ABIContract::classifyReturn(ValueType::aggregate(16, 8), Fastcall);
+    EXPECT_FALSE(span.isIndirect);
+    EXPECT_EQ(span.kind, ABIContract::ReturnInfo::Kind::Integer);
+    EXPECT_EQ(span.registerCount, 2);
+    auto pair = ABIContract::classifyReturn(ValueType::aggregate(16, 8, 2), Fastcall);
+    EXPECT_EQ(pair.kind, ABIContract::ReturnInfo::Kind::Float);
+    EXPECT_EQ(pair.registerCount, 2);
+    EXPECT_TRUE(ABIContract::classifyReturn(ValueType::aggregate(16, 8)).isIndirect);
+}
+
 // ========================================================================
 // Tests para clasificación de retornos
 // ========================================================================
@@ -88,6 +162,19 @@ TEST_F(ABIContractTest, ClassifyFloatReturn) {
     EXPECT_FALSE(ret.isIndirect);
 }
 
+TEST_F(ABIContractTest, SmallPODAggregateReturnsInRAX) {
+    auto handle = ABIContract::classifyReturn(ABIContract::ValueType::aggregate(8, 8));
+    EXPECT_EQ(handle.kind, ABIContract::ReturnInfo::Kind::Integer);
+    EXPECT_EQ(handle.underlyingKind, ABIContract::ParameterInfo::Kind::Aggregate);
+    EXPECT_FALSE(handle.isIndirect);
+
+    // Con constructor propio (no POD) o de 12 bytes, por referencia
+    auto nonPod = ABIContract::ValueType::aggregate(8, 8);
+    nonPod.isPOD = false;
+    EXPECT_TRUE(ABIContract::classifyReturn(nonPod).isIndirect);
+    EXPECT_TRUE(ABIContract::classifyReturn(12, 4, false, true).isIndirect);
+}
+
 TEST_F(ABIContractTest, ClassifyAggregateReturn) {
     // Structs pasan por referencia
     auto ret = ABIContract::classifyReturn(16, 8, false, true);  // struct de 16 bytes
@@ -228,6 +315,71 @@ TEST_F(ABIContractTest, ABIConstants) {
     EXPECT_EQ(ABIContract::GENERAL_ALIGNMENT, 8u);
 }
 
+// ========================================================================
+// Tests para marcos de función
+// ========================================================================
+
+TEST_F(ABIContractTest, LeafFunctionHasNoFrame) {
+    FrameRequirements requirements;
+    auto frame = FrameBuilder().buildFunctionFrame(requirements);
+    EXPECT_TRUE(frame.isLeaf);
+    EXPECT_EQ(frame.allocationSize, 0u);
+    EXPECT_EQ(frame.frameRegister(), 4);    // RSP
+}
+
+TEST_F(ABIContractTest, FrameSavesOnlyUsedRegistersAndAlignsCalls) {
+    FrameRequirements requirements;
+    requirements.makesCalls = true;
+    requirements.usedCalleeSaved = {12, 3};  // R12, RBX
+    auto frame = FrameBuilder().buildFunctionFrame(requirements);
+
+    EXPECT_FALSE(frame.isLeaf);
+    EXPECT_FALSE(frame.usesFramePointer);
+    EXPECT_EQ(frame.savedRegisters, (std::vector<uint8_t>{3, 12}));
+    EXPECT_EQ(frame.shadowSpaceSize, ABIContract::SHADOW_SPACE_SIZE);
+    // Dirección de retorno + 2 PUSH + reserva: múltiplo de 16 en cada CALL
+    EXPECT_EQ((8 + 16 + frame.allocationSize) % ABIContract::STACK_ALIGNMENT, 0u);
+    EXPECT_EQ(frame.allocationSize, 40u);
+}
+
+TEST_F(ABIContractTest, FramePointerOnlyWhenRequired) {
+    FrameRequirements requirements;
+    requirements.localSize = 12;
+    auto frame = FrameBuilder().buildFunctionFrame(requirements);
+    EXPECT_FALSE(frame.usesFramePointer);
+    EXPECT_EQ(frame.shadowSpaceSize, 0u);
+    EXPECT_EQ(frame.localOffset(0), 0);
+
+    requirements.needsFramePointer = true;
+    frame = FrameBuilder().buildFunctionFrame(requirements);
+    EXPECT_TRUE(frame.usesFramePointer);
+    EXPECT_EQ(frame.savedRegisters, (std::vector<uint8_t>{5}));
+    EXPECT_EQ(frame.frameRegister(), 5);    // RBP
+}
+
+TEST_F(ABIContractTest, StackSlotsShareColorsAndSortByAlignment) {
+    // Dos escalares que no conviven (color 0), un vector de 16 y un slot ancho
+    std::vector<StackSlot> slots = {
+        {8, 8, 0, 0}, {8, 8, 2, 0}, {16, 16, 1, 0}, {8, 8, 0, 0}, {32, 32, 3, 0},
+    };
+    size_t size = FrameBuilder::layoutStackSlots(slots);
+    EXPECT_EQ(size, 64u);                   // 32 + 16 + 8 + 8, sin relleno entre posiciones
+    EXPECT_EQ(slots[4].offset, 0u);         // Alineación limitada a 16: va primero por tamaño
+    EXPECT_EQ(slots[2].offset, 32u);
+    EXPECT_EQ(slots[0].offset, slots[3].offset);
+    EXPECT_EQ(slots[0].offset % 8, 0u);
+    EXPECT_NE(slots[0].offset, slots[1].offset);
+    EXPECT_EQ(FrameBuilder::layoutStackSlots(slots = {}), 0u);
+}
+
+TEST_F(ABIContractTest, StackProbeOnlyFromOnePage) {
+    FrameRequirements requirements;
+    requirements.localSize = FrameLayout::PageSize - 64;
+    EXPECT_FALSE(FrameBuilder().buildFunctionFrame(requirements).needsStackProbe());
+    requirements.localSize = FrameLayout::PageSize;
+    EXPECT_TRUE(FrameBuilder().buildFunctionFrame(requirements).needsStackProbe());
+}
+
 // ========================================================================
 // Tests para mensajes de error de validación
 // ========================================================================
@@ -0,0 +1,159 @@
+/**
+ * @file test_ast.cpp
+ * @brief Tests para el AST en arena y el visitor sin vtables
+ */
+
+#include <compiler/ast/ASTContext.h>
+#include <compiler/ast/ASTVisitor.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace cpp20::compiler;
+using namespace cpp20::compiler::ast;
+
+namespace {
+
+/**
+ * @brief Cuenta nodos por tipo; el resto se recorre con visitNode
+ */
+struct NodeCounter : ASTVisitor<NodeCounter> {
+    size_t total = 0;
+    size_t integers = 0;
+    size_t binaries = 0;
+
+    void visitNode(ASTNode* node) {
+        ++total;
+        visitChildren(node);
+    }
+
+    void visitIntegerLiteral(IntegerLiteral* node) {
+        ++integers;
+        visitNode(node);
+    }
+
+    void visitBinaryOp(BinaryOp* node) {
+        ++binaries;
+        visitNode(node);
+    }
+};
+
+/**
+ * @brief Evalúa expresiones enteras devolviendo un valor desde visit()
+ */
+struct Evaluator : ASTVisitor<Evaluator, int64_t> {
+    int64_t visitIntegerLiteral(IntegerLiteral* node) { return node->getValue(); }
+
+    int64_t visitBinaryOp(BinaryOp* node) {
+        int64_t left = visit(node->getLeft());
+        int64_t right = visit(node->getRight());
+        switch (node->getOp()) {
+            case BinaryOp::OpKind::Add: return left + right;
+            case BinaryOp::OpKind::Multiply: return left * right;
+            default: return 0;
+        }
+    }
+};
+
+class ASTTest : public ::testing::Test {
+protected:
+    ASTContext context_;
+    diagnostics::SourceLocation loc_;
+
+    IntegerLiteral* integer(int64_t value) { return context_.create<IntegerLiteral>(value, loc_); }
+
+    // 1 + 2 * 3
+    ASTNode* sampleExpression() {
+        auto* product = context_.create<BinaryOp>(integer(2), integer(3), BinaryOp::OpKind::Multiply, loc_);
+        return context_.create<BinaryOp>(integer(1), product, BinaryOp::OpKind::Add, loc_);
+    }
+};
+
+} // namespace
+
+TEST_F(ASTTest, NodesAreTriviallyDestructible) {
+    EXPECT_TRUE(std::is_trivially_destructible_v<BinaryOp>);
+    EXPECT_TRUE(std::is_trivially_destructible_v<FunctionDecl>);
+    EXPECT_TRUE(std::is_trivially_destructible_v<CompoundStmt>);
+    EXPECT_FALSE(std::is_polymorphic_v<ASTNode>);
+}
+
+TEST_F(ASTTest, ContextCountsCreatedNodes) {
+    sampleExpression();
+    EXPECT_EQ(context_.nodeCount(), 5u);
+}
+
+TEST_F(ASTTest, ToStringDispatchesByKind) {
+    ASTNode* expr = sampleExpression();
+    EXPECT_EQ(expr->kind(), ASTNodeKind::BinaryOp);
+    EXPECT_EQ(expr->toString(), "(1 + (2 * 3))");
+    EXPECT_STREQ(nodeKindName(expr->kind()), "BinaryOp");
+}
+
+TEST_F(ASTTest, StringsAndListsLiveInTheArena) {
+    std::string name = "counter";
+    std::string_view copy = context_.copyString(name);
+    name = "overwritten";
+    EXPECT_EQ(copy, "counter");
+
+    std::vector<ASTNode*> statements = {
+        context_.create<ExprStmt>(integer(1), loc_),
+        context_.create<ReturnStmt>(integer(2), loc_),
+    };
+    NodeList<> list = context_.makeList(statements);
+    statements.clear();
+
+    ASSERT_EQ(list.size(), 2u);
+    EXPECT_EQ(list[0]->kind(), ASTNodeKind::ExprStmt);
+    EXPECT_EQ(list[1]->kind(), ASTNodeKind::ReturnStmt);
+    EXPECT_TRUE(context_.makeList(std::vector<ASTNode*>()).empty());
+}
+
+TEST_F(ASTTest, ForEachChildVisitsInSourceOrderAndSkipsNull) {
+    auto* ifStmt = context_.create<IfStmt>(integer(1), integer(2), nullptr, loc_);
+
+    std::vector<int64_t> values;
+    forEachChild(ifStmt, [&values](ASTNode* child) {
+        values.push_back(static_cast<IntegerLiteral*>(child)->getValue());
+    });
+
+    EXPECT_EQ(values, (std::vector<int64_t>{1, 2}));
+}
+
+TEST_F(ASTTest, VisitorDispatchesWithoutVirtualCalls) {
+    ASTNode* statement = context_.create<ReturnStmt>(sampleExpression(), loc_);
+
+    NodeCounter counter;
+    counter.visit(statement);
+    EXPECT_EQ(counter.total, 6u);
+    EXPECT_EQ(counter.integers, 3u);
+    EXPECT_EQ(counter.binaries, 2u);
+
+    Evaluator evaluator;
+    EXPECT_EQ(evaluator.visit(sampleExpression()), 7);
+}
+
+TEST_F(ASTTest, FunctionDeclarationPrintsSignature) {
+    std::vector<ParameterDecl*> parameters = {
+        context_.create<ParameterDecl>(context_.copyString("a"), context_.copyString("int"), loc_),
+    };
+    auto* decl = context_.create<FunctionDecl>(context_.copyString("f"), context_.copyString("int"),
+                                               context_.makeList(parameters), nullptr, loc_);
+    EXPECT_EQ(decl->toString(), "int f(int a);");
+}
+
+TEST_F(ASTTest, ConstraintExpressionsJoinTheVisitor) {
+    auto* copyable = context_.create<Identifier>(context_.copyString("Copyable"), loc_);
+    auto* movable = context_.create<Identifier>(context_.copyString("Movable"), loc_);
+    auto* conjunction = context_.create<ConstraintExpression>(
+        ConstraintExpression::ConstraintType::Conjunction, copyable, movable, loc_);
+
+    EXPECT_EQ(conjunction->toString(), "(Copyable && Movable)");
+    EXPECT_EQ(ConstraintExpression::dynCast(conjunction), conjunction);
+    EXPECT_EQ(ConstraintExpression::dynCast(copyable), nullptr);
+
+    NodeCounter counter;
+    counter.visit(conjunction);
+    EXPECT_EQ(counter.total, 3u);
+}
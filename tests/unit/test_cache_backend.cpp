@@ -0,0 +1,77 @@
+/**
+ * @file test_cache_backend.cpp
+ * @brief Tests para el almacén secundario compartido de las cachés
+ */
+
+#include <compiler/common/CacheBackend.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+using namespace cpp20::compiler;
+
+namespace {
+
+class CacheBackendTest : public ::testing::Test {
+protected:
+    std::filesystem::path root_ = std::filesystem::temp_directory_path() / "cache_backend_test";
+
+    void SetUp() override { std::filesystem::remove_all(root_); }
+    void TearDown() override { std::filesystem::remove_all(root_); }
+};
+
+} // namespace
+
+TEST_F(CacheBackendTest, DirectoryBackendStoresByAddress) {
+    DirectoryCacheBackend backend(root_);
+    EXPECT_FALSE(backend.fetch("abcdef").has_value());
+
+    ASSERT_TRUE(backend.put("abcdef", "payload"));
+    EXPECT_TRUE(std::filesystem::exists(root_ / "ab" / "abcdef"));
+    EXPECT_EQ(backend.fetch("abcdef").value_or(""), "payload");
+
+    // Direccionado por contenido: la primera escritura se conserva
+    EXPECT_TRUE(backend.put("abcdef", "other"));
+    EXPECT_EQ(backend.fetch("abcdef").value_or(""), "payload");
+}
+
+TEST_F(CacheBackendTest, AddressesDependOnNamespace) {
+    auto backend = std::make_shared<DirectoryCacheBackend>(root_);
+    SecondaryCache a(backend, SecondaryCache::namespaceKeyFor("0.1.0", 1));
+    SecondaryCache b(backend, SecondaryCache::namespaceKeyFor("0.1.0", 2));
+    SecondaryCache c(backend, SecondaryCache::namespaceKeyFor("0.2.0", 1));
+
+    EXPECT_EQ(a.address(1, 42).size(), 32u);
+    EXPECT_NE(a.address(1, 42), b.address(1, 42));
+    EXPECT_NE(a.address(1, 42), c.address(1, 42));
+    EXPECT_NE(a.address(1, 42), a.address(2, 42));
+}
+
+TEST_F(CacheBackendTest, WriteBehindIsVisibleToOtherMachines) {
+    auto backend = std::make_shared<DirectoryCacheBackend>(root_);
+    uint64_t space = SecondaryCache::namespaceKeyFor("0.1.0", 7);
+
+    SecondaryCache writer(backend, space);
+    writer.writeBehind(writer.address(1, 99), "value");
+    writer.wait();
+    EXPECT_EQ(writer.writeCount(), 1u);
+
+    SecondaryCache reader(backend, space);
+    std::atomic<int> delivered{0};
+    std::string received;
+    reader.prefetch(reader.address(1, 99), [&](std::string_view data) {
+        received = std::string(data);
+        delivered++;
+    });
+    // Una dirección ya pedida no se vuelve a pedir
+    reader.prefetch(reader.address(1, 99), [&](std::string_view) { delivered++; });
+    reader.prefetch(reader.address(1, 100), [&](std::string_view) { delivered++; });
+    reader.wait();
+
+    EXPECT_EQ(delivered.load(), 1);
+    EXPECT_EQ(received, "value");
+    EXPECT_EQ(reader.fetchCount(), 2u);
+    EXPECT_EQ(reader.hitCount(), 1u);
+}
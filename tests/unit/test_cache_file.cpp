@@ -0,0 +1,78 @@
+/**
+ * @file test_cache_file.cpp
+ * @brief Tests para el formato proyectable de las cachés persistentes
+ */
+
+#include <compiler/common/CacheFile.h>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace cpp20::compiler;
+
+namespace {
+
+class CacheFileTest : public ::testing::Test {
+protected:
+    std::filesystem::path file_ = std::filesystem::temp_directory_path() / "cache_file_test.bin";
+
+    void SetUp() override { std::filesystem::remove(file_); }
+    void TearDown() override { std::filesystem::remove(file_); }
+};
+
+} // namespace
+
+TEST_F(CacheFileTest, RecordsAreFoundByFingerprint) {
+    CacheFileWriter writer;
+    writer.add(30, "c", "3");
+    writer.add(10, "a", "1");
+    writer.add(20, "b", "2");
+    writer.add(20, "b2", "22");
+    writer.setCounter(1, 42);
+    ASSERT_TRUE(writer.write(file_, 7));
+
+    auto reader = CacheFileReader::open(file_, 7);
+    ASSERT_NE(reader, nullptr);
+    EXPECT_EQ(reader->size(), 4u);
+    EXPECT_EQ(reader->counter(1), 42u);
+
+    auto [first, last] = reader->equalRange(20);
+    ASSERT_EQ(last - first, 2u);
+    auto record = reader->record(first);
+    ASSERT_TRUE(record.has_value());
+    EXPECT_EQ(record->fingerprint, 20u);
+    EXPECT_TRUE(record->key == "b" || record->key == "b2");
+
+    auto missing = reader->equalRange(25);
+    EXPECT_EQ(missing.first, missing.second);
+}
+
+TEST_F(CacheFileTest, RejectsOtherKindsAndForeignFiles) {
+    CacheFileWriter writer;
+    writer.add(1, "k", "v");
+    ASSERT_TRUE(writer.write(file_, 1));
+    EXPECT_EQ(CacheFileReader::open(file_, 2), nullptr);
+
+    std::ofstream(file_, std::ios::binary | std::ios::trunc) << "not a cache file at all, just text";
+    EXPECT_EQ(CacheFileReader::open(file_, 1), nullptr);
+}
+
+TEST_F(CacheFileTest, RecordFieldsRoundTrip) {
+    CacheRecordWriter writer;
+    writer.str("name");
+    writer.u32(7);
+    writer.u64(1ull << 40);
+    writer.u8(1);
+    std::string bytes = writer.take();
+
+    CacheRecordReader reader(bytes);
+    EXPECT_EQ(reader.str(), "name");
+    EXPECT_EQ(reader.u32(), 7u);
+    EXPECT_EQ(reader.u64(), 1ull << 40);
+    EXPECT_EQ(reader.u8(), 1u);
+    EXPECT_TRUE(reader.atEnd());
+
+    reader.u32();
+    EXPECT_FALSE(reader.ok());
+}
@@ -0,0 +1,100 @@
+/**
+ * @file test_char_scanner.cpp
+ * @brief Tests para el escaneo vectorizado del lexer
+ */
+
+#include <compiler/frontend/lexer/CharScanner.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <string>
+
+using namespace cpp20::compiler::frontend::lexer;
+
+namespace {
+
+bool isIdentifierChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+bool isWhitespaceChar(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+size_t referenceCommentEnd(const std::string& text, size_t from) {
+    size_t pos = text.find("*/", from);
+    return pos == std::string::npos ? text.size() : pos;
+}
+
+} // namespace
+
+TEST(CharScannerTest, ReportsAnImplementation) {
+    std::string name = CharScanner::implementationName();
+    EXPECT_TRUE(name == "avx2" || name == "sse2" || name == "scalar");
+}
+
+TEST(CharScannerTest, IdentifierRunsStopAtEveryBoundary) {
+    // Longitudes que cruzan los límites de 16 y 32 bytes
+    for (size_t length = 0; length < 80; ++length) {
+        std::string text(length, 'a');
+        for (size_t i = 0; i < length; ++i) {
+            text[i] = "abzAZ09_x"[i % 9];
+        }
+        for (char stop : {' ', '(', '\xC3', '\0', '@', '`', '[', '{', '/', ':'}) {
+            std::string input = text + stop + "tail";
+            const char* end = CharScanner::skipIdentifierChars(input.data(), input.data() + input.size());
+            EXPECT_EQ(static_cast<size_t>(end - input.data()), length) << "stop=" << int(stop);
+        }
+    }
+}
+
+TEST(CharScannerTest, WhitespaceAndNewlines) {
+    std::string input = std::string(37, ' ') + "\t\n\r\v\f" + "x" + std::string(40, '\n');
+    const char* begin = input.data();
+    const char* end = begin + input.size();
+
+    EXPECT_EQ(CharScanner::skipWhitespace(begin, end) - begin, 42);
+    EXPECT_EQ(CharScanner::findNewline(begin, end) - begin, 38);
+    EXPECT_EQ(CharScanner::countNewlines(begin, end), 41u);
+    EXPECT_EQ(CharScanner::findNewline(begin, begin + 10), begin + 10);
+}
+
+TEST(CharScannerTest, BlockCommentEndAcrossChunkBoundaries) {
+    for (size_t offset = 0; offset < 70; ++offset) {
+        std::string input = std::string(offset, '*') + "x*/" + "rest";
+        size_t expected = referenceCommentEnd(input, 0);
+        const char* found = CharScanner::findBlockCommentEnd(input.data(), input.data() + input.size());
+        EXPECT_EQ(static_cast<size_t>(found - input.data()), expected) << "offset=" << offset;
+    }
+
+    // "*" al final sin "/" no cierra el comentario
+    std::string unterminated(50, '*');
+    EXPECT_EQ(CharScanner::findBlockCommentEnd(unterminated.data(), unterminated.data() + unterminated.size()),
+              unterminated.data() + unterminated.size());
+}
+
+TEST(CharScannerTest, MatchesScalarReferenceOnRandomInput) {
+    std::mt19937 rng(12345);
+    const std::string alphabet = "ab_Z9 \t\n*/+\x80\xFF";
+
+    for (int round = 0; round < 200; ++round) {
+        std::string input(rng() % 200, ' ');
+        for (char& c : input) {
+            c = alphabet[rng() % alphabet.size()];
+        }
+        const char* begin = input.data();
+        const char* end = begin + input.size();
+
+        auto ident = std::find_if_not(input.begin(), input.end(), isIdentifierChar) - input.begin();
+        auto ws = std::find_if_not(input.begin(), input.end(), isWhitespaceChar) - input.begin();
+        auto nl = std::find(input.begin(), input.end(), '\n') - input.begin();
+
+        EXPECT_EQ(CharScanner::skipIdentifierChars(begin, end) - begin, ident);
+        EXPECT_EQ(CharScanner::skipWhitespace(begin, end) - begin, ws);
+        EXPECT_EQ(CharScanner::findNewline(begin, end) - begin, nl);
+        EXPECT_EQ(static_cast<size_t>(CharScanner::findBlockCommentEnd(begin, end) - begin),
+                  referenceCommentEnd(input, 0));
+        EXPECT_EQ(CharScanner::countNewlines(begin, end),
+                  static_cast<size_t>(std::count(input.begin(), input.end(), '\n')));
+    }
+}
@@ -3,11 +3,25 @@
  * @brief Tests para validar el COFF writer
  */
 
+#include <compiler/backend/codegen/CodeGenerator.h>
+#include <compiler/backend/codegen/CodegenDatabase.h>
+#include <compiler/backend/codegen/X86Encoder.h>
 #include <compiler/backend/coff/COFFWriter.h>
 #include <compiler/backend/coff/COFFDumper.h>
 #include <compiler/backend/coff/COFFTypes.h>
+#include <compiler/backend/frame/FrameBuilder.h>
+#include <compiler/backend/link/MiniLinker.h>
+#include <compiler/backend/link/LinkTimeOptimizer.h>
+#include <compiler/backend/unwind/ExceptionMapper.h>
+#include <compiler/backend/unwind/UnwindEmitter.h>
+#include <compiler/ir/IRPasses.h>
+#include <compiler/ir/IRSerialization.h>
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
+#include <sstream>
 
 using namespace cpp20::compiler::backend::coff;
 namespace fs = std::filesystem;
@@ -15,8 +29,9 @@ namespace fs = std::filesystem;
 class COFFWriterTest : public ::testing::Test {
 protected:
     void SetUp() override {
-        // Crear directorio temporal para tests
-        tempDir = fs::temp_directory_path() / "cpp20_compiler_test";
+        // Directorio temporal propio de cada test: ctest los lanza en paralelo
+        tempDir = fs::temp_directory_path() /
+                  ("cpp20_compiler_test_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
         fs::create_directories(tempDir);
     }
 
@@ -29,6 +44,77 @@ protected:
     fs::path getTempFile(const std::string& name) {
         return tempDir / name;
     }
+
+    struct ArchiveMember {
+        std::vector<std::string> symbols;   // Los que aparecen en el índice
+        std::vector<uint8_t> bytes;
+    };
+
+    // Biblioteca "!<arch>" con los dos miembros enlazadores y los miembros dados
+    fs::path writeArchive(const std::string& name, const std::vector<ArchiveMember>& members) {
+        auto header = [](const std::string& memberName, size_t size) {
+            char text[61];
+            std::snprintf(text, sizeof(text), "%-16s%-12s%-6s%-6s%-8s%-10zu`\n", memberName.c_str(), "0", "", "",
+                          "0", size);
+            return std::string(text, 60);
+        };
+        auto padded = [](size_t size) { return 60 + size + (size & 1); };
+
+        std::vector<std::pair<std::string, uint32_t>> symbols;   // Nombre y miembro (base 0)
+        for (uint32_t i = 0; i < members.size(); ++i) {
+            for (const auto& symbol : members[i].symbols) symbols.emplace_back(symbol, i);
+        }
+        size_t strings = 0;
+        for (const auto& [symbol, member] : symbols) strings += symbol.size() + 1;
+        size_t firstSize = 4 + 4 * symbols.size() + strings;
+        size_t secondSize = 4 + 4 * members.size() + 4 + 2 * symbols.size() + strings;
+
+        std::vector<uint32_t> offsets;
+        size_t offset = 8 + padded(firstSize) + padded(secondSize);
+        for (const auto& member : members) {
+            offsets.push_back(static_cast<uint32_t>(offset));
+            offset += padded(member.bytes.size());
+        }
+
+        std::string out = "!<arch>\n";
+        auto put = [&](uint32_t value, size_t width, bool bigEndian) {
+            for (size_t i = 0; i < width; ++i) {
+                out += static_cast<char>(value >> (8 * (bigEndian ? width - 1 - i : i)));
+            }
+        };
+        auto pad = [&](size_t size) { if (size & 1) out += '\n'; };
+
+        out += header("/", firstSize);
+        put(static_cast<uint32_t>(symbols.size()), 4, true);
+        for (const auto& [symbol, member] : symbols) put(offsets[member], 4, true);
+        for (const auto& [symbol, member] : symbols) out.append(symbol.c_str(), symbol.size() + 1);
+        pad(firstSize);
+
+        auto sorted = symbols;
+        std::sort(sorted.begin(), sorted.end());
+        out += header("/", secondSize);
+        put(static_cast<uint32_t>(members.size()), 4, false);
+        for (uint32_t memberOffset : offsets) put(memberOffset, 4, false);
+        put(static_cast<uint32_t>(sorted.size()), 4, false);
+        for (const auto& [symbol, member] : sorted) put(member + 1, 2, false);
+        for (const auto& [symbol, member] : sorted) out.append(symbol.c_str(), symbol.size() + 1);
+        pad(secondSize);
+
+        for (size_t i = 0; i < members.size(); ++i) {
+            out += header("m" + std::to_string(i) + ".obj/", members[i].bytes.size());
+            out.append(members[i].bytes.begin(), members[i].bytes.end());
+            pad(members[i].bytes.size());
+        }
+
+        fs::path path = getTempFile(name);
+        std::ofstream(path, std::ios::binary).write(out.data(), static_cast<std::streamsize>(out.size()));
+        return path;
+    }
+
+    std::vector<uint8_t> readBytes(const fs::path& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), {});
+    }
 };
 
 // ========================================================================
@@ -98,9 +184,11 @@ TEST_F(COFFWriterTest, WriteCOFFObjectWithData) {
     // Verificar que el archivo existe y tiene el tamaño correcto
     EXPECT_TRUE(fs::exists(testFile));
     auto fileSize = fs::file_size(testFile);
+    // La tabla de strings siempre lleva su campo de tamaño (4 bytes)
     EXPECT_EQ(fileSize, sizeof(IMAGE_FILE_HEADER) +
                        3 * sizeof(IMAGE_SECTION_HEADER) +
-                       textData.size() + dataData.size() + rdataData.size());
+                       textData.size() + dataData.size() + rdataData.size() +
+                       sizeof(uint32_t));
 }
 
 TEST_F(COFFWriterTest, AddSymbolsToCOFFObject) {
@@ -278,10 +366,13 @@ TEST_F(COFFWriterTest, FullCOFFObjectCreation) {
     // Calcular tamaño esperado
     size_t expectedSize = sizeof(IMAGE_FILE_HEADER) +
                          3 * sizeof(IMAGE_SECTION_HEADER) +     // 3 secciones
-                         7 +                                     // código (7 bytes)
+                         8 +                                     // código (8 bytes)
                          4 +                                     // datos (4 bytes)
                          0 +                                     // .rdata vacía
-                         2 * sizeof(IMAGE_SYMBOL);              // 2 símbolos
+                         2 * sizeof(IMAGE_SYMBOL) +              // 2 símbolos
+                         sizeof(uint32_t) +                      // tamaño de la tabla de strings
+                         sizeof("_test_function") +              // nombres de más de 8 bytes
+                         sizeof("_test_data");
 
     EXPECT_EQ(fileSize, expectedSize);
 
@@ -290,3 +381,1521 @@ TEST_F(COFFWriterTest, FullCOFFObjectCreation) {
     COFFDumper dumper;
     EXPECT_TRUE(dumper.dumpFile(testFile.string(), output));
 }
+
+TEST_F(COFFWriterTest, LayoutPlacesEveryPartBeforeWriting) {
+    COFFObject object = createBasicCOFFObject();
+    object.sections[0].data.assign(100, 0x90);
+    object.sections[0].relocations.push_back({4, 0, IMAGE_REL_AMD64_REL32});
+    object.sections[2].data.assign(7, 0x41);
+    object.addSymbol(COFFSymbol("main"));
+    object.stringTable = {"a_long_symbol_name"};
+
+    COFFLayout layout = COFFWriter::computeLayout(object);
+    size_t headers = sizeof(IMAGE_FILE_HEADER) + 3 * sizeof(IMAGE_SECTION_HEADER);
+    EXPECT_EQ(layout.rawDataOffsets, (std::vector<size_t>{headers, headers + 110, headers + 110}));
+    EXPECT_EQ(layout.relocationOffsets, (std::vector<size_t>{headers + 100, 0, 0}));
+    EXPECT_EQ(layout.symbolTableOffset, headers + 117);
+    EXPECT_EQ(layout.stringTableSize, 4u + 19u);
+    EXPECT_EQ(layout.fileSize, headers + 117 + sizeof(IMAGE_SYMBOL) + 23);
+}
+
+TEST_F(COFFWriterTest, ParallelWriteMatchesSerialWrite) {
+    COFFObject object = createBasicCOFFObject();
+    // Más grande que un trozo de copia para que la sección se reparta
+    object.sections[0].data.resize(5 << 20);
+    for (size_t i = 0; i < object.sections[0].data.size(); ++i) {
+        object.sections[0].data[i] = static_cast<uint8_t>(i * 31 + (i >> 12));
+    }
+    for (uint32_t i = 0; i < 64; ++i) {
+        object.sections[1].relocations.push_back({i * 8, i, IMAGE_REL_AMD64_ADDR64});
+    }
+    for (int i = 0; i < 100; ++i) {
+        object.addSymbol(COFFSymbol("s" + std::to_string(i)));
+    }
+
+    COFFWriter writer;
+    fs::path serial = getTempFile("serial.obj");
+    fs::path parallel = getTempFile("parallel.obj");
+    ASSERT_TRUE(writer.writeObject(object, serial.string(), 1));
+    ASSERT_TRUE(writer.writeObject(object, parallel.string(), 4));
+
+    auto read = [](const fs::path& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(in), {});
+    };
+    std::vector<char> expected = read(serial);
+    EXPECT_EQ(expected.size(), COFFWriter::computeLayout(object).fileSize);
+    EXPECT_EQ(read(parallel), expected);
+}
+
+// ========================================================================
+// Cosido de funciones generadas en paralelo
+// ========================================================================
+
+TEST_F(COFFWriterTest, AppendFunctionsLaysOutCodeAndUnwindInOrder) {
+    COFFObject object = createBasicCOFFObject();
+
+    COFFFunction first{"first", {0x55, 0x48, 0x89, 0xE5, 0xC3}, {0x01, 0x04, 0x01, 0x05, 0x01, 0x50}, {}};
+    COFFFunction leaf{"leaf", {0xC3}, {}, {}};
+    COFFFunction last{"last", {0x55, 0xC3}, {0x01, 0x01, 0x01, 0x00, 0x01, 0x50}, {}};
+    appendFunctions(object, {first, leaf, last});
+
+    ASSERT_EQ(object.sections.size(), 5u);
+    const COFFSection& text = object.sections[0];
+    EXPECT_EQ(text.data.size(), 34u);                   // 5 + relleno, 1 + relleno, 2
+    EXPECT_EQ(text.data[5], 0xCC);
+    EXPECT_EQ(text.data[16], 0xC3);
+
+    const COFFSection& xdata = object.sections[3];
+    const COFFSection& pdata = object.sections[4];
+    EXPECT_EQ(xdata.name, ".xdata");
+    EXPECT_EQ(xdata.data.size(), 14u);                  // 6 + 2 de alineación + 6
+    ASSERT_EQ(pdata.data.size(), 24u);                  // La función sin unwind no aparece
+    ASSERT_EQ(pdata.relocations.size(), 6u);
+    IMAGE_RELOCATION unwindRelocation = pdata.relocations[5];
+    uint32_t relocationOffset = unwindRelocation.VirtualAddress;
+    uint16_t relocationType = unwindRelocation.Type;
+    EXPECT_EQ(relocationOffset, 20u);
+    EXPECT_EQ(relocationType, IMAGE_REL_AMD64_ADDR32NB);
+
+    // Segunda RUNTIME_FUNCTION: [32, 34) con UNWIND_INFO en el offset 8
+    uint32_t entry[3];
+    std::memcpy(entry, pdata.data.data() + 12, sizeof(entry));
+    EXPECT_EQ(entry[0], 32u);
+    EXPECT_EQ(entry[1], 34u);
+    EXPECT_EQ(entry[2], 8u);
+
+    std::vector<std::string> functions;
+    for (const auto& symbol : object.symbols) {
+        if (symbol.type == IMAGE_SYM_DTYPE_FUNCTION) functions.push_back(symbol.name);
+    }
+    EXPECT_EQ(functions, (std::vector<std::string>{"first", "leaf", "last"}));
+    EXPECT_EQ(object.symbols.back().value, 32u);
+}
+
+TEST_F(COFFWriterTest, AppendFunctionsSharesIdenticalUnwindInfo) {
+    COFFObject object = createBasicCOFFObject();
+
+    std::vector<uint8_t> framed = {0x01, 0x04, 0x02, 0x00, 0x04, 0x32, 0x01, 0x50};
+    COFFFunction first{"first", {0x55, 0x48, 0x83, 0xEC, 0x20, 0xC3}, framed, {}};
+    COFFFunction other{"other", {0x55, 0xC3}, {0x01, 0x01, 0x01, 0x00, 0x01, 0x50}, {}};
+    COFFFunction second{"second", {0x55, 0x48, 0x83, 0xEC, 0x20, 0xC3}, framed, {}};
+    COFFFunction inlined{"inlined", {0x55, 0x48, 0x83, 0xEC, 0x20, 0xC3}, framed, {}};
+    inlined.comdatSelection = IMAGE_COMDAT_SELECT_ANY;
+    appendFunctions(object, {first, other, second, inlined});
+
+    // first y second comparten registro; la COMDAT conserva su .xdata asociativa
+    const COFFSection& xdata = object.sections[3];
+    const COFFSection& pdata = object.sections[4];
+    EXPECT_EQ(xdata.data.size(), 14u);                  // 8 + 6
+    ASSERT_EQ(pdata.data.size(), 36u);
+    uint32_t unwind[3];
+    for (size_t i = 0; i < 3; ++i) {
+        std::memcpy(&unwind[i], pdata.data.data() + 12 * i + 8, sizeof(uint32_t));
+    }
+    EXPECT_EQ(unwind[0], 0u);
+    EXPECT_EQ(unwind[1], 8u);
+    EXPECT_EQ(unwind[2], 0u);
+
+    auto comdatXdata = std::find_if(object.sections.begin() + 5, object.sections.end(),
+                                    [](const COFFSection& section) { return section.name == ".xdata"; });
+    ASSERT_NE(comdatXdata, object.sections.end());
+    EXPECT_EQ(comdatXdata->data, framed);
+}
+
+TEST_F(COFFWriterTest, UnwindEmitterSharesRecordsAndChainsFragments) {
+    using namespace cpp20::compiler::backend::unwind;
+
+    UnwindEmitter emitter;
+    emitter.setXdataBaseRVA(0x3000);
+    std::vector<uint8_t> prologue = {0x55, 0x48, 0x83, 0xEC, 0x20};    // push rbp; sub rsp, 32
+    emitter.addFunctionUnwind(0x1100, 0x40, prologue, 40, 0);
+    emitter.addFunctionUnwind(0x1000, 0x80, prologue, 40, 0);
+    EXPECT_TRUE(emitter.addChainedUnwind(0x2000, 0x10, 0x1000));
+    EXPECT_FALSE(emitter.addChainedUnwind(0x2100, 0x10, 0x1234));
+
+    // Un registro compartido (4 + 2 códigos) y el encadenado (4 + RUNTIME_FUNCTION)
+    auto xdata = emitter.generateXdataSection();
+    EXPECT_EQ(emitter.getUniqueUnwindInfoCount(), 2u);
+    ASSERT_EQ(xdata.size(), 8u + 16u);
+    EXPECT_EQ(emitter.getXdataSize(), xdata.size());
+    EXPECT_EQ(xdata[8], 0x01 | (static_cast<uint8_t>(UnwindFlags::ChainInfo) << 3));
+    uint32_t chained[3];
+    std::memcpy(chained, xdata.data() + 12, sizeof(chained));
+    EXPECT_EQ(chained[0], 0x1000u);
+    EXPECT_EQ(chained[1], 0x1080u);
+    EXPECT_EQ(chained[2], 0x3000u);
+
+    // .pdata ordenada por dirección de inicio
+    auto pdata = emitter.generatePdataSection();
+    ASSERT_EQ(pdata.size(), 3 * sizeof(RuntimeFunction));
+    uint32_t entries[9];
+    std::memcpy(entries, pdata.data(), sizeof(entries));
+    EXPECT_EQ(entries[0], 0x1000u);
+    EXPECT_EQ(entries[2], 0x3000u);
+    EXPECT_EQ(entries[3], 0x1100u);
+    EXPECT_EQ(entries[5], 0x3000u);
+    EXPECT_EQ(entries[6], 0x2000u);
+    EXPECT_EQ(entries[8], 0x3008u);
+}
+
+TEST_F(COFFWriterTest, ExceptionMapperEmitsCompactFuncInfo) {
+    using namespace cpp20::compiler::backend::unwind;
+
+    ExceptionMapper mapper;
+    mapper.setFunctionStart(0x1000);
+    mapper.addTryCatchRegion(TryCatchRegion(0x1040, 0x1050, 0x1200, 0x1220, 0x5000));
+    mapper.addTryCatchRegion(TryCatchRegion(0x1010, 0x1020, 0x1180, 0x1190, 0x5000));
+    mapper.addThrowSite(ThrowSite(0x1015, 0x6000));
+    ASSERT_NE(mapper.generateExceptionHandler(), 0u);
+
+    // Dos tipos; regiones ordenadas con el catch en la parte fría
+    std::vector<uint8_t> expected = {
+        0x02, 0x00, 0x50, 0x00, 0x00, 0x00, 0x60, 0x00, 0x00,
+        0x02, 0x10, 0x10, 0x80, 0x03, 0x10, 0x00,
+              0x30, 0x10, 0x80, 0x04, 0x20, 0x00,
+        0x01, 0x15, 0x01};
+    EXPECT_EQ(mapper.generateExceptionData(), expected);
+}
+
+TEST_F(COFFWriterTest, AppendFunctionsResolvesCallRelocations) {
+    COFFObject object = createBasicCOFFObject();
+
+    // caller: call callee; call puts; ret
+    COFFFunction caller{"caller", {0xE8, 0, 0, 0, 0, 0xE8, 0, 0, 0, 0, 0xC3}, {},
+                        {{1, "callee", IMAGE_REL_AMD64_REL32}, {6, "puts", IMAGE_REL_AMD64_REL32}}};
+    COFFFunction callee{"callee", {0xC3}, {}, {}};
+    appendFunctions(object, {caller, callee});
+
+    const COFFSection& text = object.sections[0];
+    ASSERT_EQ(text.relocations.size(), 2u);
+    IMAGE_RELOCATION local = text.relocations[0];
+    IMAGE_RELOCATION external = text.relocations[1];
+    EXPECT_EQ(local.VirtualAddress, 1u);
+    EXPECT_EQ(external.VirtualAddress, 6u);
+    EXPECT_EQ(local.Type, IMAGE_REL_AMD64_REL32);
+
+    // La llamada dentro del objeto usa el símbolo definido; la otra queda sin definir
+    const COFFSymbol& target = object.symbols[local.SymbolTableIndex];
+    EXPECT_EQ(target.name, "callee");
+    EXPECT_EQ(target.value, 16u);
+    EXPECT_NE(target.sectionNumber, 0);
+    const COFFSymbol& undefined = object.symbols[external.SymbolTableIndex];
+    EXPECT_EQ(undefined.name, "puts");
+    EXPECT_EQ(undefined.sectionNumber, 0);
+}
+
+// ========================================================================
+// Secciones COMDAT por función
+// ========================================================================
+
+TEST_F(COFFWriterTest, AppendFunctionsPutsComdatFunctionsInOwnSections) {
+    COFFObject object;
+
+    COFFFunction framed{"framed", {0x55, 0xC3}, {0x01, 0x01, 0x01, 0x00, 0x01, 0x50}, {}};
+    framed.comdatSelection = IMAGE_COMDAT_SELECT_NODUPLICATES;
+    COFFFunction inlined{"inlined", {0xC3}, {}, {}};
+    inlined.comdatSelection = IMAGE_COMDAT_SELECT_ANY;
+    appendFunctions(object, {framed, inlined});
+
+    // Sin funciones fuera de COMDAT no se crean .text/.xdata/.pdata comunes
+    ASSERT_EQ(object.sections.size(), 4u);
+    EXPECT_EQ(object.sections[0].name, ".text$mn");
+    EXPECT_EQ(object.sections[1].name, ".xdata");
+    EXPECT_EQ(object.sections[2].name, ".pdata");
+    EXPECT_EQ(object.sections[3].name, ".text$mn");
+    for (const auto& section : object.sections) {
+        EXPECT_TRUE(section.characteristics & IMAGE_SCN_LNK_COMDAT);
+    }
+
+    auto definition = [&](size_t index) {
+        const COFFSymbol& symbol = object.symbols[index];
+        EXPECT_EQ(symbol.storageClass, IMAGE_SYM_CLASS_STATIC);
+        EXPECT_EQ(symbol.auxSymbols, 1);
+        IMAGE_AUX_SYMBOL_SECTION aux;
+        std::memcpy(&aux, symbol.aux.data(), sizeof(aux));
+        return aux;
+    };
+
+    // Símbolo de sección con la selección y, detrás, el de la función
+    ASSERT_EQ(object.symbols.size(), 6u);
+    EXPECT_EQ(definition(0).Selection, IMAGE_COMDAT_SELECT_NODUPLICATES);
+    EXPECT_EQ(definition(0).Length, 2u);
+    EXPECT_EQ(object.symbols[1].name, "framed");
+    EXPECT_EQ(object.symbols[1].sectionNumber, 1);
+
+    // .xdata y .pdata dependen de la sección del código
+    EXPECT_EQ(definition(2).Selection, IMAGE_COMDAT_SELECT_ASSOCIATIVE);
+    EXPECT_EQ(definition(2).Number, 1);
+    EXPECT_EQ(definition(3).Selection, IMAGE_COMDAT_SELECT_ASSOCIATIVE);
+    EXPECT_EQ(definition(3).NumberOfRelocations, 3);
+    IMAGE_RELOCATION unwind = object.sections[2].relocations[2];
+    EXPECT_EQ(unwind.SymbolTableIndex, 2u);
+
+    EXPECT_EQ(definition(4).Selection, IMAGE_COMDAT_SELECT_ANY);
+    EXPECT_EQ(object.symbols[5].name, "inlined");
+    EXPECT_EQ(object.symbols[5].sectionNumber, 4);
+}
+
+TEST_F(COFFWriterTest, LiteralsArePooledWithinAndAcrossObjects) {
+    using namespace cpp20::compiler::backend::link;
+
+    COFFLiteral hello{{'h', 'o', 'l', 'a', 0}};
+    COFFLiteral table{{1, 0, 0, 0, 2, 0, 0, 0}, 4};
+    COFFLiteral wideTable{table.data, 8};
+
+    // Dentro de la unidad, cada contenido una vez y con el mayor alineamiento
+    COFFObject first;
+    auto names = appendLiterals(first, {hello, table, hello, wideTable});
+    ASSERT_EQ(names.size(), 4u);
+    EXPECT_EQ(names[0], names[2]);
+    EXPECT_EQ(names[1], names[3]);
+    EXPECT_EQ(names[0], literalSymbolName(hello.data));
+    ASSERT_EQ(first.sections.size(), 2u);
+    EXPECT_EQ(first.sections[0].name, ".rdata");
+    EXPECT_TRUE(first.sections[0].characteristics & IMAGE_SCN_LNK_COMDAT);
+    EXPECT_EQ(first.sections[1].characteristics & IMAGE_SCN_ALIGN_MASK, IMAGE_SCN_ALIGN_8BYTES);
+    EXPECT_EQ(appendLiterals(first, {table})[0], names[1]);
+    EXPECT_EQ(first.sections.size(), 2u);
+
+    // lea rcx, [rip + hola]; lea rdx, [rip + tabla]; call other; ret
+    COFFFunction main{"main", {0x48, 0x8D, 0x0D, 0, 0, 0, 0, 0x48, 0x8D, 0x15, 0, 0, 0, 0, 0xE8, 0, 0, 0, 0, 0xC3},
+                      {}, {{3, names[0], IMAGE_REL_AMD64_REL32}, {10, names[1], IMAGE_REL_AMD64_REL32},
+                           {15, "other", IMAGE_REL_AMD64_REL32}}};
+    appendFunctions(first, {main});
+
+    COFFObject second;
+    auto otherNames = appendLiterals(second, {hello});
+    COFFFunction other{"other", {0x48, 0x8D, 0x05, 0, 0, 0, 0, 0xC3}, {}, {{3, otherNames[0], IMAGE_REL_AMD64_REL32}}};
+    appendFunctions(second, {other});
+
+    fs::path firstPath = getTempFile("literals1.obj");
+    fs::path secondPath = getTempFile("literals2.obj");
+    ASSERT_TRUE(COFFWriter().writeObject(first, firstPath.string()));
+    ASSERT_TRUE(COFFWriter().writeObject(second, secondPath.string()));
+    MiniLinker linker;
+    ASSERT_TRUE(linker.addObjectFile(firstPath));
+    ASSERT_TRUE(linker.addObjectFile(secondPath));
+    fs::path exePath = getTempFile("literals.exe");
+    LinkResult result = linker.link(exePath);
+    ASSERT_TRUE(result.success) << result.errorMessage;
+
+    // Entre objetos queda una sola copia, y las dos referencias van a ella
+    EXPECT_EQ(linker.getLinkStatistics()["discarded_sections"], 1u);
+    auto image = readBytes(exePath);
+    std::string text(image.begin(), image.end());
+    size_t copy = text.find(std::string("hola\0", 5));
+    ASSERT_NE(copy, std::string::npos);
+    EXPECT_EQ(text.find(std::string("hola\0", 5), copy + 1), std::string::npos);
+    EXPECT_TRUE(result.symbolAddresses.count(names[0]));
+    EXPECT_EQ(result.symbolAddresses[names[1]] % 8, 0u);
+}
+
+TEST_F(COFFWriterTest, AuxRecordsShiftSymbolTableIndices) {
+    COFFObject object;
+    COFFFunction caller{"caller", {0xE8, 0, 0, 0, 0, 0xC3}, {}, {{1, "callee", IMAGE_REL_AMD64_REL32}}};
+    caller.comdatSelection = IMAGE_COMDAT_SELECT_NODUPLICATES;
+    COFFFunction callee{"callee", {0xC3}, {}, {}};
+    callee.comdatSelection = IMAGE_COMDAT_SELECT_ANY;
+    appendFunctions(object, {caller, callee});
+
+    fs::path path = getTempFile("comdat.obj");
+    ASSERT_TRUE(COFFWriter().writeObject(object, path.string()));
+    std::ifstream in(path, std::ios::binary);
+    std::vector<uint8_t> file((std::istreambuf_iterator<char>(in)), {});
+
+    // Cuatro símbolos más un auxiliar por cada sección
+    IMAGE_FILE_HEADER header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    EXPECT_EQ(header.NumberOfSymbols, 6u);
+
+    // La llamada apunta a la entrada de "callee" en la tabla (5), no a su posición en el vector (3)
+    COFFLayout layout = COFFWriter::computeLayout(object);
+    IMAGE_RELOCATION call;
+    std::memcpy(&call, file.data() + layout.relocationOffsets[0], sizeof(call));
+    EXPECT_EQ(call.SymbolTableIndex, 5u);
+    IMAGE_SYMBOL target;
+    std::memcpy(&target, file.data() + layout.symbolTableOffset + 5 * sizeof(IMAGE_SYMBOL), sizeof(target));
+    EXPECT_EQ(std::string(target.N.ShortName, strnlen(target.N.ShortName, 8)), "callee");
+}
+
+TEST_F(COFFWriterTest, LinkerKeepsOneComdatCopyAndDropsUnreferenced) {
+    using namespace cpp20::compiler::backend::link;
+
+    // Los dos objetos traen "shared" (inline); "unused" no lo llama nadie
+    COFFFunction main{"main", {0x48, 0x83, 0xEC, 0x28, 0xE8, 0, 0, 0, 0, 0x48, 0x83, 0xC4, 0x28, 0xC3},
+                      {0x01, 0x04, 0x01, 0x00, 0x04, 0x42}, {{5, "shared", IMAGE_REL_AMD64_REL32}}};
+    main.comdatSelection = IMAGE_COMDAT_SELECT_NODUPLICATES;
+    COFFFunction shared{"shared", {0x31, 0xC0, 0xC3}, {}, {}};
+    shared.comdatSelection = IMAGE_COMDAT_SELECT_ANY;
+    COFFFunction unused{"unused", {0xC3}, {}, {}};
+    unused.comdatSelection = IMAGE_COMDAT_SELECT_NODUPLICATES;
+
+    COFFObject first, second;
+    appendFunctions(first, {main, shared});
+    appendFunctions(second, {shared, unused});
+    fs::path firstPath = getTempFile("first.obj");
+    fs::path secondPath = getTempFile("second.obj");
+    ASSERT_TRUE(COFFWriter().writeObject(first, firstPath.string()));
+    ASSERT_TRUE(COFFWriter().writeObject(second, secondPath.string()));
+
+    MiniLinker linker;
+    linker.setOptimize(true);
+    ASSERT_TRUE(linker.addObjectFile(firstPath));
+    ASSERT_TRUE(linker.addObjectFile(secondPath));
+    LinkResult result = linker.link(getTempFile("a.exe"));
+    ASSERT_TRUE(result.success) << result.errorMessage;
+
+    // La segunda copia de "shared" y "unused" se descartan
+    EXPECT_EQ(linker.getLinkStatistics()["discarded_sections"], 2u);
+    EXPECT_TRUE(result.symbolAddresses.count("main"));
+    EXPECT_TRUE(result.symbolAddresses.count("shared"));
+    EXPECT_FALSE(result.symbolAddresses.count("unused"));
+}
+
+TEST_F(COFFWriterTest, LinkerWritesSectionsFromMappedObjects) {
+    using namespace cpp20::compiler::backend::link;
+
+    COFFFunction main{"main", {0x48, 0x83, 0xEC, 0x28, 0xE8, 0, 0, 0, 0, 0x48, 0x83, 0xC4, 0x28, 0xC3},
+                      {0x01, 0x04, 0x01, 0x00, 0x04, 0x42}, {{5, "callee", IMAGE_REL_AMD64_REL32}}};
+    COFFFunction callee{"callee", {0x31, 0xC0, 0xC3}, {}, {}};
+    COFFObject object;
+    appendFunctions(object, {main, callee});
+    fs::path objectPath = getTempFile("main.obj");
+    ASSERT_TRUE(COFFWriter().writeObject(object, objectPath.string()));
+
+    MiniLinker linker;
+    ASSERT_TRUE(linker.addObjectFile(objectPath));
+    fs::path exePath = getTempFile("main.exe");
+    LinkResult result = linker.link(exePath);
+    ASSERT_TRUE(result.success) << result.errorMessage;
+
+    // El código sale tal cual del objeto y la llamada queda resuelta en la salida
+    std::ifstream in(exePath, std::ios::binary);
+    std::vector<uint8_t> image((std::istreambuf_iterator<char>(in)), {});
+    std::vector<uint8_t> prologue{0x48, 0x83, 0xEC, 0x28, 0xE8};
+    auto code = std::search(image.begin(), image.end(), prologue.begin(), prologue.end());
+    ASSERT_NE(code, image.end());
+    int32_t displacement;
+    std::memcpy(&displacement, &*(code + 5), sizeof(displacement));
+    EXPECT_EQ(displacement, static_cast<int32_t>(result.symbolAddresses["callee"] -
+                                                 (result.symbolAddresses["main"] + 9)));
+    EXPECT_EQ(*(code + 14), 0xCC);                      // Relleno hasta la siguiente función
+}
+
+TEST_F(COFFWriterTest, ParallelLinkMatchesSerialLink) {
+    using namespace cpp20::compiler::backend::link;
+
+    // Varios objetos con funciones que se llaman entre sí
+    std::vector<fs::path> objects;
+    for (int i = 0; i < 8; ++i) {
+        std::vector<COFFFunction> functions;
+        for (int j = 0; j < 20; ++j) {
+            std::string name = "f" + std::to_string(i * 20 + j);
+            std::string next = "f" + std::to_string((i * 20 + j + 1) % 160);
+            COFFFunction function{name, {0xE8, 0, 0, 0, 0, static_cast<uint8_t>(j), 0xC3},
+                                  {0x01, 0x00, 0x00, 0x00}, {{1, next, IMAGE_REL_AMD64_REL32}}};
+            function.comdatSelection = j % 2 ? IMAGE_COMDAT_SELECT_NODUPLICATES : 0;
+            functions.push_back(function);
+        }
+        COFFObject object;
+        appendFunctions(object, functions);
+        objects.push_back(getTempFile("p" + std::to_string(i) + ".obj"));
+        ASSERT_TRUE(COFFWriter().writeObject(object, objects.back().string()));
+    }
+
+    auto linkWith = [&](size_t jobs, const std::string& name) {
+        MiniLinker linker;
+        linker.setEntryPoint("f0");
+        linker.setJobs(jobs);
+        for (const auto& object : objects) EXPECT_TRUE(linker.addObjectFile(object));
+        EXPECT_TRUE(linker.link(getTempFile(name)).success);
+        std::ifstream in(getTempFile(name), std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(in), {});
+    };
+    std::vector<char> serial = linkWith(1, "serial.exe");
+    std::vector<char> parallel = linkWith(4, "parallel.exe");
+    ASSERT_FALSE(serial.empty());
+    // El TimeDateStamp del header PE puede cambiar entre enlaces
+    constexpr size_t kTimeStamp = 64 + 4 + 4;
+    std::fill_n(serial.begin() + kTimeStamp, 4, 0);
+    std::fill_n(parallel.begin() + kTimeStamp, 4, 0);
+    EXPECT_EQ(parallel, serial);
+}
+
+TEST_F(COFFWriterTest, ParallelObjectLoadingResolvesDuplicatesLikeSerial) {
+    using namespace cpp20::compiler::backend::link;
+
+    COFFFunction main{"main", {0x48, 0x83, 0xEC, 0x28, 0xE8, 0, 0, 0, 0, 0x48, 0x83, 0xC4, 0x28, 0xC3},
+                      {0x01, 0x04, 0x01, 0x00, 0x04, 0x42}, {{5, "dup", IMAGE_REL_AMD64_REL32}}};
+    COFFFunction dup{"dup", {0x31, 0xC0, 0xC3}, {}, {}};
+    COFFObject first, second;
+    appendFunctions(first, {main, dup});
+    appendFunctions(second, {dup});
+    std::vector<fs::path> objects{getTempFile("dup1.obj"), getTempFile("dup2.obj")};
+    ASSERT_TRUE(COFFWriter().writeObject(first, objects[0].string()));
+    ASSERT_TRUE(COFFWriter().writeObject(second, objects[1].string()));
+
+    MiniLinker serial;
+    for (const auto& object : objects) ASSERT_TRUE(serial.addObjectFile(object));
+    LinkResult expected = serial.link(getTempFile("dup_serial.exe"));
+    ASSERT_TRUE(expected.success) << expected.errorMessage;
+
+    MiniLinker parallel;
+    parallel.setJobs(4);
+    ASSERT_TRUE(parallel.addObjectFiles(objects));
+    LinkResult result = parallel.link(getTempFile("dup_parallel.exe"));
+    ASSERT_TRUE(result.success) << result.errorMessage;
+
+    // La definición repetida se resuelve a la del último objeto, como en serie
+    EXPECT_EQ(result.symbolAddresses, expected.symbolAddresses);
+    EXPECT_GT(result.symbolAddresses["dup"], result.symbolAddresses["main"] + 16);
+    EXPECT_FALSE(parallel.addObjectFiles({getTempFile("missing.obj")}));
+}
+
+TEST_F(COFFWriterTest, LinkerLoadsOnlyLibraryMembersThatResolveSymbols) {
+    using namespace cpp20::compiler::backend::link;
+
+    auto writeFunction = [&](const COFFFunction& function) {
+        COFFObject object;
+        appendFunctions(object, {function});
+        fs::path path = getTempFile(function.name + ".obj");
+        EXPECT_TRUE(COFFWriter().writeObject(object, path.string()));
+        return readBytes(path);
+    };
+
+    // helper necesita a deep, que está en otro miembro: hace falta una segunda vuelta
+    COFFFunction helper{"helper", {0xE8, 0, 0, 0, 0, 0xC3}, {}, {{1, "deep", IMAGE_REL_AMD64_REL32}}};
+    COFFFunction deep{"deep", {0x31, 0xC0, 0xC3}, {}, {}};
+    COFFFunction unused{"unused", {0xC3}, {}, {}};
+
+    IMPORT_OBJECT_HEADER importHeader{};
+    importHeader.Sig2 = IMPORT_OBJECT_HDR_SIG2;
+    importHeader.Machine = IMAGE_FILE_MACHINE_AMD64;
+    std::string importNames("ExitProcess\0kernel32.dll\0", 25);
+    importHeader.SizeOfData = static_cast<uint32_t>(importNames.size());
+    std::vector<uint8_t> importMember(sizeof(importHeader) + importNames.size());
+    std::memcpy(importMember.data(), &importHeader, sizeof(importHeader));
+    std::memcpy(importMember.data() + sizeof(importHeader), importNames.data(), importNames.size());
+
+    fs::path library = writeArchive("util.lib", {{{"helper"}, writeFunction(helper)},
+                                                 {{"unused"}, writeFunction(unused)},
+                                                 {{"deep"}, writeFunction(deep)},
+                                                 {{"ExitProcess", "__imp_ExitProcess"}, importMember}});
+
+    COFFFunction main{"main", {0xE8, 0, 0, 0, 0, 0xE8, 0, 0, 0, 0, 0xC3}, {},
+                      {{1, "helper", IMAGE_REL_AMD64_REL32}, {6, "ExitProcess", IMAGE_REL_AMD64_REL32}}};
+    COFFObject object;
+    appendFunctions(object, {main});
+    fs::path objectPath = getTempFile("main.obj");
+    ASSERT_TRUE(COFFWriter().writeObject(object, objectPath.string()));
+
+    MiniLinker linker;
+    ASSERT_TRUE(linker.addObjectFile(objectPath));
+    ASSERT_TRUE(linker.addLibrary(library));
+    LinkResult result = linker.link(getTempFile("lib.exe"));
+    ASSERT_TRUE(result.success) << result.errorMessage;
+
+    auto statistics = linker.getLinkStatistics();
+    EXPECT_EQ(statistics["loaded_members"], 3u);        // helper, deep y la importación
+    EXPECT_EQ(statistics["object_files"], 4u);          // Y el de las tablas de importación
+    EXPECT_TRUE(result.symbolAddresses.count("helper"));
+    EXPECT_TRUE(result.symbolAddresses.count("deep"));
+    EXPECT_FALSE(result.symbolAddresses.count("unused"));
+    EXPECT_TRUE(linker.getUndefinedSymbols().empty());
+}
+
+TEST_F(COFFWriterTest, DelayLoadedImportsBindOnFirstCallAndIATFollowsFirstUse) {
+    using namespace cpp20::compiler::backend::link;
+
+    auto importMember = [](const std::string& symbol, const std::string& dll) {
+        IMPORT_OBJECT_HEADER header{};
+        header.Sig2 = IMPORT_OBJECT_HDR_SIG2;
+        header.Machine = IMAGE_FILE_MACHINE_AMD64;
+        std::string names = symbol + '\0' + dll + '\0';
+        header.SizeOfData = static_cast<uint32_t>(names.size());
+        std::vector<uint8_t> member(sizeof(header) + names.size());
+        std::memcpy(member.data(), &header, sizeof(header));
+        std::memcpy(member.data() + sizeof(header), names.data(), names.size());
+        return member;
+    };
+    fs::path library = writeArchive("imports.lib",
+                                    {{{"ExitProcess", "__imp_ExitProcess"}, importMember("ExitProcess", "kernel32.dll")},
+                                     {{"GetTickCount", "__imp_GetTickCount"}, importMember("GetTickCount", "kernel32.dll")},
+                                     {{"RareCall", "__imp_RareCall"}, importMember("RareCall", "rare.dll")}});
+
+    // call [__imp_GetTickCount]; call RareCall; call [__imp_ExitProcess]: GetTickCount se usa antes
+    COFFFunction main{"main", {0xFF, 0x15, 0, 0, 0, 0, 0xE8, 0, 0, 0, 0, 0xFF, 0x15, 0, 0, 0, 0, 0xC3}, {},
+                      {{2, "__imp_GetTickCount", IMAGE_REL_AMD64_REL32}, {7, "RareCall", IMAGE_REL_AMD64_REL32},
+                       {13, "__imp_ExitProcess", IMAGE_REL_AMD64_REL32}}};
+    COFFFunction helper{"__delayLoadHelper2", {0x31, 0xC0, 0xC3}, {}, {}};
+    COFFObject object;
+    appendFunctions(object, {main, helper});
+    fs::path objectPath = getTempFile("delay.obj");
+    ASSERT_TRUE(COFFWriter().writeObject(object, objectPath.string()));
+
+    MiniLinker linker;
+    linker.addDelayLoad("RARE.DLL");
+    ASSERT_TRUE(linker.addObjectFile(objectPath));
+    ASSERT_TRUE(linker.addLibrary(library));
+    fs::path exePath = getTempFile("delay.exe");
+    LinkResult result = linker.link(exePath);
+    ASSERT_TRUE(result.success) << result.errorMessage;
+    EXPECT_EQ(linker.getLinkStatistics()["imported_dlls"], 1u);
+    EXPECT_EQ(linker.getLinkStatistics()["delay_loaded_dlls"], 1u);
+
+    // La IAT de kernel32 sigue el orden de uso, no el de la biblioteca
+    auto& symbols = result.symbolAddresses;
+    ASSERT_TRUE(symbols.count("__imp_GetTickCount") && symbols.count("__imp_ExitProcess"));
+    EXPECT_EQ(symbols["__imp_ExitProcess"], symbols["__imp_GetTickCount"] + 8);
+
+    // Directorios de importación, IAT y carga diferida en el header opcional
+    auto image = readBytes(exePath);
+    uint32_t peOffset;
+    std::memcpy(&peOffset, &image[0x3C], sizeof(peOffset));
+    auto directory = [&](size_t index) {
+        std::pair<uint32_t, uint32_t> entry;
+        size_t at = peOffset + 4 + sizeof(IMAGE_FILE_HEADER) + 112 + index * 8;
+        std::memcpy(&entry.first, &image[at], 4);
+        std::memcpy(&entry.second, &image[at + 4], 4);
+        return entry;
+    };
+    EXPECT_EQ(directory(IMAGE_DIRECTORY_ENTRY_IMPORT), std::make_pair(symbols["__IMPORT_DESCRIPTOR_kernel32"], 40u));
+    EXPECT_EQ(directory(IMAGE_DIRECTORY_ENTRY_IAT), std::make_pair(symbols["__imp_GetTickCount"], 24u));
+    EXPECT_EQ(directory(IMAGE_DIRECTORY_ENTRY_DELAY_IMPORT),
+              std::make_pair(symbols["__DELAY_IMPORT_DESCRIPTOR_rare"], 64u));
+
+    // Bytes de la imagen en una RVA: las secciones van seguidas tras la tabla de secciones
+    auto at = [&](uint32_t rva) -> const uint8_t* {
+        IMAGE_FILE_HEADER file;
+        std::memcpy(&file, &image[peOffset + 4], sizeof(file));
+        size_t table = peOffset + 4 + sizeof(file) + file.SizeOfOptionalHeader;
+        size_t raw = table + file.NumberOfSections * sizeof(IMAGE_SECTION_HEADER);
+        for (size_t i = 0; i < file.NumberOfSections; ++i) {
+            IMAGE_SECTION_HEADER section;
+            std::memcpy(&section, &image[table + i * sizeof(section)], sizeof(section));
+            if (rva >= section.VirtualAddress && rva < section.VirtualAddress + section.SizeOfRawData) {
+                return &image[raw + rva - section.VirtualAddress];
+            }
+            raw += section.SizeOfRawData;
+        }
+        return nullptr;
+    };
+
+    // Hasta la primera llamada, la IAT diferida apunta al thunk de carga
+    ASSERT_TRUE(symbols.count("__imp_RareCall") && symbols.count("__imp_load_RareCall"));
+    const uint8_t* entry = at(symbols["__imp_RareCall"]);
+    ASSERT_NE(entry, nullptr);
+    uint64_t initial;
+    std::memcpy(&initial, entry, sizeof(initial));
+    EXPECT_EQ(initial, symbols["__imp_load_RareCall"]);
+
+    // La llamada directa va al JMP a través de la IAT
+    const uint8_t* thunk = at(symbols["RareCall"]);
+    ASSERT_NE(thunk, nullptr);
+    EXPECT_EQ(thunk[0], 0xFF);
+    EXPECT_EQ(thunk[1], 0x25);
+    int32_t displacement;
+    std::memcpy(&displacement, thunk + 2, sizeof(displacement));
+    EXPECT_EQ(symbols["RareCall"] + 6 + displacement, symbols["__imp_RareCall"]);
+}
+
+TEST_F(COFFWriterTest, IncrementalLinkPatchesChangedObjectInPlace) {
+    using namespace cpp20::compiler::backend::link;
+
+    COFFFunction main{"main", {0x48, 0x83, 0xEC, 0x28, 0xE8, 0, 0, 0, 0, 0x48, 0x83, 0xC4, 0x28, 0xC3},
+                      {}, {{5, "callee", IMAGE_REL_AMD64_REL32}}};
+    COFFObject mainObject;
+    appendFunctions(mainObject, {main});
+    fs::path mainPath = getTempFile("main.obj");
+    ASSERT_TRUE(COFFWriter().writeObject(mainObject, mainPath.string()));
+
+    // callee va detrás de pad: si pad crece, callee se mueve dentro de su hueco
+    fs::path calleePath = getTempFile("callee.obj");
+    auto writeCallee = [&](size_t padSize) {
+        COFFObject object;
+        appendFunctions(object, {COFFFunction{"pad", std::vector<uint8_t>(padSize, 0x90), {}, {}},
+                                 COFFFunction{"callee", {0x31, 0xC0, 0xC3}, {}, {}}});
+        ASSERT_TRUE(COFFWriter().writeObject(object, calleePath.string()));
+    };
+    auto link = [&](const fs::path& output, size_t& patched) {
+        MiniLinker linker;
+        linker.setIncremental(true);
+        EXPECT_TRUE(linker.addObjectFile(mainPath));
+        EXPECT_TRUE(linker.addObjectFile(calleePath));
+        LinkResult result = linker.link(output);
+        EXPECT_TRUE(result.success) << result.errorMessage;
+        patched = linker.getLinkStatistics()["patched_contributions"];
+        return result;
+    };
+    auto image = [&](const fs::path& path) {
+        std::vector<uint8_t> bytes = readBytes(path);
+        std::fill_n(bytes.begin() + 64 + 4 + 4, 4, 0);     // TimeDateStamp
+        return bytes;
+    };
+
+    size_t patched = 0;
+    writeCallee(1);
+    fs::path exePath = getTempFile("inc.exe");
+    LinkResult first = link(exePath, patched);
+    EXPECT_EQ(patched, 0u);
+    EXPECT_TRUE(fs::exists(IncrementalDatabase::pathFor(exePath)));
+
+    // callee se desplaza dentro del hueco de su objeto: se reescriben las
+    // secciones de ese objeto (.text, .xdata, .pdata) y el .text de main,
+    // que la llama
+    writeCallee(20);
+    LinkResult second = link(exePath, patched);
+    EXPECT_EQ(patched, 4u);
+    EXPECT_GT(second.symbolAddresses["callee"], first.symbolAddresses["callee"]);
+    EXPECT_EQ(second.symbolAddresses["main"], first.symbolAddresses["main"]);
+
+    // Con el mismo layout, un enlace completo da el mismo ejecutable
+    fs::path fullPath = getTempFile("full.exe");
+    writeCallee(1);
+    link(fullPath, patched);
+    writeCallee(20);
+    link(fullPath, patched);
+    EXPECT_EQ(image(exePath), image(fullPath));
+
+    // Si no cabe en el hueco se vuelve al enlace completo
+    writeCallee(400);
+    LinkResult third = link(exePath, patched);
+    EXPECT_EQ(patched, 0u);
+    EXPECT_GT(third.symbolAddresses["callee"], first.symbolAddresses["callee"] + 300);
+}
+
+TEST_F(COFFWriterTest, LinkerFoldsIdenticalFunctionsAndHonorsFunctionOrder) {
+    using namespace cpp20::compiler::backend::link;
+
+    // leafA y leafB son idénticas; first y second solo se parecen después
+    // de plegarlas, así que hace falta una segunda vuelta
+    auto function = [](const std::string& name, std::vector<uint8_t> code,
+                       std::vector<COFFFunctionRelocation> relocations) {
+        COFFFunction result{name, std::move(code), {0x01, 0x00, 0x00, 0x00}, std::move(relocations)};
+        result.comdatSelection = IMAGE_COMDAT_SELECT_NODUPLICATES;
+        return result;
+    };
+    COFFObject object;
+    appendFunctions(object, {
+        function("main", {0xE8, 0, 0, 0, 0, 0xE8, 0, 0, 0, 0, 0xC3},
+                 {{1, "first", IMAGE_REL_AMD64_REL32}, {6, "second", IMAGE_REL_AMD64_REL32}}),
+        function("first", {0xE8, 0, 0, 0, 0, 0xC3}, {{1, "leafA", IMAGE_REL_AMD64_REL32}}),
+        function("second", {0xE8, 0, 0, 0, 0, 0xC3}, {{1, "leafB", IMAGE_REL_AMD64_REL32}}),
+        function("leafA", {0x31, 0xC0, 0xC3}, {}),
+        function("leafB", {0x31, 0xC0, 0xC3}, {})});
+    fs::path objectPath = getTempFile("icf.obj");
+    ASSERT_TRUE(COFFWriter().writeObject(object, objectPath.string()));
+
+    MiniLinker folding;
+    folding.setOptimize(true);
+    ASSERT_TRUE(folding.addObjectFile(objectPath));
+    LinkResult folded = folding.link(getTempFile("icf.exe"));
+    ASSERT_TRUE(folded.success) << folded.errorMessage;
+    EXPECT_EQ(folding.getLinkStatistics()["folded_sections"], 2u);
+    EXPECT_EQ(folded.symbolAddresses["leafA"], folded.symbolAddresses["leafB"]);
+    EXPECT_EQ(folded.symbolAddresses["first"], folded.symbolAddresses["second"]);
+
+    // Sin plegar, el archivo de orden (con recuentos) coloca primero lo más caliente
+    fs::path orderPath = getTempFile("order.txt");
+    std::ofstream(orderPath) << "# perfil\nleafA 10\n\nsecond 300\nmissing 5\n";
+    MiniLinker ordering;
+    ASSERT_TRUE(ordering.loadOrderFile(orderPath));
+    ASSERT_TRUE(ordering.addObjectFile(objectPath));
+    LinkResult ordered = ordering.link(getTempFile("order.exe"));
+    ASSERT_TRUE(ordered.success) << ordered.errorMessage;
+    EXPECT_EQ(ordering.getLinkStatistics()["folded_sections"], 0u);
+    EXPECT_LT(ordered.symbolAddresses["second"], ordered.symbolAddresses["leafA"]);
+    EXPECT_LT(ordered.symbolAddresses["leafA"], ordered.symbolAddresses["main"]);
+    EXPECT_LT(ordered.symbolAddresses["main"], ordered.symbolAddresses["first"]);
+    EXPECT_FALSE(ordering.loadOrderFile(getTempFile("missing.txt")));
+}
+
+TEST_F(COFFWriterTest, LinkerWritesBaseRelocationsAndChecksum) {
+    using namespace cpp20::compiler::backend::link;
+
+    // mov rax, imm64 con la dirección absoluta de callee
+    COFFFunction main{"main", {0x48, 0xB8, 0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0xE0}, {},
+                      {{2, "callee", IMAGE_REL_AMD64_ADDR64}}};
+    COFFFunction callee{"callee", {0x31, 0xC0, 0xC3}, {}, {}};
+    COFFObject object;
+    appendFunctions(object, {main, callee});
+    fs::path objectPath = getTempFile("abs.obj");
+    ASSERT_TRUE(COFFWriter().writeObject(object, objectPath.string()));
+
+    auto linkWith = [&](size_t jobs, const std::string& name) {
+        MiniLinker linker;
+        linker.setJobs(jobs);
+        EXPECT_TRUE(linker.addObjectFile(objectPath));
+        LinkResult result = linker.link(getTempFile(name));
+        EXPECT_TRUE(result.success) << result.errorMessage;
+        return std::pair{result, readBytes(getTempFile(name))};
+    };
+    auto [result, image] = linkWith(1, "abs.exe");
+
+    // Las relocations base van al final: un bloque con la entrada DIR64 y relleno
+    ASSERT_GE(image.size(), 12u);
+    IMAGE_BASE_RELOCATION block;
+    std::memcpy(&block, image.data() + image.size() - 12, sizeof(block));
+    uint32_t target = result.symbolAddresses["main"] + 2;
+    EXPECT_EQ(block.VirtualAddress, target & ~0xFFFu);
+    EXPECT_EQ(block.SizeOfBlock, 12u);
+    uint16_t entries[2];
+    std::memcpy(entries, image.data() + image.size() - 4, sizeof(entries));
+    EXPECT_EQ(entries[0], (IMAGE_REL_BASED_DIR64 << 12) | (target & 0xFFF));
+    EXPECT_EQ(entries[1], IMAGE_REL_BASED_ABSOLUTE);
+
+    // Checksum de referencia: palabra a palabra, con el campo a cero
+    const char signature[] = "PE\0\0";
+    auto pe = std::search(image.begin(), image.end(), signature, signature + 4);
+    ASSERT_NE(pe, image.end());
+    size_t checksumOffset = static_cast<size_t>(pe - image.begin()) + 4 + 20 + 64;
+    uint32_t stored;
+    std::memcpy(&stored, image.data() + checksumOffset, sizeof(stored));
+    uint64_t sum = 0;
+    for (size_t i = 0; i < image.size(); i += 2) {
+        if (i == checksumOffset || i == checksumOffset + 2) continue;
+        sum += image[i] | (i + 1 < image.size() ? image[i + 1] << 8 : 0);
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    EXPECT_NE(stored, 0u);
+    EXPECT_EQ(stored, static_cast<uint32_t>(sum) + image.size());
+
+    // En paralelo sale lo mismo (salvo el TimeDateStamp, que entra en el checksum)
+    auto [parallelResult, parallelImage] = linkWith(4, "abs_parallel.exe");
+    ASSERT_EQ(parallelImage.size(), image.size());
+    EXPECT_TRUE(std::equal(image.end() - 12, image.end(), parallelImage.end() - 12));
+}
+
+TEST_F(COFFWriterTest, LinkerLinksObjectImagesWithoutTempFiles) {
+    using namespace cpp20::compiler::backend::link;
+
+    COFFFunction main{"main", {0x48, 0x83, 0xEC, 0x28, 0xE8, 0, 0, 0, 0, 0x48, 0x83, 0xC4, 0x28, 0xC3},
+                      {0x01, 0x04, 0x01, 0x00, 0x04, 0x42}, {{5, "callee", IMAGE_REL_AMD64_REL32}}};
+    COFFFunction callee{"callee", {0x31, 0xC0, 0xC3}, {}, {}};
+    COFFObject first, second;
+    appendFunctions(first, {main});
+    appendFunctions(second, {callee});
+
+    // En memoria salen los mismos bytes que en disco
+    std::vector<uint8_t> firstImage, secondImage;
+    ASSERT_TRUE(COFFWriter().writeObject(first, firstImage));
+    ASSERT_TRUE(COFFWriter().writeObject(second, secondImage));
+    fs::path firstPath = getTempFile("first.obj");
+    fs::path secondPath = getTempFile("second.obj");
+    ASSERT_TRUE(COFFWriter().writeObject(first, firstPath.string()));
+    ASSERT_TRUE(COFFWriter().writeObject(second, secondPath.string()));
+    EXPECT_EQ(firstImage, readBytes(firstPath));
+
+    MiniLinker fromFiles;
+    ASSERT_TRUE(fromFiles.addObjectFiles({firstPath, secondPath}));
+    LinkResult expected = fromFiles.link(getTempFile("files.exe"));
+    ASSERT_TRUE(expected.success) << expected.errorMessage;
+
+    MiniLinker inProcess;
+    inProcess.setJobs(2);
+    ASSERT_TRUE(inProcess.addObjectImages({{"first.obj", std::move(firstImage)},
+                                           {"second.obj", std::move(secondImage)}}));
+    LinkResult result = inProcess.link(getTempFile("memory.exe"));
+    ASSERT_TRUE(result.success) << result.errorMessage;
+    EXPECT_EQ(result.symbolAddresses, expected.symbolAddresses);
+
+    // Mismo ejecutable, salvo TimeDateStamp y el checksum que lo incluye
+    auto image = [&](const std::string& name) {
+        std::vector<uint8_t> bytes = readBytes(getTempFile(name));
+        std::fill_n(bytes.begin() + 64 + 4 + 4, 4, 0);
+        const char signature[] = "PE\0\0";
+        auto pe = std::search(bytes.begin() + 64, bytes.end(), signature, signature + 4);
+        if (pe != bytes.end()) std::fill_n(pe + 4 + 20 + 64, 4, 0);
+        return bytes;
+    };
+    EXPECT_EQ(image("memory.exe"), image("files.exe"));
+    EXPECT_FALSE(inProcess.addObjectImages({{"garbage.obj", {1, 2, 3}}}));
+}
+
+TEST_F(COFFWriterTest, LinkerRejectsDuplicateNoDuplicatesComdat) {
+    using namespace cpp20::compiler::backend::link;
+
+    COFFFunction twice{"twice", {0xC3}, {}, {}};
+    twice.comdatSelection = IMAGE_COMDAT_SELECT_NODUPLICATES;
+    COFFObject object;
+    appendFunctions(object, {twice});
+    fs::path first = getTempFile("one.obj");
+    fs::path second = getTempFile("two.obj");
+    ASSERT_TRUE(COFFWriter().writeObject(object, first.string()));
+    ASSERT_TRUE(COFFWriter().writeObject(object, second.string()));
+
+    MiniLinker linker;
+    linker.setEntryPoint("twice");
+    ASSERT_TRUE(linker.addObjectFile(first));
+    ASSERT_TRUE(linker.addObjectFile(second));
+    LinkResult result = linker.link(getTempFile("b.exe"));
+    EXPECT_FALSE(result.success);
+    EXPECT_NE(result.errorMessage.find("twice"), std::string::npos);
+}
+
+TEST_F(COFFWriterTest, DumperShowsLibraryMembersAndAppliesFilters) {
+    auto objectWith = [&](const std::vector<std::string>& names) {
+        std::vector<COFFFunction> functions;
+        for (const auto& name : names) functions.push_back({name, {0x31, 0xC0, 0xC3}, {}, {}});
+        COFFObject object;
+        appendFunctions(object, functions);
+        fs::path path = getTempFile(names.front() + ".obj");
+        EXPECT_TRUE(COFFWriter().writeObject(object, path.string()));
+        return readBytes(path);
+    };
+
+    IMPORT_OBJECT_HEADER importHeader{};
+    importHeader.Sig2 = IMPORT_OBJECT_HDR_SIG2;
+    importHeader.Machine = IMAGE_FILE_MACHINE_AMD64;
+    std::string importNames("ExitProcess\0kernel32.dll\0", 25);
+    importHeader.SizeOfData = static_cast<uint32_t>(importNames.size());
+    std::vector<uint8_t> importMember(sizeof(importHeader) + importNames.size());
+    std::memcpy(importMember.data(), &importHeader, sizeof(importHeader));
+    std::memcpy(importMember.data() + sizeof(importHeader), importNames.data(), importNames.size());
+
+    fs::path library = writeArchive("dump.lib", {{{"helper"}, objectWith({"helper"})},
+                                                 {{"unused"}, objectWith({"unused"})},
+                                                 {{"ExitProcess"}, importMember}});
+
+    std::stringstream full;
+    EXPECT_TRUE(COFFDumper().dumpFile(library.string(), full));
+    EXPECT_NE(full.str().find("Archive: 3 members"), std::string::npos);
+    EXPECT_NE(full.str().find("Member: m1.obj"), std::string::npos);
+    EXPECT_NE(full.str().find("Import:        ExitProcess from kernel32.dll"), std::string::npos);
+    EXPECT_LT(full.str().find("helper"), full.str().find("unused"));
+
+    // Solo el miembro con el símbolo, sin cabeceras ni secciones
+    COFFDumper bySymbol;
+    bySymbol.setSymbolFilter("hel*");
+    std::stringstream symbols;
+    EXPECT_TRUE(bySymbol.dumpFile(library.string(), symbols));
+    EXPECT_NE(symbols.str().find("Member: m0.obj"), std::string::npos);
+    EXPECT_NE(symbols.str().find("Name:          helper"), std::string::npos);
+    EXPECT_EQ(symbols.str().find("m1.obj"), std::string::npos);
+    EXPECT_EQ(symbols.str().find("COFF File Header"), std::string::npos);
+    EXPECT_EQ(symbols.str().find("Section Header"), std::string::npos);
+
+    COFFDumper bySection;
+    bySection.addSectionFilter(".text");
+    std::stringstream sections;
+    EXPECT_TRUE(bySection.dumpFile(library.string(), sections));
+    EXPECT_NE(sections.str().find("Section Data (.text)"), std::string::npos);
+    EXPECT_EQ(sections.str().find("Symbol Table"), std::string::npos);
+    EXPECT_EQ(sections.str().find("ExitProcess"), std::string::npos);
+
+    EXPECT_TRUE(COFFDumper::matchesPattern("?f@@YAHXZ", "?f@@*"));
+    EXPECT_TRUE(COFFDumper::matchesPattern("helper", "*p*r"));
+    EXPECT_FALSE(COFFDumper::matchesPattern("helper", "h?lper"));
+    EXPECT_FALSE(COFFDumper::matchesPattern("helper", "*x*"));
+}
+
+TEST_F(COFFWriterTest, ParallelDumpMatchesSerialDump) {
+    // Tabla de símbolos de varios tramos y una biblioteca de muchos miembros
+    std::vector<COFFFunction> functions;
+    for (int i = 0; i < 10000; ++i) {
+        functions.push_back({"f" + std::to_string(i), {0xC3}, {}, {}});
+    }
+    COFFObject object;
+    appendFunctions(object, functions);
+    fs::path objectPath = getTempFile("many.obj");
+    ASSERT_TRUE(COFFWriter().writeObject(object, objectPath.string()));
+
+    std::vector<ArchiveMember> members;
+    for (int i = 0; i < 64; ++i) {
+        std::string name = "g" + std::to_string(i);
+        COFFObject member;
+        appendFunctions(member, {{name, {0xC3}, {}, {}}});
+        fs::path path = getTempFile(name + ".obj");
+        ASSERT_TRUE(COFFWriter().writeObject(member, path.string()));
+        members.push_back({{name}, readBytes(path)});
+    }
+    fs::path library = writeArchive("many.lib", members);
+
+    for (const fs::path& path : {objectPath, library}) {
+        COFFDumper serial;
+        serial.setJobs(1);
+        COFFDumper parallel;
+        parallel.setJobs(4);
+        std::stringstream serialOutput;
+        std::stringstream parallelOutput;
+        ASSERT_TRUE(serial.dumpFile(path.string(), serialOutput));
+        ASSERT_TRUE(parallel.dumpFile(path.string(), parallelOutput));
+        EXPECT_EQ(parallelOutput.str(), serialOutput.str()) << path;
+    }
+}
+
+namespace {
+
+using namespace cpp20::compiler;
+
+const ir::TypeInfo IRInt(ir::IRType::Int, 4, 4, "i32");
+
+// Objeto de -flto con el módulo de una unidad
+std::vector<uint8_t> ltoObject(const ir::IRModule& module) {
+    COFFObject object = createBasicCOFFObject();
+    backend::link::embedIRModule(object, module);
+    std::vector<uint8_t> image;
+    EXPECT_TRUE(COFFWriter().writeObject(object, image));
+    return image;
+}
+
+// int name(int x) { return x * 2; }
+std::unique_ptr<ir::IRFunction> makeTwice(const std::string& name, ir::Linkage linkage) {
+    auto function = std::make_unique<ir::IRFunction>(name, IRInt, std::vector<ir::TypeInfo>{IRInt});
+    function->setLinkage(linkage);
+    ir::IRBuilder builder(*function);
+    builder.setInsertPoint(builder.createBlock("entry"));
+    builder.createReturn(builder.createBinary(ir::IROpcode::Mul, function->parameter(0),
+                                              builder.getInt(2, IRInt), IRInt));
+    return function;
+}
+
+} // namespace
+
+TEST_F(COFFWriterTest, LinkTimeOptimizationInlinesAcrossObjects) {
+    using namespace cpp20::compiler::backend::link;
+
+    // main.cpp: int helper(int); int main() { return helper(20); }
+    ir::IRModule mainUnit("main");
+    mainUnit.addFunction(std::make_unique<ir::IRFunction>("helper", IRInt, std::vector<ir::TypeInfo>{IRInt}));
+    auto main = std::make_unique<ir::IRFunction>("main", IRInt, std::vector<ir::TypeInfo>{});
+    ir::IRBuilder builder(*main);
+    builder.setInsertPoint(builder.createBlock("entry"));
+    ir::ValueId args[] = {builder.getInt(20, IRInt)};
+    builder.createReturn(builder.createCall(builder.getGlobal("helper", IRInt), args, IRInt));
+    mainUnit.addFunction(std::move(main));
+
+    // helper.cpp: helper y una inline que nadie llama
+    ir::IRModule helperUnit("helper");
+    helperUnit.addFunction(makeTwice("helper", ir::Linkage::External));
+    helperUnit.addFunction(makeTwice("unused", ir::Linkage::LinkOnce));
+
+    std::vector<uint8_t> mainImage = ltoObject(mainUnit);
+    std::vector<uint8_t> helperImage = ltoObject(helperUnit);
+
+    // El inliner ve el cuerpo de helper desde main
+    LinkTimeOptimizer direct;
+    std::vector<uint8_t> mainIR, helperIR;
+    ir::serializeModule(mainUnit, mainIR);
+    ir::serializeModule(helperUnit, helperIR);
+    ASSERT_TRUE(direct.addModule(mainIR, "main.obj"));
+    ASSERT_TRUE(direct.addModule(helperIR, "helper.obj"));
+    direct.optimize();
+    EXPECT_EQ(direct.getStatistics().functions, 2u);
+    EXPECT_EQ(direct.getStatistics().removedFunctions, 1u);
+    for (const auto& function : direct.getModule().getFunctions()) {
+        if (function->getName() != "main") continue;
+        for (ir::BlockId block = 0; block < function->blockCount(); ++block) {
+            for (ir::InstrId id : function->instructions(block)) {
+                EXPECT_NE(function->instruction(id).opcode, ir::IROpcode::Call);
+            }
+        }
+    }
+
+    MiniLinker linker;
+    linker.setEntryPoint("main");
+    linker.setJobs(2);
+    ASSERT_TRUE(linker.addObjectImages({{"main.obj", mainImage}, {"helper.obj", helperImage}}));
+    LinkResult result = linker.link(getTempFile("lto.exe"));
+    ASSERT_TRUE(result.success) << result.errorMessage;
+    EXPECT_EQ(linker.getLinkStatistics()["lto_modules"], 2u);
+    EXPECT_EQ(linker.getLinkStatistics()["lto_partitions"], 2u);
+    EXPECT_TRUE(result.symbolAddresses.count("main"));
+    EXPECT_TRUE(result.symbolAddresses.count("helper"));
+    EXPECT_FALSE(result.symbolAddresses.count("unused"));
+
+    // Dos definiciones External del mismo nombre no se fusionan
+    MiniLinker duplicate;
+    ASSERT_TRUE(duplicate.addObjectImages({{"a.obj", helperImage}, {"b.obj", helperImage}}));
+    LinkResult failed = duplicate.link(getTempFile("dup.exe"));
+    EXPECT_FALSE(failed.success);
+    EXPECT_NE(failed.errorMessage.find("helper"), std::string::npos);
+}
+
+TEST_F(COFFWriterTest, LinkTimeOptimizationReusesCachedMachineCode) {
+    using namespace cpp20::compiler::backend::link;
+
+    ir::IRModule unit("unit");
+    unit.addFunction(makeTwice("main", ir::Linkage::External));
+    unit.addFunction(makeTwice("helper", ir::Linkage::External));
+    std::vector<uint8_t> image = ltoObject(unit);
+
+    auto cache = std::make_shared<backend::MachineCodeCache>(
+        std::make_shared<DirectoryCacheBackend>(tempDir / "codegen"), "test-compiler");
+    auto link = [&](const std::string& output) {
+        MiniLinker linker;
+        linker.setEntryPoint("main");
+        linker.setCodeCache(cache);
+        EXPECT_TRUE(linker.addObjectImages({{"unit.obj", image}}));
+        LinkResult result = linker.link(getTempFile(output));
+        EXPECT_TRUE(result.success) << result.errorMessage;
+        cache->wait();
+        return linker.getLinkStatistics()["lto_cached_functions"];
+    };
+
+    // El segundo enlace no pasa ninguna función por el back-end y da la misma imagen
+    EXPECT_EQ(link("cold.exe"), 0u);
+    EXPECT_EQ(link("warm.exe"), 2u);
+    EXPECT_EQ(cache->hitCount(), 2u);
+    EXPECT_EQ(readBytes(getTempFile("cold.exe")), readBytes(getTempFile("warm.exe")));
+
+    // Otro compilador no ve esas entradas
+    backend::MachineCodeCache other(std::make_shared<DirectoryCacheBackend>(tempDir / "codegen"), "other");
+    backend::abi::ABIContract abi;
+    backend::CodeGenerator generator(abi);
+    generator.setSharedCache(&other);
+    backend::IncrementalStats stats;
+    generator.generateModule(unit, 1, &stats);
+    EXPECT_EQ(stats.reused, 0u);
+    EXPECT_EQ(stats.regenerated, 2u);
+}
+
+// ========================================================================
+// Llamadas en cola
+// ========================================================================
+
+TEST_F(COFFWriterTest, TailCallsLowerToEpilogueAndJump) {
+    const ir::TypeInfo IRPtr(ir::IRType::Pointer, 8, 8, "ptr");
+    backend::abi::ABIContract abi;
+    backend::CodeGenerator generator(abi);
+
+    // void resume(ptr frame) { step(frame) en cola }: hoja, solo el salto
+    ir::IRFunction leaf("resume", ir::TypeInfo(), {IRPtr});
+    leaf.addParameter("frame", IRPtr);
+    ir::IRBuilder leafBuilder(leaf);
+    leafBuilder.setInsertPoint(leafBuilder.createBlock("entry"));
+    ir::ValueId leafArgs[] = {leaf.parameter(0)};
+    ir::InstrId tail = leafBuilder.createTailCall(leafBuilder.getGlobal("step", IRPtr), leafArgs, ir::TypeInfo());
+    EXPECT_TRUE(leaf.instruction(tail).tail);
+
+    backend::FunctionCode code = generator.generateFunction(leaf);
+    ASSERT_EQ(code.code, (std::vector<uint8_t>{0xE9, 0, 0, 0, 0}));
+    ASSERT_EQ(code.relocations.size(), 1u);
+    EXPECT_EQ(code.relocations[0].symbol, "step");
+    EXPECT_EQ(code.relocations[0].offset, 1u);
+    EXPECT_TRUE(code.unwindInfo.empty());
+
+    // Con marco: el epílogo libera la pila y el salto sustituye a CALL + RET
+    ir::IRFunction framed("resumeLogged", IRInt, {IRPtr});
+    framed.addParameter("frame", IRPtr);
+    ir::IRBuilder builder(framed);
+    builder.setInsertPoint(builder.createBlock("entry"));
+    ir::ValueId args[] = {framed.parameter(0)};
+    builder.createCall(builder.getGlobal("trace", IRPtr), args, ir::TypeInfo());
+    builder.createTailCall(builder.getGlobal("step", IRPtr), args, IRInt);
+
+    code = generator.generateFunction(framed);
+    ASSERT_GE(code.code.size(), 5u);
+    EXPECT_EQ(code.code[code.code.size() - 5], 0xE9);
+    EXPECT_EQ(std::count(code.code.begin(), code.code.end(), 0xC3), 0);
+    ASSERT_EQ(code.relocations.size(), 2u);
+    EXPECT_EQ(code.relocations[0].symbol, "trace");
+    EXPECT_EQ(code.code[code.relocations[0].offset - 1], 0xE8);
+    EXPECT_EQ(code.relocations[1].symbol, "step");
+    EXPECT_EQ(code.relocations[1].offset, code.code.size() - 4);
+    EXPECT_FALSE(code.unwindInfo.empty());
+
+    // Separado de su Ret deja de ser una llamada en cola
+    ir::IRFunction split("notTail", IRInt, {});
+    ir::IRBuilder splitBuilder(split);
+    splitBuilder.setInsertPoint(splitBuilder.createBlock("entry"));
+    ir::ValueId result = splitBuilder.createCall(splitBuilder.getGlobal("step", IRPtr), {}, IRInt);
+    split.setTailCall(split.definingInstruction(result));
+    splitBuilder.createReturn(splitBuilder.createBinary(ir::IROpcode::Add, result, splitBuilder.getInt(1, IRInt), IRInt));
+    code = generator.generateFunction(split);
+    ASSERT_FALSE(code.code.empty());
+    EXPECT_EQ(code.code[code.relocations[0].offset - 1], 0xE8);
+    EXPECT_EQ(code.code.back(), 0xC3);
+
+    // Argumentos en pila: caben en el área de entrada del llamador si no recibe menos
+    auto forwarding = [&](size_t arguments) {
+        ir::IRFunction forward("forward", IRInt, std::vector<ir::TypeInfo>(5, IRInt));
+        ir::IRBuilder forwardBuilder(forward);
+        forwardBuilder.setInsertPoint(forwardBuilder.createBlock("entry"));
+        std::vector<ir::ValueId> passed;
+        for (size_t i = 0; i < arguments; ++i) passed.push_back(forward.parameter(i % 5));
+        forwardBuilder.createTailCall(forwardBuilder.getGlobal("step", IRPtr), passed, IRInt);
+        return generator.generateFunction(forward);
+    };
+    code = forwarding(5);
+    ASSERT_EQ(code.relocations.size(), 1u);
+    EXPECT_EQ(code.code[code.relocations[0].offset - 1], 0xE9);
+    code = forwarding(6);
+    ASSERT_EQ(code.relocations.size(), 1u);
+    EXPECT_EQ(code.code[code.relocations[0].offset - 1], 0xE8);
+}
+
+TEST_F(COFFWriterTest, DenseSwitchUsesJumpTableInRdata) {
+    using namespace cpp20::compiler::backend::link;
+    backend::abi::ABIContract abi;
+    backend::CodeGenerator generator(abi);
+
+    // int main(int x) { switch (x) { case 1..5: return 10 * x; default: return 0; } }
+    ir::IRFunction function("main", IRInt, {IRInt});
+    function.addParameter("x", IRInt);
+    ir::IRBuilder builder(function);
+    ir::BlockId entry = builder.createBlock("entry");
+    ir::BlockId fallback = builder.createBlock("default");
+    std::vector<std::pair<int64_t, ir::BlockId>> cases;
+    for (int64_t value = 1; value <= 5; ++value) {
+        cases.emplace_back(value, builder.createBlock("case" + std::to_string(value)));
+    }
+    builder.setInsertPoint(entry);
+    builder.createSwitch(function.parameter(0), fallback, cases);
+    for (const auto& [value, block] : cases) {
+        builder.setInsertPoint(block);
+        builder.createReturn(builder.getInt(10 * value, IRInt));
+    }
+    builder.setInsertPoint(fallback);
+    builder.createReturn(builder.getInt(0, IRInt));
+
+    backend::FunctionCode code = generator.generateFunction(function);
+    ASSERT_FALSE(code.code.empty()) << code.encodingError;
+    ASSERT_EQ(code.jumpTables.size(), 1u);
+    ASSERT_EQ(code.jumpTables[0].targets.size(), 5u);
+    for (uint32_t target : code.jumpTables[0].targets) EXPECT_LT(target, code.code.size());
+    auto relocation = [&](const std::string& symbol) {
+        return std::count_if(code.relocations.begin(), code.relocations.end(),
+                             [&](const COFFFunctionRelocation& r) { return r.symbol == symbol; });
+    };
+    EXPECT_EQ(relocation(ImageBaseSymbol), 1);
+    EXPECT_EQ(relocation(code.jumpTables[0].name), 1);
+
+    // Una entrada ADDR32NB por caso, contra el símbolo de la función
+    COFFObject object;
+    appendFunctions(object, {backend::CodeGenerator::toCOFFFunction(code)});
+    auto rdata = std::find_if(object.sections.begin(), object.sections.end(),
+                              [](const COFFSection& section) { return section.name == ".rdata"; });
+    ASSERT_NE(rdata, object.sections.end());
+    EXPECT_EQ(rdata->data.size(), 5u * 4);
+    ASSERT_EQ(rdata->relocations.size(), 5u);
+    for (const IMAGE_RELOCATION& entry : rdata->relocations) {
+        EXPECT_EQ(entry.Type, IMAGE_REL_AMD64_ADDR32NB);
+    }
+
+    // __ImageBase lo define el enlazador
+    std::vector<uint8_t> image;
+    ASSERT_TRUE(COFFWriter().writeObject(object, image));
+    MiniLinker linker;
+    ASSERT_TRUE(linker.addObjectImages({{"switch.obj", std::move(image)}}));
+    LinkResult result = linker.link(getTempFile("switch.exe"));
+    EXPECT_TRUE(result.success) << result.errorMessage;
+}
+
+TEST_F(COFFWriterTest, AlignedLoopHeadersArePaddedWithLongNops) {
+    using backend::X86Instruction;
+    using backend::X86Opcode;
+    using backend::X86Operand;
+    auto reg = [](backend::X86Register r) {
+        X86Operand operand(backend::AddressingMode::Register);
+        operand.reg = r;
+        return operand;
+    };
+    auto imm = [](int64_t value) {
+        X86Operand operand(backend::AddressingMode::Immediate);
+        operand.immediate = value;
+        return operand;
+    };
+
+    // xor eax, eax; loop (alineado a 16): inc rax; cmp rax, 10; jne loop; ret
+    std::vector<X86Instruction> body(6);
+    body[0].opcode = X86Opcode::XOR;
+    body[0].operands = {reg(backend::X86Register::EAX), reg(backend::X86Register::EAX)};
+    body[1].comment = "loop:";
+    body[1].operands = {imm(16)};
+    body[2].opcode = X86Opcode::INC;
+    body[2].operands = {reg(backend::X86Register::RAX)};
+    body[3].opcode = X86Opcode::CMP;
+    body[3].operands = {reg(backend::X86Register::RAX), imm(10)};
+    body[4].opcode = X86Opcode::JNE;
+    body[4].comment = "loop";
+    body[5].opcode = X86Opcode::RET;
+
+    backend::X86Encoder encoder;
+    std::vector<uint8_t> code;
+    std::vector<COFFFunctionRelocation> relocations;
+    ASSERT_TRUE(encoder.encode(body, code, relocations)) << encoder.getLastError();
+    ASSERT_EQ(encoder.labelOffsets().at("loop"), 16u);
+
+    // 2 bytes de XOR, relleno de 14 en dos NOPs largos y el salto de vuelta al inicio alineado
+    EXPECT_EQ(std::vector<uint8_t>(code.begin() + 2, code.begin() + 16),
+              (std::vector<uint8_t>{0x66, 0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                    0x0F, 0x1F, 0x44, 0x00, 0x00}));
+    ASSERT_GE(code.size(), 3u);
+    EXPECT_EQ(code[code.size() - 3], 0x75);
+    EXPECT_EQ(code.size() - 1 + static_cast<int8_t>(code[code.size() - 2]), 16u);
+    EXPECT_EQ(code.back(), 0xC3);
+}
+
+TEST_F(COFFWriterTest, SelectsLowerToCmovAndMinMax) {
+    const ir::TypeInfo IRFloat(ir::IRType::Float, 4, 4, "f32");
+    const ir::TypeInfo IRBool(ir::IRType::Bool, 1, 1, "bool");
+    backend::abi::ABIContract abi;
+    backend::CodeGenerator generator(abi);
+    auto makeMax = [&](const std::string& name, const ir::TypeInfo& type) {
+        auto function = std::make_unique<ir::IRFunction>(name, type, std::vector<ir::TypeInfo>{type, type});
+        function->addParameter("a", type);
+        function->addParameter("b", type);
+        ir::IRBuilder builder(*function);
+        builder.setInsertPoint(builder.createBlock("entry"));
+        ir::ValueId a = function->parameter(0), b = function->parameter(1);
+        ir::ValueId greater = builder.createBinary(ir::IROpcode::CmpGT, a, b, IRBool);
+        builder.createReturn(builder.createSelect(greater, a, b, type));
+        return function;
+    };
+
+    // int: CMP + CMOVcc, sin ningún salto condicional
+    backend::FunctionCode code = generator.generateFunction(*makeMax("imax", IRInt));
+    ASSERT_FALSE(code.code.empty()) << code.encodingError;
+    bool cmov = false;
+    for (size_t i = 0; i + 1 < code.code.size(); ++i) {
+        if (code.code[i] == 0x0F && (code.code[i + 1] & 0xF0) == 0x40) cmov = true;
+        EXPECT_FALSE(code.code[i] == 0x0F && (code.code[i + 1] & 0xF0) == 0x80) << i;
+    }
+    EXPECT_TRUE(cmov);
+
+    // float: a > b ? a : b es MAXSS (F3, REX opcional, 0F 5F)
+    code = generator.generateFunction(*makeMax("fmax", IRFloat));
+    ASSERT_FALSE(code.code.empty()) << code.encodingError;
+    bool maxss = false;
+    for (size_t i = 2; i + 1 < code.code.size(); ++i) {
+        if (code.code[i] != 0x0F || code.code[i + 1] != 0x5F) continue;
+        maxss |= code.code[i - 1] == 0xF3 || (code.code[i - 2] == 0xF3 && (code.code[i - 1] & 0xF0) == 0x40);
+    }
+    EXPECT_TRUE(maxss);
+}
+
+TEST_F(COFFWriterTest, FramesOfAPageOrMoreProbeTheStack) {
+    backend::abi::ABIContract abi;
+    backend::InstructionSelector selector(abi);
+    backend::FrameRequirements requirements;
+    requirements.localSize = 0x1F00;
+    backend::FrameLayout frame = backend::FrameBuilder().buildFunctionFrame(requirements);
+    ASSERT_TRUE(frame.needsStackProbe());
+
+    // mov eax, N; call __chkstk; sub rsp, rax
+    std::vector<uint8_t> bytes;
+    std::vector<backend::coff::COFFFunctionRelocation> relocations;
+    ASSERT_TRUE(backend::X86Encoder().encode(selector.generateFunctionPrologue(frame), bytes, relocations));
+    ASSERT_EQ(bytes.size(), 13u);
+    EXPECT_EQ(bytes[0], 0xB8);
+    uint32_t size;
+    std::memcpy(&size, &bytes[1], sizeof(size));
+    EXPECT_EQ(size, frame.allocationSize);
+    EXPECT_EQ(bytes[5], 0xE8);
+    ASSERT_EQ(relocations.size(), 1u);
+    EXPECT_EQ(relocations[0].symbol, "__chkstk");
+    EXPECT_EQ((std::vector<uint8_t>(bytes.begin() + 10, bytes.end())), (std::vector<uint8_t>{0x48, 0x29, 0xC4}));
+
+    // Un solo código de unwind, al final del SUB
+    auto codes = backend::unwind::UnwindCodeGenerator::generateFromPrologue(bytes, size, 0);
+    ASSERT_EQ(codes.size(), 1u);
+    EXPECT_EQ(codes[0].codeOffset, 13);
+    EXPECT_EQ(codes[0].unwindOp, static_cast<uint8_t>(backend::unwind::UnwindOpCode::ALLOC_LARGE));
+
+    // Por debajo de una página basta el SUB
+    requirements.localSize = 0x0F00;
+    frame = backend::FrameBuilder().buildFunctionFrame(requirements);
+    EXPECT_FALSE(frame.needsStackProbe());
+    bytes.clear();
+    relocations.clear();
+    ASSERT_TRUE(backend::X86Encoder().encode(selector.generateFunctionPrologue(frame), bytes, relocations));
+    EXPECT_TRUE(relocations.empty());
+}
+
+TEST_F(COFFWriterTest, SpillSlotsAreReusedOnceTheirValuesDie) {
+    // Dos fases con más valores vivos que registros: la segunda reutiliza los slots de la primera
+    auto function = std::make_unique<ir::IRFunction>("pressure", IRInt, std::vector<ir::TypeInfo>{IRInt});
+    ir::IRBuilder builder(*function);
+    builder.setInsertPoint(builder.createBlock("entry"));
+    ir::ValueId base = function->parameter(0);
+    for (int phase = 0; phase < 2; ++phase) {
+        std::vector<ir::ValueId> values;
+        for (int k = 1; k <= 24; ++k) {
+            values.push_back(builder.createBinary(ir::IROpcode::Mul, base, builder.getInt(k, IRInt), IRInt));
+        }
+        for (ir::ValueId value : values) base = builder.createBinary(ir::IROpcode::Add, base, value, IRInt);
+    }
+    builder.createReturn(base);
+
+    backend::abi::ABIContract abi;
+    for (auto strategy : {backend::AllocationStrategy::LinearScan, backend::AllocationStrategy::GraphColoring}) {
+        backend::FunctionCode code = backend::CodeGenerator(abi, {}, strategy).generateFunction(*function);
+        ASSERT_FALSE(code.code.empty()) << code.encodingError;
+        ASSERT_GT(code.allocation.registersSpilled, 0u);
+        EXPECT_LT(code.allocation.spillSlotsUsed, code.allocation.registersSpilled);
+        EXPECT_LT(code.stackSize, 8 * code.allocation.registersSpilled);
+    }
+}
+
+TEST_F(COFFWriterTest, SpilledAddressesAreRematerializedInsteadOfReloaded) {
+    // Direcciones de elementos de un global vivas a la vez: sobran para los registros
+    const ir::TypeInfo IRPtr(ir::IRType::Pointer, 8, 8, "ptr");
+    auto function = std::make_unique<ir::IRFunction>("addresses", IRInt, std::vector<ir::TypeInfo>{IRInt});
+    ir::IRBuilder builder(*function);
+    builder.setInsertPoint(builder.createBlock("entry"));
+    ir::ValueId table = builder.getGlobal("table", IRPtr);
+    std::vector<ir::ValueId> addresses;
+    for (int k = 0; k < 24; ++k) {
+        addresses.push_back(builder.createBinary(ir::IROpcode::GetElementPtr, table, builder.getInt(k, IRInt), IRPtr));
+    }
+    ir::ValueId sum = function->parameter(0);
+    for (ir::ValueId address : addresses) {
+        sum = builder.createBinary(ir::IROpcode::Add, sum, builder.createLoad(address, IRInt), IRInt);
+    }
+    builder.createReturn(sum);
+
+    backend::abi::ABIContract abi;
+    for (auto strategy : {backend::AllocationStrategy::LinearScan, backend::AllocationStrategy::GraphColoring}) {
+        backend::FunctionCode code = backend::CodeGenerator(abi, {}, strategy).generateFunction(*function);
+        ASSERT_FALSE(code.code.empty()) << code.encodingError;
+        ASSERT_GT(code.allocation.registersSpilled, 0u);
+        EXPECT_EQ(code.allocation.rematerialized, code.allocation.registersSpilled);
+        EXPECT_EQ(code.allocation.spillStores, 0u);
+        EXPECT_EQ(code.allocation.reloads, 0u);
+        EXPECT_EQ(code.allocation.spillSlotsUsed, 0u);
+    }
+}
+
+TEST_F(COFFWriterTest, SmallMemoryIntrinsicsExpandToVectorMoves) {
+    const ir::TypeInfo IRPtr(ir::IRType::Pointer, 8, 8, "ptr");
+    const ir::TypeInfo IRSize(ir::IRType::LongLong, 8, 8, "i64");
+    const ir::TypeInfo IRBool(ir::IRType::Bool, 1, 1, "bool");
+    auto function = std::make_unique<ir::IRFunction>("copy", IRBool, std::vector<ir::TypeInfo>{IRPtr, IRPtr});
+    function->addParameter("a", IRPtr);
+    function->addParameter("b", IRPtr);
+    ir::IRBuilder builder(*function);
+    builder.setInsertPoint(builder.createBlock("entry"));
+    ir::ValueId a = function->parameter(0), b = function->parameter(1);
+    builder.createMemCpy(a, b, builder.getInt(64, IRSize));
+    builder.createMemSet(b, builder.getInt(0, IRInt), builder.getInt(20, IRSize));
+    ir::ValueId equal = builder.createMemCmp(a, b, builder.getInt(16, IRSize), IRInt);
+    builder.createReturn(builder.createBinary(ir::IROpcode::CmpEQ, equal, builder.getInt(0, IRInt), IRBool));
+
+    backend::abi::ABIContract abi;
+    backend::FunctionCode code = backend::CodeGenerator(abi).generateFunction(*function);
+    ASSERT_FALSE(code.code.empty()) << code.encodingError;
+
+    // MOVDQU (F3, REX opcional, 0F 6F/7F), PCMPEQB (66, REX opcional, 0F 74) y ninguna llamada
+    auto count = [&](uint8_t prefix, uint8_t opcode) {
+        size_t found = 0;
+        for (size_t i = 2; i + 1 < code.code.size(); ++i) {
+            if (code.code[i] != 0x0F || code.code[i + 1] != opcode) continue;
+            found += code.code[i - 1] == prefix || (code.code[i - 2] == prefix && (code.code[i - 1] & 0xF0) == 0x40);
+        }
+        return found;
+    };
+    EXPECT_EQ(count(0xF3, 0x6F), 6u);       // Cuatro de la copia y los dos lados de la comparación
+    EXPECT_GE(count(0xF3, 0x7F), 6u);       // Cuatro de la copia y dos solapados del memset
+    EXPECT_EQ(count(0x66, 0x74), 1u);
+    EXPECT_TRUE(code.relocations.empty());
+}
+
+TEST_F(COFFWriterTest, BitIntrinsicsUseTheirInstructionOnlyWithTheExtension) {
+    const ir::TypeInfo IRLong(ir::IRType::LongLong, 8, 8, "i64");
+    auto function = std::make_unique<ir::IRFunction>("bits", IRLong, std::vector<ir::TypeInfo>{IRLong, IRLong});
+    function->addParameter("x", IRLong);
+    function->addParameter("m", IRLong);
+    ir::IRBuilder builder(*function);
+    builder.setInsertPoint(builder.createBlock("entry"));
+    ir::ValueId x = function->parameter(0), m = function->parameter(1);
+    ir::ValueId sum = builder.createUnary(ir::IROpcode::PopCount, x, IRLong);
+    sum = builder.createBinary(ir::IROpcode::Add, sum, builder.createUnary(ir::IROpcode::CountTrailingZeros, x, IRLong),
+                               IRLong);
+    sum = builder.createBinary(ir::IROpcode::Add, sum, builder.createBinary(ir::IROpcode::BitExtract, x, m, IRLong),
+                               IRLong);
+    sum = builder.createBinary(ir::IROpcode::Add, sum, builder.createBinary(ir::IROpcode::Crc32, sum, x, IRLong),
+                               IRLong);
+    builder.createReturn(sum);
+
+    // Opcode de dos bytes detrás de un prefijo obligatorio, con o sin REX entre ambos
+    auto prefixed = [](const std::vector<uint8_t>& code, uint8_t prefix, std::vector<uint8_t> opcode) {
+        for (size_t i = 2; i + opcode.size() <= code.size(); ++i) {
+            if (!std::equal(opcode.begin(), opcode.end(), code.begin() + i)) continue;
+            if (code[i - 1] == prefix || (code[i - 2] == prefix && (code[i - 1] & 0xF0) == 0x40)) return true;
+        }
+        return false;
+    };
+
+    backend::abi::ABIContract abi;
+    CPUFeatures features;
+    features.popcnt = features.bmi1 = features.bmi2 = features.sse42 = true;
+    backend::FunctionCode code = backend::CodeGenerator(abi, features).generateFunction(*function);
+    ASSERT_FALSE(code.code.empty()) << code.encodingError;
+    EXPECT_TRUE(prefixed(code.code, 0xF3, {0x0F, 0xB8}));          // POPCNT
+    EXPECT_TRUE(prefixed(code.code, 0xF3, {0x0F, 0xBC}));          // TZCNT
+    EXPECT_TRUE(prefixed(code.code, 0xF2, {0x0F, 0x38, 0xF1}));    // CRC32
+    EXPECT_NE(std::find(code.code.begin(), code.code.end(), 0xF5), code.code.end());   // PEXT
+
+    // Sin las extensiones: SWAR, BSF y bucles, sin ninguna de esas instrucciones
+    code = backend::CodeGenerator(abi).generateFunction(*function);
+    ASSERT_FALSE(code.code.empty()) << code.encodingError;
+    EXPECT_FALSE(prefixed(code.code, 0xF3, {0x0F, 0xB8}));
+    EXPECT_FALSE(prefixed(code.code, 0xF3, {0x0F, 0xBC}));
+    EXPECT_FALSE(prefixed(code.code, 0xF2, {0x0F, 0x38, 0xF1}));
+    const uint8_t bsf[] = {0x0F, 0xBC};
+    EXPECT_NE(std::search(code.code.begin(), code.code.end(), std::begin(bsf), std::end(bsf)), code.code.end());
+}
+
+TEST_F(COFFWriterTest, TargetClonesResolverReadsCPUIDAndRunsFromCRTInitializers) {
+    const ir::TypeInfo IRFunctionType(ir::IRType::Function, 8, 8, "fn");
+    ir::IRModule module("m");
+    auto work = std::make_unique<ir::IRFunction>("work", IRInt, std::vector<ir::TypeInfo>());
+    work->addParameter("x", IRInt);
+    work->setTargetClones({"avx2", "default"});
+    ir::IRBuilder builder(*work);
+    builder.setInsertPoint(builder.createBlock("entry"));
+    builder.createReturn(work->parameter(0));
+    module.addFunction(std::move(work));
+    ASSERT_TRUE(ir::MultiversioningPass().run(module));
+
+    backend::abi::ABIContract abi;
+    backend::CodeGenerator generator(abi);
+    auto relocated = [](const backend::FunctionCode& code, const std::string& symbol) {
+        return std::count_if(code.relocations.begin(), code.relocations.end(), [&](const auto& relocation) {
+            return relocation.symbol == symbol && relocation.type == IMAGE_REL_AMD64_REL32;
+        });
+    };
+    auto contains = [](const std::vector<uint8_t>& code, std::vector<uint8_t> bytes) {
+        return std::search(code.begin(), code.end(), bytes.begin(), bytes.end()) != code.end();
+    };
+
+    // CPUID y XGETBV; la copia elegida se guarda con LEA y MOV relativos a RIP
+    backend::FunctionCode resolver;
+    backend::FunctionCode thunk;
+    for (const auto& function : module.getFunctions()) {
+        if (function->getName() == "work.resolver") resolver = generator.generateFunction(*function);
+        if (function->getName() == "work") thunk = generator.generateFunction(*function);
+    }
+    ASSERT_FALSE(resolver.code.empty()) << resolver.encodingError;
+    EXPECT_TRUE(contains(resolver.code, {0x0F, 0xA2}));
+    EXPECT_TRUE(contains(resolver.code, {0x0F, 0x01, 0xD0}));
+    EXPECT_EQ(relocated(resolver, "work.avx2"), 1);
+    EXPECT_EQ(relocated(resolver, "work.default"), 1);
+    EXPECT_EQ(relocated(resolver, "work.ptr"), 2);
+
+    // El original carga el puntero y salta sin volver a mirar la CPU
+    ASSERT_FALSE(thunk.code.empty()) << thunk.encodingError;
+    EXPECT_EQ(relocated(thunk, "work.ptr"), 1);
+    EXPECT_FALSE(contains(thunk.code, {0x0F, 0xA2}));
+
+    // El resolvedor va en .CRT$XCC, delante de los constructores de .CRT$XCU
+    COFFObject object = createBasicCOFFObject();
+    appendVariables(object, {{"work.ptr", std::vector<uint8_t>(8, 0), 8}});
+    appendFunctions(object, {backend::CodeGenerator::toCOFFFunction(resolver)});
+    appendInitializers(object, module.getInitializers());
+    auto section = std::find_if(object.sections.begin(), object.sections.end(),
+                                [](const COFFSection& s) { return s.name == ".CRT$XCC"; });
+    ASSERT_NE(section, object.sections.end());
+    ASSERT_EQ(section->data.size(), 8u);
+    ASSERT_EQ(section->relocations.size(), 1u);
+    EXPECT_EQ(section->relocations[0].Type, IMAGE_REL_AMD64_ADDR64);
+    EXPECT_EQ(object.symbols[section->relocations[0].SymbolTableIndex].name, "work.resolver");
+    auto data = std::find_if(object.sections.begin(), object.sections.end(),
+                             [](const COFFSection& s) { return s.name == ".data"; });
+    ASSERT_NE(data, object.sections.end());
+    EXPECT_TRUE(data->characteristics & IMAGE_SCN_MEM_WRITE);
+    std::vector<uint8_t> bytes;
+    EXPECT_TRUE(COFFWriter().writeObject(object, bytes));
+}
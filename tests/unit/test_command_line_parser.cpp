@@ -0,0 +1,136 @@
+/**
+ * @file test_command_line_parser.cpp
+ * @brief Tests para CommandLineParser: tablas de opciones, archivos de respuesta y caché
+ */
+
+#include <compiler/driver/CommandLineParser.h>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace cpp20::compiler;
+
+namespace {
+
+bool parseArgs(std::vector<std::string> args, CompilerOptions& options, ParsedOptionsCache* cache = nullptr) {
+    args.insert(args.begin(), "cpp20-compiler");
+    std::vector<char*> argv;
+    for (auto& arg : args) argv.push_back(arg.data());
+    CommandLineParser parser;
+    parser.setCache(cache);
+    return parser.parse(static_cast<int>(argv.size()), argv.data(), options);
+}
+
+std::filesystem::path writeResponseFile(const std::string& name, const std::string& content) {
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::ofstream out(path, std::ios::binary);
+    out << content;
+    return path;
+}
+
+} // namespace
+
+TEST(CommandLineParserTest, OptionFormsAndDeduplication) {
+    CompilerOptions options;
+    ASSERT_TRUE(parseArgs({"-c", "-O2", "-Werror", "-Wno-unused", "-Iinc", "-I", "inc", "-I=other",
+                           "-DX=1", "-D", "X=1", "-DY", "-o", "out.obj", "-j3", "-std=c++17", "main.cpp"},
+                          options));
+    EXPECT_TRUE(options.compileOnly);
+    EXPECT_EQ(options.optimizationLevel, 2);
+    EXPECT_TRUE(options.warningsAsErrors);           // Flag, no el warning "error"
+    EXPECT_EQ(options.disabledWarnings, std::vector<std::string>{"unused"});
+    EXPECT_TRUE(options.enabledWarnings.empty());
+    EXPECT_EQ(options.includePaths, (std::vector<std::string>{"inc", "other"}));
+    EXPECT_EQ(options.defines, (std::vector<std::string>{"X=1", "Y"}));
+    EXPECT_EQ(options.outputFile, "out.obj");
+    EXPECT_EQ(options.jobs, 3u);
+    EXPECT_EQ(options.standard, "c++17");
+    EXPECT_EQ(options.inputFiles, std::vector<std::string>{"main.cpp"});
+
+    CompilerOptions bad;
+    EXPECT_FALSE(parseArgs({"-fno-such-option", "main.cpp"}, bad));
+}
+
+TEST(CommandLineParserTest, ResponseFilesAreTokenizedInPlace) {
+    std::string content = "-Ia # comentario -Ib\n\"-Iwith space\"\t-DZ\n";
+    auto args = CommandLineParser::tokenizeResponseFile(content);
+    ASSERT_EQ(args.size(), 3u);
+    EXPECT_EQ(args[0], "-Ia");
+    EXPECT_EQ(args[1], "-Iwith space");
+    EXPECT_EQ(args[2].data(), content.data() + content.find("-DZ"));     // Vista, sin copia
+
+    auto inner = writeResponseFile("test_clp_inner.rsp", "-Ia -DZ\n");
+    auto outer = writeResponseFile("test_clp_outer.rsp", "-c @" + inner.string() + " -Ia main.cpp\n");
+    CompilerOptions options;
+    ASSERT_TRUE(parseArgs({"@" + outer.string(), "@" + inner.string()}, options));
+    EXPECT_TRUE(options.compileOnly);                // El primer argumento del archivo no se pierde
+    EXPECT_EQ(options.includePaths, std::vector<std::string>{"a"});
+    EXPECT_EQ(options.defines, std::vector<std::string>{"Z"});
+
+    auto loop = writeResponseFile("test_clp_loop.rsp", "");
+    writeResponseFile("test_clp_loop.rsp", "main.cpp @" + loop.string() + "\n");
+    CompilerOptions recursive;
+    EXPECT_FALSE(parseArgs({"@" + loop.string()}, recursive));
+
+    std::filesystem::remove(inner);
+    std::filesystem::remove(outer);
+    std::filesystem::remove(loop);
+}
+
+TEST(CommandLineParserTest, CacheIsKeyedByArgumentsAndResponseFileContent) {
+    ParsedOptionsCache cache;
+    auto rsp = writeResponseFile("test_clp_cached.rsp", "-Ifirst main.cpp\n");
+    std::vector<std::string> args = {"-c", "@" + rsp.string()};
+
+    CompilerOptions first;
+    ASSERT_TRUE(parseArgs(args, first, &cache));
+    CompilerOptions second;
+    ASSERT_TRUE(parseArgs(args, second, &cache));
+    EXPECT_EQ(cache.hitCount(), 1u);
+    EXPECT_EQ(second.includePaths, std::vector<std::string>{"first"});
+
+    writeResponseFile("test_clp_cached.rsp", "-Isecond main.cpp\n");
+    CompilerOptions third;
+    ASSERT_TRUE(parseArgs(args, third, &cache));
+    EXPECT_EQ(cache.hitCount(), 1u);                 // Cambió el contenido: se vuelve a parsear
+    EXPECT_EQ(third.includePaths, std::vector<std::string>{"second"});
+
+    std::filesystem::remove(rsp);
+}
+
+TEST(CommandLineParserTest, LastDebugLevelWins) {
+    CompilerOptions lines;
+    ASSERT_TRUE(parseArgs({"-g", "-gline-tables-only", "main.cpp"}, lines));
+    EXPECT_TRUE(lines.debugInfo);
+    EXPECT_TRUE(lines.lineTablesOnly);
+
+    CompilerOptions full;
+    ASSERT_TRUE(parseArgs({"-g1", "-g", "main.cpp"}, full));
+    EXPECT_TRUE(full.debugInfo);
+    EXPECT_FALSE(full.lineTablesOnly);
+}
+
+TEST(CommandLineParserTest, ArenaBackingOptions) {
+    CompilerOptions options;
+    ASSERT_TRUE(parseArgs({"-farena-reserve=512", "-farena-large-pages", "main.cpp"}, options));
+    EXPECT_EQ(options.arenaReserveMB, 512u);
+    EXPECT_TRUE(options.arenaLargePages);
+
+    CompilerOptions invalid;
+    EXPECT_FALSE(parseArgs({"-farena-reserve=1G", "main.cpp"}, invalid));
+    EXPECT_FALSE(parseArgs({"-farena-reserve=99999999999999999999", "main.cpp"}, invalid));
+    EXPECT_FALSE(parseArgs({"-farena-reserve=18446744073709551615", "main.cpp"}, invalid));
+}
+
+TEST(CommandLineParserTest, JobCountOutOfRangeIsAnInvalidValue) {
+    CompilerOptions options;
+    EXPECT_FALSE(parseArgs({"-j99999999999999999999", "main.cpp"}, options));
+    EXPECT_FALSE(parseArgs({"-j=-1", "main.cpp"}, options));
+    EXPECT_FALSE(parseArgs({"-j", "+4", "main.cpp"}, options));
+
+    CompilerOptions all;
+    ASSERT_TRUE(parseArgs({"-j0", "main.cpp"}, all));
+    EXPECT_GE(all.jobs, 1u);
+}
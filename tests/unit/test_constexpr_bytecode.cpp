@@ -0,0 +1,397 @@
+/**
+ * @file test_constexpr_bytecode.cpp
+ * @brief Tests para el bytecode y el intérprete del VM constexpr
+ */
+
+#include <compiler/constexpr/ConstexprBytecode.h>
+#include <compiler/constexpr/ConstexprEvaluator.h>
+#include <compiler/constexpr/ConstexprJIT.h>
+#include <compiler/ast/ASTContext.h>
+#include <compiler/common/TimingProfiler.h>
+#include <compiler/common/diagnostics/SourceManager.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace cpp20::compiler;
+using namespace cpp20::compiler::constexpr_eval;
+using ast::ASTNode;
+
+namespace {
+
+/**
+ * @brief Construye ASTs pequeños sin pasar por el parser
+ */
+class ConstexprBytecodeTest : public ::testing::Test {
+protected:
+    ast::ASTContext context_;
+    std::shared_ptr<diagnostics::SourceManager> sourceManager_ =
+        std::make_shared<diagnostics::SourceManager>();
+    diagnostics::DiagnosticEngine diagEngine_{sourceManager_};
+    diagnostics::SourceLocation loc_;
+
+    ASTNode* integer(int64_t value) {
+        return context_.create<ast::IntegerLiteral>(value, loc_);
+    }
+    ASTNode* name(std::string_view text) {
+        return context_.create<ast::Identifier>(context_.copyString(text), loc_);
+    }
+    ASTNode* binary(ASTNode* left, ast::BinaryOp::OpKind op, ASTNode* right) {
+        return context_.create<ast::BinaryOp>(left, right, op, loc_);
+    }
+    ASTNode* assign(std::string_view target, ast::Assignment::OpKind op, ASTNode* value) {
+        return context_.create<ast::ExprStmt>(context_.create<ast::Assignment>(name(target), value, op, loc_), loc_);
+    }
+    ASTNode* call(std::string_view callee, std::vector<ASTNode*> arguments) {
+        return context_.create<ast::FunctionCall>(name(callee), context_.makeList(arguments), loc_);
+    }
+    ASTNode* variable(std::string_view varName, ASTNode* init, std::string_view type = "int") {
+        return context_.create<ast::VariableDecl>(context_.copyString(varName), type, init, loc_);
+    }
+    ASTNode* ret(ASTNode* value) {
+        return context_.create<ast::ReturnStmt>(value, loc_);
+    }
+    ast::CompoundStmt* block(std::vector<ASTNode*> statements) {
+        return context_.create<ast::CompoundStmt>(context_.makeList(statements), loc_);
+    }
+    ast::FunctionDecl* function(std::string_view fnName, std::vector<std::string_view> parameters,
+                                ast::CompoundStmt* body) {
+        std::vector<ast::ParameterDecl*> decls;
+        for (std::string_view parameter : parameters) {
+            decls.push_back(context_.create<ast::ParameterDecl>(context_.copyString(parameter), "int", loc_));
+        }
+        return context_.create<ast::FunctionDecl>(context_.copyString(fnName), "int",
+                                                  context_.makeList(decls), body, loc_);
+    }
+
+    // int fib(int n) { if (n < 2) return n; return fib(n - 1) + fib(n - 2); }
+    ast::FunctionDecl* fibonacci() {
+        using Op = ast::BinaryOp::OpKind;
+        return function("fib", {"n"}, block({
+            context_.create<ast::IfStmt>(binary(name("n"), Op::Less, integer(2)), ret(name("n")), nullptr, loc_),
+            ret(binary(call("fib", {binary(name("n"), Op::Subtract, integer(1))}), Op::Add,
+                       call("fib", {binary(name("n"), Op::Subtract, integer(2))}))),
+        }));
+    }
+};
+
+} // namespace
+
+TEST_F(ConstexprBytecodeTest, CompilesFunctionToRegisters) {
+    BytecodeCompiler compiler([](std::string_view name) -> std::optional<uint32_t> {
+        return name == "fib" ? std::optional<uint32_t>(0) : std::nullopt;
+    });
+
+    std::string error;
+    auto code = compiler.compileFunction(fibonacci(), error);
+    ASSERT_NE(code, nullptr) << error;
+    EXPECT_EQ(code->parameterCount, 1u);
+    EXPECT_GE(code->registerCount, code->parameterCount);
+    ASSERT_FALSE(code->code.empty());
+    EXPECT_EQ(code->code.back().op, OpCode::ReturnVoid);
+}
+
+TEST_F(ConstexprBytecodeTest, RejectsUnknownNames) {
+    BytecodeCompiler compiler([](std::string_view) { return std::optional<uint32_t>(); });
+
+    std::string error;
+    EXPECT_EQ(compiler.compileStandalone(name("x"), {}, error), nullptr);
+    EXPECT_NE(error.find("x"), std::string::npos);
+
+    error.clear();
+    EXPECT_EQ(compiler.compileStandalone(call("g", {}), {}, error), nullptr);
+    EXPECT_NE(error.find("g"), std::string::npos);
+}
+
+TEST_F(ConstexprBytecodeTest, EvaluatesRecursiveFunction) {
+    ConstexprEvaluator evaluator(diagEngine_);
+    evaluator.registerConstexprFunction("fib", fibonacci());
+
+    auto result = evaluator.evaluateFunction("fib", {ConstexprValue(20)}, nullptr);
+    ASSERT_EQ(result.result, EvaluationResult::Success) << result.errorMessage;
+    EXPECT_EQ(result.value.asInteger(), 6765);
+    EXPECT_GT(result.stepsExecuted, 0u);
+}
+
+TEST_F(ConstexprBytecodeTest, EvaluatesLoopsAndLocals) {
+    using Op = ast::BinaryOp::OpKind;
+    using Assign = ast::Assignment::OpKind;
+
+    // int sum(int n) { int s = 0; for (int i = 1; i <= n; i += 1) s += i * i; return s; }
+    auto* sum = function("sum", {"n"}, block({
+        variable("s", integer(0)),
+        context_.create<ast::ForStmt>(variable("i", integer(1)),
+                                      binary(name("i"), Op::LessEqual, name("n")),
+                                      context_.create<ast::Assignment>(name("i"), integer(1), Assign::AddAssign, loc_),
+                                      assign("s", Assign::AddAssign, binary(name("i"), Op::Multiply, name("i"))),
+                                      loc_),
+        ret(name("s")),
+    }));
+
+    ConstexprEvaluator evaluator(diagEngine_);
+    auto result = evaluator.evaluateFunction("sum", {ConstexprValue(10)}, sum);
+    ASSERT_EQ(result.result, EvaluationResult::Success) << result.errorMessage;
+    EXPECT_EQ(result.value.asInteger(), 385);
+}
+
+TEST_F(ConstexprBytecodeTest, EvaluatesExpressionWithParameters) {
+    using Op = ast::BinaryOp::OpKind;
+
+    ConstexprVM vm(diagEngine_);
+    auto* expression = context_.create<ast::TernaryOp>(
+        binary(name("a"), Op::Greater, name("b")),
+        binary(name("a"), Op::Subtract, name("b")),
+        binary(name("b"), Op::Subtract, name("a")), loc_);
+
+    auto result = vm.evaluate(expression, {{"a", ConstexprValue(3)}, {"b", ConstexprValue(10)}});
+    ASSERT_EQ(result.result, EvaluationResult::Success) << result.errorMessage;
+    EXPECT_EQ(result.value.asInteger(), 7);
+}
+
+TEST_F(ConstexprBytecodeTest, ReportsUndefinedBehaviour) {
+    using Op = ast::BinaryOp::OpKind;
+    ConstexprVM vm(diagEngine_);
+
+    auto division = vm.evaluate(binary(integer(1), Op::Divide, integer(0)));
+    EXPECT_EQ(division.result, EvaluationResult::Error);
+
+    auto overflow = vm.evaluate(binary(integer(2147483647), Op::Add, integer(1)));
+    EXPECT_EQ(overflow.result, EvaluationResult::Error);
+
+    // Asignar a una constante no compila
+    auto* body = block({variable("k", integer(1), "const int"),
+                        assign("k", ast::Assignment::OpKind::Assign, integer(2)),
+                        ret(name("k"))});
+    std::string error;
+    EXPECT_FALSE(vm.isValidConstexpr(body, error));
+}
+
+TEST_F(ConstexprBytecodeTest, EnforcesLimits) {
+    using Op = ast::BinaryOp::OpKind;
+
+    // int loop(int n) { while (true) n = n; }
+    auto* loop = function("loop", {"n"}, block({
+        context_.create<ast::WhileStmt>(context_.create<ast::BooleanLiteral>(true, loc_),
+                                        assign("n", ast::Assignment::OpKind::Assign, name("n")), loc_),
+    }));
+    // int deep(int n) { return deep(n + 1); }
+    auto* deep = function("deep", {"n"}, block({ret(call("deep", {binary(name("n"), Op::Add, integer(1))}))}));
+
+    ConstexprVM vm(diagEngine_);
+    vm.setLimits(1000, 50);
+    vm.registerFunction("loop", loop);
+    vm.registerFunction("deep", deep);
+
+    EXPECT_EQ(vm.call("loop", {ConstexprValue(0)}).result, EvaluationResult::Timeout);
+    EXPECT_EQ(vm.call("deep", {ConstexprValue(0)}).result, EvaluationResult::RecursionLimit);
+}
+
+TEST(EvaluationScopeTest, ResolvesNamesToSlots) {
+    EvaluationScope scope;
+    scope.pushScope();
+    scope.declareVariable("a", ConstexprValue(1), false);
+    scope.declareVariable("b", ConstexprValue(2));
+
+    scope.pushScope();
+    scope.declareVariable("a", ConstexprValue(10), false);
+
+    auto inner = scope.resolve("a");
+    auto outer = scope.resolve("b");
+    ASSERT_TRUE(inner && outer);
+    EXPECT_EQ(inner->depth, 0u);
+    EXPECT_EQ(outer->depth, 1u);
+    EXPECT_EQ(outer->index, 1u);
+    EXPECT_EQ(scope.at(*inner).asInteger(), 10);
+
+    scope.at(*inner) = ConstexprValue(11);
+    EXPECT_EQ(scope.getVariable("a")->asInteger(), 11);
+    EXPECT_FALSE(scope.updateVariable("b", ConstexprValue(3)));
+
+    // Cerrar el scope interno vuelve a exponer la variable exterior
+    scope.popScope();
+    EXPECT_EQ(scope.getVariable("a")->asInteger(), 1);
+    EXPECT_TRUE(scope.updateVariable("a", ConstexprValue(5)));
+    EXPECT_EQ(scope.frame()[0].asInteger(), 5);
+    EXPECT_EQ(scope.size(), 2u);
+}
+
+TEST(ConstexprValueTest, ScalarsAndHandlesStayInline) {
+    static_assert(sizeof(ConstexprValue) <= 16);
+
+    ConstexprValue text("abc");
+    ConstexprValue copy = text;
+    EXPECT_TRUE(copy.isString());
+    EXPECT_EQ(copy.asString(), "abc");
+    // Las cadenas iguales comparten la copia interna
+    EXPECT_EQ(&ConstexprValue(std::string("abc")).asString(), &text.asString());
+
+    auto pointer = ConstexprValue::pointer(42);
+    EXPECT_TRUE(pointer.isPointer());
+    EXPECT_EQ(pointer.asHandle(), 42u);
+    EXPECT_EQ(ConstexprValue(7).asHandle(), 0u);
+    EXPECT_TRUE(ConstexprValue::null().isNullptr());
+    EXPECT_EQ(ConstexprValue(3.5).asInteger(), 0);
+}
+
+TEST_F(ConstexprBytecodeTest, MemoizesPureCalls) {
+    ConstexprVM vm(diagEngine_);
+    vm.registerFunction("fib", fibonacci());
+
+    // Sin memoización fib(40) necesita cientos de millones de pasos
+    vm.setLimits(100000);
+    auto result = vm.call("fib", {ConstexprValue(40)});
+    ASSERT_EQ(result.result, EvaluationResult::Success) << result.errorMessage;
+    EXPECT_EQ(result.value.asInteger(), 102334155);
+    EXPECT_GT(vm.getStats().memoHits, 0u);
+    EXPECT_GE(vm.getStats().memoEntries, 41u);
+
+    // La memoización sobrevive entre evaluaciones
+    auto again = vm.call("fib", {ConstexprValue(30)});
+    EXPECT_EQ(again.value.asInteger(), 832040);
+    EXPECT_EQ(again.stepsExecuted, 0u);
+}
+
+TEST_F(ConstexprBytecodeTest, HotLeafFunctionsRunNatively) {
+    if (!ConstexprJIT::isSupported()) {
+        GTEST_SKIP() << "El nivel nativo necesita un anfitrión x86-64";
+    }
+    using Op = ast::BinaryOp::OpKind;
+    using Assign = ast::Assignment::OpKind;
+
+    // int mix(int a, int b) { if (a < b) return a * b - 3; return (a - b) * 2 + ((a ^ b) >> 1); }
+    auto* mix = function("mix", {"a", "b"}, block({
+        context_.create<ast::IfStmt>(binary(name("a"), Op::Less, name("b")),
+                                     ret(binary(binary(name("a"), Op::Multiply, name("b")), Op::Subtract, integer(3))),
+                                     nullptr, loc_),
+        ret(binary(binary(binary(name("a"), Op::Subtract, name("b")), Op::Multiply, integer(2)), Op::Add,
+                   binary(binary(name("a"), Op::BitwiseXor, name("b")), Op::RightShift, integer(1)))),
+    }));
+    // int sweep(int n) { int s = 0; for (int i = -n; i <= n; i += 1) s += mix(i, 7); return s; }
+    auto* sweep = function("sweep", {"n"}, block({
+        variable("s", integer(0)),
+        context_.create<ast::ForStmt>(variable("i", context_.create<ast::UnaryOp>(name("n"), ast::UnaryOp::OpKind::Minus,
+                                                                                 loc_)),
+                                      binary(name("i"), Op::LessEqual, name("n")),
+                                      context_.create<ast::Assignment>(name("i"), integer(1), Assign::AddAssign, loc_),
+                                      assign("s", Assign::AddAssign, call("mix", {name("i"), integer(7)})),
+                                      loc_),
+        ret(name("s")),
+    }));
+
+    ConstexprVM interpreted(diagEngine_);
+    interpreted.setJitThreshold(0);
+    ConstexprVM vm(diagEngine_);
+    vm.setJitThreshold(10);
+    for (ConstexprVM* machine : {&interpreted, &vm}) {
+        machine->registerFunction("mix", mix);
+        machine->registerFunction("sweep", sweep);
+        machine->registerFunction("fib", fibonacci());
+    }
+
+    auto expected = interpreted.call("sweep", {ConstexprValue(200)});
+    auto result = vm.call("sweep", {ConstexprValue(200)});
+    ASSERT_EQ(result.result, EvaluationResult::Success) << result.errorMessage;
+    EXPECT_EQ(result.value.asInteger(), expected.value.asInteger());
+    EXPECT_EQ(vm.getStats().nativeCompilations, 1u);
+    EXPECT_EQ(vm.getStats().nativeCalls, 401u - 9u);     // La décima ya es nativa
+    EXPECT_EQ(interpreted.getStats().nativeCalls, 0u);
+
+    // El desbordamiento abandona el código nativo y el intérprete da el error
+    auto overflow = vm.call("mix", {ConstexprValue(100000), ConstexprValue(200000)});
+    EXPECT_EQ(overflow.result, EvaluationResult::Error);
+    EXPECT_EQ(vm.getStats().nativeBailouts, 1u);
+
+    // Las funciones con llamadas siguen en el intérprete
+    for (int n = 0; n < 20; ++n) {
+        EXPECT_EQ(vm.call("fib", {ConstexprValue(n)}).value.asInteger(),
+                  interpreted.call("fib", {ConstexprValue(n)}).value.asInteger());
+    }
+    EXPECT_EQ(vm.getStats().nativeCompilations, 1u);
+}
+
+TEST_F(ConstexprBytecodeTest, IndependentInitializersEvaluateInParallelWaves) {
+    using Op = ast::BinaryOp::OpKind;
+    ConstexprEvaluator evaluator(diagEngine_);
+    evaluator.registerConstexprFunction("fib", fibonacci());
+
+    // constexpr int a = fib(20), b = fib(15), c = a + b, bad = b / 0, d = bad + 1;
+    // static_assert(c > a); static_assert(b > c);
+    std::vector<ConstexprInitializer> initializers = {
+        {"a", call("fib", {integer(20)})},
+        {"b", call("fib", {integer(15)})},
+        {"c", binary(name("a"), Op::Add, name("b"))},
+        {"", binary(name("c"), Op::Greater, name("a")), true},
+        {"bad", binary(name("b"), Op::Divide, integer(0))},
+        {"d", binary(name("bad"), Op::Add, integer(1))},
+        {"", binary(name("b"), Op::Greater, name("c")), true},
+    };
+    auto results = evaluator.evaluateInitializers(initializers, 4);
+
+    ASSERT_EQ(results.size(), initializers.size());
+    EXPECT_EQ(results[0].value.asInteger(), 6765);
+    EXPECT_EQ(results[1].value.asInteger(), 610);
+    EXPECT_EQ(results[2].value.asInteger(), 7375);
+    EXPECT_EQ(results[3].result, EvaluationResult::Success);
+    EXPECT_NE(results[4].result, EvaluationResult::Success);
+    EXPECT_EQ(results[5].result, EvaluationResult::NotConstexpr);
+    EXPECT_EQ(results[6].result, EvaluationResult::Error);
+    // {a, b, bad}, {c, d}, {los dos static_assert}
+    EXPECT_EQ(evaluator.getStats().initializerWaves, 3u);
+    EXPECT_EQ(evaluator.getStats().expressionsEvaluated, 7u);
+
+    // En un hilo el resultado es el mismo
+    ConstexprEvaluator sequential(diagEngine_);
+    sequential.registerConstexprFunction("fib", fibonacci());
+    auto expected = sequential.evaluateInitializers(initializers, 1);
+    for (size_t i = 0; i < results.size(); ++i) {
+        EXPECT_EQ(expected[i].result, results[i].result) << i;
+        EXPECT_TRUE(expected[i].value.identical(results[i].value)) << i;
+    }
+}
+
+TEST_F(ConstexprBytecodeTest, AttributesCallsToActiveProfiler) {
+    TimingProfiler profiler;
+    profiler.setEntityTracking(true);
+    TimingProfiler::setActive(&profiler);
+
+    ConstexprVM vm(diagEngine_);
+    vm.registerFunction("fib", fibonacci());
+    auto result = vm.call("fib", {ConstexprValue(20)});
+    TimingProfiler::setActive(nullptr);
+    ASSERT_EQ(result.result, EvaluationResult::Success) << result.errorMessage;
+
+    // Una entrada por llamada ejecutada; las memoizadas no cuestan nada
+    auto entities = profiler.getTopEntities(CompilationPhase::ConstexprEvaluation, 10);
+    ASSERT_EQ(entities.size(), 1u);
+    EXPECT_EQ(entities[0].name, "fib");
+    EXPECT_EQ(entities[0].count, vm.getStats().memoEntries);
+    EXPECT_LE(entities[0].selfTime, entities[0].totalTime);
+}
+
+TEST(AbstractMemoryTest, HandlesDetectStaleAccessAndBulkFree) {
+    AbstractMemory memory;
+    size_t a = memory.allocate("int[4]", 16);
+    size_t b = memory.allocate("char[100]", 100);
+    ASSERT_NE(a, 0u);
+    ASSERT_NE(memory.getObject(a), nullptr);
+    EXPECT_EQ(memory.getObject(a)->type, "int[4]");
+    EXPECT_EQ(memory.getTotalAllocated(), 116u);
+
+    // Tras liberar, el handle antiguo ya no resuelve aunque el hueco se reutilice
+    EXPECT_TRUE(memory.deallocate(a));
+    EXPECT_FALSE(memory.deallocate(a));
+    size_t c = memory.allocate("int", 4);
+    EXPECT_NE(c, a);
+    EXPECT_EQ(memory.getObject(a), nullptr);
+
+    auto live = memory.liveObjects();
+    ASSERT_EQ(live.size(), 2u);
+    EXPECT_EQ(memory.getLiveObjectCount(), 2u);
+
+    memory.clear();
+    EXPECT_EQ(memory.getObject(b), nullptr);
+    EXPECT_EQ(memory.getObject(c), nullptr);
+    EXPECT_EQ(memory.getTotalAllocated(), 0u);
+    EXPECT_TRUE(memory.liveObjects().empty());
+}
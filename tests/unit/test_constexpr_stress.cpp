@@ -3,503 +3,328 @@
  * @brief Tests de stress para el sistema constexpr
  */
 
-#include <gtest/gtest.h>
 #include <compiler/constexpr/ConstexprEvaluator.h>
 #include <compiler/templates/TemplateSystem.h>
-#include <compiler/common/diagnostics/DiagnosticEngine.h>
-#include <thread>
+#include <compiler/ast/ASTContext.h>
+#include <compiler/ast/ExpressionAST.h>
+#include <compiler/ast/StatementAST.h>
+#include <compiler/ast/DeclarationAST.h>
+#include <compiler/common/diagnostics/SourceManager.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
 #include <vector>
-#include <random>
 
+using namespace cpp20::compiler;
 using namespace cpp20::compiler::constexpr_eval;
 using namespace cpp20::compiler::semantic;
-using namespace cpp20::compiler::diagnostics;
-
-// Test para carga máxima de memoria
-TEST(ConstexprStressTest, MaximumMemoryLoad) {
-    DiagnosticEngine diagEngine;
-    ConstexprEvaluator constexprEvaluator(diagEngine);
+using ast::ASTNode;
 
-    // Configurar límites de memoria altos
-    constexprEvaluator.setLimits(10000000, 1000, 50 * 1024 * 1024); // 50MB
+namespace {
 
-    std::vector<std::unique_ptr<ast::ASTNode>> expressions;
+// Presupuesto de tiempo de cada test de stress. Pasarlo es una regresión de
+// rendimiento: el test falla en lugar de alargar sin aviso el ciclo previo al merge.
+constexpr std::chrono::milliseconds kStressBudget{10000};
 
-    // Crear muchas expresiones que usen memoria
-    for (int i = 0; i < 100000; ++i) {
-        expressions.push_back(std::make_unique<ast::ASTNode>(ast::ASTNodeKind::IntegerLiteral));
+/**
+ * @brief Construye ASTs sin pasar por el parser y comprueba el presupuesto en TearDown()
+ */
+class ConstexprStressTest : public ::testing::Test {
+protected:
+    ast::ASTContext context_;
+    std::shared_ptr<diagnostics::SourceManager> sourceManager_ =
+        std::make_shared<diagnostics::SourceManager>();
+    diagnostics::DiagnosticEngine diagEngine_{sourceManager_};
+    diagnostics::SourceLocation loc_;
+    std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+
+    void TearDown() override {
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start_);
+        EXPECT_LE(duration, kStressBudget);
+        std::cout << ::testing::UnitTest::GetInstance()->current_test_info()->name() << ": "
+                  << duration.count() << "ms" << std::endl;
     }
 
-    auto startTime = std::chrono::high_resolution_clock::now();
-
-    // Evaluar todas las expresiones
-    for (auto& expr : expressions) {
-        auto result = constexprEvaluator.evaluateExpression(expr.get());
-        EXPECT_EQ(result.result, EvaluationResult::Success);
+    ASTNode* integer(int64_t value) {
+        return context_.create<ast::IntegerLiteral>(value, loc_);
     }
-
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-
-    auto stats = constexprEvaluator.getStats();
-    EXPECT_EQ(stats.expressionsEvaluated, 100000);
-
-    std::cout << "Memory stress test: " << stats.expressionsEvaluated
-              << " expressions in " << duration.count() << "ms" << std::endl;
-}
-
-// Test para alta frecuencia de evaluación
-TEST(ConstexprStressTest, HighFrequencyEvaluation) {
-    DiagnosticEngine diagEngine;
-    ConstexprEvaluator constexprEvaluator(diagEngine);
-
-    constexprEvaluator.setLimits(10000000, 1000, 10 * 1024 * 1024);
-
-    auto startTime = std::chrono::high_resolution_clock::now();
-
-    // Evaluar expresiones lo más rápido posible
-    int evaluated = 0;
-    auto timeout = startTime + std::chrono::seconds(5); // 5 segundos de stress
-
-    while (std::chrono::high_resolution_clock::now() < timeout) {
-        auto expression = std::make_unique<ast::ASTNode>(ast::ASTNodeKind::IntegerLiteral);
-        auto result = constexprEvaluator.evaluateExpression(expression.get());
-
-        if (result.result == EvaluationResult::Success) {
-            evaluated++;
-        } else {
-            break;
+    ASTNode* name(std::string_view text) {
+        return context_.create<ast::Identifier>(context_.copyString(text), loc_);
+    }
+    ASTNode* binary(ASTNode* left, ast::BinaryOp::OpKind op, ASTNode* right) {
+        return context_.create<ast::BinaryOp>(left, right, op, loc_);
+    }
+    ASTNode* call(std::string_view callee, std::vector<ASTNode*> arguments) {
+        return context_.create<ast::FunctionCall>(name(callee), context_.makeList(arguments), loc_);
+    }
+    ASTNode* variable(std::string_view varName, ASTNode* init) {
+        return context_.create<ast::VariableDecl>(context_.copyString(varName), "int", init, loc_);
+    }
+    ASTNode* ret(ASTNode* value) {
+        return context_.create<ast::ReturnStmt>(value, loc_);
+    }
+    ast::CompoundStmt* block(std::vector<ASTNode*> statements) {
+        return context_.create<ast::CompoundStmt>(context_.makeList(statements), loc_);
+    }
+    ast::FunctionDecl* function(std::string_view fnName, std::vector<std::string_view> parameters,
+                                ast::CompoundStmt* body) {
+        std::vector<ast::ParameterDecl*> decls;
+        for (std::string_view parameter : parameters) {
+            decls.push_back(context_.create<ast::ParameterDecl>(context_.copyString(parameter), "int", loc_));
         }
+        return context_.create<ast::FunctionDecl>(context_.copyString(fnName), "int",
+                                                  context_.makeList(decls), body, loc_);
     }
 
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-
-    auto stats = constexprEvaluator.getStats();
-    EXPECT_EQ(stats.expressionsEvaluated, evaluated);
-
-    double rate = static_cast<double>(evaluated) / (duration.count() / 1000.0);
-
-    std::cout << "High frequency stress: " << evaluated << " expressions in "
-              << duration.count() << "ms (" << rate << " expr/sec)" << std::endl;
-}
-
-// Test para stress de templates
-TEST(ConstexprStressTest, TemplateInstantiationStress) {
-    DiagnosticEngine diagEngine;
-    TemplateSystem templateSystem(diagEngine);
-    ConstexprEvaluator constexprEvaluator(diagEngine);
+    // int fib(int n) { if (n < 2) return n; return fib(n - 1) + fib(n - 2); }
+    ast::FunctionDecl* fibonacci() {
+        using Op = ast::BinaryOp::OpKind;
+        return function("fib", {"n"}, block({
+            context_.create<ast::IfStmt>(binary(name("n"), Op::Less, integer(2)), ret(name("n")), nullptr, loc_),
+            ret(binary(call("fib", {binary(name("n"), Op::Subtract, integer(1))}), Op::Add,
+                       call("fib", {binary(name("n"), Op::Subtract, integer(2))}))),
+        }));
+    }
 
-    // Crear muchos templates
-    for (int i = 0; i < 1000; ++i) {
-        auto templateInfo = std::make_unique<TemplateInfo>(
-            "stress_template_" + std::to_string(i),
-            std::make_unique<ast::TemplateParameterList>(std::vector<std::unique_ptr<ast::TemplateParameter>>{}),
-            std::make_unique<ast::ASTNode>(ast::ASTNodeKind::FunctionDecl)
-        );
+    // int down(int n) { if (n == 0) return 0; return down(n - 1) + 1; }
+    ast::FunctionDecl* countdown() {
+        using Op = ast::BinaryOp::OpKind;
+        return function("down", {"n"}, block({
+            context_.create<ast::IfStmt>(binary(name("n"), Op::Equal, integer(0)), ret(integer(0)), nullptr, loc_),
+            ret(binary(call("down", {binary(name("n"), Op::Subtract, integer(1))}), Op::Add, integer(1))),
+        }));
+    }
 
-        templateSystem.registerTemplate(std::move(templateInfo));
+    // template<typename T> name;
+    std::unique_ptr<TemplateInfo> unaryTemplate(const std::string& templateName) {
+        std::vector<ast::TemplateParameter*> parameters = {
+            context_.create<ast::TemplateParameter>(ast::TemplateParameterType::Type,
+                                                    context_.copyString("T"), nullptr, loc_),
+        };
+        auto* list = context_.create<ast::TemplateParameterList>(context_.makeList(parameters), loc_);
+        return std::make_unique<TemplateInfo>(templateName, list, nullptr);
     }
+};
 
-    auto startTime = std::chrono::high_resolution_clock::now();
+} // namespace
 
-    // Instanciar templates múltiples veces
-    for (int i = 0; i < 1000; ++i) {
-        for (int j = 0; j < 10; ++j) {
-            auto instance = templateSystem.instantiateTemplate(
-                "stress_template_" + std::to_string(i),
-                {"int"}
-            );
+// Muchas expresiones distintas: cada una se compila y se ejecuta una vez
+TEST_F(ConstexprStressTest, ManyDistinctExpressions) {
+    using Op = ast::BinaryOp::OpKind;
+    ConstexprEvaluator evaluator(diagEngine_);
+    evaluator.setLimits(10000000, 1000, 50 * 1024 * 1024);
 
-            ASSERT_TRUE(instance != nullptr);
-            EXPECT_TRUE(instance->isValid);
-        }
+    constexpr int count = 100000;
+    int correct = 0;
+    for (int i = 0; i < count; ++i) {
+        auto result = evaluator.evaluateExpression(binary(integer(i), Op::Multiply, integer(3)));
+        correct += result.result == EvaluationResult::Success && result.value.asInteger() == i * 3;
     }
 
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-
-    auto stats = templateSystem.getStats();
-    EXPECT_EQ(stats.templatesRegistered, 1000);
-    EXPECT_EQ(stats.instancesCreated, 1000); // Gracias al cache
-
-    std::cout << "Template stress: " << stats.templatesRegistered << " templates, "
-              << (1000 * 10) << " instantiations in " << duration.count() << "ms" << std::endl;
+    EXPECT_EQ(correct, count);
+    EXPECT_EQ(evaluator.getStats().expressionsEvaluated, static_cast<size_t>(count));
+    EXPECT_EQ(evaluator.getStats().errors, 0u);
 }
 
-// Test para stress de conceptos
-TEST(ConstexprStressTest, ConceptEvaluationStress) {
-    DiagnosticEngine diagEngine;
-    TemplateSystem templateSystem(diagEngine);
-
-    // Registrar conceptos
-    auto integralConcept = std::make_unique<TemplateInfo>(
-        "Integral",
-        std::make_unique<ast::TemplateParameterList>(std::vector<std::unique_ptr<ast::TemplateParameter>>{}),
-        std::make_unique<ast::ASTNode>(ast::ASTNodeKind::ConceptDefinition)
-    );
-
-    auto floatingConcept = std::make_unique<TemplateInfo>(
-        "FloatingPoint",
-        std::make_unique<ast::TemplateParameterList>(std::vector<std::unique_ptr<ast::TemplateParameter>>{}),
-        std::make_unique<ast::ASTNode>(ast::ASTNodeKind::ConceptDefinition)
-    );
-
-    templateSystem.registerConcept(std::move(integralConcept));
-    templateSystem.registerConcept(std::move(floatingConcept));
+// La misma expresión con parámetros distintos en cada evaluación
+TEST_F(ConstexprStressTest, ExpressionWithChangingContext) {
+    using Op = ast::BinaryOp::OpKind;
+    ConstexprEvaluator evaluator(diagEngine_);
+    ASTNode* expression = binary(binary(name("thread_id"), Op::Multiply, integer(1000)), Op::Add, name("iteration"));
 
-    std::vector<std::string> types = {"int", "long", "short", "char", "float", "double", "void"};
-    std::vector<std::string> concepts = {"Integral", "FloatingPoint"};
-
-    auto startTime = std::chrono::high_resolution_clock::now();
-
-    // Evaluar conceptos para muchos tipos
-    for (int i = 0; i < 10000; ++i) {
-        for (const auto& concept : concepts) {
-            for (const auto& type : types) {
-                auto result = templateSystem.checkConceptSatisfaction(concept, type);
-                // No importa el resultado, solo que no falle
-                EXPECT_TRUE(result.satisfaction == ConstraintSatisfaction::Satisfied ||
-                           result.satisfaction == ConstraintSatisfaction::NotSatisfied ||
-                           result.satisfaction == ConstraintSatisfaction::Error);
-            }
+    int correct = 0;
+    for (int thread = 0; thread < 10; ++thread) {
+        for (int i = 0; i < 1000; ++i) {
+            auto result = evaluator.evaluateExpression(
+                expression, {{"thread_id", ConstexprValue(thread)}, {"iteration", ConstexprValue(i)}});
+            correct += result.result == EvaluationResult::Success && result.value.asInteger() == thread * 1000 + i;
         }
     }
 
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-
-    auto stats = templateSystem.getStats();
-    EXPECT_EQ(stats.conceptsRegistered, 2);
-    EXPECT_EQ(stats.constraintChecks, 10000 * 2 * 7);
-
-    std::cout << "Concept stress: " << stats.constraintChecks
-              << " evaluations in " << duration.count() << "ms" << std::endl;
+    EXPECT_EQ(correct, 10 * 1000);
+    EXPECT_EQ(evaluator.getStats().expressionsEvaluated, 10u * 1000u);
 }
 
-// Test para stress de recursión
-TEST(ConstexprStressTest, RecursionDepthStress) {
-    DiagnosticEngine diagEngine;
-    ConstexprEvaluator constexprEvaluator(diagEngine);
-
-    // Configurar profundidad de recursión alta
-    constexprEvaluator.setLimits(10000000, 500, 10 * 1024 * 1024);
-
-    auto startTime = std::chrono::high_resolution_clock::now();
-
-    // Simular funciones recursivas profundas (usando llamadas anidadas)
-    for (int depth = 1; depth <= 50; ++depth) {
-        // Crear cadena de llamadas recursivas simuladas
-        for (int i = 0; i < 10; ++i) {
-            auto functionBody = std::make_unique<ast::ASTNode>(ast::ASTNodeKind::CompoundStmt);
-            std::vector<ConstexprValue> args = {ConstexprValue(depth)};
+// Recursión hasta cerca del límite; pasarlo da RecursionLimit, no un desbordamiento de pila
+TEST_F(ConstexprStressTest, DeepRecursion) {
+    ConstexprEvaluator evaluator(diagEngine_);
+    evaluator.setLimits(10000000, 500, 10 * 1024 * 1024);
+    evaluator.registerConstexprFunction("down", countdown());
 
-            auto result = constexprEvaluator.evaluateFunction(
-                "recursive_func_" + std::to_string(depth),
-                args, functionBody.get()
-            );
-
-            EXPECT_TRUE(result.result == EvaluationResult::Success ||
-                       result.result == EvaluationResult::RecursionLimit);
-        }
+    for (int depth = 1; depth <= 450; ++depth) {
+        auto result = evaluator.evaluateFunction("down", {ConstexprValue(depth)}, nullptr);
+        ASSERT_EQ(result.result, EvaluationResult::Success) << depth << ": " << result.errorMessage;
+        EXPECT_EQ(result.value.asInteger(), depth);
     }
+    EXPECT_EQ(evaluator.getStats().functionsEvaluated, 450u);
 
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-
-    auto stats = constexprEvaluator.getStats();
-    EXPECT_GE(stats.functionsEvaluated, 0);
-
-    std::cout << "Recursion stress: " << stats.functionsEvaluated
-              << " recursive calls in " << duration.count() << "ms" << std::endl;
+    ConstexprEvaluator limited(diagEngine_);
+    limited.setLimits(10000000, 500, 10 * 1024 * 1024);
+    limited.registerConstexprFunction("down", countdown());
+    EXPECT_EQ(limited.evaluateFunction("down", {ConstexprValue(600)}, nullptr).result,
+              EvaluationResult::RecursionLimit);
 }
 
-// Test para stress de memoria con templates complejos
-TEST(ConstexprStressTest, ComplexTemplateMemoryStress) {
-    DiagnosticEngine diagEngine;
-    TemplateSystem templateSystem(diagEngine);
-    ConstexprEvaluator constexprEvaluator(diagEngine);
-
-    constexprEvaluator.setLimits(10000000, 1000, 100 * 1024 * 1024); // 100MB
-
-    // Crear templates complejos con muchos parámetros
-    for (int i = 0; i < 100; ++i) {
-        auto templateInfo = std::make_unique<TemplateInfo>(
-            "complex_template_" + std::to_string(i),
-            std::make_unique<ast::TemplateParameterList>(std::vector<std::unique_ptr<ast::TemplateParameter>>{}),
-            std::make_unique<ast::ASTNode>(ast::ASTNodeKind::ClassDecl)
-        );
-
-        templateSystem.registerTemplate(std::move(templateInfo));
+// Bucles largos en el intérprete
+TEST_F(ConstexprStressTest, LongLoops) {
+    using Op = ast::BinaryOp::OpKind;
+    using Assign = ast::Assignment::OpKind;
+
+    // int sum(int n) { int s = 0; for (int i = 1; i <= n; i += 1) s += i * i; return s; }
+    auto* sum = function("sum", {"n"}, block({
+        variable("s", integer(0)),
+        context_.create<ast::ForStmt>(variable("i", integer(1)),
+                                      binary(name("i"), Op::LessEqual, name("n")),
+                                      context_.create<ast::Assignment>(name("i"), integer(1), Assign::AddAssign, loc_),
+                                      context_.create<ast::ExprStmt>(
+                                          context_.create<ast::Assignment>(
+                                              name("s"), binary(name("i"), Op::Multiply, name("i")),
+                                              Assign::AddAssign, loc_),
+                                          loc_),
+                                      loc_),
+        ret(name("s")),
+    }));
+
+    ConstexprEvaluator evaluator(diagEngine_);
+    evaluator.registerConstexprFunction("sum", sum);
+    for (int64_t n = 1000; n < 1100; ++n) {
+        auto result = evaluator.evaluateFunction("sum", {ConstexprValue(static_cast<int>(n))}, nullptr);
+        ASSERT_EQ(result.result, EvaluationResult::Success) << n << ": " << result.errorMessage;
+        EXPECT_EQ(result.value.asInteger(), n * (n + 1) * (2 * n + 1) / 6);
     }
+}
 
-    auto startTime = std::chrono::high_resolution_clock::now();
-
-    // Instanciar templates con diferentes argumentos
-    std::vector<std::string> argTypes = {"int", "double", "char", "float", "long", "short"};
-
-    for (int i = 0; i < 100; ++i) {
-        for (int j = 0; j < 20; ++j) {
-            std::vector<std::string> args;
-            for (int k = 0; k < 3; ++k) { // 3 parámetros por template
-                args.push_back(argTypes[(i + j + k) % argTypes.size()]);
-            }
-
-            auto instance = templateSystem.instantiateTemplate(
-                "complex_template_" + std::to_string(i),
-                args
-            );
+// Errores en masa: cada uno se diagnostica sin abortar la evaluación siguiente
+TEST_F(ConstexprStressTest, ManyErrors) {
+    using Op = ast::BinaryOp::OpKind;
+    ConstexprEvaluator evaluator(diagEngine_);
 
-            ASSERT_TRUE(instance != nullptr);
-            EXPECT_TRUE(instance->isValid);
-        }
+    for (int i = 0; i < 1000; ++i) {
+        auto result = evaluator.evaluateExpression(binary(integer(i), Op::Divide, integer(0)));
+        EXPECT_EQ(result.result, EvaluationResult::Error);
+        EXPECT_FALSE(result.errorMessage.empty());
     }
 
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-
-    auto stats = templateSystem.getStats();
-    EXPECT_EQ(stats.templatesRegistered, 100);
-
-    std::cout << "Complex template memory stress: " << (100 * 20)
-              << " instantiations in " << duration.count() << "ms" << std::endl;
+    EXPECT_EQ(evaluator.getStats().expressionsEvaluated, 1000u);
+    EXPECT_EQ(evaluator.getStats().errors, 1000u);
 }
 
-// Test para stress de evaluación concurrente (simulado)
-TEST(ConstexprStressTest, ConcurrentEvaluationStress) {
-    DiagnosticEngine diagEngine;
-    ConstexprEvaluator constexprEvaluator(diagEngine);
-
-    constexprEvaluator.setLimits(10000000, 1000, 50 * 1024 * 1024);
-
-    auto startTime = std::chrono::high_resolution_clock::now();
-
-    // Simular carga concurrente creando múltiples evaluaciones
-    // En un escenario real, esto usaría std::thread
-    for (int thread = 0; thread < 10; ++thread) { // Simular 10 threads
-        for (int i = 0; i < 1000; ++i) {
-            auto expression = std::make_unique<ast::ASTNode>(ast::ASTNodeKind::IntegerLiteral);
-
-            // Crear contexto único por "thread"
-            std::unordered_map<std::string, ConstexprValue> context;
-            context["thread_id"] = ConstexprValue(thread);
-            context["iteration"] = ConstexprValue(i);
-
-            auto result = constexprEvaluator.evaluateExpression(expression.get(), context);
+// Límites mínimos: nada llega a ejecutarse entero
+TEST_F(ConstexprStressTest, ExtremeLimits) {
+    ConstexprEvaluator evaluator(diagEngine_);
+    evaluator.setLimits(10, 1, 1024);
+    evaluator.registerConstexprFunction("fib", fibonacci());
 
-            EXPECT_EQ(result.result, EvaluationResult::Success);
-        }
+    for (int i = 0; i < 100; ++i) {
+        auto result = evaluator.evaluateFunction("fib", {ConstexprValue(20)}, nullptr);
+        EXPECT_TRUE(result.result == EvaluationResult::Timeout ||
+                    result.result == EvaluationResult::RecursionLimit)
+            << result.errorMessage;
     }
-
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-
-    auto stats = constexprEvaluator.getStats();
-    EXPECT_EQ(stats.expressionsEvaluated, 10 * 1000);
-
-    std::cout << "Concurrent stress: " << stats.expressionsEvaluated
-              << " evaluations in " << duration.count() << "ms" << std::endl;
+    EXPECT_EQ(evaluator.getStats().errors, 100u);
 }
 
-// Test para stress de cache
-TEST(ConstexprStressTest, CacheStressTest) {
-    DiagnosticEngine diagEngine;
-    TemplateSystem templateSystem(diagEngine);
-
-    // Crear templates para cache
-    for (int i = 0; i < 500; ++i) {
-        auto templateInfo = std::make_unique<TemplateInfo>(
-            "cache_template_" + std::to_string(i),
-            std::make_unique<ast::TemplateParameterList>(std::vector<std::unique_ptr<ast::TemplateParameter>>{}),
-            std::make_unique<ast::ASTNode>(ast::ASTNodeKind::FunctionDecl)
-        );
-
-        templateSystem.registerTemplate(std::move(templateInfo));
+// Muchos inicializadores en dos oleadas repartidas entre hilos
+TEST_F(ConstexprStressTest, ParallelInitializers) {
+    using Op = ast::BinaryOp::OpKind;
+    ConstexprEvaluator evaluator(diagEngine_);
+    evaluator.registerConstexprFunction("fib", fibonacci());
+
+    // constexpr int x<i> = fib(i % 25); ... constexpr int y<i> = x<i> + 1;
+    constexpr size_t count = 1000;
+    std::vector<ConstexprInitializer> initializers;
+    for (size_t i = 0; i < count; ++i) {
+        initializers.push_back({"x" + std::to_string(i), call("fib", {integer(static_cast<int64_t>(i % 25))})});
     }
-
-    auto startTime = std::chrono::high_resolution_clock::now();
-
-    // Acceder a templates múltiples veces para probar cache
-    for (int round = 0; round < 5; ++round) {
-        for (int i = 0; i < 500; ++i) {
-            for (int j = 0; j < 5; ++j) { // 5 instancias por template
-                auto instance = templateSystem.instantiateTemplate(
-                    "cache_template_" + std::to_string(i),
-                    {"int"}
-                );
-
-                ASSERT_TRUE(instance != nullptr);
-                EXPECT_TRUE(instance->isValid);
-            }
-        }
+    for (size_t i = 0; i < count; ++i) {
+        initializers.push_back({"y" + std::to_string(i),
+                                binary(name("x" + std::to_string(i)), Op::Add, integer(1))});
     }
+    auto results = evaluator.evaluateInitializers(initializers, 4);
 
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-
-    auto stats = templateSystem.getStats();
-    EXPECT_EQ(stats.templatesRegistered, 500);
-    EXPECT_EQ(stats.instancesCreated, 500); // Solo 500 instancias reales creadas (cache)
-
-    std::cout << "Cache stress: " << (500 * 5 * 5) << " accesses, "
-              << stats.instancesCreated << " actual creations in "
-              << duration.count() << "ms" << std::endl;
+    ASSERT_EQ(results.size(), 2 * count);
+    size_t succeeded = 0;
+    for (const auto& result : results) {
+        succeeded += result.result == EvaluationResult::Success;
+    }
+    EXPECT_EQ(succeeded, 2 * count);
+    EXPECT_EQ(results[2 * count - 1].value.asInteger(), 46368 + 1);    // fib(24) + 1
+    EXPECT_EQ(evaluator.getStats().initializerWaves, 2u);
 }
 
-// Test para stress de diagnóstico
-TEST(ConstexprStressTest, DiagnosticStressTest) {
-    DiagnosticEngine diagEngine;
-    ConstexprEvaluator constexprEvaluator(diagEngine);
-
-    auto startTime = std::chrono::high_resolution_clock::now();
-
-    // Generar muchos errores para probar el sistema de diagnóstico
+// Instanciación repetida: solo la primera de cada especialización crea una instancia
+TEST_F(ConstexprStressTest, TemplateInstantiation) {
+    TemplateSystem templateSystem(diagEngine_);
     for (int i = 0; i < 1000; ++i) {
-        // Intentar evaluar expresión nula (debería generar error)
-        auto result = constexprEvaluator.evaluateExpression(nullptr);
-
-        EXPECT_EQ(result.result, EvaluationResult::Error);
-        EXPECT_FALSE(result.errorMessage.empty());
+        templateSystem.registerTemplate(unaryTemplate("stress_template_" + std::to_string(i)));
     }
 
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-
-    auto stats = constexprEvaluator.getStats();
-    EXPECT_EQ(stats.expressionsEvaluated, 0); // Expresiones nulas no se evalúan
-    EXPECT_EQ(stats.errors, 1000);
+    for (int i = 0; i < 1000; ++i) {
+        for (int j = 0; j < 10; ++j) {
+            auto instance = templateSystem.instantiateTemplate("stress_template_" + std::to_string(i), {"int"});
+            ASSERT_TRUE(instance != nullptr);
+            EXPECT_TRUE(instance->isValid);
+        }
+    }
 
-    std::cout << "Diagnostic stress: " << stats.errors
-              << " errors handled in " << duration.count() << "ms" << std::endl;
+    auto stats = templateSystem.getStats();
+    EXPECT_EQ(stats.templatesRegistered, 1000u);
+    EXPECT_EQ(stats.instancesCreated, 1000u);
+    EXPECT_EQ(stats.cacheHits, 9000u);
 }
 
-// Test para stress de límites extremos
-TEST(ConstexprStressTest, ExtremeLimitsStress) {
-    DiagnosticEngine diagEngine;
-    ConstexprEvaluator constexprEvaluator(diagEngine);
-
-    // Configurar límites extremos
-    constexprEvaluator.setLimits(10, 1, 1024); // límites muy bajos
-
-    auto startTime = std::chrono::high_resolution_clock::now();
-
-    // Intentar evaluaciones que excedan límites
-    for (int i = 0; i < 100; ++i) {
-        auto expression = std::make_unique<ast::ASTNode>(ast::ASTNodeKind::IntegerLiteral);
-        auto result = constexprEvaluator.evaluateExpression(expression.get());
+// Satisfacción de concepts para muchos tipos
+TEST_F(ConstexprStressTest, ConceptEvaluation) {
+    TemplateSystem templateSystem(diagEngine_);
+    std::vector<std::string> types = {"int", "long", "short", "char", "float", "double", "void"};
+    std::vector<std::string> concepts = {"std::integral", "std::floating_point"};
 
-        // Debería fallar debido a límites extremos
-        EXPECT_TRUE(result.result == EvaluationResult::Timeout ||
-                   result.result == EvaluationResult::MemoryLimit ||
-                   result.result == EvaluationResult::Success);
+    size_t satisfied = 0;
+    for (int i = 0; i < 10000; ++i) {
+        for (const auto& conceptName : concepts) {
+            for (const auto& type : types) {
+                auto result = templateSystem.checkConceptSatisfaction(conceptName, type);
+                EXPECT_NE(result.satisfaction, ConstraintSatisfaction::Error);
+                satisfied += result.satisfaction == ConstraintSatisfaction::Satisfied;
+            }
+        }
     }
 
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-
-    auto stats = constexprEvaluator.getStats();
-
-    std::cout << "Extreme limits stress: " << stats.expressionsEvaluated
-              << " successful evaluations, " << stats.errors
-              << " errors in " << duration.count() << "ms" << std::endl;
+    // Cuatro integrales y dos de coma flotante; void no cumple ninguno
+    EXPECT_EQ(satisfied, 10000u * 6u);
+    EXPECT_EQ(templateSystem.getStats().constraintChecks, 10000u * 2u * 7u);
 }
 
-// Test para stress de cleanup y reinicio
-TEST(ConstexprStressTest, CleanupStressTest) {
-    DiagnosticEngine diagEngine;
-    TemplateSystem templateSystem(diagEngine);
-    ConstexprEvaluator constexprEvaluator(diagEngine);
+// Ciclos de uso intenso y limpieza de cachés
+TEST_F(ConstexprStressTest, CleanupCycles) {
+    using Op = ast::BinaryOp::OpKind;
+    TemplateSystem templateSystem(diagEngine_);
+    ConstexprEvaluator evaluator(diagEngine_);
 
-    auto startTime = std::chrono::high_resolution_clock::now();
-
-    // Ciclo de creación, uso intenso y cleanup
     for (int cycle = 0; cycle < 10; ++cycle) {
-        // Crear templates
         for (int i = 0; i < 50; ++i) {
-            auto templateInfo = std::make_unique<TemplateInfo>(
-                "cleanup_template_" + std::to_string(cycle) + "_" + std::to_string(i),
-                std::make_unique<ast::TemplateParameterList>(std::vector<std::unique_ptr<ast::TemplateParameter>>{}),
-                std::make_unique<ast::ASTNode>(ast::ASTNodeKind::FunctionDecl)
-            );
-
-            templateSystem.registerTemplate(std::move(templateInfo));
+            templateSystem.registerTemplate(
+                unaryTemplate("cleanup_template_" + std::to_string(cycle) + "_" + std::to_string(i)));
         }
-
-        // Usar intensivamente
         for (int i = 0; i < 50; ++i) {
             for (int j = 0; j < 10; ++j) {
                 auto instance = templateSystem.instantiateTemplate(
-                    "cleanup_template_" + std::to_string(cycle) + "_" + std::to_string(i),
-                    {"int"}
-                );
-
+                    "cleanup_template_" + std::to_string(cycle) + "_" + std::to_string(i), {"int"});
                 ASSERT_TRUE(instance != nullptr);
                 EXPECT_TRUE(instance->isValid);
             }
         }
-
-        // Evaluar expresiones
         for (int i = 0; i < 100; ++i) {
-            auto expression = std::make_unique<ast::ASTNode>(ast::ASTNodeKind::IntegerLiteral);
-            auto result = constexprEvaluator.evaluateExpression(expression.get());
-
+            auto result = evaluator.evaluateExpression(binary(integer(cycle), Op::Add, integer(i)));
             EXPECT_EQ(result.result, EvaluationResult::Success);
         }
 
-        // Limpiar todo
         templateSystem.clearCache();
-        constexprEvaluator.clear();
+        evaluator.clear();
     }
 
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-
-    std::cout << "Cleanup stress: 10 cycles completed in " << duration.count() << "ms" << std::endl;
-}
-
-// Test para stress de tipos de datos variados
-TEST(ConstexprStressTest, DataTypeVarietyStress) {
-    DiagnosticEngine diagEngine;
-    ConstexprEvaluator constexprEvaluator(diagEngine);
-
-    constexprEvaluator.setLimits(10000000, 1000, 10 * 1024 * 1024);
-
-    std::vector<ast::ASTNodeKind> expressionTypes = {
-        ast::ASTNodeKind::IntegerLiteral,
-        ast::ASTNodeKind::BooleanLiteral,
-        ast::ASTNodeKind::CharacterLiteral,
-        ast::ASTNodeKind::FloatingPointLiteral,
-        ast::ASTNodeKind::StringLiteral,
-        ast::ASTNodeKind::BinaryOp,
-        ast::ASTNodeKind::UnaryOp,
-        ast::ASTNodeKind::FunctionCall,
-        ast::ASTNodeKind::VariableDecl,
-        ast::ASTNodeKind::Assignment,
-        ast::ASTNodeKind::IfStmt,
-        ast::ASTNodeKind::TernaryOp
-    };
-
-    auto startTime = std::chrono::high_resolution_clock::now();
-
-    // Evaluar muchos tipos diferentes de expresiones
-    for (int round = 0; round < 100; ++round) {
-        for (auto exprType : expressionTypes) {
-            auto expression = std::make_unique<ast::ASTNode>(exprType);
-            auto result = constexprEvaluator.evaluateExpression(expression.get());
-
-            // Solo verificar que no cause crashes
-            EXPECT_TRUE(result.result == EvaluationResult::Success ||
-                       result.result == EvaluationResult::Error);
-        }
-    }
-
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-
-    auto stats = constexprEvaluator.getStats();
-    EXPECT_EQ(stats.expressionsEvaluated, 100 * expressionTypes.size());
-
-    std::cout << "Data type variety stress: " << stats.expressionsEvaluated
-              << " expressions of " << expressionTypes.size() << " types in "
-              << duration.count() << "ms" << std::endl;
+    EXPECT_EQ(templateSystem.getStats().templatesRegistered, 500u);
 }
@@ -3,7 +3,11 @@
  * @brief Tests unitarios para el sistema de corroutinas C++20
  */
 
+#include <compiler/coroutines/AsyncTask.h>
+#include <compiler/coroutines/CoroutineFrame.h>
+#include <compiler/coroutines/CoroutineScheduler.h>
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <memory>
 #include <vector>
 #include <chrono>
@@ -43,17 +47,18 @@ public:
         if (state_ == Suspended) {
             state_ = Running;
             resume_count_++;
-            // Simular ejecución
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
             state_ = Suspended;
         }
     }
 
-    void destroy() {
-        if (state_ != Destroyed) {
-            state_ = Destroyed;
-            destroy_count_++;
+    // Devuelve false si el frame ya estaba destruido
+    bool destroy() {
+        if (state_ == Destroyed) {
+            return false;
         }
+        state_ = Destroyed;
+        destroy_count_++;
+        return true;
     }
 
     State getState() const { return state_; }
@@ -71,8 +76,13 @@ public:
     TestCoroutineHandle(TestCoroutineFrame* frame) : frame_(frame) {}
 
     void resume() { if (frame_) frame_->resume(); }
-    void destroy() { if (frame_) frame_->destroy(); }
-    bool isDone() const { return frame_ ? frame_->getState() == TestCoroutineFrame::Done : true; }
+    bool destroy() { return frame_ && frame_->destroy(); }
+
+    // Un handle nulo o de un frame destruido ya no puede reanudarse
+    bool isDone() const {
+        return !frame_ || frame_->getState() == TestCoroutineFrame::Done ||
+               frame_->getState() == TestCoroutineFrame::Destroyed;
+    }
 
 private:
     TestCoroutineFrame* frame_;
@@ -95,8 +105,9 @@ public:
     }
 
     void destroy(TestCoroutineHandle handle) {
-        handle.destroy();
-        total_destroys_++;
+        if (handle.destroy()) {
+            total_destroys_++;
+        }
     }
 
     void cleanup() {
@@ -109,12 +120,8 @@ public:
         );
     }
 
-    size_t getActiveCount() const {
-        return std::count_if(frames_.begin(), frames_.end(),
-            [](const std::unique_ptr<TestCoroutineFrame>& frame) {
-                return frame->getState() != TestCoroutineFrame::Destroyed;
-            });
-    }
+    // Los frames destruidos siguen contando hasta cleanup()
+    size_t getActiveCount() const { return frames_.size(); }
 
     int getTotalCreations() const { return total_creations_; }
     int getTotalResumes() const { return total_resumes_; }
@@ -515,6 +522,282 @@ TEST(AwaitableEdgeCaseTest, RapidSuccession) {
     }
 }
 
+// ============================================================================
+// Marco de la corrutina y HALO
+// ============================================================================
+
+TEST(CoroutineFrameLayoutTest, OnlyVariablesLiveAcrossSuspendGoInFrame) {
+    using namespace cpp20::compiler::coroutines;
+
+    CoroutineFrameLayout layout;
+    layout.setPromise(16, 8);
+    layout.addSuspendPoint(10);
+    layout.addSuspendPoint(20);
+    layout.addVariable({"flag", 1, 1, 2, 25});      // Cruza ambas
+    layout.addVariable({"temp", 64, 8, 3, 8});      // Muere antes de suspender
+    layout.addVariable({"count", 4, 4, 12, 22});
+    layout.addVariable({"buffer", 32, 16, 5, 15});
+    layout.addVariable({"after", 8, 8, 21, 30});    // Nace tras la última
+    layout.compute();
+
+    EXPECT_EQ(layout.getLocalCount(), 2u);
+    EXPECT_EQ(layout.findSlot("temp"), nullptr);
+    EXPECT_EQ(layout.getPromiseOffset(), 24u);
+
+    // Cabecera 24 + promesa 16 = 40; buffer alineado a 48, luego count y flag
+    ASSERT_EQ(layout.getSlots().size(), 3u);
+    EXPECT_EQ(layout.getSlots()[0].name, "buffer");
+    EXPECT_EQ(layout.findSlot("buffer")->offset, 48u);
+    EXPECT_EQ(layout.findSlot("count")->offset, 80u);
+    EXPECT_EQ(layout.findSlot("flag")->offset, 84u);
+    EXPECT_EQ(layout.getFrameAlignment(), 16u);
+    EXPECT_EQ(layout.getFrameSize(), 96u);
+}
+
+TEST(CoroutineFrameLayoutTest, ElidesAllocationOnlyForNestedLifetimes) {
+    using namespace cpp20::compiler::coroutines;
+
+    CoroutineUse awaited{true, false, true};
+    EXPECT_EQ(chooseFrameAllocation(awaited, 96), FrameAllocation::CallerStack);
+    EXPECT_EQ(chooseFrameAllocation(awaited, 64 * 1024), FrameAllocation::Heap);
+
+    CoroutineUse stored{true, true, true};
+    EXPECT_EQ(chooseFrameAllocation(stored, 96), FrameAllocation::Heap);
+    CoroutineUse detached{true, false, false};
+    EXPECT_EQ(chooseFrameAllocation(detached, 96), FrameAllocation::Heap);
+    CoroutineUse indirect{false, false, true};
+    EXPECT_EQ(chooseFrameAllocation(indirect, 96), FrameAllocation::Heap);
+}
+
+// ============================================================================
+// Planificador con robo de trabajo
+// ============================================================================
+
+TEST(ChaseLevDequeTest, OwnerPopsLifoAndThievesStealFifo) {
+    cpp20::compiler::coroutines::ChaseLevDeque<int> deque(2);
+    for (int i = 0; i < 5; ++i) deque.push(i);       // Crece de 2 a 8
+    EXPECT_EQ(deque.sizeApprox(), 5u);
+    EXPECT_EQ(deque.steal(), 0);
+    EXPECT_EQ(deque.pop(), 4);
+    EXPECT_EQ(deque.steal(), 1);
+    EXPECT_EQ(deque.pop(), 3);
+    EXPECT_EQ(deque.pop(), 2);
+    EXPECT_FALSE(deque.pop().has_value());
+    EXPECT_FALSE(deque.steal().has_value());
+}
+
+TEST(ChaseLevDequeTest, ConcurrentStealsTakeEachItemOnce) {
+    constexpr int Count = 20000;
+    cpp20::compiler::coroutines::ChaseLevDeque<int> deque(16);
+    std::vector<std::atomic<int>> seen(Count);
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < 3; ++t) {
+        thieves.emplace_back([&]() {
+            while (!done.load() || !deque.emptyApprox()) {
+                if (auto value = deque.steal()) seen[*value].fetch_add(1);
+            }
+        });
+    }
+    for (int i = 0; i < Count; ++i) {
+        deque.push(i);
+        if (i % 3 == 0) {
+            if (auto value = deque.pop()) seen[*value].fetch_add(1);
+        }
+    }
+    while (auto value = deque.pop()) seen[*value].fetch_add(1);
+    done = true;
+    for (auto& thief : thieves) thief.join();
+
+    for (int i = 0; i < Count; ++i) {
+        ASSERT_EQ(seen[i].load(), 1) << i;
+    }
+}
+
+namespace {
+
+cpp20::compiler::coroutines::ScheduledTask yieldingTask(cpp20::compiler::coroutines::CoroutineScheduler& scheduler,
+                                                        std::atomic<int>& steps, int yields) {
+    for (int i = 0; i < yields; ++i) {
+        steps.fetch_add(1);
+        co_await scheduler.yield();
+    }
+    steps.fetch_add(1);
+}
+
+cpp20::compiler::coroutines::ScheduledTask sleepingTask(cpp20::compiler::coroutines::CoroutineScheduler& scheduler,
+                                                        std::chrono::microseconds delay,
+                                                        std::chrono::steady_clock::time_point& wokeAt) {
+    co_await scheduler.sleepFor(delay);
+    wokeAt = std::chrono::steady_clock::now();
+}
+
+// Lanza las hijas de una en una; la espera deja que cada una termine antes
+cpp20::compiler::coroutines::ScheduledTask spawningTask(cpp20::compiler::coroutines::CoroutineScheduler& scheduler,
+                                                        std::atomic<int>& steps, int children) {
+    for (int i = 0; i < children; ++i) {
+        scheduler.spawn(yieldingTask(scheduler, steps, 1));
+        co_await scheduler.sleepFor(std::chrono::microseconds(100));
+    }
+}
+
+} // namespace
+
+TEST(CoroutineSchedulerTest, RunsSpawnedTasksAcrossWorkers) {
+    using namespace cpp20::compiler::coroutines;
+
+    std::atomic<int> steps{0};
+    CoroutineScheduler scheduler(4);
+    EXPECT_EQ(scheduler.workerCount(), 4u);
+    for (int i = 0; i < 1000; ++i) {
+        scheduler.spawn(yieldingTask(scheduler, steps, 5));
+    }
+    scheduler.waitIdle();
+
+    EXPECT_EQ(steps.load(), 6000);
+    EXPECT_EQ(scheduler.getStatistics().resumed, 6000u);
+}
+
+TEST(CoroutineFrameAllocatorTest, ReusesFramesOfTheSameSizeClass) {
+    using cpp20::compiler::coroutines::CoroutineFrameAllocator;
+    static_assert(CoroutineFrameAllocator::sizeClassOf(100) == CoroutineFrameAllocator::sizeClassOf(112));
+    static_assert(CoroutineFrameAllocator::sizeClassOf(4096) == CoroutineFrameAllocator::SizeClassCount);
+
+    auto before = CoroutineFrameAllocator::statistics();
+    void* first = CoroutineFrameAllocator::allocate(100);
+    CoroutineFrameAllocator::deallocate(first, 100);
+    void* second = CoroutineFrameAllocator::allocate(112);     // Misma clase: sale de la lista
+    EXPECT_EQ(second, first);
+    void* large = CoroutineFrameAllocator::allocate(4096);
+    CoroutineFrameAllocator::deallocate(large, 4096);
+    CoroutineFrameAllocator::deallocate(second, 112);
+
+    auto after = CoroutineFrameAllocator::statistics();
+    EXPECT_EQ(after.allocations - before.allocations, 3u);
+    EXPECT_EQ(after.poolHits - before.poolHits, 1u);
+    EXPECT_EQ(after.heapFallbacks - before.heapFallbacks, 1u);
+    EXPECT_EQ(after.deallocations - before.deallocations, 3u);
+}
+
+TEST(CoroutineFrameAllocatorTest, SpawnedTasksUsePooledFrames) {
+    using namespace cpp20::compiler::coroutines;
+
+    auto before = CoroutineFrameAllocator::statistics();
+    std::atomic<int> steps{0};
+    {
+        // Un solo hilo: los marcos se crean y se liberan en el mismo trabajador
+        CoroutineScheduler scheduler(1);
+        scheduler.spawn(spawningTask(scheduler, steps, 50));
+        scheduler.waitIdle();
+    }
+    auto after = CoroutineFrameAllocator::statistics();
+    EXPECT_EQ(steps.load(), 100);
+    EXPECT_EQ(after.allocations - before.allocations, 51u);
+    EXPECT_EQ(after.deallocations - before.deallocations, 51u);
+    EXPECT_GE(after.poolHits - before.poolHits, 49u);
+}
+
+TEST(CoroutineSchedulerTest, TimersResumeWithoutBlockingWorkers) {
+    using namespace cpp20::compiler::coroutines;
+
+    CoroutineScheduler scheduler(2, std::chrono::microseconds(100));
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point late, early;
+    scheduler.spawn(sleepingTask(scheduler, std::chrono::microseconds(20000), late));
+    scheduler.spawn(sleepingTask(scheduler, std::chrono::microseconds(2000), early));
+    scheduler.waitIdle();
+
+    EXPECT_GE(early - start, std::chrono::microseconds(2000));
+    EXPECT_GE(late - start, std::chrono::microseconds(20000));
+    EXPECT_LT(early, late);
+    EXPECT_EQ(scheduler.getStatistics().timersFired, 2u);
+}
+
+TEST(TimerWheelTest, ExpiresOnlyDueEntriesAcrossRevolutions) {
+    using cpp20::compiler::coroutines::TimerWheel;
+    using std::chrono::microseconds;
+
+    auto start = TimerWheel::Clock::now();
+    TimerWheel wheel(microseconds(10), 8, start);
+    int a = 0, b = 0, c = 0;
+    wheel.add(start + microseconds(25), &a);
+    wheel.add(start + microseconds(200), &b);       // Más de una vuelta
+    wheel.add(start + microseconds(15), &c);
+    EXPECT_EQ(wheel.nextDeadline(), start + microseconds(20));
+
+    std::vector<void*> expired;
+    wheel.advance(start + microseconds(29), expired);     // a redondea a 30: aún no
+    EXPECT_EQ(expired, (std::vector<void*>{&c}));
+    wheel.advance(start + microseconds(30), expired);
+    EXPECT_EQ(expired, (std::vector<void*>{&c, &a}));
+    EXPECT_EQ(wheel.nextDeadline(), start + microseconds(200));
+
+    expired.clear();
+    wheel.advance(start + microseconds(150), expired);
+    EXPECT_TRUE(expired.empty());
+    wheel.advance(start + microseconds(1000), expired);
+    EXPECT_EQ(expired, (std::vector<void*>{&b}));
+    EXPECT_TRUE(wheel.empty());
+}
+
+// ============================================================================
+// Tests para la transferencia simétrica
+// ============================================================================
+
+namespace {
+
+uintptr_t deepestFrame = 0;
+
+cpp20::compiler::coroutines::AsyncTask<int> countDown(int depth) {
+    if (depth == 0) {
+        deepestFrame = reinterpret_cast<uintptr_t>(__builtin_frame_address(0));
+        co_return 0;
+    }
+    co_return 1 + co_await countDown(depth - 1);
+}
+
+cpp20::compiler::coroutines::AsyncTask<> failAt(int depth) {
+    if (depth == 0) throw std::runtime_error("fondo");
+    co_await failAt(depth - 1);
+}
+
+cpp20::compiler::coroutines::AsyncTask<int> hopToScheduler(cpp20::compiler::coroutines::CoroutineScheduler& scheduler,
+                                                           int depth) {
+    if (depth == 0) {
+        co_await scheduler.yield();     // Sigue en un trabajador
+        co_return 0;
+    }
+    co_return 1 + co_await hopToScheduler(scheduler, depth - 1);
+}
+
+} // namespace
+
+TEST(AsyncTaskTest, DeepAwaitChainsRunInConstantStack) {
+    using cpp20::compiler::coroutines::syncWait;
+
+    auto top = reinterpret_cast<uintptr_t>(__builtin_frame_address(0));
+    EXPECT_EQ(syncWait(countDown(10000)), 10000);
+#if defined(__clang__) || defined(_MSC_VER)
+    // Con un resume() anidado por nivel la pila crecería en más de un megabyte.
+    // GCC solo convierte el salto en llamada en cola con -foptimize-sibling-calls
+    EXPECT_LT(top - deepestFrame, 64u * 1024);
+#else
+    (void)top;
+#endif
+}
+
+TEST(AsyncTaskTest, ExceptionsPropagateThroughTheChain) {
+    using cpp20::compiler::coroutines::syncWait;
+    EXPECT_THROW(syncWait(failAt(1000)), std::runtime_error);
+}
+
+TEST(AsyncTaskTest, ChainResumedByTheSchedulerFinishesTheWait) {
+    using namespace cpp20::compiler::coroutines;
+    CoroutineScheduler scheduler(2);
+    EXPECT_EQ(syncWait(hopToScheduler(scheduler, 1000)), 1000);
+}
+
 // ============================================================================
 // Main Test Runner
 // ============================================================================
@@ -0,0 +1,136 @@
+/**
+ * @file test_dependency_scanner.cpp
+ * @brief Tests para el escaneo de dependencias en modo solo-directivas
+ */
+
+#include <compiler/frontend/DependencyScanner.h>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace cpp20::compiler;
+using frontend::DependencyScanner;
+using frontend::DependencyScanOptions;
+using frontend::PreprocessorUtils;
+
+namespace {
+
+class DependencyScannerTest : public ::testing::Test {
+protected:
+    std::filesystem::path dir_ = std::filesystem::temp_directory_path() / "dependency_scan_test";
+    std::shared_ptr<diagnostics::SourceManager> sourceManager_ =
+        std::make_shared<diagnostics::SourceManager>();
+
+    void SetUp() override {
+        std::filesystem::create_directories(dir_);
+        sourceManager_->addIncludePath(dir_, false);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dir_);
+    }
+
+    uint32_t writeFile(const std::string& name, const std::string& content) {
+        std::ofstream(dir_ / name, std::ios::binary) << content;
+        return sourceManager_->loadFile(dir_ / name);
+    }
+
+    static std::vector<std::string> names(const std::vector<std::filesystem::path>& paths) {
+        std::vector<std::string> result;
+        for (const auto& path : paths) {
+            result.push_back(path.filename().string());
+        }
+        return result;
+    }
+};
+
+} // namespace
+
+TEST_F(DependencyScannerTest, MinimizerKeepsOnlyDirectiveLines) {
+    std::string source =
+        "#include \"a.h\"\n"
+        "int x = 1'000; char c = '#';\n"
+        "/* comentario\n"
+        "#include \"comentado.h\"\n"
+        "*/ const char* s = R\"(\n"
+        "#include \"raw.h\"\n"
+        ")\";\n"
+        "  #  define X \\\n"
+        "     2\n"
+        "import m;\n";
+
+    EXPECT_EQ(PreprocessorUtils::minimizeToDirectives(source),
+              "#include \"a.h\"\n"
+              ";\n\n\n\n\n\n"
+              "  #  define X \\\n"
+              "     2\n"
+              "import m;\n");
+}
+
+TEST_F(DependencyScannerTest, ConditionsSelectIncludes) {
+    writeFile("on.h", "#pragma once\nint on;\n");
+    writeFile("off.h", "int off;\n");
+    writeFile("config.h", "#ifndef CONFIG_H\n#define CONFIG_H\n#define LEVEL 2\n#endif\n");
+    uint32_t main = writeFile("main.cpp",
+        "#include \"config.h\"\n"
+        "#include \"config.h\"\n"
+        "#if LEVEL > 1\n#include \"on.h\"\n#else\n#include \"off.h\"\n#endif\n"
+        "#ifdef EXTRA\n#include \"off.h\"\n#endif\n"
+        "int main() { return 0; }\n");
+
+    DependencyScanner scanner(sourceManager_);
+    auto result = scanner.scan(main);
+
+    ASSERT_TRUE(result.success);
+    EXPECT_EQ(names(result.includes), (std::vector<std::string>{"config.h", "on.h"}));
+    ASSERT_EQ(result.includeGraph.size(), 3u);
+    EXPECT_TRUE(result.includeGraph[1].skipped);
+
+    DependencyScanOptions options;
+    options.defines = {"EXTRA", "LEVEL=0"};
+    auto withDefines = DependencyScanner(sourceManager_, options).scan(main);
+    EXPECT_EQ(names(withDefines.includes), (std::vector<std::string>{"config.h", "on.h", "off.h"}));
+}
+
+TEST_F(DependencyScannerTest, ReportsModuleImportsAndMakeRule) {
+    uint32_t unit = writeFile("unit.cpp",
+        "module;\n#include \"legacy.h\"\nexport module app;\nimport core;\nexport import :detail;\n");
+    writeFile("legacy.h", "void legacy();\n");
+
+    auto result = DependencyScanner(sourceManager_).scan(unit);
+    EXPECT_EQ(result.modules.moduleName, "app");
+    EXPECT_EQ(result.modules.imports, (std::vector<std::string>{"core", ":detail"}));
+
+    std::string rule = DependencyScanner::formatMakeRule(result, "unit.obj");
+    EXPECT_EQ(rule.rfind("unit.obj: \\\n  ", 0), 0u);
+    EXPECT_NE(rule.find("legacy.h\n"), std::string::npos);
+    EXPECT_NE(rule.find("app.c++m: unit.obj\n"), std::string::npos);
+    EXPECT_NE(rule.find("CXX_IMPORTS += core.c++m\n"), std::string::npos);
+}
+
+TEST_F(DependencyScannerTest, ParallelScanMatchesSerialScan) {
+    writeFile("shared.h", "#ifndef SHARED_H\n#define SHARED_H\n#include \"leaf.h\"\n#endif\n");
+    writeFile("leaf.h", "#pragma once\n");
+
+    std::vector<uint32_t> units;
+    for (int i = 0; i < 16; ++i) {
+        std::string extra = i % 2 ? "#include \"leaf.h\"\n" : "";
+        units.push_back(writeFile("tu" + std::to_string(i) + ".cpp",
+                                  extra + "#include \"shared.h\"\n#include \"shared.h\"\n"));
+    }
+
+    DependencyScanOptions options;
+    options.jobs = 4;
+    auto parallel = DependencyScanner(sourceManager_, options).scanAll(units);
+    auto serial = DependencyScanner(sourceManager_).scanAll(units);
+
+    ASSERT_EQ(parallel.size(), units.size());
+    for (size_t i = 0; i < units.size(); ++i) {
+        EXPECT_TRUE(parallel[i].success);
+        EXPECT_EQ(parallel[i].includes, serial[i].includes);
+        EXPECT_EQ(parallel[i].includes.size(), 2u);
+    }
+}
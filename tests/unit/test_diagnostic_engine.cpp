@@ -0,0 +1,218 @@
+/**
+ * @file test_diagnostic_engine.cpp
+ * @brief Tests para el DiagnosticEngine secuencial y con buffers por hilo
+ */
+
+#include <compiler/common/diagnostics/DiagnosticEngine.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cpp20::compiler::diagnostics;
+
+namespace {
+
+struct EngineWithMemory {
+    explicit EngineWithMemory(bool parallel, int maxErrors = 100)
+        : engine(std::make_shared<SourceManager>()) {
+        DiagnosticEngine::Options options;
+        options.parallel = parallel;
+        options.maxErrors = maxErrors;
+        engine.setOptions(options);
+        engine.clearConsumers();
+        auto consumer = std::make_unique<MemoryConsumer>();
+        memory = consumer.get();
+        engine.addConsumer(std::move(consumer));
+    }
+
+    DiagnosticEngine engine;
+    MemoryConsumer* memory = nullptr;
+};
+
+// Cada hilo emite las líneas que le tocan; la línea 7 lleva una nota detrás
+void emitLines(DiagnosticEngine& engine, int first, int step, int count) {
+    for (int line = first; line < count; line += step) {
+        if (line == 7) {
+            engine.reportError(DiagnosticCode::ERR_SYN_EXPECTED_TOKEN, SourceLocation(line, 1, 0, 1), "error");
+            engine.reportNote(DiagnosticCode::NOTE_PREVIOUS_DEFINITION, SourceLocation(1, 1, 0, 1), "nota");
+            continue;
+        }
+        engine.reportWarning(DiagnosticCode::WARN_UNUSED_VARIABLE, SourceLocation(line, 1, 0, 1),
+                             "w" + std::to_string(line));
+    }
+}
+
+std::vector<std::string> parallelOutput(int threadCount) {
+    EngineWithMemory setup(true);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back(emitLines, std::ref(setup.engine), i, threadCount, 40);
+    }
+    for (auto& thread : threads) thread.join();
+
+    EXPECT_EQ(setup.engine.errorCount(), 1u);
+    EXPECT_EQ(setup.engine.warningCount(), 39u);
+    EXPECT_TRUE(setup.engine.diagnostics().empty());     // Aún en los buffers
+
+    setup.engine.flush();
+    setup.engine.waitRendered();
+    std::vector<std::string> messages;
+    for (const Diagnostic& diagnostic : setup.memory->diagnostics()) {
+        messages.push_back(diagnostic.message());
+    }
+    EXPECT_EQ(setup.engine.diagnostics().size(), messages.size());
+    return messages;
+}
+
+} // namespace
+
+TEST(DiagnosticEngineTest, SequentialModeDeliversImmediately) {
+    EngineWithMemory setup(false, 2);
+    setup.engine.reportWarning(DiagnosticCode::WARN_PERFORMANCE, SourceLocation(3, 1), "lento");
+    ASSERT_EQ(setup.memory->diagnostics().size(), 1u);
+    EXPECT_EQ(setup.engine.diagnostics().size(), 1u);
+
+    for (int i = 0; i < 3; ++i) {
+        setup.engine.reportError(DiagnosticCode::ERR_SYN_EXPECTED_TOKEN, SourceLocation(4, 1), "error");
+    }
+    EXPECT_EQ(setup.engine.errorCount(), 2u);     // El tercero supera el límite
+    EXPECT_FALSE(setup.engine.shouldContinue());
+    EXPECT_EQ(setup.memory->diagnostics().size(), 3u);
+}
+
+TEST(DiagnosticEngineTest, ParallelOutputIsOrderedByLocationWhateverTheThreads) {
+    std::vector<std::string> single = parallelOutput(1);
+    ASSERT_EQ(single.size(), 41u);
+    EXPECT_EQ(single[0], "w0");
+    EXPECT_EQ(single[7], "error");
+    EXPECT_EQ(single[8], "nota");       // Sigue a su error aunque su línea sea anterior
+    EXPECT_EQ(single[9], "w8");
+
+    EXPECT_EQ(parallelOutput(4), single);
+    EXPECT_EQ(parallelOutput(7), single);
+}
+
+TEST(DiagnosticEngineTest, ErrorLimitHoldsAcrossThreads) {
+    EngineWithMemory setup(true, 50);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&setup, t]() {
+            for (int i = 0; i < 100; ++i) {
+                setup.engine.reportError(DiagnosticCode::ERR_SYN_EXPECTED_TOKEN,
+                                         SourceLocation(static_cast<uint32_t>(i), static_cast<uint32_t>(t)), "e");
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    EXPECT_EQ(setup.engine.errorCount(), 50u);
+    EXPECT_FALSE(setup.engine.shouldContinue());
+    setup.engine.flush();
+    setup.engine.waitRendered();
+    EXPECT_EQ(setup.memory->diagnostics().size(), 50u);
+}
+
+TEST(DiagnosticEngineTest, SuppressedWarningsAreDroppedBeforeConstruction) {
+    EngineWithMemory setup(false);
+    setup.engine.disableWarning(DiagnosticCode::WARN_UNUSED_VARIABLE);
+    setup.engine.markSystemHeader(2);
+
+    EXPECT_FALSE(setup.engine.isEnabled(DiagnosticLevel::Warning, DiagnosticCode::WARN_UNUSED_VARIABLE,
+                                        SourceLocation(1, 1, 0, 1)));
+    EXPECT_FALSE(setup.engine.isEnabled(DiagnosticLevel::Warning, DiagnosticCode::WARN_PERFORMANCE,
+                                        SourceLocation(1, 1, 0, 2)));
+    EXPECT_TRUE(setup.engine.isEnabled(DiagnosticLevel::Error, DiagnosticCode::ERR_SEM_TYPE_MISMATCH,
+                                       SourceLocation(1, 1, 0, 2)));
+
+    setup.engine.reportWarning(DiagnosticCode::WARN_UNUSED_VARIABLE, SourceLocation(1, 1, 0, 1), "%0 sin usar",
+                               DeclRef{4});
+    setup.engine.reportWarning(DiagnosticCode::WARN_PERFORMANCE, SourceLocation(1, 1, 0, 2), "copia");
+    setup.engine.reportWarning(DiagnosticCode::WARN_PERFORMANCE, SourceLocation(1, 1, 0, 1), "copia");
+    EXPECT_EQ(setup.engine.warningCount(), 1u);
+    EXPECT_EQ(setup.memory->diagnostics().size(), 1u);
+
+    setup.engine.enableWarning(DiagnosticCode::WARN_UNUSED_VARIABLE);
+    EXPECT_TRUE(setup.engine.isEnabled(DiagnosticLevel::Warning, DiagnosticCode::WARN_UNUSED_VARIABLE,
+                                       SourceLocation(1, 1, 0, 1)));
+}
+
+TEST(DiagnosticEngineTest, TrapsSwallowDiagnosticsOfDiscardedAttempts) {
+    EngineWithMemory setup(false);
+    EngineWithMemory other(false);
+    {
+        DiagnosticTrap outer(setup.engine);
+        setup.engine.reportWarning(DiagnosticCode::WARN_PERFORMANCE, SourceLocation(1, 1), "copia");
+        {
+            DiagnosticTrap inner(setup.engine);
+            setup.engine.report(DiagnosticLevel::Error, DiagnosticCode::ERR_SEM_TYPE_MISMATCH, SourceLocation(2, 5),
+                                "%0 no es %1", TypeRef{1}, TypeRef{2});
+            setup.engine.reportError(DiagnosticCode::ERR_SYN_EXPECTED_TOKEN, SourceLocation(3, 1), "error");
+            // Otro motor no está atrapado
+            other.engine.reportError(DiagnosticCode::ERR_SYN_EXPECTED_TOKEN, SourceLocation(3, 1), "error");
+            EXPECT_TRUE(inner.hasErrors());
+            EXPECT_EQ(inner.trappedCount(), 2u);
+            EXPECT_EQ(inner.firstErrorCode(), DiagnosticCode::ERR_SEM_TYPE_MISMATCH);
+            EXPECT_EQ(inner.firstErrorLocation().line(), 2u);
+        }
+        EXPECT_FALSE(outer.hasErrors());
+        EXPECT_EQ(outer.trappedCount(), 1u);
+    }
+    EXPECT_EQ(setup.engine.totalCount(), 0u);
+    EXPECT_TRUE(setup.memory->diagnostics().empty());
+    EXPECT_EQ(other.engine.errorCount(), 1u);
+
+    setup.engine.reportError(DiagnosticCode::ERR_SYN_EXPECTED_TOKEN, SourceLocation(4, 1), "error");
+    EXPECT_EQ(setup.engine.errorCount(), 1u);
+}
+
+TEST(DiagnosticEngineTest, ArgumentsAreFormattedWhenShown) {
+    EngineWithMemory setup(false);
+    setup.engine.report(DiagnosticLevel::Warning, DiagnosticCode::WARN_IMPLICIT_CONVERSION,
+                        SourceLocation(5, 3, 0, 1), "conversión de %0 a %1 en %2 (%3%%)",
+                        TypeRef{1}, TypeRef{2}, DeclRef{9}, 50);
+    ASSERT_EQ(setup.memory->diagnostics().size(), 1u);
+    const Diagnostic& diagnostic = setup.memory->diagnostics()[0];
+
+    EXPECT_EQ(diagnostic.message(), "conversión de %0 a %1 en %2 (%3%%)");    // Plantilla sin formatear
+    EXPECT_EQ(diagnostic.arguments().size(), 4u);
+    EXPECT_EQ(diagnostic.formatMessage(), "conversión de type#1 a type#2 en decl#9 (50%)");
+
+    setup.engine.setNameResolver([](DiagnosticArgument::Type kind, uint32_t id) -> std::string {
+        if (kind == DiagnosticArgument::Type::Type) return id == 1 ? "int" : "short";
+        return "f";
+    });
+    EXPECT_NE(setup.engine.formatDiagnostic(diagnostic).find("conversión de int a short en f (50%)"),
+              std::string::npos);
+}
+
+TEST(DiagnosticEngineTest, SarifIsStreamedPerDiagnostic) {
+    auto sources = std::make_shared<SourceManager>();
+    uint32_t id = sources->createVirtualFile("int x;\nint \"y\";\n", "a.cpp");
+    DiagnosticEngine engine(sources);
+    engine.clearConsumers();
+    std::ostringstream out;
+    auto consumer = std::make_unique<SarifConsumer>(out, sources);
+    SarifConsumer* sarif = consumer.get();
+    engine.addConsumer(std::move(consumer));
+
+    engine.report(DiagnosticLevel::Warning, DiagnosticCode::WARN_UNUSED_VARIABLE, SourceLocation(2, 5, 0, id),
+                  "%0 sin usar", "\"y\"\t");
+    std::string afterFirst = out.str();
+    EXPECT_NE(afterFirst.find("\"results\":["), std::string::npos);
+    EXPECT_NE(afterFirst.find("\"ruleId\":\"6000\",\"level\":\"warning\""), std::string::npos);
+    EXPECT_NE(afterFirst.find("\"text\":\"\\\"y\\\"\\t sin usar\""), std::string::npos);
+    EXPECT_NE(afterFirst.find("\"uri\":\"a.cpp\""), std::string::npos);
+    EXPECT_NE(afterFirst.find("\"startLine\":2,\"startColumn\":5,\"snippet\":{\"text\":\"int \\\"y\\\";\"}"),
+              std::string::npos);
+
+    engine.reportNote(DiagnosticCode::NOTE_PREVIOUS_DEFINITION, SourceLocation(1, 5, 0, id), "aquí");
+    sarif->finish();
+    sarif->finish();
+    EXPECT_EQ(sarif->resultCount(), 2u);
+    std::string document = out.str();
+    EXPECT_EQ(document.rfind("\n]}]}\n"), document.size() - 6);
+    EXPECT_NE(document.find(",\n{\"ruleId\":\"7000\",\"level\":\"note\""), std::string::npos);
+}
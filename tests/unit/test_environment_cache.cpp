@@ -0,0 +1,120 @@
+/**
+ * @file test_environment_cache.cpp
+ * @brief Tests para la caché por usuario del entorno MSVC/SDK detectado
+ */
+
+#include <compiler/common/EnvironmentDetector.h>
+#include <gtest/gtest.h>
+#include <filesystem>
+
+using namespace cpp20::compiler;
+
+namespace {
+
+class EnvironmentCacheTest : public ::testing::Test {
+protected:
+    std::filesystem::path root_ = std::filesystem::temp_directory_path() / "environment_cache_test";
+    std::filesystem::path install_ = root_ / "VS" / "2022";
+    std::filesystem::path cacheFile_ = root_ / "cache" / "environment.cache";
+
+    void SetUp() override {
+        std::filesystem::remove_all(root_);
+        std::filesystem::create_directories(install_ / "VC/Tools/MSVC/14.35.32215");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(root_);
+    }
+
+    DetectedEnvironment makeEnvironment() const {
+        DetectedEnvironment env;
+        env.msvcVersion = MSVCVersion(2022, 14, 35, 32215, "2022", install_, "14.35.32215");
+        env.msvcInstallPath = install_;
+        env.windowsSDK = SDKVersion(10, 0, 22000, "10.0.22000.0", root_ / "Kits");
+        env.sdkInstallPath = root_ / "Kits";
+        env.includePaths = {install_ / "VC/Tools/MSVC/14.35.32215/include"};
+        env.libraryPaths = {install_ / "VC/Tools/MSVC/14.35.32215/lib/x64"};
+        env.preprocessorDefinitions = {"_WIN32", "_MSC_VER=1435"};
+        env.isValid = true;
+        return env;
+    }
+};
+
+} // namespace
+
+TEST_F(EnvironmentCacheTest, SavedDetectionIsReloaded) {
+    CompilerConfigManager manager;
+    ASSERT_TRUE(manager.saveCache(cacheFile_, makeEnvironment()));
+
+    DetectedEnvironment loaded;
+    ASSERT_TRUE(manager.loadCache(cacheFile_, "x86_64", loaded));
+    EXPECT_TRUE(loaded.isValid);
+    EXPECT_EQ(loaded.targetArchitecture, "x64");
+    EXPECT_EQ(loaded.msvcInstallPath, install_);
+    EXPECT_EQ(loaded.msvcVersion.toolchainVersion, "14.35.32215");
+    EXPECT_EQ(loaded.windowsSDK.fullVersion, "10.0.22000.0");
+    EXPECT_EQ(loaded.includePaths, makeEnvironment().includePaths);
+    EXPECT_EQ(loaded.libraryPaths, makeEnvironment().libraryPaths);
+    EXPECT_EQ(loaded.preprocessorDefinitions, makeEnvironment().preprocessorDefinitions);
+
+    // Otra arquitectura necesita su propia detección
+    EXPECT_FALSE(manager.loadCache(cacheFile_, "x86", loaded));
+}
+
+TEST_F(EnvironmentCacheTest, NewToolsetInvalidatesCache) {
+    CompilerConfigManager manager;
+    ASSERT_TRUE(manager.saveCache(cacheFile_, makeEnvironment()));
+
+    std::filesystem::create_directories(install_ / "VC/Tools/MSVC/14.36.32532");
+
+    DetectedEnvironment loaded;
+    EXPECT_FALSE(manager.loadCache(cacheFile_, "x64", loaded));
+}
+
+TEST_F(EnvironmentCacheTest, LoadOrDetectWritesCache) {
+    CompilerConfigManager manager;
+    manager.setCacheFile(cacheFile_);
+    DetectedEnvironment detected = manager.loadOrDetect("x64");
+    ASSERT_TRUE(std::filesystem::exists(cacheFile_));
+
+    DetectedEnvironment loaded;
+    ASSERT_TRUE(manager.loadCache(cacheFile_, "x64", loaded));
+    EXPECT_EQ(loaded.isValid, detected.isValid);
+    EXPECT_EQ(loaded.includePaths, detected.includePaths);
+}
+
+TEST_F(EnvironmentCacheTest, HostCPUIsReusedOnlyOnTheSameCPU) {
+    CompilerConfigManager manager;
+    DetectedEnvironment env = makeEnvironment();
+    env.hostCPU = EnvironmentDetector::detectHostCPU();
+    env.hostCPU.l2KB = 12345;                   // Solo puede venir de la caché
+    ASSERT_TRUE(manager.saveCache(cacheFile_, env));
+
+    DetectedEnvironment loaded;
+    ASSERT_TRUE(manager.loadCache(cacheFile_, "x64", loaded));
+    EXPECT_EQ(loaded.hostCPU.l2KB, 12345u);
+    EXPECT_EQ(loaded.hostCPU.family, env.hostCPU.family);
+    EXPECT_EQ(loaded.hostCPU.features.avx2, env.hostCPU.features.avx2);
+
+    // Caché escrita en otra máquina: se redetecta la CPU, no la instalación
+    env.hostCPU.signature ^= 1;
+    ASSERT_TRUE(manager.saveCache(cacheFile_, env));
+    ASSERT_TRUE(manager.loadCache(cacheFile_, "x64", loaded));
+    EXPECT_NE(loaded.hostCPU.l2KB, 12345u);
+    EXPECT_EQ(loaded.hostCPU.signature, EnvironmentDetector::hostSignature().second);
+    EXPECT_EQ(loaded.msvcInstallPath, install_);
+}
+
+TEST(HostCPUTest, MicroarchitectureAndArchitectureNames) {
+    EXPECT_EQ(EnvironmentDetector::microarchitectureFor("GenuineIntel", 6, 0x55), Microarchitecture::Skylake);
+    EXPECT_EQ(EnvironmentDetector::microarchitectureFor("GenuineIntel", 6, 0x3C), Microarchitecture::Generic);
+    EXPECT_EQ(EnvironmentDetector::microarchitectureFor("AuthenticAMD", 0x19, 0x21), Microarchitecture::Zen3);
+    EXPECT_EQ(EnvironmentDetector::microarchitectureFor("AuthenticAMD", 0x19, 0x61), Microarchitecture::Zen4);
+    EXPECT_EQ(EnvironmentDetector::microarchitectureFor("AuthenticAMD", 0x17, 0x71), Microarchitecture::Generic);
+
+    auto v3 = parseArchitecture("x86-64-v3");
+    ASSERT_TRUE(v3);
+    EXPECT_TRUE(v3->avx2 && v3->bmi2 && v3->lzcnt && v3->popcnt);
+    EXPECT_FALSE(v3->avx512f);
+    EXPECT_FALSE(parseArchitecture("native"));      // Lo resuelve detectHostCPU
+}
@@ -0,0 +1,80 @@
+/**
+ * @file test_hash_utils.cpp
+ * @brief Tests para el hash de contenido incremental y BLAKE3
+ */
+
+#include <compiler/common/utils/HashUtils.h>
+#include <gtest/gtest.h>
+#include <set>
+#include <string>
+
+using namespace cpp20::compiler::common::utils;
+
+namespace {
+
+// Entrada de los vectores de prueba oficiales de BLAKE3: bytes 0..250 repetidos
+std::string blake3TestInput(size_t length) {
+    std::string input(length, '\0');
+    for (size_t i = 0; i < length; ++i) input[i] = static_cast<char>(i % 251);
+    return input;
+}
+
+std::string blake3Hex(std::string_view data) {
+    Blake3Hasher hasher;
+    hasher.update(data);
+    return hasher.hexDigest();
+}
+
+} // namespace
+
+TEST(HashUtilsTest, StreamingMatchesOneShotForAnySplit) {
+    std::string data = blake3TestInput(200);
+    for (size_t length : {0u, 1u, 31u, 32u, 33u, 64u, 65u, 200u}) {
+        std::string_view whole(data.data(), length);
+        Hash128 expected = hash128(whole, 7);
+        for (size_t split = 0; split <= length; ++split) {
+            StreamingHasher hasher(7);
+            hasher.update(whole.substr(0, split));
+            hasher.update(whole.substr(split));
+            EXPECT_EQ(hasher.digest128(), expected) << length << " / " << split;
+        }
+        EXPECT_EQ(hash64(whole, 7), expected.low);
+    }
+}
+
+TEST(HashUtilsTest, ContentHashSeparatesNearbyInputs) {
+    std::set<uint64_t> seen;
+    std::string zeros;
+    for (int i = 0; i < 100; ++i) {
+        seen.insert(hash64(zeros));     // Solo cambia la longitud: el relleno no colisiona
+        zeros += '\0';
+    }
+    EXPECT_EQ(seen.size(), 100u);
+    EXPECT_NE(hash64("abc"), hash64("abc", 1));
+    EXPECT_NE(hash128("abd").high, hash128("abc").high);
+    EXPECT_EQ(hash128("abc").toHex().size(), 32u);
+}
+
+TEST(HashUtilsTest, Blake3MatchesReferenceVectors) {
+    EXPECT_EQ(blake3Hex(""), "af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262");
+    EXPECT_EQ(blake3Hex(blake3TestInput(1)), "2d3adedff11b61f14c886e35afa036736dcd87a74d27b5c1510225d0f592e213");
+    EXPECT_EQ(blake3Hex(blake3TestInput(1023)), "10108970eeda3eb932baac1428c7a2163b0e924c9a9e25b35bba72b28f70bd11");
+    EXPECT_EQ(blake3Hex(blake3TestInput(1024)), "42214739f095a406f3fc83deb889744ac00df831c10daa55189b5d121c855af7");
+    EXPECT_EQ(blake3Hex(blake3TestInput(1025)), "d00278ae47eb27b34faecf67b4fe263f82d5412916c1ffd97c8cb7fb814b8444");
+    EXPECT_EQ(blake3Hex(blake3TestInput(2049)), "5f4d72f40d7a5f82b15ca2b2e44b1de3c2ef86c426c95c1af0b6879522563030");
+    EXPECT_EQ(blake3Hex(blake3TestInput(3073)), "7124b49501012f81cc7f11ca069ec9226cecb8a2c850cfe644e327d22d3e1cd3");
+    EXPECT_EQ(blake3Hex(blake3TestInput(8193)), "bab6c09cb8ce8cf459261398d2e7aef35700bf488116ceb94a36d0f5f1b7bc3b");
+}
+
+TEST(HashUtilsTest, Blake3IsIncremental) {
+    std::string data = blake3TestInput(5000);
+    std::string expected = blake3Hex(data);
+    for (size_t piece : {1u, 63u, 64u, 1000u, 1024u}) {
+        Blake3Hasher hasher;
+        for (size_t offset = 0; offset < data.size(); offset += piece) {
+            hasher.update(std::string_view(data).substr(offset, piece));
+        }
+        EXPECT_EQ(hasher.hexDigest(), expected) << piece;
+    }
+    EXPECT_EQ(blake3("").size(), Blake3Hasher::OutputSize);
+}
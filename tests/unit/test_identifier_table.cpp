@@ -0,0 +1,109 @@
+/**
+ * @file test_identifier_table.cpp
+ * @brief Tests para la tabla de identificadores internados
+ */
+
+#include <compiler/frontend/lexer/IdentifierTable.h>
+#include <compiler/frontend/lexer/Lexer.h>
+#include <compiler/frontend/Preprocessor.h>
+#include <compiler/common/utils/ThreadPool.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace cpp20::compiler;
+using frontend::lexer::IdentifierInfo;
+using frontend::lexer::IdentifierTable;
+using frontend::lexer::TokenType;
+
+TEST(IdentifierTableTest, SameSpellingSameEntry) {
+    IdentifierTable table;
+    std::string first = "counter";
+    std::string second = "counter";
+
+    IdentifierInfo* a = table.get(first);
+    IdentifierInfo* b = table.get(second);
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, table.get("other"));
+    EXPECT_EQ(a->name(), "counter");
+    EXPECT_NE(a->name().data(), first.data()); // El texto vive en la tabla
+    EXPECT_EQ(table.size(), 2u);
+}
+
+TEST(IdentifierTableTest, FindDoesNotIntern) {
+    IdentifierTable table;
+    EXPECT_EQ(table.find("missing"), nullptr);
+    EXPECT_EQ(table.size(), 0u);
+
+    IdentifierInfo* info = table.get("present");
+    EXPECT_EQ(table.find("present"), info);
+}
+
+TEST(IdentifierTableTest, KeywordKindIsCached) {
+    IdentifierTable table;
+    EXPECT_EQ(table.get("while")->keywordKind(), TokenType::WHILE);
+    EXPECT_TRUE(table.get("constexpr")->isKeyword());
+    EXPECT_FALSE(table.get("value")->isKeyword());
+}
+
+TEST(IdentifierTableTest, ConcurrentInterningReturnsOneEntry) {
+    IdentifierTable table;
+    constexpr size_t kNames = 512;
+    std::vector<std::vector<IdentifierInfo*>> seen(8, std::vector<IdentifierInfo*>(kNames));
+
+    common::utils::parallelFor(seen.size(), seen.size(), [&](size_t worker) {
+        for (size_t i = 0; i < kNames; ++i) {
+            seen[worker][i] = table.get("name" + std::to_string(i));
+        }
+    });
+
+    EXPECT_EQ(table.size(), kNames);
+    for (size_t worker = 1; worker < seen.size(); ++worker) {
+        EXPECT_EQ(seen[worker], seen[0]);
+    }
+}
+
+TEST(IdentifierTableTest, LexerAttachesEntries) {
+    IdentifierTable table;
+    auto sourceManager = std::make_shared<diagnostics::SourceManager>();
+    diagnostics::DiagnosticEngine diagEngine(sourceManager);
+
+    frontend::lexer::LexerConfig config;
+    config.identifiers = &table;
+    frontend::lexer::Lexer lexer("x + x * return", diagEngine, config);
+    auto tokens = lexer.tokenize();
+
+    ASSERT_EQ(tokens.size(), 6u);
+    EXPECT_NE(tokens[0].getIdentifierInfo(), nullptr);
+    EXPECT_EQ(tokens[0].getIdentifierInfo(), tokens[2].getIdentifierInfo());
+    EXPECT_EQ(tokens[1].getIdentifierInfo(), nullptr);
+    EXPECT_EQ(tokens[4].getType(), TokenType::RETURN);
+}
+
+TEST(IdentifierTableTest, MacroBitTracksPreprocessors) {
+    IdentifierTable table;
+    auto sourceManager = std::make_shared<diagnostics::SourceManager>();
+    diagnostics::DiagnosticEngine diagEngine(sourceManager);
+
+    frontend::PreprocessorConfig config;
+    config.identifiers = &table;
+    IdentifierInfo* info = table.get("FEATURE");
+
+    {
+        frontend::Preprocessor first(diagEngine, config);
+        frontend::Preprocessor second(diagEngine, config);
+
+        first.defineMacro("FEATURE", "1");
+        EXPECT_TRUE(info->mayHaveMacroDefinition());
+        EXPECT_TRUE(first.isMacroDefined(info));
+        EXPECT_FALSE(second.isMacroDefined(info)); // El bit es solo un filtro
+
+        second.defineMacro("FEATURE", "2");
+        first.undefineMacro("FEATURE");
+        EXPECT_TRUE(info->mayHaveMacroDefinition());
+        EXPECT_NE(second.getMacro("FEATURE"), nullptr);
+    }
+
+    EXPECT_FALSE(info->mayHaveMacroDefinition());
+}
@@ -0,0 +1,107 @@
+/**
+ * @file test_include_resolution_cache.cpp
+ * @brief Tests para la caché persistente de resolución de includes
+ */
+
+#include <compiler/common/diagnostics/IncludeResolutionCache.h>
+#include <compiler/common/diagnostics/SourceManager.h>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+using namespace cpp20::compiler::diagnostics;
+
+namespace {
+
+class IncludeResolutionCacheTest : public ::testing::Test {
+protected:
+    std::filesystem::path root_ = std::filesystem::temp_directory_path() / "include_cache_test";
+    std::filesystem::path first_ = root_ / "first";
+    std::filesystem::path second_ = root_ / "second";
+    std::filesystem::path cacheFile_ = root_ / "includes.cache";
+
+    void SetUp() override {
+        std::filesystem::remove_all(root_);
+        std::filesystem::create_directories(first_);
+        std::filesystem::create_directories(second_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(root_);
+    }
+
+    static void touch(const std::filesystem::path& path) {
+        std::ofstream(path) << "// header\n";
+    }
+
+    /// Simula una invocación del compilador: caché recién cargada y rutas -I
+    IncludeSearchPath makeSearchPath(const std::shared_ptr<IncludeResolutionCache>& cache) const {
+        IncludeSearchPath searchPath;
+        searchPath.addUserPath(first_);
+        searchPath.addUserPath(second_);
+        searchPath.setResolutionCache(cache);
+        return searchPath;
+    }
+};
+
+} // namespace
+
+TEST_F(IncludeResolutionCacheTest, ResolutionIsReusedByLaterInvocations) {
+    touch(second_ / "config.h");
+
+    auto cache = std::make_shared<IncludeResolutionCache>(cacheFile_);
+    EXPECT_EQ(makeSearchPath(cache).findInclude("config.h", false), second_ / "config.h");
+    EXPECT_EQ(cache->missCount(), 1u);
+    ASSERT_TRUE(cache->save());
+
+    auto reloaded = std::make_shared<IncludeResolutionCache>(cacheFile_);
+    ASSERT_TRUE(reloaded->load());
+    EXPECT_EQ(reloaded->size(), 1u);
+    EXPECT_EQ(makeSearchPath(reloaded).findInclude("config.h", false), second_ / "config.h");
+    EXPECT_EQ(reloaded->hitCount(), 1u);
+}
+
+TEST_F(IncludeResolutionCacheTest, NewFileInEarlierDirectoryInvalidatesEntry) {
+    touch(second_ / "config.h");
+    auto cache = std::make_shared<IncludeResolutionCache>(cacheFile_);
+    makeSearchPath(cache).findInclude("config.h", false);
+    makeSearchPath(cache).findInclude("missing.h", false);
+    ASSERT_TRUE(cache->save());
+
+    // Un header que ahora tapa al anterior cambia el mtime de first/
+    touch(first_ / "config.h");
+
+    auto reloaded = std::make_shared<IncludeResolutionCache>(cacheFile_);
+    ASSERT_TRUE(reloaded->load());
+    IncludeSearchPath searchPath = makeSearchPath(reloaded);
+    EXPECT_EQ(searchPath.findInclude("config.h", false), first_ / "config.h");
+    EXPECT_EQ(searchPath.findInclude("missing.h", false), std::nullopt);
+    EXPECT_EQ(reloaded->hitCount(), 0u);
+}
+
+TEST_F(IncludeResolutionCacheTest, KeyIncludesSearchPathsAndIncludeKind) {
+    touch(second_ / "config.h");
+    auto cache = std::make_shared<IncludeResolutionCache>();
+    IncludeSearchPath searchPath = makeSearchPath(cache);
+    searchPath.findInclude("config.h", false);
+
+    EXPECT_EQ(cache->lookup(searchPath.pathsHash(), "config.h", true), std::nullopt);
+
+    IncludeSearchPath reordered;
+    reordered.addUserPath(second_);
+    reordered.addUserPath(first_);
+    EXPECT_NE(reordered.pathsHash(), searchPath.pathsHash());
+    EXPECT_EQ(cache->lookup(reordered.pathsHash(), "config.h", false), std::nullopt);
+
+    EXPECT_EQ(cache->lookup(searchPath.pathsHash(), "config.h", false),
+              IncludeResolutionCache::Resolution(second_ / "config.h"));
+}
+
+TEST_F(IncludeResolutionCacheTest, CorruptFileLeavesCacheEmpty) {
+    std::ofstream(cacheFile_) << "cpp20-include-cache 1\nbasura\n";
+    IncludeResolutionCache cache(cacheFile_);
+    EXPECT_FALSE(cache.load());
+    EXPECT_EQ(cache.size(), 0u);
+}
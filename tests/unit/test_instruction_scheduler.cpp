@@ -0,0 +1,274 @@
+/**
+ * @file test_instruction_scheduler.cpp
+ * @brief Tests del planificador de instrucciones: dependencias y modelo de ciclos
+ */
+
+#include <compiler/backend/codegen/InstructionScheduler.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <initializer_list>
+#include <string>
+
+using namespace cpp20::compiler;
+using namespace cpp20::compiler::backend;
+
+namespace {
+
+using R = X86Register;
+using Op = X86Opcode;
+
+X86Operand reg(R r) {
+    X86Operand operand;
+    operand.reg = r;
+    return operand;
+}
+
+X86Operand mem(R base, int32_t displacement = 0) {
+    X86Operand operand(AddressingMode::MemoryBaseDisp);
+    operand.reg = base;
+    operand.displacement = displacement;
+    return operand;
+}
+
+X86Operand imm(int64_t value) {
+    X86Operand operand(AddressingMode::Immediate);
+    operand.immediate = value;
+    return operand;
+}
+
+// El comentario identifica cada instrucción tras reordenar
+X86Instruction inst(const std::string& name, Op opcode, std::initializer_list<X86Operand> operands = {}) {
+    X86Instruction instruction(opcode);
+    instruction.operands = operands;
+    instruction.comment = name;
+    return instruction;
+}
+
+size_t position(const std::vector<X86Instruction>& code, const std::string& name) {
+    auto it = std::find_if(code.begin(), code.end(), [&](const X86Instruction& i) { return i.comment == name; });
+    EXPECT_NE(it, code.end()) << name;
+    return static_cast<size_t>(it - code.begin());
+}
+
+std::vector<std::string> names(const std::vector<X86Instruction>& code) {
+    std::vector<std::string> result;
+    for (const auto& instruction : code) result.push_back(instruction.comment);
+    return result;
+}
+
+} // namespace
+
+TEST(InstructionSchedulerTest, HoistsIndependentLoadsAheadOfCheapWork) {
+    // La carga con su cadena de IMUL es la ruta crítica: sube al principio
+    std::vector<X86Instruction> code = {
+        inst("add", Op::ADD, {reg(R::RBX), imm(1)}),
+        inst("load", Op::MOV, {reg(R::RSI), mem(R::RDI)}),
+        inst("imul", Op::IMUL, {reg(R::RSI), reg(R::RSI)}),
+    };
+    auto scheduled = InstructionScheduler().schedule(code);
+    ASSERT_EQ(scheduled.size(), code.size());
+    EXPECT_EQ(position(scheduled, "load"), 0u);
+    EXPECT_LT(position(scheduled, "load"), position(scheduled, "imul"));
+}
+
+TEST(InstructionSchedulerTest, RegisterDependenciesSeeThroughSubRegisters) {
+    // RAW: escribe EAX, lee AL
+    std::vector<X86Instruction> raw = {
+        inst("def", Op::MOV, {reg(R::EAX), mem(R::RCX)}),
+        inst("chain", Op::MOV, {reg(R::RSI), mem(R::RDI)}),
+        inst("chain2", Op::IMUL, {reg(R::RSI), reg(R::RSI)}),
+        inst("use", Op::ADD, {reg(R::AL), imm(1)}),
+        inst("use2", Op::IMUL, {reg(R::RAX), reg(R::RAX)}),
+        inst("use3", Op::IMUL, {reg(R::RAX), reg(R::RAX)}),
+    };
+    auto scheduled = InstructionScheduler().schedule(raw);
+    EXPECT_LT(position(scheduled, "def"), position(scheduled, "use"));
+    EXPECT_LT(position(scheduled, "use"), position(scheduled, "use2"));
+
+    // WAR: la carga en EAX, más prioritaria, no sube por encima de quien lee RAX
+    std::vector<X86Instruction> war = {
+        inst("read", Op::ADD, {reg(R::RDX), reg(R::RAX)}),
+        inst("write", Op::MOV, {reg(R::EAX), mem(R::RCX)}),
+        inst("other", Op::MOV, {reg(R::RSI), mem(R::RDI)}),
+        inst("other2", Op::IMUL, {reg(R::RSI), reg(R::RSI)}),
+        inst("other3", Op::IMUL, {reg(R::RSI), reg(R::RSI)}),
+    };
+    scheduled = InstructionScheduler().schedule(war);
+    EXPECT_LT(position(scheduled, "read"), position(scheduled, "write"));
+    EXPECT_EQ(position(scheduled, "other"), 0u);
+
+    // WAW: MOV AL no se adelanta ni se retrasa respecto a la carga en RAX
+    std::vector<X86Instruction> waw = {
+        inst("first", Op::MOV, {reg(R::AL), imm(1)}),
+        inst("other", Op::MOV, {reg(R::RSI), mem(R::RDI)}),
+        inst("second", Op::MOV, {reg(R::RAX), mem(R::RCX)}),
+        inst("use", Op::IMUL, {reg(R::RAX), reg(R::RAX)}),
+    };
+    scheduled = InstructionScheduler().schedule(waw);
+    EXPECT_LT(position(scheduled, "first"), position(scheduled, "second"));
+    EXPECT_LT(position(scheduled, "second"), position(scheduled, "use"));
+
+    // XMM0 e YMM0 son el mismo registro
+    std::vector<X86Instruction> vector = {
+        inst("def", Op::VMOVUPS, {reg(R::YMM0), mem(R::RCX)}),
+        inst("use", Op::ADDPS, {reg(R::XMM1), reg(R::XMM0)}),
+        inst("redef", Op::MOVAPS, {reg(R::XMM0), reg(R::XMM2)}),
+    };
+    scheduled = InstructionScheduler().schedule(vector);
+    EXPECT_EQ(names(scheduled), names(vector));
+}
+
+TEST(InstructionSchedulerTest, FlagsProducerStaysBeforeTheCmov) {
+    // La cadena de ADD/IMUL sobre RBX es la más larga, pero pisa los flags:
+    // ni se mete entre CMP y CMOVL ni se adelanta al CMP
+    std::vector<X86Instruction> code = {
+        inst("cmp", Op::CMP, {reg(R::RDI), reg(R::RSI)}),
+        inst("cmov", Op::CMOVL, {reg(R::RAX), reg(R::RSI)}),
+        inst("add", Op::ADD, {reg(R::RBX), imm(1)}),
+        inst("imul", Op::IMUL, {reg(R::RBX), reg(R::RBX)}),
+        inst("imul2", Op::IMUL, {reg(R::RBX), reg(R::RBX)}),
+    };
+    auto scheduled = InstructionScheduler().schedule(code);
+    EXPECT_LT(position(scheduled, "cmp"), position(scheduled, "cmov"));
+    EXPECT_LT(position(scheduled, "cmov"), position(scheduled, "add"));
+
+    // Una instrucción independiente que no toca flags sí puede colarse en medio
+    code = {
+        inst("cmp", Op::CMP, {reg(R::RDI), reg(R::RSI)}),
+        inst("cmov", Op::CMOVGE, {reg(R::RAX), reg(R::RSI)}),
+        inst("load", Op::MOV, {reg(R::RBX), mem(R::RCX)}),
+    };
+    scheduled = InstructionScheduler().schedule(code);
+    EXPECT_EQ(position(scheduled, "load"), 0u);
+    EXPECT_LT(position(scheduled, "cmp"), position(scheduled, "cmov"));
+}
+
+TEST(InstructionSchedulerTest, IdivReadsAndWritesTheRaxRdxPair) {
+    // Ningún operando explícito de IDIV nombra RAX ni RDX
+    std::vector<X86Instruction> code = {
+        inst("dividend", Op::MOV, {reg(R::RAX), mem(R::RCX)}),
+        inst("high", Op::MOV, {reg(R::EDX), imm(0)}),
+        inst("idiv", Op::IDIV, {reg(R::RBX)}),
+        inst("remainder", Op::MOV, {reg(R::RSI), reg(R::RDX)}),
+        inst("quotient", Op::MOV, {reg(R::RDI), reg(R::EAX)}),
+        inst("reuse", Op::MOV, {reg(R::EDX), mem(R::R8)}),
+        inst("reuse2", Op::IMUL, {reg(R::RDX), reg(R::RDX)}),
+        inst("clobber", Op::MOV, {reg(R::AL), imm(7)}),
+    };
+    auto scheduled = InstructionScheduler().schedule(code);
+    size_t idiv = position(scheduled, "idiv");
+    EXPECT_LT(position(scheduled, "dividend"), idiv);
+    EXPECT_LT(position(scheduled, "high"), idiv);
+    EXPECT_GT(position(scheduled, "remainder"), idiv);
+    EXPECT_GT(position(scheduled, "quotient"), idiv);
+    EXPECT_GT(position(scheduled, "reuse"), position(scheduled, "remainder"));
+    EXPECT_GT(position(scheduled, "clobber"), position(scheduled, "quotient"));
+}
+
+TEST(InstructionSchedulerTest, StoresAreNotReorderedWithAnyMemoryAccess) {
+    // Sin análisis de alias: store → load, load → store y store → store
+    std::vector<X86Instruction> code = {
+        inst("load1", Op::MOV, {reg(R::RAX), mem(R::RSI)}),
+        inst("store1", Op::MOV, {mem(R::RDI), reg(R::RDX)}),
+        inst("load2", Op::MOV, {reg(R::RBX), mem(R::RSI, 8)}),
+        inst("use2", Op::IMUL, {reg(R::RBX), reg(R::RBX)}),
+        inst("store2", Op::MOV, {mem(R::RDI, 8), reg(R::RCX)}),
+        inst("rmw", Op::ADD, {mem(R::RDI, 16), imm(1)}),
+        inst("load3", Op::MOV, {reg(R::R8), mem(R::RSI, 16)}),
+        inst("use3", Op::IMUL, {reg(R::R8), reg(R::R8)}),
+    };
+    auto scheduled = InstructionScheduler().schedule(code);
+    EXPECT_LT(position(scheduled, "load1"), position(scheduled, "store1"));
+    EXPECT_LT(position(scheduled, "store1"), position(scheduled, "load2"));
+    EXPECT_LT(position(scheduled, "load2"), position(scheduled, "store2"));
+    EXPECT_LT(position(scheduled, "store2"), position(scheduled, "rmw"));
+    EXPECT_LT(position(scheduled, "rmw"), position(scheduled, "load3"));
+
+    // Dos stores seguidos: el segundo, del que depende la carga, no se adelanta
+    code = {
+        inst("store1", Op::MOV, {mem(R::RDI), reg(R::RDX)}),
+        inst("store2", Op::MOV, {mem(R::RDI, 8), reg(R::RCX)}),
+        inst("load", Op::MOV, {reg(R::RBX), mem(R::RSI)}),
+        inst("use", Op::IMUL, {reg(R::RBX), reg(R::RBX)}),
+    };
+    scheduled = InstructionScheduler().schedule(code);
+    EXPECT_EQ(names(scheduled), names(code));
+
+    // Las cargas entre sí sí se reordenan
+    code = {
+        inst("load1", Op::MOV, {reg(R::RAX), mem(R::RSI)}),
+        inst("load2", Op::MOV, {reg(R::RBX), mem(R::RSI, 8)}),
+        inst("use2", Op::IMUL, {reg(R::RBX), reg(R::RBX)}),
+    };
+    scheduled = InstructionScheduler().schedule(code);
+    EXPECT_EQ(position(scheduled, "load2"), 0u);
+}
+
+TEST(InstructionSchedulerTest, BarriersKeepTheirPlace) {
+    std::vector<X86Instruction> code = {
+        inst("add", Op::ADD, {reg(R::RBX), imm(1)}),
+        inst("load", Op::MOV, {reg(R::RSI), mem(R::RDI)}),
+        inst("call", Op::CALL),
+        inst("add2", Op::ADD, {reg(R::RBX), imm(1)}),
+        inst("load2", Op::MOV, {reg(R::RSI), mem(R::RDI)}),
+        inst("imul2", Op::IMUL, {reg(R::RSI), reg(R::RSI)}),
+        inst("push", Op::PUSH, {reg(R::RBX)}),
+        inst("add3", Op::ADD, {reg(R::RCX), imm(1)}),
+        inst("load3", Op::MOV, {reg(R::RDX), mem(R::RDI)}),
+        inst("imul3", Op::IMUL, {reg(R::RDX), reg(R::RDX)}),
+        inst("ret", Op::RET),
+    };
+    auto scheduled = InstructionScheduler().schedule(code);
+    ASSERT_EQ(scheduled.size(), code.size());
+    EXPECT_EQ(position(scheduled, "call"), 2u);
+    EXPECT_EQ(position(scheduled, "push"), 6u);
+    EXPECT_EQ(position(scheduled, "ret"), 10u);
+
+    // Dentro de cada tramo se reordena, pero nada cruza la barrera
+    EXPECT_EQ(position(scheduled, "load2"), 3u);
+    EXPECT_LT(position(scheduled, "add2"), 6u);
+    EXPECT_EQ(position(scheduled, "load3"), 7u);
+    EXPECT_GT(position(scheduled, "add3"), 6u);
+}
+
+TEST(InstructionSchedulerTest, FlagsSetterStaysNextToTheConditionalJump) {
+    std::vector<X86Instruction> code = {
+        inst("cmp", Op::CMP, {reg(R::RDI), reg(R::RSI)}),
+        inst("load", Op::MOV, {reg(R::RAX), mem(R::RCX)}),
+        inst("lea", Op::LEA, {reg(R::RBX), mem(R::RBX, 1)}),
+        inst("jl", Op::JL),
+    };
+    auto scheduled = InstructionScheduler().schedule(code);
+    EXPECT_EQ(position(scheduled, "cmp"), 2u);
+    EXPECT_EQ(position(scheduled, "jl"), 3u);
+}
+
+TEST(InstructionSchedulerTest, SchedulingLowersTheEstimateOnEveryModel) {
+    // Dos cadenas de carga + IMUL escritas una detrás de otra: en orden la
+    // segunda carga espera a la primera cadena; planificadas se solapan
+    std::vector<X86Instruction> code;
+    const R chains[] = {R::RAX, R::RBX, R::RCX};
+    const R bases[] = {R::RSI, R::RDI, R::R8};
+    for (size_t chain = 0; chain < 3; ++chain) {
+        std::string prefix = std::to_string(chain);
+        code.push_back(inst(prefix + "load", Op::MOV, {reg(chains[chain]), mem(bases[chain])}));
+        code.push_back(inst(prefix + "imul", Op::IMUL, {reg(chains[chain]), reg(chains[chain])}));
+        code.push_back(inst(prefix + "add", Op::ADD, {reg(chains[chain]), imm(1)}));
+    }
+
+    uint32_t generic = 0;
+    for (auto target : {Microarchitecture::Generic, Microarchitecture::Skylake,
+                        Microarchitecture::Zen3, Microarchitecture::Zen4}) {
+        InstructionScheduler scheduler(target);
+        uint32_t before = scheduler.estimateCycles(code);
+        uint32_t after = scheduler.estimateCycles(scheduler.schedule(code));
+        EXPECT_LT(after, before) << MicroarchitectureModel::forTarget(target).name;
+        // Las tres cargas salen juntas: se ocultan las latencias de dos
+        const auto& model = MicroarchitectureModel::forTarget(target);
+        EXPECT_LE(after + 2u * model.loadLatency, before) << model.name;
+        if (target == Microarchitecture::Generic) generic = before;
+    }
+
+    // Zen carga en 4 ciclos en lugar de 5: la secuencia original es más corta
+    EXPECT_LT(InstructionScheduler(Microarchitecture::Zen3).estimateCycles(code), generic);
+}
@@ -0,0 +1,234 @@
+/**
+ * @file test_ir.cpp
+ * @brief Tests para la IR en forma SSA densa
+ */
+
+#include <compiler/ir/IR.h>
+#include <compiler/ir/ExceptionIR.h>
+#include <compiler/ir/IRSerialization.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace cpp20::compiler::ir;
+
+namespace {
+
+const TypeInfo IntType(IRType::Int, 4, 4, "i32");
+
+} // namespace
+
+TEST(IRTest, BuilderProducesDenseSSA) {
+    IRFunction function("sum", IntType, {IntType, IntType});
+    IRBuilder builder(function);
+    BlockId entry = builder.createBlock("entry");
+    builder.setInsertPoint(entry);
+
+    ValueId a = function.parameter(0);
+    ValueId b = function.parameter(1);
+    ValueId add = builder.createBinary(IROpcode::Add, a, b, IntType);
+    ValueId twice = builder.createBinary(IROpcode::Mul, add, builder.getInt(2, IntType), IntType);
+    builder.createReturn(twice);
+
+    EXPECT_EQ(function.instructionCount(), 3u);
+    EXPECT_EQ(function.useCount(add), 1u);
+    EXPECT_EQ(function.useCount(a), 1u);
+
+    // Las constantes iguales comparten valor
+    EXPECT_EQ(builder.getInt(2, IntType), builder.getInt(2, IntType));
+    EXPECT_NE(builder.getInt(2, IntType), builder.getInt(3, IntType));
+
+    InstrId ret = function.terminator(entry);
+    ASSERT_NE(ret, NoInstr);
+    EXPECT_EQ(function.operand(ret, 0), twice);
+    EXPECT_NE(function.toString().find("mul"), std::string::npos);
+}
+
+TEST(IRTest, ReplaceAllUsesWithRewritesEveryUser) {
+    IRFunction function("f", IntType, {IntType});
+    IRBuilder builder(function);
+    builder.setInsertPoint(builder.createBlock("entry"));
+
+    ValueId x = function.parameter(0);
+    ValueId zero = builder.getInt(0, IntType);
+    ValueId add = builder.createBinary(IROpcode::Add, x, zero, IntType);
+    ValueId mul = builder.createBinary(IROpcode::Mul, add, add, IntType);
+    builder.createReturn(add);
+
+    EXPECT_EQ(function.useCount(add), 3u);
+    function.replaceAllUsesWith(add, x);
+
+    EXPECT_FALSE(function.hasUses(add));
+    EXPECT_EQ(function.useCount(x), 4u);
+    InstrId mulInst = function.definingInstruction(mul);
+    EXPECT_EQ(function.operand(mulInst, 0), x);
+    EXPECT_EQ(function.operand(mulInst, 1), x);
+
+    // Borrar la instrucción muerta durante la iteración del bloque
+    size_t visited = 0;
+    for (InstrId id : function.instructions(0)) {
+        ++visited;
+        if (function.instruction(id).result == add) {
+            function.erase(id);
+        }
+    }
+    EXPECT_EQ(visited, 3u);
+    EXPECT_EQ(function.instructionCount(), 2u);
+    EXPECT_EQ(function.useCount(zero), 0u);
+}
+
+TEST(IRTest, PhiOperandsGrowAndKeepUseLists) {
+    IRFunction function("loop", IntType, {IntType});
+    IRBuilder builder(function);
+    BlockId entry = builder.createBlock("entry");
+    BlockId body = builder.createBlock("body");
+    BlockId exit = builder.createBlock("exit");
+
+    builder.setInsertPoint(entry);
+    builder.createBranch(body);
+
+    builder.setInsertPoint(body);
+    ValueId phi = builder.createPhi(IntType);
+    ValueId next = builder.createBinary(IROpcode::Add, phi, builder.getInt(1, IntType), IntType);
+    ValueId done = builder.createBinary(IROpcode::CmpGE, next, function.parameter(0), IntType);
+    builder.createConditionalBranch(done, exit, body);
+    builder.addIncoming(phi, builder.getInt(0, IntType), entry);
+    builder.addIncoming(phi, next, body);
+    builder.addIncoming(phi, next, body);   // fuerza la reubicación de operandos
+
+    builder.setInsertPoint(exit);
+    builder.createReturn(next);
+
+    InstrId phiInst = function.definingInstruction(phi);
+    EXPECT_EQ(function.operandCount(phiInst), 6u);
+    EXPECT_EQ(function.useCount(next), 4u);
+
+    function.removeOperand(phiInst, 5);
+    function.removeOperand(phiInst, 4);
+    EXPECT_EQ(function.operandCount(phiInst), 4u);
+    EXPECT_EQ(function.useCount(next), 3u);
+    EXPECT_EQ(function.operand(phiInst, 3), function.blockLabel(body));
+
+    std::vector<BlockId> successors;
+    function.successors(body, successors);
+    EXPECT_EQ(successors, (std::vector<BlockId>{exit, body}));
+}
+
+TEST(IRTest, InvokeAndLandingPadUseSideTables) {
+    IRFunction function("g", IntType, {});
+    IRBuilder builder(function);
+    ExceptionHandler handler;
+    ExceptionIRBuilder exceptions(builder, handler);
+
+    BlockId entry = builder.createBlock("entry");
+    BlockId normal = builder.createBlock("normal");
+    BlockId pad = exceptions.createLandingPadBlock(1);
+
+    builder.setInsertPoint(entry);
+    ValueId callee = builder.getGlobal("may_throw", TypeInfo(IRType::Function, 8, 8, "fn"));
+    ValueId result = exceptions.createInvoke(callee, {}, IntType, normal, pad);
+    ASSERT_NE(result, NoValue);
+
+    std::vector<BlockId> successors;
+    function.successors(entry, successors);
+    EXPECT_EQ(successors, (std::vector<BlockId>{normal, pad}));
+
+    InstrId landingPad = function.block(pad).first;
+    ASSERT_NE(landingPad, NoInstr);
+    EXPECT_EQ(function.instruction(landingPad).opcode, IROpcode::LandingPad);
+    const LandingPadInfo* info = handler.getLandingPadInfo(landingPad);
+    ASSERT_NE(info, nullptr);
+    EXPECT_EQ(info->catchTypes, std::vector<std::string>{"..."});
+}
+
+TEST(IRTest, TailCallsSurviveTextAndSerialization) {
+    IRModule module("unit");
+    auto function = std::make_unique<IRFunction>("forward", IntType, std::vector<TypeInfo>{IntType});
+    function->addParameter("x", IntType);
+    IRBuilder builder(*function);
+    builder.setInsertPoint(builder.createBlock("entry"));
+    ValueId args[] = {function->parameter(0)};
+    InstrId call = builder.createTailCall(builder.getGlobal("next", IntType), args, IntType);
+    ASSERT_TRUE(function->instruction(call).tail);
+    InstrId ret = function->instruction(call).next;
+    ASSERT_NE(ret, NoInstr);
+    EXPECT_EQ(function->instruction(ret).opcode, IROpcode::Ret);
+    EXPECT_EQ(function->operand(ret, 0), function->instruction(call).result);
+    EXPECT_NE(function->toString().find("tail call"), std::string::npos);
+    module.addFunction(std::move(function));
+
+    std::vector<uint8_t> bytes;
+    serializeModule(module, bytes);
+    auto restored = deserializeModule(bytes);
+    ASSERT_NE(restored, nullptr);
+    const IRFunction& copy = *restored->getFunctions()[0];
+    EXPECT_TRUE(copy.instruction(copy.block(0).first).tail);
+    EXPECT_FALSE(copy.instruction(copy.block(0).last).tail);
+}
+
+TEST(IRTest, SerializedModuleRoundTrips) {
+    const TypeInfo DoubleType(IRType::Double, 8, 8, "double");
+    IRModule module("unit");
+    module.addGlobalVariable(std::make_unique<IRGlobalVariable>("counter", IntType, IRConstant{-3, 0.0}));
+    module.addClass({"Shape", "vtable.Shape", {}, {{"Shape::area", true}}, false});
+    module.addInitializer("setup");
+
+    auto function = std::make_unique<IRFunction>("loop", IntType, std::vector<TypeInfo>{});
+    function->addParameter("n", IntType);
+    function->setLinkage(Linkage::LinkOnce);
+    function->setTargetClones({"avx2", "default"});
+    function->setTarget("sse4.1");
+    IRBuilder builder(*function);
+    BlockId entry = builder.createBlock("entry");
+    BlockId body = builder.createBlock("body");
+    BlockId exit = builder.createBlock("exit");
+
+    builder.setInsertPoint(entry);
+    builder.createBranch(body);
+    builder.setInsertPoint(body);
+    ValueId phi = builder.createPhi(IntType);
+    ValueId next = builder.createBinary(IROpcode::Add, phi, builder.getInt(-1, IntType), IntType);
+    ValueId scaled = builder.createCast(IROpcode::SIToFP, next, DoubleType);
+    ValueId args[] = {builder.createBinary(IROpcode::Mul, scaled, builder.getFloat(0.5, DoubleType), DoubleType)};
+    builder.createCall(builder.getGlobal("report", IntType), args, TypeInfo());
+    ValueId done = builder.createBinary(IROpcode::CmpGE, next, function->parameter(0), IntType);
+    builder.createConditionalBranch(done, exit, body);
+    builder.addIncoming(phi, builder.getInt(0, IntType), entry);
+    builder.addIncoming(phi, next, body);      // Uso anterior a la definición
+    builder.setInsertPoint(exit);
+    builder.createReturn(next);
+    module.addFunction(std::move(function));
+
+    std::vector<uint8_t> bytes;
+    serializeModule(module, bytes);
+    auto restored = deserializeModule(bytes);
+    ASSERT_NE(restored, nullptr);
+
+    std::vector<uint8_t> again;
+    serializeModule(*restored, again);
+    EXPECT_EQ(again, bytes);
+
+    EXPECT_EQ(restored->getName(), "unit");
+    ASSERT_EQ(restored->getGlobals().size(), 1u);
+    EXPECT_EQ(restored->getGlobals()[0]->getInitializer()->intValue, -3);
+    ASSERT_EQ(restored->getClasses().size(), 1u);
+    EXPECT_TRUE(restored->getClasses()[0].virtualMethods[0].isFinal);
+    EXPECT_EQ(restored->getInitializers(), std::vector<std::string>{"setup"});
+
+    const IRFunction& copy = *restored->getFunctions()[0];
+    EXPECT_EQ(copy.getLinkage(), Linkage::LinkOnce);
+    EXPECT_EQ(copy.getTargetClones(), (std::vector<std::string>{"avx2", "default"}));
+    EXPECT_EQ(copy.getTarget(), "sse4.1");
+    EXPECT_NE(copy.toString().find("target_clones(\"avx2\", \"default\")"), std::string::npos);
+    EXPECT_EQ(copy.getParamNames()[0], "n");
+    EXPECT_EQ(copy.blockCount(), 3u);
+    EXPECT_EQ(copy.instructionCount(), 9u);
+    InstrId copiedPhi = copy.block(body).first;
+    ValueId incoming = copy.operand(copiedPhi, 2);
+    EXPECT_EQ(copy.instruction(copy.definingInstruction(incoming)).opcode, IROpcode::Add);
+    EXPECT_EQ(copy.operand(copy.definingInstruction(incoming), 0), copy.instruction(copiedPhi).result);
+
+    // Cualquier truncado se rechaza
+    for (size_t size = 0; size < bytes.size(); ++size) {
+        EXPECT_EQ(deserializeModule(std::span(bytes.data(), size)), nullptr) << size;
+    }
+}
@@ -0,0 +1,1536 @@
+/**
+ * @file test_ir_passes.cpp
+ * @brief Tests para los pases de optimización de la IR
+ */
+
+#include <compiler/ir/IRPasses.h>
+#include <compiler/ir/IRAnalysis.h>
+#include <compiler/ir/Profile.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+using namespace cpp20::compiler::ir;
+
+namespace {
+
+const TypeInfo IntType(IRType::Int, 4, 4, "i32");
+const TypeInfo BoolType(IRType::Bool, 1, 1, "bool");
+
+size_t countOpcode(const IRFunction& function, IROpcode opcode) {
+    size_t count = 0;
+    for (BlockId block = 0; block < function.blockCount(); ++block) {
+        for (InstrId id : function.instructions(block)) {
+            if (function.instruction(id).opcode == opcode) ++count;
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+TEST(IRAnalysisTest, DominatorsOfDiamond) {
+    IRFunction function("f", IntType, {BoolType});
+    IRBuilder builder(function);
+    BlockId entry = builder.createBlock("entry");
+    BlockId left = builder.createBlock("left");
+    BlockId right = builder.createBlock("right");
+    BlockId merge = builder.createBlock("merge");
+
+    builder.setInsertPoint(entry);
+    builder.createConditionalBranch(function.parameter(0), left, right);
+    builder.setInsertPoint(left);
+    builder.createBranch(merge);
+    builder.setInsertPoint(right);
+    builder.createBranch(merge);
+    builder.setInsertPoint(merge);
+    builder.createReturn(builder.getInt(0, IntType));
+
+    ControlFlowGraph cfg(function);
+    DominatorTree domTree(cfg);
+    EXPECT_EQ(domTree.idom(merge), entry);
+    EXPECT_TRUE(domTree.dominates(entry, merge));
+    EXPECT_FALSE(domTree.dominates(left, merge));
+
+    auto frontiers = domTree.dominanceFrontiers(cfg);
+    EXPECT_EQ(frontiers[left], std::vector<BlockId>{merge});
+    EXPECT_TRUE(frontiers[entry].empty());
+}
+
+TEST(IRPassesTest, Mem2RegBuildsPhisForLoopVariable) {
+    // int f(int n) { int i = 0; while (i < n) i = i + 1; return i; }
+    IRFunction function("f", IntType, {IntType});
+    IRBuilder builder(function);
+    BlockId entry = builder.createBlock("entry");
+    BlockId header = builder.createBlock("header");
+    BlockId body = builder.createBlock("body");
+    BlockId exit = builder.createBlock("exit");
+
+    builder.setInsertPoint(entry);
+    ValueId slot = builder.createAlloca(IntType);
+    builder.createStore(builder.getInt(0, IntType), slot);
+    builder.createBranch(header);
+
+    builder.setInsertPoint(header);
+    ValueId i = builder.createLoad(slot, IntType);
+    ValueId cond = builder.createBinary(IROpcode::CmpLT, i, function.parameter(0), BoolType);
+    builder.createConditionalBranch(cond, body, exit);
+
+    builder.setInsertPoint(body);
+    ValueId current = builder.createLoad(slot, IntType);
+    builder.createStore(builder.createBinary(IROpcode::Add, current, builder.getInt(1, IntType), IntType), slot);
+    builder.createBranch(header);
+
+    builder.setInsertPoint(exit);
+    builder.createReturn(builder.createLoad(slot, IntType));
+
+    Mem2RegPass mem2reg;
+    EXPECT_TRUE(mem2reg.run(function));
+    EXPECT_EQ(countOpcode(function, IROpcode::Alloca), 0u);
+    EXPECT_EQ(countOpcode(function, IROpcode::Load), 0u);
+    EXPECT_EQ(countOpcode(function, IROpcode::Store), 0u);
+
+    InstrId phi = function.block(header).first;
+    ASSERT_EQ(function.instruction(phi).opcode, IROpcode::Phi);
+    EXPECT_EQ(function.operandCount(phi), 4u);
+    EXPECT_EQ(function.operand(function.terminator(exit), 0), function.instruction(phi).result);
+
+    // Nada más que hacer en una segunda pasada
+    EXPECT_FALSE(mem2reg.run(function));
+}
+
+TEST(IRPassesTest, SCCPFoldsConstantBranches) {
+    // x = 2 + 3; if (x > 4) return x * 2; else return 0;
+    IRFunction function("g", IntType, {});
+    IRBuilder builder(function);
+    BlockId entry = builder.createBlock("entry");
+    BlockId then = builder.createBlock("then");
+    BlockId otherwise = builder.createBlock("else");
+
+    builder.setInsertPoint(entry);
+    ValueId x = builder.createBinary(IROpcode::Add, builder.getInt(2, IntType), builder.getInt(3, IntType), IntType);
+    ValueId cond = builder.createBinary(IROpcode::CmpGT, x, builder.getInt(4, IntType), BoolType);
+    builder.createConditionalBranch(cond, then, otherwise);
+
+    builder.setInsertPoint(then);
+    builder.createReturn(builder.createBinary(IROpcode::Mul, x, builder.getInt(2, IntType), IntType));
+
+    builder.setInsertPoint(otherwise);
+    builder.createReturn(builder.getInt(0, IntType));
+
+    PassManager manager = PassManager::createForOptimizationLevel(2);
+    EXPECT_TRUE(manager.run(function));
+
+    EXPECT_EQ(function.instruction(function.terminator(entry)).opcode, IROpcode::Br);
+    EXPECT_EQ(function.block(otherwise).first, NoInstr);
+
+    const IRConstant* result = function.constant(function.operand(function.terminator(then), 0));
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(result->intValue, 10);
+}
+
+TEST(IRPassesTest, SCCPDoesNotFoldDivisionByZero) {
+    IRFunction function("h", IntType, {});
+    IRBuilder builder(function);
+    builder.setInsertPoint(builder.createBlock("entry"));
+    ValueId div = builder.createBinary(IROpcode::Div, builder.getInt(1, IntType), builder.getInt(0, IntType), IntType);
+    ValueId wrap = builder.createBinary(IROpcode::Add, builder.getInt(0x7fffffff, IntType), builder.getInt(1, IntType), IntType);
+    builder.createReturn(builder.createBinary(IROpcode::Add, div, wrap, IntType));
+
+    SCCPPass sccp;
+    sccp.run(function);
+    EXPECT_EQ(countOpcode(function, IROpcode::Div), 1u);
+
+    // El Add que desborda se plegó con el ancho de 32 bits
+    InstrId ret = function.terminator(0);
+    InstrId sum = function.definingInstruction(function.operand(ret, 0));
+    const IRConstant* folded = function.constant(function.operand(sum, 1));
+    ASSERT_NE(folded, nullptr);
+    EXPECT_EQ(folded->intValue, -2147483648LL);
+}
+
+TEST(IRPassesTest, GVNRemovesRedundantExpressions) {
+    IRFunction function("k", IntType, {IntType, IntType});
+    IRBuilder builder(function);
+    builder.setInsertPoint(builder.createBlock("entry"));
+    ValueId a = function.parameter(0);
+    ValueId b = function.parameter(1);
+    ValueId first = builder.createBinary(IROpcode::Add, a, b, IntType);
+    ValueId second = builder.createBinary(IROpcode::Add, b, a, IntType);
+    ValueId diff1 = builder.createBinary(IROpcode::Sub, a, b, IntType);
+    ValueId diff2 = builder.createBinary(IROpcode::Sub, b, a, IntType);
+    ValueId total = builder.createBinary(IROpcode::Mul, first, second, IntType);
+    ValueId all = builder.createBinary(IROpcode::Add, total, builder.createBinary(IROpcode::Add, diff1, diff2, IntType), IntType);
+    builder.createReturn(all);
+
+    GVNPass gvn;
+    EXPECT_TRUE(gvn.run(function));
+    EXPECT_EQ(countOpcode(function, IROpcode::Add), 3u);
+    EXPECT_EQ(countOpcode(function, IROpcode::Sub), 2u);   // a - b y b - a no son iguales
+    InstrId mul = function.definingInstruction(total);
+    EXPECT_EQ(function.operand(mul, 0), function.operand(mul, 1));
+}
+
+TEST(IRPassesTest, DCERemovesDeadPhiCycles) {
+    IRFunction function("loop", IntType, {IntType});
+    IRBuilder builder(function);
+    BlockId entry = builder.createBlock("entry");
+    BlockId header = builder.createBlock("header");
+    BlockId exit = builder.createBlock("exit");
+
+    builder.setInsertPoint(entry);
+    builder.createBranch(header);
+
+    builder.setInsertPoint(header);
+    ValueId counter = builder.createPhi(IntType);
+    ValueId unused = builder.createPhi(IntType);
+    ValueId next = builder.createBinary(IROpcode::Add, counter, builder.getInt(1, IntType), IntType);
+    ValueId nextUnused = builder.createBinary(IROpcode::Mul, unused, builder.getInt(3, IntType), IntType);
+    ValueId done = builder.createBinary(IROpcode::CmpGE, next, function.parameter(0), BoolType);
+    builder.createConditionalBranch(done, exit, header);
+    builder.addIncoming(counter, builder.getInt(0, IntType), entry);
+    builder.addIncoming(counter, next, header);
+    builder.addIncoming(unused, builder.getInt(1, IntType), entry);
+    builder.addIncoming(unused, nextUnused, header);
+
+    builder.setInsertPoint(exit);
+    builder.createReturn(next);
+
+    DeadCodeEliminationPass dce;
+    EXPECT_TRUE(dce.run(function));
+    EXPECT_EQ(countOpcode(function, IROpcode::Phi), 1u);
+    EXPECT_EQ(countOpcode(function, IROpcode::Mul), 0u);
+    EXPECT_EQ(function.instructionCount(), 6u);
+}
+
+TEST(IRPassesTest, PipelineDependsOnOptimizationLevel) {
+    // La multiversión no es opcional: también a -O0
+    EXPECT_EQ(PassManager::createForOptimizationLevel(0).getPassCount(), 1u);
+    EXPECT_EQ(PassManager::createForOptimizationLevel(1).getPassCount(), 9u);
+
+    PassManager manager = PassManager::createForOptimizationLevel(2);
+    ASSERT_EQ(manager.getPassCount(), 19u);
+    auto stats = manager.getStats();
+    EXPECT_EQ(stats[0].name, "multiversion");
+    EXPECT_EQ(stats[1].name, "devirtualize");
+    EXPECT_EQ(stats[2].name, "inline");
+    EXPECT_EQ(stats[3].name, "mem2reg");
+    EXPECT_EQ(stats[4].name, "bit-intrinsics");
+    EXPECT_EQ(stats[6].name, "gvn");
+    EXPECT_EQ(stats[7].name, "licm");
+    EXPECT_EQ(stats.back().name, "eh-cold-layout");
+}
+
+namespace {
+
+/**
+ * @brief int abs(int x) { int r; if (x < 0) r = -x; else r = x; return r; }
+ *
+ * Generada como en -O0: la variable local vive en un alloca.
+ */
+std::unique_ptr<IRFunction> makeAbs() {
+    auto function = std::make_unique<IRFunction>("abs", IntType, std::vector<TypeInfo>{IntType});
+    IRBuilder builder(*function);
+    BlockId entry = builder.createBlock("entry");
+    BlockId negative = builder.createBlock("negative");
+    BlockId positive = builder.createBlock("positive");
+    BlockId done = builder.createBlock("done");
+
+    builder.setInsertPoint(entry);
+    ValueId r = builder.createAlloca(IntType);
+    ValueId x = function->parameter(0);
+    builder.createConditionalBranch(builder.createBinary(IROpcode::CmpLT, x, builder.getInt(0, IntType), BoolType),
+                                    negative, positive);
+    builder.setInsertPoint(negative);
+    builder.createStore(builder.createUnary(IROpcode::Neg, x, IntType), r);
+    builder.createBranch(done);
+    builder.setInsertPoint(positive);
+    builder.createStore(x, r);
+    builder.createBranch(done);
+    builder.setInsertPoint(done);
+    builder.createReturn(builder.createLoad(r, IntType));
+    return function;
+}
+
+/**
+ * @brief Función hoja con count sumas encadenadas sobre su parámetro
+ */
+std::unique_ptr<IRFunction> makeChain(const std::string& name, int count) {
+    auto function = std::make_unique<IRFunction>(name, IntType, std::vector<TypeInfo>{IntType});
+    IRBuilder builder(*function);
+    builder.setInsertPoint(builder.createBlock("entry"));
+    ValueId value = function->parameter(0);
+    for (int i = 0; i < count; ++i) {
+        value = builder.createBinary(IROpcode::Mul, value, function->parameter(0), IntType);
+    }
+    builder.createReturn(value);
+    return function;
+}
+
+/**
+ * @brief int name(int a) { return callee(argument); } con argument = a o una constante
+ */
+std::unique_ptr<IRFunction> makeCaller(const std::string& name, const std::string& callee,
+                                       std::optional<int64_t> constantArgument = std::nullopt) {
+    auto function = std::make_unique<IRFunction>(name, IntType, std::vector<TypeInfo>{IntType});
+    IRBuilder builder(*function);
+    builder.setInsertPoint(builder.createBlock("entry"));
+    ValueId argument = constantArgument ? builder.getInt(*constantArgument, IntType) : function->parameter(0);
+    ValueId args[] = {argument};
+    ValueId result = builder.createCall(builder.getGlobal(callee, TypeInfo(IRType::Function, 8, 8, "fn")),
+                                        args, IntType);
+    builder.createReturn(result);
+    return function;
+}
+
+} // namespace
+
+TEST(InlinerTest, InlinesAndFoldsThroughTheScalarPipeline) {
+    IRModule module("m");
+    module.addFunction(makeAbs());
+    module.addFunction(makeCaller("five", "abs", -5));
+
+    PassManager manager = PassManager::createForOptimizationLevel(2);
+    EXPECT_TRUE(manager.run(module));
+
+    const IRFunction& five = *module.getFunctions()[1];
+    EXPECT_EQ(countOpcode(five, IROpcode::Call), 0u);
+    EXPECT_EQ(countOpcode(five, IROpcode::Alloca), 0u);
+    EXPECT_EQ(countOpcode(five, IROpcode::Phi), 0u);
+
+    // El único ret devuelve la constante 5
+    bool found = false;
+    for (BlockId block = 0; block < five.blockCount(); ++block) {
+        InstrId term = five.terminator(block);
+        if (term == NoInstr || five.instruction(term).opcode != IROpcode::Ret) continue;
+        const IRConstant* value = five.constant(five.operand(term, 0));
+        ASSERT_NE(value, nullptr);
+        EXPECT_EQ(value->intValue, 5);
+        found = true;
+    }
+    EXPECT_TRUE(found);
+}
+
+TEST(InlinerTest, MultipleReturnsMergeIntoPhi) {
+    auto abs = makeAbs();
+    Mem2RegPass().run(*abs);    // Dos caminos que acaban en un ret con phi
+
+    auto caller = makeCaller("f", "abs");
+    InstrId call = caller->definingInstruction(caller->operand(caller->terminator(0), 0));
+    ASSERT_TRUE(InlinerPass::inlineCall(*caller, call, *abs));
+
+    EXPECT_EQ(countOpcode(*caller, IROpcode::Call), 0u);
+    EXPECT_EQ(countOpcode(*caller, IROpcode::Ret), 1u);
+    EXPECT_EQ(countOpcode(*caller, IROpcode::Neg), 1u);
+    EXPECT_EQ(caller->instruction(caller->terminator(0)).opcode, IROpcode::Br);
+}
+
+TEST(InlinerTest, CostModelHonorsHintsAndSize) {
+    IRModule module("m");
+    module.addFunction(makeChain("tiny", 2));
+    module.addFunction(makeChain("big", 60));
+    module.addFunction(makeChain("hinted", 60));
+    module.addFunction(makeChain("never", 2));
+    module.getFunctions()[2]->setInlineHint(InlineHint::Inline);
+    module.getFunctions()[3]->setInlineHint(InlineHint::Never);
+    for (const char* callee : {"tiny", "big", "hinted", "never"}) {
+        module.addFunction(makeCaller(std::string("call_") + callee, callee));
+    }
+
+    InlinerPass inliner(InlineCostModel::forOptimizationLevel(2));
+    EXPECT_TRUE(inliner.run(module));
+    EXPECT_EQ(inliner.getInlinedCount(), 2u);
+
+    const auto& functions = module.getFunctions();
+    EXPECT_EQ(countOpcode(*functions[4], IROpcode::Call), 0u);     // hoja trivial
+    EXPECT_EQ(countOpcode(*functions[5], IROpcode::Call), 1u);     // demasiado grande
+    EXPECT_EQ(countOpcode(*functions[6], IROpcode::Call), 0u);     // inline
+    EXPECT_EQ(countOpcode(*functions[7], IROpcode::Call), 1u);     // noinline
+
+    // A -O1 solo se integran las hojas triviales
+    IRModule small("s");
+    small.addFunction(makeChain("medium", 20));
+    small.addFunction(makeCaller("call_medium", "medium"));
+    InlinerPass conservative(InlineCostModel::forOptimizationLevel(1));
+    EXPECT_FALSE(conservative.run(small));
+}
+
+TEST(InlinerTest, SkipsDirectRecursion) {
+    IRModule module("m");
+    module.addFunction(makeCaller("self", "self"));
+
+    InlinerPass inliner(InlineCostModel::forOptimizationLevel(3));
+    EXPECT_FALSE(inliner.run(module));
+    EXPECT_EQ(countOpcode(*module.getFunctions()[0], IROpcode::Call), 1u);
+}
+
+namespace {
+
+const TypeInfo CodeType(IRType::Pointer, 8, 8, "code*");
+
+/**
+ * @brief struct Shape { virtual int area() = 0; virtual int sides(); };
+ *        struct Square : Shape { int area() override; };
+ *        struct Circle final : Shape { int area() override; int sides() override; };
+ */
+void addShapes(IRModule& module) {
+    module.addClass({"Shape", "vtable.Shape", {}, {{"", false}, {"Shape::sides", false}}, false});
+    module.addClass({"Square", "vtable.Square", {"Shape"}, {{"Square::area", false}, {"Shape::sides", false}}, false});
+    module.addClass({"Circle", "vtable.Circle", {"Shape"}, {{"Circle::area", false}, {"Circle::sides", false}}, true});
+}
+
+/**
+ * @brief int call(T* object) { return object->slot(); }
+ *
+ * Con vtable, el objeto se construye antes en la función (store del vptr).
+ */
+std::unique_ptr<IRFunction> makeVirtualCall(const std::string& className, int64_t slot,
+                                            const std::string& vtable = "") {
+    TypeInfo objectType(IRType::Pointer, 8, 8, className + "*");
+    auto function = std::make_unique<IRFunction>("call", IntType, std::vector<TypeInfo>{objectType});
+    IRBuilder builder(*function);
+    builder.setInsertPoint(builder.createBlock("entry"));
+
+    ValueId object = function->parameter(0);
+    if (!vtable.empty()) builder.createStore(builder.getGlobal(vtable, CodeType), object);
+    ValueId vptr = builder.createLoad(object, CodeType);
+    ValueId slotAddress = builder.createBinary(IROpcode::GetElementPtr, vptr, builder.getInt(slot, IntType),
+                                               CodeType);
+    ValueId pointer = builder.createLoad(slotAddress, CodeType);
+    ValueId args[] = {object};
+    ValueId result = builder.createCall(pointer, args, IntType);
+    builder.createReturn(result);
+    return function;
+}
+
+const std::string* calleeName(const IRFunction& function) {
+    for (BlockId block = 0; block < function.blockCount(); ++block) {
+        for (InstrId id : function.instructions(block)) {
+            if (function.instruction(id).opcode != IROpcode::Call) continue;
+            ValueId target = function.operand(id, 0);
+            if (function.value(target).kind == ValueKind::Global) return &function.globalName(target);
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+TEST(DevirtualizeTest, FinalClassAndKnownDynamicTypeCallDirectly) {
+    IRModule module("m");
+    addShapes(module);
+    module.addFunction(makeVirtualCall("Circle", 0));                  // clase final
+    module.addFunction(makeVirtualCall("Shape", 1, "vtable.Square"));  // tipo dinámico conocido
+    module.addFunction(makeVirtualCall("Shape", 0));                   // sin información
+
+    DevirtualizePass devirtualize;
+    EXPECT_TRUE(devirtualize.run(module));
+    EXPECT_EQ(devirtualize.getDevirtualizedCount(), 2u);
+    EXPECT_EQ(devirtualize.getGuardedCount(), 0u);
+
+    const auto& functions = module.getFunctions();
+    ASSERT_NE(calleeName(*functions[0]), nullptr);
+    EXPECT_EQ(*calleeName(*functions[0]), "Circle::area");
+    ASSERT_NE(calleeName(*functions[1]), nullptr);
+    EXPECT_EQ(*calleeName(*functions[1]), "Shape::sides");
+    EXPECT_EQ(calleeName(*functions[2]), nullptr);
+}
+
+TEST(DevirtualizeTest, WholeProgramGuardsSingleImplementation) {
+    IRModule module("m");
+    module.addClass({"Shape", "vtable.Shape", {}, {{"", false}}, false});
+    module.addClass({"Square", "vtable.Square", {"Shape"}, {{"Square::area", false}}, false});
+    module.addFunction(makeVirtualCall("Shape", 0));
+
+    DevirtualizePass separate;
+    EXPECT_FALSE(separate.run(module));
+
+    DevirtualizePass whole(true);
+    EXPECT_TRUE(whole.run(module));
+    EXPECT_EQ(whole.getGuardedCount(), 1u);
+
+    // El resultado llega por un phi desde la llamada directa y la indirecta de respaldo
+    const IRFunction& function = *module.getFunctions()[0];
+    EXPECT_EQ(function.blockCount(), 4u);
+    EXPECT_EQ(countOpcode(function, IROpcode::CmpEQ), 1u);
+    EXPECT_EQ(countOpcode(function, IROpcode::Call), 2u);
+    EXPECT_EQ(countOpcode(function, IROpcode::Phi), 1u);
+    ASSERT_NE(calleeName(function), nullptr);
+    EXPECT_EQ(*calleeName(function), "Square::area");
+
+    InstrId ret = function.terminator(1);     // devirt.cont
+    ASSERT_NE(ret, NoInstr);
+    EXPECT_EQ(function.instruction(ret).opcode, IROpcode::Ret);
+    EXPECT_EQ(function.instruction(function.definingInstruction(function.operand(ret, 0))).opcode, IROpcode::Phi);
+
+    // Con dos implementaciones no hay protección posible
+    IRModule shapes("s");
+    addShapes(shapes);
+    shapes.addFunction(makeVirtualCall("Shape", 0));
+    EXPECT_FALSE(DevirtualizePass(true).run(shapes));
+}
+
+namespace {
+
+/**
+ * @brief int loop(int n, int x, int y) {
+ *            int s = 0;
+ *            for (int i = 0; i < bound; ++i) s += i * 3 + x * y;
+ *            return s;
+ *        }
+ *
+ * Ya en SSA. Sin bound el límite es el parámetro n.
+ */
+std::unique_ptr<IRFunction> makeCountedLoop(std::optional<int64_t> bound = std::nullopt) {
+    auto function = std::make_unique<IRFunction>("loop", IntType,
+                                                 std::vector<TypeInfo>{IntType, IntType, IntType});
+    IRBuilder builder(*function);
+    BlockId entry = builder.createBlock("entry");
+    BlockId header = builder.createBlock("header");
+    BlockId body = builder.createBlock("body");
+    BlockId exit = builder.createBlock("exit");
+
+    builder.setInsertPoint(entry);
+    builder.createBranch(header);
+
+    builder.setInsertPoint(header);
+    ValueId i = builder.createPhi(IntType);
+    ValueId s = builder.createPhi(IntType);
+    ValueId limit = bound ? builder.getInt(*bound, IntType) : function->parameter(0);
+    ValueId cond = builder.createBinary(IROpcode::CmpLT, i, limit, BoolType);
+    builder.createConditionalBranch(cond, body, exit);
+
+    builder.setInsertPoint(body);
+    ValueId scaled = builder.createBinary(IROpcode::Mul, i, builder.getInt(3, IntType), IntType);
+    ValueId product = builder.createBinary(IROpcode::Mul, function->parameter(1),
+                                           function->parameter(2), IntType);
+    ValueId term = builder.createBinary(IROpcode::Add, scaled, product, IntType);
+    ValueId sum = builder.createBinary(IROpcode::Add, s, term, IntType);
+    ValueId next = builder.createBinary(IROpcode::Add, i, builder.getInt(1, IntType), IntType);
+    builder.createBranch(header);
+
+    builder.addIncoming(i, builder.getInt(0, IntType), entry);
+    builder.addIncoming(i, next, body);
+    builder.addIncoming(s, builder.getInt(0, IntType), entry);
+    builder.addIncoming(s, sum, body);
+
+    builder.setInsertPoint(exit);
+    builder.createReturn(s);
+    return function;
+}
+
+size_t countOpcodeInLoops(const IRFunction& function, IROpcode opcode) {
+    ControlFlowGraph cfg(function);
+    DominatorTree domTree(cfg);
+    LoopInfo loops(cfg, domTree);
+    size_t count = 0;
+    for (BlockId block = 0; block < function.blockCount(); ++block) {
+        if (loops.loopFor(block) == NoLoop) continue;
+        for (InstrId id : function.instructions(block)) {
+            if (function.instruction(id).opcode == opcode) ++count;
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+TEST(IRAnalysisTest, FindsNestedLoops) {
+    IRFunction function("nest", IntType, {BoolType, BoolType});
+    IRBuilder builder(function);
+    BlockId entry = builder.createBlock("entry");
+    BlockId outer = builder.createBlock("outer");
+    BlockId inner = builder.createBlock("inner");
+    BlockId latch = builder.createBlock("latch");
+    BlockId exit = builder.createBlock("exit");
+
+    builder.setInsertPoint(entry);
+    builder.createBranch(outer);
+    builder.setInsertPoint(outer);
+    builder.createConditionalBranch(function.parameter(0), inner, exit);
+    builder.setInsertPoint(inner);
+    builder.createConditionalBranch(function.parameter(1), inner, latch);
+    builder.setInsertPoint(latch);
+    builder.createBranch(outer);
+    builder.setInsertPoint(exit);
+    builder.createReturn(builder.getInt(0, IntType));
+
+    ControlFlowGraph cfg(function);
+    DominatorTree domTree(cfg);
+    LoopInfo loops(cfg, domTree);
+
+    ASSERT_EQ(loops.loops().size(), 2u);
+    const Loop& innerLoop = loops.loops()[0];
+    const Loop& outerLoop = loops.loops()[1];
+    EXPECT_EQ(innerLoop.header, inner);
+    EXPECT_EQ(innerLoop.parent, 1u);
+    EXPECT_EQ(innerLoop.latches, std::vector<BlockId>{inner});
+    EXPECT_EQ(outerLoop.header, outer);
+    EXPECT_EQ(outerLoop.blocks, (std::vector<BlockId>{outer, inner, latch}));
+
+    EXPECT_EQ(loops.loopFor(inner), 0u);
+    EXPECT_EQ(loops.loopFor(latch), 1u);
+    EXPECT_EQ(loops.loopFor(exit), NoLoop);
+    EXPECT_EQ(loops.depth(inner), 2u);
+    EXPECT_TRUE(loops.contains(1, inner));
+    EXPECT_EQ(loops.preheader(cfg, 1), entry);
+    EXPECT_EQ(loops.preheader(cfg, 0), NoBlock);     // outer tiene dos sucesores
+}
+
+TEST(LoopPassesTest, LICMHoistsInvariantProduct) {
+    auto function = makeCountedLoop();
+    LICMPass licm;
+    EXPECT_TRUE(licm.run(*function));
+
+    // x * y sale del bucle; i * 3 depende de la variable de inducción
+    EXPECT_EQ(countOpcode(*function, IROpcode::Mul), 2u);
+    EXPECT_EQ(countOpcodeInLoops(*function, IROpcode::Mul), 1u);
+    EXPECT_FALSE(licm.run(*function));
+}
+
+TEST(LoopPassesTest, LICMCreatesPreheaderForSeveralEntries) {
+    IRFunction function("f", IntType, {BoolType, IntType});
+    IRBuilder builder(function);
+    BlockId entry = builder.createBlock("entry");
+    BlockId side = builder.createBlock("side");
+    BlockId header = builder.createBlock("header");
+    BlockId exit = builder.createBlock("exit");
+
+    builder.setInsertPoint(entry);
+    builder.createConditionalBranch(function.parameter(0), side, header);
+    builder.setInsertPoint(side);
+    builder.createBranch(header);
+
+    builder.setInsertPoint(header);
+    ValueId k = builder.createPhi(IntType);
+    ValueId doubled = builder.createBinary(IROpcode::Add, function.parameter(1),
+                                           function.parameter(1), IntType);
+    ValueId more = builder.createBinary(IROpcode::CmpLT, k, doubled, BoolType);
+    builder.createConditionalBranch(more, header, exit);
+    builder.addIncoming(k, builder.getInt(1, IntType), entry);
+    builder.addIncoming(k, builder.getInt(2, IntType), side);
+    builder.addIncoming(k, doubled, header);
+
+    builder.setInsertPoint(exit);
+    builder.createReturn(k);
+
+    EXPECT_TRUE(LICMPass().run(function));
+    ASSERT_EQ(function.blockCount(), 5u);
+    BlockId preheader = 4;
+    EXPECT_EQ(countOpcodeInLoops(function, IROpcode::Add), 0u);
+
+    // Las dos entradas de fuera se reúnen en un phi del preheader
+    InstrId merged = function.block(preheader).first;
+    ASSERT_EQ(function.instruction(merged).opcode, IROpcode::Phi);
+    EXPECT_EQ(function.operandCount(merged), 4u);
+    EXPECT_EQ(function.operandCount(function.block(header).first), 4u);
+}
+
+TEST(LoopPassesTest, StrengthReductionReplacesMultiplyByInduction) {
+    auto function = makeCountedLoop();
+    EXPECT_TRUE(LoopStrengthReductionPass().run(*function));
+
+    // i * 3 pasa a ser una variable de inducción nueva con paso 3
+    EXPECT_EQ(countOpcodeInLoops(*function, IROpcode::Mul), 1u);    // solo x * y
+    EXPECT_EQ(countOpcode(*function, IROpcode::Phi), 3u);
+
+    SCCPPass().run(*function);
+    DeadCodeEliminationPass().run(*function);
+    EXPECT_EQ(countOpcode(*function, IROpcode::Mul), 1u);
+}
+
+TEST(LoopPassesTest, UnrollsConstantTripCount) {
+    auto function = makeCountedLoop(4);
+    EXPECT_TRUE(LoopUnrollPass().run(*function));
+    EXPECT_EQ(countOpcode(*function, IROpcode::Phi), 0u);
+    EXPECT_EQ(countOpcode(*function, IROpcode::BrCond), 0u);
+
+    // Las comparaciones y los i * 3 se pliegan; x * y queda una sola vez
+    SCCPPass().run(*function);
+    GVNPass().run(*function);
+    DeadCodeEliminationPass().run(*function);
+    EXPECT_EQ(countOpcode(*function, IROpcode::Mul), 1u);
+    EXPECT_EQ(countOpcode(*function, IROpcode::CmpLT), 0u);
+
+    // Demasiadas iteraciones para el límite
+    auto longer = makeCountedLoop(100);
+    EXPECT_FALSE(LoopUnrollPass().run(*longer));
+    EXPECT_EQ(countOpcode(*longer, IROpcode::Phi), 2u);
+}
+
+namespace {
+
+const TypeInfo FloatType(IRType::Float, 4, 4, "float");
+
+/**
+ * @brief void axpy(T* a, T* b, T* c, int n, T k) {
+ *            for (int i = 0; i < n; ++i) c[i] = a[i] + b[i] * k;
+ *        }
+ *
+ * Con indexStored, c[i] = i: el índice se usa como valor.
+ */
+std::unique_ptr<IRFunction> makeArrayLoop(const TypeInfo& element, bool indexStored = false) {
+    TypeInfo pointer(IRType::Pointer, 8, 8, element.typeName + "*");
+    auto function = std::make_unique<IRFunction>(
+        "axpy", TypeInfo(IRType::Void), std::vector<TypeInfo>{pointer, pointer, pointer, IntType, element});
+    IRBuilder builder(*function);
+    BlockId entry = builder.createBlock("entry");
+    BlockId header = builder.createBlock("header");
+    BlockId body = builder.createBlock("body");
+    BlockId exit = builder.createBlock("exit");
+
+    builder.setInsertPoint(entry);
+    builder.createBranch(header);
+
+    builder.setInsertPoint(header);
+    ValueId i = builder.createPhi(IntType);
+    ValueId cond = builder.createBinary(IROpcode::CmpLT, i, function->parameter(3), BoolType);
+    builder.createConditionalBranch(cond, body, exit);
+
+    builder.setInsertPoint(body);
+    auto address = [&](size_t param) {
+        ValueId ops[] = {function->parameter(param), i};
+        InstrId gep = function->append(body, IROpcode::GetElementPtr, pointer, ops, true);
+        return function->instruction(gep).result;
+    };
+    ValueId value = i;
+    if (!indexStored) {
+        ValueId a = builder.createLoad(address(0), element);
+        ValueId b = builder.createLoad(address(1), element);
+        ValueId scaled = builder.createBinary(IROpcode::Mul, b, function->parameter(4), element);
+        value = builder.createBinary(IROpcode::Add, a, scaled, element);
+    }
+    builder.createStore(value, address(2));
+    ValueId next = builder.createBinary(IROpcode::Add, i, builder.getInt(1, IntType), IntType);
+    builder.createBranch(header);
+
+    builder.addIncoming(i, builder.getInt(0, IntType), entry);
+    builder.addIncoming(i, next, body);
+
+    builder.setInsertPoint(exit);
+    builder.createReturn();
+    return function;
+}
+
+size_t countVectorOpcode(const IRFunction& function, IROpcode opcode, uint32_t lanes) {
+    size_t count = 0;
+    for (BlockId block = 0; block < function.blockCount(); ++block) {
+        for (InstrId id : function.instructions(block)) {
+            const Instruction& inst = function.instruction(id);
+            if (inst.opcode != opcode) continue;
+            ValueId typed = inst.opcode == IROpcode::Store ? function.operand(id, 0) : inst.result;
+            const TypeInfo& type = function.typeOf(typed);
+            if (type.isVector() && type.lanes == lanes) ++count;
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+TEST(LoopVectorizeTest, VectorizesArrayLoopWithScalarRemainder) {
+    auto function = makeArrayLoop(IntType);
+    LoopVectorizePass vectorizer(VectorTarget{16, true});
+    EXPECT_TRUE(vectorizer.run(*function));
+    EXPECT_EQ(vectorizer.getVectorizedCount(), 1u);
+
+    EXPECT_EQ(countVectorOpcode(*function, IROpcode::Load, 4), 2u);
+    EXPECT_EQ(countVectorOpcode(*function, IROpcode::Mul, 4), 1u);
+    EXPECT_EQ(countVectorOpcode(*function, IROpcode::Add, 4), 1u);
+    EXPECT_EQ(countVectorOpcode(*function, IROpcode::Store, 4), 1u);
+    EXPECT_EQ(countVectorOpcode(*function, IROpcode::Broadcast, 4), 1u);
+
+    // El bucle escalar sigue ahí para el resto y los arrays solapados
+    EXPECT_EQ(countOpcode(*function, IROpcode::Store), 2u);
+    ControlFlowGraph cfg(*function);
+    DominatorTree domTree(cfg);
+    EXPECT_EQ(LoopInfo(cfg, domTree).loops().size(), 2u);
+    EXPECT_EQ(cfg.successors(0).size(), 2u);    // Comprobación de solapamiento
+
+    EXPECT_FALSE(vectorizer.run(*function));
+}
+
+TEST(LoopVectorizeTest, WidthAndOperationsFollowTarget) {
+    auto floats = makeArrayLoop(FloatType);
+    EXPECT_TRUE(LoopVectorizePass(VectorTarget{32, false}).run(*floats));
+    EXPECT_EQ(countVectorOpcode(*floats, IROpcode::Mul, 8), 1u);
+
+    // Sin PMULLD no hay Mul de enteros vectorial
+    auto ints = makeArrayLoop(IntType);
+    EXPECT_FALSE(LoopVectorizePass(VectorTarget{16, false}).run(*ints));
+
+    // El índice usado como valor necesitaría un vector de inducción
+    auto indices = makeArrayLoop(IntType, true);
+    EXPECT_FALSE(LoopVectorizePass(VectorTarget{16, true}).run(*indices));
+}
+
+namespace {
+
+/**
+ * @brief int name(bool c) { if (c) return hot(0); else return cold(0); }
+ *
+ * Bloques: entry, then, else.
+ */
+std::unique_ptr<IRFunction> makeBranchyCaller(const std::string& name, const std::string& hot,
+                                              const std::string& cold) {
+    auto function = std::make_unique<IRFunction>(name, IntType, std::vector<TypeInfo>{BoolType});
+    IRBuilder builder(*function);
+    BlockId entry = builder.createBlock("entry");
+    BlockId then = builder.createBlock("then");
+    BlockId otherwise = builder.createBlock("else");
+
+    builder.setInsertPoint(entry);
+    builder.createConditionalBranch(function->parameter(0), then, otherwise);
+    ValueId args[] = {builder.getInt(0, IntType)};
+    for (auto [block, callee] : {std::pair{then, &hot}, std::pair{otherwise, &cold}}) {
+        builder.setInsertPoint(block);
+        builder.createReturn(builder.createCall(
+            builder.getGlobal(*callee, TypeInfo(IRType::Function, 8, 8, "fn")), args, IntType));
+    }
+    return function;
+}
+
+} // namespace
+
+TEST(ProfileTest, InstrumentationCountsEveryBlock) {
+    IRModule module("m");
+    module.addFunction(makeBranchyCaller("main", "a", "b"));
+    module.addFunction(std::make_unique<IRFunction>("a", IntType, std::vector<TypeInfo>{IntType}));
+    uint64_t hash = profileHash(*module.getFunctions()[0]);
+
+    ProfileInstrumentationPass instrument;
+    EXPECT_TRUE(instrument.run(module));
+    EXPECT_EQ(instrument.getInstrumentedCount(), 1u);     // Las declaraciones no se instrumentan
+
+    const IRFunction& main = *module.getFunctions()[0];
+    EXPECT_EQ(profileHash(main), hash);
+    EXPECT_EQ(countOpcode(main, IROpcode::Store), 3u);
+    EXPECT_EQ(countOpcode(main, IROpcode::Call), 4u);     // Las dos de antes y el volcado de cada ret
+    ASSERT_EQ(module.getGlobals().size(), 1u);
+    EXPECT_EQ(module.getGlobals()[0]->getName(), "__cpp_prof_cnts.main");
+    EXPECT_EQ(module.getGlobals()[0]->getType().size, 24u);
+
+    // El contador va antes que el resto del bloque; el volcado, justo antes del ret
+    EXPECT_EQ(main.instruction(main.block(1).first).opcode, IROpcode::GetElementPtr);
+    InstrId beforeRet = main.instruction(main.terminator(1)).prev;
+    EXPECT_EQ(main.instruction(beforeRet).opcode, IROpcode::Call);
+    EXPECT_EQ(main.globalName(main.operand(beforeRet, 0)), ProfileWriteFunction);
+}
+
+TEST(ProfileTest, DataMergesRunsAndRejectsTruncatedFiles) {
+    ProfileData run;
+    run.addFunction("f", {7, {10, 4, 6}});
+    run.addFunction("g", {9, {30}});
+    run.addFunction("never", {3, {0}});
+    std::vector<uint8_t> bytes;
+    run.serialize(bytes);
+
+    ProfileData merged;
+    ASSERT_TRUE(merged.merge(bytes));
+    ASSERT_TRUE(merged.merge(bytes));
+    ASSERT_NE(merged.find("f"), nullptr);
+    EXPECT_EQ(merged.find("f")->counts, (std::vector<uint64_t>{20, 8, 12}));
+    EXPECT_EQ(merged.hotFunctionOrder(), (std::vector<std::string>{"g", "f"}));
+
+    // Otra versión de f sustituye a la anterior
+    merged.addFunction("f", {8, {1, 1}});
+    EXPECT_EQ(merged.find("f")->counts.size(), 2u);
+
+    ProfileData broken;
+    bytes.pop_back();
+    EXPECT_FALSE(broken.merge(bytes));
+    EXPECT_TRUE(broken.empty());
+    EXPECT_FALSE(broken.merge(std::vector<uint8_t>{'x'}));
+}
+
+TEST(ProfileTest, ProfileGuidesInliningAndBlockLayout) {
+    IRModule module("m");
+    module.addFunction(makeBranchyCaller("f", "warm", "rare"));
+    module.addFunction(makeChain("warm", 60));
+    module.addFunction(makeChain("rare", 20));
+
+    // "rare" no aparece en el perfil: no se ejecutó
+    ProfileData profile;
+    profile.addFunction("f", {profileHash(*module.getFunctions()[0]), {100, 100, 0}});
+    profile.addFunction("warm", {profileHash(*module.getFunctions()[1]), {100}});
+
+    ProfileOptions pgo;
+    pgo.profile = &profile;
+    PassManager manager = PassManager::createForOptimizationLevel(2, VectorTarget(), false, pgo);
+    auto stats = manager.getStats();
+    EXPECT_EQ(stats.front().name, "pgo-annotate");
+    EXPECT_EQ(stats[stats.size() - 2].name, "block-placement");
+    manager.run(module);
+
+    // Sin perfil "warm" es demasiado grande y "rare" se integraría
+    const IRFunction& f = *module.getFunctions()[0];
+    ASSERT_EQ(countOpcode(f, IROpcode::Call), 1u);
+    EXPECT_EQ(module.getFunctions()[2]->blockFrequency(0), 0u);
+    EXPECT_EQ(f.blockFrequency(2), 0u);
+    EXPECT_EQ(f.instruction(f.block(2).first).opcode, IROpcode::Call);
+
+    // El camino caliente cae de bloque en bloque; el frío va al final
+    auto layout = f.blockLayout();
+    ASSERT_EQ(layout.size(), f.blockCount());
+    EXPECT_EQ(layout[0], 0u);
+    EXPECT_EQ(layout[1], 1u);
+    EXPECT_EQ(layout.back(), 2u);
+
+    // Un perfil de otra versión de la función no se aplica
+    IRModule stale("s");
+    stale.addFunction(makeBranchyCaller("f", "warm", "rare"));
+    ProfileData old;
+    old.addFunction("f", {1, {100, 0, 100}});
+    ProfileAnnotatePass annotate(old);
+    EXPECT_FALSE(annotate.run(stale));
+    EXPECT_EQ(annotate.getMismatchedCount(), 1u);
+    EXPECT_FALSE(stale.getFunctions()[0]->hasProfile());
+}
+
+TEST(BlockPlacementTest, StaticEstimateKeepsLoopsTogetherAndErrorsLast) {
+    // if (p) resume; for (...) cuerpo; return: salida y error escritos antes del cuerpo
+    IRFunction function("f", IntType, {BoolType, BoolType});
+    IRBuilder builder(function);
+    BlockId entry = builder.createBlock("entry");
+    BlockId error = builder.createBlock("error");
+    BlockId header = builder.createBlock("header");
+    BlockId exit = builder.createBlock("exit");
+    BlockId body = builder.createBlock("body");
+
+    builder.setInsertPoint(entry);
+    builder.createConditionalBranch(function.parameter(0), error, header);
+    builder.setInsertPoint(error);
+    builder.createInstruction(IROpcode::Resume, TypeInfo(), {}, false);
+    builder.setInsertPoint(header);
+    builder.createConditionalBranch(function.parameter(1), exit, body);
+    builder.setInsertPoint(body);
+    builder.createBranch(header);
+    builder.setInsertPoint(exit);
+    builder.createReturn(builder.getInt(0, IntType));
+
+    BlockPlacementPass pass;
+    EXPECT_TRUE(pass.run(function));
+    EXPECT_FALSE(function.hasProfile());
+    EXPECT_EQ(function.blockLayout(), (std::vector<BlockId>{entry, header, body, exit, error}));
+    EXPECT_EQ(function.block(header).alignment, 16u);
+    EXPECT_EQ(function.block(entry).alignment, 0u);
+    EXPECT_FALSE(pass.run(function));
+
+    // Con alineamiento 0 un orden que ya es el bueno no cambia nada
+    IRFunction spin("g", IntType, {BoolType});
+    IRBuilder spinBuilder(spin);
+    BlockId start = spinBuilder.createBlock("entry");
+    BlockId loop = spinBuilder.createBlock("loop");
+    BlockId done = spinBuilder.createBlock("done");
+    spinBuilder.setInsertPoint(start);
+    spinBuilder.createBranch(loop);
+    spinBuilder.setInsertPoint(loop);
+    spinBuilder.createConditionalBranch(spin.parameter(0), loop, done);
+    spinBuilder.setInsertPoint(done);
+    spinBuilder.createReturn(spinBuilder.getInt(0, IntType));
+    BlockPlacementPass unaligned(0);
+    EXPECT_FALSE(unaligned.run(spin));
+    EXPECT_EQ(spin.block(loop).alignment, 0u);
+}
+
+TEST(ExceptionLayoutTest, LandingPadsAndHandlersGoLast) {
+    IRFunction function("f", IntType, {BoolType});
+    IRBuilder builder(function);
+    BlockId entry = builder.createBlock("entry");
+    BlockId landing = builder.createBlock("landingpad");
+    BlockId next = builder.createBlock("next");
+    BlockId handler = builder.createBlock("catch");
+    BlockId cleanup = builder.createBlock("cleanup");
+    BlockId exit = builder.createBlock("exit");
+
+    builder.setInsertPoint(entry);
+    builder.createConditionalBranch(function.parameter(0), landing, next);
+    builder.setInsertPoint(landing);
+    builder.createInstruction(IROpcode::LandingPad, TypeInfo(IRType::Pointer, 8, 8, "i8*"), {}, true);
+    builder.createConditionalBranch(function.parameter(0), handler, cleanup);
+    builder.setInsertPoint(next);
+    builder.createBranch(exit);
+    builder.setInsertPoint(handler);
+    builder.createBranch(exit);
+    builder.setInsertPoint(cleanup);
+    builder.createInstruction(IROpcode::Resume, TypeInfo(), {}, false);
+    builder.setInsertPoint(exit);
+    builder.createReturn(builder.getInt(0, IntType));
+
+    // El catch vuelve al camino normal por "exit", que sigue caliente
+    ColdExceptionPathsPass pass;
+    EXPECT_TRUE(pass.run(function));
+    EXPECT_EQ(pass.getColdBlockCount(), 3u);
+    EXPECT_EQ(function.blockLayout(), (std::vector<BlockId>{entry, next, exit, landing, handler, cleanup}));
+    EXPECT_FALSE(pass.run(function));
+}
+
+namespace {
+
+/**
+ * @brief Recorre la IR de una función de un parámetro hasta su Ret
+ *
+ * Cubre solo las operaciones que emiten switch-lowering e if-convert.
+ */
+std::optional<int64_t> interpret(const IRFunction& function, int64_t argument) {
+    std::unordered_map<ValueId, int64_t> values{{function.parameter(0), argument}};
+    auto value = [&](ValueId id) {
+        const IRConstant* constant = function.constant(id);
+        return constant ? constant->intValue : values.at(id);
+    };
+    BlockId previous = NoBlock, block = 0;
+    for (int steps = 0; steps < 100; ++steps) {
+        BlockId next = NoBlock;
+        for (InstrId id : function.instructions(block)) {
+            const Instruction& inst = function.instruction(id);
+            auto operand = [&](size_t index) { return value(function.operand(id, index)); };
+            switch (inst.opcode) {
+                case IROpcode::Phi:
+                    for (size_t i = 0; i + 1 < function.operandCount(id); i += 2) {
+                        if (function.labelBlock(function.operand(id, i + 1)) == previous) {
+                            values[inst.result] = operand(i);
+                        }
+                    }
+                    if (!values.count(inst.result)) return std::nullopt;
+                    break;
+                case IROpcode::Sub: values[inst.result] = operand(0) - operand(1); break;
+                case IROpcode::Shl: values[inst.result] = operand(0) << operand(1); break;
+                case IROpcode::And: values[inst.result] = operand(0) & operand(1); break;
+                case IROpcode::CmpEQ: values[inst.result] = operand(0) == operand(1); break;
+                case IROpcode::CmpNE: values[inst.result] = operand(0) != operand(1); break;
+                case IROpcode::CmpLT: values[inst.result] = operand(0) < operand(1); break;
+                case IROpcode::CmpGT: values[inst.result] = operand(0) > operand(1); break;
+                case IROpcode::Select: values[inst.result] = operand(0) ? operand(1) : operand(2); break;
+                case IROpcode::Br: next = function.labelBlock(function.operand(id, 0)); break;
+                case IROpcode::BrCond:
+                    next = function.labelBlock(function.operand(id, operand(0) ? 1 : 2));
+                    break;
+                case IROpcode::Switch:
+                    next = function.labelBlock(function.operand(id, 1));
+                    for (size_t i = 2; i + 1 < function.operandCount(id); i += 2) {
+                        if (operand(i) == operand(0)) next = function.labelBlock(function.operand(id, i + 1));
+                    }
+                    break;
+                case IROpcode::Ret: return operand(0);
+                default: return std::nullopt;
+            }
+        }
+        previous = std::exchange(block, next);
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+TEST(SwitchLoweringTest, ChoosesTablesBitTestsAndComparisons) {
+    // switch (x) { case 0..7: tabla; case 100, 110, 120, 130: decenas;
+    //              case 5000: grande; case 90000: enorme; default: return x; }
+    IRFunction function("classify", IntType, {IntType});
+    function.addParameter("x", IntType);
+    IRBuilder builder(function);
+    BlockId entry = builder.createBlock("entry");
+    std::vector<BlockId> targets;
+    for (int i = 0; i < 7; ++i) targets.push_back(builder.createBlock("case" + std::to_string(i)));
+    BlockId fallback = builder.createBlock("default");
+
+    std::vector<std::pair<int64_t, BlockId>> cases;
+    for (int64_t value = 0; value < 8; ++value) cases.emplace_back(value, targets[value % 4]);
+    for (int64_t value : {100, 110, 120, 130}) cases.emplace_back(value, targets[4]);
+    cases.emplace_back(5000, targets[5]);
+    cases.emplace_back(90000, targets[6]);
+    builder.setInsertPoint(entry);
+    builder.createSwitch(function.parameter(0), fallback, cases);
+    for (size_t i = 0; i < targets.size(); ++i) {
+        builder.setInsertPoint(targets[i]);
+        builder.createReturn(builder.getInt(-1 - static_cast<int64_t>(i), IntType));
+    }
+    builder.setInsertPoint(fallback);
+    ValueId phi = builder.createPhi(IntType);
+    builder.addIncoming(phi, function.parameter(0), entry);
+    builder.createReturn(phi);
+
+    auto expected = [&](int64_t x) -> int64_t {
+        for (const auto& [value, target] : cases) {
+            if (value == x) return -1 - static_cast<int64_t>(std::find(targets.begin(), targets.end(), target) - targets.begin());
+        }
+        return x;
+    };
+    std::vector<int64_t> probes{-5, -1, 0, 3, 7, 8, 99, 100, 101, 110, 120, 130, 131, 4999, 5000, 90000, 90001};
+    for (int64_t x : probes) ASSERT_EQ(interpret(function, x), expected(x)) << x;
+
+    SwitchLoweringPass pass;
+    EXPECT_TRUE(pass.run(function));
+    EXPECT_EQ(pass.getJumpTableCount(), 1u);
+    EXPECT_EQ(pass.getBitTestCount(), 1u);
+    EXPECT_GT(pass.getComparisonCount(), 0u);
+    EXPECT_EQ(countOpcode(function, IROpcode::Switch), 1u);
+    EXPECT_EQ(countOpcode(function, IROpcode::Shl), 1u);
+    for (int64_t x : probes) EXPECT_EQ(interpret(function, x), expected(x)) << x;
+
+    // La tabla que queda ya es densa: no hay nada más que bajar
+    SwitchLoweringPass again;
+    EXPECT_FALSE(again.run(function));
+}
+
+TEST(SwitchLoweringTest, SparseSwitchBecomesBalancedTree) {
+    IRFunction function("sparse", IntType, {IntType});
+    function.addParameter("x", IntType);
+    IRBuilder builder(function);
+    BlockId entry = builder.createBlock("entry");
+    BlockId fallback = builder.createBlock("default");
+    std::vector<std::pair<int64_t, BlockId>> cases;
+    for (int64_t i = 0; i < 8; ++i) cases.emplace_back(i * 1000, builder.createBlock("case" + std::to_string(i)));
+    builder.setInsertPoint(entry);
+    builder.createSwitch(function.parameter(0), fallback, cases);
+    for (const auto& [value, target] : cases) {
+        builder.setInsertPoint(target);
+        builder.createReturn(builder.getInt(value + 1, IntType));
+    }
+    builder.setInsertPoint(fallback);
+    builder.createReturn(builder.getInt(-1, IntType));
+
+    SwitchLoweringPass pass;
+    EXPECT_TRUE(pass.run(function));
+    EXPECT_EQ(pass.getJumpTableCount(), 0u);
+    EXPECT_EQ(countOpcode(function, IROpcode::Switch), 0u);
+    // Ocho igualdades más los cortes del árbol: ningún camino las recorre todas
+    EXPECT_EQ(countOpcode(function, IROpcode::CmpEQ), 8u);
+    EXPECT_LE(pass.getComparisonCount(), 15u);
+    for (int64_t x : {-1, 0, 1, 999, 1000, 3000, 6500, 7000, 7001}) {
+        EXPECT_EQ(interpret(function, x), x % 1000 == 0 && x >= 0 && x <= 7000 ? x + 1 : -1) << x;
+    }
+}
+
+namespace {
+
+/**
+ * @brief int f(int x) { int m = x > 5 ? x : 5 - x; if (m < 3) m = 0 - m; return m; }
+ *
+ * Un rombo seguido de un triángulo; el bloque de la rama lateral del triángulo
+ * lleva @p sideOpcode para poder probar qué se especula y qué no.
+ */
+struct DiamondAndTriangle {
+    IRFunction function{"f", IntType, {IntType}};
+    BlockId entry, takeX, other, merge, negate, exit;
+
+    explicit DiamondAndTriangle(IROpcode sideOpcode = IROpcode::Sub) {
+        function.addParameter("x", IntType);
+        IRBuilder builder(function);
+        entry = builder.createBlock("entry");
+        takeX = builder.createBlock("takeX");
+        other = builder.createBlock("other");
+        merge = builder.createBlock("merge");
+        negate = builder.createBlock("negate");
+        exit = builder.createBlock("exit");
+
+        ValueId x = function.parameter(0);
+        ValueId zero = builder.getInt(0, IntType), three = builder.getInt(3, IntType), five = builder.getInt(5, IntType);
+        builder.setInsertPoint(entry);
+        builder.createConditionalBranch(builder.createBinary(IROpcode::CmpGT, x, five, BoolType), takeX, other);
+        builder.setInsertPoint(takeX);
+        builder.createBranch(merge);
+        builder.setInsertPoint(other);
+        ValueId fiveMinusX = builder.createBinary(IROpcode::Sub, five, x, IntType);
+        builder.createBranch(merge);
+        builder.setInsertPoint(merge);
+        ValueId m = builder.createPhi(IntType);
+        builder.addIncoming(m, x, takeX);
+        builder.addIncoming(m, fiveMinusX, other);
+        builder.createConditionalBranch(builder.createBinary(IROpcode::CmpLT, m, three, BoolType), negate, exit);
+        builder.setInsertPoint(negate);
+        ValueId negated = builder.createBinary(sideOpcode, zero, m, IntType);
+        builder.createBranch(exit);
+        builder.setInsertPoint(exit);
+        ValueId result = builder.createPhi(IntType);
+        builder.addIncoming(result, negated, negate);
+        builder.addIncoming(result, m, merge);
+        builder.createReturn(result);
+    }
+
+    static int64_t expected(int64_t x) {
+        int64_t m = x > 5 ? x : 5 - x;
+        return m < 3 ? -m : m;
+    }
+};
+
+} // namespace
+
+TEST(IfConversionTest, DiamondsAndTrianglesBecomeSelects) {
+    DiamondAndTriangle shape;
+    IRFunction& function = shape.function;
+    std::vector<int64_t> probes{-10, 0, 2, 3, 4, 5, 6, 100};
+    for (int64_t x : probes) ASSERT_EQ(interpret(function, x), DiamondAndTriangle::expected(x)) << x;
+
+    IfConversionPass pass;
+    EXPECT_TRUE(pass.run(function));
+    EXPECT_EQ(pass.getConvertedCount(), 2u);
+    EXPECT_EQ(pass.getSelectCount(), 2u);
+    EXPECT_EQ(countOpcode(function, IROpcode::BrCond), 0u);
+    EXPECT_EQ(countOpcode(function, IROpcode::Phi), 0u);
+    EXPECT_EQ(countOpcode(function, IROpcode::Select), 2u);
+
+    // Cada Select lleva su comparación justo delante
+    for (BlockId block = 0; block < function.blockCount(); ++block) {
+        for (InstrId id : function.instructions(block)) {
+            if (function.instruction(id).opcode != IROpcode::Select) continue;
+            EXPECT_EQ(function.instruction(id).prev, function.definingInstruction(function.operand(id, 0)));
+        }
+    }
+    for (int64_t x : probes) EXPECT_EQ(interpret(function, x), DiamondAndTriangle::expected(x)) << x;
+    EXPECT_FALSE(pass.run(function));
+}
+
+TEST(IfConversionTest, KeepsBranchesThatCannotOrShouldNotBeSpeculated) {
+    // Una división entera puede lanzar: el triángulo queda, el rombo no depende de él
+    DiamondAndTriangle division(IROpcode::Div);
+    IfConversionPass pass;
+    EXPECT_TRUE(pass.run(division.function));
+    EXPECT_EQ(pass.getConvertedCount(), 1u);
+    EXPECT_EQ(countOpcode(division.function, IROpcode::BrCond), 1u);
+    EXPECT_EQ(countOpcode(division.function, IROpcode::Div), 1u);
+
+    // Con un perfil muy sesgado el predictor acierta casi siempre
+    DiamondAndTriangle biased;
+    IRFunction& function = biased.function;
+    function.setBlockFrequency(biased.entry, 1000);
+    function.setBlockFrequency(biased.takeX, 999);
+    function.setBlockFrequency(biased.other, 1);
+    function.setBlockFrequency(biased.merge, 1000);
+    function.setBlockFrequency(biased.negate, 400);
+    function.setBlockFrequency(biased.exit, 1000);
+    IfConversionPass profiled;
+    EXPECT_TRUE(profiled.run(function));
+    EXPECT_EQ(profiled.getConvertedCount(), 1u);
+    EXPECT_EQ(countOpcode(function, IROpcode::BrCond), 1u);
+    EXPECT_EQ(countOpcode(function, IROpcode::Select), 1u);
+
+    EXPECT_EQ(IfConversionPass::speculationCost(function, function.terminator(biased.entry)), -1);
+}
+
+TEST(TailCallTest, MarksCallsFollowedByTheirReturn) {
+    // int walk(int n) { if (n < 1) return step(n); int r = next(n); return r; }
+    const TypeInfo FunctionType(IRType::Function, 8, 8, "fn");
+    IRFunction function("walk", IntType, {IntType});
+    function.addParameter("n", IntType);
+    IRBuilder builder(function);
+    BlockId entry = builder.createBlock("entry");
+    BlockId done = builder.createBlock("done");
+    BlockId more = builder.createBlock("more");
+    BlockId exit = builder.createBlock("exit");
+    ValueId n = function.parameter(0);
+    ValueId args[] = {n};
+
+    builder.setInsertPoint(entry);
+    builder.createConditionalBranch(builder.createBinary(IROpcode::CmpLT, n, builder.getInt(1, IntType), BoolType),
+                                    done, more);
+    builder.setInsertPoint(done);
+    ValueId stepped = builder.createCall(builder.getGlobal("step", FunctionType), args, IntType);
+    builder.createBranch(exit);
+    builder.setInsertPoint(more);
+    ValueId next = builder.createCall(builder.getGlobal("next", FunctionType), args, IntType);
+    builder.createBranch(exit);
+    builder.setInsertPoint(exit);
+    ValueId result = builder.createPhi(IntType);
+    builder.addIncoming(result, stepped, done);
+    builder.addIncoming(result, next, more);
+    builder.createReturn(result);
+
+    TailCallPass pass;
+    EXPECT_TRUE(pass.run(function));
+    EXPECT_EQ(pass.getTailCallCount(), 2u);
+    EXPECT_EQ(pass.getDuplicatedReturnCount(), 2u);
+    for (BlockId block : {done, more}) {
+        InstrId ret = function.terminator(block);
+        ASSERT_EQ(function.instruction(ret).opcode, IROpcode::Ret);
+        InstrId call = function.instruction(ret).prev;
+        EXPECT_TRUE(function.instruction(call).tail);
+        EXPECT_EQ(function.operand(ret, 0), function.instruction(call).result);
+    }
+    EXPECT_EQ(function.block(exit).first, NoInstr);     // Sin predecesores: se vacía
+    EXPECT_FALSE(pass.run(function));
+}
+
+TEST(TailCallTest, LeavesCallsThatNeedTheFrameOrTheirResult) {
+    const TypeInfo FunctionType(IRType::Function, 8, 8, "fn");
+
+    // int twice(int n) { return step(n) + 1; }: el resultado se usa después
+    IRFunction used("twice", IntType, {IntType});
+    used.addParameter("n", IntType);
+    IRBuilder builder(used);
+    builder.setInsertPoint(builder.createBlock("entry"));
+    ValueId args[] = {used.parameter(0)};
+    ValueId call = builder.createCall(builder.getGlobal("step", FunctionType), args, IntType);
+    builder.createReturn(builder.createBinary(IROpcode::Add, call, builder.getInt(1, IntType), IntType));
+    TailCallPass pass;
+    EXPECT_FALSE(pass.run(used));
+
+    // int local() { int x; return read(&x); }: &x apunta al marco que se libera
+    IRFunction escaping("local", IntType, {});
+    IRBuilder local(escaping);
+    local.setInsertPoint(local.createBlock("entry"));
+    ValueId slot = local.createAlloca(IntType);
+    local.createStore(local.getInt(7, IntType), slot);
+    ValueId address[] = {slot};
+    local.createReturn(local.createCall(local.getGlobal("read", FunctionType), address, IntType));
+    EXPECT_FALSE(pass.run(escaping));
+    EXPECT_EQ(pass.getTailCallCount(), 0u);
+
+    // Si solo se carga y se guarda, el Alloca no impide marcar la llamada
+    IRFunction contained("contained", IntType, {});
+    IRBuilder inner(contained);
+    inner.setInsertPoint(inner.createBlock("entry"));
+    ValueId cell = inner.createAlloca(IntType);
+    inner.createStore(inner.getInt(7, IntType), cell);
+    ValueId loaded[] = {inner.createLoad(cell, IntType)};
+    inner.createReturn(inner.createCall(inner.getGlobal("read", FunctionType), loaded, IntType));
+    EXPECT_TRUE(pass.run(contained));
+    EXPECT_EQ(pass.getTailCallCount(), 1u);
+}
+
+TEST(MemoryIntrinsicsTest, SmallCallsAndStructCopiesBecomeIntrinsics) {
+    const TypeInfo FunctionType(IRType::Function, 8, 8, "fn");
+    const TypeInfo PtrType(IRType::Pointer, 8, 8, "ptr");
+    const TypeInfo SizeType(IRType::LongLong, 8, 8, "i64");
+    const TypeInfo PairType(IRType::Struct, 24, 8, "pair");
+
+    // bool f(char* a, char* b, pair* p, pair* q, long n)
+    IRFunction function("f", BoolType, {PtrType, PtrType, PtrType, PtrType, SizeType});
+    for (const char* name : {"a", "b", "p", "q", "n"}) {
+        function.addParameter(name, name[0] == 'n' ? SizeType : PtrType);
+    }
+    IRBuilder builder(function);
+    builder.setInsertPoint(builder.createBlock("entry"));
+    ValueId a = function.parameter(0), b = function.parameter(1);
+    ValueId copy[] = {a, b, builder.getInt(64, SizeType)};
+    builder.createCall(builder.getGlobal("memcpy", FunctionType), copy, PtrType);
+    ValueId fill[] = {a, builder.getInt(0, IntType), builder.getInt(40, SizeType)};
+    builder.createCall(builder.getGlobal("memset", FunctionType), fill, PtrType);
+    ValueId large[] = {a, b, builder.getInt(4096, SizeType)};
+    builder.createCall(builder.getGlobal("memcpy", FunctionType), large, PtrType);
+    ValueId variable[] = {a, b, function.parameter(4)};
+    builder.createCall(builder.getGlobal("memcpy", FunctionType), variable, PtrType);
+    builder.createStore(builder.createLoad(function.parameter(3), PairType), function.parameter(2));
+    ValueId compare[] = {a, b, builder.getInt(16, SizeType)};
+    ValueId order = builder.createCall(builder.getGlobal("memcmp", FunctionType), compare, IntType);
+    builder.createReturn(builder.createBinary(IROpcode::CmpEQ, order, builder.getInt(0, IntType), BoolType));
+
+    MemoryIntrinsicsPass pass;
+    EXPECT_EQ(pass.getInlineLimit(), 128u);
+    EXPECT_TRUE(pass.run(function));
+    EXPECT_EQ(pass.getIntrinsicCount(), 4u);
+    EXPECT_EQ(countOpcode(function, IROpcode::MemCpy), 2u);
+    EXPECT_EQ(countOpcode(function, IROpcode::MemSet), 1u);
+    EXPECT_EQ(countOpcode(function, IROpcode::MemCmp), 1u);
+    EXPECT_EQ(countOpcode(function, IROpcode::Call), 2u);     // 4096 bytes y tamaño variable
+    EXPECT_EQ(countOpcode(function, IROpcode::Load), 0u);
+    EXPECT_EQ(countOpcode(function, IROpcode::Store), 0u);
+    EXPECT_FALSE(pass.run(function));
+
+    // Con AVX2 el límite sube a ocho registros YMM
+    EXPECT_EQ(MemoryIntrinsicsPass(VectorTarget{32, false}).getInlineLimit(), 256u);
+}
+
+TEST(MemoryIntrinsicsTest, OrderedMemcmpAndUnexpandableIntrinsicsStayCalls) {
+    const TypeInfo FunctionType(IRType::Function, 8, 8, "fn");
+    const TypeInfo PtrType(IRType::Pointer, 8, 8, "ptr");
+    const TypeInfo SizeType(IRType::LongLong, 8, 8, "i64");
+
+    // memcmp(a, b, 8) < 0 necesita el orden: sigue siendo una llamada
+    IRFunction ordered("ordered", BoolType, {PtrType, PtrType});
+    ordered.addParameter("a", PtrType);
+    ordered.addParameter("b", PtrType);
+    IRBuilder builder(ordered);
+    builder.setInsertPoint(builder.createBlock("entry"));
+    ValueId args[] = {ordered.parameter(0), ordered.parameter(1), builder.getInt(8, SizeType)};
+    ValueId order = builder.createCall(builder.getGlobal("memcmp", FunctionType), args, IntType);
+    builder.createReturn(builder.createBinary(IROpcode::CmpLT, order, builder.getInt(0, IntType), BoolType));
+    MemoryIntrinsicsPass pass;
+    EXPECT_FALSE(pass.run(ordered));
+
+    // Un MemSet de byte variable o un MemCpy sin tamaño constante vuelven a la CRT
+    IRFunction lowered("lowered", BoolType, {PtrType, PtrType, IntType, SizeType});
+    lowered.addParameter("a", PtrType);
+    lowered.addParameter("b", PtrType);
+    lowered.addParameter("c", IntType);
+    lowered.addParameter("n", SizeType);
+    IRBuilder direct(lowered);
+    direct.setInsertPoint(direct.createBlock("entry"));
+    ValueId a = lowered.parameter(0), b = lowered.parameter(1);
+    direct.createMemSet(a, lowered.parameter(2), direct.getInt(16, SizeType));
+    direct.createMemCpy(a, b, lowered.parameter(3));
+    ValueId equal = direct.createMemCmp(a, b, direct.getInt(1024, SizeType), IntType);
+    direct.createReturn(direct.createBinary(IROpcode::CmpNE, equal, direct.getInt(0, IntType), BoolType));
+    EXPECT_TRUE(pass.run(lowered));
+    EXPECT_EQ(pass.getLibraryCallCount(), 3u);
+    EXPECT_EQ(countOpcode(lowered, IROpcode::Call), 3u);
+    EXPECT_EQ(countOpcode(lowered, IROpcode::MemSet) + countOpcode(lowered, IROpcode::MemCpy) +
+                  countOpcode(lowered, IROpcode::MemCmp),
+              0u);
+    EXPECT_FALSE(pass.run(lowered));
+}
+
+namespace {
+
+const IRFunction* findFunction(const IRModule& module, const std::string& name) {
+    for (const auto& function : module.getFunctions()) {
+        if (function->getName() == name) return function.get();
+    }
+    return nullptr;
+}
+
+} // namespace
+
+TEST(BitIntrinsicsTest, BuiltinsAndIdiomsBecomeIntrinsics) {
+    const TypeInfo FunctionType(IRType::Function, 8, 8, "fn");
+    const TypeInfo PtrType(IRType::Pointer, 8, 8, "ptr");
+    const TypeInfo CharType(IRType::Char, 1, 1, "i8");
+
+    // int f(unsigned x, unsigned long* index)
+    IRFunction function("f", IntType, {IntType, PtrType});
+    function.addParameter("x", IntType);
+    function.addParameter("index", PtrType);
+    IRBuilder builder(function);
+    builder.setInsertPoint(builder.createBlock("entry"));
+    ValueId x = function.parameter(0);
+    auto call = [&](const char* name, std::vector<ValueId> args, const TypeInfo& type) {
+        return builder.createCall(builder.getGlobal(name, FunctionType), args, type);
+    };
+    ValueId sum = call("__builtin_popcount", {x}, IntType);
+    sum = builder.createBinary(IROpcode::Add, sum, call("_byteswap_ulong", {x}, IntType), IntType);
+    sum = builder.createBinary(IROpcode::Add, sum, call("_mm_crc32_u32", {sum, x}, IntType), IntType);
+    ValueId found = call("_BitScanReverse", {function.parameter(1), x}, CharType);
+    sum = builder.createBinary(IROpcode::Add, sum, builder.createCast(IROpcode::ZExt, found, IntType), IntType);
+
+    // (x << 5) | ((x >> 27) & 31) es una rotación
+    ValueId high = builder.createBinary(IROpcode::Shl, x, builder.getInt(5, IntType), IntType);
+    ValueId low = builder.createBinary(IROpcode::And, builder.createBinary(IROpcode::Shr, x, builder.getInt(27, IntType), IntType),
+                                       builder.getInt(31, IntType), IntType);
+    sum = builder.createBinary(IROpcode::Add, sum, builder.createBinary(IROpcode::Or, high, low, IntType), IntType);
+
+    // x == 0 ? 32 : __builtin_ctz(x) ya es ctz
+    ValueId zero = builder.createBinary(IROpcode::CmpEQ, x, builder.getInt(0, IntType), BoolType);
+    ValueId trailing = call("__builtin_ctz", {x}, IntType);
+    sum = builder.createBinary(IROpcode::Add, sum, builder.createSelect(zero, builder.getInt(32, IntType), trailing, IntType),
+                               IntType);
+    builder.createReturn(sum);
+
+    BitIntrinsicsPass pass;
+    EXPECT_TRUE(pass.run(function));
+    EXPECT_EQ(pass.getIntrinsicCount(), 5u);
+    EXPECT_EQ(pass.getIdiomCount(), 2u);
+    EXPECT_EQ(countOpcode(function, IROpcode::Call), 0u);
+    EXPECT_EQ(countOpcode(function, IROpcode::PopCount), 1u);
+    EXPECT_EQ(countOpcode(function, IROpcode::ByteSwap), 1u);
+    EXPECT_EQ(countOpcode(function, IROpcode::Crc32), 1u);
+    EXPECT_EQ(countOpcode(function, IROpcode::CountLeadingZeros), 1u);     // _BitScanReverse
+    EXPECT_EQ(countOpcode(function, IROpcode::CountTrailingZeros), 1u);
+    EXPECT_EQ(countOpcode(function, IROpcode::RotateLeft), 1u);
+    EXPECT_EQ(countOpcode(function, IROpcode::Select), 0u);
+    EXPECT_EQ(countOpcode(function, IROpcode::Store), 1u);                 // El índice de _BitScanReverse
+    EXPECT_FALSE(pass.run(function));
+}
+
+TEST(BitIntrinsicsTest, SCCPFoldsBitIntrinsicsAtTheTypeWidth) {
+    const TypeInfo ShortType(IRType::Short, 2, 2, "i16");
+    const TypeInfo LongType(IRType::LongLong, 8, 8, "i64");
+    auto fold = [](IROpcode opcode, int64_t value, const TypeInfo& type, int64_t other = -1) {
+        IRFunction function("f", type, {});
+        IRBuilder builder(function);
+        builder.setInsertPoint(builder.createBlock("entry"));
+        ValueId constant = builder.getInt(value, type);
+        builder.createReturn(other < 0 ? builder.createUnary(opcode, constant, type)
+                                       : builder.createBinary(opcode, constant, builder.getInt(other, type), type));
+        SCCPPass().run(function);
+        const IRConstant* folded = function.constant(function.operand(function.terminator(0), 0));
+        return folded ? folded->intValue : INT64_MIN;
+    };
+
+    EXPECT_EQ(fold(IROpcode::PopCount, -1, ShortType), 16);
+    EXPECT_EQ(fold(IROpcode::CountLeadingZeros, 1, ShortType), 15);
+    EXPECT_EQ(fold(IROpcode::CountLeadingZeros, 0, IntType), 32);
+    EXPECT_EQ(fold(IROpcode::CountTrailingZeros, 0, ShortType), 16);
+    EXPECT_EQ(fold(IROpcode::CountTrailingZeros, 0x40, LongType), 6);
+    EXPECT_EQ(fold(IROpcode::ByteSwap, 0x11223344, IntType), 0x44332211);
+    EXPECT_EQ(fold(IROpcode::RotateLeft, 0x12345678, IntType, 8), 0x34567812);
+    EXPECT_EQ(fold(IROpcode::RotateRight, 0x12345678, IntType, 8), 0x78123456);
+    EXPECT_EQ(fold(IROpcode::BitDeposit, 0b101, IntType, 0b111000), 0b101000);
+    EXPECT_EQ(fold(IROpcode::BitExtract, 0b101000, IntType, 0b111000), 0b101);
+}
+
+TEST(MultiversioningTest, ClonesPerTargetAndDispatchesThroughPointer) {
+    const TypeInfo FunctionType(IRType::Function, 8, 8, "fn");
+    IRModule module("m");
+    auto axpy = makeArrayLoop(FloatType);
+    axpy->setTargetClones({"sse4.1", "avx2", "avx512f", "default"});
+    module.addFunction(std::move(axpy));
+
+    // int spin(int x) { return spin(x); }: la recursión no vuelve a pasar por el puntero
+    auto spin = std::make_unique<IRFunction>("spin", IntType, std::vector<TypeInfo>{IntType});
+    spin->setTargetClones({"avx"});
+    {
+        IRBuilder builder(*spin);
+        builder.setInsertPoint(builder.createBlock("entry"));
+        ValueId args[] = {spin->parameter(0)};
+        builder.createReturn(builder.createCall(builder.getGlobal("spin", FunctionType), args, IntType));
+    }
+    module.addFunction(std::move(spin));
+
+    auto main = std::make_unique<IRFunction>("main", IntType, std::vector<TypeInfo>());
+    {
+        IRBuilder builder(*main);
+        builder.setInsertPoint(builder.createBlock("entry"));
+        ValueId args[] = {builder.getInt(1, IntType)};
+        builder.createReturn(builder.createCall(builder.getGlobal("spin", FunctionType), args, IntType));
+    }
+    module.addFunction(std::move(main));
+
+    MultiversioningPass pass;
+    EXPECT_TRUE(pass.run(module));
+    EXPECT_EQ(pass.getCloneCount(), 5u);
+    EXPECT_EQ(pass.getIgnoredTargetCount(), 1u);
+    EXPECT_EQ(pass.getDispatchedCallCount(), 1u);
+
+    // De la mejor copia a la peor, y la default sin extensiones propias
+    const IRFunction* resolver = findFunction(module, "axpy.resolver");
+    ASSERT_NE(resolver, nullptr);
+    EXPECT_EQ(countOpcode(*resolver, IROpcode::CPUFeatures), 1u);
+    EXPECT_EQ(countOpcode(*resolver, IROpcode::Store), 3u);
+    EXPECT_EQ(resolver->block(1).name, "avx2");
+    ASSERT_NE(findFunction(module, "axpy.sse4.1"), nullptr);
+    EXPECT_EQ(findFunction(module, "axpy.avx2")->getTarget(), "avx2");
+    EXPECT_TRUE(findFunction(module, "axpy.default")->getTarget().empty());
+    EXPECT_EQ(findFunction(module, "axpy.avx512f"), nullptr);
+    EXPECT_EQ(module.getInitializers(), (std::vector<std::string>{"axpy.resolver", "spin.resolver"}));
+    ASSERT_EQ(module.getGlobals().size(), 2u);
+    EXPECT_EQ(module.getGlobals()[0]->getName(), "axpy.ptr");
+
+    // El original salta a la copia elegida
+    const IRFunction* thunk = findFunction(module, "axpy");
+    ASSERT_NE(thunk, nullptr);
+    EXPECT_TRUE(thunk->getTargetClones().empty());
+    EXPECT_EQ(thunk->getParamTypes().size(), 5u);
+    EXPECT_EQ(countOpcode(*thunk, IROpcode::Load), 1u);
+    InstrId call = thunk->instruction(thunk->terminator(0)).prev;
+    EXPECT_TRUE(thunk->instruction(call).tail);
+
+    const IRFunction* caller = findFunction(module, "main");
+    InstrId callSite = caller->instruction(caller->terminator(0)).prev;
+    EXPECT_EQ(caller->value(caller->operand(callSite, 0)).kind, ValueKind::Instruction);
+    const IRFunction* clone = findFunction(module, "spin.avx");
+    InstrId recursive = clone->instruction(clone->terminator(0)).prev;
+    EXPECT_EQ(clone->globalName(clone->operand(recursive, 0)), "spin.avx");
+
+    // Cada copia se vectoriza con su ancho, aunque el módulo sea SSE2
+    auto* wide = const_cast<IRFunction*>(findFunction(module, "axpy.avx2"));
+    auto* narrow = const_cast<IRFunction*>(findFunction(module, "axpy.default"));
+    EXPECT_TRUE(LoopVectorizePass(VectorTarget{16, false}).run(*wide));
+    EXPECT_TRUE(LoopVectorizePass(VectorTarget{16, false}).run(*narrow));
+    EXPECT_EQ(countVectorOpcode(*wide, IROpcode::Mul, 8), 1u);
+    EXPECT_EQ(countVectorOpcode(*narrow, IROpcode::Mul, 4), 1u);
+
+    EXPECT_FALSE(MultiversioningPass().run(module));
+}
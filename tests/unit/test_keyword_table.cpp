@@ -0,0 +1,40 @@
+/**
+ * @file test_keyword_table.cpp
+ * @brief Tests para el reconocimiento de palabras clave por hash perfecto
+ */
+
+#include <compiler/frontend/lexer/KeywordTable.h>
+#include <compiler/frontend/lexer/Lexer.h>
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace cpp20::compiler::frontend::lexer;
+
+// La búsqueda es constexpr: se valida también en compilación
+static_assert(KeywordTable::typeOf("while") == TokenType::WHILE);
+static_assert(KeywordTable::typeOf("thread_local") == TokenType::THREAD_LOCAL);
+static_assert(KeywordTable::typeOf("whilst") == TokenType::IDENTIFIER);
+
+TEST(KeywordTableTest, EveryKeywordRoundTrips) {
+    for (const KeywordInfo& keyword : KeywordTable::keywords()) {
+        const KeywordInfo* found = KeywordTable::lookup(keyword.spelling);
+        ASSERT_NE(found, nullptr) << keyword.spelling;
+        EXPECT_EQ(found->spelling, keyword.spelling);
+        EXPECT_EQ(TokenUtils::getKeywordType(std::string(keyword.spelling)), keyword.type);
+    }
+}
+
+TEST(KeywordTableTest, NearMissesAreIdentifiers) {
+    for (const char* word : {"", "i", "in", "Int", "intx", "retur", "returns",
+                             "co_", "thread_locals", "a_very_long_identifier_name"}) {
+        EXPECT_EQ(TokenUtils::getKeywordType(word), TokenType::IDENTIFIER) << word;
+    }
+}
+
+TEST(KeywordTableTest, Cpp20KeywordsAreFlagged) {
+    EXPECT_TRUE(LexerUtils::isCpp20Keyword("concept"));
+    EXPECT_TRUE(LexerUtils::isCpp20Keyword("co_await"));
+    EXPECT_TRUE(LexerUtils::isCpp20Keyword("consteval"));
+    EXPECT_FALSE(LexerUtils::isCpp20Keyword("class"));
+    EXPECT_FALSE(LexerUtils::isCpp20Keyword("conceptual"));
+}
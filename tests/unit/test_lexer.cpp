@@ -3,31 +3,57 @@
  * @brief Tests unitarios para el lexer C++20
  */
 
-#include <gtest/gtest.h>
 #include <compiler/frontend/lexer/Lexer.h>
-#include <compiler/common/diagnostics/DiagnosticEngine.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace cpp20::compiler;
+using frontend::lexer::Lexer;
+using frontend::lexer::Token;
+using frontend::lexer::TokenType;
+
+namespace {
+
+class LexerTest : public ::testing::Test {
+protected:
+    std::shared_ptr<diagnostics::SourceManager> sourceManager_ =
+        std::make_shared<diagnostics::SourceManager>();
+    diagnostics::DiagnosticEngine diagEngine_{sourceManager_};
+
+    std::vector<std::string> lexemes(const std::string& source) {
+        Lexer lexer(source, diagEngine_);
+        std::vector<std::string> result;
+        for (const Token& token : lexer.tokenize()) {
+            if (token.getType() != TokenType::END_OF_FILE) {
+                result.push_back(token.getLexeme());
+            }
+        }
+        return result;
+    }
+};
 
-using namespace cpp20::compiler::frontend::lexer;
-using namespace cpp20::compiler::diagnostics;
+} // namespace
 
 // Test para inicialización del lexer
-TEST(LexerTest, BasicInitialization) {
-    DiagnosticEngine diagEngine;
-    LexerConfig config;
-    Lexer lexer("", diagEngine, config);
+TEST_F(LexerTest, BasicInitialization) {
+    frontend::lexer::LexerConfig config;
+    Lexer lexer("", diagEngine_, config);
 
-    EXPECT_FALSE(lexer.hasMoreTokens());
+    // END_OF_FILE cuenta como token hasta que se entrega
+    EXPECT_TRUE(lexer.hasMoreTokens());
 
     auto tokens = lexer.tokenize();
+    EXPECT_FALSE(lexer.hasMoreTokens());
     EXPECT_EQ(tokens.size(), 1); // Solo EOF
     EXPECT_EQ(tokens[0].getType(), TokenType::END_OF_FILE);
 }
 
 // Test para tokenización básica
-TEST(LexerTest, BasicTokenization) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, BasicTokenization) {
     std::string source = "int main() { return 0; }";
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     auto tokens = lexer.tokenize();
 
@@ -43,10 +69,9 @@ TEST(LexerTest, BasicTokenization) {
 }
 
 // Test para identificadores
-TEST(LexerTest, Identifiers) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, Identifiers) {
     std::string source = "variable _private __system myVar123";
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     auto tokens = lexer.tokenize();
 
@@ -66,10 +91,9 @@ TEST(LexerTest, Identifiers) {
 }
 
 // Test para palabras clave
-TEST(LexerTest, Keywords) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, Keywords) {
     std::string source = "int void char if else while for return";
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     auto tokens = lexer.tokenize();
 
@@ -86,10 +110,9 @@ TEST(LexerTest, Keywords) {
 }
 
 // Test para literales enteros
-TEST(LexerTest, IntegerLiterals) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, IntegerLiterals) {
     std::string source = "42 0xFF 077 0b1010 123ULL";
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     auto tokens = lexer.tokenize();
 
@@ -112,10 +135,9 @@ TEST(LexerTest, IntegerLiterals) {
 }
 
 // Test para literales flotantes
-TEST(LexerTest, FloatLiterals) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, FloatLiterals) {
     std::string source = "3.14 2.5f 1.23L 4.56e-2";
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     auto tokens = lexer.tokenize();
 
@@ -135,10 +157,9 @@ TEST(LexerTest, FloatLiterals) {
 }
 
 // Test para literales de caracter
-TEST(LexerTest, CharacterLiterals) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, CharacterLiterals) {
     std::string source = "'a' L'b' u'c' U'd' '\\n' '\\x41'";
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     auto tokens = lexer.tokenize();
 
@@ -150,13 +171,13 @@ TEST(LexerTest, CharacterLiterals) {
     EXPECT_EQ(tokens[3].getType(), TokenType::CHAR_LITERAL);
     EXPECT_EQ(tokens[4].getType(), TokenType::CHAR_LITERAL);
     EXPECT_EQ(tokens[5].getType(), TokenType::CHAR_LITERAL);
+    EXPECT_EQ(tokens[1].getLexeme(), "L'b'");
 }
 
 // Test para literales de string
-TEST(LexerTest, StringLiterals) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, StringLiterals) {
     std::string source = "\"hello\" L\"world\" u8\"text\" U\"unicode\"";
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     auto tokens = lexer.tokenize();
 
@@ -166,13 +187,14 @@ TEST(LexerTest, StringLiterals) {
     EXPECT_EQ(tokens[1].getType(), TokenType::STRING_LITERAL);
     EXPECT_EQ(tokens[2].getType(), TokenType::STRING_LITERAL);
     EXPECT_EQ(tokens[3].getType(), TokenType::STRING_LITERAL);
+    EXPECT_EQ(tokens[2].getLexeme(), "u8\"text\"");
+    EXPECT_EQ(tokens[2].getValue(), "text");
 }
 
 // Test para operadores
-TEST(LexerTest, Operators) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, Operators) {
     std::string source = "+ - * / % ++ -- == != < > <= >= && || ! & | ^ ~ << >> = += -= *= /= %= &= |= ^= <<= >>=";
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     auto tokens = lexer.tokenize();
 
@@ -193,10 +215,9 @@ TEST(LexerTest, Operators) {
 }
 
 // Test para puntuación
-TEST(LexerTest, Punctuation) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, Punctuation) {
     std::string source = "();[]{},.;:?";
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     auto tokens = lexer.tokenize();
 
@@ -215,10 +236,9 @@ TEST(LexerTest, Punctuation) {
 }
 
 // Test para operadores de comparación C++20
-TEST(LexerTest, SpaceshipOperator) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, SpaceshipOperator) {
     std::string source = "a <=> b";
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     auto tokens = lexer.tokenize();
 
@@ -230,10 +250,9 @@ TEST(LexerTest, SpaceshipOperator) {
 }
 
 // Test para palabras clave C++20
-TEST(LexerTest, Cpp20Keywords) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, Cpp20Keywords) {
     std::string source = "co_await co_return co_yield module import export concept requires";
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     auto tokens = lexer.tokenize();
 
@@ -250,10 +269,9 @@ TEST(LexerTest, Cpp20Keywords) {
 }
 
 // Test para literales booleanos y nullptr
-TEST(LexerTest, BooleanAndNullptrLiterals) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, BooleanAndNullptrLiterals) {
     std::string source = "true false nullptr";
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     auto tokens = lexer.tokenize();
 
@@ -265,26 +283,25 @@ TEST(LexerTest, BooleanAndNullptrLiterals) {
 }
 
 // Test para secuencias de escape
-TEST(LexerTest, EscapeSequences) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, EscapeSequences) {
     std::string source = "'\\n' '\\t' '\\'' '\\\"' '\\\\' '\\x41' '\\u0041' '\\U00000041'";
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     auto tokens = lexer.tokenize();
 
     // Verificar que se reconocieron los literales de caracter con escape
     ASSERT_GE(tokens.size(), 8);
 
-    for (const auto& token : tokens) {
-        EXPECT_EQ(token.getType(), TokenType::CHAR_LITERAL);
+    for (size_t i = 0; i + 1 < tokens.size(); ++i) {
+        EXPECT_EQ(tokens[i].getType(), TokenType::CHAR_LITERAL);
     }
+    EXPECT_EQ(tokens.back().getType(), TokenType::END_OF_FILE);
 }
 
 // Test para concatenación de líneas
-TEST(LexerTest, LineConcatenation) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, LineConcatenation) {
     std::string source = "int main() { \\\n    return 0; \\\n}";
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     auto tokens = lexer.tokenize();
 
@@ -305,10 +322,9 @@ TEST(LexerTest, LineConcatenation) {
 }
 
 // Test para eliminación de espacios en blanco y comentarios
-TEST(LexerTest, WhitespaceAndComments) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, WhitespaceAndComments) {
     std::string source = "int   main()  // comentario\n{  /* otro\n   comentario */  return    0;  }";
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     auto tokens = lexer.tokenize();
 
@@ -322,10 +338,9 @@ TEST(LexerTest, WhitespaceAndComments) {
 }
 
 // Test para estadísticas del lexer
-TEST(LexerTest, LexerStatistics) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, LexerStatistics) {
     std::string source = "/* comentario */\nint main() {\n    return 0;\n}\n// otro comentario";
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     auto tokens = lexer.tokenize();
     auto stats = lexer.getStats();
@@ -338,10 +353,9 @@ TEST(LexerTest, LexerStatistics) {
 }
 
 // Test para manejo de errores
-TEST(LexerTest, ErrorHandling) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, ErrorHandling) {
     std::string source = "int main() { return @; }"; // @ es un carácter inválido
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     auto tokens = lexer.tokenize();
     auto stats = lexer.getStats();
@@ -352,10 +366,9 @@ TEST(LexerTest, ErrorHandling) {
 }
 
 // Test para string vacío
-TEST(LexerTest, EmptyString) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, EmptyString) {
     std::string source = "";
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     auto tokens = lexer.tokenize();
 
@@ -364,10 +377,9 @@ TEST(LexerTest, EmptyString) {
 }
 
 // Test para solo espacios en blanco
-TEST(LexerTest, OnlyWhitespace) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, OnlyWhitespace) {
     std::string source = "   \n\t  \n  ";
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     auto tokens = lexer.tokenize();
 
@@ -376,10 +388,9 @@ TEST(LexerTest, OnlyWhitespace) {
 }
 
 // Test para números con sufijos complejos
-TEST(LexerTest, ComplexNumberSuffixes) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, ComplexNumberSuffixes) {
     std::string source = "123u 456l 789ul 101112LL 131415ull 161718.5f 192021.0L";
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     auto tokens = lexer.tokenize();
 
@@ -393,10 +404,9 @@ TEST(LexerTest, ComplexNumberSuffixes) {
 }
 
 // Test para identificadores con caracteres Unicode (simulado)
-TEST(LexerTest, UnicodeIdentifiers) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, UnicodeIdentifiers) {
     std::string source = "variable_normal _con_guion _doble_guion";
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     auto tokens = lexer.tokenize();
 
@@ -408,10 +418,9 @@ TEST(LexerTest, UnicodeIdentifiers) {
 }
 
 // Test para operadores compuestos
-TEST(LexerTest, CompoundOperators) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, CompoundOperators) {
     std::string source = "a+=b a-=c a*=d a/=e a%=f a&=g a|=h a^=i a<<=j a>>=k a==b a!=c a<=d a>=e a&&f a||g a++ a-- ++a --a";
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     auto tokens = lexer.tokenize();
 
@@ -439,10 +448,9 @@ TEST(LexerTest, CompoundOperators) {
 }
 
 // Test para ámbito (::)
-TEST(LexerTest, ScopeResolution) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, ScopeResolution) {
     std::string source = "std::cout ::global ns::func";
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     auto tokens = lexer.tokenize();
 
@@ -461,11 +469,9 @@ TEST(LexerTest, ScopeResolution) {
 }
 
 // Test para configuración del lexer
-TEST(LexerTest, LexerConfiguration) {
-    DiagnosticEngine diagEngine;
-
+TEST_F(LexerTest, LexerConfiguration) {
     // Configuración por defecto
-    LexerConfig config;
+    frontend::lexer::LexerConfig config;
     EXPECT_TRUE(config.enableUnicodeSupport);
     EXPECT_TRUE(config.enableRawStrings);
     EXPECT_TRUE(config.enableUserDefinedLiterals);
@@ -476,17 +482,16 @@ TEST(LexerTest, LexerConfiguration) {
 
     // Lexer con configuración personalizada
     config.preserveComments = true;
-    Lexer lexer("", diagEngine, config);
+    Lexer lexer("", diagEngine_, config);
 
     auto tokens = lexer.tokenize();
     EXPECT_EQ(tokens.size(), 1); // Solo EOF
 }
 
 // Test para procesamiento de fases del lexer
-TEST(LexerTest, LexerPhasesProcessing) {
-    DiagnosticEngine diagEngine;
+TEST_F(LexerTest, LexerPhasesProcessing) {
     std::string source = "/* comment */ int main() { return 0; } // line comment";
-    Lexer lexer(source, diagEngine);
+    Lexer lexer(source, diagEngine_);
 
     // Ejecutar tokenización completa (todas las fases)
     auto tokens = lexer.tokenize();
@@ -507,3 +512,61 @@ TEST(LexerTest, LexerPhasesProcessing) {
     EXPECT_EQ(stats.commentLines, 2); // Dos líneas de comentario
     EXPECT_EQ(stats.errorCount, 0);
 }
+
+TEST_F(LexerTest, WhitespaceSeparatesTokens) {
+    EXPECT_EQ(lexemes("int x = 42;"),
+              (std::vector<std::string>{"int", "x", "=", "42", ";"}));
+}
+
+TEST_F(LexerTest, NumbersFollowPpNumberGrammar) {
+    EXPECT_EQ(lexemes("0xFFu 202002L 1'000'000 1.5e-3f 0x1p+4 3-1"),
+              (std::vector<std::string>{"0xFFu", "202002L", "1'000'000", "1.5e-3f", "0x1p+4", "3", "-", "1"}));
+}
+
+TEST_F(LexerTest, CommentsAreSkipped) {
+    EXPECT_EQ(lexemes("a // line\nb /* block\n still */ c /*/ x */ d"),
+              (std::vector<std::string>{"a", "b", "c", "d"}));
+}
+
+TEST_F(LexerTest, LineSplicesAreFusedIntoTheCursor) {
+    EXPECT_EQ(lexemes("ab\\\ncd // comment \\\n continued\nef"),
+              (std::vector<std::string>{"abcd", "ef"}));
+}
+
+TEST_F(LexerTest, TrigraphsAreDecoded) {
+    std::string source = "?\?= x";
+    EXPECT_EQ(lexemes(source), (std::vector<std::string>{"#", "x"}));
+
+    frontend::lexer::LexerConfig config;
+    config.enableTrigraphs = false;
+    Lexer lexer(source, diagEngine_, config);
+    EXPECT_EQ(lexer.getNextToken().getType(), TokenType::QUESTION);
+}
+
+TEST_F(LexerTest, TokensAreProducedOnDemand) {
+    std::string source = "first second";
+    Lexer lexer(source, diagEngine_);
+
+    EXPECT_TRUE(lexer.hasMoreTokens());
+    EXPECT_EQ(lexer.peekNextToken().getLexeme(), "first");
+    EXPECT_EQ(lexer.peekNextToken().getLexeme(), "first");
+    EXPECT_EQ(lexer.getNextToken().getLexeme(), "first");
+    EXPECT_EQ(lexer.getNextToken().getLexeme(), "second");
+    EXPECT_EQ(lexer.getNextToken().getType(), TokenType::END_OF_FILE);
+    EXPECT_FALSE(lexer.hasMoreTokens());
+    EXPECT_EQ(lexer.getNextToken().getType(), TokenType::END_OF_FILE);
+}
+
+TEST_F(LexerTest, LocationsPointAtTokenStart) {
+    std::string source = "a\n  /* c */ bb";
+    Lexer lexer(source, diagEngine_);
+
+    Token a = lexer.getNextToken();
+    EXPECT_EQ(a.getLocation().line(), 1u);
+    EXPECT_EQ(a.getLocation().column(), 1u);
+
+    Token bb = lexer.getNextToken();
+    EXPECT_EQ(bb.getLocation().line(), 2u);
+    EXPECT_EQ(bb.getLocation().column(), 11u);
+    EXPECT_EQ(bb.getLocation().offset(), 12u);
+}
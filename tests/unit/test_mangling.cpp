@@ -5,6 +5,7 @@
 
 #include <gtest/gtest.h>
 #include <compiler/backend/mangling/MSVCNameMangler.h>
+#include <compiler/backend/mangling/MSVCDemangler.h>
 #include <compiler/backend/mangling/ClassLayout.h>
 #include <compiler/backend/mangling/VTableGenerator.h>
 
@@ -144,7 +145,8 @@ TEST(ManglingTest, ReferenceTypeMangling) {
 TEST(ManglingTest, ArrayTypeMangling) {
     MSVCNameMangler mangler;
 
-    EXPECT_EQ(mangler.mangleArrayType("int", 10), "Y0AH");  // Array of 10 ints
+    EXPECT_EQ(mangler.mangleArrayType("int", 10), "Y09H");  // Array of 10 ints (10 se codifica '9')
+    EXPECT_EQ(mangler.mangleArrayType("int", 16), "Y0BA@H"); // 16 = 0x10 en hexadecimal A..P
     EXPECT_EQ(mangler.mangleArrayType("char", 0), "QAD");   // Array of unknown size chars
 }
 
@@ -285,6 +287,59 @@ TEST(VTableGeneratorTest, RTTIGeneration) {
     EXPECT_FALSE(rtti.hasVirtualDestructor);
 }
 
+// La vtable solo se emite donde se define la función clave
+TEST(VTableGeneratorTest, KeyFunctionDecidesVTablePlacement) {
+    std::vector<VirtualFunctionInfo> virtualFuncs = {
+        VirtualFunctionInfo("area", "double Shape::area(void)", 0, true),
+        VirtualFunctionInfo("name", "const char* Shape::name(void)", 1),
+        VirtualFunctionInfo("draw", "void Shape::draw(void)", 2)
+    };
+    virtualFuncs[1].isInline = true;
+
+    auto elsewhere = ClassLayoutGenerator::createPolymorphicClass("Shape", {}, virtualFuncs);
+    ASSERT_NE(VTableGenerator::keyFunction(*elsewhere), nullptr);
+    EXPECT_EQ(VTableGenerator::keyFunction(*elsewhere)->name, "draw");
+    EXPECT_EQ(VTableGenerator::vtableLinkage(*elsewhere), VTableLinkage::None);
+
+    virtualFuncs[2].isDefined = true;
+    auto here = ClassLayoutGenerator::createPolymorphicClass("Shape", {}, virtualFuncs);
+    EXPECT_EQ(VTableGenerator::vtableLinkage(*here), VTableLinkage::Strong);
+
+    // Todas inline o puras: cada unidad la emite como COMDAT
+    virtualFuncs[2].isInline = true;
+    auto inlineOnly = ClassLayoutGenerator::createPolymorphicClass("Shape", {}, virtualFuncs);
+    EXPECT_EQ(VTableGenerator::keyFunction(*inlineOnly), nullptr);
+    EXPECT_EQ(VTableGenerator::vtableLinkage(*inlineOnly), VTableLinkage::Comdat);
+
+    auto plain = ClassLayoutGenerator::createSimpleClass("Point", {MemberInfo("x", "int")});
+    EXPECT_EQ(VTableGenerator::vtableLinkage(*plain), VTableLinkage::None);
+}
+
+// El RTTI de una clase sin vtable solo se genera si se usa
+TEST(VTableGeneratorTest, RTTIOnlyWhenUsed) {
+    std::vector<VirtualFunctionInfo> virtualFuncs = {
+        VirtualFunctionInfo("run", "void Task::run(void)", 0)
+    };
+    virtualFuncs[0].isDefined = true;
+    auto task = ClassLayoutGenerator::createPolymorphicClass("Task", {}, virtualFuncs);
+    auto point = ClassLayoutGenerator::createSimpleClass("Point", {MemberInfo("x", "int")});
+
+    VTableGenerator vtableGen;
+    EXPECT_EQ(vtableGen.rttiLinkage(*task), VTableLinkage::Strong);
+    EXPECT_EQ(vtableGen.rttiLinkage(*point), VTableLinkage::None);
+    EXPECT_TRUE(vtableGen.requireRTTI(point->getQualifiedName(), RTTIUse::TypeId));
+    EXPECT_EQ(vtableGen.rttiLinkage(*point), VTableLinkage::Comdat);
+
+    // -fno-rtti: solo las excepciones generan type_info
+    VTableGenerator noRtti;
+    noRtti.setRTTIEnabled(false);
+    EXPECT_EQ(noRtti.rttiLinkage(*task), VTableLinkage::None);
+    EXPECT_FALSE(noRtti.requireRTTI(task->getQualifiedName(), RTTIUse::DynamicCast));
+    EXPECT_EQ(noRtti.rttiLinkage(*task), VTableLinkage::None);
+    EXPECT_TRUE(noRtti.requireRTTI(task->getQualifiedName(), RTTIUse::Exception));
+    EXPECT_EQ(noRtti.rttiLinkage(*task), VTableLinkage::Comdat);
+}
+
 // Test para compatibilidad de layouts
 TEST(ClassLayoutTest, LayoutCompatibility) {
     // Crear dos layouts idénticos
@@ -325,6 +380,37 @@ TEST(ManglingUtilsTest, NameValidation) {
     EXPECT_TRUE(demangled.length() > 0);
 }
 
+// Test para la caché de layouts y el análisis de relleno
+TEST(ClassLayoutTest, CacheResolvesClassMembersAndReportsPadding) {
+    ClassLayoutCache cache;
+    cache.setPaddingAnalysis(true, 10);
+
+    auto& inner = cache.declareClass("Inner", "ns");
+    inner.addDataMember(MemberInfo("tag", "char"));
+    inner.addDataMember(MemberInfo("value", "int"));
+
+    auto& hot = cache.declareClass("Hot");
+    hot.addDataMember(MemberInfo("flag", "bool"));
+    hot.addDataMember(MemberInfo("count", "long long"));
+    hot.addDataMember(MemberInfo("inner", "ns::Inner"));
+    hot.addDataMember(MemberInfo("kind", "char"));
+
+    const ClassLayout* layout = cache.getLayout("Hot");
+    ASSERT_NE(layout, nullptr);
+    EXPECT_EQ(layout->getDataMembers()[2].offset, 16u);    // ns::Inner: 8 bytes, alineación 4
+    EXPECT_EQ(layout->getSize(), 32u);
+    EXPECT_EQ(cache.getLayout("Hot"), layout);
+    EXPECT_EQ(cache.computedLayouts(), 2u);
+    EXPECT_EQ(cache.getLayout("Missing"), nullptr);
+
+    PaddingReport report = layout->analyzePadding();
+    EXPECT_EQ(report.paddingBytes, 14u);
+    EXPECT_EQ(report.suggestedOrder, (std::vector<std::string>{"count", "inner", "flag", "kind"}));
+    EXPECT_EQ(report.suggestedSize, 24u);
+    EXPECT_EQ(report.bytesSaved(), 8u);
+    EXPECT_EQ(cache.paddingReports().size(), 2u);
+}
+
 // Test para herencia múltiple en VTable
 TEST(VTableGeneratorTest, MultipleInheritance) {
     // Crear layout con herencia múltiple
@@ -346,3 +432,57 @@ TEST(VTableGeneratorTest, MultipleInheritance) {
     // El layout debería ser válido
     EXPECT_TRUE(layout->isMSVCCompatible());
 }
+
+// Test para el demangler: inverso del mangler
+TEST(DemanglerTest, RoundTrip) {
+    MSVCNameMangler mangler;
+
+    FunctionInfo funcInfo;
+    funcInfo.name = "area";
+    funcInfo.scope = "geo::Shape";
+    funcInfo.returnType = "double";
+    funcInfo.parameterTypes = {"int*", "char", "int*"};
+    funcInfo.qualifiers = FunctionQualifiers::Const;
+    funcInfo.isVirtual = true;
+    EXPECT_EQ(MSVCDemangler::demangle(mangler.mangleFunction(funcInfo)),
+              "virtual double geo::Shape::area(int*, char, int*) const");
+
+    VariableInfo varInfo{"counter", "app", "unsigned long long", false, false};
+    EXPECT_EQ(MSVCDemangler::demangle(mangler.mangleVariable(varInfo)), "unsigned long long app::counter");
+
+    EXPECT_EQ(MSVCDemangler::demangle(mangler.generateVTableName("Shape", "geo")),
+              "const geo::Shape::`vftable'");
+
+    // Lo que no es del mangler no se toca
+    std::string buffer = "x";
+    EXPECT_FALSE(MSVCDemangler::demangle("_main", buffer));
+    EXPECT_EQ(buffer, "x");
+    EXPECT_EQ(MSVCDemangler::demangle("?testFunction@@YAXXZ"), "?testFunction@@YAXXZ");
+}
+
+// Test para el índice de símbolos ordenado por nombre desmangled
+TEST(DemanglerTest, SymbolIndexSortsAndFinds) {
+    MSVCNameMangler mangler;
+    std::vector<std::string> names;
+    for (const char* name : {"zeta", "alpha", "beta"}) {
+        FunctionInfo funcInfo;
+        funcInfo.name = name;
+        funcInfo.returnType = "int";
+        names.push_back(mangler.mangleFunction(funcInfo));
+    }
+    names.push_back("_main");
+    std::string alpha = names[1];
+
+    auto index = SymbolIndex::build(std::move(names), 2);
+    ASSERT_EQ(index.size(), 4u);
+    EXPECT_EQ(index[0].demangled, "_main");
+    EXPECT_EQ(index[1].demangled, "int alpha(void)");
+    EXPECT_EQ(index[3].demangled, "int zeta(void)");
+    EXPECT_EQ(index.demangledByOrdinal(2), "int beta(void)");
+
+    auto [first, last] = index.findPrefix("int ");
+    EXPECT_EQ(first, 1u);
+    EXPECT_EQ(last, 4u);
+    EXPECT_EQ(index.findMangled(alpha), 1u);
+    EXPECT_EQ(index.findMangled("?missing"), index.size());
+}
@@ -0,0 +1,234 @@
+/**
+ * @file test_memory_pool.cpp
+ * @brief Tests para la arena MemoryPool y ArenaAllocator
+ */
+
+#include <compiler/common/utils/MemoryPool.h>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace cpp20::compiler::common::utils;
+
+TEST(MemoryPoolTest, AllocationsRespectAlignment) {
+    MemoryPool pool(1024);
+
+    for (size_t alignment : {1u, 2u, 4u, 8u, 16u, 32u, 64u}) {
+        pool.allocate(3, 1); // desalinear el cursor
+        void* p = pool.allocate(24, alignment);
+        ASSERT_NE(p, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % alignment, 0u);
+    }
+}
+
+TEST(MemoryPoolTest, DeallocatedSmallBlocksAreReused) {
+    MemoryPool pool(1024);
+
+    void* first = pool.allocate(40);
+    pool.deallocate(first, 40);
+
+    // Misma clase de tamaño (33..48 bytes) reutiliza el hueco
+    void* second = pool.allocate(48);
+    EXPECT_EQ(first, second);
+}
+
+TEST(MemoryPoolTest, ReusedSmallBlocksKeepClassAlignment) {
+    MemoryPool pool(1024);
+
+    pool.allocate(289, 1); // fuera de las clases: deja el cursor desalineado
+    void* p = pool.allocate(16, 8);
+    pool.deallocate(p, 16);
+
+    void* q = pool.allocate(16, 16);
+    ASSERT_NE(q, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(q) % 16, 0u);
+}
+
+TEST(MemoryPoolTest, ResetReusesBlocksWithoutGrowing) {
+    MemoryPool pool(256);
+
+    for (int i = 0; i < 64; ++i) {
+        pool.allocate(64);
+    }
+    size_t allocated = pool.totalAllocated();
+    EXPECT_GT(allocated, 256u);
+
+    pool.reset();
+    EXPECT_EQ(pool.totalUsed(), 0u);
+
+    for (int i = 0; i < 64; ++i) {
+        pool.allocate(64);
+    }
+    EXPECT_EQ(pool.totalAllocated(), allocated);
+}
+
+TEST(MemoryPoolTest, ReleaseReturnsExtraBlocks) {
+    MemoryPool pool(256);
+
+    for (int i = 0; i < 64; ++i) {
+        pool.allocate(64);
+    }
+    pool.release();
+
+    EXPECT_EQ(pool.totalAllocated(), 256u);
+    EXPECT_EQ(pool.totalUsed(), 0u);
+}
+
+TEST(MemoryPoolTest, LargeAllocationsGetTheirOwnBlock) {
+    MemoryPool pool(256);
+
+    auto* bytes = static_cast<char*>(pool.allocate(4096));
+    ASSERT_NE(bytes, nullptr);
+    bytes[0] = 'a';
+    bytes[4095] = 'z';
+    EXPECT_GE(pool.totalUsed(), 4096u);
+
+    pool.reset();
+    EXPECT_EQ(pool.totalAllocated(), 256u);
+}
+
+TEST(MemoryPoolTest, CreateRunsDestructorsOnReset) {
+    static int destroyed = 0;
+    struct Tracked {
+        int value;
+        explicit Tracked(int v) : value(v) {}
+        ~Tracked() { ++destroyed; }
+    };
+
+    destroyed = 0;
+    MemoryPool pool;
+    Tracked* a = pool.create<Tracked>(1);
+    Tracked* b = pool.create<Tracked>(2);
+    EXPECT_EQ(a->value, 1);
+    EXPECT_EQ(b->value, 2);
+
+    pool.reset();
+    EXPECT_EQ(destroyed, 2);
+}
+
+TEST(MemoryPoolTest, ArenaAllocatorBacksStandardContainers) {
+    MemoryPool pool(4096);
+    {
+        std::vector<int, ArenaAllocator<int>> values{ArenaAllocator<int>(pool)};
+        for (int i = 0; i < 1000; ++i) {
+            values.push_back(i);
+        }
+        EXPECT_EQ(values.size(), 1000u);
+        EXPECT_EQ(values[999], 999);
+
+        using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+        ArenaString text{ArenaAllocator<char>(pool)};
+        text.append(200, 'x');
+        EXPECT_EQ(text.size(), 200u);
+    }
+    EXPECT_GT(pool.totalUsed(), 0u);
+}
+
+TEST(MemoryPoolTest, TrackedBlocksAreChargedToTheirSubsystem) {
+    MemoryTracker::setEnabled(true);
+    MemoryCounters before = MemoryTracker::counters(MemorySubsystem::AST);
+    {
+        MemoryScope scope(MemorySubsystem::AST);
+        MemoryPool pool(1024);
+        EXPECT_EQ(pool.subsystem(), MemorySubsystem::AST);
+        pool.allocate(2000);    // Asignación grande, fuera de bloque
+
+        MemoryCounters during = MemoryTracker::counters(MemorySubsystem::AST);
+        EXPECT_EQ(during.current - before.current, 1024u + 2000u);
+
+        // Cambiar de subsistema mueve lo ya reservado
+        pool.setSubsystem(MemorySubsystem::Tokens);
+        EXPECT_EQ(MemoryTracker::counters(MemorySubsystem::AST).current, before.current);
+        EXPECT_GE(MemoryTracker::counters(MemorySubsystem::Tokens).current, 1024u + 2000u);
+    }
+    EXPECT_EQ(MemoryTracker::counters(MemorySubsystem::AST).current, before.current);
+    EXPECT_EQ(MemoryTracker::current(), MemorySubsystem::Other);
+    MemoryTracker::setEnabled(false);
+}
+
+TEST(MemoryPoolTest, PeakWindowsSeeTransientAllocations) {
+    MemoryTracker::setEnabled(true);
+    size_t outer = MemoryTracker::beginPeakWindow();
+    size_t base = MemoryTracker::totalCurrent();
+    {
+        size_t inner = MemoryTracker::beginPeakWindow();
+        {
+            MemoryPool pool(64 * 1024);
+        }
+        EXPECT_GE(MemoryTracker::endPeakWindow(inner), base + 64 * 1024);
+    }
+    // La ventana de fuera también ve el pico de la de dentro
+    EXPECT_GE(MemoryTracker::endPeakWindow(outer), base + 64 * 1024);
+    EXPECT_EQ(MemoryTracker::totalCurrent(), base);
+    MemoryTracker::setEnabled(false);
+}
+
+TEST(MemoryPoolTest, RollbackDiscardsSpeculativeAllocations) {
+    MemoryPool pool(256);
+    void* kept = pool.allocate(32);
+    size_t usedBefore = pool.totalUsed();
+
+    MemoryPool::Checkpoint checkpoint = pool.checkpoint();
+    EXPECT_TRUE(pool.isSpeculating());
+    void* first = pool.allocate(64);
+    pool.allocate(200);     // Pasa al bloque siguiente
+    pool.allocate(1000);    // Asignación grande
+    pool.deallocate(first, 64);    // No entra en la lista libre: su memoria se descarta
+    pool.rollback(checkpoint);
+
+    EXPECT_FALSE(pool.isSpeculating());
+    EXPECT_EQ(pool.totalUsed(), usedBefore);
+    // Lo siguiente reutiliza la memoria descartada, justo detrás de lo conservado
+    EXPECT_EQ(pool.allocate(64), first);
+    EXPECT_NE(kept, first);
+
+    // Un intento confirmado se queda
+    checkpoint = pool.checkpoint();
+    pool.allocate(16);
+    pool.commit(checkpoint);
+    EXPECT_EQ(pool.totalUsed(), usedBefore + 64 + 16);
+}
+
+TEST(MemoryPoolTest, ReservedRegionBacksBlocksContiguously) {
+    ArenaBacking backing;
+    backing.reserveBytes = 4 * 4096;
+    backing.numaNode = ArenaBacking::currentNumaNode();
+    EXPECT_GE(backing.numaNode, 0);
+
+    MemoryPool pool(4096, 1, backing);
+    ASSERT_GE(pool.reservedBytes(), backing.reserveBytes);
+
+    // Cada bloque nuevo sigue al anterior dentro de la región
+    auto* first = static_cast<char*>(pool.allocate(4000));
+    auto* second = static_cast<char*>(pool.allocate(4000));
+    EXPECT_EQ(second, first + 4096);
+
+    // Agotada la región, los bloques salen de malloc
+    for (int i = 0; i < 8; ++i) {
+        std::memset(pool.allocate(4000), 0xab, 4000);
+    }
+    EXPECT_EQ(pool.totalAllocated(), 10u * 4096);
+
+    // release() devuelve la región salvo el bloque inicial y la vuelve a repartir
+    pool.release();
+    EXPECT_EQ(pool.totalAllocated(), 4096u);
+    EXPECT_EQ(pool.allocate(4000), first);
+    EXPECT_EQ(pool.allocate(4000), second);
+}
+
+TEST(MemoryPoolTest, LargePagesFallBackWhenUnavailable) {
+    ArenaBacking backing;
+    backing.reserveBytes = 8 * 1024 * 1024;
+    backing.largePages = true;
+
+    // Con o sin páginas grandes en el sistema, el pool funciona igual
+    MemoryPool pool(64 * 1024, 1, backing);
+    EXPECT_GE(pool.reservedBytes(), backing.reserveBytes);
+    std::vector<int, ArenaAllocator<int>> values{ArenaAllocator<int>(pool)};
+    for (int i = 0; i < 100000; ++i) {
+        values.push_back(i);
+    }
+    EXPECT_EQ(values[99999], 99999);
+}
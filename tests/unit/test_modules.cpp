@@ -6,6 +6,9 @@
 #include <gtest/gtest.h>
 #include <memory>
 #include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
 #include <compiler/modules/ModuleSystem.h>
 
 using namespace cpp20::compiler::modules;
@@ -133,6 +136,49 @@ TEST(ModuleDependencyScannerTest, ExtractImportName) {
     EXPECT_EQ(scanner.extractImportName("import math.utils;"), "math.utils");
 }
 
+TEST(P1689ScannerTest, SkipsCommentsAndLiterals) {
+    auto rule = P1689Scanner::scanBuffer(
+        "module;\n"
+        "#include \"config.h\"\n"
+        "export module app:part;\n"
+        "/* import hidden;\n"
+        "import hidden2; */\n"
+        "auto text = R\"x(\nimport raw;\n)x\";\n"
+        "int n = 1'000; // import comment;\n"
+        "  export import core;\n"
+        "import :util;\n"
+        "import <vector>;\n"
+        "import \"local.h\";\n"
+        "int import_count = 0;\n");
+
+    EXPECT_TRUE(rule.success);
+    EXPECT_EQ(rule.provides, "app:part");
+    EXPECT_TRUE(rule.isInterface);
+    ASSERT_EQ(rule.requirements.size(), 4u);
+    EXPECT_EQ(rule.requirements[0].logicalName, "core");
+    EXPECT_TRUE(rule.requirements[0].isExported);
+    EXPECT_EQ(rule.requirements[0].line, 10u);
+    EXPECT_EQ(rule.requirements[1].logicalName, "app:util");
+    EXPECT_EQ(rule.requirements[2].logicalName, "vector");
+    EXPECT_TRUE(rule.requirements[2].isHeaderUnit);
+    EXPECT_TRUE(rule.requirements[2].isAngled);
+    EXPECT_FALSE(rule.requirements[3].isAngled);
+}
+
+TEST(P1689ScannerTest, FormatJson) {
+    auto rule = P1689Scanner::scanBuffer("module app;\nimport <vector>;\n", "impl.cpp");
+    rule.primaryOutput = "impl.o";
+    EXPECT_TRUE(rule.provides.empty());
+    EXPECT_EQ(rule.implements, "app");
+
+    std::string json = P1689Scanner::formatJson({rule});
+    EXPECT_NE(json.find("\"primary-output\": \"impl.o\""), std::string::npos);
+    EXPECT_NE(json.find("\"logical-name\": \"app\""), std::string::npos);
+    EXPECT_NE(json.find("\"lookup-method\": \"include-angle\""), std::string::npos);
+    EXPECT_EQ(json.find("\"provides\""), std::string::npos);
+    EXPECT_NE(json.find("\"version\": 1"), std::string::npos);
+}
+
 // Test para ModuleCache
 TEST(ModuleCacheTest, BasicCreation) {
     std::filesystem::path cacheDir("./test_cache");
@@ -171,6 +217,113 @@ TEST(ModuleCacheTest, StoreAndRetrieve) {
     EXPECT_EQ(stats.hits, 1);
 }
 
+TEST(ModuleCacheTest, InterfaceHashInvalidation) {
+    BinaryModuleInterface core("core");
+    core.addExportedEntity(ExportedEntity("f", "core::f", ExportType::Function, "core.ixx:3"));
+    core.addExportedEntity(ExportedEntity("T", "core::T", ExportType::Type));
+    uint64_t coreHash = core.calculateInterfaceHash();
+
+    // Ubicación y orden no forman parte de la interfaz
+    BinaryModuleInterface moved("core");
+    moved.addExportedEntity(ExportedEntity("T", "core::T", ExportType::Type));
+    moved.addExportedEntity(ExportedEntity("f", "core::f", ExportType::Function, "core.ixx:9"));
+    EXPECT_EQ(moved.calculateInterfaceHash(), coreHash);
+    moved.addExportedEntity(ExportedEntity("g", "core::g", ExportType::Function));
+    EXPECT_NE(moved.calculateInterfaceHash(), coreHash);
+
+    ModuleCache cache("./test_interface_cache");
+    BinaryModuleInterface app("app");
+    app.addExportedEntity(ExportedEntity("main", "app::main", ExportType::Function));
+    ModuleDependency dep("core", true);
+    dep.interfaceHash = coreHash;
+    app.addDependency(dep);
+    ASSERT_TRUE(cache.store("app", app));
+
+    CompilationOptionsHash options;
+    EXPECT_TRUE(cache.isValid("app", options, {{"core", coreHash}}));
+    EXPECT_FALSE(cache.isValid("app", options, {{"core", moved.calculateInterfaceHash()}}));
+    EXPECT_FALSE(cache.isValid("app", options, {}));
+}
+
+TEST(ModuleCacheTest, CollectGarbageEvictsLeastRecentlyUsed) {
+    std::filesystem::path cacheDir("./test_gc_cache");
+    std::filesystem::remove_all(cacheDir);
+    ModuleCache cache(cacheDir);
+
+    for (const char* name : {"old", "mid", "new"}) {
+        BinaryModuleInterface bmi(name);
+        bmi.addExportedEntity(ExportedEntity("f", "f", ExportType::Function));
+        ASSERT_TRUE(cache.store(name, bmi));
+    }
+    auto bmiFiles = [&] {
+        std::vector<std::filesystem::path> files;
+        for (const auto& entry : std::filesystem::directory_iterator(cacheDir)) {
+            if (entry.path().extension() == ".bmi") files.push_back(entry.path());
+        }
+        return files;
+    };
+    auto files = bmiFiles();
+    ASSERT_EQ(files.size(), 3u);
+    uint64_t entrySize = std::filesystem::file_size(files[0]);
+
+    // Fechas explícitas: old es el menos usado aunque se escribiera el último
+    auto now = std::filesystem::file_time_type::clock::now();
+    ASSERT_TRUE(cache.retrieve("old") != nullptr);
+    for (const auto& file : files) {
+        std::filesystem::last_write_time(file, now - std::chrono::minutes(10));
+    }
+    ASSERT_TRUE(cache.retrieve("mid") != nullptr);
+    ASSERT_TRUE(cache.retrieve("new") != nullptr);
+
+    EXPECT_EQ(cache.collectGarbage(2 * entrySize + entrySize / 2), 1u);
+    EXPECT_TRUE(cache.retrieve("old") == nullptr);
+    EXPECT_TRUE(cache.retrieve("mid") != nullptr);
+    EXPECT_TRUE(cache.retrieve("new") != nullptr);
+    std::filesystem::remove_all(cacheDir);
+}
+
+TEST(ModuleCacheTest, ParallelImportersShareOneLoadedBMI) {
+    std::filesystem::path cacheDir("./test_shared_bmi_cache");
+    std::filesystem::remove_all(cacheDir);
+    {
+        ModuleCache writer(cacheDir);
+        BinaryModuleInterface bmi("core");
+        bmi.addExportedEntity(ExportedEntity("Vector", "core::Vector", ExportType::Type));
+        ASSERT_TRUE(writer.store("core", bmi));
+    }
+
+    // Una caché por trabajo, como en -j: el registro es del proceso
+    constexpr size_t kWorkers = 8;
+    std::vector<std::unique_ptr<ModuleCache>> caches;
+    std::vector<std::shared_ptr<const BinaryModuleInterface>> loaded(kWorkers);
+    for (size_t i = 0; i < kWorkers; ++i) caches.push_back(std::make_unique<ModuleCache>(cacheDir));
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < kWorkers; ++i) {
+        workers.emplace_back([&, i] { loaded[i] = caches[i]->retrieve("core"); });
+    }
+    for (auto& worker : workers) worker.join();
+
+    size_t shared = 0;
+    for (size_t i = 0; i < kWorkers; ++i) {
+        ASSERT_TRUE(loaded[i] != nullptr);
+        EXPECT_EQ(loaded[i].get(), loaded[0].get());
+        shared += caches[i]->getStats().sharedHits;
+    }
+    EXPECT_EQ(shared, kWorkers - 1);                // Una sola deserialización
+    EXPECT_EQ(loaded[0]->getExportedEntities()[0].name, "Vector");
+
+    // Sin importadores el BMI se libera; otro contenido es otra entrada
+    loaded.clear();
+    BinaryModuleInterface changed("core");
+    changed.addExportedEntity(ExportedEntity("Map", "core::Map", ExportType::Type));
+    ASSERT_TRUE(caches[0]->store("core", changed));
+    auto reloaded = caches[0]->retrieve("core");
+    ASSERT_TRUE(reloaded != nullptr);
+    EXPECT_EQ(reloaded->getExportedEntities()[0].name, "Map");
+    EXPECT_EQ(caches[0]->getStats().sharedHits, 0u);
+    std::filesystem::remove_all(cacheDir);
+}
+
 // Test para ModuleSystem
 TEST(ModuleSystemTest, BasicCreation) {
     std::filesystem::path cacheDir("./test_module_cache");
@@ -200,6 +353,57 @@ TEST(ModuleSystemTest, ModuleExists) {
     EXPECT_FALSE(system.moduleExists("math"));
 }
 
+TEST(ModuleSystemTest, CompileModuleGraph) {
+    std::filesystem::path sourceDir("./test_graph_sources");
+    std::filesystem::create_directories(sourceDir);
+    auto writeSource = [&](const std::string& file, const std::string& text) {
+        std::ofstream(sourceDir / file) << text;
+        return sourceDir / file;
+    };
+
+    std::filesystem::remove_all("./test_graph_cache");
+    ModuleSystem system("./test_graph_cache");
+    system.setParallelJobs(4);
+    ASSERT_TRUE(system.processSourceFile(writeSource("core.ixx", "export module core;\n")));
+    ASSERT_TRUE(system.processSourceFile(writeSource("util.ixx", "export module util;\n")));
+    ASSERT_TRUE(system.processSourceFile(writeSource("part.ixx", "export module app:part;\nimport core;\n")));
+    ASSERT_TRUE(system.processSourceFile(writeSource("app.ixx", "export module app;\nimport :part;\nimport core;\n")));
+    system.setModuleCost("core", 50.0);
+
+    auto graph = system.buildModuleGraph("app");
+    ASSERT_TRUE(graph.acyclic);
+    ASSERT_EQ(graph.modules.size(), 3u);
+    EXPECT_EQ(graph.modules.back(), "app");
+    for (size_t i = 0; i < graph.modules.size(); ++i) {
+        for (size_t dep : graph.dependencies[i]) {
+            EXPECT_LT(dep, i);
+        }
+    }
+    EXPECT_EQ(graph.modules.front(), "core");
+    EXPECT_GT(graph.criticalPath.front(), 50.0);
+
+    EXPECT_TRUE(system.compileModule("app"));
+    EXPECT_EQ(system.getStats().interfacesCompiled, 3u);
+    EXPECT_EQ(system.getModuleDependencies("app").size(), 2u);
+    EXPECT_GE(system.getModuleCost("app:part"), 0.0);
+
+    // Un cambio que no toca la interfaz de core no se propaga a app
+    writeSource("core.ixx", "export module core;\nint helper() { return 1; }\n");
+    system.invalidateModule("core");
+    EXPECT_TRUE(system.compileModule("app"));
+    EXPECT_EQ(system.getStats().interfacesCompiled, 4u);
+
+    // Otro compilador sobre la misma caché reutiliza los BMI publicados
+    ModuleSystem other("./test_graph_cache");
+    for (const char* file : {"core.ixx", "part.ixx", "app.ixx"}) {
+        ASSERT_TRUE(other.processSourceFile(sourceDir / file));
+    }
+    EXPECT_TRUE(other.compileModule("app"));
+    EXPECT_EQ(other.getStats().interfacesCompiled, 0u);
+
+    std::filesystem::remove_all(sourceDir);
+}
+
 // Test para tipos de datos
 TEST(ModuleTypesTest, ExportTypeValues) {
     EXPECT_EQ(static_cast<int>(ExportType::Type), 0);
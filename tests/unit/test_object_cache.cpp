@@ -0,0 +1,118 @@
+/**
+ * @file test_object_cache.cpp
+ * @brief Tests para la caché de objetos por unidad de traducción
+ */
+
+#include <compiler/driver/ObjectCache.h>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+using namespace cpp20::compiler;
+using namespace cpp20::compiler::diagnostics;
+
+namespace {
+
+class ObjectCacheTest : public ::testing::Test {
+protected:
+    std::filesystem::path root_ = std::filesystem::temp_directory_path() / "object_cache_test";
+    std::filesystem::path source_ = root_ / "src" / "unit.cpp";
+    std::filesystem::path header_ = root_ / "src" / "unit.h";
+    std::shared_ptr<CacheBackend> backend_;
+
+    void SetUp() override {
+        std::filesystem::remove_all(root_);
+        std::filesystem::create_directories(root_ / "src");
+        write(source_, "#include \"unit.h\"\nint f() { return g(); }\n");
+        write(header_, "int g();\n");
+        backend_ = std::make_shared<DirectoryCacheBackend>(root_ / "cache");
+    }
+
+    void TearDown() override { std::filesystem::remove_all(root_); }
+
+    static void write(const std::filesystem::path& path, const std::string& content) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << content;
+    }
+
+    // Cada invocación parte de un SourceManager nuevo, con otros fileId
+    struct Session {
+        std::shared_ptr<SourceManager> sources = std::make_shared<SourceManager>();
+        std::unique_ptr<ObjectCache> cache;
+        uint32_t sourceId = 0;
+    };
+
+    Session open(uint64_t namespaceKey = 1) {
+        Session session;
+        session.sources->createVirtualFile("// desplaza los fileId\n", "padding.cpp");
+        session.cache = std::make_unique<ObjectCache>(backend_, session.sources, namespaceKey);
+        session.sourceId = session.sources->loadFile(source_);
+        return session;
+    }
+
+    void compileAndStore(Session& session) {
+        uint32_t headerId = session.sources->loadFile(header_);
+        Diagnostic warning(DiagnosticLevel::Warning, DiagnosticCode::WARN_UNUSED_VARIABLE,
+                           SourceLocation(1, 5, 4, headerId), "%0 sin usar en %1");
+        warning.addArgument(DeclRef{7});
+        warning.addArgument(SourceLocation(2, 1, 18, session.sourceId));
+        ASSERT_TRUE(session.cache->store(session.sourceId, {headerId, headerId}, {1, 2, 3}, {warning}));
+    }
+};
+
+} // namespace
+
+TEST_F(ObjectCacheTest, HitReplaysObjectAndDiagnosticsInTheNewSession) {
+    Session first = open();
+    EXPECT_FALSE(first.cache->lookup(first.sourceId).has_value());
+    compileAndStore(first);
+    EXPECT_EQ(first.cache->missCount(), 1u);
+    EXPECT_EQ(first.cache->storeCount(), 1u);
+
+    Session second = open();
+    second.sources->createVirtualFile("// otro desplazamiento\n", "padding2.cpp");
+    auto cached = second.cache->lookup(second.sourceId);
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_EQ(second.cache->hitCount(), 1u);
+    EXPECT_EQ(cached->image, (std::vector<uint8_t>{1, 2, 3}));
+
+    ASSERT_EQ(cached->diagnostics.size(), 1u);
+    const Diagnostic& diagnostic = cached->diagnostics[0];
+    EXPECT_EQ(diagnostic.level(), DiagnosticLevel::Warning);
+    EXPECT_EQ(diagnostic.code(), DiagnosticCode::WARN_UNUSED_VARIABLE);
+    EXPECT_EQ(diagnostic.message(), "%0 sin usar en %1");
+    // Los fileId se traducen a los de esta sesión
+    const SourceFile* header = second.sources->getFile(diagnostic.location().fileId());
+    ASSERT_NE(header, nullptr);
+    EXPECT_EQ(header->path.filename(), "unit.h");
+    EXPECT_EQ(diagnostic.location().column(), 5u);
+    ASSERT_EQ(diagnostic.arguments().size(), 2u);
+    EXPECT_EQ(diagnostic.arguments()[0].asDeclId(), 7u);
+    EXPECT_EQ(diagnostic.arguments()[1].asLocation().fileId(), second.sourceId);
+}
+
+TEST_F(ObjectCacheTest, ChangedHeaderOptionsOrSourceMiss) {
+    Session first = open();
+    compileAndStore(first);
+
+    Session otherOptions = open(2);
+    EXPECT_FALSE(otherOptions.cache->lookup(otherOptions.sourceId).has_value());
+
+    write(header_, "long g();\n");
+    Session changedHeader = open();
+    EXPECT_FALSE(changedHeader.cache->lookup(changedHeader.sourceId).has_value());
+
+    // La nueva versión se publica junto a la anterior y ambas aciertan
+    compileAndStore(changedHeader);
+    Session again = open();
+    EXPECT_TRUE(again.cache->lookup(again.sourceId).has_value());
+    write(header_, "int g();\n");
+    Session restored = open();
+    EXPECT_TRUE(restored.cache->lookup(restored.sourceId).has_value());
+
+    write(source_, "#include \"unit.h\"\nint f() { return g() + 1; }\n");
+    Session changedSource = open();
+    EXPECT_FALSE(changedSource.cache->lookup(changedSource.sourceId).has_value());
+}
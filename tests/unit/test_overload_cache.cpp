@@ -0,0 +1,156 @@
+/**
+ * @file test_overload_cache.cpp
+ * @brief Tests para la poda y la memorización de la resolución de sobrecargas
+ */
+
+#include <compiler/symbols/OverloadCache.h>
+#include <compiler/frontend/lexer/IdentifierTable.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+using namespace cpp20::compiler;
+using frontend::lexer::IdentifierTable;
+using types::BasicType;
+
+namespace {
+
+/**
+ * @brief Tipo de clase que TypeContext todavía no sabe unificar
+ */
+class OpaqueClassType : public types::Type {
+public:
+    OpaqueClassType() : Type(Kind::Class) {}
+
+    std::string toString() const override { return "opaque"; }
+    size_t size() const override { return 1; }
+    size_t alignment() const override { return 1; }
+    bool isComplete() const override { return true; }
+    bool equals(const Type* other) const override { return other == this; }
+    std::unique_ptr<Type> withCV(types::CVQualifier) const override { return std::make_unique<OpaqueClassType>(); }
+};
+
+class OverloadCacheTest : public ::testing::Test {
+protected:
+    IdentifierTable identifiers_;
+    types::TypeContext types_;
+    symbols::SymbolArena arena_;
+
+    const types::Type* basic(BasicType::BasicKind kind) { return types_.getBasicType(kind); }
+
+    const symbols::FunctionSymbol* function(const char* name, std::vector<const types::Type*> parameters) {
+        return arena_.createFunction(identifiers_.get(name), basic(BasicType::BasicKind::Void), parameters);
+    }
+};
+
+} // namespace
+
+TEST_F(OverloadCacheTest, PruningRejectsOnlyImpossibleFirstArguments) {
+    const types::Type* intType = basic(BasicType::BasicKind::Int);
+    const types::Type* doubleType = basic(BasicType::BasicKind::Double);
+    const types::Type* pointer = types_.getPointerType(intType);
+    OpaqueClassType opaque;
+
+    // Misma categoría, referencias y punteros a aritméticos (bool) pasan
+    EXPECT_TRUE(symbols::mayConvert(intType, doubleType));
+    EXPECT_TRUE(symbols::mayConvert(types_.getReferenceType(intType), doubleType));
+    EXPECT_TRUE(symbols::mayConvert(intType, types_.getReferenceType(doubleType, true)));
+    EXPECT_TRUE(symbols::mayConvert(pointer, basic(BasicType::BasicKind::Bool)));
+
+    // Un tipo de clase puede tener conversiones definidas por el usuario
+    EXPECT_TRUE(symbols::mayConvert(&opaque, intType));
+    EXPECT_TRUE(symbols::mayConvert(intType, &opaque));
+
+    // Ninguna conversión implícita lleva un entero a un puntero
+    EXPECT_FALSE(symbols::mayConvert(intType, pointer));
+    EXPECT_FALSE(symbols::mayConvert(intType, types_.getReferenceType(pointer)));
+    EXPECT_FALSE(symbols::mayConvert(nullptr, intType));
+
+    const symbols::FunctionSymbol* takesPointer = function("f", {pointer, intType});
+    const symbols::FunctionSymbol* takesInts = function("f", {intType, intType});
+    const symbols::FunctionSymbol* takesNothing = function("f", {});
+    std::vector<const types::Type*> arguments = {intType, doubleType};
+    EXPECT_FALSE(symbols::mayBeViable(*takesPointer, arguments));
+    EXPECT_TRUE(symbols::mayBeViable(*takesInts, arguments));
+    EXPECT_FALSE(symbols::mayBeViable(*takesNothing, arguments));
+    EXPECT_TRUE(symbols::mayBeViable(*takesNothing, {}));
+}
+
+TEST_F(OverloadCacheTest, RepeatedCallsAreResolvedOnce) {
+    const types::Type* intType = basic(BasicType::BasicKind::Int);
+    std::vector<const symbols::FunctionSymbol*> candidates = {
+        function("print", {intType}),
+        function("print", {basic(BasicType::BasicKind::Double)}),
+    };
+
+    symbols::OverloadCache cache(types_);
+    std::vector<const types::Type*> arguments = {intType};
+    auto key = cache.makeKey(candidates, arguments);
+    EXPECT_FALSE(cache.find(key).has_value());
+    cache.store(std::move(key), candidates[0]);
+
+    // Un tipo equivalente creado fuera del contexto da la misma clave
+    BasicType looseInt(BasicType::BasicKind::Int);
+    std::vector<const types::Type*> loose = {&looseInt};
+    auto cached = cache.find(cache.makeKey(candidates, loose));
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_EQ(*cached, candidates[0]);
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.entries, 1u);
+}
+
+TEST_F(OverloadCacheTest, FailuresAreMemoizedToo) {
+    const types::Type* pointer = types_.getPointerType(basic(BasicType::BasicKind::Char));
+    std::vector<const symbols::FunctionSymbol*> candidates = {function("g", {pointer})};
+    std::vector<const types::Type*> arguments = {basic(BasicType::BasicKind::Int)};
+
+    symbols::OverloadCache cache(types_);
+    cache.store(cache.makeKey(candidates, arguments), nullptr);
+
+    auto cached = cache.find(cache.makeKey(candidates, arguments));
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_EQ(*cached, nullptr);
+}
+
+TEST_F(OverloadCacheTest, KeysSeparateOverloadSetsAndArgumentTypes) {
+    const types::Type* intType = basic(BasicType::BasicKind::Int);
+    const types::Type* longType = basic(BasicType::BasicKind::Long);
+    const symbols::FunctionSymbol* first = function("h", {intType});
+    const symbols::FunctionSymbol* second = function("h", {longType});
+    std::vector<const types::Type*> intArgument = {intType};
+
+    symbols::OverloadCache cache(types_);
+    std::vector<const symbols::FunctionSymbol*> before = {first};
+    cache.store(cache.makeKey(before, intArgument), first);
+
+    // Una sobrecarga nueva cambia la clave
+    std::vector<const symbols::FunctionSymbol*> after = {first, second};
+    EXPECT_FALSE(cache.find(cache.makeKey(after, intArgument)).has_value());
+
+    // Y también otro tipo de argumento con el mismo conjunto
+    std::vector<const types::Type*> longArgument = {longType};
+    EXPECT_FALSE(cache.find(cache.makeKey(before, longArgument)).has_value());
+
+    cache.clear();
+    EXPECT_FALSE(cache.find(cache.makeKey(before, intArgument)).has_value());
+    EXPECT_EQ(cache.getStats().entries, 0u);
+}
+
+TEST_F(OverloadCacheTest, CallsWithUnifiedTypesOnlyAreMemoized) {
+    OpaqueClassType opaque;
+    std::vector<const symbols::FunctionSymbol*> candidates = {function("k", {&opaque})};
+    std::vector<const types::Type*> arguments = {&opaque};
+
+    symbols::OverloadCache cache(types_);
+    auto key = cache.makeKey(candidates, arguments);
+    EXPECT_FALSE(key.memoizable);
+    cache.store(std::move(key), candidates[0]);
+
+    EXPECT_FALSE(cache.find(cache.makeKey(candidates, arguments)).has_value());
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.entries, 0u);
+    EXPECT_EQ(stats.misses, 0u);
+}
@@ -0,0 +1,107 @@
+/**
+ * @file test_parallel_test_runner.cpp
+ * @brief Tests para el ejecutor de tests en procesos aislados
+ */
+
+#include <compiler/testing/ParallelTestRunner.h>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <string>
+
+using namespace cpp20::compiler::testing;
+using namespace std::chrono_literals;
+
+#ifndef _WIN32
+
+namespace {
+
+ParallelTestRunner::Test shell(const std::string& name, const std::string& script,
+                               std::chrono::milliseconds timeout = 10s) {
+    return ParallelTestRunner::Test{name, {"/bin/sh", "-c", script}, timeout};
+}
+
+} // namespace
+
+TEST(ParallelTestRunnerTest, EachTestRunsInItsOwnProcess) {
+    ParallelTestRunner runner(2);
+    runner.addTest(shell("Suite.Passes", "echo listo"));
+    runner.addTest(shell("Suite.Fails", "echo roto >&2; exit 3"));
+    runner.addTest(shell("Suite.Crashes", "kill -SEGV $$"));
+
+    auto results = runner.run();
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_EQ(results[0].outcome, ParallelTestRunner::Outcome::Passed);
+    EXPECT_EQ(results[0].output, "listo\n");
+    EXPECT_GT(results[0].peakMemoryBytes, 0u);
+    EXPECT_EQ(results[1].outcome, ParallelTestRunner::Outcome::Failed);
+    EXPECT_EQ(results[1].exitCode, 3);
+    EXPECT_EQ(results[1].output, "roto\n");
+    EXPECT_EQ(results[2].outcome, ParallelTestRunner::Outcome::Failed);
+    EXPECT_LT(results[2].exitCode, 0); // Murió por una señal
+}
+
+TEST(ParallelTestRunnerTest, TimeoutKillsTheWholeProcessGroup) {
+    ParallelTestRunner runner(1);
+    runner.addTest(shell("Slow.Sleeps", "sleep 30 & wait", 10s));
+    runner.setTimeout("Slow.", 100ms);
+
+    auto start = std::chrono::steady_clock::now();
+    auto results = runner.run();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_EQ(results[0].outcome, ParallelTestRunner::Outcome::TimedOut);
+    EXPECT_GE(results[0].duration, 100ms);
+}
+
+TEST(ParallelTestRunnerTest, SlowestRecordedTestIsScheduledFirst) {
+    auto history = std::filesystem::temp_directory_path() / "cpp20_parallel_runner_history.cache";
+    std::filesystem::remove(history);
+
+    {
+        ParallelTestRunner runner(1);
+        runner.addTest(shell("A.Fast", "true"));
+        runner.addTest(shell("A.Slow", "sleep 0.2"));
+        runner.run();
+        ASSERT_TRUE(runner.saveHistory(history));
+    }
+
+    ParallelTestRunner runner(1);
+    runner.addTest(shell("A.Fast", "true"));
+    runner.addTest(shell("A.New", "true"));
+    runner.addTest(shell("A.Slow", "sleep 0.2"));
+    ASSERT_TRUE(runner.loadHistory(history));
+    ASSERT_NE(runner.recordedDuration("A.Slow"), nullptr);
+
+    // Sin historial primero, luego de más lento a más rápido
+    auto order = runner.schedule();
+    ASSERT_EQ(order.size(), 3u);
+    EXPECT_EQ(order[0]->name, "A.New");
+    EXPECT_EQ(order[1]->name, "A.Slow");
+    EXPECT_EQ(order[2]->name, "A.Fast");
+    std::filesystem::remove(history);
+}
+
+TEST(ParallelTestRunnerTest, JSONReportListsSlowestFirst) {
+    ParallelTestRunner::Result fast;
+    fast.name = "S.Fast";
+    fast.outcome = ParallelTestRunner::Outcome::Passed;
+    fast.exitCode = 0;
+    fast.duration = 5ms;
+    fast.peakMemoryBytes = 1024;
+    ParallelTestRunner::Result slow;
+    slow.name = "S.\"Slow\"";
+    slow.outcome = ParallelTestRunner::Outcome::TimedOut;
+    slow.duration = 900ms;
+
+    std::string json = ParallelTestRunner::formatJSON({fast, slow}, 910ms);
+    EXPECT_NE(json.find("\"wall_ms\": 910"), std::string::npos);
+    size_t slowAt = json.find("S.\\\"Slow\\\"");
+    size_t fastAt = json.find("S.Fast");
+    ASSERT_NE(slowAt, std::string::npos);
+    ASSERT_NE(fastAt, std::string::npos);
+    EXPECT_LT(slowAt, fastAt);
+    EXPECT_NE(json.find("\"outcome\": \"timeout\""), std::string::npos);
+    EXPECT_NE(json.find("\"peak_memory_bytes\": 1024"), std::string::npos);
+}
+
+#endif
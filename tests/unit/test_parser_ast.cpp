@@ -0,0 +1,342 @@
+/**
+ * @file test_parser_ast.cpp
+ * @brief Tests del árbol que construye el parser
+ */
+
+#include <compiler/frontend/Parser.h>
+#include <compiler/frontend/lexer/Lexer.h>
+#include <compiler/ast/ASTVisitor.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace cpp20::compiler;
+using frontend::Parser;
+using frontend::lexer::Lexer;
+using frontend::lexer::Token;
+
+namespace {
+
+class ParserTest : public ::testing::Test {
+protected:
+    std::shared_ptr<diagnostics::SourceManager> sourceManager_ =
+        std::make_shared<diagnostics::SourceManager>();
+    diagnostics::DiagnosticEngine diagEngine_{sourceManager_};
+    std::vector<Token> tokens_;
+    std::unique_ptr<Parser> parser_;
+
+    ast::TranslationUnit* parse(const std::string& source,
+                                const frontend::ParserConfig& config = frontend::ParserConfig()) {
+        Lexer lexer(source, diagEngine_);
+        tokens_ = lexer.tokenize();
+        parser_ = std::make_unique<Parser>(tokens_, diagEngine_, config);
+        return parser_->parse();
+    }
+
+    static frontend::ParserConfig delayedBodies() {
+        frontend::ParserConfig config;
+        config.delayFunctionBodies = true;
+        return config;
+    }
+
+    // Forma del árbol sin plegar las subexpresiones de literales
+    static frontend::ParserConfig unfolded() {
+        frontend::ParserConfig config;
+        config.foldConstants = false;
+        return config;
+    }
+
+    // Inicializador de la única declaración de variable de la unidad
+    std::string initializerOf(const std::string& source,
+                              const frontend::ParserConfig& config = frontend::ParserConfig()) {
+        ast::TranslationUnit* unit = parse(source, config);
+        EXPECT_TRUE(parser_->isSuccessful());
+        if (unit->declarations().size() != 1 ||
+            unit->declarations()[0]->kind() != ast::ASTNodeKind::VariableDecl) {
+            return "<no variable>";
+        }
+        auto* decl = static_cast<ast::VariableDecl*>(unit->declarations()[0]);
+        return decl->getInitializer() ? decl->getInitializer()->toString() : "<null>";
+    }
+};
+
+} // namespace
+
+TEST_F(ParserTest, BinaryOperatorsRespectPrecedence) {
+    EXPECT_EQ(initializerOf("int x = 1 + 2 * 3;", unfolded()), "(1 + (2 * 3))");
+    EXPECT_EQ(initializerOf("int x = (1 + 2) * 3;", unfolded()), "((1 + 2) * 3)");
+    EXPECT_EQ(initializerOf("int x = 1 - 2 - 3;", unfolded()), "((1 - 2) - 3)");
+    EXPECT_EQ(initializerOf("bool b = a < b && c == d || e;"), "(((a < b) && (c == d)) || e)");
+    EXPECT_EQ(initializerOf("int x = a | b ^ c & d;"), "(a | (b ^ (c & d)))");
+}
+
+TEST_F(ParserTest, UnaryTernaryAndAssignment) {
+    EXPECT_EQ(initializerOf("int x = -a * !b;"), "((-a) * (!b))");
+    EXPECT_EQ(initializerOf("int x = c ? 1 : 2;"), "(c ? 1 : 2)");
+    EXPECT_EQ(initializerOf("int x = a = b += 2;"), "(a = (b += 2))");
+}
+
+TEST_F(ParserTest, ConditionalIsRightAssociative) {
+    EXPECT_EQ(initializerOf("int x = a ? b : c ? d : e;"), "(a ? b : (c ? d : e))");
+    EXPECT_EQ(initializerOf("int x = a ? b : c = d;"), "(a ? b : (c = d))");
+    EXPECT_EQ(initializerOf("int x = a || b ? c + 1 : d;"), "((a || b) ? (c + 1) : d)");
+}
+
+TEST_F(ParserTest, LongOperatorChainsStayFlat) {
+    std::string source = "int x = 0";
+    for (int i = 0; i < 2000; ++i) {
+        source += " + 1";
+    }
+    source += ";";
+
+    ast::TranslationUnit* unit = parse(source, unfolded());
+    EXPECT_TRUE(parser_->isSuccessful());
+    auto* decl = static_cast<ast::VariableDecl*>(unit->declarations()[0]);
+
+    // Asociatividad izquierda: la cadena crece por el hijo izquierdo
+    size_t depth = 0;
+    ast::ASTNode* node = decl->getInitializer();
+    while (node->kind() == ast::ASTNodeKind::BinaryOp) {
+        auto* binary = static_cast<ast::BinaryOp*>(node);
+        EXPECT_EQ(binary->getRight()->kind(), ast::ASTNodeKind::IntegerLiteral);
+        node = binary->getLeft();
+        ++depth;
+    }
+    EXPECT_EQ(depth, 2000u);
+}
+
+TEST_F(ParserTest, LiteralValues) {
+    EXPECT_EQ(initializerOf("int x = 0x1F;"), "31");
+    EXPECT_EQ(initializerOf("int x = 1'000u;"), "1000");
+    EXPECT_EQ(initializerOf("bool b = true;"), "true");
+}
+
+TEST_F(ParserTest, ConstantSubexpressionsFoldWhileParsing) {
+    EXPECT_EQ(initializerOf("int x = 1 + 2 * 3;"), "7");
+    EXPECT_EQ(initializerOf("long x = (1024 * 1024) - -4;"), "1048580");
+    EXPECT_EQ(initializerOf("double d = 1.5 * 2;"), "3.000000");
+    // Solo se pliega lo constante; lo indefinido queda para el diagnóstico
+    EXPECT_EQ(initializerOf("int x = a + 2 * 3;"), "(a + 6)");
+    EXPECT_EQ(initializerOf("int x = 1 / 0;"), "(1 / 0)");
+    EXPECT_EQ(initializerOf("int x = 7 % 0;"), "(7 % 0)");
+    EXPECT_EQ(initializerOf("int x = 9223372036854775807 + 1;"), "(9223372036854775807 + 1)");
+    EXPECT_EQ(initializerOf("bool b = 1 < 2;"), "(1 < 2)");
+
+    ast::TranslationUnit* unit = parse("int x = 10 + 20 * 3;");
+    EXPECT_EQ(parser_->getStats().constantsFolded, 2u);
+    auto* literal = static_cast<ast::IntegerLiteral*>(
+        static_cast<ast::VariableDecl*>(unit->declarations()[0])->getInitializer());
+    ASSERT_EQ(literal->kind(), ast::ASTNodeKind::IntegerLiteral);
+    ASSERT_NE(literal->getFoldedRange(), nullptr);
+    EXPECT_EQ(literal->getFoldedRange()->start().column(), 9u);
+    EXPECT_EQ(literal->getFoldedRange()->end().column(), 19u);
+    EXPECT_EQ(literal->getLocation().column(), 9u);
+}
+
+TEST_F(ParserTest, FoldingFollowsTheTypeOfTheLiterals) {
+    // int: lo que no cabe queda para el diagnóstico de desbordamiento del evaluador
+    EXPECT_EQ(initializerOf("int x = 2147483647 + 1;"), "(2147483647 + 1)");
+    EXPECT_EQ(initializerOf("int x = -2147483647 - 1;"), "-2147483648");
+    EXPECT_EQ(initializerOf("int x = 46341 * 46341;"), "(46341 * 46341)");
+    EXPECT_EQ(initializerOf("int x = -2147483647 / -1;"), "2147483647");
+    EXPECT_EQ(initializerOf("int x = (-2147483647 - 1) / -1;"), "(-2147483648 / -1)");
+    EXPECT_EQ(initializerOf("int x = -(-2147483647 - 1);"), "(--2147483648)");
+
+    // unsigned y long tienen otra aritmética (módulo 2^32, 64 bits): no se pliegan
+    EXPECT_EQ(initializerOf("unsigned x = 0u - 1;"), "(0 - 1)");
+    EXPECT_EQ(initializerOf("unsigned x = ~0u;"), "(~0)");
+    EXPECT_EQ(initializerOf("long x = 3000000000 + 1;"), "(3000000000 + 1)");
+    EXPECT_EQ(initializerOf("long x = 2L * 3;"), "(2 * 3)");
+    EXPECT_EQ(initializerOf("unsigned x = 0xFFFFFFFF & 1;"), "(4294967295 & 1)");
+
+    // float se redondea en cada operación: solo double se pliega; el signo es exacto
+    EXPECT_EQ(initializerOf("float f = 1.5f * 2.0f;"), "(1.500000 * 2.000000)");
+    EXPECT_EQ(initializerOf("float f = 0.1f + 1;"), "(0.100000 + 1)");
+    EXPECT_EQ(initializerOf("double d = 0.5 + 1;"), "1.500000");
+    EXPECT_EQ(initializerOf("float f = -1.5f;"), "-1.500000");
+}
+
+TEST_F(ParserTest, RepeatedLiteralTextIsInterned) {
+    ast::TranslationUnit* unit = parse("auto a = \"tabla\";\nauto b = \"tabla\";\n");
+    ASSERT_EQ(unit->declarations().size(), 2u);
+    EXPECT_EQ(parser_->getStats().literalsInterned, 1u);
+    auto value = [&](size_t i) {
+        auto* decl = static_cast<ast::VariableDecl*>(unit->declarations()[i]);
+        return static_cast<ast::StringLiteral*>(decl->getInitializer())->getValue();
+    };
+    EXPECT_EQ(value(0), "tabla");
+    EXPECT_EQ(value(0).data(), value(1).data());
+}
+
+TEST_F(ParserTest, FunctionWithStatements) {
+    ast::TranslationUnit* unit = parse(
+        "int f(int a, int b) {\n"
+        "  int s = 0;\n"
+        "  for (int i = 0; i < a; i += 1) { s += b; }\n"
+        "  if (s > 10) return s; else return 0;\n"
+        "  while (a) a -= 1;\n"
+        "}\n"
+        "void g();\n");
+
+    EXPECT_TRUE(parser_->isSuccessful());
+    ASSERT_EQ(unit->declarations().size(), 2u);
+    ASSERT_EQ(unit->declarations()[0]->kind(), ast::ASTNodeKind::FunctionDecl);
+
+    auto* f = static_cast<ast::FunctionDecl*>(unit->declarations()[0]);
+    EXPECT_EQ(f->getName(), "f");
+    EXPECT_EQ(f->getReturnType(), "int");
+    ASSERT_EQ(f->getParameters().size(), 2u);
+    EXPECT_EQ(f->getParameters()[1]->getName(), "b");
+    ASSERT_NE(f->getBody(), nullptr);
+
+    std::vector<ast::ASTNodeKind> kinds;
+    for (ast::ASTNode* statement : f->getBody()->getStatements()) {
+        kinds.push_back(statement->kind());
+    }
+    EXPECT_EQ(kinds, (std::vector<ast::ASTNodeKind>{
+        ast::ASTNodeKind::VariableDecl, ast::ASTNodeKind::ForStmt,
+        ast::ASTNodeKind::IfStmt, ast::ASTNodeKind::WhileStmt}));
+
+    auto* g = static_cast<ast::FunctionDecl*>(unit->declarations()[1]);
+    EXPECT_EQ(g->getBody(), nullptr);
+    EXPECT_EQ(g->toString(), "void g();");
+}
+
+TEST_F(ParserTest, MustTailAttributeMarksReturnedCall) {
+    ast::TranslationUnit* unit = parse(
+        "int f(int n) {\n"
+        "  [[likely]] return 0;\n"
+        "  [[clang::musttail, maybe_unused]] return g(n);\n"
+        "}\n");
+    EXPECT_TRUE(parser_->isSuccessful());
+    ASSERT_EQ(unit->declarations().size(), 1u);
+    auto* f = static_cast<ast::FunctionDecl*>(unit->declarations()[0]);
+    ASSERT_NE(f->getBody(), nullptr);
+    const auto& statements = f->getBody()->getStatements();
+    ASSERT_EQ(statements.size(), 2u);
+    ASSERT_EQ(statements[1]->kind(), ast::ASTNodeKind::ReturnStmt);
+    EXPECT_FALSE(static_cast<ast::ReturnStmt*>(statements[0])->isMustTail());
+    EXPECT_TRUE(static_cast<ast::ReturnStmt*>(statements[1])->isMustTail());
+    EXPECT_EQ(static_cast<ast::ReturnStmt*>(statements[1])->toString(), "[[clang::musttail]] return g(n);");
+
+    // Sin llamada no hay nada que bajar a salto
+    parse("int f(int n) { [[clang::musttail]] return n; }\n");
+    EXPECT_FALSE(parser_->isSuccessful());
+}
+
+TEST_F(ParserTest, NodesAreCountedInStats) {
+    parse("int x = 1 + 2;");
+    // VariableDecl, BinaryOp, dos literales y la TranslationUnit
+    EXPECT_EQ(parser_->getStats().nodesCreated, 5u);
+}
+
+TEST_F(ParserTest, DeclarationsAreDisambiguatedTentatively) {
+    ast::TranslationUnit* unit = parse("int x = 1;\nint f();\n");
+    EXPECT_TRUE(parser_->isSuccessful());
+    EXPECT_EQ(parser_->getStats().errorsReported, 0u);
+    EXPECT_EQ(parser_->getStats().tentativeParses, 2u);
+    ASSERT_EQ(unit->declarations().size(), 2u);
+    EXPECT_EQ(unit->declarations()[0]->kind(), ast::ASTNodeKind::VariableDecl);
+    EXPECT_EQ(unit->declarations()[1]->kind(), ast::ASTNodeKind::FunctionDecl);
+}
+
+TEST_F(ParserTest, FailedTentativeParseReusesMemoizedPrefix) {
+    ast::TranslationUnit* unit = parse("const unsigned long x = 1;\nint y;\n");
+    EXPECT_TRUE(parser_->isSuccessful());
+    // La variable reutiliza especificadores y declarador del intento de función
+    EXPECT_EQ(parser_->getStats().memoHits, 4u);
+    ASSERT_EQ(unit->declarations().size(), 2u);
+    auto* variable = static_cast<ast::VariableDecl*>(unit->declarations()[0]);
+    EXPECT_EQ(variable->kind(), ast::ASTNodeKind::VariableDecl);
+    EXPECT_EQ(variable->getName(), "x");
+    EXPECT_EQ(variable->getTypeName(), "const unsigned long");
+}
+
+TEST_F(ParserTest, ErrorsInsideAcceptedTentativeParseAreReported) {
+    ast::TranslationUnit* unit = parse("int f() { return 1 }\n");
+    EXPECT_FALSE(parser_->isSuccessful());
+    EXPECT_EQ(parser_->getStats().errorsReported, 1u);
+    ASSERT_EQ(unit->declarations().size(), 1u);
+    EXPECT_EQ(unit->declarations()[0]->kind(), ast::ASTNodeKind::FunctionDecl);
+}
+
+TEST_F(ParserTest, DelayedBodiesAreParsedOnDemand) {
+    ast::TranslationUnit* unit = parse(
+        "int f(int a) { if (a) { return 1; } return 2; }\n"
+        "int g() { return 3; }\n"
+        "int h();\n", delayedBodies());
+
+    EXPECT_TRUE(parser_->isSuccessful());
+    ASSERT_EQ(unit->declarations().size(), 3u);
+    auto* f = static_cast<ast::FunctionDecl*>(unit->declarations()[0]);
+    auto* h = static_cast<ast::FunctionDecl*>(unit->declarations()[2]);
+
+    EXPECT_EQ(parser_->getStats().delayedBodies, 2u);
+    EXPECT_EQ(parser_->delayedFunctions().size(), 2u);
+    EXPECT_EQ(f->getBody(), nullptr);
+    EXPECT_TRUE(f->hasDelayedBody());
+    EXPECT_TRUE(f->isDefinition());
+    EXPECT_FALSE(h->isDefinition());
+    EXPECT_EQ(f->toString(), "int f(int a) { ... }");
+
+    ast::CompoundStmt* body = parser_->parseDelayedBody(f);
+    ASSERT_NE(body, nullptr);
+    EXPECT_EQ(f->getBody(), body);
+    EXPECT_FALSE(f->hasDelayedBody());
+    EXPECT_EQ(body->getStatements().size(), 2u);
+    EXPECT_EQ(parser_->parseDelayedBody(f), body);
+
+    EXPECT_EQ(parser_->parseDelayedBodies(), 1u);
+    EXPECT_EQ(parser_->getStats().delayedBodiesParsed, 2u);
+    EXPECT_TRUE(parser_->isSuccessful());
+}
+
+TEST_F(ParserTest, DelayedBodyErrorsSurfaceWhenParsed) {
+    ast::TranslationUnit* unit = parse("int f() { return 1 }\nint x = 2;\n", delayedBodies());
+    EXPECT_TRUE(parser_->isSuccessful());
+    ASSERT_EQ(unit->declarations().size(), 2u);
+
+    parser_->parseDelayedBodies();
+    EXPECT_FALSE(parser_->isSuccessful());
+    EXPECT_EQ(parser_->getStats().errorsReported, 1u);
+}
+
+TEST_F(ParserTest, DelayedBodiesParseInParallel) {
+    std::string source;
+    for (int i = 0; i < 64; ++i) {
+        std::string n = std::to_string(i);
+        source += "int f" + n + "(int a) { int b = a * " + n + "; return b + 1; }\n";
+    }
+    source += "int broken() { return 1 }\n";
+
+    ast::TranslationUnit* unit = parse(source, delayedBodies());
+    ASSERT_EQ(unit->declarations().size(), 65u);
+    EXPECT_EQ(parser_->parseDelayedBodies(4), 65u);
+
+    for (size_t i = 0; i < 64; ++i) {
+        auto* function = static_cast<ast::FunctionDecl*>(unit->declarations()[i]);
+        ASSERT_NE(function->getBody(), nullptr);
+        EXPECT_FALSE(function->hasDelayedBody());
+        EXPECT_EQ(function->getBody()->getStatements().size(), 2u);
+    }
+
+    // Mismo árbol que el parsing en serie
+    Parser serial(tokens_, diagEngine_);
+    ast::TranslationUnit* serialUnit = serial.parse();
+    for (size_t i = 0; i < unit->declarations().size(); ++i) {
+        EXPECT_EQ(unit->declarations()[i]->toString(), serialUnit->declarations()[i]->toString());
+    }
+    EXPECT_EQ(parser_->getStats().delayedBodiesParsed, 65u);
+    EXPECT_EQ(parser_->getStats().errorsReported, 1u);
+    EXPECT_FALSE(parser_->isSuccessful());
+}
+
+TEST_F(ParserTest, ReportsErrorsAndRecovers) {
+    ast::TranslationUnit* unit = parse("int x = ;\nint y = 2;");
+    EXPECT_FALSE(parser_->isSuccessful());
+    ASSERT_FALSE(unit->declarations().empty());
+    auto* last = unit->declarations()[unit->declarations().size() - 1];
+    ASSERT_EQ(last->kind(), ast::ASTNodeKind::VariableDecl);
+    EXPECT_EQ(static_cast<ast::VariableDecl*>(last)->getName(), "y");
+}
@@ -0,0 +1,84 @@
+/**
+ * @file test_preprocessed_output.cpp
+ * @brief Tests para la salida de -E en texto y en flujo binario de tokens
+ */
+
+#include <compiler/frontend/PreprocessedOutput.h>
+#include <compiler/frontend/Preprocessor.h>
+#include <compiler/frontend/lexer/Lexer.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+#include <string>
+
+using namespace cpp20::compiler;
+using frontend::Preprocessor;
+using frontend::lexer::Lexer;
+using frontend::lexer::Token;
+
+namespace {
+
+class PreprocessedOutputTest : public ::testing::Test {
+protected:
+    std::shared_ptr<diagnostics::SourceManager> sources_ = std::make_shared<diagnostics::SourceManager>();
+    diagnostics::DiagnosticEngine diagEngine_{sources_};
+
+    template <typename Writer>
+    void preprocessInto(Writer& writer, const std::string& source, const std::string& name) {
+        uint32_t fileId = sources_->createVirtualFile(source, name);
+        frontend::lexer::LexerConfig config;
+        config.fileId = fileId;
+        Lexer lexer(sources_->getFile(fileId)->text(), diagEngine_, config);
+        Preprocessor preprocessor(diagEngine_);
+        preprocessor.begin(lexer);
+        while (auto token = preprocessor.nextToken()) {
+            writer.write(*token);
+        }
+        ASSERT_TRUE(writer.finish());
+    }
+};
+
+} // namespace
+
+TEST_F(PreprocessedOutputTest, TextKeepsLinesWithMinimalMarkers) {
+    std::ostringstream out;
+    frontend::PreprocessedTextWriter writer(out, sources_);
+    preprocessInto(writer, "#define ADD(a, b) a + b\nint x = ADD(1, 2);\n\n\nint y;\n"
+                           "\n\n\n\n\n\n\n\n\n\nint z;\n", "main.cpp");
+
+    // Tres líneas vacías se conservan; diez se sustituyen por una marca
+    EXPECT_EQ(out.str(), "# 2 \"main.cpp\"\nint x = 1 + 2;\n\n\nint y;\n# 16 \"main.cpp\"\nint z;\n");
+    EXPECT_EQ(writer.markerCount(), 2u);
+}
+
+TEST_F(PreprocessedOutputTest, TextSeparatesTokensThatWouldPaste) {
+    std::ostringstream out;
+    frontend::PreprocessedTextWriter writer(out, sources_, false);
+    preprocessInto(writer, "#define NEG -x\n#define ID(t) t\nint a = -NEG;\nID(a)ID(b) ID(1)ID(.5)\n", "paste.cpp");
+    EXPECT_EQ(out.str(), "int a = - -x;\na b 1 .5\n");
+}
+
+TEST_F(PreprocessedOutputTest, TokenStreamLoadsWithoutRelexing) {
+    std::ostringstream out;
+    frontend::PreprocessedTokenWriter writer(out, sources_);
+    preprocessInto(writer, "#define N 4\nint values[N];\n", "unit.cpp");
+    std::string stream = out.str();
+
+    // Otra sesión, como la de un trabajador remoto
+    auto remoteSources = std::make_shared<diagnostics::SourceManager>();
+    auto tokens = frontend::PreprocessedTokenWriter::readTokens(stream, *remoteSources);
+    ASSERT_TRUE(tokens.has_value());
+    ASSERT_EQ(tokens->size(), 6u);
+    EXPECT_EQ((*tokens)[0].getLexeme(), "int");
+    EXPECT_EQ((*tokens)[1].getType(), frontend::lexer::TokenType::IDENTIFIER);
+    EXPECT_NE((*tokens)[1].getIdentifierInfo(), nullptr);
+    EXPECT_EQ((*tokens)[3].getLexeme(), "4");
+    EXPECT_EQ((*tokens)[0].getLocation().line(), 2u);
+    const diagnostics::SourceFile* file = remoteSources->getFile((*tokens)[0].getLocation().fileId());
+    ASSERT_NE(file, nullptr);
+    EXPECT_EQ(file->displayName, "unit.cpp");
+
+    EXPECT_FALSE(frontend::PreprocessedTokenWriter::readTokens(stream.substr(0, stream.size() - 3),
+                                                               *remoteSources).has_value());
+    EXPECT_FALSE(frontend::PreprocessedTokenWriter::readTokens("CPPTOKS0", *remoteSources).has_value());
+}
@@ -1,557 +1,499 @@
 /**
  * @file test_preprocessor.cpp
- * @brief Tests unitarios para el preprocesador C++20
+ * @brief Tests para directivas e inclusión de archivos del preprocesador
  */
 
-#include <gtest/gtest.h>
 #include <compiler/frontend/Preprocessor.h>
+#include <compiler/frontend/HeaderUnitTable.h>
+#include <compiler/common/TimingProfiler.h>
 #include <compiler/frontend/lexer/Lexer.h>
-#include <compiler/common/diagnostics/DiagnosticEngine.h>
-
-using namespace cpp20::compiler::frontend;
-using namespace cpp20::compiler::diagnostics;
-
-// Clase auxiliar para crear tokens de prueba
-class TestTokenFactory {
-public:
-    static lexer::Token createToken(lexer::TokenType type, const std::string& lexeme = "",
-                                   const std::string& value = "") {
-        return lexer::Token(type, lexeme,
-                           SourceLocation("", 1, 1), value);
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace cpp20::compiler;
+using frontend::MacroDefinition;
+using frontend::Preprocessor;
+using frontend::lexer::Lexer;
+using frontend::lexer::Token;
+using frontend::lexer::TokenType;
+
+namespace {
+
+class PreprocessorTest : public ::testing::Test {
+protected:
+    std::filesystem::path dir_ = std::filesystem::temp_directory_path() / "pp_include_test";
+    std::shared_ptr<diagnostics::SourceManager> sourceManager_ =
+        std::make_shared<diagnostics::SourceManager>();
+    diagnostics::DiagnosticEngine diagEngine_{sourceManager_};
+
+    void SetUp() override {
+        std::filesystem::create_directories(dir_);
+        sourceManager_->addIncludePath(dir_, false);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dir_);
     }
 
-    static std::vector<lexer::Token> createTokens(const std::vector<std::pair<lexer::TokenType, std::string>>& tokenSpecs) {
-        std::vector<lexer::Token> tokens;
-        for (const auto& spec : tokenSpecs) {
-            tokens.push_back(createToken(spec.first, spec.second));
+    void writeHeader(const std::string& name, const std::string& content) {
+        std::ofstream out(dir_ / name, std::ios::binary);
+        out << content;
+    }
+
+    std::string preprocess(const std::string& source, Preprocessor& preprocessor) {
+        Lexer lexer(source, diagEngine_);
+        std::string result;
+        for (const Token& token : preprocessor.process(lexer)) {
+            if (!result.empty()) result += ' ';
+            result += token.getLexeme();
         }
-        return tokens;
+        return result;
+    }
+
+    std::string preprocess(const std::string& source) {
+        Preprocessor preprocessor(diagEngine_);
+        return preprocess(source, preprocessor);
+    }
+
+    std::vector<Token> tokens(const std::string& source, Preprocessor& preprocessor) {
+        Lexer lexer(source, diagEngine_);
+        return preprocessor.process(lexer);
     }
 };
 
-// Test para inicialización del preprocesador
-TEST(PreprocessorTest, BasicInitialization) {
-    DiagnosticEngine diagEngine;
-    Preprocessor preprocessor(diagEngine);
+} // namespace
 
-    // Verificar que las macros predefinidas están disponibles
-    EXPECT_TRUE(preprocessor.isMacroDefined("__cplusplus"));
-    EXPECT_TRUE(preprocessor.isMacroDefined("__STDC_HOSTED__"));
-    EXPECT_TRUE(preprocessor.isMacroDefined("__FILE__"));
-    EXPECT_TRUE(preprocessor.isMacroDefined("__LINE__"));
-    EXPECT_TRUE(preprocessor.isMacroDefined("__DATE__"));
-    EXPECT_TRUE(preprocessor.isMacroDefined("__TIME__"));
+TEST_F(PreprocessorTest, DirectivesEndAtNewline) {
+    EXPECT_EQ(preprocess("#define VALUE 1\nint x = VALUE;"), "int x = 1 ;");
 }
 
-// Test para definición de macros simples
-TEST(PreprocessorTest, SimpleMacroDefinition) {
-    DiagnosticEngine diagEngine;
-    Preprocessor preprocessor(diagEngine);
+TEST_F(PreprocessorTest, InactiveSectionsAreSkipped) {
+    EXPECT_EQ(preprocess("#ifdef MISSING\nint a;\n#define B 2\n#else\nint c;\n#endif\nB"),
+              "int c ; B");
+}
 
-    // Definir una macro simple
-    preprocessor.defineMacro("MAX_SIZE", "100");
+TEST_F(PreprocessorTest, IncludeGuardIsDetectedAndHonoured) {
+    writeHeader("guarded.h", "// cabecera\n#ifndef GUARDED_H\n#define GUARDED_H\nint g;\n#endif\n");
 
-    EXPECT_TRUE(preprocessor.isMacroDefined("MAX_SIZE"));
+    Preprocessor preprocessor(diagEngine_);
+    EXPECT_EQ(preprocess("#include \"guarded.h\"\n#include \"guarded.h\"\nint m;", preprocessor),
+              "int g ; int m ;");
+    EXPECT_EQ(preprocessor.getStats().includesSkipped, 1u);
 
-    const MacroDefinition* macro = preprocessor.getMacro("MAX_SIZE");
-    ASSERT_TRUE(macro != nullptr);
-    EXPECT_EQ(macro->name, "MAX_SIZE");
-    EXPECT_FALSE(macro->isFunctionLike);
-    EXPECT_EQ(macro->body.size(), 1);
-    EXPECT_EQ(macro->body[0].getLexeme(), "100");
+    auto entry = sourceManager_->getIncludeCacheEntry("guarded.h");
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->includeGuard, "GUARDED_H");
+    EXPECT_FALSE(entry->pragmaOnce);
 }
 
-// Test para definición de macros de función
-TEST(PreprocessorTest, FunctionMacroDefinition) {
-    DiagnosticEngine diagEngine;
-    Preprocessor preprocessor(diagEngine);
+TEST_F(PreprocessorTest, PragmaOnceIsHonoured) {
+    writeHeader("once.h", "#pragma once\nint o;\n");
 
-    // Crear definición de macro de función
-    std::vector<lexer::Token> body = {
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "x"),
-        TestTokenFactory::createToken(lexer::TokenType::PLUS, "+"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "y")
-    };
+    Preprocessor preprocessor(diagEngine_);
+    EXPECT_EQ(preprocess("#include \"once.h\"\n#include \"once.h\"", preprocessor), "int o ;");
+    EXPECT_EQ(preprocessor.getStats().includesSkipped, 1u);
 
-    std::vector<std::string> parameters = {"x", "y"};
-    MacroDefinition funcMacro("ADD", body, true, false);
-    funcMacro.parameters = parameters;
+    auto entry = sourceManager_->getIncludeCacheEntry("once.h");
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_TRUE(entry->pragmaOnce);
+}
 
-    preprocessor.defineMacro(funcMacro);
+TEST_F(PreprocessorTest, ContentOutsideGuardDisablesOptimization) {
+    writeHeader("trailing.h", "#ifndef TRAILING_H\n#define TRAILING_H\n#endif\nint t;\n");
+    writeHeader("with_else.h", "#ifndef ELSE_H\n#define ELSE_H\n#else\nint e;\n#endif\n");
+
+    Preprocessor preprocessor(diagEngine_);
+    EXPECT_EQ(preprocess("#include \"trailing.h\"\n#include \"trailing.h\"\n"
+                         "#include \"with_else.h\"\n#include \"with_else.h\"", preprocessor),
+              "int t ; int t ; int e ;");
+    EXPECT_EQ(preprocessor.getStats().includesSkipped, 0u);
+    EXPECT_TRUE(sourceManager_->getIncludeCacheEntry("trailing.h")->includeGuard.empty());
+    EXPECT_TRUE(sourceManager_->getIncludeCacheEntry("with_else.h")->includeGuard.empty());
+}
 
-    EXPECT_TRUE(preprocessor.isMacroDefined("ADD"));
+TEST_F(PreprocessorTest, GuardIsReevaluatedPerTranslationUnit) {
+    writeHeader("shared.h", "#ifndef SHARED_H\n#define SHARED_H\nint s;\n#endif\n");
 
-    const MacroDefinition* macro = preprocessor.getMacro("ADD");
-    ASSERT_TRUE(macro != nullptr);
-    EXPECT_TRUE(macro->isFunctionLike);
-    EXPECT_EQ(macro->parameters.size(), 2);
-    EXPECT_EQ(macro->parameters[0], "x");
-    EXPECT_EQ(macro->parameters[1], "y");
+    // La guarda queda registrada en el SourceManager, pero otra unidad no tiene la macro
+    EXPECT_EQ(preprocess("#include \"shared.h\""), "int s ;");
+    EXPECT_EQ(preprocess("#include \"shared.h\""), "int s ;");
 }
 
-// Test para eliminación de macros
-TEST(PreprocessorTest, MacroUndefinition) {
-    DiagnosticEngine diagEngine;
-    Preprocessor preprocessor(diagEngine);
+TEST_F(PreprocessorTest, FunctionLikeMacroSubstitutesArguments) {
+    EXPECT_EQ(preprocess("#define ADD(a, b) ((a) + (b))\nADD(1, f(2, 3))\n"),
+              "( ( 1 ) + ( f ( 2 , 3 ) ) )");
+    EXPECT_EQ(preprocess("#define F (x)\nF\n"), "( x )");
+    EXPECT_EQ(preprocess("#define G(x) x\nG + 1\n"), "G + 1");
+}
 
-    // Definir y verificar
-    preprocessor.defineMacro("TEMP_MACRO", "value");
-    EXPECT_TRUE(preprocessor.isMacroDefined("TEMP_MACRO"));
+TEST_F(PreprocessorTest, StringizeAndPasteOperators) {
+    EXPECT_EQ(preprocess("#define STR(x) #x\nSTR(a  +  \"b\")\n"), "\"a + \\\"b\\\"\"");
+    EXPECT_EQ(preprocess("#define CAT(a, b) a ## b\n#define ONE 1\nCAT(x, y) CAT(ONE, 2)\n"),
+              "xy ONE2");
+}
 
-    // Eliminar y verificar
-    preprocessor.undefineMacro("TEMP_MACRO");
-    EXPECT_FALSE(preprocessor.isMacroDefined("TEMP_MACRO"));
+TEST_F(PreprocessorTest, VariadicMacroCollectsTrailingArguments) {
+    EXPECT_EQ(preprocess("#define CALL(f, ...) f(__VA_ARGS__)\nCALL(g, 1, 2) CALL(h)\n"),
+              "g ( 1 , 2 ) h ( )");
 }
 
-// Test para procesamiento básico
-TEST(PreprocessorTest, BasicProcessing) {
-    DiagnosticEngine diagEngine;
-    Preprocessor preprocessor(diagEngine);
+TEST_F(PreprocessorTest, NestedExpansionStopsAtSelfReference) {
+    EXPECT_EQ(preprocess("#define A B + A\n#define B A\nA\n"), "A + A");
+    EXPECT_EQ(preprocess("#define TWICE(x) x x\n#define V 7\nTWICE(V)\n"), "7 7");
+}
 
-    // Crear tokens de entrada simples
-    std::vector<lexer::Token> inputTokens = {
-        TestTokenFactory::createToken(lexer::TokenType::INT, "int"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "main"),
-        TestTokenFactory::createToken(lexer::TokenType::LEFT_PAREN, "("),
-        TestTokenFactory::createToken(lexer::TokenType::RIGHT_PAREN, ")"),
-        TestTokenFactory::createToken(lexer::TokenType::END_OF_FILE)
-    };
+TEST_F(PreprocessorTest, ObjectLikeExpansionIsMemoized) {
+    Preprocessor preprocessor(diagEngine_);
+    EXPECT_EQ(preprocess("#define INNER 1\n#define OUTER INNER + INNER\nOUTER OUTER OUTER\n",
+                         preprocessor),
+              "1 + 1 1 + 1 1 + 1");
+    EXPECT_EQ(preprocessor.getStats().expansionCacheHits, 3u);
+}
 
-    auto outputTokens = preprocessor.process(inputTokens);
+TEST_F(PreprocessorTest, RedefiningDependencyInvalidatesMemo) {
+    EXPECT_EQ(preprocess("#define OUTER INNER\nOUTER\n#define INNER 2\nOUTER\n"
+                         "#undef INNER\n#define INNER 3\nOUTER\n"),
+              "INNER 2 3");
+}
 
-    // Verificar que los tokens pasaron sin cambios
-    ASSERT_EQ(outputTokens.size(), inputTokens.size());
-    for (size_t i = 0; i < outputTokens.size(); ++i) {
-        EXPECT_EQ(outputTokens[i].getType(), inputTokens[i].getType());
-        EXPECT_EQ(outputTokens[i].getLexeme(), inputTokens[i].getLexeme());
-    }
+TEST_F(PreprocessorTest, IfEvaluatesArithmeticAndDefined) {
+    EXPECT_EQ(preprocess("#define V 3\n#if V * 2 == 6 && defined(V) && !defined W\nyes\n#endif\n"), "yes");
+    EXPECT_EQ(preprocess("#if (1 << 4) > 0x0f ? UNDEFINED : 1\nno\n#else\nyes\n#endif\n"), "yes");
+    EXPECT_EQ(preprocess("#if 0 && 1 / 0\nno\n#elif 1'000 == 1000 && 0x10 >> 4 == 1 && __cplusplus >= 202002L\nyes\n#endif\n"), "yes");
 }
 
-// Test para procesamiento de #define
-TEST(PreprocessorTest, DefineDirectiveProcessing) {
-    DiagnosticEngine diagEngine;
-    Preprocessor preprocessor(diagEngine);
+TEST_F(PreprocessorTest, ElifChainTakesOnlyFirstTrueBranch) {
+    EXPECT_EQ(preprocess("#if 0\na\n#elif 1\nb\n#elif 1\nc\n#else\nd\n#endif\n"), "b");
+    EXPECT_EQ(preprocess("#if 0\n#if 1\na\n#else\nb\n#endif\n#else\nc\n#endif\n"), "c");
+}
 
-    // Crear tokens que simulan #define MAX 100
-    std::vector<lexer::Token> inputTokens = {
-        TestTokenFactory::createToken(lexer::TokenType::HASH, "#"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "define"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "MAX"),
-        TestTokenFactory::createToken(lexer::TokenType::INTEGER_LITERAL, "100"),
-        TestTokenFactory::createToken(lexer::TokenType::END_OF_FILE)
-    };
+TEST_F(PreprocessorTest, ModuleDeclarationsAreRecorded) {
+    Preprocessor preprocessor(diagEngine_);
+    EXPECT_EQ(preprocess("export module app;\nimport core;\nexport import :part;\nimport <vector>;\n"
+                         "export int f();\n", preprocessor),
+              "export module app ; import core ; export import : part ; import < vector > ; "
+              "export int f ( ) ;");
 
-    auto outputTokens = preprocessor.process(inputTokens);
+    const auto& modules = preprocessor.moduleDependencies();
+    EXPECT_EQ(modules.moduleName, "app");
+    EXPECT_EQ(modules.imports, (std::vector<std::string>{"core", ":part", "<vector>"}));
+}
 
-    // Verificar que la macro fue definida
-    EXPECT_TRUE(preprocessor.isMacroDefined("MAX"));
+TEST_F(PreprocessorTest, ConditionResultsAreSharedWhileTheirMacrosMatch) {
+    writeHeader("cond.h", "#if defined(FAST) && LEVEL > 1\nfast\n#else\nslow\n#endif\n"
+                          "#if __has_include(\"cond.h\")\nhas\n#endif\n");
+    frontend::PreprocessorConfig config;
+    config.conditionCache = std::make_shared<frontend::ConditionCache>();
+
+    Preprocessor first(diagEngine_, config);
+    EXPECT_EQ(preprocess("#define FAST\n#define LEVEL 2\n#include \"cond.h\"\n", first), "fast has");
+    EXPECT_EQ(first.getStats().conditionCacheHits, 0u);
+    EXPECT_EQ(config.conditionCache->size(), 2u);
+
+    Preprocessor second(diagEngine_, config);
+    EXPECT_EQ(preprocess("#define FAST\n#define LEVEL 2\n#include \"cond.h\"\n", second), "fast has");
+    EXPECT_EQ(second.getStats().conditionCacheHits, 2u);
+
+    // Otra definición de LEVEL: la variante guardada no vale y se añade otra
+    Preprocessor third(diagEngine_, config);
+    EXPECT_EQ(preprocess("#define FAST\n#define LEVEL 1\n#include \"cond.h\"\n", third), "slow has");
+    EXPECT_EQ(third.getStats().conditionCacheHits, 1u);
+    EXPECT_EQ(config.conditionCache->size(), 3u);
+}
 
-    // El output debería estar vacío (solo EOF) porque #define se procesa
-    ASSERT_EQ(outputTokens.size(), 1);
-    EXPECT_EQ(outputTokens[0].getType(), lexer::TokenType::END_OF_FILE);
+TEST_F(PreprocessorTest, HasCppAttributeUsesTheStandardVersions) {
+    EXPECT_EQ(preprocess("#if __has_cpp_attribute(nodiscard) >= 201907L && !__has_cpp_attribute(gnu::unknown)\n"
+                         "yes\n#endif\n"),
+              "yes");
+    EXPECT_EQ(preprocess("#if __has_cpp_attribute(likely) == 201803L\nyes\n#endif\n"), "yes");
+    EXPECT_EQ(preprocess("#if __has_cpp_attribute(clang::musttail)\nyes\n#endif\n"), "yes");
 }
 
-// Test para procesamiento de #ifdef/#ifndef
-TEST(PreprocessorTest, ConditionalDirectiveProcessing) {
-    DiagnosticEngine diagEngine;
-    Preprocessor preprocessor(diagEngine);
+TEST_F(PreprocessorTest, NextTokenPullsThroughIncludesOnDemand) {
+    writeHeader("inner.h", "#define TWICE(x) x x\nint TWICE(i);\n");
+    writeHeader("outer.h", "#include \"inner.h\"\nint o;\n");
+    std::string source = "#include \"outer.h\"\nint TWICE(m);\n#if 1\nend\n#endif\n";
+
+    Preprocessor preprocessor(diagEngine_);
+    Lexer lexer(source, diagEngine_);
+    preprocessor.begin(lexer);
+    std::optional<Token> first = preprocessor.nextToken();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->getLexeme(), "int");
+    // Solo se ha abierto lo necesario para el primer token
+    EXPECT_EQ(preprocessor.includeGraph().size(), 2u);
+    EXPECT_EQ(preprocessor.getStats().tokensProcessed, 1u);
+
+    std::string rest;
+    while (std::optional<Token> token = preprocessor.nextToken()) {
+        rest += ' ' + token->getLexeme();
+    }
+    EXPECT_EQ(rest, " i i ; int o ; int m m ; end");
+    EXPECT_FALSE(preprocessor.nextToken().has_value());
+    EXPECT_EQ(preprocess(source), "int" + rest);
+}
 
-    // Definir una macro para pruebas
-    preprocessor.defineMacro("DEFINED_MACRO", "1");
+TEST_F(PreprocessorTest, OnlyMacroIndependentHeadersAreEligibleAsHeaderUnits) {
+    using frontend::HeaderUnitTable;
+    EXPECT_TRUE(HeaderUnitTable::isEligible("#ifndef A_H\n#define A_H\n#define TWICE(x) \\\n  ((x) + (x))\nint a;\n#endif\n"));
+    EXPECT_TRUE(HeaderUnitTable::isEligible("#pragma once\n#define LIMIT 4\nint b;\n"));
+    EXPECT_FALSE(HeaderUnitTable::isEligible("int unguarded;\n"));
+    EXPECT_FALSE(HeaderUnitTable::isEligible("#pragma once\n#ifdef _DEBUG\nint d;\n#endif\n"));
+    EXPECT_FALSE(HeaderUnitTable::isEligible("#pragma once\n#include \"other.h\"\n"));
+    EXPECT_FALSE(HeaderUnitTable::isEligible("#ifndef C_H\n#define C_H\n#undef LIMIT\n#endif\n"));
+}
 
-    // Test #ifdef con macro definida
-    std::vector<lexer::Token> inputTokens1 = {
-        TestTokenFactory::createToken(lexer::TokenType::HASH, "#"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "ifdef"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "DEFINED_MACRO"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "content"),
-        TestTokenFactory::createToken(lexer::TokenType::HASH, "#"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "endif"),
-        TestTokenFactory::createToken(lexer::TokenType::END_OF_FILE)
-    };
-
-    auto outputTokens1 = preprocessor.process(inputTokens1);
-
-    // Debería incluir "content"
-    bool foundContent = false;
-    for (const auto& token : outputTokens1) {
-        if (token.getLexeme() == "content") {
-            foundContent = true;
-            break;
-        }
-    }
-    EXPECT_TRUE(foundContent);
-
-    // Test #ifndef con macro no definida
-    std::vector<lexer::Token> inputTokens2 = {
-        TestTokenFactory::createToken(lexer::TokenType::HASH, "#"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "ifndef"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "UNDEFINED_MACRO"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "content2"),
-        TestTokenFactory::createToken(lexer::TokenType::HASH, "#"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "endif"),
-        TestTokenFactory::createToken(lexer::TokenType::END_OF_FILE)
-    };
-
-    auto outputTokens2 = preprocessor.process(inputTokens2);
-
-    // Debería incluir "content2"
-    bool foundContent2 = false;
-    for (const auto& token : outputTokens2) {
-        if (token.getLexeme() == "content2") {
-            foundContent2 = true;
-            break;
-        }
-    }
-    EXPECT_TRUE(foundContent2);
+TEST_F(PreprocessorTest, FrequentHeadersAreImportedAsHeaderUnits) {
+    writeHeader("heavy.h", "#ifndef HEAVY_H\n#define HEAVY_H\n#define SQUARE(x) ((x) * (x))\nint heavy;\n#endif\n");
+    writeHeader("config.h", "#pragma once\n#if LEVEL > 1\nint fast;\n#endif\n");
+    std::string heavy = sourceManager_->getFile(sourceManager_->loadFile(dir_ / "heavy.h"))->path.string();
+    std::string config = sourceManager_->getFile(sourceManager_->loadFile(dir_ / "config.h"))->path.string();
+
+    auto table = std::make_shared<frontend::HeaderUnitTable>(std::filesystem::path(), frontend::HeaderUnitTable::Policy{2, {}});
+    EntityStats once{CompilationPhase::HeaderInclusion, heavy, 1};
+    EXPECT_EQ(table->update({once, {CompilationPhase::HeaderInclusion, config, 5}}, *sourceManager_), 0u);
+    EXPECT_EQ(table->update({once}, *sourceManager_), 1u);
+    EXPECT_EQ(table->promotedCount(), 1u);
+
+    frontend::PreprocessorConfig ppConfig;
+    ppConfig.headerUnits = table;
+    std::string source = "#define LEVEL 2\n#include \"heavy.h\"\n#include \"config.h\"\n#include \"heavy.h\"\nSQUARE(LEVEL)\n";
+    Preprocessor first(diagEngine_, ppConfig);
+    EXPECT_EQ(preprocess(source, first), "int heavy ; int fast ; ( ( 2 ) * ( 2 ) )");
+    EXPECT_EQ(first.getStats().headerUnitImports, 1u);
+    EXPECT_EQ(first.moduleDependencies().imports, std::vector<std::string>{"\"heavy.h\""});
+    ASSERT_NE(table->unit(heavy), nullptr);
+
+    // La segunda unidad reutiliza el header unit ya construido
+    Preprocessor second(diagEngine_, ppConfig);
+    EXPECT_EQ(preprocess(source, second), preprocess(source));
+    EXPECT_EQ(second.getStats().headerUnitImports, 1u);
 }
 
-// Test para procesamiento de #include
-TEST(PreprocessorTest, IncludeDirectiveProcessing) {
-    DiagnosticEngine diagEngine;
-    Preprocessor preprocessor(diagEngine);
+TEST_F(PreprocessorTest, BasicInitialization) {
+    Preprocessor preprocessor(diagEngine_);
 
-    // Simular #include <iostream>
-    std::vector<lexer::Token> inputTokens = {
-        TestTokenFactory::createToken(lexer::TokenType::HASH, "#"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "include"),
-        TestTokenFactory::createToken(lexer::TokenType::LESS, "<"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "iostream"),
-        TestTokenFactory::createToken(lexer::TokenType::GREATER, ">"),
-        TestTokenFactory::createToken(lexer::TokenType::END_OF_FILE)
-    };
+    EXPECT_TRUE(preprocessor.isMacroDefined("__cplusplus"));
+    EXPECT_TRUE(preprocessor.isMacroDefined("__STDC_HOSTED__"));
+    EXPECT_TRUE(preprocessor.isMacroDefined("__FILE__"));
+    EXPECT_TRUE(preprocessor.isMacroDefined("__LINE__"));
+    EXPECT_TRUE(preprocessor.isMacroDefined("__DATE__"));
+    EXPECT_TRUE(preprocessor.isMacroDefined("__TIME__"));
+}
 
-    auto outputTokens = preprocessor.process(inputTokens);
+TEST_F(PreprocessorTest, SimpleMacroDefinition) {
+    Preprocessor preprocessor(diagEngine_);
+    preprocessor.defineMacro("MAX_SIZE", "100");
 
-    // El output debería estar vacío porque #include se procesa
-    ASSERT_EQ(outputTokens.size(), 1);
-    EXPECT_EQ(outputTokens[0].getType(), lexer::TokenType::END_OF_FILE);
+    EXPECT_TRUE(preprocessor.isMacroDefined("MAX_SIZE"));
+    const MacroDefinition* macro = preprocessor.getMacro("MAX_SIZE");
+    ASSERT_NE(macro, nullptr);
+    EXPECT_EQ(macro->name, "MAX_SIZE");
+    EXPECT_FALSE(macro->isFunctionLike);
+    ASSERT_EQ(macro->body.size(), 1u);
+    EXPECT_EQ(macro->body[0].getLexeme(), "100");
 }
 
-// Test para expansión de macros simples
-TEST(PreprocessorTest, SimpleMacroExpansion) {
-    DiagnosticEngine diagEngine;
-    Preprocessor preprocessor(diagEngine);
+TEST_F(PreprocessorTest, FunctionMacroDefinition) {
+    Preprocessor preprocessor(diagEngine_);
+    EXPECT_EQ(preprocess("#define ADD(x, y) x + y\n", preprocessor), "");
 
-    // Definir macro
-    preprocessor.defineMacro("PI", "3.14159");
+    const MacroDefinition* macro = preprocessor.getMacro("ADD");
+    ASSERT_NE(macro, nullptr);
+    EXPECT_TRUE(macro->isFunctionLike);
+    EXPECT_EQ(macro->parameters, (std::vector<std::string>{"x", "y"}));
+    EXPECT_EQ(macro->body.size(), 3u);
+}
 
-    // Crear tokens con uso de la macro
-    std::vector<lexer::Token> inputTokens = {
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "PI"),
-        TestTokenFactory::createToken(lexer::TokenType::END_OF_FILE)
-    };
+TEST_F(PreprocessorTest, MacroUndefinition) {
+    Preprocessor preprocessor(diagEngine_);
 
-    auto outputTokens = preprocessor.process(inputTokens);
+    preprocessor.defineMacro("TEMP_MACRO", "value");
+    EXPECT_TRUE(preprocessor.isMacroDefined("TEMP_MACRO"));
+    preprocessor.undefineMacro("TEMP_MACRO");
+    EXPECT_FALSE(preprocessor.isMacroDefined("TEMP_MACRO"));
 
-    // Verificar que PI fue expandido a 3.14159
-    ASSERT_EQ(outputTokens.size(), 2); // "3.14159" + EOF
-    EXPECT_EQ(outputTokens[0].getLexeme(), "3.14159");
-    EXPECT_EQ(outputTokens[0].getType(), lexer::TokenType::FLOAT_LITERAL);
+    EXPECT_EQ(preprocess("#define LOCAL 1\n#undef LOCAL\nLOCAL\n", preprocessor), "LOCAL");
+    EXPECT_FALSE(preprocessor.isMacroDefined("LOCAL"));
 }
 
-// Test para expansión de macros de función (simplificada)
-TEST(PreprocessorTest, FunctionMacroExpansion) {
-    DiagnosticEngine diagEngine;
-    Preprocessor preprocessor(diagEngine);
+TEST_F(PreprocessorTest, BasicProcessing) {
+    Preprocessor preprocessor(diagEngine_);
+    std::vector<Token> output = tokens("int main()\n", preprocessor);
 
-    // Crear macro de función simple
-    std::vector<lexer::Token> body = {
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "a"),
-        TestTokenFactory::createToken(lexer::TokenType::PLUS, "+"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "b")
-    };
+    std::vector<TokenType> types;
+    for (const Token& token : output) {
+        types.push_back(token.getType());
+    }
+    EXPECT_EQ(types, (std::vector<TokenType>{TokenType::INT, TokenType::IDENTIFIER,
+                                             TokenType::LEFT_PAREN, TokenType::RIGHT_PAREN}));
+}
 
-    MacroDefinition funcMacro("SUM", body, true, false);
-    funcMacro.parameters = {"a", "b"};
-    preprocessor.defineMacro(funcMacro);
+TEST_F(PreprocessorTest, DefineDirectiveProcessing) {
+    Preprocessor preprocessor(diagEngine_);
+    EXPECT_TRUE(tokens("#define MAX 100\n", preprocessor).empty());
+    EXPECT_TRUE(preprocessor.isMacroDefined("MAX"));
+}
 
-    // Crear tokens con llamada a la macro
-    std::vector<lexer::Token> inputTokens = {
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "SUM"),
-        TestTokenFactory::createToken(lexer::TokenType::LEFT_PAREN, "("),
-        TestTokenFactory::createToken(lexer::TokenType::INTEGER_LITERAL, "1"),
-        TestTokenFactory::createToken(lexer::TokenType::COMMA, ","),
-        TestTokenFactory::createToken(lexer::TokenType::INTEGER_LITERAL, "2"),
-        TestTokenFactory::createToken(lexer::TokenType::RIGHT_PAREN, ")"),
-        TestTokenFactory::createToken(lexer::TokenType::END_OF_FILE)
-    };
+TEST_F(PreprocessorTest, ConditionalDirectiveProcessing) {
+    Preprocessor preprocessor(diagEngine_);
+    preprocessor.defineMacro("DEFINED_MACRO", "1");
 
-    auto outputTokens = preprocessor.process(inputTokens);
+    EXPECT_EQ(preprocess("#ifdef DEFINED_MACRO\ncontent\n#endif\n", preprocessor), "content");
+    EXPECT_EQ(preprocess("#ifndef UNDEFINED_MACRO\ncontent2\n#endif\n"), "content2");
+    EXPECT_EQ(preprocess("#ifdef UNDEFINED_MACRO\ncontent3\n#endif\n"), "");
+}
 
-    // Verificar que la expansión funcionó (simplificada)
-    EXPECT_GT(outputTokens.size(), 1);
+TEST_F(PreprocessorTest, IncludeDirectiveProcessing) {
+    // El #include abre el archivo de verdad: sin contenido no aporta tokens
+    writeHeader("empty.h", "// vacío\n");
+
+    Preprocessor preprocessor(diagEngine_);
+    EXPECT_TRUE(tokens("#include <empty.h>\n", preprocessor).empty());
+    EXPECT_EQ(preprocessor.getStats().includesProcessed, 1u);
+    EXPECT_FALSE(diagEngine_.hasErrors());
 }
 
-// Test para anidamiento condicional
-TEST(PreprocessorTest, NestedConditionals) {
-    DiagnosticEngine diagEngine;
-    Preprocessor preprocessor(diagEngine);
+TEST_F(PreprocessorTest, SimpleMacroExpansion) {
+    Preprocessor preprocessor(diagEngine_);
+    preprocessor.defineMacro("PI", "3.14159");
 
-    preprocessor.defineMacro("LEVEL1", "1");
+    std::vector<Token> output = tokens("PI\n", preprocessor);
+    ASSERT_EQ(output.size(), 1u);
+    EXPECT_EQ(output[0].getLexeme(), "3.14159");
+    EXPECT_EQ(output[0].getType(), TokenType::FLOAT_LITERAL);
+}
 
-    std::vector<lexer::Token> inputTokens = {
-        TestTokenFactory::createToken(lexer::TokenType::HASH, "#"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "ifdef"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "LEVEL1"),
-        TestTokenFactory::createToken(lexer::TokenType::HASH, "#"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "ifdef"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "LEVEL2"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "nested"),
-        TestTokenFactory::createToken(lexer::TokenType::HASH, "#"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "endif"),
-        TestTokenFactory::createToken(lexer::TokenType::HASH, "#"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "endif"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "outer"),
-        TestTokenFactory::createToken(lexer::TokenType::END_OF_FILE)
-    };
-
-    auto outputTokens = preprocessor.process(inputTokens);
-
-    // Debería incluir "outer" pero no "nested"
-    bool foundOuter = false, foundNested = false;
-    for (const auto& token : outputTokens) {
-        if (token.getLexeme() == "outer") foundOuter = true;
-        if (token.getLexeme() == "nested") foundNested = true;
-    }
+TEST_F(PreprocessorTest, FunctionMacroExpansion) {
+    EXPECT_EQ(preprocess("#define SUM(a, b) a + b\nSUM(1, 2)\n"), "1 + 2");
+}
 
-    EXPECT_TRUE(foundOuter);
-    EXPECT_FALSE(foundNested);
+TEST_F(PreprocessorTest, NestedConditionals) {
+    Preprocessor preprocessor(diagEngine_);
+    preprocessor.defineMacro("LEVEL1", "1");
+
+    EXPECT_EQ(preprocess("#ifdef LEVEL1\n#ifdef LEVEL2\nnested\n#endif\n#endif\nouter\n", preprocessor),
+              "outer");
 }
 
-// Test para estadísticas del preprocesador
-TEST(PreprocessorTest, PreprocessorStatistics) {
-    DiagnosticEngine diagEngine;
-    Preprocessor preprocessor(diagEngine);
+TEST_F(PreprocessorTest, PreprocessorStatistics) {
+    Preprocessor preprocessor(diagEngine_);
+    size_t predefined = preprocessor.getStats().macrosDefined;
 
-    // Definir algunas macros
     preprocessor.defineMacro("MACRO1", "value1");
     preprocessor.defineMacro("MACRO2", "value2");
-
-    // Eliminar una
     preprocessor.undefineMacro("MACRO1");
-
-    // Procesar algunos tokens
-    std::vector<lexer::Token> inputTokens = {
-        TestTokenFactory::createToken(lexer::TokenType::HASH, "#"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "define"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "TEMP"),
-        TestTokenFactory::createToken(lexer::TokenType::INTEGER_LITERAL, "42"),
-        TestTokenFactory::createToken(lexer::TokenType::END_OF_FILE)
-    };
-
-    preprocessor.process(inputTokens);
+    tokens("#define TEMP 42\nint x;\n", preprocessor);
 
     auto stats = preprocessor.getStats();
-
-    EXPECT_EQ(stats.macrosDefined, 3); // 2 manuales + 1 procesada
-    EXPECT_EQ(stats.macrosUndefined, 1);
-    EXPECT_EQ(stats.tokensProcessed, 5);
+    EXPECT_EQ(stats.macrosDefined, predefined + 3); // 2 manuales + 1 procesada
+    EXPECT_EQ(stats.macrosUndefined, 1u);
+    EXPECT_EQ(stats.tokensProcessed, 3u);           // Los tokens se cuentan al entregarse: no las directivas
 }
 
-// Test para macros predefinidas
-TEST(PreprocessorTest, PredefinedMacros) {
-    DiagnosticEngine diagEngine;
-    Preprocessor preprocessor(diagEngine);
-
-    // Verificar macros estándar de C++
-    EXPECT_TRUE(preprocessor.isMacroDefined("__cplusplus"));
+TEST_F(PreprocessorTest, PredefinedMacros) {
+    Preprocessor preprocessor(diagEngine_);
 
     const MacroDefinition* cppMacro = preprocessor.getMacro("__cplusplus");
-    ASSERT_TRUE(cppMacro != nullptr);
+    ASSERT_NE(cppMacro, nullptr);
     EXPECT_FALSE(cppMacro->isFunctionLike);
-    EXPECT_EQ(cppMacro->body.size(), 1);
+    ASSERT_EQ(cppMacro->body.size(), 1u);
     EXPECT_EQ(cppMacro->body[0].getLexeme(), "202002L");
+    EXPECT_EQ(preprocess("__cplusplus __STDC_HOSTED__\n"), "202002L 1");
 }
 
-// Test para procesamiento de #pragma
-TEST(PreprocessorTest, PragmaDirectiveProcessing) {
-    DiagnosticEngine diagEngine;
-    Preprocessor preprocessor(diagEngine);
-
-    std::vector<lexer::Token> inputTokens = {
-        TestTokenFactory::createToken(lexer::TokenType::HASH, "#"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "pragma"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "once"),
-        TestTokenFactory::createToken(lexer::TokenType::END_OF_FILE)
-    };
-
-    auto outputTokens = preprocessor.process(inputTokens);
-
-    // #pragma debería ser procesado sin generar output
-    ASSERT_EQ(outputTokens.size(), 1);
-    EXPECT_EQ(outputTokens[0].getType(), lexer::TokenType::END_OF_FILE);
+TEST_F(PreprocessorTest, PragmaDirectiveProcessing) {
+    EXPECT_EQ(preprocess("#pragma once\n#pragma warning(disable: 4996)\nint p;\n"), "int p ;");
+    EXPECT_FALSE(diagEngine_.hasErrors());
 }
 
-// Test para procesamiento de #line
-TEST(PreprocessorTest, LineDirectiveProcessing) {
-    DiagnosticEngine diagEngine;
-    Preprocessor preprocessor(diagEngine);
+TEST_F(PreprocessorTest, LineDirectiveProcessing) {
+    Preprocessor preprocessor(diagEngine_);
+    std::vector<Token> output = tokens("#line 100 \"test.h\"\nint l;\n", preprocessor);
 
-    std::vector<lexer::Token> inputTokens = {
-        TestTokenFactory::createToken(lexer::TokenType::HASH, "#"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "line"),
-        TestTokenFactory::createToken(lexer::TokenType::INTEGER_LITERAL, "100"),
-        TestTokenFactory::createToken(lexer::TokenType::STRING_LITERAL, "\"test.h\""),
-        TestTokenFactory::createToken(lexer::TokenType::END_OF_FILE)
-    };
-
-    auto outputTokens = preprocessor.process(inputTokens);
-
-    // #line debería ser procesado sin generar output
-    ASSERT_EQ(outputTokens.size(), 1);
-    EXPECT_EQ(outputTokens[0].getType(), lexer::TokenType::END_OF_FILE);
+    ASSERT_EQ(output.size(), 3u);
+    EXPECT_EQ(output[0].getLexeme(), "int");
+    EXPECT_FALSE(diagEngine_.hasErrors());
 }
 
-// Test para procesamiento de #error
-TEST(PreprocessorTest, ErrorDirectiveProcessing) {
-    DiagnosticEngine diagEngine;
-    Preprocessor preprocessor(diagEngine);
-
-    std::vector<lexer::Token> inputTokens = {
-        TestTokenFactory::createToken(lexer::TokenType::HASH, "#"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "error"),
-        TestTokenFactory::createToken(lexer::TokenType::STRING_LITERAL, "\"Test error\""),
-        TestTokenFactory::createToken(lexer::TokenType::END_OF_FILE)
-    };
-
-    // Este test verificaría que se reporta un error, pero no podemos capturar
-    // la salida de error fácilmente en este contexto
-    auto outputTokens = preprocessor.process(inputTokens);
-
-    // #error debería ser procesado sin generar output
-    ASSERT_EQ(outputTokens.size(), 1);
-    EXPECT_EQ(outputTokens[0].getType(), lexer::TokenType::END_OF_FILE);
+TEST_F(PreprocessorTest, ErrorDirectiveProcessing) {
+    ::testing::internal::CaptureStderr();
+    EXPECT_EQ(preprocess("#error \"Test error\"\n"), "");
+    EXPECT_NE(::testing::internal::GetCapturedStderr().find("Test error"), std::string::npos);
 }
 
-// Test para procesamiento de expresiones condicionales
-TEST(PreprocessorTest, ConditionalExpressionProcessing) {
-    DiagnosticEngine diagEngine;
-    Preprocessor preprocessor(diagEngine);
-
+TEST_F(PreprocessorTest, ConditionalExpressionProcessing) {
+    Preprocessor preprocessor(diagEngine_);
     preprocessor.defineMacro("VALUE", "5");
 
-    std::vector<lexer::Token> inputTokens = {
-        TestTokenFactory::createToken(lexer::TokenType::HASH, "#"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "if"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "VALUE"),
-        TestTokenFactory::createToken(lexer::TokenType::GREATER, ">"),
-        TestTokenFactory::createToken(lexer::TokenType::INTEGER_LITERAL, "3"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "included"),
-        TestTokenFactory::createToken(lexer::TokenType::HASH, "#"),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "endif"),
-        TestTokenFactory::createToken(lexer::TokenType::END_OF_FILE)
-    };
-
-    auto outputTokens = preprocessor.process(inputTokens);
-
-    // Debería incluir "included" porque VALUE > 3
-    bool foundIncluded = false;
-    for (const auto& token : outputTokens) {
-        if (token.getLexeme() == "included") {
-            foundIncluded = true;
-            break;
-        }
-    }
-    EXPECT_TRUE(foundIncluded);
+    EXPECT_EQ(preprocess("#if VALUE > 3\nincluded\n#endif\n", preprocessor), "included");
+    EXPECT_EQ(preprocess("#if VALUE < 3\nexcluded\n#endif\n", preprocessor), "");
 }
 
-// Test para configuración del preprocesador
-TEST(PreprocessorTest, PreprocessorConfiguration) {
-    DiagnosticEngine diagEngine;
-
-    PreprocessorConfig config;
+TEST_F(PreprocessorTest, PreprocessorConfiguration) {
+    frontend::PreprocessorConfig config;
     config.enableWarnings = false;
     config.maxIncludeDepth = 10;
     config.includePaths = {"/usr/include", "/opt/include"};
 
-    Preprocessor preprocessor(diagEngine, config);
+    Preprocessor preprocessor(diagEngine_, config);
 
-    // Verificar que la configuración se aplicó
-    EXPECT_EQ(config.maxIncludeDepth, 10);
-    EXPECT_EQ(config.includePaths.size(), 2);
+    EXPECT_EQ(config.maxIncludeDepth, 10u);
+    EXPECT_EQ(config.includePaths.size(), 2u);
     EXPECT_FALSE(config.enableWarnings);
 }
 
-// Test para utilidades del preprocesador
 TEST(PreprocessorUtilsTest, DirectiveDetection) {
-    using namespace cpp20::compiler::frontend;
+    using frontend::PreprocessorUtils;
+    diagnostics::DiagnosticEngine diagEngine(std::make_shared<diagnostics::SourceManager>());
+    Lexer lexer("# int", diagEngine);
+    Token hashToken = lexer.getNextToken();
+    Token identToken = lexer.getNextToken();
 
-    // Test para detectar directivas
-    lexer::Token hashToken(lexer::TokenType::HASH, "#", SourceLocation("", 1, 1));
     EXPECT_TRUE(PreprocessorUtils::isDirectiveStart(hashToken));
-
-    lexer::Token identToken(lexer::TokenType::IDENTIFIER, "int", SourceLocation("", 1, 1));
     EXPECT_FALSE(PreprocessorUtils::isDirectiveStart(identToken));
-
-    // Test para extraer nombre de directiva
     EXPECT_EQ(PreprocessorUtils::extractDirectiveName(hashToken), "#");
 
-    // Test para líneas en blanco
-    std::vector<lexer::Token> blankLine = {
-        lexer::Token(lexer::TokenType::INVALID, " ", SourceLocation("", 1, 1))
-    };
-    EXPECT_TRUE(PreprocessorUtils::isBlankLine(blankLine));
-
-    std::vector<lexer::Token> nonBlankLine = {
-        lexer::Token(lexer::TokenType::INT, "int", SourceLocation("", 1, 1))
-    };
-    EXPECT_FALSE(PreprocessorUtils::isBlankLine(nonBlankLine));
+    EXPECT_TRUE(PreprocessorUtils::isBlankLine({Token(TokenType::INVALID, " ", hashToken.getLocation())}));
+    EXPECT_FALSE(PreprocessorUtils::isBlankLine({identToken}));
 }
 
-// Test para procesamiento de macros complejas
-TEST(PreprocessorTest, ComplexMacroProcessing) {
-    DiagnosticEngine diagEngine;
-    Preprocessor preprocessor(diagEngine);
-
-    // Definir macro compleja
-    std::vector<lexer::Token> body = {
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "printf"),
-        TestTokenFactory::createToken(lexer::TokenType::LEFT_PAREN, "("),
-        TestTokenFactory::createToken(lexer::TokenType::STRING_LITERAL, "\"%d\\n\""),
-        TestTokenFactory::createToken(lexer::TokenType::COMMA, ","),
-        TestTokenFactory::createToken(lexer::TokenType::IDENTIFIER, "x"),
-        TestTokenFactory::createToken(lexer::TokenType::RIGHT_PAREN, ")"),
-        TestTokenFactory::createToken(lexer::TokenType::SEMICOLON, ";")
-    };
-
-    MacroDefinition complexMacro("PRINT_INT", body, true, false);
-    complexMacro.parameters = {"x"};
-    preprocessor.defineMacro(complexMacro);
-
-    EXPECT_TRUE(preprocessor.isMacroDefined("PRINT_INT"));
+TEST_F(PreprocessorTest, ComplexMacroProcessing) {
+    Preprocessor preprocessor(diagEngine_);
+    EXPECT_EQ(preprocess("#define PRINT_INT(x) printf(\"%d\\n\", x);\nPRINT_INT(42)\n", preprocessor),
+              "printf ( \"%d\\n\" , 42 ) ;");
 
     const MacroDefinition* macro = preprocessor.getMacro("PRINT_INT");
-    ASSERT_TRUE(macro != nullptr);
+    ASSERT_NE(macro, nullptr);
     EXPECT_TRUE(macro->isFunctionLike);
-    EXPECT_EQ(macro->parameters.size(), 1);
-    EXPECT_EQ(macro->parameters[0], "x");
+    EXPECT_EQ(macro->parameters, std::vector<std::string>{"x"});
 }
 
-// Test para límites y casos extremos
-TEST(PreprocessorTest, LimitsAndEdgeCases) {
-    DiagnosticEngine diagEngine;
-    Preprocessor preprocessor(diagEngine);
+TEST_F(PreprocessorTest, LimitsAndEdgeCases) {
+    Preprocessor preprocessor(diagEngine_);
+    size_t predefined = preprocessor.getStats().macrosDefined;
 
-    // Test con nombre de macro vacío (debería fallar)
+    // Un nombre vacío no define nada
     preprocessor.defineMacro("", "value");
     EXPECT_FALSE(preprocessor.isMacroDefined(""));
 
-    // Test con macro que se redefine a sí misma
     preprocessor.defineMacro("SELF", "SELF");
     EXPECT_TRUE(preprocessor.isMacroDefined("SELF"));
+    EXPECT_EQ(preprocess("SELF\n", preprocessor), "SELF");
 
-    // Test con undef de macro no existente
+    // #undef de una macro inexistente no es un error
     preprocessor.undefineMacro("NONEXISTENT");
-    // No debería causar problemas
 
-    // Test con muchas macros
     for (int i = 0; i < 100; ++i) {
         std::string name = "MACRO" + std::to_string(i);
         preprocessor.defineMacro(name, "value" + std::to_string(i));
         EXPECT_TRUE(preprocessor.isMacroDefined(name));
     }
 
-    auto stats = preprocessor.getStats();
-    EXPECT_EQ(stats.macrosDefined, 103); // 100 + SELF + las predefinidas
+    EXPECT_EQ(preprocessor.getStats().macrosDefined, predefined + 101); // 100 + SELF
 }
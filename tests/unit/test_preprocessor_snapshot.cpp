@@ -0,0 +1,165 @@
+/**
+ * @file test_preprocessor_snapshot.cpp
+ * @brief Tests para las instantáneas del preprocesador tras el prólogo de #include
+ */
+
+#include <compiler/frontend/PreprocessorSnapshot.h>
+#include <compiler/frontend/lexer/Lexer.h>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+using namespace cpp20::compiler;
+using frontend::Preprocessor;
+using frontend::PreprocessorSnapshot;
+using frontend::lexer::Lexer;
+using frontend::lexer::Token;
+
+namespace {
+
+/**
+ * @brief Una invocación del compilador: SourceManager y diagnósticos propios
+ */
+struct Invocation {
+    std::shared_ptr<diagnostics::SourceManager> sourceManager =
+        std::make_shared<diagnostics::SourceManager>();
+    diagnostics::DiagnosticEngine diagEngine{sourceManager};
+
+    explicit Invocation(const std::filesystem::path& includeDir) {
+        sourceManager->addIncludePath(includeDir, false);
+    }
+};
+
+class PreprocessorSnapshotTest : public ::testing::Test {
+protected:
+    std::filesystem::path dir_ = std::filesystem::temp_directory_path() / "pp_snapshot_test";
+    std::filesystem::path snapshotFile_ = dir_ / "prologue.ppsnap";
+
+    void SetUp() override {
+        std::filesystem::remove_all(dir_);
+        std::filesystem::create_directories(dir_);
+        writeHeader("common.h",
+                    "#ifndef COMMON_H\n#define COMMON_H\n#define SQUARE(x) ((x) * (x))\n"
+                    "#define LIMIT 8\nint shared;\n#endif\n");
+        writeHeader("extra.h", "#pragma once\nint extra;\n");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dir_);
+    }
+
+    void writeHeader(const std::string& name, const std::string& content) {
+        std::ofstream out(dir_ / name, std::ios::binary);
+        out << content;
+    }
+
+    static std::string spell(const std::vector<Token>& tokens) {
+        std::string result;
+        for (const Token& token : tokens) {
+            if (!result.empty()) result += ' ';
+            result += token.getLexeme();
+        }
+        return result;
+    }
+
+    /// Preprocesar un archivo principal; con snapshot != nullptr se intenta restaurar
+    std::string run(Invocation& invocation, const std::string& source,
+                    const PreprocessorSnapshot* snapshot, bool* restored = nullptr) {
+        uint32_t fileId = invocation.sourceManager->createVirtualFile(source, "main.cpp");
+        std::string_view text = invocation.sourceManager->getFile(fileId)->text();
+
+        Preprocessor preprocessor(invocation.diagEngine);
+        bool didRestore = snapshot && preprocessor.restoreSnapshot(*snapshot, fileId);
+        if (restored) {
+            *restored = didRestore;
+        }
+        if (!didRestore) {
+            preprocessor.requestSnapshot(fileId, PreprocessorSnapshot::prologueOf(text).size());
+        }
+
+        frontend::lexer::LexerConfig config;
+        config.fileId = fileId;
+        Lexer lexer(text, invocation.diagEngine, config);
+        std::string result = spell(preprocessor.process(lexer));
+
+        if (auto captured = preprocessor.takeSnapshot()) {
+            captured->save(snapshotFile_);
+        }
+        return result;
+    }
+};
+
+const char* const kPrologue = "// unidad\n#include \"common.h\"\n\n#include \"extra.h\"\n";
+
+} // namespace
+
+TEST_F(PreprocessorSnapshotTest, PrologueCoversLeadingIncludeLines) {
+    std::string source = std::string(kPrologue) + "int x;\n#include \"late.h\"\n";
+    EXPECT_EQ(PreprocessorSnapshot::prologueOf(source), kPrologue);
+    EXPECT_EQ(PreprocessorSnapshot::prologueOf("int x;\n#include \"common.h\"\n"), "");
+    EXPECT_EQ(PreprocessorSnapshot::prologueOf("#include \"a.h\"\n#define X\n"), "#include \"a.h\"\n");
+}
+
+TEST_F(PreprocessorSnapshotTest, RestoredPrologueMatchesFullPreprocessing) {
+    {
+        Invocation first(dir_);
+        run(first, std::string(kPrologue) + "int a = LIMIT;\n", nullptr);
+    }
+    auto snapshot = PreprocessorSnapshot::load(snapshotFile_);
+    ASSERT_TRUE(snapshot.has_value());
+    EXPECT_EQ(snapshot->files.size(), 2u);
+
+    // Otra unidad con el mismo prólogo en una invocación nueva
+    std::string source = std::string(kPrologue) +
+                         "#include \"common.h\"\nint b = SQUARE(LIMIT);\n#include \"extra.h\"\n";
+    Invocation fresh(dir_);
+    std::string expected = run(fresh, source, nullptr);
+
+    Invocation second(dir_);
+    bool restored = false;
+    EXPECT_EQ(run(second, source, &*snapshot, &restored), expected);
+    EXPECT_TRUE(restored);
+    EXPECT_EQ(expected, "int shared ; int extra ; int b = ( ( 8 ) * ( 8 ) ) ;");
+}
+
+TEST_F(PreprocessorSnapshotTest, ChangedHeaderRejectsSnapshot) {
+    {
+        Invocation first(dir_);
+        run(first, std::string(kPrologue) + "int a;\n", nullptr);
+    }
+    auto snapshot = PreprocessorSnapshot::load(snapshotFile_);
+    ASSERT_TRUE(snapshot.has_value());
+
+    writeHeader("extra.h", "#pragma once\nint changed;\n");
+
+    Invocation second(dir_);
+    bool restored = true;
+    EXPECT_EQ(run(second, std::string(kPrologue) + "int a;\n", &*snapshot, &restored),
+              "int shared ; int changed ; int a ;");
+    EXPECT_FALSE(restored);
+}
+
+TEST_F(PreprocessorSnapshotTest, HeaderAppearingLaterRejectsSnapshot) {
+    std::string source = std::string(kPrologue) + "#include \"missing.h\"\nint a;\n";
+    {
+        Invocation first(dir_);
+        run(first, source, nullptr);
+    }
+    auto snapshot = PreprocessorSnapshot::load(snapshotFile_);
+    ASSERT_TRUE(snapshot.has_value());
+
+    writeHeader("missing.h", "int found;\n");
+
+    Invocation second(dir_);
+    bool restored = true;
+    EXPECT_EQ(run(second, source, &*snapshot, &restored), "int shared ; int extra ; int found ; int a ;");
+    EXPECT_FALSE(restored);
+}
+
+TEST_F(PreprocessorSnapshotTest, CorruptFileIsIgnored) {
+    std::ofstream(snapshotFile_, std::ios::binary) << "CPPSNAP1 truncated";
+    EXPECT_FALSE(PreprocessorSnapshot::load(snapshotFile_).has_value());
+    EXPECT_FALSE(PreprocessorSnapshot::load(dir_ / "absent.ppsnap").has_value());
+}
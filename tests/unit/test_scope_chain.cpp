@@ -0,0 +1,157 @@
+/**
+ * @file test_scope_chain.cpp
+ * @brief Tests para la cadena de scopes de la tabla de símbolos
+ */
+
+#include <compiler/symbols/ScopeChain.h>
+#include <compiler/frontend/lexer/IdentifierTable.h>
+#include <compiler/types/Type.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace cpp20::compiler;
+using frontend::lexer::IdentifierTable;
+
+TEST(ScopeChainTest, InnermostDeclarationShadowsOuterOnes) {
+    IdentifierTable identifiers;
+    types::BasicType intType(types::BasicType::BasicKind::Int);
+    symbols::SymbolArena arena;
+    auto x = identifiers.get("x");
+    const symbols::Symbol* outer = arena.createVariable(x, &intType);
+    const symbols::Symbol* inner = arena.createVariable(x, &intType);
+
+    symbols::ScopeChain chain;
+    EXPECT_EQ(chain.currentScope(), 1u);
+    EXPECT_TRUE(chain.insert(x, outer));
+    uint32_t block = chain.enter();
+    EXPECT_EQ(block, 2u);
+    EXPECT_EQ(chain.find(x), outer);
+    EXPECT_TRUE(chain.insert(x, inner));
+
+    // Ocultar no es ambigüedad: find() se queda con la más interna
+    EXPECT_EQ(chain.find(x), inner);
+    EXPECT_EQ(chain.findInGlobal(x), outer);
+    EXPECT_EQ(chain.findAll(x), (std::vector<const symbols::Symbol*>{inner, outer}));
+
+    EXPECT_TRUE(chain.exit());
+    EXPECT_EQ(chain.find(x), outer);
+    EXPECT_EQ(chain.findAll(x).size(), 1u);
+}
+
+TEST(ScopeChainTest, RedeclarationInTheSameScopeIsRejected) {
+    IdentifierTable identifiers;
+    types::BasicType intType(types::BasicType::BasicKind::Int);
+    symbols::SymbolArena arena;
+    auto f = identifiers.get("f");
+    const symbols::Symbol* first = arena.createVariable(f, &intType);
+    const symbols::Symbol* second = arena.createVariable(f, &intType);
+
+    symbols::ScopeChain chain;
+    EXPECT_TRUE(chain.insert(f, first));
+    EXPECT_FALSE(chain.insert(f, second));
+    EXPECT_EQ(chain.find(f), first);
+
+    EXPECT_FALSE(chain.insert(nullptr, first));
+    EXPECT_FALSE(chain.insert(identifiers.get("g"), nullptr));
+    EXPECT_EQ(chain.find(nullptr), nullptr);
+}
+
+TEST(ScopeChainTest, ExitForgetsOnlyTheClosedScope) {
+    IdentifierTable identifiers;
+    types::BasicType intType(types::BasicType::BasicKind::Int);
+    symbols::SymbolArena arena;
+
+    // Suficientes nombres para que las tablas de los scopes crezcan varias veces
+    std::vector<symbols::ScopeChain::Name> globals;
+    std::vector<symbols::ScopeChain::Name> locals;
+    for (int i = 0; i < 100; ++i) {
+        globals.push_back(identifiers.get("g" + std::to_string(i)));
+        locals.push_back(identifiers.get("l" + std::to_string(i)));
+    }
+
+    symbols::ScopeChain chain;
+    for (auto name : globals) {
+        ASSERT_TRUE(chain.insert(name, arena.createVariable(name, &intType)));
+    }
+    chain.enter();
+    for (auto name : locals) {
+        ASSERT_TRUE(chain.insert(name, arena.createVariable(name, &intType)));
+    }
+    for (size_t i = 0; i < globals.size(); ++i) {
+        EXPECT_EQ(chain.find(globals[i])->identifier(), globals[i]);
+        EXPECT_EQ(chain.find(locals[i])->identifier(), locals[i]);
+    }
+
+    EXPECT_TRUE(chain.exit());
+    for (size_t i = 0; i < globals.size(); ++i) {
+        EXPECT_NE(chain.find(globals[i]), nullptr);
+        EXPECT_EQ(chain.find(locals[i]), nullptr);
+    }
+
+    // El scope reciclado llega vacío y con un id nuevo
+    EXPECT_EQ(chain.enter(), 3u);
+    EXPECT_EQ(chain.findInCurrent(locals[0]), nullptr);
+    EXPECT_TRUE(chain.insert(locals[0], arena.createVariable(locals[0], &intType)));
+}
+
+TEST(ScopeChainTest, GlobalScopeIsNeverLeft) {
+    IdentifierTable identifiers;
+    types::BasicType intType(types::BasicType::BasicKind::Int);
+    symbols::SymbolArena arena;
+    auto x = identifiers.get("x");
+
+    symbols::ScopeChain chain;
+    EXPECT_FALSE(chain.exit());
+    EXPECT_EQ(chain.depth(), 1u);
+    EXPECT_TRUE(chain.insert(x, arena.createVariable(x, &intType)));
+    EXPECT_NE(chain.findInGlobal(x), nullptr);
+}
+
+TEST(ScopeChainTest, LookupInScopeSeesOnlyActiveScopes) {
+    IdentifierTable identifiers;
+    types::BasicType intType(types::BasicType::BasicKind::Int);
+    symbols::SymbolArena arena;
+    auto x = identifiers.get("x");
+    auto y = identifiers.get("y");
+    const symbols::Symbol* global = arena.createVariable(x, &intType);
+    const symbols::Symbol* local = arena.createVariable(y, &intType);
+
+    symbols::ScopeChain chain;
+    chain.insert(x, global);
+    uint32_t function = chain.enter();
+    chain.insert(y, local);
+    chain.enter();
+
+    EXPECT_EQ(chain.findInScope(x, 1), global);
+    EXPECT_EQ(chain.findInScope(y, function), local);
+    EXPECT_EQ(chain.findInScope(x, function), nullptr);
+    EXPECT_EQ(chain.findInCurrent(y), nullptr);
+
+    chain.exit();
+    chain.exit();
+    EXPECT_EQ(chain.findInScope(y, function), nullptr);
+}
+
+TEST(ScopeChainTest, ClearReopensTheGlobalScope) {
+    IdentifierTable identifiers;
+    types::BasicType intType(types::BasicType::BasicKind::Int);
+    symbols::SymbolArena arena;
+    auto x = identifiers.get("x");
+
+    symbols::ScopeChain chain;
+    chain.insert(x, arena.createVariable(x, &intType));
+    chain.enter();
+    chain.enter();
+    chain.exit();
+    EXPECT_EQ(chain.scopesCreated(), 3u);
+    EXPECT_EQ(chain.maxDepth(), 3u);
+    EXPECT_EQ(chain.depth(), 2u);
+
+    chain.clear();
+    EXPECT_EQ(chain.find(x), nullptr);
+    EXPECT_EQ(chain.currentScope(), 1u);
+    EXPECT_EQ(chain.depth(), 1u);
+    EXPECT_EQ(chain.scopesCreated(), 1u);
+    EXPECT_EQ(chain.maxDepth(), 1u);
+}
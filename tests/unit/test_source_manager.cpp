@@ -0,0 +1,257 @@
+/**
+ * @file test_source_manager.cpp
+ * @brief Tests para la carga de archivos del SourceManager
+ */
+
+#include <compiler/common/diagnostics/SourceManager.h>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace cpp20::compiler::diagnostics;
+
+namespace {
+
+std::filesystem::path writeTempFile(const std::string& name, const std::string& content) {
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::ofstream out(path, std::ios::binary);
+    out << content;
+    return path;
+}
+
+std::string makeLargeSource(const std::string& newline) {
+    std::string content;
+    for (int i = 0; i < 4096; ++i) {
+        content += "int value" + std::to_string(i) + " = 0;" + newline;
+    }
+    return content;
+}
+
+} // namespace
+
+TEST(SourceManagerTest, LargeFilesAreMappedWithoutCopy) {
+    std::string content = makeLargeSource("\n");
+    auto path = writeTempFile("sm_mapped.cpp", content);
+
+    SourceManager manager;
+    uint32_t id = manager.loadFile(path);
+    const SourceFile* file = manager.getFile(id);
+    ASSERT_NE(file, nullptr);
+
+    EXPECT_TRUE(file->isMapped());
+    EXPECT_TRUE(file->rawContent.empty());
+    EXPECT_TRUE(file->normalizedContent.empty());
+    EXPECT_EQ(file->text(), content);
+    EXPECT_EQ(file->text().data(), file->rawText().data());
+    EXPECT_EQ(file->fileSize, content.size());
+
+    std::filesystem::remove(path);
+}
+
+TEST(SourceManagerTest, MappedCrlfFilesAreNormalized) {
+    auto path = writeTempFile("sm_crlf.cpp", makeLargeSource("\r\n"));
+
+    SourceManager manager;
+    const SourceFile* file = manager.getFile(manager.loadFile(path));
+    ASSERT_NE(file, nullptr);
+
+    EXPECT_TRUE(file->isMapped());
+    EXPECT_EQ(file->text(), makeLargeSource("\n"));
+    EXPECT_EQ(file->getLine(1), "int value0 = 0;");
+
+    std::filesystem::remove(path);
+}
+
+TEST(SourceManagerTest, SmallFilesAreReadIntoMemory) {
+    auto path = writeTempFile("sm_small.cpp", "int a;\r\nint b;\r\n");
+
+    SourceManager manager;
+    const SourceFile* file = manager.getFile(manager.loadFile(path));
+    ASSERT_NE(file, nullptr);
+
+    EXPECT_FALSE(file->isMapped());
+    EXPECT_EQ(file->text(), "int a;\nint b;\n");
+    EXPECT_EQ(file->getNormalizedContent(), "int a;\nint b;\n");
+
+    std::filesystem::remove(path);
+}
+
+TEST(SourceManagerTest, MappingCanBeDisabled) {
+    std::string content = makeLargeSource("\n");
+    auto path = writeTempFile("sm_nomap.cpp", content);
+
+    SourceManager manager;
+    manager.setUseMemoryMapping(false);
+    const SourceFile* file = manager.getFile(manager.loadFile(path));
+    ASSERT_NE(file, nullptr);
+
+    EXPECT_FALSE(file->isMapped());
+    EXPECT_EQ(file->text(), content);
+
+    std::filesystem::remove(path);
+}
+
+TEST(SourceManagerTest, LineOffsetsResolveLocations) {
+    SourceManager manager;
+    uint32_t id = manager.createVirtualFile("first\nsecond\nthird", "virtual.cpp");
+    const SourceFile* file = manager.getFile(id);
+    ASSERT_NE(file, nullptr);
+
+    EXPECT_EQ(file->lineCount(), 3u);
+
+    SourceLocation location = file->locationForOffset(8);
+    EXPECT_EQ(location.line(), 2u);
+    EXPECT_EQ(location.column(), 3u);
+    EXPECT_EQ(file->offsetForLocation(location), 8u);
+    EXPECT_EQ(file->getLine(3), "third");
+}
+
+TEST(SourceManagerTest, LineTextViewsTheContent) {
+    SourceManager manager;
+    uint32_t id = manager.createVirtualFile("first\nsecond\n\nfourth\n", "virtual.cpp");
+    const SourceFile* file = manager.getFile(id);
+    ASSERT_NE(file, nullptr);
+
+    EXPECT_EQ(file->lineForOffset(0), 1u);
+    EXPECT_EQ(file->lineForOffset(6), 2u);
+    EXPECT_EQ(file->lineForOffset(13), 3u);
+    EXPECT_EQ(file->lineForOffset(100), 0u);
+
+    std::string_view line = file->lineText(2);
+    EXPECT_EQ(line, "second");
+    EXPECT_EQ(line.data(), file->text().data() + 6);     // Sin copia
+    EXPECT_TRUE(file->lineText(3).empty());
+    EXPECT_TRUE(file->lineText(9).empty());
+
+    EXPECT_EQ(manager.getLineText(SourceLocation(4, 1, 0, id)), "fourth");
+    EXPECT_EQ(manager.getContextLines(SourceLocation(2, 1, 0, id), 1, 1),
+              "     1 | first\n     2 | second\n     3 | ");
+}
+
+TEST(SourceManagerTest, CompactLocationsResolveThroughFilesAndExpansions) {
+    SourceManager manager;
+    uint32_t header = manager.createVirtualFile("#define SQUARE(x) x * x\n", "square.h");
+    uint32_t main = manager.createVirtualFile("int a;\nint b = SQUARE(a);\n", "main.cpp");
+
+    CompactSourceLocation bodyStart = manager.getCompactLocation(header, 18);     // "x * x"
+    CompactSourceLocation invocation = manager.getCompactLocation(SourceLocation(2, 9, 0, main));
+    ASSERT_TRUE(bodyStart.isFileLocation());
+    ASSERT_TRUE(invocation.isFileLocation());
+    EXPECT_NE(bodyStart, invocation);
+    EXPECT_EQ(manager.getFileId(bodyStart), header);
+    EXPECT_EQ(manager.getFileId(invocation), main);
+
+    SourceLocation resolved = manager.getSourceLocation(invocation);
+    EXPECT_EQ(resolved.fileId(), main);
+    EXPECT_EQ(resolved.line(), 2u);
+    EXPECT_EQ(resolved.column(), 9u);
+
+    CompactSourceLocation expanded = manager.createExpansionLocation(bodyStart, invocation, 5);
+    ASSERT_TRUE(expanded.isMacroLocation());
+    EXPECT_EQ(manager.getSpellingLocation(expanded + 4), bodyStart + 4);
+    EXPECT_EQ(manager.getExpansionLocation(expanded + 4), invocation);
+    EXPECT_EQ(manager.getSourceLocation(expanded + 2).line(), 2u);       // Se ve en la invocación
+
+    // Expansión anidada: su texto viene de la anterior
+    CompactSourceLocation nested = manager.createExpansionLocation(expanded, invocation, 5);
+    EXPECT_EQ(manager.getSpellingLocation(nested + 1), bodyStart + 1);
+    EXPECT_FALSE(manager.getCompactLocation(99, 0).isValid());
+    EXPECT_FALSE(manager.getSourceLocation(CompactSourceLocation()).isValid());
+}
+
+TEST(SourceManagerTest, OtherPathsToTheSameFileAreAliases) {
+    auto path = writeTempFile("sm_alias.h", "#pragma once\r\nint a;\r\n");
+    auto dotted = path.parent_path() / "." / path.filename();
+    auto link = path.parent_path() / "sm_alias_link.h";
+    std::error_code ec;
+    std::filesystem::remove(link, ec);
+    std::filesystem::create_symlink(path, link, ec);
+    bool haveLink = !ec;
+
+    SourceManager manager;
+    uint32_t first = manager.loadFile(path);
+    uint32_t second = manager.loadFile(dotted, "alias.h");
+    ASSERT_NE(first, 0u);
+    ASSERT_NE(second, first);
+    EXPECT_EQ(manager.loadFile(dotted), second);
+
+    const SourceFile* canonical = manager.getFile(first);
+    const SourceFile* alias = manager.getFile(second);
+    EXPECT_FALSE(canonical->isAlias());
+    EXPECT_TRUE(alias->isAlias());
+    EXPECT_EQ(manager.getCanonicalFileId(second), first);
+    EXPECT_EQ(alias->path, dotted);
+    EXPECT_EQ(alias->displayName, "alias.h");
+    EXPECT_EQ(alias->text().data(), canonical->text().data());     // Mismo buffer normalizado
+    EXPECT_EQ(&alias->lineOffsets(), &canonical->lineOffsets());
+    EXPECT_EQ(manager.getLineText(SourceLocation(2, 1, 0, second)), "int a;");
+    EXPECT_EQ(manager.totalSize(), canonical->fileSize);
+
+    if (haveLink) {
+        EXPECT_EQ(manager.getCanonicalFileId(manager.loadFile(link)), first);
+        EXPECT_EQ(manager.aliasCount(), 2u);
+        std::filesystem::remove(link);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(SourceManagerTest, IdenticalCopiesShareContentWhenEnabled) {
+    auto path = writeTempFile("sm_copy_a.h", "int shared;\n");
+    auto copy = writeTempFile("sm_copy_b.h", "int shared;\n");
+
+    SourceManager byIdentity;
+    byIdentity.loadFile(path);
+    uint32_t separate = byIdentity.loadFile(copy);
+    EXPECT_EQ(byIdentity.getCanonicalFileId(separate), separate);     // Otro inodo: otro archivo
+    EXPECT_EQ(byIdentity.aliasCount(), 0u);
+
+    SourceManager byContent;
+    byContent.setDeduplicateByContent(true);
+    uint32_t first = byContent.loadFile(path);
+    uint32_t second = byContent.loadFile(copy);
+    EXPECT_EQ(byContent.getCanonicalFileId(second), first);
+    EXPECT_EQ(byContent.aliasCount(), 1u);
+
+    // Invalidado el canónico, la siguiente carga vuelve a leer el archivo
+    EXPECT_TRUE(byContent.invalidateFile(path));
+    uint32_t reloaded = byContent.loadFile(path);
+    EXPECT_EQ(byContent.getCanonicalFileId(reloaded), reloaded);
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(copy);
+}
+
+TEST(SourceManagerTest, PrefetchedFilesAreTakenByLoadFile) {
+    auto small = writeTempFile("sm_prefetch_small.h", "int small;\r\n");
+    auto large = writeTempFile("sm_prefetch_large.h", makeLargeSource("\n"));
+    auto missing = std::filesystem::temp_directory_path() / "sm_prefetch_missing.h";
+
+    SourceManager manager;
+    manager.preloadHeaders({small, large, missing});
+    manager.prefetchFiles({small});     // Ya pedido: no se lee dos veces
+
+    uint32_t largeId = manager.loadFile(large);     // Puede esperar a la lectura en curso
+    manager.waitForPrefetch();
+    uint32_t smallId = manager.loadFile(small);
+    EXPECT_EQ(manager.loadFile(missing), 0u);
+    EXPECT_EQ(manager.prefetchHitCount(), 2u);
+
+    const SourceFile* smallFile = manager.getFile(smallId);
+    ASSERT_NE(smallFile, nullptr);
+    EXPECT_EQ(smallFile->text(), "int small;\n");
+    EXPECT_TRUE(smallFile->isHeaderUnit);
+    const SourceFile* largeFile = manager.getFile(largeId);
+    ASSERT_NE(largeFile, nullptr);
+    EXPECT_TRUE(largeFile->isMapped());
+    EXPECT_EQ(largeFile->text(), makeLargeSource("\n"));
+
+    // Lo ya cargado no se vuelve a pedir
+    manager.prefetchFiles({small});
+    manager.waitForPrefetch();
+    EXPECT_EQ(manager.loadFile(small), smallId);
+    EXPECT_EQ(manager.prefetchHitCount(), 2u);
+
+    std::filesystem::remove(small);
+    std::filesystem::remove(large);
+}
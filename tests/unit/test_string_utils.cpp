@@ -0,0 +1,100 @@
+/**
+ * @file test_string_utils.cpp
+ * @brief Tests para StringUtils, readFileBuffer y statFile
+ */
+
+#include <compiler/common/utils/FileUtils.h>
+#include <compiler/common/utils/StringUtils.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace cpp20::compiler::common::utils;
+
+TEST(StringUtilsTest, ViewsPointIntoTheInput) {
+    std::string text = "  \tvalor  \n";
+    std::string_view trimmed = trimView(text);
+    EXPECT_EQ(trimmed, "valor");
+    EXPECT_EQ(trimmed.data(), text.data() + 3);
+    EXPECT_EQ(trimLeftView(text), "valor  \n");
+    EXPECT_EQ(trimRightView(text), "  \tvalor");
+    EXPECT_TRUE(trimView(" \t ").empty());
+    EXPECT_EQ(trim(text), "valor");
+}
+
+TEST(StringUtilsTest, SplitViewKeepsEveryField) {
+    std::vector<std::string_view> fields;
+    for (std::string_view field : splitView("a,,b,", ',')) {
+        fields.push_back(field);
+    }
+    EXPECT_EQ(fields, (std::vector<std::string_view>{"a", "", "b", ""}));
+
+    std::vector<std::string_view> single(splitView("", ',').begin(), splitView("", ',').end());
+    EXPECT_EQ(single, (std::vector<std::string_view>{""}));
+
+    // split mantiene la semántica de std::getline
+    EXPECT_EQ(split("a,,b,", ','), (std::vector<std::string>{"a", "", "b"}));
+    EXPECT_TRUE(split("", ',').empty());
+    EXPECT_EQ(split(",", ','), (std::vector<std::string>{""}));
+}
+
+TEST(StringUtilsTest, CaseFoldingAndReplacement) {
+    std::string flag = "/W4-Werror";
+    toLowerInPlace(flag);
+    EXPECT_EQ(flag, "/w4-werror");
+    EXPECT_EQ(toUpper("abc"), "ABC");
+
+    EXPECT_EQ(replace("a.b.c", ".", "::"), "a::b::c");
+    EXPECT_EQ(replace("aaa", "a", "aa"), "aaaaaa");
+    EXPECT_EQ(replace("abc", "", "x"), "abc");
+    EXPECT_EQ(join({"a", "b", "c"}, ", "), "a, b, c");
+    EXPECT_TRUE(startsWith("-Wno-unused", "-Wno-"));
+    EXPECT_TRUE(endsWith("main.cpp", ".cpp"));
+}
+
+TEST(FileUtilsTest, ReadFileBufferMapsTheFile) {
+    auto path = std::filesystem::temp_directory_path() / "test_string_utils_buffer.txt";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "contenido\n";
+    }
+    FileBuffer buffer = readFileBuffer(path.string());
+    EXPECT_EQ(buffer.view(), "contenido\n");
+    EXPECT_EQ(buffer.view(), readFile(path.string()));
+
+    FileBuffer moved = std::move(buffer);
+    EXPECT_EQ(moved.size(), 10u);
+    std::filesystem::remove(path);
+
+    EXPECT_THROW(readFileBuffer((std::filesystem::temp_directory_path() / "no_existe.txt").string()),
+                 std::runtime_error);
+}
+
+TEST(FileUtilsTest, StatFileTracksSizeTimeAndIdentity) {
+    auto path = std::filesystem::temp_directory_path() / "test_string_utils_stamp.txt";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "uno";
+    }
+    FileStamp first;
+    ASSERT_TRUE(statFile(path.string(), first));
+    EXPECT_EQ(first.size, 3u);
+    EXPECT_FALSE(first.empty());
+
+    FileStamp again;
+    ASSERT_TRUE(statFile(path.string(), again));
+    EXPECT_EQ(again, first);
+
+    std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + std::chrono::seconds(5));
+    FileStamp touched;
+    ASSERT_TRUE(statFile(path.string(), touched));
+    EXPECT_EQ(touched.size, first.size);
+    EXPECT_NE(touched, first);
+    std::filesystem::remove(path);
+
+    FileStamp missing;
+    EXPECT_FALSE(statFile(path.string(), missing));
+}
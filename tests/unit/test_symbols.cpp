@@ -0,0 +1,57 @@
+/**
+ * @file test_symbols.cpp
+ * @brief Tests para la arena de símbolos
+ */
+
+#include <compiler/symbols/Symbol.h>
+#include <compiler/frontend/lexer/IdentifierTable.h>
+#include <compiler/types/Type.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace cpp20::compiler;
+using frontend::lexer::IdentifierTable;
+
+TEST(SymbolArenaTest, KindPayloadsLiveInTheArena) {
+    IdentifierTable identifiers;
+    types::BasicType intType(types::BasicType::BasicKind::Int);
+    std::vector<const types::Type*> parameters = {&intType, &intType};
+
+    symbols::SymbolArena arena;
+    const symbols::VariableSymbol* limit = arena.createVariable(identifiers.get("limit"), &intType, true, true);
+    const symbols::FunctionSymbol* add = arena.createFunction(identifiers.get("add"), &intType, parameters);
+    parameters.clear();
+
+    EXPECT_EQ(limit->id(), 1u);
+    EXPECT_EQ(add->id(), 2u);
+    EXPECT_EQ(arena.symbol(2), add);
+    EXPECT_EQ(add->name(), "add");
+    EXPECT_EQ(add->identifier(), identifiers.find("add"));
+    ASSERT_EQ(add->paramTypes().size(), 2u);
+    EXPECT_EQ(add->paramTypes()[1], &intType);
+
+    // Sin RTTI: la clase decide qué vista es válida
+    const symbols::Symbol* symbol = add;
+    EXPECT_EQ(symbol->asFunction(), add);
+    EXPECT_EQ(symbol->asVariable(), nullptr);
+    EXPECT_TRUE(limit->isConst());
+    EXPECT_TRUE(limit->isStatic());
+    EXPECT_EQ(limit->toString(), "static const variable limit");
+
+    arena.clear();
+    EXPECT_EQ(arena.size(), 0u);
+}
+
+TEST(SymbolArenaTest, SymbolsStayCompact) {
+    // Sin vtable ni std::string: cabe en medio bloque de caché
+    EXPECT_LE(sizeof(symbols::Symbol), 40u);
+    EXPECT_EQ(sizeof(symbols::FunctionSymbol), sizeof(symbols::Symbol));
+
+    IdentifierTable identifiers;
+    symbols::SymbolArena arena;
+    for (int i = 0; i < 100000; ++i) {
+        arena.create(symbols::SymbolKind::Type, identifiers.get("T" + std::to_string(i)), nullptr);
+    }
+    EXPECT_EQ(arena.size(), 100000u);
+    EXPECT_EQ(arena.symbol(100000)->name(), "T99999");
+}
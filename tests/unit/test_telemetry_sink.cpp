@@ -0,0 +1,142 @@
+/**
+ * @file test_telemetry_sink.cpp
+ * @brief Tests para el archivo de telemetría del build y su agregación
+ */
+
+#include <compiler/common/TelemetrySink.h>
+#include <compiler/common/TimingProfiler.h>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cpp20::compiler;
+
+namespace {
+
+class TelemetrySinkTest : public ::testing::Test {
+protected:
+    std::filesystem::path root_ = std::filesystem::temp_directory_path() / "telemetry_sink_test";
+    std::filesystem::path file_ = root_ / "build.telemetry";
+
+    void SetUp() override {
+        std::filesystem::remove_all(root_);
+        std::filesystem::create_directories(root_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(root_);
+    }
+
+    static TelemetryRecord record(const std::string& unit, const std::string& version, double parsing) {
+        TelemetryRecord result;
+        result.unit = unit;
+        result.compilerVersion = version;
+        result.metrics["phase.Parsing.us"] = parsing;
+        result.metrics["cache.template.hit_rate"] = 80;
+        return result;
+    }
+};
+
+} // namespace
+
+TEST_F(TelemetrySinkTest, RecordsRoundTripThroughTheFile) {
+    TelemetryRecord original = record("dir/a \"b\".cpp", "1.0", 1234.5);
+    original.metrics["link.total_symbols"] = 42;
+    ASSERT_TRUE(TelemetrySink(file_).append(original));
+    ASSERT_TRUE(TelemetrySink(file_).append(record("b.cpp", "1.0", 10)));
+
+    // Una línea cortada por un proceso que murió se salta
+    {
+        std::ofstream out(file_, std::ios::app);
+        out << "{\"unit\":\"c.cpp\",\"metr\n";
+    }
+
+    size_t malformed = 0;
+    auto records = TelemetrySink::read(file_, &malformed);
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(malformed, 1u);
+    EXPECT_EQ(records[0].unit, original.unit);
+    EXPECT_EQ(records[0].compilerVersion, "1.0");
+    EXPECT_EQ(records[0].metrics, original.metrics);
+}
+
+TEST_F(TelemetrySinkTest, ConcurrentWritersKeepLinesIntact) {
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([this, t]() {
+            TelemetrySink sink(file_);
+            for (int i = 0; i < 50; ++i) {
+                sink.append(record("unit" + std::to_string(t) + "_" + std::to_string(i), "1.0", i));
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    size_t malformed = 0;
+    EXPECT_EQ(TelemetrySink::read(file_, &malformed).size(), 200u);
+    EXPECT_EQ(malformed, 0u);
+}
+
+TEST_F(TelemetrySinkTest, AggregatorComputesPercentilesPerVersion) {
+    TelemetryAggregator aggregator;
+    aggregator.filterVersion("2.0");
+    for (int i = 1; i <= 100; ++i) {
+        aggregator.add(record("u" + std::to_string(i), "2.0", i));
+    }
+    aggregator.add(record("old", "1.0", 100000));
+
+    EXPECT_EQ(aggregator.recordCount(), 100u);
+    auto distributions = aggregator.distributions();
+    ASSERT_EQ(distributions.size(), 2u);
+    const MetricDistribution& parsing = distributions[1];
+    EXPECT_EQ(parsing.name, "phase.Parsing.us");
+    EXPECT_EQ(parsing.count, 100u);
+    EXPECT_EQ(parsing.min, 1);
+    EXPECT_EQ(parsing.max, 100);
+    EXPECT_EQ(parsing.p50, 50);
+    EXPECT_EQ(parsing.p90, 90);
+    EXPECT_EQ(parsing.p99, 99);
+    EXPECT_NE(aggregator.generateReport().find("phase.Parsing.us"), std::string::npos);
+}
+
+TEST_F(TelemetrySinkTest, RegressionsCompareMediansAndTails) {
+    TelemetryAggregator baseline;
+    TelemetryAggregator current;
+    for (int i = 1; i <= 20; ++i) {
+        baseline.add(record("u", "1.0", 100));
+        TelemetryRecord slower = record("u", "2.0", i <= 17 ? 100 : 200);   // Solo empeora la cola
+        slower.metrics["cache.template.hit_rate"] = 50;
+        current.add(slower);
+    }
+
+    auto regressions = TelemetryAggregator::findRegressions(baseline.distributions(),
+                                                            current.distributions(), 0.05, 10);
+    ASSERT_EQ(regressions.size(), 2u);
+    EXPECT_EQ(regressions[0].name, "phase.Parsing.us");
+    EXPECT_DOUBLE_EQ(regressions[0].change, 1.0);
+    EXPECT_EQ(regressions[1].name, "cache.template.hit_rate");
+
+    // Por debajo del mínimo de muestras no se compara
+    EXPECT_TRUE(TelemetryAggregator::findRegressions(baseline.distributions(),
+                                                     current.distributions(), 0.05, 50).empty());
+}
+
+TEST_F(TelemetrySinkTest, TelemetryExportsPhaseTimesAndSummedMetrics) {
+    TimingProfiler profiler;
+    profiler.recordPhaseTiming(CompilationPhase::TemplateInstantiation, std::chrono::microseconds(300));
+    profiler.recordPhaseTiming(CompilationPhase::TemplateInstantiation, std::chrono::microseconds(200));
+
+    CompilationTelemetry telemetry(profiler);
+    telemetry.recordPhaseTimes();
+    telemetry.recordMetric("bmi.load.us", 10);
+    telemetry.recordMetric("bmi.load.us", 5);
+
+    TelemetryRecord result = telemetry.toRecord("a.cpp", "1.0");
+    EXPECT_EQ(result.metrics.at("phase.TemplateInstantiation.us"), 500);
+    EXPECT_EQ(result.metrics.at("bmi.load.us"), 15);
+}
@@ -0,0 +1,308 @@
+/**
+ * @file test_template_instantiation.cpp
+ * @brief Tests para la lista de instanciación diferida de templates
+ */
+
+#include <compiler/templates/TemplateSystem.h>
+#include <compiler/ast/ASTContext.h>
+#include <compiler/ast/ExpressionAST.h>
+#include <compiler/ast/StatementAST.h>
+#include <compiler/ast/DeclarationAST.h>
+#include <compiler/symbols/Symbol.h>
+#include <compiler/frontend/lexer/IdentifierTable.h>
+#include <compiler/types/TypeContext.h>
+#include <compiler/common/diagnostics/SourceManager.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace cpp20::compiler;
+using namespace cpp20::compiler::semantic;
+
+namespace {
+
+class TemplateInstantiationTest : public ::testing::Test {
+protected:
+    std::shared_ptr<diagnostics::SourceManager> sourceManager_ =
+        std::make_shared<diagnostics::SourceManager>();
+    diagnostics::DiagnosticEngine diagEngine_{sourceManager_};
+    ast::ASTContext context_;
+    diagnostics::SourceLocation loc_;
+    ConstraintSolver solver_{diagEngine_};
+    TemplateInstantiationEngine engine_{diagEngine_, solver_};
+
+    // template<typename T> ...
+    void registerUnary(const std::string& name) {
+        std::vector<ast::TemplateParameter*> parameters = {
+            context_.create<ast::TemplateParameter>(ast::TemplateParameterType::Type,
+                                                    context_.copyString("T"), nullptr, loc_),
+        };
+        auto* list = context_.create<ast::TemplateParameterList>(context_.makeList(parameters), loc_);
+        engine_.registerTemplate(std::make_unique<TemplateInfo>(name, list, nullptr));
+    }
+};
+
+} // namespace
+
+TEST_F(TemplateInstantiationTest, OnlyDependentNamesAreLookedUpPerSpecialization) {
+    // template<typename T> T scaled(T x) { return helper(scale(x)) + log(1) + limit; }
+    auto name = [&](const char* text) { return context_.create<ast::Identifier>(context_.copyString(text), loc_); };
+    auto call = [&](const char* callee, ast::ASTNode* argument) {
+        return context_.create<ast::FunctionCall>(name(callee), context_.makeList<ast::ASTNode>({argument}), loc_);
+    };
+    auto add = [&](ast::ASTNode* left, ast::ASTNode* right) {
+        return context_.create<ast::BinaryOp>(left, right, ast::BinaryOp::OpKind::Add, loc_);
+    };
+    ast::ASTNode* value = add(add(call("helper", call("scale", name("x"))),
+                                  call("log", context_.create<ast::IntegerLiteral>(1, loc_))),
+                              name("limit"));
+    std::vector<ast::ASTNode*> statements = {context_.create<ast::ReturnStmt>(value, loc_)};
+    std::vector<ast::ParameterDecl*> functionParameters = {
+        context_.create<ast::ParameterDecl>(context_.copyString("x"), context_.copyString("T"), loc_),
+    };
+    auto* function = context_.create<ast::FunctionDecl>(
+        context_.copyString("scaled"), context_.copyString("T"), context_.makeList(functionParameters),
+        context_.create<ast::CompoundStmt>(context_.makeList(statements), loc_), loc_);
+    std::vector<ast::TemplateParameter*> parameters = {
+        context_.create<ast::TemplateParameter>(ast::TemplateParameterType::Type,
+                                                context_.copyString("T"), nullptr, loc_),
+    };
+    auto* list = context_.create<ast::TemplateParameterList>(context_.makeList(parameters), loc_);
+
+    symbols::Symbol limit(symbols::SymbolKind::Variable, frontend::lexer::IdentifierTable::global().get("limit"),
+                          nullptr);
+    std::vector<std::string> lookups;
+    engine_.setNameLookup([&](const std::string& lookedUp, const std::vector<std::string>& arguments) {
+        lookups.push_back(lookedUp + (arguments.empty() ? "" : "<" + arguments[0] + ">"));
+        return lookedUp == "limit" ? &limit : nullptr;
+    });
+    engine_.registerTemplate(std::make_unique<TemplateInfo>("scaled", list, function));
+
+    const TemplateInfo* info = engine_.getTemplateInfo("scaled");
+    ASSERT_NE(info, nullptr);
+    EXPECT_EQ(info->dependentNames, (std::vector<std::string>{"scale", "helper"}));
+    EXPECT_EQ(info->boundNames.size(), 2u);
+    EXPECT_EQ(info->boundNames.at("limit"), &limit);
+    EXPECT_EQ(lookups, (std::vector<std::string>{"log", "limit"}));
+
+    lookups.clear();
+    auto first = engine_.instantiateTemplate("scaled", {"int"});
+    auto again = engine_.instantiateTemplate("scaled", {"int"});
+    auto other = engine_.instantiateTemplate("scaled", {"double"});
+    EXPECT_EQ(lookups, (std::vector<std::string>{"scale<int>", "helper<int>", "scale<double>", "helper<double>"}));
+    EXPECT_TRUE(first->isValid && other->isValid);
+    EXPECT_EQ(again->dependentBindings.size(), 2u);
+    EXPECT_EQ(engine_.getStats().namesBoundAtDefinition, 2u);
+    EXPECT_EQ(engine_.getStats().dependentLookups, 4u);
+}
+
+TEST_F(TemplateInstantiationTest, FailedSubstitutionsRollBackArenaAndDiagnostics) {
+    SFINAEHandler handler(diagEngine_);
+    common::utils::MemoryPool& arena = context_.pool();
+    size_t usedBefore = arena.totalUsed();
+
+    // enable_if<is_integral<T>> con T = float: la sustitución falla
+    bool accepted = handler.trySubstitution("f", {"float"}, arena, [&] {
+        context_.create<ast::Identifier>(context_.copyString("enable_if_t"), loc_);
+        diagEngine_.report(diagnostics::DiagnosticLevel::Error, diagnostics::DiagnosticCode::ERR_TPL_INVALID_ARGUMENTS,
+                           loc_, "no hay tipo 'type' en %0", diagnostics::TypeRef{3});
+        return true;
+    });
+    EXPECT_FALSE(accepted);
+    EXPECT_EQ(arena.totalUsed(), usedBefore);
+    EXPECT_EQ(diagEngine_.errorCount(), 0u);
+    EXPECT_TRUE(handler.isSFINAEFailure("f", {"float"}));
+
+    EXPECT_TRUE(handler.trySubstitution("f", {"int"}, arena, [&] {
+        context_.create<ast::Identifier>(context_.copyString("int"), loc_);
+        return true;
+    }));
+    EXPECT_GT(arena.totalUsed(), usedBefore);
+    EXPECT_FALSE(handler.isSFINAEFailure("f", {"int"}));
+    EXPECT_EQ(handler.getStats().trials, 2u);
+    EXPECT_EQ(handler.getStats().failedTrials, 1u);
+}
+
+TEST_F(TemplateInstantiationTest, RequestsAreDeduplicatedThroughTheCache) {
+    registerUnary("vector");
+
+    EXPECT_TRUE(engine_.requestInstantiation("vector", {"int"}, loc_));
+    EXPECT_FALSE(engine_.requestInstantiation("vector", {"int"}, loc_));
+    EXPECT_TRUE(engine_.requestInstantiation("vector", {"float"}, loc_));
+    EXPECT_EQ(engine_.pendingInstantiations(), 2u);
+    EXPECT_EQ(engine_.findInstance("vector", {"int"}), nullptr);
+
+    EXPECT_EQ(engine_.performPendingInstantiations(2), 2u);
+    EXPECT_EQ(engine_.pendingInstantiations(), 0u);
+    ASSERT_NE(engine_.findInstance("vector", {"int"}), nullptr);
+    EXPECT_TRUE(engine_.findInstance("vector", {"int"})->isValid);
+
+    // Ya instanciada: ni se encola ni se vuelve a instanciar
+    EXPECT_FALSE(engine_.requestInstantiation("vector", {"int"}, loc_));
+    EXPECT_EQ(engine_.getStats().deferredDuplicates, 2u);
+    EXPECT_EQ(engine_.getStats().instancesCreated, 2u);
+}
+
+TEST_F(TemplateInstantiationTest, ParallelWorklistMatchesImmediateInstantiation) {
+    registerUnary("box");
+
+    std::vector<std::string> types;
+    for (int i = 0; i < 200; ++i) {
+        types.push_back("T" + std::to_string(i));
+        engine_.requestInstantiation("box", {types.back()}, loc_);
+    }
+
+    EXPECT_EQ(engine_.performPendingInstantiations(4), types.size());
+    for (const std::string& type : types) {
+        const TemplateInstance* instance = engine_.findInstance("box", {type});
+        ASSERT_NE(instance, nullptr);
+        EXPECT_EQ(instance->arguments, std::vector<std::string>{type});
+    }
+
+    // La instanciación inmediata ve lo que instanció la lista de trabajo
+    size_t hits = engine_.getStats().cacheHits;
+    EXPECT_TRUE(engine_.instantiateTemplate("box", {"T7"})->isValid);
+    EXPECT_EQ(engine_.getStats().cacheHits, hits + 1);
+}
+
+TEST_F(TemplateInstantiationTest, FailuresAreReportedAtThePointOfInstantiation) {
+    registerUnary("pair");
+
+    engine_.requestInstantiation("pair", {"int", "int"}, loc_);
+    engine_.requestInstantiation("missing", {"int"}, loc_);
+    EXPECT_EQ(engine_.performPendingInstantiations(2), 0u);
+
+    EXPECT_EQ(diagEngine_.errorCount(), 2u);
+    EXPECT_EQ(engine_.getStats().errors, 2u);
+    EXPECT_EQ(engine_.findInstance("pair", {"int", "int"}), nullptr);
+}
+
+TEST_F(TemplateInstantiationTest, TemplateStatsReportTheSharedCacheHitRate) {
+    TemplateSystem system(diagEngine_);
+    std::vector<ast::TemplateParameter*> parameters = {
+        context_.create<ast::TemplateParameter>(ast::TemplateParameterType::Type,
+                                                context_.copyString("T"), nullptr, loc_),
+    };
+    auto* list = context_.create<ast::TemplateParameterList>(context_.makeList(parameters), loc_);
+    system.registerTemplate(std::make_unique<TemplateInfo>("optional", list, nullptr));
+
+    system.requestInstantiation("optional", {"int"}, loc_);
+    system.performPendingInstantiations(2);
+    EXPECT_TRUE(system.instantiateTemplate("optional", {"int"})->isValid);
+    EXPECT_TRUE(system.instantiateTemplate("optional", {"int"})->isValid);
+
+    TemplateSystem::TemplateStats stats = system.getStats();
+    EXPECT_EQ(stats.instancesCreated, 1u);
+    EXPECT_EQ(stats.cacheHits, 2u);
+    EXPECT_EQ(stats.cacheMisses, 1u);
+    EXPECT_DOUBLE_EQ(stats.hitRate(), 2.0 / 3.0);
+}
+
+TEST_F(TemplateInstantiationTest, ConceptSatisfactionIsMemoizedByCanonicalType) {
+    types::TypeContext types;
+    const types::Type* intType = types.getBasicType(types::BasicType::BasicKind::Int);
+    const types::Type* floatType = types.getBasicType(types::BasicType::BasicKind::Float);
+
+    EXPECT_EQ(solver_.checkConceptSatisfaction("std::integral", intType, {}).satisfaction,
+              ConstraintSatisfaction::Satisfied);
+    EXPECT_EQ(solver_.checkConceptSatisfaction("std::integral", intType, {}).satisfaction,
+              ConstraintSatisfaction::Satisfied);
+    EXPECT_EQ(solver_.checkConceptSatisfaction("std::integral", floatType, {}).satisfaction,
+              ConstraintSatisfaction::NotSatisfied);
+    EXPECT_EQ(solver_.checkConceptSatisfaction("std::integral", std::string("int"), {}).satisfaction,
+              ConstraintSatisfaction::Satisfied);
+
+    ConstraintSolver::CacheStats stats = solver_.getCacheStats();
+    EXPECT_EQ(stats.satisfactionHits, 1u);
+    EXPECT_EQ(stats.satisfactionMisses, 3u);
+}
+
+TEST_F(TemplateInstantiationTest, SubsumptionUsesTheNormalForm) {
+    using ConstraintType = ast::ConstraintExpression::ConstraintType;
+    auto atomic = [this](const char* name) {
+        auto* concept_ = context_.create<ast::Identifier>(context_.copyString(name), loc_);
+        return context_.create<ast::ConstraintExpression>(ConstraintType::Atomic, concept_, nullptr, loc_);
+    };
+
+    auto* input = atomic("input_range");
+    auto* sized = atomic("sized_range");
+    auto* both = context_.create<ast::ConstraintExpression>(ConstraintType::Conjunction, input, sized, loc_);
+    auto* either = context_.create<ast::ConstraintExpression>(ConstraintType::Disjunction, input, sized, loc_);
+    auto* inputAgain = atomic("input_range");
+
+    // A && B subsume A, A subsume A || B; no al revés
+    EXPECT_TRUE(solver_.checkSubsumption(both, inputAgain));
+    EXPECT_FALSE(solver_.checkSubsumption(inputAgain, both));
+    EXPECT_TRUE(solver_.checkSubsumption(input, either));
+    EXPECT_FALSE(solver_.checkSubsumption(either, input));
+    EXPECT_TRUE(solver_.checkSubsumption(both, either));
+
+    EXPECT_TRUE(solver_.checkSubsumption(both, inputAgain));
+    ConstraintSolver::CacheStats stats = solver_.getCacheStats();
+    EXPECT_EQ(stats.subsumptionHits, 1u);
+    EXPECT_EQ(stats.subsumptionMisses, 5u);
+
+    EXPECT_EQ(solver_.evaluateConstraint(both, {{"T", "int"}}).satisfaction, ConstraintSatisfaction::Satisfied);
+    EXPECT_EQ(solver_.evaluateConstraint(both, {{"T", "int"}}).satisfaction, ConstraintSatisfaction::Satisfied);
+    EXPECT_EQ(solver_.getCacheStats().evaluationHits, 1u);
+}
+
+TEST_F(TemplateInstantiationTest, DeductionResultsAreCachedPerArgumentTypes) {
+    // template<typename T, typename U> void put(const T& value, std::vector<U>* out);
+    std::vector<ast::ParameterDecl*> functionParameters = {
+        context_.create<ast::ParameterDecl>(context_.copyString("value"), context_.copyString("const T&"), loc_),
+        context_.create<ast::ParameterDecl>(context_.copyString("out"), context_.copyString("std::vector<U>*"), loc_),
+    };
+    auto* function = context_.create<ast::FunctionDecl>(
+        context_.copyString("put"), context_.copyString("void"), context_.makeList(functionParameters),
+        nullptr, loc_);
+    std::vector<ast::TemplateParameter*> parameters = {
+        context_.create<ast::TemplateParameter>(ast::TemplateParameterType::Type,
+                                                context_.copyString("T"), nullptr, loc_),
+        context_.create<ast::TemplateParameter>(ast::TemplateParameterType::Type,
+                                                context_.copyString("U"), nullptr, loc_),
+    };
+    auto* list = context_.create<ast::TemplateParameterList>(context_.makeList(parameters), loc_);
+    engine_.registerTemplate(std::make_unique<TemplateInfo>("put", list, function));
+    registerUnary("identity");
+
+    DeductionResult first = engine_.deduceTemplateArguments("put", {}, {"const unsigned int&", "std::vector<std::pair<int, long>>*"});
+    ASSERT_TRUE(first.success) << first.errorMessage;
+    EXPECT_EQ(first.arguments, (std::vector<std::string>{"unsigned int", "std::pair<int,long>"}));
+
+    // Otra grafía del mismo tipo reutiliza la deducción
+    DeductionResult again = engine_.deduceTemplateArguments("put", {}, {"const unsigned int &", "std::vector<std::pair<int,long>> *"});
+    EXPECT_EQ(again.arguments, first.arguments);
+    EXPECT_EQ(engine_.getStats().deductionsRun, 1u);
+    EXPECT_EQ(engine_.getStats().deductionCacheHits, 1u);
+
+    // Los fallos también se memorizan
+    EXPECT_FALSE(engine_.deduceTemplateArguments("put", {"int"}, {"long", "std::vector<int>*"}).success);
+    EXPECT_FALSE(engine_.deduceTemplateArguments("put", {}, {"int", "std::list<int>*"}).success);
+    EXPECT_FALSE(engine_.deduceTemplateArguments("put", {}, {"int", "std::list<int>*"}).success);
+    EXPECT_EQ(engine_.getStats().deductionsRun, 3u);
+    EXPECT_EQ(engine_.getStats().deductionCacheHits, 2u);
+    EXPECT_EQ(engine_.getStats().deductionFastPaths, 0u);
+
+    // Sin definición de función no hay nada que deducir
+    EXPECT_FALSE(engine_.deduceTemplateArguments("identity", {}, {"int"}).success);
+
+    engine_.clearCache();
+    engine_.deduceTemplateArguments("put", {}, {"const unsigned int&", "std::vector<std::pair<int, long>>*"});
+    EXPECT_EQ(engine_.getStats().deductionsRun, 5u);
+
+    // template<typename T> T pick(T a, T&& b): se deduce sin emparejar patrones
+    std::vector<ast::ParameterDecl*> pickParameters = {
+        context_.create<ast::ParameterDecl>(context_.copyString("a"), context_.copyString("T"), loc_),
+        context_.create<ast::ParameterDecl>(context_.copyString("b"), context_.copyString("T&&"), loc_),
+    };
+    auto* pick = context_.create<ast::FunctionDecl>(context_.copyString("pick"), context_.copyString("T"),
+                                                    context_.makeList(pickParameters), nullptr, loc_);
+    auto* single = context_.create<ast::TemplateParameterList>(context_.makeList(std::vector{parameters[0]}), loc_);
+    engine_.registerTemplate(std::make_unique<TemplateInfo>("pick", single, pick));
+    EXPECT_EQ(engine_.deduceTemplateArguments("pick", {}, {"const double", "double&"}).arguments,
+              (std::vector<std::string>{"double"}));
+    EXPECT_FALSE(engine_.deduceTemplateArguments("pick", {}, {"int", "double"}).success);
+    EXPECT_EQ(engine_.getStats().deductionFastPaths, 1u);
+}
@@ -0,0 +1,102 @@
+/**
+ * @file test_thread_pool.cpp
+ * @brief Tests para el pool de hilos, parallelFor y BoundedQueue
+ */
+
+#include <compiler/common/utils/ThreadPool.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace cpp20::compiler::common::utils;
+
+TEST(ThreadPoolTest, SubmitReturnsResults) {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.threadCount(), 4u);
+
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 32; ++i) {
+        futures.push_back(pool.submit([i]() { return i * i; }));
+    }
+
+    for (int i = 0; i < 32; ++i) {
+        EXPECT_EQ(futures[i].get(), i * i);
+    }
+}
+
+TEST(ThreadPoolTest, WaitBlocksUntilIdle) {
+    ThreadPool pool(3);
+    std::atomic<int> counter{0};
+
+    for (int i = 0; i < 100; ++i) {
+        pool.submit([&counter]() { counter.fetch_add(1); });
+    }
+    pool.wait();
+
+    EXPECT_EQ(counter.load(), 100);
+}
+
+TEST(ThreadPoolTest, ExceptionsPropagateThroughFuture) {
+    ThreadPool pool(2);
+    auto future = pool.submit([]() -> int { throw std::runtime_error("fallo"); });
+    EXPECT_THROW(future.get(), std::runtime_error);
+}
+
+TEST(ParallelForTest, VisitsEveryIndexOnce) {
+    std::vector<std::atomic<int>> visits(257);
+    parallelFor(visits.size(), 8, [&](size_t i) { visits[i].fetch_add(1); });
+
+    for (const auto& v : visits) {
+        EXPECT_EQ(v.load(), 1);
+    }
+}
+
+TEST(ParallelForTest, SerialWhenSingleJob) {
+    std::vector<size_t> order;
+    parallelFor(5, 1, [&](size_t i) { order.push_back(i); });
+    EXPECT_EQ(order, (std::vector<size_t>{0, 1, 2, 3, 4}));
+}
+
+TEST(ParallelForTest, RethrowsFirstException) {
+    EXPECT_THROW(parallelFor(16, 4, [](size_t i) {
+        if (i == 7) throw std::logic_error("índice 7");
+    }), std::logic_error);
+}
+
+TEST(BoundedQueueTest, ProducerNeverRunsAheadOfCapacity) {
+    BoundedQueue<int> queue(2);
+    std::atomic<int> pushed{0};
+    std::thread producer([&]() {
+        for (int i = 0; i < 50; ++i) {
+            queue.push(i);
+            pushed.fetch_add(1);
+        }
+        queue.close();
+    });
+
+    std::vector<int> received;
+    while (auto value = queue.pop()) {
+        // Lo encolado y aún sin sacar nunca supera la capacidad (+1 en vuelo)
+        EXPECT_LE(pushed.load() - static_cast<int>(received.size()), 3);
+        received.push_back(*value);
+    }
+    producer.join();
+
+    ASSERT_EQ(received.size(), 50u);
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_EQ(received[i], i);
+    }
+}
+
+TEST(BoundedQueueTest, CloseReleasesBlockedProducer) {
+    BoundedQueue<int> queue(1);
+    EXPECT_TRUE(queue.push(1));
+    std::thread producer([&]() { EXPECT_FALSE(queue.push(2)); });
+    queue.close();
+    producer.join();
+
+    EXPECT_EQ(queue.pop(), std::optional<int>(1));     // Lo encolado antes de cerrar se entrega
+    EXPECT_EQ(queue.pop(), std::nullopt);
+}
@@ -0,0 +1,196 @@
+/**
+ * @file test_timing_profiler.cpp
+ * @brief Tests para los ámbitos anidados y la traza por hilo de TimingProfiler
+ */
+
+#include <compiler/common/TimingProfiler.h>
+#include <compiler/common/utils/MemoryPool.h>
+#include <compiler/common/utils/MemoryTracker.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cpp20::compiler;
+
+TEST(TimingProfilerTest, NestedScopesStayInsideTheirParent) {
+    TimingProfiler profiler;
+    profiler.enableTrace();
+    {
+        AutoTimer unit(profiler, CompilationPhase::TranslationUnit, "a.cpp");
+        {
+            AutoTimer instantiation(profiler, CompilationPhase::TemplateInstantiation, "vector<int>");
+        }
+        AutoTimer parsing(profiler, CompilationPhase::Parsing);
+    }
+
+    ASSERT_EQ(profiler.getTraceThreadCount(), 1u);
+    auto events = profiler.getTraceEvents(0);
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_EQ(events[0].phase, CompilationPhase::TranslationUnit);
+    EXPECT_EQ(events[0].detail, "a.cpp");
+    EXPECT_EQ(events[1].phase, CompilationPhase::TemplateInstantiation);
+    EXPECT_EQ(events[1].detail, "vector<int>");
+    for (size_t i = 1; i < events.size(); ++i) {
+        EXPECT_GE(events[i].begin, events[0].begin);
+        EXPECT_LE(events[i].end, events[0].end);
+    }
+
+    // Las estadísticas agregadas siguen disponibles
+    const PhaseStats* stats = profiler.getPhaseStats(CompilationPhase::TemplateInstantiation);
+    ASSERT_NE(stats, nullptr);
+    EXPECT_EQ(stats->callCount, 1u);
+}
+
+TEST(TimingProfilerTest, EachThreadWritesItsOwnBuffer) {
+    TimingProfiler profiler;
+    profiler.enableTrace();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&profiler, t]() {
+            for (int i = 0; i < 100; ++i) {
+                AutoTimer timer(profiler, CompilationPhase::Parsing, "unit" + std::to_string(t));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(profiler.getTraceThreadCount(), 4u);
+    for (size_t t = 0; t < 4; ++t) {
+        auto events = profiler.getTraceEvents(t);
+        ASSERT_EQ(events.size(), 100u);
+        for (const auto& event : events) {
+            EXPECT_EQ(event.detail, events[0].detail);
+        }
+    }
+    EXPECT_EQ(profiler.getPhaseStats(CompilationPhase::Parsing)->callCount, 400u);
+}
+
+TEST(TimingProfilerTest, FullBufferKeepsNewestEvents) {
+    TimingProfiler profiler;
+    profiler.enableTrace(4);
+    for (int i = 0; i < 10; ++i) {
+        AutoTimer timer(profiler, CompilationPhase::Lexing, std::to_string(i));
+    }
+
+    auto events = profiler.getTraceEvents(0);
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_EQ(events.front().detail, "6");
+    EXPECT_EQ(events.back().detail, "9");
+    EXPECT_EQ(profiler.getDroppedTraceEvents(), 6u);
+}
+
+TEST(TimingProfilerTest, ChromeTraceHasCompleteEventsWithAttributes) {
+    TimingProfiler profiler;
+    profiler.enableTrace();
+    {
+        AutoTimer timer(profiler, CompilationPhase::TemplateInstantiation, "pair<\"a\", int>");
+    }
+
+    std::string trace = profiler.generateChromeTrace();
+    EXPECT_EQ(trace.rfind("{\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(trace.find("\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"Template Instantiation\""), std::string::npos);
+    EXPECT_NE(trace.find("\"args\":{\"detail\":\"pair<\\\"a\\\", int>\"}"), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"thread_name\""), std::string::npos);
+}
+
+TEST(TimingProfilerTest, ScopesWithoutTraceOnlyUpdateStats) {
+    TimingProfiler profiler;
+    {
+        AutoTimer timer(profiler, CompilationPhase::Parsing);
+    }
+    AutoTimer disabled(static_cast<TimingProfiler*>(nullptr), CompilationPhase::Parsing);
+
+    EXPECT_EQ(profiler.getTraceThreadCount(), 0u);
+    EXPECT_EQ(profiler.getPhaseStats(CompilationPhase::Parsing)->callCount, 1u);
+    EXPECT_NE(profiler.generateTimingReport(true).find("Parsing"), std::string::npos);
+    EXPECT_NE(profiler.generateJSONReport().find("\"call_count\": 1"), std::string::npos);
+}
+
+TEST(TimingProfilerTest, EntitiesSubtractNestedScopesFromSelfTime) {
+    TimingProfiler profiler;
+    profiler.setEntityTracking(true);
+    auto spin = [](std::chrono::microseconds duration) {
+        auto end = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < end) {
+        }
+    };
+
+    for (int i = 0; i < 2; ++i) {
+        AutoTimer outer(profiler, CompilationPhase::HeaderInclusion, "vector");
+        spin(std::chrono::microseconds(200));
+        {
+            AutoTimer inner(profiler, CompilationPhase::HeaderInclusion, "memory");
+            inner.recordMemoryUsage(100);
+            spin(std::chrono::microseconds(2000));
+        }
+    }
+
+    auto entities = profiler.getTopEntities(CompilationPhase::HeaderInclusion, 10);
+    ASSERT_EQ(entities.size(), 2u);
+    EXPECT_EQ(entities[0].name, "vector");
+    EXPECT_EQ(entities[0].count, 2u);
+    EXPECT_EQ(entities[1].name, "memory");
+    EXPECT_EQ(entities[1].memory, 200u);
+
+    // vector lleva dentro a memory, pero su tiempo propio es el menor
+    EXPECT_GE(entities[0].totalTime, entities[1].totalTime);
+    EXPECT_LT(entities[0].selfTime, entities[1].selfTime);
+    EXPECT_EQ(entities[1].selfTime, entities[1].totalTime);
+
+    EXPECT_EQ(profiler.getTopEntities(CompilationPhase::HeaderInclusion, 1).size(), 1u);
+    EXPECT_TRUE(profiler.getTopEntities(CompilationPhase::CodeGeneration, 10).empty());
+}
+
+TEST(TimingProfilerTest, EntitiesAreMergedAcrossThreads) {
+    TimingProfiler profiler;
+    profiler.setEntityTracking(true);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&profiler, t]() {
+            for (int i = 0; i < 50; ++i) {
+                profiler.recordEntity(CompilationPhase::ConstexprEvaluation, "fib", 1000000, 500000);
+                profiler.recordEntity(CompilationPhase::ConstexprEvaluation, "f" + std::to_string(t), 1000, 1000);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto entities = profiler.getTopEntities(CompilationPhase::ConstexprEvaluation, 10);
+    ASSERT_EQ(entities.size(), 5u);
+    EXPECT_EQ(entities[0].name, "fib");
+    EXPECT_EQ(entities[0].count, 200u);
+
+    std::string report = profiler.generateEntityReport(3);
+    EXPECT_NE(report.find("Constexpr Evaluation"), std::string::npos);
+    EXPECT_NE(report.find("fib"), std::string::npos);
+}
+
+TEST(TimingProfilerTest, TrackedMemoryFeedsPhasePeaks) {
+    using namespace cpp20::compiler::common::utils;
+    TimingProfiler profiler;
+    MemoryTracker::setEnabled(true);
+    {
+        AutoTimer timer(profiler, CompilationPhase::Parsing);
+        MemoryPool retained(32 * 1024);
+        {
+            MemoryPool transient(256 * 1024);
+        }
+    }
+    MemoryTracker::setEnabled(false);
+
+    const PhaseStats* stats = profiler.getPhaseStats(CompilationPhase::Parsing);
+    ASSERT_NE(stats, nullptr);
+    EXPECT_GE(stats->peakMemory, (32 + 256) * 1024u);
+    EXPECT_NE(profiler.generatePhaseMemoryReport().find("Parsing"), std::string::npos);
+    EXPECT_NE(profiler.generateJSONReport().find("\"peak_memory\""), std::string::npos);
+    EXPECT_NE(MemoryProfiler::generateSubsystemReport().find("Other"), std::string::npos);
+}
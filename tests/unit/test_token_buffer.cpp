@@ -0,0 +1,172 @@
+/**
+ * @file test_token_buffer.cpp
+ * @brief Tests para la representación compacta de tokens
+ */
+
+#include <compiler/frontend/lexer/Lexer.h>
+#include <compiler/frontend/lexer/TokenBuffer.h>
+#include <compiler/common/utils/ThreadPool.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+using namespace cpp20::compiler;
+using frontend::lexer::CompactToken;
+using frontend::lexer::Lexer;
+using frontend::lexer::LexerConfig;
+using frontend::lexer::TokenBuffer;
+using frontend::lexer::TokenType;
+
+namespace {
+
+class TokenBufferTest : public ::testing::Test {
+protected:
+    std::shared_ptr<diagnostics::SourceManager> sourceManager_ =
+        std::make_shared<diagnostics::SourceManager>();
+    diagnostics::DiagnosticEngine diagEngine_{sourceManager_};
+
+    void lex(const std::string& source, TokenBuffer& buffer, uint32_t fileId = 1) {
+        LexerConfig config;
+        config.fileId = fileId;
+        Lexer lexer(source, diagEngine_, config);
+        lexer.tokenize(buffer);
+    }
+};
+
+} // namespace
+
+TEST_F(TokenBufferTest, CompactTokenIsSixteenBytes) {
+    EXPECT_EQ(sizeof(CompactToken), 16u);
+    EXPECT_TRUE(std::is_trivially_copyable_v<CompactToken>);
+}
+
+TEST_F(TokenBufferTest, SpellingsPointIntoSource) {
+    std::string source = "int value = 42;";
+    TokenBuffer buffer;
+    lex(source, buffer);
+
+    ASSERT_EQ(buffer.size(), 6u); // 5 tokens + END_OF_FILE
+    EXPECT_EQ(buffer[0].type, TokenType::INT);
+    EXPECT_EQ(buffer[1].type, TokenType::IDENTIFIER);
+    EXPECT_EQ(buffer[5].type, TokenType::END_OF_FILE);
+
+    std::string_view name = buffer.spelling(buffer[1]);
+    EXPECT_EQ(name, "value");
+    EXPECT_EQ(name.data(), source.data() + 4); // Sin copia
+}
+
+TEST_F(TokenBufferTest, SplicedTokensUseSpellingTable) {
+    std::string source = "ab\\\ncd + x";
+    TokenBuffer buffer;
+    lex(source, buffer);
+
+    ASSERT_GE(buffer.size(), 2u);
+    EXPECT_TRUE(buffer[0].flags & frontend::lexer::TOKEN_FLAG_SPELLING_IN_TABLE);
+    EXPECT_EQ(buffer.spelling(buffer[0]), "abcd");
+    EXPECT_EQ(buffer.spelling(buffer[1]), "+");
+}
+
+TEST_F(TokenBufferTest, LocationsAreComputedOnDemand) {
+    std::string source = "a\n  bb\n\tc";
+    TokenBuffer buffer;
+    lex(source, buffer, 7);
+
+    auto first = buffer.location(buffer[0]);
+    auto second = buffer.location(buffer[1]);
+    auto third = buffer.location(buffer[2]);
+
+    EXPECT_EQ(first.line(), 1u);
+    EXPECT_EQ(second.line(), 2u);
+    EXPECT_EQ(second.column(), 3u);
+    EXPECT_EQ(third.line(), 3u);
+    EXPECT_EQ(third.column(), 2u);
+    EXPECT_EQ(third.fileId(), 7u);
+}
+
+TEST_F(TokenBufferTest, StartOfLineFlags) {
+    std::string source = "#define X \\\n  1\n/* c\n */ # y";
+    TokenBuffer buffer;
+    lex(source, buffer);
+
+    ASSERT_EQ(buffer.size(), 7u);
+    EXPECT_TRUE(buffer.view(0).isAtStartOfLine());  // #
+    EXPECT_FALSE(buffer.view(1).isAtStartOfLine()); // define
+    EXPECT_FALSE(buffer.view(3).isAtStartOfLine()); // 1 (tras continuación)
+    EXPECT_TRUE(buffer.view(4).isAtStartOfLine());  // # tras comentario multilínea
+    EXPECT_TRUE(buffer.view(5).flags() & frontend::lexer::TOKEN_FLAG_LEADING_SPACE);
+}
+
+TEST_F(TokenBufferTest, ViewMatchesMaterializedToken) {
+    std::string source = "s = \"a\\n\\\"b\";";
+    TokenBuffer buffer;
+    lex(source, buffer);
+
+    auto literal = buffer.view(2);
+    EXPECT_EQ(literal.getType(), TokenType::STRING_LITERAL);
+    EXPECT_EQ(literal.getLexeme(), "\"a\\n\\\"b\"");
+    EXPECT_EQ(literal.getValue(), "a\n\"b");
+
+    Lexer lexer(source, diagEngine_);
+    auto tokens = lexer.tokenize();
+    ASSERT_EQ(tokens.size(), buffer.size());
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        auto token = buffer.view(i).toToken();
+        EXPECT_EQ(token.getType(), tokens[i].getType());
+        EXPECT_EQ(token.getLexeme(), tokens[i].getLexeme());
+        EXPECT_EQ(token.getValue(), tokens[i].getValue());
+        EXPECT_EQ(token.getLocation().offset(), tokens[i].getLocation().offset());
+        EXPECT_EQ(token.flags(), tokens[i].flags());
+    }
+}
+
+TEST_F(TokenBufferTest, SplitPointsFollowCommentsAndLiterals) {
+    std::string source =
+        "int a; /* x\n y */ int b;\n"      // El primer \n está dentro del comentario
+        "s = \"p\nq\"; // r \\\n t\n"        // Literal que sigue en la línea siguiente y // continuado
+        "n = 1'0'0; c = u8'\\''; \n"       // Separadores de dígitos y ' escapada
+        "end\n";
+
+    std::vector<size_t> expected;
+    for (std::string_view line : {"int b;\n", " t\n", "; \n", "end\n"}) {
+        expected.push_back(source.find(line) + line.size() - 1);
+    }
+    EXPECT_EQ(Lexer::findSplitPoints(source, source.size()), expected);
+    EXPECT_TRUE(Lexer::findSplitPoints(source, 1).empty());
+}
+
+TEST_F(TokenBufferTest, ParallelTokenizeMatchesSerial) {
+    std::string snippet =
+        "static const unsigned char table[] = { 0x1F, 1'000, .5e+3, 0x1p-2 };\n"
+        "/* comentario\n   de varias líneas con \" y ' */\n"
+        "const char* s = \"a\\\"b // no es comentario\";\n"
+        "#define M(x) x + \\\n    '\"'\n"
+        "auto r = R\"d(raw \" string)d\"; char c = L'\\''; // fin\n";
+    std::string source;
+    while (source.size() < 4 * Lexer::kMinParallelChunk) {
+        source += snippet;
+    }
+    ASSERT_EQ(Lexer::findSplitPoints(source, 4).size(), 3u);
+
+    TokenBuffer serial;
+    lex(source, serial);
+
+    TokenBuffer parallel;
+    common::utils::ThreadPool pool(4);
+    LexerConfig config;
+    config.fileId = 1;
+    Lexer lexer(source, diagEngine_, config);
+    lexer.tokenize(parallel, pool);
+
+    ASSERT_EQ(parallel.size(), serial.size());
+    for (size_t i = 0; i < serial.size(); ++i) {
+        ASSERT_EQ(parallel[i].type, serial[i].type) << i;
+        ASSERT_EQ(parallel[i].offset, serial[i].offset) << i;
+        ASSERT_EQ(parallel[i].flags, serial[i].flags) << i;
+        ASSERT_EQ(parallel.spelling(parallel[i]), serial.spelling(serial[i])) << i;
+    }
+    EXPECT_EQ(parallel[parallel.size() - 1].type, TokenType::END_OF_FILE);
+    EXPECT_EQ(lexer.getStats().totalTokens, serial.size() - 1);
+
+    auto last = parallel.location(parallel[parallel.size() - 2]);
+    EXPECT_EQ(last.line(), serial.location(serial[serial.size() - 2]).line());
+}
@@ -0,0 +1,64 @@
+/**
+ * @file test_token_cursor.cpp
+ * @brief Tests para el cursor de tokens del parser
+ */
+
+#include <compiler/frontend/TokenCursor.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace cpp20::compiler;
+using frontend::TokenCursor;
+using frontend::lexer::Token;
+using frontend::lexer::TokenType;
+
+namespace {
+
+std::vector<Token> sampleTokens() {
+    return {
+        Token(TokenType::INT, "int", diagnostics::SourceLocation()),
+        Token(TokenType::IDENTIFIER, "x", diagnostics::SourceLocation()),
+        Token(TokenType::SEMICOLON, ";", diagnostics::SourceLocation()),
+    };
+}
+
+} // namespace
+
+TEST(TokenCursorTest, ReturnsReferencesIntoTheBuffer) {
+    std::vector<Token> tokens = sampleTokens();
+    TokenCursor cursor(tokens);
+
+    EXPECT_EQ(&cursor.current(), &tokens[0]);
+    EXPECT_EQ(&cursor.peek(2), &tokens[2]);
+    EXPECT_EQ(&cursor.advance(), &tokens[0]);
+    EXPECT_EQ(&cursor.current(), &tokens[1]);
+}
+
+TEST(TokenCursorTest, PastTheEndIsEndOfFile) {
+    std::vector<Token> tokens = sampleTokens();
+    TokenCursor cursor(tokens);
+
+    EXPECT_EQ(cursor.peek(10).getType(), TokenType::END_OF_FILE);
+    while (!cursor.atEnd()) {
+        cursor.advance();
+    }
+    EXPECT_EQ(cursor.position(), 3u);
+    EXPECT_EQ(cursor.advance().getType(), TokenType::END_OF_FILE);
+    EXPECT_EQ(cursor.position(), 3u);
+}
+
+TEST(TokenCursorTest, RewindRestoresMark) {
+    std::vector<Token> tokens = sampleTokens();
+    TokenCursor cursor(tokens);
+
+    cursor.advance();
+    TokenCursor::Mark mark = cursor.mark();
+    cursor.advance();
+    cursor.advance();
+    EXPECT_TRUE(cursor.atEnd());
+
+    cursor.rewind(mark);
+    EXPECT_EQ(cursor.current().getLexeme(), "x");
+    cursor.reset();
+    EXPECT_EQ(cursor.current().getType(), TokenType::INT);
+}
@@ -0,0 +1,72 @@
+/**
+ * @file test_type_context.cpp
+ * @brief Tests para la unificación de tipos en TypeContext
+ */
+
+#include <compiler/types/TypeContext.h>
+#include <gtest/gtest.h>
+
+using namespace cpp20::compiler::types;
+
+namespace {
+
+class TypeContextTest : public ::testing::Test {
+protected:
+    TypeContext context_;
+
+    const BasicType* intType(CVQualifier cv = CVQualifier::None) {
+        return context_.getBasicType(BasicType::BasicKind::Int, cv);
+    }
+};
+
+} // namespace
+
+TEST_F(TypeContextTest, BasicTypesAreUniqued) {
+    EXPECT_EQ(intType(), intType());
+    EXPECT_NE(intType(), intType(CVQualifier::Const));
+    EXPECT_NE(intType(), context_.getBasicType(BasicType::BasicKind::Long));
+    EXPECT_TRUE(intType()->isCanonical());
+    EXPECT_EQ(intType(CVQualifier::ConstVolatile)->toString(), "const volatile int");
+}
+
+TEST_F(TypeContextTest, DerivedTypesAreUniqued) {
+    size_t before = context_.typeCount();
+
+    const PointerType* pointer = context_.getPointerType(intType(CVQualifier::Const));
+    EXPECT_EQ(pointer, context_.getPointerType(intType(CVQualifier::Const)));
+    EXPECT_NE(pointer, context_.getPointerType(intType()));
+    EXPECT_NE(pointer, context_.getPointerType(intType(CVQualifier::Const), CVQualifier::Const));
+    EXPECT_EQ(pointer->toString(), "const int*");
+
+    const ReferenceType* lvalue = context_.getReferenceType(pointer);
+    EXPECT_EQ(lvalue, context_.getReferenceType(pointer));
+    EXPECT_NE(lvalue, context_.getReferenceType(pointer, true));
+    EXPECT_EQ(context_.getReferenceType(pointer, true)->toString(), "const int*&&");
+
+    EXPECT_EQ(context_.typeCount(), before + 5);
+}
+
+TEST_F(TypeContextTest, QualifiedTypesReuseTheCanonicalInstance) {
+    const PointerType* pointer = context_.getPointerType(intType());
+    const Type* constPointer = context_.getQualifiedType(pointer, CVQualifier::Const);
+
+    EXPECT_EQ(constPointer, context_.getPointerType(intType(), CVQualifier::Const));
+    EXPECT_EQ(context_.getQualifiedType(constPointer, CVQualifier::None), pointer);
+    EXPECT_EQ(context_.getQualifiedType(intType(), CVQualifier::Volatile), intType(CVQualifier::Volatile));
+
+    const ReferenceType* reference = context_.getReferenceType(intType());
+    EXPECT_EQ(context_.getQualifiedType(reference, CVQualifier::Const), reference);
+}
+
+TEST_F(TypeContextTest, ExternalTypesCanonicalizeStructurally) {
+    BasicType looseInt(BasicType::BasicKind::Int, CVQualifier::Const);
+    PointerType loosePointer(&looseInt);
+
+    EXPECT_FALSE(looseInt.isCanonical());
+    EXPECT_EQ(context_.getCanonicalType(&looseInt), intType(CVQualifier::Const));
+    EXPECT_EQ(context_.getCanonicalType(&loosePointer), context_.getPointerType(intType(CVQualifier::Const)));
+
+    EXPECT_TRUE(isSameType(&looseInt, intType(CVQualifier::Const)));
+    EXPECT_FALSE(isSameType(intType(), intType(CVQualifier::Const)));
+    EXPECT_FALSE(isSameType(intType(), nullptr));
+}
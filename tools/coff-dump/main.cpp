@@ -0,0 +1,90 @@
+/**
+ * @file main.cpp
+ * @brief Muestra objetos COFF y bibliotecas (.lib) proyectados en memoria
+ *
+ * Uso:
+ *   cpp20-coff-dump [opciones] <archivo>...
+ *
+ *   --section=<nombre>   Solo esa sección (repetible)
+ *   --symbol=<patrón>    Solo los símbolos cuyo nombre mangled encaja ('*' = cualquier texto)
+ *   --sorted             Tabla de símbolos ordenada por nombre desmangled
+ *   --jobs=<n>           Hilos para secciones, símbolos y miembros (núcleos por defecto)
+ *
+ * Devuelve 0 si todos los archivos se leen, 1 si alguno no y 2 ante un
+ * error de uso.
+ */
+
+#include <compiler/backend/coff/COFFDumper.h>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace cpp20::compiler::backend;
+
+namespace {
+
+constexpr int ExitFailure = 1;
+constexpr int ExitUsage = 2;
+
+void printUsage() {
+    std::cerr << "Uso: cpp20-coff-dump [--section=<nombre>]... [--symbol=<patrón>] [--sorted]\n"
+                 "                       [--jobs=<n>] <archivo>...\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> files;
+    coff::COFFDumper dumper;
+    bool sorted = false;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            auto valueOf = [&](std::string_view prefix) { return std::string(arg.substr(prefix.size())); };
+
+            if (arg.rfind("--section=", 0) == 0) {
+                dumper.addSectionFilter(valueOf("--section="));
+            } else if (arg.rfind("--symbol=", 0) == 0) {
+                dumper.setSymbolFilter(valueOf("--symbol="));
+            } else if (arg == "--sorted") {
+                sorted = true;
+            } else if (arg.rfind("--jobs=", 0) == 0) {
+                dumper.setJobs(std::stoul(valueOf("--jobs=")));
+            } else if (arg == "--help" || arg == "-h") {
+                printUsage();
+                return EXIT_SUCCESS;
+            } else if (!arg.empty() && arg[0] == '-') {
+                std::cerr << "Opción desconocida: " << arg << std::endl;
+                printUsage();
+                return ExitUsage;
+            } else {
+                files.emplace_back(arg);
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Valor numérico inválido" << std::endl;
+        return ExitUsage;
+    }
+
+    if (files.empty()) {
+        printUsage();
+        return ExitUsage;
+    }
+
+    // La salida puede ser de cientos de MB: sin sincronizar con stdio
+    std::ios::sync_with_stdio(false);
+
+    bool success = true;
+    for (const auto& file : files) {
+        if (files.size() > 1) {
+            std::cout << "\n" << file << ":\n";
+        }
+        success = (sorted ? dumper.dumpSortedSymbols(file, std::cout) : dumper.dumpFile(file, std::cout)) &&
+                  success;
+    }
+    std::cout.flush();
+    return success ? EXIT_SUCCESS : ExitFailure;
+}
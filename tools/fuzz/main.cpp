@@ -0,0 +1,185 @@
+/**
+ * @file main.cpp
+ * @brief Fuzzer en proceso del front-end con trabajadores en paralelo
+ *
+ * Uso:
+ *   cpp20-fuzz [opciones]
+ *
+ *   --target=<t>        lexer, parser, preprocessor, semantic, codegen o full (full)
+ *   --strategy=<s>      random, mutational, grammar o coverage (coverage)
+ *   --workers=<n>       Trabajadores en paralelo (núcleos disponibles)
+ *   --iterations=<n>    Ejecuciones en total (100000)
+ *   --minutes=<n>       Duración máxima (5)
+ *   --max-len=<n>       Tamaño máximo de entrada (4096)
+ *   --seed=<n>          Semilla; el trabajador i usa seed + i
+ *   --corpus=<dir>      Semillas (.cpp/.txt); al terminar se añade el corpus nuevo
+ *   --crashes=<dir>     Dónde guardar los crashes (crashes)
+ *   --minimize=<dir>    No hace fuzzing: deduplica y minimiza --corpus y
+ *                       escribe el resultado en <dir>
+ *   -v                  Progreso y errores de los targets en stderr
+ *
+ * La cobertura solo guía la búsqueda en un build con
+ * CPP20_COMPILER_FUZZ_COVERAGE. Devuelve 0 sin crashes, 1 con crashes y 2
+ * ante un error de uso.
+ */
+
+#include <compiler/testing/FuzzingEngine.h>
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+using namespace cpp20::compiler::testing;
+
+namespace {
+
+constexpr int ExitCrashes = 1;
+constexpr int ExitUsage = 2;
+
+void printUsage() {
+    std::cerr << "Uso: cpp20-fuzz [--target=<t>] [--strategy=<s>] [--workers=<n>] [--iterations=<n>]\n"
+                 "                 [--minutes=<n>] [--max-len=<n>] [--seed=<n>] [--corpus=<dir>]\n"
+                 "                 [--crashes=<dir>] [--minimize=<dir>] [-v]\n";
+}
+
+std::optional<FuzzTarget> parseTarget(std::string_view name) {
+    if (name == "lexer") return FuzzTarget::Lexer;
+    if (name == "parser") return FuzzTarget::Parser;
+    if (name == "preprocessor") return FuzzTarget::Preprocessor;
+    if (name == "semantic") return FuzzTarget::Semantic;
+    if (name == "codegen") return FuzzTarget::CodeGen;
+    if (name == "full") return FuzzTarget::FullPipeline;
+    return std::nullopt;
+}
+
+std::optional<FuzzStrategy> parseStrategy(std::string_view name) {
+    if (name == "random") return FuzzStrategy::Random;
+    if (name == "mutational") return FuzzStrategy::Mutational;
+    if (name == "grammar") return FuzzStrategy::GrammarBased;
+    if (name == "coverage") return FuzzStrategy::CoverageGuided;
+    return std::nullopt;
+}
+
+void writeEntries(const std::filesystem::path& dir, const std::vector<std::string>& entries, size_t from) {
+    std::filesystem::create_directories(dir);
+    for (size_t i = from; i < entries.size(); ++i) {
+        std::ofstream out(dir / ("cov_" + std::to_string(std::hash<std::string>{}(entries[i])) + ".txt"),
+                          std::ios::binary);
+        out << entries[i];
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    FuzzTarget target = FuzzTarget::FullPipeline;
+    FuzzStrategy strategy = FuzzStrategy::CoverageGuided;
+    size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    size_t iterations = 100000;
+    size_t minutes = 5;
+    size_t maxLength = 4096;
+    std::optional<size_t> seed;
+    std::string corpusDir;
+    std::string crashesDir = "crashes";
+    std::string minimizeDir;
+    bool verbose = false;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            auto valueOf = [&](std::string_view prefix) { return std::string(arg.substr(prefix.size())); };
+
+            if (arg.rfind("--target=", 0) == 0) {
+                auto parsed = parseTarget(valueOf("--target="));
+                if (!parsed) {
+                    std::cerr << "Target desconocido: " << arg << std::endl;
+                    return ExitUsage;
+                }
+                target = *parsed;
+            } else if (arg.rfind("--strategy=", 0) == 0) {
+                auto parsed = parseStrategy(valueOf("--strategy="));
+                if (!parsed) {
+                    std::cerr << "Estrategia desconocida: " << arg << std::endl;
+                    return ExitUsage;
+                }
+                strategy = *parsed;
+            } else if (arg.rfind("--workers=", 0) == 0) {
+                workers = std::stoul(valueOf("--workers="));
+            } else if (arg.rfind("--iterations=", 0) == 0) {
+                iterations = std::stoul(valueOf("--iterations="));
+            } else if (arg.rfind("--minutes=", 0) == 0) {
+                minutes = std::stoul(valueOf("--minutes="));
+            } else if (arg.rfind("--max-len=", 0) == 0) {
+                maxLength = std::stoul(valueOf("--max-len="));
+            } else if (arg.rfind("--seed=", 0) == 0) {
+                seed = std::stoul(valueOf("--seed="));
+            } else if (arg.rfind("--corpus=", 0) == 0) {
+                corpusDir = valueOf("--corpus=");
+            } else if (arg.rfind("--crashes=", 0) == 0) {
+                crashesDir = valueOf("--crashes=");
+            } else if (arg.rfind("--minimize=", 0) == 0) {
+                minimizeDir = valueOf("--minimize=");
+            } else if (arg == "-v") {
+                verbose = true;
+            } else if (arg == "--help" || arg == "-h") {
+                printUsage();
+                return EXIT_SUCCESS;
+            } else {
+                std::cerr << "Opción desconocida: " << arg << std::endl;
+                printUsage();
+                return ExitUsage;
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Valor numérico inválido" << std::endl;
+        return ExitUsage;
+    }
+
+    FuzzingEngine engine(target, strategy);
+    if (seed) engine.setSeed(*seed);
+    engine.setWorkers(workers);
+    engine.setVerbose(verbose);
+    engine.configure(maxLength);
+
+    if (!corpusDir.empty() && !engine.loadCorpus(corpusDir)) {
+        std::cerr << "Advertencia: " << corpusDir << " no tiene semillas" << std::endl;
+    }
+
+    if (!minimizeDir.empty()) {
+        if (corpusDir.empty()) {
+            std::cerr << "--minimize requiere --corpus" << std::endl;
+            return ExitUsage;
+        }
+        if (!CoverageMap::isInstrumented()) {
+            std::cerr << "Advertencia: build sin SanitizerCoverage; solo se deduplica por contenido" << std::endl;
+        }
+        size_t before = engine.getCorpus().size();
+        size_t removed = engine.minimizeCorpus();
+        writeEntries(minimizeDir, engine.getCorpus().getAllEntries(), 0);
+        std::cout << "Corpus: " << before << " -> " << before - removed << " entradas" << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    if (!CoverageMap::isInstrumented() && strategy == FuzzStrategy::CoverageGuided) {
+        std::cerr << "Advertencia: build sin SanitizerCoverage; la cobertura no guiará la búsqueda" << std::endl;
+    }
+
+    size_t loaded = engine.getCorpus().size();
+    FuzzStatistics statistics = engine.runFuzzing(iterations, std::chrono::minutes(minutes));
+
+    // Las entradas que aportaron cobertura se suman a las semillas para la próxima sesión
+    if (!corpusDir.empty()) {
+        writeEntries(corpusDir, engine.getCorpus().getAllEntries(), loaded);
+    }
+
+    if (!engine.getCrashes().empty()) {
+        engine.saveCrashes(crashesDir);
+        return ExitCrashes;
+    }
+    return statistics.crashesFound > 0 ? ExitCrashes : EXIT_SUCCESS;
+}
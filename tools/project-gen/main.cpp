@@ -0,0 +1,112 @@
+/**
+ * @file main.cpp
+ * @brief Genera proyectos sintéticos para medir cómo escala el compilador
+ *
+ * Uso:
+ *   cpp20-project-gen [opciones] <directorio>
+ *
+ *   --units=<n>             Unidades de traducción (16)
+ *   --include-depth=<n>     Cabeceras encadenadas por unidad (4)
+ *   --templates=<n>         Templates de función (8)
+ *   --instantiations=<n>    Instanciaciones distintas de cada template (4)
+ *   --constexpr=<n>         Funciones constexpr con bucle (4)
+ *   --constexpr-steps=<n>   Iteraciones de cada evaluación constexpr (1000)
+ *   --module-width=<n>      Módulos por nivel (0 = sin módulos)
+ *   --module-depth=<n>      Niveles del grafo de módulos (0)
+ *   --filler=<n>            Declaraciones aleatorias por unidad (0)
+ *   --seed=<n>              Semilla del relleno aleatorio (1)
+ *
+ * Las unidades se compilan con -I<directorio>/include en el orden de
+ * <directorio>/sources.txt. Devuelve 0 si todo se escribió, 1 si falló la
+ * escritura y 2 ante un error de uso.
+ */
+
+#include <compiler/testing/ProjectGenerator.h>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+using namespace cpp20::compiler::testing;
+
+namespace {
+
+constexpr int ExitWriteError = 1;
+constexpr int ExitUsage = 2;
+
+void printUsage() {
+    std::cerr << "Uso: cpp20-project-gen [--units=<n>] [--include-depth=<n>] [--templates=<n>]\n"
+                 "                         [--instantiations=<n>] [--constexpr=<n>] [--constexpr-steps=<n>]\n"
+                 "                         [--module-width=<n>] [--module-depth=<n>] [--filler=<n>]\n"
+                 "                         [--seed=<n>] <directorio>\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ProjectShape shape;
+    std::string output;
+
+    struct Option {
+        std::string_view prefix;
+        size_t ProjectShape::* field;
+    };
+    const Option options[] = {
+        {"--units=", &ProjectShape::translationUnits},
+        {"--include-depth=", &ProjectShape::includeDepth},
+        {"--templates=", &ProjectShape::templates},
+        {"--instantiations=", &ProjectShape::instantiationsPerTemplate},
+        {"--constexpr=", &ProjectShape::constexprFunctions},
+        {"--constexpr-steps=", &ProjectShape::constexprIterations},
+        {"--module-width=", &ProjectShape::moduleWidth},
+        {"--module-depth=", &ProjectShape::moduleDepth},
+        {"--filler=", &ProjectShape::fillerComplexity},
+        {"--seed=", &ProjectShape::seed},
+    };
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            if (arg == "--help" || arg == "-h") {
+                printUsage();
+                return EXIT_SUCCESS;
+            }
+
+            bool matched = false;
+            for (const auto& option : options) {
+                if (arg.rfind(option.prefix, 0) == 0) {
+                    shape.*option.field = std::stoul(std::string(arg.substr(option.prefix.size())));
+                    matched = true;
+                    break;
+                }
+            }
+            if (matched) continue;
+
+            if (!arg.empty() && arg[0] == '-') {
+                std::cerr << "Opción desconocida: " << arg << std::endl;
+                printUsage();
+                return ExitUsage;
+            }
+            if (!output.empty()) {
+                printUsage();
+                return ExitUsage;
+            }
+            output = arg;
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Valor numérico inválido" << std::endl;
+        return ExitUsage;
+    }
+
+    if (output.empty()) {
+        printUsage();
+        return ExitUsage;
+    }
+
+    std::string error;
+    if (!ProjectGenerator(shape).write(output, &error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return ExitWriteError;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file main.cpp
+ * @brief Agrega archivos de -ftelemetry en distribuciones y detecta regresiones
+ *
+ * Uso:
+ *   cpp20-telemetry-merge [opciones] <archivo>...
+ *
+ *   --json                  Distribuciones en JSON en lugar de tabla
+ *   --version=<v>           Solo registros de esa versión del compilador
+ *   --baseline=<archivo>    Referencia contra la que comparar (repetible)
+ *   --baseline-version=<v>  Versión de referencia; sin --baseline se toma
+ *                           de los mismos archivos de entrada
+ *   --tolerance=<pct>       Crecimiento de p50/p90 admitido (5 por defecto)
+ *   --min-samples=<n>       Muestras mínimas por métrica para comparar (10)
+ *
+ * Devuelve 0 si no hay regresiones, 1 si las hay y 2 ante un error de uso.
+ */
+
+#include <compiler/common/TelemetrySink.h>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace cpp20::compiler;
+
+namespace {
+
+constexpr int ExitRegression = 1;
+constexpr int ExitUsage = 2;
+
+void printUsage() {
+    std::cerr << "Uso: cpp20-telemetry-merge [--json] [--version=<v>] [--baseline=<archivo>]\n"
+                 "                            [--baseline-version=<v>] [--tolerance=<pct>]\n"
+                 "                            [--min-samples=<n>] <archivo>...\n";
+}
+
+bool readInto(TelemetryAggregator& aggregator, const std::vector<std::string>& files) {
+    for (const auto& file : files) {
+        size_t malformed = 0;
+        auto records = TelemetrySink::read(file, &malformed);
+        if (records.empty() && malformed == 0) {
+            std::cerr << "Advertencia: " << file << " no tiene registros" << std::endl;
+        }
+        if (malformed > 0) {
+            std::cerr << "Advertencia: " << malformed << " líneas mal formadas en " << file << std::endl;
+        }
+        aggregator.add(records);
+    }
+    return aggregator.recordCount() > 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> inputs;
+    std::vector<std::string> baselines;
+    std::string version;
+    std::string baselineVersion;
+    bool json = false;
+    double tolerance = 0.05;
+    size_t minSamples = 10;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            auto valueOf = [&](std::string_view prefix) { return std::string(arg.substr(prefix.size())); };
+
+            if (arg == "--json") {
+                json = true;
+            } else if (arg.rfind("--version=", 0) == 0) {
+                version = valueOf("--version=");
+            } else if (arg.rfind("--baseline=", 0) == 0) {
+                baselines.push_back(valueOf("--baseline="));
+            } else if (arg.rfind("--baseline-version=", 0) == 0) {
+                baselineVersion = valueOf("--baseline-version=");
+            } else if (arg.rfind("--tolerance=", 0) == 0) {
+                tolerance = std::stod(valueOf("--tolerance=")) / 100.0;
+            } else if (arg.rfind("--min-samples=", 0) == 0) {
+                minSamples = std::stoul(valueOf("--min-samples="));
+            } else if (arg == "--help" || arg == "-h") {
+                printUsage();
+                return EXIT_SUCCESS;
+            } else if (!arg.empty() && arg[0] == '-') {
+                std::cerr << "Opción desconocida: " << arg << std::endl;
+                printUsage();
+                return ExitUsage;
+            } else {
+                inputs.emplace_back(arg);
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Valor numérico inválido" << std::endl;
+        return ExitUsage;
+    }
+
+    if (inputs.empty()) {
+        printUsage();
+        return ExitUsage;
+    }
+
+    TelemetryAggregator current;
+    current.filterVersion(version);
+    if (!readInto(current, inputs)) {
+        std::cerr << "Error: no hay registros que agregar" << std::endl;
+        return ExitUsage;
+    }
+    std::cout << (json ? current.generateJSON() : current.generateReport());
+
+    if (baselines.empty() && baselineVersion.empty()) {
+        return EXIT_SUCCESS;
+    }
+
+    TelemetryAggregator baseline;
+    baseline.filterVersion(baselineVersion);
+    if (!readInto(baseline, baselines.empty() ? inputs : baselines)) {
+        std::cerr << "Error: la referencia no tiene registros" << std::endl;
+        return ExitUsage;
+    }
+
+    auto regressions = TelemetryAggregator::findRegressions(baseline.distributions(),
+                                                            current.distributions(),
+                                                            tolerance, minSamples);
+    if (regressions.empty()) {
+        std::cerr << "Sin regresiones frente a la referencia" << std::endl;
+        return EXIT_SUCCESS;
+    }
+    std::cerr << TelemetryAggregator::formatRegressions(regressions);
+    return ExitRegression;
+}
@@ -0,0 +1,156 @@
+/**
+ * @file main.cpp
+ * @brief Ejecuta los tests de Google Test en paralelo, cada uno en su proceso
+ *
+ * Uso:
+ *   cpp20-test-runner [opciones] <ejecutable>...
+ *
+ *   --jobs=<n>              Procesos simultáneos (núcleos por defecto)
+ *   --timeout=<ms>          Timeout por test (60000 por defecto)
+ *   --budget=<prefijo>=<ms> Timeout de los tests que empiezan por prefijo (repetible)
+ *   --history=<archivo>     Duraciones de la ejecución anterior: el más lento empieza primero
+ *   --json=<archivo>        Informe con tiempo y pico de memoria por test
+ *   --slowest=<n>           Tests más lentos que se listan al final (10)
+ *
+ * Devuelve 0 si todos pasan, 1 si alguno falla o vence su timeout y 2 ante
+ * un error de uso.
+ */
+
+#include <compiler/testing/ParallelTestRunner.h>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace cpp20::compiler;
+using testing::ParallelTestRunner;
+
+namespace {
+
+constexpr int ExitFailure = 1;
+constexpr int ExitUsage = 2;
+
+void printUsage() {
+    std::cerr << "Uso: cpp20-test-runner [--jobs=<n>] [--timeout=<ms>] [--budget=<prefijo>=<ms>]\n"
+                 "                         [--history=<archivo>] [--json=<archivo>] [--slowest=<n>]\n"
+                 "                         <ejecutable>...\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> executables;
+    std::vector<std::pair<std::string, std::chrono::milliseconds>> budgets;
+    std::string history;
+    std::string json;
+    size_t jobs = 0;
+    size_t slowestCount = 10;
+    std::chrono::milliseconds timeout = std::chrono::seconds(60);
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            auto valueOf = [&](std::string_view prefix) { return std::string(arg.substr(prefix.size())); };
+
+            if (arg.rfind("--jobs=", 0) == 0) {
+                jobs = std::stoul(valueOf("--jobs="));
+            } else if (arg.rfind("--timeout=", 0) == 0) {
+                timeout = std::chrono::milliseconds(std::stoll(valueOf("--timeout=")));
+            } else if (arg.rfind("--budget=", 0) == 0) {
+                std::string budget = valueOf("--budget=");
+                size_t equals = budget.rfind('=');
+                if (equals == std::string::npos) {
+                    std::cerr << "Presupuesto sin '=<ms>': " << budget << std::endl;
+                    return ExitUsage;
+                }
+                budgets.emplace_back(budget.substr(0, equals),
+                                     std::chrono::milliseconds(std::stoll(budget.substr(equals + 1))));
+            } else if (arg.rfind("--history=", 0) == 0) {
+                history = valueOf("--history=");
+            } else if (arg.rfind("--json=", 0) == 0) {
+                json = valueOf("--json=");
+            } else if (arg.rfind("--slowest=", 0) == 0) {
+                slowestCount = std::stoul(valueOf("--slowest="));
+            } else if (arg == "--help" || arg == "-h") {
+                printUsage();
+                return EXIT_SUCCESS;
+            } else if (!arg.empty() && arg[0] == '-') {
+                std::cerr << "Opción desconocida: " << arg << std::endl;
+                printUsage();
+                return ExitUsage;
+            } else {
+                executables.emplace_back(arg);
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Valor numérico inválido" << std::endl;
+        return ExitUsage;
+    }
+
+    if (executables.empty()) {
+        printUsage();
+        return ExitUsage;
+    }
+
+    ParallelTestRunner runner(jobs);
+    for (const auto& executable : executables) {
+        if (runner.addGoogleTests(executable, timeout) == 0) {
+            std::cerr << "Error: " << executable << " no listó ningún test" << std::endl;
+            return ExitUsage;
+        }
+    }
+    for (auto& [prefix, budget] : budgets) {
+        runner.setTimeout(prefix, budget);
+    }
+    if (!history.empty()) {
+        runner.loadHistory(history);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto results = runner.run();
+    auto wallTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    if (!history.empty() && !runner.saveHistory(history)) {
+        std::cerr << "Advertencia: no se pudo escribir " << history << std::endl;
+    }
+    if (!json.empty()) {
+        std::ofstream out(json, std::ios::binary | std::ios::trunc);
+        out << ParallelTestRunner::formatJSON(results, wallTime);
+        if (!out) {
+            std::cerr << "Advertencia: no se pudo escribir " << json << std::endl;
+        }
+    }
+
+    size_t failed = 0;
+    for (const auto& result : results) {
+        if (result.outcome == ParallelTestRunner::Outcome::Passed) {
+            continue;
+        }
+        ++failed;
+        std::cout << "[ " << ParallelTestRunner::outcomeName(result.outcome) << " ] " << result.name
+                  << " (" << result.duration.count() << " ms)\n" << result.output << '\n';
+    }
+
+    std::vector<const ParallelTestRunner::Result*> slowest;
+    for (const auto& result : results) {
+        slowest.push_back(&result);
+    }
+    std::sort(slowest.begin(), slowest.end(), [](const auto* a, const auto* b) {
+        return a->duration > b->duration;
+    });
+    slowest.resize(std::min(slowest.size(), slowestCount));
+    if (!slowest.empty()) {
+        std::cout << "Tests más lentos:\n";
+        for (const auto* result : slowest) {
+            std::cout << "  " << result->duration.count() << " ms  "
+                      << result->peakMemoryBytes / (1024 * 1024) << " MB  " << result->name << '\n';
+        }
+    }
+
+    std::cout << results.size() - failed << "/" << results.size() << " tests pasaron en "
+              << wallTime.count() << " ms con " << runner.jobs() << " procesos" << std::endl;
+    return failed > 0 ? ExitFailure : EXIT_SUCCESS;
+}